@@ -0,0 +1,56 @@
+# Copyright (c) 2020-present Baidu, Inc. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+# http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+INCLUDE(ExternalProject)
+message(STATUS "Include google benchmark...")
+
+SET(BENCHMARK_SOURCES_DIR ${THIRD_PARTY_PATH}/source/benchmark)
+SET(BENCHMARK_BINARY_DIR ${THIRD_PARTY_PATH}/build/benchmark)
+SET(BENCHMARK_INSTALL_DIR ${THIRD_PARTY_PATH}/install/benchmark)
+SET(BENCHMARK_INCLUDE_DIR "${BENCHMARK_INSTALL_DIR}/include" CACHE PATH "benchmark include directory." FORCE)
+SET(BENCHMARK_LIBRARIES "${BENCHMARK_INSTALL_DIR}/lib/libbenchmark.a" CACHE FILEPATH "benchmark library." FORCE)
+
+ExternalProject_Add(
+    extern_benchmark
+    ${EXTERNAL_PROJECT_LOG_ARGS}
+
+    GIT_REPOSITORY https://github.com/google/benchmark.git
+    GIT_TAG v1.8.3
+    SOURCE_DIR ${BENCHMARK_SOURCES_DIR}
+    BINARY_DIR ${BENCHMARK_BINARY_DIR}
+    PREFIX ${BENCHMARK_BINARY_DIR}
+
+    UPDATE_COMMAND ""
+    CMAKE_ARGS -DCMAKE_CXX_COMPILER=${CMAKE_CXX_COMPILER}
+    -DCMAKE_C_COMPILER=${CMAKE_C_COMPILER}
+    -DCMAKE_CXX_FLAGS=${CMAKE_CXX_FLAGS}
+    -DCMAKE_C_FLAGS=${CMAKE_C_FLAGS}
+    -DCMAKE_INSTALL_PREFIX=${BENCHMARK_INSTALL_DIR}
+    -DCMAKE_INSTALL_LIBDIR=${BENCHMARK_INSTALL_DIR}/lib
+    -DCMAKE_POSITION_INDEPENDENT_CODE=ON
+    -DCMAKE_BUILD_TYPE=${THIRD_PARTY_BUILD_TYPE}
+    -DBENCHMARK_ENABLE_TESTING=OFF
+    -DBENCHMARK_ENABLE_GTEST_TESTS=OFF
+    -DBENCHMARK_ENABLE_INSTALL=ON
+    ${EXTERNAL_OPTIONAL_ARGS}
+    LIST_SEPARATOR |
+    CMAKE_CACHE_ARGS -DCMAKE_INSTALL_PREFIX:PATH=${BENCHMARK_INSTALL_DIR}
+    -DCMAKE_INSTALL_LIBDIR:PATH=${BENCHMARK_INSTALL_DIR}/lib
+    -DCMAKE_POSITION_INDEPENDENT_CODE:BOOL=ON
+    -DCMAKE_BUILD_TYPE:STRING=${THIRD_PARTY_BUILD_TYPE}
+)
+
+ADD_LIBRARY(benchmark STATIC IMPORTED GLOBAL)
+SET_PROPERTY(TARGET benchmark PROPERTY IMPORTED_LOCATION ${BENCHMARK_LIBRARIES})
+ADD_DEPENDENCIES(benchmark extern_benchmark)
@@ -57,6 +57,7 @@ ExternalProject_Add(
     -DGFLAGS_LIBRARY=${GFLAGS_LIBRARIES}
     -DDOWNLOAD_GTEST=OFF
     -DBUILD_BRPC_TOOLS=OFF
+    -DWITH_RDMA=${WITH_RDMA}
     -DPROTOC_LIB=${PROTOBUF_LIBRARIES}
     ${EXTERNAL_OPTIONAL_ARGS}
     LIST_SEPARATOR |
@@ -0,0 +1,306 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "client/client_async.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "bthread/bthread.h"
+#include "common/helper.h"
+#include "common/logging.h"
+#include "fmt/core.h"
+
+namespace client {
+
+// A shorter batch delay makes the flush bthread spin.
+static const int64_t kMinBatchDelayUs = 100;
+
+AsyncStoreClient::AsyncStoreClient(int64_t max_batch_size, int64_t batch_delay_us, int64_t max_inflight)
+    : max_batch_size_(std::max(max_batch_size, static_cast<int64_t>(1))),
+      batch_delay_us_(std::max(batch_delay_us, kMinBatchDelayUs)),
+      max_inflight_(std::max(max_inflight, static_cast<int64_t>(1))) {
+  if (bthread_start_background(&flush_tid_, nullptr, FlushRoutine, this) != 0) {
+    DINGO_LOG(ERROR) << "Fail to create flush bthread";
+    flush_tid_ = 0;
+  }
+}
+
+AsyncStoreClient::~AsyncStoreClient() {
+  {
+    std::lock_guard<bthread::Mutex> lock(mutex_);
+    is_stop_.store(true);
+    flush_cond_.notify_all();
+  }
+  if (flush_tid_ != 0) {
+    bthread_join(flush_tid_, nullptr);
+  }
+  Flush();
+
+  // the rpc closures and callbacks still use the client
+  std::unique_lock<bthread::Mutex> lock(mutex_);
+  while (pending_call_count_ > 0) {
+    drain_cond_.wait(lock);
+  }
+}
+
+void* AsyncStoreClient::FlushRoutine(void* arg) {
+  auto* self = static_cast<AsyncStoreClient*>(arg);
+  while (!self->is_stop_.load(std::memory_order_relaxed)) {
+    self->FlushBatches(self->batch_delay_us_);
+
+    std::unique_lock<bthread::Mutex> lock(self->mutex_);
+    if (self->is_stop_.load(std::memory_order_relaxed)) {
+      break;
+    }
+    int64_t wait_us = self->NextFlushWaitUs();
+    if (wait_us < 0) {
+      self->flush_cond_.wait(lock);
+    } else if (wait_us > 0) {
+      self->flush_cond_.wait_for(lock, wait_us);
+    }
+  }
+
+  return nullptr;
+}
+
+int64_t AsyncStoreClient::NextFlushWaitUs() {
+  int64_t min_pending_time_us = INT64_MAX;
+  for (auto& [_, region] : regions_) {
+    if (!region->get_keys.empty()) {
+      min_pending_time_us = std::min(min_pending_time_us, region->get_pending_time_us);
+    }
+    if (!region->put_kvs.empty()) {
+      min_pending_time_us = std::min(min_pending_time_us, region->put_pending_time_us);
+    }
+  }
+  if (min_pending_time_us == INT64_MAX) {
+    return -1;
+  }
+
+  return std::max(min_pending_time_us + batch_delay_us_ - dingodb::Helper::TimestampUs(), static_cast<int64_t>(0));
+}
+
+AsyncStoreClient::RegionStatePtr AsyncStoreClient::GetRegionState(int64_t region_id) {
+  {
+    std::lock_guard<bthread::Mutex> lock(mutex_);
+    auto it = regions_.find(region_id);
+    if (it != regions_.end()) {
+      return it->second;
+    }
+  }
+
+  auto region_entry = RegionRouter::GetInstance().QueryRegionEntry(region_id);
+  if (region_entry == nullptr) {
+    DINGO_LOG(ERROR) << fmt::format("not found region entry {}", region_id);
+    return nullptr;
+  }
+  auto region = std::make_shared<RegionState>();
+  region->region_id = region_id;
+  region->endpoints =
+      std::make_shared<const std::vector<butil::EndPoint>>(Helper::VectorToEndpoints(region_entry->GetAddrs()));
+  if (region->endpoints->empty()) {
+    DINGO_LOG(ERROR) << fmt::format("region {} has no peer", region_id);
+    return nullptr;
+  }
+
+  std::lock_guard<bthread::Mutex> lock(mutex_);
+  return regions_.emplace(region_id, region).first->second;
+}
+
+void AsyncStoreClient::RefreshRegionState(RegionStatePtr region) {
+  auto region_entry = RegionRouter::GetInstance().QueryRegionEntry(region->region_id);
+  if (region_entry == nullptr) {
+    return;
+  }
+  auto endpoints =
+      std::make_shared<const std::vector<butil::EndPoint>>(Helper::VectorToEndpoints(region_entry->GetAddrs()));
+  if (endpoints->empty()) {
+    return;
+  }
+
+  // the leader is unknown, retry finds it
+  std::atomic_store(&region->endpoints, endpoints);
+  region->leader_index.store(0);
+}
+
+void AsyncStoreClient::Dispatch(RegionStatePtr region, std::function<void()> send) {
+  {
+    std::lock_guard<bthread::Mutex> lock(mutex_);
+    ++pending_call_count_;
+    if (region->inflight >= max_inflight_) {
+      region->waiting.push_back(std::move(send));
+      return;
+    }
+    ++region->inflight;
+  }
+
+  send();
+}
+
+void AsyncStoreClient::Done(RegionStatePtr region) {
+  std::function<void()> send;
+  {
+    std::lock_guard<bthread::Mutex> lock(mutex_);
+    if (--pending_call_count_ == 0) {
+      drain_cond_.notify_all();
+    }
+    if (region->waiting.empty()) {
+      --region->inflight;
+      return;
+    }
+    // pass the inflight slot to the next one
+    send = std::move(region->waiting.front());
+    region->waiting.pop_front();
+  }
+
+  send();
+}
+
+void AsyncStoreClient::KvGet(int64_t region_id, const std::string& key, KvGetCallback callback) {
+  auto region = GetRegionState(region_id);
+  if (region == nullptr) {
+    callback(butil::Status(dingodb::pb::error::EREGION_NOT_FOUND, "Not found region %ld", region_id), "");
+    return;
+  }
+
+  std::function<void()> send;
+  {
+    std::lock_guard<bthread::Mutex> lock(mutex_);
+    if (region->get_keys.empty()) {
+      region->get_pending_time_us = dingodb::Helper::TimestampUs();
+      flush_cond_.notify_one();
+    }
+    region->get_keys.push_back(key);
+    region->get_callbacks.push_back(std::move(callback));
+    if (region->get_keys.size() >= max_batch_size_) {
+      send = TakeGetBatch(region);
+    }
+  }
+
+  if (send != nullptr) {
+    Dispatch(region, std::move(send));
+  }
+}
+
+void AsyncStoreClient::KvPut(int64_t region_id, const std::string& key, const std::string& value,
+                             StatusCallback callback) {
+  auto region = GetRegionState(region_id);
+  if (region == nullptr) {
+    callback(butil::Status(dingodb::pb::error::EREGION_NOT_FOUND, "Not found region %ld", region_id));
+    return;
+  }
+
+  std::function<void()> send;
+  {
+    std::lock_guard<bthread::Mutex> lock(mutex_);
+    if (region->put_kvs.empty()) {
+      region->put_pending_time_us = dingodb::Helper::TimestampUs();
+      flush_cond_.notify_one();
+    }
+    auto& kv = region->put_kvs.emplace_back();
+    kv.set_key(key);
+    kv.set_value(value);
+    region->put_callbacks.push_back(std::move(callback));
+    if (region->put_kvs.size() >= max_batch_size_) {
+      send = TakePutBatch(region);
+    }
+  }
+
+  if (send != nullptr) {
+    Dispatch(region, std::move(send));
+  }
+}
+
+std::function<void()> AsyncStoreClient::TakeGetBatch(RegionStatePtr region) {
+  auto keys = std::make_shared<std::vector<std::string>>();
+  auto callbacks = std::make_shared<std::vector<KvGetCallback>>();
+  keys->swap(region->get_keys);
+  callbacks->swap(region->get_callbacks);
+
+  return [this, region, keys, callbacks]() {
+    dingodb::pb::store::KvBatchGetRequest request;
+    for (const auto& key : *keys) {
+      request.add_keys(key);
+    }
+
+    const auto* method = dingodb::pb::store::StoreService::descriptor()->FindMethodByName("KvBatchGet");
+    auto* call = new AsyncCall<dingodb::pb::store::KvBatchGetRequest, dingodb::pb::store::KvBatchGetResponse>(
+        this, region, method, request,
+        [keys, callbacks](const butil::Status& status, const dingodb::pb::store::KvBatchGetResponse& response) {
+          std::map<std::string, const std::string*> values;
+          for (const auto& kv : response.kvs()) {
+            values[kv.key()] = &kv.value();
+          }
+          for (size_t i = 0; i < keys->size(); ++i) {
+            auto it = values.find(keys->at(i));
+            (*callbacks)[i](status, (status.ok() && it != values.end()) ? *it->second : "");
+          }
+        });
+    // the inflight slot is already taken by dispatch
+    call->Send();
+  };
+}
+
+std::function<void()> AsyncStoreClient::TakePutBatch(RegionStatePtr region) {
+  dingodb::pb::store::KvBatchPutRequest request;
+  for (auto& kv : region->put_kvs) {
+    request.add_kvs()->Swap(&kv);
+  }
+  region->put_kvs.clear();
+  auto callbacks = std::make_shared<std::vector<StatusCallback>>();
+  callbacks->swap(region->put_callbacks);
+
+  return [this, region, request = std::move(request), callbacks]() {
+    const auto* method = dingodb::pb::store::StoreService::descriptor()->FindMethodByName("KvBatchPut");
+    auto* call = new AsyncCall<dingodb::pb::store::KvBatchPutRequest, dingodb::pb::store::KvBatchPutResponse>(
+        this, region, method, request, [callbacks](const butil::Status& status, const auto&) {
+          for (auto& callback : *callbacks) {
+            callback(status);
+          }
+        });
+    call->Send();
+  };
+}
+
+void AsyncStoreClient::FlushBatches(int64_t delay_us) {
+  std::vector<std::pair<RegionStatePtr, std::function<void()>>> sends;
+  {
+    std::lock_guard<bthread::Mutex> lock(mutex_);
+    int64_t now_us = dingodb::Helper::TimestampUs();
+    for (auto& [_, region] : regions_) {
+      if (!region->get_keys.empty() && now_us - region->get_pending_time_us >= delay_us) {
+        sends.emplace_back(region, TakeGetBatch(region));
+      }
+      if (!region->put_kvs.empty() && now_us - region->put_pending_time_us >= delay_us) {
+        sends.emplace_back(region, TakePutBatch(region));
+      }
+    }
+  }
+
+  for (auto& [region, send] : sends) {
+    Dispatch(region, std::move(send));
+  }
+}
+
+void AsyncStoreClient::Flush() { FlushBatches(0); }
+
+}  // namespace client
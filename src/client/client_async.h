@@ -0,0 +1,266 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef DINGODB_CLIENT_ASYNC_H_
+#define DINGODB_CLIENT_ASYNC_H_
+
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "brpc/channel.h"
+#include "brpc/controller.h"
+#include "bthread/condition_variable.h"
+#include "bthread/mutex.h"
+#include "bthread/types.h"
+#include "butil/endpoint.h"
+#include "butil/status.h"
+#include "client/client_helper.h"
+#include "client/client_interation.h"
+#include "client/client_router.h"
+#include "common/logging.h"
+#include "fmt/core.h"
+#include "google/protobuf/stubs/callback.h"
+#include "proto/common.pb.h"
+#include "proto/error.pb.h"
+#include "proto/store.pb.h"
+
+namespace client {
+
+// Asynchronous requests to store regions, the caller is not blocked, the callback is called in bthread when the
+// response arrives or the retries are exhausted, so the throughput of a client doesn't depend on its thread number.
+// Requests of a region are pipelined on the shared channel of its leader, at most max_inflight of them are in flight
+// and the others wait in the region queue. Small KvGet and KvPut of a region are coalesced into KvBatchGet and
+// KvBatchPut, a batch is sent when it is full or about batch_delay_us after its first request.
+// The destructor sends the pending batches and waits for all requests done.
+class AsyncStoreClient {
+ public:
+  using KvGetCallback = std::function<void(const butil::Status& status, const std::string& value)>;
+  using StatusCallback = std::function<void(const butil::Status& status)>;
+  template <typename Response>
+  using ResponseCallback = std::function<void(const butil::Status& status, const Response& response)>;
+
+  AsyncStoreClient(int64_t max_batch_size, int64_t batch_delay_us, int64_t max_inflight);
+  ~AsyncStoreClient();
+
+  AsyncStoreClient(const AsyncStoreClient&) = delete;
+  AsyncStoreClient& operator=(const AsyncStoreClient&) = delete;
+
+  // Value is empty if the key is not exist.
+  void KvGet(int64_t region_id, const std::string& key, KvGetCallback callback);
+  void KvPut(int64_t region_id, const std::string& key, const std::string& value, StatusCallback callback);
+
+  // Send request of StoreService, the context of request is filled by region router.
+  template <typename Request, typename Response>
+  void SendRequest(int64_t region_id, const std::string& api_name, const Request& request,
+                   ResponseCallback<Response> callback);
+
+  // Send the pending batches now.
+  void Flush();
+
+ private:
+  template <typename Request, typename Response>
+  friend class AsyncCall;
+
+  struct RegionState {
+    int64_t region_id{0};
+    // replaced on region epoch change, access by std::atomic_load/std::atomic_store
+    std::shared_ptr<const std::vector<butil::EndPoint>> endpoints;
+    std::atomic<int> leader_index{0};
+
+    // requests wait for sending when inflight is full, protected by client mutex_
+    int64_t inflight{0};
+    std::deque<std::function<void()>> waiting;
+
+    // pending batches, protected by client mutex_
+    std::vector<std::string> get_keys;
+    std::vector<KvGetCallback> get_callbacks;
+    int64_t get_pending_time_us{0};
+    std::vector<dingodb::pb::common::KeyValue> put_kvs;
+    std::vector<StatusCallback> put_callbacks;
+    int64_t put_pending_time_us{0};
+  };
+  using RegionStatePtr = std::shared_ptr<RegionState>;
+
+  RegionStatePtr GetRegionState(int64_t region_id);
+  // Reload the peers of region from router after the region entry is updated.
+  static void RefreshRegionState(RegionStatePtr region);
+
+  // Run send now if inflight is not full, otherwise queue it.
+  void Dispatch(RegionStatePtr region, std::function<void()> send);
+  // A request of region is done, send the next waiting one.
+  void Done(RegionStatePtr region);
+
+  // Take the pending batch of region, caller hold mutex_.
+  std::function<void()> TakeGetBatch(RegionStatePtr region);
+  std::function<void()> TakePutBatch(RegionStatePtr region);
+  // Send the batches pending longer than delay_us.
+  void FlushBatches(int64_t delay_us);
+  // Time until the oldest pending batch is due, -1 if no pending batch, caller hold mutex_.
+  int64_t NextFlushWaitUs();
+
+  static void* FlushRoutine(void* arg);
+
+  int64_t max_batch_size_;
+  int64_t batch_delay_us_;
+  int64_t max_inflight_;
+
+  bthread::Mutex mutex_;
+  std::map<int64_t, RegionStatePtr> regions_;
+  // requests dispatched and not done, include the waiting ones
+  int64_t pending_call_count_{0};
+  // signaled when pending_call_count_ is 0
+  bthread::ConditionVariable drain_cond_;
+  // signaled when a batch begins pending or stop
+  bthread::ConditionVariable flush_cond_;
+
+  std::atomic<bool> is_stop_{false};
+  bthread_t flush_tid_{0};
+};
+
+// One asynchronous rpc of a region, retry on leader change and region epoch change like ServerInteraction.
+// It deletes itself after the callback.
+template <typename Request, typename Response>
+class AsyncCall : public google::protobuf::Closure {
+ public:
+  AsyncCall(AsyncStoreClient* client, AsyncStoreClient::RegionStatePtr region,
+            const google::protobuf::MethodDescriptor* method, const Request& request,
+            AsyncStoreClient::ResponseCallback<Response> callback)
+      : client_(client), region_(region), method_(method), request_(request), callback_(std::move(callback)) {
+    *request_.mutable_context() = RegionRouter::GetInstance().GenConext(region_->region_id);
+  }
+  ~AsyncCall() override = default;
+
+  void Send() {
+    endpoints_ = std::atomic_load(&region_->endpoints);
+    leader_index_ = region_->leader_index.load(std::memory_order_relaxed) % endpoints_->size();
+    auto channel = ChannelPool::GetInstance().GetChannel(endpoints_->at(leader_index_));
+    if (channel == nullptr) {
+      Finish(butil::Status(dingodb::pb::error::EINTERNAL, "Init channel failed"));
+      return;
+    }
+
+    cntl_ = std::make_unique<brpc::Controller>();
+    cntl_->set_timeout_ms(FLAGS_timeout_ms);
+    response_.Clear();
+    channel->CallMethod(method_, cntl_.get(), &request_, &response_, this);
+  }
+
+  void Run() override {
+    if (cntl_->Failed()) {
+      // host down
+      if (cntl_->ErrorCode() == EHOSTDOWN && Retry()) {
+        NextLeader();
+        Send();
+        return;
+      }
+      Finish(butil::Status(cntl_->ErrorCode(), cntl_->ErrorText()));
+      return;
+    }
+
+    auto errcode = response_.error().errcode();
+    if ((errcode == dingodb::pb::error::ERAFT_NOTLEADER || errcode == dingodb::pb::error::EREGION_NOT_FOUND) &&
+        Retry()) {
+      NextLeader(response_.error().leader_location());
+      Send();
+      return;
+    }
+    if (errcode == dingodb::pb::error::EREGION_VERSION && Retry()) {
+      RegionRouter::GetInstance().UpdateRegionEntry(response_.error().store_region_info());
+      AsyncStoreClient::RefreshRegionState(region_);
+      *request_.mutable_context() = RegionRouter::GetInstance().GenConext(region_->region_id);
+      Send();
+      return;
+    }
+
+    if (errcode != dingodb::pb::error::OK) {
+      Finish(butil::Status(errcode, response_.error().errmsg()));
+    } else {
+      Finish(butil::Status());
+    }
+  }
+
+ private:
+  bool Retry() { return ++retry_count_ < kMaxRetry; }
+
+  void NextLeader() {
+    int next_leader_index = (leader_index_ + 1) % endpoints_->size();
+    region_->leader_index.compare_exchange_weak(leader_index_, next_leader_index);
+  }
+
+  void NextLeader(const dingodb::pb::common::Location& location) {
+    auto endpoints = Helper::StringToEndpoints(fmt::format("{}:{}", location.host(), location.port()));
+    if (location.port() != 0 && !endpoints.empty()) {
+      for (int i = 0; i < endpoints_->size(); ++i) {
+        if (endpoints_->at(i) == endpoints[0]) {
+          region_->leader_index.store(i);
+          return;
+        }
+      }
+    }
+    NextLeader();
+  }
+
+  void Finish(const butil::Status& status) {
+    std::unique_ptr<AsyncCall> self_guard(this);
+    if (callback_ != nullptr) {
+      callback_(status, response_);
+    }
+    client_->Done(region_);
+  }
+
+  AsyncStoreClient* client_;
+  AsyncStoreClient::RegionStatePtr region_;
+  const google::protobuf::MethodDescriptor* method_;
+  Request request_;
+  Response response_;
+  AsyncStoreClient::ResponseCallback<Response> callback_;
+
+  std::unique_ptr<brpc::Controller> cntl_;
+  // the endpoints of region when send
+  std::shared_ptr<const std::vector<butil::EndPoint>> endpoints_;
+  int leader_index_{0};
+  int retry_count_{0};
+};
+
+template <typename Request, typename Response>
+void AsyncStoreClient::SendRequest(int64_t region_id, const std::string& api_name, const Request& request,
+                                   ResponseCallback<Response> callback) {
+  auto region = GetRegionState(region_id);
+  if (region == nullptr) {
+    if (callback != nullptr) {
+      callback(butil::Status(dingodb::pb::error::EREGION_NOT_FOUND, "Not found region %ld", region_id), Response());
+    }
+    return;
+  }
+
+  const auto* method = dingodb::pb::store::StoreService::descriptor()->FindMethodByName(api_name);
+  if (method == nullptr) {
+    DINGO_LOG(FATAL) << "Unknown api name: " << api_name;
+  }
+
+  auto* call = new AsyncCall<Request, Response>(this, region, method, request, std::move(callback));
+  Dispatch(region, [call]() { call->Send(); });
+}
+
+}  // namespace client
+
+#endif  // DINGODB_CLIENT_ASYNC_H_
@@ -24,6 +24,34 @@
 
 namespace client {
 
+ChannelPool::ChannelPool() { bthread_mutex_init(&mutex_, nullptr); }
+
+ChannelPool::~ChannelPool() { bthread_mutex_destroy(&mutex_); }
+
+ChannelPool& ChannelPool::GetInstance() {
+  static ChannelPool instance;
+  return instance;
+}
+
+std::shared_ptr<brpc::Channel> ChannelPool::GetChannel(const butil::EndPoint& endpoint) {
+  BAIDU_SCOPED_LOCK(mutex_);
+
+  auto it = channels_.find(endpoint);
+  if (it != channels_.end()) {
+    return it->second;
+  }
+
+  DINGO_LOG(INFO) << fmt::format("Init channel {}:{}", butil::ip2str(endpoint.ip).c_str(), endpoint.port);
+  auto channel = std::make_shared<brpc::Channel>();
+  if (channel->Init(endpoint, nullptr) != 0) {
+    DINGO_LOG(ERROR) << fmt::format("Init channel failed, {}:{}", butil::ip2str(endpoint.ip).c_str(), endpoint.port);
+    return nullptr;
+  }
+
+  channels_.insert(std::make_pair(endpoint, channel));
+  return channel;
+}
+
 bool ServerInteraction::Init(const std::string& addrs) {
   std::vector<std::string> vec_addrs;
   butil::SplitString(addrs, ',', &vec_addrs);
@@ -39,13 +67,11 @@ bool ServerInteraction::Init(std::vector<std::string> addrs) {
   }
 
   for (auto& endpoint : endpoints_) {
-    DINGO_LOG(INFO) << fmt::format("Init channel {}:{}", butil::ip2str(endpoint.ip).c_str(), endpoint.port);
-    std::unique_ptr<brpc::Channel> channel = std::make_unique<brpc::Channel>();
-    if (channel->Init(endpoint, nullptr) != 0) {
-      DINGO_LOG(ERROR) << fmt::format("Init channel failed, {}:{}", butil::ip2str(endpoint.ip).c_str(), endpoint.port);
+    auto channel = ChannelPool::GetInstance().GetChannel(endpoint);
+    if (channel == nullptr) {
       return false;
     }
-    channels_.push_back(std::move(channel));
+    channels_.push_back(channel);
   }
 
   return true;
@@ -54,13 +80,12 @@ bool ServerInteraction::Init(std::vector<std::string> addrs) {
 bool ServerInteraction::AddAddr(const std::string& addr) {
   butil::EndPoint endpoint = dingodb::Helper::StringToEndPoint(addr);
 
-  std::unique_ptr<brpc::Channel> channel = std::make_unique<brpc::Channel>();
-  if (channel->Init(endpoint, nullptr) != 0) {
-    DINGO_LOG(ERROR) << fmt::format("Init channel failed, {}:{}", butil::ip2str(endpoint.ip).c_str(), endpoint.port);
+  auto channel = ChannelPool::GetInstance().GetChannel(endpoint);
+  if (channel == nullptr) {
     return false;
   }
 
-  channels_.push_back(std::move(channel));
+  channels_.push_back(channel);
   endpoints_.push_back(endpoint);
 
   return true;
@@ -98,6 +123,27 @@ void ServerInteraction::NextLeader(const dingodb::pb::common::Location& location
   }
 }
 
+void ServerInteraction::CallVectorSearchPacked(const google::protobuf::MethodDescriptor* method,
+                                               brpc::Controller& cntl, int leader_index,
+                                               const dingodb::pb::index::VectorSearchRequest& request,
+                                               dingodb::pb::index::VectorSearchResponse& response) {
+  dingodb::pb::index::VectorSearchRequest packed_request = request;
+  dingodb::VectorPackedCodec::Pack(dingodb::VectorPackedCodec::VectorWithIds(&packed_request),
+                                   cntl.request_attachment());
+  channels_[leader_index]->CallMethod(method, &cntl, &packed_request, &response, nullptr);
+  if (cntl.Failed() || cntl.response_attachment().empty()) {
+    return;
+  }
+
+  auto vector_with_ids = dingodb::VectorPackedCodec::VectorWithIds(&response);
+  auto status = dingodb::VectorPackedCodec::Unpack(vector_with_ids, cntl.response_attachment());
+  if (!status.ok()) {
+    DINGO_LOG(ERROR) << fmt::format("unpack vector search response failed, error: {}", status.error_str());
+    response.mutable_error()->set_errcode(static_cast<dingodb::pb::error::Errno>(status.error_code()));
+    response.mutable_error()->set_errmsg(status.error_str());
+  }
+}
+
 InteractionManager::InteractionManager() { bthread_mutex_init(&mutex_, nullptr); }
 
 InteractionManager::~InteractionManager() { bthread_mutex_destroy(&mutex_); }
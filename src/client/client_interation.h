@@ -23,6 +23,7 @@
 #include <numeric>
 #include <random>
 #include <string>
+#include <type_traits>
 #include <vector>
 
 #include "brpc/channel.h"
@@ -41,14 +42,31 @@
 #include "proto/meta.pb.h"
 #include "proto/store.pb.h"
 #include "proto/util.pb.h"
+#include "vector/vector_packed_codec.h"
 
 DECLARE_bool(log_each_request);
 DECLARE_int64(timeout_ms);
+DECLARE_bool(vector_packed_encoding);
 
 namespace client {
 
 const int kMaxRetry = 5;
 
+// Channels shared by all interactions of the process, one channel per endpoint.
+class ChannelPool {
+ public:
+  static ChannelPool& GetInstance();
+
+  std::shared_ptr<brpc::Channel> GetChannel(const butil::EndPoint& endpoint);
+
+ private:
+  ChannelPool();
+  ~ChannelPool();
+
+  bthread_mutex_t mutex_;
+  std::map<butil::EndPoint, std::shared_ptr<brpc::Channel> > channels_;
+};
+
 class ServerInteraction {
  public:
   ServerInteraction() : leader_index_(0){};
@@ -77,9 +95,14 @@ class ServerInteraction {
   int64_t GetLatency() const { return latency_; }
 
  private:
+  // the vectors of request and response are packed in attachment, see VectorPackedCodec
+  void CallVectorSearchPacked(const google::protobuf::MethodDescriptor* method, brpc::Controller& cntl,
+                              int leader_index, const dingodb::pb::index::VectorSearchRequest& request,
+                              dingodb::pb::index::VectorSearchResponse& response);
+
   std::atomic<int> leader_index_;
   std::vector<butil::EndPoint> endpoints_;
-  std::vector<std::unique_ptr<brpc::Channel> > channels_;
+  std::vector<std::shared_ptr<brpc::Channel> > channels_;
   int64_t latency_;
 };
 
@@ -118,7 +141,15 @@ butil::Status ServerInteraction::SendRequest(const std::string& service_name, co
     cntl.set_timeout_ms(FLAGS_timeout_ms);
     cntl.set_log_id(butil::fast_rand());
     const int leader_index = GetLeader();
-    channels_[leader_index]->CallMethod(method, &cntl, &request, &response, nullptr);
+    if constexpr (std::is_same_v<Request, dingodb::pb::index::VectorSearchRequest>) {
+      if (FLAGS_vector_packed_encoding) {
+        CallVectorSearchPacked(method, cntl, leader_index, request, response);
+      } else {
+        channels_[leader_index]->CallMethod(method, &cntl, &request, &response, nullptr);
+      }
+    } else {
+      channels_[leader_index]->CallMethod(method, &cntl, &request, &response, nullptr);
+    }
     if (FLAGS_log_each_request) {
       DINGO_LOG(INFO) << fmt::format("send request api [{}] {} response: {} request: {}", leader_index, api_name,
                                      response.ShortDebugString().substr(0, 256),
@@ -17,6 +17,7 @@
 #include <memory>
 #include <utility>
 
+#include "bthread/bthread.h"
 #include "client/client_interation.h"
 
 namespace client {
@@ -94,13 +95,49 @@ RegionRouter& RegionRouter::GetInstance() {
 void RegionRouter::AddRegionEntry(const dingodb::pb::common::Region& region) {
   BAIDU_SCOPED_LOCK(mutex_);
 
-  route_map_.insert_or_assign(region.definition().range().start_key(), RegionEntry::New(region));
+  PutRegionEntry(RegionEntry::New(region));
 }
 
 void RegionRouter::AddRegionEntry(RegionEntryPtr region) {
   BAIDU_SCOPED_LOCK(mutex_);
 
-  route_map_.insert_or_assign(region->Range().start_key(), region);
+  PutRegionEntry(region);
+}
+
+void RegionRouter::PutRegionEntry(RegionEntryPtr region_entry) {
+  EraseRegionEntry(region_entry->RegionId());
+
+  // after split/merge the old ranges overlap with the new one are stale
+  const auto& range = region_entry->Range();
+  auto it = route_map_.upper_bound(range.start_key());
+  if (it != route_map_.begin()) {
+    --it;
+  }
+  while (it != route_map_.end() && (range.end_key().empty() || it->first < range.end_key())) {
+    const auto& other_range = it->second->Range();
+    if (other_range.end_key().empty() || other_range.end_key() > range.start_key()) {
+      id_map_.erase(it->second->RegionId());
+      it = route_map_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+
+  route_map_.insert_or_assign(range.start_key(), region_entry);
+  id_map_.insert_or_assign(region_entry->RegionId(), region_entry);
+}
+
+void RegionRouter::EraseRegionEntry(int64_t region_id) {
+  auto it = id_map_.find(region_id);
+  if (it == id_map_.end()) {
+    return;
+  }
+
+  auto route_it = route_map_.find(it->second->Range().start_key());
+  if (route_it != route_map_.end() && route_it->second == it->second) {
+    route_map_.erase(route_it);
+  }
+  id_map_.erase(it);
 }
 
 RegionEntryPtr RegionRouter::AddRegionEntry(int64_t region_id) {
@@ -126,12 +163,15 @@ void RegionRouter::UpdateRegionEntry(const dingodb::pb::error::StoreRegionInfo&
 RegionEntryPtr RegionRouter::QueryRegionEntry(const std::string& key) {
   BAIDU_SCOPED_LOCK(mutex_);
 
-  auto it = route_map_.lower_bound(key);
-  if (it == route_map_.end()) {
+  // the region contain key is the last one whose start_key <= key
+  auto it = route_map_.upper_bound(key);
+  if (it == route_map_.begin()) {
     return nullptr;
   }
+  --it;
   auto region_entry = it->second;
   if (region_entry->IsDirty()) {
+    UpdateRegion(region_entry);
   }
 
   const auto& range = region_entry->Range();
@@ -148,11 +188,9 @@ RegionEntryPtr RegionRouter::QueryRegionEntry(int64_t region_id) {
   {
     BAIDU_SCOPED_LOCK(mutex_);
 
-    for (auto& [_, temp_region_entry] : route_map_) {
-      if (temp_region_entry->RegionId() == region_id) {
-        region_entry = temp_region_entry;
-        break;
-      }
+    auto it = id_map_.find(region_id);
+    if (it != id_map_.end()) {
+      region_entry = it->second;
     }
   }
 
@@ -208,6 +246,115 @@ dingodb::pb::store::Context RegionRouter::GenConext(int64_t region_id) {
   return {};
 }
 
+static bool IsOlderEpoch(const dingodb::pb::common::RegionEpoch& epoch,
+                         const dingodb::pb::common::RegionEpoch& other_epoch) {
+  return epoch.version() < other_epoch.version() ||
+         (epoch.version() == other_epoch.version() && epoch.conf_version() < other_epoch.conf_version());
+}
+
+void RegionRouter::ApplyRegionEvent(const dingodb::pb::meta::MetaEvent& event) {
+  const auto& region = event.region();
+
+  BAIDU_SCOPED_LOCK(mutex_);
+
+  auto it = id_map_.find(region.id());
+  if (it != id_map_.end() && IsOlderEpoch(region.definition().epoch(), it->second->Epoch())) {
+    return;
+  }
+
+  switch (event.event_type()) {
+    case dingodb::pb::meta::MetaEventType::META_EVENT_REGION_CREATE:
+    case dingodb::pb::meta::MetaEventType::META_EVENT_REGION_UPDATE: {
+      // watch event not carry leader and status, keep them from cache
+      dingodb::pb::common::Region new_region = region;
+      if (it != id_map_.end()) {
+        new_region.set_leader_store_id(it->second->Region().leader_store_id());
+        *new_region.mutable_status() = it->second->Region().status();
+      }
+      PutRegionEntry(RegionEntry::New(new_region));
+      break;
+    }
+    case dingodb::pb::meta::MetaEventType::META_EVENT_REGION_DELETE:
+      EraseRegionEntry(region.id());
+      break;
+    default:
+      break;
+  }
+}
+
+void RegionRouter::MarkAllDirty() {
+  BAIDU_SCOPED_LOCK(mutex_);
+
+  for (auto& [_, region_entry] : id_map_) {
+    region_entry->SetDirty(true);
+  }
+}
+
+bool RegionRouter::StartWatch() {
+  if (is_watching_.exchange(true)) {
+    return true;
+  }
+
+  if (bthread_start_background(&watch_tid_, nullptr, &RegionRouter::WatchRoutine, this) != 0) {
+    DINGO_LOG(ERROR) << "[router.watch] start watch bthread failed.";
+    is_watching_.store(false);
+    return false;
+  }
+
+  return true;
+}
+
+void RegionRouter::StopWatch() { is_watching_.store(false); }
+
+void* RegionRouter::WatchRoutine(void* arg) {
+  auto* self = static_cast<RegionRouter*>(arg);
+
+  int64_t watch_id = 0;
+  while (self->is_watching_.load()) {
+    if (watch_id == 0) {
+      dingodb::pb::meta::WatchRequest request;
+      dingodb::pb::meta::WatchResponse response;
+      auto* create_request = request.mutable_create_request();
+      create_request->add_event_types(dingodb::pb::meta::MetaEventType::META_EVENT_REGION_CREATE);
+      create_request->add_event_types(dingodb::pb::meta::MetaEventType::META_EVENT_REGION_UPDATE);
+      create_request->add_event_types(dingodb::pb::meta::MetaEventType::META_EVENT_REGION_DELETE);
+
+      auto status = InteractionManager::GetInstance().SendRequestWithoutContext("MetaService", "Watch", request,
+                                                                                 response);
+      if (!status.ok() || response.watch_id() == 0) {
+        DINGO_LOG(WARNING) << fmt::format("[router.watch] create watch failed, error: {}", status.error_str());
+        bthread_usleep(1000 * 1000);
+        continue;
+      }
+
+      watch_id = response.watch_id();
+      // events before the watch created may be lost, refresh all cached region on next use
+      self->MarkAllDirty();
+      DINGO_LOG(INFO) << fmt::format("[router.watch] create watch success, watch_id: {}", watch_id);
+    }
+
+    dingodb::pb::meta::WatchRequest request;
+    dingodb::pb::meta::WatchResponse response;
+    request.mutable_progress_request()->set_watch_id(watch_id);
+    auto status = InteractionManager::GetInstance().SendRequestWithoutContext("MetaService", "Watch", request, response);
+    if (!status.ok()) {
+      if (status.error_code() != brpc::ERPCTIMEDOUT) {
+        DINGO_LOG(WARNING) << fmt::format("[router.watch] progress watch {} failed, error: {}", watch_id,
+                                          status.error_str());
+        watch_id = 0;
+        bthread_usleep(1000 * 1000);
+      }
+      continue;
+    }
+
+    for (const auto& event : response.events()) {
+      self->ApplyRegionEvent(event);
+    }
+  }
+
+  return nullptr;
+}
+
 bool RegionRouter::UpdateRegion(RegionEntryPtr region_entry) {
   auto region = SendQueryRegion(region_entry->RegionId());
   if (region.id() == 0) {
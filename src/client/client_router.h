@@ -17,13 +17,16 @@
 
 #include <atomic>
 #include <cstdint>
+#include <map>
 #include <memory>
 #include <string>
 #include <vector>
 
 #include "bthread/mutex.h"
+#include "bthread/types.h"
 #include "proto/common.pb.h"
 #include "proto/error.pb.h"
+#include "proto/meta.pb.h"
 #include "proto/store.pb.h"
 
 namespace client {
@@ -83,13 +86,32 @@ class RegionRouter {
 
   dingodb::pb::store::Context GenConext(int64_t region_id);
 
+  // apply region event of coordinator meta watch, older epoch than cached is ignored
+  void ApplyRegionEvent(const dingodb::pb::meta::MetaEvent& event);
+
+  // watch region events in background, so route is fresh before hit region error
+  bool StartWatch();
+  void StopWatch();
+
  private:
   static bool UpdateRegion(RegionEntryPtr region_entry);
 
+  static void* WatchRoutine(void* arg);
+  void MarkAllDirty();
+
+  // put region entry and remove the stale entries overlap with it, caller hold mutex_
+  void PutRegionEntry(RegionEntryPtr region_entry);
+  void EraseRegionEntry(int64_t region_id);
+
   // key: the start_key of region range
   // value: RegionEntry
   std::map<std::string, RegionEntryPtr> route_map_;
+  // key: region id
+  std::map<int64_t, RegionEntryPtr> id_map_;
   bthread_mutex_t mutex_;
+
+  std::atomic<bool> is_watching_{false};
+  bthread_t watch_tid_{0};
 };
 
 }  // namespace client
@@ -149,6 +149,7 @@ void SendGetAutoIncrement(std::shared_ptr<dingodb::CoordinatorInteraction> coord
 void SendCreateAutoIncrement(std::shared_ptr<dingodb::CoordinatorInteraction> coordinator_interaction);
 void SendUpdateAutoIncrement(std::shared_ptr<dingodb::CoordinatorInteraction> coordinator_interaction);
 void SendGenerateAutoIncrement(std::shared_ptr<dingodb::CoordinatorInteraction> coordinator_interaction);
+void SendGenerateAutoIncrementCached(std::shared_ptr<dingodb::CoordinatorInteraction> coordinator_interaction);
 void SendDeleteAutoIncrement(std::shared_ptr<dingodb::CoordinatorInteraction> coordinator_interaction);
 
 // lease
@@ -172,6 +173,7 @@ void SendLock(std::shared_ptr<dingodb::CoordinatorInteraction> coordinator_inter
 
 // tso
 void SendGenTso(std::shared_ptr<dingodb::CoordinatorInteraction> coordinator_interaction);
+void SendGenTsoBatch(std::shared_ptr<dingodb::CoordinatorInteraction> coordinator_interaction);
 void SendResetTso(std::shared_ptr<dingodb::CoordinatorInteraction> coordinator_interaction);
 void SendUpdateTso(std::shared_ptr<dingodb::CoordinatorInteraction> coordinator_interaction);
 
@@ -13,10 +13,15 @@
 // limitations under the License.
 
 #include <memory>
+#include <vector>
 
+#include "bthread/bthread.h"
+#include "common/helper.h"
 #include "common/logging.h"
+#include "coordinator/auto_increment_id_cache.h"
 #include "coordinator/coordinator_interaction.h"
 #include "coordinator_client_function.h"
+#include "fmt/core.h"
 
 DEFINE_int64(incr_start_id, 1, "Start id of auto_increment.");
 DEFINE_bool(force, true, "Force set auto increment.");
@@ -26,6 +31,8 @@ DEFINE_int32(auto_increment_offset, 1, "SQL var auto_increment_offset.");
 
 DECLARE_bool(log_each_request);
 DECLARE_string(id);
+DECLARE_int32(thread_num);
+DECLARE_int32(req_num);
 
 // usage example:
 
@@ -33,6 +40,7 @@ DECLARE_string(id);
 // ./dingodb_client -id=888 -method=CreateAutoIncrement
 // ./dingodb_client -id=888 -method=GetAutoIncrement
 // ./dingodb_client -id=888 -generate_count=10000 -method=GenerateAutoIncrement
+// ./dingodb_client -id=888 -generate_count=10000 -thread_num=8 -req_num=100000 -method=GenerateAutoIncrementCached
 // ./dingodb_client -id=888 -incr_start_id=110000 -method=UpdateAutoIncrement
 // ./dingodb_client -id=888 -method=DeleteAutoIncrement
 
@@ -122,6 +130,85 @@ void SendGenerateAutoIncrement(std::shared_ptr<dingodb::CoordinatorInteraction>
   DINGO_LOG(INFO) << response.DebugString();
 }
 
+// Concurrent thread_num bthreads each get req_num ids one by one from a cache of generate_count ids segment.
+void SendGenerateAutoIncrementCached(std::shared_ptr<dingodb::CoordinatorInteraction> coordinator_interaction) {
+  if (FLAGS_id.empty()) {
+    DINGO_LOG(WARNING) << "id is empty";
+    return;
+  }
+  if (FLAGS_thread_num <= 0 || FLAGS_req_num <= 0) {
+    DINGO_LOG(ERROR) << "thread_num and req_num should be positive";
+    return;
+  }
+  int64_t table_id = std::stol(FLAGS_id);
+
+  dingodb::AutoIncrementIdCache id_cache(
+      [coordinator_interaction, table_id](uint32_t count, int64_t& start_id, int64_t& end_id) -> butil::Status {
+        dingodb::pb::meta::GenerateAutoIncrementRequest request;
+        dingodb::pb::meta::GenerateAutoIncrementResponse response;
+        request.mutable_table_id()->set_entity_type(dingodb::pb::meta::EntityType::ENTITY_TYPE_TABLE);
+        request.mutable_table_id()->set_entity_id(table_id);
+        request.set_count(count);
+        request.set_auto_increment_increment(FLAGS_auto_increment_increment);
+        request.set_auto_increment_offset(FLAGS_auto_increment_offset);
+
+        auto status = coordinator_interaction->SendRequest("GenerateAutoIncrement", request, response);
+        if (!status.ok()) {
+          return status;
+        }
+        start_id = response.start_id();
+        end_id = response.end_id();
+        return butil::Status::OK();
+      },
+      FLAGS_generate_count, FLAGS_auto_increment_increment, FLAGS_auto_increment_offset);
+
+  struct Param {
+    dingodb::AutoIncrementIdCache* id_cache;
+    int64_t last_id{0};
+    int64_t fail_count{0};
+  };
+
+  std::vector<Param> params(FLAGS_thread_num, Param{&id_cache});
+  std::vector<bthread_t> tids(FLAGS_thread_num);
+  int64_t start_time = dingodb::Helper::TimestampMs();
+  for (int i = 0; i < FLAGS_thread_num; ++i) {
+    if (bthread_start_background(
+            &tids[i], nullptr,
+            [](void* arg) -> void* {
+              auto* param = static_cast<Param*>(arg);
+              for (int j = 0; j < FLAGS_req_num; ++j) {
+                int64_t id = 0;
+                auto status = param->id_cache->GenerateId(id);
+                if (!status.ok()) {
+                  ++param->fail_count;
+                  continue;
+                }
+                CHECK(id > param->last_id) << "id fallback, " << id << " <= " << param->last_id;
+                param->last_id = id;
+              }
+              return nullptr;
+            },
+            &params[i]) != 0) {
+      DINGO_LOG(ERROR) << "Fail to create bthread";
+      tids[i] = 0;
+    }
+  }
+
+  int64_t fail_count = 0;
+  for (int i = 0; i < FLAGS_thread_num; ++i) {
+    if (tids[i] != 0) {
+      bthread_join(tids[i], nullptr);
+    }
+    fail_count += params[i].fail_count;
+  }
+
+  DINGO_LOG(INFO) << fmt::format(
+      "generate auto increment cached, thread_num: {}, req_num: {}, fail_count: {}, rpc_count: {}, segment_count: {}, "
+      "elapsed_ms: {}",
+      FLAGS_thread_num, FLAGS_req_num, fail_count, id_cache.FetchCount(), FLAGS_generate_count,
+      dingodb::Helper::TimestampMs() - start_time);
+}
+
 void SendDeleteAutoIncrement(std::shared_ptr<dingodb::CoordinatorInteraction> coordinator_interaction) {
   dingodb::pb::meta::DeleteAutoIncrementRequest request;
   dingodb::pb::meta::DeleteAutoIncrementResponse response;
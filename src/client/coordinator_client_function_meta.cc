@@ -17,18 +17,23 @@
 #include <string>
 #include <vector>
 
+#include "bthread/bthread.h"
 #include "client/client_helper.h"
 #include "client/coordinator_client_function.h"
 #include "common/helper.h"
 #include "common/logging.h"
 #include "coordinator/coordinator_interaction.h"
+#include "coordinator/tso_batcher.h"
 #include "coordinator/tso_control.h"
+#include "fmt/core.h"
 #include "gflags/gflags_declare.h"
 #include "proto/common.pb.h"
 #include "proto/meta.pb.h"
 
 DECLARE_bool(log_each_request);
 DECLARE_int64(timeout_ms);
+DECLARE_int32(thread_num);
+DECLARE_int32(req_num);
 DECLARE_string(id);
 DECLARE_string(name);
 DECLARE_string(comment);
@@ -1485,6 +1490,76 @@ void SendGenTso(std::shared_ptr<dingodb::CoordinatorInteraction> coordinator_int
   }
 }
 
+// Concurrent thread_num bthreads each get req_num timestamps one by one, the waiters share the in flight request.
+void SendGenTsoBatch(std::shared_ptr<dingodb::CoordinatorInteraction> coordinator_interaction) {
+  if (FLAGS_thread_num <= 0 || FLAGS_req_num <= 0) {
+    DINGO_LOG(ERROR) << "thread_num and req_num should be positive";
+    return;
+  }
+
+  dingodb::TsoBatcher tso_batcher(
+      [coordinator_interaction](int64_t count, int64_t& start_ts) -> butil::Status {
+        dingodb::pb::meta::TsoRequest request;
+        dingodb::pb::meta::TsoResponse response;
+        request.set_op_type(::dingodb::pb::meta::TsoOpType::OP_GEN_TSO);
+        request.set_count(count);
+
+        auto status = coordinator_interaction->SendRequest("TsoService", request, response);
+        if (!status.ok()) {
+          return status;
+        }
+        start_ts =
+            (response.start_timestamp().physical() << ::dingodb::kLogicalBits) + response.start_timestamp().logical();
+        return butil::Status::OK();
+      },
+      FLAGS_count);
+
+  struct Param {
+    dingodb::TsoBatcher* tso_batcher;
+    int64_t last_tso{0};
+    int64_t fail_count{0};
+  };
+
+  std::vector<Param> params(FLAGS_thread_num, Param{&tso_batcher});
+  std::vector<bthread_t> tids(FLAGS_thread_num);
+  int64_t start_time = dingodb::Helper::TimestampMs();
+  for (int i = 0; i < FLAGS_thread_num; ++i) {
+    if (bthread_start_background(
+            &tids[i], nullptr,
+            [](void* arg) -> void* {
+              auto* param = static_cast<Param*>(arg);
+              for (int j = 0; j < FLAGS_req_num; ++j) {
+                int64_t tso = 0;
+                auto status = param->tso_batcher->GetTso(tso);
+                if (!status.ok()) {
+                  ++param->fail_count;
+                  continue;
+                }
+                CHECK(tso > param->last_tso) << "tso fallback, " << tso << " <= " << param->last_tso;
+                param->last_tso = tso;
+              }
+              return nullptr;
+            },
+            &params[i]) != 0) {
+      DINGO_LOG(ERROR) << "Fail to create bthread";
+      tids[i] = 0;
+    }
+  }
+
+  int64_t fail_count = 0;
+  for (int i = 0; i < FLAGS_thread_num; ++i) {
+    if (tids[i] != 0) {
+      bthread_join(tids[i], nullptr);
+    }
+    fail_count += params[i].fail_count;
+  }
+
+  DINGO_LOG(INFO) << fmt::format(
+      "gen tso batch, thread_num: {}, req_num: {}, fail_count: {}, rpc_count: {}, max_batch_count: {}, elapsed_ms: {}",
+      FLAGS_thread_num, FLAGS_req_num, fail_count, tso_batcher.FetchCount(), FLAGS_count,
+      dingodb::Helper::TimestampMs() - start_time);
+}
+
 void SendResetTso(std::shared_ptr<dingodb::CoordinatorInteraction> coordinator_interaction) {
   dingodb::pb::meta::TsoRequest request;
   dingodb::pb::meta::TsoResponse response;
@@ -25,7 +25,9 @@
 #include "bthread/bthread.h"
 #include "client/client_helper.h"
 #include "client/client_interation.h"
+#include "client/client_router.h"
 #include "client/coordinator_client_function.h"
+#include "client/store_client_bench.h"
 #include "client/store_client_function.h"
 #include "client/store_tool_dump.h"
 #include "common/helper.h"
@@ -40,6 +42,7 @@ DEFINE_bool(log_each_request, false, "Print log for each request");
 DEFINE_bool(use_bthread, false, "Use bthread to send requests");
 DEFINE_int32(thread_num, 1, "Number of threads sending requests");
 DEFINE_int64(timeout_ms, 60000, "Timeout for each request");
+DEFINE_bool(vector_packed_encoding, false, "Pack the float vectors of vector search in attachment");
 DEFINE_int32(req_num, 1, "Number of requests");
 DEFINE_string(method, "", "Request method");
 DEFINE_string(id, "", "Request parameter id, for example: table_id for CreateTable/DropTable");
@@ -67,6 +70,7 @@ DEFINE_int64(store_id, 0, "store_id");
 DEFINE_int64(start_region_cmd_id, 0, "start_region_cmd_id");
 DEFINE_int64(end_region_cmd_id, 0, "end_region_cmd_id");
 DEFINE_int64(region_id, 0, "region_id");
+DEFINE_int64(document_region_id, 0, "document region id of hybrid search");
 DEFINE_int64(region_cmd_id, 0, "region_cmd_id");
 DEFINE_int64(task_list_id, 0, "task_list_id");
 DEFINE_string(store_ids, "1001,1002,1003", "store_ids splited by ,");
@@ -123,6 +127,9 @@ DEFINE_bool(print_vector_search_delay, false, "print vector search delay");
 DEFINE_int32(offset, 0, "offset");
 DEFINE_int64(limit, 50, "limit");
 DEFINE_bool(is_reverse, false, "is_revers");
+DEFINE_int32(scan_page_size, 1000, "Page size of each scan continue request");
+DEFINE_bool(scan_ordered, false, "Emit parallel scan results in key order");
+DEFINE_bool(region_router_watch, false, "Keep client region route fresh by coordinator region watch");
 DEFINE_string(scalar_filter_key, "", "Request scalar_filter_key");
 DEFINE_string(scalar_filter_value, "", "Request scalar_filter_value");
 DEFINE_string(scalar_filter_key2, "", "Request scalar_filter_key");
@@ -369,6 +376,12 @@ void Sender(std::shared_ptr<client::Context> ctx, const std::string& method, int
       client::SendKvDeleteRange(FLAGS_region_id, FLAGS_prefix);
     } else if (method == "KvScan") {
       client::SendKvScan(FLAGS_region_id, FLAGS_prefix);
+    } else if (method == "KvParallelScan") {
+      if (FLAGS_table_id == 0) {
+        DINGO_LOG(ERROR) << "Param table_id is error.";
+        return;
+      }
+      client::SendKvParallelScan(FLAGS_table_id, FLAGS_thread_num, FLAGS_scan_page_size, FLAGS_scan_ordered);
     } else if (method == "KvCompareAndSet") {
       client::SendKvCompareAndSet(FLAGS_region_id, FLAGS_key);
     } else if (method == "KvBatchCompareAndSet") {
@@ -433,6 +446,8 @@ void Sender(std::shared_ptr<client::Context> ctx, const std::string& method, int
       client::SendDocumentCount(FLAGS_region_id, FLAGS_start_id, FLAGS_end_id);
     } else if (method == "DocumentGetRegionMetrics") {
       client::SendDocumentGetRegionMetrics(FLAGS_region_id);
+    } else if (method == "HybridSearch") {
+      client::SendHybridSearch(FLAGS_region_id, FLAGS_document_region_id, FLAGS_dimension, FLAGS_topn);
     }
 
     // vector operation
@@ -580,6 +595,13 @@ void Sender(std::shared_ptr<client::Context> ctx, const std::string& method, int
         return;
       }
       client::DumpDb(ctx);
+    } else if (method == "DumpDbParallel") {
+      ctx->db_path = FLAGS_db_path;
+      if (ctx->db_path.empty()) {
+        DINGO_LOG(ERROR) << "Param db_path is error.";
+        return;
+      }
+      client::DumpDbParallel(ctx);
     } else if (method == "WhichRegion") {
       ctx->table_id = FLAGS_table_id;
       ctx->index_id = FLAGS_index_id;
@@ -594,6 +616,14 @@ void Sender(std::shared_ptr<client::Context> ctx, const std::string& method, int
       }
       WhichRegion(ctx);
 
+      // Benchmark
+    } else if (method == "BenchKv") {
+      client::BenchKv(FLAGS_region_id);
+    } else if (method == "BenchTxn") {
+      client::BenchTxn(FLAGS_region_id);
+    } else if (method == "BenchVector") {
+      client::BenchVector(FLAGS_region_id, FLAGS_dimension, FLAGS_start_id);
+
       // illegal method
     } else {
       DINGO_LOG(ERROR) << "Unknown method: " << method;
@@ -924,6 +954,8 @@ int CoordinatorSender() {
     SendUpdateAutoIncrement(coordinator_interaction_meta);
   } else if (FLAGS_method == "GenerateAutoIncrement") {
     SendGenerateAutoIncrement(coordinator_interaction_meta);
+  } else if (FLAGS_method == "GenerateAutoIncrementCached") {
+    SendGenerateAutoIncrementCached(coordinator_interaction_meta);
   } else if (FLAGS_method == "DeleteAutoIncrement") {
     SendDeleteAutoIncrement(coordinator_interaction_meta);
   }
@@ -979,6 +1011,8 @@ int CoordinatorSender() {
   // tso
   else if (FLAGS_method == "GenTso") {
     SendGenTso(coordinator_interaction_meta);
+  } else if (FLAGS_method == "GenTsoBatch") {
+    SendGenTsoBatch(coordinator_interaction_meta);
   } else if (FLAGS_method == "ResetTso") {
     SendResetTso(coordinator_interaction_meta);
   } else if (FLAGS_method == "UpdateTso") {
@@ -1165,6 +1199,10 @@ int main(int argc, char* argv[]) {
     }
 
     client::InteractionManager::GetInstance().SetCoorinatorInteraction(coordinator_interaction);
+
+    if (FLAGS_region_router_watch) {
+      client::RegionRouter::GetInstance().StartWatch();
+    }
   }
 
   // this is for legacy coordinator_client use, will be removed in the future
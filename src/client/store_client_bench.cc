@@ -0,0 +1,392 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "client/store_client_bench.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "bthread/bthread.h"
+#include "bvar/latency_recorder.h"
+#include "bvar/reducer.h"
+#include "client/client_interation.h"
+#include "client/client_router.h"
+#include "client/store_client_function.h"
+#include "common/helper.h"
+#include "common/logging.h"
+#include "coordinator/tso_control.h"
+#include "fmt/core.h"
+#include "gflags/gflags.h"
+#include "proto/common.pb.h"
+#include "proto/index.pb.h"
+#include "proto/meta.pb.h"
+#include "proto/store.pb.h"
+
+DEFINE_int32(bench_concurrency, 16, "bench concurrent bthread number");
+DEFINE_int32(bench_duration_s, 60, "bench duration seconds");
+DEFINE_int32(bench_report_interval_s, 5, "bench report interval seconds");
+DEFINE_int64(bench_key_num, 100000, "bench key number, also vector number");
+DEFINE_string(bench_key_distribution, "uniform", "bench key distribution, uniform/zipf/sequential");
+DEFINE_double(bench_zipf_theta, 0.99, "bench zipf distribution theta, in (0, 1)");
+DEFINE_int32(bench_value_size, 256, "bench value size");
+DEFINE_double(bench_read_ratio, 0.5, "bench read request ratio, the others are write, in [0, 1]");
+DEFINE_int32(bench_vector_topn, 10, "bench vector search topn");
+DEFINE_double(bench_vector_filter_selectivity, 0.0,
+              "bench vector search id pre filter selectivity, the ratio of vector ids passed filter, 0 is no filter");
+
+namespace client {
+
+static const int64_t kMaxFilterVectorIdNum = 10000;
+
+BenchKeyGenerator::BenchKeyGenerator(const std::string& distribution, int64_t key_num, double zipf_theta,
+                                     uint64_t seed)
+    : key_num_(std::max(key_num, static_cast<int64_t>(1))), rng_(seed) {
+  if (distribution == "zipf") {
+    distribution_ = Distribution::kZipf;
+  } else if (distribution == "sequential") {
+    distribution_ = Distribution::kSequential;
+  } else {
+    distribution_ = Distribution::kUniform;
+  }
+
+  if (distribution_ == Distribution::kZipf) {
+    theta_ = std::clamp(zipf_theta, 0.01, 0.999);
+    for (int64_t i = 1; i <= key_num_; ++i) {
+      zetan_ += 1.0 / std::pow(static_cast<double>(i), theta_);
+    }
+    double zeta2 = 1.0 + 1.0 / std::pow(2.0, theta_);
+    alpha_ = 1.0 / (1.0 - theta_);
+    eta_ = (1.0 - std::pow(2.0 / key_num_, 1.0 - theta_)) / (1.0 - zeta2 / zetan_);
+  }
+}
+
+bool BenchKeyGenerator::IsValidDistribution(const std::string& distribution) {
+  return distribution == "uniform" || distribution == "zipf" || distribution == "sequential";
+}
+
+int64_t BenchKeyGenerator::Next() {
+  switch (distribution_) {
+    case Distribution::kSequential:
+      return sequence_++ % key_num_;
+    case Distribution::kZipf: {
+      double u = NextDouble();
+      double uz = u * zetan_;
+      if (uz < 1.0) {
+        return 0;
+      }
+      if (uz < 1.0 + std::pow(0.5, theta_)) {
+        return std::min(static_cast<int64_t>(1), key_num_ - 1);
+      }
+      auto index = static_cast<int64_t>(key_num_ * std::pow(eta_ * u - eta_ + 1.0, alpha_));
+      return std::min(index, key_num_ - 1);
+    }
+    default:
+      return static_cast<int64_t>(rng_() % static_cast<uint64_t>(key_num_));
+  }
+}
+
+namespace {
+
+struct BenchStats {
+  BenchStats()
+      : read_latency("dingo_client_bench_read", FLAGS_bench_report_interval_s),
+        write_latency("dingo_client_bench_write", FLAGS_bench_report_interval_s),
+        error_count("dingo_client_bench_error_count") {}
+
+  bvar::LatencyRecorder read_latency;
+  bvar::LatencyRecorder write_latency;
+  bvar::Adder<int64_t> error_count;
+};
+
+// Do one request, is_read decides which latency recorder, return false on error.
+using BenchFunc = std::function<bool(int32_t thread_no, bool is_read, BenchKeyGenerator& key_generator)>;
+
+struct BenchParam {
+  int32_t thread_no{0};
+  BenchFunc func;
+  BenchStats* stats{nullptr};
+  std::atomic<bool>* stop{nullptr};
+};
+
+void* BenchRoutine(void* arg) {
+  auto* param = static_cast<BenchParam*>(arg);
+
+  BenchKeyGenerator key_generator(FLAGS_bench_key_distribution, FLAGS_bench_key_num, FLAGS_bench_zipf_theta,
+                                  dingodb::Helper::TimestampNs() + param->thread_no);
+  std::mt19937_64 rng(param->thread_no);
+  std::uniform_real_distribution<double> distrib(0.0, 1.0);
+  while (!param->stop->load(std::memory_order_relaxed)) {
+    bool is_read = distrib(rng) < FLAGS_bench_read_ratio;
+
+    int64_t start_time_us = dingodb::Helper::TimestampUs();
+    bool ok = param->func(param->thread_no, is_read, key_generator);
+    int64_t elapsed_us = dingodb::Helper::TimestampUs() - start_time_us;
+    if (!ok) {
+      param->stats->error_count << 1;
+      continue;
+    }
+
+    if (is_read) {
+      param->stats->read_latency << elapsed_us;
+    } else {
+      param->stats->write_latency << elapsed_us;
+    }
+  }
+
+  return nullptr;
+}
+
+std::string FormatLatency(const std::string& name, bvar::LatencyRecorder& recorder) {
+  return fmt::format("{}: qps({}) avg({}us) p50({}us) p99({}us) p999({}us) max({}us)", name, recorder.qps(),
+                     recorder.latency(), recorder.latency_percentile(0.5), recorder.latency_percentile(0.99),
+                     recorder.latency_percentile(0.999), recorder.max_latency());
+}
+
+void RunBench(const std::string& name, BenchFunc func) {
+  if (!BenchKeyGenerator::IsValidDistribution(FLAGS_bench_key_distribution)) {
+    DINGO_LOG(ERROR) << fmt::format("[bench] invalid key distribution: {}", FLAGS_bench_key_distribution);
+    return;
+  }
+  int32_t concurrency = std::max(FLAGS_bench_concurrency, 1);
+
+  BenchStats stats;
+  std::atomic<bool> stop{false};
+  std::vector<BenchParam> params(concurrency);
+  std::vector<bthread_t> tids(concurrency, 0);
+  for (int32_t i = 0; i < concurrency; ++i) {
+    params[i] = BenchParam{i, func, &stats, &stop};
+    if (bthread_start_background(&tids[i], nullptr, BenchRoutine, &params[i]) != 0) {
+      DINGO_LOG(ERROR) << "Fail to create bthread";
+      tids[i] = 0;
+    }
+  }
+
+  DINGO_LOG(INFO) << fmt::format(
+      "[bench.{}] start, concurrency({}) duration({}s) key_num({}) distribution({}) read_ratio({}) value_size({})", name,
+      concurrency, FLAGS_bench_duration_s, FLAGS_bench_key_num, FLAGS_bench_key_distribution, FLAGS_bench_read_ratio,
+      FLAGS_bench_value_size);
+
+  int64_t start_time_ms = dingodb::Helper::TimestampMs();
+  int64_t end_time_ms = start_time_ms + static_cast<int64_t>(FLAGS_bench_duration_s) * 1000;
+  int32_t report_interval_s = std::max(FLAGS_bench_report_interval_s, 1);
+  while (dingodb::Helper::TimestampMs() < end_time_ms) {
+    bthread_usleep(report_interval_s * 1000 * 1000L);
+    DINGO_LOG(INFO) << fmt::format("[bench.{}] elapsed({}s) {} | {} | errors({})", name,
+                                   (dingodb::Helper::TimestampMs() - start_time_ms) / 1000,
+                                   FormatLatency("read", stats.read_latency),
+                                   FormatLatency("write", stats.write_latency), stats.error_count.get_value());
+  }
+
+  stop.store(true);
+  for (auto tid : tids) {
+    if (tid != 0) {
+      bthread_join(tid, nullptr);
+    }
+  }
+
+  int64_t elapsed_ms = std::max(dingodb::Helper::TimestampMs() - start_time_ms, static_cast<int64_t>(1));
+  int64_t read_count = stats.read_latency.count();
+  int64_t write_count = stats.write_latency.count();
+  DINGO_LOG(INFO) << fmt::format(
+      "[bench.{}] finish, elapsed({}ms) read_count({}) write_count({}) error_count({}) total_qps({})", name,
+      elapsed_ms, read_count, write_count, stats.error_count.get_value(),
+      (read_count + write_count) * 1000 / elapsed_ms);
+}
+
+std::string BenchKey(const std::string& prefix, int64_t index) { return prefix + fmt::format("{:016}", index); }
+
+int64_t GenTso() {
+  dingodb::pb::meta::TsoRequest request;
+  dingodb::pb::meta::TsoResponse response;
+  request.set_op_type(::dingodb::pb::meta::TsoOpType::OP_GEN_TSO);
+  request.set_count(1);
+
+  auto status = InteractionManager::GetInstance().SendRequestWithoutContext("MetaService", "TsoService", request,
+                                                                             response);
+  if (!status.ok()) {
+    return 0;
+  }
+
+  return (response.start_timestamp().physical() << ::dingodb::kLogicalBits) + response.start_timestamp().logical();
+}
+
+}  // namespace
+
+void BenchKv(int64_t region_id) {
+  dingodb::pb::common::Region region;
+  if (!TxnGetRegion(region_id, region)) {
+    return;
+  }
+  // keys are appended to start key, so they are in the region range
+  const std::string prefix = region.definition().range().start_key();
+  const std::string value(FLAGS_bench_value_size, 'v');
+
+  RunBench("kv", [&](int32_t, bool is_read, BenchKeyGenerator& key_generator) -> bool {
+    std::string key = BenchKey(prefix, key_generator.Next());
+    if (is_read) {
+      dingodb::pb::store::KvGetRequest request;
+      dingodb::pb::store::KvGetResponse response;
+      *(request.mutable_context()) = RegionRouter::GetInstance().GenConext(region_id);
+      request.set_key(key);
+      return InteractionManager::GetInstance().SendRequestWithContext("StoreService", "KvGet", request, response).ok();
+    }
+
+    dingodb::pb::store::KvPutRequest request;
+    dingodb::pb::store::KvPutResponse response;
+    *(request.mutable_context()) = RegionRouter::GetInstance().GenConext(region_id);
+    request.mutable_kv()->set_key(key);
+    request.mutable_kv()->set_value(value);
+    return InteractionManager::GetInstance().SendRequestWithContext("StoreService", "KvPut", request, response).ok();
+  });
+}
+
+// write is a one key transaction of prewrite and commit, read is a snapshot get.
+void BenchTxn(int64_t region_id) {
+  dingodb::pb::common::Region region;
+  if (!TxnGetRegion(region_id, region)) {
+    return;
+  }
+  const std::string prefix = region.definition().range().start_key();
+  const std::string value(FLAGS_bench_value_size, 'v');
+
+  auto set_context = [&](dingodb::pb::store::Context* context) {
+    context->set_region_id(region_id);
+    *context->mutable_region_epoch() = region.definition().epoch();
+    context->set_isolation_level(dingodb::pb::store::IsolationLevel::SnapshotIsolation);
+  };
+
+  RunBench("txn", [&](int32_t, bool is_read, BenchKeyGenerator& key_generator) -> bool {
+    std::string key = BenchKey(prefix, key_generator.Next());
+    int64_t start_ts = GenTso();
+    if (start_ts == 0) {
+      return false;
+    }
+
+    if (is_read) {
+      dingodb::pb::store::TxnGetRequest request;
+      dingodb::pb::store::TxnGetResponse response;
+      set_context(request.mutable_context());
+      request.set_key(key);
+      request.set_start_ts(start_ts);
+      return InteractionManager::GetInstance().SendRequestWithContext("StoreService", "TxnGet", request, response).ok();
+    }
+
+    dingodb::pb::store::TxnPrewriteRequest prewrite_request;
+    dingodb::pb::store::TxnPrewriteResponse prewrite_response;
+    set_context(prewrite_request.mutable_context());
+    prewrite_request.set_primary_lock(key);
+    prewrite_request.set_start_ts(start_ts);
+    prewrite_request.set_lock_ttl(dingodb::Helper::TimestampMs() + 10000);
+    prewrite_request.set_txn_size(1);
+    auto* mutation = prewrite_request.add_mutations();
+    mutation->set_op(dingodb::pb::store::Op::Put);
+    mutation->set_key(key);
+    mutation->set_value(value);
+    auto status = InteractionManager::GetInstance().SendRequestWithContext("StoreService", "TxnPrewrite",
+                                                                           prewrite_request, prewrite_response);
+    // lock conflict of hot keys is reported by txn_result
+    if (!status.ok() || prewrite_response.txn_result_size() > 0) {
+      return false;
+    }
+
+    int64_t commit_ts = GenTso();
+    if (commit_ts == 0) {
+      return false;
+    }
+    dingodb::pb::store::TxnCommitRequest commit_request;
+    dingodb::pb::store::TxnCommitResponse commit_response;
+    set_context(commit_request.mutable_context());
+    commit_request.set_start_ts(start_ts);
+    commit_request.set_commit_ts(commit_ts);
+    commit_request.add_keys(key);
+    return InteractionManager::GetInstance()
+        .SendRequestWithContext("StoreService", "TxnCommit", commit_request, commit_response)
+        .ok();
+  });
+}
+
+// write is a vector add, read is a vector search with optional id pre filter.
+void BenchVector(int64_t region_id, uint32_t dimension, int64_t start_id) {
+  if (dimension == 0) {
+    DINGO_LOG(ERROR) << "dimension is 0";
+    return;
+  }
+  if (start_id <= 0) {
+    DINGO_LOG(ERROR) << "start_id must be positive and in the region range";
+    return;
+  }
+
+  // the same random ids pass the filter for all searches
+  std::vector<int64_t> filter_vector_ids;
+  if (FLAGS_bench_vector_filter_selectivity > 0) {
+    int64_t filter_num = std::min(static_cast<int64_t>(FLAGS_bench_key_num * FLAGS_bench_vector_filter_selectivity),
+                                  kMaxFilterVectorIdNum);
+    std::mt19937_64 rng(start_id);
+    for (int64_t i = 0; i < std::max(filter_num, static_cast<int64_t>(1)); ++i) {
+      filter_vector_ids.push_back(start_id + static_cast<int64_t>(rng() % FLAGS_bench_key_num));
+    }
+    std::sort(filter_vector_ids.begin(), filter_vector_ids.end());
+    filter_vector_ids.erase(std::unique(filter_vector_ids.begin(), filter_vector_ids.end()), filter_vector_ids.end());
+  }
+
+  RunBench("vector", [&](int32_t thread_no, bool is_read, BenchKeyGenerator& key_generator) -> bool {
+    thread_local std::mt19937 rng(thread_no);
+    std::uniform_real_distribution<float> distrib(0.0, 1.0);
+
+    dingodb::pb::common::VectorWithId vector_with_id;
+    vector_with_id.set_id(start_id + key_generator.Next());
+    auto* vector = vector_with_id.mutable_vector();
+    vector->set_dimension(dimension);
+    vector->set_value_type(dingodb::pb::common::ValueType::FLOAT);
+    for (uint32_t i = 0; i < dimension; ++i) {
+      vector->add_float_values(distrib(rng));
+    }
+
+    if (is_read) {
+      dingodb::pb::index::VectorSearchRequest request;
+      dingodb::pb::index::VectorSearchResponse response;
+      *(request.mutable_context()) = RegionRouter::GetInstance().GenConext(region_id);
+      *request.add_vector_with_ids() = std::move(vector_with_id);
+      auto* parameter = request.mutable_parameter();
+      parameter->set_top_n(FLAGS_bench_vector_topn);
+      parameter->set_without_vector_data(true);
+      if (!filter_vector_ids.empty()) {
+        parameter->set_vector_filter(dingodb::pb::common::VectorFilter::VECTOR_ID_FILTER);
+        parameter->set_vector_filter_type(dingodb::pb::common::VectorFilterType::QUERY_PRE);
+        for (auto id : filter_vector_ids) {
+          parameter->add_vector_ids(id);
+        }
+      }
+      return InteractionManager::GetInstance()
+          .SendRequestWithContext("IndexService", "VectorSearch", request, response)
+          .ok();
+    }
+
+    dingodb::pb::index::VectorAddRequest request;
+    dingodb::pb::index::VectorAddResponse response;
+    *(request.mutable_context()) = RegionRouter::GetInstance().GenConext(region_id);
+    *request.add_vectors() = std::move(vector_with_id);
+    request.set_is_update(true);
+    return InteractionManager::GetInstance().SendRequestWithContext("IndexService", "VectorAdd", request, response).ok();
+  });
+}
+
+}  // namespace client
@@ -0,0 +1,60 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_CLIENT_STORE_CLIENT_BENCH_H_
+#define DINGODB_CLIENT_STORE_CLIENT_BENCH_H_
+
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace client {
+
+// Generate key index of [0, key_num) by distribution uniform/zipf/sequential.
+// The zipf generator follows "Quickly Generating Billion-Record Synthetic Databases", Gray et al.
+class BenchKeyGenerator {
+ public:
+  BenchKeyGenerator(const std::string& distribution, int64_t key_num, double zipf_theta, uint64_t seed);
+
+  int64_t Next();
+
+  static bool IsValidDistribution(const std::string& distribution);
+
+ private:
+  enum class Distribution { kUniform, kZipf, kSequential };
+
+  double NextDouble() { return std::uniform_real_distribution<double>(0.0, 1.0)(rng_); }
+
+  Distribution distribution_;
+  int64_t key_num_;
+  int64_t sequence_{0};
+  std::mt19937_64 rng_;
+
+  // zipf parameters
+  double theta_{0};
+  double alpha_{0};
+  double zetan_{0};
+  double eta_{0};
+};
+
+// Sustained load against one region, bench_concurrency bthreads send requests for bench_duration_s,
+// throughput and latency percentiles are printed every bench_report_interval_s.
+void BenchKv(int64_t region_id);
+void BenchTxn(int64_t region_id);
+void BenchVector(int64_t region_id, uint32_t dimension, int64_t start_id);
+
+}  // namespace client
+
+#endif  // DINGODB_CLIENT_STORE_CLIENT_BENCH_H_
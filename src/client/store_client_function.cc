@@ -20,12 +20,14 @@
 #include <unistd.h>
 
 #include <algorithm>
+#include <atomic>
 #include <cctype>
 #include <chrono>
 #include <cstddef>
 #include <cstdint>
 #include <filesystem>
 #include <memory>
+#include <mutex>
 #include <ostream>
 #include <string>
 #include <thread>
@@ -37,6 +39,8 @@
 #include "client/client_router.h"
 #include "common/helper.h"
 #include "common/logging.h"
+#include "common/score_fusion.h"
+#include "document/codec.h"
 #include "fmt/core.h"
 #include "gflags/gflags.h"
 #include "glog/logging.h"
@@ -84,9 +88,15 @@ DECLARE_int64(document_id);
 DEFINE_string(document_text1, "", "document text 1");
 DEFINE_string(document_text2, "", "document text 2");
 DEFINE_string(query_string, "", "document query string");
+DEFINE_string(document_filter, "", "document scalar filter pushed into query, e.g. i64>=10;f64<2.5;text=hello");
 DECLARE_int32(topn);
 DEFINE_bool(is_update, false, "is update document");
 
+// for hybrid search
+DEFINE_string(hybrid_fusion, "rrf", "hybrid search score fusion: rrf, weighted");
+DEFINE_int32(hybrid_rrf_k, 60, "hybrid search reciprocal rank fusion k");
+DEFINE_double(hybrid_vector_weight, 0.5, "hybrid search weight of vector result, document weight is 1 - it");
+
 namespace client {
 
 /*
@@ -2227,9 +2237,32 @@ void SendDocumentSearch(int64_t region_id) {
     return;
   }
 
+  std::string query_string = FLAGS_query_string;
+  if (!FLAGS_document_filter.empty()) {
+    std::string error_message;
+    std::vector<dingodb::DocumentScalarFilter> filters;
+    if (!dingodb::DocumentCodec::ParseScalarFilter(FLAGS_document_filter, filters, error_message)) {
+      DINGO_LOG(ERROR) << "parse document_filter failed, error: " << error_message;
+      return;
+    }
+
+    auto region_entry = RegionRouter::GetInstance().QueryRegionEntry(region_id);
+    if (region_entry == nullptr) {
+      DINGO_LOG(ERROR) << fmt::format("not found region {}", region_id);
+      return;
+    }
+    const auto& scalar_schema =
+        region_entry->Region().definition().index_parameter().document_index_parameter().scalar_schema();
+    if (!dingodb::DocumentCodec::GenScalarFilterQueryString(scalar_schema, FLAGS_query_string, filters, query_string,
+                                                            error_message)) {
+      DINGO_LOG(ERROR) << "push down document_filter failed, error: " << error_message;
+      return;
+    }
+  }
+
   auto* parameter = request.mutable_parameter();
   parameter->set_top_n(FLAGS_topn);
-  parameter->set_query_string(FLAGS_query_string);
+  parameter->set_query_string(query_string);
   parameter->set_without_scalar_data(FLAGS_without_scalar);
 
   *(request.mutable_context()) = RegionRouter::GetInstance().GenConext(region_id);
@@ -2241,6 +2274,91 @@ void SendDocumentSearch(int64_t region_id) {
   DINGO_LOG(INFO) << "DocumentSearch response: " << response.DebugString();
 }
 
+// Vector search and document search of the same table run concurrently, each takes topn * 2 candidates without
+// row data, the fused topn are fetched from the document region by one batch query.
+void SendHybridSearch(int64_t vector_region_id, int64_t document_region_id, uint32_t dimension, uint32_t topn) {
+  if (vector_region_id == 0 || document_region_id == 0) {
+    DINGO_LOG(ERROR) << "vector region_id or document_region_id is 0";
+    return;
+  }
+  if (dimension == 0 || topn == 0) {
+    DINGO_LOG(ERROR) << "dimension or topn is 0";
+    return;
+  }
+  if (FLAGS_query_string.empty() || FLAGS_vector_data.empty()) {
+    DINGO_LOG(ERROR) << "query_string or vector_data is empty";
+    return;
+  }
+
+  dingodb::pb::index::VectorSearchRequest vector_request;
+  dingodb::pb::index::VectorSearchResponse vector_response;
+  *(vector_request.mutable_context()) = RegionRouter::GetInstance().GenConext(vector_region_id);
+  std::vector<float> row = dingodb::Helper::StringToVector(FLAGS_vector_data);
+  CHECK(dimension == row.size()) << "dimension not match";
+  auto* vector = vector_request.add_vector_with_ids()->mutable_vector();
+  for (auto v : row) {
+    vector->add_float_values(v);
+  }
+  auto* vector_parameter = vector_request.mutable_parameter();
+  vector_parameter->set_top_n(topn * 2);
+  vector_parameter->set_without_vector_data(true);
+  vector_parameter->set_without_scalar_data(true);
+  vector_parameter->set_without_table_data(true);
+
+  dingodb::pb::document::DocumentSearchRequest document_request;
+  dingodb::pb::document::DocumentSearchResponse document_response;
+  *(document_request.mutable_context()) = RegionRouter::GetInstance().GenConext(document_region_id);
+  auto* document_parameter = document_request.mutable_parameter();
+  document_parameter->set_top_n(topn * 2);
+  document_parameter->set_query_string(FLAGS_query_string);
+  document_parameter->set_without_scalar_data(true);
+
+  auto start_time = dingodb::Helper::TimestampMs();
+  std::thread document_thread([&]() {
+    InteractionManager::GetInstance().SendRequestWithContext("DocumentService", "DocumentSearch", document_request,
+                                                             document_response);
+  });
+  InteractionManager::GetInstance().SendRequestWithContext("IndexService", "VectorSearch", vector_request,
+                                                           vector_response);
+  document_thread.join();
+
+  if (vector_response.error().errcode() != 0 || document_response.error().errcode() != 0) {
+    DINGO_LOG(ERROR) << fmt::format("HybridSearch failed, vector error: {} document error: {}",
+                                    vector_response.error().ShortDebugString(),
+                                    document_response.error().ShortDebugString());
+    return;
+  }
+
+  std::vector<dingodb::ScoreFusion::RankedList> lists;
+  lists.push_back(vector_response.batch_results().empty()
+                      ? dingodb::ScoreFusion::RankedList{}
+                      : dingodb::ScoreFusion::FromVectorResult(vector_response.batch_results(0)));
+  lists.push_back(dingodb::ScoreFusion::FromDocumentResult(document_response.document_with_scores()));
+  std::vector<float> weights = {static_cast<float>(FLAGS_hybrid_vector_weight),
+                                static_cast<float>(1.0 - FLAGS_hybrid_vector_weight)};
+
+  auto fused = FLAGS_hybrid_fusion == "weighted" ? dingodb::ScoreFusion::WeightedScore(lists, weights, topn)
+                                                 : dingodb::ScoreFusion::ReciprocalRank(lists, weights,
+                                                                                        FLAGS_hybrid_rrf_k, topn);
+
+  DINGO_LOG(INFO) << fmt::format("HybridSearch fusion({}) vector({}) document({}) fused({}) elapsed time({} ms)",
+                                 FLAGS_hybrid_fusion, lists[0].size(), lists[1].size(), fused.size(),
+                                 dingodb::Helper::TimestampMs() - start_time);
+  for (const auto& item : fused) {
+    DINGO_LOG(INFO) << fmt::format("id: {} score: {}", item.id, item.score);
+  }
+
+  // row data of fused results only
+  if (!FLAGS_without_scalar && !fused.empty()) {
+    std::vector<int64_t> document_ids;
+    document_ids.reserve(fused.size());
+    for (const auto& item : fused) {
+      document_ids.push_back(item.id);
+    }
+    SendDocumentBatchQuery(document_region_id, document_ids);
+  }
+}
+
 void SendDocumentBatchQuery(int64_t region_id, std::vector<int64_t> document_ids) {
   dingodb::pb::document::DocumentBatchQueryRequest request;
   dingodb::pb::document::DocumentBatchQueryResponse response;
@@ -3220,6 +3338,197 @@ void SendKvScan(int64_t region_id, const std::string& prefix) {
                                                            release_response);
 }
 
+// Scan the whole range of one region page by page, return the scanned kv count, or -1 when failed.
+static int64_t ScanRegionRange(int64_t region_id, const dingodb::pb::common::Range& range, int page_size,
+                               std::vector<dingodb::pb::common::KeyValue>* kvs) {
+  dingodb::pb::store::KvScanBeginRequest request;
+  dingodb::pb::store::KvScanBeginResponse response;
+
+  *(request.mutable_context()) = RegionRouter::GetInstance().GenConext(region_id);
+  *(request.mutable_range()->mutable_range()) = range;
+  request.mutable_range()->set_with_start(true);
+  request.mutable_range()->set_with_end(false);
+  request.set_max_fetch_cnt(page_size);
+
+  InteractionManager::GetInstance().SendRequestWithContext("StoreService", "KvScanBegin", request, response);
+  if (response.error().errcode() != 0) {
+    return -1;
+  }
+
+  int64_t count = response.kvs().size();
+  if (kvs != nullptr) {
+    kvs->insert(kvs->end(), response.kvs().begin(), response.kvs().end());
+  }
+
+  int64_t ret = count;
+  if (response.kvs().size() >= page_size) {
+    dingodb::pb::store::KvScanContinueRequest continue_request;
+    dingodb::pb::store::KvScanContinueResponse continue_response;
+
+    *(continue_request.mutable_context()) = RegionRouter::GetInstance().GenConext(region_id);
+    continue_request.set_scan_id(response.scan_id());
+    continue_request.set_max_fetch_cnt(page_size);
+
+    for (;;) {
+      continue_response.Clear();
+      InteractionManager::GetInstance().SendRequestWithContext("StoreService", "KvScanContinue", continue_request,
+                                                               continue_response);
+      if (continue_response.error().errcode() != 0) {
+        ret = -1;
+        break;
+      }
+
+      count += continue_response.kvs().size();
+      if (kvs != nullptr) {
+        kvs->insert(kvs->end(), continue_response.kvs().begin(), continue_response.kvs().end());
+      }
+      if (continue_response.kvs().size() < page_size) {
+        ret = count;
+        break;
+      }
+    }
+  }
+
+  dingodb::pb::store::KvScanReleaseRequest release_request;
+  dingodb::pb::store::KvScanReleaseResponse release_response;
+
+  *(release_request.mutable_context()) = RegionRouter::GetInstance().GenConext(region_id);
+  release_request.set_scan_id(response.scan_id());
+
+  InteractionManager::GetInstance().SendRequestWithContext("StoreService", "KvScanRelease", release_request,
+                                                           release_response);
+
+  return ret;
+}
+
+struct ParallelScanState {
+  std::vector<dingodb::pb::meta::RangeDistribution> ranges;
+  int page_size{0};
+  bool ordered{false};
+
+  std::atomic<size_t> next_index{0};
+
+  // Ordered output, regions are emitted strictly by start key, a finished region waits for its predecessors.
+  std::mutex mutex;
+  std::vector<bool> finished;
+  std::vector<std::vector<dingodb::pb::common::KeyValue>> results;
+  size_t emit_index{0};
+  std::string last_key;
+
+  std::atomic<int64_t> total_count{0};
+  std::atomic<int64_t> fail_count{0};
+};
+
+static void EmitOrderedRegions(ParallelScanState* state) {
+  while (state->emit_index < state->ranges.size() && state->finished[state->emit_index]) {
+    auto& kvs = state->results[state->emit_index];
+    const auto& range = state->ranges[state->emit_index];
+    for (const auto& kv : kvs) {
+      if (!state->last_key.empty() && kv.key() <= state->last_key) {
+        DINGO_LOG(ERROR) << fmt::format("Scan out of order, region({}) key({}) last_key({})",
+                                        range.id().entity_id(), dingodb::Helper::StringToHex(kv.key()),
+                                        dingodb::Helper::StringToHex(state->last_key));
+      }
+      state->last_key = kv.key();
+    }
+
+    DINGO_LOG(INFO) << fmt::format("region({}) range[{}-{}) count({}) first_key({}) last_key({})",
+                                   range.id().entity_id(), dingodb::Helper::StringToHex(range.range().start_key()),
+                                   dingodb::Helper::StringToHex(range.range().end_key()), kvs.size(),
+                                   kvs.empty() ? "" : dingodb::Helper::StringToHex(kvs.front().key()),
+                                   kvs.empty() ? "" : dingodb::Helper::StringToHex(kvs.back().key()));
+
+    std::vector<dingodb::pb::common::KeyValue>().swap(kvs);
+    ++state->emit_index;
+  }
+}
+
+void SendKvParallelScan(int64_t table_id, int thread_num, int page_size, bool ordered) {
+  if (thread_num <= 0 || page_size <= 0) {
+    DINGO_LOG(ERROR) << fmt::format("Param thread_num({}) or page_size({}) is error.", thread_num, page_size);
+    return;
+  }
+
+  auto table_range = SendGetTableRange(table_id);
+
+  auto state = std::make_shared<ParallelScanState>();
+  state->page_size = page_size;
+  state->ordered = ordered;
+  for (const auto& region_range : table_range.range_distribution()) {
+    if (region_range.range().start_key() >= region_range.range().end_key()) {
+      DINGO_LOG(ERROR) << fmt::format("Invalid region {} range [{}-{})", region_range.id().entity_id(),
+                                      dingodb::Helper::StringToHex(region_range.range().start_key()),
+                                      dingodb::Helper::StringToHex(region_range.range().end_key()));
+      continue;
+    }
+    state->ranges.push_back(region_range);
+  }
+  std::sort(state->ranges.begin(), state->ranges.end(), [](const auto& a, const auto& b) {
+    return a.range().start_key() < b.range().start_key();
+  });
+  state->finished.resize(state->ranges.size(), false);
+  state->results.resize(state->ranges.size());
+
+  thread_num = std::min(thread_num, static_cast<int>(state->ranges.size()));
+  int64_t start_time = dingodb::Helper::TimestampMs();
+
+  std::vector<bthread_t> tids;
+  tids.resize(thread_num);
+  for (int i = 0; i < thread_num; ++i) {
+    auto* arg = new std::shared_ptr<ParallelScanState>(state);
+    if (bthread_start_background(
+            &tids[i], nullptr,
+            [](void* arg) -> void* {
+              std::unique_ptr<std::shared_ptr<ParallelScanState>> holder(
+                  static_cast<std::shared_ptr<ParallelScanState>*>(arg));
+              auto* state = holder->get();
+
+              for (;;) {
+                size_t index = state->next_index.fetch_add(1);
+                if (index >= state->ranges.size()) {
+                  break;
+                }
+
+                const auto& region_range = state->ranges[index];
+                int64_t region_id = region_range.id().entity_id();
+                std::vector<dingodb::pb::common::KeyValue> kvs;
+                int64_t count =
+                    ScanRegionRange(region_id, region_range.range(), state->page_size, state->ordered ? &kvs : nullptr);
+                if (count < 0) {
+                  DINGO_LOG(ERROR) << fmt::format("Scan region({}) failed.", region_id);
+                  state->fail_count.fetch_add(1);
+                } else {
+                  state->total_count.fetch_add(count);
+                }
+
+                if (state->ordered) {
+                  std::lock_guard<std::mutex> guard(state->mutex);
+                  state->results[index].swap(kvs);
+                  state->finished[index] = true;
+                  EmitOrderedRegions(state);
+                } else {
+                  DINGO_LOG(INFO) << fmt::format("region({}) count({})", region_id, count);
+                }
+              }
+              return nullptr;
+            },
+            arg) != 0) {
+      delete arg;
+      DINGO_LOG(ERROR) << "Fail to create bthread";
+      continue;
+    }
+  }
+
+  for (int i = 0; i < thread_num; ++i) {
+    bthread_join(tids[i], nullptr);
+  }
+
+  DINGO_LOG(INFO) << fmt::format("Parallel scan table({}) region_num({}) thread_num({}) fail_region_num({}) count({}) "
+                                 "elapsed({}ms)",
+                                 table_id, state->ranges.size(), thread_num, state->fail_count.load(),
+                                 state->total_count.load(), dingodb::Helper::TimestampMs() - start_time);
+}
+
 void SendKvCompareAndSet(int64_t region_id, const std::string& key) {
   dingodb::pb::store::KvCompareAndSetRequest request;
   dingodb::pb::store::KvCompareAndSetResponse response;
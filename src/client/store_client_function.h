@@ -110,6 +110,9 @@ void SendDocumentScanQuery(int64_t region_id, int64_t start_id, int64_t end_id,
 int64_t SendDocumentCount(int64_t region_id, int64_t start_document_id, int64_t end_document_id);
 void SendDocumentGetRegionMetrics(int64_t region_id);
 
+// hybrid
+void SendHybridSearch(int64_t vector_region_id, int64_t document_region_id, uint32_t dimension, uint32_t topn);
+
 // vector
 void SendVectorSearch(int64_t region_id, uint32_t dimension, uint32_t topn);
 void SendVectorSearchDebug(int64_t region_id, uint32_t dimension, int64_t start_vector_id, uint32_t topn,
@@ -148,6 +151,7 @@ void SendKvBatchPutIfAbsent(int64_t region_id, const std::string& prefix, int co
 void SendKvBatchDelete(int64_t region_id, const std::string& key);
 void SendKvDeleteRange(int64_t region_id, const std::string& prefix);
 void SendKvScan(int64_t region_id, const std::string& prefix);
+void SendKvParallelScan(int64_t table_id, int thread_num, int page_size, bool ordered);
 void SendKvCompareAndSet(int64_t region_id, const std::string& key);
 void SendKvBatchCompareAndSet(int64_t region_id, const std::string& prefix, int count);
 void SendKvScanBeginV2(int64_t region_id, int64_t scan_id);
@@ -14,15 +14,19 @@
 
 #include "client/store_tool_dump.h"
 
+#include <algorithm>
 #include <any>
+#include <atomic>
 #include <cstdint>
 #include <cstring>
+#include <fstream>
 #include <functional>
 #include <iostream>
 #include <memory>
 #include <optional>
 #include <sstream>
 #include <string>
+#include <thread>
 #include <utility>
 #include <vector>
 
@@ -39,6 +43,7 @@
 #include "proto/meta.pb.h"
 #include "rocksdb/db.h"
 #include "rocksdb/listener.h"
+#include "rocksdb/metadata.h"
 #include "rocksdb/options.h"
 #include "serial/record_decoder.h"
 #include "serial/record_encoder.h"
@@ -52,6 +57,10 @@ DEFINE_bool(show_all_data, false, "show all version data");
 
 DEFINE_int32(print_column_width, 24, "print column width");
 
+DEFINE_int32(dump_thread_num, 8, "thread num of parallel dump");
+DEFINE_string(dump_output_dir, "", "output dir of parallel dump json lines files, empty is verify only");
+DEFINE_string(dump_cfs, "", "column families of parallel dump, separated by comma, empty is all");
+
 DECLARE_bool(show_pretty);
 
 namespace client {
@@ -117,6 +126,51 @@ class RocksDBOperator {
     return (it == family_handles_.end()) ? nullptr : it->second;
   }
 
+  // Split the key space of cf into at most num ranges by the smallest key of its sst files, every range has similar
+  // sst file count. Return the split keys, range i is [split_keys[i-1], split_keys[i]).
+  std::vector<std::string> SplitKeys(const std::string& cf_name, int num) {
+    std::vector<rocksdb::LiveFileMetaData> files;
+    db_->GetLiveFilesMetaData(&files);
+
+    std::vector<std::string> smallest_keys;
+    for (const auto& file : files) {
+      if (file.column_family_name == cf_name) {
+        smallest_keys.push_back(file.smallestkey);
+      }
+    }
+    std::sort(smallest_keys.begin(), smallest_keys.end());
+    smallest_keys.erase(std::unique(smallest_keys.begin(), smallest_keys.end()), smallest_keys.end());
+
+    std::vector<std::string> split_keys;
+    for (int i = 1; i < num && !smallest_keys.empty(); ++i) {
+      const auto& key = smallest_keys[smallest_keys.size() * i / num];
+      if (!key.empty() && (split_keys.empty() || split_keys.back() < key)) {
+        split_keys.push_back(key);
+      }
+    }
+
+    return split_keys;
+  }
+
+  // Scan [begin_key, end_key) without cache, the checksum of every block is verified, empty end_key is unbounded.
+  rocksdb::Status ScanRange(const std::string& cf_name, const std::string& begin_key, const std::string& end_key,
+                            std::function<void(const rocksdb::Slice&, const rocksdb::Slice&)> handler) {
+    rocksdb::ReadOptions read_option;
+    read_option.fill_cache = false;
+    read_option.verify_checksums = true;
+    rocksdb::Slice end_key_slice(end_key);
+    if (!end_key.empty()) {
+      read_option.iterate_upper_bound = &end_key_slice;
+    }
+
+    std::unique_ptr<rocksdb::Iterator> it(db_->NewIterator(read_option, GetFamilyHandle(cf_name)));
+    for (it->Seek(begin_key); it->Valid(); it->Next()) {
+      handler(it->key(), it->value());
+    }
+
+    return it->status();
+  }
+
   void Scan(const std::string& cf_name, const std::string& begin_key, const std::string& end_key, int32_t offset,
             int32_t limit, std::function<void(const std::string&, const std::string&)> handler) {
     rocksdb::ReadOptions read_option;
@@ -635,6 +689,130 @@ void DumpDb(std::shared_ptr<Context> ctx) {
 
 void DumpMeta(std::shared_ptr<Context> ctx) {}
 
+namespace {
+
+struct DumpRangeResult {
+  std::string cf_name;
+  std::string begin_key;
+  std::string end_key;
+  int64_t count{0};
+  int64_t bytes{0};
+  int64_t disorder_count{0};
+  rocksdb::Status status;
+};
+
+// Dump one range of cf into a json lines file if output_dir is not empty, and verify the block checksum and key order.
+void DumpRange(RocksDBOperatorPtr db, const std::string& output_dir, int range_no, DumpRangeResult& result) {
+  std::ofstream output;
+  if (!output_dir.empty()) {
+    auto path = fmt::format("{}/{}.{:04}.jsonl", output_dir, result.cf_name, range_no);
+    output.open(path, std::ios::out | std::ios::trunc);
+    if (!output.is_open()) {
+      result.status = rocksdb::Status::IOError("open output file failed", path);
+      return;
+    }
+  }
+
+  std::string prev_key;
+  result.status =
+      db->ScanRange(result.cf_name, result.begin_key, result.end_key,
+                    [&](const rocksdb::Slice& key, const rocksdb::Slice& value) {
+                      ++result.count;
+                      result.bytes += key.size() + value.size();
+                      if (result.count > 1 && key.compare(prev_key) <= 0) {
+                        ++result.disorder_count;
+                      }
+                      prev_key.assign(key.data(), key.size());
+
+                      if (output.is_open()) {
+                        output << fmt::format(R"({{"key":"{}","value":"{}"}})", key.ToString(true),
+                                              value.ToString(true))
+                               << '\n';
+                      }
+                    });
+}
+
+}  // namespace
+
+void DumpDbParallel(std::shared_ptr<Context> ctx) {
+  std::vector<std::string> all_cf_names;
+  auto status = rocksdb::DB::ListColumnFamilies(rocksdb::DBOptions(), ctx->db_path, &all_cf_names);
+  if (!status.ok()) {
+    DINGO_LOG(ERROR) << fmt::format("List column families failed, error: {}", status.ToString());
+    return;
+  }
+
+  std::vector<std::string> cf_names;
+  dingodb::Helper::SplitString(FLAGS_dump_cfs, ',', cf_names);
+  for (const auto& cf_name : cf_names) {
+    if (std::find(all_cf_names.begin(), all_cf_names.end(), cf_name) == all_cf_names.end()) {
+      DINGO_LOG(ERROR) << fmt::format("Not found column family {}", cf_name);
+      return;
+    }
+  }
+  if (cf_names.empty()) {
+    cf_names = all_cf_names;
+  }
+
+  auto db = std::make_shared<RocksDBOperator>(ctx->db_path, all_cf_names);
+  if (!db->Init()) {
+    return;
+  }
+
+  int thread_num = std::max(FLAGS_dump_thread_num, 1);
+
+  // the ranges of all column families are dumped by a thread pool
+  std::vector<DumpRangeResult> results;
+  for (const auto& cf_name : cf_names) {
+    auto split_keys = db->SplitKeys(cf_name, thread_num);
+    std::string begin_key;
+    for (size_t i = 0; i <= split_keys.size(); ++i) {
+      DumpRangeResult result;
+      result.cf_name = cf_name;
+      result.begin_key = begin_key;
+      result.end_key = i < split_keys.size() ? split_keys[i] : "";
+      begin_key = result.end_key;
+      results.push_back(std::move(result));
+    }
+  }
+
+  int64_t start_time_ms = dingodb::Helper::TimestampMs();
+  std::atomic<size_t> next_range{0};
+  std::vector<std::thread> threads;
+  threads.reserve(thread_num);
+  for (int i = 0; i < thread_num; ++i) {
+    threads.emplace_back([&]() {
+      for (size_t range_no = next_range.fetch_add(1); range_no < results.size(); range_no = next_range.fetch_add(1)) {
+        DumpRange(db, FLAGS_dump_output_dir, range_no, results[range_no]);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  int64_t total_count = 0;
+  int64_t total_bytes = 0;
+  bool is_ok = true;
+  for (const auto& result : results) {
+    total_count += result.count;
+    total_bytes += result.bytes;
+    if (!result.status.ok() || result.disorder_count > 0) {
+      is_ok = false;
+      std::cout << fmt::format("[{}] range[{}, {}) verify failed, count: {} disorder_count: {} status: {}",
+                               result.cf_name, dingodb::Helper::StringToHex(result.begin_key),
+                               dingodb::Helper::StringToHex(result.end_key), result.count, result.disorder_count,
+                               result.status.ToString())
+                << std::endl;
+    }
+  }
+
+  std::cout << fmt::format("Dump {} ranges of {} column families, rows: {} bytes: {} elapsed: {}ms verify: {}",
+                           results.size(), cf_names.size(), total_count, total_bytes,
+                           dingodb::Helper::TimestampMs() - start_time_ms, is_ok ? "ok" : "failed")
+            << std::endl;
+}
+
 void WhichRegion(std::shared_ptr<Context> ctx) {
   dingodb::pb::meta::TableDefinition table_definition;
   int64_t table_or_index_id = ctx->table_id > 0 ? ctx->table_id : ctx->index_id;
@@ -20,6 +20,9 @@
 namespace client {
 
 void DumpDb(std::shared_ptr<Context> ctx);
+// Dump the column families of db by dump_thread_num threads, every thread dumps the key ranges split by sst files
+// into json lines files, and verify the block checksum and key order.
+void DumpDbParallel(std::shared_ptr<Context> ctx);
 void WhichRegion(std::shared_ptr<Context> ctx);
 
 }  // namespace client
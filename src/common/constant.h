@@ -112,6 +112,9 @@ class Constant {
   inline static const std::string kBlockSizeDefaultValue = "131072";  // 128KB
   inline static const std::string kBlockCache = "block_cache";
   inline static const std::string kBlockCacheDefaultValue = "1073741824";  // 1GB
+  // compressed secondary tier of block cache, the blocks evicted from block cache are kept compressed, 0 disable.
+  inline static const std::string kCompressedSecondaryCache = "compressed_secondary_cache";
+  inline static const std::string kCompressedSecondaryCacheDefaultValue = "0";
   inline static const std::string kArenaBlockSize = "arena_block_size";
   inline static const std::string kArenaBlockSizeDefaultValue = "67108864";  // 64MB
   inline static const std::string kMinWriteBufferNumberToMerge = "min_write_buffer_number_to_merge";
@@ -123,13 +126,46 @@ class Constant {
   inline static const std::string kWriteBufferSize = "write_buffer_size";
   inline static const std::string kWriteBufferSizeDefaultValue = "67108864";  // 64MB
   inline static const std::string kPrefixExtractor = "prefix_extractor";
-  inline static const std::string kPrefixExtractorDefaultValue = "24";
+  // dingo key is prefix char + partition id + user key, share prefix within partition.
+  inline static const std::string kPrefixExtractorDefaultValue = "9";
+  // capped/fixed/none
+  inline static const std::string kPrefixExtractorType = "prefix_extractor_type";
+  inline static const std::string kPrefixExtractorTypeDefaultValue = "capped";
+  inline static const std::string kMemtablePrefixBloomSizeRatio = "memtable_prefix_bloom_size_ratio";
+  inline static const std::string kMemtablePrefixBloomSizeRatioDefaultValue = "0.1";
+  inline static const std::string kMemtableWholeKeyFiltering = "memtable_whole_key_filtering";
+  inline static const std::string kMemtableWholeKeyFilteringDefaultValue = "true";
+  inline static const std::string kBloomFilterBitsPerKey = "bloom_filter_bits_per_key";
+  inline static const std::string kBloomFilterBitsPerKeyDefaultValue = "10";
+  inline static const std::string kWholeKeyFiltering = "whole_key_filtering";
+  inline static const std::string kWholeKeyFilteringDefaultValue = "true";
   inline static const std::string kMaxBytesForLevelBase = "max_bytes_for_level_base";
   inline static const std::string kMaxBytesForLevelBaseDefaultValue = "134217728";  // 128MB
   inline static const std::string kTargetFileSizeBase = "target_file_size_base";
   inline static const std::string kTargetFileSizeBaseDefaultValue = "67108864";  // 64MB
   inline static const std::string kMaxBytesForLevelMultiplier = "max_bytes_for_level_multiplier";
   inline static const std::string kMaxBytesForLevelMultiplierDefaultValue = "10";
+  // tiered storage, the sst of level >= cold_level is placed in cold_path, empty cold_path disable it.
+  inline static const std::string kColdPath = "cold_path";
+  inline static const std::string kColdPathDefaultValue = "";
+  inline static const std::string kColdLevel = "cold_level";
+  inline static const std::string kColdLevelDefaultValue = "4";
+  // the sst older than ttl is compacted to next level, so it reach the cold levels finally, 0 disable.
+  inline static const std::string kColdTtlS = "cold_ttl_s";
+  inline static const std::string kColdTtlSDefaultValue = "0";
+  // key-value separation, the value not smaller than min_blob_size is stored in blob files.
+  inline static const std::string kEnableBlobFiles = "enable_blob_files";
+  inline static const std::string kEnableBlobFilesDefaultValue = "false";
+  inline static const std::string kMinBlobSize = "min_blob_size";
+  inline static const std::string kMinBlobSizeDefaultValue = "4096";  // 4KB
+  inline static const std::string kBlobFileSize = "blob_file_size";
+  inline static const std::string kBlobFileSizeDefaultValue = "268435456";  // 256MB
+  // the blobs in the oldest age_cutoff of blob files are relocated by compaction, the sst referencing the oldest
+  // blob files is force compacted when their garbage ratio exceed force_threshold.
+  inline static const std::string kBlobGcAgeCutoff = "blob_garbage_collection_age_cutoff";
+  inline static const std::string kBlobGcAgeCutoffDefaultValue = "0.25";
+  inline static const std::string kBlobGcForceThreshold = "blob_garbage_collection_force_threshold";
+  inline static const std::string kBlobGcForceThresholdDefaultValue = "0.5";
 
   static const int kRocksdbBackgroundThreadNumDefault = 16;
   static const int kStatsDumpPeriodSecDefault = 600;
@@ -180,6 +216,8 @@ class Constant {
   static constexpr int32_t kCreateIvfPqParamNsubvector = 64;
   static constexpr int32_t kCreateIvfPqParamNbitsPerIdx = 8;
   static constexpr int32_t kCreateIvfPqParamNbitsPerIdxMaxWarning = 16;
+  // ivf pq with nbits_per_idx equal it is scanned by simd fast scan
+  static constexpr int32_t kIvfPqFastScanNbitsPerIdx = 4;
 
   static constexpr int32_t kSearchIvfPqParamNprobe = 80;
 
@@ -207,6 +245,7 @@ class Constant {
   // raft snapshot
   inline static const std::string kRaftSnapshotRegionMetaFileName = "region_meta";
   inline static const std::string kRaftSnapshotRegionDateFileNameSuffix = ".dingo_sst";
+  inline static const std::string kRaftSnapshotRangeSstFileNameSuffix = ".range_sst";
 
   static constexpr uint32_t kCollectApproximateSizeBatchSize = 1024;
   static constexpr int64_t kVectorIndexSnapshotCatchupMargin = 4000;
@@ -18,6 +18,8 @@
 #include <cstdint>
 #include <memory>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "brpc/controller.h"
 #include "common/synchronization.h"
@@ -121,9 +123,18 @@ class Context {
   void SetStatus(butil::Status& status) { status_ = status; }
   void SetStatus(butil::Status&& status) { status_ = status; }  // NOLINT
 
+  // The per key result of conditional write, set by the apply handler.
+  const std::vector<bool>& KeyStates() const { return key_states_; }
+  void SetKeyStates(std::vector<bool>&& key_states) { key_states_ = std::move(key_states); }
+
   WriteCbFunc WriteCb() { return write_cb_; }
   void SetWriteCb(WriteCbFunc write_cb) { write_cb_ = write_cb; }
 
+  // The requests of multiple callers are coalesced into one raft cmd, the i-th request is applied with the i-th
+  // sub context, so every caller gets its own response and status.
+  const std::vector<std::shared_ptr<Context>>& SubContexts() const { return sub_contexts_; }
+  void AddSubContext(std::shared_ptr<Context> ctx) { sub_contexts_.push_back(ctx); }
+
  private:
   // brpc framework free resource
   brpc::Controller* cntl_{nullptr};
@@ -151,10 +162,13 @@ class Context {
   BthreadCondPtr cond_{nullptr};
   bthread_mutex_t cond_mutex_;
   butil::Status status_{};
+  std::vector<bool> key_states_;
 
   WriteCbFunc write_cb_{};
 
   TrackerPtr tracker_;
+
+  std::vector<std::shared_ptr<Context>> sub_contexts_;
 };
 
 using ContextPtr = std::shared_ptr<Context>;
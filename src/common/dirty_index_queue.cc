@@ -0,0 +1,75 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "common/dirty_index_queue.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace dingodb {
+
+void DirtyIndexQueue::Mark(int64_t id, int64_t priority) {
+  std::lock_guard<bthread::Mutex> lock(mutex_);
+
+  auto it = dirty_ids_.find(id);
+  if (it == dirty_ids_.end()) {
+    dirty_ids_.emplace(id, priority);
+  } else if (priority > it->second) {
+    it->second = priority;
+  }
+}
+
+std::vector<int64_t> DirtyIndexQueue::Pop(int64_t max_num) {
+  std::vector<std::pair<int64_t, int64_t>> entries;
+  {
+    std::lock_guard<bthread::Mutex> lock(mutex_);
+    entries.assign(dirty_ids_.begin(), dirty_ids_.end());
+    if (max_num <= 0 || max_num >= static_cast<int64_t>(entries.size())) {
+      dirty_ids_.clear();
+    } else {
+      std::partial_sort(entries.begin(), entries.begin() + max_num, entries.end(),
+                        [](const auto& a, const auto& b) { return a.second > b.second; });
+      entries.resize(max_num);
+      for (const auto& entry : entries) {
+        dirty_ids_.erase(entry.first);
+      }
+    }
+  }
+
+  std::sort(entries.begin(), entries.end(), [](const auto& a, const auto& b) { return a.second > b.second; });
+
+  std::vector<int64_t> ids;
+  ids.reserve(entries.size());
+  for (const auto& entry : entries) {
+    ids.push_back(entry.first);
+  }
+
+  return ids;
+}
+
+void DirtyIndexQueue::Remove(int64_t id) {
+  std::lock_guard<bthread::Mutex> lock(mutex_);
+  dirty_ids_.erase(id);
+}
+
+int64_t DirtyIndexQueue::Size() {
+  std::lock_guard<bthread::Mutex> lock(mutex_);
+  return dirty_ids_.size();
+}
+
+}  // namespace dingodb
@@ -0,0 +1,54 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef DINGODB_COMMON_DIRTY_INDEX_QUEUE_H_
+#define DINGODB_COMMON_DIRTY_INDEX_QUEUE_H_
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "bthread/mutex.h"
+
+namespace dingodb {
+
+// Index ids marked dirty by the write path, popped by the scrub in priority order.
+// Marking an id already in queue keeps the larger priority, so an index is scrubbed once per round.
+class DirtyIndexQueue {
+ public:
+  DirtyIndexQueue() = default;
+  ~DirtyIndexQueue() = default;
+
+  DirtyIndexQueue(const DirtyIndexQueue&) = delete;
+  DirtyIndexQueue& operator=(const DirtyIndexQueue&) = delete;
+
+  void Mark(int64_t id, int64_t priority);
+
+  // pop at most max_num ids of the highest priority, max_num <= 0 means all
+  std::vector<int64_t> Pop(int64_t max_num);
+
+  void Remove(int64_t id);
+
+  int64_t Size();
+
+ private:
+  bthread::Mutex mutex_;
+  // id -> priority
+  std::unordered_map<int64_t, int64_t> dirty_ids_;
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_COMMON_DIRTY_INDEX_QUEUE_H_
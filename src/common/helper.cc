@@ -51,6 +51,7 @@
 #include "butil/status.h"
 #include "butil/strings/string_split.h"
 #include "common/constant.h"
+#include "common/key_codec.h"
 #include "common/logging.h"
 #include "common/role.h"
 #include "common/service_access.h"
@@ -634,6 +635,45 @@ std::string Helper::StringDivideByTwoRightAlign(const std::string& array) {
   return result;
 }
 
+std::vector<std::string> Helper::GenEvenSplitKeys(const std::string& start_key, const std::string& end_key,
+                                                  int32_t count) {
+  size_t prefix_len = 0;
+  while (prefix_len < start_key.size() && prefix_len < end_key.size() &&
+         start_key[prefix_len] == end_key[prefix_len]) {
+    ++prefix_len;
+  }
+
+  auto to_integer = [prefix_len](const std::string& key) {
+    uint64_t value = 0;
+    for (size_t i = 0; i < 8; ++i) {
+      value <<= 8;
+      if (prefix_len + i < key.size()) {
+        value |= static_cast<uint8_t>(key[prefix_len + i]);
+      }
+    }
+    return value;
+  };
+
+  std::vector<std::string> split_keys;
+  uint64_t start_value = to_integer(start_key);
+  uint64_t end_value = to_integer(end_key);
+  if (count <= 1 || end_value - start_value <= static_cast<uint64_t>(count)) {
+    return split_keys;
+  }
+
+  uint64_t step = (end_value - start_value) / count;
+  for (int32_t i = 1; i < count; ++i) {
+    uint64_t value = start_value + step * i;
+    std::string key = end_key.substr(0, prefix_len);
+    for (int j = 7; j >= 0; --j) {
+      key.push_back(static_cast<char>((value >> (j * 8)) & 0xff));
+    }
+    split_keys.push_back(std::move(key));
+  }
+
+  return split_keys;
+}
+
 std::string Helper::CalculateMiddleKey(const std::string& start_key, const std::string& end_key) {
   DINGO_LOG(INFO) << " start_key = " << dingodb::Helper::StringToHex(start_key);
   DINGO_LOG(INFO) << " end_key   = " << dingodb::Helper::StringToHex(end_key);
@@ -1546,11 +1586,11 @@ std::string Helper::EncodeVectorIndexRegionHeader(char prefix, int64_t partition
     DINGO_LOG(FATAL) << "Encode vector key failed, prefix is 0, partition_id:[" << partition_id << "]";
   }
 
-  // Buf buf(17);
-  Buf buf(Constant::kVectorKeyMaxLenWithPrefix - 8);
-  buf.Write(prefix);
-  buf.WriteLong(partition_id);
-  return buf.GetString();
+  std::string result;
+  result.reserve(Constant::kVectorKeyMaxLenWithPrefix - 8);
+  result.push_back(prefix);
+  KeyCodec::AppendInt64(result, partition_id);
+  return result;
 }
 
 std::string Helper::EncodeVectorIndexRegionHeader(char prefix, int64_t partition_id, int64_t vector_id) {
@@ -1560,12 +1600,12 @@ std::string Helper::EncodeVectorIndexRegionHeader(char prefix, int64_t partition
                      << vector_id << "]";
   }
 
-  // Buf buf(17);
-  Buf buf(Constant::kVectorKeyMaxLenWithPrefix);
-  buf.Write(prefix);
-  buf.WriteLong(partition_id);
-  DingoSchema<std::optional<int64_t>>::InternalEncodeKey(&buf, vector_id);
-  return buf.GetString();
+  std::string result;
+  result.reserve(Constant::kVectorKeyMaxLenWithPrefix);
+  result.push_back(prefix);
+  KeyCodec::AppendInt64(result, partition_id);
+  KeyCodec::AppendComparableInt64(result, vector_id);
+  return result;
 }
 
 std::string Helper::EncodeDocumentIndexRegionHeader(char prefix, int64_t partition_id) {
@@ -1574,11 +1614,11 @@ std::string Helper::EncodeDocumentIndexRegionHeader(char prefix, int64_t partiti
     DINGO_LOG(FATAL) << "Encode document key failed, prefix is 0, partition_id:[" << partition_id << "]";
   }
 
-  // Buf buf(17);
-  Buf buf(Constant::kDocumentKeyMaxLenWithPrefix - 8);
-  buf.Write(prefix);
-  buf.WriteLong(partition_id);
-  return buf.GetString();
+  std::string result;
+  result.reserve(Constant::kDocumentKeyMaxLenWithPrefix - 8);
+  result.push_back(prefix);
+  KeyCodec::AppendInt64(result, partition_id);
+  return result;
 }
 
 std::string Helper::EncodeDocumentIndexRegionHeader(char prefix, int64_t partition_id, int64_t document_id) {
@@ -1588,12 +1628,12 @@ std::string Helper::EncodeDocumentIndexRegionHeader(char prefix, int64_t partiti
                      << document_id << "]";
   }
 
-  // Buf buf(17);
-  Buf buf(Constant::kDocumentKeyMaxLenWithPrefix);
-  buf.Write(prefix);
-  buf.WriteLong(partition_id);
-  DingoSchema<std::optional<int64_t>>::InternalEncodeKey(&buf, document_id);
-  return buf.GetString();
+  std::string result;
+  result.reserve(Constant::kDocumentKeyMaxLenWithPrefix);
+  result.push_back(prefix);
+  KeyCodec::AppendInt64(result, partition_id);
+  KeyCodec::AppendComparableInt64(result, document_id);
+  return result;
 }
 
 std::string Helper::EncodeTableRegionHeader(char prefix, const std::string& user_key) {
@@ -1602,10 +1642,11 @@ std::string Helper::EncodeTableRegionHeader(char prefix, const std::string& user
     DINGO_LOG(FATAL) << "Encode table key failed, prefix is 0, user_key:[" << Helper::StringToHex(user_key) << "]";
   }
 
-  Buf buf(1 + user_key.size());
-  buf.Write(prefix);
-  buf.Write(user_key);
-  return buf.GetString();
+  std::string result;
+  result.reserve(1 + user_key.size());
+  result.push_back(prefix);
+  result.append(user_key);
+  return result;
 }
 
 std::string Helper::EncodeTableRegionHeader(char prefix, int64_t partition_id) {
@@ -1614,10 +1655,11 @@ std::string Helper::EncodeTableRegionHeader(char prefix, int64_t partition_id) {
     DINGO_LOG(FATAL) << "Encode table key failed, prefix is 0, partition_id:[" << partition_id << "]";
   }
 
-  Buf buf(1 + 8);
-  buf.Write(prefix);
-  buf.WriteLong(partition_id);
-  return buf.GetString();
+  std::string result;
+  result.reserve(1 + 8);
+  result.push_back(prefix);
+  KeyCodec::AppendInt64(result, partition_id);
+  return result;
 }
 
 std::string Helper::EncodeTableRegionHeader(char prefix, int64_t partition_id, const std::string& user_key) {
@@ -1627,112 +1669,54 @@ std::string Helper::EncodeTableRegionHeader(char prefix, int64_t partition_id, c
                      << Helper::StringToHex(user_key) << "]";
   }
 
-  Buf buf(1 + 8 + user_key.size());
-  buf.Write(prefix);
-  buf.WriteLong(partition_id);
-  buf.Write(user_key);
-  return buf.GetString();
+  std::string result;
+  result.reserve(1 + 8 + user_key.size());
+  result.push_back(prefix);
+  KeyCodec::AppendInt64(result, partition_id);
+  result.append(user_key);
+  return result;
 }
 
 // for txn, encode start_ts/commit_ts to std::string
 std::string Helper::EncodeTso(int64_t ts) {
-  Buf buf(8);
-  buf.WriteLongWithNegation(ts);
+  std::string result;
+  KeyCodec::AppendNegationInt64(result, ts);
 
-  return buf.GetString();
+  return result;
 }
 
 std::string Helper::PaddingUserKey(const std::string& key) {
-  uint32_t new_size = ((8 + key.length()) / 8) * 9;
-  char buf[new_size];
-  const auto* data = key.data();
-
-  int i = 0;
-  int j = 0;
-  for (i = 0; i < key.length(); i++) {
-    if ((i + 1) % 8 != 0) {
-      buf[j++] = data[i];
-    } else {
-      buf[j++] = data[i];
-      buf[j++] = '\xff';
-    }
-  }
-
-  int padding_num = 8 - (i % 8);
-
-  for (int k = 0; k < padding_num; k++) {
-    buf[j++] = '\x00';
-  }
-  buf[j] = '\xff' - padding_num;
+  std::string padding_key;
+  padding_key.reserve(KeyCodec::PaddingKeySize(key.size()));
+  KeyCodec::AppendPaddingKey(padding_key, key);
 
-  return std::string(buf, new_size);
+  return padding_key;
 }
 
 std::string Helper::UnpaddingUserKey(const std::string& padding_key) {
-  if (padding_key.length() % 9 != 0) {
+  std::string key;
+  if (!KeyCodec::DecodePaddingKey(padding_key, key)) {
     return std::string();
   }
 
-  uint32_t new_size = ((padding_key.length() / 9) * 8);
-  uint32_t padding_num = '\xff' - padding_key.back();
-
-  if (padding_num == 0) {
-    return std::string();
-  }
-
-  char buf[new_size];
-  const auto* data = padding_key.data();
-
-  int i = 0;
-  int j = 0;
-  for (i = 0; i < padding_key.length(); i++) {
-    if ((i + 1) % 9 != 0) {
-      buf[j++] = data[i];
-    }
-  }
-
-  return std::string(buf, new_size - padding_num);
+  return key;
 }
 
 // for txn, encode data/write key
-std::string Helper::EncodeTxnKey(const std::string& key, int64_t ts) {
-  std::string padding_key = Helper::PaddingUserKey(key);
-  // const std::string& padding_key = key;
-  Buf buf(padding_key.length() + 8);
-  buf.Write(padding_key);
-  buf.WriteLongWithNegation(ts);
-
-  return buf.GetString();
-}
+std::string Helper::EncodeTxnKey(const std::string& key, int64_t ts) { return EncodeTxnKey(std::string_view(key), ts); }
 
 std::string Helper::EncodeTxnKey(const std::string_view& key, int64_t ts) {
-  std::string padding_key = Helper::PaddingUserKey(std::string(key));
-  // std::string padding_key = std::string(key);
-  Buf buf(padding_key.length() + 8);
-  buf.Write(padding_key);
-  buf.WriteLongWithNegation(ts);
+  std::string txn_key;
+  txn_key.reserve(KeyCodec::PaddingKeySize(key.size()) + 8);
+  KeyCodec::AppendPaddingKey(txn_key, key);
+  KeyCodec::AppendNegationInt64(txn_key, ts);
 
-  return buf.GetString();
+  return txn_key;
 }
 
 // for txn, encode data/write key
 butil::Status Helper::DecodeTxnKey(const std::string& txn_key, std::string& key, int64_t& ts) {
-  if (txn_key.length() <= 8) {
-    return butil::Status(pb::error::EINTERNAL, "DecodeTxnKey failed, txn_key length <= 8");
-  }
-
-  auto padding_key = txn_key.substr(0, txn_key.length() - 8);
-  key = Helper::UnpaddingUserKey(padding_key);
-  // key = padding_key;
-  if (key.empty()) {
-    return butil::Status(pb::error::EINTERNAL, "DecodeTxnKey failed, padding_key is empty");
-  }
-
-  auto ts_str = txn_key.substr(txn_key.length() - 8);
-  Buf buf(ts_str);
-  ts = ~buf.ReadLong();
-
-  return butil::Status::OK();
+  return DecodeTxnKey(std::string_view(txn_key), key, ts);
 }
 
 // for txn, encode data/write key
@@ -1741,17 +1725,12 @@ butil::Status Helper::DecodeTxnKey(const std::string_view& txn_key, std::string&
     return butil::Status(pb::error::EINTERNAL, "DecodeTxnKey failed, txn_key length <= 8");
   }
 
-  auto padding_key = txn_key.substr(0, txn_key.length() - 8);
-  key = Helper::UnpaddingUserKey(std::string(padding_key));
-  // key = std::string(padding_key);
-  if (key.empty()) {
+  if (!KeyCodec::DecodePaddingKey(txn_key.substr(0, txn_key.length() - 8), key) || key.empty()) {
+    key.clear();
     return butil::Status(pb::error::EINTERNAL, "DecodeTxnKey failed, padding_key is empty");
   }
 
-  std::string ts_str;
-  ts_str = txn_key.substr(txn_key.length() - 8);
-  Buf buf(ts_str);
-  ts = ~buf.ReadLong();
+  ts = KeyCodec::DecodeNegationInt64(txn_key.data() + txn_key.length() - 8);
 
   return butil::Status::OK();
 }
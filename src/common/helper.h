@@ -289,6 +289,9 @@ class Helper {
   static std::string StringDivideByTwoRightAlign(const std::string& array);
 
   static std::string CalculateMiddleKey(const std::string& start_key, const std::string& end_key);
+  // Evenly pick count - 1 keys in (start_key, end_key), take the 8 bytes after common prefix as an integer.
+  static std::vector<std::string> GenEvenSplitKeys(const std::string& start_key, const std::string& end_key,
+                                                   int32_t count);
 
   static std::vector<uint8_t> SubtractByteArrays(const std::vector<uint8_t>& a, const std::vector<uint8_t>& b);
   static std::vector<uint8_t> DivideByteArrayByTwo(const std::vector<uint8_t>& array);
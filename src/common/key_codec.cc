@@ -0,0 +1,72 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "common/key_codec.h"
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+
+namespace dingodb {
+
+void KeyCodec::AppendPaddingKey(std::string& dst, std::string_view key) {
+  size_t offset = dst.size();
+  size_t group_num = key.size() / kGroupSize;
+  dst.resize(offset + PaddingKeySize(key.size()));
+
+  char* out = dst.data() + offset;
+  const char* in = key.data();
+  // full groups, one word copy per group
+  for (size_t i = 0; i < group_num; ++i) {
+    memcpy(out, in, kGroupSize);
+    out[kGroupSize] = '\xff';
+    out += kGroupSize + 1;
+    in += kGroupSize;
+  }
+
+  // last group
+  size_t remain = key.size() - group_num * kGroupSize;
+  memset(out, 0, kGroupSize);
+  memcpy(out, in, remain);
+  out[kGroupSize] = static_cast<char>(0xff - (kGroupSize - remain));
+}
+
+bool KeyCodec::DecodePaddingKey(std::string_view padding_key, std::string& key) {
+  if (padding_key.empty() || padding_key.size() % (kGroupSize + 1) != 0) {
+    return false;
+  }
+
+  size_t padding_num = 0xff - static_cast<uint8_t>(padding_key.back());
+  if (padding_num == 0 || padding_num > kGroupSize) {
+    return false;
+  }
+
+  size_t group_num = padding_key.size() / (kGroupSize + 1);
+  key.resize(group_num * kGroupSize);
+
+  char* out = key.data();
+  const char* in = padding_key.data();
+  for (size_t i = 0; i < group_num; ++i) {
+    memcpy(out, in, kGroupSize);
+    out += kGroupSize;
+    in += kGroupSize + 1;
+  }
+  key.resize(key.size() - padding_num);
+
+  return true;
+}
+
+}  // namespace dingodb
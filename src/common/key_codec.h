@@ -0,0 +1,72 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef DINGODB_COMMON_KEY_CODEC_H_
+#define DINGODB_COMMON_KEY_CODEC_H_
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+
+#include "butil/sys_byteorder.h"
+
+namespace dingodb {
+
+// Memcomparable key codec, byte compatible with the serial Buf and schema encoding.
+// The ints are written as one big endian word instead of byte by byte, the callers reserve the key once and append
+// all parts to it, the padding key(8 bytes group and 1 byte marker) is encoded and decoded a group word at a time.
+class KeyCodec {
+ public:
+  // Buf::WriteLong, big endian.
+  static void AppendInt64(std::string& dst, int64_t value) { AppendWord(dst, static_cast<uint64_t>(value)); }
+  static int64_t DecodeInt64(const char* src) { return static_cast<int64_t>(ReadWord(src)); }
+
+  // DingoSchema<int64_t> key encoding, big endian with sign bit flipped, keep the order of negative numbers.
+  static void AppendComparableInt64(std::string& dst, int64_t value) {
+    AppendWord(dst, static_cast<uint64_t>(value) ^ kSignBit);
+  }
+  static int64_t DecodeComparableInt64(const char* src) { return static_cast<int64_t>(ReadWord(src) ^ kSignBit); }
+
+  // Buf::WriteLongWithNegation, big endian of ~value, the bigger ts is in front.
+  static void AppendNegationInt64(std::string& dst, int64_t value) { AppendWord(dst, ~static_cast<uint64_t>(value)); }
+  static int64_t DecodeNegationInt64(const char* src) { return static_cast<int64_t>(~ReadWord(src)); }
+
+  // Padding key, every 8 bytes group of key is followed by a marker, 0xff for a full group, and 0xff - padding num
+  // for the last group which is padded by 0, so the last group always exists.
+  static size_t PaddingKeySize(size_t key_size) { return (key_size / kGroupSize + 1) * (kGroupSize + 1); }
+  static void AppendPaddingKey(std::string& dst, std::string_view key);
+  // Return false if padding_key is malformed.
+  static bool DecodePaddingKey(std::string_view padding_key, std::string& key);
+
+ private:
+  static constexpr uint64_t kSignBit = 0x8000000000000000ULL;
+  static constexpr size_t kGroupSize = 8;
+
+  static void AppendWord(std::string& dst, uint64_t word) {
+    word = butil::HostToNet64(word);
+    dst.append(reinterpret_cast<const char*>(&word), sizeof(word));
+  }
+
+  static uint64_t ReadWord(const char* src) {
+    uint64_t word;
+    memcpy(&word, src, sizeof(word));
+    return butil::NetToHost64(word);
+  }
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_COMMON_KEY_CODEC_H_
@@ -14,10 +14,14 @@
 
 #include "common/latch.h"
 
+#include <algorithm>
 #include <cassert>
 #include <utility>
 
 #include "butil/scoped_lock.h"
+#include "bvar/recorder.h"
+#include "bvar/reducer.h"
+#include "bvar/window.h"
 #include "gflags/gflags.h"
 
 namespace dingodb {
@@ -27,6 +31,13 @@ DEFINE_uint32(latch_slot_num, 2048, "latch slot num");
 const size_t kWaitingListShrinkSize = 8;
 const size_t kWaitingListMaxCapacity = 16;
 
+// latch contention, the waiting size is the slot waiting list size when a cmd start waiting
+static bvar::Adder<int64_t> g_latch_wait_count("dingo_latch_wait_count");
+static bvar::IntRecorder g_latch_wait_size("dingo_latch_wait_size");
+static bvar::Maxer<int64_t> g_latch_max_wait_size;
+static bvar::Window<bvar::Maxer<int64_t>> g_latch_max_wait_size_window("dingo_latch_max_wait_size",
+                                                                         &g_latch_max_wait_size, 60);
+
 std::optional<uint64_t> Latch::GetFirstReqByHash(uint64_t hash) {
   for (const auto& [h, cid] : waiting) {
     if (h == hash) {
@@ -53,16 +64,18 @@ std::optional<std::pair<uint64_t, uint64_t>> Latch::PopFront(uint64_t key_hash)
   return std::nullopt;
 }
 
-void Latch::WaitForWake(uint64_t key_hash, uint64_t cid) { waiting.push_back(std::make_pair(key_hash, cid)); }
+void Latch::WaitForWake(uint64_t key_hash, uint64_t cid) {
+  waiting.push_back(std::make_pair(key_hash, cid));
+  max_waiting_size_ = std::max(max_waiting_size_, waiting.size());
+}
 
 void Latch::PushPreemptive(uint64_t key_hash, uint64_t cid) { waiting.push_front(std::make_pair(key_hash, cid)); }
 
+// Only shrink after a burst, not scan the waiting list on every pop.
 void Latch::MaybeShrink() {
-  waiting.erase(std::remove_if(waiting.begin(), waiting.end(), [](const auto& item) { return item.first == 0; }),
-                waiting.end());
-
-  if (waiting.size() > kWaitingListMaxCapacity && waiting.size() < kWaitingListShrinkSize) {
+  if (max_waiting_size_ > kWaitingListMaxCapacity && waiting.size() < kWaitingListShrinkSize) {
     waiting.shrink_to_fit();
+    max_waiting_size_ = waiting.size();
   }
 }
 
@@ -117,6 +130,9 @@ bool Latches::Acquire(Lock* lock, uint64_t who) const {
         ++acquired_count;
       } else {
         latch.WaitForWake(key_hash, who);
+        g_latch_wait_count << 1;
+        g_latch_wait_size << static_cast<int64_t>(latch.waiting.size());
+        g_latch_max_wait_size << static_cast<int64_t>(latch.waiting.size());
         break;
       }
     } else {
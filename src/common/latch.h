@@ -40,6 +40,9 @@ class Latch {
 
  private:
   void MaybeShrink();
+
+  // max waiting size since last shrink
+  size_t max_waiting_size_{0};
 };
 
 class Lock {
@@ -58,7 +61,8 @@ class Lock {
   static uint64_t Hash(const std::string& key);
 };
 
-struct Slot {
+// Padded to cache line, the adjacent slots are locked by different keys, not share cache line.
+struct alignas(64) Slot {
   Slot() { CHECK_EQ(0, bthread_mutex_init(&mutex, nullptr)); }
   ~Slot() { CHECK_EQ(0, bthread_mutex_destroy(&mutex)); }
   bthread_mutex_t mutex;
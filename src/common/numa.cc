@@ -0,0 +1,128 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "common/numa.h"
+
+#include <pthread.h>
+#include <sched.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "common/helper.h"
+#include "common/logging.h"
+#include "fmt/core.h"
+
+namespace dingodb {
+
+static const std::string kNumaNodePath = "/sys/devices/system/node";
+
+static bool IsDigits(const std::string& str) {
+  return !str.empty() && std::all_of(str.begin(), str.end(), [](unsigned char c) { return std::isdigit(c); });
+}
+
+NumaTopology::NumaTopology() {
+  std::vector<int32_t> nodes;
+  for (const auto& filename : Helper::TraverseDirectory(kNumaNodePath, "node", false, true)) {
+    std::string no = filename.substr(4);
+    if (IsDigits(no)) {
+      nodes.push_back(Helper::StringToInt32(no));
+    }
+  }
+  std::sort(nodes.begin(), nodes.end());
+
+  for (auto node : nodes) {
+    std::ifstream file(fmt::format("{}/node{}/cpulist", kNumaNodePath, node));
+    std::string cpulist;
+    std::getline(file, cpulist);
+
+    std::vector<uint32_t> cpus;
+    if (!ParseCpuList(cpulist, cpus)) {
+      DINGO_LOG(WARNING) << fmt::format("[numa] parse node({}) cpulist failed, cpulist: {}", node, cpulist);
+      continue;
+    }
+    // memory only node
+    if (cpus.empty()) {
+      continue;
+    }
+
+    node_cpus_.push_back(std::move(cpus));
+  }
+
+  if (node_cpus_.empty()) {
+    std::vector<uint32_t> cpus;
+    for (int i = 0; i < Helper::GetCores(); ++i) {
+      cpus.push_back(i);
+    }
+    node_cpus_.push_back(std::move(cpus));
+  }
+
+  DINGO_LOG(INFO) << fmt::format("[numa] node num: {}", node_cpus_.size());
+}
+
+bool NumaTopology::BindCurrentThread(int32_t node) const {
+  if (node < 0 || node >= NodeNum()) {
+    return false;
+  }
+
+  cpu_set_t cpuset;
+  CPU_ZERO(&cpuset);
+  for (auto cpu : node_cpus_[node]) {
+    CPU_SET(cpu, &cpuset);
+  }
+
+  int ret = pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuset);
+  if (ret != 0) {
+    DINGO_LOG(ERROR) << fmt::format("[numa] bind thread to node({}) failed, error: {}", node, ret);
+    return false;
+  }
+
+  return true;
+}
+
+bool NumaTopology::ParseCpuList(const std::string& str, std::vector<uint32_t>& cpus) {
+  std::string cpulist = str;
+  cpulist.erase(std::remove_if(cpulist.begin(), cpulist.end(), [](unsigned char c) { return std::isspace(c); }),
+                cpulist.end());
+  if (cpulist.empty()) {
+    return true;
+  }
+
+  std::vector<std::string> ranges;
+  Helper::SplitString(cpulist, ',', ranges);
+  for (const auto& range : ranges) {
+    std::vector<std::string> bounds;
+    Helper::SplitString(range, '-', bounds);
+    if (bounds.empty() || bounds.size() > 2 || !IsDigits(bounds[0]) || !IsDigits(bounds.back())) {
+      return false;
+    }
+
+    int32_t start = Helper::StringToInt32(bounds[0]);
+    int32_t end = Helper::StringToInt32(bounds.back());
+    if (start > end) {
+      return false;
+    }
+    for (int32_t cpu = start; cpu <= end; ++cpu) {
+      cpus.push_back(cpu);
+    }
+  }
+
+  return true;
+}
+
+}  // namespace dingodb
@@ -0,0 +1,55 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_COMMON_NUMA_H_
+#define DINGODB_COMMON_NUMA_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace dingodb {
+
+// NUMA topology of the machine, read from /sys/devices/system/node.
+// A machine without NUMA support is treated as one node with all cpus.
+class NumaTopology {
+ public:
+  static NumaTopology& GetInstance() {
+    static NumaTopology instance;
+    return instance;
+  }
+
+  int32_t NodeNum() const { return node_cpus_.size(); }
+  const std::vector<uint32_t>& NodeCpus(int32_t node) const { return node_cpus_[node]; }
+
+  // id(e.g. region id) is assigned to node by hash.
+  int32_t NodeOfId(int64_t id) const { return static_cast<int32_t>(static_cast<uint64_t>(id) % node_cpus_.size()); }
+
+  // bind current thread to the cpus of node
+  bool BindCurrentThread(int32_t node) const;
+
+  // parse cpulist format, e.g. 0-3,8,10-11
+  static bool ParseCpuList(const std::string& str, std::vector<uint32_t>& cpus);
+
+ private:
+  NumaTopology();
+  ~NumaTopology() = default;
+
+  // node -> cpus, index is the order of online node
+  std::vector<std::vector<uint32_t>> node_cpus_;
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_COMMON_NUMA_H_
@@ -0,0 +1,151 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_COMMON_POOL_ALLOCATOR_H_
+#define DINGODB_COMMON_POOL_ALLOCATOR_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <utility>
+
+namespace dingodb {
+
+// Thread local free list of fixed size blocks, used to reuse the memory of the short lived per request objects
+// without going through the global allocator.
+// The block freed by a thread is cached by the freeing thread, so the request object created by the brpc worker and
+// released by the raft apply thread is still reused, at most kMaxCachedBlockNum blocks are cached per thread.
+template <size_t kBlockSize>
+class ThreadLocalBlockCache {
+ public:
+  static constexpr int64_t kMaxCachedBlockNum = 4096;
+
+  static void* Allocate() {
+    auto& free_list = GetFreeList();
+    if (free_list.head == nullptr) {
+      return ::operator new(kBlockSize);
+    }
+
+    auto* block = free_list.head;
+    free_list.head = block->next;
+    --free_list.count;
+    return block;
+  }
+
+  static void Deallocate(void* ptr) {
+    auto& free_list = GetFreeList();
+    if (free_list.disabled || free_list.count >= kMaxCachedBlockNum) {
+      ::operator delete(ptr);
+      return;
+    }
+
+    auto* block = static_cast<Block*>(ptr);
+    block->next = free_list.head;
+    free_list.head = block;
+    ++free_list.count;
+  }
+
+  static int64_t CachedBlockNum() { return GetFreeList().count; }
+
+ private:
+  static_assert(kBlockSize >= sizeof(void*), "block is too small");
+
+  struct Block {
+    Block* next;
+  };
+
+  // trivially destructible, so it is still usable by the thread local objects destructed after the guard
+  struct FreeList {
+    Block* head{nullptr};
+    int64_t count{0};
+    bool disabled{false};
+  };
+
+  // free the cached blocks at thread exit
+  struct Guard {
+    ~Guard() {
+      auto& free_list = free_list_;
+      free_list.disabled = true;
+      while (free_list.head != nullptr) {
+        auto* block = free_list.head;
+        free_list.head = block->next;
+        ::operator delete(block);
+      }
+      free_list.count = 0;
+    }
+  };
+
+  static FreeList& GetFreeList() {
+    thread_local Guard guard;
+    (void)guard;
+    return free_list_;
+  }
+
+  static thread_local FreeList free_list_;
+};
+
+template <size_t kBlockSize>
+thread_local typename ThreadLocalBlockCache<kBlockSize>::FreeList ThreadLocalBlockCache<kBlockSize>::free_list_;
+
+// Standard allocator on ThreadLocalBlockCache, the type of same rounded size share the cache.
+template <typename T>
+class PoolAllocator {
+ public:
+  using value_type = T;
+
+  PoolAllocator() noexcept = default;
+  template <typename U>
+  PoolAllocator(const PoolAllocator<U>&) noexcept {}  // NOLINT
+
+  T* allocate(size_t n) {
+    if (n != 1) {
+      return static_cast<T*>(::operator new(n * sizeof(T)));
+    }
+    return static_cast<T*>(Cache::Allocate());
+  }
+
+  void deallocate(T* ptr, size_t n) noexcept {
+    if (n != 1) {
+      ::operator delete(ptr);
+      return;
+    }
+    Cache::Deallocate(ptr);
+  }
+
+  template <typename U>
+  bool operator==(const PoolAllocator<U>&) const noexcept {
+    return true;
+  }
+  template <typename U>
+  bool operator!=(const PoolAllocator<U>&) const noexcept {
+    return false;
+  }
+
+ private:
+  static_assert(alignof(T) <= __STDCPP_DEFAULT_NEW_ALIGNMENT__, "over aligned type is not supported");
+
+  static constexpr size_t kAlignment = 16;
+  using Cache = ThreadLocalBlockCache<(sizeof(T) + kAlignment - 1) / kAlignment * kAlignment>;
+};
+
+// Like std::make_shared, the object and control block are allocated from the thread local pool.
+template <typename T, typename... Args>
+std::shared_ptr<T> MakePooledShared(Args&&... args) {
+  return std::allocate_shared<T>(PoolAllocator<T>(), std::forward<Args>(args)...);
+}
+
+}  // namespace dingodb
+
+#endif  // DINGODB_COMMON_POOL_ALLOCATOR_H_
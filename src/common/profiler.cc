@@ -0,0 +1,139 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "common/profiler.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "bthread/bthread.h"
+#include "common/helper.h"
+#include "common/logging.h"
+#include "fmt/core.h"
+#include "gflags/gflags.h"
+
+#ifdef LINK_TCMALLOC
+#include "gperftools/malloc_extension.h"
+#endif
+
+#ifdef BRPC_ENABLE_CPU_PROFILER
+#include "gperftools/profiler.h"
+#endif
+
+namespace dingodb {
+
+DEFINE_bool(enable_continuous_profiler, false, "enable dump cpu and heap profile periodically");
+DEFINE_int32(continuous_profiler_interval_s, 600, "continuous profiler dump interval seconds");
+DEFINE_int32(continuous_profiler_cpu_duration_s, 10, "continuous profiler cpu profile duration seconds");
+DEFINE_string(continuous_profiler_dir, "./profile", "continuous profiler dump directory");
+DEFINE_int32(continuous_profiler_keep_num, 24, "continuous profiler keep latest profile number of every kind");
+
+bool ContinuousProfiler::IsEnabled() { return FLAGS_enable_continuous_profiler; }
+
+void ContinuousProfiler::Run() {
+  if (!IsEnabled()) {
+    return;
+  }
+  // skip when the last round is still running
+  bool expected = false;
+  if (!is_running_.compare_exchange_strong(expected, true)) {
+    return;
+  }
+
+  const std::string& dirpath = FLAGS_continuous_profiler_dir;
+  auto status = Helper::CreateDirectories(dirpath);
+  if (!status.ok()) {
+    DINGO_LOG(ERROR) << fmt::format("[profiler] create directory {} failed, error: {}", dirpath, status.error_str());
+    is_running_.store(false);
+    return;
+  }
+
+  // fixed width timestamp keeps the filename order same as time order
+  std::string timestamp = fmt::format("{:016}", Helper::TimestampMs());
+
+  std::string cpu_filepath = fmt::format("{}/cpu.{}.prof", dirpath, timestamp);
+  if (ProfileCpu(cpu_filepath, FLAGS_continuous_profiler_cpu_duration_s)) {
+    CleanExpiredProfiles(dirpath, "cpu");
+  }
+
+  std::string heap_filepath = fmt::format("{}/heap.{}.prof", dirpath, timestamp);
+  if (ProfileHeap(heap_filepath)) {
+    CleanExpiredProfiles(dirpath, "heap");
+  }
+
+  is_running_.store(false);
+}
+
+bool ContinuousProfiler::ProfileCpu(const std::string& filepath, int64_t duration_s) {
+#ifdef BRPC_ENABLE_CPU_PROFILER
+  // fail when brpc /hotspots/cpu is profiling
+  if (!ProfilerStart(filepath.c_str())) {
+    DINGO_LOG(WARNING) << fmt::format("[profiler] start cpu profiler failed, maybe is profiling, path: {}", filepath);
+    return false;
+  }
+
+  bthread_usleep(std::max(duration_s, static_cast<int64_t>(1)) * 1000 * 1000);
+  ProfilerStop();
+
+  DINGO_LOG(INFO) << fmt::format("[profiler] dump cpu profile {}", filepath);
+  return true;
+#else
+  (void)filepath;
+  (void)duration_s;
+  return false;
+#endif
+}
+
+bool ContinuousProfiler::ProfileHeap(const std::string& filepath) {
+#ifdef LINK_TCMALLOC
+  std::string heap_sample;
+  MallocExtension::instance()->GetHeapSample(&heap_sample);
+  if (heap_sample.empty()) {
+    return false;
+  }
+
+  if (!Helper::SaveFile(filepath, heap_sample)) {
+    DINGO_LOG(ERROR) << fmt::format("[profiler] save heap profile {} failed", filepath);
+    return false;
+  }
+
+  DINGO_LOG(INFO) << fmt::format("[profiler] dump heap profile {}", filepath);
+  return true;
+#else
+  (void)filepath;
+  return false;
+#endif
+}
+
+std::vector<std::string> ContinuousProfiler::ExpiredProfiles(std::vector<std::string> filenames, int32_t keep_num) {
+  keep_num = std::max(keep_num, 1);
+  if (filenames.size() <= static_cast<size_t>(keep_num)) {
+    return {};
+  }
+
+  std::sort(filenames.begin(), filenames.end());
+  filenames.resize(filenames.size() - keep_num);
+  return filenames;
+}
+
+void ContinuousProfiler::CleanExpiredProfiles(const std::string& dirpath, const std::string& kind) {
+  auto filenames = Helper::TraverseDirectory(dirpath, kind + ".", true, false);
+  for (const auto& filename : ExpiredProfiles(filenames, FLAGS_continuous_profiler_keep_num)) {
+    Helper::RemoveFileOrDirectory(fmt::format("{}/{}", dirpath, filename));
+  }
+}
+
+}  // namespace dingodb
@@ -0,0 +1,57 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_COMMON_PROFILER_H_
+#define DINGODB_COMMON_PROFILER_H_
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace dingodb {
+
+// Continuous profiling, periodically dump a sampled cpu profile and a heap profile of the process into the profile
+// directory in pprof format, and keep the latest ones, so a problem is still visible after it's gone.
+// The cpu profile requires BRPC_ENABLE_CPU_PROFILER, the heap profile requires LINK_TCMALLOC and
+// TCMALLOC_SAMPLE_PARAMETER env. The on-demand profiles are served by brpc builtin /hotspots/cpu and /hotspots/heap.
+class ContinuousProfiler {
+ public:
+  static ContinuousProfiler& GetInstance() {
+    static ContinuousProfiler instance;
+    return instance;
+  }
+
+  static bool IsEnabled();
+
+  // Dump one round profiles, called by crontab, it blocks for the cpu profile duration.
+  void Run();
+
+  // Profile files of the kind(cpu/heap) to remove, keep the latest keep_num, filenames are ordered by time.
+  static std::vector<std::string> ExpiredProfiles(std::vector<std::string> filenames, int32_t keep_num);
+
+ private:
+  ContinuousProfiler() = default;
+  ~ContinuousProfiler() = default;
+
+  static bool ProfileCpu(const std::string& filepath, int64_t duration_s);
+  static bool ProfileHeap(const std::string& filepath);
+  static void CleanExpiredProfiles(const std::string& dirpath, const std::string& kind);
+
+  std::atomic<bool> is_running_{false};
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_COMMON_PROFILER_H_
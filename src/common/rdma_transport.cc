@@ -0,0 +1,75 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "common/rdma_transport.h"
+
+#include <string>
+
+#include "common/helper.h"
+#include "common/logging.h"
+#include "fmt/core.h"
+#include "gflags/gflags.h"
+
+namespace dingodb {
+
+DEFINE_bool(use_rdma, false, "use rdma for brpc server and channel, fall back to tcp if rdma is unavailable");
+
+static const std::string kRdmaDevicePath = "/sys/class/infiniband";
+
+bool RdmaTransport::IsDeviceAvailable() {
+  auto devices = Helper::TraverseDirectory(kRdmaDevicePath, false, false);
+  DINGO_LOG(INFO) << fmt::format("[rdma] device num: {}", devices.size());
+  return !devices.empty();
+}
+
+bool RdmaTransport::IsEnabled() {
+  // decided once at startup, the servers and channels use the same transport
+  static const bool enabled = [] {
+    if (!FLAGS_use_rdma) {
+      return false;
+    }
+#ifdef BRPC_WITH_RDMA
+    if (!IsDeviceAvailable()) {
+      DINGO_LOG(WARNING) << "[rdma] no rdma device, fall back to tcp.";
+      return false;
+    }
+    DINGO_LOG(INFO) << "[rdma] use rdma transport.";
+    return true;
+#else
+    DINGO_LOG(WARNING) << "[rdma] not built with rdma, fall back to tcp.";
+    return false;
+#endif
+  }();
+
+  return enabled;
+}
+
+void RdmaTransport::SetServerOptions(brpc::ServerOptions& options) {
+#ifdef BRPC_WITH_RDMA
+  options.use_rdma = IsEnabled();
+#else
+  (void)options;
+#endif
+}
+
+void RdmaTransport::SetChannelOptions(brpc::ChannelOptions& options) {
+#ifdef BRPC_WITH_RDMA
+  options.use_rdma = IsEnabled();
+#else
+  (void)options;
+#endif
+}
+
+}  // namespace dingodb
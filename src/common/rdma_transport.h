@@ -0,0 +1,41 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef DINGODB_COMMON_RDMA_TRANSPORT_H_
+#define DINGODB_COMMON_RDMA_TRANSPORT_H_
+
+#include "brpc/channel.h"
+#include "brpc/server.h"
+
+namespace dingodb {
+
+// RDMA transport of brpc, only available when built with WITH_RDMA.
+// It is used when enabled by gflags and the machine has a rdma device, otherwise fall back to tcp. The connection
+// also falls back to tcp in brpc handshake when the peer doesn't use rdma.
+class RdmaTransport {
+ public:
+  static bool IsEnabled();
+
+  // Use rdma for the server and channel if enabled.
+  static void SetServerOptions(brpc::ServerOptions& options);
+  static void SetChannelOptions(brpc::ChannelOptions& options);
+
+ private:
+  static bool IsDeviceAvailable();
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_COMMON_RDMA_TRANSPORT_H_
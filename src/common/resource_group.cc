@@ -0,0 +1,178 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "common/resource_group.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "bvar/reducer.h"
+#include "common/helper.h"
+#include "common/logging.h"
+#include "fmt/core.h"
+#include "gflags/gflags.h"
+
+namespace dingodb {
+
+DEFINE_bool(enable_resource_group, false, "enable request unit throttling of tenant resource group");
+DEFINE_string(resource_group_ru_budgets, "", "ru per second of tenant, format: tenant_id:ru_per_second,...");
+DEFINE_int64(resource_group_burst_seconds, 1, "max seconds of budget a resource group can save");
+DEFINE_int64(resource_group_ru_cpu_us, 1000, "run time of one request unit");
+
+static bool ValidateRuBudgets(const char*, const std::string& value) {
+  std::map<int64_t, int64_t> budgets;
+  if (!ResourceGroupManager::ParseBudgets(value, budgets)) {
+    return false;
+  }
+
+  ResourceGroupManager::GetInstance().SetBudgets(budgets, Helper::TimestampUs());
+  DINGO_LOG(INFO) << fmt::format("[resource_group] update budgets: {}", value);
+  return true;
+}
+DEFINE_validator(resource_group_ru_budgets, &ValidateRuBudgets);
+
+bvar::Adder<uint64_t> g_resource_group_throttle_count("dingo_resource_group_throttle_count");
+
+// base ru of request type, the read of small data is cheaper than write and vector search
+static const double kQosRequestTypeBaseRu[kQosRequestTypeNum] = {0.125, 0.5, 2, 1};
+
+ResourceGroupManager& ResourceGroupManager::GetInstance() {
+  static ResourceGroupManager instance;
+  static bool loaded = [] {
+    std::map<int64_t, int64_t> budgets;
+    if (!ParseBudgets(FLAGS_resource_group_ru_budgets, budgets)) {
+      DINGO_LOG(WARNING) << fmt::format("[resource_group] parse budgets failed, budgets: {}",
+                                        FLAGS_resource_group_ru_budgets);
+    }
+    instance.SetBudgets(budgets, Helper::TimestampUs());
+    return true;
+  }();
+  (void)loaded;
+
+  return instance;
+}
+
+bool ResourceGroupManager::IsEnabled() { return FLAGS_enable_resource_group; }
+
+bool ResourceGroupManager::ParseBudgets(const std::string& budgets_str, std::map<int64_t, int64_t>& budgets) {
+  std::vector<std::string> items;
+  Helper::SplitString(budgets_str, ',', items);
+  for (const auto& item : items) {
+    if (item.empty()) {
+      continue;
+    }
+
+    std::vector<std::string> tenant_budget;
+    Helper::SplitString(item, ':', tenant_budget);
+    if (tenant_budget.size() != 2) {
+      return false;
+    }
+
+    int64_t ru_per_second = std::strtoll(tenant_budget[1].c_str(), nullptr, 10);
+    if (ru_per_second <= 0) {
+      return false;
+    }
+    budgets[std::strtoll(tenant_budget[0].c_str(), nullptr, 10)] = ru_per_second;
+  }
+
+  return true;
+}
+
+double ResourceGroupManager::RequestUnit(QosRequestType request_type, int64_t run_time_us) {
+  return kQosRequestTypeBaseRu[static_cast<int>(request_type)] +
+         static_cast<double>(std::max(run_time_us, static_cast<int64_t>(0))) /
+             std::max(FLAGS_resource_group_ru_cpu_us, static_cast<int64_t>(1));
+}
+
+void ResourceGroupManager::Refill(Group& group, int64_t now_us) {
+  if (now_us <= group.last_refill_time_us) {
+    return;
+  }
+
+  int64_t burst_seconds = std::max(FLAGS_resource_group_burst_seconds, static_cast<int64_t>(1));
+  double burst = static_cast<double>(group.ru_per_second) * burst_seconds;
+  double refill = static_cast<double>(group.ru_per_second) * (now_us - group.last_refill_time_us) / 1000000;
+  group.tokens = std::min(burst, group.tokens + refill);
+  group.last_refill_time_us = now_us;
+}
+
+void ResourceGroupManager::SetBudgets(const std::map<int64_t, int64_t>& budgets, int64_t now_us) {
+  std::lock_guard<bthread::Mutex> lock(mutex_);
+
+  std::map<int64_t, Group> groups;
+  for (const auto& [tenant_id, ru_per_second] : budgets) {
+    auto& group = groups[tenant_id];
+    auto it = groups_.find(tenant_id);
+    if (it != groups_.end()) {
+      group = it->second;
+      Refill(group, now_us);
+    } else {
+      // start with a full second of budget
+      group.tokens = ru_per_second;
+      group.last_refill_time_us = now_us;
+    }
+    group.ru_per_second = ru_per_second;
+  }
+  groups_.swap(groups);
+}
+
+bool ResourceGroupManager::Admit(int64_t tenant_id, int64_t now_us) {
+  std::lock_guard<bthread::Mutex> lock(mutex_);
+
+  auto it = groups_.find(tenant_id);
+  if (it == groups_.end()) {
+    return true;
+  }
+
+  Refill(it->second, now_us);
+  if (it->second.tokens > 0) {
+    return true;
+  }
+
+  g_resource_group_throttle_count << 1;
+  return false;
+}
+
+void ResourceGroupManager::Charge(int64_t tenant_id, QosRequestType request_type, int64_t run_time_us,
+                                  int64_t now_us) {
+  double ru = RequestUnit(request_type, run_time_us);
+
+  std::lock_guard<bthread::Mutex> lock(mutex_);
+  auto it = groups_.find(tenant_id);
+  if (it == groups_.end()) {
+    return;
+  }
+
+  Refill(it->second, now_us);
+  it->second.tokens -= ru;
+}
+
+double ResourceGroupManager::Tokens(int64_t tenant_id, int64_t now_us) {
+  std::lock_guard<bthread::Mutex> lock(mutex_);
+  auto it = groups_.find(tenant_id);
+  if (it == groups_.end()) {
+    return 0;
+  }
+
+  Refill(it->second, now_us);
+  return it->second.tokens;
+}
+
+}  // namespace dingodb
@@ -0,0 +1,77 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef DINGODB_COMMON_RESOURCE_GROUP_H_
+#define DINGODB_COMMON_RESOURCE_GROUP_H_
+
+#include <cstdint>
+#include <map>
+#include <string>
+
+#include "bthread/mutex.h"
+#include "common/runnable.h"
+
+namespace dingodb {
+
+// Request unit(RU) budget of tenants, every tenant with a budget is a resource group with a token bucket.
+// The bucket is refilled by ru_per_second up to burst_seconds of budget. A task is admitted before entering the worker
+// set when its bucket is not in debt, and charged by its measured cost after run, so a tenant over budget is rejected
+// until it pays back the debt. The tenant without budget is unlimited.
+// RU of a task is the base cost of its request type plus its run time.
+class ResourceGroupManager {
+ public:
+  ResourceGroupManager() = default;
+  ~ResourceGroupManager() = default;
+
+  ResourceGroupManager(const ResourceGroupManager&) = delete;
+  ResourceGroupManager& operator=(const ResourceGroupManager&) = delete;
+
+  // Budgets are loaded from gflags, and reloaded when the gflags changed.
+  static ResourceGroupManager& GetInstance();
+
+  static bool IsEnabled();
+
+  // Parse budgets, format: tenant_id:ru_per_second,... e.g. 1:1000,2:500
+  static bool ParseBudgets(const std::string& budgets_str, std::map<int64_t, int64_t>& budgets);
+
+  static double RequestUnit(QosRequestType request_type, int64_t run_time_us);
+
+  // Replace the budgets, the bucket of the kept tenant is kept.
+  void SetBudgets(const std::map<int64_t, int64_t>& budgets, int64_t now_us);
+
+  // Return false if the tenant is throttled.
+  bool Admit(int64_t tenant_id, int64_t now_us);
+  void Charge(int64_t tenant_id, QosRequestType request_type, int64_t run_time_us, int64_t now_us);
+
+  // Tokens of the tenant, 0 if no budget.
+  double Tokens(int64_t tenant_id, int64_t now_us);
+
+ private:
+  struct Group {
+    int64_t ru_per_second{0};
+    double tokens{0};
+    int64_t last_refill_time_us{0};
+  };
+
+  static void Refill(Group& group, int64_t now_us);
+
+  bthread::Mutex mutex_;
+  // tenant_id -> group
+  std::map<int64_t, Group> groups_;
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_COMMON_RESOURCE_GROUP_H_
@@ -14,19 +14,32 @@
 
 #include "common/runnable.h"
 
+#include <algorithm>
 #include <atomic>
 #include <cstdint>
+#include <cstdlib>
 #include <string>
+#include <vector>
 
 #include "bthread/bthread.h"
 #include "butil/compiler_specific.h"
 #include "common/helper.h"
 #include "common/logging.h"
+#include "common/resource_group.h"
 #include "common/synchronization.h"
 #include "fmt/core.h"
+#include "gflags/gflags.h"
 
 namespace dingodb {
 
+DEFINE_bool(enable_worker_set_fair_queue, false, "enable weighted fair queue of simple worker set");
+DEFINE_string(worker_set_fair_queue_shares, "point_read:8,scan:1,vector_search:2,write:4",
+              "share of request type in worker set fair queue");
+DEFINE_bool(enable_worker_set_admission_control, false, "enable queue delay based admission control of worker set");
+DEFINE_int64(worker_set_admission_target_ms, 50, "target queue delay of worker set admission control");
+DEFINE_int64(worker_set_admission_interval_ms, 100,
+             "queue delay above target for a whole interval make worker set overload");
+
 TaskRunnable::TaskRunnable() : id_(GenId()) { create_time_us_ = Helper::TimestampUs(); }
 TaskRunnable::~TaskRunnable() = default;
 
@@ -293,17 +306,157 @@ std::vector<std::vector<std::string>> ExecqWorkerSet::GetPendingTaskTrace() {
   return traces;
 }
 
+static const char* kQosRequestTypeNames[kQosRequestTypeNum] = {"point_read", "scan", "vector_search", "write"};
+// initial cost estimation of request type before any task finished
+static const int64_t kQosRequestTypeInitCostUs[kQosRequestTypeNum] = {100, 1000, 2000, 500};
+
+WeightedFairQueue::WeightedFairQueue() {
+  shares_.fill(1);
+  if (!ParseShares(FLAGS_worker_set_fair_queue_shares, shares_)) {
+    DINGO_LOG(WARNING) << fmt::format("[execqueue] parse fair queue shares failed, shares: {}",
+                                      FLAGS_worker_set_fair_queue_shares);
+    shares_.fill(1);
+  }
+
+  for (int i = 0; i < kQosRequestTypeNum; ++i) {
+    costs_us_[i].store(kQosRequestTypeInitCostUs[i], std::memory_order_relaxed);
+  }
+}
+
+bool WeightedFairQueue::ParseShares(const std::string& shares_str, std::array<uint32_t, kQosRequestTypeNum>& shares) {
+  std::vector<std::string> items;
+  Helper::SplitString(shares_str, ',', items);
+  for (const auto& item : items) {
+    std::vector<std::string> name_value;
+    Helper::SplitString(item, ':', name_value);
+    if (name_value.size() != 2) {
+      return false;
+    }
+
+    auto* it = std::find(std::begin(kQosRequestTypeNames), std::end(kQosRequestTypeNames), name_value[0]);
+    if (it == std::end(kQosRequestTypeNames)) {
+      return false;
+    }
+
+    int64_t share = std::strtoll(name_value[1].c_str(), nullptr, 10);
+    if (share <= 0) {
+      return false;
+    }
+    shares[it - std::begin(kQosRequestTypeNames)] = share;
+  }
+
+  return true;
+}
+
+void WeightedFairQueue::Push(TaskRunnablePtr task) {
+  int type = static_cast<int>(task->RequestType());
+  FlowKey flow_key = std::make_pair(task->TenantId(), type);
+  auto& flow = flows_[flow_key];
+
+  double start_tag = std::max(virtual_time_, flow.finish_tag);
+  flow.finish_tag = start_tag + static_cast<double>(Cost(task->RequestType())) / shares_[type];
+  task->SetStartTag(start_tag);
+
+  if (flow.tasks.empty()) {
+    active_flows_.insert(std::make_pair(start_tag, flow_key));
+  }
+  flow.tasks.push_back(task);
+  ++size_;
+}
+
+TaskRunnablePtr WeightedFairQueue::Pop() {
+  if (active_flows_.empty()) {
+    return nullptr;
+  }
+
+  auto active_it = active_flows_.begin();
+  FlowKey flow_key = active_it->second;
+  active_flows_.erase(active_it);
+
+  auto flow_it = flows_.find(flow_key);
+  auto& flow = flow_it->second;
+  auto task = flow.tasks.front();
+  flow.tasks.pop_front();
+  --size_;
+
+  virtual_time_ = std::max(virtual_time_, task->StartTag());
+
+  if (!flow.tasks.empty()) {
+    active_flows_.insert(std::make_pair(flow.tasks.front()->StartTag(), flow_key));
+  }
+
+  // idle flow whose finish tag is behind virtual time is same as a new flow, remove it periodically
+  if (++pop_count_ % kIdleFlowCleanInterval == 0) {
+    for (auto it = flows_.begin(); it != flows_.end();) {
+      if (it->second.tasks.empty() && it->second.finish_tag <= virtual_time_) {
+        it = flows_.erase(it);
+      } else {
+        ++it;
+      }
+    }
+  }
+
+  return task;
+}
+
+void WeightedFairQueue::UpdateCost(QosRequestType request_type, int64_t run_time_us) {
+  // moving average, new sample weight 1/8
+  auto& cost = costs_us_[static_cast<int>(request_type)];
+  int64_t old_cost = cost.load(std::memory_order_relaxed);
+  cost.store(std::max(old_cost + (run_time_us - old_cost) / 8, static_cast<int64_t>(1)), std::memory_order_relaxed);
+}
+
+int64_t WeightedFairQueue::Cost(QosRequestType request_type) const {
+  return costs_us_[static_cast<int>(request_type)].load(std::memory_order_relaxed);
+}
+
+uint32_t WeightedFairQueue::Share(QosRequestType request_type) const {
+  return shares_[static_cast<int>(request_type)];
+}
+
+bool CodelAdmission::OnDequeue(int64_t sojourn_us, int64_t now_us) {
+  if (sojourn_us < target_us_) {
+    first_above_time_us_ = 0;
+    is_overload_.store(false, std::memory_order_relaxed);
+    return false;
+  }
+
+  if (first_above_time_us_ == 0) {
+    first_above_time_us_ = now_us + interval_us_;
+    return false;
+  }
+
+  if (now_us >= first_above_time_us_ && !IsOverload()) {
+    is_overload_.store(true, std::memory_order_relaxed);
+    return true;
+  }
+
+  return false;
+}
+
+void CodelAdmission::Reset() {
+  first_above_time_us_ = 0;
+  is_overload_.store(false, std::memory_order_relaxed);
+}
+
 SimpleWorkerSet::SimpleWorkerSet(std::string name, uint32_t worker_num, int64_t max_pending_task_count,
                                  bool use_pthread, bool use_prior)
     : name_(name),
       worker_num_(worker_num),
       use_pthread_(use_pthread),
       use_prior_(use_prior),
+      use_fair_(FLAGS_enable_worker_set_fair_queue && !use_prior),
+      use_admission_(FLAGS_enable_worker_set_admission_control),
+      admission_(FLAGS_worker_set_admission_target_ms * 1000, FLAGS_worker_set_admission_interval_ms * 1000),
+      use_resource_group_(ResourceGroupManager::IsEnabled()),
       max_pending_task_count_(max_pending_task_count),
       total_task_count_metrics_(fmt::format("dingo_simple_worker_set_{}_total_task_count", name)),
       pending_task_count_metrics_(fmt::format("dingo_simple_worker_set_{}_pending_task_count", name)),
       queue_wait_metrics_(fmt::format("dingo_simple_worker_set_{}_queue_wait_latency", name)),
-      queue_run_metrics_(fmt::format("dingo_simple_worker_set_{}_queue_run_latency", name)) {
+      queue_run_metrics_(fmt::format("dingo_simple_worker_set_{}_queue_run_latency", name)),
+      admission_reject_count_metrics_(fmt::format("dingo_simple_worker_set_{}_admission_reject_count", name)),
+      resource_group_reject_count_metrics_(
+          fmt::format("dingo_simple_worker_set_{}_resource_group_reject_count", name)) {
   bthread_mutex_init(&mutex_, nullptr);
   bthread_cond_init(&cond_, nullptr);
 }
@@ -325,21 +478,18 @@ bool SimpleWorkerSet::Init() {
     if (!use_prior_) {
       while (true) {
         bthread_mutex_lock(&mutex_);
-        while (!is_stop_ && tasks_.empty()) {
+        while (!is_stop_ && IsTaskQueueEmpty()) {
           bthread_cond_wait(&cond_, &mutex_);
         }
 
-        if (is_stop_ && tasks_.empty()) {
+        if (is_stop_ && IsTaskQueueEmpty()) {
           bthread_mutex_unlock(&mutex_);
           break;
         }
 
         // get task from task queue
-        TaskRunnablePtr task = nullptr;
-        if (BAIDU_LIKELY(!tasks_.empty())) {
-          task = tasks_.front();
-          tasks_.pop();
-        }
+        TaskRunnablePtr task = PopTask();
+        CheckAdmission(task);
 
         bthread_mutex_unlock(&mutex_);
 
@@ -349,7 +499,15 @@ bool SimpleWorkerSet::Init() {
 
           task->Run();
 
-          queue_run_metrics_ << Helper::TimestampUs() - now_time_us;
+          int64_t run_time_us = Helper::TimestampUs() - now_time_us;
+          queue_run_metrics_ << run_time_us;
+          if (use_fair_) {
+            fair_tasks_.UpdateCost(task->RequestType(), run_time_us);
+          }
+          if (use_resource_group_ && task->HasQos()) {
+            ResourceGroupManager::GetInstance().Charge(task->TenantId(), task->RequestType(), run_time_us,
+                                                       now_time_us + run_time_us);
+          }
           DecPendingTaskCount();
           Notify(WorkerEventType::kFinishTask);
         }
@@ -371,6 +529,7 @@ bool SimpleWorkerSet::Init() {
           task = prior_tasks_.top();
           prior_tasks_.pop();
         }
+        CheckAdmission(task);
 
         bthread_mutex_unlock(&mutex_);
 
@@ -446,16 +605,22 @@ bool SimpleWorkerSet::Execute(TaskRunnablePtr task) {
     }
   }
 
+  if (use_admission_ && admission_.IsOverload()) {
+    admission_reject_count_metrics_ << 1;
+    return false;
+  }
+
+  if (use_resource_group_ && task->HasQos() &&
+      !ResourceGroupManager::GetInstance().Admit(task->TenantId(), Helper::TimestampUs())) {
+    resource_group_reject_count_metrics_ << 1;
+    return false;
+  }
+
   IncPendingTaskCount();
   IncTotalTaskCount();
 
   bthread_mutex_lock(&mutex_);
-  if (!use_prior_) {
-    tasks_.push(task);
-  } else {
-    prior_tasks_.push(task);
-  }
-
+  PushTask(task);
   bthread_mutex_unlock(&mutex_);
 
   bthread_cond_signal(&cond_);
@@ -463,6 +628,47 @@ bool SimpleWorkerSet::Execute(TaskRunnablePtr task) {
   return true;
 }
 
+void SimpleWorkerSet::PushTask(TaskRunnablePtr task) {
+  if (use_prior_) {
+    prior_tasks_.push(task);
+  } else if (use_fair_) {
+    fair_tasks_.Push(task);
+  } else {
+    tasks_.push(task);
+  }
+}
+
+TaskRunnablePtr SimpleWorkerSet::PopTask() {
+  TaskRunnablePtr task = nullptr;
+  if (use_fair_) {
+    task = fair_tasks_.Pop();
+  } else if (BAIDU_LIKELY(!tasks_.empty())) {
+    task = tasks_.front();
+    tasks_.pop();
+  }
+
+  return task;
+}
+
+bool SimpleWorkerSet::IsTaskQueueEmpty() { return use_fair_ ? fair_tasks_.Empty() : tasks_.empty(); }
+
+void SimpleWorkerSet::CheckAdmission(TaskRunnablePtr task) {
+  if (!use_admission_ || task == nullptr) {
+    return;
+  }
+
+  int64_t now_time_us = Helper::TimestampUs();
+  int64_t sojourn_us = now_time_us - task->CreateTimeUs();
+  if (admission_.OnDequeue(sojourn_us, now_time_us)) {
+    DINGO_LOG(WARNING) << fmt::format("[execqueue] worker set {} overload, queue delay {}us, pending task count {}.",
+                                      name_, sojourn_us, pending_task_count_.load(std::memory_order_relaxed));
+  }
+
+  if (use_prior_ ? prior_tasks_.empty() : IsTaskQueueEmpty()) {
+    admission_.Reset();
+  }
+}
+
 bool SimpleWorkerSet::ExecuteRR(TaskRunnablePtr task) { return Execute(task); }
 
 bool SimpleWorkerSet::ExecuteLeastQueue(TaskRunnablePtr task) { return Execute(task); }
@@ -481,6 +687,8 @@ void SimpleWorkerSet::IncTotalTaskCount() { total_task_count_metrics_ << 1; }
 
 uint64_t SimpleWorkerSet::PendingTaskCount() { return pending_task_count_.load(std::memory_order_relaxed); }
 
+int64_t SimpleWorkerSet::QueueWaitLatencyUs() { return queue_wait_metrics_.latency(); }
+
 void SimpleWorkerSet::IncPendingTaskCount() {
   pending_task_count_metrics_ << 1;
   pending_task_count_.fetch_add(1, std::memory_order_relaxed);
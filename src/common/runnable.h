@@ -15,13 +15,17 @@
 #ifndef DINGODB_COMMON_RUNNABLE_H_
 #define DINGODB_COMMON_RUNNABLE_H_
 
+#include <array>
 #include <atomic>
 #include <cstdint>
+#include <deque>
 #include <functional>
 #include <map>
 #include <memory>
 #include <queue>
+#include <set>
 #include <string>
+#include <utility>
 #include <thread>
 #include <vector>
 
@@ -32,6 +36,16 @@
 
 namespace dingodb {
 
+// Request type of task for fair queue, every type has its own share and cost estimation.
+enum class QosRequestType : uint8_t {
+  kPointRead = 0,
+  kScan = 1,
+  kVectorSearch = 2,
+  kWrite = 3,
+};
+
+constexpr int kQosRequestTypeNum = 4;
+
 class TaskRunnable {
  public:
   TaskRunnable();
@@ -57,10 +71,29 @@ class TaskRunnable {
 
   int64_t CreateTimeUs() const { return create_time_us_; }
 
+  int64_t TenantId() const { return tenant_id_; }
+  QosRequestType RequestType() const { return request_type_; }
+  void SetQos(int64_t tenant_id, QosRequestType request_type) {
+    tenant_id_ = tenant_id;
+    request_type_ = request_type;
+    has_qos_ = true;
+  }
+  // Only the task of client request has qos, e.g. not the raft apply task.
+  bool HasQos() const { return has_qos_; }
+
+  // Virtual start time of task in fair queue.
+  double StartTag() const { return start_tag_; }
+  void SetStartTag(double start_tag) { start_tag_ = start_tag; }
+
  private:
   uint64_t id_{0};
   int32_t priority_{0};
   int64_t create_time_us_{0};
+
+  int64_t tenant_id_{0};
+  QosRequestType request_type_{QosRequestType::kPointRead};
+  bool has_qos_{false};
+  double start_tag_{0};
 };
 
 using TaskRunnablePtr = std::shared_ptr<TaskRunnable>;
@@ -125,6 +158,76 @@ class Worker {
 
 using WorkerPtr = std::shared_ptr<Worker>;
 
+// Start-time fair queuing of tasks, every (tenant, request type) is a flow.
+// A task is tagged with virtual start time max(virtual_time, flow finish time), and flow finish time moves forward
+// by estimated cost / share of the request type, the task with the smallest start tag is run first. So a tenant's
+// heavy scan or bulk write only consumes its own share and can't starve point reads of others.
+// Cost of request type is estimated by moving average of the run time of finished tasks.
+// Not thread safe, protected by the caller.
+class WeightedFairQueue {
+ public:
+  WeightedFairQueue();
+  ~WeightedFairQueue() = default;
+
+  void Push(TaskRunnablePtr task);
+  TaskRunnablePtr Pop();
+
+  bool Empty() const { return size_ == 0; }
+  size_t Size() const { return size_; }
+
+  // Feedback the run time of finished task, thread safe.
+  void UpdateCost(QosRequestType request_type, int64_t run_time_us);
+  int64_t Cost(QosRequestType request_type) const;
+  uint32_t Share(QosRequestType request_type) const;
+
+  // Parse shares, format: point_read:8,scan:1,vector_search:2,write:4
+  static bool ParseShares(const std::string& shares_str, std::array<uint32_t, kQosRequestTypeNum>& shares);
+
+ private:
+  using FlowKey = std::pair<int64_t, int>;
+  struct Flow {
+    std::deque<TaskRunnablePtr> tasks;
+    double finish_tag{0};
+  };
+
+  static constexpr uint64_t kIdleFlowCleanInterval = 1024;
+
+  double virtual_time_{0};
+  size_t size_{0};
+  uint64_t pop_count_{0};
+  std::map<FlowKey, Flow> flows_;
+  // head start tag of flows with pending tasks
+  std::set<std::pair<double, FlowKey>> active_flows_;
+
+  std::array<uint32_t, kQosRequestTypeNum> shares_;
+  std::array<std::atomic<int64_t>, kQosRequestTypeNum> costs_us_;
+};
+
+// CoDel-style admission control of worker set.
+// Track the queue sojourn time of dequeued tasks, when the sojourn time stays above target for a whole interval,
+// there is a standing queue, enter overload and new tasks are rejected with retryable error so client can back off.
+// Leave overload once a task sojourn time drops below target or the queue drains.
+// Not thread safe except IsOverload(), protected by the caller.
+class CodelAdmission {
+ public:
+  CodelAdmission(int64_t target_us, int64_t interval_us) : target_us_(target_us), interval_us_(interval_us) {}
+  ~CodelAdmission() = default;
+
+  // Record sojourn time of a dequeued task, return true when enter overload.
+  bool OnDequeue(int64_t sojourn_us, int64_t now_us);
+  // Queue is drained.
+  void Reset();
+
+  bool IsOverload() const { return is_overload_.load(std::memory_order_relaxed); }
+
+ private:
+  int64_t target_us_;
+  int64_t interval_us_;
+  // time of sojourn time above target for a whole interval, 0 means below target
+  int64_t first_above_time_us_{0};
+  std::atomic<bool> is_overload_{false};
+};
+
 class ExecqWorkerSet {
  public:
   ExecqWorkerSet(std::string name, uint32_t worker_num, int64_t max_pending_task_count);
@@ -198,6 +301,9 @@ class SimpleWorkerSet {
   void IncPendingTaskCount();
   void DecPendingTaskCount();
 
+  // average queue wait time(us) of recent tasks
+  int64_t QueueWaitLatencyUs();
+
   std::vector<std::vector<std::string>> GetPendingTaskTrace();
 
   void Notify(WorkerEventType type);
@@ -205,6 +311,13 @@ class SimpleWorkerSet {
  private:
   bool IsDestroied();
 
+  // Task queue operation, protected by mutex_.
+  void PushTask(TaskRunnablePtr task);
+  TaskRunnablePtr PopTask();
+  bool IsTaskQueueEmpty();
+  // Feed the sojourn time of dequeued task to admission control, protected by mutex_.
+  void CheckAdmission(TaskRunnablePtr task);
+
   const std::string name_;
 
   std::atomic<uint32_t> worker_no_generator_{0};
@@ -220,6 +333,14 @@ class SimpleWorkerSet {
 
   bool use_pthread_;
   bool use_prior_;
+  // use fair queue instead of fifo queue, only work when not use_prior_
+  bool use_fair_;
+  WeightedFairQueue fair_tasks_;
+  // reject new task when queue delay stays above target
+  bool use_admission_;
+  CodelAdmission admission_;
+  // reject the task of tenant over its request unit budget
+  bool use_resource_group_;
   std::vector<Bthread> bthread_workers_;
   std::vector<std::thread> pthread_workers_;
 
@@ -236,6 +357,8 @@ class SimpleWorkerSet {
   bvar::Adder<int64_t> pending_task_count_metrics_;
   bvar::LatencyRecorder queue_wait_metrics_;
   bvar::LatencyRecorder queue_run_metrics_;
+  bvar::Adder<uint64_t> admission_reject_count_metrics_;
+  bvar::Adder<uint64_t> resource_group_reject_count_metrics_;
 };
 
 using SimpleWorkerSetPtr = std::shared_ptr<SimpleWorkerSet>;
@@ -18,10 +18,13 @@
 #include <cstddef>
 #include <cstdint>
 #include <functional>
+#include <map>
+#include <memory>
 #include <set>
 #include <utility>
 #include <vector>
 
+#include "bthread/mutex.h"
 #include "butil/containers/doubly_buffered_data.h"
 #include "butil/containers/flat_map.h"
 
@@ -302,6 +305,17 @@ class DingoSafeMap {
     }
   }
 
+  // BatchModify
+  // apply many modifications in one Modify, so the writer waits for the readers only once
+  // func is called on both buffers, it must be deterministic and return the count of modified records
+  int BatchModify(const std::function<size_t(TypeRawMap &)> &func) {
+    if (safe_map.Modify(InnerBatchModify, func) > 0) {
+      return 1;
+    } else {
+      return -1;
+    }
+  }
+
   // PutIfExists
   // put key-value pair into map if key exists
   int PutIfExists(const T_KEY &key, const T_VALUE &value) {
@@ -416,6 +430,10 @@ class DingoSafeMap {
     return 1;
   }
 
+  static size_t InnerBatchModify(TypeRawMap &map, const std::function<size_t(TypeRawMap &)> &func) {
+    return func(map);
+  }
+
   static size_t InnerPutIfExists(TypeRawMap &map, const T_KEY &key, const T_VALUE &value) {
     auto *value_ptr = map.seek(key);
     if (value_ptr == nullptr) {
@@ -478,6 +496,381 @@ class DingoSafeMap {
   TypeSafeMap safe_map;
 };
 
+// Implement a write optimized ThreadSafeMap
+// The keys are hashed into shards, every shard is a FlatMap protected by its own mutex, so a write only blocks the
+// readers and writers of the same shard and never waits for the readers of other shards like DingoSafeMap does.
+// It has the same api as DingoSafeMap, use it for the map which is updated frequently, e.g. updated on every heartbeat.
+// The whole map read functions (GetAllKeys/GetRawMapCopy...) lock the shards one by one, so they are not a snapshot.
+// Notice: Must call Init(capacity) before use
+// all membber functions except Size(), MemorySize() return 1 if success, return -1 if failed
+// Size() and MemorySize() return 0 if failed, return size if success
+template <typename T_KEY, typename T_VALUE>
+class DingoShardedSafeMap {
+ public:
+  using TypeRawMap = butil::FlatMap<T_KEY, T_VALUE>;
+
+  static constexpr uint32_t kDefaultShardNum = 16;
+
+  explicit DingoShardedSafeMap(uint32_t shard_num = kDefaultShardNum) {
+    shard_num = shard_num > 0 ? shard_num : 1;
+    for (uint32_t i = 0; i < shard_num; ++i) {
+      shards_.push_back(std::make_unique<Shard>());
+    }
+  }
+  DingoShardedSafeMap(const DingoShardedSafeMap &) = delete;
+  ~DingoShardedSafeMap() = default;
+
+  void Init(int64_t capacity) {
+    for (auto &shard : shards_) {
+      BAIDU_SCOPED_LOCK(shard->mutex);
+      CHECK_EQ(0, shard->map.init(ShardCapacity(capacity)));
+    }
+  }
+
+  void Resize(int64_t capacity) {
+    for (auto &shard : shards_) {
+      BAIDU_SCOPED_LOCK(shard->mutex);
+      CHECK_EQ(0, shard->map.resize(ShardCapacity(capacity)));
+    }
+  }
+
+  // Get
+  // get value by key
+  int Get(const T_KEY &key, T_VALUE &value) {
+    auto &shard = GetShard(key);
+    BAIDU_SCOPED_LOCK(shard.mutex);
+    auto *value_ptr = shard.map.seek(key);
+    if (!value_ptr) {
+      return -1;
+    }
+
+    value = *value_ptr;
+    return 1;
+  }
+
+  // multi-get value by key
+  int MultiGet(const std::vector<T_KEY> &keys, std::vector<T_VALUE> &values, std::vector<bool> &exists) {
+    for (const auto &key : keys) {
+      T_VALUE value;
+      if (Get(key, value) > 0) {
+        values.push_back(value);
+        exists.push_back(true);
+      } else {
+        values.push_back(value);
+        exists.push_back(false);
+      }
+    }
+
+    return 1;
+  }
+
+  // Get
+  // get value by key
+  T_VALUE Get(const T_KEY &key) {
+    T_VALUE value;
+    Get(key, value);
+    return value;
+  }
+
+  // GetAllKeys
+  // get all keys of the map
+  int GetAllKeys(std::vector<T_KEY> &keys) {
+    for (auto &shard : shards_) {
+      BAIDU_SCOPED_LOCK(shard->mutex);
+      for (const auto &it : shard->map) {
+        keys.push_back(it.first);
+      }
+    }
+
+    return keys.size();
+  }
+
+  // GetAllKeys
+  // get all keys of the map
+  int GetAllKeys(std::set<T_KEY> &keys, std::function<bool(T_VALUE)> filter = nullptr) {
+    for (auto &shard : shards_) {
+      BAIDU_SCOPED_LOCK(shard->mutex);
+      for (const auto &it : shard->map) {
+        if (filter == nullptr || filter(it.second)) {
+          keys.insert(it.first);
+        }
+      }
+    }
+
+    return keys.size();
+  }
+
+  // GetAllValues
+  // get all values of the map
+  int GetAllValues(std::vector<T_VALUE> &values, std::function<bool(T_VALUE)> filter = nullptr) {
+    for (auto &shard : shards_) {
+      BAIDU_SCOPED_LOCK(shard->mutex);
+      for (const auto &it : shard->map) {
+        if (filter == nullptr || filter(it.second)) {
+          values.push_back(it.second);
+        }
+      }
+    }
+
+    return values.size();
+  }
+
+  // GetAllKeyValues
+  // get all keys and values of the map
+  int GetAllKeyValues(std::vector<T_KEY> &keys, std::vector<T_VALUE> &values,
+                      std::function<bool(T_VALUE)> filter = nullptr) {
+    for (auto &shard : shards_) {
+      BAIDU_SCOPED_LOCK(shard->mutex);
+      for (const auto &it : shard->map) {
+        if (filter == nullptr || filter(it.second)) {
+          keys.push_back(it.first);
+          values.push_back(it.second);
+        }
+      }
+    }
+
+    return keys.size();
+  }
+
+  int GetAllKeyValues(std::map<T_KEY, T_VALUE> &key_value_map, std::function<bool(T_VALUE)> filter = nullptr) {
+    for (auto &shard : shards_) {
+      BAIDU_SCOPED_LOCK(shard->mutex);
+      for (const auto &it : shard->map) {
+        if (filter == nullptr || filter(it.second)) {
+          key_value_map.insert_or_assign(it.first, it.second);
+        }
+      }
+    }
+
+    return key_value_map.size();
+  }
+
+  // Exists
+  // check if the key exists in the safe map
+  bool Exists(const T_KEY &key) {
+    auto &shard = GetShard(key);
+    BAIDU_SCOPED_LOCK(shard.mutex);
+    return shard.map.seek(key) != nullptr;
+  }
+
+  // SafeExists
+  // check if the key exists in the safe map
+  int SafeExists(const T_KEY &key, bool &exists) {
+    exists = Exists(key);
+    return 1;
+  }
+
+  // Size
+  // return the record count of map
+  int64_t Size() {
+    int64_t size = 0;
+    for (auto &shard : shards_) {
+      BAIDU_SCOPED_LOCK(shard->mutex);
+      size += shard->map.size();
+    }
+
+    return size;
+  }
+
+  // MemorySize
+  // return the memory size of map
+  int64_t MemorySize() {
+    int64_t size = 0;
+    for (auto &shard : shards_) {
+      BAIDU_SCOPED_LOCK(shard->mutex);
+      for (auto const &it : shard->map) {
+        size += it.second.ByteSizeLong();
+      }
+    }
+
+    // sharded map keeps only one copy of data
+    return size;
+  }
+
+  // Copy
+  // copy the map with FlatMap input_map
+  int CopyFromRawMap(const TypeRawMap &input_map) {
+    for (auto &shard : shards_) {
+      BAIDU_SCOPED_LOCK(shard->mutex);
+      shard->map.clear();
+    }
+
+    for (const auto &it : input_map) {
+      auto &shard = GetShard(it.first);
+      BAIDU_SCOPED_LOCK(shard.mutex);
+      shard.map.insert(it.first, it.second);
+    }
+
+    return 1;
+  }
+
+  // GetRawMapCopy
+  // get a copy of the internal flat maps
+  // used to get all key-value pairs from safe map
+  // the out_map must be initialized before call this function
+  int GetRawMapCopy(TypeRawMap &out_map) {
+    for (auto &shard : shards_) {
+      BAIDU_SCOPED_LOCK(shard->mutex);
+      for (const auto &it : shard->map) {
+        out_map.insert(it.first, it.second);
+      }
+    }
+
+    return 1;
+  }
+
+  // Put
+  // put key-value pair into map
+  int Put(const T_KEY &key, const T_VALUE &value) {
+    auto &shard = GetShard(key);
+    BAIDU_SCOPED_LOCK(shard.mutex);
+    shard.map.insert(key, value);
+    return 1;
+  }
+
+  // MultiPut
+  // put key-value pairs into map, every shard is locked once
+  int MultiPut(const std::vector<T_KEY> &key_list, const std::vector<T_VALUE> &value_list) {
+    if (key_list.size() != value_list.size() || key_list.empty()) {
+      return -1;
+    }
+
+    auto shard_indexes = GroupByShard(key_list);
+    for (uint32_t i = 0; i < shards_.size(); ++i) {
+      if (shard_indexes[i].empty()) {
+        continue;
+      }
+
+      auto &shard = *shards_[i];
+      BAIDU_SCOPED_LOCK(shard.mutex);
+      for (auto index : shard_indexes[i]) {
+        shard.map.insert(key_list[index], value_list[index]);
+      }
+    }
+
+    return 1;
+  }
+
+  // MultiErase
+  // erase multi keys, every shard is locked once
+  int MultiErase(const std::vector<T_KEY> &key_list) {
+    if (key_list.empty()) {
+      return -1;
+    }
+
+    auto shard_indexes = GroupByShard(key_list);
+    for (uint32_t i = 0; i < shards_.size(); ++i) {
+      if (shard_indexes[i].empty()) {
+        continue;
+      }
+
+      auto &shard = *shards_[i];
+      BAIDU_SCOPED_LOCK(shard.mutex);
+      for (auto index : shard_indexes[i]) {
+        shard.map.erase(key_list[index]);
+      }
+    }
+
+    return 1;
+  }
+
+  // PutIfExists
+  // put key-value pair into map if key exists
+  int PutIfExists(const T_KEY &key, const T_VALUE &value) {
+    auto &shard = GetShard(key);
+    BAIDU_SCOPED_LOCK(shard.mutex);
+    auto *value_ptr = shard.map.seek(key);
+    if (value_ptr == nullptr) {
+      return -1;
+    }
+
+    *value_ptr = value;
+    return 1;
+  }
+
+  // PutIfAbsent
+  // put key-value pair into map if key not exists
+  int PutIfAbsent(const T_KEY &key, const T_VALUE &value) {
+    auto &shard = GetShard(key);
+    BAIDU_SCOPED_LOCK(shard.mutex);
+    if (shard.map.seek(key) != nullptr) {
+      return -1;
+    }
+
+    shard.map.insert(key, value);
+    return 1;
+  }
+
+  // PutIfEqual
+  // put key-value pair into map if key exists and value equals
+  int PutIfEqual(const T_KEY &key, const T_VALUE &value) {
+    auto &shard = GetShard(key);
+    BAIDU_SCOPED_LOCK(shard.mutex);
+    auto *value_ptr = shard.map.seek(key);
+    if (value_ptr == nullptr || *value_ptr != value) {
+      return -1;
+    }
+
+    return 1;
+  }
+
+  // PutIfNotEqual
+  // put key-value pair into map if key exists and value not equals
+  int PutIfNotEqual(const T_KEY &key, const T_VALUE &value) {
+    auto &shard = GetShard(key);
+    BAIDU_SCOPED_LOCK(shard.mutex);
+    auto *value_ptr = shard.map.seek(key);
+    if (value_ptr == nullptr || *value_ptr == value) {
+      return -1;
+    }
+
+    *value_ptr = value;
+    return 1;
+  }
+
+  // Erase
+  // erase key-value pair from map
+  int Erase(const T_KEY &key) {
+    auto &shard = GetShard(key);
+    BAIDU_SCOPED_LOCK(shard.mutex);
+    shard.map.erase(key);
+    return 1;
+  }
+
+  // Clear
+  // erase all key-value pairs from map
+  int Clear() {
+    for (auto &shard : shards_) {
+      BAIDU_SCOPED_LOCK(shard->mutex);
+      shard->map.clear();
+    }
+
+    return 1;
+  }
+
+  T_VALUE operator[](T_KEY &key) { return Get(key); }
+
+ private:
+  struct Shard {
+    bthread::Mutex mutex;
+    TypeRawMap map;
+  };
+
+  int64_t ShardCapacity(int64_t capacity) const { return capacity / static_cast<int64_t>(shards_.size()) + 1; }
+
+  Shard &GetShard(const T_KEY &key) { return *shards_[butil::DefaultHasher<T_KEY>()(key) % shards_.size()]; }
+
+  std::vector<std::vector<size_t>> GroupByShard(const std::vector<T_KEY> &key_list) {
+    std::vector<std::vector<size_t>> shard_indexes(shards_.size());
+    for (size_t i = 0; i < key_list.size(); ++i) {
+      shard_indexes[butil::DefaultHasher<T_KEY>()(key_list[i]) % shards_.size()].push_back(i);
+    }
+    return shard_indexes;
+  }
+
+  std::vector<std::unique_ptr<Shard>> shards_;
+};
+
 // Implement a ThreadSafeMap
 // Notice: Must call Init(capacity) before use
 // all membber functions except Size(), MemorySize() return 1 if success, return -1 if failed
@@ -735,9 +1128,10 @@ class DingoSafeStdMap {
 
   // FinIntervalValues
   // The real range is [lower_bound, upper_bound)
-  int FindIntervalValues(std::vector<T_VALUE> &values, T_KEY lower_bound, T_KEY upper_bound,
-                         std::function<bool(T_KEY)> key_filter = nullptr,
-                         std::function<bool(T_VALUE)> value_filter = nullptr) {
+  // limit: stop after limit values are found, 0 means no limit, so a bounded range scan cost O(log n + limit)
+  int FindIntervalValues(std::vector<T_VALUE> &values, const T_KEY &lower_bound, const T_KEY &upper_bound,
+                         std::function<bool(const T_KEY &)> key_filter = nullptr,
+                         std::function<bool(const T_VALUE &)> value_filter = nullptr, size_t limit = 0) {
     TypeScopedPtr ptr;
     if (safe_map.Read(&ptr) != 0) {
       return -1;
@@ -775,8 +1169,11 @@ class DingoSafeStdMap {
         if (it->first >= upper_bound) {
           break;
         }
-        if ((key_filter == nullptr || key_filter(it->first)) & (value_filter == nullptr || value_filter(it->second))) {
+        if ((key_filter == nullptr || key_filter(it->first)) && (value_filter == nullptr || value_filter(it->second))) {
           values.push_back(it->second);
+          if (limit > 0 && values.size() >= limit) {
+            break;
+          }
         }
       }
 
@@ -0,0 +1,104 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "common/score_fusion.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace dingodb {
+
+static float GetWeight(const std::vector<float>& weights, size_t i) { return i < weights.size() ? weights[i] : 1.0F; }
+
+static ScoreFusion::RankedList SortAndTruncate(const std::unordered_map<int64_t, float>& scores, uint32_t top_n) {
+  ScoreFusion::RankedList fused;
+  fused.reserve(scores.size());
+  for (const auto& [id, score] : scores) {
+    fused.push_back({id, score});
+  }
+
+  std::sort(fused.begin(), fused.end(), [](const ScoreFusion::Item& lhs, const ScoreFusion::Item& rhs) {
+    return lhs.score != rhs.score ? lhs.score > rhs.score : lhs.id < rhs.id;
+  });
+  if (fused.size() > top_n) {
+    fused.resize(top_n);
+  }
+
+  return fused;
+}
+
+ScoreFusion::RankedList ScoreFusion::ReciprocalRank(const std::vector<RankedList>& lists,
+                                                    const std::vector<float>& weights, int32_t k, uint32_t top_n) {
+  std::unordered_map<int64_t, float> scores;
+  for (size_t i = 0; i < lists.size(); ++i) {
+    float weight = GetWeight(weights, i);
+    for (size_t rank = 0; rank < lists[i].size(); ++rank) {
+      scores[lists[i][rank].id] += weight / static_cast<float>(k + rank + 1);
+    }
+  }
+
+  return SortAndTruncate(scores, top_n);
+}
+
+ScoreFusion::RankedList ScoreFusion::WeightedScore(const std::vector<RankedList>& lists,
+                                                   const std::vector<float>& weights, uint32_t top_n) {
+  std::unordered_map<int64_t, float> scores;
+  for (size_t i = 0; i < lists.size(); ++i) {
+    const auto& list = lists[i];
+    if (list.empty()) {
+      continue;
+    }
+
+    auto [min_it, max_it] = std::minmax_element(
+        list.begin(), list.end(), [](const Item& lhs, const Item& rhs) { return lhs.score < rhs.score; });
+    float min_score = min_it->score;
+    float range = max_it->score - min_score;
+
+    float weight = GetWeight(weights, i);
+    for (const auto& item : list) {
+      // all equal, every item is the best of the list
+      float normalized = range > 0.0F ? (item.score - min_score) / range : 1.0F;
+      scores[item.id] += weight * normalized;
+    }
+  }
+
+  return SortAndTruncate(scores, top_n);
+}
+
+ScoreFusion::RankedList ScoreFusion::FromVectorResult(const pb::index::VectorWithDistanceResult& result) {
+  RankedList list;
+  list.reserve(result.vector_with_distances_size());
+  for (const auto& vector_with_distance : result.vector_with_distances()) {
+    list.push_back({vector_with_distance.vector_with_id().id(), -vector_with_distance.distance()});
+  }
+
+  std::stable_sort(list.begin(), list.end(), [](const Item& lhs, const Item& rhs) { return lhs.score > rhs.score; });
+  return list;
+}
+
+ScoreFusion::RankedList ScoreFusion::FromDocumentResult(
+    const google::protobuf::RepeatedPtrField<pb::common::DocumentWithScore>& result) {
+  RankedList list;
+  list.reserve(result.size());
+  for (const auto& document_with_score : result) {
+    list.push_back({document_with_score.document_with_id().id(), document_with_score.score()});
+  }
+
+  std::stable_sort(list.begin(), list.end(), [](const Item& lhs, const Item& rhs) { return lhs.score > rhs.score; });
+  return list;
+}
+
+}  // namespace dingodb
@@ -0,0 +1,54 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_COMMON_SCORE_FUSION_H_
+#define DINGODB_COMMON_SCORE_FUSION_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "proto/common.pb.h"
+#include "proto/index.pb.h"
+
+namespace dingodb {
+
+// Fuse ranked lists of different retrievers over the same row ids, e.g. vector search and full text search of a
+// table, whose vector id and document id are both the row id.
+class ScoreFusion {
+ public:
+  // score higher is better
+  struct Item {
+    int64_t id{0};
+    float score{0.0F};
+  };
+  // best first
+  using RankedList = std::vector<Item>;
+
+  // Reciprocal rank fusion, score = sum of weight / (k + rank), rank starts from 1.
+  // Only ranks are used, so the scores of the lists need not be comparable.
+  static RankedList ReciprocalRank(const std::vector<RankedList>& lists, const std::vector<float>& weights, int32_t k,
+                                   uint32_t top_n);
+
+  // Weighted sum of min-max normalized scores, an id missed by a list gets 0 from it.
+  static RankedList WeightedScore(const std::vector<RankedList>& lists, const std::vector<float>& weights,
+                                  uint32_t top_n);
+
+  // distance is lower better, score is its negation
+  static RankedList FromVectorResult(const pb::index::VectorWithDistanceResult& result);
+  static RankedList FromDocumentResult(const google::protobuf::RepeatedPtrField<pb::common::DocumentWithScore>& result);
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_COMMON_SCORE_FUSION_H_
@@ -25,6 +25,7 @@
 #include "common/helper.h"
 #include "common/logging.h"
 #include "fmt/core.h"
+#include "proto/common.pb.h"
 #include "proto/error.pb.h"
 
 namespace dingodb {
@@ -158,6 +159,47 @@ std::vector<pb::node::RaftStatusEntry> ServiceAccess::GetRaftStatus(std::vector<
   return Helper::PbRepeatedToVector(response.entries());
 }
 
+static constexpr uint32_t kReadIndexMagic = 0x58444952;  // "RIDX"
+
+butil::Status ServiceAccess::GetReadIndex(int64_t region_id, const butil::EndPoint& endpoint, int64_t timeout_ms,
+                                          int64_t& read_index) {
+  auto channel = ChannelPool::GetInstance().GetChannel(endpoint);
+  if (channel == nullptr) {
+    return butil::Status(pb::error::EINTERNAL, "Get channel failed, endpoint: %s",
+                         Helper::EndPointToString(endpoint).c_str());
+  }
+
+  pb::node::NodeService_Stub stub(channel.get());
+
+  brpc::Controller cntl;
+  cntl.set_timeout_ms(timeout_ms);
+  cntl.request_attachment().append(&kReadIndexMagic, sizeof(kReadIndexMagic));
+
+  pb::node::GetRaftStatusRequest request;
+  request.add_region_ids(region_id);
+  pb::node::GetRaftStatusResponse response;
+  stub.GetRaftStatus(&cntl, &request, &response, nullptr);
+  if (cntl.Failed()) {
+    return butil::Status(pb::error::ERAFT_NOTLEADER, "Get read index failed, error: %s", cntl.ErrorText().c_str());
+  }
+  if (response.error().errcode() != pb::error::OK) {
+    return butil::Status(response.error().errcode(), response.error().errmsg());
+  }
+  if (response.entries_size() != 1 ||
+      response.entries(0).raft_status().raft_state() != pb::common::RaftNodeState::STATE_LEADER) {
+    return butil::Status(pb::error::ERAFT_NOTLEADER, "Not leader");
+  }
+
+  read_index = response.entries(0).raft_status().committed_index();
+  return butil::Status();
+}
+
+bool ServiceAccess::IsReadIndexRequest(const butil::IOBuf& attachment) {
+  uint32_t magic = 0;
+  return attachment.size() == sizeof(magic) && attachment.copy_to(&magic, sizeof(magic)) == sizeof(magic) &&
+         magic == kReadIndexMagic;
+}
+
 butil::Status ServiceAccess::InstallVectorIndexSnapshot(const pb::node::InstallVectorIndexSnapshotRequest& request,
                                                         const butil::EndPoint& endpoint,
                                                         pb::node::InstallVectorIndexSnapshotResponse& response) {
@@ -57,6 +57,12 @@ class ServiceAccess {
   static std::vector<pb::node::RaftStatusEntry> GetRaftStatus(std::vector<int64_t> region_ids,
                                                               const butil::EndPoint& endpoint);
 
+  // Get the committed index of the leader as read index, the leader answers only while its lease is valid.
+  // The request has no field for it, GetRaftStatus with the attachment kReadIndexMagic(u32) asks for the read index.
+  static butil::Status GetReadIndex(int64_t region_id, const butil::EndPoint& endpoint, int64_t timeout_ms,
+                                    int64_t& read_index);
+  static bool IsReadIndexRequest(const butil::IOBuf& attachment);
+
   static butil::Status InstallVectorIndexSnapshot(const pb::node::InstallVectorIndexSnapshotRequest& request,
                                                   const butil::EndPoint& endpoint,
                                                   pb::node::InstallVectorIndexSnapshotResponse& response);
@@ -14,6 +14,7 @@
 
 #include "common/threadpool.h"
 
+#include <algorithm>
 #include <atomic>
 #include <chrono>
 #include <cstdint>
@@ -26,6 +27,7 @@
 
 #include "common/helper.h"
 #include "common/logging.h"
+#include "common/numa.h"
 #include "fmt/core.h"
 #include "glog/logging.h"
 
@@ -35,10 +37,25 @@ ThreadPool::ThreadPool(const std::string &thread_name, uint32_t pool_size)
     : ThreadPool(thread_name, pool_size, nullptr) {}
 
 ThreadPool::ThreadPool(const std::string &thread_name, uint32_t pool_size, std::function<void(void)> init_thread)
+    : ThreadPool(thread_name, pool_size, init_thread, false) {}
+
+ThreadPool::ThreadPool(const std::string &thread_name, uint32_t pool_size, std::function<void(void)> init_thread,
+                       bool numa_aware)
     : thread_name_(thread_name),
       init_thread_func_(init_thread),
       total_task_count_metrics_(fmt::format("dingo_threadpool_{}_total_task_count", thread_name)),
       pending_task_count_metrics_(fmt::format("dingo_threadpool_{}_pending_task_count", thread_name)) {
+  uint32_t queue_num = std::max(pool_size, static_cast<uint32_t>(1));
+  queues_.reserve(queue_num);
+  for (uint32_t i = 0; i < queue_num; ++i) {
+    queues_.push_back(std::make_shared<WorkQueue>());
+  }
+
+  if (numa_aware) {
+    numa_node_num_ = NumaTopology::GetInstance().NodeNum();
+    DINGO_LOG(INFO) << fmt::format("[threadpool] {} numa aware, node num: {}", thread_name, numa_node_num_);
+  }
+
   {
     std::unique_lock<std::mutex> lock(mutex_);
     for (int i = 0; i < pool_size; ++i) {
@@ -138,23 +155,21 @@ ThreadPool::ThreadEntryPtr ThreadPool::BootstrapThread(int thread_no) {
       init_thread_func_();
     }
 
-    for (;;) {
-      TaskPtr task;
-
-      {
-        std::unique_lock<std::mutex> lock(this->task_mutex_);
-
-        this->task_condition_.wait(lock,
-                                   [this, thread_entry] { return thread_entry->is_stop || !this->tasks_.empty(); });
+    uint32_t home_queue = thread_no % this->queues_.size();
+    if (this->numa_node_num_ > 1) {
+      NumaTopology::GetInstance().BindCurrentThread(home_queue % this->numa_node_num_);
+    }
 
-        if (thread_entry->is_stop && this->tasks_.empty()) {
+    for (;;) {
+      TaskPtr task = this->TakeTask(home_queue);
+      if (task == nullptr) {
+        // exit after all tasks are finished
+        if (thread_entry->is_stop.load()) {
           return;
-        } else if (this->tasks_.empty()) {
-          continue;
         }
 
-        task = this->tasks_.top();
-        this->tasks_.pop();
+        this->ParkThread(thread_entry);
+        continue;
       }
 
       try {
@@ -196,7 +211,7 @@ void ThreadPool::ShrinkThreadPool(uint32_t pool_size) {
     worker->is_stop = true;
   }
 
-  task_condition_.notify_all();
+  WakeUpThreads(true);
 
   for (auto &worker : shrink_workers) {
     if (worker->thread.joinable()) {
@@ -215,6 +230,24 @@ void ThreadPool::ExpandTheadPool(uint32_t pool_size) {
 }
 
 ThreadPool::TaskPtr ThreadPool::ExecuteTask(Funcer func, void *arg, int priority) {
+  return SubmitTask(func, arg, priority, submit_seq_.fetch_add(1, std::memory_order_relaxed) % queues_.size());
+}
+
+ThreadPool::TaskPtr ThreadPool::ExecuteTaskByNumaNode(int64_t id, Funcer func, void *arg, int priority) {
+  uint32_t queue_num = queues_.size();
+  uint32_t node = NumaTopology::GetInstance().NodeOfId(id);
+  if (numa_node_num_ <= 1 || node >= queue_num) {
+    return ExecuteTask(func, arg, priority);
+  }
+
+  // queues of node: node, node + numa_node_num_, node + 2 * numa_node_num_ ...
+  uint32_t node_queue_num = (queue_num - 1 - node) / numa_node_num_ + 1;
+  uint32_t pos = node + (submit_seq_.fetch_add(1, std::memory_order_relaxed) % node_queue_num) * numa_node_num_;
+
+  return SubmitTask(func, arg, priority, pos);
+}
+
+ThreadPool::TaskPtr ThreadPool::SubmitTask(Funcer func, void *arg, int priority, uint32_t queue_pos) {
   if (is_destroied_.load(std::memory_order_relaxed)) {
     return nullptr;
   }
@@ -225,20 +258,123 @@ ThreadPool::TaskPtr ThreadPool::ExecuteTask(Funcer func, void *arg, int priority
   task->arg = arg;
   task->cond = std::make_shared<BthreadCond>();
 
-  {
-    std::unique_lock<std::mutex> lock(task_mutex_);
+  IncTotalTaskCount();
+  IncPendingTaskCount();
+
+  PushTask(*queues_[queue_pos], task);
+  queued_task_count_.fetch_add(1);
+
+  WakeUpThreads(false);
+
+  return task;
+}
+
+void ThreadPool::PushTask(WorkQueue &queue, TaskPtr task) {
+  std::unique_lock<std::mutex> lock(queue.mutex);
 
-    tasks_.push(task);
+  int32_t priority = task->priority;
+  queue.lanes[priority].push_back(std::move(task));
+  if (priority > queue.top_priority.load(std::memory_order_relaxed)) {
+    queue.top_priority.store(priority, std::memory_order_relaxed);
   }
+}
 
-  IncTotalTaskCount();
-  IncPendingTaskCount();
+ThreadPool::TaskPtr ThreadPool::PopTask(WorkQueue &queue) {
+  std::unique_lock<std::mutex> lock(queue.mutex);
 
-  task_condition_.notify_one();
+  TaskPtr task;
+  int64_t top_priority = kNoTaskPriority;
+  for (auto &[priority, lane] : queue.lanes) {
+    if (lane.empty()) {
+      continue;
+    }
+    if (task == nullptr) {
+      task = std::move(lane.front());
+      lane.pop_front();
+      if (lane.empty()) {
+        continue;
+      }
+    }
+
+    top_priority = priority;
+    break;
+  }
+
+  queue.top_priority.store(top_priority, std::memory_order_relaxed);
 
   return task;
 }
 
+uint32_t ThreadPool::ChooseQueue(uint32_t home_queue, bool same_node_only) {
+  uint32_t queue_num = queues_.size();
+  uint32_t home_node = home_queue % numa_node_num_;
+
+  // prefer home queue when priority is same
+  int64_t best_priority = kNoTaskPriority;
+  uint32_t best_queue = queue_num;
+  for (uint32_t i = 0; i < queue_num; ++i) {
+    uint32_t pos = (home_queue + i) % queue_num;
+    if (same_node_only && pos % numa_node_num_ != home_node) {
+      continue;
+    }
+
+    int64_t priority = queues_[pos]->top_priority.load(std::memory_order_relaxed);
+    if (priority > best_priority) {
+      best_priority = priority;
+      best_queue = pos;
+    }
+  }
+
+  return best_queue;
+}
+
+ThreadPool::TaskPtr ThreadPool::TakeTask(uint32_t home_queue) {
+  uint32_t queue_num = queues_.size();
+  for (;;) {
+    // steal from other numa node only when the same node has no task, the node may have no thread after shrink.
+    uint32_t best_queue = ChooseQueue(home_queue, true);
+    if (best_queue == queue_num && numa_node_num_ > 1) {
+      best_queue = ChooseQueue(home_queue, false);
+    }
+
+    if (best_queue == queue_num) {
+      return nullptr;
+    }
+
+    // the queue may be taken by other threads at the same time, choose again
+    auto task = PopTask(*queues_[best_queue]);
+    if (task != nullptr) {
+      queued_task_count_.fetch_sub(1);
+      return task;
+    }
+  }
+}
+
+void ThreadPool::ParkThread(ThreadEntryPtr thread_entry) {
+  std::unique_lock<std::mutex> lock(park_mutex_);
+
+  parked_thread_count_.fetch_add(1);
+  park_condition_.wait(lock,
+                       [this, &thread_entry] { return thread_entry->is_stop.load() || queued_task_count_.load() > 0; });
+  parked_thread_count_.fetch_sub(1);
+}
+
+void ThreadPool::WakeUpThreads(bool all) {
+  // the task count is increased before check parked threads, and parked threads check task count under park_mutex_,
+  // so one of them must see the other and no wake up is lost.
+  if (!all && parked_thread_count_.load() == 0) {
+    return;
+  }
+
+  { std::unique_lock<std::mutex> lock(park_mutex_); }
+
+  if (all) {
+    park_condition_.notify_all();
+  } else {
+    park_condition_.notify_one();
+  }
+}
+
 uint64_t ThreadPool::TotalTaskCount() { return total_task_count_metrics_.get_value(); }
 
 void ThreadPool::IncTotalTaskCount() { total_task_count_metrics_ << 1; }
@@ -266,7 +402,7 @@ void ThreadPool::Destroy() {
       worker->is_stop = true;
     }
 
-    task_condition_.notify_all();
+    WakeUpThreads(true);
     for (auto &worker : workers_) {
       if (worker->thread.joinable()) {
         worker->thread.join();
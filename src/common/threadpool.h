@@ -15,12 +15,15 @@
 #ifndef DINGODB_COMMON_THREADPOOL_H_
 #define DINGODB_COMMON_THREADPOOL_H_
 
+#include <atomic>
 #include <condition_variable>
 #include <cstdint>
+#include <deque>
 #include <functional>
+#include <limits>
+#include <map>
 #include <memory>
 #include <mutex>
-#include <queue>
 #include <string>
 #include <thread>
 #include <vector>
@@ -33,12 +36,15 @@ class ThreadPool {
  public:
   ThreadPool(const std::string &thread_name, uint32_t pool_size);
   ThreadPool(const std::string &thread_name, uint32_t pool_size, std::function<void(void)> init_thread);
+  // numa_aware: thread is bound to the cpus of numa node, thread i belongs to node i % node_num
+  ThreadPool(const std::string &thread_name, uint32_t pool_size, std::function<void(void)> init_thread,
+             bool numa_aware);
   ~ThreadPool();
 
   struct ThreadEntry {
     std::string name;
     std::thread thread;
-    bool is_stop;
+    std::atomic<bool> is_stop;
   };
   using ThreadEntryPtr = std::shared_ptr<ThreadEntry>;
 
@@ -61,6 +67,9 @@ class ThreadPool {
   using TaskPtr = std::shared_ptr<Task>;
 
   TaskPtr ExecuteTask(Funcer func, void *arg, int priority = 0);
+  // run task on the threads of the numa node which id(e.g. region id) belongs to, so the memory first touched by
+  // the task is allocated on that node and later access is local, same as ExecuteTask when not numa aware.
+  TaskPtr ExecuteTaskByNumaNode(int64_t id, Funcer func, void *arg, int priority = 0);
 
   void AdjustPoolSize(uint32_t pool_size);
   // bind core, thread[0] bind core[0]
@@ -79,9 +88,33 @@ class ThreadPool {
   void Destroy();
 
  private:
+  static constexpr int64_t kNoTaskPriority = std::numeric_limits<int64_t>::min();
+
+  // Tasks are sharded into multiple queues to avoid all workers and submitters contending on one lock.
+  // Every worker prefers its home queue, and steals from other queues when they hold higher priority task.
+  struct WorkQueue {
+    std::mutex mutex;
+    // priority lanes, the value bigger, the priority higher, every lane is FIFO
+    std::map<int32_t, std::deque<TaskPtr>, std::greater<>> lanes;
+    // highest priority of pending tasks, read without lock for choosing which queue to take from
+    std::atomic<int64_t> top_priority{kNoTaskPriority};
+  };
+  using WorkQueuePtr = std::shared_ptr<WorkQueue>;
+
   // create a new thread
   ThreadEntryPtr BootstrapThread(int thread_no);
 
+  TaskPtr SubmitTask(Funcer func, void *arg, int priority, uint32_t queue_pos);
+  static void PushTask(WorkQueue &queue, TaskPtr task);
+  static TaskPtr PopTask(WorkQueue &queue);
+  // choose the queue with the highest priority task, return queue num if no task
+  uint32_t ChooseQueue(uint32_t home_queue, bool same_node_only);
+  // take the highest priority task, prefer queues of the same numa node, nullptr if no task
+  TaskPtr TakeTask(uint32_t home_queue);
+  // wait until there is pending task or the thread is stopped
+  void ParkThread(ThreadEntryPtr thread_entry);
+  void WakeUpThreads(bool all);
+
   void ShrinkThreadPool(uint32_t pool_size);
   void ExpandTheadPool(uint32_t pool_size);
 
@@ -98,10 +131,19 @@ class ThreadPool {
   std::mutex mutex_;
   std::vector<ThreadEntryPtr> workers_;
 
-  // protect tasks
-  std::mutex task_mutex_;
-  std::condition_variable task_condition_;
-  std::priority_queue<TaskPtr, std::vector<TaskPtr>, Task> tasks_;
+  // task queues, the count is fixed at construction
+  std::vector<WorkQueuePtr> queues_;
+  // numa node num of threads, 1 means not numa aware, queue i belongs to node i % numa_node_num_
+  int32_t numa_node_num_{1};
+  // round-robin position of submitting task
+  std::atomic<uint64_t> submit_seq_{0};
+  // task count in all queues
+  std::atomic<int64_t> queued_task_count_{0};
+
+  // protect idle threads sleep and wake up
+  std::mutex park_mutex_;
+  std::condition_variable park_condition_;
+  std::atomic<int32_t> parked_thread_count_{0};
 
   // metrics
   bvar::Adder<uint64_t> total_task_count_metrics_;
@@ -0,0 +1,123 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "common/timer_wheel.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace dingodb {
+
+void TimerWheel::Place(int64_t id, Timer& timer) {
+  // the expired ids are processed at the next tick
+  int64_t expire_tick = timer.expire_tick < current_tick_ ? current_tick_ : timer.expire_tick;
+  int64_t delta = expire_tick - current_tick_;
+
+  uint32_t level = 0;
+  while (level < kLevelNum - 1 && delta >= (static_cast<int64_t>(1) << ((level + 1) * kLevelBits))) {
+    ++level;
+  }
+  if (delta >= (static_cast<int64_t>(1) << (kLevelNum * kLevelBits))) {
+    // out of range, wait in the farthest slot and cascade again
+    expire_tick = current_tick_ + (static_cast<int64_t>(1) << (kLevelNum * kLevelBits)) - 1;
+  }
+
+  timer.level = level;
+  timer.slot = (expire_tick >> (level * kLevelBits)) & (kSlotNum - 1);
+  wheels_[timer.level][timer.slot].insert(id);
+}
+
+void TimerWheel::Add(int64_t id, int64_t expire_tick) {
+  auto it = timers_.find(id);
+  if (it != timers_.end()) {
+    wheels_[it->second.level][it->second.slot].erase(id);
+  } else {
+    it = timers_.emplace(id, Timer{}).first;
+  }
+
+  it->second.expire_tick = expire_tick;
+  Place(id, it->second);
+}
+
+void TimerWheel::Remove(int64_t id) {
+  auto it = timers_.find(id);
+  if (it == timers_.end()) {
+    return;
+  }
+
+  wheels_[it->second.level][it->second.slot].erase(id);
+  timers_.erase(it);
+}
+
+void TimerWheel::Cascade(uint32_t level) {
+  auto& slot = wheels_[level][(current_tick_ >> (level * kLevelBits)) & (kSlotNum - 1)];
+  Slot ids;
+  ids.swap(slot);
+  for (auto id : ids) {
+    Place(id, timers_[id]);
+  }
+}
+
+void TimerWheel::Advance(int64_t now, std::vector<int64_t>& expired_ids) {
+  if (now < current_tick_) {
+    // the ids added with a passed expire tick wait in the slot of current tick
+    auto& slot = wheels_[0][current_tick_ & (kSlotNum - 1)];
+    for (auto it = slot.begin(); it != slot.end();) {
+      if (timers_[*it].expire_tick <= now) {
+        expired_ids.push_back(*it);
+        timers_.erase(*it);
+        it = slot.erase(it);
+      } else {
+        ++it;
+      }
+    }
+    return;
+  }
+
+  while (current_tick_ <= now) {
+    if (timers_.empty()) {
+      current_tick_ = now + 1;
+      break;
+    }
+
+    // cascade the upper level when the lower level turns a round, from low to high
+    for (uint32_t level = 1; level < kLevelNum; ++level) {
+      if ((current_tick_ & ((static_cast<int64_t>(1) << (level * kLevelBits)) - 1)) != 0) {
+        break;
+      }
+      Cascade(level);
+    }
+
+    auto& slot = wheels_[0][current_tick_ & (kSlotNum - 1)];
+    for (auto id : slot) {
+      expired_ids.push_back(id);
+      timers_.erase(id);
+    }
+    slot.clear();
+
+    ++current_tick_;
+  }
+}
+
+void TimerWheel::Clear(int64_t current_tick) {
+  for (auto& wheel : wheels_) {
+    for (auto& slot : wheel) {
+      slot.clear();
+    }
+  }
+  timers_.clear();
+  current_tick_ = current_tick;
+}
+
+}  // namespace dingodb
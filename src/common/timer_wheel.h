@@ -0,0 +1,78 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_COMMON_TIMER_WHEEL_H_
+#define DINGODB_COMMON_TIMER_WHEEL_H_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace dingodb {
+
+// Hierarchical timer wheel, index the ids by expire tick.
+// Level n has kSlotNum slots, each slot of level n covers kSlotNum^n ticks, an id is put into the lowest level which
+// covers its expire tick and cascaded to the lower level when the wheel turns to it, so Advance only touches the ids
+// expired or cascaded, and Add/Remove are O(1).
+// The tick unit is decided by caller, e.g. second. Not thread safe, caller should protect it.
+class TimerWheel {
+ public:
+  static constexpr uint32_t kLevelBits = 6;
+  static constexpr uint32_t kSlotNum = 1 << kLevelBits;
+  static constexpr uint32_t kLevelNum = 4;
+
+  // current_tick is the first tick to be processed by Advance
+  explicit TimerWheel(int64_t current_tick) : current_tick_(current_tick) {}
+  ~TimerWheel() = default;
+
+  TimerWheel(const TimerWheel&) = delete;
+  TimerWheel& operator=(const TimerWheel&) = delete;
+
+  // Add or reschedule the id, it will be expired by Advance(now) when now >= expire_tick.
+  void Add(int64_t id, int64_t expire_tick);
+  void Remove(int64_t id);
+  bool Exists(int64_t id) const { return timers_.find(id) != timers_.end(); }
+
+  // Turn the wheel to now, output the expired ids and remove them.
+  void Advance(int64_t now, std::vector<int64_t>& expired_ids);
+
+  // Remove all the ids and restart the wheel from current_tick.
+  void Clear(int64_t current_tick);
+
+  size_t Size() const { return timers_.size(); }
+  int64_t CurrentTick() const { return current_tick_; }
+
+ private:
+  struct Timer {
+    int64_t expire_tick;
+    uint32_t level;
+    uint32_t slot;
+  };
+
+  using Slot = std::unordered_set<int64_t>;
+
+  void Place(int64_t id, Timer& timer);
+  void Cascade(uint32_t level);
+
+  int64_t current_tick_;
+  std::array<std::array<Slot, kSlotNum>, kLevelNum> wheels_;
+  std::unordered_map<int64_t, Timer> timers_;
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_COMMON_TIMER_WHEEL_H_
@@ -14,19 +14,33 @@
 
 #include "common/tracker.h"
 
+#include <algorithm>
+#include <cstdint>
 #include <memory>
+#include <string>
+#include <utility>
+#include <vector>
 
+#include "bthread/mutex.h"
 #include "common/helper.h"
+#include "common/pool_allocator.h"
+#include "fmt/core.h"
+#include "gflags/gflags.h"
 
 namespace dingodb {
 
+DEFINE_bool(enable_tracker_stats, false, "enable aggregate request stage latency into histograms");
+DEFINE_int32(tracker_sample_interval, 1000, "sample one of every interval requests into trace ring, 0 is disable");
+DEFINE_int64(tracker_sample_slow_threshold_ms, 100, "always sample the request slower than the threshold");
+DEFINE_int32(tracker_sample_ring_size, 1024, "sampled trace ring buffer size");
+
 Tracker::Tracker(const pb::common::RequestInfo& request_info) : request_info_(request_info) {
   start_time_ = Helper::TimestampNs();
   last_time_ = start_time_;
 }
 
 std::shared_ptr<Tracker> Tracker::New(const pb::common::RequestInfo& request_info) {
-  return std::make_shared<Tracker>(request_info);
+  return MakePooledShared<Tracker>(request_info);
 }
 
 void Tracker::SetTotalRpcTime() { metrics_.total_rpc_time_ns = Helper::TimestampNs() - start_time_; }
@@ -80,4 +94,161 @@ uint64_t Tracker::VectorIndexwriteTime() const { return metrics_.vector_index_wr
 void Tracker::SetDocumentIndexWriteTime(uint64_t elapsed_time) { metrics_.document_index_write_time_ns = elapsed_time; }
 uint64_t Tracker::DocumentIndexwriteTime() const { return metrics_.document_index_write_time_ns; }
 
-}  // namespace dingodb
\ No newline at end of file
+void Tracker::SetWriteStagesFromBatch(const Tracker& batch_tracker) {
+  uint64_t batch_wait_time = batch_tracker.start_time_ > last_time_ ? batch_tracker.start_time_ - last_time_ : 0;
+  const auto& batch_metrics = batch_tracker.metrics_;
+  metrics_.prepair_commit_time_ns = batch_wait_time + batch_metrics.prepair_commit_time_ns;
+  metrics_.raft_commit_time_ns = batch_metrics.raft_commit_time_ns;
+  metrics_.raft_queue_wait_time_ns = batch_metrics.raft_queue_wait_time_ns;
+  metrics_.raft_apply_time_ns = batch_metrics.raft_apply_time_ns;
+  metrics_.store_write_time_ns = batch_metrics.store_write_time_ns;
+  metrics_.vector_index_write_time_ns = batch_metrics.vector_index_write_time_ns;
+  metrics_.document_index_write_time_ns = batch_metrics.document_index_write_time_ns;
+  last_time_ = std::max(last_time_, batch_tracker.last_time_);
+}
+
+static const char* kStageNames[] = {
+    "total_rpc",         "service_queue_wait", "prepair_commit",       "raft_commit",         "raft_queue_wait",
+    "raft_apply",        "store_write",        "vector_index_write",   "document_index_write",
+};
+
+static std::string RegionClass(int64_t region_id, pb::common::RegionType region_type) {
+  if (region_id == 0) {
+    return "none";
+  }
+
+  switch (region_type) {
+    case pb::common::STORE_REGION:
+      return "store";
+    case pb::common::INDEX_REGION:
+      return "index";
+    case pb::common::DOCUMENT_REGION:
+      return "document";
+    default:
+      return "unknown";
+  }
+}
+
+TrackerStats& TrackerStats::GetInstance() {
+  static TrackerStats instance;
+  return instance;
+}
+
+TrackerStats::TrackerStats() : sampled_traces_metrics_("dingo_tracker_sampled_traces", DumpSampledTraces, this) {
+  bthread_mutex_init(&recorders_mutex_, nullptr);
+  bthread_mutex_init(&traces_mutex_, nullptr);
+}
+
+TrackerStats::~TrackerStats() {
+  bthread_mutex_destroy(&recorders_mutex_);
+  bthread_mutex_destroy(&traces_mutex_);
+}
+
+TrackerStats::StageRecorders& TrackerStats::GetOrCreateRecorders(const std::string& method,
+                                                                 const std::string& region_class) {
+  std::string key = fmt::format("{}_{}", method, region_class);
+
+  BAIDU_SCOPED_LOCK(recorders_mutex_);
+  auto it = recorders_.find(key);
+  if (it != recorders_.end()) {
+    return it->second;
+  }
+
+  auto& recorders = recorders_[key];
+  for (int i = 0; i < kStageNum; ++i) {
+    recorders[i] = std::make_unique<bvar::LatencyRecorder>(fmt::format("dingo_tracker_{}_{}", key, kStageNames[i]));
+  }
+
+  return recorders;
+}
+
+bool TrackerStats::IsSample(uint64_t total_rpc_time_ns) {
+  if (total_rpc_time_ns >= static_cast<uint64_t>(FLAGS_tracker_sample_slow_threshold_ms) * 1000 * 1000) {
+    return true;
+  }
+
+  int32_t interval = FLAGS_tracker_sample_interval;
+  return interval > 0 && request_count_.fetch_add(1, std::memory_order_relaxed) % interval == 0;
+}
+
+void TrackerStats::AppendTrace(std::string trace) {
+  size_t ring_size = FLAGS_tracker_sample_ring_size > 0 ? FLAGS_tracker_sample_ring_size : 1;
+
+  BAIDU_SCOPED_LOCK(traces_mutex_);
+  if (traces_.size() < ring_size) {
+    traces_.push_back(std::move(trace));
+    next_trace_pos_ = traces_.size() % ring_size;
+    return;
+  }
+
+  // ring size is shrunk at runtime
+  if (next_trace_pos_ >= traces_.size()) {
+    next_trace_pos_ = 0;
+  }
+  traces_[next_trace_pos_] = std::move(trace);
+  next_trace_pos_ = (next_trace_pos_ + 1) % traces_.size();
+}
+
+void TrackerStats::Record(const std::string& method, int64_t region_id, pb::common::RegionType region_type,
+                          const Tracker& tracker) {
+  if (!FLAGS_enable_tracker_stats) {
+    return;
+  }
+
+  const std::string region_class = RegionClass(region_id, region_type);
+  const uint64_t stage_times[kStageNum] = {
+      tracker.TotalRpcTime(),    tracker.ServiceQueueWaitTime(), tracker.PrepairCommitTime(),
+      tracker.RaftCommitTime(),  tracker.RaftQueueWaitTime(),    tracker.RaftApplyTime(),
+      tracker.StoreWriteTime(),  tracker.VectorIndexwriteTime(), tracker.DocumentIndexwriteTime(),
+  };
+
+  auto& recorders = GetOrCreateRecorders(method, region_class);
+  for (int i = 0; i < kStageNum; ++i) {
+    // the stage is not passed by the request, e.g. raft stages of read request
+    if (stage_times[i] == 0 && i != kTotalRpc && i != kServiceQueueWait) {
+      continue;
+    }
+    *recorders[i] << static_cast<int64_t>(stage_times[i] / 1000);
+  }
+
+  if (!IsSample(stage_times[kTotalRpc])) {
+    return;
+  }
+
+  std::string trace = fmt::format("request_id({}) method({}) region({}) region_class({}) time_us", tracker.RequestId(),
+                                  method, region_id, region_class);
+  for (int i = 0; i < kStageNum; ++i) {
+    trace += fmt::format(" {}({})", kStageNames[i], stage_times[i] / 1000);
+  }
+  AppendTrace(std::move(trace));
+}
+
+std::vector<std::string> TrackerStats::GetSampledTraces() {
+  BAIDU_SCOPED_LOCK(traces_mutex_);
+  if (traces_.empty()) {
+    return {};
+  }
+
+  std::vector<std::string> traces;
+  traces.reserve(traces_.size());
+  size_t start = next_trace_pos_ < traces_.size() ? next_trace_pos_ : 0;
+  for (size_t i = 0; i < traces_.size(); ++i) {
+    traces.push_back(traces_[(start + i) % traces_.size()]);
+  }
+
+  return traces;
+}
+
+std::string TrackerStats::DumpSampledTraces(void* arg) {
+  auto* stats = static_cast<TrackerStats*>(arg);
+
+  std::string result;
+  for (const auto& trace : stats->GetSampledTraces()) {
+    result += trace;
+    result += "\n";
+  }
+
+  return result;
+}
+
+}  // namespace dingodb
@@ -15,9 +15,17 @@
 #ifndef DINGODB_COMMON_TRACKER_H_
 #define DINGODB_COMMON_TRACKER_H_
 
+#include <array>
+#include <atomic>
 #include <cstdint>
+#include <map>
 #include <memory>
+#include <string>
+#include <vector>
 
+#include "bthread/types.h"
+#include "bvar/latency_recorder.h"
+#include "bvar/passive_status.h"
 #include "proto/common.pb.h"
 
 namespace dingodb {
@@ -29,6 +37,8 @@ class Tracker {
 
   static std::shared_ptr<Tracker> New(const pb::common::RequestInfo& request_info);
 
+  int64_t RequestId() const { return request_info_.request_id(); }
+
   struct Metrics {
     uint64_t total_rpc_time_ns{0};
     uint64_t service_queue_wait_time_ns{0};
@@ -68,6 +78,10 @@ class Tracker {
   void SetDocumentIndexWriteTime(uint64_t elapsed_time);
   uint64_t DocumentIndexwriteTime() const;
 
+  // The request is written in a coalesced batch, take the raft stages of the batch tracker, which is created when
+  // the batch is sent. The wait for the batch is counted into prepair commit.
+  void SetWriteStagesFromBatch(const Tracker& batch_tracker);
+
  private:
   uint64_t start_time_;
   uint64_t last_time_;
@@ -77,6 +91,57 @@ class Tracker {
 };
 using TrackerPtr = std::shared_ptr<Tracker>;
 
+// Aggregate the stage latency of finished requests into bvar histograms by method and region type, so the p99 of
+// every stage is visible without log diving. Some requests and all slow requests are sampled into a ring buffer,
+// which is exposed as bvar dingo_tracker_sampled_traces.
+class TrackerStats {
+ public:
+  static TrackerStats& GetInstance();
+
+  // region_id is 0 when the request has no region, region_type is ignored then.
+  void Record(const std::string& method, int64_t region_id, pb::common::RegionType region_type,
+              const Tracker& tracker);
+
+  // sampled traces, oldest first
+  std::vector<std::string> GetSampledTraces();
+
+ private:
+  TrackerStats();
+  ~TrackerStats();
+
+  enum Stage {
+    kTotalRpc = 0,
+    kServiceQueueWait,
+    kPrepairCommit,
+    kRaftCommit,
+    kRaftQueueWait,
+    kRaftApply,
+    kStoreWrite,
+    kVectorIndexWrite,
+    kDocumentIndexWrite,
+    kStageNum,
+  };
+  using StageRecorders = std::array<std::unique_ptr<bvar::LatencyRecorder>, kStageNum>;
+
+  StageRecorders& GetOrCreateRecorders(const std::string& method, const std::string& region_class);
+  bool IsSample(uint64_t total_rpc_time_ns);
+  void AppendTrace(std::string trace);
+
+  static std::string DumpSampledTraces(void* arg);
+
+  // method_regiontype -> stage recorders, never removed
+  bthread_mutex_t recorders_mutex_;
+  std::map<std::string, StageRecorders> recorders_;
+
+  // sampled trace ring buffer
+  std::atomic<uint64_t> request_count_{0};
+  bthread_mutex_t traces_mutex_;
+  std::vector<std::string> traces_;
+  size_t next_trace_pos_{0};
+
+  bvar::PassiveStatus<std::string> sampled_traces_metrics_;
+};
+
 }  // namespace dingodb
 
 #endif  // DINGODB_COMMON_TRACKER_H_
\ No newline at end of file
@@ -0,0 +1,184 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "coordinator/auto_increment_id_cache.h"
+
+#include <cstdint>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "bthread/bthread.h"
+#include "common/logging.h"
+#include "fmt/core.h"
+#include "glog/logging.h"
+
+namespace dingodb {
+
+AutoIncrementIdCache::AutoIncrementIdCache(FetchFunc fetch_func, uint32_t segment_count, uint32_t increment,
+                                           uint32_t offset, double prefetch_ratio)
+    : fetch_func_(std::move(fetch_func)),
+      segment_count_(segment_count > 0 ? segment_count : 1),
+      increment_(increment > 0 ? increment : 1),
+      offset_(offset > 0 ? offset : 1),
+      prefetch_ratio_(prefetch_ratio) {
+  CHECK(fetch_func_ != nullptr) << "fetch_func is nullptr.";
+}
+
+AutoIncrementIdCache::~AutoIncrementIdCache() {
+  // wait the background prefetch, it refers to this
+  std::unique_lock<bthread::Mutex> lock(mutex_);
+  while (fetching_) {
+    cond_.wait(lock);
+  }
+}
+
+int64_t AutoIncrementIdCache::FirstId(int64_t start_id, uint32_t increment, uint32_t offset) {
+  // same as AutoIncrementControl::GetGenerateEndId and GetRealStartId
+  if (increment == 1 && offset == 1) {
+    return start_id;
+  }
+
+  int64_t remainder = start_id % increment;
+  if (remainder < offset) {
+    return start_id - remainder + offset;
+  } else if (remainder > offset) {
+    return start_id - remainder + increment + offset;
+  }
+
+  return start_id;
+}
+
+int64_t AutoIncrementIdCache::RemainCount(const Segment& segment) const {
+  if (segment.next_id >= segment.end_id) {
+    return 0;
+  }
+  return (segment.end_id - segment.next_id + increment_ - 1) / increment_;
+}
+
+butil::Status AutoIncrementIdCache::Fetch(Segment& segment) {
+  int64_t start_id = 0;
+  int64_t end_id = 0;
+  auto status = fetch_func_(segment_count_, start_id, end_id);
+  if (!status.ok()) {
+    DINGO_LOG(WARNING) << fmt::format("[auto_increment] fetch segment failed, count: {} error: {}", segment_count_,
+                                      status.error_str());
+    return status;
+  }
+
+  segment.next_id = FirstId(start_id, increment_, offset_);
+  segment.end_id = end_id;
+  DINGO_LOG(DEBUG) << fmt::format("[auto_increment] fetch segment [{}, {}), first id: {}", start_id, end_id,
+                                  segment.next_id);
+
+  return butil::Status::OK();
+}
+
+void AutoIncrementIdCache::LaunchPrefetch() {
+  fetching_ = true;
+  ++fetch_count_;
+
+  bthread_t tid;
+  int ret = bthread_start_background(
+      &tid, nullptr,
+      [](void* arg) -> void* {
+        static_cast<AutoIncrementIdCache*>(arg)->Prefetch();
+        return nullptr;
+      },
+      this);
+  if (ret != 0) {
+    DINGO_LOG(ERROR) << "[auto_increment] start prefetch bthread failed.";
+    fetching_ = false;
+  }
+}
+
+void AutoIncrementIdCache::Prefetch() {
+  Segment segment;
+  auto status = Fetch(segment);
+
+  std::unique_lock<bthread::Mutex> lock(mutex_);
+  if (status.ok()) {
+    next_ = segment;
+    has_next_ = true;
+  }
+  fetching_ = false;
+  cond_.notify_all();
+}
+
+butil::Status AutoIncrementIdCache::GenerateId(int64_t& id) {
+  std::vector<int64_t> ids;
+  auto status = GenerateIds(1, ids);
+  if (!status.ok()) {
+    return status;
+  }
+
+  id = ids.front();
+  return butil::Status::OK();
+}
+
+butil::Status AutoIncrementIdCache::GenerateIds(uint32_t count, std::vector<int64_t>& ids) {
+  ids.reserve(ids.size() + count);
+
+  std::unique_lock<bthread::Mutex> lock(mutex_);
+  while (count > 0) {
+    if (RemainCount(current_) == 0) {
+      if (has_next_) {
+        current_ = next_;
+        has_next_ = false;
+        continue;
+      }
+
+      if (fetching_) {
+        // a failed prefetch leaves no next segment, then the caller fetches by itself
+        cond_.wait(lock);
+        continue;
+      }
+
+      // both segments are used up, fetch synchronously
+      fetching_ = true;
+      ++fetch_count_;
+      lock.unlock();
+      Segment segment;
+      auto status = Fetch(segment);
+      lock.lock();
+      fetching_ = false;
+      cond_.notify_all();
+      if (!status.ok()) {
+        return status;
+      }
+
+      next_ = segment;
+      has_next_ = true;
+      continue;
+    }
+
+    ids.push_back(current_.next_id);
+    current_.next_id += increment_;
+    --count;
+  }
+
+  // prefetch the next segment when the current one is used up to prefetch_ratio
+  if (!has_next_ && !fetching_ && RemainCount(current_) <= segment_count_ * (1 - prefetch_ratio_)) {
+    LaunchPrefetch();
+  }
+
+  return butil::Status::OK();
+}
+
+int64_t AutoIncrementIdCache::FetchCount() {
+  std::unique_lock<bthread::Mutex> lock(mutex_);
+  return fetch_count_;
+}
+
+}  // namespace dingodb
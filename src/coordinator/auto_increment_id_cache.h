@@ -0,0 +1,86 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_COORDINATOR_AUTO_INCREMENT_ID_CACHE_H_
+#define DINGODB_COORDINATOR_AUTO_INCREMENT_ID_CACHE_H_
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "bthread/condition_variable.h"
+#include "bthread/mutex.h"
+#include "butil/status.h"
+
+namespace dingodb {
+
+// Hand out the auto increment ids of one table from a cached segment.
+// A segment is generated by coordinator in one GenerateAutoIncrement request, the ids in it follow the
+// auto_increment_increment and auto_increment_offset semantics of coordinator, so they are the same ids as
+// generated one by one. When the current segment is used up to prefetch_ratio, the next segment is fetched in
+// background, the callers only wait for coordinator when both segments are used up.
+// The ids of a segment not used before the cache is destroyed are skipped, like the ids cached by MySQL.
+class AutoIncrementIdCache {
+ public:
+  // Generate count ids from coordinator, [start_id, end_id) is the generated range.
+  using FetchFunc = std::function<butil::Status(uint32_t count, int64_t& start_id, int64_t& end_id)>;
+
+  static constexpr double kDefaultPrefetchRatio = 0.8;
+
+  AutoIncrementIdCache(FetchFunc fetch_func, uint32_t segment_count, uint32_t increment, uint32_t offset,
+                       double prefetch_ratio = kDefaultPrefetchRatio);
+  ~AutoIncrementIdCache();
+
+  AutoIncrementIdCache(const AutoIncrementIdCache&) = delete;
+  AutoIncrementIdCache& operator=(const AutoIncrementIdCache&) = delete;
+
+  butil::Status GenerateId(int64_t& id);
+  butil::Status GenerateIds(uint32_t count, std::vector<int64_t>& ids);
+
+  int64_t FetchCount();
+
+  // The first id of the generated range [start_id, end_id), same as the coordinator.
+  static int64_t FirstId(int64_t start_id, uint32_t increment, uint32_t offset);
+
+ private:
+  struct Segment {
+    // the ids are next_id, next_id + increment ... and less than end_id
+    int64_t next_id{0};
+    int64_t end_id{0};
+  };
+
+  int64_t RemainCount(const Segment& segment) const;
+  butil::Status Fetch(Segment& segment);
+  void LaunchPrefetch();
+  void Prefetch();
+
+  FetchFunc fetch_func_;
+  uint32_t segment_count_;
+  uint32_t increment_;
+  uint32_t offset_;
+  double prefetch_ratio_;
+
+  bthread::Mutex mutex_;
+  bthread::ConditionVariable cond_;
+  Segment current_;
+  Segment next_;
+  bool has_next_{false};
+  // a fetch is in flight, the segment will be set to next_
+  bool fetching_{false};
+  int64_t fetch_count_{0};
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_COORDINATOR_AUTO_INCREMENT_ID_CACHE_H_
@@ -17,7 +17,10 @@
 #include <algorithm>
 #include <atomic>
 #include <cstdint>
+#include <map>
 #include <memory>
+#include <queue>
+#include <set>
 #include <string>
 #include <utility>
 #include <vector>
@@ -35,8 +38,26 @@
 
 DEFINE_uint32(balacne_leader_task_batch_size, 4, "balance leader task batch size");
 
+DEFINE_bool(balance_leader_incremental_schedule, false,
+            "balance leader pick region by leader score gain instead of random, filter region lazily and cache the "
+            "result in one schedule, adapt task batch size to the leader imbalance");
+
+DEFINE_uint32(balance_leader_max_task_batch_size, 32, "balance leader max task batch size of incremental schedule");
+
 DEFINE_uint32(balacne_leader_random_select_region_num, 10, "balance leader random select region num");
 
+DEFINE_bool(balance_leader_prefer_hot_vector_index, true,
+            "balance leader prefer transfer to the follower which hold a ready vector index");
+
+DEFINE_bool(enable_balance_hot_store, false, "enable transfer leader out of hot cpu usage store");
+
+DEFINE_int64(balance_hot_store_cpu_usage, 8000, "balance hot store min cpu usage of hot store, percent * 100");
+
+DEFINE_int64(balance_hot_store_cpu_usage_gap, 2000,
+             "balance hot store min cpu usage gap between hot store and average, percent * 100");
+
+DEFINE_uint32(balance_hot_store_task_num_per_store, 2, "balance hot store max transfer leader task num per store");
+
 namespace dingodb {
 
 namespace balance {
@@ -472,6 +493,9 @@ std::vector<TransferLeaderTaskPtr> BalanceLeaderScheduler::Schedule(const pb::co
     tracker_->leader_score = source_candidate_stores->ToString();
   }
 
+  uint32_t task_batch_size = FLAGS_balance_leader_incremental_schedule ? CalcTaskBatchSize(store_entries)
+                                                                       : FLAGS_balacne_leader_task_batch_size;
+
   int32_t round = 0;
   std::set<int64_t> used_regions;
   std::vector<TransferLeaderTaskPtr> transfer_leader_tasks;
@@ -496,7 +520,7 @@ std::vector<TransferLeaderTaskPtr> BalanceLeaderScheduler::Schedule(const pb::co
         // adjust leader score
         ReadjustLeaderScore(source_candidate_stores, target_candidate_stores, transfer_leader_task);
 
-        if (transfer_leader_tasks.size() >= FLAGS_balacne_leader_task_batch_size) {
+        if (transfer_leader_tasks.size() >= task_batch_size) {
           break;
         }
 
@@ -525,7 +549,7 @@ std::vector<TransferLeaderTaskPtr> BalanceLeaderScheduler::Schedule(const pb::co
         // adjust leader score
         ReadjustLeaderScore(source_candidate_stores, target_candidate_stores, transfer_leader_task);
 
-        if (transfer_leader_tasks.size() >= FLAGS_balacne_leader_task_batch_size) {
+        if (transfer_leader_tasks.size() >= task_batch_size) {
           break;
         }
       } else {
@@ -544,6 +568,31 @@ std::vector<TransferLeaderTaskPtr> BalanceLeaderScheduler::Schedule(const pb::co
   return transfer_leader_tasks;
 }
 
+uint32_t BalanceLeaderScheduler::CalcTaskBatchSize(const std::vector<StoreEntryPtr>& store_entries) {
+  int64_t total_leader_num = 0;
+  int64_t total_weight = 0;
+  for (const auto& store_entry : store_entries) {
+    total_leader_num += store_entry->LeaderRegionIds().size();
+    total_weight += store_entry->Store().leader_num_weight() > 0 ? store_entry->Store().leader_num_weight() : 1;
+  }
+
+  // the leader num which should be transferred out to reach the weighted average
+  double surplus_leader_num = 0;
+  for (const auto& store_entry : store_entries) {
+    int64_t weight = store_entry->Store().leader_num_weight() > 0 ? store_entry->Store().leader_num_weight() : 1;
+    double expect_leader_num = total_weight > 0 ? static_cast<double>(total_leader_num) * weight / total_weight : 0;
+    double leader_num = store_entry->LeaderRegionIds().size();
+    if (leader_num > expect_leader_num) {
+      surplus_leader_num += leader_num - expect_leader_num;
+    }
+  }
+
+  uint32_t min_batch_size = FLAGS_balacne_leader_task_batch_size;
+  uint32_t max_batch_size = std::max(FLAGS_balance_leader_max_task_batch_size, min_batch_size);
+  auto batch_size = static_cast<uint32_t>(surplus_leader_num);
+  return std::clamp(batch_size, min_batch_size, max_batch_size);
+}
+
 // commit transfer leader task to raft
 void BalanceLeaderScheduler::CommitTransferLeaderTaskList(const std::vector<TransferLeaderTaskPtr>& tasks) {
   dingodb::pb::coordinator_internal::MetaIncrement meta_increment;
@@ -614,6 +663,8 @@ std::vector<StoreEntryPtr> BalanceLeaderScheduler::GenerateStoreEntries(const St
 BalanceLeaderScheduler::StoreRegionMap BalanceLeaderScheduler::GenerateStoreRegionMap(
     const pb::common::RegionMap& region_map) {
   StoreRegionMap store_region_id_map;
+  region_store_ids_.clear();
+  region_filter_cache_.clear();
   for (const auto& region : region_map.regions()) {
     if (region.leader_store_id() == 0) {
       if (tracker_) {
@@ -621,6 +672,15 @@ BalanceLeaderScheduler::StoreRegionMap BalanceLeaderScheduler::GenerateStoreRegi
       }
       continue;
     }
+
+    auto& region_store_ids = region_store_ids_[region.id()];
+    region_store_ids.first = region.leader_store_id();
+    for (const auto& peer : region.definition().peers()) {
+      if (peer.role() == pb::common::PeerRole::VOTER && peer.store_id() != region.leader_store_id()) {
+        region_store_ids.second.push_back(peer.store_id());
+      }
+    }
+
     for (const auto& peer : region.definition().peers()) {
       if (store_region_id_map.find(peer.store_id()) == store_region_id_map.end()) {
         store_region_id_map.insert(
@@ -684,6 +744,89 @@ pb::coordinator_internal::RegionInternal BalanceLeaderScheduler::PickOneRegion(s
   return coordinator_controller_->GetRegion(picked_region_id);
 }
 
+// gain: source leader score after transfer out minus the lowest follower leader score after transfer in
+pb::coordinator_internal::RegionInternal BalanceLeaderScheduler::PickTransferOutRegion(
+    CandidateStoresPtr candidate_stores, StoreEntryPtr source_store_entry, const std::set<int64_t>& used_regions) {
+  float source_score = source_store_entry->LeaderScore(-1);
+
+  std::priority_queue<std::pair<float, int64_t>> region_queue;
+  for (auto region_id : source_store_entry->LeaderRegionIds()) {
+    auto it = region_store_ids_.find(region_id);
+    if (it == region_store_ids_.end() || used_regions.count(region_id) > 0) {
+      continue;
+    }
+
+    bool has_follower = false;
+    float min_follower_score = 0.0f;
+    for (auto store_id : it->second.second) {
+      auto store_entry = candidate_stores->Store(store_id);
+      if (store_entry == nullptr) {
+        continue;
+      }
+      float score = store_entry->LeaderScore(1);
+      if (!has_follower || score < min_follower_score) {
+        min_follower_score = score;
+        has_follower = true;
+      }
+    }
+    if (has_follower && min_follower_score <= source_score) {
+      region_queue.emplace(source_score - min_follower_score, region_id);
+    }
+  }
+
+  while (!region_queue.empty()) {
+    int64_t region_id = region_queue.top().second;
+    region_queue.pop();
+    if (!FilterRegion(region_id)) {
+      return coordinator_controller_->GetRegion(region_id);
+    }
+  }
+
+  return {};
+}
+
+// gain: leader store leader score after transfer out minus target leader score after transfer in
+pb::coordinator_internal::RegionInternal BalanceLeaderScheduler::PickTransferInRegion(
+    CandidateStoresPtr candidate_stores, StoreEntryPtr target_store_entry, const std::set<int64_t>& used_regions) {
+  float target_score = target_store_entry->LeaderScore(1);
+
+  std::priority_queue<std::pair<float, int64_t>> region_queue;
+  for (auto region_id : target_store_entry->FollowerRegionIds()) {
+    auto it = region_store_ids_.find(region_id);
+    if (it == region_store_ids_.end() || used_regions.count(region_id) > 0) {
+      continue;
+    }
+
+    auto leader_store_entry = candidate_stores->Store(it->second.first);
+    if (leader_store_entry == nullptr) {
+      continue;
+    }
+    float leader_score = leader_store_entry->LeaderScore(-1);
+    if (leader_score >= target_score) {
+      region_queue.emplace(leader_score - target_score, region_id);
+    }
+  }
+
+  // prefer the region whose vector index is hot on target store, else the first reserved region
+  int64_t first_region_id = 0;
+  while (!region_queue.empty()) {
+    int64_t region_id = region_queue.top().second;
+    region_queue.pop();
+    if (FilterRegion(region_id)) {
+      continue;
+    }
+    if (!FLAGS_balance_leader_prefer_hot_vector_index || IsVectorIndexHot(target_store_entry->Id(), region_id)) {
+      return coordinator_controller_->GetRegion(region_id);
+    }
+    if (first_region_id == 0) {
+      first_region_id = region_id;
+    }
+  }
+
+  return first_region_id != 0 ? coordinator_controller_->GetRegion(first_region_id)
+                              : pb::coordinator_internal::RegionInternal{};
+}
+
 std::vector<StoreEntryPtr> BalanceLeaderScheduler::GetFollowerStores(CandidateStoresPtr candidate_stores,
                                                                      pb::coordinator_internal::RegionInternal& region,
                                                                      int64_t leader_store_id) {
@@ -751,7 +894,10 @@ TransferLeaderTaskPtr BalanceLeaderScheduler::GenerateTransferLeaderTask(int64_t
 TransferLeaderTaskPtr BalanceLeaderScheduler::GenerateTransferOutLeaderTask(CandidateStoresPtr candidate_stores,
                                                                             const std::set<int64_t>& used_regions) {
   auto source_store_entry = candidate_stores->GetStore();
-  auto region = PickOneRegion(FilterRegion(FilterUsedRegion(source_store_entry->LeaderRegionIds(), used_regions)));
+  auto region =
+      FLAGS_balance_leader_incremental_schedule
+          ? PickTransferOutRegion(candidate_stores, source_store_entry, used_regions)
+          : PickOneRegion(FilterRegion(FilterUsedRegion(source_store_entry->LeaderRegionIds(), used_regions)));
   if (region.id() == 0) {
     return nullptr;
   }
@@ -773,6 +919,9 @@ TransferLeaderTaskPtr BalanceLeaderScheduler::GenerateTransferOutLeaderTask(Cand
     return nullptr;
   }
 
+  // follower which hold a ready vector index take over leader without load/build
+  follower_store_entries = PreferHotVectorIndex(follower_store_entries, region.id());
+
   for (auto& store_entry : follower_store_entries) {
     auto task = GenerateTransferLeaderTask(region.id(), source_store_entry->Id(), store_entry);
     if (task) {
@@ -786,7 +935,11 @@ TransferLeaderTaskPtr BalanceLeaderScheduler::GenerateTransferOutLeaderTask(Cand
 TransferLeaderTaskPtr BalanceLeaderScheduler::GenerateTransferInLeaderTask(CandidateStoresPtr candidate_stores,
                                                                            const std::set<int64_t>& used_regions) {
   auto target_store_entry = candidate_stores->GetStore();
-  auto region = PickOneRegion(FilterRegion(FilterUsedRegion(target_store_entry->FollowerRegionIds(), used_regions)));
+  auto region = FLAGS_balance_leader_incremental_schedule
+                    ? PickTransferInRegion(candidate_stores, target_store_entry, used_regions)
+                    : PickOneRegion(PreferHotVectorIndex(
+                          target_store_entry->Id(),
+                          FilterRegion(FilterUsedRegion(target_store_entry->FollowerRegionIds(), used_regions))));
   if (region.id() == 0) {
     return nullptr;
   }
@@ -820,13 +973,26 @@ bool BalanceLeaderScheduler::FilterStore(dingodb::pb::common::Store& store) {
 }
 
 bool BalanceLeaderScheduler::FilterRegion(int64_t region_id) {
+  if (FLAGS_balance_leader_incremental_schedule) {
+    auto it = region_filter_cache_.find(region_id);
+    if (it != region_filter_cache_.end()) {
+      return it->second;
+    }
+  }
+
+  bool is_filter = false;
   for (auto& filter : region_filters_) {
     if (!filter->Check(region_id)) {
-      return true;
+      is_filter = true;
+      break;
     }
   }
 
-  return false;
+  if (FLAGS_balance_leader_incremental_schedule) {
+    region_filter_cache_[region_id] = is_filter;
+  }
+
+  return is_filter;
 }
 
 std::vector<int64_t> BalanceLeaderScheduler::FilterRegion(std::vector<int64_t> region_ids) {
@@ -884,6 +1050,273 @@ std::vector<StoreEntryPtr> BalanceLeaderScheduler::FilterResource(const std::vec
   return reserve_store_entries;
 }
 
+bool BalanceLeaderScheduler::IsVectorIndexHot(int64_t store_id, int64_t region_id) {
+  std::vector<pb::common::StoreMetrics> store_metrics;
+  coordinator_controller_->GetStoreRegionMetrics(store_id, region_id, store_metrics);
+  if (store_metrics.empty()) {
+    return false;
+  }
+
+  const auto& region_metrics_map = store_metrics[0].region_metrics_map();
+  auto it = region_metrics_map.find(region_id);
+  if (it == region_metrics_map.end()) {
+    return false;
+  }
+
+  const auto& region_metric = it->second;
+  if (region_metric.region_definition().index_parameter().index_type() != pb::common::INDEX_TYPE_VECTOR) {
+    return true;
+  }
+
+  const auto& vector_index_status = region_metric.vector_index_status();
+  return vector_index_status.is_ready() && !vector_index_status.is_switching() &&
+         !vector_index_status.is_build_error() && !vector_index_status.is_rebuild_error();
+}
+
+std::vector<StoreEntryPtr> BalanceLeaderScheduler::PreferHotVectorIndex(std::vector<StoreEntryPtr> store_entries,
+                                                                        int64_t region_id) {
+  if (!FLAGS_balance_leader_prefer_hot_vector_index || store_entries.size() <= 1) {
+    return store_entries;
+  }
+
+  std::stable_partition(store_entries.begin(), store_entries.end(), [&](const StoreEntryPtr& store_entry) {
+    bool is_hot = IsVectorIndexHot(store_entry->Id(), region_id);
+    if (!is_hot && tracker_) {
+      tracker_->GetLastRecord()->filter_records.push_back(fmt::format(
+          "[prefer.vector_index({}).region({})] vector index is not hot, lower priority", store_entry->Id(), region_id));
+    }
+    return is_hot;
+  });
+
+  return store_entries;
+}
+
+std::vector<int64_t> BalanceLeaderScheduler::PreferHotVectorIndex(int64_t store_id,
+                                                                  const std::vector<int64_t>& region_ids) {
+  if (!FLAGS_balance_leader_prefer_hot_vector_index) {
+    return region_ids;
+  }
+
+  std::vector<int64_t> hot_region_ids;
+  for (auto region_id : region_ids) {
+    if (IsVectorIndexHot(store_id, region_id)) {
+      hot_region_ids.push_back(region_id);
+    }
+  }
+
+  return hot_region_ids.empty() ? region_ids : hot_region_ids;
+}
+
+butil::Status HotStoreScheduler::LaunchBalanceHotStore(std::shared_ptr<CoordinatorControl> coordinator_controller,
+                                                       std::shared_ptr<Engine> raft_engine,
+                                                       pb::common::StoreType store_type, bool dryrun,
+                                                       TrackerPtr tracker) {
+  if (!FLAGS_enable_balance_hot_store) {
+    return butil::Status(pb::error::EINTERNAL, "balance hot store is disabled.");
+  }
+
+  // not allow parallel running
+  static std::atomic<bool> is_running = false;
+  if (is_running.load()) {
+    return butil::Status(pb::error::EINTERNAL, "already exist balance hot store running.");
+  }
+  is_running.store(true);
+  DEFER(is_running.store(false));
+
+  DINGO_LOG(INFO) << fmt::format("[balance.hot_store] launch balance hot store store_type({}) dryrun({})",
+                                 pb::common::StoreType_Name(store_type), dryrun);
+  if (tracker) tracker->store_type = store_type;
+
+  // ready filters
+  std::vector<FilterPtr> store_filters;
+  store_filters.push_back(std::make_shared<StoreStateFilter>(tracker));
+
+  std::vector<FilterPtr> region_filters;
+  region_filters.push_back(std::make_shared<RegionHealthFilter>(coordinator_controller, tracker));
+
+  std::vector<FilterPtr> task_filters;
+  task_filters.push_back(std::make_shared<TaskFilter>(coordinator_controller, tracker));
+
+  std::vector<FilterPtr> resource_filters;
+  resource_filters.push_back(std::make_shared<ResourceFilter>(coordinator_controller, tracker));
+
+  auto hot_store_scheduler = std::make_shared<HotStoreScheduler>(
+      coordinator_controller, raft_engine, store_filters, region_filters, task_filters, resource_filters, tracker);
+
+  // get all region and store
+  pb::common::RegionMap region_map;
+  auto region_type = GetRegionTypeByStoreType(store_type);
+  coordinator_controller->GetRegionMapFull(region_map, region_type);
+  if (region_map.regions().empty()) {
+    return butil::Status(pb::error::EINTERNAL, "region map is empty");
+  }
+  pb::common::StoreMap store_map;
+  coordinator_controller->GetStoreMap(store_map, store_type);
+  if (store_map.stores().empty()) {
+    return butil::Status(pb::error::EINTERNAL, "store map is empty");
+  }
+
+  auto transfer_leader_tasks =
+      hot_store_scheduler->Schedule(region_map, store_map, hot_store_scheduler->GetStoreCpuUsages(store_map));
+  if (transfer_leader_tasks.empty()) {
+    return butil::Status(0, "transfer leader task is empty, maybe no hot store");
+  }
+
+  if (!dryrun) {
+    hot_store_scheduler->CommitTransferLeaderTaskList(transfer_leader_tasks);
+  }
+
+  if (tracker) {
+    tracker->tasks = transfer_leader_tasks;
+  }
+
+  return butil::Status::OK();
+}
+
+std::map<int64_t, int64_t> HotStoreScheduler::GetStoreCpuUsages(const pb::common::StoreMap& store_map) {
+  std::map<int64_t, int64_t> store_cpu_usages;
+  for (const auto& store : store_map.stores()) {
+    std::vector<pb::common::StoreMetrics> store_metrics;
+    coordinator_controller_->GetStoreRegionMetrics(store.id(), store_metrics);
+    if (store_metrics.empty() || !store_metrics[0].has_store_own_metrics()) {
+      if (tracker_) {
+        tracker_->filter_records.push_back(fmt::format("[filter.store({})] not found store cpu usage", store.id()));
+      }
+      continue;
+    }
+
+    store_cpu_usages[store.id()] = store_metrics[0].store_own_metrics().system_cpu_usage();
+  }
+
+  return store_cpu_usages;
+}
+
+static std::string CpuUsagesToString(const std::map<int64_t, int64_t>& store_cpu_usages) {
+  std::string str;
+  for (const auto& [store_id, cpu_usage] : store_cpu_usages) {
+    str += fmt::format("{}({:.2f}%),", store_id, cpu_usage / 100.0);
+  }
+  return str;
+}
+
+// 1. hot store: cpu usage exceed threshold and exceed average by gap, hottest first
+// 2. pick leader region of hot store, estimate the load of one leader by cpu usage / leader num
+// 3. transfer to the coolest follower store which still cooler than the hot store after transfer
+// 4. readjust estimated cpu usage, until the store is not hot
+std::vector<TransferLeaderTaskPtr> HotStoreScheduler::Schedule(const pb::common::RegionMap& region_map,
+                                                               const pb::common::StoreMap& store_map,
+                                                               std::map<int64_t, int64_t> store_cpu_usages) {
+  CHECK(coordinator_controller_ != nullptr) << "coordinator_controller is nullptr.";
+
+  auto store_region_id_map = GenerateStoreRegionMap(region_map);
+  auto store_entries = GenerateStoreEntries(store_region_id_map, store_map);
+
+  // only schedule among stores which pass filter and have cpu usage
+  std::vector<StoreEntryPtr> usage_store_entries;
+  for (auto& store_entry : store_entries) {
+    if (store_cpu_usages.find(store_entry->Id()) != store_cpu_usages.end()) {
+      usage_store_entries.push_back(store_entry);
+    }
+  }
+  if (usage_store_entries.size() < 2) {
+    DINGO_LOG(INFO) << "[balance.hot_store] not enough store to balance.";
+    return {};
+  }
+  auto candidate_stores = CandidateStores::New(usage_store_entries, true);
+
+  int64_t total_cpu_usage = 0;
+  for (auto& store_entry : usage_store_entries) {
+    total_cpu_usage += store_cpu_usages[store_entry->Id()];
+  }
+  int64_t average_cpu_usage = total_cpu_usage / static_cast<int64_t>(usage_store_entries.size());
+  auto is_hot = [&](int64_t store_id) {
+    int64_t cpu_usage = store_cpu_usages[store_id];
+    return cpu_usage >= FLAGS_balance_hot_store_cpu_usage &&
+           cpu_usage - average_cpu_usage >= FLAGS_balance_hot_store_cpu_usage_gap;
+  };
+
+  std::vector<StoreEntryPtr> hot_store_entries;
+  for (auto& store_entry : usage_store_entries) {
+    if (is_hot(store_entry->Id())) {
+      hot_store_entries.push_back(store_entry);
+    }
+  }
+  std::sort(hot_store_entries.begin(), hot_store_entries.end(), [&](const auto& lhs, const auto& rhs) {
+    return store_cpu_usages[lhs->Id()] > store_cpu_usages[rhs->Id()];
+  });
+
+  if (tracker_) {
+    tracker_->leader_score = CpuUsagesToString(store_cpu_usages);
+  }
+
+  uint32_t round = 0;
+  std::set<int64_t> used_regions;
+  std::vector<TransferLeaderTaskPtr> transfer_leader_tasks;
+  for (auto& hot_store_entry : hot_store_entries) {
+    int64_t source_store_id = hot_store_entry->Id();
+    auto leader_region_ids = FilterRegion(FilterUsedRegion(hot_store_entry->LeaderRegionIds(), used_regions));
+    if (leader_region_ids.empty()) {
+      continue;
+    }
+    int64_t leader_load = store_cpu_usages[source_store_id] / static_cast<int64_t>(leader_region_ids.size());
+
+    uint32_t task_num = 0;
+    while (task_num < FLAGS_balance_hot_store_task_num_per_store && is_hot(source_store_id) &&
+           transfer_leader_tasks.size() < FLAGS_balacne_leader_task_batch_size) {
+      leader_region_ids = FilterUsedRegion(leader_region_ids, used_regions);
+      auto region = PickOneRegion(leader_region_ids);
+      if (region.id() == 0) {
+        break;
+      }
+      used_regions.insert(region.id());
+
+      auto record = tracker_ != nullptr ? tracker_->AddRecord() : nullptr;
+      if (record) {
+        record->round = ++round;
+        record->leader_score = CpuUsagesToString(store_cpu_usages);
+      }
+
+      auto follower_store_entries = FilterResource(GetFollowerStores(candidate_stores, region, source_store_id),
+                                                   region.id());
+      StoreEntryPtr target_store_entry = nullptr;
+      for (auto& follower_store_entry : follower_store_entries) {
+        int64_t target_cpu_usage = store_cpu_usages[follower_store_entry->Id()];
+        if (target_cpu_usage + leader_load > store_cpu_usages[source_store_id] - leader_load) {
+          continue;
+        }
+        if (target_store_entry == nullptr || target_cpu_usage < store_cpu_usages[target_store_entry->Id()]) {
+          target_store_entry = follower_store_entry;
+        }
+      }
+      if (target_store_entry == nullptr) {
+        continue;
+      }
+
+      auto task = GenerateTransferLeaderTask(region.id(), source_store_id, target_store_entry);
+      if (record) {
+        record->region_id = task->region_id;
+        record->source_store_id = task->source_store_id;
+        record->target_store_id = task->target_store_id;
+      }
+      transfer_leader_tasks.push_back(task);
+      ++task_num;
+
+      // readjust estimated cpu usage
+      store_cpu_usages[source_store_id] -= leader_load;
+      store_cpu_usages[target_store_entry->Id()] += leader_load;
+    }
+  }
+
+  // if region runing task then eliminate transfer leader task
+  transfer_leader_tasks = FilterTask(transfer_leader_tasks);
+
+  if (tracker_) {
+    tracker_->expect_leader_score = CpuUsagesToString(store_cpu_usages);
+  }
+
+  return transfer_leader_tasks;
+}
+
 }  // namespace balance
 
 }  // namespace dingodb
\ No newline at end of file
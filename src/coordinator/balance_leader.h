@@ -18,6 +18,7 @@
 #include <algorithm>
 #include <complex>
 #include <cstdint>
+#include <map>
 #include <memory>
 #include <string>
 #include <vector>
@@ -41,6 +42,9 @@ using CandidateStoresPtr = std::shared_ptr<CandidateStores>;
 class BalanceLeaderScheduler;
 using BalanceLeaderSchedulerPtr = std::shared_ptr<BalanceLeaderScheduler>;
 
+class HotStoreScheduler;
+using HotStoreSchedulerPtr = std::shared_ptr<HotStoreScheduler>;
+
 struct TransferLeaderTask;
 using TransferLeaderTaskPtr = std::shared_ptr<TransferLeaderTask>;
 
@@ -245,7 +249,7 @@ class BalanceLeaderScheduler {
         task_filters_(task_filters),
         resource_filters_(resource_filters),
         tracker_(tracker){};
-  ~BalanceLeaderScheduler() = default;
+  virtual ~BalanceLeaderScheduler() = default;
 
   static BalanceLeaderSchedulerPtr New(std::shared_ptr<CoordinatorControl> coordinator_controller,
                                        std::shared_ptr<Engine> raft_engine, std::vector<FilterPtr>& store_filters,
@@ -269,12 +273,16 @@ class BalanceLeaderScheduler {
   std::vector<TransferLeaderTaskPtr> Schedule(const pb::common::RegionMap& region_map,
                                               const pb::common::StoreMap& store_map);
 
+  // transfer leader task num of one schedule, the leader num beyond the weighted average of all stores,
+  // limited in [balacne_leader_task_batch_size, balance_leader_max_task_batch_size]
+  static uint32_t CalcTaskBatchSize(const std::vector<StoreEntryPtr>& store_entries);
+
   // Just for unit test
   static std::vector<std::pair<int, int>> TestParseTimePeriod(const std::string& time_period) {
     return ParseTimePeriod(time_period);
   }
 
- private:
+ protected:
   // parse config item(coordinator.balance_leader_inspection_time_period)
   static std::vector<std::pair<int, int>> ParseTimePeriod(const std::string& time_period);
   // commit transfer leader tasks to raft
@@ -293,6 +301,13 @@ class BalanceLeaderScheduler {
   static std::vector<int64_t> FilterUsedRegion(std::vector<int64_t> region_ids, const std::set<int64_t>& used_regions);
   // pick one region for transfer leader
   pb::coordinator_internal::RegionInternal PickOneRegion(std::vector<int64_t> region_ids);
+  // pick the region with the largest leader score gain, filter region lazily in priority order
+  pb::coordinator_internal::RegionInternal PickTransferOutRegion(CandidateStoresPtr candidate_stores,
+                                                                 StoreEntryPtr source_store_entry,
+                                                                 const std::set<int64_t>& used_regions);
+  pb::coordinator_internal::RegionInternal PickTransferInRegion(CandidateStoresPtr candidate_stores,
+                                                                StoreEntryPtr target_store_entry,
+                                                                const std::set<int64_t>& used_regions);
 
   // get all followers store of region
   static std::vector<StoreEntryPtr> GetFollowerStores(CandidateStoresPtr candidate_stores,
@@ -328,6 +343,13 @@ class BalanceLeaderScheduler {
   bool FilterResource(const dingodb::pb::common::Store& store, int64_t region_id);
   std::vector<StoreEntryPtr> FilterResource(const std::vector<StoreEntryPtr>& store_entries, int64_t region_id);
 
+  // vector index of region on the store is loaded and caught up, non vector region is always true
+  bool IsVectorIndexHot(int64_t store_id, int64_t region_id);
+  // stores which hold hot vector index come first, keep the original order in each part
+  std::vector<StoreEntryPtr> PreferHotVectorIndex(std::vector<StoreEntryPtr> store_entries, int64_t region_id);
+  // regions whose vector index is hot on the store, all regions if none is hot
+  std::vector<int64_t> PreferHotVectorIndex(int64_t store_id, const std::vector<int64_t>& region_ids);
+
   std::shared_ptr<CoordinatorControl> coordinator_controller_;
   // for commit transfer leader task
   std::shared_ptr<Engine> raft_engine_;
@@ -340,6 +362,36 @@ class BalanceLeaderScheduler {
 
   // for track balance leader schedule process
   TrackerPtr tracker_;
+
+  // region_id: leader_store_id,follower_store_ids, build by GenerateStoreRegionMap
+  std::map<int64_t, std::pair<int64_t, std::vector<int64_t>>> region_store_ids_;
+  // region_id: filter result, region state hardly change in one schedule
+  std::map<int64_t, bool> region_filter_cache_;
+};
+
+// balance load, transfer leaders out of the store whose cpu usage is hot to the follower store with low cpu usage.
+// reuse the filters and task commit of balance leader, work with balance leader which balance leader count.
+class HotStoreScheduler : public BalanceLeaderScheduler {
+ public:
+  HotStoreScheduler(std::shared_ptr<CoordinatorControl> coordinator_controller, std::shared_ptr<Engine> raft_engine,
+                    std::vector<FilterPtr>& store_filters, std::vector<FilterPtr>& region_filters,
+                    std::vector<FilterPtr>& task_filters, std::vector<FilterPtr>& resource_filters, TrackerPtr tracker)
+      : BalanceLeaderScheduler(coordinator_controller, raft_engine, store_filters, region_filters, task_filters,
+                               resource_filters, tracker){};
+  ~HotStoreScheduler() override = default;
+
+  // launch hot store schedule, only for store type has cpu usage metrics
+  static butil::Status LaunchBalanceHotStore(std::shared_ptr<CoordinatorControl> coordinator_controller,
+                                             std::shared_ptr<Engine> raft_engine, pb::common::StoreType store_type,
+                                             bool dryrun, TrackerPtr tracker);
+
+  // store_cpu_usages: store_id -> cpu usage(percent * 100), stores without usage are not scheduled
+  std::vector<TransferLeaderTaskPtr> Schedule(const pb::common::RegionMap& region_map,
+                                              const pb::common::StoreMap& store_map,
+                                              std::map<int64_t, int64_t> store_cpu_usages);
+
+ private:
+  std::map<int64_t, int64_t> GetStoreCpuUsages(const pb::common::StoreMap& store_map);
 };
 
 }  // namespace balance
@@ -46,6 +46,8 @@ CoordinatorControl::CoordinatorControl(std::shared_ptr<MetaReader> meta_reader,
   // bthread_mutex_init(&lease_to_key_map_temp_mutex_, nullptr);
   // bthread_mutex_init(&one_time_watch_map_mutex_, nullptr);
   bthread_mutex_init(&meta_watch_bitmap_mutex_, nullptr);
+  bthread_mutex_init(&region_map_snapshot_mutex_, nullptr);
+  bthread_mutex_init(&table_metrics_mutex_, nullptr);
 
   root_schema_writed_to_raft_ = false;
   is_processing_task_list_.store(false);
@@ -62,7 +64,8 @@ CoordinatorControl::CoordinatorControl(std::shared_ptr<MetaReader> meta_reader,
   deleted_region_meta_ =
       new MetaDiskMap<pb::coordinator_internal::RegionInternal>(kPrefixDeletedRegion, raw_engine_of_meta);
   region_metrics_meta_ =
-      new MetaMemMapFlat<pb::common::RegionMetrics>(&region_metrics_map_, kPrefixRegionMetrics, raw_engine_of_meta);
+      new MetaMemMapFlat<pb::common::RegionMetrics, RegionMetricsMap>(&region_metrics_map_, kPrefixRegionMetrics,
+                                                                       raw_engine_of_meta);
   table_meta_ =
       new MetaMemMapFlat<pb::coordinator_internal::TableInternal>(&table_map_, kPrefixTable, raw_engine_of_meta);
   deleted_table_meta_ =
@@ -360,6 +360,16 @@ class CoordinatorControl : public MetaControl {
   butil::Status CreateTable(int64_t schema_id, const pb::meta::TableDefinition &table_definition, int64_t &new_table_id,
                             std::vector<int64_t> &region_ids, pb::coordinator_internal::MetaIncrement &meta_increment);
 
+  // Parse the pre split keys property of table definition, e.g. hex_key1,hex_key2:weight2, the key is a sampled
+  // key or the upper bound of a histogram bucket, the weight is the key count of bucket, default 1.
+  static butil::Status ParsePreSplitKeys(const std::string &str, std::vector<std::pair<std::string, int64_t>> &keys);
+  // Calculate the split keys which divide the weighted keys in range into region_num balanced parts.
+  static std::vector<std::string> CalcPreSplitKeys(std::vector<std::pair<std::string, int64_t>> keys,
+                                                   const pb::common::Range &range, int64_t region_num);
+  // Split the partition ranges by the pre split properties of table definition.
+  static butil::Status PreSplitPartRanges(const pb::meta::TableDefinition &table_definition,
+                                          const pb::common::Range &part_range, std::vector<pb::common::Range> &ranges);
+
   butil::Status UpdateTableDefinition(int64_t table_id, bool is_index,
                                       const pb::meta::TableDefinition &table_definition,
                                       pb::coordinator_internal::MetaIncrement &meta_increment);
@@ -605,6 +615,9 @@ class CoordinatorControl : public MetaControl {
   static pb::common::RegionStatus GenRegionStatus(const pb::common::RegionMetrics &region_metrics);
 
   void GetRegionMap(pb::common::RegionMap &region_map);
+  // immutable snapshot of GetRegionMap, shared by concurrent routing refreshes,
+  // rebuild when region epoch changed or snapshot older than region_map_snapshot_ttl_ms.
+  std::shared_ptr<const pb::common::RegionMap> GetRegionMapSnapshot();
   void GetRegionMapFull(pb::common::RegionMap &region_map);
   void GetRegionMapFull(pb::common::RegionMap &region_map, pb::common::RegionType region_type);
   void GetDeletedRegionMap(pb::common::RegionMap &region_map);
@@ -768,6 +781,9 @@ class CoordinatorControl : public MetaControl {
   // calculate single table metrics
   int64_t CalculateTableMetricsSingle(int64_t table_id, pb::meta::TableMetrics &table_metrics);
 
+  // apply the delta of region metrics to the table metrics, it must be called before region_metrics_map_ is updated
+  void ApplyRegionMetricsDeltaToTableMetrics(const std::vector<pb::common::RegionMetrics> &region_metricses);
+
   // calculate index metrics
   void CalculateIndexMetrics();
 
@@ -776,6 +792,9 @@ class CoordinatorControl : public MetaControl {
 
   // functions below are for raft fsm
   bool IsLeader() override;                                            // for raft fsm
+  // Leader, or follower with bounded staleness when follower read is enabled, for GetSchema, GetTable, GetIndex and
+  // GetIndexRange only. The reads of region metrics, which only the leader fills from heartbeats, stay on leader.
+  bool CanServeRead();
   void SetLeaderTerm(int64_t term) override;                           // for raft fsm
   void OnLeaderStart(int64_t term) override;                           // for raft fsm
   void OnLeaderStop() override;                                        // for raft fsm
@@ -975,8 +994,10 @@ class CoordinatorControl : public MetaControl {
   // 5.1 deleted_regions
   MetaDiskMap<pb::coordinator_internal::RegionInternal> *deleted_region_meta_;
   // 5.2 region_metrics, this map does not need to be persisted
-  DingoSafeMap<int64_t, pb::common::RegionMetrics> region_metrics_map_;
-  MetaMemMapFlat<pb::common::RegionMetrics> *region_metrics_meta_;
+  // it's updated on every store heartbeat, so use the sharded map to avoid writers waiting for readers
+  using RegionMetricsMap = DingoShardedSafeMap<int64_t, pb::common::RegionMetrics>;
+  RegionMetricsMap region_metrics_map_;
+  MetaMemMapFlat<pb::common::RegionMetrics, RegionMetricsMap> *region_metrics_meta_;
   // 5.3 range->region map
   DingoSafeStdMap<std::string, pb::coordinator_internal::RegionInternal> range_region_map_;
 
@@ -990,6 +1011,11 @@ class CoordinatorControl : public MetaControl {
   // table_name -> table-id
   DingoSafeMap<std::string, int64_t> table_name_map_safe_temp_;
 
+  // region map snapshot for GetRegionMapSnapshot
+  std::shared_ptr<const pb::common::RegionMap> region_map_snapshot_;
+  int64_t region_map_snapshot_time_ms_{0};
+  bthread_mutex_t region_map_snapshot_mutex_;
+
   // 7.store_metrics
   std::map<int64_t, pb::common::StoreMetrics> store_region_metrics_map_;
   bthread_mutex_t store_region_metrics_map_mutex_;
@@ -998,6 +1024,9 @@ class CoordinatorControl : public MetaControl {
 
   // 8.table_metrics
   DingoSafeMap<int64_t, pb::coordinator_internal::TableMetricsInternal> table_metrics_map_;
+  // protect the read-modify-write of table metrics, e.g. incremental update and full calculation
+  bthread_mutex_t table_metrics_mutex_;
+  int64_t table_metrics_full_calc_time_ms_{0};
 
   // 9.store_operation
   DingoSafeMap<int64_t, pb::coordinator_internal::StoreOperationInternal> store_operation_map_;
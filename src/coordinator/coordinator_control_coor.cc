@@ -53,11 +53,14 @@ DECLARE_int32(region_heartbeat_timeout);
 DECLARE_int32(region_delete_after_deleted_time);
 
 DECLARE_bool(ip2hostname);
+DECLARE_bool(enable_coordinator_incremental_table_metrics);
 
 DEFINE_int32(table_delete_after_deleted_time, 86400, "delete table after deleted time in seconds");
 DEFINE_int32(index_delete_after_deleted_time, 86400, "delete index after deleted time in seconds");
 DEFINE_int64(store_metrics_keep_time_s, 3600, "store metrics keep time in seconds");
 DEFINE_bool(enable_region_split_and_merge_for_lite, false, "enable region split and merge for lite");
+DEFINE_int64(region_map_snapshot_ttl_ms, 1000,
+             "region map snapshot ttl, leader and status in snapshot may lag behind region metrics within ttl");
 
 DEFINE_int32(
     region_update_timeout, 25,
@@ -74,6 +77,8 @@ DECLARE_int64(max_hnsw_memory_size_of_region);
 DECLARE_int32(max_hnsw_nlinks_of_region);
 
 DEFINE_int32(max_send_region_cmd_per_store, 100, "max send region cmd per store");
+DEFINE_int32(send_create_region_cmd_batch_size, 1,
+             "max create region cmd num in one push store operation rpc, 1 means one cmd per rpc");
 
 DEFINE_int64(max_region_count, 40000, "max region of dingo");
 
@@ -922,6 +927,28 @@ void CoordinatorControl::GetRegionMap(pb::common::RegionMap& region_map) {
   }
 }
 
+std::shared_ptr<const pb::common::RegionMap> CoordinatorControl::GetRegionMapSnapshot() {
+  int64_t epoch = GetPresentId(pb::coordinator::IdEpochType::EPOCH_REGION);
+
+  // only one request rebuild the snapshot, others wait and share it
+  BAIDU_SCOPED_LOCK(region_map_snapshot_mutex_);
+  int64_t now_ms = butil::gettimeofday_ms();
+  if (region_map_snapshot_ != nullptr && region_map_snapshot_->epoch() == epoch &&
+      now_ms - region_map_snapshot_time_ms_ < FLAGS_region_map_snapshot_ttl_ms) {
+    return region_map_snapshot_;
+  }
+
+  auto region_map = std::make_shared<pb::common::RegionMap>();
+  GetRegionMap(*region_map);
+  // the snapshot must be tagged with the epoch read before copy, so a concurrent change rebuild it next time
+  region_map->set_epoch(epoch);
+
+  region_map_snapshot_ = region_map;
+  region_map_snapshot_time_ms_ = now_ms;
+
+  return region_map_snapshot_;
+}
+
 void CoordinatorControl::GetRegionMapFull(pb::common::RegionMap& region_map) {
   region_map.set_epoch(GetPresentId(pb::coordinator::IdEpochType::EPOCH_REGION));
   {
@@ -4222,14 +4249,20 @@ void CoordinatorControl::UpdateRegionMapAndStoreOperation(const pb::common::Stor
                     << store_metrics.region_metrics_map_size()
                     << ", region_metrics=" << store_metrics.ShortDebugString();
   } else if (store_metrics.is_partial_region_metrics()) {
+    // partial heartbeat also carry the changed regions between full heartbeat, so not print all region_metrics
     DINGO_LOG(INFO) << "UpdateRegionMapAndStoreOperation partial heartbeat, not split/merge, region_metrics_map_size = "
-                    << store_metrics.region_metrics_map_size()
-                    << ", region_metrics=" << store_metrics.ShortDebugString();
+                    << store_metrics.region_metrics_map_size();
+    DINGO_LOG(DEBUG) << "UpdateRegionMapAndStoreOperation partial heartbeat, region_metrics="
+                     << store_metrics.ShortDebugString();
   } else {
     DINGO_LOG(INFO) << "UpdateRegionMapAndStoreOperation full heartbeat, region_metrics_map_size = "
                     << store_metrics.region_metrics_map_size();
   }
 
+  // the region_metrics to update are put into region_metrics_map_ in one batch after the loop
+  std::vector<int64_t> region_metrics_ids;
+  std::vector<pb::common::RegionMetrics> region_metrics_values;
+
   // update region_map
   for (const auto& it : store_metrics.region_metrics_map()) {
     const auto& region_metrics = it.second;
@@ -4255,7 +4288,8 @@ void CoordinatorControl::UpdateRegionMapAndStoreOperation(const pb::common::Stor
     if (ret1 < 0) {
       region_metrics_to_update = region_metrics;
       *(region_metrics_to_update.mutable_region_status()) = GenRegionStatus(region_metrics);
-      region_metrics_map_.Put(region_metrics.id(), region_metrics_to_update);
+      region_metrics_ids.push_back(region_metrics.id());
+      region_metrics_values.push_back(region_metrics_to_update);
 
       DINGO_LOG(INFO) << "region_metrics_to_update is first time put into region_metrics_map_, region_id = "
                       << region_metrics.id() << ", from store_id: " << store_metrics.id();
@@ -4445,7 +4479,8 @@ void CoordinatorControl::UpdateRegionMapAndStoreOperation(const pb::common::Stor
 
       *(region_metrics_to_update.mutable_region_status()) = region_status_to_update;
 
-      region_metrics_map_.Put(region_metrics.id(), region_metrics_to_update);
+      region_metrics_ids.push_back(region_metrics.id());
+      region_metrics_values.push_back(region_metrics_to_update);
 
       DINGO_LOG(DEBUG) << "UpdateRegionMapAndStoreOperation region_metrics_map_ update region_id = "
                        << region_metrics.id() << " last_update_timestamp = "
@@ -4459,6 +4494,16 @@ void CoordinatorControl::UpdateRegionMapAndStoreOperation(const pb::common::Stor
                                                         region_metrics.region_size());
     }
   }
+
+  if (!region_metrics_ids.empty()) {
+    if (FLAGS_enable_coordinator_incremental_table_metrics) {
+      BAIDU_SCOPED_LOCK(table_metrics_mutex_);
+      ApplyRegionMetricsDeltaToTableMetrics(region_metrics_values);
+      region_metrics_map_.MultiPut(region_metrics_ids, region_metrics_values);
+    } else {
+      region_metrics_map_.MultiPut(region_metrics_ids, region_metrics_values);
+    }
+  }
 }
 
 int64_t CoordinatorControl::UpdateStoreMetrics(const pb::common::StoreMetrics& store_metrics,
@@ -4484,6 +4529,14 @@ int64_t CoordinatorControl::UpdateStoreMetrics(const pb::common::StoreMetrics& s
 
     DINGO_LOG(INFO) << "UpdateStoreMetrics store_metrics.id=" << store_metrics.id()
                     << ", metrics: " << store_metrics.store_own_metrics().ShortDebugString();
+  } else if (store_metrics.has_store_own_metrics()) {
+    // partial heartbeat keep the region_num of last full heartbeat
+    BAIDU_SCOPED_LOCK(store_metrics_map_mutex_);
+    auto it = store_metrics_map_.find(store_metrics.id());
+    if (it != store_metrics_map_.end()) {
+      it->second.store_own_metrics = store_metrics.store_own_metrics();
+      it->second.update_time = butil::gettimeofday_ms();
+    }
   }
 
   if (store_metrics.region_metrics_map_size() <= 0) {
@@ -4498,9 +4551,9 @@ int64_t CoordinatorControl::UpdateStoreMetrics(const pb::common::StoreMetrics& s
       if (store_region_metrics_map_.find(store_metrics.id()) == store_region_metrics_map_.end()) {
         store_region_metrics_map_.insert_or_assign(store_metrics.id(), store_metrics);
       } else {
+        auto* mut_region_metrics_map = store_region_metrics_map_[store_metrics.id()].mutable_region_metrics_map();
         for (const auto& region_metrics : store_metrics.region_metrics_map()) {
-          store_region_metrics_map_[store_metrics.id()].mutable_region_metrics_map()->insert(
-              {region_metrics.first, region_metrics.second});
+          (*mut_region_metrics_map)[region_metrics.first] = region_metrics.second;
         }
       }
     } else {
@@ -5588,11 +5641,13 @@ butil::Status CoordinatorControl::ScanRegions(const std::string& start_key, cons
   //                 << " upper_bound=" << Helper::StringToHex(upper_bound);
 
   std::vector<pb::coordinator_internal::RegionInternal> region_internals;
+  // point lookup need check which region contain the key, so only range scan stop at limit in range_region_map_
   auto ret = range_region_map_.FindIntervalValues(
       region_internals, lower_bound, upper_bound, nullptr,
-      [lower_bound, upper_bound](const pb::coordinator_internal::RegionInternal& region) {
+      [&lower_bound](const pb::coordinator_internal::RegionInternal& region) {
         return region.id() > 0 && region.definition().range().end_key() > lower_bound;
-      });
+      },
+      end_key.empty() ? 0 : std::max(limit, static_cast<int64_t>(0)));
   if (ret < 0) {
     DINGO_LOG(ERROR) << "range_region_map_.FindIntervalValues failed";
     return butil::Status(pb::error::EINTERNAL, "range_region_map_.FindIntervalValues failed");
@@ -6138,8 +6193,13 @@ void CoordinatorControl::TryToSendStoreOperations() {
           break;
         }
 
-        auto region_cmd = region_cmds.back();
-        region_cmds.pop_back();
+        int32_t batch_size = std::max(FLAGS_send_create_region_cmd_batch_size, 1);
+        pb::coordinator::StoreOperation store_operation;
+        store_operation.set_id(store_id);
+        while (!region_cmds.empty() && store_operation.region_cmds_size() < batch_size) {
+          *(store_operation.add_region_cmds()) = region_cmds.back();
+          region_cmds.pop_back();
+        }
 
         auto store_it = tmp_store_map.find(store_id);
         if (store_it == tmp_store_map.end()) {
@@ -6153,9 +6213,6 @@ void CoordinatorControl::TryToSendStoreOperations() {
         pb::push::PushStoreOperationRequest request;
         pb::push::PushStoreOperationResponse response;
 
-        pb::coordinator::StoreOperation store_operation;
-        store_operation.set_id(store.id());
-        *(store_operation.add_region_cmds()) = region_cmd;
         *(request.mutable_store_operation()) = store_operation;
 
         // send rpcs
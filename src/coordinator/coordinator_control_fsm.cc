@@ -40,11 +40,33 @@
 
 namespace dingodb {
 
+DEFINE_bool(coordinator_enable_follower_read, false,
+            "coordinator follower serve GetSchema, GetTable, GetIndex and GetIndexRange");
+DEFINE_int64(coordinator_follower_read_max_lag, 16,
+             "coordinator follower serve read when its applied index lag behind committed index not exceed it");
 DEFINE_int64(meta_revision_base, 0,
              "meta_revision base value, the real revision is meta_revision_base + applied_index");
 
 bool CoordinatorControl::IsLeader() { return leader_term_.load(butil::memory_order_acquire) > 0; }
 
+// A follower knows the leader only within the election timeout since the last heartbeat, and its committed index is
+// carried by the heartbeats, so the meta applied by a follower with known leader and small apply lag is at most
+// one election timeout plus max lag entries behind the leader.
+bool CoordinatorControl::CanServeRead() {
+  if (IsLeader()) {
+    return true;
+  }
+  if (!FLAGS_coordinator_enable_follower_read || raft_node_ == nullptr) {
+    return false;
+  }
+
+  if (raft_node_->GetLeaderId().is_empty()) {
+    return false;
+  }
+  auto status = raft_node_->GetStatus();
+  return status->known_applied_index() + FLAGS_coordinator_follower_read_max_lag >= status->committed_index();
+}
+
 void CoordinatorControl::SetLeaderTerm(int64_t term) {
   DINGO_LOG(INFO) << "SetLeaderTerm, term=" << term;
   leader_term_.store(term, butil::memory_order_release);
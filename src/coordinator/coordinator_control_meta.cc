@@ -14,9 +14,11 @@
 
 #include <sys/types.h>
 
+#include <algorithm>
 #include <cstddef>
 #include <cstdint>
 #include <cstdlib>
+#include <map>
 #include <nlohmann/json.hpp>
 #include <set>
 #include <string>
@@ -53,6 +55,17 @@ DEFINE_int64(max_index_count, 10000, "max index num of dingo");
 DEFINE_int64(max_tenant_count, 1024, "max tenant num of dingo");
 DEFINE_uint32(default_replica_num, 3, "default replica number");
 DEFINE_bool(enable_lite, false, "enable lite");
+DEFINE_bool(enable_coordinator_incremental_table_metrics, false,
+            "update table metrics by the delta of region metrics heartbeat, full calculation is a consistency check");
+DEFINE_int64(coordinator_table_metrics_full_calc_interval_s, 3600,
+             "full calculate table metrics interval seconds when table metrics is updated incrementally");
+DEFINE_bool(enable_table_pre_split, false,
+            "create the regions of new table up front by the pre split keys sampled from the data to load");
+DEFINE_int64(table_pre_split_max_region_num_per_part, 64, "max pre split region num of one partition");
+
+// table definition properties of pre split
+static const std::string kPreSplitKeysProperty = "pre_split_keys";
+static const std::string kPreSplitRegionNumProperty = "pre_split_region_num_per_part";
 butil::Status CoordinatorControl::GenerateTableIdAndPartIds(int64_t schema_id, int64_t part_count,
                                                             pb::meta::EntityType entity_type,
                                                             pb::coordinator_internal::MetaIncrement& meta_increment,
@@ -515,6 +528,125 @@ butil::Status CoordinatorControl::ValidateMaxIndexCount() {
   return butil::Status::OK();
 }
 
+butil::Status CoordinatorControl::ParsePreSplitKeys(const std::string& str,
+                                                    std::vector<std::pair<std::string, int64_t>>& keys) {
+  std::vector<std::string> items;
+  Helper::SplitString(str, ',', items);
+  for (const auto& item : items) {
+    if (item.empty()) {
+      continue;
+    }
+
+    std::string hex_key = item;
+    int64_t weight = 1;
+    auto pos = item.find(':');
+    if (pos != std::string::npos) {
+      hex_key = item.substr(0, pos);
+      weight = Helper::StringToInt64(item.substr(pos + 1));
+    }
+    if (hex_key.empty() || hex_key.size() % 2 != 0 || weight <= 0) {
+      return butil::Status(pb::error::Errno::ETABLE_DEFINITION_ILLEGAL, "pre split key is illegal: " + item);
+    }
+
+    keys.emplace_back(Helper::HexToString(hex_key), weight);
+  }
+
+  return butil::Status::OK();
+}
+
+std::vector<std::string> CoordinatorControl::CalcPreSplitKeys(std::vector<std::pair<std::string, int64_t>> keys,
+                                                              const pb::common::Range& range, int64_t region_num) {
+  std::vector<std::string> split_keys;
+  if (region_num <= 1) {
+    return split_keys;
+  }
+
+  // only the keys in range can split it
+  keys.erase(std::remove_if(keys.begin(), keys.end(),
+                            [&](const auto& key) {
+                              return key.first <= range.start_key() || key.first >= range.end_key();
+                            }),
+             keys.end());
+  std::sort(keys.begin(), keys.end());
+
+  // few keys, every key is a split key
+  if (static_cast<int64_t>(keys.size()) < region_num) {
+    for (const auto& key : keys) {
+      if (split_keys.empty() || split_keys.back() != key.first) {
+        split_keys.push_back(key.first);
+      }
+    }
+    return split_keys;
+  }
+
+  int64_t total_weight = 0;
+  for (const auto& key : keys) {
+    total_weight += key.second;
+  }
+
+  // the i-th split key is the first key after the keys whose weight reaches i/region_num of total
+  int64_t accumulated_weight = 0;
+  int64_t next = 1;
+  for (const auto& key : keys) {
+    if (next >= region_num) {
+      break;
+    }
+    if (accumulated_weight > 0 && accumulated_weight * region_num >= total_weight * next) {
+      if (split_keys.empty() || split_keys.back() != key.first) {
+        split_keys.push_back(key.first);
+      }
+      while (next < region_num && accumulated_weight * region_num >= total_weight * next) {
+        ++next;
+      }
+    }
+    accumulated_weight += key.second;
+  }
+
+  return split_keys;
+}
+
+butil::Status CoordinatorControl::PreSplitPartRanges(const pb::meta::TableDefinition& table_definition,
+                                                     const pb::common::Range& part_range,
+                                                     std::vector<pb::common::Range>& ranges) {
+  ranges.clear();
+
+  const auto& properties = table_definition.properties();
+  auto it = properties.find(kPreSplitKeysProperty);
+  if (!FLAGS_enable_table_pre_split || it == properties.end()) {
+    ranges.push_back(part_range);
+    return butil::Status::OK();
+  }
+
+  std::vector<std::pair<std::string, int64_t>> keys;
+  auto status = ParsePreSplitKeys(it->second, keys);
+  if (!status.ok()) {
+    return status;
+  }
+
+  // default one region per sampled key
+  int64_t region_num = keys.size() + 1;
+  auto num_it = properties.find(kPreSplitRegionNumProperty);
+  if (num_it != properties.end()) {
+    region_num = Helper::StringToInt64(num_it->second);
+  }
+  region_num = std::min(region_num, FLAGS_table_pre_split_max_region_num_per_part);
+
+  std::string start_key = part_range.start_key();
+  for (const auto& split_key : CalcPreSplitKeys(keys, part_range, region_num)) {
+    pb::common::Range range;
+    range.set_start_key(start_key);
+    range.set_end_key(split_key);
+    ranges.push_back(range);
+    start_key = split_key;
+  }
+  pb::common::Range range;
+  range.set_start_key(start_key);
+  range.set_end_key(part_range.end_key());
+  ranges.push_back(range);
+
+  return butil::Status::OK();
+}
+
 // CreateTable
 // in: schema_id, table_definition
 // out: new_table_id, new_regin_ids meta_increment
@@ -722,33 +854,57 @@ butil::Status CoordinatorControl::CreateTable(int64_t schema_id, const pb::meta:
     return ret4;
   }
 
-  // for partitions
+  // for partitions, a pre split partition has several regions
+  int64_t need_region_num = 0;
   for (int i = 0; i < new_part_ranges.size(); i++) {
-    int64_t new_region_id = 0;
     int64_t new_part_id = new_part_ids[i];
-    auto new_part_range = new_part_ranges[i];
 
-    std::string const region_name = std::string("T_") + std::to_string(schema_id) + std::string("_") +
-                                    table_definition.name() + std::string("_part_") + std::to_string(new_part_id);
-
-    std::vector<pb::coordinator::StoreOperation> store_operations;
-    auto ret = CreateRegionFinal(region_name, pb::common::RegionType::STORE_REGION, region_raw_engine_type,
-                                 region_store_engine_type, "", replica, new_part_range, schema_id, new_table_id, 0,
-                                 new_part_id, tenant_id, index_parameter, store_ids, 0, new_region_id, store_operations,
-                                 meta_increment);
+    std::vector<pb::common::Range> region_ranges;
+    auto ret = PreSplitPartRanges(table_definition, new_part_ranges[i], region_ranges);
     if (!ret.ok()) {
-      DINGO_LOG(ERROR) << "CreateRegion failed in CreateTable table_name=" << table_definition.name()
-                       << ", table_definition:" << table_definition.ShortDebugString() << " ret: " << ret.error_str();
+      DINGO_LOG(ERROR) << "PreSplitPartRanges failed in CreateTable table_name=" << table_definition.name()
+                       << " ret: " << ret.error_str();
       return ret;
     }
+    need_region_num += region_ranges.size();
 
-    DINGO_LOG(INFO) << "CreateTable create region success, region_id=" << new_region_id;
+    for (int j = 0; j < region_ranges.size(); j++) {
+      int64_t new_region_id = 0;
 
-    new_region_ids.push_back(new_region_id);
+      std::string region_name = std::string("T_") + std::to_string(schema_id) + std::string("_") +
+                                table_definition.name() + std::string("_part_") + std::to_string(new_part_id);
+      if (region_ranges.size() > 1) {
+        region_name += std::string("_") + std::to_string(j);
+      }
+
+      // the first peer is the preferred leader, rotate it to scatter the leaders of pre split regions
+      std::vector<int64_t> region_store_ids = store_ids;
+      if (region_ranges.size() > 1 && !region_store_ids.empty()) {
+        std::rotate(region_store_ids.begin(),
+                    region_store_ids.begin() + (new_region_ids.size() % region_store_ids.size()),
+                    region_store_ids.end());
+      }
+
+      std::vector<pb::coordinator::StoreOperation> store_operations;
+      ret = CreateRegionFinal(region_name, pb::common::RegionType::STORE_REGION, region_raw_engine_type,
+                              region_store_engine_type, "", replica, region_ranges[j], schema_id, new_table_id, 0,
+                              new_part_id, tenant_id, index_parameter, region_store_ids, 0, new_region_id,
+                              store_operations, meta_increment);
+      if (!ret.ok()) {
+        DINGO_LOG(ERROR) << "CreateRegion failed in CreateTable table_name=" << table_definition.name()
+                         << ", table_definition:" << table_definition.ShortDebugString()
+                         << " ret: " << ret.error_str();
+        return ret;
+      }
+
+      DINGO_LOG(INFO) << "CreateTable create region success, region_id=" << new_region_id;
+
+      new_region_ids.push_back(new_region_id);
+    }
   }
 
-  if (new_region_ids.size() < new_part_ranges.size()) {
-    DINGO_LOG(ERROR) << "Not enough regions is created, drop residual regions need=" << new_part_ranges.size()
+  if (new_region_ids.size() < need_region_num) {
+    DINGO_LOG(ERROR) << "Not enough regions is created, drop residual regions need=" << need_region_num
                      << " created=" << new_region_ids.size();
     for (auto region_id_to_delete : new_region_ids) {
       auto ret = DropRegion(region_id_to_delete, meta_increment);
@@ -2614,13 +2770,84 @@ int64_t CoordinatorControl::CalculateIndexMetricsSingle(int64_t index_id, pb::me
   return 0;
 }
 
+// ApplyRegionMetricsDeltaToTableMetrics
+// the old region metrics is read from region_metrics_map_, so caller must hold table_metrics_mutex_ until
+// region_metrics_map_ is updated. min/max key is only widened, shrinking is fixed by the full calculation.
+void CoordinatorControl::ApplyRegionMetricsDeltaToTableMetrics(
+    const std::vector<pb::common::RegionMetrics>& region_metricses) {
+  std::map<int64_t, pb::coordinator_internal::TableMetricsInternal> changed_table_metricses;
+  // the same region may appear more than once, the delta is against the previous one
+  std::map<int64_t, const pb::common::RegionMetrics*> applied_region_metricses;
+
+  for (const auto& region_metrics : region_metricses) {
+    const pb::common::RegionMetrics* old_region_metrics = nullptr;
+    pb::common::RegionMetrics region_metrics_in_map;
+    auto applied_it = applied_region_metricses.find(region_metrics.id());
+    if (applied_it != applied_region_metricses.end()) {
+      old_region_metrics = applied_it->second;
+    } else if (region_metrics_map_.Get(region_metrics.id(), region_metrics_in_map) >= 0) {
+      old_region_metrics = &region_metrics_in_map;
+    }
+    applied_region_metricses[region_metrics.id()] = &region_metrics;
+
+    int64_t table_id = region_metrics.region_definition().table_id();
+    if (table_id <= 0) {
+      continue;
+    }
+
+    int64_t row_count_delta = region_metrics.row_count();
+    int64_t size_delta = region_metrics.region_size();
+    if (old_region_metrics != nullptr) {
+      row_count_delta -= old_region_metrics->row_count();
+      size_delta -= old_region_metrics->region_size();
+    }
+
+    auto it = changed_table_metricses.find(table_id);
+    if (it == changed_table_metricses.end()) {
+      pb::coordinator_internal::TableMetricsInternal table_metrics_internal;
+      // only the table metrics has been calculated is maintained
+      if (table_metrics_map_.Get(table_id, table_metrics_internal) < 0) {
+        continue;
+      }
+      it = changed_table_metricses.emplace(table_id, std::move(table_metrics_internal)).first;
+    }
+
+    auto* table_metrics = it->second.mutable_table_metrics();
+    table_metrics->set_rows_count(table_metrics->rows_count() + row_count_delta);
+    table_metrics->set_table_size(table_metrics->table_size() + size_delta);
+    if (table_metrics->min_key().compare(region_metrics.min_key()) > 0) {
+      table_metrics->set_min_key(region_metrics.min_key());
+    }
+    if (table_metrics->max_key().compare(region_metrics.max_key()) < 0) {
+      table_metrics->set_max_key(region_metrics.max_key());
+    }
+  }
+
+  for (const auto& [table_id, table_metrics_internal] : changed_table_metricses) {
+    table_metrics_map_.PutIfExists(table_id, table_metrics_internal);
+
+    // mbvar table
+    const auto& table_metrics = table_metrics_internal.table_metrics();
+    coordinator_bvar_metrics_table_.UpdateTableBvar(table_id, table_metrics.rows_count(), table_metrics.part_count());
+  }
+}
+
 // CalculateTableMetrics
 // calculate table metrics using region metrics
 // only recalculate when table_metrics_map_ does contain table_id
 // if the table_id is not in table_map_, remove it from table_metrics_map_
+// when table metrics is updated incrementally, it's only a rare consistency check.
 void CoordinatorControl::CalculateTableMetrics() {
   // BAIDU_SCOPED_LOCK(table_metrics_map_mutex_);
 
+  if (FLAGS_enable_coordinator_incremental_table_metrics) {
+    int64_t now_ms = butil::gettimeofday_ms();
+    if (now_ms - table_metrics_full_calc_time_ms_ < FLAGS_coordinator_table_metrics_full_calc_interval_s * 1000) {
+      return;
+    }
+    table_metrics_full_calc_time_ms_ = now_ms;
+  }
+
   butil::FlatMap<int64_t, pb::coordinator_internal::TableMetricsInternal> temp_table_metrics_map;
   temp_table_metrics_map.init(10000);
   table_metrics_map_.GetRawMapCopy(temp_table_metrics_map);
@@ -2628,6 +2855,8 @@ void CoordinatorControl::CalculateTableMetrics() {
   for (auto& table_metrics_internal : temp_table_metrics_map) {
     int64_t table_id = table_metrics_internal.first;
     pb::meta::TableMetrics table_metrics;
+    // the incremental update can't interleave with the calculation of a table
+    BAIDU_SCOPED_LOCK(table_metrics_mutex_);
     if (CalculateTableMetricsSingle(table_id, table_metrics) < 0) {
       DINGO_LOG(ERROR) << "ERRROR: CalculateTableMetricsSingle failed, remove metrics from map" << table_id;
       table_metrics_map_.Erase(table_id);
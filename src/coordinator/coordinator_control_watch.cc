@@ -518,6 +518,13 @@ void CoordinatorControl::AddEventList(int64_t meta_revision,
   // add event list to meta_event_map_
   meta_event_map_.Put(meta_revision, event_list);
 
+  // most watchers have no pending revisions, they are all served by the events of this revision, so build the
+  // response once and share it by these watchers instead of rebuilding from meta_event_map_ for every watcher.
+  pb::meta::WatchResponse shared_event_response;
+  for (const auto &event : *event_list) {
+    *shared_event_response.add_events() = event;
+  }
+
   // check watch_bitset and push event list to pending_event_revisions
   {
     BAIDU_SCOPED_LOCK(meta_watch_bitmap_mutex_);
@@ -553,12 +560,15 @@ void CoordinatorControl::AddEventList(int64_t meta_revision,
         }
 
         if (!watch_instances.empty()) {
-          pb::meta::WatchResponse event_response;
-          auto ret = MetaWatchGetEventsForRevisions(event_revisions, event_response);
-          if (!ret.ok()) {
-            DINGO_LOG(ERROR) << "Get event list failed, watch_id: " << watch_id;
-            continue;
+          pb::meta::WatchResponse pending_event_response;
+          if (event_revisions.size() > 1) {
+            auto ret = MetaWatchGetEventsForRevisions(event_revisions, pending_event_response);
+            if (!ret.ok()) {
+              DINGO_LOG(ERROR) << "Get event list failed, watch_id: " << watch_id;
+              continue;
+            }
           }
+          const auto &event_response = event_revisions.size() > 1 ? pending_event_response : shared_event_response;
 
           for (auto &watch_instance : watch_instances) {
             auto ret = MetaWatchSendEvents(watch_id, node->watch_bitset, event_response, watch_instance.response,
@@ -15,14 +15,20 @@
 #ifndef DINGODB_COORDINATOR_META_STORAGE_H_
 #define DINGODB_COORDINATOR_META_STORAGE_H_
 
+#include <atomic>
 #include <cstdint>
+#include <functional>
+#include <list>
 #include <string>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
+#include "bthread/mutex.h"
 #include "butil/compiler_specific.h"
 #include "butil/containers/doubly_buffered_data.h"
 #include "butil/containers/flat_map.h"
+#include "butil/scoped_lock.h"
 #include "butil/status.h"
 #include "common/constant.h"
 #include "common/logging.h"
@@ -666,11 +672,12 @@ class MetaDiskMap {
 
 // MetaMemMapFlat is a template class for meta storage
 // This is for read/write meta data from/to RocksDB storage
-template <typename T>
+// MAP is DingoSafeMap or DingoShardedSafeMap, which have the same api
+template <typename T, typename MAP = DingoSafeMap<int64_t, T>>
 class MetaMemMapFlat {
  public:
   const std::string internal_prefix;
-  MetaMemMapFlat(DingoSafeMap<int64_t, T> *elements, const std::string &prefix, std::shared_ptr<RawEngine> raw_engine)
+  MetaMemMapFlat(MAP *elements, const std::string &prefix, std::shared_ptr<RawEngine> raw_engine)
       : internal_prefix(std::string("METAFLT") + prefix), raw_engine_(raw_engine), elements_(elements){};
   ~MetaMemMapFlat() = default;
 
@@ -919,7 +926,7 @@ class MetaMemMapFlat {
 
  private:
   std::shared_ptr<RawEngine> raw_engine_;
-  DingoSafeMap<int64_t, T> *elements_;
+  MAP *elements_;
 };
 
 // MetaMemMapStd is a template class for meta storage
@@ -1153,6 +1160,301 @@ class MetaMemMapStd {
   DingoSafeStdMap<std::string, T> *elements_;
 };
 
+// MetaCachedDiskMap is a template class for meta storage
+// The elements are stored in RocksDB only, with the same key layout as MetaMemMapStd, so data and snapshot written by
+// MetaMemMapStd can be read directly. A bounded LRU cache keeps the hot elements in memory, range read is served by
+// prefix iteration of RocksDB, so the memory is no longer bounded by the element count.
+template <typename T>
+class MetaCachedDiskMap {
+ public:
+  const std::string internal_prefix;
+  MetaCachedDiskMap(const std::string &prefix, std::shared_ptr<RawEngine> raw_engine, int64_t cache_capacity)
+      : internal_prefix(std::string("METASFM") + prefix), raw_engine_(raw_engine), cache_capacity_(cache_capacity) {
+    bthread_mutex_init(&cache_mutex_, nullptr);
+  };
+  ~MetaCachedDiskMap() { bthread_mutex_destroy(&cache_mutex_); }
+
+  // reset the cache and the element count after the data in RocksDB is replaced
+  bool Recover() {
+    ClearCache();
+
+    int64_t count = 0;
+    butil::Status status = raw_engine_->Reader()->KvCount(Constant::kStoreMetaCF, GenKey(""), EndKey(), count);
+    if (!status.ok()) {
+      DINGO_LOG(ERROR) << fmt::format("Meta count failed, errcode: {} {}", status.error_code(), status.error_str());
+      return false;
+    }
+    count_.store(count);
+
+    return true;
+  }
+
+  bool Recover(const std::vector<pb::common::KeyValue> &kvs) {
+    ClearCache();
+    count_.store(kvs.size());
+    return true;
+  }
+
+  std::string Prefix() { return internal_prefix; }
+
+  std::string ParseId(const std::string &key) {
+    if (key.size() <= internal_prefix.size()) {
+      DINGO_LOG(ERROR) << "Parse id failed, invalid str " << key;
+      return std::string();
+    }
+
+    return key.substr(internal_prefix.size() + 1);
+  }
+
+  std::string GenKey(const std::string &id) { return internal_prefix + "_" + id; }
+
+  // return EKEY_NOT_FOUND if id is not exist
+  butil::Status Get(const std::string &id, T &element) {
+    uint64_t seq = 0;
+    {
+      BAIDU_SCOPED_LOCK(cache_mutex_);
+      auto it = cache_.find(id);
+      if (it != cache_.end()) {
+        cache_lru_.splice(cache_lru_.begin(), cache_lru_, it->second.second);
+        element = it->second.first;
+        return butil::Status::OK();
+      }
+      seq = mutation_seq_;
+    }
+
+    std::string value;
+    butil::Status status = raw_engine_->Reader()->KvGet(Constant::kStoreMetaCF, GenKey(id), value);
+    if (!status.ok()) {
+      if (status.error_code() != pb::error::EKEY_NOT_FOUND) {
+        DINGO_LOG(ERROR) << fmt::format("Meta get id {} failed, errcode: {} {}", id, status.error_code(),
+                                        status.error_str());
+      }
+      return status;
+    }
+
+    if (!element.ParsePartialFromString(value)) {
+      DINGO_LOG(ERROR) << fmt::format("Meta parse value failed, id: {}", id);
+      return butil::Status(pb::error::EINTERNAL, "Meta parse value failed");
+    }
+
+    {
+      // the element may be changed by Put/Erase during the disk read, only cache it when nothing changed.
+      BAIDU_SCOPED_LOCK(cache_mutex_);
+      if (seq == mutation_seq_) {
+        CacheInsertWithLock(id, element);
+      }
+    }
+
+    return butil::Status::OK();
+  }
+
+  bool Exists(const std::string &id) {
+    T element;
+    return Get(id, element).ok();
+  }
+
+  butil::Status Put(const std::string &id, const T &element) {
+    CHECK(!id.empty());
+    CHECK(id == element.id());
+
+    bool is_exists = Exists(id);
+
+    pb::common::KeyValue kv;
+    kv.set_key(GenKey(id));
+    kv.set_value(element.SerializeAsString());
+    butil::Status status = raw_engine_->Writer()->KvPut(Constant::kStoreMetaCF, kv);
+    if (!status.ok()) {
+      DINGO_LOG(ERROR) << fmt::format("Meta put id {} failed, errcode: {} {}", id, status.error_code(),
+                                      status.error_str());
+      return status;
+    }
+
+    if (!is_exists) {
+      count_.fetch_add(1);
+    }
+
+    BAIDU_SCOPED_LOCK(cache_mutex_);
+    ++mutation_seq_;
+    CacheInsertWithLock(id, element);
+
+    return butil::Status::OK();
+  }
+
+  butil::Status Erase(const std::string &id) {
+    bool is_exists = Exists(id);
+
+    butil::Status status = raw_engine_->Writer()->KvDelete(Constant::kStoreMetaCF, GenKey(id));
+    if (!status.ok()) {
+      DINGO_LOG(ERROR) << fmt::format("Meta delete id {} failed, errcode: {} {}", id, status.error_code(),
+                                      status.error_str());
+      return status;
+    }
+
+    if (is_exists) {
+      count_.fetch_sub(1);
+    }
+
+    BAIDU_SCOPED_LOCK(cache_mutex_);
+    ++mutation_seq_;
+    auto it = cache_.find(id);
+    if (it != cache_.end()) {
+      cache_lru_.erase(it->second.second);
+      cache_.erase(it);
+    }
+
+    return butil::Status::OK();
+  }
+
+  int64_t Size() { return Count(); }
+
+  int64_t Count() { return count_.load(); }
+
+  int64_t CacheSize() {
+    BAIDU_SCOPED_LOCK(cache_mutex_);
+    return cache_.size();
+  }
+
+  int64_t CacheMemorySize() {
+    BAIDU_SCOPED_LOCK(cache_mutex_);
+    int64_t size = 0;
+    for (const auto &[id, element] : cache_) {
+      size += id.size() * 2 + element.first.ByteSizeLong();
+    }
+    return size;
+  }
+
+  // scan elements in [lower_bound, upper_bound) from RocksDB in key order, limit 0 means no limit
+  // the iteration stops once limit elements pass the filter, the rest of range is not read
+  butil::Status GetRangeValues(std::vector<T> &values, const std::string &lower_bound, const std::string &upper_bound,
+                               std::function<bool(const T &)> value_filter = nullptr, size_t limit = 0) {
+    IteratorOptions options;
+    options.upper_bound = GenKey(upper_bound);
+    auto iter = raw_engine_->Reader()->NewIterator(Constant::kStoreMetaCF, options);
+    if (iter == nullptr) {
+      DINGO_LOG(ERROR) << "Meta scan failed, new iterator failed";
+      return butil::Status(pb::error::EINTERNAL, "Meta new iterator failed");
+    }
+
+    for (iter->Seek(GenKey(lower_bound)); iter->Valid(); iter->Next()) {
+      T element;
+      auto value = iter->Value();
+      if (!element.ParsePartialFromArray(value.data(), value.size())) {
+        DINGO_LOG(ERROR) << fmt::format("Meta parse value failed, key: {}", iter->Key());
+        return butil::Status(pb::error::EINTERNAL, "Meta parse value failed");
+      }
+      if (value_filter != nullptr && !value_filter(element)) {
+        continue;
+      }
+
+      values.push_back(std::move(element));
+      if (limit > 0 && values.size() >= limit) {
+        return butil::Status::OK();
+      }
+    }
+
+    auto status = iter->Status();
+    if (!status.ok()) {
+      DINGO_LOG(ERROR) << fmt::format("Meta scan failed, errcode: {} {}", status.error_code(), status.error_str());
+    }
+    return status;
+  }
+
+  butil::Status GetAllIds(std::vector<std::string> &ids) {
+    std::vector<pb::common::KeyValue> kvs;
+    butil::Status status = raw_engine_->Reader()->KvScan(Constant::kStoreMetaCF, GenKey(""), EndKey(), kvs);
+    if (!status.ok()) {
+      DINGO_LOG(ERROR) << fmt::format("Meta get all keys failed, errcode: {} {}", status.error_code(),
+                                      status.error_str());
+      return status;
+    }
+
+    ids.reserve(ids.size() + kvs.size());
+    for (const auto &kv : kvs) {
+      ids.push_back(ParseId(kv.key()));
+    }
+
+    return butil::Status::OK();
+  }
+
+  butil::Status GetAllElements(std::vector<T> &elements, std::function<bool(const T &)> value_filter = nullptr) {
+    std::vector<pb::common::KeyValue> kvs;
+    butil::Status status = raw_engine_->Reader()->KvScan(Constant::kStoreMetaCF, GenKey(""), EndKey(), kvs);
+    if (!status.ok()) {
+      DINGO_LOG(ERROR) << fmt::format("Meta get all elements failed, errcode: {} {}", status.error_code(),
+                                      status.error_str());
+      return status;
+    }
+
+    return ParseKvValues(kvs, elements, value_filter, 0);
+  }
+
+  MetaCachedDiskMap(const MetaCachedDiskMap &) = delete;
+  const MetaCachedDiskMap &operator=(const MetaCachedDiskMap &) = delete;
+
+ private:
+  std::string EndKey() { return internal_prefix + "~"; }
+
+  static butil::Status ParseKvValues(const std::vector<pb::common::KeyValue> &kvs, std::vector<T> &values,
+                                     const std::function<bool(const T &)> &value_filter, size_t limit) {
+    for (const auto &kv : kvs) {
+      T element;
+      if (!element.ParsePartialFromString(kv.value())) {
+        DINGO_LOG(ERROR) << fmt::format("Meta parse value failed, key: {}", kv.key());
+        return butil::Status(pb::error::EINTERNAL, "Meta parse value failed");
+      }
+      if (value_filter != nullptr && !value_filter(element)) {
+        continue;
+      }
+
+      values.push_back(std::move(element));
+      if (limit > 0 && values.size() >= limit) {
+        break;
+      }
+    }
+
+    return butil::Status::OK();
+  }
+
+  void ClearCache() {
+    BAIDU_SCOPED_LOCK(cache_mutex_);
+    ++mutation_seq_;
+    cache_.clear();
+    cache_lru_.clear();
+  }
+
+  void CacheInsertWithLock(const std::string &id, const T &element) {
+    if (cache_capacity_ <= 0) {
+      return;
+    }
+
+    auto it = cache_.find(id);
+    if (it != cache_.end()) {
+      it->second.first = element;
+      cache_lru_.splice(cache_lru_.begin(), cache_lru_, it->second.second);
+      return;
+    }
+
+    cache_lru_.push_front(id);
+    cache_.emplace(id, std::make_pair(element, cache_lru_.begin()));
+
+    while (static_cast<int64_t>(cache_.size()) > cache_capacity_) {
+      cache_.erase(cache_lru_.back());
+      cache_lru_.pop_back();
+    }
+  }
+
+  std::shared_ptr<RawEngine> raw_engine_;
+  std::atomic<int64_t> count_{0};
+
+  // hot elements cache, protected by cache_mutex_
+  int64_t cache_capacity_;
+  bthread_mutex_t cache_mutex_;
+  std::list<std::string> cache_lru_;
+  std::unordered_map<std::string, std::pair<T, std::list<std::string>::iterator>> cache_;
+  // bumped by every Put/Erase, guard a disk read from caching a stale element
+  uint64_t mutation_seq_{0};
+};
+
 }  // namespace dingodb
 
 #endif  // DINGODB_COORDINATOR_META_STORAGE_H_
\ No newline at end of file
@@ -36,9 +36,15 @@
 
 namespace dingodb {
 
+DEFINE_int64(kv_index_cache_capacity, 100000, "max cached kv index count of version kv");
+
 KvControl::KvControl(std::shared_ptr<MetaReader> meta_reader, std::shared_ptr<MetaWriter> meta_writer,
                      std::shared_ptr<RawEngine> raw_engine_of_meta)
-    : meta_reader_(meta_reader), meta_writer_(meta_writer), leader_term_(-1), raw_engine_of_meta_(raw_engine_of_meta) {
+    : lease_timer_wheel_(butil::gettimeofday_s()),
+      meta_reader_(meta_reader),
+      meta_writer_(meta_writer),
+      leader_term_(-1),
+      raw_engine_of_meta_(raw_engine_of_meta) {
   // init bthread mutex
   bthread_mutex_init(&lease_to_key_map_temp_mutex_, nullptr);
   bthread_mutex_init(&one_time_watch_map_mutex_, nullptr);
@@ -51,8 +57,8 @@ KvControl::KvControl(std::shared_ptr<MetaReader> meta_reader, std::shared_ptr<Me
   // version kv
   kv_lease_meta_ =
       new MetaMemMapFlat<pb::coordinator_internal::LeaseInternal>(&kv_lease_map_, kPrefixKvLease, raw_engine_of_meta);
-  kv_index_meta_ =
-      new MetaMemMapStd<pb::coordinator_internal::KvIndexInternal>(&kv_index_map_, kPrefixKvIndex, raw_engine_of_meta);
+  kv_index_meta_ = new MetaCachedDiskMap<pb::coordinator_internal::KvIndexInternal>(
+      kPrefixKvIndex, raw_engine_of_meta, FLAGS_kv_index_cache_capacity);
   kv_rev_meta_ = new MetaDiskMap<pb::coordinator_internal::KvRevInternal>(kPrefixKvRev, raw_engine_of_meta_);
 
   // init SafeMap
@@ -118,28 +124,14 @@ bool KvControl::Recover() {
   kvs.clear();
 
   // 15.kv_index map
-  if (!meta_reader_->Scan(kv_index_meta_->Prefix(), kvs)) {
+  // kv_index and kv_rev are read from rocksdb on demand, do not load them into memory
+  if (!kv_index_meta_->Recover()) {
     return false;
   }
-  {
-    if (!kv_index_meta_->Recover(kvs)) {
-      return false;
-    }
-  }
-  DINGO_LOG(INFO) << "Recover kv_index_meta, count=" << kvs.size();
-  kvs.clear();
+  DINGO_LOG(INFO) << "Recover kv_index_meta, count=" << kv_index_meta_->Count();
 
   // 16.kv_rev map
-  if (!meta_reader_->Scan(kv_rev_meta_->Prefix(), kvs)) {
-    return false;
-  }
-  // {
-  //   if (!kv_rev_meta_->Recover(kvs)) {
-  //     return false;
-  //   }
-  // }
-  DINGO_LOG(INFO) << "Recover kv_rev_meta, count=" << kvs.size();
-  kvs.clear();
+  DINGO_LOG(INFO) << "Recover kv_rev_meta, count=" << kv_rev_meta_->Count();
 
   // build id_epoch, schema_name, table_name, index_name maps
   BuildTempMaps();
@@ -148,12 +140,6 @@ bool KvControl::Recover() {
   BuildLeaseToKeyMap();
   DINGO_LOG(INFO) << "Recover lease_to_key_map_temp, count=" << lease_to_key_map_temp_.size();
 
-  std::map<std::string, pb::coordinator_internal::KvRevInternal> kv_rev_map;
-  kv_rev_meta_->GetAllIdElements(kv_rev_map);
-  for (auto& kv : kv_rev_map) {
-    DINGO_LOG(INFO) << "kv_rev_map key=" << Helper::StringToHex(kv.first) << " value=" << kv.second.DebugString();
-  }
-
   return true;
 }
 
@@ -314,8 +300,8 @@ void KvControl::GetMemoryInfo(pb::coordinator::CoordinatorMemoryInfo& memory_inf
       memory_info.set_total_size(memory_info.total_size() + memory_info.kv_lease_map_size());
     }
     {
-      memory_info.set_kv_index_map_count(kv_index_map_.Size());
-      memory_info.set_kv_index_map_size(kv_index_map_.MemorySize());
+      memory_info.set_kv_index_map_count(kv_index_meta_->Count());
+      memory_info.set_kv_index_map_size(kv_index_meta_->CacheMemorySize());
       memory_info.set_total_size(memory_info.total_size() + memory_info.kv_index_map_size());
     }
     {
@@ -28,6 +28,7 @@
 #include "butil/status.h"
 #include "common/meta_control.h"
 #include "common/safe_map.h"
+#include "common/timer_wheel.h"
 #include "coordinator/coordinator_meta_storage.h"
 #include "engine/engine.h"
 #include "engine/snapshot.h"
@@ -243,8 +244,10 @@ class KvControl : public MetaControl {
   static pb::coordinator_internal::RevisionInternal StringToRevision(const std::string &input_string);
 
   // raw kv functions
+  // limit 0 means no limit
   butil::Status RangeRawKvIndex(const std::string &key, const std::string &range_end,
-                                std::vector<pb::coordinator_internal::KvIndexInternal> &kv_index_values);
+                                std::vector<pb::coordinator_internal::KvIndexInternal> &kv_index_values,
+                                int64_t limit = 0);
   butil::Status GetRawKvIndex(const std::string &key, pb::coordinator_internal::KvIndexInternal &kv_index);
   butil::Status PutRawKvIndex(const std::string &key, const pb::coordinator_internal::KvIndexInternal &kv_index);
   butil::Status DeleteRawKvIndex(const std::string &key);
@@ -349,10 +352,12 @@ class KvControl : public MetaControl {
   std::map<int64_t, KvLeaseWithKeys>
       lease_to_key_map_temp_;  // storage lease_id to key map, this map is built in on_leader_start
   bthread_mutex_t lease_to_key_map_temp_mutex_;
+  // the leases of lease_to_key_map_temp_ indexed by expire seconds, protected by lease_to_key_map_temp_mutex_
+  TimerWheel lease_timer_wheel_;
 
   // 15.version kv with lease
-  DingoSafeStdMap<std::string, pb::coordinator_internal::KvIndexInternal> kv_index_map_;
-  MetaMemMapStd<pb::coordinator_internal::KvIndexInternal> *kv_index_meta_;
+  // kv index is stored in rocksdb only, with a lru cache of hot keys
+  MetaCachedDiskMap<pb::coordinator_internal::KvIndexInternal> *kv_index_meta_;
 
   // 16.version kv multi revision
   MetaDiskMap<pb::coordinator_internal::KvRevInternal> *kv_rev_meta_;
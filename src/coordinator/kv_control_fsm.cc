@@ -240,10 +240,6 @@ bool KvControl::LoadMetaFromSnapshotFile(pb::coordinator_internal::MetaSnapshotF
     kvs.push_back(meta_snapshot_file.kv_index_map_kvs(i));
   }
   {
-    if (!kv_index_meta_->Recover(kvs)) {
-      return false;
-    }
-
     // remove data in rocksdb
     if (!meta_writer_->DeletePrefix(kv_index_meta_->internal_prefix)) {
       DINGO_LOG(ERROR) << "Coordinator delete kv_index_meta_ range failed in LoadMetaFromSnapshotFile";
@@ -257,6 +253,11 @@ bool KvControl::LoadMetaFromSnapshotFile(pb::coordinator_internal::MetaSnapshotF
       return false;
     }
     DINGO_LOG(INFO) << "Coordinator put kv_index_meta_ success in LoadMetaFromSnapshotFile";
+
+    // reset cache after rocksdb is replaced
+    if (!kv_index_meta_->Recover(kvs)) {
+      return false;
+    }
   }
   DINGO_LOG(INFO) << "LoadSnapshot version_kv_meta, count=" << kvs.size();
   kvs.clear();
@@ -68,49 +68,64 @@ pb::coordinator_internal::RevisionInternal KvControl::StringToRevision(const std
 }
 
 butil::Status KvControl::GetRawKvIndex(const std::string &key, pb::coordinator_internal::KvIndexInternal &kv_index) {
-  auto ret = kv_index_map_.Get(key, kv_index);
-  if (ret < 0) {
-    DINGO_LOG(WARNING) << "GetRawKvIndex not found, key:[" << key << "]";
+  auto ret = kv_index_meta_->Get(key, kv_index);
+  if (!ret.ok()) {
+    DINGO_LOG(WARNING) << "GetRawKvIndex not found, key:[" << key << "], errcode: " << ret.error_code();
     return butil::Status(EINVAL, "GetRawKvIndex not found");
   }
   return butil::Status::OK();
 }
 
+static bool IsLiveKvIndex(const pb::coordinator_internal::KvIndexInternal &version_kv) {
+  auto generation_count = version_kv.generations_size();
+  if (generation_count == 0) {
+    return false;
+  }
+
+  const auto &latest_generation = version_kv.generations(generation_count - 1);
+  return latest_generation.has_create_revision() && latest_generation.revisions_size() > 0;
+}
+
 butil::Status KvControl::RangeRawKvIndex(const std::string &key, const std::string &range_end,
-                                         std::vector<pb::coordinator_internal::KvIndexInternal> &kv_index_values) {
+                                         std::vector<pb::coordinator_internal::KvIndexInternal> &kv_index_values,
+                                         int64_t limit) {
+  // exact key, point get instead of scan
+  if (range_end.empty()) {
+    pb::coordinator_internal::KvIndexInternal kv_index;
+    auto ret = kv_index_meta_->Get(key, kv_index);
+    if (ret.ok() && IsLiveKvIndex(kv_index)) {
+      kv_index_values.push_back(std::move(kv_index));
+    } else if (!ret.ok() && ret.error_code() != pb::error::EKEY_NOT_FOUND) {
+      DINGO_LOG(WARNING) << "RangeRawKvIndex failed, key:[" << key << "]";
+      return butil::Status(EINVAL, "RangeRawKvIndex failed");
+    }
+    return butil::Status::OK();
+  }
+
   // scan kv_index for legal keys
   std::string lower_bound = key;
   std::string upper_bound = range_end;
 
   if (range_end == std::string(1, '\0')) {
     upper_bound = std::string(FLAGS_max_kv_key_size, '\xff');
-  } else if (range_end.empty()) {
-    upper_bound = Helper::PrefixNext(key);
   }
 
-  auto ret = kv_index_map_.GetRangeValues(
-      kv_index_values, lower_bound, upper_bound, nullptr,
+  auto ret = kv_index_meta_->GetRangeValues(
+      kv_index_values, lower_bound, upper_bound,
       [&key, &range_end](const pb::coordinator_internal::KvIndexInternal &version_kv) -> bool {
-        auto generation_count = version_kv.generations_size();
-        if (generation_count == 0) {
-          return false;
-        }
-
-        const auto &latest_generation = version_kv.generations(generation_count - 1);
-        if (!latest_generation.has_create_revision() || latest_generation.revisions_size() == 0) {
+        if (!IsLiveKvIndex(version_kv)) {
           return false;
         }
 
-        if (range_end.empty()) {
-          return key == version_kv.id();
-        } else if (range_end == std::string(1, '\0')) {
+        if (range_end == std::string(1, '\0')) {
           return version_kv.id().compare(key) >= 0;
         } else {
           return version_kv.id().compare(key) >= 0 && version_kv.id().compare(range_end) < 0;
         }
-      });
+      },
+      limit > 0 ? static_cast<size_t>(limit) : 0);
 
-  if (ret < 0) {
+  if (!ret.ok()) {
     DINGO_LOG(WARNING) << "RangeRawKvIndex failed, key:[" << key << "]";
     return butil::Status(EINVAL, "RangeRawKvIndex failed");
   } else {
@@ -203,8 +218,8 @@ butil::Status KvControl::KvRange(const std::string &key, const std::string &rang
     }
     kv_index_values.push_back(kv_index);
   } else {
-    // scan kv_index for legal keys
-    auto ret = RangeRawKvIndex(key, range_end, kv_index_values);
+    // scan kv_index for legal keys, one more than limit to know has_more
+    auto ret = RangeRawKvIndex(key, range_end, kv_index_values, limit == INT64_MAX ? 0 : limit + 1);
     if (!ret.ok()) {
       DINGO_LOG(ERROR) << "KvRange kv_index_map_.RangeRawKvIndex failed, key: " << key << "("
                        << Helper::StringToHex(key) << "), range_end: " << range_end << "("
@@ -342,8 +357,8 @@ butil::Status KvControl::KvPut(const pb::common::KeyValue &key_value_in, int64_t
                   << "), lease_id: " << lease_id << ", need_prev_kv: " << need_prev_kv
                   << ", igore_value: " << ignore_value << ", ignore_lease: " << ignore_lease;
 
-  if (kv_index_map_.Size() > FLAGS_version_kv_max_count) {
-    DINGO_LOG(ERROR) << "KvPut kv_index_map_ size: " << kv_index_map_.Size() << ", will do compaction";
+  if (kv_index_meta_->Count() > FLAGS_version_kv_max_count) {
+    DINGO_LOG(ERROR) << "KvPut kv_index_map_ size: " << kv_index_meta_->Count() << ", will do compaction";
     return butil::Status(pb::error::Errno::EKV_COUNT_EXCEEDS_LIMIT, "KvPut kv_index_map_ size is too large");
   }
 
@@ -883,8 +898,8 @@ void KvControl::CompactionTask() {
 
   // get all keys in kv_index_map_
   std::vector<std::string> keys;
-  auto ret = kv_index_map_.GetAllKeys(keys);
-  if (ret < 0) {
+  auto ret = kv_index_meta_->GetAllIds(keys);
+  if (!ret.ok()) {
     DINGO_LOG(ERROR) << "kv_index_map_ GetAllKeys failed";
     return;
   }
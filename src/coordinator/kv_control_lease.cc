@@ -39,6 +39,11 @@ DEFINE_int64(version_lease_print_ttl_remaining_seconds, 10, "print ttl remaining
 
 DEFINE_bool(dingo_log_switch_coor_lease, false, "switch for dingo log of kv control lease");
 
+// the lease is expired when ttl_seconds + last_renew_ts_seconds < now
+static int64_t LeaseExpireSeconds(const pb::coordinator_internal::LeaseInternal &lease) {
+  return lease.ttl_seconds() + lease.last_renew_ts_seconds() + 1;
+}
+
 butil::Status KvControl::LeaseGrant(int64_t lease_id, int64_t ttl_seconds, int64_t &granted_id,
                                     int64_t &granted_ttl_seconds,
                                     pb::coordinator_internal::MetaIncrement &meta_increment) {
@@ -95,6 +100,7 @@ butil::Status KvControl::LeaseGrant(int64_t lease_id, int64_t ttl_seconds, int64
   {
     BAIDU_SCOPED_LOCK(lease_to_key_map_temp_mutex_);
     lease_to_key_map_temp_.emplace(lease_with_keys.lease.id(), lease_with_keys);
+    lease_timer_wheel_.Add(lease_with_keys.lease.id(), LeaseExpireSeconds(lease_with_keys.lease));
   }
 
   return butil::Status::OK();
@@ -110,7 +116,14 @@ butil::Status KvControl::LeaseRenew(int64_t lease_id, int64_t &ttl_seconds,
 
   auto iter = lease_to_key_map_temp_.find(lease_id);
   if (iter != lease_to_key_map_temp_.end()) {
+    auto remaining_ttl_seconds = LeaseExpireSeconds(iter->second.lease) - 1 - now_time_seconds;
+    if (remaining_ttl_seconds < FLAGS_version_lease_print_ttl_remaining_seconds) {
+      DINGO_LOG(INFO) << "lease id " << lease_id << " is renewed, last_renew_ts_seconds "
+                      << iter->second.lease.last_renew_ts_seconds() << ", ttl_seconds "
+                      << iter->second.lease.ttl_seconds() << ", remaining ttl_seconds " << remaining_ttl_seconds;
+    }
     iter->second.lease.set_last_renew_ts_seconds(now_time_seconds);
+    lease_timer_wheel_.Add(lease_id, LeaseExpireSeconds(iter->second.lease));
   } else {
     DINGO_LOG(WARNING) << "lease id " << lease_id << " not found, cannot renew";
     return butil::Status(pb::error::Errno::ELEASE_NOT_EXISTS_OR_EXPIRED, "lease id %lu not found", lease_id);
@@ -186,6 +199,7 @@ butil::Status KvControl::LeaseRevoke(int64_t lease_id, pb::coordinator_internal:
 
     // delete lease from map
     lease_to_key_map_temp_.erase(lease_id);
+    lease_timer_wheel_.Remove(lease_id);
   }
 
   if (!has_mutex_locked) {
@@ -242,23 +256,31 @@ void KvControl::LeaseTask() {
       return;
     }
 
-    for (const auto &it : lease_to_key_map_temp_) {
-      const auto &lease = it.second.lease;
+    // only the leases expired since last task are touched
+    std::vector<int64_t> expired_lease_ids;
+    lease_timer_wheel_.Advance(butil::gettimeofday_s(), expired_lease_ids);
+    for (auto lease_id : expired_lease_ids) {
+      auto it = lease_to_key_map_temp_.find(lease_id);
+      if (it == lease_to_key_map_temp_.end()) {
+        continue;
+      }
+
+      const auto &lease = it->second.lease;
       if (lease.ttl_seconds() + lease.last_renew_ts_seconds() < butil::gettimeofday_s()) {
         DINGO_LOG(INFO) << "lease id " << lease.id() << " expired, will revoke";
         lease_ids_to_revoke.emplace_back(lease.id());
       } else {
-        auto remaining_ttl_seconds = lease.ttl_seconds() - (butil::gettimeofday_s() - lease.last_renew_ts_seconds());
-        if (remaining_ttl_seconds < FLAGS_version_lease_print_ttl_remaining_seconds) {
-          DINGO_LOG(INFO) << "lease id " << lease.id() << " is ok, last_renew_ts_seconds "
-                          << lease.last_renew_ts_seconds() << ", ttl_seconds " << lease.ttl_seconds()
-                          << ", remaining ttl_seconds " << remaining_ttl_seconds;
-        }
+        // the clock went back, wait for the real expire time
+        lease_timer_wheel_.Add(lease_id, LeaseExpireSeconds(lease));
       }
     }
 
     for (const auto &lease_id : lease_ids_to_revoke) {
-      LeaseRevoke(lease_id, meta_increment, true);
+      auto ret = LeaseRevoke(lease_id, meta_increment, true);
+      if (!ret.ok() && lease_to_key_map_temp_.find(lease_id) != lease_to_key_map_temp_.end()) {
+        // retry in next task
+        lease_timer_wheel_.Add(lease_id, butil::gettimeofday_s());
+      }
     }
 
     // submit meta_increment with mutex locked
@@ -295,15 +317,18 @@ void KvControl::BuildLeaseToKeyMap() {
   // read all keys from version_kv to construct lease list
   std::vector<pb::coordinator_internal::KvIndexInternal> kv_index_values;
 
-  if (kv_index_map_.GetAllValues(kv_index_values, [](pb::coordinator_internal::KvIndexInternal version_kv) -> bool {
-        auto generation_count = version_kv.generations_size();
-        if (generation_count == 0) {
-          return false;
-        }
-        const auto &latest_generation = version_kv.generations(generation_count - 1);
-        return latest_generation.has_create_revision();
-      }) < 0) {
-    DINGO_LOG(FATAL) << "OnLeaderStart kv_index_map_.GetAllValues failed";
+  if (!kv_index_meta_
+           ->GetAllElements(kv_index_values,
+                            [](const pb::coordinator_internal::KvIndexInternal &version_kv) -> bool {
+                              auto generation_count = version_kv.generations_size();
+                              if (generation_count == 0) {
+                                return false;
+                              }
+                              const auto &latest_generation = version_kv.generations(generation_count - 1);
+                              return latest_generation.has_create_revision();
+                            })
+           .ok()) {
+    DINGO_LOG(FATAL) << "OnLeaderStart kv_index_meta_->GetAllElements failed";
   }
 
   for (const auto &kv_index_value : kv_index_values) {
@@ -332,6 +357,11 @@ void KvControl::BuildLeaseToKeyMap() {
 
   BAIDU_SCOPED_LOCK(lease_to_key_map_temp_mutex_);
   lease_to_key_map_temp_.swap(t_lease_to_key);
+
+  lease_timer_wheel_.Clear(butil::gettimeofday_s());
+  for (const auto &it : lease_to_key_map_temp_) {
+    lease_timer_wheel_.Add(it.first, LeaseExpireSeconds(it.second.lease));
+  }
 }
 
 butil::Status KvControl::LeaseAddKeys(int64_t lease_id, std::set<std::string> &keys) {
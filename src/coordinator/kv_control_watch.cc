@@ -154,11 +154,13 @@ butil::Status KvControl::RemoveOneTimeWatchWithLock(uint64_t closure_id) {
   }
   auto& defer_done = it_defer_done->second;
 
-  DINGO_LOG(INFO) << "RemoveOneTimeWatch, closure_id:" << closure_id << ", done->Run() start";
+  DINGO_LOG_IF(INFO, FLAGS_dingo_log_switch_coor_watch)
+      << "RemoveOneTimeWatch, closure_id:" << closure_id << ", done->Run() start";
   int64_t start_ts = butil::gettimeofday_ms();
   defer_done.Done();
-  DINGO_LOG(INFO) << "RemoveOneTimeWatch, closure_id:" << closure_id
-                  << ", done->Run() finish, cost: " << butil::gettimeofday_ms() - start_ts << " ms";
+  DINGO_LOG_IF(INFO, FLAGS_dingo_log_switch_coor_watch)
+      << "RemoveOneTimeWatch, closure_id:" << closure_id
+      << ", done->Run() finish, cost: " << butil::gettimeofday_ms() - start_ts << " ms";
 
   auto watch_key = defer_done.GetWatchKey();
   if (watch_key.empty()) {
@@ -183,8 +185,9 @@ butil::Status KvControl::RemoveOneTimeWatchWithLock(uint64_t closure_id) {
   }
 
   watch_node_map.erase(it_watch_node);
-  DINGO_LOG(INFO) << "RemoveOneTimeWatch, done->Run: " << closure_id << ", watch_key:" << watch_key
-                  << ", cost: " << butil::gettimeofday_ms() - start_ts << " ms";
+  DINGO_LOG_IF(INFO, FLAGS_dingo_log_switch_coor_watch)
+      << "RemoveOneTimeWatch, done->Run: " << closure_id << ", watch_key:" << watch_key
+      << ", cost: " << butil::gettimeofday_ms() - start_ts << " ms";
 
   if (watch_node_map.empty()) {
     DINGO_LOG(INFO) << "RemoveOneTimeWatch, watch_node_map is empty, watch_key:" << watch_key;
@@ -284,7 +287,15 @@ butil::Status KvControl::TriggerOneWatch(const std::string& key, pb::version::Ev
   DINGO_LOG_IF(INFO, FLAGS_dingo_log_switch_coor_watch)
       << "TriggerOneWatch, key:" << key << ", watch_node_map.size:" << watch_node_map.size();
 
+  // build the event once and share it by all watchers of the key, watchers only differ in need_prev_kv.
+  pb::version::Event shared_event;
+  shared_event.set_type(event_type);
+  *shared_event.mutable_kv() = new_kv;
+  pb::version::Event shared_event_with_prev_kv;
+  bool has_event_with_prev_kv = false;
+
   std::vector<uint64_t> done_list;
+  done_list.reserve(watch_node_map.size());
   for (auto& watch_node : watch_node_map) {
     if (watch_node.second.no_put_event && event_type == pb::version::Event::EventType::Event_EventType_PUT) {
       DINGO_LOG_IF(INFO, FLAGS_dingo_log_switch_coor_watch) << "TriggerOneWatch skip, no_put_event, key:" << key;
@@ -304,12 +315,13 @@ butil::Status KvControl::TriggerOneWatch(const std::string& key, pb::version::Ev
       continue;
     }
 
-    DINGO_LOG(INFO) << "TriggerOneWatch will GetResponse, key:" << key << ", event_type:" << event_type
-                    << ", watch_node.first:" << watch_node.first
-                    << ", watch_detail: start_revision=" << watch_node.second.start_revision
-                    << ", no_put_event=" << watch_node.second.no_put_event
-                    << ", no_delete_event=" << watch_node.second.no_delete_event
-                    << ", need_prev_kv=" << watch_node.second.need_prev_kv;
+    DINGO_LOG_IF(INFO, FLAGS_dingo_log_switch_coor_watch)
+        << "TriggerOneWatch will GetResponse, key:" << key << ", event_type:" << event_type
+        << ", watch_node.first:" << watch_node.first
+        << ", watch_detail: start_revision=" << watch_node.second.start_revision
+        << ", no_put_event=" << watch_node.second.no_put_event
+        << ", no_delete_event=" << watch_node.second.no_delete_event
+        << ", need_prev_kv=" << watch_node.second.need_prev_kv;
 
     pb::version::WatchResponse* response = nullptr;
     auto closure_id = watch_node.first;
@@ -327,13 +339,15 @@ butil::Status KvControl::TriggerOneWatch(const std::string& key, pb::version::Ev
       if (response == nullptr) {
         DINGO_LOG(ERROR) << "TriggerOneWatch, response is nullptr, key:" << key << ", closure_id:" << closure_id;
       } else {
-        auto* event = response->add_events();
-        event->set_type(event_type);
-        auto* kv = event->mutable_kv();
-        *kv = new_kv;
         if (watch_node.second.need_prev_kv) {
-          auto* old_kv = event->mutable_prev_kv();
-          *old_kv = prev_kv;
+          if (!has_event_with_prev_kv) {
+            shared_event_with_prev_kv = shared_event;
+            *shared_event_with_prev_kv.mutable_prev_kv() = prev_kv;
+            has_event_with_prev_kv = true;
+          }
+          *response->add_events() = shared_event_with_prev_kv;
+        } else {
+          *response->add_events() = shared_event;
         }
       }
     }
@@ -348,10 +362,13 @@ butil::Status KvControl::TriggerOneWatch(const std::string& key, pb::version::Ev
 
     done_list.push_back(closure_id);
 
-    DINGO_LOG(INFO) << "TriggerOneWatch success, key:" << key << ", event_type:" << event_type
-                    << ", closure_id:" << closure_id;
+    DINGO_LOG_IF(INFO, FLAGS_dingo_log_switch_coor_watch)
+        << "TriggerOneWatch success, key:" << key << ", event_type:" << event_type << ", closure_id:" << closure_id;
   }
 
+  DINGO_LOG(INFO) << "TriggerOneWatch, key:" << key << ", event_type:" << event_type
+                  << ", notify watcher count:" << done_list.size();
+
   for (auto& closure_id : done_list) {
     auto ret = RemoveOneTimeWatchWithLock(closure_id);
     if (ret.ok()) {
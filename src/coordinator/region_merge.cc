@@ -0,0 +1,194 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "coordinator/region_merge.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <vector>
+
+#include "butil/status.h"
+#include "common/constant.h"
+#include "common/context.h"
+#include "common/helper.h"
+#include "common/logging.h"
+#include "common/synchronization.h"
+#include "engine/write_data.h"
+#include "fmt/core.h"
+#include "gflags/gflags.h"
+#include "proto/common.pb.h"
+#include "proto/coordinator_internal.pb.h"
+#include "proto/error.pb.h"
+
+namespace dingodb {
+
+DEFINE_bool(enable_region_merge, false, "enable merge adjacent small region");
+
+DEFINE_int64(region_merge_max_size, 16 * 1024 * 1024, "region merge max size of region which can be merged");
+
+DEFINE_int64(region_merge_max_merged_size, 64 * 1024 * 1024, "region merge max size of region after merged");
+
+DEFINE_int64(region_merge_min_age_s, 3600, "region merge min age of region, avoid merge region just split");
+
+DEFINE_uint32(region_merge_task_batch_size, 4, "region merge task batch size");
+
+namespace balance {
+
+butil::Status RegionMergeScheduler::LaunchRegionMerge(std::shared_ptr<CoordinatorControl> coordinator_controller,
+                                                      std::shared_ptr<Engine> raft_engine, bool dryrun,
+                                                      std::vector<MergeRegionTask>& tasks) {
+  if (!FLAGS_enable_region_merge) {
+    return butil::Status(pb::error::EINTERNAL, "region merge is disabled.");
+  }
+
+  // not allow parallel running
+  static std::atomic<bool> is_running = false;
+  if (is_running.load()) {
+    return butil::Status(pb::error::EINTERNAL, "already exist region merge running.");
+  }
+  is_running.store(true);
+  DEFER(is_running.store(false));
+
+  DINGO_LOG(INFO) << fmt::format("[balance.merge] launch region merge dryrun({})", dryrun);
+
+  auto region_merge_scheduler = std::make_shared<RegionMergeScheduler>(coordinator_controller, raft_engine);
+
+  pb::common::RegionMap region_map;
+  coordinator_controller->GetRegionMapFull(region_map);
+  if (region_map.regions().empty()) {
+    return butil::Status(pb::error::EINTERNAL, "region map is empty");
+  }
+
+  tasks = Schedule(region_map, region_merge_scheduler->GetRegionSizes(region_map));
+  if (tasks.empty() || dryrun) {
+    return butil::Status::OK();
+  }
+
+  for (const auto& task : tasks) {
+    auto status = region_merge_scheduler->CommitMergeRegionTask(task);
+    if (!status.ok()) {
+      DINGO_LOG(WARNING) << fmt::format("[balance.merge] merge region {} to {} failed, error: {}",
+                                        task.source_region_id, task.target_region_id, status.error_str());
+    }
+  }
+
+  return butil::Status::OK();
+}
+
+std::map<int64_t, int64_t> RegionMergeScheduler::GetRegionSizes(const pb::common::RegionMap& region_map) {
+  std::map<int64_t, int64_t> region_sizes;
+  for (const auto& region : region_map.regions()) {
+    auto region_metrics = coordinator_controller_->GetRegionMetrics(region.id());
+    if (region_metrics.id() == 0) {
+      continue;
+    }
+
+    region_sizes[region.id()] = region_metrics.region_size();
+  }
+
+  return region_sizes;
+}
+
+static bool IsMergeable(const pb::common::Region& left, const pb::common::Region& right) {
+  const auto& left_definition = left.definition();
+  const auto& right_definition = right.definition();
+
+  return left.region_type() == right.region_type() &&
+         left_definition.range().end_key() == right_definition.range().start_key() &&
+         left_definition.part_id() == right_definition.part_id() &&
+         left_definition.store_engine() == right_definition.store_engine() &&
+         left_definition.raw_engine() == right_definition.raw_engine() &&
+         !Helper::IsDifferencePeers(left_definition, right_definition);
+}
+
+// 1. candidate region: normal state, old enough, size not exceed region_merge_max_size
+// 2. sort candidate region by range, merge right region into left region when adjacent and compatible
+// 3. every region is merged at most once a round, chained small regions are merged in next rounds
+std::vector<MergeRegionTask> RegionMergeScheduler::Schedule(const pb::common::RegionMap& region_map,
+                                                            const std::map<int64_t, int64_t>& region_sizes) {
+  int64_t now_ms = Helper::TimestampMs();
+
+  std::vector<const pb::common::Region*> candidate_regions;
+  for (const auto& region : region_map.regions()) {
+    if (region.state() != pb::common::REGION_NORMAL) {
+      continue;
+    }
+    if (region.create_timestamp() > 0 && now_ms - region.create_timestamp() < FLAGS_region_merge_min_age_s * 1000) {
+      continue;
+    }
+    auto it = region_sizes.find(region.id());
+    if (it == region_sizes.end() || it->second > FLAGS_region_merge_max_size) {
+      continue;
+    }
+
+    candidate_regions.push_back(&region);
+  }
+
+  std::sort(candidate_regions.begin(), candidate_regions.end(), [](const auto* lhs, const auto* rhs) {
+    if (lhs->region_type() != rhs->region_type()) {
+      return lhs->region_type() < rhs->region_type();
+    }
+    return lhs->definition().range().start_key() < rhs->definition().range().start_key();
+  });
+
+  std::vector<MergeRegionTask> tasks;
+  for (size_t i = 1; i < candidate_regions.size() && tasks.size() < FLAGS_region_merge_task_batch_size; ++i) {
+    const auto& left = *candidate_regions[i - 1];
+    const auto& right = *candidate_regions[i];
+    if (!tasks.empty() && tasks.back().source_region_id == left.id()) {
+      continue;
+    }
+    if (!IsMergeable(left, right)) {
+      continue;
+    }
+
+    int64_t left_size = region_sizes.at(left.id());
+    int64_t right_size = region_sizes.at(right.id());
+    if (left_size + right_size > FLAGS_region_merge_max_merged_size) {
+      continue;
+    }
+
+    tasks.push_back({right.id(), left.id(), right_size, left_size});
+  }
+
+  return tasks;
+}
+
+butil::Status RegionMergeScheduler::CommitMergeRegionTask(const MergeRegionTask& task) {
+  DINGO_LOG(INFO) << fmt::format("[balance.merge] merge region {}({}) to {}({})", task.source_region_id,
+                                 task.source_region_size, task.target_region_id, task.target_region_size);
+
+  pb::coordinator_internal::MetaIncrement meta_increment;
+  auto status =
+      coordinator_controller_->MergeRegionWithTaskList(task.source_region_id, task.target_region_id, meta_increment);
+  if (!status.ok()) {
+    return status;
+  }
+
+  if (meta_increment.ByteSizeLong() == 0) {
+    return butil::Status::OK();
+  }
+
+  std::shared_ptr<Context> ctx = std::make_shared<Context>();
+  ctx->SetRegionId(Constant::kMetaRegionId);
+
+  return raft_engine_->Write(ctx, WriteDataBuilder::BuildWrite(ctx->CfName(), meta_increment));
+}
+
+}  // namespace balance
+
+}  // namespace dingodb
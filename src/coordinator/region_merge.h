@@ -0,0 +1,72 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_REGION_MERGE_H_
+#define DINGODB_REGION_MERGE_H_
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <vector>
+
+#include "butil/status.h"
+#include "coordinator/coordinator_control.h"
+#include "proto/common.pb.h"
+
+namespace dingodb {
+
+namespace balance {
+
+// merge region task descriptor, source region is merged into target region
+struct MergeRegionTask {
+  int64_t source_region_id;
+  int64_t target_region_id;
+  int64_t source_region_size;
+  int64_t target_region_size;
+};
+
+// Find adjacent undersized regions and merge them, cut the per-region overhead(raft group, heartbeat, index wrapper)
+// left by ttl deletion and table drop.
+class RegionMergeScheduler {
+ public:
+  RegionMergeScheduler(std::shared_ptr<CoordinatorControl> coordinator_controller, std::shared_ptr<Engine> raft_engine)
+      : coordinator_controller_(coordinator_controller), raft_engine_(raft_engine){};
+  ~RegionMergeScheduler() = default;
+
+  // launch region merge schedule
+  // only one schedule is allowed run at a time
+  static butil::Status LaunchRegionMerge(std::shared_ptr<CoordinatorControl> coordinator_controller,
+                                         std::shared_ptr<Engine> raft_engine, bool dryrun,
+                                         std::vector<MergeRegionTask>& tasks);
+
+  // generate merge region tasks
+  // region_sizes: region_id -> approximate size, region without metrics is absent
+  static std::vector<MergeRegionTask> Schedule(const pb::common::RegionMap& region_map,
+                                               const std::map<int64_t, int64_t>& region_sizes);
+
+ private:
+  std::map<int64_t, int64_t> GetRegionSizes(const pb::common::RegionMap& region_map);
+
+  // commit one merge task list to raft
+  butil::Status CommitMergeRegionTask(const MergeRegionTask& task);
+
+  std::shared_ptr<CoordinatorControl> coordinator_controller_;
+  std::shared_ptr<Engine> raft_engine_;
+};
+
+}  // namespace balance
+
+}  // namespace dingodb
+
+#endif  // DINGODB_REGION_MERGE_H_
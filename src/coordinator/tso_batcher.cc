@@ -0,0 +1,74 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "coordinator/tso_batcher.h"
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <utility>
+
+#include "glog/logging.h"
+
+namespace dingodb {
+
+TsoBatcher::TsoBatcher(FetchFunc fetch_func, int64_t max_batch_count)
+    : fetch_func_(std::move(fetch_func)), max_batch_count_(max_batch_count > 0 ? max_batch_count : 1) {
+  CHECK(fetch_func_ != nullptr) << "fetch_func is nullptr.";
+}
+
+butil::Status TsoBatcher::GetTso(int64_t& tso) {
+  std::unique_lock<bthread::Mutex> lock(mutex_);
+
+  // join the last waiting batch, or open a new one
+  if (batches_.empty() || batches_.back()->sent || batches_.back()->count >= max_batch_count_) {
+    batches_.push_back(std::make_shared<Batch>());
+  }
+  auto batch = batches_.back();
+  int64_t index = batch->count++;
+
+  while (!batch->done) {
+    if (!in_flight_ && batches_.front() == batch) {
+      // lead the batch, no one can join it after sent
+      batch->sent = true;
+      in_flight_ = true;
+      int64_t count = batch->count;
+      ++fetch_count_;
+
+      lock.unlock();
+      int64_t start_ts = 0;
+      auto status = fetch_func_(count, start_ts);
+      lock.lock();
+
+      batch->status = status;
+      batch->start_ts = start_ts;
+      batch->done = true;
+      batches_.pop_front();
+      in_flight_ = false;
+      cond_.notify_all();
+      break;
+    }
+
+    cond_.wait(lock);
+  }
+
+  if (!batch->status.ok()) {
+    return batch->status;
+  }
+
+  tso = batch->start_ts + index;
+  return butil::Status::OK();
+}
+
+}  // namespace dingodb
@@ -0,0 +1,71 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_COORDINATOR_TSO_BATCHER_H_
+#define DINGODB_COORDINATOR_TSO_BATCHER_H_
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+
+#include "bthread/condition_variable.h"
+#include "bthread/mutex.h"
+#include "butil/status.h"
+
+namespace dingodb {
+
+// Coalesce the concurrent tso waiters into one in flight request.
+// The waiters arrive while a request is in flight join the next batch, which is sent by one of them as soon as
+// the in flight request is done, so at most one request is in flight and its count is the number of the waiters.
+// The timestamps are never cached, each one is allocated after its caller arrived.
+class TsoBatcher {
+ public:
+  // Fetch count timestamps, set the first one to start_ts, the others are start_ts + 1 ... start_ts + count - 1.
+  using FetchFunc = std::function<butil::Status(int64_t count, int64_t& start_ts)>;
+
+  TsoBatcher(FetchFunc fetch_func, int64_t max_batch_count);
+  ~TsoBatcher() = default;
+
+  TsoBatcher(const TsoBatcher&) = delete;
+  TsoBatcher& operator=(const TsoBatcher&) = delete;
+
+  butil::Status GetTso(int64_t& tso);
+
+  int64_t FetchCount() const { return fetch_count_; }
+
+ private:
+  struct Batch {
+    int64_t count{0};
+    bool sent{false};
+    bool done{false};
+    butil::Status status;
+    int64_t start_ts{0};
+  };
+  using BatchPtr = std::shared_ptr<Batch>;
+
+  FetchFunc fetch_func_;
+  int64_t max_batch_count_;
+
+  bthread::Mutex mutex_;
+  bthread::ConditionVariable cond_;
+  // The front batch is in flight when in_flight_ is true, the others are waiting.
+  std::deque<BatchPtr> batches_;
+  bool in_flight_{false};
+  int64_t fetch_count_{0};
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_COORDINATOR_TSO_BATCHER_H_
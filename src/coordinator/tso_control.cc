@@ -26,6 +26,7 @@
 #include "common/logging.h"
 #include "common/synchronization.h"
 #include "engine/snapshot.h"
+#include "fmt/core.h"
 #include "proto/coordinator_internal.pb.h"
 #include "proto/error.pb.h"
 #include "proto/meta.pb.h"
@@ -137,11 +138,17 @@ int TsoControl::SyncTimestamp(const pb::meta::TsoTimestamp& current_timestamp, i
 void TsoControl::GenTso(const pb::meta::TsoRequest* request, pb::meta::TsoResponse* response) {
   int64_t count = request->count();
   response->set_op_type(request->op_type());
-  if (count == 0) {
+  if (count <= 0) {
     response->mutable_error()->set_errcode(pb::error::Errno::EILLEGAL_PARAMTETERS);
     response->mutable_error()->set_errmsg("tso count should be positive");
     return;
   }
+  // a batch never fit in the logical part of one physical
+  if (count >= kMaxLogical) {
+    response->mutable_error()->set_errcode(pb::error::Errno::EILLEGAL_PARAMTETERS);
+    response->mutable_error()->set_errmsg(fmt::format("tso count should be less than {}", kMaxLogical));
+    return;
+  }
   if (!is_healty_) {
     DINGO_LOG(ERROR) << "TSO has wrong status, retry later";
     response->mutable_error()->set_errcode(pb::error::Errno::ERETRY_LATER);
@@ -181,7 +188,7 @@ void TsoControl::GenTso(const pb::meta::TsoRequest* request, pb::meta::TsoRespon
     DINGO_LOG(ERROR) << "gen tso failed";
     return;
   }
-  DINGO_LOG(INFO) << "gen tso current: (" << current.physical() << ", " << current.logical() << ")";
+  DINGO_LOG(DEBUG) << "gen tso current: (" << current.physical() << ", " << current.logical() << "), count: " << count;
   auto* timestamp = response->mutable_start_timestamp();
   *timestamp = current;
   response->set_count(count);
@@ -0,0 +1,64 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "coordinator/tso_proxy.h"
+
+#include <cstdint>
+#include <utility>
+
+#include "common/helper.h"
+#include "common/logging.h"
+#include "fmt/core.h"
+#include "proto/error.pb.h"
+
+namespace dingodb {
+
+TsoProxy::TsoProxy(FetchFunc fetch_func, int64_t window_size, int64_t lease_ms)
+    : fetch_func_(std::move(fetch_func)), window_size_(window_size > 0 ? window_size : 1), lease_ms_(lease_ms) {
+  CHECK(fetch_func_ != nullptr) << "fetch_func is nullptr.";
+}
+
+butil::Status TsoProxy::GetTso(int64_t& tso) {
+  BAIDU_SCOPED_LOCK(mutex_);
+
+  if (next_ts_ >= end_ts_ || Helper::TimestampMs() >= expire_ms_) {
+    // the lease start before the window is allocated
+    int64_t now_ms = Helper::TimestampMs();
+    int64_t start_ts = 0;
+    ++fetch_count_;
+    auto status = fetch_func_(window_size_, start_ts);
+    if (!status.ok()) {
+      return status;
+    }
+    if (start_ts <= last_ts_) {
+      DINGO_LOG(ERROR) << fmt::format("[tso_proxy] tso fallback, start_ts: {}, last_ts: {}", start_ts, last_ts_);
+      return butil::Status(pb::error::Errno::EINTERNAL, "tso fallback");
+    }
+
+    next_ts_ = start_ts;
+    end_ts_ = start_ts + window_size_;
+    expire_ms_ = now_ms + lease_ms_;
+  }
+
+  tso = next_ts_++;
+  last_ts_ = tso;
+  return butil::Status::OK();
+}
+
+int64_t TsoProxy::FetchCount() {
+  BAIDU_SCOPED_LOCK(mutex_);
+  return fetch_count_;
+}
+
+}  // namespace dingodb
@@ -0,0 +1,61 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_COORDINATOR_TSO_PROXY_H_
+#define DINGODB_COORDINATOR_TSO_PROXY_H_
+
+#include <cstdint>
+#include <functional>
+
+#include "bthread/mutex.h"
+#include "butil/status.h"
+
+namespace dingodb {
+
+// Local tso proxy, serve timestamps from a leased window pre-allocated from coordinator tso service.
+// The served timestamps are strictly increasing, but may be allocated up to lease_ms before the caller arrived,
+// so it is only for the internal callers which need a lower bound of the current tso, e.g. resolved ts.
+// It must not be used for commit ts, which must be greater than every timestamp allocated before.
+class TsoProxy {
+ public:
+  // Fetch count timestamps, set the first one to start_ts.
+  using FetchFunc = std::function<butil::Status(int64_t count, int64_t& start_ts)>;
+
+  TsoProxy(FetchFunc fetch_func, int64_t window_size, int64_t lease_ms);
+  ~TsoProxy() = default;
+
+  TsoProxy(const TsoProxy&) = delete;
+  TsoProxy& operator=(const TsoProxy&) = delete;
+
+  butil::Status GetTso(int64_t& tso);
+
+  int64_t FetchCount();
+
+ private:
+  FetchFunc fetch_func_;
+  int64_t window_size_;
+  int64_t lease_ms_;
+
+  bthread::Mutex mutex_;
+  // The window is [next_ts_, end_ts_), valid before expire_ms_.
+  int64_t next_ts_{0};
+  int64_t end_ts_{0};
+  int64_t expire_ms_{0};
+  int64_t last_ts_{0};
+  int64_t fetch_count_{0};
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_COORDINATOR_TSO_PROXY_H_
@@ -14,114 +14,153 @@
 
 #include "coprocessor/aggregation.h"
 
+#include <algorithm>
 #include <cstdint>
+#include <functional>
 #include <memory>
 #include <optional>
 #include <string>
+#include <utility>
 
 #include "common/logging.h"
 #include "fmt/core.h"
+#include "proto/error.pb.h"
 #include "proto/store.pb.h"
 
 namespace dingodb {
 
-Aggregation::Aggregation() = default;
-Aggregation::~Aggregation() { Close(); }
-
-butil::Status Aggregation::Open(
-    size_t start_aggregation_operators_index,
-    const std::shared_ptr<std::vector<std::shared_ptr<BaseSchema>>>& result_serial_schemas,
-    const ::google::protobuf::RepeatedPtrField<pb::store::AggregationOperator>& aggregation_operators) {
-  butil::Status status;
-
-  result_record_ = std::make_shared<std::vector<std::any>>();
-
-  result_record_->reserve((*result_serial_schemas).size() - start_aggregation_operators_index);
-  size_t j = 0;
-  for (size_t i = start_aggregation_operators_index;
-       i < result_serial_schemas->size() && j < aggregation_operators.size(); i++, j++) {
-    auto type = (*result_serial_schemas)[i]->GetType();
-    auto oper = aggregation_operators[j].oper();
-
-    switch (type) {
-      case BaseSchema::Type::kBool: {
-        if (pb::store::COUNT == oper || pb::store::COUNTWITHNULL == oper || pb::store::SUM0 == oper) {
-          result_record_->emplace_back(std::optional<bool>(false));
-        } else {
-          result_record_->emplace_back(std::optional<bool>(std::nullopt));
-        }
-        break;
-      }
-      case BaseSchema::Type::kInteger: {
-        if (pb::store::COUNT == oper || pb::store::COUNTWITHNULL == oper || pb::store::SUM0 == oper) {
-          result_record_->emplace_back(std::optional<int32_t>(0));
-        } else {
-          result_record_->emplace_back(std::optional<int32_t>(std::nullopt));
-        }
-        break;
-      }
-      case BaseSchema::Type::kFloat: {
-        if (pb::store::COUNT == oper || pb::store::COUNTWITHNULL == oper || pb::store::SUM0 == oper) {
-          result_record_->emplace_back(std::optional<float>(0.0f));
-        } else {
-          result_record_->emplace_back(std::optional<float>(std::nullopt));
-        }
-        break;
-      }
-      case BaseSchema::Type::kLong: {
-        if (pb::store::COUNT == oper || pb::store::COUNTWITHNULL == oper || pb::store::SUM0 == oper) {
-          result_record_->emplace_back(std::optional<int64_t>(0));
-        } else {
-          result_record_->emplace_back(std::optional<int64_t>(std::nullopt));
-        }
-        break;
-      }
-      case BaseSchema::Type::kDouble: {
-        if (pb::store::COUNT == oper || pb::store::COUNTWITHNULL == oper || pb::store::SUM0 == oper) {
-          result_record_->emplace_back(std::optional<double>(0.0));
-        } else {
-          result_record_->emplace_back(std::optional<double>(std::nullopt));
-        }
-        break;
-      }
-      case BaseSchema::Type::kString: {
-        if (pb::store::COUNT == oper || pb::store::COUNTWITHNULL == oper || pb::store::SUM0 == oper) {
-          result_record_->emplace_back(std::optional<std::shared_ptr<std::string>>(std::make_shared<std::string>()));
-        } else {
-          result_record_->emplace_back(std::optional<std::shared_ptr<std::string>>(std::nullopt));
-        }
-        break;
-      }
-      default: {
-        std::string error_message = fmt::format("unsupported serial_schema1 type: {}", static_cast<int>(type));
-        DINGO_LOG(ERROR) << error_message;
-        return butil::Status(pb::error::EILLEGAL_PARAMTETERS, error_message);
-      }
+static constexpr size_t kAggregationHashTableInitSlotNum = 64;
+
+AggregationHashTable::AggregationHashTable(std::vector<AggregationState> init_states)
+    : init_states_(std::move(init_states)) {
+  slots_.resize(kAggregationHashTableInitSlotNum, 0);
+}
+
+AggregationState* AggregationHashTable::FindOrInsert(const std::string& key) {
+  size_t hash = std::hash<std::string_view>()(key);
+  size_t mask = slots_.size() - 1;
+  size_t pos = hash & mask;
+  while (slots_[pos] != 0) {
+    uint32_t group = slots_[pos] - 1;
+    const auto& group_info = groups_[group];
+    if (group_info.hash == hash && GetKey(group) == key) {
+      return &states_[group * init_states_.size()];
     }
+    pos = (pos + 1) & mask;
   }
 
-  return butil::Status();
+  // insert, keep load factor not greater than 0.5
+  uint32_t group = groups_.size();
+  groups_.push_back(Group{key_buffer_.size(), key.size(), hash});
+  key_buffer_.append(key);
+  states_.insert(states_.end(), init_states_.begin(), init_states_.end());
+  slots_[pos] = group + 1;
+
+  if (groups_.size() * 2 > slots_.size()) {
+    Rehash(slots_.size() * 2);
+  }
+
+  return &states_[group * init_states_.size()];
+}
+
+std::string_view AggregationHashTable::GetKey(size_t group) const {
+  const auto& group_info = groups_[group];
+  return std::string_view(key_buffer_.data() + group_info.key_offset, group_info.key_size);
 }
 
-butil::Status Aggregation::Execute(
-    const std::vector<std::function<bool(const std::any&, std::any*)>>& aggregation_functions,
-    const std::vector<std::any>& group_by_operator_record) {
-  bool ret = false;
-  for (size_t i = 0; i < group_by_operator_record.size(); i++) {
-    ret = aggregation_functions[i](group_by_operator_record[i], &(*result_record_)[i]);
-    if (!ret) {
-      std::string error_message = fmt::format("Execute failed index :  {}", i);
+const AggregationState* AggregationHashTable::GetStates(size_t group) const {
+  return &states_[group * init_states_.size()];
+}
+
+std::vector<uint32_t> AggregationHashTable::SortedGroups() const {
+  std::vector<uint32_t> groups(groups_.size());
+  for (uint32_t i = 0; i < groups.size(); ++i) {
+    groups[i] = i;
+  }
+  std::sort(groups.begin(), groups.end(), [this](uint32_t lhs, uint32_t rhs) { return GetKey(lhs) < GetKey(rhs); });
+  return groups;
+}
+
+void AggregationHashTable::Rehash(size_t slot_num) {
+  slots_.assign(slot_num, 0);
+  size_t mask = slot_num - 1;
+  for (uint32_t group = 0; group < groups_.size(); ++group) {
+    size_t pos = groups_[group].hash & mask;
+    while (slots_[pos] != 0) {
+      pos = (pos + 1) & mask;
+    }
+    slots_[pos] = group + 1;
+  }
+}
+
+butil::Status GenAggregationInitState(BaseSchema::Type type, pb::store::AggregationType oper,
+                                      AggregationState& state) {
+  // count and sum0 start from zero, others start from null
+  bool zero = (pb::store::COUNT == oper || pb::store::COUNTWITHNULL == oper || pb::store::SUM0 == oper);
+
+  state = AggregationState();
+  state.has_value = zero;
+  switch (type) {
+    case BaseSchema::Type::kBool:
+      state.bool_value = false;
+      break;
+    case BaseSchema::Type::kInteger:
+      state.int_value = 0;
+      break;
+    case BaseSchema::Type::kFloat:
+      state.float_value = 0.0f;
+      break;
+    case BaseSchema::Type::kLong:
+      state.long_value = 0;
+      break;
+    case BaseSchema::Type::kDouble:
+      state.double_value = 0.0;
+      break;
+    case BaseSchema::Type::kString:
+      if (zero) {
+        state.string_value = std::make_shared<std::string>();
+      }
+      break;
+    default: {
+      std::string error_message = fmt::format("unsupported serial_schema1 type: {}", static_cast<int>(type));
       DINGO_LOG(ERROR) << error_message;
       return butil::Status(pb::error::EILLEGAL_PARAMTETERS, error_message);
     }
   }
+
   return butil::Status();
 }
 
-void Aggregation::Close() {
-  if (result_record_) {
-    result_record_.reset();
+butil::Status TransAggregationState(BaseSchema::Type type, const AggregationState& state,
+                                    std::vector<std::any>& columns) {
+  switch (type) {
+    case BaseSchema::Type::kBool:
+      columns.emplace_back(state.has_value ? std::optional<bool>(state.bool_value) : std::nullopt);
+      break;
+    case BaseSchema::Type::kInteger:
+      columns.emplace_back(state.has_value ? std::optional<int32_t>(state.int_value) : std::nullopt);
+      break;
+    case BaseSchema::Type::kFloat:
+      columns.emplace_back(state.has_value ? std::optional<float>(state.float_value) : std::nullopt);
+      break;
+    case BaseSchema::Type::kLong:
+      columns.emplace_back(state.has_value ? std::optional<int64_t>(state.long_value) : std::nullopt);
+      break;
+    case BaseSchema::Type::kDouble:
+      columns.emplace_back(state.has_value ? std::optional<double>(state.double_value) : std::nullopt);
+      break;
+    case BaseSchema::Type::kString:
+      columns.emplace_back(state.has_value ? std::optional<std::shared_ptr<std::string>>(state.string_value)
+                                           : std::nullopt);
+      break;
+    default: {
+      std::string error_message = fmt::format("unsupported serial_schema1 type: {}", static_cast<int>(type));
+      DINGO_LOG(ERROR) << error_message;
+      return butil::Status(pb::error::EILLEGAL_PARAMTETERS, error_message);
+    }
   }
+
+  return butil::Status();
 }
 
 }  // namespace dingodb
@@ -18,8 +18,11 @@
 #include <serial/schema/base_schema.h>
 
 #include <any>
-#include <functional>
+#include <cstddef>
+#include <cstdint>
 #include <memory>
+#include <string>
+#include <string_view>
 #include <vector>
 
 #include "butil/status.h"
@@ -27,31 +30,76 @@
 
 namespace dingodb {
 
-class Aggregation {
+// Aggregate state of one aggregation operator of one group, the member in use is decided by the result schema type.
+struct AggregationState {
+  AggregationState() : long_value(0) {}
+
+  bool has_value{false};
+  union {
+    bool bool_value;
+    int32_t int_value;
+    float float_value;
+    int64_t long_value;
+    double double_value;
+  };
+  std::shared_ptr<std::string> string_value;
+};
+
+// Typed aggregation function chosen at open, update the state with the param column.
+using AggregationFunction = bool (*)(const std::any& param, AggregationState& state);
+
+// Map group by key to the aggregate states of the group.
+// Open addressing with linear probing, the keys are appended to one buffer and the states of all groups are in one
+// vector, so a new group cost no allocation besides the amortized growth.
+class AggregationHashTable {
  public:
-  Aggregation();
-  ~Aggregation();
+  // init_states is the states of a new group, one for each aggregation operator.
+  explicit AggregationHashTable(std::vector<AggregationState> init_states);
+  ~AggregationHashTable() = default;
 
-  Aggregation(const Aggregation& rhs) = delete;
-  Aggregation& operator=(const Aggregation& rhs) = delete;
-  Aggregation(Aggregation&& rhs) = delete;
-  Aggregation& operator=(Aggregation&& rhs) = delete;
+  AggregationHashTable(const AggregationHashTable& rhs) = delete;
+  AggregationHashTable& operator=(const AggregationHashTable& rhs) = delete;
+  AggregationHashTable(AggregationHashTable&& rhs) = delete;
+  AggregationHashTable& operator=(AggregationHashTable&& rhs) = delete;
 
-  butil::Status Open(size_t start_aggregation_operators_index,
-                     const std::shared_ptr<std::vector<std::shared_ptr<BaseSchema>>>& result_serial_schemas,
-                     const ::google::protobuf::RepeatedPtrField<pb::store::AggregationOperator>& aggregation_operators);
+  // Return the states of the group, insert the group with init states if not exist.
+  // The returned pointer is invalid after next insert.
+  AggregationState* FindOrInsert(const std::string& key);
 
-  butil::Status Execute(const std::vector<std::function<bool(const std::any&, std::any*)>>& aggregation_functions,
-                        const std::vector<std::any>& group_by_operator_record);
+  size_t Size() const { return groups_.size(); }
+  size_t StateNum() const { return init_states_.size(); }
 
-  const std::shared_ptr<std::vector<std::any>>& GetResult() const { return result_record_; }
+  std::string_view GetKey(size_t group) const;
+  const AggregationState* GetStates(size_t group) const;
 
-  void Close();
+  // Group indexes in key order.
+  std::vector<uint32_t> SortedGroups() const;
 
  private:
-  std::shared_ptr<std::vector<std::any>> result_record_;
+  struct Group {
+    size_t key_offset;
+    size_t key_size;
+    size_t hash;
+  };
+
+  void Rehash(size_t slot_num);
+
+  std::vector<AggregationState> init_states_;
+  std::string key_buffer_;
+  std::vector<Group> groups_;
+  std::vector<AggregationState> states_;
+  // value is group index + 1, 0 is empty, size is power of 2.
+  std::vector<uint32_t> slots_;
 };
 
+// Build the init state of a new group for the result schema type and aggregation operator.
+butil::Status GenAggregationInitState(BaseSchema::Type type, pb::store::AggregationType oper,
+                                      AggregationState& state);  // NOLINT
+
+// Trans the state to std::optional<T> of the result schema type.
+butil::Status TransAggregationState(BaseSchema::Type type, const AggregationState& state,
+                                    std::vector<std::any>& columns);  // NOLINT
+
 }  // namespace dingodb
 
 #endif  // DINGODB_COPROCESSOR_AGGREGATION_H_  // NOLINT
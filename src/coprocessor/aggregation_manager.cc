@@ -15,208 +15,189 @@
 #include "coprocessor/aggregation_manager.h"
 
 #include <cstdint>
-#include <exception>
 #include <memory>
 #include <optional>
 #include <string>
 #include <type_traits>
+#include <typeinfo>
 #include <utility>
 
 #include "common/logging.h"
 #include "fmt/core.h"
+#include "proto/error.pb.h"
 #include "proto/store.pb.h"
 
 namespace dingodb {
 
-template <typename PARAM, typename RESULT>
-struct SUM {
-  bool operator()(const std::any& param, std::any* result) {
-    static_assert(
-        !(std::is_same_v<std::string, PARAM> || std::is_same_v<std::string, RESULT> ||
-          std::is_same_v<std::shared_ptr<std::string>, PARAM> || std::is_same_v<std::shared_ptr<std::string>, RESULT>),
-        "SUM : unsupported shared_ptr<std::string> or std::string");
-
-    try {
-      const std::optional<PARAM>& param_value = std::any_cast<const std::optional<PARAM>&>(param);
-      std::optional<RESULT>& result_value = std::any_cast<std::optional<RESULT>&>(*result);
-
-      if (param_value.has_value() && !result_value.has_value()) {
-        result_value = param_value;
-      } else if (!param_value.has_value() && !result_value.has_value()) {
-        return true;
-      } else if (!param_value.has_value() && result_value.has_value()) {
-        return true;
-      } else {
-        result_value.value() += param_value.value();
-      }
-    } catch (const std::exception& my_exception) {
-      DINGO_LOG(ERROR) << fmt::format("SUM<{},{}> exception : {}", typeid(PARAM).name(), typeid(RESULT).name(),
-                                      my_exception.what());
-      return false;
-    }
+template <typename T>
+T& StateValue(AggregationState& state);
 
-    return true;
+template <>
+bool& StateValue<bool>(AggregationState& state) {
+  return state.bool_value;
+}
+
+template <>
+int32_t& StateValue<int32_t>(AggregationState& state) {
+  return state.int_value;
+}
+
+template <>
+float& StateValue<float>(AggregationState& state) {
+  return state.float_value;
+}
+
+template <>
+int64_t& StateValue<int64_t>(AggregationState& state) {
+  return state.long_value;
+}
+
+template <>
+double& StateValue<double>(AggregationState& state) {
+  return state.double_value;
+}
+
+template <>
+std::shared_ptr<std::string>& StateValue<std::shared_ptr<std::string>>(AggregationState& state) {
+  return state.string_value;
+}
+
+template <typename T>
+static const std::optional<T>* CastParam(const char* name, const std::any& param) {
+  const auto* param_value = std::any_cast<std::optional<T>>(&param);
+  if (param_value == nullptr) {
+    DINGO_LOG(ERROR) << fmt::format("{}<{}> bad any cast, param type : {}", name, typeid(T).name(),
+                                    param.type().name());
   }
-};
-
-template <typename PARAM, typename RESULT>
-struct COUNT {
-  bool operator()(const std::any& param, std::any* result) {
-    try {
-      const std::optional<PARAM>& param_value = std::any_cast<const std::optional<PARAM>&>(param);
-      std::optional<RESULT>& result_value = std::any_cast<std::optional<RESULT>&>(*result);
-
-      if (param_value.has_value() && !result_value.has_value()) {
-        result_value = 1;
-      } else if (!param_value.has_value() && !result_value.has_value()) {
-        return true;
-      } else if (!param_value.has_value() && result_value.has_value()) {
-        return true;
-      } else {
-        result_value.value() += 1;
-      }
-    } catch (const std::exception& my_exception) {
-      DINGO_LOG(ERROR) << fmt::format("COUNT<{},{}> exception : {}", typeid(PARAM).name(), typeid(RESULT).name(),
-                                      my_exception.what());
-      return false;
-    }
+  return param_value;
+}
 
+template <typename T>
+static bool AggSum(const std::any& param, AggregationState& state) {
+  static_assert(!std::is_same_v<std::shared_ptr<std::string>, T>, "SUM : unsupported shared_ptr<std::string>");
+
+  const auto* param_value = CastParam<T>("SUM", param);
+  if (param_value == nullptr) {
+    return false;
+  }
+  if (!param_value->has_value()) {
     return true;
   }
-};
-
-template <typename PARAM, typename RESULT>
-struct COUNTWITHNULL {
-  bool operator()([[maybe_unused]] const std::any& param, std::any* result) {
-    try {
-      std::optional<RESULT>& result_value = std::any_cast<std::optional<RESULT>&>(*result);
-
-      if (!result_value.has_value()) {
-        result_value = 1;
-      } else {
-        result_value.value() += 1;
-      }
-    } catch (const std::exception& my_exception) {
-      DINGO_LOG(ERROR) << fmt::format("COUNTWITHNULL<{},{}> exception : {}", typeid(PARAM).name(),
-                                      typeid(RESULT).name(), my_exception.what());
-      return false;
-    }
 
+  if (!state.has_value) {
+    StateValue<T>(state) = param_value->value();
+    state.has_value = true;
+  } else {
+    StateValue<T>(state) += param_value->value();
+  }
+  return true;
+}
+
+template <typename T>
+static bool AggCount(const std::any& param, AggregationState& state) {
+  const auto* param_value = CastParam<T>("COUNT", param);
+  if (param_value == nullptr) {
+    return false;
+  }
+  if (!param_value->has_value()) {
     return true;
   }
-};
-
-template <typename PARAM, typename RESULT>
-struct MAX {
-  bool operator()(const std::any& param, std::any* result) {
-    try {
-      const std::optional<PARAM>& param_value = std::any_cast<const std::optional<PARAM>&>(param);
-      std::optional<RESULT>& result_value = std::any_cast<std::optional<RESULT>&>(*result);
-
-      if (param_value.has_value() && !result_value.has_value()) {
-        if constexpr (std::is_same_v<std::shared_ptr<std::string>, PARAM> &&
-                      !std::is_same_v<std::shared_ptr<std::string>, RESULT>) {
-          result_value = *(param_value.value());
-
-        } else if constexpr (!std::is_same_v<std::shared_ptr<std::string>, PARAM> &&  // NOLINT
-                             std::is_same_v<std::shared_ptr<std::string>, RESULT>) {
-          result_value.value() = std::make_shared<std::string>(param_value);
-
-        } else {
-          result_value = param_value;
-        }
 
-      } else if (!param_value.has_value() && !result_value.has_value()) {
-        return true;
-      } else if (!param_value.has_value() && result_value.has_value()) {
-        return true;
-      } else {
-        if constexpr (std::is_same_v<std::shared_ptr<std::string>, PARAM> &&
-                      !std::is_same_v<std::shared_ptr<std::string>, RESULT>) {
-          if (result_value.value() < *(param_value.value())) {
-            result_value = *(param_value.value());
-          }
-        } else if constexpr (std::is_same_v<std::shared_ptr<std::string>, PARAM> &&  // NOLINT
-                             std::is_same_v<std::shared_ptr<std::string>, RESULT>) {
-          if (*(result_value.value()) < *(param_value.value())) {
-            result_value = param_value;
-          }
-        } else if constexpr (!std::is_same_v<std::shared_ptr<std::string>, PARAM> &&  // NOLINT
-                             std::is_same_v<std::shared_ptr<std::string>, RESULT>) {
-          if (*(result_value.value()) < param_value.value()) {
-            *(result_value.value()) = param_value;
-          }
-        } else {
-          if (result_value.value() < param_value.value()) {
-            result_value = param_value;
-          }
-        }
-      }
-    } catch (const std::exception& my_exception) {
-      DINGO_LOG(ERROR) << fmt::format("MAX<{},{}> exception : {}", typeid(PARAM).name(), typeid(RESULT).name(),
-                                      my_exception.what());
-      return false;
-    }
+  if (!state.has_value) {
+    state.long_value = 1;
+    state.has_value = true;
+  } else {
+    state.long_value += 1;
+  }
+  return true;
+}
 
-    return true;
+template <typename T>
+static bool AggCountWithNull([[maybe_unused]] const std::any& param, AggregationState& state) {
+  if (!state.has_value) {
+    state.long_value = 1;
+    state.has_value = true;
+  } else {
+    state.long_value += 1;
   }
-};
-
-template <typename PARAM, typename RESULT>
-struct MIN {
-  bool operator()(const std::any& param, std::any* result) {
-    try {
-      const std::optional<PARAM>& param_value = std::any_cast<const std::optional<PARAM>&>(param);
-      std::optional<RESULT>& result_value = std::any_cast<std::optional<RESULT>&>(*result);
-
-      if (param_value.has_value() && !result_value.has_value()) {
-        if constexpr (std::is_same_v<std::shared_ptr<std::string>, PARAM> &&
-                      !std::is_same_v<std::shared_ptr<std::string>, RESULT>) {
-          result_value = *(param_value.value());
-
-        } else if constexpr (!std::is_same_v<std::shared_ptr<std::string>, PARAM> &&  // NOLINT
-                             std::is_same_v<std::shared_ptr<std::string>, RESULT>) {
-          result_value.value() = std::make_shared<std::string>(param_value);
-
-        } else {
-          result_value = param_value;
-        }
+  return true;
+}
 
-      } else if (!param_value.has_value() && !result_value.has_value()) {
-        return true;
-      } else if (!param_value.has_value() && result_value.has_value()) {
-        return true;
-      } else {
-        if constexpr (std::is_same_v<std::shared_ptr<std::string>, PARAM> &&
-                      !std::is_same_v<std::shared_ptr<std::string>, RESULT>) {
-          if (result_value.value() > *(param_value.value())) {
-            result_value = *(param_value.value());
-          }
-        } else if constexpr (std::is_same_v<std::shared_ptr<std::string>, PARAM> &&  // NOLINT
-                             std::is_same_v<std::shared_ptr<std::string>, RESULT>) {
-          if (*(result_value.value()) > *(param_value.value())) {
-            result_value = param_value;
-          }
-        } else if constexpr (!std::is_same_v<std::shared_ptr<std::string>, PARAM> &&  // NOLINT
-                             std::is_same_v<std::shared_ptr<std::string>, RESULT>) {
-          if (*(result_value.value()) > param_value.value()) {
-            *(result_value.value()) = param_value;
-          }
-        } else {
-          if (result_value.value() > param_value.value()) {
-            result_value = param_value;
-          }
-        }
-      }
-    } catch (const std::exception& my_exception) {
-      DINGO_LOG(ERROR) << fmt::format("MIN<{},{}> exception : {}", typeid(PARAM).name(), typeid(RESULT).name(),
-                                      my_exception.what());
-      return false;
-    }
+// Replace the state with the param if the state is null or less(IS_MAX) / greater(!IS_MAX) than the param.
+template <typename T, bool IS_MAX>
+static bool AggMaxMin(const std::any& param, AggregationState& state) {
+  const auto* param_value = CastParam<T>(IS_MAX ? "MAX" : "MIN", param);
+  if (param_value == nullptr) {
+    return false;
+  }
+  if (!param_value->has_value()) {
+    return true;
+  }
 
+  auto& state_value = StateValue<T>(state);
+  if (!state.has_value) {
+    state_value = param_value->value();
+    state.has_value = true;
     return true;
   }
-};
+
+  bool replace = false;
+  if constexpr (std::is_same_v<std::shared_ptr<std::string>, T>) {
+    replace = IS_MAX ? (*state_value < *(param_value->value())) : (*state_value > *(param_value->value()));
+  } else {
+    replace = IS_MAX ? (state_value < param_value->value()) : (state_value > param_value->value());
+  }
+  if (replace) {
+    state_value = param_value->value();
+  }
+  return true;
+}
+
+template <typename T>
+static bool AggMax(const std::any& param, AggregationState& state) {
+  return AggMaxMin<T, true>(param, state);
+}
+
+template <typename T>
+static bool AggMin(const std::any& param, AggregationState& state) {
+  return AggMaxMin<T, false>(param, state);
+}
+
+AggregationIterator::AggregationIterator(const std::shared_ptr<AggregationHashTable>& aggregations,
+                                         const std::vector<BaseSchema::Type>& result_types)
+    : aggregations_(aggregations), result_types_(result_types) {
+  if (aggregations_) {
+    groups_ = aggregations_->SortedGroups();
+  }
+  Load();
+}
+
+void AggregationIterator::Next() {
+  ++pos_;
+  Load();
+}
+
+void AggregationIterator::Load() {
+  if (pos_ >= groups_.size()) {
+    key_.clear();
+    value_.reset();
+    return;
+  }
+
+  uint32_t group = groups_[pos_];
+  key_ = aggregations_->GetKey(group);
+
+  const AggregationState* states = aggregations_->GetStates(group);
+  value_ = std::make_shared<std::vector<std::any>>();
+  value_->reserve(result_types_.size());
+  for (size_t i = 0; i < result_types_.size(); ++i) {
+    auto status = TransAggregationState(result_types_[i], states[i], *value_);
+    if (!status.ok()) {
+      // the type is checked at open
+      DINGO_LOG(ERROR) << fmt::format("TransAggregationState failed, index : {}", i);
+    }
+  }
+}
 
 AggregationManager::AggregationManager() = default;
 AggregationManager::~AggregationManager() { Close(); }
@@ -314,38 +295,40 @@ butil::Status AggregationManager::Open(
     i++;
   }
 
+  init_states_.resize(aggregation_operators.size());
+  result_types_.reserve(aggregation_operators.size());
+  for (size_t j = 0; j < aggregation_operators.size(); j++) {
+    BaseSchema::Type result_schema_type = (*result_serial_schemas)[j + start_aggregation_operators_index]->GetType();
+    status = GenAggregationInitState(result_schema_type, aggregation_operators[j].oper(), init_states_[j]);
+    if (!status.ok()) {
+      return status;
+    }
+    result_types_.push_back(result_schema_type);
+  }
+
   return butil::Status();
 }
 
 butil::Status AggregationManager::Execute(const std::string& group_by_key,
                                           const std::vector<std::any>& group_by_operator_record) {
-  butil::Status status;
-  std::shared_ptr<Aggregation> aggregation;
+  if (group_by_operator_record.size() > aggregation_functions_.size()) {
+    std::string error_message = fmt::format("Execute failed record size : {} aggregation functions size : {}",
+                                            group_by_operator_record.size(), aggregation_functions_.size());
+    DINGO_LOG(ERROR) << error_message;
+    return butil::Status(pb::error::EILLEGAL_PARAMTETERS, error_message);
+  }
 
   if (!aggregations_) {
-    using MapType = std::map<std::string, std::shared_ptr<Aggregation>>;
-    aggregations_ = std::make_shared<MapType>();
+    aggregations_ = std::make_shared<AggregationHashTable>(init_states_);
   }
 
-  const auto& iter = aggregations_->find(group_by_key);
-  if (iter == aggregations_->end()) {
-    const auto& [iter_new, _] = aggregations_->emplace(group_by_key, std::make_shared<Aggregation>());
-    aggregation = iter_new->second;
-
-    status = aggregation->Open(result_serial_schemas_->size() - group_by_operator_serial_schemas_->size(),
-                               result_serial_schemas_, aggregation_operators_);
-    if (!status.ok()) {
-      DINGO_LOG(ERROR) << fmt::format("Aggregation::Open failed");
-      return status;
+  AggregationState* states = aggregations_->FindOrInsert(group_by_key);
+  for (size_t i = 0; i < group_by_operator_record.size(); i++) {
+    if (!aggregation_functions_[i](group_by_operator_record[i], states[i])) {
+      std::string error_message = fmt::format("Execute failed index :  {}", i);
+      DINGO_LOG(ERROR) << error_message;
+      return butil::Status(pb::error::EILLEGAL_PARAMTETERS, error_message);
     }
-  } else {
-    aggregation = iter->second;
-  }
-
-  status = aggregation->Execute(aggregation_functions_, group_by_operator_record);
-  if (!status.ok()) {
-    DINGO_LOG(ERROR) << fmt::format("Aggregation::Execute failed");
-    return status;
   }
 
   return butil::Status();
@@ -363,6 +346,8 @@ void AggregationManager::Close() {
   }
 
   aggregation_functions_.clear();
+  init_states_.clear();
+  result_types_.clear();
 
   if (aggregations_) {
     aggregations_.reset();
@@ -371,25 +356,30 @@ void AggregationManager::Close() {
 
 std::shared_ptr<AggregationIterator> AggregationManager::CreateIterator() {
   if (!aggregations_) {
-    using MapType = std::map<std::string, std::shared_ptr<Aggregation>>;
-    aggregations_ = std::make_shared<MapType>();
+    aggregations_ = std::make_shared<AggregationHashTable>(init_states_);
   }
-  DINGO_LOG(DEBUG) << "aggregations  size : " << aggregations_->size();
-  return std::make_shared<AggregationIterator>(aggregations_);
+  DINGO_LOG(DEBUG) << "aggregations  size : " << aggregations_->Size();
+  return std::make_shared<AggregationIterator>(aggregations_, result_types_);
+}
+
+std::shared_ptr<AggregationIterator> AggregationManager::Flush() {
+  auto iterator = CreateIterator();
+  aggregations_ = std::make_shared<AggregationHashTable>(init_states_);
+  return iterator;
 }
 
 butil::Status AggregationManager::AddSumFunction(BaseSchema::Type serial_schema_type,
                                                  BaseSchema::Type result_schema_type) {
   if (serial_schema_type == BaseSchema::kBool && result_schema_type == BaseSchema::kBool) {
-    aggregation_functions_.emplace_back(SUM<bool, bool>());
+    aggregation_functions_.emplace_back(&AggSum<bool>);
   } else if (serial_schema_type == BaseSchema::kInteger && result_schema_type == BaseSchema::kInteger) {
-    aggregation_functions_.emplace_back(SUM<int32_t, int32_t>());
+    aggregation_functions_.emplace_back(&AggSum<int32_t>);
   } else if (serial_schema_type == BaseSchema::kFloat && result_schema_type == BaseSchema::kFloat) {
-    aggregation_functions_.emplace_back(SUM<float, float>());
+    aggregation_functions_.emplace_back(&AggSum<float>);
   } else if (serial_schema_type == BaseSchema::kLong && result_schema_type == BaseSchema::kLong) {
-    aggregation_functions_.emplace_back(SUM<int64_t, int64_t>());
+    aggregation_functions_.emplace_back(&AggSum<int64_t>);
   } else if (serial_schema_type == BaseSchema::kDouble && result_schema_type == BaseSchema::kDouble) {
-    aggregation_functions_.emplace_back(SUM<double, double>());
+    aggregation_functions_.emplace_back(&AggSum<double>);
   } else {
     std::string error_message =
         fmt::format("SUM<{},{}>  not support yet", BaseSchema::GetTypeString(serial_schema_type),
@@ -404,17 +394,17 @@ butil::Status AggregationManager::AddSumFunction(BaseSchema::Type serial_schema_
 butil::Status AggregationManager::AddCountFunction(BaseSchema::Type serial_schema_type,
                                                    BaseSchema::Type result_schema_type) {
   if (serial_schema_type == BaseSchema::kBool && result_schema_type == BaseSchema::kLong) {
-    aggregation_functions_.emplace_back(COUNT<bool, int64_t>());
+    aggregation_functions_.emplace_back(&AggCount<bool>);
   } else if (serial_schema_type == BaseSchema::kInteger && result_schema_type == BaseSchema::kLong) {
-    aggregation_functions_.emplace_back(COUNT<int32_t, int64_t>());
+    aggregation_functions_.emplace_back(&AggCount<int32_t>);
   } else if (serial_schema_type == BaseSchema::kFloat && result_schema_type == BaseSchema::kLong) {
-    aggregation_functions_.emplace_back(COUNT<float, int64_t>());
+    aggregation_functions_.emplace_back(&AggCount<float>);
   } else if (serial_schema_type == BaseSchema::kLong && result_schema_type == BaseSchema::kLong) {
-    aggregation_functions_.emplace_back(COUNT<int64_t, int64_t>());
+    aggregation_functions_.emplace_back(&AggCount<int64_t>);
   } else if (serial_schema_type == BaseSchema::kDouble && result_schema_type == BaseSchema::kLong) {
-    aggregation_functions_.emplace_back(COUNT<double, int64_t>());
+    aggregation_functions_.emplace_back(&AggCount<double>);
   } else if (serial_schema_type == BaseSchema::kString && result_schema_type == BaseSchema::kLong) {
-    aggregation_functions_.emplace_back(COUNT<std::shared_ptr<std::string>, int64_t>());
+    aggregation_functions_.emplace_back(&AggCount<std::shared_ptr<std::string>>);
   } else {
     std::string error_message =
         fmt::format("COUNT<{},{}>  not support yet", BaseSchema::GetTypeString(serial_schema_type),
@@ -427,17 +417,17 @@ butil::Status AggregationManager::AddCountFunction(BaseSchema::Type serial_schem
 butil::Status AggregationManager::AddCountWithNullFunction(BaseSchema::Type serial_schema_type,
                                                            BaseSchema::Type result_schema_type) {
   if (serial_schema_type == BaseSchema::kBool && result_schema_type == BaseSchema::kLong) {
-    aggregation_functions_.emplace_back(COUNTWITHNULL<bool, int64_t>());
+    aggregation_functions_.emplace_back(&AggCountWithNull<bool>);
   } else if (serial_schema_type == BaseSchema::kInteger && result_schema_type == BaseSchema::kLong) {
-    aggregation_functions_.emplace_back(COUNTWITHNULL<int32_t, int64_t>());
+    aggregation_functions_.emplace_back(&AggCountWithNull<int32_t>);
   } else if (serial_schema_type == BaseSchema::kFloat && result_schema_type == BaseSchema::kLong) {
-    aggregation_functions_.emplace_back(COUNTWITHNULL<float, int64_t>());
+    aggregation_functions_.emplace_back(&AggCountWithNull<float>);
   } else if (serial_schema_type == BaseSchema::kLong && result_schema_type == BaseSchema::kLong) {
-    aggregation_functions_.emplace_back(COUNTWITHNULL<int64_t, int64_t>());
+    aggregation_functions_.emplace_back(&AggCountWithNull<int64_t>);
   } else if (serial_schema_type == BaseSchema::kDouble && result_schema_type == BaseSchema::kLong) {
-    aggregation_functions_.emplace_back(COUNTWITHNULL<double, int64_t>());
+    aggregation_functions_.emplace_back(&AggCountWithNull<double>);
   } else if (serial_schema_type == BaseSchema::kString && result_schema_type == BaseSchema::kLong) {
-    aggregation_functions_.emplace_back(COUNTWITHNULL<std::shared_ptr<std::string>, int64_t>());
+    aggregation_functions_.emplace_back(&AggCountWithNull<std::shared_ptr<std::string>>);
   } else {
     std::string error_message =
         fmt::format("COUNTWITHNULL<{},{}>  not support yet", BaseSchema::GetTypeString(serial_schema_type),
@@ -450,17 +440,17 @@ butil::Status AggregationManager::AddCountWithNullFunction(BaseSchema::Type seri
 butil::Status AggregationManager::AddMaxFunction(BaseSchema::Type serial_schema_type,
                                                  BaseSchema::Type result_schema_type) {
   if (serial_schema_type == BaseSchema::kBool && result_schema_type == BaseSchema::kBool) {
-    aggregation_functions_.emplace_back(MAX<bool, bool>());
+    aggregation_functions_.emplace_back(&AggMax<bool>);
   } else if (serial_schema_type == BaseSchema::kInteger && result_schema_type == BaseSchema::kInteger) {
-    aggregation_functions_.emplace_back(MAX<int32_t, int32_t>());
+    aggregation_functions_.emplace_back(&AggMax<int32_t>);
   } else if (serial_schema_type == BaseSchema::kFloat && result_schema_type == BaseSchema::kFloat) {
-    aggregation_functions_.emplace_back(MAX<float, float>());
+    aggregation_functions_.emplace_back(&AggMax<float>);
   } else if (serial_schema_type == BaseSchema::kLong && result_schema_type == BaseSchema::kLong) {
-    aggregation_functions_.emplace_back(MAX<int64_t, int64_t>());
+    aggregation_functions_.emplace_back(&AggMax<int64_t>);
   } else if (serial_schema_type == BaseSchema::kDouble && result_schema_type == BaseSchema::kDouble) {
-    aggregation_functions_.emplace_back(MAX<double, double>());
+    aggregation_functions_.emplace_back(&AggMax<double>);
   } else if (serial_schema_type == BaseSchema::kString && result_schema_type == BaseSchema::kString) {
-    aggregation_functions_.emplace_back(MAX<std::shared_ptr<std::string>, std::shared_ptr<std::string>>());
+    aggregation_functions_.emplace_back(&AggMax<std::shared_ptr<std::string>>);
   } else {
     std::string error_message =
         fmt::format("COUNTWITHNULL<{},{}>  not support yet", BaseSchema::GetTypeString(serial_schema_type),
@@ -473,17 +463,17 @@ butil::Status AggregationManager::AddMaxFunction(BaseSchema::Type serial_schema_
 butil::Status AggregationManager::AddMinFunction(BaseSchema::Type serial_schema_type,
                                                  BaseSchema::Type result_schema_type) {
   if (serial_schema_type == BaseSchema::kBool && result_schema_type == BaseSchema::kBool) {
-    aggregation_functions_.emplace_back(MIN<bool, bool>());
+    aggregation_functions_.emplace_back(&AggMin<bool>);
   } else if (serial_schema_type == BaseSchema::kInteger && result_schema_type == BaseSchema::kInteger) {
-    aggregation_functions_.emplace_back(MIN<int32_t, int32_t>());
+    aggregation_functions_.emplace_back(&AggMin<int32_t>);
   } else if (serial_schema_type == BaseSchema::kFloat && result_schema_type == BaseSchema::kFloat) {
-    aggregation_functions_.emplace_back(MIN<float, float>());
+    aggregation_functions_.emplace_back(&AggMin<float>);
   } else if (serial_schema_type == BaseSchema::kLong && result_schema_type == BaseSchema::kLong) {
-    aggregation_functions_.emplace_back(MIN<int64_t, int64_t>());
+    aggregation_functions_.emplace_back(&AggMin<int64_t>);
   } else if (serial_schema_type == BaseSchema::kDouble && result_schema_type == BaseSchema::kDouble) {
-    aggregation_functions_.emplace_back(MIN<double, double>());
+    aggregation_functions_.emplace_back(&AggMin<double>);
   } else if (serial_schema_type == BaseSchema::kString && result_schema_type == BaseSchema::kString) {
-    aggregation_functions_.emplace_back(MIN<std::shared_ptr<std::string>, std::shared_ptr<std::string>>());
+    aggregation_functions_.emplace_back(&AggMin<std::shared_ptr<std::string>>);
   } else {
     std::string error_message =
         fmt::format("COUNTWITHNULL<{},{}>  not support yet", BaseSchema::GetTypeString(serial_schema_type),
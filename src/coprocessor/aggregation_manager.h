@@ -18,8 +18,7 @@
 #include <serial/schema/base_schema.h>
 
 #include <any>
-#include <functional>
-#include <map>
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <vector>
@@ -32,21 +31,26 @@ namespace dingodb {
 
 class AggregationIterator {
  public:
-  explicit AggregationIterator(const std::shared_ptr<std::map<std::string, std::shared_ptr<Aggregation>>>& aggregations)
-      : aggregations_(aggregations) {
-    iter_ = aggregations_->begin();
-  }
+  // Iterate the groups in key order, the result record of a group is built when it is visited.
+  AggregationIterator(const std::shared_ptr<AggregationHashTable>& aggregations,
+                      const std::vector<BaseSchema::Type>& result_types);
 
   ~AggregationIterator() { aggregations_.reset(); }
 
-  bool HasNext() { return (iter_ != aggregations_->end()); }
-  void Next() { ++iter_; }
-  const std::string& GetKey() const { return iter_->first; }
-  const std::shared_ptr<std::vector<std::any>>& GetValue() const { return iter_->second->GetResult(); }
+  bool HasNext() { return (pos_ < groups_.size()); }
+  void Next();
+  const std::string& GetKey() const { return key_; }
+  const std::shared_ptr<std::vector<std::any>>& GetValue() const { return value_; }
 
  private:
-  std::shared_ptr<std::map<std::string, std::shared_ptr<Aggregation>>> aggregations_;
-  std::map<std::string, std::shared_ptr<Aggregation>>::iterator iter_;
+  void Load();
+
+  std::shared_ptr<AggregationHashTable> aggregations_;
+  std::vector<BaseSchema::Type> result_types_;
+  std::vector<uint32_t> groups_;
+  size_t pos_{0};
+  std::string key_;
+  std::shared_ptr<std::vector<std::any>> value_;
 };
 
 class AggregationManager {
@@ -67,6 +71,12 @@ class AggregationManager {
 
   std::shared_ptr<AggregationIterator> CreateIterator();
 
+  // Hand the current groups to an iterator and restart with an empty table, rows executed afterwards build new
+  // partial states for the same keys.
+  std::shared_ptr<AggregationIterator> Flush();
+
+  size_t GroupCount() const { return aggregations_ ? aggregations_->Size() : 0; }
+
   void Close();
 
  private:
@@ -79,8 +89,11 @@ class AggregationManager {
   std::shared_ptr<std::vector<std::shared_ptr<BaseSchema>>> group_by_operator_serial_schemas_;
   ::google::protobuf::RepeatedPtrField<pb::store::AggregationOperator> aggregation_operators_;
   std::shared_ptr<std::vector<std::shared_ptr<BaseSchema>>> result_serial_schemas_;
-  std::vector<std::function<bool(const std::any&, std::any*)>> aggregation_functions_;
-  std::shared_ptr<std::map<std::string, std::shared_ptr<Aggregation>>> aggregations_;
+  std::vector<AggregationFunction> aggregation_functions_;
+  // state of a new group and result type, one for each aggregation operator
+  std::vector<AggregationState> init_states_;
+  std::vector<BaseSchema::Type> result_types_;
+  std::shared_ptr<AggregationHashTable> aggregations_;
 };
 
 }  // namespace dingodb
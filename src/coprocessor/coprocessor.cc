@@ -27,6 +27,7 @@
 #include "coprocessor/utils.h"
 #include "expr/runner.h"
 #include "fmt/core.h"
+#include "gflags/gflags.h"
 #include "proto/error.pb.h"
 #include "proto/store.pb.h"
 #include "rel_expr_helper.h"
@@ -36,6 +37,9 @@
 
 namespace dingodb {
 
+DEFINE_int64(coprocessor_aggregation_flush_group_count, 0,
+             "flush partial aggregation results when the group count reaches this value, 0 means flush at scan end");
+
 bvar::Adder<uint64_t> Coprocessor::bvar_coprocessor_v1_object_running_num("dingo_coprocessor_v1_object_running_num");
 bvar::Adder<uint64_t> Coprocessor::bvar_coprocessor_v1_object_total_num("dingo_coprocessor_v1_object_total_num");
 bvar::LatencyRecorder Coprocessor::coprocessor_v1_latency("dingo_coprocessor_v1_latency");
@@ -208,6 +212,12 @@ butil::Status Coprocessor::Open(const std::any& coprocessor) {
 
   DINGO_LOG(DEBUG) << fmt::format("Coprocessor::Open enable_expression_ : {}", enable_expression_);
 
+  status = InitCodecAndRunner();
+  if (!status.ok()) {
+    DINGO_LOG(ERROR) << fmt::format("InitCodecAndRunner failed");
+    return status;
+  }
+
   DINGO_LOG(DEBUG) << fmt::format("Coprocessor::Open Leave");
 
   // Utils::DebugSerialSchema(original_serial_schemas_, "original_serial_schemas");
@@ -230,6 +240,17 @@ butil::Status Coprocessor::Execute(IteratorPtr iter, bool key_only, size_t max_f
   DINGO_LOG(DEBUG) << fmt::format("Coprocessor::Execute Enter");
   ScanFilter scan_filter = ScanFilter(key_only, max_fetch_cnt, max_bytes_rpc);
   butil::Status status;
+  bool upto_limit = false;
+
+  // return the rest of partial groups flushed by the last call first
+  if (partial_aggregation_iterator_) {
+    status = DrainAggregationIterator(partial_aggregation_iterator_, scan_filter, key_only, kvs, upto_limit);
+    if (!status.ok() || upto_limit) {
+      return status;
+    }
+    partial_aggregation_iterator_.reset();
+  }
+
   while (iter->Valid()) {
     pb::common::KeyValue kv;
     *kv.mutable_key() = iter->Key();
@@ -242,23 +263,27 @@ butil::Status Coprocessor::Execute(IteratorPtr iter, bool key_only, size_t max_f
       DINGO_LOG(ERROR) << fmt::format("Coprocessor::Execute failed");
       return status;
     }
+    iter->Next();
 
-    if (!has_result_kv) {
-      iter->Next();
-      continue;
-    }
-
-    if (key_only) {
-      result_key_value.set_value("");
-    }
+    if (has_result_kv) {
+      if (key_only) {
+        result_key_value.set_value("");
+      }
 
-    kvs->emplace_back(result_key_value);
+      kvs->emplace_back(result_key_value);
 
-    if (scan_filter.UptoLimit(result_key_value)) {
-      iter->Next();
-      return butil::Status();
+      if (scan_filter.UptoLimit(result_key_value)) {
+        return butil::Status();
+      }
+    } else if (NeedFlushAggregation()) {
+      // the partial states of the same group are merged by the caller as the results of different regions
+      partial_aggregation_iterator_ = aggregation_manager_->Flush();
+      status = DrainAggregationIterator(partial_aggregation_iterator_, scan_filter, key_only, kvs, upto_limit);
+      if (!status.ok() || upto_limit) {
+        return status;
+      }
+      partial_aggregation_iterator_.reset();
     }
-    iter->Next();
   }
 
   status = GetKeyValueFromAggregation(key_only, max_fetch_cnt, max_bytes_rpc, kvs);
@@ -286,9 +311,6 @@ butil::Status Coprocessor::DoExecute(const pb::common::KeyValue& kv, bool* has_r
                                      pb::common::KeyValue* result_kv) {
   butil::Status status;
 
-  RecordDecoder original_record_decoder(coprocessor_.schema_version(), original_serial_schemas_,
-                                        coprocessor_.original_schema().common_id());
-
   std::vector<std::any> original_record;
 
   // if (original_column_indexes_.empty()) {
@@ -306,7 +328,7 @@ butil::Status Coprocessor::DoExecute(const pb::common::KeyValue& kv, bool* has_r
   int ret = 0;
   try {
     // decode some column. not decode all
-    ret = original_record_decoder.Decode(kv.key(), kv.value(), selection_column_indexes_, original_record);
+    ret = original_record_decoder_->Decode(kv.key(), kv.value(), selection_column_indexes_, original_record);
   } catch (const std::exception& my_exception) {
     std::string error_message = fmt::format("serial::Decode failed exception : {}", my_exception.what());
     DINGO_LOG(ERROR) << error_message;
@@ -339,19 +361,15 @@ butil::Status Coprocessor::DoExecute(const pb::common::KeyValue& kv, bool* has_r
 
   bool is_key_value_reserve = true;
   if (enable_expression_) {
-    expr::Runner runner;
-
     try {
-      runner.Decode(reinterpret_cast<const expr::Byte*>(coprocessor_.expression().c_str()),
-                    coprocessor_.expression().length());
       auto tuple = std::make_unique<expr::Tuple>();
       RelExprHelper::TransToOperandWrapper(original_serial_schemas_, selection_column_indexes_, original_record, tuple);
-      runner.BindTuple(tuple.get());
-      runner.Run();
-      std::optional<bool> ok = runner.GetOptional<bool>();
+      expr_runner_->BindTuple(tuple.get());
+      expr_runner_->Run();
+      std::optional<bool> ok = expr_runner_->GetOptional<bool>();
       is_key_value_reserve = ok.has_value() && ok.value();
     } catch (const std::exception& my_exception) {
-      std::string error_message = fmt::format("expr::Runner Decode or Run failed. exception : {}", my_exception.what());
+      std::string error_message = fmt::format("expr::Runner Run failed. exception : {}", my_exception.what());
       DINGO_LOG(ERROR) << error_message;
       return butil::Status(pb::error::EILLEGAL_PARAMTETERS, error_message);
     }
@@ -439,12 +457,10 @@ butil::Status Coprocessor::DoExecuteForAggregation(const std::vector<std::any>&
 
   std::string group_by_key;
   if (group_by_key_serial_schemas_ && !group_by_key_serial_schemas_->empty()) {
-    RecordEncoder group_by_key_encoder(coprocessor_.schema_version(), group_by_key_serial_schemas_,
-                                       coprocessor_.result_schema().common_id());
     int ret = 0;
     try {
       // group_by_key_record [0,1,2,3,4,5,6] sort, for group_by_key_serial_schemas_ in vector index no schema index
-      ret = group_by_key_encoder.EncodeKey(prefix_, group_by_key_record, group_by_key);
+      ret = group_by_key_encoder_->EncodeKey(prefix_, group_by_key_record, group_by_key);
     } catch (const std::exception& my_exception) {
       std::string error_message = fmt::format("serial::EncodeKey failed exception : {}", my_exception.what());
       DINGO_LOG(ERROR) << error_message;
@@ -481,13 +497,11 @@ butil::Status Coprocessor::DoExecuteForSelection(const std::vector<std::any>& se
                                                  pb::common::KeyValue* result_kv) {
   butil::Status status;
   // selection
-  RecordEncoder result_record_encoder(coprocessor_.schema_version(), result_serial_schemas_sorted_,
-                                      coprocessor_.result_schema().common_id());
   pb::common::KeyValue result_key_value;
   int ret = 0;
   try {
-    ret = result_record_encoder.Encode(prefix_, selection_record, *result_key_value.mutable_key(),
-                                       *result_key_value.mutable_value());
+    ret = selection_record_encoder_->Encode(prefix_, selection_record, *result_key_value.mutable_key(),
+                                            *result_key_value.mutable_value());
   } catch (const std::exception& my_exception) {
     std::string error_message = fmt::format("serial::Encode failed exception : {}", my_exception.what());
     DINGO_LOG(ERROR) << error_message;
@@ -507,111 +521,118 @@ butil::Status Coprocessor::DoExecuteForSelection(const std::vector<std::any>& se
 
 butil::Status Coprocessor::GetKeyValueFromAggregation(bool key_only, size_t max_fetch_cnt, int64_t max_bytes_rpc,
                                                       std::vector<pb::common::KeyValue>* kvs) {
-  butil::Status status;
-
   if (end_of_group_by_ && aggregation_manager_) {
     if (!aggregation_iterator_) {
       aggregation_iterator_ = aggregation_manager_->CreateIterator();
     }
     ScanFilter scan_filter = ScanFilter(key_only, max_fetch_cnt, max_bytes_rpc);
+    bool upto_limit = false;
+    return DrainAggregationIterator(aggregation_iterator_, scan_filter, key_only, kvs, upto_limit);
+  }
 
-    RecordEncoder result_record_encoder(coprocessor_.schema_version(), result_serial_schemas_,
-                                        coprocessor_.result_schema().common_id());
-
-    while (aggregation_iterator_->HasNext()) {
-      Utils::DebugGroupByKey("", "Key Value pair");
-      const std::string& key = aggregation_iterator_->GetKey();
-      const std::shared_ptr<std::vector<std::any>>& value = aggregation_iterator_->GetValue();
-
-      std::vector<std::any> result_key_record;
-      int ret = 0;
-      if (group_by_key_serial_schemas_ && !group_by_key_serial_schemas_->empty()) {
-        RecordDecoder result_record_decoder(coprocessor_.schema_version(), group_by_key_serial_schemas_,
-                                            coprocessor_.result_schema().common_id());
-
-        try {
-          ret = result_record_decoder.DecodeKey(key, result_key_record);
-        } catch (const std::exception& my_exception) {
-          std::string error_message = fmt::format("serial::DecodeKey failed exception : {}", my_exception.what());
-          DINGO_LOG(ERROR) << error_message;
-          return butil::Status(pb::error::EILLEGAL_PARAMTETERS, error_message);
-        }
-        if (ret < 0) {
-          std::string error_message = fmt::format("serial::DecodeKey failed");
-          DINGO_LOG(ERROR) << error_message;
-          return butil::Status(pb::error::EILLEGAL_PARAMTETERS, error_message);
-        }
-      }
+  return butil::Status();
+}
 
-      std::vector<std::any> result_record;
-      result_record.reserve(result_key_record.size() + value->size());
-      size_t i = 0;
-      for (const auto& column : result_key_record) {
-        std::any column_clone = Utils::CloneColumn(column, (*result_serial_schemas_sorted_)[i]->GetType());
-        if (!column_clone.has_value()) {
-          std::string error_message = fmt::format(
-              "CloneColumn failed result_key_record index : {} result_serial_schemas_sorted_ i : {} "
-              "result_serial_schemas_sorted_ "
-              "type : {}",
-              i, i, BaseSchema::GetTypeString((*result_serial_schemas_sorted_)[i]->GetType()));
-          DINGO_LOG(ERROR) << error_message;
-          return butil::Status(pb::error::EILLEGAL_PARAMTETERS, error_message);
-        }
-        Utils::DebugColumn(column, (*result_serial_schemas_sorted_)[i]->GetType(), "Key");
-        result_record.emplace_back(std::move(column_clone));
-        i++;
-      }
+butil::Status Coprocessor::DrainAggregationIterator(std::shared_ptr<AggregationIterator>& iterator,
+                                                    ScanFilter& scan_filter, bool key_only,
+                                                    std::vector<pb::common::KeyValue>* kvs, bool& upto_limit) {
+  upto_limit = false;
+  while (iterator->HasNext()) {
+    Utils::DebugGroupByKey("", "Key Value pair");
+    const std::string& key = iterator->GetKey();
+    const std::shared_ptr<std::vector<std::any>>& value = iterator->GetValue();
 
-      for (const auto& column : *value) {
-        std::any column_clone = Utils::CloneColumn(column, (*result_serial_schemas_sorted_)[i]->GetType());
-        if (!column_clone.has_value()) {
-          std::string error_message = fmt::format(
-              "CloneColumn failed result_aggregation_record  index : {} result_serial_schemas_sorted_ i : {} "
-              "result_serial_schemas_sorted_ type : {}",
-              (i - result_key_record.size()), i,
-              BaseSchema::GetTypeString((*result_serial_schemas_sorted_)[i]->GetType()));
-          DINGO_LOG(ERROR) << error_message;
-          return butil::Status(pb::error::EILLEGAL_PARAMTETERS, error_message);
-        }
-        Utils::DebugColumn(column, (*result_serial_schemas_sorted_)[i]->GetType(), "Value");
-        result_record.emplace_back(std::move(column_clone));
-        i++;
-      }
-
-      pb::common::KeyValue result_key_value;
-      ret = 0;
+    std::vector<std::any> result_key_record;
+    int ret = 0;
+    if (group_by_key_serial_schemas_ && !group_by_key_serial_schemas_->empty()) {
       try {
-        ret = result_record_encoder.Encode(prefix_, result_record, *result_key_value.mutable_key(),
-                                           *result_key_value.mutable_value());
+        ret = group_by_key_decoder_->DecodeKey(key, result_key_record);
       } catch (const std::exception& my_exception) {
-        std::string error_message = fmt::format("serial::Encode failed exception : {}", my_exception.what());
+        std::string error_message = fmt::format("serial::DecodeKey failed exception : {}", my_exception.what());
         DINGO_LOG(ERROR) << error_message;
         return butil::Status(pb::error::EILLEGAL_PARAMTETERS, error_message);
       }
       if (ret < 0) {
-        std::string error_message = fmt::format("serial::Encode failed");
+        std::string error_message = fmt::format("serial::DecodeKey failed");
         DINGO_LOG(ERROR) << error_message;
         return butil::Status(pb::error::EILLEGAL_PARAMTETERS, error_message);
       }
+    }
 
-      if (key_only) {
-        result_key_value.set_value("");
+    std::vector<std::any> result_record;
+    result_record.reserve(result_key_record.size() + value->size());
+    size_t i = 0;
+    for (const auto& column : result_key_record) {
+      std::any column_clone = Utils::CloneColumn(column, (*result_serial_schemas_sorted_)[i]->GetType());
+      if (!column_clone.has_value()) {
+        std::string error_message = fmt::format(
+            "CloneColumn failed result_key_record index : {} result_serial_schemas_sorted_ i : {} "
+            "result_serial_schemas_sorted_ "
+            "type : {}",
+            i, i, BaseSchema::GetTypeString((*result_serial_schemas_sorted_)[i]->GetType()));
+        DINGO_LOG(ERROR) << error_message;
+        return butil::Status(pb::error::EILLEGAL_PARAMTETERS, error_message);
       }
+      Utils::DebugColumn(column, (*result_serial_schemas_sorted_)[i]->GetType(), "Key");
+      result_record.emplace_back(std::move(column_clone));
+      i++;
+    }
 
-      kvs->emplace_back(result_key_value);
-
-      if (scan_filter.UptoLimit(result_key_value)) {
-        aggregation_iterator_->Next();
-        return butil::Status();
+    for (const auto& column : *value) {
+      std::any column_clone = Utils::CloneColumn(column, (*result_serial_schemas_sorted_)[i]->GetType());
+      if (!column_clone.has_value()) {
+        std::string error_message = fmt::format(
+            "CloneColumn failed result_aggregation_record  index : {} result_serial_schemas_sorted_ i : {} "
+            "result_serial_schemas_sorted_ type : {}",
+            (i - result_key_record.size()), i,
+            BaseSchema::GetTypeString((*result_serial_schemas_sorted_)[i]->GetType()));
+        DINGO_LOG(ERROR) << error_message;
+        return butil::Status(pb::error::EILLEGAL_PARAMTETERS, error_message);
       }
+      Utils::DebugColumn(column, (*result_serial_schemas_sorted_)[i]->GetType(), "Value");
+      result_record.emplace_back(std::move(column_clone));
+      i++;
+    }
 
-      aggregation_iterator_->Next();
+    pb::common::KeyValue result_key_value;
+    ret = 0;
+    try {
+      ret = aggregation_record_encoder_->Encode(prefix_, result_record, *result_key_value.mutable_key(),
+                                                *result_key_value.mutable_value());
+    } catch (const std::exception& my_exception) {
+      std::string error_message = fmt::format("serial::Encode failed exception : {}", my_exception.what());
+      DINGO_LOG(ERROR) << error_message;
+      return butil::Status(pb::error::EILLEGAL_PARAMTETERS, error_message);
     }
+    if (ret < 0) {
+      std::string error_message = fmt::format("serial::Encode failed");
+      DINGO_LOG(ERROR) << error_message;
+      return butil::Status(pb::error::EILLEGAL_PARAMTETERS, error_message);
+    }
+
+    if (key_only) {
+      result_key_value.set_value("");
+    }
+
+    kvs->emplace_back(result_key_value);
+
+    if (scan_filter.UptoLimit(result_key_value)) {
+      iterator->Next();
+      upto_limit = true;
+      return butil::Status();
+    }
+
+    iterator->Next();
   }
 
   return butil::Status();
 }
 
+bool Coprocessor::NeedFlushAggregation() const {
+  return FLAGS_coprocessor_aggregation_flush_group_count > 0 && end_of_group_by_ && aggregation_manager_ &&
+         aggregation_manager_->GroupCount() >= FLAGS_coprocessor_aggregation_flush_group_count;
+}
+
 void Coprocessor::Close() {
   coprocessor_.Clear();
   if (original_serial_schemas_) {
@@ -649,6 +670,8 @@ void Coprocessor::Close() {
     aggregation_iterator_.reset();
   }
 
+  partial_aggregation_iterator_.reset();
+
   original_column_indexes_.clear();
   selection_column_indexes_.clear();
 
@@ -663,6 +686,46 @@ void Coprocessor::Close() {
   if (result_serial_schemas_sorted_) {
     result_serial_schemas_sorted_.reset();
   }
+
+  original_record_decoder_.reset();
+  selection_record_encoder_.reset();
+  aggregation_record_encoder_.reset();
+  group_by_key_encoder_.reset();
+  group_by_key_decoder_.reset();
+  expr_runner_.reset();
+}
+
+butil::Status Coprocessor::InitCodecAndRunner() {
+  original_record_decoder_ = std::make_shared<RecordDecoder>(
+      coprocessor_.schema_version(), original_serial_schemas_, coprocessor_.original_schema().common_id());
+
+  selection_record_encoder_ = std::make_shared<RecordEncoder>(
+      coprocessor_.schema_version(), result_serial_schemas_sorted_, coprocessor_.result_schema().common_id());
+
+  aggregation_record_encoder_ = std::make_shared<RecordEncoder>(
+      coprocessor_.schema_version(), result_serial_schemas_, coprocessor_.result_schema().common_id());
+
+  if (group_by_key_serial_schemas_ && !group_by_key_serial_schemas_->empty()) {
+    group_by_key_encoder_ = std::make_shared<RecordEncoder>(
+        coprocessor_.schema_version(), group_by_key_serial_schemas_, coprocessor_.result_schema().common_id());
+    group_by_key_decoder_ = std::make_shared<RecordDecoder>(
+        coprocessor_.schema_version(), group_by_key_serial_schemas_, coprocessor_.result_schema().common_id());
+  }
+
+  // decode the expression once, every row only binds a new tuple
+  if (enable_expression_) {
+    expr_runner_ = std::make_shared<expr::Runner>();
+    try {
+      expr_runner_->Decode(reinterpret_cast<const expr::Byte*>(coprocessor_.expression().c_str()),
+                           coprocessor_.expression().length());
+    } catch (const std::exception& my_exception) {
+      std::string error_message = fmt::format("expr::Runner Decode failed. exception : {}", my_exception.what());
+      DINGO_LOG(ERROR) << error_message;
+      return butil::Status(pb::error::EILLEGAL_PARAMTETERS, error_message);
+    }
+  }
+
+  return butil::Status();
 }
 
 butil::Status Coprocessor::CompareSerialSchema(const pb::store::Coprocessor& coprocessor) {
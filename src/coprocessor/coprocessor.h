@@ -26,7 +26,11 @@
 #include "coprocessor/aggregation_manager.h"
 #include "coprocessor/raw_coprocessor.h"
 #include "engine/iterator.h"
+#include "expr/runner.h"
 #include "proto/store.pb.h"
+#include "scan/scan_filter.h"
+#include "serial/record_decoder.h"
+#include "serial/record_encoder.h"
 
 namespace dingodb {
 
@@ -65,6 +69,10 @@ class Coprocessor : public RawCoprocessor {
                                       pb::common::KeyValue* result_kv);
   butil::Status GetKeyValueFromAggregation(bool key_only, size_t max_fetch_cnt, int64_t max_bytes_rpc,
                                            std::vector<pb::common::KeyValue>* kvs);
+  butil::Status DrainAggregationIterator(std::shared_ptr<AggregationIterator>& iterator,           // NOLINT
+                                         ScanFilter& scan_filter, bool key_only,                         // NOLINT
+                                         std::vector<pb::common::KeyValue>* kvs, bool& upto_limit);  // NOLINT
+  bool NeedFlushAggregation() const;
 
   butil::Status CompareSerialSchema(const pb::store::Coprocessor& coprocessor);
 
@@ -73,6 +81,8 @@ class Coprocessor : public RawCoprocessor {
   void GetOriginalColumnIndexes();
   void GetSelectionColumnIndexes();
 
+  butil::Status InitCodecAndRunner();
+
   char prefix_;
   pb::store::Coprocessor coprocessor_;
   std::shared_ptr<std::vector<std::shared_ptr<BaseSchema>>> original_serial_schemas_;
@@ -88,6 +98,8 @@ class Coprocessor : public RawCoprocessor {
   bool end_of_group_by_;
   std::shared_ptr<AggregationManager> aggregation_manager_;
   std::shared_ptr<AggregationIterator> aggregation_iterator_;
+  // partial groups flushed in the middle of scan, not yet returned
+  std::shared_ptr<AggregationIterator> partial_aggregation_iterator_;
   std::vector<int> original_column_indexes_;
   std::vector<int> selection_column_indexes_;
 
@@ -95,6 +107,14 @@ class Coprocessor : public RawCoprocessor {
   std::shared_ptr<std::vector<std::shared_ptr<BaseSchema>>> selection_serial_schemas_sorted_;
   std::shared_ptr<std::vector<std::shared_ptr<BaseSchema>>> result_serial_schemas_sorted_;
 
+  // built once in Open and reused for every row
+  std::shared_ptr<RecordDecoder> original_record_decoder_;
+  std::shared_ptr<RecordEncoder> selection_record_encoder_;
+  std::shared_ptr<RecordEncoder> aggregation_record_encoder_;
+  std::shared_ptr<RecordEncoder> group_by_key_encoder_;
+  std::shared_ptr<RecordDecoder> group_by_key_decoder_;
+  std::shared_ptr<expr::Runner> expr_runner_;
+
   static bvar::Adder<uint64_t> bvar_coprocessor_v1_object_running_num;
   static bvar::Adder<uint64_t> bvar_coprocessor_v1_object_total_num;
   static bvar::LatencyRecorder coprocessor_v1_latency;
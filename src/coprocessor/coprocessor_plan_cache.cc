@@ -0,0 +1,100 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "coprocessor/coprocessor_plan_cache.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <utility>
+
+#include "bvar/reducer.h"
+#include "gflags/gflags.h"
+
+namespace dingodb {
+
+DEFINE_bool(enable_coprocessor_v2_plan_cache, false, "enable cache the schemas built by coprocessor v2 open");
+DEFINE_int64(coprocessor_v2_plan_cache_capacity, 1024, "coprocessor v2 plan cache capacity, number of plans");
+
+static bvar::Adder<int64_t> g_coprocessor_v2_plan_cache_hit_count("dingo_coprocessor_v2_plan_cache_hit_count");
+static bvar::Adder<int64_t> g_coprocessor_v2_plan_cache_miss_count("dingo_coprocessor_v2_plan_cache_miss_count");
+
+bool CoprocessorV2PlanCache::IsEnabled() {
+  return FLAGS_enable_coprocessor_v2_plan_cache && FLAGS_coprocessor_v2_plan_cache_capacity > 0;
+}
+
+std::string CoprocessorV2PlanCache::Fingerprint(const pb::common::CoprocessorV2& coprocessor) {
+  std::string fingerprint;
+  fingerprint.append(std::to_string(coprocessor.schema_version()));
+  fingerprint.push_back('|');
+  for (auto column : coprocessor.selection_columns()) {
+    fingerprint.append(std::to_string(column));
+    fingerprint.push_back(',');
+  }
+  fingerprint.push_back('|');
+  // the schemas carry the common id
+  coprocessor.original_schema().AppendToString(&fingerprint);
+  fingerprint.push_back('|');
+  coprocessor.result_schema().AppendToString(&fingerprint);
+
+  return fingerprint;
+}
+
+CoprocessorV2PlanPtr CoprocessorV2PlanCache::Get(const std::string& fingerprint) {
+  std::lock_guard<bthread::Mutex> lock(mutex_);
+
+  auto it = entries_.find(fingerprint);
+  if (it == entries_.end()) {
+    g_coprocessor_v2_plan_cache_miss_count << 1;
+    return nullptr;
+  }
+
+  lru_.splice(lru_.begin(), lru_, it->second);
+  g_coprocessor_v2_plan_cache_hit_count << 1;
+  return it->second->second;
+}
+
+void CoprocessorV2PlanCache::Put(const std::string& fingerprint, CoprocessorV2PlanPtr plan) {
+  std::lock_guard<bthread::Mutex> lock(mutex_);
+
+  auto it = entries_.find(fingerprint);
+  if (it != entries_.end()) {
+    it->second->second = std::move(plan);
+    lru_.splice(lru_.begin(), lru_, it->second);
+    return;
+  }
+
+  lru_.emplace_front(fingerprint, std::move(plan));
+  entries_[fingerprint] = lru_.begin();
+
+  while (static_cast<int64_t>(lru_.size()) > std::max(FLAGS_coprocessor_v2_plan_cache_capacity, int64_t(1))) {
+    entries_.erase(lru_.back().first);
+    lru_.pop_back();
+  }
+}
+
+int64_t CoprocessorV2PlanCache::Count() {
+  std::lock_guard<bthread::Mutex> lock(mutex_);
+  return lru_.size();
+}
+
+void CoprocessorV2PlanCache::Clear() {
+  std::lock_guard<bthread::Mutex> lock(mutex_);
+  entries_.clear();
+  lru_.clear();
+}
+
+}  // namespace dingodb
@@ -0,0 +1,87 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef DINGODB_COPROCESSOR_COPROCESSOR_PLAN_CACHE_H_  // NOLINT
+#define DINGODB_COPROCESSOR_COPROCESSOR_PLAN_CACHE_H_
+
+#include <serial/schema/base_schema.h>
+
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "bthread/mutex.h"
+#include "proto/common.pb.h"
+#include "serial/record_decoder.h"
+#include "serial/record_encoder.h"
+
+namespace dingodb {
+
+// The part of CoprocessorV2::Open which only depends on the schemas of the request.
+// It is immutable after built, so the coprocessors of the requests with the same schemas share it.
+struct CoprocessorV2Plan {
+  std::shared_ptr<std::vector<std::shared_ptr<BaseSchema>>> original_serial_schemas;
+  std::vector<int> original_column_indexes;
+  std::vector<int> selection_column_indexes;
+  std::vector<BaseSchema::Type> selection_column_types;
+  std::shared_ptr<std::vector<std::shared_ptr<BaseSchema>>> result_serial_schemas;
+  std::vector<int> result_column_indexes;
+  std::shared_ptr<RecordDecoder> original_record_decoder;
+  std::shared_ptr<RecordEncoder> result_record_encoder;
+};
+
+using CoprocessorV2PlanPtr = std::shared_ptr<const CoprocessorV2Plan>;
+
+// Store level LRU cache of CoprocessorV2Plan, keyed by the schema version and the schemas of the request.
+class CoprocessorV2PlanCache {
+ public:
+  static CoprocessorV2PlanCache& GetInstance() {
+    static CoprocessorV2PlanCache instance;
+    return instance;
+  }
+
+  CoprocessorV2PlanCache(const CoprocessorV2PlanCache& rhs) = delete;
+  CoprocessorV2PlanCache& operator=(const CoprocessorV2PlanCache& rhs) = delete;
+  CoprocessorV2PlanCache(CoprocessorV2PlanCache&& rhs) = delete;
+  CoprocessorV2PlanCache& operator=(CoprocessorV2PlanCache&& rhs) = delete;
+
+  static bool IsEnabled();
+
+  // Serialize everything the plan depends on.
+  static std::string Fingerprint(const pb::common::CoprocessorV2& coprocessor);
+
+  CoprocessorV2PlanPtr Get(const std::string& fingerprint);
+  void Put(const std::string& fingerprint, CoprocessorV2PlanPtr plan);
+
+  int64_t Count();
+  void Clear();
+
+ private:
+  CoprocessorV2PlanCache() = default;
+  ~CoprocessorV2PlanCache() = default;
+
+  bthread::Mutex mutex_;
+  // front is the most recently used
+  std::list<std::pair<std::string, CoprocessorV2PlanPtr>> lru_;
+  std::unordered_map<std::string, std::list<std::pair<std::string, CoprocessorV2PlanPtr>>::iterator> entries_;
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_COPROCESSOR_COPROCESSOR_PLAN_CACHE_H_  // NOLINT
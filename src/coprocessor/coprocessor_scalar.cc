@@ -18,6 +18,7 @@
 #include <cstddef>
 #include <cstdint>
 #include <memory>
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -40,6 +41,32 @@ bvar::LatencyRecorder CoprocessorScalar::coprocessor_v2_filter_scalar_latency(
 
 DEFINE_bool(dingo_log_switch_coprocessor_scalar_detail, false, "coprocessor_scalar detail log");
 
+template <pb::common::ScalarFieldType FIELD_TYPE>
+static bool TransScalarValue(const pb::common::ScalarValue& scalar_value, std::vector<std::any>& original_record) {
+  if (scalar_value.field_type() != FIELD_TYPE || scalar_value.fields().empty()) {
+    return false;
+  }
+
+  const auto& field = scalar_value.fields(0);
+  if constexpr (FIELD_TYPE == pb::common::BOOL) {
+    original_record.emplace_back(std::optional<bool>{field.bool_data()});
+  } else if constexpr (FIELD_TYPE == pb::common::INT32) {
+    original_record.emplace_back(std::optional<int32_t>{field.int_data()});
+  } else if constexpr (FIELD_TYPE == pb::common::INT64) {
+    original_record.emplace_back(std::optional<int64_t>{field.long_data()});
+  } else if constexpr (FIELD_TYPE == pb::common::FLOAT32) {
+    original_record.emplace_back(std::optional<float>{field.float_data()});
+  } else if constexpr (FIELD_TYPE == pb::common::DOUBLE) {
+    original_record.emplace_back(std::optional<double>{field.double_data()});
+  } else {
+    static_assert(FIELD_TYPE == pb::common::STRING);
+    original_record.emplace_back(
+        std::optional<std::shared_ptr<std::string>>{std::make_shared<std::string>(field.string_data())});
+  }
+
+  return true;
+}
+
 CoprocessorScalar::CoprocessorScalar(char prefix) : CoprocessorV2(prefix){};
 CoprocessorScalar::~CoprocessorScalar() { Close(); }
 
@@ -64,9 +91,44 @@ butil::Status CoprocessorScalar::Open(const std::any& coprocessor) {
     return butil::Status(pb::error::EILLEGAL_PARAMTETERS, s);
   }
 
+  InitScalarColumns();
+
   return butil::Status();
 }
 
+void CoprocessorScalar::InitScalarColumns() {
+  scalar_columns_.clear();
+  scalar_columns_.reserve(selection_column_indexes_.size());
+  for (int selection_column_index : selection_column_indexes_) {
+    const auto& original_serial_schema = (*original_serial_schemas_)[selection_column_index];
+    ScalarColumn column{original_serial_schema->GetName(), original_serial_schema->GetType(), nullptr};
+    switch (column.type) {
+      case BaseSchema::Type::kBool:
+        column.trans_func = &TransScalarValue<pb::common::BOOL>;
+        break;
+      case BaseSchema::Type::kInteger:
+        column.trans_func = &TransScalarValue<pb::common::INT32>;
+        break;
+      case BaseSchema::Type::kLong:
+        column.trans_func = &TransScalarValue<pb::common::INT64>;
+        break;
+      case BaseSchema::Type::kFloat:
+        column.trans_func = &TransScalarValue<pb::common::FLOAT32>;
+        break;
+      case BaseSchema::Type::kDouble:
+        column.trans_func = &TransScalarValue<pb::common::DOUBLE>;
+        break;
+      case BaseSchema::Type::kString:
+        column.trans_func = &TransScalarValue<pb::common::STRING>;
+        break;
+      default:
+        // not support, TransScalarValueToAny reports the error
+        break;
+    }
+    scalar_columns_.push_back(std::move(column));
+  }
+}
+
 butil::Status CoprocessorScalar::Execute(IteratorPtr iter, bool key_only, size_t max_fetch_cnt, int64_t max_bytes_rpc,
                                          std::vector<pb::common::KeyValue>* kvs, bool& has_more) {
   return CoprocessorV2::RawCoprocessor::Execute(iter, key_only, max_fetch_cnt, max_bytes_rpc, kvs, has_more);  // NOLINT
@@ -119,132 +181,145 @@ butil::Status CoprocessorScalar::Filter(const pb::common::VectorScalardata& scal
   return butil::Status();
 }
 
-void CoprocessorScalar::Close() { return CoprocessorV2::Close(); }
+void CoprocessorScalar::Close() {
+  scalar_columns_.clear();
+  return CoprocessorV2::Close();
+}
 
 butil::Status CoprocessorScalar::TransToAnyRecord(const pb::common::VectorScalardata& scalar_data,
                                                   std::vector<std::any>& original_record) {
-  for (int selection_column_index : selection_column_indexes_) {
-    auto original_serial_schema = (*original_serial_schemas_)[selection_column_index];
-    BaseSchema::Type type = original_serial_schema->GetType();
-    const std::string& name = original_serial_schema->GetName();
-
-    auto iter = scalar_data.scalar_data().find(name);
+  for (const auto& column : scalar_columns_) {
+    auto iter = scalar_data.scalar_data().find(column.name);
     if (iter == scalar_data.scalar_data().end()) {
-      std::string error_message = fmt::format("in scalar_data not find name : {}", name);
+      std::string error_message = fmt::format("in scalar_data not find name : {}", column.name);
       DINGO_LOG(ERROR) << error_message;
       return butil::Status(pb::error::EILLEGAL_PARAMTETERS, error_message);
     }
 
-    const auto& scalar_value = iter->second;
-    pb::common::ScalarFieldType field_type = scalar_value.field_type();
-
-    auto lambda_check_misc_function = [&name, &type, &field_type, &scalar_value](BaseSchema::Type base_schema_type) {
-      if (base_schema_type != type) {
-        std::string error_message =
-            fmt::format("field name : {} type not match. schema type : {} field_type : {}", name,
-                        BaseSchema::GetTypeString(type), pb::common::ScalarFieldType_Name(field_type));
-        if (FLAGS_dingo_log_switch_coprocessor_scalar_detail) {
-          LOG(ERROR) << "[" << __PRETTY_FUNCTION__ << "] " << error_message;
-        }
-        return butil::Status(pb::error::EILLEGAL_PARAMTETERS, error_message);
-      }
+    if (column.trans_func != nullptr && column.trans_func(iter->second, original_record)) {
+      continue;
+    }
+
+    auto status = TransScalarValueToAny(column.name, column.type, iter->second, original_record);
+    if (!status.ok()) {
+      return status;
+    }
+  }
 
-      if (scalar_value.fields().empty()) {
-        std::string error_message = fmt::format("name : {} field_type : {} scalar_value.fields() empty", name,
-                                                pb::common::ScalarFieldType_Name(field_type));
-        if (FLAGS_dingo_log_switch_coprocessor_scalar_detail) {
-          LOG(ERROR) << "[" << __PRETTY_FUNCTION__ << "] " << error_message;
-        }
-        return butil::Status(pb::error::EILLEGAL_PARAMTETERS, error_message);
+  return butil::Status();
+}
+
+butil::Status CoprocessorScalar::TransScalarValueToAny(const std::string& name, BaseSchema::Type type,
+                                                       const pb::common::ScalarValue& scalar_value,
+                                                       std::vector<std::any>& original_record) {
+  pb::common::ScalarFieldType field_type = scalar_value.field_type();
+
+  auto lambda_check_misc_function = [&name, &type, &field_type, &scalar_value](BaseSchema::Type base_schema_type) {
+    if (base_schema_type != type) {
+      std::string error_message =
+          fmt::format("field name : {} type not match. schema type : {} field_type : {}", name,
+                      BaseSchema::GetTypeString(type), pb::common::ScalarFieldType_Name(field_type));
+      if (FLAGS_dingo_log_switch_coprocessor_scalar_detail) {
+        LOG(ERROR) << "[" << __PRETTY_FUNCTION__ << "] " << error_message;
       }
+      return butil::Status(pb::error::EILLEGAL_PARAMTETERS, error_message);
+    }
 
-      return butil::Status();
-    };
-
-    switch (field_type) {
-      case pb::common::BOOL: {
-        auto status = lambda_check_misc_function(BaseSchema::Type::kBool);
-        if (!status.ok()) {
-          DINGO_LOG(ERROR) << status.error_cstr();
-          return status;
-        }
-        original_record.emplace_back(std::optional<bool>{scalar_value.fields(0).bool_data()});
-        break;
+    if (scalar_value.fields().empty()) {
+      std::string error_message = fmt::format("name : {} field_type : {} scalar_value.fields() empty", name,
+                                              pb::common::ScalarFieldType_Name(field_type));
+      if (FLAGS_dingo_log_switch_coprocessor_scalar_detail) {
+        LOG(ERROR) << "[" << __PRETTY_FUNCTION__ << "] " << error_message;
       }
+      return butil::Status(pb::error::EILLEGAL_PARAMTETERS, error_message);
+    }
 
-      case pb::common::INT32: {
-        auto status = lambda_check_misc_function(BaseSchema::Type::kInteger);
-        if (!status.ok()) {
-          DINGO_LOG(ERROR) << status.error_cstr();
-          return status;
-        }
+    return butil::Status();
+  };
+
+  switch (field_type) {
+    case pb::common::BOOL: {
+      auto status = lambda_check_misc_function(BaseSchema::Type::kBool);
+      if (!status.ok()) {
+        DINGO_LOG(ERROR) << status.error_cstr();
+        return status;
+      }
+      original_record.emplace_back(std::optional<bool>{scalar_value.fields(0).bool_data()});
+      break;
+    }
 
-        original_record.emplace_back(std::optional<int32_t>{scalar_value.fields(0).int_data()});
-        break;
+    case pb::common::INT32: {
+      auto status = lambda_check_misc_function(BaseSchema::Type::kInteger);
+      if (!status.ok()) {
+        DINGO_LOG(ERROR) << status.error_cstr();
+        return status;
       }
-      case pb::common::INT64: {
-        auto status = lambda_check_misc_function(BaseSchema::Type::kLong);
-        if (!status.ok()) {
-          DINGO_LOG(ERROR) << status.error_cstr();
-          return status;
-        }
-
-        original_record.emplace_back(std::optional<int64_t>{scalar_value.fields(0).long_data()});
-        break;
+
+      original_record.emplace_back(std::optional<int32_t>{scalar_value.fields(0).int_data()});
+      break;
+    }
+    case pb::common::INT64: {
+      auto status = lambda_check_misc_function(BaseSchema::Type::kLong);
+      if (!status.ok()) {
+        DINGO_LOG(ERROR) << status.error_cstr();
+        return status;
       }
-      case pb::common::FLOAT32: {
-        auto status = lambda_check_misc_function(BaseSchema::Type::kFloat);
-        if (!status.ok()) {
-          DINGO_LOG(ERROR) << status.error_cstr();
-          return status;
-        }
-
-        original_record.emplace_back(std::optional<float>{scalar_value.fields(0).float_data()});
-        break;
+
+      original_record.emplace_back(std::optional<int64_t>{scalar_value.fields(0).long_data()});
+      break;
+    }
+    case pb::common::FLOAT32: {
+      auto status = lambda_check_misc_function(BaseSchema::Type::kFloat);
+      if (!status.ok()) {
+        DINGO_LOG(ERROR) << status.error_cstr();
+        return status;
       }
-      case pb::common::DOUBLE: {
-        auto status = lambda_check_misc_function(BaseSchema::Type::kDouble);
-        if (!status.ok()) {
-          DINGO_LOG(ERROR) << status.error_cstr();
-          return status;
-        }
-
-        original_record.emplace_back(std::optional<double>{scalar_value.fields(0).double_data()});
-        break;
+
+      original_record.emplace_back(std::optional<float>{scalar_value.fields(0).float_data()});
+      break;
+    }
+    case pb::common::DOUBLE: {
+      auto status = lambda_check_misc_function(BaseSchema::Type::kDouble);
+      if (!status.ok()) {
+        DINGO_LOG(ERROR) << status.error_cstr();
+        return status;
       }
-      case pb::common::STRING: {
-        auto status = lambda_check_misc_function(BaseSchema::Type::kString);
-        if (!status.ok()) {
-          DINGO_LOG(ERROR) << status.error_cstr();
-          return status;
-        }
-
-        original_record.emplace_back(std::optional<std::shared_ptr<std::string>>{
-            std::make_shared<std::string>(scalar_value.fields(0).string_data())});
-        break;
+
+      original_record.emplace_back(std::optional<double>{scalar_value.fields(0).double_data()});
+      break;
+    }
+    case pb::common::STRING: {
+      auto status = lambda_check_misc_function(BaseSchema::Type::kString);
+      if (!status.ok()) {
+        DINGO_LOG(ERROR) << status.error_cstr();
+        return status;
       }
 
-      case pb::common::INT8:
-        [[fallthrough]];
-      case pb::common::INT16:
-        [[fallthrough]];
-      case pb::common::BYTES:
-        [[fallthrough]];
-      case pb::common::NONE:
-        [[fallthrough]];
-      case pb::common::ScalarFieldType_INT_MIN_SENTINEL_DO_NOT_USE_:
-        [[fallthrough]];
-      case pb::common::ScalarFieldType_INT_MAX_SENTINEL_DO_NOT_USE_:
-        [[fallthrough]];
-      default: {
-        std::string error_message =
-            fmt::format("field name : {}  not support . schema type : {} field_type : {}", name,
-                        BaseSchema::GetTypeString(type), pb::common::ScalarFieldType_Name(field_type));
-        if (FLAGS_dingo_log_switch_coprocessor_scalar_detail) {
-          DINGO_LOG(ERROR) << error_message;
-        }
-        return butil::Status(pb::error::EILLEGAL_PARAMTETERS, error_message);
+      original_record.emplace_back(std::optional<std::shared_ptr<std::string>>{
+          std::make_shared<std::string>(scalar_value.fields(0).string_data())});
+      break;
+    }
+
+    case pb::common::INT8:
+      [[fallthrough]];
+    case pb::common::INT16:
+      [[fallthrough]];
+    case pb::common::BYTES:
+      [[fallthrough]];
+    case pb::common::NONE:
+      [[fallthrough]];
+    case pb::common::ScalarFieldType_INT_MIN_SENTINEL_DO_NOT_USE_:
+      [[fallthrough]];
+    case pb::common::ScalarFieldType_INT_MAX_SENTINEL_DO_NOT_USE_:
+      [[fallthrough]];
+    default: {
+      std::string error_message =
+          fmt::format("field name : {}  not support . schema type : {} field_type : {}", name,
+                      BaseSchema::GetTypeString(type), pb::common::ScalarFieldType_Name(field_type));
+      if (FLAGS_dingo_log_switch_coprocessor_scalar_detail) {
+        DINGO_LOG(ERROR) << error_message;
       }
+      return butil::Status(pb::error::EILLEGAL_PARAMTETERS, error_message);
     }
   }
 
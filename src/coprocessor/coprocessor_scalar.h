@@ -18,6 +18,7 @@
 #include <serial/schema/base_schema.h>
 
 #include <any>
+#include <string>
 #include <vector>
 
 #include "butil/status.h"
@@ -54,8 +55,27 @@ class CoprocessorScalar : public CoprocessorV2 {
   void Close() override;
 
  private:
+  // trans the first field of scalar value to the column, false if field type not match or no field.
+  using ScalarValueTransFunc = bool (*)(const pb::common::ScalarValue& scalar_value,
+                                        std::vector<std::any>& original_record);  // NOLINT
+
+  // selection column resolved at Open, so a row only needs a lookup by name and a type check.
+  struct ScalarColumn {
+    std::string name;
+    BaseSchema::Type type;
+    ScalarValueTransFunc trans_func;
+  };
+
+  void InitScalarColumns();
+
   butil::Status TransToAnyRecord(const pb::common::VectorScalardata& scalar_data,
                                  std::vector<std::any>& original_record);  // NOLINT
+  static butil::Status TransScalarValueToAny(const std::string& name, BaseSchema::Type type,
+                                             const pb::common::ScalarValue& scalar_value,
+                                             std::vector<std::any>& original_record);  // NOLINT
+
+  std::vector<ScalarColumn> scalar_columns_;
+
   static bvar::Adder<uint64_t> bvar_coprocessor_v2_filter_scalar_running_num;
   static bvar::Adder<uint64_t> bvar_coprocessor_v2_filter_scalar_total_num;
   static bvar::LatencyRecorder coprocessor_v2_filter_scalar_latency;
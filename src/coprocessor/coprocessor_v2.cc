@@ -26,6 +26,7 @@
 #include <vector>
 
 #include "common/logging.h"
+#include "coprocessor/coprocessor_plan_cache.h"
 #include "coprocessor/utils.h"
 #include "fmt/core.h"
 #include "proto/error.pb.h"
@@ -39,6 +40,8 @@ namespace dingodb {
 DECLARE_int64(max_scan_memory_size);
 DECLARE_int64(max_scan_line_limit);
 
+DEFINE_int32(coprocessor_v2_batch_size, 256, "coprocessor v2 decode and trans rows in batch, 1 is row by row");
+
 bvar::Adder<uint64_t> CoprocessorV2::bvar_coprocessor_v2_object_running_num("dingo_coprocessor_v2_object_running_num");
 bvar::Adder<uint64_t> CoprocessorV2::bvar_coprocessor_v2_object_total_num("dingo_coprocessor_v2_object_total_num");
 bvar::LatencyRecorder CoprocessorV2::coprocessor_v2_latency("dingo_coprocessor_v2_latency");
@@ -139,6 +142,17 @@ butil::Status CoprocessorV2::Open(const std::any& coprocessor) {
 
   Utils::DebugCoprocessorV2(coprocessor_);
 
+  // the schemas of the same shape requests are built once
+  std::string plan_fingerprint;
+  if (CoprocessorV2PlanCache::IsEnabled()) {
+    plan_fingerprint = CoprocessorV2PlanCache::Fingerprint(coprocessor_);
+    auto plan = CoprocessorV2PlanCache::GetInstance().Get(plan_fingerprint);
+    if (plan != nullptr) {
+      ApplyPlan(*plan);
+      return DecodeRelExpr();
+    }
+  }
+
   status = Utils::CheckPbSchema(coprocessor_.original_schema().schema());
   if (!status.ok()) {
     std::string error_message = fmt::format("original_schema check failed");
@@ -172,6 +186,12 @@ butil::Status CoprocessorV2::Open(const std::any& coprocessor) {
   GetSelectionColumnIndexes();
   ShowSelectionColumnIndexes();
 
+  selection_column_types_.clear();
+  selection_column_types_.reserve(selection_column_indexes_.size());
+  for (int index : selection_column_indexes_) {
+    selection_column_types_.push_back((*original_serial_schemas_)[index]->GetType());
+  }
+
   status = Utils::CheckPbSchema(coprocessor_.result_schema().schema());
   if (!status.ok()) {
     std::string error_message = fmt::format("result_schema check failed");
@@ -191,18 +211,27 @@ butil::Status CoprocessorV2::Open(const std::any& coprocessor) {
   GetResultColumnIndexes();
   ShowResultColumnIndexes();
 
-  if (coprocessor_.rel_expr().empty()) {
-    std::string error_message = fmt::format("CoprocessorV2::Open rel_expr empty. not support");
-    DINGO_LOG(ERROR) << error_message;
-    return butil::Status(pb::error::EILLEGAL_PARAMTETERS, error_message);
-  }
-
   original_record_decoder_ = std::make_shared<RecordDecoder>(coprocessor_.schema_version(), original_serial_schemas_,
                                                              coprocessor_.original_schema().common_id());
 
   result_record_encoder_ = std::make_shared<RecordEncoder>(coprocessor_.schema_version(), result_serial_schemas_,
                                                            coprocessor_.result_schema().common_id());
 
+  if (!plan_fingerprint.empty()) {
+    CoprocessorV2PlanCache::GetInstance().Put(plan_fingerprint, BuildPlan());
+  }
+
+  return DecodeRelExpr();
+}
+
+// The rel runner keeps the state of execution, e.g. aggregation, so it is decoded for every request.
+butil::Status CoprocessorV2::DecodeRelExpr() {
+  if (coprocessor_.rel_expr().empty()) {
+    std::string error_message = fmt::format("CoprocessorV2::Open rel_expr empty. not support");
+    DINGO_LOG(ERROR) << error_message;
+    return butil::Status(pb::error::EILLEGAL_PARAMTETERS, error_message);
+  }
+
 #if defined(TEST_COPROCESSOR_V2_MOCK)
   rel_runner_ = std::make_shared<rel::mock::RelRunner>();
 #else
@@ -218,7 +247,32 @@ butil::Status CoprocessorV2::Open(const std::any& coprocessor) {
     return butil::Status(pb::error::EILLEGAL_PARAMTETERS, error_message);
   }
 
-  return status;
+  return butil::Status();
+}
+
+CoprocessorV2PlanPtr CoprocessorV2::BuildPlan() const {
+  auto plan = std::make_shared<CoprocessorV2Plan>();
+  plan->original_serial_schemas = original_serial_schemas_;
+  plan->original_column_indexes = original_column_indexes_;
+  plan->selection_column_indexes = selection_column_indexes_;
+  plan->selection_column_types = selection_column_types_;
+  plan->result_serial_schemas = result_serial_schemas_;
+  plan->result_column_indexes = result_column_indexes_;
+  plan->original_record_decoder = original_record_decoder_;
+  plan->result_record_encoder = result_record_encoder_;
+
+  return plan;
+}
+
+void CoprocessorV2::ApplyPlan(const CoprocessorV2Plan& plan) {
+  original_serial_schemas_ = plan.original_serial_schemas;
+  original_column_indexes_ = plan.original_column_indexes;
+  selection_column_indexes_ = plan.selection_column_indexes;
+  selection_column_types_ = plan.selection_column_types;
+  result_serial_schemas_ = plan.result_serial_schemas;
+  result_column_indexes_ = plan.result_column_indexes;
+  original_record_decoder_ = plan.original_record_decoder;
+  result_record_encoder_ = plan.result_record_encoder;
 }
 
 butil::Status CoprocessorV2::Execute(IteratorPtr iter, bool key_only, size_t max_fetch_cnt, int64_t max_bytes_rpc,
@@ -238,6 +292,8 @@ butil::Status CoprocessorV2::Execute(IteratorPtr iter, bool key_only, size_t max
   ScanFilter scan_filter = ScanFilter(false, max_fetch_cnt, max_bytes_rpc);
   butil::Status status;
   has_more = false;
+  const size_t batch_size = std::max(FLAGS_coprocessor_v2_batch_size, 1);
+  std::vector<pb::common::KeyValue> batch_kvs;
   while (iter->Valid()) {
     pb::common::KeyValue kv;
 #if defined(ENABLE_COPROCESSOR_V2_STATISTICS_TIME_CONSUMPTION)
@@ -253,24 +309,37 @@ butil::Status CoprocessorV2::Execute(IteratorPtr iter, bool key_only, size_t max
 #if defined(ENABLE_COPROCESSOR_V2_STATISTICS_TIME_CONSUMPTION)
     }
 #endif
-    bool has_result_kv = false;
-    pb::common::KeyValue result_key_value;
-    DINGO_LOG(DEBUG) << fmt::format("CoprocessorV2::DoExecute Call");
-    status = DoExecute(kv.key(), kv.value(), &has_result_kv, &result_key_value);
-    if (!status.ok()) {
-      DINGO_LOG(ERROR) << fmt::format("CoprocessorV2::Execute failed");
-      return status;
-    }
-
-    if (has_result_kv) {
-      if (key_only) {
-        result_key_value.set_value("");
+    bool upto_limit = scan_filter.UptoLimit(kv);
+    if (batch_size > 1) {
+      batch_kvs.push_back(std::move(kv));
+      if (batch_kvs.size() >= batch_size) {
+        status = DoExecuteBatch(batch_kvs, key_only, *kvs);
+        if (!status.ok()) {
+          DINGO_LOG(ERROR) << fmt::format("CoprocessorV2::Execute failed");
+          return status;
+        }
+        batch_kvs.clear();
+      }
+    } else {
+      bool has_result_kv = false;
+      pb::common::KeyValue result_key_value;
+      DINGO_LOG(DEBUG) << fmt::format("CoprocessorV2::DoExecute Call");
+      status = DoExecute(kv.key(), kv.value(), &has_result_kv, &result_key_value);
+      if (!status.ok()) {
+        DINGO_LOG(ERROR) << fmt::format("CoprocessorV2::Execute failed");
+        return status;
       }
 
-      kvs->emplace_back(std::move(result_key_value));
+      if (has_result_kv) {
+        if (key_only) {
+          result_key_value.set_value("");
+        }
+
+        kvs->emplace_back(std::move(result_key_value));
+      }
     }
 
-    if (scan_filter.UptoLimit(kv)) {
+    if (upto_limit) {
       has_more = true;
       DINGO_LOG(WARNING) << fmt::format(
           "CoprocessorV2 UptoLimit. key_only : {} max_fetch_cnt : {} max_bytes_rpc : {} cur_fetch_cnt : {} "
@@ -304,6 +373,14 @@ butil::Status CoprocessorV2::Execute(IteratorPtr iter, bool key_only, size_t max
 #endif
   }
 
+  if (!batch_kvs.empty()) {
+    status = DoExecuteBatch(batch_kvs, key_only, *kvs);
+    if (!status.ok()) {
+      DINGO_LOG(ERROR) << fmt::format("CoprocessorV2::Execute failed");
+      return status;
+    }
+  }
+
   status = GetKvFromExprEndOfFinish(key_only, max_fetch_cnt, max_bytes_rpc, kvs);
 
   DINGO_LOG(DEBUG) << fmt::format("CoprocessorV2::Execute IteratorPtr Leave");
@@ -311,6 +388,29 @@ butil::Status CoprocessorV2::Execute(IteratorPtr iter, bool key_only, size_t max
   return status;
 }
 
+// Read the values deferred by the txn iterator for the rows of a batch in one multi get.
+static butil::Status FillLazyValues(TxnIteratorPtr iter, std::vector<size_t>& lazy_indexes,
+                                    std::vector<std::string>& lazy_data_keys,
+                                    std::vector<pb::common::KeyValue>& batch_kvs) {
+  if (lazy_indexes.empty()) {
+    return butil::Status();
+  }
+
+  std::vector<std::string> values;
+  auto status = iter->BatchGetValue(lazy_data_keys, values);
+  if (!status.ok()) {
+    return status;
+  }
+
+  for (size_t i = 0; i < lazy_indexes.size(); ++i) {
+    *batch_kvs[lazy_indexes[i]].mutable_value() = std::move(values[i]);
+  }
+  lazy_indexes.clear();
+  lazy_data_keys.clear();
+
+  return butil::Status();
+}
+
 butil::Status CoprocessorV2::Execute(TxnIteratorPtr iter, int64_t limit, bool key_only, bool /*is_reverse*/,
                                      pb::store::TxnResultInfo& txn_result_info, std::vector<pb::common::KeyValue>& kvs,
                                      bool& has_more, std::string& end_key) {
@@ -331,6 +431,11 @@ butil::Status CoprocessorV2::Execute(TxnIteratorPtr iter, int64_t limit, bool ke
 
   ScanFilter scan_filter =
       ScanFilter(false, std::min(limit, FLAGS_max_scan_line_limit), std::numeric_limits<int64_t>::max());
+  const size_t batch_size = std::max(FLAGS_coprocessor_v2_batch_size, 1);
+  std::vector<pb::common::KeyValue> batch_kvs;
+  // rows of batch_kvs whose value is not read yet
+  std::vector<size_t> lazy_indexes;
+  std::vector<std::string> lazy_data_keys;
 
   while (iter->Valid(txn_result_info)) {
     pb::common::KeyValue kv;
@@ -343,30 +448,52 @@ butil::Status CoprocessorV2::Execute(TxnIteratorPtr iter, int64_t limit, bool ke
       });
 #endif
       *kv.mutable_key() = iter->Key();
-      *kv.mutable_value() = iter->Value();
+      if (batch_size > 1 && !iter->ValueDataKey().empty()) {
+        // read with the other rows of the batch
+        lazy_indexes.push_back(batch_kvs.size());
+        lazy_data_keys.push_back(iter->ValueDataKey());
+      } else {
+        *kv.mutable_value() = iter->Value();
+      }
 #if defined(ENABLE_COPROCESSOR_V2_STATISTICS_TIME_CONSUMPTION)
     }
 #endif
-    bool has_result_kv = false;
-    pb::common::KeyValue result_key_value;
-    DINGO_LOG(DEBUG) << fmt::format("CoprocessorV2::DoExecute Call");
-    status = DoExecute(kv.key(), kv.value(), &has_result_kv, &result_key_value);
-    if (!status.ok()) {
-      DINGO_LOG(ERROR) << fmt::format("CoprocessorV2::Execute failed");
-      return status;
-    }
-
     end_key = iter->Key();
 
-    if (has_result_kv) {
-      if (key_only) {
-        result_key_value.set_value("");
+    bool upto_limit = scan_filter.UptoLimit(kv);
+    if (batch_size > 1) {
+      batch_kvs.push_back(std::move(kv));
+      if (batch_kvs.size() >= batch_size) {
+        status = FillLazyValues(iter, lazy_indexes, lazy_data_keys, batch_kvs);
+        if (status.ok()) {
+          status = DoExecuteBatch(batch_kvs, key_only, kvs);
+        }
+        if (!status.ok()) {
+          DINGO_LOG(ERROR) << fmt::format("CoprocessorV2::Execute failed");
+          return status;
+        }
+        batch_kvs.clear();
+      }
+    } else {
+      bool has_result_kv = false;
+      pb::common::KeyValue result_key_value;
+      DINGO_LOG(DEBUG) << fmt::format("CoprocessorV2::DoExecute Call");
+      status = DoExecute(kv.key(), kv.value(), &has_result_kv, &result_key_value);
+      if (!status.ok()) {
+        DINGO_LOG(ERROR) << fmt::format("CoprocessorV2::Execute failed");
+        return status;
       }
 
-      kvs.emplace_back(std::move(result_key_value));
+      if (has_result_kv) {
+        if (key_only) {
+          result_key_value.set_value("");
+        }
+
+        kvs.emplace_back(std::move(result_key_value));
+      }
     }
 
-    if (scan_filter.UptoLimit(kv)) {
+    if (upto_limit) {
       has_more = true;
       DINGO_LOG(WARNING) << fmt::format(
           "CoprocessorV2 UptoLimit. key_only : {} max_fetch_cnt : {} max_bytes_rpc : {} cur_fetch_cnt : {} "
@@ -401,6 +528,17 @@ butil::Status CoprocessorV2::Execute(TxnIteratorPtr iter, int64_t limit, bool ke
 #endif
   }
 
+  if (!batch_kvs.empty()) {
+    status = FillLazyValues(iter, lazy_indexes, lazy_data_keys, batch_kvs);
+    if (status.ok()) {
+      status = DoExecuteBatch(batch_kvs, key_only, kvs);
+    }
+    if (!status.ok()) {
+      DINGO_LOG(ERROR) << fmt::format("CoprocessorV2::Execute failed");
+      return status;
+    }
+  }
+
   status = GetKvFromExprEndOfFinish(key_only, limit, FLAGS_max_scan_memory_size, &kvs);
 
   DINGO_LOG(DEBUG) << fmt::format("CoprocessorV2::Execute TxnIteratorPtr Leave");
@@ -428,6 +566,7 @@ void CoprocessorV2::Close() {
   original_serial_schemas_.reset();
   original_column_indexes_.clear();
   selection_column_indexes_.clear();
+  selection_column_types_.clear();
   result_serial_schemas_.reset();
   result_record_encoder_.reset();
   original_record_decoder_.reset();
@@ -553,6 +692,11 @@ butil::Status CoprocessorV2::DoRelExprCore(const std::vector<std::any>& original
   });
 #endif
 
+  return RunRelExpr(operand_ptr, result_operand_ptr);
+}
+
+butil::Status CoprocessorV2::RunRelExpr(std::unique_ptr<std::vector<expr::Operand>>& operand_ptr,
+                                        std::unique_ptr<std::vector<expr::Operand>>& result_operand_ptr) {
   try {
     std::vector<expr::Operand>* raw_operand_ptr = operand_ptr.release();
 
@@ -564,7 +708,7 @@ butil::Status CoprocessorV2::DoRelExprCore(const std::vector<std::any>& original
     return butil::Status(pb::error::EILLEGAL_PARAMTETERS, error_message);
   }
 
-  return status;
+  return butil::Status();
 }
 
 butil::Status CoprocessorV2::DoRelExprCoreWrapper(const std::string& key, const std::string& value,
@@ -584,20 +728,9 @@ butil::Status CoprocessorV2::DoRelExprCoreWrapper(const std::string& key, const
       decode_spend_time_ms += lambda_time_diff_microseconds_function(decode_start, decode_end);
     });
 #endif
-    int ret = 0;
-    try {
-      // decode some column. not decode all
-      ret = original_record_decoder_->Decode(key, value, selection_column_indexes_, original_record);
-    } catch (const std::exception& my_exception) {
-      std::string error_message = fmt::format("serial::Decode failed exception : {}", my_exception.what());
-      DINGO_LOG(ERROR) << error_message;
-      return butil::Status(pb::error::EILLEGAL_PARAMTETERS, error_message);
-    }
-
-    if (ret < 0) {
-      std::string error_message = fmt::format("serial::Decode failed");
-      DINGO_LOG(ERROR) << error_message;
-      return butil::Status(pb::error::EILLEGAL_PARAMTETERS, error_message);
+    status = DecodeRecord(key, value, original_record);
+    if (!status.ok()) {
+      return status;
     }
 #if defined(ENABLE_COPROCESSOR_V2_STATISTICS_TIME_CONSUMPTION)
   }
@@ -606,6 +739,88 @@ butil::Status CoprocessorV2::DoRelExprCoreWrapper(const std::string& key, const
   return DoRelExprCore(original_record, result_operand_ptr);
 }
 
+butil::Status CoprocessorV2::DecodeRecord(const std::string& key, const std::string& value,
+                                          std::vector<std::any>& original_record) {
+  int ret = 0;
+  try {
+    // decode some column. not decode all
+    ret = original_record_decoder_->Decode(key, value, selection_column_indexes_, original_record);
+  } catch (const std::exception& my_exception) {
+    std::string error_message = fmt::format("serial::Decode failed exception : {}", my_exception.what());
+    DINGO_LOG(ERROR) << error_message;
+    return butil::Status(pb::error::EILLEGAL_PARAMTETERS, error_message);
+  }
+
+  if (ret < 0) {
+    std::string error_message = fmt::format("serial::Decode failed");
+    DINGO_LOG(ERROR) << error_message;
+    return butil::Status(pb::error::EILLEGAL_PARAMTETERS, error_message);
+  }
+
+  return butil::Status();
+}
+
+butil::Status CoprocessorV2::DoExecuteBatch(const std::vector<pb::common::KeyValue>& batch_kvs, bool key_only,
+                                            std::vector<pb::common::KeyValue>& kvs) {
+  butil::Status status;
+
+  std::vector<std::vector<std::any>> original_records(batch_kvs.size());
+  for (size_t i = 0; i < batch_kvs.size(); ++i) {
+    original_records[i].reserve(selection_column_indexes_.size());
+    status = DecodeRecord(batch_kvs[i].key(), batch_kvs[i].value(), original_records[i]);
+    if (!status.ok()) {
+      return status;
+    }
+  }
+
+  std::vector<std::unique_ptr<std::vector<expr::Operand>>> operand_ptrs;
+  status = RelExprHelper::TransToOperandBatch(selection_column_types_, original_records, operand_ptrs);
+  if (!status.ok()) {
+    DINGO_LOG(ERROR) << status.error_cstr();
+    return status;
+  }
+  original_records.clear();
+
+  std::vector<std::any> result_record;
+  for (auto& operand_ptr : operand_ptrs) {
+    std::unique_ptr<std::vector<expr::Operand>> result_operand_ptr;
+    status = RunRelExpr(operand_ptr, result_operand_ptr);
+    if (!status.ok()) {
+      return status;
+    }
+
+    // filtered out, or hold by the rel runner, e.g. aggregation
+    if (!result_operand_ptr) {
+      continue;
+    }
+
+    result_record.clear();
+    status = RelExprHelper::TransFromOperandWrapper(result_operand_ptr, result_serial_schemas_, result_column_indexes_,
+                                                    result_record);
+    if (!status.ok()) {
+      DINGO_LOG(ERROR) << status.error_cstr();
+      return status;
+    }
+
+    bool has_result_kv = false;
+    pb::common::KeyValue result_kv;
+    status = GetKvFromExpr(result_record, &has_result_kv, &result_kv);
+    if (!status.ok()) {
+      DINGO_LOG(ERROR) << status.error_cstr();
+      return status;
+    }
+
+    if (has_result_kv) {
+      if (key_only) {
+        result_kv.set_value("");
+      }
+      kvs.emplace_back(std::move(result_kv));
+    }
+  }
+
+  return status;
+}
+
 butil::Status CoprocessorV2::GetKvFromExprEndOfFinish(bool /*key_only*/, size_t /*max_fetch_cnt*/,
                                                       int64_t /*max_bytes_rpc*/,
                                                       std::vector<pb::common::KeyValue>* kvs) {
@@ -23,6 +23,7 @@
 #include <vector>
 
 #include "butil/status.h"
+#include "coprocessor/coprocessor_plan_cache.h"
 #include "coprocessor/raw_coprocessor.h"
 #include "coprocessor/rel_expr_helper.h"  // IWYU pragma: keep
 #include "engine/iterator.h"
@@ -73,11 +74,22 @@ class CoprocessorV2 : public RawCoprocessor {
                               std::unique_ptr<std::vector<expr::Operand>>& result_operand_ptr);  // NOLINT
   butil::Status DoRelExprCoreWrapper(const std::string& key, const std::string& value,
                                      std::unique_ptr<std::vector<expr::Operand>>& result_operand_ptr);  // NOLINT
+  butil::Status DecodeRecord(const std::string& key, const std::string& value,
+                             std::vector<std::any>& original_record);  // NOLINT
+  butil::Status RunRelExpr(std::unique_ptr<std::vector<expr::Operand>>& operand_ptr,
+                           std::unique_ptr<std::vector<expr::Operand>>& result_operand_ptr);  // NOLINT
+  // Decode the batch first, trans to operand column by column, then put the rows into rel runner in order.
+  butil::Status DoExecuteBatch(const std::vector<pb::common::KeyValue>& batch_kvs, bool key_only,
+                               std::vector<pb::common::KeyValue>& kvs);  // NOLINT
   butil::Status GetKvFromExprEndOfFinish(bool key_only, size_t max_fetch_cnt, int64_t max_bytes_rpc,
                                          std::vector<pb::common::KeyValue>* kvs);
   butil::Status GetKvFromExpr(const std::vector<std::any>& record, bool* has_result_kv,
                               pb::common::KeyValue* result_kv);
 
+  butil::Status DecodeRelExpr();
+  CoprocessorV2PlanPtr BuildPlan() const;
+  void ApplyPlan(const CoprocessorV2Plan& plan);
+
   void GetOriginalColumnIndexes();
   void GetSelectionColumnIndexes();
   void GetResultColumnIndexes();
@@ -92,7 +104,9 @@ class CoprocessorV2 : public RawCoprocessor {
   // array index =  original schema member index field ; value = original schema array index
   std::vector<int> original_column_indexes_;  // NOLINT
   // index = dummy ; value =  original schema index
-  std::vector<int> selection_column_indexes_;                                        // NOLINT
+  std::vector<int> selection_column_indexes_;  // NOLINT
+  // index = dummy ; value = original schema type of selection column
+  std::vector<BaseSchema::Type> selection_column_types_;                             // NOLINT
   std::shared_ptr<std::vector<std::shared_ptr<BaseSchema>>> result_serial_schemas_;  // NOLINT
   std::shared_ptr<RecordEncoder> result_record_encoder_;                             // NOLINT
   std::shared_ptr<RecordDecoder> original_record_decoder_;                           // NOLINT
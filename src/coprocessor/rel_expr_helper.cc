@@ -335,6 +335,101 @@ butil::Status RelExprHelper::TransToOperandWrapper(
   return butil::Status();
 }
 
+template <typename T>
+static butil::Status TransColumnToOperand(size_t column_index,
+                                          const std::vector<std::vector<std::any>>& original_records,
+                                          std::vector<std::unique_ptr<std::vector<expr::Operand>>>& operand_ptrs) {
+  try {
+    for (size_t i = 0; i < original_records.size(); ++i) {
+      operand_ptrs[i]->emplace_back(expr::any_optional_data_adaptor::ToOperand<T>(original_records[i][column_index]));
+    }
+  } catch (const std::bad_any_cast& bad) {
+    std::string s = fmt::format("Trans to Operand failed, column index: {}, {}", column_index, bad.what());
+    DINGO_LOG(ERROR) << s;
+    return butil::Status(pb::error::EILLEGAL_PARAMTETERS, s);
+  }
+
+  return butil::Status();
+}
+
+butil::Status RelExprHelper::TransToOperandBatch(
+    const std::vector<BaseSchema::Type>& column_types, const std::vector<std::vector<std::any>>& original_records,
+    std::vector<std::unique_ptr<std::vector<expr::Operand>>>& operand_ptrs) {
+  operand_ptrs.clear();
+  operand_ptrs.reserve(original_records.size());
+  for (const auto& record : original_records) {
+    if (record.size() != column_types.size()) {
+      std::string s = fmt::format("record column size({}) not match column types size({})", record.size(),
+                                  column_types.size());
+      DINGO_LOG(ERROR) << s;
+      return butil::Status(pb::error::EILLEGAL_PARAMTETERS, s);
+    }
+    auto operand_ptr = std::make_unique<std::vector<expr::Operand>>();
+    operand_ptr->reserve(column_types.size());
+    operand_ptrs.push_back(std::move(operand_ptr));
+  }
+
+  butil::Status status;
+  for (size_t column_index = 0; column_index < column_types.size(); ++column_index) {
+    switch (column_types[column_index]) {
+      case BaseSchema::Type::kBool:
+        status = TransColumnToOperand<bool>(column_index, original_records, operand_ptrs);
+        break;
+      case BaseSchema::Type::kInteger:
+        status = TransColumnToOperand<int32_t>(column_index, original_records, operand_ptrs);
+        break;
+      case BaseSchema::Type::kFloat:
+        status = TransColumnToOperand<float>(column_index, original_records, operand_ptrs);
+        break;
+      case BaseSchema::Type::kLong:
+        status = TransColumnToOperand<int64_t>(column_index, original_records, operand_ptrs);
+        break;
+      case BaseSchema::Type::kDouble:
+        status = TransColumnToOperand<double>(column_index, original_records, operand_ptrs);
+        break;
+      case BaseSchema::Type::kString:
+        status = TransColumnToOperand<std::shared_ptr<std::string>>(column_index, original_records, operand_ptrs);
+        break;
+      case BaseSchema::Type::kBoolList:
+        status =
+            TransColumnToOperand<std::shared_ptr<std::vector<bool>>>(column_index, original_records, operand_ptrs);
+        break;
+      case BaseSchema::Type::kIntegerList:
+        status =
+            TransColumnToOperand<std::shared_ptr<std::vector<int32_t>>>(column_index, original_records, operand_ptrs);
+        break;
+      case BaseSchema::Type::kFloatList:
+        status =
+            TransColumnToOperand<std::shared_ptr<std::vector<float>>>(column_index, original_records, operand_ptrs);
+        break;
+      case BaseSchema::Type::kLongList:
+        status =
+            TransColumnToOperand<std::shared_ptr<std::vector<int64_t>>>(column_index, original_records, operand_ptrs);
+        break;
+      case BaseSchema::Type::kDoubleList:
+        status =
+            TransColumnToOperand<std::shared_ptr<std::vector<double>>>(column_index, original_records, operand_ptrs);
+        break;
+      case BaseSchema::Type::kStringList:
+        status = TransColumnToOperand<std::shared_ptr<std::vector<std::string>>>(column_index, original_records,
+                                                                                 operand_ptrs);
+        break;
+      default: {
+        std::string s =
+            fmt::format("CloneColumn unsupported type  {}", BaseSchema::GetTypeString(column_types[column_index]));
+        DINGO_LOG(ERROR) << s;
+        return butil::Status(pb::error::EILLEGAL_PARAMTETERS, s);
+      }
+    }
+
+    if (!status.ok()) {
+      return status;
+    }
+  }
+
+  return butil::Status();
+}
+
 butil::Status RelExprHelper::TransFromOperandWrapper(
     const std::unique_ptr<std::vector<expr::Operand>>& operand_ptr,
     const std::shared_ptr<std::vector<std::shared_ptr<BaseSchema>>>& result_serial_schemas,
@@ -98,6 +98,12 @@ class RelExprHelper {
       const std::vector<int>& selection_column_indexes, const std::vector<std::any>& original_record,
       std::unique_ptr<std::vector<expr::Operand>>& operand_ptr);  // NOLINT
 
+  // Trans a batch of records column by column, the type of a column is dispatched once for all the rows.
+  // column_types index = column index of record ; value = type of the column.
+  static butil::Status TransToOperandBatch(
+      const std::vector<BaseSchema::Type>& column_types, const std::vector<std::vector<std::any>>& original_records,
+      std::vector<std::unique_ptr<std::vector<expr::Operand>>>& operand_ptrs);  // NOLINT
+
   static butil::Status TransFromOperandWrapper(
       const std::unique_ptr<std::vector<expr::Operand>>& operand_ptr,
       const std::shared_ptr<std::vector<std::shared_ptr<BaseSchema>>>& result_serial_schemas,
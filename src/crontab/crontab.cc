@@ -14,14 +14,53 @@
 
 #include "crontab/crontab.h"
 
+#include <algorithm>
+#include <cstdint>
+
 #include "bthread/bthread.h"
 #include "bthread/unstable.h"
+#include "butil/fast_rand.h"
+#include "bvar/passive_status.h"
+#include "bvar/reducer.h"
+#include "bvar/window.h"
+#include "common/helper.h"
 #include "common/logging.h"
 #include "common/role.h"
 #include "fmt/core.h"
+#include "gflags/gflags.h"
 
 namespace dingodb {
 
+DEFINE_bool(enable_crontab_load_aware_schedule, false,
+            "stagger heavy crontabs across their interval with jitter, and defer them when the foreground is busy");
+DEFINE_double(crontab_heavy_jitter_ratio, 0.1, "heavy crontab interval jitter ratio, at most 0.5");
+DEFINE_int64(crontab_heavy_defer_queue_wait_us, 20000,
+             "defer heavy crontab when the foreground queue wait time exceeds it");
+DEFINE_int64(crontab_heavy_defer_ms, 1000, "heavy crontab defer time");
+DEFINE_uint32(crontab_heavy_max_defer_count, 30, "heavy crontab runs anyway after deferred so many times");
+
+static bvar::Adder<int64_t> g_crontab_run_time_us("dingo_crontab_run_time_us");
+static bvar::Window<bvar::Adder<int64_t>> g_crontab_run_time_window(&g_crontab_run_time_us, 60);
+static bvar::Adder<int64_t> g_crontab_heavy_defer_count("dingo_crontab_heavy_defer_count");
+
+// run time of crontabs and the work they trigger in last 60 seconds / cpu time of all cores,
+// the run time is a upper bound of cpu time
+static double GetBackgroundCpuShare(void*) {
+  return static_cast<double>(g_crontab_run_time_window.get_value()) / (60.0 * 1000 * 1000 * Helper::GetCores());
+}
+
+static bvar::PassiveStatus<double> g_crontab_background_cpu_share("dingo_crontab_background_cpu_share",
+                                                                  GetBackgroundCpuShare, nullptr);
+
+CrontabRunTimeGuard::CrontabRunTimeGuard() : start_time_us_(Helper::TimestampUs()) {}
+
+CrontabRunTimeGuard::~CrontabRunTimeGuard() { g_crontab_run_time_us << Helper::TimestampUs() - start_time_us_; }
+
+static void RunAndAccount(const std::function<void(void*)>& func, void* arg) {
+  CrontabRunTimeGuard guard;
+  func(arg);
+}
+
 CrontabManager::CrontabManager() { bthread_mutex_init(&mutex_, nullptr); }
 
 CrontabManager::~CrontabManager() { bthread_mutex_destroy(&mutex_); }
@@ -31,7 +70,17 @@ void CrontabManager::Run(void* arg) {
   if (crontab->pause) {
     return;
   }
+
+  int64_t delay = NextDelay(*crontab);
   if (crontab->immediately) {
+    if (ShouldDefer(*crontab)) {
+      ++crontab->defer_count;
+      g_crontab_heavy_defer_count << 1;
+      bthread_timer_add(&crontab->timer_id, butil::milliseconds_from_now(FLAGS_crontab_heavy_defer_ms), &Run, crontab);
+      return;
+    }
+    crontab->defer_count = 0;
+
     try {
       crontab->func(crontab->arg);
     } catch (...) {
@@ -41,34 +90,73 @@ void CrontabManager::Run(void* arg) {
     ++crontab->run_count;
   } else {
     crontab->immediately = true;
+    delay += crontab->start_delay;
   }
 
   if (crontab->max_times == 0 || crontab->run_count < crontab->max_times) {
-    bthread_timer_add(&crontab->timer_id, butil::milliseconds_from_now(crontab->interval), &Run, crontab);
+    bthread_timer_add(&crontab->timer_id, butil::milliseconds_from_now(delay), &Run, crontab);
+  }
+}
+
+int64_t CrontabManager::NextDelay(const Crontab& crontab) {
+  if (!FLAGS_enable_crontab_load_aware_schedule || crontab.cost != CrontabCost::kHeavy) {
+    return crontab.interval;
+  }
+
+  // the heavy crontabs with multiple intervals not line up forever
+  int64_t jitter = static_cast<int64_t>(crontab.interval * std::clamp(FLAGS_crontab_heavy_jitter_ratio, 0.0, 0.5));
+  if (jitter <= 0) {
+    return crontab.interval;
   }
+
+  return crontab.interval - jitter + static_cast<int64_t>(butil::fast_rand_less_than(2 * jitter + 1));
+}
+
+bool CrontabManager::ShouldDefer(const Crontab& crontab) {
+  if (!FLAGS_enable_crontab_load_aware_schedule || crontab.cost != CrontabCost::kHeavy ||
+      crontab.load_probe == nullptr) {
+    return false;
+  }
+
+  // not starve the heavy crontab under long busy time
+  if (crontab.defer_count >= FLAGS_crontab_heavy_max_defer_count) {
+    return false;
+  }
+
+  return crontab.load_probe() > FLAGS_crontab_heavy_defer_queue_wait_us;
 }
 
 uint32_t CrontabManager::AllocCrontabId() { return auinc_crontab_id_.fetch_add(1); }
 
 void CrontabManager::AddCrontab(std::vector<CrontabConfig>& crontab_configs) {
+  // Check whether should add crontab.
+  auto should_add_crontab = [](const CrontabConfig& crontab_config) -> bool {
+    return std::find(crontab_config.roles.begin(), crontab_config.roles.end(), GetRole()) !=
+           crontab_config.roles.end();
+  };
+
+  // the heavy crontabs start at evenly spaced offsets of their interval
+  int64_t heavy_num = std::count_if(crontab_configs.begin(), crontab_configs.end(), [&](const auto& crontab_config) {
+    return crontab_config.cost == CrontabCost::kHeavy && should_add_crontab(crontab_config);
+  });
+  int64_t heavy_no = 0;
+
   for (auto& crontab_config : crontab_configs) {
-    // Check whether should add crontab.
-    bool should_add_crontab = false;
-    for (auto role : crontab_config.roles) {
-      if (role == GetRole()) {
-        should_add_crontab = true;
-      }
-    }
-    if (!should_add_crontab) {
+    if (!should_add_crontab(crontab_config)) {
       continue;
     }
 
-    DINGO_LOG(INFO) << fmt::format("[crontab.add][name({}).interval({}ms).async({})] add crontab task.",
-                                   crontab_config.name, crontab_config.interval, crontab_config.async);
+    DINGO_LOG(INFO) << fmt::format("[crontab.add][name({}).interval({}ms).async({}).heavy({})] add crontab task.",
+                                   crontab_config.name, crontab_config.interval, crontab_config.async,
+                                   crontab_config.cost == CrontabCost::kHeavy);
 
     auto crontab = std::make_shared<Crontab>();
     crontab->name = crontab_config.name;
     crontab->interval = crontab_config.interval;
+    crontab->cost = crontab_config.cost;
+    if (FLAGS_enable_crontab_load_aware_schedule && crontab->cost == CrontabCost::kHeavy) {
+      crontab->start_delay = crontab->interval * heavy_no++ / heavy_num;
+    }
     if (crontab_config.async) {
       crontab->func = [&](void*) {
         bthread_t tid;
@@ -77,13 +165,13 @@ void CrontabManager::AddCrontab(std::vector<CrontabConfig>& crontab_configs) {
             &tid, &attr,
             [](void* arg) -> void* {
               CrontabConfig* crontab_config = static_cast<CrontabConfig*>(arg);
-              crontab_config->funcer(nullptr);
+              RunAndAccount(crontab_config->funcer, nullptr);
               return nullptr;
             },
             &crontab_config);
       };
     } else {
-      crontab->func = crontab_config.funcer;
+      crontab->func = [&](void* arg) { RunAndAccount(crontab_config.funcer, arg); };
     }
 
     crontab->arg = nullptr;
@@ -104,6 +192,9 @@ uint32_t CrontabManager::AddCrontab(std::shared_ptr<Crontab> crontab) {
 
   uint32_t crontab_id = AllocCrontabId();
   crontab->id = crontab_id;
+  if (crontab->load_probe == nullptr) {
+    crontab->load_probe = load_probe_;
+  }
 
   crontabs_[crontab_id] = crontab;
   return crontab_id;
@@ -28,12 +28,20 @@
 
 namespace dingodb {
 
+// Cost class of crontab, the heavy ones(e.g. split check, gc, snapshot, scrub) are staggered across their interval
+// and deferred when the foreground is busy if load aware schedule is enabled.
+enum class CrontabCost : unsigned char {
+  kLight = 0,
+  kHeavy = 1,
+};
+
 struct CrontabConfig {
   std::string name;
   std::vector<pb::common::ClusterRole> roles;
   int32_t interval;
   bool async;
   std::function<void(void*)> funcer;
+  CrontabCost cost{CrontabCost::kLight};
 };
 
 class Crontab {
@@ -56,6 +64,28 @@ class Crontab {
   std::function<void(void*)> func;
   // Delivery to func_'s argument
   void* arg{nullptr};
+
+  CrontabCost cost{CrontabCost::kLight};
+  // unit ms, delay of the first run
+  int64_t start_delay{0};
+  // Deferred count of current run, reset after run
+  uint32_t defer_count{0};
+  // Return the foreground queue wait time(us), nullptr is idle
+  std::function<int64_t()> load_probe;
+};
+
+// Account the run time of its scope in dingo_crontab_background_cpu_share. The async heavy crontab(e.g. split check,
+// scrub, raft snapshot) only triggers the work to other workers, the triggered work accounts itself with it.
+class CrontabRunTimeGuard {
+ public:
+  CrontabRunTimeGuard();
+  ~CrontabRunTimeGuard();
+
+  CrontabRunTimeGuard(const CrontabRunTimeGuard&) = delete;
+  const CrontabRunTimeGuard& operator=(const CrontabRunTimeGuard&) = delete;
+
+ private:
+  int64_t start_time_us_;
 };
 
 // Manage crontab use brpc::bthread_timer_add
@@ -79,6 +109,14 @@ class CrontabManager {
 
   void Destroy();
 
+  // Probe the foreground load for load aware schedule, set before adding crontab.
+  void SetLoadProbe(std::function<int64_t()> load_probe) { load_probe_ = load_probe; }
+
+  // The delay of next run of the crontab, interval with jitter for the heavy one.
+  static int64_t NextDelay(const Crontab& crontab);
+  // Whether defer the heavy crontab for the busy foreground.
+  static bool ShouldDefer(const Crontab& crontab);
+
  private:
   // Allocate crontab id by auto incremental.
   uint32_t AllocCrontabId();
@@ -91,6 +129,8 @@ class CrontabManager {
   bthread_mutex_t mutex_;
   // Store all crontab, key(crontab_id) / value(Crontab)
   std::map<uint32_t, std::shared_ptr<Crontab> > crontabs_;
+
+  std::function<int64_t()> load_probe_;
 };
 
 }  // namespace dingodb
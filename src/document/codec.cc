@@ -14,17 +14,21 @@
 
 #include "document/codec.h"
 
+#include <cerrno>
 #include <cstdint>
+#include <cstdlib>
 #include <nlohmann/json.hpp>
+#include <string>
+#include <utility>
+#include <vector>
 
 #include "butil/compiler_specific.h"
 #include "common/constant.h"
 #include "common/helper.h"
+#include "common/key_codec.h"
 #include "common/logging.h"
 #include "fmt/core.h"
 #include "nlohmann/json_fwd.hpp"
-#include "serial/buf.h"
-#include "serial/schema/long_schema.h"
 #include "tantivy_search.h"
 
 namespace dingodb {
@@ -35,11 +39,10 @@ void DocumentCodec::EncodeDocumentKey(char prefix, int64_t partition_id, std::st
     DINGO_LOG(FATAL) << "Encode document key failed, prefix is 0, partition_id:[" << partition_id << "]";
   }
 
-  // Buf buf(17);
-  Buf buf(Constant::kDocumentKeyMinLenWithPrefix);
-  buf.Write(prefix);
-  buf.WriteLong(partition_id);
-  buf.GetBytes(result);
+  result.clear();
+  result.reserve(Constant::kDocumentKeyMinLenWithPrefix);
+  result.push_back(prefix);
+  KeyCodec::AppendInt64(result, partition_id);
 }
 
 void DocumentCodec::EncodeDocumentKey(char prefix, int64_t partition_id, int64_t document_id, std::string& result) {
@@ -55,12 +58,11 @@ void DocumentCodec::EncodeDocumentKey(char prefix, int64_t partition_id, int64_t
                      << document_id << "]";
   }
 
-  // Buf buf(17);
-  Buf buf(Constant::kDocumentKeyMaxLenWithPrefix);
-  buf.Write(prefix);
-  buf.WriteLong(partition_id);
-  DingoSchema<std::optional<int64_t>>::InternalEncodeKey(&buf, document_id);
-  buf.GetBytes(result);
+  result.clear();
+  result.reserve(Constant::kDocumentKeyMaxLenWithPrefix);
+  result.push_back(prefix);
+  KeyCodec::AppendInt64(result, partition_id);
+  KeyCodec::AppendComparableInt64(result, document_id);
 }
 
 void DocumentCodec::EncodeDocumentKey(char prefix, int64_t partition_id, int64_t document_id,
@@ -75,19 +77,17 @@ void DocumentCodec::EncodeDocumentKey(char prefix, int64_t partition_id, int64_t
                      << partition_id << "], document_id:[" << document_id << "]";
   }
 
-  // Buf buf(17 +  scalar_key.size());
-  Buf buf(Constant::kDocumentKeyMaxLenWithPrefix + scalar_key.size());
-  buf.Write(prefix);
-  buf.WriteLong(partition_id);
-  DingoSchema<std::optional<int64_t>>::InternalEncodeKey(&buf, document_id);
-  buf.Write(scalar_key);
-  buf.GetBytes(result);
+  result.clear();
+  result.reserve(Constant::kDocumentKeyMaxLenWithPrefix + scalar_key.size());
+  result.push_back(prefix);
+  KeyCodec::AppendInt64(result, partition_id);
+  KeyCodec::AppendComparableInt64(result, document_id);
+  result.append(scalar_key);
 }
 
 int64_t DocumentCodec::DecodeDocumentId(const std::string& value) {
-  Buf buf(value);
   if (value.size() >= Constant::kDocumentKeyMaxLenWithPrefix) {
-    buf.Skip(9);
+    return KeyCodec::DecodeComparableInt64(value.data() + Constant::kDocumentKeyMinLenWithPrefix);
   } else if (value.size() == Constant::kDocumentKeyMinLenWithPrefix) {
     return 0;
   } else {
@@ -95,33 +95,29 @@ int64_t DocumentCodec::DecodeDocumentId(const std::string& value) {
                      << "]";
     return 0;
   }
-
-  // return buf.ReadLong();
-  return DingoSchema<std::optional<int64_t>>::InternalDecodeKey(&buf);
 }
 
 int64_t DocumentCodec::DecodePartitionId(const std::string& value) {
-  Buf buf(value);
-
-  // if (value.size() >= 17 || value.size() == 9) {
   if (value.size() >= Constant::kDocumentKeyMaxLenWithPrefix ||
       value.size() == Constant::kDocumentKeyMinLenWithPrefix) {
-    buf.Skip(1);
+    return KeyCodec::DecodeInt64(value.data() + 1);
+  }
+
+  if (BAIDU_UNLIKELY(value.size() < 8)) {
+    DINGO_LOG(ERROR) << "Decode partition id failed, value size < 8, value:[" << Helper::StringToHex(value) << "]";
+    return 0;
   }
 
-  return buf.ReadLong();
+  return KeyCodec::DecodeInt64(value.data());
 }
 
 std::string DocumentCodec::DecodeScalarKey(const std::string& value) {
-  Buf buf(value);
   if (value.size() <= Constant::kDocumentKeyMaxLenWithPrefix) {
     DINGO_LOG(FATAL) << "Decode scalar key failed, value size <=17, value:[" << Helper::StringToHex(value) << "]";
     return "";
   }
 
-  buf.Skip(Constant::kDocumentKeyMaxLenWithPrefix);
-
-  return buf.ReadString();
+  return value.substr(Constant::kDocumentKeyMaxLenWithPrefix);
 }
 
 std::string DocumentCodec::DecodeKeyToString(const std::string& key) {
@@ -259,4 +255,142 @@ std::string DocumentCodec::GetTokenizerTypeString(TokenizerType type) {
   }
 }
 
-}  // namespace dingodb
\ No newline at end of file
+bool DocumentCodec::ParseScalarFilter(const std::string& expression, std::vector<DocumentScalarFilter>& filters,
+                                      std::string& error_message) {
+  std::vector<std::string> items;
+  Helper::SplitString(expression, ';', items);
+  for (const auto& item : items) {
+    if (item.empty()) {
+      continue;
+    }
+
+    auto pos = item.find_first_of("=<>");
+    if (pos == std::string::npos || pos == 0) {
+      error_message = fmt::format("illegal filter({})", item);
+      return false;
+    }
+
+    DocumentScalarFilter filter;
+    filter.column = item.substr(0, pos);
+    size_t op_size = (item[pos] != '=' && pos + 1 < item.size() && item[pos + 1] == '=') ? 2 : 1;
+    filter.op = item.substr(pos, op_size);
+    filter.value = item.substr(pos + op_size);
+    if (filter.value.empty()) {
+      error_message = fmt::format("illegal filter({}), value is empty", item);
+      return false;
+    }
+
+    filters.push_back(std::move(filter));
+  }
+
+  return true;
+}
+
+static bool IsInt64(const std::string& value) {
+  char* end = nullptr;
+  errno = 0;
+  std::strtoll(value.c_str(), &end, 10);
+  return errno == 0 && end != value.c_str() && *end == '\0';
+}
+
+static bool IsDouble(const std::string& value) {
+  char* end = nullptr;
+  errno = 0;
+  std::strtod(value.c_str(), &end);
+  return errno == 0 && end != value.c_str() && *end == '\0';
+}
+
+static std::string QuoteTerm(const std::string& value) {
+  std::string result = "\"";
+  for (char c : value) {
+    if (c == '"' || c == '\\') {
+      result.push_back('\\');
+    }
+    result.push_back(c);
+  }
+  result.push_back('"');
+  return result;
+}
+
+bool DocumentCodec::GenScalarFilterQueryString(const pb::common::ScalarSchema& scalar_schema,
+                                               const std::string& query_string,
+                                               const std::vector<DocumentScalarFilter>& filters, std::string& result,
+                                               std::string& error_message) {
+  std::vector<std::string> clauses;
+  if (!query_string.empty()) {
+    clauses.push_back(fmt::format("({})", query_string));
+  }
+
+  for (const auto& filter : filters) {
+    const pb::common::ScalarSchemaItem* field = nullptr;
+    for (const auto& item : scalar_schema.fields()) {
+      if (item.key() == filter.column) {
+        field = &item;
+        break;
+      }
+    }
+    if (field == nullptr) {
+      error_message = fmt::format("column({}) is not declared in document index", filter.column);
+      return false;
+    }
+
+    bool is_number = false;
+    switch (field->field_type()) {
+      case pb::common::ScalarFieldType::INT64:
+        is_number = true;
+        if (!IsInt64(filter.value)) {
+          error_message = fmt::format("column({}) value({}) is not int64", filter.column, filter.value);
+          return false;
+        }
+        break;
+      case pb::common::ScalarFieldType::DOUBLE:
+        is_number = true;
+        if (!IsDouble(filter.value)) {
+          error_message = fmt::format("column({}) value({}) is not double", filter.column, filter.value);
+          return false;
+        }
+        break;
+      case pb::common::ScalarFieldType::STRING:
+        break;
+      default:
+        error_message = fmt::format("column({}) type({}) not support filter", filter.column,
+                                    pb::common::ScalarFieldType_Name(field->field_type()));
+        return false;
+    }
+
+    if (filter.op == "=") {
+      clauses.push_back(fmt::format("{}:{}", filter.column, is_number ? filter.value : QuoteTerm(filter.value)));
+      continue;
+    }
+
+    if (!is_number) {
+      error_message = fmt::format("column({}) range filter only support int64 and double", filter.column);
+      return false;
+    }
+
+    if (filter.op == ">") {
+      clauses.push_back(fmt::format("{}:{{{} TO *}}", filter.column, filter.value));
+    } else if (filter.op == ">=") {
+      clauses.push_back(fmt::format("{}:[{} TO *}}", filter.column, filter.value));
+    } else if (filter.op == "<") {
+      clauses.push_back(fmt::format("{}:{{* TO {}}}", filter.column, filter.value));
+    } else if (filter.op == "<=") {
+      clauses.push_back(fmt::format("{}:{{* TO {}]", filter.column, filter.value));
+    } else {
+      error_message = fmt::format("column({}) illegal op({})", filter.column, filter.op);
+      return false;
+    }
+  }
+
+  result.clear();
+  for (size_t i = 0; i < clauses.size(); ++i) {
+    if (i > 0) {
+      result += " AND ";
+    }
+    result += clauses[i];
+  }
+
+  return true;
+}
+
+}  // namespace dingodb
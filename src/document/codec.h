@@ -16,7 +16,9 @@
 #define DINGODB_DOCUMENT_CODEC_H_
 
 #include <cstdint>
+#include <map>
 #include <string>
+#include <vector>
 
 #include "proto/common.pb.h"
 
@@ -30,6 +32,14 @@ enum TokenizerType {
   kTokenizerTypeBytes = 4,
 };
 
+// Scalar filter on a declared column, e.g. i64>=10
+struct DocumentScalarFilter {
+  std::string column;
+  // one of = > >= < <=
+  std::string op;
+  std::string value;
+};
+
 class DocumentCodec {
  public:
   static void EncodeDocumentKey(char prefix, int64_t partition_id, std::string& result);
@@ -58,6 +68,16 @@ class DocumentCodec {
                                                std::string& json_parameter, std::string& error_message);
 
   static std::string GetTokenizerTypeString(TokenizerType type);
+
+  // Parse semicolon separated filters, e.g. "i64>=10;f64<2.5;text=hello".
+  static bool ParseScalarFilter(const std::string& expression, std::vector<DocumentScalarFilter>& filters,
+                                std::string& error_message);
+  // Push filters into the tantivy query as term or range clauses of the declared columns, so they are evaluated
+  // in the index before top-k instead of on fetched rows. Range is only for INT64 and DOUBLE columns.
+  static bool GenScalarFilterQueryString(const pb::common::ScalarSchema& scalar_schema,
+                                         const std::string& query_string,
+                                         const std::vector<DocumentScalarFilter>& filters, std::string& result,
+                                         std::string& error_message);
 };
 
 }  // namespace dingodb
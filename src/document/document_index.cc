@@ -14,6 +14,7 @@
 
 #include "document/document_index.h"
 
+#include <atomic>
 #include <cstdint>
 #include <memory>
 #include <string>
@@ -21,12 +22,15 @@
 
 #include "bthread/bthread.h"
 #include "butil/status.h"
+#include "bvar/reducer.h"
 #include "common/constant.h"
 #include "common/helper.h"
 #include "common/logging.h"
 #include "document/codec.h"
+#include "document/document_index_merge_scheduler.h"
 #include "document/document_index_snapshot_manager.h"
 #include "fmt/core.h"
+#include "gflags/gflags.h"
 #include "proto/common.pb.h"
 #include "proto/error.pb.h"
 #include "server/server.h"
@@ -34,6 +38,22 @@
 
 namespace dingodb {
 
+DEFINE_int64(document_index_group_commit_max_count, 10000,
+             "document index group commit when pending write count reach it, 0 means commit every write");
+DEFINE_int64(document_index_group_commit_interval_ms, 1000,
+             "document index group commit when the time since last commit reach it");
+DEFINE_bool(enable_document_index_event_scrub, false,
+            "scrub the document indexes marked dirty by write instead of sweeping all the document indexes");
+DEFINE_int64(document_index_event_scrub_write_key_num, 10, "write key num to mark document index dirty for scrub");
+
+static bvar::Adder<int64_t> g_document_index_evict_count("dingo_document_index_evict_count");
+static bvar::Adder<int64_t> g_document_index_reload_count("dingo_document_index_reload_count");
+
+// unique in the process, so a rebuilt index never reuses the generation of the old one.
+static std::atomic<int64_t> g_document_index_generation{0};
+
+static int64_t NextGeneration() { return g_document_index_generation.fetch_add(1, std::memory_order_relaxed) + 1; }
+
 butil::Status DocumentIndex::RemoveIndexFiles(int64_t id, const std::string& index_path) {
   DINGO_LOG(INFO) << fmt::format("[document_index.raw][id({})] remove index files, path: {}", id, index_path);
   Helper::RemoveAllFileOrDirectory(index_path);
@@ -49,7 +69,12 @@ DocumentIndex::DocumentIndex(int64_t id, const std::string& index_path,
       snapshot_log_id(0),
       document_index_parameter(document_index_parameter),
       epoch(epoch),
-      range(range) {
+      range(range),
+      last_commit_time_ms_(Helper::TimestampMs()),
+      last_access_time_ms_(Helper::TimestampMs()),
+      generation_(NextGeneration()) {
+  bthread_mutex_init(&write_mutex_, nullptr);
+  bthread_mutex_init(&reader_mutex_, nullptr);
   DINGO_LOG(DEBUG) << fmt::format("[new.DocumentIndex][id({})]", id);
 }
 
@@ -58,15 +83,19 @@ DocumentIndex::~DocumentIndex() {
 
   RWLockReadGuard guard(&rw_lock_);
 
-  auto bool_result = ffi_free_index_writer(index_path);
-  if (!bool_result.result) {
-    DINGO_LOG(ERROR) << fmt::format("[document_index.raw][id({})] free index writer failed, error: {}, error_msg: {}",
-                                    id, bool_result.error_code, bool_result.error_msg.c_str());
+  if (writer_loaded_) {
+    auto bool_result = ffi_free_index_writer(index_path);
+    if (!bool_result.result) {
+      DINGO_LOG(ERROR) << fmt::format("[document_index.raw][id({})] free index writer failed, error: {}, error_msg: {}",
+                                      id, bool_result.error_code, bool_result.error_msg.c_str());
+    }
   }
-  bool_result = ffi_free_index_reader(index_path);
-  if (!bool_result.result) {
-    DINGO_LOG(ERROR) << fmt::format("[document_index.raw][id({})] free index reader failed, error: {}, error_msg: {}",
-                                    id, bool_result.error_code, bool_result.error_msg.c_str());
+  if (reader_loaded_) {
+    auto bool_result = ffi_free_index_reader(index_path);
+    if (!bool_result.result) {
+      DINGO_LOG(ERROR) << fmt::format("[document_index.raw][id({})] free index reader failed, error: {}, error_msg: {}",
+                                      id, bool_result.error_code, bool_result.error_msg.c_str());
+    }
   }
 
   if (is_destroyed_) {
@@ -74,6 +103,10 @@ DocumentIndex::~DocumentIndex() {
                                    id);
     RemoveIndexFiles(id, index_path);
   }
+
+  guard.Release();
+  bthread_mutex_destroy(&write_mutex_);
+  bthread_mutex_destroy(&reader_mutex_);
 }
 
 void DocumentIndex::SetSnapshotLogId(int64_t snapshot_log_id) {
@@ -98,6 +131,7 @@ void DocumentIndex::SetEpochAndRange(const pb::common::RegionEpoch& epoch, const
                                  Helper::RangeToString(this->range), Helper::RangeToString(range));
   this->epoch = epoch;
   this->range = range;
+  generation_.store(NextGeneration(), std::memory_order_release);
 }
 
 void DocumentIndex::LockWrite() { rw_lock_.LockWrite(); }
@@ -132,7 +166,30 @@ butil::Status DocumentIndex::Add(const std::vector<pb::common::DocumentWithId>&
     return butil::Status::OK();
   }
 
-  RWLockWriteGuard guard(&rw_lock_);
+  RWLockReadGuard guard(&rw_lock_);
+  BAIDU_SCOPED_LOCK(write_mutex_);
+
+  if (is_destroyed_) {
+    std::string err_msg = fmt::format("[document_index.raw][id({})] document index is destroyed", id);
+    DINGO_LOG(ERROR) << err_msg;
+    return butil::Status(pb::error::EILLEGAL_PARAMTETERS, err_msg);
+  }
+
+  auto status = AddDocuments(document_with_ids);
+  if (!status.ok()) {
+    return status;
+  }
+
+  return Commit(reload_reader);
+}
+
+butil::Status DocumentIndex::BulkAdd(const std::vector<pb::common::DocumentWithId>& document_with_ids) {
+  if (document_with_ids.empty()) {
+    return butil::Status::OK();
+  }
+
+  RWLockReadGuard guard(&rw_lock_);
+  BAIDU_SCOPED_LOCK(write_mutex_);
 
   if (is_destroyed_) {
     std::string err_msg = fmt::format("[document_index.raw][id({})] document index is destroyed", id);
@@ -140,6 +197,16 @@ butil::Status DocumentIndex::Add(const std::vector<pb::common::DocumentWithId>&
     return butil::Status(pb::error::EILLEGAL_PARAMTETERS, err_msg);
   }
 
+  return AddDocuments(document_with_ids);
+}
+
+butil::Status DocumentIndex::AddDocuments(const std::vector<pb::common::DocumentWithId>& document_with_ids) {
+  auto status = LoadWriter();
+  if (!status.ok()) {
+    return status;
+  }
+  Touch();
+
   for (const auto& document_with_id : document_with_ids) {
     std::vector<std::string> text_column_names;
     std::vector<std::string> text_column_docs;
@@ -192,6 +259,20 @@ butil::Status DocumentIndex::Add(const std::vector<pb::common::DocumentWithId>&
     }
   }
 
+  pending_commit_count_ += document_with_ids.size();
+  for (const auto& document_with_id : document_with_ids) {
+    pending_commit_bytes_ += document_with_id.ByteSizeLong();
+  }
+
+  return butil::Status::OK();
+}
+
+butil::Status DocumentIndex::Commit(bool reload_reader) {
+  // evicted writer has nothing pending, Evict committed them.
+  if (!writer_loaded_) {
+    return butil::Status::OK();
+  }
+
   auto bool_result = ffi_index_writer_commit(index_path);
   if (!bool_result.result) {
     std::string err_msg = fmt::format("[document_index.raw][id({})] commit failed, error: {}, error_msg: {}", id,
@@ -200,7 +281,13 @@ butil::Status DocumentIndex::Add(const std::vector<pb::common::DocumentWithId>&
     return butil::Status(pb::error::EINTERNAL, err_msg);
   }
 
-  if (reload_reader) {
+  pending_commit_count_ = 0;
+  pending_commit_bytes_ = 0;
+  last_commit_time_ms_ = Helper::TimestampMs();
+
+  // evicted reader sees the commit when loaded again.
+  BAIDU_SCOPED_LOCK(reader_mutex_);
+  if (reload_reader && reader_loaded_) {
     bool_result = ffi_index_reader_reload(index_path);
     if (!bool_result.result) {
       std::string err_msg = fmt::format("[document_index.raw][id({})] reload failed, error: {}, error_msg: {}", id,
@@ -209,6 +296,7 @@ butil::Status DocumentIndex::Add(const std::vector<pb::common::DocumentWithId>&
       return butil::Status(pb::error::EINTERNAL, err_msg);
     }
   }
+  generation_.store(NextGeneration(), std::memory_order_release);
 
   return butil::Status::OK();
 }
@@ -220,7 +308,8 @@ butil::Status DocumentIndex::Delete(const std::vector<int64_t>& delete_ids) {
     return butil::Status::OK();
   }
 
-  RWLockWriteGuard guard(&rw_lock_);
+  RWLockReadGuard guard(&rw_lock_);
+  BAIDU_SCOPED_LOCK(write_mutex_);
 
   if (is_destroyed_) {
     std::string err_msg = fmt::format("[document_index.raw][id({})] document index is destroyed", id);
@@ -246,6 +335,12 @@ butil::Status DocumentIndex::Delete(const std::vector<int64_t>& delete_ids) {
     delete_ids_uint64.push_back(delete_id);
   }
 
+  auto status = LoadWriter();
+  if (!status.ok()) {
+    return status;
+  }
+  Touch();
+
   auto bool_result = ffi_delete_row_ids(index_path, delete_ids_uint64);
   if (!bool_result.result) {
     std::string err_msg = fmt::format("[document_index.raw][id({})] delete failed, error: {}, error_msg: {}", id,
@@ -254,6 +349,207 @@ butil::Status DocumentIndex::Delete(const std::vector<int64_t>& delete_ids) {
     return butil::Status(pb::error::EINTERNAL, err_msg);
   }
 
+  pending_commit_count_ += delete_ids.size();
+  pending_commit_bytes_ += delete_ids.size() * sizeof(int64_t);
+
+  return butil::Status::OK();
+}
+
+butil::Status DocumentIndex::GroupUpsert(const std::vector<pb::common::DocumentWithId>& document_with_ids) {
+  if (document_with_ids.empty()) {
+    return butil::Status::OK();
+  }
+
+  std::vector<int64_t> delete_ids;
+  delete_ids.reserve(document_with_ids.size());
+  for (const auto& document_with_id : document_with_ids) {
+    delete_ids.push_back(document_with_id.id());
+  }
+
+  auto status = Delete(delete_ids);
+  if (!status.ok()) {
+    return status;
+  }
+
+  return GroupAdd(document_with_ids);
+}
+
+butil::Status DocumentIndex::GroupAdd(const std::vector<pb::common::DocumentWithId>& document_with_ids) {
+  if (document_with_ids.empty()) {
+    return butil::Status::OK();
+  }
+
+  RWLockReadGuard guard(&rw_lock_);
+  BAIDU_SCOPED_LOCK(write_mutex_);
+
+  if (is_destroyed_) {
+    std::string err_msg = fmt::format("[document_index.raw][id({})] document index is destroyed", id);
+    DINGO_LOG(ERROR) << err_msg;
+    return butil::Status(pb::error::EILLEGAL_PARAMTETERS, err_msg);
+  }
+
+  auto status = AddDocuments(document_with_ids);
+  if (!status.ok()) {
+    return status;
+  }
+
+  if (!NeedGroupCommit()) {
+    return butil::Status::OK();
+  }
+
+  DocumentIndexMergeScheduler::GetInstance().Charge(pending_commit_bytes_);
+  return Commit(true);
+}
+
+butil::Status DocumentIndex::GroupDelete(const std::vector<int64_t>& delete_ids) {
+  auto status = Delete(delete_ids);
+  if (!status.ok()) {
+    return status;
+  }
+
+  return GroupCommit(false);
+}
+
+butil::Status DocumentIndex::GroupCommit(bool force) {
+  RWLockReadGuard guard(&rw_lock_);
+  BAIDU_SCOPED_LOCK(write_mutex_);
+
+  if (is_destroyed_ || pending_commit_count_ == 0) {
+    return butil::Status::OK();
+  }
+
+  if (!force && !NeedGroupCommit()) {
+    return butil::Status::OK();
+  }
+
+  if (!force) {
+    DocumentIndexMergeScheduler::GetInstance().Charge(pending_commit_bytes_);
+  }
+
+  DINGO_LOG(DEBUG) << fmt::format("[document_index.raw][id({})] group commit pending count({})", id,
+                                  pending_commit_count_);
+
+  return Commit(true);
+}
+
+int64_t DocumentIndex::PendingCommitCount() {
+  BAIDU_SCOPED_LOCK(write_mutex_);
+  return pending_commit_count_;
+}
+
+int64_t DocumentIndex::PendingCommitBytes() {
+  BAIDU_SCOPED_LOCK(write_mutex_);
+  return pending_commit_bytes_;
+}
+
+bool DocumentIndex::IsGroupCommitExpired() {
+  BAIDU_SCOPED_LOCK(write_mutex_);
+  return pending_commit_count_ > 0 &&
+         Helper::TimestampMs() - last_commit_time_ms_ >= FLAGS_document_index_group_commit_interval_ms;
+}
+
+bool DocumentIndex::NeedGroupCommit() const {
+  return FLAGS_document_index_group_commit_max_count <= 0 ||
+         pending_commit_count_ >= FLAGS_document_index_group_commit_max_count;
+}
+
+void DocumentIndex::Touch() { last_access_time_ms_.store(Helper::TimestampMs(), std::memory_order_relaxed); }
+
+butil::Status DocumentIndex::LoadWriter() {
+  if (writer_loaded_) {
+    return butil::Status::OK();
+  }
+
+  auto bool_result = ffi_load_index_writer(index_path);
+  if (!bool_result.result) {
+    std::string err_msg = fmt::format("[document_index.raw][id({})] load index writer failed, error: {}, error_msg: {}",
+                                      id, bool_result.error_code, bool_result.error_msg.c_str());
+    DINGO_LOG(ERROR) << err_msg;
+    return butil::Status(pb::error::EINTERNAL, err_msg);
+  }
+
+  writer_loaded_ = true;
+  g_document_index_reload_count << 1;
+  DINGO_LOG(INFO) << fmt::format("[document_index.raw][id({})] reload evicted index writer", id);
+
+  return butil::Status::OK();
+}
+
+butil::Status DocumentIndex::LoadReader() {
+  BAIDU_SCOPED_LOCK(reader_mutex_);
+  if (reader_loaded_) {
+    return butil::Status::OK();
+  }
+
+  auto bool_result = ffi_load_index_reader(index_path);
+  if (!bool_result.result) {
+    std::string err_msg = fmt::format("[document_index.raw][id({})] load index reader failed, error: {}, error_msg: {}",
+                                      id, bool_result.error_code, bool_result.error_msg.c_str());
+    DINGO_LOG(ERROR) << err_msg;
+    return butil::Status(pb::error::EINTERNAL, err_msg);
+  }
+
+  reader_loaded_ = true;
+  g_document_index_reload_count << 1;
+  DINGO_LOG(INFO) << fmt::format("[document_index.raw][id({})] reload evicted index reader", id);
+
+  return butil::Status::OK();
+}
+
+bool DocumentIndex::IsWriterLoaded() {
+  BAIDU_SCOPED_LOCK(write_mutex_);
+  return writer_loaded_;
+}
+
+bool DocumentIndex::IsReaderLoaded() {
+  BAIDU_SCOPED_LOCK(reader_mutex_);
+  return reader_loaded_;
+}
+
+butil::Status DocumentIndex::Evict() {
+  // wait in flight searches and writes.
+  RWLockWriteGuard guard(&rw_lock_);
+  BAIDU_SCOPED_LOCK(write_mutex_);
+
+  if (is_destroyed_) {
+    return butil::Status::OK();
+  }
+
+  if (writer_loaded_) {
+    if (pending_commit_count_ > 0) {
+      auto status = Commit(false);
+      if (!status.ok()) {
+        return status;
+      }
+    }
+
+    auto bool_result = ffi_free_index_writer(index_path);
+    if (!bool_result.result) {
+      std::string err_msg =
+          fmt::format("[document_index.raw][id({})] free index writer failed, error: {}, error_msg: {}", id,
+                      bool_result.error_code, bool_result.error_msg.c_str());
+      DINGO_LOG(ERROR) << err_msg;
+      return butil::Status(pb::error::EINTERNAL, err_msg);
+    }
+    writer_loaded_ = false;
+  }
+
+  BAIDU_SCOPED_LOCK(reader_mutex_);
+  if (reader_loaded_) {
+    auto bool_result = ffi_free_index_reader(index_path);
+    if (!bool_result.result) {
+      std::string err_msg =
+          fmt::format("[document_index.raw][id({})] free index reader failed, error: {}, error_msg: {}", id,
+                      bool_result.error_code, bool_result.error_msg.c_str());
+      DINGO_LOG(ERROR) << err_msg;
+      return butil::Status(pb::error::EINTERNAL, err_msg);
+    }
+    reader_loaded_ = false;
+  }
+
+  g_document_index_evict_count << 1;
+  DINGO_LOG(INFO) << fmt::format("[document_index.raw][id({})] evict to disk", id);
+
   return butil::Status::OK();
 }
 
@@ -278,6 +574,12 @@ butil::Status DocumentIndex::Search(uint32_t topk, const std::string& query_stri
     return butil::Status(pb::error::EILLEGAL_PARAMTETERS, "query string must not be empty");
   }
 
+  auto status = LoadReader();
+  if (!status.ok()) {
+    return status;
+  }
+  Touch();
+
   // if (use_id_filter) {
   //   for (const auto& id : alive_ids) {
   //     if (id < 0 || id >= INT64_MAX) {
@@ -297,8 +599,8 @@ butil::Status DocumentIndex::Search(uint32_t topk, const std::string& query_stri
       result_doc.set_score(row_id_with_score.score);
       results.push_back(result_doc);
 
-      DINGO_LOG(INFO) << fmt::format("[document_index.raw][id({})] search result, row_id({}) score({})", id,
-                                     row_id_with_score.row_id, row_id_with_score.score);
+      DINGO_LOG(DEBUG) << fmt::format("[document_index.raw][id({})] search result, row_id({}) score({})", id,
+                                      row_id_with_score.row_id, row_id_with_score.score);
     }
 
     return butil::Status::OK();
@@ -312,20 +614,24 @@ butil::Status DocumentIndex::Search(uint32_t topk, const std::string& query_stri
 
 butil::Status DocumentIndex::Save(const std::string& /*path*/) {
   // Save need the caller to do LockWrite() and UnlockWrite()
-  auto result = ffi_index_writer_commit(index_path);
-  if (result.result) {
-    return butil::Status::OK();
-  } else {
-    std::string err_msg = fmt::format("[document_index.raw][id({})] save failed, error: {}, error_msg: {}", id,
-                                      result.error_code, result.error_msg.c_str());
-    DINGO_LOG(ERROR) << err_msg;
-    return butil::Status(pb::error::EINTERNAL, err_msg);
+  // commit pending group commit writes, so the snapshot apply log id covers only committed writes.
+  auto status = Commit(true);
+  if (!status.ok()) {
+    DINGO_LOG(ERROR) << fmt::format("[document_index.raw][id({})] save failed, error: {}", id, status.error_str());
   }
+
+  return status;
 }
 
 butil::Status DocumentIndex::Load(const std::string& /*path*/) {
+  BAIDU_SCOPED_LOCK(reader_mutex_);
+  if (!reader_loaded_) {
+    return butil::Status::OK();
+  }
+
   auto result = ffi_index_reader_reload(index_path);
   if (result.result) {
+    generation_.store(NextGeneration(), std::memory_order_release);
     return butil::Status::OK();
   } else {
     std::string err_msg = fmt::format("[document_index.raw][id({})] load failed, error: {}, error_msg: {}", id,
@@ -343,6 +649,11 @@ butil::Status DocumentIndex::GetDocCount(int64_t& count) {
     return butil::Status(pb::error::EILLEGAL_PARAMTETERS, err_msg);
   }
 
+  auto status = LoadReader();
+  if (!status.ok()) {
+    return status;
+  }
+
   count = ffi_get_indexed_doc_counts(index_path);
   return butil::Status::OK();
 }
@@ -355,6 +666,11 @@ butil::Status DocumentIndex::GetTokenCount(int64_t& count) {
     return butil::Status(pb::error::EILLEGAL_PARAMTETERS, err_msg);
   }
 
+  auto status = LoadReader();
+  if (!status.ok()) {
+    return status;
+  }
+
   count = ffi_get_total_num_tokens(index_path);
   return butil::Status::OK();
 }
@@ -367,6 +683,11 @@ butil::Status DocumentIndex::GetMetaJson(std::string& json) {
     return butil::Status(pb::error::EILLEGAL_PARAMTETERS, err_msg);
   }
 
+  auto status = LoadReader();
+  if (!status.ok()) {
+    return status;
+  }
+
   auto string_result = ffi_get_index_meta_json(index_path);
   if (string_result.error_code != 0) {
     std::string err_msg = fmt::format("ffi_get_index_meta_json faild for ({}), error_code: ({}), error_msg: ({})",
@@ -388,6 +709,11 @@ butil::Status DocumentIndex::GetJsonParameter(std::string& json) {
     return butil::Status(pb::error::EILLEGAL_PARAMTETERS, err_msg);
   }
 
+  auto status = LoadReader();
+  if (!status.ok()) {
+    return status;
+  }
+
   auto string_result = ffi_get_index_json_parameter(index_path);
   if (string_result.error_code != 0) {
     std::string err_msg = fmt::format("ffi_get_index_json_parameter faild for ({}), error_code: ({}), error_msg: ({})",
@@ -787,6 +1113,21 @@ bool DocumentIndexWrapper::NeedToRebuild() {
   return document_index->NeedToRebuild();
 }
 
+DirtyIndexQueue& DocumentIndexWrapper::ScrubQueue() {
+  static DirtyIndexQueue queue;
+  return queue;
+}
+
+void DocumentIndexWrapper::MarkScrubDirty() {
+  if (!FLAGS_enable_document_index_event_scrub ||
+      write_key_count_ - last_scrub_write_key_count_ < FLAGS_document_index_event_scrub_write_key_num) {
+    return;
+  }
+
+  last_scrub_write_key_count_ = write_key_count_;
+  ScrubQueue().Mark(Id(), write_key_count_ - last_save_write_key_count_);
+}
+
 bool DocumentIndexWrapper::SupportSave() {
   auto document_index = GetOwnDocumentIndex();
   if (document_index == nullptr) {
@@ -915,25 +1256,27 @@ butil::Status DocumentIndexWrapper::Upsert(const std::vector<pb::common::Documen
   auto sibling_document_index = SiblingDocumentIndex();
   if (sibling_document_index != nullptr) {
     auto status =
-        sibling_document_index->Upsert(FilterDocumentWithId(document_with_ids, sibling_document_index->Range()), true);
+        sibling_document_index->GroupUpsert(FilterDocumentWithId(document_with_ids, sibling_document_index->Range()));
     if (!status.ok()) {
       return status;
     }
 
-    status = document_index->Upsert(FilterDocumentWithId(document_with_ids, document_index->Range()), true);
+    status = document_index->GroupUpsert(FilterDocumentWithId(document_with_ids, document_index->Range()));
     if (!status.ok()) {
       sibling_document_index->Delete(FilterDocumentId(document_with_ids, sibling_document_index->Range()));
       return status;
     }
 
     write_key_count_ += document_with_ids.size();
+    MarkScrubDirty();
 
     return status;
   }
 
-  auto status = document_index->Upsert(document_with_ids, true);
+  auto status = document_index->GroupUpsert(document_with_ids);
   if (status.ok()) {
     write_key_count_ += document_with_ids.size();
+    MarkScrubDirty();
   }
   return status;
 }
@@ -962,25 +1305,27 @@ butil::Status DocumentIndexWrapper::Add(const std::vector<pb::common::DocumentWi
   auto sibling_document_index = SiblingDocumentIndex();
   if (sibling_document_index != nullptr) {
     auto status =
-        sibling_document_index->Add(FilterDocumentWithId(document_with_ids, sibling_document_index->Range()), true);
+        sibling_document_index->GroupAdd(FilterDocumentWithId(document_with_ids, sibling_document_index->Range()));
     if (!status.ok()) {
       return status;
     }
 
-    status = document_index->Add(FilterDocumentWithId(document_with_ids, document_index->Range()), true);
+    status = document_index->GroupAdd(FilterDocumentWithId(document_with_ids, document_index->Range()));
     if (!status.ok()) {
       sibling_document_index->Delete(FilterDocumentId(document_with_ids, sibling_document_index->Range()));
       return status;
     }
 
     write_key_count_ += document_with_ids.size();
+    MarkScrubDirty();
 
     return status;
   }
 
-  auto status = document_index->Add(document_with_ids, true);
+  auto status = document_index->GroupAdd(document_with_ids);
   if (status.ok()) {
     write_key_count_ += document_with_ids.size();
+    MarkScrubDirty();
   }
   return status;
 }
@@ -1008,21 +1353,23 @@ butil::Status DocumentIndexWrapper::Delete(const std::vector<int64_t>& delete_id
   // Exist sibling document index, so need to separate delete document.
   auto sibling_document_index = SiblingDocumentIndex();
   if (sibling_document_index != nullptr) {
-    auto status = sibling_document_index->Delete(FilterDocumentId(delete_ids, sibling_document_index->Range()));
+    auto status = sibling_document_index->GroupDelete(FilterDocumentId(delete_ids, sibling_document_index->Range()));
     if (!status.ok()) {
       return status;
     }
 
-    status = document_index->Delete(FilterDocumentId(delete_ids, document_index->Range()));
+    status = document_index->GroupDelete(FilterDocumentId(delete_ids, document_index->Range()));
     if (status.ok()) {
       write_key_count_ += delete_ids.size();
+      MarkScrubDirty();
     }
     return status;
   }
 
-  auto status = document_index->Delete(delete_ids);
+  auto status = document_index->GroupDelete(delete_ids);
   if (status.ok()) {
     write_key_count_ += delete_ids.size();
+    MarkScrubDirty();
   }
   return status;
 }
@@ -1075,6 +1422,8 @@ static void MergeSearchResult(uint32_t topk, std::vector<pb::common::DocumentWit
 butil::Status DocumentIndexWrapper::Search(const pb::common::Range& region_range,
                                            const pb::common::DocumentSearchParameter& parameter,
                                            std::vector<pb::common::DocumentWithScore>& results) {
+  search_count_.fetch_add(1, std::memory_order_relaxed);
+
   if (!IsReady()) {
     DINGO_LOG(WARNING) << fmt::format("[document_index.wrapper][index_id({})] document index is not ready.", Id());
     return butil::Status(pb::error::EDOCUMENT_INDEX_NOT_FOUND, "document index %lu is not ready.", Id());
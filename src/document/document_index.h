@@ -23,6 +23,7 @@
 
 #include "bthread/types.h"
 #include "butil/status.h"
+#include "common/dirty_index_queue.h"
 #include "common/runnable.h"
 #include "common/synchronization.h"
 #include "document/document_index_snapshot.h"
@@ -60,8 +61,35 @@ class DocumentIndex {
 
   butil::Status Add(const std::vector<pb::common::DocumentWithId>& document_with_ids, bool reload_reader);
 
+  // Add without commit for bulk build, the concurrent callers share the tantivy writer whose indexing threads build
+  // segments independently, caller commit once by GroupCommit(true) after all added.
+  butil::Status BulkAdd(const std::vector<pb::common::DocumentWithId>& document_with_ids);
+
   butil::Status Delete(const std::vector<int64_t>& delete_ids);
 
+  // Group commit for raft apply, writes of consecutive applies share one tantivy commit, which happens in apply
+  // when the pending write count reach document_index_group_commit_max_count, or by DocumentIndexMergeScheduler
+  // after document_index_group_commit_interval_ms passed since last commit.
+  // Pending writes are not searchable until committed.
+  butil::Status GroupUpsert(const std::vector<pb::common::DocumentWithId>& document_with_ids);
+  butil::Status GroupAdd(const std::vector<pb::common::DocumentWithId>& document_with_ids);
+  butil::Status GroupDelete(const std::vector<int64_t>& delete_ids);
+  // Commit pending writes when reach the group commit bound, or always when force.
+  butil::Status GroupCommit(bool force);
+  int64_t PendingCommitCount();
+  int64_t PendingCommitBytes();
+  // Has pending writes and reach the time bound.
+  bool IsGroupCommitExpired();
+
+  // Evict to on disk only mode by DocumentIndexMemoryManager, commit pending writes then free the tantivy writer and
+  // reader, which are loaded again by the next write or search.
+  butil::Status Evict();
+  bool IsWriterLoaded();
+  bool IsReaderLoaded();
+  bool IsEvicted() { return !IsWriterLoaded() && !IsReaderLoaded(); }
+  // Last search or write time.
+  int64_t LastAccessTimeMs() const { return last_access_time_ms_.load(std::memory_order_relaxed); }
+
   butil::Status Save(const std::string& path);
 
   butil::Status Load(const std::string& path);
@@ -108,6 +136,9 @@ class DocumentIndex {
 
   std::string IndexPath() { return index_path; }
 
+  // Changed after every commit, reader reload and range change, the search results of the same generation are same.
+  int64_t Generation() const { return generation_.load(std::memory_order_acquire); }
+
  protected:
   // document index id
   int64_t id;
@@ -126,8 +157,36 @@ class DocumentIndex {
   pb::common::DocumentIndexParameter document_index_parameter;
 
  private:
+  // Caller hold rw_lock_ and write_mutex_.
+  butil::Status AddDocuments(const std::vector<pb::common::DocumentWithId>& document_with_ids);
+  butil::Status Commit(bool reload_reader);
+  bool NeedGroupCommit() const;
+  // Caller hold rw_lock_ and write_mutex_.
+  butil::Status LoadWriter();
+  // Caller hold rw_lock_.
+  butil::Status LoadReader();
+  void Touch();
+
+  // Search only pins the current searcher generation of the tantivy reader, which is refreshed by reload after
+  // commit, so search and write share rw_lock_ in read mode, and write_mutex_ serializes the writer.
+  // rw_lock_ in write mode is for destroy and save snapshot.
   RWLock rw_lock_;
+  bthread_mutex_t write_mutex_;
   bool is_destroyed_{false};
+
+  // Protected by write_mutex_, written but not committed count and bytes.
+  int64_t pending_commit_count_{0};
+  int64_t pending_commit_bytes_{0};
+  int64_t last_commit_time_ms_{0};
+
+  // writer_loaded_ is protected by write_mutex_, reader_loaded_ by reader_mutex_, both are cleared by Evict which
+  // also hold rw_lock_ in write mode, so no search or write is using them.
+  bool writer_loaded_{true};
+  bool reader_loaded_{true};
+  bthread_mutex_t reader_mutex_;
+  std::atomic<int64_t> last_access_time_ms_{0};
+
+  std::atomic<int64_t> generation_{0};
 };
 
 using DocumentIndexPtr = std::shared_ptr<DocumentIndex>;
@@ -249,18 +308,27 @@ class DocumentIndexWrapper : public std::enable_shared_from_this<DocumentIndexWr
   bool NeedToSave(std::string& reason);
   bool SupportSave();
 
+  // The dirty document indexes wait for event driven scrub, priority is the write key count since last save.
+  static DirtyIndexQueue& ScrubQueue();
+
   butil::Status Add(const std::vector<pb::common::DocumentWithId>& document_with_ids);
   butil::Status Upsert(const std::vector<pb::common::DocumentWithId>& document_with_ids);
   butil::Status Delete(const std::vector<int64_t>& delete_ids);
   butil::Status Search(const pb::common::Range& region_range, const pb::common::DocumentSearchParameter& parameter,
                        std::vector<pb::common::DocumentWithScore>& results);
 
+  // Searches since created, for query rate.
+  int64_t SearchCount() const { return search_count_.load(std::memory_order_relaxed); }
+
   // static butil::Status SetDocumentIndexRangeFilter(
   //     DocumentIndexPtr document_index,
   //     std::vector<std::shared_ptr<DocumentIndex::FilterFunctor>>& filters,  // NOLINT
   //     int64_t min_document_id, int64_t max_document_id);
 
  private:
+  // mark dirty for scrub when the write key count since last mark crosses threshold
+  void MarkScrubDirty();
+
   // document index id
   int64_t id_;
   // document index version
@@ -309,9 +377,13 @@ class DocumentIndexWrapper : public std::enable_shared_from_this<DocumentIndexWr
   // write(add/update/delete) key count
   int64_t write_key_count_{0};
   int64_t last_save_write_key_count_{0};
+  // write key count when last marked dirty for scrub
+  int64_t last_scrub_write_key_count_{0};
   // save snapshot threshold write key num
   int64_t save_snapshot_threshold_write_key_num_;
 
+  std::atomic<int64_t> search_count_{0};
+
   // need hold document index
   // std::atomic<bool> is_hold_document_index_;
 };
@@ -31,8 +31,11 @@
 #include "document/codec.h"
 #include "document/document_index.h"
 #include "document/document_index_factory.h"
+#include "document/document_index_memory_manager.h"
+#include "document/document_index_merge_scheduler.h"
 #include "document/document_index_snapshot_manager.h"
 #include "fmt/core.h"
+#include "log/index_journal.h"
 #include "meta/store_meta_manager.h"
 #include "proto/common.pb.h"
 #include "proto/error.pb.h"
@@ -48,6 +51,13 @@ DEFINE_int32(document_fast_background_worker_num, 8, "document index fast backgr
 DEFINE_int64(document_fast_build_log_gap, 50, "document index fast build log gap");
 DEFINE_int64(document_pull_snapshot_min_log_gap, 66, "document index pull snapshot min log gap");
 DEFINE_int64(document_max_background_task_count, 32, "document index max background task count");
+DEFINE_int32(document_index_build_parallel_num, 0,
+             "document index build parallel num, split the document id range and build in parallel, <=1 is serial");
+DEFINE_int64(document_index_event_scrub_max_num, 64, "max dirty document index num of one event driven scrub");
+DEFINE_int64(document_index_event_scrub_full_interval, 10,
+             "sweep all document indexes every interval event driven scrubs");
+
+DECLARE_bool(enable_document_index_event_scrub);
 
 std::string RebuildDocumentIndexTask::Trace() {
   return fmt::format("[document_index.rebuild][id({}).start_time({}).job_id({})] {}", document_index_wrapper_->Id(),
@@ -1084,12 +1094,8 @@ butil::Status DocumentIndexManager::ReplayWalToDocumentIndex(DocumentIndexPtr do
   ids.reserve(Constant::kBuildDocumentIndexBatchSize);
 
   int64_t last_log_id = document_index->ApplyLogId();
-  auto log_entrys = log_storage->GetEntrys(start_log_id, end_log_id);
-  for (const auto& log_entry : log_entrys) {
-    auto raft_cmd = std::make_shared<pb::raft::RaftCmdRequest>();
-    butil::IOBufAsZeroCopyInputStream wrapper(log_entry->data);
-    CHECK(raft_cmd->ParseFromZeroCopyStream(&wrapper));
-    for (auto& request : *raft_cmd->mutable_requests()) {
+  auto replay_func = [&](int64_t log_id, pb::raft::RaftCmdRequest& raft_cmd) {
+    for (auto& request : *raft_cmd.mutable_requests()) {
       switch (request.cmd_type()) {
         case pb::raft::DOCUMENT_ADD: {
           if (!ids.empty()) {
@@ -1131,8 +1137,15 @@ butil::Status DocumentIndexManager::ReplayWalToDocumentIndex(DocumentIndexPtr do
       }
     }
 
-    last_log_id = log_entry->index;
+    last_log_id = log_id;
+  };
+
+  // the log truncated from raft log is read from index journal
+  auto status = IndexJournalManager::ReadIndexLog(log_storage, start_log_id, end_log_id, replay_func);
+  if (!status.ok()) {
+    return status;
   }
+
   if (!documents.empty()) {
     document_index->Add(documents, false);
   } else if (!ids.empty()) {
@@ -1226,6 +1239,7 @@ DocumentIndexPtr DocumentIndexManager::BuildDocumentIndex(DocumentIndexWrapperPt
   // load document data to document index
   IteratorOptions options;
   options.upper_bound = end_key;
+  options.long_scan = true;
 
   auto raw_engine = Server::GetInstance().GetRawEngine(region->GetRawEngineType());
   auto iter = raw_engine->Reader()->NewIterator(Constant::kStoreDataCF, options);
@@ -1255,6 +1269,26 @@ DocumentIndexPtr DocumentIndexManager::BuildDocumentIndex(DocumentIndexWrapperPt
   }
 
   int64_t count = 0;
+  if (FLAGS_document_index_build_parallel_num > 1) {
+    auto status = ParallelBuildDocumentIndex(document_index, raw_engine, range, FLAGS_document_index_build_parallel_num,
+                                             count, trace);
+    if (!status.ok()) {
+      DINGO_LOG(ERROR) << fmt::format(
+          "[document_index.build][index_id({})][trace({})] Parallel build document index failed, error: {} {}",
+          document_index_id, trace, status.error_code(), status.error_str());
+      return nullptr;
+    }
+
+    DINGO_LOG(INFO) << fmt::format(
+        "[document_index.build][index_id({})][trace({})] Parallel build document index finish, parallel({}) count({}) "
+        "epoch({}) range({}) elapsed time({}ms)",
+        document_index_id, trace, FLAGS_document_index_build_parallel_num, count,
+        Helper::RegionEpochToString(document_index->Epoch()),
+        DocumentCodec::DecodeRangeToString(document_index->Range()), Helper::TimestampMs() - start_time);
+
+    return document_index;
+  }
+
   int64_t upsert_use_time = 0;
   std::vector<pb::common::DocumentWithId> documents;
   documents.reserve(Constant::kBuildDocumentIndexBatchSize);
@@ -1317,6 +1351,125 @@ DocumentIndexPtr DocumentIndexManager::BuildDocumentIndex(DocumentIndexWrapperPt
   return document_index;
 }
 
+butil::Status DocumentIndexManager::ParallelBuildDocumentIndex(DocumentIndexPtr document_index,
+                                                               RawEnginePtr raw_engine, const pb::common::Range& range,
+                                                               int parallel_num, int64_t& count,
+                                                               const std::string& trace) {
+  struct Parameter {
+    DocumentIndexPtr document_index;
+    RawEnginePtr raw_engine;
+    // sub range i is [keys[i], keys[i+1])
+    std::vector<std::string> keys;
+    std::atomic<int> offset;
+    std::atomic<int64_t> count;
+    std::vector<butil::Status> results;
+    std::string trace;
+  };
+
+  auto param = std::make_shared<Parameter>();
+  param->document_index = document_index;
+  param->raw_engine = raw_engine;
+  param->offset = 0;
+  param->count = 0;
+  param->trace = trace;
+
+  // split by document id, the sub ranges keep the region start/end key at both ends
+  int64_t begin_document_id = 0;
+  int64_t end_document_id = 0;
+  DocumentCodec::DecodeRangeToDocumentId(range, begin_document_id, end_document_id);
+  param->keys.push_back(range.start_key());
+  if (end_document_id > begin_document_id) {
+    char prefix = range.start_key()[0];
+    int64_t partition_id = DocumentCodec::DecodePartitionId(range.start_key());
+    uint64_t step = (static_cast<uint64_t>(end_document_id) - begin_document_id) / parallel_num;
+    for (int i = 1; i < parallel_num && step > 0; ++i) {
+      std::string key;
+      DocumentCodec::EncodeDocumentKey(prefix, partition_id, begin_document_id + static_cast<int64_t>(step * i), key);
+      param->keys.push_back(key);
+    }
+  }
+  param->keys.push_back(range.end_key());
+  param->results.resize(param->keys.size() - 1);
+
+  DINGO_LOG(INFO) << fmt::format(
+      "[document_index.build][index_id({})][trace({})] Parallel build document index, document id [{}-{}) "
+      "sub ranges({})",
+      document_index->Id(), trace, begin_document_id, end_document_id, param->results.size());
+
+  auto task = [](void* arg) -> void* {
+    if (arg == nullptr) {
+      return nullptr;
+    }
+    auto* param = static_cast<Parameter*>(arg);
+
+    for (;;) {
+      int offset = param->offset.fetch_add(1, std::memory_order_relaxed);
+      if (offset >= param->results.size()) {
+        break;
+      }
+
+      const auto& start_key = param->keys[offset];
+      IteratorOptions options;
+      options.upper_bound = param->keys[offset + 1];
+      options.long_scan = true;
+      auto iter = param->raw_engine->Reader()->NewIterator(Constant::kStoreDataCF, options);
+      if (iter == nullptr) {
+        param->results[offset] = butil::Status(pb::error::EINTERNAL, "NewIterator failed.");
+        break;
+      }
+
+      std::vector<pb::common::DocumentWithId> documents;
+      documents.reserve(Constant::kBuildDocumentIndexBatchSize);
+      for (iter->Seek(start_key); iter->Valid(); iter->Next()) {
+        pb::common::DocumentWithId document;
+        document.set_id(DocumentCodec::DecodeDocumentId(std::string(iter->Key())));
+        if (!document.mutable_document()->ParseFromArray(iter->Value().data(), iter->Value().size()) ||
+            document.document().document_data_size() <= 0) {
+          DINGO_LOG(WARNING) << fmt::format(
+              "[document_index.build][index_id({})][trace({})] document({}) parse failed or values_size error.",
+              param->document_index->Id(), param->trace, document.id());
+          continue;
+        }
+
+        documents.push_back(std::move(document));
+        if (documents.size() >= Constant::kBuildDocumentIndexBatchSize) {
+          param->results[offset] = param->document_index->BulkAdd(documents);
+          if (!param->results[offset].ok()) {
+            break;
+          }
+          param->count.fetch_add(documents.size(), std::memory_order_relaxed);
+          documents.clear();
+          bthread_yield();
+        }
+      }
+
+      if (param->results[offset].ok() && !documents.empty()) {
+        param->results[offset] = param->document_index->BulkAdd(documents);
+        param->count.fetch_add(documents.size(), std::memory_order_relaxed);
+      }
+      if (!param->results[offset].ok()) {
+        break;
+      }
+    }
+
+    return nullptr;
+  };
+
+  if (!Helper::ParallelRunTask(task, param.get(), parallel_num)) {
+    return butil::Status(pb::error::EINTERNAL, "Create bthread failed.");
+  }
+
+  count = param->count.load();
+  for (const auto& result : param->results) {
+    if (!result.ok()) {
+      return result;
+    }
+  }
+
+  // one commit for all sub ranges, the segments are merged by the merge policy of tantivy
+  return document_index->GroupCommit(true);
+}
+
 void DocumentIndexManager::LaunchRebuildDocumentIndex(DocumentIndexWrapperPtr document_index_wrapper, int64_t job_id,
                                                       bool is_double_check, bool is_force, bool is_clear,
                                                       const std::string& trace) {
@@ -1585,7 +1738,83 @@ void DocumentIndexManager::LaunchSaveDocumentIndex(DocumentIndexWrapperPtr docum
   }
 }
 
+bool DocumentIndexManager::ScrubDocumentIndex(store::RegionPtr region) {
+  int64_t document_index_id = region->Id();
+  if (region->State() != pb::common::NORMAL) {
+    DINGO_LOG(INFO) << fmt::format("[document_index.scrub][index_id({})] region state is not normal, dont't scrub.",
+                                   document_index_id);
+    return true;
+  }
+  auto document_index_wrapper = region->DocumentIndexWrapper();
+  if (!document_index_wrapper->IsReady()) {
+    DINGO_LOG(INFO) << fmt::format("[document_index.scrub][index_id({})] document index is not ready, dont't scrub.",
+                                   document_index_id);
+    return true;
+  }
+  if (document_index_wrapper->IsDestoryed()) {
+    DINGO_LOG(INFO) << fmt::format("[document_index.scrub][index_id({})] document index is stop, dont't scrub.",
+                                   document_index_id);
+    return true;
+  }
+
+  bool need_rebuild = document_index_wrapper->NeedToRebuild();
+  if (need_rebuild) {
+    if (document_index_wrapper->RebuildingNum() != 0) {
+      return false;
+    }
+    DINGO_LOG(INFO) << fmt::format("[document_index.scrub][index_id({})] need rebuild, do rebuild document index.",
+                                   document_index_id);
+    LaunchRebuildDocumentIndex(document_index_wrapper, 0, true, false, false, "from scrub");
+    return true;
+  }
+
+  std::string trace;
+  bool need_save = document_index_wrapper->NeedToSave(trace);
+  if (need_save) {
+    if (document_index_wrapper->RebuildingNum() != 0 || document_index_wrapper->SavingNum() >= 128) {
+      return false;
+    }
+    DINGO_LOG(INFO) << fmt::format("[document_index.scrub][index_id({})] need save, trace: {}.", document_index_id,
+                                   trace);
+
+    LaunchSaveDocumentIndex(document_index_wrapper, fmt::format("scrub-{}", trace));
+  }
+
+  return true;
+}
+
+// Event driven scrub only visits the dirty document indexes of highest priority, idle indexes cost nothing.
+static butil::Status ScrubDirtyDocumentIndex() {
+  auto& queue = DocumentIndexWrapper::ScrubQueue();
+  auto document_index_ids = queue.Pop(FLAGS_document_index_event_scrub_max_num);
+  if (document_index_ids.empty()) {
+    return butil::Status::OK();
+  }
+
+  DINGO_LOG(INFO) << fmt::format("[document_index.scrub][index_id()] Scrub dirty document index start, count: {}/{}",
+                                 document_index_ids.size(), document_index_ids.size() + queue.Size());
+
+  for (auto document_index_id : document_index_ids) {
+    auto region = Server::GetInstance().GetRegion(document_index_id);
+    if (region == nullptr || region->DocumentIndexWrapper() == nullptr) {
+      continue;
+    }
+    // busy with save or rebuild, scrub at next round
+    if (!DocumentIndexManager::ScrubDocumentIndex(region)) {
+      queue.Mark(document_index_id, 0);
+    }
+  }
+
+  return butil::Status::OK();
+}
+
 butil::Status DocumentIndexManager::ScrubDocumentIndex() {
+  static std::atomic<int64_t> scrub_count{0};
+  if (FLAGS_enable_document_index_event_scrub && FLAGS_document_index_event_scrub_full_interval > 0 &&
+      scrub_count.fetch_add(1) % FLAGS_document_index_event_scrub_full_interval != 0) {
+    return ScrubDirtyDocumentIndex();
+  }
+
   auto regions = Server::GetInstance().GetAllAliveRegion();
   if (regions.empty()) {
     DINGO_LOG(INFO) << "[document_index.scrub][index_id()] No alive region, skip scrub document index";
@@ -1596,42 +1825,51 @@ butil::Status DocumentIndexManager::ScrubDocumentIndex() {
                   << regions.size();
 
   for (const auto& region : regions) {
-    int64_t document_index_id = region->Id();
-    if (region->State() != pb::common::NORMAL) {
-      DINGO_LOG(INFO) << fmt::format("[document_index.scrub][index_id({})] region state is not normal, dont't scrub.",
-                                     document_index_id);
-      continue;
+    // full sweep covers the dirty document indexes
+    DocumentIndexWrapper::ScrubQueue().Remove(region->Id());
+    if (!ScrubDocumentIndex(region) && FLAGS_enable_document_index_event_scrub) {
+      DocumentIndexWrapper::ScrubQueue().Mark(region->Id(), 0);
     }
+  }
+
+  return butil::Status::OK();
+}
+
+butil::Status DocumentIndexManager::GroupCommitDocumentIndex() {
+  auto regions = Server::GetInstance().GetAllAliveRegion();
+
+  std::vector<DocumentIndexWrapperPtr> document_index_wrappers;
+  document_index_wrappers.reserve(regions.size());
+  for (const auto& region : regions) {
     auto document_index_wrapper = region->DocumentIndexWrapper();
-    if (!document_index_wrapper->IsReady()) {
-      DINGO_LOG(INFO) << fmt::format("[document_index.scrub][index_id({})] document index is not ready, dont't scrub.",
-                                     document_index_id);
-      continue;
-    }
-    if (document_index_wrapper->IsDestoryed()) {
-      DINGO_LOG(INFO) << fmt::format("[document_index.scrub][index_id({})] document index is stop, dont't scrub.",
-                                     document_index_id);
+    if (document_index_wrapper == nullptr || !document_index_wrapper->IsReady() ||
+        document_index_wrapper->IsDestoryed()) {
       continue;
     }
+    document_index_wrappers.push_back(document_index_wrapper);
+  }
 
-    bool need_rebuild = document_index_wrapper->NeedToRebuild();
-    if (need_rebuild && document_index_wrapper->RebuildingNum() == 0) {
-      DINGO_LOG(INFO) << fmt::format("[document_index.scrub][index_id({})] need rebuild, do rebuild document index.",
-                                     document_index_id);
-      LaunchRebuildDocumentIndex(document_index_wrapper, 0, true, false, false, "from scrub");
-      continue;
-    }
+  DocumentIndexMergeScheduler::GetInstance().Schedule(document_index_wrappers);
 
-    std::string trace;
-    bool need_save = document_index_wrapper->NeedToSave(trace);
-    if (need_save && document_index_wrapper->RebuildingNum() == 0 && document_index_wrapper->SavingNum() < 128) {
-      DINGO_LOG(INFO) << fmt::format("[document_index.scrub][index_id({})] need save, trace: {}.", document_index_id,
-                                     trace);
+  return butil::Status::OK();
+}
+
+butil::Status DocumentIndexManager::BalanceDocumentIndexMemory() {
+  auto regions = Server::GetInstance().GetAllAliveRegion();
 
-      LaunchSaveDocumentIndex(document_index_wrapper, fmt::format("scrub-{}", trace));
+  std::vector<DocumentIndexWrapperPtr> document_index_wrappers;
+  document_index_wrappers.reserve(regions.size());
+  for (const auto& region : regions) {
+    auto document_index_wrapper = region->DocumentIndexWrapper();
+    if (document_index_wrapper == nullptr || !document_index_wrapper->IsReady() ||
+        document_index_wrapper->IsDestoryed()) {
+      continue;
     }
+    document_index_wrappers.push_back(document_index_wrapper);
   }
 
+  DocumentIndexMemoryManager::Balance(document_index_wrappers);
+
   return butil::Status::OK();
 }
 
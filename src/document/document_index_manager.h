@@ -25,6 +25,7 @@
 #include "bvar/latency_recorder.h"
 #include "common/helper.h"
 #include "document/document_index.h"
+#include "engine/raw_engine.h"
 #include "meta/store_meta_manager.h"
 #include "proto/common.pb.h"
 
@@ -212,7 +213,16 @@ class DocumentIndexManager {
   static void LaunchBuildDocumentIndex(DocumentIndexWrapperPtr document_index_wrapper, bool is_temp_hold_document_index,
                                        bool is_fast_build, int64_t job_id, const std::string& trace);
 
+  // Scrub all document indexes, or only the dirty document indexes when event driven scrub is enabled.
   static butil::Status ScrubDocumentIndex();
+  // Scrub one document index, return false when it need save or rebuild but is busy.
+  static bool ScrubDocumentIndex(store::RegionPtr region);
+
+  // Commit the group commit writes which reach the time bound through DocumentIndexMergeScheduler.
+  static butil::Status GroupCommitDocumentIndex();
+
+  // Evict cold document indexes to disk through DocumentIndexMemoryManager when over the memory budget.
+  static butil::Status BalanceDocumentIndexMemory();
 
   static bvar::Adder<uint64_t> bvar_document_index_task_running_num;
   static bvar::Adder<uint64_t> bvar_document_index_rebuild_task_running_num;
@@ -301,6 +311,12 @@ class DocumentIndexManager {
   static butil::Status ReplayWalToDocumentIndex(std::shared_ptr<DocumentIndex> document_index, int64_t start_log_id,
                                                 int64_t end_log_id);
 
+  // Split the document id range into parallel_num sub ranges, read and add every sub range by its own bthread, then
+  // commit once at the end.
+  static butil::Status ParallelBuildDocumentIndex(std::shared_ptr<DocumentIndex> document_index,
+                                                  RawEnginePtr raw_engine, const pb::common::Range& range,
+                                                  int parallel_num, int64_t& count, const std::string& trace);
+
   static butil::Status TrainForBuild(std::shared_ptr<DocumentIndex> document_index, std::shared_ptr<Iterator> iter,
                                      const std::string& start_key, [[maybe_unused]] const std::string& end_key);
 
@@ -0,0 +1,144 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "document/document_index_memory_manager.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+#include <vector>
+
+#include "bvar/reducer.h"
+#include "bvar/status.h"
+#include "common/helper.h"
+#include "common/logging.h"
+#include "fmt/core.h"
+#include "gflags/gflags.h"
+
+namespace dingodb {
+
+DEFINE_int64(document_index_memory_budget_bytes, 0,
+             "document index store wide memory budget bytes, cold index is evicted to disk when exceed, 0 means no "
+             "limit");
+DEFINE_int64(document_index_writer_memory_bytes, 50 * 1024 * 1024,
+             "document index estimated memory bytes of a loaded tantivy index writer");
+DEFINE_int64(document_index_reader_memory_bytes, 8 * 1024 * 1024,
+             "document index estimated memory bytes of a loaded tantivy index reader");
+DEFINE_int64(document_index_evict_idle_s, 300, "document index is cold when not searched or written for it");
+DEFINE_int32(document_index_memory_budget_interval_s, 10, "document index memory budget check interval seconds");
+
+static bvar::Status<int64_t> g_document_index_memory_bytes("dingo_document_index_memory_bytes", 0);
+static bvar::Status<int64_t> g_document_index_evicted_num("dingo_document_index_evicted_num", 0);
+
+int64_t DocumentIndexMemoryManager::EstimateMemoryBytes(bool writer_loaded, bool reader_loaded,
+                                                        int64_t pending_commit_bytes) {
+  int64_t bytes = 0;
+  if (writer_loaded) {
+    bytes += FLAGS_document_index_writer_memory_bytes + std::max(pending_commit_bytes, static_cast<int64_t>(0));
+  }
+  if (reader_loaded) {
+    bytes += FLAGS_document_index_reader_memory_bytes;
+  }
+  return bytes;
+}
+
+std::vector<size_t> DocumentIndexMemoryManager::SelectEvictions(const std::vector<Usage>& usages,
+                                                                int64_t budget_bytes, int64_t idle_ms,
+                                                                int64_t now_ms) {
+  std::vector<size_t> evictions;
+  if (budget_bytes <= 0) {
+    return evictions;
+  }
+
+  int64_t total_bytes = 0;
+  for (const auto& usage : usages) {
+    total_bytes += usage.memory_bytes;
+  }
+
+  std::vector<size_t> positions(usages.size());
+  std::iota(positions.begin(), positions.end(), 0);
+  std::sort(positions.begin(), positions.end(), [&usages](size_t lhs, size_t rhs) {
+    return usages[lhs].last_access_time_ms < usages[rhs].last_access_time_ms;
+  });
+
+  for (auto position : positions) {
+    if (total_bytes <= budget_bytes) {
+      break;
+    }
+
+    const auto& usage = usages[position];
+    // sorted by access time, the rest are hotter.
+    if (now_ms - usage.last_access_time_ms < idle_ms) {
+      break;
+    }
+    if (usage.memory_bytes <= 0) {
+      continue;
+    }
+
+    evictions.push_back(position);
+    total_bytes -= usage.memory_bytes;
+  }
+
+  return evictions;
+}
+
+int64_t DocumentIndexMemoryManager::MemoryBytes() { return g_document_index_memory_bytes.get_value(); }
+
+void DocumentIndexMemoryManager::Balance(const std::vector<DocumentIndexWrapperPtr>& document_index_wrappers) {
+  std::vector<DocumentIndexPtr> document_indexes;
+  std::vector<Usage> usages;
+  int64_t total_bytes = 0;
+  int64_t evicted_num = 0;
+  for (const auto& document_index_wrapper : document_index_wrappers) {
+    for (const auto& document_index :
+         {document_index_wrapper->GetOwnDocumentIndex(), document_index_wrapper->SiblingDocumentIndex()}) {
+      if (document_index == nullptr) {
+        continue;
+      }
+
+      int64_t memory_bytes = EstimateMemoryBytes(document_index->IsWriterLoaded(), document_index->IsReaderLoaded(),
+                                                 document_index->PendingCommitBytes());
+      if (memory_bytes == 0) {
+        ++evicted_num;
+      }
+      total_bytes += memory_bytes;
+      document_indexes.push_back(document_index);
+      usages.push_back({memory_bytes, document_index->LastAccessTimeMs()});
+    }
+  }
+
+  auto evictions = SelectEvictions(usages, FLAGS_document_index_memory_budget_bytes,
+                                   FLAGS_document_index_evict_idle_s * 1000, Helper::TimestampMs());
+  for (auto position : evictions) {
+    const auto& document_index = document_indexes[position];
+    auto status = document_index->Evict();
+    if (!status.ok()) {
+      DINGO_LOG(WARNING) << fmt::format("[document_index.memory][index_id({})] evict failed, error: {}",
+                                        document_index->Id(), Helper::PrintStatus(status));
+      continue;
+    }
+
+    total_bytes -= usages[position].memory_bytes;
+    ++evicted_num;
+  }
+
+  g_document_index_memory_bytes.set_value(total_bytes);
+  g_document_index_evicted_num.set_value(evicted_num);
+  if (!evictions.empty()) {
+    DINGO_LOG(INFO) << fmt::format("[document_index.memory] evict({}) memory({}) budget({})", evictions.size(),
+                                   total_bytes, FLAGS_document_index_memory_budget_bytes);
+  }
+}
+
+}  // namespace dingodb
@@ -0,0 +1,54 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_DOCUMENT_INDEX_MEMORY_MANAGER_H_
+#define DINGODB_DOCUMENT_INDEX_MEMORY_MANAGER_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "document/document_index.h"
+
+namespace dingodb {
+
+// Store wide memory budget of document indexes.
+// Tantivy does not report its heap, so the memory of a document index is estimated by what it holds loaded, the
+// writer with its indexing heap and pending writes, the reader with its searcher caches. When the total exceeds
+// document_index_memory_budget_bytes, the least recently accessed indexes idle for document_index_evict_idle_s are
+// evicted to on disk only mode, and loaded again by their next search or write.
+class DocumentIndexMemoryManager {
+ public:
+  struct Usage {
+    int64_t memory_bytes{0};
+    int64_t last_access_time_ms{0};
+  };
+
+  // Estimated memory of a document index.
+  static int64_t EstimateMemoryBytes(bool writer_loaded, bool reader_loaded, int64_t pending_commit_bytes);
+
+  // Position of the usages to evict, least recently accessed first, until the total fits the budget.
+  // Only the usages idle for idle_ms are candidates, budget <= 0 means no limit.
+  static std::vector<size_t> SelectEvictions(const std::vector<Usage>& usages, int64_t budget_bytes, int64_t idle_ms,
+                                             int64_t now_ms);
+
+  // Evict the cold document indexes of the regions when over the budget.
+  static void Balance(const std::vector<DocumentIndexWrapperPtr>& document_index_wrappers);
+
+  // Estimated memory of all document indexes at the last Balance.
+  static int64_t MemoryBytes();
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_DOCUMENT_INDEX_MEMORY_MANAGER_H_
@@ -0,0 +1,194 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "document/document_index_merge_scheduler.h"
+
+#include <algorithm>
+#include <iterator>
+#include <cstdint>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "bthread/mutex.h"
+#include "bvar/reducer.h"
+#include "bvar/status.h"
+#include "common/helper.h"
+#include "common/logging.h"
+#include "fmt/core.h"
+#include "gflags/gflags.h"
+#include "nlohmann/json.hpp"
+
+namespace dingodb {
+
+DEFINE_int64(document_merge_bytes_per_second, 64 * 1024 * 1024,
+             "document index store wide segment write budget bytes per second, 0 means no limit");
+
+static bvar::Status<int64_t> g_document_merge_queue_size("dingo_document_merge_scheduler_queue_size", 0);
+static bvar::Status<int64_t> g_document_merge_tokens("dingo_document_merge_scheduler_tokens", 0);
+static bvar::Adder<int64_t> g_document_merge_commit_count("dingo_document_merge_scheduler_commit_count");
+static bvar::Adder<int64_t> g_document_merge_deferred_count("dingo_document_merge_scheduler_deferred_count");
+static bvar::Adder<int64_t> g_document_merge_bytes("dingo_document_merge_scheduler_bytes");
+
+DocumentIndexMergeScheduler& DocumentIndexMergeScheduler::GetInstance() {
+  static DocumentIndexMergeScheduler instance;
+  return instance;
+}
+
+DocumentIndexMergeScheduler::DocumentIndexMergeScheduler() : last_refill_time_ms_(Helper::TimestampMs()) {
+  bthread_mutex_init(&mutex_, nullptr);
+}
+
+DocumentIndexMergeScheduler::~DocumentIndexMergeScheduler() { bthread_mutex_destroy(&mutex_); }
+
+// Caller hold mutex_.
+void DocumentIndexMergeScheduler::Refill() {
+  int64_t now_ms = Helper::TimestampMs();
+  double capacity = static_cast<double>(FLAGS_document_merge_bytes_per_second);
+  tokens_ = std::min(capacity, tokens_ + capacity * (now_ms - last_refill_time_ms_) / 1000.0);
+  last_refill_time_ms_ = now_ms;
+  g_document_merge_tokens.set_value(static_cast<int64_t>(tokens_));
+}
+
+bool DocumentIndexMergeScheduler::Acquire(int64_t bytes) {
+  if (FLAGS_document_merge_bytes_per_second <= 0) {
+    g_document_merge_bytes << bytes;
+    return true;
+  }
+
+  BAIDU_SCOPED_LOCK(mutex_);
+  Refill();
+  if (tokens_ < bytes && tokens_ < FLAGS_document_merge_bytes_per_second) {
+    return false;
+  }
+
+  tokens_ -= bytes;
+  g_document_merge_tokens.set_value(static_cast<int64_t>(tokens_));
+  g_document_merge_bytes << bytes;
+  return true;
+}
+
+void DocumentIndexMergeScheduler::Charge(int64_t bytes) {
+  g_document_merge_bytes << bytes;
+  if (FLAGS_document_merge_bytes_per_second <= 0) {
+    return;
+  }
+
+  BAIDU_SCOPED_LOCK(mutex_);
+  Refill();
+  // debt at most one second budget, raft apply must not starve the queued commits forever.
+  tokens_ = std::max(tokens_ - bytes, -static_cast<double>(FLAGS_document_merge_bytes_per_second));
+  g_document_merge_tokens.set_value(static_cast<int64_t>(tokens_));
+}
+
+double DocumentIndexMergeScheduler::QueryRate(int64_t region_id, int64_t search_count, int64_t now_ms) {
+  BAIDU_SCOPED_LOCK(mutex_);
+  auto it = last_search_counts_.find(region_id);
+  if (it == last_search_counts_.end()) {
+    last_search_counts_[region_id] = {search_count, now_ms};
+    return 0.0;
+  }
+
+  auto [last_count, last_time_ms] = it->second;
+  it->second = {search_count, now_ms};
+  if (now_ms <= last_time_ms || search_count < last_count) {
+    return 0.0;
+  }
+
+  return (search_count - last_count) * 1000.0 / (now_ms - last_time_ms);
+}
+
+double DocumentIndexMergeScheduler::Priority(double query_rate, int64_t segment_count) {
+  return (1.0 + std::max(query_rate, 0.0)) / (1.0 + std::max(segment_count, static_cast<int64_t>(0)));
+}
+
+int64_t DocumentIndexMergeScheduler::ParseSegmentCount(const std::string& meta_json) {
+  auto json = nlohmann::json::parse(meta_json, nullptr, false);
+  if (json.is_discarded() || !json.is_object()) {
+    return -1;
+  }
+
+  auto it = json.find("segments");
+  if (it == json.end() || !it->is_array()) {
+    return -1;
+  }
+
+  return it->size();
+}
+
+void DocumentIndexMergeScheduler::Schedule(const std::vector<DocumentIndexWrapperPtr>& document_index_wrappers) {
+  struct Candidate {
+    DocumentIndexPtr document_index;
+    int64_t bytes;
+    double priority;
+  };
+
+  int64_t now_ms = Helper::TimestampMs();
+  std::vector<Candidate> candidates;
+  std::set<int64_t> region_ids;
+  for (const auto& document_index_wrapper : document_index_wrappers) {
+    region_ids.insert(document_index_wrapper->Id());
+    double query_rate = QueryRate(document_index_wrapper->Id(), document_index_wrapper->SearchCount(), now_ms);
+
+    for (const auto& document_index :
+         {document_index_wrapper->GetOwnDocumentIndex(), document_index_wrapper->SiblingDocumentIndex()}) {
+      if (document_index == nullptr || !document_index->IsGroupCommitExpired()) {
+        continue;
+      }
+
+      int64_t segment_count = 0;
+      std::string meta_json;
+      // not load an evicted reader only for priority.
+      if (document_index->IsReaderLoaded() && document_index->GetMetaJson(meta_json).ok()) {
+        segment_count = std::max(ParseSegmentCount(meta_json), static_cast<int64_t>(0));
+      }
+
+      candidates.push_back(
+          {document_index, document_index->PendingCommitBytes(), Priority(query_rate, segment_count)});
+    }
+  }
+
+  std::sort(candidates.begin(), candidates.end(),
+            [](const Candidate& lhs, const Candidate& rhs) { return lhs.priority > rhs.priority; });
+
+  size_t committed = 0;
+  for (; committed < candidates.size(); ++committed) {
+    const auto& candidate = candidates[committed];
+    if (!Acquire(candidate.bytes)) {
+      break;
+    }
+
+    auto status = candidate.document_index->GroupCommit(true);
+    if (!status.ok()) {
+      DINGO_LOG(WARNING) << fmt::format("[document_index.merge_scheduler][index_id({})] group commit failed, error: {}",
+                                        candidate.document_index->Id(), Helper::PrintStatus(status));
+    }
+    g_document_merge_commit_count << 1;
+  }
+
+  int64_t deferred = candidates.size() - committed;
+  g_document_merge_queue_size.set_value(deferred);
+  g_document_merge_deferred_count << deferred;
+  if (deferred > 0) {
+    DINGO_LOG(INFO) << fmt::format("[document_index.merge_scheduler] commit({}) deferred({}) out of budget",
+                                   committed, deferred);
+  }
+
+  BAIDU_SCOPED_LOCK(mutex_);
+  for (auto it = last_search_counts_.begin(); it != last_search_counts_.end();) {
+    it = region_ids.count(it->first) == 0 ? last_search_counts_.erase(it) : std::next(it);
+  }
+}
+
+}  // namespace dingodb
@@ -0,0 +1,73 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_DOCUMENT_INDEX_MERGE_SCHEDULER_H_
+#define DINGODB_DOCUMENT_INDEX_MERGE_SCHEDULER_H_
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "bthread/types.h"
+#include "document/document_index.h"
+
+namespace dingodb {
+
+// Store wide scheduler of document index segment writes.
+// Tantivy creates one segment per commit and starts its merges right after a commit, so pacing the commits paces
+// the merges. Every group commit takes bytes from one token bucket refilled by document_merge_bytes_per_second,
+// commits reaching the count bound in raft apply are only charged, and commits reaching the time bound are queued
+// here and committed by priority while the budget lasts, the rest wait for the next round.
+class DocumentIndexMergeScheduler {
+ public:
+  static DocumentIndexMergeScheduler& GetInstance();
+
+  DocumentIndexMergeScheduler(const DocumentIndexMergeScheduler&) = delete;
+  DocumentIndexMergeScheduler& operator=(const DocumentIndexMergeScheduler&) = delete;
+
+  // Take bytes from the budget, false if not enough.
+  // A write bigger than the whole bucket is allowed when the bucket is full, otherwise it never goes.
+  bool Acquire(int64_t bytes);
+  // Charge bytes which are written anyway.
+  void Charge(int64_t bytes);
+
+  // Commit expired group commit writes of the regions by priority within the budget.
+  void Schedule(const std::vector<DocumentIndexWrapperPtr>& document_index_wrappers);
+
+  // Searched regions first for freshness, regions with fewer segments first, whose merge is cheaper and which are
+  // less likely merging now.
+  static double Priority(double query_rate, int64_t segment_count);
+  // Segment count from tantivy meta json, -1 if malformed.
+  static int64_t ParseSegmentCount(const std::string& meta_json);
+
+ private:
+  DocumentIndexMergeScheduler();
+  ~DocumentIndexMergeScheduler();
+
+  void Refill();
+  double QueryRate(int64_t region_id, int64_t search_count, int64_t now_ms);
+
+  bthread_mutex_t mutex_;
+  double tokens_{0};
+  int64_t last_refill_time_ms_{0};
+
+  // region_id -> (search count, time ms) of last round
+  std::map<int64_t, std::pair<int64_t, int64_t>> last_search_counts_;
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_DOCUMENT_INDEX_MERGE_SCHEDULER_H_
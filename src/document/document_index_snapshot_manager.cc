@@ -44,6 +44,8 @@
 namespace dingodb {
 
 DEFINE_bool(document_index_snapshot_use_fork, true, "Use fork to save vector index snapshot.");
+DEFINE_bool(document_index_snapshot_use_hard_link, false,
+            "Keep a hard link copy of the document index at every save, restore from it when load failed.");
 
 // Get all snapshot path, except tmp dir.
 static std::vector<std::string> GetSnapshotPaths(std::string path) {
@@ -120,6 +122,93 @@ static int64_t ParseMetaLogId(const std::string& path) {
   return 0;
 }
 
+// Hard link all files of src_path into dst_path, no data is copied.
+// Tantivy never modifies a written file in place, meta.json is replaced by rename, so the linked files stay the
+// same point in time copy while the source index goes on writing.
+static butil::Status LinkDirectory(const std::string& src_path, const std::string& dst_path) {
+  if (!Helper::CreateDirectory(dst_path)) {
+    return butil::Status(pb::error::EINTERNAL, "Create directory %s failed", dst_path.c_str());
+  }
+
+  for (const auto& filename : Helper::TraverseDirectory(src_path, true, false)) {
+    // skip the lock files of tantivy writer/reader
+    if (filename.size() >= 5 && filename.compare(filename.size() - 5, 5, ".lock") == 0) {
+      continue;
+    }
+    if (!Helper::Link(fmt::format("{}/{}", src_path, filename), fmt::format("{}/{}", dst_path, filename))) {
+      Helper::RemoveAllFileOrDirectory(dst_path);
+      return butil::Status(pb::error::EINTERNAL, "Link file %s failed", filename.c_str());
+    }
+  }
+
+  return butil::Status::OK();
+}
+
+butil::Status DocumentIndexSnapshotManager::SaveHardLinkSnapshot(int64_t document_index_id,
+                                                                 const std::string& index_path,
+                                                                 int64_t snapshot_log_id) {
+  std::string tmp_path = GetSnapshotTmpPath(document_index_id);
+  auto status = LinkDirectory(index_path, tmp_path);
+  if (!status.ok()) {
+    return status;
+  }
+
+  std::string new_path = GetSnapshotNewPath(document_index_id, snapshot_log_id);
+  status = Helper::Rename(tmp_path, new_path);
+  if (!status.ok()) {
+    Helper::RemoveAllFileOrDirectory(tmp_path);
+    return status;
+  }
+
+  std::string parent_path = GetSnapshotParentPath(document_index_id);
+  for (const auto& dir_name : Helper::TraverseDirectory(parent_path, std::string("snapshot_"), false, true)) {
+    std::string path = fmt::format("{}/{}", parent_path, dir_name);
+    if (path != new_path) {
+      Helper::RemoveAllFileOrDirectory(path);
+    }
+  }
+
+  return butil::Status::OK();
+}
+
+std::string DocumentIndexSnapshotManager::RestoreHardLinkSnapshot(int64_t document_index_id,
+                                                                  const pb::common::RegionEpoch& epoch) {
+  std::string parent_path = GetSnapshotParentPath(document_index_id);
+  auto dir_names = Helper::TraverseDirectory(parent_path, std::string("snapshot_"), false, true);
+  std::sort(dir_names.begin(), dir_names.end(), std::greater<>());
+
+  for (const auto& dir_name : dir_names) {
+    std::string snapshot_path = fmt::format("{}/{}", parent_path, dir_name);
+    pb::store_internal::DocumentIndexSnapshotMeta meta;
+    braft::ProtoBufFile pb_file_meta(fmt::format("{}/meta", snapshot_path));
+    if (pb_file_meta.load(&meta) != 0 || meta.epoch().version() != epoch.version()) {
+      continue;
+    }
+
+    std::string epoch_path = GetSnapshotPath(document_index_id, epoch.version());
+    std::string tmp_path = GetSnapshotTmpPath(document_index_id);
+    auto status = LinkDirectory(snapshot_path, tmp_path);
+    if (status.ok()) {
+      Helper::RemoveAllFileOrDirectory(epoch_path);
+      status = Helper::Rename(tmp_path, epoch_path);
+    }
+    if (!status.ok()) {
+      Helper::RemoveAllFileOrDirectory(tmp_path);
+      DINGO_LOG(ERROR) << fmt::format(
+          "[document_index.load_snapshot][index_id({})] restore hard link snapshot {} failed, error: {}",
+          document_index_id, snapshot_path, status.error_str());
+      return "";
+    }
+
+    DINGO_LOG(INFO) << fmt::format(
+        "[document_index.load_snapshot][index_id({})] restore hard link snapshot {} to {}, snapshot_log_id: {}",
+        document_index_id, snapshot_path, epoch_path, meta.snapshot_log_id());
+    return epoch_path;
+  }
+
+  return "";
+}
+
 std::vector<std::string> DocumentIndexSnapshotManager::GetSnapshotList(int64_t document_index_id) {
   std::string snapshot_parent_path = GetSnapshotParentPath(document_index_id);
 
@@ -276,6 +365,13 @@ butil::Status DocumentIndexSnapshotManager::SaveDocumentIndexSnapshot(DocumentIn
 
   document_index->LockWrite();
 
+  // commit pending writes of group commit first, they are covered by the snapshot log id.
+  auto status = document_index->Save(document_index->IndexPath());
+  if (!status.ok()) {
+    document_index->UnlockWrite();
+    return status;
+  }
+
   snapshot_log_index = document_index_wrapper->ApplyLogId();
   document_index->SetApplyLogId(snapshot_log_index);
 
@@ -293,6 +389,14 @@ butil::Status DocumentIndexSnapshotManager::SaveDocumentIndexSnapshot(DocumentIn
     DINGO_LOG(ERROR) << fmt::format(
         "[document_index.child_save_snapshot][index_id({})] Save document index success, save meta to meta file failed",
         document_index_id);
+  } else if (FLAGS_document_index_snapshot_use_hard_link) {
+    // link under the write lock, so the files are consistent with the meta.
+    auto status = SaveHardLinkSnapshot(document_index_id, document_index->IndexPath(), snapshot_log_index);
+    if (!status.ok()) {
+      DINGO_LOG(WARNING) << fmt::format(
+          "[document_index.save_snapshot][index_id({})] Save hard link snapshot failed, error: {}", document_index_id,
+          status.error_str());
+    }
   }
 
   document_index->UnlockWrite();
@@ -320,6 +424,9 @@ std::shared_ptr<DocumentIndex> DocumentIndexSnapshotManager::LoadDocumentIndexSn
   int64_t document_index_id = document_index_wrapper->Id();
 
   auto document_index_path = GetSnapshotPath(document_index_id, epoch);
+  if (document_index_path.empty() && FLAGS_document_index_snapshot_use_hard_link) {
+    document_index_path = RestoreHardLinkSnapshot(document_index_id, epoch);
+  }
 
   if (document_index_path.empty()) {
     DINGO_LOG(WARNING) << fmt::format(
@@ -356,6 +463,13 @@ std::shared_ptr<DocumentIndex> DocumentIndexSnapshotManager::LoadDocumentIndexSn
   auto document_index =
       DocumentIndexFactory::LoadIndex(document_index_id, document_index_path, document_index_wrapper->IndexParameter(),
                                       meta.epoch(), meta.range(), status);
+  // the index files maybe broken, e.g. crash while writing, retry with the hard link snapshot
+  if (!document_index && FLAGS_document_index_snapshot_use_hard_link &&
+      !RestoreHardLinkSnapshot(document_index_id, epoch).empty() && pb_file_meta.load(&meta) == 0) {
+    document_index =
+        DocumentIndexFactory::LoadIndex(document_index_id, document_index_path,
+                                        document_index_wrapper->IndexParameter(), meta.epoch(), meta.range(), status);
+  }
   if (!document_index) {
     DINGO_LOG(WARNING) << fmt::format(
         "[document_index.load_snapshot][index_id({})] load snapshot failed, create document index failed. index_path: "
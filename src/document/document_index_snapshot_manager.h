@@ -59,6 +59,12 @@ class DocumentIndexSnapshotManager {
  private:
   static std::string GetSnapshotTmpPath(int64_t document_index_id);
   static std::string GetSnapshotNewPath(int64_t document_index_id, int64_t snapshot_log_id);
+
+  // Hard link snapshot snapshot_{log_id}, the older ones are removed.
+  static butil::Status SaveHardLinkSnapshot(int64_t document_index_id, const std::string& index_path,
+                                            int64_t snapshot_log_id);
+  // Restore the epoch path from the latest hard link snapshot of the epoch, return empty if not found.
+  static std::string RestoreHardLinkSnapshot(int64_t document_index_id, const pb::common::RegionEpoch& epoch);
 };
 
 }  // namespace dingodb
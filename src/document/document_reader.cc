@@ -25,6 +25,7 @@
 #include "common/logging.h"
 #include "document/codec.h"
 #include "document/document_index.h"
+#include "document/document_search_cache.h"
 #include "fmt/core.h"
 #include "gflags/gflags.h"
 #include "proto/common.pb.h"
@@ -32,6 +33,32 @@
 
 namespace dingodb {
 
+butil::Status DocumentReader::ParseDocument(const std::vector<std::string>& selected_scalar_keys,
+                                           const std::string& value, pb::common::DocumentWithId& document_with_id) {
+  pb::common::Document document;
+  if (!document.ParseFromString(value)) {
+    return butil::Status(pb::error::EINTERNAL, "Parse proto from string error");
+  }
+
+  if (selected_scalar_keys.empty()) {
+    document_with_id.mutable_document()->Swap(&document);
+    return butil::Status();
+  }
+
+  auto* document_data = document.mutable_document_data();
+  for (const auto& key : selected_scalar_keys) {
+    auto scalar = document_data->find(key);
+    // skip duplicated key, it has been moved out
+    if (scalar == document_data->end() || document_with_id.document().document_data().count(key) > 0) {
+      continue;
+    }
+
+    (*document_with_id.mutable_document()->mutable_document_data())[key].Swap(&scalar->second);
+  }
+
+  return butil::Status();
+}
+
 butil::Status DocumentReader::QueryDocumentWithId(const pb::common::Range& region_range, int64_t partition_id,
                                                   int64_t document_id, bool with_scalar_data,
                                                   std::vector<std::string>& selected_scalar_keys,
@@ -45,27 +72,46 @@ butil::Status DocumentReader::QueryDocumentWithId(const pb::common::Range& regio
     return status;
   }
 
+  document_with_id.set_id(document_id);
+
+  if (with_scalar_data) {
+    return ParseDocument(selected_scalar_keys, value, document_with_id);
+  }
+
   pb::common::Document document;
   if (!document.ParseFromString(value)) {
     return butil::Status(pb::error::EINTERNAL, "Parse proto from string error");
   }
-  document_with_id.set_id(document_id);
 
-  if (with_scalar_data) {
-    if (selected_scalar_keys.empty()) {
-      document_with_id.mutable_document()->Swap(&document);
-      return butil::Status();
-    } else {
-      for (auto& key : selected_scalar_keys) {
-        auto scalar = document.document_data().find(key);
-        if (scalar == document.document_data().end()) {
-          continue;
-        }
-
-        (*document_with_id.mutable_document()->mutable_document_data())[key] = scalar->second;
-      }
+  return butil::Status();
+}
 
-      return butil::Status();
+butil::Status DocumentReader::QueryDocumentWithIds(const pb::common::Range& region_range, int64_t partition_id,
+                                                   const std::vector<std::string>& selected_scalar_keys,
+                                                   const std::vector<pb::common::DocumentWithId*>& document_with_ids) {
+  if (document_with_ids.empty()) {
+    return butil::Status();
+  }
+
+  std::vector<std::string> keys(document_with_ids.size());
+  for (size_t i = 0; i < document_with_ids.size(); ++i) {
+    DocumentCodec::EncodeDocumentKey(region_range.start_key()[0], partition_id, document_with_ids[i]->id(), keys[i]);
+  }
+
+  std::vector<std::string> values;
+  std::vector<bool> exists;
+  auto status = reader_->KvMultiGet(Constant::kStoreDataCF, keys, values, exists);
+  if (!status.ok()) {
+    return status;
+  }
+
+  for (size_t i = 0; i < document_with_ids.size(); ++i) {
+    if (!exists[i]) {
+      return butil::Status(pb::error::EKEY_NOT_FOUND, "Not found key");
+    }
+    status = ParseDocument(selected_scalar_keys, values[i], *document_with_ids[i]);
+    if (!status.ok()) {
+      return status;
     }
   }
 
@@ -85,19 +131,45 @@ butil::Status DocumentReader::SearchDocument(int64_t partition_id, DocumentIndex
     }
   }
 
-  auto ret = document_index->Search(region_range, parameter, document_with_score_results);
+  // read generation before search, then a commit meanwhile makes the entry stale rather than wrong.
+  DocumentSearchCache::Version cache_version;
+  std::string cache_fingerprint;
+  bool use_cache = false;
+  if (DocumentSearchCache::IsEnabled()) {
+    auto own_document_index = document_index->GetDocumentIndex();
+    auto sibling_document_index = document_index->SiblingDocumentIndex();
+    if (own_document_index != nullptr) {
+      use_cache = true;
+      cache_version.generation = own_document_index->Generation();
+      cache_version.sibling_generation =
+          sibling_document_index != nullptr ? sibling_document_index->Generation() : 0;
+      cache_fingerprint = DocumentSearchCache::Fingerprint(document_index->Id(), region_range, parameter);
+    }
+  }
+
+  if (!use_cache ||
+      !DocumentSearchCache::GetInstance().Get(cache_fingerprint, cache_version, document_with_score_results)) {
+    auto ret = document_index->Search(region_range, parameter, document_with_score_results);
+    if (!ret.ok()) {
+      return ret;
+    }
+
+    if (use_cache) {
+      DocumentSearchCache::GetInstance().Put(cache_fingerprint, cache_version, document_with_score_results);
+    }
+  }
 
   // document index does not support restruct document, we restruct it using kv store
   if (with_scalar_data) {
+    std::vector<pb::common::DocumentWithId*> document_with_ids;
+    document_with_ids.reserve(document_with_score_results.size());
     for (auto& document_with_score : document_with_score_results) {
-      pb::common::DocumentWithId document_with_id;
-      auto status = QueryDocumentWithId(region_range, partition_id, document_with_score.document_with_id().id(),
-                                        with_scalar_data, selected_scalar_keys, document_with_id);
-      if (!status.ok()) {
-        return status;
-      }
+      document_with_ids.push_back(document_with_score.mutable_document_with_id());
+    }
 
-      document_with_score.mutable_document_with_id()->Swap(&document_with_id);
+    auto status = QueryDocumentWithIds(region_range, partition_id, selected_scalar_keys, document_with_ids);
+    if (!status.ok()) {
+      return status;
     }
   }
 
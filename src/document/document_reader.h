@@ -59,6 +59,12 @@ class DocumentReader {
   butil::Status QueryDocumentWithId(const pb::common::Range& region_range, int64_t partition_id, int64_t document_id,
                                     bool with_scalar_data, std::vector<std::string>& selected_scalar_keys,
                                     pb::common::DocumentWithId& document_with_id);
+  // Get documents of all document_with_ids by one multi get, not exist one is left empty.
+  butil::Status QueryDocumentWithIds(const pb::common::Range& region_range, int64_t partition_id,
+                                     const std::vector<std::string>& selected_scalar_keys,
+                                     const std::vector<pb::common::DocumentWithId*>& document_with_ids);
+  static butil::Status ParseDocument(const std::vector<std::string>& selected_scalar_keys, const std::string& value,
+                                     pb::common::DocumentWithId& document_with_id);
   butil::Status SearchDocument(int64_t partition_id, DocumentIndexWrapperPtr document_index,
                                pb::common::Range region_range, const pb::common::DocumentSearchParameter& parameter,
                                std::vector<pb::common::DocumentWithScore>& document_with_score_results);
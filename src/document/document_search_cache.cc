@@ -0,0 +1,212 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "document/document_search_cache.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "bthread/mutex.h"
+#include "bvar/passive_status.h"
+#include "bvar/reducer.h"
+#include "bvar/window.h"
+#include "common/logging.h"
+#include "fmt/core.h"
+#include "gflags/gflags.h"
+#include "google/protobuf/io/coded_stream.h"
+#include "google/protobuf/io/zero_copy_stream_impl_lite.h"
+
+namespace dingodb {
+
+DEFINE_bool(enable_document_search_cache, false, "enable document full-text search result cache");
+DEFINE_int64(document_search_cache_capacity_bytes, 64 * 1024 * 1024, "document search result cache capacity bytes");
+DEFINE_uint32(document_search_cache_shard_num, 16, "document search result cache shard num");
+DEFINE_int64(document_search_cache_max_entry_bytes, 256 * 1024, "document search result bigger than it not cache");
+
+static bvar::Adder<int64_t> g_document_search_cache_hit_count("dingo_document_search_cache_hit_count");
+static bvar::Adder<int64_t> g_document_search_cache_miss_count("dingo_document_search_cache_miss_count");
+static bvar::Adder<int64_t> g_document_search_cache_evict_count("dingo_document_search_cache_evict_count");
+static bvar::Window<bvar::Adder<int64_t>> g_document_search_cache_hit_window(&g_document_search_cache_hit_count, 60);
+static bvar::Window<bvar::Adder<int64_t>> g_document_search_cache_miss_window(&g_document_search_cache_miss_count,
+                                                                              60);
+
+static double GetHitRatio(void*) {
+  int64_t hit = g_document_search_cache_hit_window.get_value();
+  int64_t total = hit + g_document_search_cache_miss_window.get_value();
+  return total > 0 ? static_cast<double>(hit) / total : 0.0;
+}
+
+// hit ratio in last 60 seconds
+static bvar::PassiveStatus<double> g_document_search_cache_hit_ratio("dingo_document_search_cache_hit_ratio",
+                                                                     GetHitRatio, nullptr);
+
+DocumentSearchCache::DocumentSearchCache(int64_t capacity_bytes, uint32_t shard_num)
+    : shard_capacity_bytes_(capacity_bytes / std::max(shard_num, 1U)), shards_(std::max(shard_num, 1U)) {
+  for (auto& shard : shards_) {
+    bthread_mutex_init(&shard.mutex, nullptr);
+  }
+}
+
+DocumentSearchCache::~DocumentSearchCache() {
+  for (auto& shard : shards_) {
+    bthread_mutex_destroy(&shard.mutex);
+  }
+}
+
+DocumentSearchCache& DocumentSearchCache::GetInstance() {
+  static DocumentSearchCache instance(FLAGS_document_search_cache_capacity_bytes,
+                                      FLAGS_document_search_cache_shard_num);
+  return instance;
+}
+
+bool DocumentSearchCache::IsEnabled() { return FLAGS_enable_document_search_cache; }
+
+std::string DocumentSearchCache::NormalizeQuery(const std::string& query_string) {
+  std::string result;
+  result.reserve(query_string.size());
+  for (unsigned char c : query_string) {
+    if (std::isspace(c)) {
+      if (!result.empty() && result.back() != ' ') {
+        result.push_back(' ');
+      }
+    } else {
+      result.push_back(c);
+    }
+  }
+  if (!result.empty() && result.back() == ' ') {
+    result.pop_back();
+  }
+
+  return result;
+}
+
+std::string DocumentSearchCache::Fingerprint(int64_t index_id, const pb::common::Range& region_range,
+                                             const pb::common::DocumentSearchParameter& parameter) {
+  std::string fingerprint;
+  fingerprint.append(reinterpret_cast<const char*>(&index_id), sizeof(index_id));
+
+  // the scalar data is not from tantivy, the requests differ only in it share the entry.
+  pb::common::DocumentSearchParameter normalized_parameter = parameter;
+  normalized_parameter.set_query_string(NormalizeQuery(parameter.query_string()));
+  normalized_parameter.clear_without_scalar_data();
+  normalized_parameter.clear_selected_keys();
+
+  // length prefix every part, keep parts boundary unambiguous.
+  auto append = [&fingerprint](const google::protobuf::Message& message) {
+    std::string data;
+    {
+      google::protobuf::io::StringOutputStream stream(&data);
+      google::protobuf::io::CodedOutputStream output(&stream);
+      output.SetSerializationDeterministic(true);
+      message.SerializeToCodedStream(&output);
+    }
+    uint64_t size = data.size();
+    fingerprint.append(reinterpret_cast<const char*>(&size), sizeof(size));
+    fingerprint.append(data);
+  };
+
+  append(region_range);
+  append(normalized_parameter);
+
+  return fingerprint;
+}
+
+void DocumentSearchCache::EraseEntry(Shard& shard, std::list<Entry>::iterator it) {
+  shard.bytes -= it->bytes;
+  shard.entries.erase(it->hash);
+  shard.lru.erase(it);
+}
+
+bool DocumentSearchCache::Get(const std::string& fingerprint, const Version& version,
+                              std::vector<pb::common::DocumentWithScore>& results) {
+  uint64_t hash = std::hash<std::string>{}(fingerprint);
+  auto& shard = GetShard(hash);
+
+  BAIDU_SCOPED_LOCK(shard.mutex);
+
+  auto it = shard.entries.find(hash);
+  if (it == shard.entries.end() || it->second->fingerprint != fingerprint) {
+    g_document_search_cache_miss_count << 1;
+    return false;
+  }
+
+  // document index has committed or reloaded, the entry is stale.
+  if (!(it->second->version == version)) {
+    EraseEntry(shard, it->second);
+    g_document_search_cache_miss_count << 1;
+    return false;
+  }
+
+  shard.lru.splice(shard.lru.begin(), shard.lru, it->second);
+  results = it->second->results;
+  g_document_search_cache_hit_count << 1;
+
+  return true;
+}
+
+void DocumentSearchCache::Put(const std::string& fingerprint, const Version& version,
+                              const std::vector<pb::common::DocumentWithScore>& results) {
+  int64_t bytes = sizeof(Entry) + fingerprint.size();
+  for (const auto& result : results) {
+    bytes += result.ByteSizeLong();
+  }
+  if (bytes > FLAGS_document_search_cache_max_entry_bytes || bytes > shard_capacity_bytes_) {
+    return;
+  }
+
+  uint64_t hash = std::hash<std::string>{}(fingerprint);
+  auto& shard = GetShard(hash);
+
+  BAIDU_SCOPED_LOCK(shard.mutex);
+
+  auto it = shard.entries.find(hash);
+  if (it != shard.entries.end()) {
+    EraseEntry(shard, it->second);
+  }
+
+  while (!shard.lru.empty() && shard.bytes + bytes > shard_capacity_bytes_) {
+    EraseEntry(shard, std::prev(shard.lru.end()));
+    g_document_search_cache_evict_count << 1;
+  }
+
+  shard.lru.push_front(Entry{hash, fingerprint, version, results, bytes});
+  shard.entries[hash] = shard.lru.begin();
+  shard.bytes += bytes;
+}
+
+int64_t DocumentSearchCache::Count() {
+  int64_t count = 0;
+  for (auto& shard : shards_) {
+    BAIDU_SCOPED_LOCK(shard.mutex);
+    count += shard.lru.size();
+  }
+  return count;
+}
+
+int64_t DocumentSearchCache::MemorySize() {
+  int64_t bytes = 0;
+  for (auto& shard : shards_) {
+    BAIDU_SCOPED_LOCK(shard.mutex);
+    bytes += shard.bytes;
+  }
+  return bytes;
+}
+
+}  // namespace dingodb
@@ -0,0 +1,100 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef DINGODB_DOCUMENT_SEARCH_CACHE_H_
+#define DINGODB_DOCUMENT_SEARCH_CACHE_H_
+
+#include <cstdint>
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "bthread/types.h"
+#include "proto/common.pb.h"
+
+namespace dingodb {
+
+// Store level LRU cache of the full-text search results of document index.
+// An entry is keyed by the index id, the region range and the search parameter with normalized query string, and is
+// tagged with the generations of the document index (and of its sibling while split/merge) when it is computed.
+// Any commit, reader reload or rebuild changes the generation, so Get only returns an entry computed by the same
+// tantivy searcher, the stale ones are dropped on access or by LRU eviction.
+// Only the tantivy result is cached, the scalar data is still read from kv store.
+class DocumentSearchCache {
+ public:
+  struct Version {
+    int64_t generation{0};
+    int64_t sibling_generation{0};
+
+    bool operator==(const Version& rhs) const {
+      return generation == rhs.generation && sibling_generation == rhs.sibling_generation;
+    }
+  };
+
+  DocumentSearchCache(int64_t capacity_bytes, uint32_t shard_num);
+  ~DocumentSearchCache();
+
+  DocumentSearchCache(const DocumentSearchCache& rhs) = delete;
+  DocumentSearchCache& operator=(const DocumentSearchCache& rhs) = delete;
+  DocumentSearchCache(DocumentSearchCache&& rhs) = delete;
+  DocumentSearchCache& operator=(DocumentSearchCache&& rhs) = delete;
+
+  // Create by gflags.
+  static DocumentSearchCache& GetInstance();
+
+  static bool IsEnabled();
+
+  // Trim and collapse the whitespaces of query string.
+  static std::string NormalizeQuery(const std::string& query_string);
+
+  // Serialize everything the tantivy result depends on.
+  static std::string Fingerprint(int64_t index_id, const pb::common::Range& region_range,
+                                 const pb::common::DocumentSearchParameter& parameter);
+
+  bool Get(const std::string& fingerprint, const Version& version, std::vector<pb::common::DocumentWithScore>& results);
+  void Put(const std::string& fingerprint, const Version& version,
+           const std::vector<pb::common::DocumentWithScore>& results);
+
+  int64_t Count();
+  int64_t MemorySize();
+
+ private:
+  struct Entry {
+    uint64_t hash;
+    std::string fingerprint;
+    Version version;
+    std::vector<pb::common::DocumentWithScore> results;
+    int64_t bytes;
+  };
+
+  struct Shard {
+    bthread_mutex_t mutex;
+    // front is the most recently used
+    std::list<Entry> lru;
+    std::unordered_map<uint64_t, std::list<Entry>::iterator> entries;
+    int64_t bytes{0};
+  };
+
+  Shard& GetShard(uint64_t hash) { return shards_[hash % shards_.size()]; }
+  static void EraseEntry(Shard& shard, std::list<Entry>::iterator it);
+
+  int64_t shard_capacity_bytes_;
+  std::vector<Shard> shards_;
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_DOCUMENT_SEARCH_CACHE_H_
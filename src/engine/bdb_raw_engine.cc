@@ -22,6 +22,7 @@
 #include <cstdlib>
 #include <cstring>
 #include <memory>
+#include <mutex>
 #include <random>
 #include <string>
 #include <string_view>
@@ -50,6 +51,7 @@
 
 bvar::Adder<uint64_t> bdb_snapshot_alive_count("bdb_snapshot_alive_count");
 bvar::Adder<uint64_t> bdb_transaction_alive_count("bdb_transaction_alive_count");
+bvar::Adder<uint64_t> bdb_group_commit_flush_count("bdb_group_commit_flush_count");
 
 namespace bthread {
 DECLARE_int32(bthread_concurrency);
@@ -81,6 +83,9 @@ DEFINE_int32(bdb_stat_time_s, 60, "bdb stat time interval(s)");
 
 DEFINE_bool(bdb_use_db_pool, false, "bdb use db pool");
 DEFINE_int32(bdb_db_pool_size, 4096, "bdb db pool size, must bigger than bthread_connecurrency");
+DEFINE_bool(bdb_group_commit, false, "bdb writers commit txn without sync and share one log flush");
+DEFINE_bool(bdb_point_get_without_snapshot, false,
+            "bdb get key without explicit snapshot reads latest committed value, skip creating snapshot txn");
 
 namespace bdb {
 
@@ -198,21 +203,61 @@ std::string BdbHelper::GetCfName(char cf_id) {
   return it->second;
 }
 
-int BdbHelper::TxnCommit(DbTxn** txn_ptr) {
+int BdbHelper::TxnCommit(DbTxn** txn_ptr, DbEnv* envp) {
   if (BAIDU_UNLIKELY(*txn_ptr == nullptr)) {
     return 0;
   }
 
-  auto ret = (*txn_ptr)->commit(0);
+  bool group_commit = FLAGS_bdb_group_commit && envp != nullptr;
+  auto ret = (*txn_ptr)->commit(group_commit ? DB_TXN_NOSYNC : 0);
   if (ret == 0) {
     *txn_ptr = nullptr;
   }
 
   bdb_transaction_alive_count << -1;
 
+  if (ret == 0 && group_commit) {
+    ret = BdbLogFlusher::GetInstance().Flush(envp);
+  }
+
   return ret;
 }
 
+int BdbLogFlusher::Flush(DbEnv* envp) {
+  std::unique_lock<bthread::Mutex> lock(mutex_);
+
+  int64_t seq = ++request_seq_;
+  while (flushed_seq_ < seq) {
+    if (flushing_) {
+      cond_.wait(lock);
+      continue;
+    }
+
+    // lead the flush, which covers all the requests arrived so far
+    flushing_ = true;
+    int64_t target_seq = request_seq_;
+    lock.unlock();
+
+    int ret = 0;
+    try {
+      ret = envp->log_flush(nullptr);
+    } catch (DbException& db_exception) {
+      DINGO_LOG(ERROR) << fmt::format("[bdb] log flush failed, exception: {} {}.", db_exception.get_errno(),
+                                      db_exception.what());
+      ret = BdbHelper::kCommitException;
+    }
+    bdb_group_commit_flush_count << 1;
+
+    lock.lock();
+    flushing_ = false;
+    flushed_seq_ = target_seq;
+    last_ret_ = ret;
+    cond_.notify_all();
+  }
+
+  return last_ret_;
+}
+
 int BdbHelper::TxnAbort(DbTxn** txn_ptr) {
   if (BAIDU_UNLIKELY(*txn_ptr == nullptr)) {
     return 0;
@@ -680,6 +725,10 @@ BdbSnapshot::~BdbSnapshot() {
 
 // Reader
 butil::Status Reader::KvGet(const std::string& cf_name, const std::string& key, std::string& value) {
+  // a single get needs no snapshot, which costs a snapshot txn and a cursor
+  if (FLAGS_bdb_point_get_without_snapshot) {
+    return KvGet(cf_name, nullptr, key, value);
+  }
   return KvGet(cf_name, GetSnapshot(), key, value);
 }
 
@@ -737,6 +786,31 @@ butil::Status Reader::KvGet(const std::string& cf_name, dingodb::SnapshotPtr sna
   return butil::Status(pb::error::EBDB_UNKNOW, "unknow error.");
 }
 
+butil::Status Reader::KvMultiGet(const std::string& cf_name, const std::vector<std::string>& keys,
+                                 std::vector<std::string>& values, std::vector<bool>& exists) {
+  return KvMultiGet(cf_name, GetSnapshot(), keys, values, exists);
+}
+
+// bdb has no batch get, get key one by one.
+butil::Status Reader::KvMultiGet(const std::string& cf_name, dingodb::SnapshotPtr snapshot,
+                                 const std::vector<std::string>& keys, std::vector<std::string>& values,
+                                 std::vector<bool>& exists) {
+  values.clear();
+  values.resize(keys.size());
+  exists.assign(keys.size(), false);
+
+  for (size_t i = 0; i < keys.size(); ++i) {
+    auto status = KvGet(cf_name, snapshot, keys[i], values[i]);
+    if (status.ok()) {
+      exists[i] = true;
+    } else if (status.error_code() != pb::error::EKEY_NOT_FOUND) {
+      return status;
+    }
+  }
+
+  return butil::Status();
+}
+
 butil::Status Reader::KvScan(const std::string& cf_name, const std::string& start_key, const std::string& end_key,
                              std::vector<pb::common::KeyValue>& kvs) {
   return KvScan(cf_name, GetSnapshot(), start_key, end_key, kvs);
@@ -1063,7 +1137,7 @@ butil::Status Writer::KvPut(const std::string& cf_name, const pb::common::KeyVal
 
       // commit
       try {
-        ret = BdbHelper::TxnCommit(&txn);
+        ret = BdbHelper::TxnCommit(&txn, envp);
         if (ret == 0) {
           return butil::Status::OK();
         } else {
@@ -1184,7 +1258,7 @@ butil::Status Writer::KvBatchPutAndDelete(const std::string& cf_name,
 
       // commit
       try {
-        ret = BdbHelper::TxnCommit(&txn);
+        ret = BdbHelper::TxnCommit(&txn, envp);
         if (ret == 0) {
           DINGO_LOG(DEBUG) << fmt::format(
               "[bdb] batch put and delete success, cf_name: {}, put size: {}, delete size: {}.", cf_name,
@@ -1316,7 +1390,7 @@ butil::Status Writer::KvBatchPutAndDelete(
 
       // commit
       try {
-        ret = BdbHelper::TxnCommit(&txn);
+        ret = BdbHelper::TxnCommit(&txn, envp);
         if (ret == 0) {
           return butil::Status::OK();
         }
@@ -1472,7 +1546,7 @@ butil::Status Writer::KvBatchDelete(const std::string& cf_name, const std::vecto
 
       // commit
       try {
-        ret = BdbHelper::TxnCommit(&txn);
+        ret = BdbHelper::TxnCommit(&txn, envp);
         if (ret == 0) {
           return butil::Status::OK();
         } else {
@@ -1563,7 +1637,7 @@ butil::Status Writer::KvDelete(const std::string& cf_name, const std::string& ke
 
       // commit
       try {
-        ret = BdbHelper::TxnCommit(&txn);
+        ret = BdbHelper::TxnCommit(&txn, envp);
         if (ret == 0) {
           return butil::Status::OK();
         }
@@ -1677,7 +1751,7 @@ butil::Status Writer::KvBatchDeleteRangeNormal(
 
       // commit
       try {
-        ret = BdbHelper::TxnCommit(&txn);
+        ret = BdbHelper::TxnCommit(&txn, envp);
         if (ret == 0) {
           return butil::Status::OK();
         }
@@ -2315,13 +2389,14 @@ butil::Status BdbRawEngine::IngestExternalFile(const std::string& cf_name, const
   return butil::Status();
 }
 
-void BdbRawEngine::Flush(const std::string& /*cf_name*/) {
+butil::Status BdbRawEngine::Flush(const std::string& /*cf_name*/) {
   try {
     int ret = db_->sync(0);
     if (ret == 0) {
       DINGO_LOG(INFO) << fmt::format("[bdb] flush done!");
     } else {
       DINGO_LOG(ERROR) << fmt::format("[bdb] flush failed, ret: {}.", ret);
+      return butil::Status(pb::error::EINTERNAL, "Flush failed, ret: %d", ret);
     }
 
     envp_->stat_print(DB_STAT_SUBSYSTEM);
@@ -2329,7 +2404,10 @@ void BdbRawEngine::Flush(const std::string& /*cf_name*/) {
     bdb::BdbHelper::PrintEnvStat(GetEnv());
     DINGO_LOG(ERROR) << fmt::format("[bdb] error flushing, exception: {} {}.", db_exception.get_errno(),
                                     db_exception.what());
+    return butil::Status(pb::error::EINTERNAL, "Flush failed, exception: %s", db_exception.what());
   }
+
+  return butil::Status();
 }
 
 butil::Status BdbRawEngine::Compact(const std::string& cf_name) {
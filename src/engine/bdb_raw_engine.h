@@ -23,6 +23,8 @@
 #include <unordered_map>
 #include <vector>
 
+#include "bthread/condition_variable.h"
+#include "bthread/mutex.h"
 #include "common/synchronization.h"
 #include "config/config.h"
 #include "db_cxx.h"
@@ -72,7 +74,8 @@ class BdbHelper {
   static std::unordered_map<std::string, char> cf_name_to_id;
   static std::unordered_map<char, std::string> cf_id_to_name;
 
-  static int TxnCommit(DbTxn** txn_ptr);
+  // Commit write txn with envp when bdb_group_commit is on, the concurrent commits share one log flush.
+  static int TxnCommit(DbTxn** txn_ptr, DbEnv* envp = nullptr);
   static int TxnAbort(DbTxn** txn_ptr);
 
   static void CheckpointThread(DbEnv* env, Db* db, std::atomic<bool>& is_close);
@@ -80,6 +83,31 @@ class BdbHelper {
   static void PrintEnvStat(DbEnv* env);
 };
 
+// Group commit of bdb, the writers commit txn without sync, then wait one log flush which is started after their
+// commit, so the concurrent writers share one log flush instead of one sync per txn.
+class BdbLogFlusher {
+ public:
+  static BdbLogFlusher& GetInstance() {
+    static BdbLogFlusher instance;
+    return instance;
+  }
+
+  // Flush the log of the txns committed before call, return 0 on success.
+  int Flush(DbEnv* envp);
+
+ private:
+  BdbLogFlusher() = default;
+  ~BdbLogFlusher() = default;
+
+  bthread::Mutex mutex_;
+  bthread::ConditionVariable cond_;
+  // sequence of flush request and the last done flush
+  int64_t request_seq_{0};
+  int64_t flushed_seq_{0};
+  bool flushing_{false};
+  int last_ret_{0};
+};
+
 // Snapshot
 class BdbSnapshot : public dingodb::Snapshot {
  public:
@@ -168,6 +196,12 @@ class Reader : public RawEngine::Reader {
   butil::Status KvGet(const std::string& cf_name, dingodb::SnapshotPtr snapshot, const std::string& key,
                       std::string& value) override;
 
+  butil::Status KvMultiGet(const std::string& cf_name, const std::vector<std::string>& keys,
+                           std::vector<std::string>& values, std::vector<bool>& exists) override;
+  butil::Status KvMultiGet(const std::string& cf_name, dingodb::SnapshotPtr snapshot,
+                           const std::vector<std::string>& keys, std::vector<std::string>& values,
+                           std::vector<bool>& exists) override;
+
   butil::Status KvScan(const std::string& cf_name, const std::string& start_key, const std::string& end_key,
                        std::vector<pb::common::KeyValue>& kvs) override;
   butil::Status KvScan(const std::string& cf_name, dingodb::SnapshotPtr snapshot, const std::string& start_key,
@@ -267,7 +301,7 @@ class BdbRawEngine : public RawEngine {
                                      std::vector<std::string>& merge_sst_paths) override;
   butil::Status IngestExternalFile(const std::string& cf_name, const std::vector<std::string>& files) override;
 
-  void Flush(const std::string& cf_name) override;
+  butil::Status Flush(const std::string& cf_name) override;
   butil::Status Compact(const std::string& cf_name) override;
   std::vector<int64_t> GetApproximateSizes(const std::string& cf_name, std::vector<pb::common::Range>& ranges) override;
 
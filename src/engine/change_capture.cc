@@ -0,0 +1,573 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "engine/change_capture.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "bthread/bthread.h"
+#include "bthread/mutex.h"
+#include "bvar/reducer.h"
+#include "common/constant.h"
+#include "common/helper.h"
+#include "common/logging.h"
+#include "fmt/core.h"
+#include "gflags/gflags.h"
+#include "proto/error.pb.h"
+#include "proto/store.pb.h"
+#include "raft/raft_cmd_codec.h"
+#include "server/server.h"
+
+namespace dingodb {
+
+DEFINE_bool(enable_cdc, false, "enable change data capture, the committed writes are streamed to the subscribers");
+DEFINE_int64(cdc_region_buffer_bytes, 8 * 1024 * 1024,
+             "max bytes of buffered events per subscribed region, the evicted events are read from raft log");
+DEFINE_int32(cdc_catch_up_batch_size, 256, "max raft log entries read per batch when catching up");
+DEFINE_int32(cdc_retry_interval_ms, 100, "retry interval ms when the sink is full");
+
+static bvar::Adder<int64_t> g_cdc_event_count("dingo_cdc_event_count");
+static bvar::Adder<int64_t> g_cdc_evict_count("dingo_cdc_evict_count");
+static bvar::Adder<int64_t> g_cdc_catch_up_entry_count("dingo_cdc_catch_up_entry_count");
+
+static bool IsInternalEvent(const ChangeEvent& event) {
+  return event.type == ChangeEvent::Type::kTxnPrewrite || event.type == ChangeEvent::Type::kTxnRollback;
+}
+
+static void AppendInt64(butil::IOBuf& buf, int64_t value) {
+  char data[8];
+  for (int i = 7; i >= 0; --i) {
+    data[i] = static_cast<char>(value & 0xff);
+    value >>= 8;
+  }
+  buf.append(data, sizeof(data));
+}
+
+static void AppendString(butil::IOBuf& buf, const std::string& str) {
+  uint32_t size = str.size();
+  char data[4] = {static_cast<char>(size >> 24), static_cast<char>(size >> 16), static_cast<char>(size >> 8),
+                  static_cast<char>(size)};
+  buf.append(data, sizeof(data));
+  buf.append(str);
+}
+
+void ChangeEvent::EncodeTo(butil::IOBuf& buf) const {
+  buf.push_back(static_cast<char>(type));
+  AppendInt64(buf, log_index);
+  AppendInt64(buf, start_ts);
+  AppendInt64(buf, commit_ts);
+  buf.push_back(value_missing ? 1 : 0);
+  AppendString(buf, key);
+  AppendString(buf, value);
+}
+
+bool StreamChangeSink::OnEvents(int64_t region_id, const std::vector<ChangeEvent>& events) {
+  butil::IOBuf buf;
+  for (const auto& event : events) {
+    event.EncodeTo(buf);
+  }
+
+  int ret = brpc::StreamWrite(stream_id_, buf);
+  if (ret == EAGAIN) {
+    return false;
+  }
+  if (ret != 0) {
+    DINGO_LOG(WARNING) << fmt::format("[cdc][region({})] write stream({}) failed, error: {}", region_id, stream_id_,
+                                      ret);
+  }
+
+  return true;
+}
+
+void StreamChangeSink::OnError(int64_t region_id, const butil::Status& status) {
+  DINGO_LOG(WARNING) << fmt::format("[cdc][region({})] close stream({}), error: {} {}", region_id, stream_id_,
+                                    pb::error::Errno_Name(status.error_code()), status.error_str());
+  brpc::StreamClose(stream_id_);
+}
+
+ChangeCapture::ChangeCapture() { bthread_mutex_init(&mutex_, nullptr); }
+
+ChangeCapture::~ChangeCapture() { bthread_mutex_destroy(&mutex_); }
+
+ChangeCapture& ChangeCapture::GetInstance() {
+  static ChangeCapture instance;
+  return instance;
+}
+
+bool ChangeCapture::IsEnabled() { return FLAGS_enable_cdc; }
+
+void ChangeCapture::Collect(const pb::raft::Request& req, int64_t log_index, std::vector<ChangeEvent>& events) {
+  auto new_event = [&](ChangeEvent::Type type) -> ChangeEvent& {
+    auto& event = events.emplace_back();
+    event.type = type;
+    event.log_index = log_index;
+    return event;
+  };
+
+  switch (req.cmd_type()) {
+    case pb::raft::PUT: {
+      const auto& request = req.put();
+      if (request.cf_name() != Constant::kStoreDataCF) {
+        break;
+      }
+      for (const auto& kv : request.kvs()) {
+        auto& event = new_event(ChangeEvent::Type::kPut);
+        event.key = kv.key();
+        event.value = kv.value();
+      }
+      break;
+    }
+    case pb::raft::DELETEBATCH: {
+      const auto& request = req.delete_batch();
+      if (request.cf_name() != Constant::kStoreDataCF) {
+        break;
+      }
+      for (const auto& key : request.keys()) {
+        new_event(ChangeEvent::Type::kDelete).key = key;
+      }
+      break;
+    }
+    case pb::raft::DELETERANGE: {
+      const auto& request = req.delete_range();
+      if (request.cf_name() != Constant::kStoreDataCF) {
+        break;
+      }
+      for (const auto& range : request.ranges()) {
+        auto& event = new_event(ChangeEvent::Type::kDeleteRange);
+        event.key = range.start_key();
+        event.value = range.end_key();
+      }
+      break;
+    }
+    case pb::raft::TXN: {
+      const auto& txn_raft_req = req.txn_raft_req();
+      if (!txn_raft_req.has_multi_cf_put_and_delete()) {
+        break;
+      }
+
+      // 1pc prewrite and commit are in the same request, so the prewrite goes first
+      const auto& request = txn_raft_req.multi_cf_put_and_delete();
+      for (const auto& puts : request.puts_with_cf()) {
+        if (puts.cf_name() != Constant::kTxnDataCF) {
+          continue;
+        }
+        for (const auto& kv : puts.kvs()) {
+          auto& event = new_event(ChangeEvent::Type::kTxnPrewrite);
+          event.key = kv.key();
+          event.value = kv.value();
+        }
+      }
+
+      for (const auto& puts : request.puts_with_cf()) {
+        if (puts.cf_name() != Constant::kTxnWriteCF) {
+          continue;
+        }
+        for (const auto& kv : puts.kvs()) {
+          std::string key;
+          int64_t commit_ts = 0;
+          pb::store::WriteInfo write_info;
+          if (!Helper::DecodeTxnKey(kv.key(), key, commit_ts).ok() || !write_info.ParseFromString(kv.value())) {
+            DINGO_LOG(ERROR) << fmt::format("[cdc] decode write failed, log_index: {} key: {}", log_index,
+                                            Helper::StringToHex(kv.key()));
+            continue;
+          }
+
+          ChangeEvent::Type type;
+          if (write_info.op() == pb::store::Op::Put) {
+            type = ChangeEvent::Type::kTxnPut;
+          } else if (write_info.op() == pb::store::Op::Delete) {
+            type = ChangeEvent::Type::kTxnDelete;
+          } else if (write_info.op() == pb::store::Op::Rollback) {
+            type = ChangeEvent::Type::kTxnRollback;
+          } else {
+            continue;
+          }
+
+          auto& event = new_event(type);
+          event.key = std::move(key);
+          event.value = write_info.short_value();
+          event.start_ts = write_info.start_ts();
+          event.commit_ts = commit_ts;
+        }
+      }
+      break;
+    }
+    default:
+      break;
+  }
+}
+
+void ChangeCapture::ResolveTxnValue(std::map<std::string, std::string>& prewrites, int64_t& prewrite_bytes,
+                                    std::vector<ChangeEvent>& events) {
+  auto erase_prewrite = [&](const ChangeEvent& event, std::string* value) -> bool {
+    auto it = prewrites.find(Helper::EncodeTxnKey(event.key, event.start_ts));
+    if (it == prewrites.end()) {
+      return false;
+    }
+    prewrite_bytes -= it->first.size() + it->second.size();
+    if (value != nullptr) {
+      value->swap(it->second);
+    }
+    prewrites.erase(it);
+    return true;
+  };
+
+  for (auto& event : events) {
+    if (event.type == ChangeEvent::Type::kTxnPrewrite) {
+      prewrite_bytes += event.key.size() + event.value.size();
+      prewrites[event.key].swap(event.value);
+    } else if (event.type == ChangeEvent::Type::kTxnRollback) {
+      erase_prewrite(event, nullptr);
+    } else if (event.type == ChangeEvent::Type::kTxnPut) {
+      // short value is in the write
+      if (!erase_prewrite(event, event.value.empty() ? &event.value : nullptr) && event.value.empty()) {
+        event.value_missing = true;
+      }
+    }
+  }
+
+  events.erase(std::remove_if(events.begin(), events.end(), IsInternalEvent), events.end());
+
+  // the prewrite of a txn never committed or rolled back here, e.g. the region is split
+  if (prewrite_bytes > FLAGS_cdc_region_buffer_bytes) {
+    prewrites.clear();
+    prewrite_bytes = 0;
+  }
+}
+
+void ChangeCapture::Append(int64_t region_id, int64_t log_index, std::vector<ChangeEvent> events) {
+  if (events.empty()) {
+    return;
+  }
+
+  BAIDU_SCOPED_LOCK(mutex_);
+  captured_indexes_[region_id] = log_index;
+
+  auto it = regions_.find(region_id);
+  if (it == regions_.end()) {
+    return;
+  }
+  auto state = it->second;
+  // already read from raft log
+  if (log_index < state->complete_index) {
+    return;
+  }
+
+  ResolveTxnValue(state->prewrites, state->prewrite_bytes, events);
+  if (events.empty()) {
+    return;
+  }
+  g_cdc_event_count << events.size();
+
+  for (auto& [_, subscriber] : state->subscribers) {
+    if (subscriber->is_live && !subscriber->sink->OnEvents(region_id, events)) {
+      // fall behind, catch up from buffer or raft log
+      subscriber->is_live = false;
+      subscriber->next_index = log_index;
+      LaunchCatchUp(region_id, subscriber->id);
+    } else if (subscriber->is_live) {
+      subscriber->next_index = log_index + 1;
+    }
+  }
+
+  BufferEntry entry;
+  entry.log_index = log_index;
+  for (const auto& event : events) {
+    entry.bytes += event.ByteSize();
+  }
+  entry.events = std::move(events);
+  state->bytes += entry.bytes;
+  state->entries.push_back(std::move(entry));
+
+  while (state->bytes > FLAGS_cdc_region_buffer_bytes && !state->entries.empty()) {
+    state->complete_index = state->entries.front().log_index + 1;
+    state->bytes -= state->entries.front().bytes;
+    state->entries.pop_front();
+    g_cdc_evict_count << 1;
+  }
+}
+
+void ChangeCapture::Capture(int64_t region_id, int64_t log_index, const pb::raft::Request& req) {
+  std::vector<ChangeEvent> events;
+  Collect(req, log_index, events);
+  Append(region_id, log_index, std::move(events));
+}
+
+butil::Status ChangeCapture::Subscribe(int64_t region_id, int64_t start_index, ChangeSinkPtr sink,
+                                       int64_t& subscriber_id) {
+  if (!IsEnabled()) {
+    return butil::Status(pb::error::ENOT_SUPPORT, "cdc is disabled");
+  }
+  auto raft_meta = Server::GetInstance().GetRaftMeta(region_id);
+  if (raft_meta == nullptr) {
+    return butil::Status(pb::error::EREGION_NOT_FOUND, "not found region");
+  }
+
+  {
+    BAIDU_SCOPED_LOCK(mutex_);
+    auto& state = regions_[region_id];
+    if (state == nullptr) {
+      // The log not greater than it is already applied or appended without buffer.
+      state = std::make_shared<RegionState>();
+      state->complete_index = std::max(captured_indexes_[region_id], raft_meta->AppliedId()) + 1;
+    }
+
+    auto subscriber = std::make_shared<Subscriber>();
+    subscriber->id = next_subscriber_id_++;
+    subscriber->sink = sink;
+    subscriber->next_index = start_index > 0 ? start_index : state->complete_index;
+    state->subscribers[subscriber->id] = subscriber;
+    subscriber_id = subscriber->id;
+  }
+
+  DINGO_LOG(INFO) << fmt::format("[cdc][region({})] subscribe, subscriber({}) start_index({})", region_id,
+                                 subscriber_id, start_index);
+  LaunchCatchUp(region_id, subscriber_id);
+
+  return butil::Status::OK();
+}
+
+void ChangeCapture::Unsubscribe(int64_t region_id, int64_t subscriber_id) {
+  BAIDU_SCOPED_LOCK(mutex_);
+  auto it = regions_.find(region_id);
+  if (it == regions_.end()) {
+    return;
+  }
+
+  it->second->subscribers.erase(subscriber_id);
+  if (it->second->subscribers.empty()) {
+    regions_.erase(it);
+  }
+}
+
+void ChangeCapture::EraseRegion(int64_t region_id) {
+  RegionStatePtr state;
+  {
+    BAIDU_SCOPED_LOCK(mutex_);
+    captured_indexes_.erase(region_id);
+    auto it = regions_.find(region_id);
+    if (it == regions_.end()) {
+      return;
+    }
+    state = it->second;
+    regions_.erase(it);
+  }
+
+  DINGO_LOG(INFO) << fmt::format("[cdc][region({})] erase region, subscriber num: {}", region_id,
+                                 state->subscribers.size());
+  for (auto& [_, subscriber] : state->subscribers) {
+    subscriber->sink->OnError(region_id, butil::Status(pb::error::EREGION_UNAVAILABLE, "region data is changed"));
+  }
+}
+
+void ChangeCapture::AdvanceResolvedTs(int64_t region_id, int64_t resolved_ts) {
+  BAIDU_SCOPED_LOCK(mutex_);
+  auto it = regions_.find(region_id);
+  if (it == regions_.end() || resolved_ts <= it->second->resolved_ts) {
+    return;
+  }
+  auto state = it->second;
+  state->resolved_ts = resolved_ts;
+
+  std::vector<ChangeEvent> events(1);
+  events[0].type = ChangeEvent::Type::kResolvedTs;
+  events[0].log_index = captured_indexes_[region_id];
+  events[0].commit_ts = resolved_ts;
+  for (auto& [_, subscriber] : state->subscribers) {
+    // the lagging subscriber get it when live
+    if (subscriber->is_live) {
+      subscriber->sink->OnEvents(region_id, events);
+    }
+  }
+}
+
+void ChangeCapture::LaunchCatchUp(int64_t region_id, int64_t subscriber_id) {
+  auto* arg = new CatchUpArg{region_id, subscriber_id};
+
+  bthread_t tid;
+  if (bthread_start_background(&tid, &BTHREAD_ATTR_NORMAL, CatchUp, arg) != 0) {
+    DINGO_LOG(ERROR) << fmt::format("[cdc][region({})] start catch up bthread failed.", region_id);
+    delete arg;
+  }
+}
+
+void* ChangeCapture::CatchUp(void* arg) {
+  std::unique_ptr<CatchUpArg> catch_up_arg(static_cast<CatchUpArg*>(arg));
+  ChangeCapture::GetInstance().DoCatchUp(catch_up_arg->region_id, catch_up_arg->subscriber_id);
+  return nullptr;
+}
+
+ChangeCapture::SubscriberPtr ChangeCapture::GetSubscriber(int64_t region_id, int64_t subscriber_id) {
+  auto it = regions_.find(region_id);
+  if (it == regions_.end()) {
+    return nullptr;
+  }
+  auto sub_it = it->second->subscribers.find(subscriber_id);
+  return sub_it != it->second->subscribers.end() ? sub_it->second : nullptr;
+}
+
+bool ChangeCapture::SendBuffer(int64_t region_id, RegionStatePtr state, SubscriberPtr subscriber) {
+  for (const auto& entry : state->entries) {
+    if (entry.log_index < subscriber->next_index) {
+      continue;
+    }
+    if (!subscriber->sink->OnEvents(region_id, entry.events)) {
+      return false;
+    }
+    subscriber->next_index = entry.log_index + 1;
+  }
+
+  subscriber->is_live = true;
+  if (state->resolved_ts > 0) {
+    std::vector<ChangeEvent> events(1);
+    events[0].type = ChangeEvent::Type::kResolvedTs;
+    events[0].log_index = subscriber->next_index - 1;
+    events[0].commit_ts = state->resolved_ts;
+    subscriber->sink->OnEvents(region_id, events);
+  }
+
+  return true;
+}
+
+butil::Status ChangeCapture::ReadLog(int64_t region_id, int64_t begin_index, int64_t end_index,
+                                     std::vector<BufferEntry>& entries) {
+  auto region = Server::GetInstance().GetRegion(region_id);
+  auto log_storage = Server::GetInstance().GetLogStorageManager()->GetLogStorage(region_id);
+  if (region == nullptr || log_storage == nullptr) {
+    return butil::Status(pb::error::EREGION_NOT_FOUND, "not found region or raft log");
+  }
+  if (begin_index < log_storage->FirstLogIndex()) {
+    return butil::Status(pb::error::ENO_ENTRIES,
+                         fmt::format("raft log is truncated to {}", log_storage->FirstLogIndex()));
+  }
+
+  auto epoch = region->Epoch();
+  for (const auto& log_entry : log_storage->GetEntrys(begin_index, end_index)) {
+    pb::raft::RaftCmdRequest raft_cmd;
+    if (!RaftCmdCodec::Decode(log_entry->data, raft_cmd)) {
+      return butil::Status(pb::error::EINTERNAL, fmt::format("decode raft log {} failed", log_entry->index));
+    }
+    // The entry of other epoch may be not applied, the subscriber should restart from the current epoch.
+    if (raft_cmd.header().epoch().version() != epoch.version()) {
+      return butil::Status(pb::error::EREGION_VERSION,
+                           fmt::format("raft log {} epoch is not match, region epoch({}) log epoch({})",
+                                       log_entry->index, Helper::RegionEpochToString(epoch),
+                                       Helper::RegionEpochToString(raft_cmd.header().epoch())));
+    }
+
+    BufferEntry entry;
+    entry.log_index = log_entry->index;
+    for (const auto& req : raft_cmd.requests()) {
+      Collect(req, log_entry->index, entry.events);
+    }
+    if (!entry.events.empty()) {
+      entries.push_back(std::move(entry));
+    }
+  }
+  g_cdc_catch_up_entry_count << end_index - begin_index + 1;
+
+  return butil::Status::OK();
+}
+
+void ChangeCapture::Fail(int64_t region_id, int64_t subscriber_id, const butil::Status& status) {
+  SubscriberPtr subscriber;
+  {
+    BAIDU_SCOPED_LOCK(mutex_);
+    subscriber = GetSubscriber(region_id, subscriber_id);
+  }
+  if (subscriber == nullptr) {
+    return;
+  }
+
+  DINGO_LOG(WARNING) << fmt::format("[cdc][region({})] subscriber({}) failed, next_index({}) error: {} {}", region_id,
+                                    subscriber_id, subscriber->next_index, pb::error::Errno_Name(status.error_code()),
+                                    status.error_str());
+  Unsubscribe(region_id, subscriber_id);
+  subscriber->sink->OnError(region_id, status);
+}
+
+void ChangeCapture::DoCatchUp(int64_t region_id, int64_t subscriber_id) {
+  // the prewrites read from raft log
+  std::map<std::string, std::string> prewrites;
+  int64_t prewrite_bytes = 0;
+
+  for (;;) {
+    int64_t begin_index = 0;
+    int64_t end_index = 0;
+    ChangeSinkPtr sink;
+    {
+      BAIDU_SCOPED_LOCK(mutex_);
+      auto subscriber = GetSubscriber(region_id, subscriber_id);
+      if (subscriber == nullptr || subscriber->is_live) {
+        return;
+      }
+
+      auto state = regions_[region_id];
+      if (subscriber->next_index >= state->complete_index) {
+        if (SendBuffer(region_id, state, subscriber)) {
+          DINGO_LOG(INFO) << fmt::format("[cdc][region({})] subscriber({}) is live, next_index({})", region_id,
+                                         subscriber_id, subscriber->next_index);
+          return;
+        }
+      } else {
+        begin_index = subscriber->next_index;
+        end_index = std::min(state->complete_index - 1, begin_index + FLAGS_cdc_catch_up_batch_size - 1);
+        sink = subscriber->sink;
+      }
+    }
+
+    // sink is full
+    if (sink == nullptr) {
+      bthread_usleep(FLAGS_cdc_retry_interval_ms * 1000L);
+      continue;
+    }
+
+    std::vector<BufferEntry> entries;
+    auto status = ReadLog(region_id, begin_index, end_index, entries);
+    if (!status.ok()) {
+      Fail(region_id, subscriber_id, status);
+      return;
+    }
+
+    for (auto& entry : entries) {
+      ResolveTxnValue(prewrites, prewrite_bytes, entry.events);
+      if (entry.events.empty()) {
+        continue;
+      }
+      while (!sink->OnEvents(region_id, entry.events)) {
+        bthread_usleep(FLAGS_cdc_retry_interval_ms * 1000L);
+        BAIDU_SCOPED_LOCK(mutex_);
+        if (GetSubscriber(region_id, subscriber_id) == nullptr) {
+          return;
+        }
+      }
+    }
+
+    BAIDU_SCOPED_LOCK(mutex_);
+    auto subscriber = GetSubscriber(region_id, subscriber_id);
+    if (subscriber == nullptr) {
+      return;
+    }
+    subscriber->next_index = end_index + 1;
+  }
+}
+
+}  // namespace dingodb
@@ -0,0 +1,190 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef DINGODB_ENGINE_CHANGE_CAPTURE_H_
+#define DINGODB_ENGINE_CHANGE_CAPTURE_H_
+
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "brpc/stream.h"
+#include "bthread/types.h"
+#include "butil/iobuf.h"
+#include "butil/status.h"
+#include "proto/raft.pb.h"
+
+namespace dingodb {
+
+// Change of the committed write, raw kv put/delete or committed txn put/delete.
+struct ChangeEvent {
+  enum class Type : uint8_t {
+    kPut = 0,
+    kDelete = 1,
+    // key is start key, value is end key
+    kDeleteRange = 2,
+    kTxnPut = 3,
+    kTxnDelete = 4,
+    // all the txn which commit_ts not greater than commit_ts are sent
+    kResolvedTs = 5,
+
+    // internal, the prewrite value and rollback of txn, not sent
+    kTxnPrewrite = 100,
+    kTxnRollback = 101,
+  };
+
+  Type type{Type::kPut};
+  int64_t log_index{0};
+  std::string key;
+  std::string value;
+  int64_t start_ts{0};
+  int64_t commit_ts{0};
+  // The txn value is prewritten before the capture, read it from data cf by key and start_ts.
+  bool value_missing{false};
+
+  int64_t ByteSize() const { return sizeof(ChangeEvent) + key.size() + value.size(); }
+
+  // | type(1B) | log_index(8B) | start_ts(8B) | commit_ts(8B) | value_missing(1B) | key size(4B) | key |
+  // | value size(4B) | value |, integer is big endian.
+  void EncodeTo(butil::IOBuf& buf) const;
+};
+
+// Receive the change events of region in log order, it must not block.
+class ChangeSink {
+ public:
+  virtual ~ChangeSink() = default;
+
+  // Return false if the sink is full, the events are sent again later.
+  virtual bool OnEvents(int64_t region_id, const std::vector<ChangeEvent>& events) = 0;
+  // The subscription is terminated, e.g. the raft log is truncated.
+  virtual void OnError(int64_t region_id, const butil::Status& status) = 0;
+};
+
+using ChangeSinkPtr = std::shared_ptr<ChangeSink>;
+
+// Write the events to the brpc stream accepted by the subscribe rpc, the stream is closed on error.
+class StreamChangeSink : public ChangeSink {
+ public:
+  explicit StreamChangeSink(brpc::StreamId stream_id) : stream_id_(stream_id) {}
+  ~StreamChangeSink() override = default;
+
+  bool OnEvents(int64_t region_id, const std::vector<ChangeEvent>& events) override;
+  void OnError(int64_t region_id, const butil::Status& status) override;
+
+ private:
+  brpc::StreamId stream_id_;
+};
+
+// Change data capture, tap the committed writes in raft apply and stream them to the subscribers.
+// The events of a subscribed region are buffered in memory with a bound, a subscriber start from an earlier log
+// index or fall behind catch up from the raft log, the data cf is never read again.
+// The resolved ts is sent when it moves forward, so subscriber know all txn committed before it are received.
+class ChangeCapture {
+ public:
+  ChangeCapture();
+  ~ChangeCapture();
+
+  ChangeCapture(const ChangeCapture& rhs) = delete;
+  ChangeCapture& operator=(const ChangeCapture& rhs) = delete;
+  ChangeCapture(ChangeCapture&& rhs) = delete;
+  ChangeCapture& operator=(ChangeCapture&& rhs) = delete;
+
+  static ChangeCapture& GetInstance();
+
+  static bool IsEnabled();
+
+  // Collect the change events of the raft request, internal events included.
+  static void Collect(const pb::raft::Request& req, int64_t log_index, std::vector<ChangeEvent>& events);
+
+  // Append the events of the applied log, must be called in log order per region after the write.
+  void Append(int64_t region_id, int64_t log_index, std::vector<ChangeEvent> events);
+  void Capture(int64_t region_id, int64_t log_index, const pb::raft::Request& req);
+
+  // Subscribe the change of region from start_index, start_index <= 0 means from now on.
+  butil::Status Subscribe(int64_t region_id, int64_t start_index, ChangeSinkPtr sink, int64_t& subscriber_id);
+  void Unsubscribe(int64_t region_id, int64_t subscriber_id);
+
+  // Terminate the subscriptions, e.g. region is deleted or its data is replaced by snapshot.
+  void EraseRegion(int64_t region_id);
+
+  // Send resolved ts to the subscribers if it moves forward.
+  void AdvanceResolvedTs(int64_t region_id, int64_t resolved_ts);
+
+  // Fill the txn value by the prewrite, drop the internal events.
+  static void ResolveTxnValue(std::map<std::string, std::string>& prewrites, int64_t& prewrite_bytes,
+                              std::vector<ChangeEvent>& events);
+
+ private:
+  struct Subscriber {
+    int64_t id{0};
+    ChangeSinkPtr sink;
+    // the next log index to send
+    int64_t next_index{0};
+    // receive the appended events directly, otherwise catching up
+    bool is_live{false};
+  };
+  using SubscriberPtr = std::shared_ptr<Subscriber>;
+
+  struct BufferEntry {
+    int64_t log_index{0};
+    std::vector<ChangeEvent> events;
+    int64_t bytes{0};
+  };
+
+  struct RegionState {
+    // The buffer have all the events from complete_index.
+    int64_t complete_index{0};
+    std::deque<BufferEntry> entries;
+    int64_t bytes{0};
+
+    // data key -> prewrite value
+    std::map<std::string, std::string> prewrites;
+    int64_t prewrite_bytes{0};
+
+    int64_t resolved_ts{0};
+    std::map<int64_t, SubscriberPtr> subscribers;
+  };
+  using RegionStatePtr = std::shared_ptr<RegionState>;
+
+  struct CatchUpArg {
+    int64_t region_id;
+    int64_t subscriber_id;
+  };
+  static void* CatchUp(void* arg);
+  void DoCatchUp(int64_t region_id, int64_t subscriber_id);
+  void LaunchCatchUp(int64_t region_id, int64_t subscriber_id);
+
+  // Send the buffered events to subscriber, return true if it's live.
+  bool SendBuffer(int64_t region_id, RegionStatePtr state, SubscriberPtr subscriber);
+  // Read the events in [begin_index, end_index] from raft log.
+  static butil::Status ReadLog(int64_t region_id, int64_t begin_index, int64_t end_index,
+                               std::vector<BufferEntry>& entries);
+  void Fail(int64_t region_id, int64_t subscriber_id, const butil::Status& status);
+  SubscriberPtr GetSubscriber(int64_t region_id, int64_t subscriber_id);
+
+  bthread_mutex_t mutex_;
+  // region id -> the last log index has events, tracked for all regions
+  std::map<int64_t, int64_t> captured_indexes_;
+  // subscribed regions
+  std::map<int64_t, RegionStatePtr> regions_;
+  int64_t next_subscriber_id_{1};
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_ENGINE_CHANGE_CAPTURE_H_
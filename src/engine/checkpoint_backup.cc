@@ -0,0 +1,301 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "engine/checkpoint_backup.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <set>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "common/helper.h"
+#include "common/logging.h"
+#include "fmt/core.h"
+#include "gflags/gflags.h"
+#include "proto/common.pb.h"
+#include "proto/error.pb.h"
+#include "server/server.h"
+
+namespace dingodb {
+
+DEFINE_string(checkpoint_backup_dir, "", "incremental checkpoint backup directory, empty disable backup");
+DEFINE_string(checkpoint_backup_tmp_dir, "./backup_tmp",
+              "local directory of the checkpoint before upload, should be in the file system of db");
+DEFINE_int32(checkpoint_backup_interval_s, 3600, "checkpoint backup interval seconds");
+DEFINE_int32(checkpoint_backup_keep_num, 24, "checkpoint backup keep latest backup number");
+DEFINE_int32(checkpoint_backup_upload_parallel_num, 4, "checkpoint backup upload or restore files in parallel");
+
+static const std::string kBackupPrefix = "backup_";
+static const std::string kTmpBackupPrefix = "tmp_backup_";
+static const std::string kSharedDir = "sst";
+
+static bool CopyFile(const std::string& src_path, const std::string& dst_path) {
+  std::error_code ec;
+  std::filesystem::copy_file(src_path, dst_path, std::filesystem::copy_options::overwrite_existing, ec);
+  if (ec) {
+    DINGO_LOG(ERROR) << fmt::format("[backup] copy file {} to {} failed, error: {}", src_path, dst_path, ec.message());
+    return false;
+  }
+  return true;
+}
+
+static bool ReadFile(const std::string& filepath, std::string& content) {
+  std::ifstream file(filepath);
+  if (!file.is_open()) {
+    return false;
+  }
+  std::stringstream buffer;
+  buffer << file.rdbuf();
+  content = buffer.str();
+  return true;
+}
+
+// Copy files in parallel, the pair is source and destination path.
+static butil::Status ParallelCopyFiles(const std::vector<std::pair<std::string, std::string>>& files,
+                                       int32_t parallel_num) {
+  parallel_num = std::min(std::max(parallel_num, 1), static_cast<int32_t>(files.size()));
+
+  std::atomic<size_t> next_index{0};
+  std::atomic<bool> failed{false};
+  std::vector<std::thread> threads;
+  threads.reserve(parallel_num);
+  for (int32_t i = 0; i < parallel_num; ++i) {
+    threads.emplace_back([&]() {
+      for (size_t index = next_index.fetch_add(1); index < files.size() && !failed.load();
+           index = next_index.fetch_add(1)) {
+        if (!CopyFile(files[index].first, files[index].second)) {
+          failed.store(true);
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  return failed.load() ? butil::Status(pb::error::EINTERNAL, "copy files failed") : butil::Status::OK();
+}
+
+bool CheckpointBackup::IsEnabled() { return !FLAGS_checkpoint_backup_dir.empty(); }
+
+void CheckpointBackup::Run() {
+  if (!IsEnabled()) {
+    return;
+  }
+  // skip when the last round is still running
+  bool expected = false;
+  if (!is_running_.compare_exchange_strong(expected, true)) {
+    return;
+  }
+
+  auto raw_engine = Server::GetInstance().GetRawEngine(pb::common::RAW_ENG_ROCKSDB);
+  if (raw_engine != nullptr) {
+    std::string backup_name;
+    auto status = Backup(raw_engine, FLAGS_checkpoint_backup_dir, backup_name);
+    if (status.ok()) {
+      CleanExpiredBackups(FLAGS_checkpoint_backup_dir, FLAGS_checkpoint_backup_keep_num);
+    }
+  }
+
+  is_running_.store(false);
+}
+
+butil::Status CheckpointBackup::Backup(RawEnginePtr raw_engine, const std::string& backup_dir,
+                                       std::string& backup_name) {
+  int64_t start_time = Helper::TimestampMs();
+  // fixed width timestamp keeps the name order same as time order
+  backup_name = fmt::format("{}{:016}", kBackupPrefix, start_time);
+
+  std::string checkpoint_path = fmt::format("{}/{}", FLAGS_checkpoint_backup_tmp_dir, backup_name);
+  Helper::RemoveAllFileOrDirectory(checkpoint_path);
+  auto status = Helper::CreateDirectories(FLAGS_checkpoint_backup_tmp_dir);
+  if (!status.ok()) {
+    return status;
+  }
+
+  std::string shared_path = fmt::format("{}/{}", backup_dir, kSharedDir);
+  std::string tmp_backup_path = fmt::format("{}/{}{:016}", backup_dir, kTmpBackupPrefix, start_time);
+  status = Helper::CreateDirectories(shared_path);
+  if (status.ok()) {
+    status = Helper::CreateDirectories(tmp_backup_path);
+  }
+  if (!status.ok()) {
+    DINGO_LOG(ERROR) << fmt::format("[backup] create backup directory {} failed, error: {}", backup_dir,
+                                    status.error_str());
+    return status;
+  }
+
+  // checkpoint hard links the files of db, it's cheap.
+  status = raw_engine->NewCheckpoint()->Create(checkpoint_path);
+  if (!status.ok()) {
+    DINGO_LOG(ERROR) << fmt::format("[backup] create checkpoint {} failed, error: {}", checkpoint_path,
+                                    status.error_str());
+    Helper::RemoveAllFileOrDirectory(tmp_backup_path);
+    return status;
+  }
+
+  std::map<std::string, std::string> shared_files;
+  std::vector<std::pair<std::string, std::string>> upload_files;
+  for (const auto& filename : Helper::TraverseDirectory(checkpoint_path, true, false)) {
+    std::string filepath = fmt::format("{}/{}", checkpoint_path, filename);
+    if (!IsSharedFile(filename)) {
+      upload_files.emplace_back(filepath, fmt::format("{}/{}", tmp_backup_path, filename));
+      continue;
+    }
+
+    // the file number may be reused by a recreated db, the size tells them apart.
+    std::string shared_name = fmt::format("{}.{}", filename, Helper::GetFileSize(filepath));
+    shared_files[shared_name] = filename;
+    std::string shared_filepath = fmt::format("{}/{}", shared_path, shared_name);
+    if (!Helper::IsExistPath(shared_filepath)) {
+      // upload to tmp name, a partial file is never taken as uploaded.
+      upload_files.emplace_back(filepath, shared_filepath + ".tmp");
+    }
+  }
+
+  status = ParallelCopyFiles(upload_files, FLAGS_checkpoint_backup_upload_parallel_num);
+  for (const auto& [src_path, dst_path] : upload_files) {
+    if (status.ok() && std::filesystem::path(dst_path).extension() == ".tmp") {
+      status = Helper::Rename(dst_path, dst_path.substr(0, dst_path.size() - 4));
+    }
+  }
+  if (status.ok() && !Helper::SaveFile(fmt::format("{}/{}", tmp_backup_path, kFileListName),
+                                       EncodeFileList(shared_files))) {
+    status = butil::Status(pb::error::EINTERNAL, "save file list failed");
+  }
+  if (status.ok()) {
+    status = Helper::Rename(tmp_backup_path, fmt::format("{}/{}", backup_dir, backup_name));
+  }
+
+  Helper::RemoveAllFileOrDirectory(checkpoint_path);
+  if (!status.ok()) {
+    DINGO_LOG(ERROR) << fmt::format("[backup] backup {} failed, error: {}", backup_name, status.error_str());
+    Helper::RemoveAllFileOrDirectory(tmp_backup_path);
+    return status;
+  }
+
+  DINGO_LOG(INFO) << fmt::format("[backup] backup {} done, shared files: {}, uploaded files: {}, elapsed time: {}ms",
+                                 backup_name, shared_files.size(), upload_files.size(),
+                                 Helper::TimestampMs() - start_time);
+
+  return butil::Status::OK();
+}
+
+butil::Status CheckpointBackup::Restore(const std::string& backup_dir, const std::string& backup_name,
+                                        const std::string& db_path, int32_t parallel_num) {
+  std::string backup_path = fmt::format("{}/{}", backup_dir, backup_name);
+  std::string content;
+  if (!ReadFile(fmt::format("{}/{}", backup_path, kFileListName), content)) {
+    return butil::Status(pb::error::EINTERNAL, fmt::format("read file list of backup {} failed", backup_name));
+  }
+
+  if (Helper::IsExistPath(db_path) && !Helper::TraverseDirectory(db_path).empty()) {
+    return butil::Status(pb::error::EILLEGAL_PARAMTETERS, fmt::format("db path {} is not empty", db_path));
+  }
+  auto status = Helper::CreateDirectories(db_path);
+  if (!status.ok()) {
+    return status;
+  }
+
+  std::vector<std::pair<std::string, std::string>> files;
+  for (const auto& [shared_name, filename] : DecodeFileList(content)) {
+    files.emplace_back(fmt::format("{}/{}/{}", backup_dir, kSharedDir, shared_name),
+                       fmt::format("{}/{}", db_path, filename));
+  }
+  for (const auto& filename : Helper::TraverseDirectory(backup_path, true, false)) {
+    if (filename != kFileListName) {
+      files.emplace_back(fmt::format("{}/{}", backup_path, filename), fmt::format("{}/{}", db_path, filename));
+    }
+  }
+
+  status = ParallelCopyFiles(files, parallel_num);
+  if (!status.ok()) {
+    DINGO_LOG(ERROR) << fmt::format("[backup] restore {} to {} failed, error: {}", backup_name, db_path,
+                                    status.error_str());
+    return status;
+  }
+
+  DINGO_LOG(INFO) << fmt::format("[backup] restore {} to {} done, files: {}", backup_name, db_path, files.size());
+  return butil::Status::OK();
+}
+
+std::vector<std::string> CheckpointBackup::ListBackups(const std::string& backup_dir) {
+  auto backups = Helper::TraverseDirectory(backup_dir, kBackupPrefix, false, true);
+  std::sort(backups.begin(), backups.end());
+  return backups;
+}
+
+void CheckpointBackup::CleanExpiredBackups(const std::string& backup_dir, int32_t keep_num) {
+  keep_num = std::max(keep_num, 1);
+  auto backups = ListBackups(backup_dir);
+  if (backups.size() > static_cast<size_t>(keep_num)) {
+    for (size_t i = 0; i < backups.size() - keep_num; ++i) {
+      Helper::RemoveAllFileOrDirectory(fmt::format("{}/{}", backup_dir, backups[i]));
+    }
+    backups.erase(backups.begin(), backups.end() - keep_num);
+  }
+
+  std::set<std::string> referenced_files;
+  for (const auto& backup : backups) {
+    std::string content;
+    if (!ReadFile(fmt::format("{}/{}/{}", backup_dir, backup, kFileListName), content)) {
+      // keep all shared files when not sure
+      return;
+    }
+    for (const auto& [shared_name, filename] : DecodeFileList(content)) {
+      referenced_files.insert(shared_name);
+    }
+  }
+
+  // the tmp files of a running backup are not removed, only one backup runs at a time.
+  std::string shared_path = fmt::format("{}/{}", backup_dir, kSharedDir);
+  for (const auto& shared_name : Helper::TraverseDirectory(shared_path, true, false)) {
+    if (referenced_files.count(shared_name) == 0 && shared_name.find(".tmp") == std::string::npos) {
+      Helper::RemoveFileOrDirectory(fmt::format("{}/{}", shared_path, shared_name));
+    }
+  }
+}
+
+bool CheckpointBackup::IsSharedFile(const std::string& filename) {
+  auto extension = std::filesystem::path(filename).extension();
+  return extension == ".sst" || extension == ".blob";
+}
+
+std::string CheckpointBackup::EncodeFileList(const std::map<std::string, std::string>& files) {
+  std::string content;
+  for (const auto& [shared_name, filename] : files) {
+    content += fmt::format("{} {}\n", shared_name, filename);
+  }
+  return content;
+}
+
+std::map<std::string, std::string> CheckpointBackup::DecodeFileList(const std::string& content) {
+  std::map<std::string, std::string> files;
+  std::istringstream stream(content);
+  std::string shared_name, filename;
+  while (stream >> shared_name >> filename) {
+    files[shared_name] = filename;
+  }
+  return files;
+}
+
+}  // namespace dingodb
@@ -0,0 +1,77 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef DINGODB_ENGINE_CHECKPOINT_BACKUP_H_
+#define DINGODB_ENGINE_CHECKPOINT_BACKUP_H_
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "butil/status.h"
+#include "engine/raw_engine.h"
+
+namespace dingodb {
+
+// Incremental backup of the raw engine by checkpoint, the backup directory may be a mounted external storage.
+// Layout of the backup directory:
+//   sst/<file>.<size>        sst and blob files shared by all backups, a file is immutable so it's uploaded once.
+//   backup_<timestamp>/      meta files of one checkpoint(CURRENT, MANIFEST, OPTIONS, wal) and the FILES list,
+//                            a backup is visible only after its directory is renamed from the tmp name.
+// Restore copies the files of a backup into an empty db directory in parallel.
+class CheckpointBackup {
+ public:
+  static CheckpointBackup& GetInstance() {
+    static CheckpointBackup instance;
+    return instance;
+  }
+
+  static bool IsEnabled();
+
+  // Backup the rocksdb raw engine into the backup directory, called by crontab.
+  void Run();
+
+  butil::Status Backup(RawEnginePtr raw_engine, const std::string& backup_dir, std::string& backup_name);
+
+  static butil::Status Restore(const std::string& backup_dir, const std::string& backup_name,
+                               const std::string& db_path, int32_t parallel_num);
+
+  // Ascending backup names, the latest is the last.
+  static std::vector<std::string> ListBackups(const std::string& backup_dir);
+
+  // Remove the backups except the latest keep_num, and the shared files not referenced by any backup.
+  static void CleanExpiredBackups(const std::string& backup_dir, int32_t keep_num);
+
+  // The shared files are sst and blob files, the other files of checkpoint belong to one backup.
+  static bool IsSharedFile(const std::string& filename);
+
+  // Format: one "<shared name> <file name>" per line.
+  static std::string EncodeFileList(const std::map<std::string, std::string>& files);
+  static std::map<std::string, std::string> DecodeFileList(const std::string& content);
+
+  static constexpr const char* kFileListName = "FILES";
+
+ private:
+  CheckpointBackup() = default;
+  ~CheckpointBackup() = default;
+
+  std::atomic<bool> is_running_{false};
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_ENGINE_CHECKPOINT_BACKUP_H_
@@ -67,6 +67,12 @@ class Engine : public std::enable_shared_from_this<Engine> {
     virtual ~Reader() = default;
 
     virtual butil::Status KvGet(std::shared_ptr<Context> ctx, const std::string& key, std::string& value) = 0;
+    // Get without copy, see RawEngine::Reader::KvGetPinned.
+    virtual butil::Status KvGetPinned(std::shared_ptr<Context> ctx, const std::string& key,
+                                      const ValueVisitor& visitor) = 0;
+    // Get many keys by one raw engine multi get, values[i] and exists[i] are of keys[i].
+    virtual butil::Status KvMultiGet(std::shared_ptr<Context> ctx, const std::vector<std::string>& keys,
+                                     std::vector<std::string>& values, std::vector<bool>& exists) = 0;
 
     virtual butil::Status KvScan(std::shared_ptr<Context> ctx, const std::string& start_key, const std::string& end_key,
                                  std::vector<pb::common::KeyValue>& kvs) = 0;
@@ -81,7 +87,7 @@ class Engine : public std::enable_shared_from_this<Engine> {
     Writer() = default;
     virtual ~Writer() = default;
 
-    virtual butil::Status KvPut(std::shared_ptr<Context> ctx, const std::vector<pb::common::KeyValue>& kvs) = 0;
+    virtual butil::Status KvPut(std::shared_ptr<Context> ctx, std::vector<pb::common::KeyValue>&& kvs) = 0;
     virtual butil::Status KvDelete(std::shared_ptr<Context> ctx, const std::vector<std::string>& keys) = 0;
     virtual butil::Status KvDeleteRange(std::shared_ptr<Context> ctx, const pb::common::Range& range) = 0;
     virtual butil::Status KvPutIfAbsent(std::shared_ptr<Context> ctx, const std::vector<pb::common::KeyValue>& kvs,
@@ -124,6 +130,14 @@ class Engine : public std::enable_shared_from_this<Engine> {
 
       VectorIndexWrapperPtr vector_index;
       pb::common::ScalarSchema scalar_schema;
+
+      // token bits of multi vector index, 0 is single vector index
+      int32_t multi_vector_token_bits{};
+
+      // full-text pre filter, the documents matching document_parameter in the document index of the region,
+      // used when document_index is set and query_string is not empty.
+      DocumentIndexWrapperPtr document_index;
+      pb::common::DocumentSearchParameter document_parameter;
     };
 
     virtual butil::Status VectorBatchSearch(std::shared_ptr<VectorReader::Context> ctx,
@@ -0,0 +1,150 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "engine/flushed_applied_index_tracker.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "bthread/mutex.h"
+#include "common/logging.h"
+#include "fmt/core.h"
+#include "gflags/gflags.h"
+
+namespace dingodb {
+
+DECLARE_bool(rocksdb_disable_data_wal);
+
+DEFINE_int32(flushed_applied_index_max_pending, 1024, "max pending applied index record num per region");
+
+FlushedAppliedIndexTracker::FlushedAppliedIndexTracker() { bthread_mutex_init(&mutex_, nullptr); }
+
+FlushedAppliedIndexTracker::~FlushedAppliedIndexTracker() { bthread_mutex_destroy(&mutex_); }
+
+FlushedAppliedIndexTracker& FlushedAppliedIndexTracker::GetInstance() {
+  static FlushedAppliedIndexTracker instance;
+  return instance;
+}
+
+bool FlushedAppliedIndexTracker::IsEnabled() { return FLAGS_rocksdb_disable_data_wal; }
+
+void FlushedAppliedIndexTracker::SetSequenceFunc(SequenceFunc func) {
+  BAIDU_SCOPED_LOCK(mutex_);
+  sequence_func_ = func;
+}
+
+void FlushedAppliedIndexTracker::SetPersistFunc(PersistFunc func) {
+  BAIDU_SCOPED_LOCK(mutex_);
+  persist_func_ = func;
+}
+
+void FlushedAppliedIndexTracker::Record(int64_t region_id, int64_t term, int64_t applied_index) {
+  PersistFunc persist_func;
+  {
+    BAIDU_SCOPED_LOCK(mutex_);
+    if (sequence_func_ == nullptr) {
+      return;
+    }
+    uint64_t seqno = sequence_func_();
+
+    auto& state = regions_[region_id];
+    if (seqno <= flushed_seqno_) {
+      // no write since the last flush, supersede all the pendings.
+      state.pendings.clear();
+      state.flushed_index = std::max(state.flushed_index, applied_index);
+      persist_func = persist_func_;
+    } else if (!state.pendings.empty() && state.pendings.back().seqno == seqno) {
+      state.pendings.back().term = term;
+      state.pendings.back().applied_index = applied_index;
+    } else {
+      state.pendings.push_back(Pending{seqno, term, applied_index});
+      // drop the oldest, it only makes the persisted applied index lag.
+      if (state.pendings.size() > static_cast<size_t>(std::max(FLAGS_flushed_applied_index_max_pending, 1))) {
+        state.pendings.pop_front();
+      }
+    }
+  }
+
+  if (persist_func != nullptr) {
+    persist_func(region_id, term, applied_index);
+  }
+}
+
+void FlushedAppliedIndexTracker::Erase(int64_t region_id) {
+  BAIDU_SCOPED_LOCK(mutex_);
+  regions_.erase(region_id);
+}
+
+bool FlushedAppliedIndexTracker::IsFlushed(int64_t region_id, int64_t applied_index) {
+  BAIDU_SCOPED_LOCK(mutex_);
+  auto it = regions_.find(region_id);
+  return it != regions_.end() && it->second.flushed_index >= applied_index;
+}
+
+bool FlushedAppliedIndexTracker::OnFlushCompleted(uint64_t largest_seqno) {
+  BAIDU_SCOPED_LOCK(mutex_);
+  if (largest_seqno <= flushed_seqno_) {
+    return false;
+  }
+  flushed_seqno_ = largest_seqno;
+
+  return true;
+}
+
+void FlushedAppliedIndexTracker::PersistFlushed() {
+  PersistFunc persist_func;
+  std::vector<std::tuple<int64_t, int64_t, int64_t>> flusheds;
+  {
+    BAIDU_SCOPED_LOCK(mutex_);
+    for (auto& [region_id, state] : regions_) {
+      bool has_flushed = false;
+      Pending last{0, 0, 0};
+      while (!state.pendings.empty() && state.pendings.front().seqno <= flushed_seqno_) {
+        last = state.pendings.front();
+        has_flushed = true;
+        state.pendings.pop_front();
+      }
+
+      if (has_flushed && last.applied_index > state.flushed_index) {
+        state.flushed_index = last.applied_index;
+        flusheds.emplace_back(region_id, last.term, last.applied_index);
+      }
+    }
+    persist_func = persist_func_;
+  }
+
+  if (persist_func == nullptr) {
+    return;
+  }
+
+  for (const auto& [region_id, term, applied_index] : flusheds) {
+    DINGO_LOG(DEBUG) << fmt::format("[flushed_applied_index][region({})] persist applied index {}:{}", region_id,
+                                    term, applied_index);
+    persist_func(region_id, term, applied_index);
+  }
+}
+
+int64_t FlushedAppliedIndexTracker::PendingCount() {
+  BAIDU_SCOPED_LOCK(mutex_);
+  int64_t count = 0;
+  for (const auto& [_, state] : regions_) {
+    count += state.pendings.size();
+  }
+  return count;
+}
+
+}  // namespace dingodb
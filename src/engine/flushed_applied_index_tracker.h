@@ -0,0 +1,93 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_ENGINE_FLUSHED_APPLIED_INDEX_TRACKER_H_
+#define DINGODB_ENGINE_FLUSHED_APPLIED_INDEX_TRACKER_H_
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+
+#include "bthread/types.h"
+
+namespace dingodb {
+
+// When the wal of raft replicated data column families is disabled, the data still in memtable is lost on crash
+// and is recovered by replaying raft log from the persisted applied index of region.
+// So the persisted applied index must never go beyond the data which already flushed to sst.
+// The tracker records the rocksdb latest sequence number together with the applied index of region, and only
+// persists the applied index after a flush covers that sequence number.
+// All column families are flushed atomically in this mode, so every write at or before the largest sequence
+// number of a completed flush is in sst.
+class FlushedAppliedIndexTracker {
+ public:
+  using SequenceFunc = std::function<uint64_t()>;
+  using PersistFunc = std::function<void(int64_t region_id, int64_t term, int64_t applied_index)>;
+
+  FlushedAppliedIndexTracker();
+  ~FlushedAppliedIndexTracker();
+
+  FlushedAppliedIndexTracker(const FlushedAppliedIndexTracker& rhs) = delete;
+  FlushedAppliedIndexTracker& operator=(const FlushedAppliedIndexTracker& rhs) = delete;
+  FlushedAppliedIndexTracker(FlushedAppliedIndexTracker&& rhs) = delete;
+  FlushedAppliedIndexTracker& operator=(FlushedAppliedIndexTracker&& rhs) = delete;
+
+  static FlushedAppliedIndexTracker& GetInstance();
+
+  // Whether the wal of raft replicated data is disabled.
+  static bool IsEnabled();
+
+  // Latest sequence number of raw engine.
+  void SetSequenceFunc(SequenceFunc func);
+  // Persist raft meta of region.
+  void SetPersistFunc(PersistFunc func);
+
+  // The data of applied_index has been written, persist it once flushed.
+  void Record(int64_t region_id, int64_t term, int64_t applied_index);
+  // Region is deleted, drop its pending records.
+  void Erase(int64_t region_id);
+  // Whether the data at or before applied_index of region is in sst.
+  bool IsFlushed(int64_t region_id, int64_t applied_index);
+
+  // Called by the rocksdb flush listener, return true if the flushed sequence number advanced.
+  bool OnFlushCompleted(uint64_t largest_seqno);
+  // Persist the applied index of regions which data is flushed.
+  // It writes db, must not run in the flush listener, that may deadlock with write stall.
+  void PersistFlushed();
+
+  int64_t PendingCount();
+
+ private:
+  struct Pending {
+    uint64_t seqno;
+    int64_t term;
+    int64_t applied_index;
+  };
+
+  struct RegionState {
+    std::deque<Pending> pendings;
+    int64_t flushed_index{0};
+  };
+
+  bthread_mutex_t mutex_;
+  SequenceFunc sequence_func_;
+  PersistFunc persist_func_;
+  uint64_t flushed_seqno_{0};
+  std::map<int64_t, RegionState> regions_;
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_ENGINE_FLUSHED_APPLIED_INDEX_TRACKER_H_
@@ -36,6 +36,10 @@ enum class IteratorType {
 struct IteratorOptions {
   std::string lower_bound;
   std::string upper_bound;
+  // long sequential scan, e.g. full region analytical scan, engine prefetch with readahead and async io.
+  bool long_scan{false};
+  // only keys are needed, e.g. count or exists, the engine may skip loading values(blob) until Value() is called.
+  bool key_only{false};
 };
 
 class Iterator {
@@ -17,6 +17,7 @@
 #include "document/document_reader.h"
 #include "engine/engine.h"
 #include "engine/raft_store_engine.h"
+#include "engine/raw_kv_ttl.h"
 #include "engine/txn_engine_helper.h"
 #include "engine/write_data.h"
 #include "event/store_state_machine_event.h"
@@ -186,17 +187,27 @@ butil::Status MonoStoreEngine::AsyncWrite(std::shared_ptr<Context> ctx, std::sha
 }
 
 butil::Status MonoStoreEngine::Reader::KvGet(std::shared_ptr<Context> ctx, const std::string& key, std::string& value) {
-  return reader_->KvGet(ctx->CfName(), key, value);
+  return RawKvTtl::GetInstance().KvGet(reader_, ctx->CfName(), key, value);
+}
+
+butil::Status MonoStoreEngine::Reader::KvGetPinned(std::shared_ptr<Context> ctx, const std::string& key,
+                                                   const ValueVisitor& visitor) {
+  return RawKvTtl::GetInstance().KvGetPinned(reader_, ctx->CfName(), key, visitor);
+}
+
+butil::Status MonoStoreEngine::Reader::KvMultiGet(std::shared_ptr<Context> ctx, const std::vector<std::string>& keys,
+                                                  std::vector<std::string>& values, std::vector<bool>& exists) {
+  return RawKvTtl::GetInstance().KvMultiGet(reader_, ctx->CfName(), keys, values, exists);
 }
 
 butil::Status MonoStoreEngine::Reader::KvScan(std::shared_ptr<Context> ctx, const std::string& start_key,
                                               const std::string& end_key, std::vector<pb::common::KeyValue>& kvs) {
-  return reader_->KvScan(ctx->CfName(), start_key, end_key, kvs);
+  return RawKvTtl::GetInstance().KvScan(reader_, ctx->CfName(), start_key, end_key, kvs);
 }
 
 butil::Status MonoStoreEngine::Reader::KvCount(std::shared_ptr<Context> ctx, const std::string& start_key,
                                                const std::string& end_key, int64_t& count) {
-  return reader_->KvCount(ctx->CfName(), start_key, end_key, count);
+  return RawKvTtl::GetInstance().KvCount(reader_, ctx->CfName(), start_key, end_key, count);
 }
 
 std::shared_ptr<Engine::Reader> MonoStoreEngine::NewReader(pb::common::RawEngine type) {
@@ -293,9 +304,9 @@ std::shared_ptr<Engine::Writer> MonoStoreEngine::NewWriter(pb::common::RawEngine
   return std::make_shared<MonoStoreEngine::Writer>(GetRawEngine(type), GetSelfPtr());
 }
 
-butil::Status MonoStoreEngine::Writer::KvPut(std::shared_ptr<Context> ctx,
-                                             const std::vector<pb::common::KeyValue>& kvs) {
-  return rocks_engine_->Write(ctx, WriteDataBuilder::BuildWrite(ctx->CfName(), kvs));
+butil::Status MonoStoreEngine::Writer::KvPut(std::shared_ptr<Context> ctx, std::vector<pb::common::KeyValue>&& kvs) {
+  RawKvTtl::GetInstance().EncodeValues(ctx->CfName(), kvs);
+  return rocks_engine_->Write(ctx, WriteDataBuilder::BuildWrite(ctx->CfName(), std::move(kvs)));
 }
 
 butil::Status MonoStoreEngine::Writer::KvDelete(std::shared_ptr<Context> ctx, const std::vector<std::string>& keys) {
@@ -312,6 +323,10 @@ butil::Status MonoStoreEngine::Writer::KvPutIfAbsent(std::shared_ptr<Context> ct
   if (BAIDU_UNLIKELY(kvs.empty())) {
     return butil::Status(pb::error::EKEY_EMPTY, "Key is empty");
   }
+  // the stored value of key with ttl has expire time, can't compare with the user value.
+  if (RawKvTtl::GetInstance().HasTtl(ctx->CfName(), kvs)) {
+    return butil::Status(pb::error::ENOT_SUPPORT, "Not support key with ttl");
+  }
 
   key_states.resize(kvs.size(), false);
 
@@ -366,6 +381,10 @@ butil::Status MonoStoreEngine::Writer::KvCompareAndSet(std::shared_ptr<Context>
   if (BAIDU_UNLIKELY(kvs.empty())) {
     return butil::Status(pb::error::EKEY_EMPTY, "Key is empty");
   }
+  // the stored value of key with ttl has expire time, can't compare with the user value.
+  if (RawKvTtl::GetInstance().HasTtl(ctx->CfName(), kvs)) {
+    return butil::Status(pb::error::ENOT_SUPPORT, "Not support key with ttl");
+  }
   if (BAIDU_UNLIKELY(kvs.size() != expect_values.size())) {
     return butil::Status(pb::error::EKEY_EMPTY, "Key is mismatch");
   }
@@ -55,6 +55,10 @@ class MonoStoreEngine : public Engine {
    public:
     Reader(RawEngine::ReaderPtr reader) : reader_(reader) {}
     butil::Status KvGet(std::shared_ptr<Context> ctx, const std::string& key, std::string& value) override;
+    butil::Status KvGetPinned(std::shared_ptr<Context> ctx, const std::string& key,
+                              const ValueVisitor& visitor) override;
+    butil::Status KvMultiGet(std::shared_ptr<Context> ctx, const std::vector<std::string>& keys,
+                             std::vector<std::string>& values, std::vector<bool>& exists) override;
 
     butil::Status KvScan(std::shared_ptr<Context> ctx, const std::string& start_key, const std::string& end_key,
                          std::vector<pb::common::KeyValue>& kvs) override;
@@ -70,7 +74,7 @@ class MonoStoreEngine : public Engine {
    public:
     Writer(std::shared_ptr<RawEngine> raw_engine, std::shared_ptr<MonoStoreEngine> rocks_engine)
         : writer_raw_engine_(raw_engine), rocks_engine_(rocks_engine) {}
-    butil::Status KvPut(std::shared_ptr<Context> ctx, const std::vector<pb::common::KeyValue>& kvs) override;
+    butil::Status KvPut(std::shared_ptr<Context> ctx, std::vector<pb::common::KeyValue>&& kvs) override;
     butil::Status KvDelete(std::shared_ptr<Context> ctx, const std::vector<std::string>& keys) override;
     butil::Status KvDeleteRange(std::shared_ptr<Context> ctx, const pb::common::Range& range) override;
     butil::Status KvPutIfAbsent(std::shared_ptr<Context> ctx, const std::vector<pb::common::KeyValue>& kvs,
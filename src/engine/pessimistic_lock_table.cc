@@ -0,0 +1,107 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "engine/pessimistic_lock_table.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "bthread/mutex.h"
+#include "bvar/passive_status.h"
+#include "gflags/gflags.h"
+
+namespace dingodb {
+
+DEFINE_bool(enable_in_memory_pessimistic_lock, false,
+            "keep pessimistic lock in leader memory, persist it on prewrite or transfer leader");
+DEFINE_int64(in_memory_pessimistic_lock_max_count, 1024 * 1024,
+             "max in memory pessimistic lock count, beyond it write lock through raft");
+
+static int64_t GetPessimisticLockCount(void*) { return PessimisticLockTable::GetInstance().Count(); }
+
+static bvar::PassiveStatus<int64_t> g_in_memory_pessimistic_lock_count("dingo_in_memory_pessimistic_lock_count",
+                                                                       GetPessimisticLockCount, nullptr);
+
+PessimisticLockTable::PessimisticLockTable(int64_t max_count) : max_count_(max_count) {
+  bthread_mutex_init(&mutex_, nullptr);
+}
+
+PessimisticLockTable::~PessimisticLockTable() { bthread_mutex_destroy(&mutex_); }
+
+PessimisticLockTable& PessimisticLockTable::GetInstance() {
+  static PessimisticLockTable instance(FLAGS_in_memory_pessimistic_lock_max_count);
+  return instance;
+}
+
+bool PessimisticLockTable::IsEnabled() { return FLAGS_enable_in_memory_pessimistic_lock; }
+
+bool PessimisticLockTable::Put(const std::vector<pb::store::LockInfo>& lock_infos) {
+  BAIDU_SCOPED_LOCK(mutex_);
+
+  if (static_cast<int64_t>(locks_.size() + lock_infos.size()) > max_count_) {
+    return false;
+  }
+
+  for (const auto& lock_info : lock_infos) {
+    locks_.insert_or_assign(lock_info.key(), lock_info);
+  }
+
+  return true;
+}
+
+bool PessimisticLockTable::Get(const std::string& key, pb::store::LockInfo& lock_info) {
+  BAIDU_SCOPED_LOCK(mutex_);
+
+  auto it = locks_.find(key);
+  if (it == locks_.end()) {
+    return false;
+  }
+
+  lock_info = it->second;
+  return true;
+}
+
+void PessimisticLockTable::Erase(const std::string& key) {
+  BAIDU_SCOPED_LOCK(mutex_);
+  locks_.erase(key);
+}
+
+std::vector<pb::store::LockInfo> PessimisticLockTable::GetRange(const std::string& start_key,
+                                                                const std::string& end_key) {
+  BAIDU_SCOPED_LOCK(mutex_);
+
+  std::vector<pb::store::LockInfo> lock_infos;
+  for (auto it = locks_.lower_bound(start_key); it != locks_.end() && it->first < end_key; ++it) {
+    lock_infos.push_back(it->second);
+  }
+
+  return lock_infos;
+}
+
+void PessimisticLockTable::EraseRange(const std::string& start_key, const std::string& end_key) {
+  BAIDU_SCOPED_LOCK(mutex_);
+
+  auto it = locks_.lower_bound(start_key);
+  while (it != locks_.end() && it->first < end_key) {
+    it = locks_.erase(it);
+  }
+}
+
+int64_t PessimisticLockTable::Count() {
+  BAIDU_SCOPED_LOCK(mutex_);
+  return locks_.size();
+}
+
+}  // namespace dingodb
@@ -0,0 +1,73 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_ENGINE_PESSIMISTIC_LOCK_TABLE_H_
+#define DINGODB_ENGINE_PESSIMISTIC_LOCK_TABLE_H_
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "bthread/types.h"
+#include "proto/store.pb.h"
+
+namespace dingodb {
+
+// In memory pessimistic lock of the leader, the lock is not written through raft when acquire.
+// It is replaced by the prewrite lock, or persisted through raft before transfer leader.
+// Any write of lock cf applied erase the key from it, so the lock cf always wins once written.
+// The locks in the range of region are dropped on leader change or restart. A pessimistic prewrite which finds its
+// lock lost checks the write cf, and fails with write conflict when the key was committed since its for_update_ts,
+// so a write slipped in while the lock was lost is never overwritten.
+// Transfer leader persists the locks of region under the latches, a key locked in lock cf meanwhile is skipped.
+// ScanLockInfo adds the memory locks of the leader, so resolve lock and gc see them like the persisted ones.
+// The key is user key, it is unique in store, so the table is ordered by key and is partitioned by region range.
+class PessimisticLockTable {
+ public:
+  PessimisticLockTable(int64_t max_count);
+  ~PessimisticLockTable();
+
+  PessimisticLockTable(const PessimisticLockTable& rhs) = delete;
+  PessimisticLockTable& operator=(const PessimisticLockTable& rhs) = delete;
+  PessimisticLockTable(PessimisticLockTable&& rhs) = delete;
+  PessimisticLockTable& operator=(PessimisticLockTable&& rhs) = delete;
+
+  // Create by gflags.
+  static PessimisticLockTable& GetInstance();
+
+  static bool IsEnabled();
+
+  // Put all or nothing, return false if beyond the max count.
+  bool Put(const std::vector<pb::store::LockInfo>& lock_infos);
+  // Return false if not exist.
+  bool Get(const std::string& key, pb::store::LockInfo& lock_info);
+  void Erase(const std::string& key);
+
+  // Range is [start_key, end_key) of user key.
+  std::vector<pb::store::LockInfo> GetRange(const std::string& start_key, const std::string& end_key);
+  void EraseRange(const std::string& start_key, const std::string& end_key);
+
+  int64_t Count();
+
+ private:
+  int64_t max_count_;
+
+  bthread_mutex_t mutex_;
+  std::map<std::string, pb::store::LockInfo> locks_;
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_ENGINE_PESSIMISTIC_LOCK_TABLE_H_
@@ -16,7 +16,10 @@
 
 #include <netinet/in.h>
 
+#include <algorithm>
+#include <atomic>
 #include <cstdint>
+#include <functional>
 #include <memory>
 #include <string>
 #include <utility>
@@ -26,6 +29,7 @@
 #include "butil/endpoint.h"
 #include "butil/status.h"
 #include "bvar/latency_recorder.h"
+#include "bvar/status.h"
 #include "common/helper.h"
 #include "common/logging.h"
 #include "common/role.h"
@@ -33,6 +37,7 @@
 #include "document/document_reader.h"
 #include "engine/engine.h"
 #include "engine/raw_engine.h"
+#include "engine/raw_kv_ttl.h"
 #include "engine/txn_engine_helper.h"
 #include "engine/write_data.h"
 #include "event/store_state_machine_event.h"
@@ -46,12 +51,21 @@
 #include "raft/raft_node.h"
 #include "raft/store_state_machine.h"
 #include "server/server.h"
+#include "store/region_heat.h"
 #include "vector/vector_reader.h"
 
 DECLARE_int32(init_election_timeout_ms);
 
+DEFINE_int32(raft_node_recover_concurrency, 1, "concurrency of recover raft node at startup");
+
 namespace dingodb {
 
+static const std::string kRegionHeatFileName = "region_heat";
+
+// startup progress of raft node recover
+static bvar::Status<int64_t> g_recover_raft_node_total("dingo_store_recover_raft_node_total", 0);
+static bvar::Status<int64_t> g_recover_raft_node_num("dingo_store_recover_raft_node_num", 0);
+
 RaftStoreEngine::RaftStoreEngine(std::shared_ptr<RawEngine> rocks_engine, std::shared_ptr<RawEngine> bdb_engine)
     : raw_rocks_engine(rocks_engine),
       raw_bdb_engine(bdb_engine),
@@ -106,10 +120,13 @@ bool RaftStoreEngine::Recover() {
 
   // shuffle regions for balance leader on restart
   Helper::ShuffleVector(regions);
+  // the hot regions of last run first, they serve and load index earlier
+  if (RegionHeat::IsEnabled()) {
+    RegionHeat::GetInstance().Load(fmt::format("{}/{}", config->GetString("store.path"), kRegionHeatFileName));
+    RegionHeat::GetInstance().SortByHeat(regions);
+  }
 
-  int count = 0;
-  auto ctx = std::make_shared<Context>();
-  auto listener_factory = std::make_shared<StoreSmEventListenerFactory>();
+  std::vector<store::RegionPtr> recover_regions;
   for (auto& region : regions) {
     if ((region->State() == pb::common::StoreRegionState::NORMAL ||
          region->State() == pb::common::StoreRegionState::STANDBY ||
@@ -117,63 +134,118 @@ bool RaftStoreEngine::Recover() {
          region->State() == pb::common::StoreRegionState::MERGING ||
          region->State() == pb::common::StoreRegionState::TOMBSTONE) &&
         region->GetStoreEngineType() == pb::common::StorageEngine::STORE_ENG_RAFT_STORE) {
-      auto raft_meta = store_raft_meta->GetRaftMeta(region->Id());
-      if (raft_meta == nullptr) {
-        DINGO_LOG(ERROR) << fmt::format("[raft.engine][region({})] recover raft meta not found.", region->Id());
-        continue;
-      }
-      auto region_metrics = store_region_metrics->GetMetrics(region->Id());
-      if (region_metrics == nullptr) {
-        DINGO_LOG(WARNING) << fmt::format("[raft.engine][region({})] recover raft metrics not found.", region->Id());
-      }
-
-      RaftControlAble::AddNodeParameter parameter;
-      parameter.role = GetRole();
-      parameter.is_restart = true;
-      parameter.raft_endpoint = Server::GetInstance().RaftEndpoint();
+      recover_regions.push_back(region);
+    }
+  }
+  g_recover_raft_node_total.set_value(recover_regions.size());
 
-      parameter.raft_path = config->GetString("raft.path");
-      // random election timeout for balance leader on restart
-      parameter.election_timeout_ms = FLAGS_init_election_timeout_ms +
-                                      Helper::GenerateRealRandomInteger(Constant::kRandomElectionTimeoutMinDeltaMs,
-                                                                        Constant::kRandomElectionTimeoutMaxDeltaMs);
-      parameter.log_max_segment_size = config->GetInt64("raft.segmentlog_max_segment_size");
-      parameter.log_path = config->GetString("raft.log_path");
+  auto listener_factory = std::make_shared<StoreSmEventListenerFactory>();
+  auto recover_region = [&](store::RegionPtr region) -> bool {
+    auto raft_meta = store_raft_meta->GetRaftMeta(region->Id());
+    if (raft_meta == nullptr) {
+      DINGO_LOG(ERROR) << fmt::format("[raft.engine][region({})] recover raft meta not found.", region->Id());
+      return false;
+    }
+    auto region_metrics = store_region_metrics->GetMetrics(region->Id());
+    if (region_metrics == nullptr) {
+      DINGO_LOG(WARNING) << fmt::format("[raft.engine][region({})] recover raft metrics not found.", region->Id());
+    }
 
+    RaftControlAble::AddNodeParameter parameter;
+    parameter.role = GetRole();
+    parameter.is_restart = true;
+    parameter.raft_endpoint = Server::GetInstance().RaftEndpoint();
+
+    parameter.raft_path = config->GetString("raft.path");
+    // random election timeout for balance leader on restart
+    parameter.election_timeout_ms = FLAGS_init_election_timeout_ms +
+                                    Helper::GenerateRealRandomInteger(Constant::kRandomElectionTimeoutMinDeltaMs,
+                                                                      Constant::kRandomElectionTimeoutMaxDeltaMs);
+    parameter.log_max_segment_size = config->GetInt64("raft.segmentlog_max_segment_size");
+    parameter.log_path = config->GetString("raft.log_path");
+
+    parameter.raft_meta = raft_meta;
+    parameter.region_metrics = region_metrics;
+    parameter.listeners = listener_factory->Build();
+
+    auto is_complete = IsCompleteRaftNode(region->Id(), parameter.raft_path, parameter.log_path);
+    if (!is_complete) {
+      DINGO_LOG(INFO) << fmt::format("[raft.engine][region({})] raft node is not complete.", region->Id());
+      if (!CleanRaftDirectory(region->Id(), parameter.raft_path, parameter.log_path)) {
+        DINGO_LOG(WARNING) << fmt::format("[raft.engine][region({})] clean region raft directory failed.",
+                                          region->Id());
+        return false;
+      }
+      raft_meta = store::RaftMeta::New(region->Id());
+      store_raft_meta->UpdateRaftMeta(raft_meta);
       parameter.raft_meta = raft_meta;
-      parameter.region_metrics = region_metrics;
-      parameter.listeners = listener_factory->Build();
-
-      auto is_complete = IsCompleteRaftNode(region->Id(), parameter.raft_path, parameter.log_path);
-      if (!is_complete) {
-        DINGO_LOG(INFO) << fmt::format("[raft.engine][region({})] raft node is not complete.", region->Id());
-        if (!CleanRaftDirectory(region->Id(), parameter.raft_path, parameter.log_path)) {
-          DINGO_LOG(WARNING) << fmt::format("[raft.engine][region({})] clean region raft directory failed.",
-                                            region->Id());
-          continue;
-        }
-        raft_meta = store::RaftMeta::New(region->Id());
-        store_raft_meta->UpdateRaftMeta(raft_meta);
-        parameter.raft_meta = raft_meta;
-        parameter.is_restart = false;
+      parameter.is_restart = false;
+    }
+
+    AddNode(region, parameter);
+    if (region->NeedBootstrapDoSnapshot()) {
+      DINGO_LOG(INFO) << fmt::format("[raft.engine][region({})] need do snapshot.", region->Id());
+      auto node = GetNode(region->Id());
+      if (node != nullptr) {
+        auto ctx = std::make_shared<Context>();
+        ctx->SetRegionId(region->Id());
+        node->Snapshot(ctx, true);
       }
+    }
 
-      AddNode(region, parameter);
-      if (region->NeedBootstrapDoSnapshot()) {
-        DINGO_LOG(INFO) << fmt::format("[raft.engine][region({})] need do snapshot.", region->Id());
-        auto node = GetNode(region->Id());
-        if (node != nullptr) {
-          auto ctx = std::make_shared<Context>();
-          ctx->SetRegionId(region->Id());
-          node->Snapshot(ctx, true);
+    return true;
+  };
+
+  int64_t start_time = Helper::TimestampMs();
+  std::atomic<int> count{0};
+  int concurrency = std::min(std::max(FLAGS_raft_node_recover_concurrency, 1), static_cast<int>(recover_regions.size()));
+  if (concurrency <= 1) {
+    for (auto& region : recover_regions) {
+      if (recover_region(region)) {
+        ++count;
+        g_recover_raft_node_num.set_value(count.load());
+      }
+    }
+  } else {
+    // take regions in order, so the hot regions still recover first
+    struct Parameter {
+      std::vector<store::RegionPtr>* regions;
+      std::function<bool(store::RegionPtr)>* recover_region;
+      std::atomic<size_t> offset{0};
+      std::atomic<int>* count;
+    };
+    std::function<bool(store::RegionPtr)> recover_func = recover_region;
+    Parameter param;
+    param.regions = &recover_regions;
+    param.recover_region = &recover_func;
+    param.count = &count;
+
+    auto task = [](void* arg) -> void* {
+      auto* param = static_cast<Parameter*>(arg);
+      for (;;) {
+        size_t offset = param->offset.fetch_add(1, std::memory_order_relaxed);
+        if (offset >= param->regions->size()) {
+          break;
+        }
+        if ((*param->recover_region)((*param->regions)[offset])) {
+          g_recover_raft_node_num.set_value(param->count->fetch_add(1) + 1);
         }
       }
+      return nullptr;
+    };
 
-      ++count;
+    if (!Helper::ParallelRunTask(task, &param, concurrency)) {
+      DINGO_LOG(ERROR) << "[raft.engine][region(*)] parallel recover raft node failed.";
+      return false;
     }
   }
 
-  DINGO_LOG(INFO) << fmt::format("[raft.engine][region(*)] recover Raft node num({}).", count);
+  if (RegionHeat::IsEnabled()) {
+    RegionHeat::GetInstance().Save();
+  }
+
+  DINGO_LOG(INFO) << fmt::format("[raft.engine][region(*)] recover Raft node num({}) concurrency({}) elapsed({}ms).",
+                                 count.load(), concurrency, Helper::TimestampMs() - start_time);
 
   return true;
 }
@@ -372,6 +444,14 @@ void RaftStoreEngine::DoSnapshotPeriodicity() {
   }
 }
 
+void RaftStoreEngine::QuiesceIdleNodes() {
+  auto nodes = raft_node_manager->GetAllNode();
+
+  for (auto& node : nodes) {
+    node->CheckQuiescent();
+  }
+}
+
 butil::Status RaftStoreEngine::TransferLeader(int64_t region_id, const pb::common::Peer& peer) {
   auto node = raft_node_manager->GetNode(region_id);
   if (node == nullptr) {
@@ -458,17 +538,27 @@ butil::Status RaftStoreEngine::AsyncWrite(std::shared_ptr<Context> ctx, std::sha
 }
 
 butil::Status RaftStoreEngine::Reader::KvGet(std::shared_ptr<Context> ctx, const std::string& key, std::string& value) {
-  return reader_->KvGet(ctx->CfName(), key, value);
+  return RawKvTtl::GetInstance().KvGet(reader_, ctx->CfName(), key, value);
+}
+
+butil::Status RaftStoreEngine::Reader::KvGetPinned(std::shared_ptr<Context> ctx, const std::string& key,
+                                                   const ValueVisitor& visitor) {
+  return RawKvTtl::GetInstance().KvGetPinned(reader_, ctx->CfName(), key, visitor);
+}
+
+butil::Status RaftStoreEngine::Reader::KvMultiGet(std::shared_ptr<Context> ctx, const std::vector<std::string>& keys,
+                                                  std::vector<std::string>& values, std::vector<bool>& exists) {
+  return RawKvTtl::GetInstance().KvMultiGet(reader_, ctx->CfName(), keys, values, exists);
 }
 
 butil::Status RaftStoreEngine::Reader::KvScan(std::shared_ptr<Context> ctx, const std::string& start_key,
                                               const std::string& end_key, std::vector<pb::common::KeyValue>& kvs) {
-  return reader_->KvScan(ctx->CfName(), start_key, end_key, kvs);
+  return RawKvTtl::GetInstance().KvScan(reader_, ctx->CfName(), start_key, end_key, kvs);
 }
 
 butil::Status RaftStoreEngine::Reader::KvCount(std::shared_ptr<Context> ctx, const std::string& start_key,
                                                const std::string& end_key, int64_t& count) {
-  return reader_->KvCount(ctx->CfName(), start_key, end_key, count);
+  return RawKvTtl::GetInstance().KvCount(reader_, ctx->CfName(), start_key, end_key, count);
 }
 
 std::shared_ptr<Engine::Reader> RaftStoreEngine::NewReader(pb::common::RawEngine type) {
@@ -667,9 +757,9 @@ std::shared_ptr<Engine::Writer> RaftStoreEngine::NewWriter(pb::common::RawEngine
   return std::make_shared<RaftStoreEngine::Writer>(GetRawEngine(type), GetSelfPtr());
 }
 
-butil::Status RaftStoreEngine::Writer::KvPut(std::shared_ptr<Context> ctx,
-                                             const std::vector<pb::common::KeyValue>& kvs) {
-  return raft_engine_->Write(ctx, WriteDataBuilder::BuildWrite(ctx->CfName(), kvs));
+butil::Status RaftStoreEngine::Writer::KvPut(std::shared_ptr<Context> ctx, std::vector<pb::common::KeyValue>&& kvs) {
+  RawKvTtl::GetInstance().EncodeValues(ctx->CfName(), kvs);
+  return raft_engine_->Write(ctx, WriteDataBuilder::BuildWrite(ctx->CfName(), std::move(kvs)));
 }
 
 butil::Status RaftStoreEngine::Writer::KvDelete(std::shared_ptr<Context> ctx, const std::vector<std::string>& keys) {
@@ -686,49 +776,26 @@ butil::Status RaftStoreEngine::Writer::KvPutIfAbsent(std::shared_ptr<Context> ct
   if (BAIDU_UNLIKELY(kvs.empty())) {
     return butil::Status(pb::error::EKEY_EMPTY, "Key is empty");
   }
-
-  key_states.resize(kvs.size(), false);
-
-  std::vector<bool> temp_key_states;
-  temp_key_states.resize(kvs.size(), false);
-
-  std::vector<pb::common::KeyValue> put_kvs;
-  for (int i = 0; i < kvs.size(); ++i) {
-    const auto& kv = kvs[i];
+  for (const auto& kv : kvs) {
     if (BAIDU_UNLIKELY(kv.key().empty())) {
       return butil::Status(pb::error::EKEY_EMPTY, "Key is empty");
     }
-
-    std::string old_value;
-    auto status = writer_raw_engine_->Reader()->KvGet(ctx->CfName(), kv.key(), old_value);
-    if (!status.ok() && status.error_code() != pb::error::Errno::EKEY_NOT_FOUND) {
-      return butil::Status(pb::error::EINTERNAL, "Internal get error");
-    }
-
-    if (is_atomic) {
-      if (status.ok()) {
-        return butil::Status();
-      }
-    } else {
-      if (status.ok()) {
-        continue;
-      }
-    }
-
-    put_kvs.push_back(kv);
-    temp_key_states[i] = true;
   }
-
-  if (put_kvs.empty()) {
-    return butil::Status::OK();
+  // the stored value of key with ttl has expire time, can't compare with the user value.
+  if (RawKvTtl::GetInstance().HasTtl(ctx->CfName(), kvs)) {
+    return butil::Status(pb::error::ENOT_SUPPORT, "Not support key with ttl");
   }
 
-  auto status = raft_engine_->Write(ctx, WriteDataBuilder::BuildWrite(ctx->CfName(), put_kvs));
+  key_states.resize(kvs.size(), false);
+
+  auto status = raft_engine_->Write(ctx, WriteDataBuilder::BuildWrite(ctx->CfName(), kvs, is_atomic));
   if (!status.ok()) {
     return status;
   }
 
-  key_states = temp_key_states;
+  if (ctx->KeyStates().size() == kvs.size()) {
+    key_states = ctx->KeyStates();
+  }
 
   return butil::Status();
 }
@@ -740,91 +807,29 @@ butil::Status RaftStoreEngine::Writer::KvCompareAndSet(std::shared_ptr<Context>
   if (BAIDU_UNLIKELY(kvs.empty())) {
     return butil::Status(pb::error::EKEY_EMPTY, "Key is empty");
   }
-  if (BAIDU_UNLIKELY(kvs.size() != expect_values.size())) {
-    return butil::Status(pb::error::EKEY_EMPTY, "Key is mismatch");
-  }
-
-  key_states.resize(kvs.size(), false);
-
-  std::vector<bool> temp_key_states;
-  temp_key_states.resize(kvs.size(), false);
-
-  std::vector<pb::common::KeyValue> put_kvs;
-  std::vector<std::string> delete_keys;
-  for (int i = 0; i < kvs.size(); ++i) {
-    const auto& kv = kvs[i];
+  for (const auto& kv : kvs) {
     if (BAIDU_UNLIKELY(kv.key().empty())) {
       return butil::Status(pb::error::EKEY_EMPTY, "Key is empty");
     }
-
-    std::string old_value;
-    auto status = writer_raw_engine_->Reader()->KvGet(ctx->CfName(), kv.key(), old_value);
-    if (!status.ok() && status.error_code() != pb::error::Errno::EKEY_NOT_FOUND) {
-      return butil::Status(pb::error::EINTERNAL, "Internal get error");
-    }
-
-    if (is_atomic) {
-      if (status.ok()) {
-        if (old_value != expect_values[i]) {
-          return butil::Status();
-        }
-      } else if (status.error_code() == pb::error::Errno::EKEY_NOT_FOUND) {
-        if (!expect_values[i].empty()) {
-          return butil::Status(pb::error::EKEY_NOT_FOUND, "Not found key");
-        }
-      }
-    } else {
-      if (status.ok()) {
-        if (old_value != expect_values[i]) {
-          continue;
-        }
-      } else if (status.error_code() == pb::error::Errno::EKEY_NOT_FOUND) {
-        if (!expect_values[i].empty()) {
-          continue;
-        }
-      }
-    }
-
-    // value empty means delete
-    if (kv.value().empty()) {
-      delete_keys.push_back(kv.key());
-    } else {
-      put_kvs.push_back(kv);
-    }
-
-    temp_key_states[i] = true;
   }
-
-  if (put_kvs.empty() && delete_keys.empty()) {
-    return butil::Status();
+  // the stored value of key with ttl has expire time, can't compare with the user value.
+  if (RawKvTtl::GetInstance().HasTtl(ctx->CfName(), kvs)) {
+    return butil::Status(pb::error::ENOT_SUPPORT, "Not support key with ttl");
   }
-
-  pb::raft::TxnRaftRequest txn_raft_request;
-  auto* cf_put_delete = txn_raft_request.mutable_multi_cf_put_and_delete();
-
-  // after all is processed, write into raft engine
-  if (!put_kvs.empty()) {
-    auto* default_puts = cf_put_delete->add_puts_with_cf();
-    default_puts->set_cf_name(ctx->CfName());
-    for (auto& kv : put_kvs) {
-      *default_puts->add_kvs() = kv;
-    }
+  if (BAIDU_UNLIKELY(kvs.size() != expect_values.size())) {
+    return butil::Status(pb::error::EKEY_EMPTY, "Key is mismatch");
   }
 
-  if (!delete_keys.empty()) {
-    auto* default_dels = cf_put_delete->add_deletes_with_cf();
-    default_dels->set_cf_name(ctx->CfName());
-    for (auto& key : delete_keys) {
-      default_dels->add_keys(key);
-    }
-  }
+  key_states.resize(kvs.size(), false);
 
-  auto status = raft_engine_->Write(ctx, WriteDataBuilder::BuildWrite(txn_raft_request));
+  auto status = raft_engine_->Write(ctx, WriteDataBuilder::BuildWrite(ctx->CfName(), kvs, expect_values, is_atomic));
   if (!status.ok()) {
     return status;
   }
 
-  key_states = temp_key_states;
+  if (ctx->KeyStates().size() == kvs.size()) {
+    key_states = ctx->KeyStates();
+  }
 
   return butil::Status();
 }
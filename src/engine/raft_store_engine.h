@@ -101,6 +101,7 @@ class RaftStoreEngine : public Engine, public RaftControlAble {
   butil::Status SaveSnapshot(std::shared_ptr<Context> ctx, int64_t region_id, bool force) override;
   butil::Status AyncSaveSnapshot(std::shared_ptr<Context> ctx, int64_t region_id, bool force) override;
   void DoSnapshotPeriodicity();
+  void QuiesceIdleNodes();
 
   butil::Status Write(std::shared_ptr<Context> ctx, std::shared_ptr<WriteData> write_data) override;
   butil::Status AsyncWrite(std::shared_ptr<Context> ctx, std::shared_ptr<WriteData> write_data) override;
@@ -112,6 +113,10 @@ class RaftStoreEngine : public Engine, public RaftControlAble {
    public:
     Reader(RawEngine::ReaderPtr reader) : reader_(reader) {}
     butil::Status KvGet(std::shared_ptr<Context> ctx, const std::string& key, std::string& value) override;
+    butil::Status KvGetPinned(std::shared_ptr<Context> ctx, const std::string& key,
+                              const ValueVisitor& visitor) override;
+    butil::Status KvMultiGet(std::shared_ptr<Context> ctx, const std::vector<std::string>& keys,
+                             std::vector<std::string>& values, std::vector<bool>& exists) override;
 
     butil::Status KvScan(std::shared_ptr<Context> ctx, const std::string& start_key, const std::string& end_key,
                          std::vector<pb::common::KeyValue>& kvs) override;
@@ -127,9 +132,11 @@ class RaftStoreEngine : public Engine, public RaftControlAble {
    public:
     Writer(std::shared_ptr<RawEngine> raw_engine, std::shared_ptr<RaftStoreEngine> raft_engine)
         : writer_raw_engine_(raw_engine), raft_engine_(raft_engine) {}
-    butil::Status KvPut(std::shared_ptr<Context> ctx, const std::vector<pb::common::KeyValue>& kvs) override;
+    butil::Status KvPut(std::shared_ptr<Context> ctx, std::vector<pb::common::KeyValue>&& kvs) override;
     butil::Status KvDelete(std::shared_ptr<Context> ctx, const std::vector<std::string>& keys) override;
     butil::Status KvDeleteRange(std::shared_ptr<Context> ctx, const pb::common::Range& range) override;
+    // The condition is checked by the apply handler, so the check and the write are atomic, the result of every key
+    // is returned by ctx key states.
     butil::Status KvPutIfAbsent(std::shared_ptr<Context> ctx, const std::vector<pb::common::KeyValue>& kvs,
                                 bool is_atomic, std::vector<bool>& key_states) override;
     butil::Status KvCompareAndSet(std::shared_ptr<Context> ctx, const std::vector<pb::common::KeyValue>& kvs,
@@ -18,8 +18,10 @@
 #include <sys/types.h>
 
 #include <cstdint>
+#include <functional>
 #include <memory>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include "butil/status.h"
@@ -32,6 +34,9 @@
 
 namespace dingodb {
 
+// Visit a value in place, the view is only valid during the call.
+using ValueVisitor = std::function<void(std::string_view value)>;
+
 class RawEngine : public std::enable_shared_from_this<RawEngine> {
  public:
   virtual ~RawEngine() = default;
@@ -45,6 +50,34 @@ class RawEngine : public std::enable_shared_from_this<RawEngine> {
     virtual butil::Status KvGet(const std::string& cf_name, std::shared_ptr<dingodb::Snapshot> snapshot,
                                 const std::string& key, std::string& value) = 0;
 
+    // Get without copy, visitor reads the value pinned in engine memory (block cache or memtable),
+    // engine not support pinning falls back to KvGet.
+    virtual butil::Status KvGetPinned(const std::string& cf_name, const std::string& key, const ValueVisitor& visitor) {
+      std::string value;
+      auto status = KvGet(cf_name, key, value);
+      if (status.ok()) {
+        visitor(value);
+      }
+      return status;
+    }
+    virtual butil::Status KvGetPinned(const std::string& cf_name, std::shared_ptr<dingodb::Snapshot> snapshot,
+                                      const std::string& key, const ValueVisitor& visitor) {
+      std::string value;
+      auto status = KvGet(cf_name, snapshot, key, value);
+      if (status.ok()) {
+        visitor(value);
+      }
+      return status;
+    }
+
+    // Get many keys in one call, values[i] and exists[i] are the result of keys[i],
+    // a not found key is not an error, values[i] is empty and exists[i] is false.
+    virtual butil::Status KvMultiGet(const std::string& cf_name, const std::vector<std::string>& keys,
+                                     std::vector<std::string>& values, std::vector<bool>& exists) = 0;
+    virtual butil::Status KvMultiGet(const std::string& cf_name, std::shared_ptr<dingodb::Snapshot> snapshot,
+                                     const std::vector<std::string>& keys, std::vector<std::string>& values,
+                                     std::vector<bool>& exists) = 0;
+
     virtual butil::Status KvScan(const std::string& cf_name, const std::string& start_key, const std::string& end_key,
                                  std::vector<pb::common::KeyValue>& kvs) = 0;
     virtual butil::Status KvScan(const std::string& cf_name, std::shared_ptr<dingodb::Snapshot> snapshot,
@@ -132,8 +165,16 @@ class RawEngine : public std::enable_shared_from_this<RawEngine> {
   virtual std::vector<int64_t> GetApproximateSizes(const std::string& cf_name,
                                                    std::vector<pb::common::Range>& ranges) = 0;
 
-  virtual void Flush(const std::string& cf_name) = 0;
+  virtual butil::Status Flush(const std::string& cf_name) = 0;
   virtual butil::Status Compact(const std::string& cf_name) = 0;
+  // Delete the files which are wholly in the range and compact the rest of the range, reclaim the disk space of the
+  // range at once. It ignores snapshots, so only use it on the data nobody reads, e.g. deleted region.
+  virtual butil::Status DeleteFilesInRange(const std::string& /*cf_name*/, const pb::common::Range& /*range*/) {
+    return butil::Status(pb::error::ENOT_SUPPORT, "Not support delete files in range.");
+  }
+
+  // Memory held by engine, e.g. memtable/block cache/table reader, 0 is unknown.
+  virtual int64_t GetMemoryUsage() { return 0; }
 
  protected:
   RawEngine() = default;
@@ -0,0 +1,356 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "engine/raw_kv_ttl.h"
+
+#include <cstdint>
+#include <ctime>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "bvar/reducer.h"
+#include "common/constant.h"
+#include "common/helper.h"
+#include "common/logging.h"
+#include "fmt/core.h"
+#include "gflags/gflags.h"
+#include "proto/error.pb.h"
+#include "serial/buf.h"
+
+namespace dingodb {
+
+DEFINE_string(raw_kv_ttl_partitions, "", "ttl seconds of raw kv partitions, e.g. 1001:3600,1002:60");
+
+static bvar::Adder<int64_t> g_raw_kv_ttl_compaction_drop_count("dingo_raw_kv_ttl_compaction_drop_count");
+
+// expire time is fixed 8 bytes big endian
+static const size_t kExpireTsSize = 8;
+// prefix | partition id
+static const size_t kKeyHeaderSize = 9;
+
+static int64_t NowSeconds() { return static_cast<int64_t>(std::time(nullptr)); }
+
+RawKvTtl::RawKvTtl() {
+  if (!Init(FLAGS_raw_kv_ttl_partitions)) {
+    DINGO_LOG(FATAL) << fmt::format("[raw_kv_ttl] invalid raw_kv_ttl_partitions: {}", FLAGS_raw_kv_ttl_partitions);
+  }
+}
+
+RawKvTtl& RawKvTtl::GetInstance() {
+  static RawKvTtl instance;
+  return instance;
+}
+
+bool RawKvTtl::Init(const std::string& config) {
+  std::map<int64_t, int64_t> partition_ttls;
+
+  std::vector<std::string> items;
+  Helper::SplitString(config, ',', items);
+  for (const auto& item : items) {
+    if (item.empty()) {
+      continue;
+    }
+    std::vector<std::string> pair;
+    Helper::SplitString(item, ':', pair);
+    if (pair.size() != 2) {
+      return false;
+    }
+
+    char* end = nullptr;
+    int64_t partition_id = std::strtoll(pair[0].c_str(), &end, 10);
+    if (pair[0].empty() || *end != '\0' || partition_id <= 0) {
+      return false;
+    }
+    int64_t ttl_s = std::strtoll(pair[1].c_str(), &end, 10);
+    if (pair[1].empty() || *end != '\0' || ttl_s <= 0) {
+      return false;
+    }
+    partition_ttls[partition_id] = ttl_s;
+  }
+
+  partition_ttls_.swap(partition_ttls);
+  return true;
+}
+
+int64_t RawKvTtl::GetTtl(const std::string& cf_name, std::string_view key) const {
+  if (partition_ttls_.empty() || cf_name != Constant::kStoreDataCF || key.size() < kKeyHeaderSize ||
+      (key[0] != Constant::kExecutorRaw && key[0] != Constant::kClientRaw)) {
+    return 0;
+  }
+
+  Buf buf(std::string(key.substr(1, kKeyHeaderSize - 1)));
+  auto it = partition_ttls_.find(buf.ReadLong());
+  return it != partition_ttls_.end() ? it->second : 0;
+}
+
+bool RawKvTtl::HasTtl(const std::string& cf_name, const std::vector<pb::common::KeyValue>& kvs) const {
+  if (partition_ttls_.empty()) {
+    return false;
+  }
+
+  for (const auto& kv : kvs) {
+    if (GetTtl(cf_name, kv.key()) > 0) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+void RawKvTtl::EncodeValues(const std::string& cf_name, std::vector<pb::common::KeyValue>& kvs) const {
+  if (partition_ttls_.empty()) {
+    return;
+  }
+
+  int64_t now_s = NowSeconds();
+  for (auto& kv : kvs) {
+    int64_t ttl_s = GetTtl(cf_name, kv.key());
+    if (ttl_s > 0) {
+      *kv.mutable_value() = EncodeValue(kv.value(), now_s + ttl_s);
+    }
+  }
+}
+
+std::string RawKvTtl::EncodeValue(std::string_view value, int64_t expire_ts_s) {
+  std::string result;
+  result.reserve(value.size() + kExpireTsSize);
+  result.append(value);
+  for (int i = kExpireTsSize - 1; i >= 0; --i) {
+    result.push_back(static_cast<char>((static_cast<uint64_t>(expire_ts_s) >> (i * 8)) & 0xFF));
+  }
+
+  return result;
+}
+
+bool RawKvTtl::DecodeValue(std::string_view value, std::string_view& user_value, int64_t& expire_ts_s) {
+  if (value.size() < kExpireTsSize) {
+    return false;
+  }
+
+  uint64_t expire_ts = 0;
+  for (size_t i = value.size() - kExpireTsSize; i < value.size(); ++i) {
+    expire_ts = (expire_ts << 8) | static_cast<uint8_t>(value[i]);
+  }
+  expire_ts_s = static_cast<int64_t>(expire_ts);
+  user_value = value.substr(0, value.size() - kExpireTsSize);
+
+  return true;
+}
+
+// Return false if the value is expired, otherwise strip the expire time.
+static bool StripValue(std::string_view value, int64_t now_s, std::string_view& user_value) {
+  int64_t expire_ts_s = 0;
+  if (!RawKvTtl::DecodeValue(value, user_value, expire_ts_s)) {
+    user_value = value;
+    return true;
+  }
+
+  return expire_ts_s > now_s;
+}
+
+butil::Status RawKvTtl::KvGet(RawEngine::ReaderPtr reader, const std::string& cf_name, const std::string& key,
+                              std::string& value) const {
+  auto status = reader->KvGet(cf_name, key, value);
+  if (!status.ok() || GetTtl(cf_name, key) == 0) {
+    return status;
+  }
+
+  std::string_view user_value;
+  if (!StripValue(value, NowSeconds(), user_value)) {
+    value.clear();
+    return butil::Status(pb::error::EKEY_NOT_FOUND, "Not found key");
+  }
+  value.resize(user_value.size());
+
+  return status;
+}
+
+butil::Status RawKvTtl::KvGetPinned(RawEngine::ReaderPtr reader, const std::string& cf_name, const std::string& key,
+                                    const ValueVisitor& visitor) const {
+  if (GetTtl(cf_name, key) == 0) {
+    return reader->KvGetPinned(cf_name, key, visitor);
+  }
+
+  bool is_expired = false;
+  auto status = reader->KvGetPinned(cf_name, key, [&](std::string_view value) {
+    std::string_view user_value;
+    is_expired = !StripValue(value, NowSeconds(), user_value);
+    if (!is_expired) {
+      visitor(user_value);
+    }
+  });
+  if (status.ok() && is_expired) {
+    return butil::Status(pb::error::EKEY_NOT_FOUND, "Not found key");
+  }
+
+  return status;
+}
+
+butil::Status RawKvTtl::KvMultiGet(RawEngine::ReaderPtr reader, const std::string& cf_name,
+                                   const std::vector<std::string>& keys, std::vector<std::string>& values,
+                                   std::vector<bool>& exists) const {
+  auto status = reader->KvMultiGet(cf_name, keys, values, exists);
+  if (!status.ok() || partition_ttls_.empty()) {
+    return status;
+  }
+
+  int64_t now_s = NowSeconds();
+  for (size_t i = 0; i < keys.size(); ++i) {
+    if (!exists[i] || GetTtl(cf_name, keys[i]) == 0) {
+      continue;
+    }
+
+    std::string_view user_value;
+    if (StripValue(values[i], now_s, user_value)) {
+      values[i].resize(user_value.size());
+    } else {
+      values[i].clear();
+      exists[i] = false;
+    }
+  }
+
+  return status;
+}
+
+butil::Status RawKvTtl::KvScan(RawEngine::ReaderPtr reader, const std::string& cf_name, const std::string& start_key,
+                               const std::string& end_key, std::vector<pb::common::KeyValue>& kvs) const {
+  auto status = reader->KvScan(cf_name, start_key, end_key, kvs);
+  if (!status.ok() || GetTtl(cf_name, start_key) == 0) {
+    return status;
+  }
+
+  int64_t now_s = NowSeconds();
+  std::vector<pb::common::KeyValue> live_kvs;
+  live_kvs.reserve(kvs.size());
+  for (auto& kv : kvs) {
+    std::string_view user_value;
+    if (StripValue(kv.value(), now_s, user_value)) {
+      kv.mutable_value()->resize(user_value.size());
+      live_kvs.push_back(std::move(kv));
+    }
+  }
+  kvs.swap(live_kvs);
+
+  return status;
+}
+
+butil::Status RawKvTtl::KvCount(RawEngine::ReaderPtr reader, const std::string& cf_name, const std::string& start_key,
+                                const std::string& end_key, int64_t& count) const {
+  if (GetTtl(cf_name, start_key) == 0) {
+    return reader->KvCount(cf_name, start_key, end_key, count);
+  }
+
+  IteratorOptions options;
+  options.upper_bound = end_key;
+  auto iter = reader->NewIterator(cf_name, options);
+  if (iter == nullptr) {
+    return butil::Status(pb::error::EINTERNAL, "Create iterator failed");
+  }
+
+  TtlIterator ttl_iter(iter, NowSeconds());
+  count = 0;
+  for (ttl_iter.Seek(start_key); ttl_iter.Valid(); ttl_iter.Next()) {
+    ++count;
+  }
+
+  return ttl_iter.Status();
+}
+
+IteratorPtr RawKvTtl::WrapIterator(const std::string& cf_name, const pb::common::Range& range,
+                                   IteratorPtr iter) const {
+  if (iter == nullptr || GetTtl(cf_name, range.start_key()) == 0) {
+    return iter;
+  }
+
+  return std::make_shared<TtlIterator>(iter, NowSeconds());
+}
+
+bool TtlIterator::IsExpired() const {
+  std::string_view user_value;
+  return !StripValue(iter_->Value(), now_s_, user_value);
+}
+
+void TtlIterator::SkipForward() {
+  while (iter_->Valid() && IsExpired()) {
+    iter_->Next();
+  }
+}
+
+void TtlIterator::SkipBackward() {
+  while (iter_->Valid() && IsExpired()) {
+    iter_->Prev();
+  }
+}
+
+void TtlIterator::SeekToFirst() {
+  iter_->SeekToFirst();
+  SkipForward();
+}
+
+void TtlIterator::SeekToLast() {
+  iter_->SeekToLast();
+  SkipBackward();
+}
+
+void TtlIterator::Seek(const std::string& target) {
+  iter_->Seek(target);
+  SkipForward();
+}
+
+void TtlIterator::SeekForPrev(const std::string& target) {
+  iter_->SeekForPrev(target);
+  SkipBackward();
+}
+
+void TtlIterator::Next() {
+  iter_->Next();
+  SkipForward();
+}
+
+void TtlIterator::Prev() {
+  iter_->Prev();
+  SkipBackward();
+}
+
+std::string_view TtlIterator::Value() const {
+  std::string_view user_value;
+  StripValue(iter_->Value(), now_s_, user_value);
+  return user_value;
+}
+
+bool TtlCompactionFilter::Filter(int /*level*/, const rocksdb::Slice& key, const rocksdb::Slice& existing_value,
+                                 std::string* /*new_value*/, bool* /*value_changed*/) const {
+  if (RawKvTtl::GetInstance().GetTtl(Constant::kStoreDataCF, key.ToStringView()) == 0) {
+    return false;
+  }
+
+  std::string_view user_value;
+  int64_t expire_ts_s = 0;
+  if (!RawKvTtl::DecodeValue(existing_value.ToStringView(), user_value, expire_ts_s) || expire_ts_s > now_s_) {
+    return false;
+  }
+
+  g_raw_kv_ttl_compaction_drop_count << 1;
+  return true;
+}
+
+std::unique_ptr<rocksdb::CompactionFilter> TtlCompactionFilterFactory::CreateCompactionFilter(
+    const rocksdb::CompactionFilter::Context& /*context*/) {
+  return std::make_unique<TtlCompactionFilter>(NowSeconds());
+}
+
+}  // namespace dingodb
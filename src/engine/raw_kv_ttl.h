@@ -0,0 +1,143 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef DINGODB_ENGINE_RAW_KV_TTL_H_
+#define DINGODB_ENGINE_RAW_KV_TTL_H_
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "butil/status.h"
+#include "engine/iterator.h"
+#include "engine/raw_engine.h"
+#include "proto/common.pb.h"
+#include "rocksdb/compaction_filter.h"
+#include "rocksdb/slice.h"
+
+namespace dingodb {
+
+// TTL of raw kv tables, the expired rows are dropped without client delete.
+// The table definition has no ttl, so the ttl is set per partition by raw_kv_ttl_partitions, e.g. "1001:3600,1002:60".
+// The value of a partition with ttl is stored as user value | expire time(8 bytes, seconds), the engine writer
+// appends the expire time before proposal, so every replica stores the same value. Reads drop the expired rows and
+// strip the expire time, and the compaction filter of data cf deletes them physically, no raft write is needed.
+// Set the ttl of a partition before writing it, the values written without ttl are not readable after.
+class RawKvTtl {
+ public:
+  static RawKvTtl& GetInstance();
+
+  // Parse config "partition_id:ttl_s,...", replace the current ttls.
+  bool Init(const std::string& config);
+  bool IsEnabled() const { return !partition_ttls_.empty(); }
+
+  // Ttl seconds of key, 0 means no ttl. Only the raw kv keys of data cf have ttl.
+  int64_t GetTtl(const std::string& cf_name, std::string_view key) const;
+  bool HasTtl(const std::string& cf_name, const std::vector<pb::common::KeyValue>& kvs) const;
+
+  // Append the expire time to the values of keys with ttl.
+  void EncodeValues(const std::string& cf_name, std::vector<pb::common::KeyValue>& kvs) const;
+
+  static std::string EncodeValue(std::string_view value, int64_t expire_ts_s);
+  // Return false if the value is too short to have expire time.
+  static bool DecodeValue(std::string_view value, std::string_view& user_value, int64_t& expire_ts_s);
+
+  // Read by raw engine reader, drop the expired values and strip the expire time of the keys with ttl.
+  butil::Status KvGet(RawEngine::ReaderPtr reader, const std::string& cf_name, const std::string& key,
+                      std::string& value) const;
+  butil::Status KvGetPinned(RawEngine::ReaderPtr reader, const std::string& cf_name, const std::string& key,
+                            const ValueVisitor& visitor) const;
+  butil::Status KvMultiGet(RawEngine::ReaderPtr reader, const std::string& cf_name,
+                           const std::vector<std::string>& keys, std::vector<std::string>& values,
+                           std::vector<bool>& exists) const;
+  butil::Status KvScan(RawEngine::ReaderPtr reader, const std::string& cf_name, const std::string& start_key,
+                       const std::string& end_key, std::vector<pb::common::KeyValue>& kvs) const;
+  butil::Status KvCount(RawEngine::ReaderPtr reader, const std::string& cf_name, const std::string& start_key,
+                        const std::string& end_key, int64_t& count) const;
+
+  // Wrap the iterator of range if it has ttl.
+  IteratorPtr WrapIterator(const std::string& cf_name, const pb::common::Range& range, IteratorPtr iter) const;
+
+ private:
+  RawKvTtl();
+  ~RawKvTtl() = default;
+
+  // partition id -> ttl seconds
+  std::map<int64_t, int64_t> partition_ttls_;
+};
+
+// Skip the expired values and strip the expire time.
+class TtlIterator : public Iterator {
+ public:
+  TtlIterator(IteratorPtr iter, int64_t now_s) : iter_(iter), now_s_(now_s) {}
+  ~TtlIterator() override = default;
+
+  std::string GetName() override { return "Ttl"; }
+  IteratorType GetID() override { return iter_->GetID(); }
+
+  bool Valid() const override { return iter_->Valid(); }
+
+  void SeekToFirst() override;
+  void SeekToLast() override;
+
+  void Seek(const std::string& target) override;
+  void SeekForPrev(const std::string& target) override;
+
+  void Next() override;
+  void Prev() override;
+
+  std::string_view Key() const override { return iter_->Key(); }
+  std::string_view Value() const override;
+
+  butil::Status Status() const override { return iter_->Status(); }
+
+ private:
+  bool IsExpired() const;
+  void SkipForward();
+  void SkipBackward();
+
+  IteratorPtr iter_;
+  int64_t now_s_;
+};
+
+// Delete the expired values of data cf in compaction.
+class TtlCompactionFilter : public rocksdb::CompactionFilter {
+ public:
+  explicit TtlCompactionFilter(int64_t now_s) : now_s_(now_s) {}
+  ~TtlCompactionFilter() override = default;
+
+  bool Filter(int level, const rocksdb::Slice& key, const rocksdb::Slice& existing_value, std::string* new_value,
+              bool* value_changed) const override;
+
+  const char* Name() const override { return "TtlCompactionFilter"; }
+
+ private:
+  int64_t now_s_;
+};
+
+class TtlCompactionFilterFactory : public rocksdb::CompactionFilterFactory {
+ public:
+  std::unique_ptr<rocksdb::CompactionFilter> CreateCompactionFilter(
+      const rocksdb::CompactionFilter::Context& context) override;
+
+  const char* Name() const override { return "TtlCompactionFilterFactory"; }
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_ENGINE_RAW_KV_TTL_H_
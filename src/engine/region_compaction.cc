@@ -0,0 +1,188 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "engine/region_compaction.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <ctime>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "bvar/reducer.h"
+#include "common/helper.h"
+#include "common/logging.h"
+#include "engine/rocks_raw_engine.h"
+#include "fmt/core.h"
+#include "gflags/gflags.h"
+#include "proto/common.pb.h"
+#include "server/server.h"
+
+namespace dingodb {
+
+DEFINE_bool(enable_region_compaction, false, "enable compact the range of region which has much garbage");
+DEFINE_double(region_compaction_garbage_ratio, 0.3, "min deletion ratio of region to compact");
+DEFINE_int64(region_compaction_min_deletion_count, 10000, "min deletion count of region to compact");
+DEFINE_int32(region_compaction_region_num_per_round, 2, "max region num to compact per round");
+DEFINE_int64(region_compaction_min_interval_s, 3600, "min interval seconds between two compactions of one region");
+DEFINE_int32(region_compaction_start_hour, 0, "start hour of region compaction window, local time");
+DEFINE_int32(region_compaction_end_hour, 24, "end hour of region compaction window, local time");
+
+static bvar::Adder<int64_t> g_region_compaction_count("dingo_region_compaction_count");
+
+RegionCompactionScheduler& RegionCompactionScheduler::GetInstance() {
+  static RegionCompactionScheduler instance;
+  return instance;
+}
+
+bool RegionCompactionScheduler::IsEnabled() { return FLAGS_enable_region_compaction; }
+
+double RegionCompactionScheduler::GarbageRatio(const Candidate& candidate) {
+  // a range tombstone may shadow any number of entries
+  if (candidate.range_deletion_count > 0) {
+    return 1.0;
+  }
+  if (candidate.entry_count <= 0) {
+    return 0.0;
+  }
+
+  return static_cast<double>(candidate.deletion_count) / candidate.entry_count;
+}
+
+std::vector<int64_t> RegionCompactionScheduler::Pick(std::vector<Candidate> candidates, double min_garbage_ratio,
+                                                     int64_t min_deletion_count, int32_t max_num) {
+  candidates.erase(std::remove_if(candidates.begin(), candidates.end(),
+                                  [&](const Candidate& candidate) {
+                                    if (candidate.range_deletion_count > 0) {
+                                      return false;
+                                    }
+                                    return candidate.deletion_count < min_deletion_count ||
+                                           GarbageRatio(candidate) < min_garbage_ratio;
+                                  }),
+                   candidates.end());
+
+  std::sort(candidates.begin(), candidates.end(), [](const Candidate& lhs, const Candidate& rhs) {
+    double lhs_ratio = GarbageRatio(lhs);
+    double rhs_ratio = GarbageRatio(rhs);
+    return lhs_ratio != rhs_ratio ? lhs_ratio > rhs_ratio : lhs.deletion_count > rhs.deletion_count;
+  });
+
+  std::vector<int64_t> region_ids;
+  for (const auto& candidate : candidates) {
+    if (static_cast<int32_t>(region_ids.size()) >= max_num) {
+      break;
+    }
+    region_ids.push_back(candidate.region_id);
+  }
+
+  return region_ids;
+}
+
+bool RegionCompactionScheduler::InWindow(int32_t hour, int32_t start_hour, int32_t end_hour) {
+  if (start_hour <= end_hour) {
+    return hour >= start_hour && hour < end_hour;
+  }
+
+  return hour >= start_hour || hour < end_hour;
+}
+
+// The column families and the ranges of region in them.
+static std::vector<std::pair<std::string, pb::common::Range>> GetCfRanges(store::RegionPtr region) {
+  std::vector<std::string> raw_cf_names;
+  std::vector<std::string> txn_cf_names;
+  Helper::GetColumnFamilyNames(region->Range().start_key(), raw_cf_names, txn_cf_names);
+
+  std::vector<std::pair<std::string, pb::common::Range>> cf_ranges;
+  for (const auto& cf_name : raw_cf_names) {
+    cf_ranges.emplace_back(cf_name, region->Range());
+  }
+  pb::common::Range txn_range = Helper::GetMemComparableRange(region->Range());
+  for (const auto& cf_name : txn_cf_names) {
+    cf_ranges.emplace_back(cf_name, txn_range);
+  }
+
+  return cf_ranges;
+}
+
+void RegionCompactionScheduler::Schedule() {
+  time_t now = std::time(nullptr);
+  struct tm local_time;
+  localtime_r(&now, &local_time);
+  if (!InWindow(local_time.tm_hour, FLAGS_region_compaction_start_hour, FLAGS_region_compaction_end_hour)) {
+    return;
+  }
+
+  auto raw_engine =
+      std::dynamic_pointer_cast<RocksRawEngine>(Server::GetInstance().GetRawEngine(pb::common::RAW_ENG_ROCKSDB));
+  if (raw_engine == nullptr) {
+    return;
+  }
+
+  int64_t now_ms = Helper::TimestampMs();
+  std::map<int64_t, int64_t> last_compact_time_ms;
+  {
+    BAIDU_SCOPED_LOCK(mutex_);
+    last_compact_time_ms = last_compact_time_ms_;
+  }
+
+  std::map<int64_t, store::RegionPtr> regions;
+  std::vector<Candidate> candidates;
+  for (auto& region : Server::GetInstance().GetAllAliveRegion()) {
+    if (region->GetRawEngineType() != pb::common::RAW_ENG_ROCKSDB ||
+        region->State() != pb::common::StoreRegionState::NORMAL || Helper::InvalidRange(region->Range())) {
+      continue;
+    }
+    regions[region->Id()] = region;
+
+    auto it = last_compact_time_ms.find(region->Id());
+    if (it != last_compact_time_ms.end() && now_ms - it->second < FLAGS_region_compaction_min_interval_s * 1000) {
+      continue;
+    }
+
+    RocksRawEngine::TableStats stats;
+    for (const auto& [cf_name, range] : GetCfRanges(region)) {
+      raw_engine->GetTableStats(cf_name, range, stats);
+    }
+    candidates.push_back({region->Id(), stats.entry_count, stats.deletion_count, stats.range_deletion_count});
+  }
+
+  auto region_ids = Pick(candidates, FLAGS_region_compaction_garbage_ratio, FLAGS_region_compaction_min_deletion_count,
+                         FLAGS_region_compaction_region_num_per_round);
+  for (auto region_id : region_ids) {
+    auto region = regions[region_id];
+    int64_t start_time_ms = Helper::TimestampMs();
+    for (const auto& [cf_name, range] : GetCfRanges(region)) {
+      raw_engine->CompactRange(cf_name, range);
+    }
+    g_region_compaction_count << 1;
+    last_compact_time_ms[region_id] = Helper::TimestampMs();
+
+    DINGO_LOG(INFO) << fmt::format("[region_compaction][region({})] compact region range, time consuming: {} ms",
+                                   region_id, Helper::TimestampMs() - start_time_ms);
+  }
+
+  // Drop the region which is not alive.
+  for (auto it = last_compact_time_ms.begin(); it != last_compact_time_ms.end();) {
+    it = regions.count(it->first) > 0 ? std::next(it) : last_compact_time_ms.erase(it);
+  }
+
+  BAIDU_SCOPED_LOCK(mutex_);
+  last_compact_time_ms_.swap(last_compact_time_ms);
+}
+
+}  // namespace dingodb
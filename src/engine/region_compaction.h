@@ -0,0 +1,66 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef DINGODB_ENGINE_REGION_COMPACTION_H_
+#define DINGODB_ENGINE_REGION_COMPACTION_H_
+
+#include <cstdint>
+#include <map>
+#include <vector>
+
+#include "bthread/mutex.h"
+
+namespace dingodb {
+
+// Compact the range of a few regions per round which have much garbage, only in the low load window, instead of the
+// manual full compaction of column family.
+// The garbage of region is estimated by the deletion count in the table properties of the sst files overlapped with
+// it, a region has range tombstone is compacted first.
+class RegionCompactionScheduler {
+ public:
+  static RegionCompactionScheduler& GetInstance();
+
+  static bool IsEnabled();
+
+  // Run by crontab.
+  void Schedule();
+
+  struct Candidate {
+    int64_t region_id{0};
+    int64_t entry_count{0};
+    int64_t deletion_count{0};
+    int64_t range_deletion_count{0};
+  };
+  // Pick at most max_num regions, the most garbage first.
+  static std::vector<int64_t> Pick(std::vector<Candidate> candidates, double min_garbage_ratio,
+                                   int64_t min_deletion_count, int32_t max_num);
+
+  // Whether hour is in [start_hour, end_hour), the window crosses midnight if start_hour > end_hour.
+  static bool InWindow(int32_t hour, int32_t start_hour, int32_t end_hour);
+
+ private:
+  RegionCompactionScheduler() = default;
+  ~RegionCompactionScheduler() = default;
+
+  static double GarbageRatio(const Candidate& candidate);
+
+  bthread::Mutex mutex_;
+  // region id -> last compact time
+  std::map<int64_t, int64_t> last_compact_time_ms_;
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_ENGINE_REGION_COMPACTION_H_
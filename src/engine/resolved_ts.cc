@@ -0,0 +1,76 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "engine/resolved_ts.h"
+
+#include <cstdint>
+#include <set>
+
+#include "bthread/mutex.h"
+#include "gflags/gflags.h"
+
+namespace dingodb {
+
+DEFINE_bool(enable_resolved_ts, false, "enable region resolved ts, txn read below it can be served on any replica");
+DEFINE_int32(resolved_ts_advance_interval_s, 5, "advance region resolved ts interval seconds");
+DEFINE_int64(resolved_ts_max_scan_lock_count, 10000,
+             "max lock count scanned of one region when advance resolved ts without lock index, the region is not "
+             "advanced in this round when exceeded");
+
+RegionResolvedTs::RegionResolvedTs() { bthread_mutex_init(&mutex_, nullptr); }
+
+RegionResolvedTs::~RegionResolvedTs() { bthread_mutex_destroy(&mutex_); }
+
+RegionResolvedTs& RegionResolvedTs::GetInstance() {
+  static RegionResolvedTs instance;
+  return instance;
+}
+
+bool RegionResolvedTs::IsEnabled() { return FLAGS_enable_resolved_ts; }
+
+void RegionResolvedTs::Advance(int64_t region_id, int64_t resolved_ts) {
+  BAIDU_SCOPED_LOCK(mutex_);
+  auto& ts = resolved_ts_[region_id];
+  if (resolved_ts > ts) {
+    ts = resolved_ts;
+  }
+}
+
+int64_t RegionResolvedTs::Get(int64_t region_id) {
+  BAIDU_SCOPED_LOCK(mutex_);
+  auto it = resolved_ts_.find(region_id);
+  return it != resolved_ts_.end() ? it->second : 0;
+}
+
+void RegionResolvedTs::Erase(int64_t region_id) {
+  BAIDU_SCOPED_LOCK(mutex_);
+  resolved_ts_.erase(region_id);
+}
+
+void RegionResolvedTs::EraseNotIn(const std::set<int64_t>& region_ids) {
+  BAIDU_SCOPED_LOCK(mutex_);
+  for (auto it = resolved_ts_.begin(); it != resolved_ts_.end();) {
+    if (region_ids.count(it->first) == 0) {
+      it = resolved_ts_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+bool RegionResolvedTs::IsResolved(int64_t region_id, int64_t start_ts) {
+  return start_ts > 0 && start_ts <= Get(region_id);
+}
+
+}  // namespace dingodb
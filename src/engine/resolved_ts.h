@@ -0,0 +1,62 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_ENGINE_RESOLVED_TS_H_
+#define DINGODB_ENGINE_RESOLVED_TS_H_
+
+#include <cstdint>
+#include <map>
+#include <set>
+
+#include "bthread/types.h"
+
+namespace dingodb {
+
+// Resolved ts of region on this replica, all the txn which commit_ts not greater than it are applied locally,
+// and there is no lock which lock_ts less than it.
+// So txn read with start_ts not greater than it can be served on any replica without lock conflict.
+// It is advanced periodically by a store task, from a tso and the min lock_ts of region after read index.
+class RegionResolvedTs {
+ public:
+  RegionResolvedTs();
+  ~RegionResolvedTs();
+
+  RegionResolvedTs(const RegionResolvedTs& rhs) = delete;
+  RegionResolvedTs& operator=(const RegionResolvedTs& rhs) = delete;
+  RegionResolvedTs(RegionResolvedTs&& rhs) = delete;
+  RegionResolvedTs& operator=(RegionResolvedTs&& rhs) = delete;
+
+  static RegionResolvedTs& GetInstance();
+
+  static bool IsEnabled();
+
+  // Resolved ts only move forward.
+  void Advance(int64_t region_id, int64_t resolved_ts);
+  // Return 0 if not resolved.
+  int64_t Get(int64_t region_id);
+  void Erase(int64_t region_id);
+  // Erase the regions not in region_ids, e.g. deleted or moved out of this store.
+  void EraseNotIn(const std::set<int64_t>& region_ids);
+
+  // Whether txn read at start_ts can serve on this replica.
+  bool IsResolved(int64_t region_id, int64_t start_ts);
+
+ private:
+  bthread_mutex_t mutex_;
+  std::map<int64_t, int64_t> resolved_ts_;
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_ENGINE_RESOLVED_TS_H_
@@ -16,14 +16,20 @@
 
 #include <elf.h>
 
+#include <algorithm>
+#include <atomic>
 #include <cstddef>
 #include <cstdint>
 #include <cstring>
 #include <exception>
+#include <limits>
 #include <map>
 #include <memory>
+#include <numeric>
 #include <stdexcept>
 #include <string>
+#include <string_view>
+#include <thread>
 #include <tuple>
 #include <type_traits>
 #include <utility>
@@ -31,12 +37,17 @@
 
 #include "butil/compiler_specific.h"
 #include "butil/status.h"
+#include "bvar/reducer.h"
 #include "common/constant.h"
 #include "common/helper.h"
 #include "common/logging.h"
+#include "common/synchronization.h"
 #include "config/config_helper.h"
+#include "engine/flushed_applied_index_tracker.h"
 #include "engine/raw_engine.h"
+#include "engine/raw_kv_ttl.h"
 #include "engine/snapshot.h"
+#include "engine/txn_gc_compaction_filter.h"
 #include "fmt/core.h"
 #include "proto/common.pb.h"
 #include "proto/error.pb.h"
@@ -45,13 +56,86 @@
 #include "rocksdb/db.h"
 #include "rocksdb/filter_policy.h"
 #include "rocksdb/iterator.h"
+#include "rocksdb/listener.h"
+#include "rocksdb/perf_context.h"
+#include "rocksdb/perf_level.h"
+#include "rocksdb/rate_limiter.h"
 #include "rocksdb/table.h"
+#include "rocksdb/table_properties.h"
 #include "rocksdb/write_batch.h"
 
 namespace dingodb {
 DEFINE_bool(enable_rocksdb_sync, false, "enable rocksdb sync ");
+DEFINE_bool(rocksdb_disable_data_wal, false,
+            "disable wal of raft replicated data column families, recover them by replaying raft log after the "
+            "flushed applied index, only for store/index/document role");
+DEFINE_bool(rocksdb_multiget_async_io, true, "rocksdb multi get read sst files with async io");
+DEFINE_bool(rocksdb_long_scan_async_io, true, "rocksdb long scan prefetch sst blocks with async io");
+DEFINE_int64(rocksdb_long_scan_readahead_size, 2 * 1024 * 1024, "rocksdb long scan initial readahead size");
+DEFINE_bool(rocksdb_long_scan_fill_cache, false, "rocksdb long scan fill block cache");
+DEFINE_bool(rocksdb_block_cache_read_metrics, true,
+            "rocksdb account block cache hit/miss of point read and scan separately");
+DEFINE_int64(rocksdb_rate_bytes_per_sec, 0, "rocksdb flush and compaction write rate limit, 0 means no limit");
+DEFINE_int32(raft_snapshot_merge_parallel_num, 1, "column families cut in parallel when merge checkpoint files");
+DEFINE_int64(raft_snapshot_merge_rate_bytes_per_sec, 0,
+             "write rate limit of merge checkpoint files shared by all regions, 0 means no limit");
 namespace rocks {
 
+static bvar::Adder<int64_t> g_point_read_block_cache_hit_count("dingo_rocksdb_point_read_block_cache_hit_count");
+static bvar::Adder<int64_t> g_point_read_block_cache_miss_count("dingo_rocksdb_point_read_block_cache_miss_count");
+static bvar::Adder<int64_t> g_scan_block_cache_hit_count("dingo_rocksdb_scan_block_cache_hit_count");
+static bvar::Adder<int64_t> g_scan_block_cache_miss_count("dingo_rocksdb_scan_block_cache_miss_count");
+// the block cache misses served by compressed secondary cache, not read from sst
+static bvar::Adder<int64_t> g_point_read_secondary_cache_hit_count(
+    "dingo_rocksdb_point_read_secondary_cache_hit_count");
+static bvar::Adder<int64_t> g_scan_secondary_cache_hit_count("dingo_rocksdb_scan_secondary_cache_hit_count");
+
+// Account the block cache hit/miss of one engine read by the thread local perf context,
+// a single rocksdb call never yields the bthread, so the delta belongs to this read.
+class BlockCacheReadGuard {
+ public:
+  explicit BlockCacheReadGuard(bool is_scan) : is_scan_(is_scan), enable_(FLAGS_rocksdb_block_cache_read_metrics) {
+    if (enable_) {
+      if (rocksdb::GetPerfLevel() < rocksdb::PerfLevel::kEnableCount) {
+        rocksdb::SetPerfLevel(rocksdb::PerfLevel::kEnableCount);
+      }
+      auto* perf_context = rocksdb::get_perf_context();
+      hit_count_ = perf_context->block_cache_hit_count;
+      miss_count_ = perf_context->block_read_count;
+      secondary_hit_count_ = perf_context->secondary_cache_hit_count;
+    }
+  }
+  ~BlockCacheReadGuard() {
+    if (!enable_) {
+      return;
+    }
+
+    auto* perf_context = rocksdb::get_perf_context();
+    int64_t hit_count = static_cast<int64_t>(perf_context->block_cache_hit_count - hit_count_);
+    int64_t miss_count = static_cast<int64_t>(perf_context->block_read_count - miss_count_);
+    if (hit_count > 0) {
+      (is_scan_ ? g_scan_block_cache_hit_count : g_point_read_block_cache_hit_count) << hit_count;
+    }
+    if (miss_count > 0) {
+      (is_scan_ ? g_scan_block_cache_miss_count : g_point_read_block_cache_miss_count) << miss_count;
+    }
+    int64_t secondary_hit_count = static_cast<int64_t>(perf_context->secondary_cache_hit_count - secondary_hit_count_);
+    if (secondary_hit_count > 0) {
+      (is_scan_ ? g_scan_secondary_cache_hit_count : g_point_read_secondary_cache_hit_count) << secondary_hit_count;
+    }
+  }
+
+  BlockCacheReadGuard(const BlockCacheReadGuard&) = delete;
+  void operator=(const BlockCacheReadGuard&) = delete;
+
+ private:
+  bool is_scan_;
+  bool enable_;
+  uint64_t hit_count_{0};
+  uint64_t miss_count_{0};
+  uint64_t secondary_hit_count_{0};
+};
+
 ColumnFamily::ColumnFamily(const std::string& cf_name, const ColumnFamilyConfig& config,
                            rocksdb::ColumnFamilyHandle* handle)
     : name_(cf_name), config_(config), handle_(handle) {}
@@ -107,6 +191,44 @@ bool Iterator::Valid() const {
   return true;
 }
 
+void Iterator::SeekToFirst() {
+  BlockCacheReadGuard guard(true);
+  iter_->SeekToFirst();
+}
+
+void Iterator::SeekToLast() {
+  BlockCacheReadGuard guard(true);
+  iter_->SeekToLast();
+}
+
+void Iterator::Seek(const std::string& target) {
+  BlockCacheReadGuard guard(true);
+  iter_->Seek(target);
+}
+
+void Iterator::SeekForPrev(const std::string& target) {
+  BlockCacheReadGuard guard(true);
+  iter_->SeekForPrev(target);
+}
+
+void Iterator::Next() {
+  BlockCacheReadGuard guard(true);
+  iter_->Next();
+}
+
+void Iterator::Prev() {
+  BlockCacheReadGuard guard(true);
+  iter_->Prev();
+}
+
+std::string_view Iterator::Value() const {
+  // the value of key only iterator is loaded on demand
+  if (options_.key_only && !iter_->PrepareValue()) {
+    return {};
+  }
+  return std::string_view(iter_->value().data(), iter_->value().size());
+}
+
 butil::Status Iterator::Status() const {
   if (iter_->status().ok()) {
     return butil::Status();
@@ -141,12 +263,22 @@ butil::Status SstFileWriter::SaveFile(std::shared_ptr<dingodb::Iterator> iter, c
     return butil::Status(status.code(), status.ToString());
   }
 
+  int64_t unlimited_bytes = 0;
   for (; iter->Valid(); iter->Next()) {
     status = sst_writer_->Put(iter->Key(), iter->Value());
     if (!status.ok()) {
       sst_writer_->Finish();
       return butil::Status(status.code(), status.ToString());
     }
+
+    if (rate_limiter_ != nullptr) {
+      unlimited_bytes += iter->Key().size() + iter->Value().size();
+      int64_t burst_bytes = rate_limiter_->GetSingleBurstBytes();
+      while (unlimited_bytes >= burst_bytes) {
+        rate_limiter_->Request(burst_bytes, rocksdb::Env::IO_LOW, nullptr, rocksdb::RateLimiter::OpType::kWrite);
+        unlimited_bytes -= burst_bytes;
+      }
+    }
   }
 
   status = sst_writer_->Finish();
@@ -325,7 +457,47 @@ butil::Status Reader::KvGet(ColumnFamilyPtr column_family, dingodb::SnapshotPtr
 
   rocksdb::ReadOptions read_option;
   read_option.snapshot = static_cast<const rocksdb::Snapshot*>(snapshot->Inner());
-  rocksdb::Status s = GetDB()->Get(read_option, column_family->GetHandle(), rocksdb::Slice(key), &value);
+  rocksdb::Status s;
+  {
+    BlockCacheReadGuard guard(false);
+    s = GetDB()->Get(read_option, column_family->GetHandle(), rocksdb::Slice(key), &value);
+  }
+  if (!s.ok()) {
+    if (s.IsNotFound()) {
+      return butil::Status(pb::error::EKEY_NOT_FOUND, "Not found key");
+    }
+    DINGO_LOG(ERROR) << fmt::format("[rocksdb] get key failed, error: {}", s.ToString());
+    return butil::Status(pb::error::EINTERNAL, "Internal get error");
+  }
+
+  return butil::Status();
+}
+
+butil::Status Reader::KvGetPinned(const std::string& cf_name, const std::string& key, const ValueVisitor& visitor) {
+  return KvGetPinned(GetColumnFamily(cf_name), GetSnapshot(), key, visitor);
+}
+
+butil::Status Reader::KvGetPinned(const std::string& cf_name, dingodb::SnapshotPtr snapshot, const std::string& key,
+                                  const ValueVisitor& visitor) {
+  return KvGetPinned(GetColumnFamily(cf_name), snapshot, key, visitor);
+}
+
+butil::Status Reader::KvGetPinned(ColumnFamilyPtr column_family, dingodb::SnapshotPtr snapshot, const std::string& key,
+                                  const ValueVisitor& visitor) {
+  if (BAIDU_UNLIKELY(key.empty())) {
+    DINGO_LOG(ERROR) << fmt::format("[rocksdb] not support empty key.");
+    return butil::Status(pb::error::EKEY_EMPTY, "Key is empty");
+  }
+
+  rocksdb::ReadOptions read_option;
+  read_option.snapshot = static_cast<const rocksdb::Snapshot*>(snapshot->Inner());
+  // pinned value refers the block cache or memtable memory, released when out of scope.
+  rocksdb::PinnableSlice pinnable_value;
+  rocksdb::Status s;
+  {
+    BlockCacheReadGuard guard(false);
+    s = GetDB()->Get(read_option, column_family->GetHandle(), rocksdb::Slice(key), &pinnable_value);
+  }
   if (!s.ok()) {
     if (s.IsNotFound()) {
       return butil::Status(pb::error::EKEY_NOT_FOUND, "Not found key");
@@ -334,6 +506,75 @@ butil::Status Reader::KvGet(ColumnFamilyPtr column_family, dingodb::SnapshotPtr
     return butil::Status(pb::error::EINTERNAL, "Internal get error");
   }
 
+  visitor(std::string_view(pinnable_value.data(), pinnable_value.size()));
+
+  return butil::Status();
+}
+
+butil::Status Reader::KvMultiGet(const std::string& cf_name, const std::vector<std::string>& keys,
+                                 std::vector<std::string>& values, std::vector<bool>& exists) {
+  return KvMultiGet(GetColumnFamily(cf_name), GetSnapshot(), keys, values, exists);
+}
+
+butil::Status Reader::KvMultiGet(const std::string& cf_name, dingodb::SnapshotPtr snapshot,
+                                 const std::vector<std::string>& keys, std::vector<std::string>& values,
+                                 std::vector<bool>& exists) {
+  return KvMultiGet(GetColumnFamily(cf_name), snapshot, keys, values, exists);
+}
+
+butil::Status Reader::KvMultiGet(ColumnFamilyPtr column_family, dingodb::SnapshotPtr snapshot,
+                                 const std::vector<std::string>& keys, std::vector<std::string>& values,
+                                 std::vector<bool>& exists) {
+  values.clear();
+  values.resize(keys.size());
+  exists.assign(keys.size(), false);
+  if (keys.empty()) {
+    return butil::Status();
+  }
+
+  for (const auto& key : keys) {
+    if (BAIDU_UNLIKELY(key.empty())) {
+      DINGO_LOG(ERROR) << fmt::format("[rocksdb] not support empty key.");
+      return butil::Status(pb::error::EKEY_EMPTY, "Key is empty");
+    }
+  }
+
+  // batched MultiGet does one pass over the files with sorted keys, keep the caller order by index.
+  std::vector<size_t> order(keys.size());
+  std::iota(order.begin(), order.end(), 0);
+  if (!std::is_sorted(keys.begin(), keys.end())) {
+    std::sort(order.begin(), order.end(), [&keys](size_t lhs, size_t rhs) { return keys[lhs] < keys[rhs]; });
+  }
+
+  std::vector<rocksdb::Slice> key_slices;
+  key_slices.reserve(keys.size());
+  for (auto i : order) {
+    key_slices.emplace_back(keys[i]);
+  }
+
+  rocksdb::ReadOptions read_option;
+  read_option.snapshot = static_cast<const rocksdb::Snapshot*>(snapshot->Inner());
+  read_option.async_io = FLAGS_rocksdb_multiget_async_io;
+
+  std::vector<rocksdb::PinnableSlice> pinnable_values(keys.size());
+  std::vector<rocksdb::Status> statuses(keys.size());
+  {
+    BlockCacheReadGuard guard(false);
+    GetDB()->MultiGet(read_option, column_family->GetHandle(), keys.size(), key_slices.data(), pinnable_values.data(),
+                      statuses.data(), true);
+  }
+
+  for (size_t i = 0; i < keys.size(); ++i) {
+    const auto& s = statuses[i];
+    if (s.ok()) {
+      values[order[i]].assign(pinnable_values[i].data(), pinnable_values[i].size());
+      exists[order[i]] = true;
+    } else if (!s.IsNotFound()) {
+      DINGO_LOG(ERROR) << fmt::format("[rocksdb] multi get key failed, error: {}", s.ToString());
+      return butil::Status(pb::error::EINTERNAL, "Internal multi get error");
+    }
+  }
+
   return butil::Status();
 }
 
@@ -394,6 +635,8 @@ butil::Status Reader::KvCount(ColumnFamilyPtr column_family, dingodb::SnapshotPt
   rocksdb::ReadOptions read_options;
   read_options.auto_prefix_mode = true;
   read_options.snapshot = static_cast<const rocksdb::Snapshot*>(snapshot->Inner());
+  // count not read values
+  read_options.allow_unprepared_value = true;
 
   std::string_view end_key_view(end_key.data(), end_key.size());
   rocksdb::Iterator* it = GetDB()->NewIterator(read_options, column_family->GetHandle());
@@ -424,6 +667,17 @@ dingodb::IteratorPtr Reader::NewIterator(ColumnFamilyPtr column_family, dingodb:
     read_options.snapshot = static_cast<const rocksdb::Snapshot*>(snapshot->Inner());
   }
   read_options.auto_prefix_mode = true;
+  if (options.long_scan) {
+    // prefetch next blocks while consuming current, readahead grows adaptively.
+    read_options.async_io = FLAGS_rocksdb_long_scan_async_io;
+    read_options.adaptive_readahead = true;
+    read_options.readahead_size = FLAGS_rocksdb_long_scan_readahead_size;
+    // one pass cold scan not evict hot blocks
+    read_options.fill_cache = FLAGS_rocksdb_long_scan_fill_cache;
+  }
+  if (options.key_only) {
+    read_options.allow_unprepared_value = true;
+  }
 
   return std::make_shared<Iterator>(options, GetDB()->NewIterator(read_options, column_family->GetHandle()), snapshot);
 }
@@ -446,6 +700,29 @@ std::shared_ptr<RocksRawEngine> Writer::GetRawEngine() {
   return raw_engine;
 }
 
+// Raft replicated data can be recovered by replaying raft log, meta column family always keep wal.
+static bool IsDisableWal(const std::string& cf_name) {
+  return FLAGS_rocksdb_disable_data_wal && cf_name != Constant::kStoreMetaCF;
+}
+
+template <typename T>
+static bool IsDisableWal(const std::map<std::string, T>& value_with_cfs) {
+  return std::all_of(value_with_cfs.begin(), value_with_cfs.end(),
+                     [](const auto& pair) { return IsDisableWal(pair.first); });
+}
+
+static rocksdb::WriteOptions GenWriteOptions(bool disable_wal) {
+  rocksdb::WriteOptions write_options;
+  if (disable_wal) {
+    // sync write require wal
+    write_options.disableWAL = true;
+  } else if (FLAGS_enable_rocksdb_sync) {
+    write_options.sync = true;
+  }
+
+  return write_options;
+}
+
 std::shared_ptr<rocksdb::DB> Writer::GetDB() { return GetRawEngine()->GetDB(); }
 
 ColumnFamilyPtr Writer::GetColumnFamily(const std::string& cf_name) { return GetRawEngine()->GetColumnFamily(cf_name); }
@@ -458,10 +735,7 @@ butil::Status Writer::KvPut(const std::string& cf_name, const pb::common::KeyVal
     return butil::Status(pb::error::EKEY_EMPTY, "Key is empty");
   }
 
-  rocksdb::WriteOptions write_options;
-  if (FLAGS_enable_rocksdb_sync) {
-    write_options.sync = true;
-  }
+  auto write_options = GenWriteOptions(IsDisableWal(cf_name));
   rocksdb::Status s = GetDB()->Put(write_options, GetColumnFamily(cf_name)->GetHandle(), rocksdb::Slice(kv.key()),
                                    rocksdb::Slice(kv.value()));
   if (!s.ok()) {
@@ -508,10 +782,7 @@ butil::Status Writer::KvBatchPutAndDelete(const std::string& cf_name,
       }
     }
   }
-  rocksdb::WriteOptions write_options;
-  if (FLAGS_enable_rocksdb_sync) {
-    write_options.sync = true;
-  }
+  auto write_options = GenWriteOptions(IsDisableWal(cf_name));
   rocksdb::Status s = GetDB()->Write(write_options, &batch);
   if (!s.ok()) {
     DINGO_LOG(ERROR) << fmt::format("[rocksdb] write failed, error: {}", s.ToString());
@@ -570,10 +841,7 @@ butil::Status Writer::KvBatchPutAndDelete(
     }
   }
 
-  rocksdb::WriteOptions write_options;
-  if (FLAGS_enable_rocksdb_sync) {
-    write_options.sync = true;
-  }
+  auto write_options = GenWriteOptions(IsDisableWal(kv_puts_with_cf) && IsDisableWal(kv_deletes_with_cf));
   rocksdb::Status s = GetDB()->Write(write_options, &batch);
   if (!s.ok()) {
     DINGO_LOG(ERROR) << fmt::format("[rocksdb] write failed, error: {}", s.ToString());
@@ -589,10 +857,7 @@ butil::Status Writer::KvDelete(const std::string& cf_name, const std::string& ke
     return butil::Status(pb::error::EKEY_EMPTY, "Key is empty");
   }
 
-  rocksdb::WriteOptions write_options;
-  if (FLAGS_enable_rocksdb_sync) {
-    write_options.sync = true;
-  }
+  auto write_options = GenWriteOptions(IsDisableWal(cf_name));
   rocksdb::Status const s =
       GetDB()->Delete(write_options, GetColumnFamily(cf_name)->GetHandle(), rocksdb::Slice(key.data(), key.size()));
   if (!s.ok()) {
@@ -617,10 +882,7 @@ butil::Status Writer::KvDeleteRange(const std::string& cf_name, const pb::common
     DINGO_LOG(ERROR) << fmt::format("[rocksdb] delete range failed, error: {}.", s.ToString());
     return butil::Status(pb::error::EINTERNAL, "Internal delete range error");
   }
-  rocksdb::WriteOptions write_options;
-  if (FLAGS_enable_rocksdb_sync) {
-    write_options.sync = true;
-  }
+  auto write_options = GenWriteOptions(IsDisableWal(cf_name));
 
   s = GetDB()->Write(write_options, &batch);
   if (!s.ok()) {
@@ -650,10 +912,7 @@ butil::Status Writer::KvBatchDeleteRange(const std::map<std::string, std::vector
       }
     }
   }
-  rocksdb::WriteOptions write_options;
-  if (FLAGS_enable_rocksdb_sync) {
-    write_options.sync = true;
-  }
+  auto write_options = GenWriteOptions(IsDisableWal(range_with_cfs));
 
   rocksdb::Status s = GetDB()->Write(write_options, &batch);
   if (!s.ok()) {
@@ -674,15 +933,29 @@ static rocks::ColumnFamilyMap GenColumnFamilyByDefaultConfig(const std::vector<s
   rocks::ColumnFamily::ColumnFamilyConfig default_config;
   default_config.emplace(Constant::kBlockSize, Constant::kBlockSizeDefaultValue);
   default_config.emplace(Constant::kBlockCache, Constant::kBlockCacheDefaultValue);
+  default_config.emplace(Constant::kCompressedSecondaryCache, Constant::kCompressedSecondaryCacheDefaultValue);
   default_config.emplace(Constant::kArenaBlockSize, Constant::kArenaBlockSizeDefaultValue);
   default_config.emplace(Constant::kMinWriteBufferNumberToMerge, Constant::kMinWriteBufferNumberToMergeDefaultValue);
   default_config.emplace(Constant::kMaxWriteBufferNumber, Constant::kMaxWriteBufferNumberDefaultValue);
   default_config.emplace(Constant::kMaxCompactionBytes, Constant::kMaxCompactionBytesDefaultValue);
   default_config.emplace(Constant::kWriteBufferSize, Constant::kWriteBufferSizeDefaultValue);
   default_config.emplace(Constant::kPrefixExtractor, Constant::kPrefixExtractorDefaultValue);
+  default_config.emplace(Constant::kPrefixExtractorType, Constant::kPrefixExtractorTypeDefaultValue);
+  default_config.emplace(Constant::kMemtablePrefixBloomSizeRatio, Constant::kMemtablePrefixBloomSizeRatioDefaultValue);
+  default_config.emplace(Constant::kMemtableWholeKeyFiltering, Constant::kMemtableWholeKeyFilteringDefaultValue);
+  default_config.emplace(Constant::kBloomFilterBitsPerKey, Constant::kBloomFilterBitsPerKeyDefaultValue);
+  default_config.emplace(Constant::kWholeKeyFiltering, Constant::kWholeKeyFilteringDefaultValue);
   default_config.emplace(Constant::kMaxBytesForLevelBase, Constant::kMaxBytesForLevelBaseDefaultValue);
   default_config.emplace(Constant::kTargetFileSizeBase, Constant::kTargetFileSizeBaseDefaultValue);
   default_config.emplace(Constant::kMaxBytesForLevelMultiplier, Constant::kMaxBytesForLevelMultiplierDefaultValue);
+  default_config.emplace(Constant::kColdPath, Constant::kColdPathDefaultValue);
+  default_config.emplace(Constant::kColdLevel, Constant::kColdLevelDefaultValue);
+  default_config.emplace(Constant::kColdTtlS, Constant::kColdTtlSDefaultValue);
+  default_config.emplace(Constant::kEnableBlobFiles, Constant::kEnableBlobFilesDefaultValue);
+  default_config.emplace(Constant::kMinBlobSize, Constant::kMinBlobSizeDefaultValue);
+  default_config.emplace(Constant::kBlobFileSize, Constant::kBlobFileSizeDefaultValue);
+  default_config.emplace(Constant::kBlobGcAgeCutoff, Constant::kBlobGcAgeCutoffDefaultValue);
+  default_config.emplace(Constant::kBlobGcForceThreshold, Constant::kBlobGcForceThresholdDefaultValue);
 
   rocks::ColumnFamilyMap column_families;
   for (const auto& cf_name : column_family_names) {
@@ -767,8 +1040,38 @@ bool CastValue(std::string value, std::string& dst_value) {
   return true;
 }
 
+template <>
+bool CastValue(std::string value, bool& dst_value) {
+  if (value == "true") {
+    dst_value = true;
+  } else if (value == "false") {
+    dst_value = false;
+  } else {
+    DINGO_LOG(FATAL) << fmt::format("[rocksdb] cast bool failed, value: {}.", value);
+    return false;
+  }
+  return true;
+}
+
+// The size of level [0, cold_level) when every level is full, L0 is estimated as L1 like rocksdb placing sst by
+// cf_paths target size, so the sst of these levels are placed in the first path.
+static uint64_t CalcHotPathTargetSize(uint64_t max_bytes_for_level_base, double max_bytes_for_level_multiplier,
+                                      int cold_level) {
+  uint64_t target_size = 0;
+  double level_size = max_bytes_for_level_base;
+  for (int level = 0; level < cold_level; ++level) {
+    target_size += static_cast<uint64_t>(level_size);
+    if (level > 0) {
+      level_size *= max_bytes_for_level_multiplier;
+    }
+  }
+
+  return target_size;
+}
+
 // set cf config
-static rocksdb::ColumnFamilyOptions GenRocksDBColumnFamilyOptions(rocks::ColumnFamilyPtr column_family) {
+static rocksdb::ColumnFamilyOptions GenRocksDBColumnFamilyOptions(const std::string& db_path,
+                                                                  rocks::ColumnFamilyPtr column_family) {
   rocksdb::ColumnFamilyOptions family_options;
   rocksdb::BlockBasedTableOptions table_options;
 
@@ -780,7 +1083,21 @@ static rocksdb::ColumnFamilyOptions GenRocksDBColumnFamilyOptions(rocks::ColumnF
     size_t option_value = 0;
     CastValue(column_family->GetConfItem(Constant::kBlockCache), option_value);
 
-    table_options.block_cache = rocksdb::NewLRUCache(option_value);  // LRUcache
+    rocksdb::LRUCacheOptions cache_options;
+    cache_options.capacity = option_value;
+
+    // more cached blocks per gigabyte for point read heavy cf
+    size_t secondary_cache_size = 0;
+    CastValue(column_family->GetConfItem(Constant::kCompressedSecondaryCache), secondary_cache_size);
+    if (secondary_cache_size > 0) {
+      rocksdb::CompressedSecondaryCacheOptions secondary_cache_options;
+      secondary_cache_options.capacity = secondary_cache_size;
+      cache_options.secondary_cache = rocksdb::NewCompressedSecondaryCache(secondary_cache_options);
+      DINGO_LOG(INFO) << fmt::format("[rocksdb] cf({}) compressed secondary cache size({})", column_family->Name(),
+                                     secondary_cache_size);
+    }
+
+    table_options.block_cache = rocksdb::NewLRUCache(cache_options);  // LRUcache
   }
 
   // arena_block_size
@@ -804,19 +1121,83 @@ static rocksdb::ColumnFamilyOptions GenRocksDBColumnFamilyOptions(rocks::ColumnF
             family_options.max_bytes_for_level_multiplier);
 
   // prefix_extractor
+  // capped keeps the keys shorter than the length in domain, fixed leaves them out of the prefix bloom.
   {
     size_t value = 0;
     CastValue(column_family->GetConfItem(Constant::kPrefixExtractor), value);
 
-    family_options.prefix_extractor.reset(rocksdb::NewCappedPrefixTransform(value));
+    std::string type;
+    CastValue(column_family->GetConfItem(Constant::kPrefixExtractorType), type);
+    if (type == "fixed") {
+      family_options.prefix_extractor.reset(rocksdb::NewFixedPrefixTransform(value));
+    } else if (type == "none") {
+      family_options.prefix_extractor.reset();
+    } else {
+      if (type != "capped") {
+        DINGO_LOG(WARNING) << fmt::format("[rocksdb] unknown prefix_extractor_type({}), use capped.", type);
+      }
+      family_options.prefix_extractor.reset(rocksdb::NewCappedPrefixTransform(value));
+    }
   }
 
+  // memtable bloom, size is ratio of write_buffer_size, 0 disable.
+  CastValue(column_family->GetConfItem(Constant::kMemtablePrefixBloomSizeRatio),
+            family_options.memtable_prefix_bloom_size_ratio);
+  CastValue(column_family->GetConfItem(Constant::kMemtableWholeKeyFiltering),
+            family_options.memtable_whole_key_filtering);
+
   // max_bytes_for_level_base
   CastValue(column_family->GetConfItem(Constant::kMaxBytesForLevelBase), family_options.max_bytes_for_level_base);
 
   // target_file_size_base
   CastValue(column_family->GetConfItem(Constant::kTargetFileSizeBase), family_options.target_file_size_base);
 
+  // tiered storage, the hot levels stay in db path, the cold levels are placed in cold path.
+  {
+    std::string cold_path;
+    CastValue(column_family->GetConfItem(Constant::kColdPath), cold_path);
+    if (!cold_path.empty()) {
+      int cold_level = 0;
+      CastValue(column_family->GetConfItem(Constant::kColdLevel), cold_level);
+      uint64_t hot_target_size = CalcHotPathTargetSize(family_options.max_bytes_for_level_base,
+                                                       family_options.max_bytes_for_level_multiplier, cold_level);
+      family_options.cf_paths.emplace_back(db_path, hot_target_size);
+      family_options.cf_paths.emplace_back(cold_path, std::numeric_limits<uint64_t>::max());
+
+      uint64_t ttl_s = 0;
+      CastValue(column_family->GetConfItem(Constant::kColdTtlS), ttl_s);
+      if (ttl_s > 0) {
+        family_options.ttl = ttl_s;
+      }
+
+      DINGO_LOG(INFO) << fmt::format(
+          "[rocksdb] cf({}) tiered storage, cold_path({}) cold_level({}) hot_target_size({}) cold_ttl_s({})",
+          column_family->Name(), cold_path, cold_level, hot_target_size, ttl_s);
+    }
+  }
+
+  // key-value separation, compaction only rewrites the keys and blob references of the large values.
+  // the blob garbage made by delete and mvcc gc is relocated when compaction touches the oldest blob files.
+  {
+    bool enable_blob_files = false;
+    CastValue(column_family->GetConfItem(Constant::kEnableBlobFiles), enable_blob_files);
+    if (enable_blob_files) {
+      family_options.enable_blob_files = true;
+      CastValue(column_family->GetConfItem(Constant::kMinBlobSize), family_options.min_blob_size);
+      CastValue(column_family->GetConfItem(Constant::kBlobFileSize), family_options.blob_file_size);
+      family_options.enable_blob_garbage_collection = true;
+      CastValue(column_family->GetConfItem(Constant::kBlobGcAgeCutoff),
+                family_options.blob_garbage_collection_age_cutoff);
+      CastValue(column_family->GetConfItem(Constant::kBlobGcForceThreshold),
+                family_options.blob_garbage_collection_force_threshold);
+
+      DINGO_LOG(INFO) << fmt::format(
+          "[rocksdb] cf({}) blob files, min_blob_size({}) blob_file_size({}) gc_age_cutoff({}) gc_force_threshold({})",
+          column_family->Name(), family_options.min_blob_size, family_options.blob_file_size,
+          family_options.blob_garbage_collection_age_cutoff, family_options.blob_garbage_collection_force_threshold);
+    }
+  }
+
   family_options.compression_per_level = {
       rocksdb::CompressionType::kNoCompression,  rocksdb::CompressionType::kNoCompression,
       rocksdb::CompressionType::kLZ4Compression, rocksdb::CompressionType::kLZ4Compression,
@@ -824,21 +1205,48 @@ static rocksdb::ColumnFamilyOptions GenRocksDBColumnFamilyOptions(rocks::ColumnF
       rocksdb::CompressionType::kZSTD,
   };
 
-  table_options.filter_policy.reset(rocksdb::NewBloomFilterPolicy(10.0, false));
-  table_options.whole_key_filtering = true;
+  // sst bloom, hold whole keys for point lookup and prefixes for region bounded scan(auto_prefix_mode).
+  {
+    double bits_per_key = 0;
+    CastValue(column_family->GetConfItem(Constant::kBloomFilterBitsPerKey), bits_per_key);
+    if (bits_per_key > 0) {
+      table_options.filter_policy.reset(rocksdb::NewBloomFilterPolicy(bits_per_key, false));
+    }
+    CastValue(column_family->GetConfItem(Constant::kWholeKeyFiltering), table_options.whole_key_filtering);
+  }
 
   rocksdb::TableFactory* table_factory = NewBlockBasedTableFactory(table_options);
   family_options.table_factory.reset(table_factory);
 
+  // txn gc drop old mvcc versions in compaction.
+  if (column_family->Name() == Constant::kTxnWriteCF && CompactionFilterGc::IsEnabled()) {
+    family_options.compaction_filter_factory = std::make_shared<TxnGcCompactionFilterFactory>();
+  }
+  // drop the expired raw kv in compaction.
+  if (column_family->Name() == Constant::kStoreDataCF && RawKvTtl::GetInstance().IsEnabled()) {
+    family_options.compaction_filter_factory = std::make_shared<TtlCompactionFilterFactory>();
+  }
+
   return family_options;
 }
 
+// Notify the flushed sequence number when the wal of raft replicated data is disabled.
+class DataFlushListener : public rocksdb::EventListener {
+ public:
+  void OnFlushCompleted(rocksdb::DB* /*db*/, const rocksdb::FlushJobInfo& flush_job_info) override {
+    if (FlushedAppliedIndexTracker::GetInstance().OnFlushCompleted(flush_job_info.largest_seqno)) {
+      // write db in flush listener may deadlock with write stall, so persist in background.
+      Bthread bth([]() { FlushedAppliedIndexTracker::GetInstance().PersistFlushed(); });
+    }
+  }
+};
+
 static rocksdb::DB* InitDB(const std::string& db_path, rocks::ColumnFamilyMap& column_families) {
   // Cast ColumnFamily to rocksdb::ColumnFamilyOptions
   std::vector<rocksdb::ColumnFamilyDescriptor> column_family_descs;
   for (auto [cf_name, column_family] : column_families) {
     column_family->Dump();
-    rocksdb::ColumnFamilyOptions family_options = GenRocksDBColumnFamilyOptions(column_family);
+    rocksdb::ColumnFamilyOptions family_options = GenRocksDBColumnFamilyOptions(db_path, column_family);
     column_family_descs.push_back(rocksdb::ColumnFamilyDescriptor(cf_name, family_options));
   }
 
@@ -851,6 +1259,19 @@ static rocksdb::DB* InitDB(const std::string& db_path, rocks::ColumnFamilyMap& c
   DINGO_LOG(INFO) << fmt::format("[rocksdb] config max_background_jobs({}) max_subcompactions({})",
                                  db_options.max_background_jobs, db_options.max_subcompactions);
 
+  if (FLAGS_rocksdb_rate_bytes_per_sec > 0) {
+    db_options.rate_limiter.reset(rocksdb::NewGenericRateLimiter(FLAGS_rocksdb_rate_bytes_per_sec));
+    DINGO_LOG(INFO) << fmt::format("[rocksdb] config rate_bytes_per_sec({})", FLAGS_rocksdb_rate_bytes_per_sec);
+  }
+
+  if (FLAGS_rocksdb_disable_data_wal) {
+    // data of all column families must be flushed together, then the largest flushed sequence number
+    // means every write before it is in sst.
+    db_options.atomic_flush = true;
+    db_options.listeners.push_back(std::make_shared<DataFlushListener>());
+    DINGO_LOG(INFO) << "[rocksdb] disable data wal, enable atomic flush.";
+  }
+
   rocksdb::DB* db;
   std::vector<rocksdb::ColumnFamilyHandle*> family_handles;
   rocksdb::Status s = rocksdb::DB::Open(db_options, db_path, column_family_descs, &family_handles, &db);
@@ -900,6 +1321,29 @@ bool RocksRawEngine::Init(std::shared_ptr<Config> config, const std::vector<std:
   reader_ = std::make_shared<rocks::Reader>(GetSelfPtr());
   writer_ = std::make_shared<rocks::Writer>(GetSelfPtr());
 
+  if (FLAGS_rocksdb_disable_data_wal) {
+    std::weak_ptr<rocksdb::DB> weak_db = db_;
+    FlushedAppliedIndexTracker::GetInstance().SetSequenceFunc([weak_db]() -> uint64_t {
+      auto db = weak_db.lock();
+      return db != nullptr ? db->GetLatestSequenceNumber() : 0;
+    });
+  }
+
+  if (CompactionFilterGc::IsEnabled()) {
+    std::weak_ptr<RocksRawEngine> weak_engine = GetSelfPtr();
+    CompactionFilterGc::GetInstance().SetDeleteDataFunc([weak_engine](const std::vector<std::string>& data_keys) {
+      auto engine = weak_engine.lock();
+      if (engine == nullptr) {
+        return;
+      }
+      auto status = engine->Writer()->KvBatchPutAndDelete(Constant::kTxnDataCF, {}, data_keys);
+      if (!status.ok()) {
+        DINGO_LOG(ERROR) << fmt::format("[rocksdb] delete txn data of gc failed, count: {} error: {}",
+                                        data_keys.size(), status.error_str());
+      }
+    });
+  }
+
   DINGO_LOG(INFO) << fmt::format("[rocksdb] open success, path: {}", db_path_);
 
   return true;
@@ -955,6 +1399,17 @@ rocks::SstFileWriterPtr RocksRawEngine::NewSstFileWriter() {
 
 RawEngine::CheckpointPtr RocksRawEngine::NewCheckpoint() { return std::make_shared<rocks::Checkpoint>(GetSelfPtr()); }
 
+// Shared by the snapshots of all regions, so the total rate of cutting range sst is bounded.
+static rocksdb::RateLimiter* SnapshotMergeRateLimiter() {
+  if (FLAGS_raft_snapshot_merge_rate_bytes_per_sec <= 0) {
+    return nullptr;
+  }
+
+  static std::unique_ptr<rocksdb::RateLimiter> rate_limiter(
+      rocksdb::NewGenericRateLimiter(FLAGS_raft_snapshot_merge_rate_bytes_per_sec));
+  return rate_limiter.get();
+}
+
 butil::Status RocksRawEngine::MergeCheckpointFiles(const std::string& path, const pb::common::Range& range,
                                                    const std::vector<std::string>& cf_names,
                                                    std::vector<std::string>& merge_sst_paths) {
@@ -988,85 +1443,116 @@ butil::Status RocksRawEngine::MergeCheckpointFiles(const std::string& path, cons
     return butil::Status(pb::error::EINTERNAL, fmt::format("Rocksdb Repair db failed, {}", status.ToString()));
   }
 
-  auto default_cf_desc = rocksdb::ColumnFamilyDescriptor(Constant::kStoreDataCF, rocksdb::ColumnFamilyOptions());
-
-  for (int i = 0; i < cf_names.size(); i++) {
-    std::vector<rocksdb::ColumnFamilyDescriptor> cf_descs;
-    cf_descs.push_back(default_cf_desc);
-    if (cf_names[i] != Constant::kStoreDataCF) {
-      cf_descs.push_back(rocksdb::ColumnFamilyDescriptor(cf_names[i], rocksdb::ColumnFamilyOptions()));
+  int parallel_num = std::min(static_cast<int>(cf_names.size()), std::max(FLAGS_raft_snapshot_merge_parallel_num, 1));
+  if (parallel_num <= 1) {
+    for (int i = 0; i < cf_names.size(); i++) {
+      auto ret = MergeCheckpointCfFile(path, range, cf_names[i], merge_sst_paths[i]);
+      if (!ret.ok()) {
+        return ret;
+      }
     }
+    return butil::Status::OK();
+  }
+
+  // every column family is cut by its own read only db and sst writer, they only share the checkpoint files.
+  std::vector<butil::Status> statuses(cf_names.size());
+  std::atomic<int> next_index{0};
+  std::vector<std::thread> threads;
+  threads.reserve(parallel_num);
+  for (int i = 0; i < parallel_num; ++i) {
+    threads.emplace_back([&]() {
+      for (int index = next_index.fetch_add(1); index < cf_names.size(); index = next_index.fetch_add(1)) {
+        statuses[index] = MergeCheckpointCfFile(path, range, cf_names[index], merge_sst_paths[index]);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
 
-    // Open snapshot db.
-    rocksdb::DB* snapshot_db = nullptr;
-    std::vector<rocksdb::ColumnFamilyHandle*> handles;
-    status = rocksdb::DB::OpenForReadOnly(options, path, cf_descs, &handles, &snapshot_db);
-    if (!status.ok()) {
-      DINGO_LOG(ERROR) << fmt::format("[rocksdb] open checkpoint failed, path: {} error: {}", path, status.ToString());
-      // return butil::Status(pb::error::EINTERNAL, fmt::format("Rocksdb open checkpoint failed, {}",
-      // status.ToString()));
-      merge_sst_paths[i] = "";
-      continue;
+  for (const auto& ret : statuses) {
+    if (!ret.ok()) {
+      return ret;
     }
+  }
 
-    DINGO_LOG(INFO) << fmt::format("[rocksdb] open checkpoint success, path: {} cf_name: {}", path, cf_names[i]);
+  return butil::Status::OK();
+}
 
-    // Create iterator
-    IteratorOptions iter_options;
-    iter_options.upper_bound = range.end_key();
+butil::Status RocksRawEngine::MergeCheckpointCfFile(const std::string& path, const pb::common::Range& range,
+                                                    const std::string& cf_name, std::string& merge_sst_path) {
+  rocksdb::Options options;
+  options.create_if_missing = false;
 
-    rocksdb::ReadOptions read_options;
-    read_options.auto_prefix_mode = true;
+  std::vector<rocksdb::ColumnFamilyDescriptor> cf_descs;
+  cf_descs.push_back(rocksdb::ColumnFamilyDescriptor(Constant::kStoreDataCF, rocksdb::ColumnFamilyOptions()));
+  if (cf_name != Constant::kStoreDataCF) {
+    cf_descs.push_back(rocksdb::ColumnFamilyDescriptor(cf_name, rocksdb::ColumnFamilyOptions()));
+  }
 
-    auto& merge_sst_path = merge_sst_paths[i];
-    auto* handle = handles[0];
-    if (handles.size() > 1) {
-      handle = handles[1];
-    }
+  // Open snapshot db.
+  rocksdb::DB* snapshot_db = nullptr;
+  std::vector<rocksdb::ColumnFamilyHandle*> handles;
+  auto status = rocksdb::DB::OpenForReadOnly(options, path, cf_descs, &handles, &snapshot_db);
+  if (!status.ok()) {
+    DINGO_LOG(ERROR) << fmt::format("[rocksdb] open checkpoint failed, path: {} error: {}", path, status.ToString());
+    merge_sst_path = "";
+    return butil::Status::OK();
+  }
 
-    butil::Status ret_status = butil::Status::OK();
-    {
-      auto iter = std::make_shared<rocks::Iterator>(iter_options, snapshot_db->NewIterator(read_options, handle));
-      if (iter == nullptr) {
-        DINGO_LOG(ERROR) << fmt::format("[rocksdb] merge checkpoint files failed, create iterator failed");
-        ret_status = butil::Status(pb::error::EINTERNAL, "merge checkpoint files failed, create iterator failed");
-      } else {
-        iter->Seek(range.start_key());
-        auto ret = NewSstFileWriter()->SaveFile(iter, merge_sst_path);
-        if (ret.error_code() == pb::error::Errno::ENO_ENTRIES) {
-          DINGO_LOG(WARNING) << "[rocksdb] merge checkpoint files no entries, file_name=" << merge_sst_path;
-          merge_sst_paths[i] = "";
-        } else if (!ret.ok()) {
-          DINGO_LOG(ERROR) << fmt::format("[rocksdb] merge checkpoint files failed, save file failed")
-                           << ", error: " << ret.error_str();
-          ret_status = butil::Status(pb::error::EINTERNAL, "merge checkpoint files failed, save file failed");
-        }
+  DINGO_LOG(INFO) << fmt::format("[rocksdb] open checkpoint success, path: {} cf_name: {}", path, cf_name);
 
-        DINGO_LOG(INFO) << fmt::format("[rocksdb] merge checkpoint files success, path: {} cf_name: {}", path,
-                                       cf_names[i]);
-      }
-    }
+  // Create iterator
+  IteratorOptions iter_options;
+  iter_options.upper_bound = range.end_key();
 
-    // Close snapshot db.
-    try {
-      CancelAllBackgroundWork(snapshot_db, true);
-      snapshot_db->DropColumnFamilies(handles);
-      for (auto& handle : handles) {
-        snapshot_db->DestroyColumnFamilyHandle(handle);
+  rocksdb::ReadOptions read_options;
+  read_options.auto_prefix_mode = true;
+
+  auto* handle = handles[0];
+  if (handles.size() > 1) {
+    handle = handles[1];
+  }
+
+  butil::Status ret_status = butil::Status::OK();
+  {
+    auto iter = std::make_shared<rocks::Iterator>(iter_options, snapshot_db->NewIterator(read_options, handle));
+    if (iter == nullptr) {
+      DINGO_LOG(ERROR) << fmt::format("[rocksdb] merge checkpoint files failed, create iterator failed");
+      ret_status = butil::Status(pb::error::EINTERNAL, "merge checkpoint files failed, create iterator failed");
+    } else {
+      iter->Seek(range.start_key());
+      auto sst_writer = NewSstFileWriter();
+      sst_writer->SetRateLimiter(SnapshotMergeRateLimiter());
+      auto ret = sst_writer->SaveFile(iter, merge_sst_path);
+      if (ret.error_code() == pb::error::Errno::ENO_ENTRIES) {
+        DINGO_LOG(WARNING) << "[rocksdb] merge checkpoint files no entries, file_name=" << merge_sst_path;
+        merge_sst_path = "";
+      } else if (!ret.ok()) {
+        DINGO_LOG(ERROR) << fmt::format("[rocksdb] merge checkpoint files failed, save file failed")
+                         << ", error: " << ret.error_str();
+        ret_status = butil::Status(pb::error::EINTERNAL, "merge checkpoint files failed, save file failed");
       }
-      snapshot_db->Close();
-      delete snapshot_db;
-    } catch (std::exception& e) {
-      DINGO_LOG(ERROR) << fmt::format("[rocksdb] close snapshot db failed, path: {} error: {}", path, e.what());
-      ret_status = butil::Status(pb::error::EINTERNAL, fmt::format("Rocksdb close snapshot db failed, {}", e.what()));
+
+      DINGO_LOG(INFO) << fmt::format("[rocksdb] merge checkpoint files success, path: {} cf_name: {}", path, cf_name);
     }
+  }
 
-    if (!ret_status.ok()) {
-      return ret_status;
+  // Close snapshot db.
+  try {
+    CancelAllBackgroundWork(snapshot_db, true);
+    snapshot_db->DropColumnFamilies(handles);
+    for (auto& handle : handles) {
+      snapshot_db->DestroyColumnFamilyHandle(handle);
     }
+    snapshot_db->Close();
+    delete snapshot_db;
+  } catch (std::exception& e) {
+    DINGO_LOG(ERROR) << fmt::format("[rocksdb] close snapshot db failed, path: {} error: {}", path, e.what());
+    ret_status = butil::Status(pb::error::EINTERNAL, fmt::format("Rocksdb close snapshot db failed, {}", e.what()));
   }
 
-  return butil::Status::OK();
+  return ret_status;
 }
 
 butil::Status RocksRawEngine::IngestExternalFile(const std::string& cf_name, const std::vector<std::string>& files) {
@@ -1081,11 +1567,28 @@ butil::Status RocksRawEngine::IngestExternalFile(const std::string& cf_name, con
   return butil::Status();
 }
 
-void RocksRawEngine::Flush(const std::string& cf_name) {
+butil::Status RocksRawEngine::Flush(const std::string& cf_name) {
   if (db_) {
     rocksdb::FlushOptions flush_options;
-    db_->Flush(flush_options, GetColumnFamily(cf_name)->GetHandle());
+    rocksdb::Status status;
+    if (FLAGS_rocksdb_disable_data_wal) {
+      // flush all column families atomically, keep the flushed sequence number meaningful.
+      std::vector<rocksdb::ColumnFamilyHandle*> column_family_handles;
+      for (auto& [_, column_family] : column_families_) {
+        column_family_handles.push_back(column_family->GetHandle());
+      }
+      status = db_->Flush(flush_options, column_family_handles);
+    } else {
+      status = db_->Flush(flush_options, GetColumnFamily(cf_name)->GetHandle());
+    }
+    if (!status.ok()) {
+      DINGO_LOG(ERROR) << fmt::format("[rocksdb] flush failed, column family {} error: {}", cf_name,
+                                      status.ToString());
+      return butil::Status(pb::error::EINTERNAL, "Flush column family %s failed", cf_name.c_str());
+    }
   }
+
+  return butil::Status();
 }
 
 butil::Status RocksRawEngine::Compact(const std::string& cf_name) {
@@ -1104,6 +1607,36 @@ butil::Status RocksRawEngine::Compact(const std::string& cf_name) {
   return butil::Status();
 }
 
+butil::Status RocksRawEngine::DeleteFilesInRange(const std::string& cf_name, const pb::common::Range& range) {
+  if (db_ == nullptr) {
+    return butil::Status();
+  }
+
+  auto* handle = GetColumnFamily(cf_name)->GetHandle();
+  rocksdb::Slice start_key(range.start_key());
+  rocksdb::Slice end_key(range.end_key());
+  auto status = rocksdb::DeleteFilesInRange(db_.get(), handle, &start_key, &end_key, false);
+  if (!status.ok()) {
+    DINGO_LOG(ERROR) << fmt::format("[rocksdb] delete files in range failed, column family {} range[{}, {}) error: {}",
+                                    cf_name, Helper::StringToHex(range.start_key()),
+                                    Helper::StringToHex(range.end_key()), status.ToString());
+    return butil::Status(pb::error::EINTERNAL, "Delete files in range of column family %s failed", cf_name.c_str());
+  }
+
+  // the files across the range boundary are left, compact them to drop the deleted data and range tombstones.
+  rocksdb::CompactRangeOptions options;
+  options.allow_write_stall = false;
+  status = db_->CompactRange(options, handle, &start_key, &end_key);
+  if (!status.ok()) {
+    DINGO_LOG(ERROR) << fmt::format("[rocksdb] compact range failed, column family {} range[{}, {}) error: {}",
+                                    cf_name, Helper::StringToHex(range.start_key()),
+                                    Helper::StringToHex(range.end_key()), status.ToString());
+    return butil::Status(pb::error::EINTERNAL, "Compact range of column family %s failed", cf_name.c_str());
+  }
+
+  return butil::Status();
+}
+
 void RocksRawEngine::Destroy() { rocksdb::DestroyDB(db_path_, rocksdb::Options()); }
 
 void RocksRawEngine::Close() {
@@ -1129,9 +1662,55 @@ void RocksRawEngine::Close() {
   DINGO_LOG(INFO) << fmt::format("[rocksdb] close db.");
 }
 
+butil::Status RocksRawEngine::CompactRange(const std::string& cf_name, const pb::common::Range& range) {
+  if (db_ != nullptr) {
+    rocksdb::CompactRangeOptions options;
+    options.allow_write_stall = false;
+    // rewrite bottommost files too, the filter drops the old versions there.
+    options.bottommost_level_compaction = rocksdb::BottommostLevelCompaction::kForceOptimized;
+    rocksdb::Slice start_key(range.start_key());
+    rocksdb::Slice end_key(range.end_key());
+    auto status = db_->CompactRange(options, GetColumnFamily(cf_name)->GetHandle(), &start_key, &end_key);
+    if (!status.ok()) {
+      DINGO_LOG(ERROR) << fmt::format("[rocksdb] compact range failed, column family {} range[{}, {}) error: {}",
+                                      cf_name, Helper::StringToHex(range.start_key()),
+                                      Helper::StringToHex(range.end_key()), status.ToString());
+      return butil::Status(pb::error::EINTERNAL, "Compact range of column family %s failed", cf_name.c_str());
+    }
+  }
+
+  return butil::Status();
+}
+
+butil::Status RocksRawEngine::GetTableStats(const std::string& cf_name, const pb::common::Range& range,
+                                            TableStats& stats) {
+  if (db_ == nullptr) {
+    return butil::Status(pb::error::EINTERNAL, "Db is closed");
+  }
+
+  rocksdb::Range inner_range(range.start_key(), range.end_key());
+  rocksdb::TablePropertiesCollection props;
+  auto status = db_->GetPropertiesOfTablesInRange(GetColumnFamily(cf_name)->GetHandle(), &inner_range, 1, &props);
+  if (!status.ok()) {
+    DINGO_LOG(ERROR) << fmt::format("[rocksdb] get table properties failed, column family {} error: {}", cf_name,
+                                    status.ToString());
+    return butil::Status(pb::error::EINTERNAL, "Get table properties of column family %s failed", cf_name.c_str());
+  }
+
+  for (const auto& [_, prop] : props) {
+    stats.entry_count += prop->num_entries;
+    stats.deletion_count += prop->num_deletions;
+    stats.range_deletion_count += prop->num_range_deletions;
+  }
+
+  return butil::Status();
+}
+
 std::vector<int64_t> RocksRawEngine::GetApproximateSizes(const std::string& cf_name,
                                                          std::vector<pb::common::Range>& ranges) {
   rocksdb::SizeApproximationOptions options;
+  // the recent writes are still in memtable, count them too.
+  options.include_memtables = true;
 
   rocksdb::Range inner_ranges[ranges.size()];
   for (int i = 0; i < ranges.size(); ++i) {
@@ -1151,4 +1730,23 @@ std::vector<int64_t> RocksRawEngine::GetApproximateSizes(const std::string& cf_n
   return result;
 }
 
+int64_t RocksRawEngine::GetMemoryUsage() {
+  // every column family has its own block cache, so the aggregated usage is not double counted
+  static const std::vector<std::string> kMemoryProperties = {
+      rocksdb::DB::Properties::kCurSizeAllMemTables,
+      rocksdb::DB::Properties::kEstimateTableReadersMem,
+      rocksdb::DB::Properties::kBlockCacheUsage,
+  };
+
+  int64_t memory_usage = 0;
+  for (const auto& property : kMemoryProperties) {
+    uint64_t value = 0;
+    if (db_->GetAggregatedIntProperty(property, &value)) {
+      memory_usage += value;
+    }
+  }
+
+  return memory_usage;
+}
+
 }  // namespace dingodb
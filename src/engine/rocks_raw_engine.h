@@ -31,6 +31,7 @@
 #include "rocksdb/db.h"
 #include "rocksdb/listener.h"
 #include "rocksdb/options.h"
+#include "rocksdb/rate_limiter.h"
 #include "rocksdb/slice.h"
 #include "rocksdb/slice_transform.h"
 #include "rocksdb/utilities/checkpoint.h"
@@ -89,19 +90,19 @@ class Iterator : public dingodb::Iterator {
 
   bool Valid() const override;
 
-  void SeekToFirst() override { iter_->SeekToFirst(); }
-  void SeekToLast() override { iter_->SeekToLast(); }
+  void SeekToFirst() override;
+  void SeekToLast() override;
 
-  void Seek(const std::string& target) override { return iter_->Seek(target); }
+  void Seek(const std::string& target) override;
 
-  void SeekForPrev(const std::string& target) override { return iter_->SeekForPrev(target); }
+  void SeekForPrev(const std::string& target) override;
 
-  void Next() override { iter_->Next(); }
+  void Next() override;
 
-  void Prev() override { iter_->Prev(); }
+  void Prev() override;
 
   std::string_view Key() const override { return std::string_view(iter_->key().data(), iter_->key().size()); }
-  std::string_view Value() const override { return std::string_view(iter_->value().data(), iter_->value().size()); }
+  std::string_view Value() const override;
 
   butil::Status Status() const override;
 
@@ -146,9 +147,13 @@ class SstFileWriter {
 
   int64_t GetSize() { return sst_writer_->FileSize(); }
 
+  // Limit the write rate of SaveFile by iterator, the limiter is not owned.
+  void SetRateLimiter(rocksdb::RateLimiter* rate_limiter) { rate_limiter_ = rate_limiter; }
+
  private:
   rocksdb::Options options_;
   std::unique_ptr<rocksdb::SstFileWriter> sst_writer_;
+  rocksdb::RateLimiter* rate_limiter_{nullptr};
 };
 using SstFileWriterPtr = std::shared_ptr<SstFileWriter>;
 
@@ -182,6 +187,16 @@ class Reader : public RawEngine::Reader {
   butil::Status KvGet(const std::string& cf_name, dingodb::SnapshotPtr snapshot, const std::string& key,
                       std::string& value) override;
 
+  butil::Status KvGetPinned(const std::string& cf_name, const std::string& key, const ValueVisitor& visitor) override;
+  butil::Status KvGetPinned(const std::string& cf_name, dingodb::SnapshotPtr snapshot, const std::string& key,
+                            const ValueVisitor& visitor) override;
+
+  butil::Status KvMultiGet(const std::string& cf_name, const std::vector<std::string>& keys,
+                           std::vector<std::string>& values, std::vector<bool>& exists) override;
+  butil::Status KvMultiGet(const std::string& cf_name, dingodb::SnapshotPtr snapshot,
+                           const std::vector<std::string>& keys, std::vector<std::string>& values,
+                           std::vector<bool>& exists) override;
+
   butil::Status KvScan(const std::string& cf_name, const std::string& start_key, const std::string& end_key,
                        std::vector<pb::common::KeyValue>& kvs) override;
   butil::Status KvScan(const std::string& cf_name, std::shared_ptr<dingodb::Snapshot> snapshot,
@@ -206,6 +221,11 @@ class Reader : public RawEngine::Reader {
 
   butil::Status KvGet(ColumnFamilyPtr column_family, dingodb::SnapshotPtr snapshot, const std::string& key,
                       std::string& value);
+  butil::Status KvGetPinned(ColumnFamilyPtr column_family, dingodb::SnapshotPtr snapshot, const std::string& key,
+                            const ValueVisitor& visitor);
+  butil::Status KvMultiGet(ColumnFamilyPtr column_family, dingodb::SnapshotPtr snapshot,
+                           const std::vector<std::string>& keys, std::vector<std::string>& values,
+                           std::vector<bool>& exists);
   butil::Status KvScan(ColumnFamilyPtr column_family, std::shared_ptr<dingodb::Snapshot> snapshot,
                        const std::string& start_key, const std::string& end_key,
                        std::vector<pb::common::KeyValue>& kvs);
@@ -279,11 +299,25 @@ class RocksRawEngine : public RawEngine {
 
   butil::Status IngestExternalFile(const std::string& cf_name, const std::vector<std::string>& files) override;
 
-  void Flush(const std::string& cf_name) override;
+  butil::Status Flush(const std::string& cf_name) override;
   butil::Status Compact(const std::string& cf_name) override;
+  butil::Status DeleteFilesInRange(const std::string& cf_name, const pb::common::Range& range) override;
+  // Compact [start_key, end_key) of column family, not exclusive with the auto compaction.
+  butil::Status CompactRange(const std::string& cf_name, const pb::common::Range& range);
+
+  // Entry and deletion count summed from the table properties of the sst files overlapped with the range.
+  // The files across the range boundary are counted wholly, memtable is not counted.
+  struct TableStats {
+    int64_t entry_count{0};
+    int64_t deletion_count{0};
+    int64_t range_deletion_count{0};
+  };
+  butil::Status GetTableStats(const std::string& cf_name, const pb::common::Range& range, TableStats& stats);
 
   std::vector<int64_t> GetApproximateSizes(const std::string& cf_name, std::vector<pb::common::Range>& ranges) override;
 
+  int64_t GetMemoryUsage() override;
+
  private:
   friend rocks::Reader;
   friend rocks::Writer;
@@ -291,6 +325,10 @@ class RocksRawEngine : public RawEngine {
 
   std::shared_ptr<rocksdb::DB> GetDB();
 
+  // Cut the range of one column family out of the checkpoint into merge_sst_path.
+  static butil::Status MergeCheckpointCfFile(const std::string& path, const pb::common::Range& range,
+                                             const std::string& cf_name, std::string& merge_sst_path);
+
   rocks::ColumnFamilyPtr GetDefaultColumnFamily();
   rocks::ColumnFamilyPtr GetColumnFamily(const std::string& cf_name);
   std::vector<rocks::ColumnFamilyPtr> GetColumnFamilies(const std::vector<std::string>& cf_names);
@@ -0,0 +1,216 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "engine/row_cache.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "bthread/mutex.h"
+#include "bvar/passive_status.h"
+#include "bvar/reducer.h"
+#include "bvar/window.h"
+#include "common/logging.h"
+#include "fmt/core.h"
+#include "gflags/gflags.h"
+#include "metrics/store_bvar_metrics.h"
+
+namespace dingodb {
+
+DEFINE_bool(enable_row_cache, false, "enable raw kv row cache for raft store point read");
+DEFINE_int64(row_cache_capacity_bytes, 256 * 1024 * 1024, "raw kv row cache capacity bytes");
+DEFINE_uint32(row_cache_shard_num, 64, "raw kv row cache shard num");
+DEFINE_int64(row_cache_max_value_bytes, 64 * 1024, "raw kv row cache not cache value bigger than it");
+
+static bvar::Adder<int64_t> g_row_cache_hit_count("dingo_row_cache_hit_count");
+static bvar::Adder<int64_t> g_row_cache_miss_count("dingo_row_cache_miss_count");
+static bvar::Adder<int64_t> g_row_cache_evict_count("dingo_row_cache_evict_count");
+static bvar::Adder<int64_t> g_row_cache_invalidate_count("dingo_row_cache_invalidate_count");
+static bvar::Window<bvar::Adder<int64_t>> g_row_cache_hit_window(&g_row_cache_hit_count, 60);
+static bvar::Window<bvar::Adder<int64_t>> g_row_cache_miss_window(&g_row_cache_miss_count, 60);
+
+static double GetHitRatio(void*) {
+  int64_t hit = g_row_cache_hit_window.get_value();
+  int64_t total = hit + g_row_cache_miss_window.get_value();
+  return total > 0 ? static_cast<double>(hit) / total : 0.0;
+}
+
+// hit ratio in last 60 seconds
+static bvar::PassiveStatus<double> g_row_cache_hit_ratio("dingo_row_cache_hit_ratio", GetHitRatio, nullptr);
+
+RowCache::RowCache(int64_t capacity_bytes, uint32_t shard_num)
+    : shard_capacity_bytes_(capacity_bytes / std::max(shard_num, 1U)), shards_(std::max(shard_num, 1U)) {
+  for (auto& shard : shards_) {
+    bthread_mutex_init(&shard.mutex, nullptr);
+  }
+}
+
+RowCache::~RowCache() {
+  for (auto& shard : shards_) {
+    bthread_mutex_destroy(&shard.mutex);
+  }
+}
+
+RowCache& RowCache::GetInstance() {
+  static RowCache instance(FLAGS_row_cache_capacity_bytes, FLAGS_row_cache_shard_num);
+  return instance;
+}
+
+bool RowCache::IsEnabled() { return FLAGS_enable_row_cache; }
+
+std::string RowCache::CacheKey(int64_t region_id, const std::string& key) {
+  std::string cache_key;
+  cache_key.reserve(sizeof(region_id) + key.size());
+  cache_key.append(reinterpret_cast<const char*>(&region_id), sizeof(region_id));
+  cache_key.append(key);
+  return cache_key;
+}
+
+RowCache::Shard& RowCache::GetShard(const std::string& cache_key) {
+  return shards_[std::hash<std::string>{}(cache_key) % shards_.size()];
+}
+
+void RowCache::EraseEntry(Shard& shard, std::list<Entry>::iterator it) {
+  shard.bytes -= it->bytes;
+  shard.entries.erase(it->cache_key);
+  shard.lru.erase(it);
+}
+
+uint64_t RowCache::Generation(int64_t region_id, const std::string& key) {
+  auto& shard = GetShard(CacheKey(region_id, key));
+
+  BAIDU_SCOPED_LOCK(shard.mutex);
+  return shard.generation;
+}
+
+bool RowCache::Get(int64_t region_id, const std::string& key, std::string& value) {
+  auto cache_key = CacheKey(region_id, key);
+  auto& shard = GetShard(cache_key);
+
+  bool hit = false;
+  {
+    BAIDU_SCOPED_LOCK(shard.mutex);
+    auto it = shard.entries.find(cache_key);
+    if (it != shard.entries.end()) {
+      shard.lru.splice(shard.lru.begin(), shard.lru, it->second);
+      value = it->second->value;
+      hit = true;
+    }
+  }
+
+  if (hit) {
+    g_row_cache_hit_count << 1;
+    StoreBvarMetrics::GetInstance().IncRowCacheHitCount(std::to_string(region_id));
+  } else {
+    g_row_cache_miss_count << 1;
+    StoreBvarMetrics::GetInstance().IncRowCacheMissCount(std::to_string(region_id));
+  }
+
+  return hit;
+}
+
+void RowCache::Put(int64_t region_id, const std::string& key, std::string_view value, uint64_t generation) {
+  auto cache_key = CacheKey(region_id, key);
+  int64_t bytes = sizeof(Entry) + cache_key.size() * 2 + value.size();
+  if (static_cast<int64_t>(value.size()) > FLAGS_row_cache_max_value_bytes || bytes > shard_capacity_bytes_) {
+    return;
+  }
+
+  auto& shard = GetShard(cache_key);
+
+  BAIDU_SCOPED_LOCK(shard.mutex);
+
+  // written after the read, the value may be stale.
+  if (shard.generation != generation) {
+    return;
+  }
+
+  auto it = shard.entries.find(cache_key);
+  if (it != shard.entries.end()) {
+    EraseEntry(shard, it->second);
+  }
+
+  while (!shard.lru.empty() && shard.bytes + bytes > shard_capacity_bytes_) {
+    EraseEntry(shard, std::prev(shard.lru.end()));
+    g_row_cache_evict_count << 1;
+  }
+
+  shard.lru.push_front(Entry{cache_key, region_id, std::string(value), bytes});
+  shard.entries[cache_key] = shard.lru.begin();
+  shard.bytes += bytes;
+}
+
+void RowCache::Invalidate(int64_t region_id, const std::string& key) {
+  auto cache_key = CacheKey(region_id, key);
+  auto& shard = GetShard(cache_key);
+
+  BAIDU_SCOPED_LOCK(shard.mutex);
+  ++shard.generation;
+  auto it = shard.entries.find(cache_key);
+  if (it != shard.entries.end()) {
+    EraseEntry(shard, it->second);
+    g_row_cache_invalidate_count << 1;
+  }
+}
+
+void RowCache::Invalidate(int64_t region_id, const std::vector<std::string>& keys) {
+  for (const auto& key : keys) {
+    Invalidate(region_id, key);
+  }
+}
+
+void RowCache::InvalidateRegion(int64_t region_id) {
+  int64_t count = 0;
+  for (auto& shard : shards_) {
+    BAIDU_SCOPED_LOCK(shard.mutex);
+    ++shard.generation;
+    for (auto it = shard.lru.begin(); it != shard.lru.end();) {
+      if (it->region_id == region_id) {
+        auto erase_it = it++;
+        EraseEntry(shard, erase_it);
+        ++count;
+      } else {
+        ++it;
+      }
+    }
+  }
+
+  g_row_cache_invalidate_count << count;
+  DINGO_LOG(INFO) << fmt::format("[row_cache][region({})] invalidate region count({})", region_id, count);
+}
+
+int64_t RowCache::Count() {
+  int64_t count = 0;
+  for (auto& shard : shards_) {
+    BAIDU_SCOPED_LOCK(shard.mutex);
+    count += shard.lru.size();
+  }
+  return count;
+}
+
+int64_t RowCache::MemorySize() {
+  int64_t bytes = 0;
+  for (auto& shard : shards_) {
+    BAIDU_SCOPED_LOCK(shard.mutex);
+    bytes += shard.bytes;
+  }
+  return bytes;
+}
+
+}  // namespace dingodb
@@ -0,0 +1,89 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_ENGINE_ROW_CACHE_H_
+#define DINGODB_ENGINE_ROW_CACHE_H_
+
+#include <cstdint>
+#include <list>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "bthread/types.h"
+
+namespace dingodb {
+
+// Store level LRU cache of raw kv point read values of the raft store, in front of the raw engine reader.
+// It is sharded by the hash of region and key, every shard has its own lock.
+// Raft apply handlers invalidate the written keys on every peer, and the whole region when its data is changed by
+// delete range, split, merge or snapshot load.
+// A read takes the shard generation before reading the engine, and the value is only put back if no invalidation
+// happened in the shard since, so a value read before a write is never cached after the write.
+class RowCache {
+ public:
+  RowCache(int64_t capacity_bytes, uint32_t shard_num);
+  ~RowCache();
+
+  RowCache(const RowCache& rhs) = delete;
+  RowCache& operator=(const RowCache& rhs) = delete;
+  RowCache(RowCache&& rhs) = delete;
+  RowCache& operator=(RowCache&& rhs) = delete;
+
+  // Create by gflags.
+  static RowCache& GetInstance();
+
+  static bool IsEnabled();
+
+  uint64_t Generation(int64_t region_id, const std::string& key);
+
+  bool Get(int64_t region_id, const std::string& key, std::string& value);
+  void Put(int64_t region_id, const std::string& key, std::string_view value, uint64_t generation);
+
+  void Invalidate(int64_t region_id, const std::string& key);
+  void Invalidate(int64_t region_id, const std::vector<std::string>& keys);
+  void InvalidateRegion(int64_t region_id);
+
+  int64_t Count();
+  int64_t MemorySize();
+
+ private:
+  struct Entry {
+    std::string cache_key;
+    int64_t region_id;
+    std::string value;
+    int64_t bytes;
+  };
+
+  struct Shard {
+    bthread_mutex_t mutex;
+    // front is the most recently used
+    std::list<Entry> lru;
+    std::unordered_map<std::string, std::list<Entry>::iterator> entries;
+    int64_t bytes{0};
+    uint64_t generation{0};
+  };
+
+  static std::string CacheKey(int64_t region_id, const std::string& key);
+  Shard& GetShard(const std::string& cache_key);
+  static void EraseEntry(Shard& shard, std::list<Entry>::iterator it);
+
+  int64_t shard_capacity_bytes_;
+  std::vector<Shard> shards_;
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_ENGINE_ROW_CACHE_H_
@@ -17,32 +17,64 @@
 #include <cstdint>
 #include <limits>
 #include <string>
+#include <string_view>
 #include <vector>
 
+#include "bthread/bthread.h"
 #include "butil/compiler_specific.h"
 #include "butil/status.h"
 #include "common/constant.h"
 #include "common/helper.h"
 #include "common/logging.h"
+#include "common/service_access.h"
 #include "engine/raft_store_engine.h"
+#include "engine/raw_kv_ttl.h"
+#include "engine/resolved_ts.h"
+#include "engine/row_cache.h"
 #include "engine/snapshot.h"
 #include "engine/write_data.h"
 #include "fmt/core.h"
+#include "gflags/gflags.h"
 #include "meta/store_meta_manager.h"
+#include "metrics/store_metrics_manager.h"
 #include "proto/common.pb.h"
 #include "proto/error.pb.h"
 #include "proto/index.pb.h"
 #include "proto/raft.pb.h"
 #include "proto/store.pb.h"
+#include "raft/store_state_machine.h"
 #include "scan/scan.h"
 #include "scan/scan_manager.h"
 #include "server/server.h"
 #include "vector/vector_index_utils.h"
 
+namespace brpc {
+DECLARE_uint64(max_body_size);
+}  // namespace brpc
+
 namespace dingodb {
 
+DEFINE_bool(enable_leader_lease_read, false, "leader serve read only when its lease is valid");
+DEFINE_bool(enable_follower_read, false,
+            "follower serve txn read after applied the leader read index, the leader gives the read index only "
+            "while its lease is valid, so it needs raft_enable_leader_lease on all stores");
+DEFINE_int64(follower_read_wait_apply_timeout_ms, 1000, "follower read wait apply to read index timeout ms");
+DEFINE_bool(enable_vector_write_coalesce, false, "coalesce concurrent vector add/delete of region into one raft entry");
+DEFINE_int64(vector_write_coalesce_max_count, 32, "max request count of one coalesced vector write");
+DEFINE_int64(vector_write_coalesce_max_bytes, 0,
+             "max bytes of one coalesced vector write, 0 is half of brpc max_body_size which bounds a raft entry");
+DECLARE_bool(enable_region_incremental_key_count);
+
 Storage::Storage(std::shared_ptr<Engine> raft_engine, std::shared_ptr<Engine> mono_engine)
-    : raft_engine_(raft_engine), mono_engine_(mono_engine) {}
+    : raft_engine_(raft_engine), mono_engine_(mono_engine), vector_search_cache_(VectorSearchCache::New()) {
+  vector_write_coalescer_ = std::make_shared<RegionWriteCoalescer>(
+      [raft_engine](std::shared_ptr<Context> ctx, std::shared_ptr<WriteData> write_data) {
+        return raft_engine->Write(ctx, write_data);
+      },
+      FLAGS_vector_write_coalesce_max_count,
+      FLAGS_vector_write_coalesce_max_bytes > 0 ? FLAGS_vector_write_coalesce_max_bytes
+                                                : static_cast<int64_t>(brpc::FLAGS_max_body_size / 2));
+}
 
 std::shared_ptr<RaftStoreEngine> Storage::GetRaftStoreEngine() {
   return std::dynamic_pointer_cast<RaftStoreEngine>(raft_engine_);
@@ -169,6 +201,93 @@ butil::Status Storage::ValidateLeader(store::RegionPtr region) {
   return butil::Status();
 }
 
+// Get the committed index from leader as read index, then wait local state machine apply to it.
+static butil::Status WaitFollowerReadIndex(int64_t region_id, std::shared_ptr<RaftNode> node) {
+  auto leader_id = node->GetLeaderId();
+  if (leader_id.is_empty()) {
+    return butil::Status(pb::error::ERAFT_NOTLEADER, "");
+  }
+
+  auto state_machine = std::dynamic_pointer_cast<StoreStateMachine>(node->GetStateMachine());
+  if (state_machine == nullptr) {
+    return butil::Status(pb::error::EINTERNAL, "Not store state machine");
+  }
+
+  int64_t read_index = 0;
+  auto status =
+      ServiceAccess::GetReadIndex(region_id, leader_id.addr, FLAGS_follower_read_wait_apply_timeout_ms, read_index);
+  if (!status.ok()) {
+    return butil::Status(pb::error::ERAFT_NOTLEADER, leader_id.to_string());
+  }
+
+  if (!state_machine->WaitReadableIndex(read_index, FLAGS_follower_read_wait_apply_timeout_ms)) {
+    DINGO_LOG(WARNING) << fmt::format(
+        "[storage][region({})] follower read wait apply timeout, read_index({}) applied_index({})", region_id,
+        read_index, state_machine->GetAppliedIndex());
+    return butil::Status(pb::error::ERAFT_NOTLEADER, leader_id.to_string());
+  }
+
+  return butil::Status();
+}
+
+butil::Status Storage::ValidateLeaderRead(int64_t region_id, bool allow_follower_read, int64_t start_ts) {
+  allow_follower_read = allow_follower_read && FLAGS_enable_follower_read;
+  bool use_resolved_ts = start_ts > 0 && RegionResolvedTs::IsEnabled();
+  if (!FLAGS_enable_leader_lease_read && !allow_follower_read && !use_resolved_ts) {
+    return ValidateLeader(region_id);
+  }
+
+  auto region = Server::GetInstance().GetRegion(region_id);
+  if (region == nullptr) {
+    return butil::Status(pb::error::EREGION_NOT_FOUND, "Not found region");
+  }
+
+  if (region->GetStoreEngineType() != pb::common::STORE_ENG_RAFT_STORE) {
+    return butil::Status();
+  }
+
+  // txn read not greater than resolved ts, every replica has applied the visible data and no lock conflict
+  if (use_resolved_ts && RegionResolvedTs::GetInstance().IsResolved(region_id, start_ts)) {
+    return butil::Status();
+  }
+
+  auto raft_kv_engine = std::dynamic_pointer_cast<RaftStoreEngine>(raft_engine_);
+  auto node = raft_kv_engine->GetNode(region_id);
+  if (node == nullptr) {
+    return butil::Status(pb::error::ERAFT_NOT_FOUND, "Not found region");
+  }
+
+  if (node->IsLeader()) {
+    if (FLAGS_enable_leader_lease_read && !node->IsLeaderLeaseValid()) {
+      return butil::Status(pb::error::ERAFT_NOTLEADER, node->GetLeaderId().to_string());
+    }
+    return butil::Status();
+  }
+
+  if (!allow_follower_read) {
+    return butil::Status(pb::error::ERAFT_NOTLEADER, node->GetLeaderId().to_string());
+  }
+
+  return WaitFollowerReadIndex(region_id, node);
+}
+
+butil::Status Storage::ReadIndex(int64_t region_id) {
+  auto raft_kv_engine = std::dynamic_pointer_cast<RaftStoreEngine>(raft_engine_);
+  auto node = raft_kv_engine->GetNode(region_id);
+  if (node == nullptr) {
+    return butil::Status(pb::error::ERAFT_NOT_FOUND, "Not found raft node");
+  }
+
+  if (node->IsLeader()) {
+    if (!node->IsLeaderLeaseValid()) {
+      return butil::Status(pb::error::ERAFT_NOTLEADER, node->GetLeaderId().to_string());
+    }
+    return butil::Status();
+  }
+
+  return WaitFollowerReadIndex(region_id, node);
+}
+
 bool Storage::IsLeader(int64_t region_id) {
   auto region = Server::GetInstance().GetRegion(region_id);
   if (region == nullptr) {
@@ -200,7 +319,7 @@ bool Storage::IsLeader(store::RegionPtr region) {
 
 butil::Status Storage::KvGet(std::shared_ptr<Context> ctx, const std::vector<std::string>& keys,
                              std::vector<pb::common::KeyValue>& kvs) {
-  auto status = ValidateLeader(ctx->RegionId());
+  auto status = ValidateLeaderRead(ctx->RegionId());
   if (!status.ok()) {
     return status;
   }
@@ -210,33 +329,122 @@ butil::Status Storage::KvGet(std::shared_ptr<Context> ctx, const std::vector<std
     return butil::Status(pb::error::EENGINE_NOT_FOUND, "reader is nullptr");
   }
 
-  for (const auto& key : keys) {
-    std::string value;
-    auto status = reader->KvGet(ctx, key, value);
+  bool use_row_cache = IsUseRowCache(ctx);
+  std::vector<std::string> values(keys.size());
+  std::vector<bool> exists(keys.size(), false);
+
+  // hit keys are served from row cache, the rest are read by one multi get.
+  std::vector<size_t> miss_positions;
+  std::vector<std::string> miss_keys;
+  std::vector<uint64_t> generations;
+  for (size_t i = 0; i < keys.size(); ++i) {
+    if (use_row_cache && RowCache::GetInstance().Get(ctx->RegionId(), keys[i], values[i])) {
+      exists[i] = true;
+      continue;
+    }
+    if (use_row_cache) {
+      generations.push_back(RowCache::GetInstance().Generation(ctx->RegionId(), keys[i]));
+    }
+    miss_positions.push_back(i);
+    miss_keys.push_back(keys[i]);
+  }
+
+  if (!miss_keys.empty()) {
+    std::vector<std::string> miss_values;
+    std::vector<bool> miss_exists;
+    status = reader->KvMultiGet(ctx, miss_keys, miss_values, miss_exists);
     if (!status.ok()) {
-      if (pb::error::EKEY_NOT_FOUND == status.error_code()) {
-        continue;
-      }
       kvs.clear();
       return status;
     }
 
+    for (size_t i = 0; i < miss_keys.size(); ++i) {
+      if (!miss_exists[i]) {
+        continue;
+      }
+      if (use_row_cache) {
+        RowCache::GetInstance().Put(ctx->RegionId(), miss_keys[i], miss_values[i], generations[i]);
+      }
+      values[miss_positions[i]] = std::move(miss_values[i]);
+      exists[miss_positions[i]] = true;
+    }
+  }
+
+  for (size_t i = 0; i < keys.size(); ++i) {
+    if (!exists[i]) {
+      continue;
+    }
+
     pb::common::KeyValue kv;
-    kv.set_key(key);
-    kv.set_value(value);
-    kvs.emplace_back(kv);
+    kv.set_key(keys[i]);
+    kv.set_value(std::move(values[i]));
+    kvs.emplace_back(std::move(kv));
   }
 
   return butil::Status();
 }
 
-butil::Status Storage::KvPut(std::shared_ptr<Context> ctx, const std::vector<pb::common::KeyValue>& kvs) {
+butil::Status Storage::KvGetPinned(std::shared_ptr<Context> ctx, const std::string& key, const ValueVisitor& visitor) {
+  auto status = ValidateLeaderRead(ctx->RegionId());
+  if (!status.ok()) {
+    return status;
+  }
+
+  auto reader = GetEngineReader(ctx->StoreEngineType(), ctx->RawEngineType());
+  if (reader == nullptr) {
+    return butil::Status(pb::error::EENGINE_NOT_FOUND, "reader is nullptr");
+  }
+
+  if (!IsUseRowCache(ctx)) {
+    status = reader->KvGetPinned(ctx, key, visitor);
+    if (!status.ok() && status.error_code() != pb::error::EKEY_NOT_FOUND) {
+      return status;
+    }
+
+    return butil::Status();
+  }
+
+  std::string value;
+  if (RowCache::GetInstance().Get(ctx->RegionId(), key, value)) {
+    visitor(value);
+    return butil::Status();
+  }
+
+  uint64_t generation = RowCache::GetInstance().Generation(ctx->RegionId(), key);
+  status = reader->KvGetPinned(ctx, key, [&](std::string_view pinned_value) {
+    RowCache::GetInstance().Put(ctx->RegionId(), key, pinned_value, generation);
+    visitor(pinned_value);
+  });
+  if (!status.ok() && status.error_code() != pb::error::EKEY_NOT_FOUND) {
+    return status;
+  }
+
+  return butil::Status();
+}
+
+// Row cache is invalidated by raft apply, only for raw kv of raft store.
+// The cached value doesn't expire, so the region with ttl doesn't use row cache.
+static bool IsTtlRegion(int64_t region_id) {
+  if (!RawKvTtl::GetInstance().IsEnabled()) {
+    return false;
+  }
+
+  auto region = Server::GetInstance().GetRegion(region_id);
+  return region == nullptr || RawKvTtl::GetInstance().GetTtl(Constant::kStoreDataCF, region->Range().start_key()) > 0;
+}
+
+bool Storage::IsUseRowCache(std::shared_ptr<Context> ctx) {
+  return RowCache::IsEnabled() && ctx->StoreEngineType() == pb::common::STORE_ENG_RAFT_STORE &&
+         ctx->CfName() == Constant::kStoreDataCF && !IsTtlRegion(ctx->RegionId());
+}
+
+butil::Status Storage::KvPut(std::shared_ptr<Context> ctx, std::vector<pb::common::KeyValue>&& kvs) {
   auto writer = GetEngineWriter(ctx->StoreEngineType(), ctx->RawEngineType());
   if (writer == nullptr) {
     return butil::Status(pb::error::EENGINE_NOT_FOUND, "writer is nullptr");
   }
 
-  auto status = writer->KvPut(ctx, kvs);
+  auto status = writer->KvPut(ctx, std::move(kvs));
   if (!status.ok()) {
     return status;
   }
@@ -308,7 +516,7 @@ butil::Status Storage::KvScanBegin(std::shared_ptr<Context> ctx, const std::stri
                                    bool disable_auto_release, bool disable_coprocessor,
                                    const pb::store::Coprocessor& coprocessor, std::string* scan_id,
                                    std::vector<pb::common::KeyValue>* kvs) {
-  auto status = ValidateLeader(ctx->RegionId());
+  auto status = ValidateLeaderRead(ctx->RegionId());
   if (!status.ok()) {
     return status;
   }
@@ -393,7 +601,7 @@ butil::Status Storage::KvScanBeginV2(std::shared_ptr<Context> ctx, const std::st
                                      bool disable_auto_release, bool disable_coprocessor,
                                      const pb::common::CoprocessorV2& coprocessor, int64_t scan_id,
                                      std::vector<pb::common::KeyValue>* kvs) {
-  auto status = ValidateLeader(ctx->RegionId());
+  auto status = ValidateLeaderRead(ctx->RegionId());
   if (!status.ok()) {
     return status;
   }
@@ -475,13 +683,21 @@ butil::Status Storage::KvScanReleaseV2(std::shared_ptr<Context> /*ctx*/, int64_t
 }
 
 butil::Status Storage::VectorAdd(std::shared_ptr<Context> ctx, bool is_sync,
-                                 const std::vector<pb::common::VectorWithId>& vectors, bool is_update) {
+                                 std::vector<pb::common::VectorWithId>&& vectors, bool is_update) {
   if (BAIDU_LIKELY(ctx->StoreEngineType() == pb::common::StorageEngine::STORE_ENG_RAFT_STORE)) {
     if (is_sync) {
-      return raft_engine_->Write(ctx, WriteDataBuilder::BuildWrite(ctx->CfName(), vectors, is_update));
+      if (FLAGS_enable_vector_write_coalesce) {
+        int64_t bytes = 0;
+        for (const auto& vector : vectors) {
+          bytes += vector.ByteSizeLong();
+        }
+        auto write_data = WriteDataBuilder::BuildWrite(ctx->CfName(), std::move(vectors), is_update);
+        return vector_write_coalescer_->Write(ctx, write_data->Datums().front(), bytes);
+      }
+      return raft_engine_->Write(ctx, WriteDataBuilder::BuildWrite(ctx->CfName(), std::move(vectors), is_update));
     }
 
-    return raft_engine_->AsyncWrite(ctx, WriteDataBuilder::BuildWrite(ctx->CfName(), vectors, is_update),
+    return raft_engine_->AsyncWrite(ctx, WriteDataBuilder::BuildWrite(ctx->CfName(), std::move(vectors), is_update),
                                     [](std::shared_ptr<Context> ctx, butil::Status status) {
                                       if (!status.ok()) {
                                         Helper::SetPbMessageError(status, ctx->Response());
@@ -489,10 +705,10 @@ butil::Status Storage::VectorAdd(std::shared_ptr<Context> ctx, bool is_sync,
                                     });
   } else if (ctx->StoreEngineType() == pb::common::StorageEngine::STORE_ENG_MONO_STORE) {
     if (is_sync) {
-      return mono_engine_->Write(ctx, WriteDataBuilder::BuildWrite(ctx->CfName(), vectors, is_update));
+      return mono_engine_->Write(ctx, WriteDataBuilder::BuildWrite(ctx->CfName(), std::move(vectors), is_update));
     }
 
-    return mono_engine_->AsyncWrite(ctx, WriteDataBuilder::BuildWrite(ctx->CfName(), vectors, is_update),
+    return mono_engine_->AsyncWrite(ctx, WriteDataBuilder::BuildWrite(ctx->CfName(), std::move(vectors), is_update),
                                     [](std::shared_ptr<Context> ctx, butil::Status status) {
                                       if (!status.ok()) {
                                         Helper::SetPbMessageError(status, ctx->Response());
@@ -506,6 +722,10 @@ butil::Status Storage::VectorAdd(std::shared_ptr<Context> ctx, bool is_sync,
 butil::Status Storage::VectorDelete(std::shared_ptr<Context> ctx, bool is_sync, const std::vector<int64_t>& ids) {
   if (BAIDU_LIKELY(ctx->StoreEngineType() == pb::common::StorageEngine::STORE_ENG_RAFT_STORE)) {
     if (is_sync) {
+      if (FLAGS_enable_vector_write_coalesce) {
+        auto write_data = WriteDataBuilder::BuildWrite(ctx->CfName(), ids);
+        return vector_write_coalescer_->Write(ctx, write_data->Datums().front(), ids.size() * sizeof(int64_t));
+      }
       return raft_engine_->Write(ctx, WriteDataBuilder::BuildWrite(ctx->CfName(), ids));
     }
 
@@ -570,6 +790,18 @@ butil::Status Storage::VectorBatchSearch(std::shared_ptr<Engine::VectorReader::C
     return butil::Status(pb::error::EENGINE_NOT_FOUND, "vector reader is nullptr");
   }
 
+  // read version before search, then a write applied meanwhile makes the entry stale rather than lost.
+  VectorSearchCache::Version cache_version;
+  std::string cache_fingerprint;
+  bool use_cache = GetVectorSearchCacheVersion(ctx, cache_version);
+  if (use_cache) {
+    cache_fingerprint =
+        VectorSearchCache::Fingerprint(ctx->region_id, ctx->region_range, ctx->vector_with_ids, ctx->parameter);
+    if (vector_search_cache_->Get(cache_fingerprint, cache_version, results)) {
+      return butil::Status();
+    }
+  }
+
   status = vector_reader->VectorBatchSearch(ctx, results);
   if (!status.ok()) {
     if (pb::error::EKEY_NOT_FOUND == status.error_code()) {
@@ -580,9 +812,36 @@ butil::Status Storage::VectorBatchSearch(std::shared_ptr<Engine::VectorReader::C
     return status;
   }
 
+  if (use_cache) {
+    vector_search_cache_->Put(cache_fingerprint, cache_version, results);
+  }
+
   return butil::Status();
 }
 
+bool Storage::GetVectorSearchCacheVersion(std::shared_ptr<Engine::VectorReader::Context> ctx,
+                                          VectorSearchCache::Version& version) {
+  // mono store not track apply log id
+  if (ctx->store_engine_type != pb::common::STORE_ENG_RAFT_STORE || ctx->vector_index == nullptr) {
+    return false;
+  }
+
+  auto region = Server::GetInstance().GetRegion(ctx->region_id);
+  if (region == nullptr || !vector_search_cache_->IsEnabled(region->Definition().index_id())) {
+    return false;
+  }
+
+  auto raft_meta = Server::GetInstance().GetRaftMeta(ctx->region_id);
+  if (raft_meta == nullptr) {
+    return false;
+  }
+
+  version.region_apply_log_id = raft_meta->AppliedId();
+  version.vector_index_apply_log_id = ctx->vector_index->ApplyLogId();
+
+  return true;
+}
+
 butil::Status Storage::VectorGetBorderId(store::RegionPtr region, bool get_min, int64_t& vector_id) {
   auto status = ValidateLeader(region);
   if (!status.ok()) {
@@ -645,12 +904,30 @@ butil::Status Storage::VectorGetRegionMetrics(store::RegionPtr region, VectorInd
   return butil::Status();
 }
 
+// The key count of the whole region is maintained in raft apply, see RegionMetrics::AddKeyCountDelta.
+static bool GetRegionTrustedKeyCount(store::RegionPtr region, const pb::common::Range& range, int64_t& count) {
+  if (!FLAGS_enable_region_incremental_key_count || region->GetStoreEngineType() != pb::common::STORE_ENG_RAFT_STORE) {
+    return false;
+  }
+  if (range.start_key() != region->Range().start_key() || range.end_key() != region->Range().end_key()) {
+    return false;
+  }
+
+  auto store_region_metrics = Server::GetInstance().GetStoreMetricsManager()->GetStoreRegionMetrics();
+  auto region_metrics = store_region_metrics->GetMetrics(region->Id());
+  return region_metrics != nullptr && region_metrics->GetTrustedKeyCount(count);
+}
+
 butil::Status Storage::VectorCount(store::RegionPtr region, pb::common::Range range, int64_t& count) {
   auto status = ValidateLeader(region);
   if (!status.ok()) {
     return status;
   }
 
+  if (GetRegionTrustedKeyCount(region, range, count)) {
+    return butil::Status();
+  }
+
   auto vector_reader = GetEngineVectorReader(region->GetStoreEngineType(), region->GetRawEngineType());
   if (!vector_reader) {
     DINGO_LOG(ERROR) << fmt::format("vector reader is nullptr, region_id : {}", region->Id());
@@ -668,7 +945,8 @@ butil::Status Storage::VectorCount(store::RegionPtr region, pb::common::Range ra
 butil::Status Storage::VectorCalcDistance(const ::dingodb::pb::index::VectorCalcDistanceRequest& request,
                                           std::vector<std::vector<float>>& distances,
                                           std::vector<::dingodb::pb::common::Vector>& result_op_left_vectors,
-                                          std::vector<::dingodb::pb::common::Vector>& result_op_right_vectors) {
+                                          std::vector<::dingodb::pb::common::Vector>& result_op_right_vectors,
+                                          uint32_t topk, std::vector<std::vector<uint32_t>>* topk_indexes) {
   // param check
   auto algorithm_type = request.algorithm_type();
   auto metric_type = request.metric_type();
@@ -732,7 +1010,8 @@ butil::Status Storage::VectorCalcDistance(const ::dingodb::pb::index::VectorCalc
     return status;
   }
 
-  status = VectorIndexUtils::CalcDistanceEntry(request, distances, result_op_left_vectors, result_op_right_vectors);
+  status = VectorIndexUtils::CalcDistanceEntry(request, distances, result_op_left_vectors, result_op_right_vectors,
+                                               topk, Server::GetInstance().GetVectorIndexThreadPool(), topk_indexes);
   if (!status.ok()) {
     DINGO_LOG(ERROR) << fmt::format("VectorIndexUtils::CalcDistanceEntry failed : {}", status.error_cstr());
   }
@@ -772,13 +1051,13 @@ butil::Status Storage::VectorBatchSearchDebug(std::shared_ptr<Engine::VectorRead
 // document
 
 butil::Status Storage::DocumentAdd(std::shared_ptr<Context> ctx, bool is_sync,
-                                   const std::vector<pb::common::DocumentWithId>& documents, bool is_update) {
+                                   std::vector<pb::common::DocumentWithId>&& documents, bool is_update) {
   if (BAIDU_LIKELY(ctx->StoreEngineType() == pb::common::StorageEngine::STORE_ENG_RAFT_STORE)) {
     if (is_sync) {
-      return raft_engine_->Write(ctx, WriteDataBuilder::BuildWrite(ctx->CfName(), documents, is_update));
+      return raft_engine_->Write(ctx, WriteDataBuilder::BuildWrite(ctx->CfName(), std::move(documents), is_update));
     }
 
-    return raft_engine_->AsyncWrite(ctx, WriteDataBuilder::BuildWrite(ctx->CfName(), documents, is_update),
+    return raft_engine_->AsyncWrite(ctx, WriteDataBuilder::BuildWrite(ctx->CfName(), std::move(documents), is_update),
                                     [](std::shared_ptr<Context> ctx, butil::Status status) {
                                       if (!status.ok()) {
                                         Helper::SetPbMessageError(status, ctx->Response());
@@ -786,10 +1065,10 @@ butil::Status Storage::DocumentAdd(std::shared_ptr<Context> ctx, bool is_sync,
                                     });
   } else if (ctx->StoreEngineType() == pb::common::StorageEngine::STORE_ENG_MONO_STORE) {
     if (is_sync) {
-      return mono_engine_->Write(ctx, WriteDataBuilder::BuildWrite(ctx->CfName(), documents, is_update));
+      return mono_engine_->Write(ctx, WriteDataBuilder::BuildWrite(ctx->CfName(), std::move(documents), is_update));
     }
 
-    return mono_engine_->AsyncWrite(ctx, WriteDataBuilder::BuildWrite(ctx->CfName(), documents, is_update),
+    return mono_engine_->AsyncWrite(ctx, WriteDataBuilder::BuildWrite(ctx->CfName(), std::move(documents), is_update),
                                     [](std::shared_ptr<Context> ctx, butil::Status status) {
                                       if (!status.ok()) {
                                         Helper::SetPbMessageError(status, ctx->Response());
@@ -949,6 +1228,10 @@ butil::Status Storage::DocumentCount(store::RegionPtr region, pb::common::Range
     return status;
   }
 
+  if (GetRegionTrustedKeyCount(region, range, count)) {
+    return butil::Status();
+  }
+
   auto vector_reader = GetEngineDocumentReader(region->GetStoreEngineType(), region->GetRawEngineType());
   if (!vector_reader) {
     DINGO_LOG(ERROR) << fmt::format("vector reader is nullptr, region_id : {}", region->Id());
@@ -968,7 +1251,7 @@ butil::Status Storage::DocumentCount(store::RegionPtr region, pb::common::Range
 butil::Status Storage::TxnBatchGet(std::shared_ptr<Context> ctx, int64_t start_ts, const std::vector<std::string>& keys,
                                    const std::set<int64_t>& resolved_locks, pb::store::TxnResultInfo& txn_result_info,
                                    std::vector<pb::common::KeyValue>& kvs) {
-  auto status = ValidateLeader(ctx->RegionId());
+  auto status = ValidateLeaderRead(ctx->RegionId(), true, start_ts);
   if (!status.ok()) {
     return status;
   }
@@ -1001,7 +1284,7 @@ butil::Status Storage::TxnScan(std::shared_ptr<Context> ctx, int64_t start_ts, c
                                pb::store::TxnResultInfo& txn_result_info, std::vector<pb::common::KeyValue>& kvs,
                                bool& has_more, std::string& end_scan_key, bool disable_coprocessor,
                                const pb::common::CoprocessorV2& coprocessor) {
-  auto status = ValidateLeader(ctx->RegionId());
+  auto status = ValidateLeaderRead(ctx->RegionId(), true, start_ts);
   if (!status.ok()) {
     return status;
   }
@@ -25,8 +25,10 @@
 #include "engine/engine.h"
 #include "engine/raft_store_engine.h"
 #include "engine/raw_engine.h"
+#include "engine/write_coalescer.h"
 #include "proto/common.pb.h"
 #include "proto/store.pb.h"
+#include "vector/vector_search_cache.h"
 
 namespace dingodb {
 
@@ -57,6 +59,8 @@ class Storage {
   // kv read
   butil::Status KvGet(std::shared_ptr<Context> ctx, const std::vector<std::string>& keys,
                       std::vector<pb::common::KeyValue>& kvs);
+  // Single key get without copy, visitor is not called when key not found.
+  butil::Status KvGetPinned(std::shared_ptr<Context> ctx, const std::string& key, const ValueVisitor& visitor);
 
   butil::Status KvScanBegin(std::shared_ptr<Context> ctx, const std::string& cf_name, int64_t region_id,
                             const pb::common::Range& range, int64_t max_fetch_cnt, bool key_only,
@@ -81,7 +85,7 @@ class Storage {
   static butil::Status KvScanReleaseV2(std::shared_ptr<Context> ctx, int64_t scan_id);
 
   // kv write
-  butil::Status KvPut(std::shared_ptr<Context> ctx, const std::vector<pb::common::KeyValue>& kvs);
+  butil::Status KvPut(std::shared_ptr<Context> ctx, std::vector<pb::common::KeyValue>&& kvs);
 
   butil::Status KvPutIfAbsent(std::shared_ptr<Context> ctx, const std::vector<pb::common::KeyValue>& kvs,
                               bool is_atomic, std::vector<bool>& key_states);
@@ -139,7 +143,7 @@ class Storage {
 
   // vector index
   butil::Status VectorAdd(std::shared_ptr<Context> ctx, bool is_sync,
-                          const std::vector<pb::common::VectorWithId>& vectors, bool is_update);
+                          std::vector<pb::common::VectorWithId>&& vectors, bool is_update);
   butil::Status VectorDelete(std::shared_ptr<Context> ctx, bool is_sync, const std::vector<int64_t>& ids);
 
   butil::Status VectorBatchQuery(std::shared_ptr<Engine::VectorReader::Context> ctx,
@@ -154,11 +158,13 @@ class Storage {
 
   butil::Status VectorCount(store::RegionPtr region, pb::common::Range range, int64_t& count);
 
+  // topk > 0 keeps the topk nearest right vectors of every left vector, their positions are set to topk_indexes.
   static butil::Status VectorCalcDistance(
       const ::dingodb::pb::index::VectorCalcDistanceRequest& request,
-      std::vector<std::vector<float>>& distances,                            // NOLINT
-      std::vector<::dingodb::pb::common::Vector>& result_op_left_vectors,    // NOLINT
-      std::vector<::dingodb::pb::common::Vector>& result_op_right_vectors);  // NOLINT
+      std::vector<std::vector<float>>& distances,                           // NOLINT
+      std::vector<::dingodb::pb::common::Vector>& result_op_left_vectors,   // NOLINT
+      std::vector<::dingodb::pb::common::Vector>& result_op_right_vectors,  // NOLINT
+      uint32_t topk = 0, std::vector<std::vector<uint32_t>>* topk_indexes = nullptr);
 
   // This function is for testing only
   butil::Status VectorBatchSearchDebug(std::shared_ptr<Engine::VectorReader::Context> ctx,
@@ -168,7 +174,7 @@ class Storage {
 
   // document index
   butil::Status DocumentAdd(std::shared_ptr<Context> ctx, bool is_sync,
-                            const std::vector<pb::common::DocumentWithId>& documents, bool is_update);
+                            std::vector<pb::common::DocumentWithId>&& documents, bool is_update);
   butil::Status DocumentDelete(std::shared_ptr<Context> ctx, bool is_sync, const std::vector<int64_t>& ids);
 
   butil::Status DocumentBatchQuery(std::shared_ptr<Engine::DocumentReader::Context> ctx,
@@ -186,6 +192,12 @@ class Storage {
   // common functions
   butil::Status ValidateLeader(int64_t region_id);
   butil::Status ValidateLeader(store::RegionPtr region);
+  // Validate the region can serve local read, leader with valid lease when enable lease read,
+  // or follower which applied the leader read index when allow follower read,
+  // or any replica when txn start_ts not greater than the region resolved ts.
+  butil::Status ValidateLeaderRead(int64_t region_id, bool allow_follower_read = false, int64_t start_ts = 0);
+  // Wait this replica applied to the leader committed index, leader check its lease.
+  butil::Status ReadIndex(int64_t region_id);
   bool IsLeader(int64_t region_id);
   bool IsLeader(store::RegionPtr region);
 
@@ -196,8 +208,19 @@ class Storage {
                             const std::vector<pb::raft::LogEntry>& entries);
 
  private:
+  static bool IsUseRowCache(std::shared_ptr<Context> ctx);
+
+  // Get the result cache version of region, return false if the search should not use cache.
+  bool GetVectorSearchCacheVersion(std::shared_ptr<Engine::VectorReader::Context> ctx,
+                                   VectorSearchCache::Version& version);
+
   std::shared_ptr<Engine> raft_engine_;
   std::shared_ptr<Engine> mono_engine_;
+
+  VectorSearchCachePtr vector_search_cache_;
+
+  // coalesce concurrent sync vector add/delete of region
+  RegionWriteCoalescerPtr vector_write_coalescer_;
 };
 
 using StoragePtr = std::shared_ptr<Storage>;
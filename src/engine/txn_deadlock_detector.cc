@@ -0,0 +1,97 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "engine/txn_deadlock_detector.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <vector>
+
+namespace dingodb {
+
+bool TxnDeadlockDetector::AddEdge(int64_t waiter_ts, int64_t holder_ts, std::vector<int64_t>& cycle) {
+  cycle.clear();
+
+  // search the path holder -> ... -> waiter
+  std::map<int64_t, int64_t> parents{{holder_ts, holder_ts}};
+  std::vector<int64_t> stack{holder_ts};
+  bool found = holder_ts == waiter_ts;
+  while (!found && !stack.empty()) {
+    int64_t ts = stack.back();
+    stack.pop_back();
+
+    auto it = edges_.find(ts);
+    if (it == edges_.end()) {
+      continue;
+    }
+    for (const auto& [next_ts, count] : it->second) {
+      if (!parents.emplace(next_ts, ts).second) {
+        continue;
+      }
+      if (next_ts == waiter_ts) {
+        found = true;
+        break;
+      }
+      stack.push_back(next_ts);
+    }
+  }
+
+  if (found) {
+    for (int64_t ts = waiter_ts; ts != holder_ts; ts = parents[ts]) {
+      cycle.push_back(ts);
+    }
+    cycle.push_back(holder_ts);
+    // waiter, holder, ..., in wait order
+    std::reverse(cycle.begin() + 1, cycle.end());
+    return false;
+  }
+
+  ++edges_[waiter_ts][holder_ts];
+  return true;
+}
+
+void TxnDeadlockDetector::RemoveEdge(int64_t waiter_ts, int64_t holder_ts) {
+  auto it = edges_.find(waiter_ts);
+  if (it == edges_.end()) {
+    return;
+  }
+
+  auto holder_it = it->second.find(holder_ts);
+  if (holder_it == it->second.end()) {
+    return;
+  }
+
+  if (--holder_it->second <= 0) {
+    it->second.erase(holder_it);
+    if (it->second.empty()) {
+      edges_.erase(it);
+    }
+  }
+}
+
+int64_t TxnDeadlockDetector::ChooseVictim(const std::vector<int64_t>& cycle) {
+  return cycle.empty() ? 0 : *std::max_element(cycle.begin(), cycle.end());
+}
+
+int64_t TxnDeadlockDetector::EdgeCount() const {
+  int64_t count = 0;
+  for (const auto& [waiter_ts, holders] : edges_) {
+    count += holders.size();
+  }
+  return count;
+}
+
+}  // namespace dingodb
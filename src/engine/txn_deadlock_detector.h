@@ -0,0 +1,53 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef DINGODB_ENGINE_TXN_DEADLOCK_DETECTOR_H_
+#define DINGODB_ENGINE_TXN_DEADLOCK_DETECTOR_H_
+
+#include <cstdint>
+#include <map>
+#include <vector>
+
+namespace dingodb {
+
+// Wait-for graph of txns, the vertex is txn start_ts, the edge waiter -> holder means the waiter waits for a lock of
+// the holder. The graph is kept acyclic: adding an edge only searches the paths from the holder, an edge which closes
+// a cycle is refused and the cycle is returned, the caller aborts a victim of the cycle and may add it again.
+// It is not thread safe.
+class TxnDeadlockDetector {
+ public:
+  TxnDeadlockDetector() = default;
+  ~TxnDeadlockDetector() = default;
+
+  TxnDeadlockDetector(const TxnDeadlockDetector& rhs) = delete;
+  TxnDeadlockDetector& operator=(const TxnDeadlockDetector& rhs) = delete;
+
+  // Return false if the edge closes a cycle, cycle is the txns in wait order which begins with waiter_ts.
+  bool AddEdge(int64_t waiter_ts, int64_t holder_ts, std::vector<int64_t>& cycle);
+  void RemoveEdge(int64_t waiter_ts, int64_t holder_ts);
+
+  // The youngest txn, i.e. the biggest start_ts, has done the least work.
+  static int64_t ChooseVictim(const std::vector<int64_t>& cycle);
+
+  int64_t EdgeCount() const;
+
+ private:
+  // waiter -> holder -> count, a txn may wait for the same holder by several requests
+  std::map<int64_t, std::map<int64_t, int64_t>> edges_;
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_ENGINE_TXN_DEADLOCK_DETECTOR_H_
@@ -15,10 +15,14 @@
 #include "engine/txn_engine_helper.h"
 
 #include <algorithm>
+#include <atomic>
 #include <cerrno>
 #include <cstdint>
+#include <functional>
 #include <map>
 #include <memory>
+#include <numeric>
+#include <set>
 #include <string>
 #include <string_view>
 #include <utility>
@@ -27,11 +31,23 @@
 #include "butil/compiler_specific.h"
 #include "butil/status.h"
 #include "bvar/latency_recorder.h"
+#include "bvar/reducer.h"
 #include "common/constant.h"
 #include "common/helper.h"
 #include "common/logging.h"
+#include "common/synchronization.h"
+#include "coordinator/tso_batcher.h"
+#include "coordinator/tso_control.h"
+#include "coordinator/tso_proxy.h"
 #include "coprocessor/coprocessor_v2.h"
 #include "document/codec.h"
+#include "engine/change_capture.h"
+#include "engine/pessimistic_lock_table.h"
+#include "engine/resolved_ts.h"
+#include "engine/rocks_raw_engine.h"
+#include "engine/txn_gc_compaction_filter.h"
+#include "engine/txn_lock_index.h"
+#include "engine/txn_one_pc_keys.h"
 #include "fmt/core.h"
 #include "meta/store_meta_manager.h"
 #include "proto/common.pb.h"
@@ -48,13 +64,31 @@ DEFINE_int64(max_batch_get_count, 4096, "max batch get count");
 DEFINE_int64(max_batch_get_memory_size, 60 * 1024 * 1024, "max batch get memory size");
 DEFINE_int64(max_scan_memory_size, 60 * 1024 * 1024, "max scan memory size");
 DEFINE_int64(max_scan_line_limit, 40960, "max scan line limit");
+DEFINE_int64(txn_scan_long_scan_min_limit, 4096,
+             "txn scan limit not less than it or with coprocessor use long scan iterator prefetch");
+DEFINE_int32(txn_scan_parallel_concurrency, 1,
+             "long txn scan without coprocessor split range to scan concurrently, <=1 means sequential");
+DEFINE_int64(txn_scan_parallel_min_size, 64 * 1024 * 1024,
+             "min approximate write cf size of range to enable parallel txn scan");
 DEFINE_int64(max_scan_lock_limit, 40960, "Max scan lock limit");
+DEFINE_int64(txn_lock_index_scan_max_keys, 4096,
+             "max keys of lock index read by a scan lock, a wider ts range scans the lock cf instead");
 DEFINE_int64(max_prewrite_count, 4096, "max prewrite count");
 DEFINE_int64(max_commit_count, 4096, "max commit count");
 DEFINE_int64(max_rollback_count, 4096, "max rollback count");
 DEFINE_int64(max_resolve_count, 4096, "max rollback count");
 DEFINE_int64(max_pessimistic_count, 4096, "max pessimistic count");
+DEFINE_int64(txn_prewrite_max_raft_entry_size, 0,
+             "split the prewrite of large transaction into raft entries not larger than it, 0 disable");
+DEFINE_bool(enable_txn_one_pc, false,
+            "enable one phase commit for the txn which all mutations in one region, prewrite with try_one_pc is "
+            "rejected when disabled, so a successful one is always committed");
 DEFINE_int64(gc_delete_batch_count, 32768, "gc delete batch count");
+DEFINE_int64(store_tso_batch_max_count, 1024, "max count of the concurrent tso waiters coalesced into one request");
+DEFINE_bool(enable_store_tso_proxy, false, "serve the internal lower bound tso from a local leased window");
+DEFINE_int64(store_tso_proxy_window_size, 1024, "count of timestamps pre-allocated by the store tso proxy");
+DEFINE_int64(store_tso_proxy_lease_ms, 0,
+             "max staleness of the timestamps served by the store tso proxy, 0 is two advance resolved ts intervals");
 
 DEFINE_bool(dingo_log_switch_txn_detail, false, "txn detail log");
 
@@ -64,6 +98,11 @@ butil::Status TxnReader::Init() {
   }
 
   if (snapshot_ == nullptr) {
+    // must get before take snapshot
+    if (TxnLockIndex::IsEnabled()) {
+      lock_index_sequence_ = TxnLockIndex::GetInstance().Sequence();
+    }
+
     snapshot_ = raw_engine_->GetSnapshot();
     if (snapshot_ == nullptr) {
       DINGO_LOG(ERROR) << "[txn]Scan GetSnapshot failed";
@@ -98,11 +137,22 @@ butil::Status TxnReader::GetLockInfo(const std::string &key, pb::store::LockInfo
   }
 
   std::string lock_value;
-  auto status =
-      reader_->KvGet(Constant::kTxnLockCF, snapshot_, Helper::EncodeTxnKey(key, Constant::kLockVer), lock_value);
+  butil::Status status;
+  if (TxnLockIndex::IsEnabled() && !TxnLockIndex::GetInstance().MayLocked(key, lock_index_sequence_)) {
+    // not in lock index, skip read lock cf
+    status = butil::Status(pb::error::Errno::EKEY_NOT_FOUND, "not in lock index");
+  } else {
+    status =
+        reader_->KvGet(Constant::kTxnLockCF, snapshot_, Helper::EncodeTxnKey(key, Constant::kLockVer), lock_value);
+  }
   // if lock_value is not found or it is empty, then the key is not locked
   // else the key is locked, return WriteConflict
   if (status.error_code() == pb::error::Errno::EKEY_NOT_FOUND) {
+    // the pessimistic lock may be only in leader memory
+    if (PessimisticLockTable::IsEnabled() && PessimisticLockTable::GetInstance().Get(key, lock_info)) {
+      return butil::Status::OK();
+    }
+
     // key is not exists, the key is not locked
     DINGO_LOG_IF(INFO, FLAGS_dingo_log_switch_txn_detail)
         << "[txn]GetLockInfo key: " << Helper::StringToHex(key) << " is not locked, lock_key is not exist";
@@ -132,6 +182,88 @@ butil::Status TxnReader::GetLockInfo(const std::string &key, pb::store::LockInfo
   return butil::Status::OK();
 }
 
+butil::Status TxnReader::BatchGetLockInfo(const std::vector<std::string> &keys,
+                                          std::vector<pb::store::LockInfo> &lock_infos) {
+  if (!is_initialized_) {
+    return butil::Status(pb::error::Errno::EINTERNAL, "txn reader is not initialized");
+  }
+
+  // the keys not in lock index are not locked, only read the others
+  bool use_lock_index = TxnLockIndex::IsEnabled();
+  std::vector<std::string> lock_keys;
+  std::vector<size_t> lock_key_indexes;
+  lock_keys.reserve(keys.size());
+  for (size_t i = 0; i < keys.size(); ++i) {
+    if (use_lock_index && !TxnLockIndex::GetInstance().MayLocked(keys[i], lock_index_sequence_)) {
+      continue;
+    }
+    lock_keys.push_back(Helper::EncodeTxnKey(keys[i], Constant::kLockVer));
+    lock_key_indexes.push_back(i);
+  }
+
+  std::vector<std::string> lock_values(keys.size());
+  std::vector<bool> exists(keys.size(), false);
+  if (!lock_keys.empty()) {
+    std::vector<std::string> values;
+    std::vector<bool> key_exists;
+    auto status = reader_->KvMultiGet(Constant::kTxnLockCF, snapshot_, lock_keys, values, key_exists);
+    if (!status.ok()) {
+      DINGO_LOG(ERROR) << "[txn]BatchGetLockInfo read lock_key failed, keys_count: " << keys.size()
+                       << ", status: " << status.error_str();
+      return butil::Status(status.error_code(), status.error_str());
+    }
+
+    for (size_t i = 0; i < lock_key_indexes.size(); ++i) {
+      lock_values[lock_key_indexes[i]] = std::move(values[i]);
+      exists[lock_key_indexes[i]] = key_exists[i];
+    }
+  }
+
+  lock_infos.clear();
+  lock_infos.resize(keys.size());
+  for (size_t i = 0; i < keys.size(); ++i) {
+    // lock_key not exist or lock_value is empty, the key is not locked
+    if (!exists[i] || lock_values[i].empty()) {
+      // the pessimistic lock may be only in leader memory
+      if (!exists[i] && PessimisticLockTable::IsEnabled()) {
+        PessimisticLockTable::GetInstance().Get(keys[i], lock_infos[i]);
+      }
+      continue;
+    }
+
+    if (!lock_infos[i].ParseFromString(lock_values[i])) {
+      DINGO_LOG(FATAL) << "[txn]BatchGetLockInfo parse lock info failed, lock_key: " << Helper::StringToHex(keys[i])
+                       << ", lock_value: " << Helper::StringToHex(lock_values[i]);
+    }
+  }
+
+  return butil::Status::OK();
+}
+
+butil::Status TxnReader::BatchGetDataValue(const std::vector<std::string> &keys, std::vector<std::string> &values,
+                                           std::vector<butil::Status> &statuses) {
+  if (!is_initialized_) {
+    return butil::Status(pb::error::Errno::EINTERNAL, "txn reader is not initialized");
+  }
+
+  std::vector<bool> exists;
+  auto status = reader_->KvMultiGet(Constant::kTxnDataCF, snapshot_, keys, values, exists);
+  if (!status.ok()) {
+    return status;
+  }
+
+  statuses.assign(keys.size(), butil::Status::OK());
+  for (size_t i = 0; i < keys.size(); ++i) {
+    if (!exists[i]) {
+      DINGO_LOG_IF(INFO, FLAGS_dingo_log_switch_txn_detail)
+          << "[txn]BatchGetDataValue key: " << Helper::StringToHex(keys[i]) << " key is not exist";
+      statuses[i] = butil::Status(pb::error::Errno::EKEY_NOT_FOUND, "key is not exist");
+    }
+  }
+
+  return butil::Status::OK();
+}
+
 butil::Status TxnReader::GetDataValue(const std::string &key, std::string &value) {
   if (!is_initialized_) {
     return butil::Status(pb::error::Errno::EINTERNAL, "txn reader is not initialized");
@@ -294,7 +426,9 @@ butil::Status TxnReader::GetRollbackInfo(int64_t start_ts, const std::string &ke
 }
 
 butil::Status TxnIterator::Init() {
-  snapshot_ = raw_engine_->GetSnapshot();
+  if (snapshot_ == nullptr) {
+    snapshot_ = raw_engine_->GetSnapshot();
+  }
   if (snapshot_ == nullptr) {
     DINGO_LOG(ERROR) << "[txn]Scan GetSnapshot failed";
     return butil::Status(pb::error::Errno::EINTERNAL, "get snapshot failed");
@@ -309,6 +443,7 @@ butil::Status TxnIterator::Init() {
   IteratorOptions write_iter_options;
   write_iter_options.lower_bound = Helper::EncodeTxnKey(range_.start_key(), Constant::kMaxVer);
   write_iter_options.upper_bound = Helper::EncodeTxnKey(range_.end_key(), Constant::kMaxVer);
+  write_iter_options.long_scan = long_scan_;
 
   write_iter_ = reader_->NewIterator(Constant::kTxnWriteCF, snapshot_, write_iter_options);
   if (write_iter_ == nullptr) {
@@ -352,7 +487,7 @@ butil::Status TxnIterator::Seek(const std::string &key) {
     return ret;
   }
 
-  while (value_.empty()) {
+  while (!HasValue()) {
     ret = InnerNext();
     if (ret.error_code() == pb::error::Errno::ETXN_SCAN_FINISH) {
       DINGO_LOG_IF(INFO, FLAGS_dingo_log_switch_txn_detail)
@@ -363,7 +498,7 @@ butil::Status TxnIterator::Seek(const std::string &key) {
       return ret;
     }
 
-    if (!value_.empty()) {
+    if (HasValue()) {
       return butil::Status::OK();
     } else {
       DINGO_LOG_IF(INFO, FLAGS_dingo_log_switch_txn_detail)
@@ -379,6 +514,7 @@ butil::Status TxnIterator::Seek(const std::string &key) {
 butil::Status TxnIterator::InnerSeek(const std::string &key) {
   key_.clear();
   value_.clear();
+  value_data_key_.clear();
   last_lock_key_.clear();
   last_write_key_.clear();
 
@@ -447,7 +583,7 @@ butil::Status TxnIterator::Next() {
       return ret;
     }
 
-    if (!value_.empty()) {
+    if (HasValue()) {
       return butil::Status::OK();
     } else {
       DINGO_LOG_IF(INFO, FLAGS_dingo_log_switch_txn_detail)
@@ -474,6 +610,7 @@ butil::Status TxnIterator::InnerNext() {
   }
 
   value_.clear();
+  value_data_key_.clear();
 
   if (lock_iter_->Valid() && key_ >= last_lock_key_) {
     while (lock_iter_->Valid()) {
@@ -595,11 +732,15 @@ std::string TxnIterator::GetUserKey(std::shared_ptr<Iterator> write_iter) {
   return std::move(user_key);
 }
 
+// the short value inlined in write cf save a data cf read for each visible row.
+bvar::Adder<int64_t> g_txn_scan_short_value_count("dingo_txn_scan_short_value_count");
+bvar::Adder<int64_t> g_txn_scan_data_cf_read_count("dingo_txn_scan_data_cf_read_count");
+
 butil::Status TxnIterator::GetUserValueInWriteIter(std::shared_ptr<Iterator> write_iter, RawEngine::ReaderPtr reader,
-                                                   pb::store::IsolationLevel isolation_level, int64_t seek_ts,
-                                                   int64_t start_ts, const std::string &user_key,
+                                                   SnapshotPtr snapshot, pb::store::IsolationLevel isolation_level,
+                                                   int64_t seek_ts, int64_t start_ts, const std::string &user_key,
                                                    std::string &last_write_key, bool &is_value_found,
-                                                   std::string &user_value) {
+                                                   std::string &user_value, std::string *data_key) {
   is_value_found = false;
   while (write_iter->Valid()) {
     int64_t commit_ts;
@@ -669,14 +810,26 @@ butil::Status TxnIterator::GetUserValueInWriteIter(std::shared_ptr<Iterator> wri
       // use write_ts to get data from data_cf
       if (!write_info.short_value().empty()) {
         user_value = write_info.short_value();
+        g_txn_scan_short_value_count << 1;
+
+        // before return, go to next user_key
+        GotoNextUserKeyInWriteIter(write_iter, last_write_key, last_write_key);
+        is_value_found = true;
+        return butil::Status::OK();
+      } else if (data_key != nullptr) {
+        // lazy value, the caller reads data cf when the value is needed
+        *data_key = Helper::EncodeTxnKey(user_key, write_info.start_ts());
+        user_value = std::string();
 
         // before return, go to next user_key
         GotoNextUserKeyInWriteIter(write_iter, last_write_key, last_write_key);
         is_value_found = true;
         return butil::Status::OK();
       } else {
-        auto ret3 =
-            reader->KvGet(Constant::kTxnDataCF, Helper::EncodeTxnKey(user_key, write_info.start_ts()), user_value);
+        // read the same snapshot as write iter
+        g_txn_scan_data_cf_read_count << 1;
+        auto ret3 = reader->KvGet(Constant::kTxnDataCF, snapshot, Helper::EncodeTxnKey(user_key, write_info.start_ts()),
+                                  user_value);
         if (!ret3.ok() && ret3.error_code() != pb::error::Errno::EKEY_NOT_FOUND) {
           DINGO_LOG(FATAL) << "[txn]Scan read data failed, key: " << Helper::StringToHex(user_key)
                            << ", status: " << ret3.error_str();
@@ -746,8 +899,8 @@ butil::Status TxnIterator::GetCurrentValue() {
     // if lock_key == write_key, then we can get data from write_cf
     if (last_lock_key_ == last_write_key_) {
       bool is_value_found = false;
-      GetUserValueInWriteIter(write_iter_, reader_, isolation_level_, seek_ts_, start_ts_, key_, last_write_key_,
-                              is_value_found, value_);
+      GetUserValueInWriteIter(write_iter_, reader_, snapshot_, isolation_level_, seek_ts_, start_ts_, key_,
+                              last_write_key_, is_value_found, value_, lazy_value_ ? &value_data_key_ : nullptr);
 
       if (is_value_found) {
         return butil::Status::OK();
@@ -765,8 +918,8 @@ butil::Status TxnIterator::GetCurrentValue() {
     key_ = last_write_key_;
 
     bool is_value_found = false;
-    GetUserValueInWriteIter(write_iter_, reader_, isolation_level_, seek_ts_, start_ts_, key_, last_write_key_,
-                            is_value_found, value_);
+    GetUserValueInWriteIter(write_iter_, reader_, snapshot_, isolation_level_, seek_ts_, start_ts_, key_,
+                            last_write_key_, is_value_found, value_, lazy_value_ ? &value_data_key_ : nullptr);
 
     if (is_value_found) {
       return butil::Status::OK();
@@ -796,7 +949,45 @@ bool TxnIterator::Valid(pb::store::TxnResultInfo &txn_result_info) {
 
 std::string TxnIterator::Key() { return key_; }
 
-std::string TxnIterator::Value() { return value_; }
+std::string TxnIterator::Value() {
+  if (!value_data_key_.empty()) {
+    g_txn_scan_data_cf_read_count << 1;
+    auto ret = reader_->KvGet(Constant::kTxnDataCF, snapshot_, value_data_key_, value_);
+    if (!ret.ok()) {
+      DINGO_LOG(ERROR) << "[txn]Scan read data failed, key: " << Helper::StringToHex(key_)
+                       << ", status: " << ret.error_str();
+    }
+    value_data_key_.clear();
+  }
+
+  return value_;
+}
+
+butil::Status TxnIterator::BatchGetValue(const std::vector<std::string> &data_keys, std::vector<std::string> &values) {
+  if (data_keys.empty()) {
+    values.clear();
+    return butil::Status::OK();
+  }
+
+  g_txn_scan_data_cf_read_count << data_keys.size();
+  std::vector<bool> exists;
+  auto ret = reader_->KvMultiGet(Constant::kTxnDataCF, snapshot_, data_keys, values, exists);
+  if (!ret.ok()) {
+    DINGO_LOG(ERROR) << "[txn]Scan multi get data failed, count: " << data_keys.size()
+                     << ", status: " << ret.error_str();
+    return butil::Status(pb::error::Errno::EINTERNAL, "read data failed");
+  }
+
+  for (size_t i = 0; i < data_keys.size(); ++i) {
+    if (!exists[i]) {
+      DINGO_LOG(ERROR) << "[txn]Scan read data failed, data is illegally not found, raw_key: "
+                       << Helper::StringToHex(data_keys[i]);
+      return butil::Status(pb::error::Errno::EINTERNAL, "data is illegally not found");
+    }
+  }
+
+  return butil::Status::OK();
+}
 
 bool TxnEngineHelper::CheckLockConflict(const pb::store::LockInfo &lock_info, pb::store::IsolationLevel isolation_level,
                                         int64_t start_ts, const std::set<int64_t> &resolved_locks,
@@ -884,6 +1075,90 @@ bool TxnEngineHelper::CheckLockConflict(const pb::store::LockInfo &lock_info, pb
 
 bvar::LatencyRecorder g_txn_scan_lock_latency("dingo_txn_scan_lock");
 
+// The keys are the sorted candidates from TxnLockIndex, the index is a superset of lock cf, so check the lock again.
+static butil::Status ScanLockInfoByIndex(RawEnginePtr engine, int64_t min_lock_ts, int64_t max_lock_ts,
+                                         const std::vector<std::string> &keys, int64_t limit,
+                                         std::vector<pb::store::LockInfo> &lock_infos, bool &has_more,
+                                         std::string &end_scan_key) {
+  auto reader = engine->Reader();
+  int64_t response_memory_size = 0;
+  for (const auto &key : keys) {
+    std::string lock_value;
+    auto status = reader->KvGet(Constant::kTxnLockCF, Helper::EncodeTxnKey(key, Constant::kLockVer), lock_value);
+    if (status.error_code() == pb::error::Errno::EKEY_NOT_FOUND) {
+      continue;
+    } else if (!status.ok()) {
+      DINGO_LOG(ERROR) << "[txn]ScanLockInfo get lock failed, key: " << Helper::StringToHex(key)
+                       << ", status: " << status.error_str();
+      return status;
+    }
+
+    pb::store::LockInfo lock_info;
+    if (!lock_info.ParseFromString(lock_value)) {
+      DINGO_LOG(FATAL) << "[txn]ScanLockInfo parse lock info failed, key: " << Helper::StringToHex(key)
+                       << ", lock_value(hex): " << Helper::StringToHex(lock_value);
+    }
+
+    end_scan_key = lock_info.key();
+
+    if (lock_info.lock_ts() == 0 || lock_info.lock_ts() < min_lock_ts || lock_info.lock_ts() >= max_lock_ts) {
+      continue;
+    }
+
+    lock_infos.push_back(lock_info);
+    response_memory_size += lock_info.ByteSizeLong();
+
+    if ((limit > 0 && lock_infos.size() >= limit) || lock_infos.size() > FLAGS_max_scan_lock_limit ||
+        response_memory_size > FLAGS_max_scan_memory_size) {
+      has_more = true;
+      break;
+    }
+  }
+
+  DINGO_LOG_IF(INFO, FLAGS_dingo_log_switch_txn_detail)
+      << "[txn]ScanLockInfo by index, candidate count: " << keys.size() << ", lock_infos size: " << lock_infos.size()
+      << ", has_more: " << has_more;
+
+  return butil::Status::OK();
+}
+
+// The in memory pessimistic locks of the leader are not in lock cf, add the ones of the scanned keys, a page with more
+// only covers the keys up to end_scan_key. The lock cf wins, a key has lock in lock cf is already scanned.
+static butil::Status AppendMemoryPessimisticLocks(RawEnginePtr engine, int64_t min_lock_ts, int64_t max_lock_ts,
+                                                  const pb::common::Range &range, bool has_more,
+                                                  const std::string &end_scan_key,
+                                                  std::vector<pb::store::LockInfo> &lock_infos) {
+  if (!PessimisticLockTable::IsEnabled()) {
+    return butil::Status::OK();
+  }
+
+  std::string end_key = has_more ? end_scan_key + '\0' : range.end_key();
+  auto memory_lock_infos = PessimisticLockTable::GetInstance().GetRange(range.start_key(), end_key);
+  if (memory_lock_infos.empty()) {
+    return butil::Status::OK();
+  }
+
+  auto reader = engine->Reader();
+  for (auto &lock_info : memory_lock_infos) {
+    if (lock_info.lock_ts() < min_lock_ts || lock_info.lock_ts() >= max_lock_ts) {
+      continue;
+    }
+
+    std::string lock_value;
+    auto status =
+        reader->KvGet(Constant::kTxnLockCF, Helper::EncodeTxnKey(lock_info.key(), Constant::kLockVer), lock_value);
+    if (status.ok()) {
+      continue;
+    } else if (status.error_code() != pb::error::Errno::EKEY_NOT_FOUND) {
+      return status;
+    }
+
+    lock_infos.push_back(std::move(lock_info));
+  }
+
+  return butil::Status::OK();
+}
+
 butil::Status TxnEngineHelper::ScanLockInfo(RawEnginePtr engine, int64_t min_lock_ts, int64_t max_lock_ts,
                                             const pb::common::Range &range, int64_t limit,
                                             std::vector<pb::store::LockInfo> &lock_infos, bool &has_more,
@@ -905,6 +1180,19 @@ butil::Status TxnEngineHelper::ScanLockInfo(RawEnginePtr engine, int64_t min_loc
     return butil::Status(pb::error::Errno::EILLEGAL_PARAMTETERS, "has_more or end_scan_key is not empty");
   }
 
+  // only read the locks in the ts range
+  std::vector<std::string> index_keys;
+  if (TxnLockIndex::IsEnabled() &&
+      TxnLockIndex::GetInstance().GetKeysByTs(min_lock_ts, max_lock_ts, range.start_key(), range.end_key(),
+                                              FLAGS_txn_lock_index_scan_max_keys, index_keys)) {
+    auto status = ScanLockInfoByIndex(engine, min_lock_ts, max_lock_ts, index_keys, limit, lock_infos, has_more,
+                                      end_scan_key);
+    if (!status.ok()) {
+      return status;
+    }
+    return AppendMemoryPessimisticLocks(engine, min_lock_ts, max_lock_ts, range, has_more, end_scan_key, lock_infos);
+  }
+
   IteratorOptions iter_options;
   iter_options.lower_bound = Helper::EncodeTxnKey(range.start_key(), Constant::kLockVer);
   iter_options.upper_bound = Helper::EncodeTxnKey(range.end_key(), Constant::kLockVer);
@@ -979,7 +1267,7 @@ butil::Status TxnEngineHelper::ScanLockInfo(RawEnginePtr engine, int64_t min_loc
     iter->Next();
   }
 
-  return butil::Status::OK();
+  return AppendMemoryPessimisticLocks(engine, min_lock_ts, max_lock_ts, range, has_more, end_scan_key, lock_infos);
 }
 
 bvar::LatencyRecorder g_txn_batch_get_latency("dingo_txn_batch_get");
@@ -1023,6 +1311,11 @@ butil::Status TxnEngineHelper::BatchGet(RawEnginePtr engine, const pb::store::Is
     return butil::Status(pb::error::Errno::EILLEGAL_PARAMTETERS, "txn_result_info is not empty");
   }
 
+  if (!TxnOnePcKeys::GetInstance().WaitKeys(keys, start_ts)) {
+    DINGO_LOG(WARNING) << "[txn]BatchGet wait one pc commit timeout, start_ts: " << start_ts;
+    return butil::Status(pb::error::Errno::EREGION_UNAVAILABLE, "one pc commit is in flight, retry later");
+  }
+
   TxnReader txn_reader(engine);
   auto ret_init = txn_reader.Init();
   if (!ret_init.ok()) {
@@ -1038,30 +1331,42 @@ butil::Status TxnEngineHelper::BatchGet(RawEnginePtr engine, const pb::store::Is
     return butil::Status(pb::error::Errno::EINTERNAL, "GetWriteIter failed");
   }
 
-  // for every key in keys, get lock info, if lock_ts < start_ts, return LockInfo
+  // get lock info of all keys by one multi get, for every key in keys, if lock_ts < start_ts, return LockInfo
   // else find the latest write below our start_ts
-  // then read data from data_cf
-  for (const auto &key : keys) {
+  // then read data from data_cf by one multi get
+  std::vector<pb::store::LockInfo> lock_infos;
+  auto ret_lock = txn_reader.BatchGetLockInfo(keys, lock_infos);
+  if (!ret_lock.ok()) {
+    DINGO_LOG(FATAL) << "[txn]BatchGet BatchGetLockInfo failed, keys_count: " << keys.size()
+                     << ", status: " << ret_lock.error_str();
+  }
+
+  // the lock conflict is reported only if the keys before it fit in max_batch_get_memory_size.
+  size_t conflict_pos = keys.size();
+  pb::store::TxnResultInfo conflict_result_info;
+
+  std::vector<pb::common::KeyValue> key_values;
+  key_values.reserve(keys.size());
+  // position in key_values and data key of the values stored in data_cf
+  std::vector<size_t> data_positions;
+  std::vector<std::string> data_keys;
+
+  for (size_t i = 0; i < keys.size(); ++i) {
+    const auto &key = keys[i];
     pb::common::KeyValue kv;
     kv.set_key(key);
 
-    pb::store::LockInfo lock_info;
-    auto ret = txn_reader.GetLockInfo(key, lock_info);
-    if (!ret.ok()) {
-      DINGO_LOG(FATAL) << "[txn]BatchGet GetLockInfo failed, key: " << Helper::StringToHex(key)
-                       << ", status: " << ret.error_str();
-    }
-
-    auto is_lock_conflict = CheckLockConflict(lock_info, isolation_level, start_ts, resolved_locks, txn_result_info);
+    auto is_lock_conflict =
+        CheckLockConflict(lock_infos[i], isolation_level, start_ts, resolved_locks, conflict_result_info);
     if (is_lock_conflict) {
       DINGO_LOG(WARNING) << "[txn]BatchGet CheckLockConflict return conflict, key: " << Helper::StringToHex(key)
                          << ", isolation_level: " << isolation_level << ", start_ts: " << start_ts
-                         << ", lock_info: " << lock_info.ShortDebugString();
-      return butil::Status::OK();
+                         << ", lock_info: " << lock_infos[i].ShortDebugString();
+      conflict_pos = i;
+      break;
     }
 
     int64_t iter_start_ts;
-    bool is_valid = false;
     if (isolation_level == pb::store::IsolationLevel::SnapshotIsolation) {
       iter_start_ts = start_ts;
     } else if (isolation_level == pb::store::IsolationLevel::ReadCommitted) {
@@ -1146,15 +1451,8 @@ butil::Status TxnEngineHelper::BatchGet(RawEnginePtr engine, const pb::store::Is
           break;
         }
 
-        auto ret1 = txn_reader.GetDataValue(Helper::EncodeTxnKey(key, write_info.start_ts()), *kv.mutable_value());
-        if (!ret1.ok() && ret1.error_code() != pb::error::Errno::EKEY_NOT_FOUND) {
-          DINGO_LOG(FATAL) << "[txn]BatchGet read data failed, key: " << Helper::StringToHex(key)
-                           << ", status: " << ret1.error_str();
-        } else if (ret1.error_code() == pb::error::Errno::EKEY_NOT_FOUND) {
-          DINGO_LOG(ERROR) << "[txn]BatchGet read data failed, data is illegally not found, key: "
-                           << Helper::StringToHex(key) << ", status: " << ret1.error_str()
-                           << ", raw_key: " << Helper::EncodeTxnKey(key, write_info.start_ts());
-        }
+        data_positions.push_back(key_values.size());
+        data_keys.push_back(Helper::EncodeTxnKey(key, write_info.start_ts()));
         break;
       } else {
         DINGO_LOG_IF(INFO, FLAGS_dingo_log_switch_txn_detail)
@@ -1165,10 +1463,37 @@ butil::Status TxnEngineHelper::BatchGet(RawEnginePtr engine, const pb::store::Is
       write_iter->Next();
     }
 
-    kvs.emplace_back(kv);
+    key_values.push_back(std::move(kv));
+  }
+
+  if (!data_keys.empty()) {
+    std::vector<std::string> data_values;
+    std::vector<butil::Status> data_statuses;
+    auto ret = txn_reader.BatchGetDataValue(data_keys, data_values, data_statuses);
+    if (!ret.ok()) {
+      DINGO_LOG(FATAL) << "[txn]BatchGet read data failed, keys_count: " << data_keys.size()
+                       << ", status: " << ret.error_str();
+    }
+
+    for (size_t i = 0; i < data_keys.size(); ++i) {
+      auto &kv = key_values[data_positions[i]];
+      if (data_statuses[i].error_code() == pb::error::Errno::EKEY_NOT_FOUND) {
+        DINGO_LOG(ERROR) << "[txn]BatchGet read data failed, data is illegally not found, key: "
+                         << Helper::StringToHex(kv.key()) << ", status: " << data_statuses[i].error_str()
+                         << ", raw_key: " << data_keys[i];
+        continue;
+      }
+      kv.set_value(std::move(data_values[i]));
+    }
+  }
+
+  bool is_memory_limited = false;
+  for (auto &kv : key_values) {
     response_memory_size += kv.ByteSizeLong();
+    kvs.push_back(std::move(kv));
 
     if (response_memory_size >= FLAGS_max_batch_get_memory_size) {
+      is_memory_limited = true;
       DINGO_LOG_IF(INFO, FLAGS_dingo_log_switch_txn_detail)
           << "[txn]BatchGet kvs.size: " << kvs.size() << ", response_memory_size: " << response_memory_size
           << ", max_batch_get_count: " << FLAGS_max_batch_get_count
@@ -1177,6 +1502,10 @@ butil::Status TxnEngineHelper::BatchGet(RawEnginePtr engine, const pb::store::Is
     }
   }
 
+  if (conflict_pos < keys.size() && !is_memory_limited) {
+    txn_result_info.Swap(&conflict_result_info);
+  }
+
   return butil::Status::OK();
 }
 
@@ -1227,8 +1556,24 @@ butil::Status TxnEngineHelper::Scan(RawEnginePtr raw_engine, const pb::store::Is
     return butil::Status(pb::error::Errno::EILLEGAL_PARAMTETERS, "has_more or end_scan_key is not empty");
   }
 
+  if (!TxnOnePcKeys::GetInstance().WaitRange(range.start_key(), range.end_key(), start_ts)) {
+    DINGO_LOG(WARNING) << "[txn]Scan wait one pc commit timeout, start_ts: " << start_ts;
+    return butil::Status(pb::error::Errno::EREGION_UNAVAILABLE, "one pc commit is in flight, retry later");
+  }
+
+  // analytical scan read most of the region, prefetch ahead
+  bool long_scan = !disable_coprocessor || limit >= FLAGS_txn_scan_long_scan_min_limit;
+
+  if (disable_coprocessor && long_scan && FLAGS_txn_scan_parallel_concurrency > 1) {
+    auto sub_ranges = SplitScanRange(raw_engine, range, FLAGS_txn_scan_parallel_concurrency);
+    if (sub_ranges.size() > 1) {
+      return ParallelScan(raw_engine, isolation_level, start_ts, sub_ranges, limit, key_only, resolved_locks,
+                          txn_result_info, kvs, has_more, end_scan_key);
+    }
+  }
+
   std::shared_ptr<TxnIterator> txn_iter =
-      std::make_shared<TxnIterator>(raw_engine, range, start_ts, isolation_level, resolved_locks);
+      std::make_shared<TxnIterator>(raw_engine, range, start_ts, isolation_level, resolved_locks, long_scan);
   auto ret = txn_iter->Init();
   if (!ret.ok()) {
     DINGO_LOG(ERROR) << "[txn]Scan init txn_iter failed, start_ts: " << start_ts
@@ -1236,7 +1581,8 @@ butil::Status TxnEngineHelper::Scan(RawEnginePtr raw_engine, const pb::store::Is
     return ret;
   }
 
-  int64_t response_memory_size = 0;
+  // key only scan and coprocessor filter need not read the value of every row
+  txn_iter->SetLazyValue(key_only || !disable_coprocessor);
   txn_iter->Seek(range.start_key());
 
   if (!disable_coprocessor) {
@@ -1262,9 +1608,19 @@ butil::Status TxnEngineHelper::Scan(RawEnginePtr raw_engine, const pb::store::Is
     return butil::Status::OK();
   }
 
+  ScanTxnIterator(txn_iter, limit, key_only, txn_result_info, kvs, has_more, end_scan_key);
+
+  return butil::Status::OK();
+}
+
+void TxnEngineHelper::ScanTxnIterator(std::shared_ptr<TxnIterator> txn_iter, int64_t limit, bool key_only,
+                                      pb::store::TxnResultInfo &txn_result_info,
+                                      std::vector<pb::common::KeyValue> &kvs, bool &has_more,
+                                      std::string &end_scan_key,
+                                      const std::function<bool(int64_t, int64_t)> &is_enough) {
+  int64_t response_memory_size = 0;
   while (txn_iter->Valid(txn_result_info)) {
     auto key = txn_iter->Key();
-    auto value = txn_iter->Value();
 
     if (key_only) {
       pb::common::KeyValue kv;
@@ -1274,7 +1630,7 @@ butil::Status TxnEngineHelper::Scan(RawEnginePtr raw_engine, const pb::store::Is
     } else {
       pb::common::KeyValue kv;
       kv.set_key(key);
-      kv.set_value(value);
+      kv.set_value(txn_iter->Value());
       kvs.push_back(kv);
       response_memory_size += kv.ByteSizeLong();
     }
@@ -1284,7 +1640,8 @@ butil::Status TxnEngineHelper::Scan(RawEnginePtr raw_engine, const pb::store::Is
     txn_iter->Next();
 
     if ((limit > 0 && kvs.size() >= limit) || kvs.size() >= FLAGS_max_scan_line_limit ||
-        response_memory_size >= FLAGS_max_scan_memory_size) {
+        response_memory_size >= FLAGS_max_scan_memory_size ||
+        (is_enough != nullptr && is_enough(kvs.size(), response_memory_size))) {
       has_more = true;
       DINGO_LOG_IF(INFO, FLAGS_dingo_log_switch_txn_detail)
           << "[txn]Scan kvs.size: " << kvs.size() << ", response_memory_size: " << response_memory_size
@@ -1293,6 +1650,164 @@ butil::Status TxnEngineHelper::Scan(RawEnginePtr raw_engine, const pb::store::Is
       break;
     }
   }
+}
+
+std::vector<pb::common::Range> TxnEngineHelper::SplitScanRange(RawEnginePtr raw_engine, const pb::common::Range &range,
+                                                               int32_t concurrency) {
+  if (range.end_key().empty() || range.start_key() >= range.end_key()) {
+    return {range};
+  }
+
+  // cut into small pieces, then group them by approximate size of write cf
+  auto split_keys = Helper::GenEvenSplitKeys(range.start_key(), range.end_key(), concurrency * 4);
+  if (split_keys.empty()) {
+    return {range};
+  }
+  split_keys.insert(split_keys.begin(), range.start_key());
+  split_keys.push_back(range.end_key());
+
+  std::vector<pb::common::Range> pieces;
+  for (size_t i = 0; i + 1 < split_keys.size(); ++i) {
+    pb::common::Range piece;
+    piece.set_start_key(Helper::EncodeTxnKey(split_keys[i], Constant::kMaxVer));
+    piece.set_end_key(Helper::EncodeTxnKey(split_keys[i + 1], Constant::kMaxVer));
+    pieces.push_back(std::move(piece));
+  }
+
+  auto sizes = raw_engine->GetApproximateSizes(Constant::kTxnWriteCF, pieces);
+  if (sizes.size() != pieces.size()) {
+    return {range};
+  }
+
+  int64_t total_size = std::accumulate(sizes.begin(), sizes.end(), static_cast<int64_t>(0));
+  if (total_size < FLAGS_txn_scan_parallel_min_size) {
+    return {range};
+  }
+
+  std::vector<pb::common::Range> sub_ranges;
+  int64_t target_size = total_size / concurrency;
+  int64_t acc_size = 0;
+  std::string sub_start_key = range.start_key();
+  for (size_t i = 0; i < sizes.size(); ++i) {
+    acc_size += sizes[i];
+    bool is_last = (i + 1 == sizes.size());
+    if (is_last || (acc_size >= target_size && sub_ranges.size() + 1 < static_cast<size_t>(concurrency))) {
+      pb::common::Range sub_range;
+      sub_range.set_start_key(sub_start_key);
+      sub_range.set_end_key(split_keys[i + 1]);
+      sub_ranges.push_back(std::move(sub_range));
+
+      sub_start_key = split_keys[i + 1];
+      acc_size = 0;
+    }
+  }
+
+  return sub_ranges;
+}
+
+bvar::LatencyRecorder g_txn_parallel_scan_latency("dingo_txn_parallel_scan");
+
+butil::Status TxnEngineHelper::ParallelScan(RawEnginePtr raw_engine, const pb::store::IsolationLevel &isolation_level,
+                                            int64_t start_ts, const std::vector<pb::common::Range> &sub_ranges,
+                                            int64_t limit, bool key_only, const std::set<int64_t> &resolved_locks,
+                                            pb::store::TxnResultInfo &txn_result_info,
+                                            std::vector<pb::common::KeyValue> &kvs, bool &has_more,
+                                            std::string &end_scan_key) {
+  BvarLatencyGuard bvar_guard(&g_txn_parallel_scan_latency);
+
+  // all the sub range read one snapshot, same as the sequential scan
+  auto snapshot = raw_engine->GetSnapshot();
+  if (snapshot == nullptr) {
+    DINGO_LOG(ERROR) << "[txn]ParallelScan GetSnapshot failed";
+    return butil::Status(pb::error::Errno::EINTERNAL, "get snapshot failed");
+  }
+
+  struct SubScan {
+    butil::Status status;
+    pb::store::TxnResultInfo txn_result_info;
+    std::vector<pb::common::KeyValue> kvs;
+    bool has_more{false};
+    std::string end_scan_key;
+  };
+
+  int64_t count = sub_ranges.size();
+  std::vector<SubScan> sub_scans(count);
+
+  // The merge takes the sub scans in order, the kvs of sub scan i after the ones of sub scan 0..i-1 reach the
+  // limit are never returned. The collected of the former sub scans only grows, so stop sub scan i once
+  // the sum reaches the limit, the memory is bounded by the limit instead of concurrency * limit.
+  std::vector<std::atomic<int64_t>> collected_counts(count);
+  std::vector<std::atomic<int64_t>> collected_sizes(count);
+  for (int64_t i = 0; i < count; ++i) {
+    collected_counts[i].store(0, std::memory_order_relaxed);
+    collected_sizes[i].store(0, std::memory_order_relaxed);
+  }
+  auto is_enough = [&](int64_t i, int64_t sub_count, int64_t sub_size) -> bool {
+    collected_counts[i].store(sub_count, std::memory_order_relaxed);
+    collected_sizes[i].store(sub_size, std::memory_order_relaxed);
+
+    int64_t total_count = sub_count;
+    int64_t total_size = sub_size;
+    for (int64_t j = 0; j < i; ++j) {
+      total_count += collected_counts[j].load(std::memory_order_relaxed);
+      total_size += collected_sizes[j].load(std::memory_order_relaxed);
+    }
+    return (limit > 0 && total_count >= limit) || total_count >= FLAGS_max_scan_line_limit ||
+           total_size >= FLAGS_max_scan_memory_size;
+  };
+
+  auto scan_func = [&](int64_t i) {
+    auto txn_iter = std::make_shared<TxnIterator>(raw_engine, sub_ranges[i], start_ts, isolation_level,
+                                                  resolved_locks, true, snapshot);
+    auto &sub_scan = sub_scans[i];
+    sub_scan.status = txn_iter->Init();
+    if (!sub_scan.status.ok()) {
+      return;
+    }
+
+    txn_iter->SetLazyValue(key_only);
+    txn_iter->Seek(sub_ranges[i].start_key());
+    ScanTxnIterator(txn_iter, limit, key_only, sub_scan.txn_result_info, sub_scan.kvs, sub_scan.has_more,
+                    sub_scan.end_scan_key,
+                    [&is_enough, i](int64_t sub_count, int64_t sub_size) { return is_enough(i, sub_count, sub_size); });
+  };
+
+  std::vector<Bthread> workers;
+  workers.reserve(count - 1);
+  for (int64_t i = 1; i < count; ++i) {
+    workers.emplace_back([&scan_func, i]() { scan_func(i); });
+  }
+  scan_func(0);
+  for (auto &worker : workers) {
+    worker.Join();
+  }
+
+  // merge in key order, stop at the first conflict or limit like the sequential scan
+  int64_t response_memory_size = 0;
+  for (auto &sub_scan : sub_scans) {
+    if (!sub_scan.status.ok()) {
+      DINGO_LOG(ERROR) << "[txn]ParallelScan init txn_iter failed, start_ts: " << start_ts
+                       << ", status: " << sub_scan.status.error_str();
+      return sub_scan.status;
+    }
+
+    for (auto &kv : sub_scan.kvs) {
+      response_memory_size += kv.ByteSizeLong();
+      end_scan_key = kv.key();
+      kvs.push_back(std::move(kv));
+
+      if ((limit > 0 && kvs.size() >= limit) || kvs.size() >= FLAGS_max_scan_line_limit ||
+          response_memory_size >= FLAGS_max_scan_memory_size) {
+        has_more = true;
+        return butil::Status::OK();
+      }
+    }
+
+    if (sub_scan.txn_result_info.ByteSizeLong() > 0) {
+      txn_result_info = sub_scan.txn_result_info;
+      return butil::Status::OK();
+    }
+  }
 
   return butil::Status::OK();
 }
@@ -1330,6 +1845,7 @@ butil::Status TxnEngineHelper::PessimisticLock(RawEnginePtr raw_engine, std::sha
   }
 
   std::vector<pb::common::KeyValue> kv_puts_lock;
+  std::vector<pb::store::LockInfo> lock_infos;
 
   auto *response = dynamic_cast<pb::store::TxnPessimisticLockResponse *>(ctx->Response());
   if (response == nullptr) {
@@ -1408,6 +1924,7 @@ butil::Status TxnEngineHelper::PessimisticLock(RawEnginePtr raw_engine, std::sha
           kv.set_value(lock_info.SerializeAsString());
 
           kv_puts_lock.push_back(kv);
+          lock_infos.push_back(lock_info);
         } else {
           // lock_info.for_update_ts() > for_update_ts, this is a illegal request, we return lock_info
           DINGO_LOG(ERROR) << fmt::format("[txn][region({})] PessimisticLock,", region->Id())
@@ -1492,6 +2009,7 @@ butil::Status TxnEngineHelper::PessimisticLock(RawEnginePtr raw_engine, std::sha
         kv.set_value(lock_info.SerializeAsString());
 
         kv_puts_lock.push_back(kv);
+        lock_infos.push_back(lock_info);
       }
     }
   }
@@ -1512,6 +2030,15 @@ butil::Status TxnEngineHelper::PessimisticLock(RawEnginePtr raw_engine, std::sha
     return butil::Status::OK();
   }
 
+  // keep the lock in leader memory, not write raft
+  if (PessimisticLockTable::IsEnabled() && region->GetStoreEngineType() == pb::common::STORE_ENG_RAFT_STORE &&
+      PessimisticLockTable::GetInstance().Put(lock_infos)) {
+    DINGO_LOG_IF(INFO, FLAGS_dingo_log_switch_txn_detail)
+        << fmt::format("[txn][region({})] PessimisticLock in memory", region->Id())
+        << ", lock_size: " << lock_infos.size() << ", start_ts: " << start_ts << ", for_update_ts: " << for_update_ts;
+    return butil::Status::OK();
+  }
+
   // after all mutations is processed, write into raft engine
   pb::raft::TxnRaftRequest txn_raft_request;
   auto *cf_put_delete = txn_raft_request.mutable_multi_cf_put_and_delete();
@@ -1538,6 +2065,70 @@ butil::Status TxnEngineHelper::PessimisticLock(RawEnginePtr raw_engine, std::sha
   return ret;
 }
 
+butil::Status TxnEngineHelper::PersistMemoryPessimisticLock(std::shared_ptr<Engine> raft_engine,
+                                                            store::RegionPtr region) {
+  auto range = region->Range();
+  auto lock_infos = PessimisticLockTable::GetInstance().GetRange(range.start_key(), range.end_key());
+  if (lock_infos.empty()) {
+    return butil::Status::OK();
+  }
+
+  // Hold the latches of the keys like the txn write requests, so no lock cf write of them is in flight, then only
+  // persist the memory locks which still exist and have no lock in lock cf, never overwrite a lock of other txn.
+  std::vector<std::string> keys;
+  keys.reserve(lock_infos.size());
+  for (const auto &lock_info : lock_infos) {
+    keys.push_back(lock_info.key());
+  }
+  Lock lock(keys);
+  BthreadCond sync_cond;
+  uint64_t cid = (uint64_t)(&sync_cond);
+  while (!region->LatchesAcquire(&lock, cid)) {
+    sync_cond.IncreaseWait();
+  }
+  DEFER(region->LatchesRelease(&lock, cid));
+
+  auto reader = Server::GetInstance().GetRawEngine(region->GetRawEngineType())->Reader();
+  pb::raft::TxnRaftRequest txn_raft_request;
+  auto *lock_puts = txn_raft_request.mutable_multi_cf_put_and_delete()->add_puts_with_cf();
+  lock_puts->set_cf_name(Constant::kTxnLockCF);
+  for (const auto &key : keys) {
+    pb::store::LockInfo lock_info;
+    if (!PessimisticLockTable::GetInstance().Get(key, lock_info)) {
+      continue;
+    }
+
+    std::string lock_key = Helper::EncodeTxnKey(key, Constant::kLockVer);
+    std::string lock_value;
+    auto status = reader->KvGet(Constant::kTxnLockCF, lock_key, lock_value);
+    if (status.ok()) {
+      continue;
+    } else if (status.error_code() != pb::error::Errno::EKEY_NOT_FOUND) {
+      return status;
+    }
+
+    auto *kv = lock_puts->add_kvs();
+    kv->set_key(lock_key);
+    kv->set_value(lock_info.SerializeAsString());
+  }
+  if (lock_puts->kvs().empty()) {
+    return butil::Status::OK();
+  }
+
+  DINGO_LOG(INFO) << fmt::format("[txn][region({})] persist memory pessimistic lock, lock_size: {}", region->Id(),
+                                 lock_puts->kvs_size());
+
+  auto ctx = std::make_shared<Context>();
+  ctx->SetRegionId(region->Id());
+  ctx->SetRegionEpoch(region->Epoch());
+  ctx->SetCfName(Constant::kStoreDataCF);
+  ctx->SetStoreEngineType(region->GetStoreEngineType());
+  ctx->SetRawEngineType(region->GetRawEngineType());
+
+  // the applied lock cf write erase them from memory
+  return raft_engine->Write(ctx, WriteDataBuilder::BuildWrite(txn_raft_request));
+}
+
 bvar::LatencyRecorder g_txn_do_update_lock_latency("dingo_txn_do_update_lock");
 
 butil::Status TxnEngineHelper::DoUpdateLock(std::shared_ptr<Engine> raft_engine, std::shared_ptr<Context> ctx,
@@ -1754,7 +2345,170 @@ butil::Status TxnEngineHelper::PessimisticRollback(RawEnginePtr raw_engine, std:
   return ret;
 }
 
+bvar::Adder<int64_t> g_txn_tso_request_count("dingo_txn_tso_request_count");
+
+// Get count timestamps from coordinator tso service in one request.
+static butil::Status FetchTso(int64_t count, int64_t &start_ts) {
+  pb::meta::TsoRequest request;
+  pb::meta::TsoResponse response;
+  request.set_op_type(pb::meta::TsoOpType::OP_GEN_TSO);
+  request.set_count(count);
+  g_txn_tso_request_count << 1;
+  auto status = Server::GetInstance().GetCoordinatorInteractionIncr()->SendRequest("TsoService", request, response);
+  if (!status.ok()) {
+    return status;
+  }
+  if (response.count() != count) {
+    return butil::Status(pb::error::Errno::EINTERNAL,
+                         fmt::format("tso count mismatch, request: {}, response: {}", count, response.count()));
+  }
+
+  start_ts = (response.start_timestamp().physical() << kLogicalBits) + response.start_timestamp().logical();
+  return butil::Status::OK();
+}
+
+// Get a timestamp from coordinator tso service, the concurrent callers share one request.
+static butil::Status GetTso(int64_t &tso) {
+  static TsoBatcher tso_batcher(FetchTso, FLAGS_store_tso_batch_max_count);
+  return tso_batcher.GetTso(tso);
+}
+
+DECLARE_int32(resolved_ts_advance_interval_s);
+
+// Get a timestamp not greater than the current tso, it may be served by the local tso proxy without rpc.
+// The advance resolved ts task is the only caller, the commit ts of one pc needs a fresh tso. The task runs once per
+// interval, so the lease shorter than the interval fetches every call, by default the lease covers two intervals,
+// it halves the tso requests and the resolved ts lags at most one more interval.
+static butil::Status GetLowerBoundTso(int64_t &tso) {
+  if (!FLAGS_enable_store_tso_proxy) {
+    return GetTso(tso);
+  }
+
+  static TsoProxy tso_proxy(FetchTso, FLAGS_store_tso_proxy_window_size,
+                            FLAGS_store_tso_proxy_lease_ms > 0
+                                ? FLAGS_store_tso_proxy_lease_ms
+                                : 2 * static_cast<int64_t>(FLAGS_resolved_ts_advance_interval_s) * 1000);
+  return tso_proxy.GetTso(tso);
+}
+
+// The write is async when ctx carries the done of request, the error of write is filled into the response and the
+// done runs after apply, so the worker of request is not blocked during raft replication.
+// on_applied is called after the async write is applied or failed, the sync write is done when it returns.
+static butil::Status RaftEngineWrite(std::shared_ptr<Engine> raft_engine, std::shared_ptr<Context> ctx,
+                                     std::shared_ptr<WriteData> write_data,
+                                     std::function<void()> on_applied = nullptr) {
+  if (ctx->Done() == nullptr) {
+    return raft_engine->Write(ctx, write_data);
+  }
+
+  return raft_engine->AsyncWrite(ctx, write_data, [on_applied](std::shared_ptr<Context> ctx, butil::Status status) {
+    if (on_applied != nullptr) {
+      on_applied();
+    }
+    if (!status.ok()) {
+      if (status.error_code() == EPERM) {
+        status = butil::Status(pb::error::Errno::ERAFT_NOTLEADER, status.error_str());
+      }
+      Helper::SetPbMessageError(status, ctx->Response());
+    }
+  });
+}
+
 bvar::LatencyRecorder g_txn_prewrite_latency("dingo_txn_prewrite");
+bvar::Adder<int64_t> g_txn_one_pc_count("dingo_txn_one_pc_count");
+bvar::Adder<int64_t> g_txn_prewrite_chunk_count("dingo_txn_prewrite_chunk_count");
+
+static int64_t KvsSize(const std::vector<pb::common::KeyValue> &kvs) {
+  int64_t size = 0;
+  for (const auto &kv : kvs) {
+    size += kv.key().size() + kv.value().size();
+  }
+  return size;
+}
+
+// Append the kvs of cf into chunks of raft request, a chunk is closed before it exceeds max_entry_size.
+static void AppendPrewriteChunks(const std::string &cf_name, const std::vector<pb::common::KeyValue> &kvs,
+                                 int64_t max_entry_size, std::vector<pb::raft::TxnRaftRequest> &chunks) {
+  pb::raft::TxnRaftRequest chunk;
+  int64_t chunk_size = 0;
+  for (const auto &kv : kvs) {
+    int64_t kv_size = kv.key().size() + kv.value().size();
+    if (chunk_size > 0 && chunk_size + kv_size > max_entry_size) {
+      chunks.push_back(std::move(chunk));
+      chunk = pb::raft::TxnRaftRequest();
+      chunk_size = 0;
+    }
+
+    auto *cf_put_delete = chunk.mutable_multi_cf_put_and_delete();
+    if (cf_put_delete->puts_with_cf_size() == 0) {
+      cf_put_delete->add_puts_with_cf()->set_cf_name(cf_name);
+    }
+    *cf_put_delete->mutable_puts_with_cf(0)->add_kvs() = kv;
+    chunk_size += kv_size;
+  }
+
+  if (chunk_size > 0) {
+    chunks.push_back(std::move(chunk));
+  }
+}
+
+// The prewrite of large transaction is written as several bounded raft entries under the same start_ts and primary.
+// The data entries go before the lock entries, so a visible lock never points to missing data. A failure in the
+// middle leaves some locks only, which are cleaned by the rollback of transaction like a partial prewrite across
+// regions. All entries but the last are written synchronously with a context without done.
+static butil::Status PrewriteInChunks(std::shared_ptr<Engine> raft_engine, std::shared_ptr<Context> ctx,
+                                      const std::vector<pb::common::KeyValue> &kv_puts_data,
+                                      const std::vector<pb::common::KeyValue> &kv_puts_lock) {
+  std::vector<pb::raft::TxnRaftRequest> chunks;
+  AppendPrewriteChunks(Constant::kTxnDataCF, kv_puts_data, FLAGS_txn_prewrite_max_raft_entry_size, chunks);
+  AppendPrewriteChunks(Constant::kTxnLockCF, kv_puts_lock, FLAGS_txn_prewrite_max_raft_entry_size, chunks);
+
+  DINGO_LOG_IF(INFO, FLAGS_dingo_log_switch_txn_detail) << fmt::format(
+      "[txn][region({})] Prewrite in chunks, chunk_count: {}, kv_puts_data_size: {}, kv_puts_lock_size: {}",
+      ctx->RegionId(), chunks.size(), kv_puts_data.size(), kv_puts_lock.size());
+  g_txn_prewrite_chunk_count << chunks.size();
+
+  // the done of request belongs to the last entry
+  auto sync_ctx = std::make_shared<Context>();
+  sync_ctx->SetRegionId(ctx->RegionId());
+  sync_ctx->SetRegionEpoch(ctx->RegionEpoch());
+  sync_ctx->SetCfName(ctx->CfName());
+  sync_ctx->SetRawEngineType(ctx->RawEngineType());
+  sync_ctx->SetStoreEngineType(ctx->StoreEngineType());
+  sync_ctx->SetTracker(ctx->Tracker());
+
+  for (size_t i = 0; i + 1 < chunks.size(); ++i) {
+    auto ret = raft_engine->Write(sync_ctx, WriteDataBuilder::BuildWrite(chunks[i]));
+    if (!ret.ok()) {
+      return ret;
+    }
+  }
+
+  return RaftEngineWrite(raft_engine, ctx, WriteDataBuilder::BuildWrite(chunks.back()));
+}
+
+// One pc commits the whole txn by this prewrite, so the primary key must be one of the mutations and all of them
+// must be in the region.
+static butil::Status ValidateOnePcKeys(store::RegionPtr region, const std::vector<pb::store::Mutation> &mutations,
+                                       const std::string &primary_lock) {
+  const auto &range = region->Range();
+  bool has_primary = false;
+  for (const auto &mutation : mutations) {
+    if (range.start_key().compare(mutation.key()) > 0 || range.end_key().compare(mutation.key()) <= 0) {
+      return butil::Status(pb::error::Errno::EKEY_OUT_OF_RANGE,
+                           fmt::format("one pc key out of range, region range[{}-{}] key[{}]",
+                                       Helper::StringToHex(range.start_key()), Helper::StringToHex(range.end_key()),
+                                       Helper::StringToHex(mutation.key())));
+    }
+    has_primary = has_primary || mutation.key() == primary_lock;
+  }
+
+  if (!has_primary) {
+    return butil::Status(pb::error::Errno::EILLEGAL_PARAMTETERS, "one pc primary_lock is not in mutations");
+  }
+
+  return butil::Status();
+}
 
 butil::Status TxnEngineHelper::Prewrite(RawEnginePtr raw_engine, std::shared_ptr<Engine> raft_engine,
                                         std::shared_ptr<Context> ctx, const std::vector<pb::store::Mutation> &mutations,
@@ -1806,10 +2560,34 @@ butil::Status TxnEngineHelper::Prewrite(RawEnginePtr raw_engine, std::shared_ptr
     return butil::Status(pb::error::Errno::EREGION_NOT_FOUND, "region is not found");
   }
 
+  // Prewrite and commit the txn in one raft log. The client skips commit after a successful one pc prewrite, so
+  // try_one_pc is rejected instead of falling back to two phase commit.
+  bool is_one_pc = try_one_pc;
+  if (is_one_pc && !FLAGS_enable_txn_one_pc) {
+    DINGO_LOG(WARNING) << fmt::format("[txn][region({})] Prewrite, start_ts: {}", region->Id(), start_ts)
+                       << ", one pc is disabled";
+    return butil::Status(pb::error::Errno::ENOT_SUPPORT, "one pc is disabled");
+  }
+  if (is_one_pc && RegionResolvedTs::IsEnabled()) {
+    // the commit_ts is got before the write applied, it may be less than the resolved ts.
+    DINGO_LOG(WARNING) << fmt::format("[txn][region({})] Prewrite, start_ts: {}", region->Id(), start_ts)
+                       << ", one pc is not supported when resolved ts is enabled";
+    return butil::Status(pb::error::Errno::EILLEGAL_PARAMTETERS, "one pc is not supported when resolved ts is enabled");
+  }
+  if (is_one_pc) {
+    auto status = ValidateOnePcKeys(region, mutations, primary_lock);
+    if (!status.ok()) {
+      DINGO_LOG(WARNING) << fmt::format("[txn][region({})] Prewrite, start_ts: {}", region->Id(), start_ts)
+                         << ", one pc validate keys failed, status: " << status.error_str();
+      return status;
+    }
+  }
+
   std::vector<pb::common::KeyValue> kv_puts_data;
   std::vector<pb::common::KeyValue> kv_puts_lock;
   std::vector<std::string> kv_dels_lock;  // for PutIfAbsent on pessimistic lock, if key is exists, no put will be
                                           // done, need to delete the lock in prewrite
+  std::vector<pb::store::LockInfo> one_pc_lock_infos;
 
   auto *response = dynamic_cast<pb::store::TxnPrewriteResponse *>(ctx->Response());
   if (response == nullptr) {
@@ -1858,6 +2636,9 @@ butil::Status TxnEngineHelper::Prewrite(RawEnginePtr raw_engine, std::shared_ptr
     if (!pessimistic_checks.empty() && pessimistic_checks[i] == 1) {
       need_check_pessimistic_lock = true;
     }
+    // the pessimistic lock is lost, e.g. an in memory lock dropped on leader change, so no writer was blocked since
+    // the lock time, a commit not before this ts conflicts
+    int64_t lost_lock_check_ts = 0;
 
     // for optimistic prewrite
     if (!need_check_pessimistic_lock) {
@@ -1956,6 +2737,13 @@ butil::Status TxnEngineHelper::Prewrite(RawEnginePtr raw_engine, std::shared_ptr
           // need response to client
           continue;
         }
+      } else {
+        lost_lock_check_ts =
+            for_update_ts_checks.find(i) != for_update_ts_checks.end() ? for_update_ts_checks.at(i) : start_ts;
+        DINGO_LOG_IF(INFO, FLAGS_dingo_log_switch_txn_detail)
+            << fmt::format("[txn][region({})] Prewrite,", region->Id())
+            << ", key: " << Helper::StringToHex(mutation.key())
+            << " pessimistic lock is not found, check commit since: " << lost_lock_check_ts;
       }
     }
 
@@ -1998,7 +2786,7 @@ butil::Status TxnEngineHelper::Prewrite(RawEnginePtr raw_engine, std::shared_ptr
     // if there is a commit, there will be a key | commit_ts : WriteInfo| in write_cf
     // for optimistic prewrite, we need to check if commit_ts >= start_ts
     // for pessimistic prewrite, we need to check if commit_ts >= for_update_ts, but this check is done in lock
-    // phase, so we do not need to check here
+    // phase, so we do not need to check here, unless the pessimistic lock is lost
     int64_t commit_ts = 0;
     auto ret2 =
         txn_reader.GetWriteInfo(0, Constant::kMaxVer, 0, mutation.key(), false, true, true, write_info, commit_ts);
@@ -2014,6 +2802,14 @@ butil::Status TxnEngineHelper::Prewrite(RawEnginePtr raw_engine, std::shared_ptr
         << ", write_info: " << write_info.ShortDebugString();
 
     if (commit_ts >= start_ts) {
+      if (is_one_pc && write_info.start_ts() == start_ts) {
+        DINGO_LOG_IF(INFO, FLAGS_dingo_log_switch_txn_detail)
+            << fmt::format("[txn][region({})] Prewrite", region->Id())
+            << ", key: " << Helper::StringToHex(mutation.key()) << " is already one pc committed, this is a repeated prewrite, skip it, start_ts: " << start_ts
+            << ", commit_ts: " << commit_ts;
+        continue;
+      }
+
       if (!need_check_pessimistic_lock) {
         DINGO_LOG_IF(INFO, FLAGS_dingo_log_switch_txn_detail)
             << "Optimistic Prewrite find this transaction is committed after start_ts,return "
@@ -2035,6 +2831,18 @@ butil::Status TxnEngineHelper::Prewrite(RawEnginePtr raw_engine, std::shared_ptr
             << fmt::format("[txn][region({})] Prewrite", region->Id()) << ", write_conflict, start_ts: " << start_ts
             << ", commit_ts: " << commit_ts << ", write_info: " << write_info.ShortDebugString();
         break;
+      } else if (lost_lock_check_ts > 0 && commit_ts >= lost_lock_check_ts) {
+        DINGO_LOG_IF(INFO, FLAGS_dingo_log_switch_txn_detail)
+            << "Pessimistic Prewrite lost its pessimistic lock and find a commit after lock, return WriteConflict "
+               "start_ts: "
+            << start_ts << ", for_update_ts: " << lost_lock_check_ts << ", commit_ts: " << commit_ts;
+
+        auto *write_conflict = response->add_txn_result()->mutable_write_conflict();
+        write_conflict->set_reason(::dingodb::pb::store::WriteConflict_Reason::WriteConflict_Reason_PessimisticRetry);
+        write_conflict->set_start_ts(start_ts);
+        write_conflict->set_conflict_ts(commit_ts);
+        write_conflict->set_key(mutation.key());
+        break;
       } else {
         DINGO_LOG_IF(INFO, FLAGS_dingo_log_switch_txn_detail)
             << "Pessimistic Prewrite find this transaction is committed after start_ts, it's ok. start_ts: " << start_ts
@@ -2050,6 +2858,11 @@ butil::Status TxnEngineHelper::Prewrite(RawEnginePtr raw_engine, std::shared_ptr
       return butil::Status::OK();
     }
 
+    // the lock of repeated prewrite is already in lock cf, one pc need commit it too
+    if (is_one_pc && is_repeated_prewrite) {
+      one_pc_lock_infos.push_back(prev_lock_info);
+    }
+
     // 3.do Put/Delete/PutIfAbsent
     if (mutation.op() == pb::store::Op::Put) {
       if (BAIDU_UNLIKELY(is_repeated_prewrite)) {
@@ -2262,6 +3075,68 @@ butil::Status TxnEngineHelper::Prewrite(RawEnginePtr raw_engine, std::shared_ptr
     }
   }
 
+  if (is_one_pc) {
+    for (const auto &kv : kv_puts_lock) {
+      pb::store::LockInfo lock_info;
+      lock_info.ParseFromString(kv.value());
+      one_pc_lock_infos.push_back(lock_info);
+    }
+    if (one_pc_lock_infos.empty()) {
+      return butil::Status::OK();
+    }
+
+    // the keys stay in flight until the commit is applied, a reader gets start_ts >= commit_ts waits for it
+    std::vector<std::string> one_pc_keys;
+    one_pc_keys.reserve(one_pc_lock_infos.size());
+    for (const auto &lock_info : one_pc_lock_infos) {
+      one_pc_keys.push_back(lock_info.key());
+    }
+    auto one_pc_holder = TxnOnePcKeys::GetInstance().Add(one_pc_keys);
+
+    // the tso is greater than start_ts of every txn which may read the old value
+    int64_t commit_ts = 0;
+    auto ret = GetTso(commit_ts);
+    if (!ret.ok()) {
+      DINGO_LOG(ERROR) << fmt::format("[txn][region({})] Prewrite, start_ts: {}", region->Id(), start_ts)
+                       << ", one pc get commit_ts failed, status: " << ret.error_str();
+      error->set_errcode(static_cast<pb::error::Errno>(ret.error_code()));
+      error->set_errmsg(ret.error_str());
+      return ret;
+    }
+
+    if (max_commit_ts > 0 && commit_ts > max_commit_ts) {
+      DINGO_LOG(WARNING) << fmt::format("[txn][region({})] Prewrite, start_ts: {}", region->Id(), start_ts)
+                         << ", one pc commit_ts: " << commit_ts << " is greater than max_commit_ts: " << max_commit_ts;
+      error->set_errcode(pb::error::Errno::EILLEGAL_PARAMTETERS);
+      error->set_errmsg("one pc commit_ts is greater than max_commit_ts");
+      return butil::Status(pb::error::Errno::EILLEGAL_PARAMTETERS, "one pc commit_ts is greater than max_commit_ts");
+    }
+
+    DINGO_LOG_IF(INFO, FLAGS_dingo_log_switch_txn_detail)
+        << fmt::format("[txn][region({})] Prewrite one pc, start_ts: {}, commit_ts: {}", region->Id(), start_ts,
+                       commit_ts)
+        << ", kv_puts_data_size: " << kv_puts_data.size() << ", lock_infos_size: " << one_pc_lock_infos.size();
+
+    one_pc_holder->SetCommitTs(commit_ts);
+    ret = DoTxnCommit(raw_engine, raft_engine, ctx, region, one_pc_lock_infos, start_ts, commit_ts, kv_puts_data,
+                      [one_pc_holder]() { one_pc_holder->Release(); });
+    // the async write releases the keys after apply
+    if (!ret.ok() || ctx->Done() == nullptr) {
+      one_pc_holder->Release();
+    }
+    if (!ret.ok()) {
+      DINGO_LOG(ERROR) << fmt::format("[txn][region({})] Prewrite one pc, start_ts: {}, commit_ts: {}", region->Id(),
+                                      start_ts, commit_ts)
+                       << ", do txn commit failed, status: " << ret.error_str();
+      error->set_errcode(static_cast<pb::error::Errno>(ret.error_code()));
+      error->set_errmsg(ret.error_str());
+      return ret;
+    }
+
+    g_txn_one_pc_count << 1;
+    return butil::Status::OK();
+  }
+
   if (kv_puts_data.empty() && kv_puts_lock.empty()) {
     DINGO_LOG_IF(INFO, FLAGS_dingo_log_switch_txn_detail)
         << fmt::format("[txn][region({})] Prewrite return empty kv_puts_data and kv_puts_lock,", region->Id())
@@ -2271,6 +3146,17 @@ butil::Status TxnEngineHelper::Prewrite(RawEnginePtr raw_engine, std::shared_ptr
     return butil::Status::OK();
   }
 
+  if (FLAGS_txn_prewrite_max_raft_entry_size > 0 &&
+      KvsSize(kv_puts_data) + KvsSize(kv_puts_lock) > FLAGS_txn_prewrite_max_raft_entry_size) {
+    auto ret = PrewriteInChunks(raft_engine, ctx, kv_puts_data, kv_puts_lock);
+    if (ret.error_code() == EPERM) {
+      DINGO_LOG(ERROR) << fmt::format("[txn][region({})] Prewrite in chunks", region->Id())
+                       << ", write raft engine failed, status: " << ret.error_str();
+      return butil::Status(pb::error::Errno::ERAFT_NOTLEADER, ret.error_str());
+    }
+    return ret;
+  }
+
   // after all mutations is processed, write into raft engine
   pb::raft::TxnRaftRequest txn_raft_request;
   auto *cf_put_delete = txn_raft_request.mutable_multi_cf_put_and_delete();
@@ -2300,7 +3186,7 @@ butil::Status TxnEngineHelper::Prewrite(RawEnginePtr raw_engine, std::shared_ptr
       << ", kv_puts_lock_size: " << kv_puts_lock.size() << ", start_ts: " << start_ts
       << ", region_epoch: " << ctx->RegionEpoch().ShortDebugString() << ", mutations_size: " << mutations.size();
 
-  auto ret = raft_engine->Write(ctx, WriteDataBuilder::BuildWrite(txn_raft_request));
+  auto ret = RaftEngineWrite(raft_engine, ctx, WriteDataBuilder::BuildWrite(txn_raft_request));
   if (ret.error_code() == EPERM) {
     DINGO_LOG(ERROR) << fmt::format("[txn][region({})] Prewrite", region->Id())
                      << ", write raft engine failed, status: " << ret.error_str();
@@ -2539,7 +3425,8 @@ bvar::LatencyRecorder g_txn_do_commit_latency("dingo_txn_do_commit");
 butil::Status TxnEngineHelper::DoTxnCommit(RawEnginePtr raw_engine, std::shared_ptr<Engine> raft_engine,
                                            std::shared_ptr<Context> ctx, store::RegionPtr region,
                                            const std::vector<pb::store::LockInfo> &lock_infos, int64_t start_ts,
-                                           int64_t commit_ts) {
+                                           int64_t commit_ts, const std::vector<pb::common::KeyValue> &kv_puts_data,
+                                           std::function<void()> on_applied) {
   BvarLatencyGuard bvar_guard(&g_txn_do_commit_latency);
 
   DINGO_LOG_IF(INFO, FLAGS_dingo_log_switch_txn_detail)
@@ -2564,6 +3451,17 @@ butil::Status TxnEngineHelper::DoTxnCommit(RawEnginePtr raw_engine, std::shared_
   auto *document_add = cf_put_delete->mutable_document_add();
   auto *document_del = cf_put_delete->mutable_document_del();
 
+  // for one pc, the data is not in data cf yet, put it in the same raft log
+  std::map<std::string, std::string> one_pc_datas;
+  if (!kv_puts_data.empty()) {
+    auto *data_puts = cf_put_delete->add_puts_with_cf();
+    data_puts->set_cf_name(Constant::kTxnDataCF);
+    for (const auto &kv_put : kv_puts_data) {
+      *data_puts->add_kvs() = kv_put;
+      one_pc_datas.insert_or_assign(kv_put.key(), kv_put.value());
+    }
+  }
+
   // for every key, check and do commit, if primary key is failed, the whole commit is failed
   for (const auto &lock_info : lock_infos) {
     // 1.delete lock from lock_cf
@@ -2581,12 +3479,18 @@ butil::Status TxnEngineHelper::DoTxnCommit(RawEnginePtr raw_engine, std::shared_
     if (!lock_info.short_value().empty()) {
       data_value = lock_info.short_value();
     } else if (lock_info.lock_type() == pb::store::Put) {
-      auto ret = reader->KvGet(Constant::kTxnDataCF, Helper::EncodeTxnKey(lock_info.key(), start_ts), data_value);
-      if (!ret.ok() && ret.error_code() != pb::error::Errno::EKEY_NOT_FOUND) {
-        DINGO_LOG(FATAL) << fmt::format("[txn][region({})] DoTxnCommit, start_ts: {} commit_ts: {}", region->Id(),
-                                        start_ts, commit_ts)
-                         << ", get data failed, key: " << lock_info.key() << ", start_ts: " << start_ts
-                         << ", status: " << ret.error_str() << ", lock_info: " << lock_info.ShortDebugString();
+      std::string data_key = Helper::EncodeTxnKey(lock_info.key(), start_ts);
+      auto it = one_pc_datas.find(data_key);
+      if (it != one_pc_datas.end()) {
+        data_value = it->second;
+      } else {
+        auto ret = reader->KvGet(Constant::kTxnDataCF, data_key, data_value);
+        if (!ret.ok() && ret.error_code() != pb::error::Errno::EKEY_NOT_FOUND) {
+          DINGO_LOG(FATAL) << fmt::format("[txn][region({})] DoTxnCommit, start_ts: {} commit_ts: {}", region->Id(),
+                                          start_ts, commit_ts)
+                           << ", get data failed, key: " << lock_info.key() << ", start_ts: " << start_ts
+                           << ", status: " << ret.error_str() << ", lock_info: " << lock_info.ShortDebugString();
+        }
       }
     }
 
@@ -2699,7 +3603,7 @@ butil::Status TxnEngineHelper::DoTxnCommit(RawEnginePtr raw_engine, std::shared_
     }
   }
 
-  auto ret = raft_engine->Write(ctx, WriteDataBuilder::BuildWrite(txn_raft_request));
+  auto ret = RaftEngineWrite(raft_engine, ctx, WriteDataBuilder::BuildWrite(txn_raft_request), on_applied);
   if (ret.error_code() == EPERM) {
     DINGO_LOG(ERROR) << fmt::format("[txn][region({})] DoTxnCommit, start_ts: {} commit_ts: {}", region->Id(), start_ts,
                                     commit_ts)
@@ -3554,6 +4458,7 @@ butil::Status TxnEngineHelper::DoGc(RawEnginePtr raw_engine, std::shared_ptr<Eng
   IteratorOptions write_iter_options;
   write_iter_options.lower_bound = Helper::EncodeTxnKey(region_start_key, Constant::kMaxVer);
   write_iter_options.upper_bound = Helper::EncodeTxnKey(region_end_key, -1);
+  write_iter_options.long_scan = true;
 
   auto write_iter = reader->NewIterator(Constant::kTxnWriteCF, snapshot, write_iter_options);
   if (nullptr == write_iter) {
@@ -3789,6 +4694,7 @@ butil::Status TxnEngineHelper::CheckLockForGc(RawEngine::ReaderPtr reader, std::
   IteratorOptions lock_iter_options;
   lock_iter_options.lower_bound = Helper::EncodeTxnKey(start_key, Constant::kLockVer);
   lock_iter_options.upper_bound = Helper::EncodeTxnKey(end_key, 0);
+  lock_iter_options.long_scan = true;
 
   std::shared_ptr<dingodb::Iterator> lock_iter = reader->NewIterator(Constant::kTxnLockCF, snapshot, lock_iter_options);
   if (nullptr == lock_iter) {
@@ -4022,6 +4928,62 @@ void TxnEngineHelper::RegularUpdateSafePointTsHandler(void * /*arg*/) {
 #endif
 #undef ENABLE_TXN_GC_REMEMBER_LAST_ACCOMPLISHED_SAFE_POINT_TS
 
+DECLARE_int32(txn_gc_compaction_filter_region_num_per_round);
+DECLARE_int64(resolved_ts_max_scan_lock_count);
+
+// Compaction filter mode, compact the write cf of a few regions whose gc ts is behind, the oldest first.
+static void CompactRegionsForGc(std::shared_ptr<GCSafePoint> gc_safe_point, int64_t safe_point_ts) {
+  auto raw_engine =
+      std::dynamic_pointer_cast<RocksRawEngine>(Server::GetInstance().GetRawEngine(pb::common::RAW_ENG_ROCKSDB));
+  if (raw_engine == nullptr) {
+    return;
+  }
+
+  auto &compaction_filter_gc = CompactionFilterGc::GetInstance();
+
+  std::set<int64_t> region_ids;
+  std::vector<std::pair<int64_t, store::RegionPtr>> behind_regions;
+  for (auto &region : Server::GetInstance().GetAllAliveRegion()) {
+    if (!region->IsTxn() || region->GetRawEngineType() != pb::common::RAW_ENG_ROCKSDB) {
+      continue;
+    }
+    region_ids.insert(region->Id());
+
+    int64_t gc_ts = compaction_filter_gc.GetRegionGcTs(region->Id());
+    if (region->State() == pb::common::StoreRegionState::NORMAL && gc_ts < safe_point_ts) {
+      behind_regions.emplace_back(gc_ts, region);
+    }
+  }
+  compaction_filter_gc.RetainRegions(region_ids);
+
+  std::sort(behind_regions.begin(), behind_regions.end(),
+            [](const auto &lhs, const auto &rhs) { return lhs.first < rhs.first; });
+
+  int32_t count = 0;
+  for (auto &[gc_ts, region] : behind_regions) {
+    if (count++ >= FLAGS_txn_gc_compaction_filter_region_num_per_round) {
+      break;
+    }
+
+    auto [gc_stop, _] = gc_safe_point->GetGcFlagAndSafePointTs();
+    if (gc_stop) {
+      compaction_filter_gc.SetSafePointTs(0);
+      return;
+    }
+
+    int64_t start_time_ms = Helper::TimestampMs();
+    auto status = raw_engine->CompactRange(Constant::kTxnWriteCF, Helper::GetMemComparableRange(region->Range()));
+    if (!status.ok()) {
+      continue;
+    }
+    compaction_filter_gc.SetRegionGcTs(region->Id(), safe_point_ts);
+
+    DINGO_LOG_IF(INFO, FLAGS_dingo_log_switch_txn_detail) << fmt::format(
+        "[txn_gc][compaction][region({})] compact write cf, gc_ts: {} -> {} time consuming: {} ms", region->Id(),
+        gc_ts, safe_point_ts, Helper::TimestampMs() - start_time_ms);
+  }
+}
+
 void TxnEngineHelper::RegularDoGcHandler(void * /*arg*/) {
   static std::atomic<bool> g_regular_do_gc_handler_running(false);
 
@@ -4041,6 +5003,9 @@ void TxnEngineHelper::RegularDoGcHandler(void * /*arg*/) {
   if (gc_stop) {
     DINGO_LOG_IF(INFO, FLAGS_dingo_log_switch_txn_detail)
         << fmt::format("[txn_gc] set gc_flag stop, return. safe_point_ts : {}", safe_point_ts);
+    if (CompactionFilterGc::IsEnabled()) {
+      CompactionFilterGc::GetInstance().SetSafePointTs(0);
+    }
     return;
   }
 
@@ -4055,6 +5020,17 @@ void TxnEngineHelper::RegularDoGcHandler(void * /*arg*/) {
 
   gc_safe_point->SetForceGcStop(false);
 
+  // the regions of rocksdb are gc by compaction filter, no raft delete.
+  if (CompactionFilterGc::IsEnabled()) {
+    CompactionFilterGc::GetInstance().SetSafePointTs(safe_point_ts);
+    bool started = CompactionFilterGc::GetInstance().CompactInBackground(
+        [gc_safe_point, safe_point_ts]() { CompactRegionsForGc(gc_safe_point, safe_point_ts); });
+    if (!started) {
+      DINGO_LOG(INFO) << fmt::format("[txn_gc][compaction] last round is running, skip. safe_point_ts: {}",
+                                     safe_point_ts);
+    }
+  }
+
 #if defined(ENABLE_TXN_GC_REMEMBER_LAST_ACCOMPLISHED_SAFE_POINT_TS)
   int64_t last_accomplished_safe_point_ts = gc_safe_point->GetLastAccomplishedSafePointTs();
   if (last_accomplished_safe_point_ts <= safe_point_ts) {
@@ -4073,6 +5049,10 @@ void TxnEngineHelper::RegularDoGcHandler(void * /*arg*/) {
   std::shared_ptr<Storage> storage = Server::GetInstance().GetStorage();
 
   for (auto &region_ptr : region_ptrs) {
+    if (CompactionFilterGc::IsEnabled() && region_ptr->GetRawEngineType() == pb::common::RAW_ENG_ROCKSDB) {
+      continue;
+    }
+
     butil::Status status;
     status = storage->ValidateLeader(region_ptr);
 
@@ -4167,4 +5147,103 @@ void TxnEngineHelper::RegularDoGcHandler(void * /*arg*/) {
       << fmt::format("[txn_gc] gc task end. safe_point_ts : {}", safe_point_ts);
 }
 
+// Get min lock_ts of region, INT64_MAX if there is no lock, 0 if unknown.
+// Use the lock index when it is trusted, otherwise scan the lock cf of region, at most
+// FLAGS_resolved_ts_max_scan_lock_count locks, a region with more locks is unknown in this round.
+static int64_t GetMinLockTs(RawEnginePtr raw_engine, const pb::common::Range &range) {
+  int64_t min_lock_ts = INT64_MAX;
+  if (TxnLockIndex::IsEnabled() &&
+      TxnLockIndex::GetInstance().GetMinLockTs(range.start_key(), range.end_key(), min_lock_ts)) {
+    return min_lock_ts;
+  }
+
+  IteratorOptions iter_options;
+  iter_options.lower_bound = Helper::EncodeTxnKey(range.start_key(), Constant::kLockVer);
+  iter_options.upper_bound = Helper::EncodeTxnKey(range.end_key(), Constant::kLockVer);
+
+  auto iter = raw_engine->Reader()->NewIterator(Constant::kTxnLockCF, iter_options);
+  if (iter == nullptr) {
+    return 0;
+  }
+
+  int64_t count = 0;
+  for (iter->Seek(iter_options.lower_bound); iter->Valid(); iter->Next()) {
+    if (++count > FLAGS_resolved_ts_max_scan_lock_count) {
+      return 0;
+    }
+
+    pb::store::LockInfo lock_info;
+    if (!lock_info.ParseFromArray(iter->Value().data(), iter->Value().size())) {
+      DINGO_LOG(ERROR) << "[txn]parse lock info failed, key: " << Helper::StringToHex(iter->Key());
+      return 0;
+    }
+    if (lock_info.lock_ts() > 0) {
+      min_lock_ts = std::min(min_lock_ts, lock_info.lock_ts());
+    }
+  }
+
+  return min_lock_ts;
+}
+
+void TxnEngineHelper::RegularAdvanceResolvedTsHandler(void * /*arg*/) {
+  static std::atomic<bool> g_regular_advance_resolved_ts_handler_running(false);
+
+  if (g_regular_advance_resolved_ts_handler_running.load(std::memory_order_relaxed)) {
+    return;
+  }
+
+  AtomicGuard guard(g_regular_advance_resolved_ts_handler_running);
+
+  // The tso must be got before read index, so every txn committed not greater than it already have lock or write
+  // applied at the read index. A tso allocated earlier also works, it only lag the resolved ts.
+  int64_t tso = 0;
+  auto status = GetLowerBoundTso(tso);
+  if (!status.ok()) {
+    DINGO_LOG(WARNING) << fmt::format("[txn.resolved_ts] get tso failed, error: {} {}",
+                                      pb::error::Errno_Name(status.error_code()), status.error_str());
+    return;
+  }
+
+  auto storage = Server::GetInstance().GetStorage();
+  auto &region_resolved_ts = RegionResolvedTs::GetInstance();
+  auto regions = Server::GetInstance().GetAllAliveRegion();
+
+  // evict the regions deleted, moved out or no longer normal
+  std::set<int64_t> normal_region_ids;
+  for (auto &region : regions) {
+    if (region->IsTxn() && region->GetStoreEngineType() == pb::common::STORE_ENG_RAFT_STORE &&
+        region->State() == pb::common::StoreRegionState::NORMAL) {
+      normal_region_ids.insert(region->Id());
+    }
+  }
+  region_resolved_ts.EraseNotIn(normal_region_ids);
+
+  for (auto &region : regions) {
+    if (normal_region_ids.count(region->Id()) == 0) {
+      continue;
+    }
+
+    status = storage->ReadIndex(region->Id());
+    if (!status.ok()) {
+      DINGO_LOG_IF(INFO, FLAGS_dingo_log_switch_txn_detail) << fmt::format(
+          "[txn.resolved_ts][region({})] read index failed, error: {}", region->Id(), status.error_str());
+      continue;
+    }
+
+    auto raw_engine = Server::GetInstance().GetRawEngine(region->GetRawEngineType());
+    int64_t min_lock_ts = GetMinLockTs(raw_engine, region->Range());
+    int64_t resolved_ts = std::min(tso, min_lock_ts);
+    if (resolved_ts > 0) {
+      region_resolved_ts.Advance(region->Id(), resolved_ts);
+      if (ChangeCapture::IsEnabled()) {
+        ChangeCapture::GetInstance().AdvanceResolvedTs(region->Id(), region_resolved_ts.Get(region->Id()));
+      }
+    }
+
+    DINGO_LOG_IF(INFO, FLAGS_dingo_log_switch_txn_detail)
+        << fmt::format("[txn.resolved_ts][region({})] tso({}) min_lock_ts({}) resolved_ts({})", region->Id(), tso,
+                       min_lock_ts, region_resolved_ts.Get(region->Id()));
+  }
+}
+
 }  // namespace dingodb
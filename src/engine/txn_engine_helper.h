@@ -18,6 +18,7 @@
 #include <sys/stat.h>
 
 #include <cstdint>
+#include <functional>
 #include <memory>
 #include <vector>
 
@@ -42,6 +43,11 @@ class TxnReader {
   butil::Status Init();
   butil::Status GetLockInfo(const std::string &key, pb::store::LockInfo &lock_info);
   butil::Status GetDataValue(const std::string &key, std::string &value);
+  // Batched GetLockInfo and GetDataValue by one raw engine multi get, lock_infos[i] and values[i] are of keys[i],
+  // a not found data key is EKEY_NOT_FOUND in statuses[i].
+  butil::Status BatchGetLockInfo(const std::vector<std::string> &keys, std::vector<pb::store::LockInfo> &lock_infos);
+  butil::Status BatchGetDataValue(const std::vector<std::string> &keys, std::vector<std::string> &values,
+                                  std::vector<butil::Status> &statuses);
   butil::Status GetWriteInfo(int64_t min_commit_ts, int64_t max_commit_ts, int64_t start_ts, const std::string &key,
                              bool include_rollback, bool include_delete, bool include_put,
                              pb::store::WriteInfo &write_info, int64_t &commit_ts);
@@ -57,17 +63,23 @@ class TxnReader {
   RawEngine::ReaderPtr reader_;
 
   std::shared_ptr<Iterator> write_iter_;
+
+  // sequence of TxnLockIndex before take snapshot, negative is unknown.
+  int64_t lock_index_sequence_{-1};
 };
 
 class TxnIterator {
  public:
   TxnIterator(RawEnginePtr raw_engine, const pb::common::Range &range, int64_t start_ts,
-              pb::store::IsolationLevel isolation_level, const std::set<int64_t> &resolved_locks)
+              pb::store::IsolationLevel isolation_level, const std::set<int64_t> &resolved_locks,
+              bool long_scan = false, SnapshotPtr snapshot = nullptr)
       : raw_engine_(raw_engine),
         range_(range),
         isolation_level_(isolation_level),
         start_ts_(start_ts),
-        resolved_locks_(resolved_locks) {
+        snapshot_(snapshot),
+        resolved_locks_(resolved_locks),
+        long_scan_(long_scan) {
     if (isolation_level == pb::store::IsolationLevel::ReadCommitted) {
       seek_ts_ = Constant::kMaxVer;
     } else {
@@ -85,20 +97,29 @@ class TxnIterator {
   std::string Key();
   std::string Value();
 
+  // Defer the data cf read of a row until Value() is called, set before Seek.
+  // The rows dropped by the caller cost no data cf read, and the survivors can be read in one BatchGetValue.
+  void SetLazyValue(bool lazy_value) { lazy_value_ = lazy_value; }
+  // The data cf key of the current row if its value is not read yet, otherwise empty.
+  const std::string &ValueDataKey() const { return value_data_key_; }
+  // Read the values of data keys got from ValueDataKey in one multi get, from the same snapshot as the iterator.
+  butil::Status BatchGetValue(const std::vector<std::string> &data_keys, std::vector<std::string> &values);
+
   std::string GetLastLockKey() { return last_lock_key_; }
   std::string GetLastWriteKey() { return last_write_key_; }
 
   static butil::Status GetUserValueInWriteIter(std::shared_ptr<Iterator> write_iter, RawEngine::ReaderPtr reader,
-                                               pb::store::IsolationLevel isolation_level, int64_t seek_ts,
-                                               int64_t start_ts, const std::string &user_key,
+                                               SnapshotPtr snapshot, pb::store::IsolationLevel isolation_level,
+                                               int64_t seek_ts, int64_t start_ts, const std::string &user_key,
                                                std::string &last_write_key, bool &is_value_found,
-                                               std::string &user_value);
+                                               std::string &user_value, std::string *data_key = nullptr);
   static std::string GetUserKey(std::shared_ptr<Iterator> write_iter);
   static butil::Status GotoNextUserKeyInWriteIter(std::shared_ptr<Iterator> write_iter, std::string prev_user_key,
                                                   std::string &last_write_key);
 
  private:
   butil::Status GetCurrentValue();
+  bool HasValue() const { return !value_.empty() || !value_data_key_.empty(); }
 
   RawEnginePtr raw_engine_;
   pb::common::Range range_;
@@ -116,10 +137,16 @@ class TxnIterator {
 
   std::string key_{};
   std::string value_{};
+  // data cf key of value_ not read yet, only in lazy value mode
+  std::string value_data_key_{};
+  bool lazy_value_{false};
 
   // The resolved locks are used to check the lock conflict.
   // If the lock is resolved, there will not be a conflict for provided resolved_locks.
   std::set<int64_t> resolved_locks_;
+
+  // prefetch write cf with readahead and async io
+  bool long_scan_;
 };
 
 class TxnEngineHelper {
@@ -144,11 +171,33 @@ class TxnEngineHelper {
                             const pb::common::CoprocessorV2 &coprocessor, pb::store::TxnResultInfo &txn_result_info,
                             std::vector<pb::common::KeyValue> &kvs, bool &has_more, std::string &end_scan_key);
 
+  // Split range into at most concurrency sub ranges of similar write cf size, return the range itself if it is
+  // too small to scan in parallel.
+  static std::vector<pb::common::Range> SplitScanRange(RawEnginePtr raw_engine, const pb::common::Range &range,
+                                                       int32_t concurrency);
+
+  // Scan the ordered sub ranges concurrently on one snapshot, the result is same as the sequential scan.
+  static butil::Status ParallelScan(RawEnginePtr raw_engine, const pb::store::IsolationLevel &isolation_level,
+                                    int64_t start_ts, const std::vector<pb::common::Range> &sub_ranges,
+                                    int64_t limit, bool key_only, const std::set<int64_t> &resolved_locks,
+                                    pb::store::TxnResultInfo &txn_result_info, std::vector<pb::common::KeyValue> &kvs,
+                                    bool &has_more, std::string &end_scan_key);
+
+  // Collect the visible kvs of txn_iter until limit, conflict or end.
+  // is_enough is called with the count and memory size collected after every kv, it stops the scan like the limit.
+  static void ScanTxnIterator(std::shared_ptr<TxnIterator> txn_iter, int64_t limit, bool key_only,
+                              pb::store::TxnResultInfo &txn_result_info, std::vector<pb::common::KeyValue> &kvs,
+                              bool &has_more, std::string &end_scan_key,
+                              const std::function<bool(int64_t, int64_t)> &is_enough = nullptr);
+
   // txn write functions
+  // kv_puts_data is the data of one pc prewrite, it is put to data cf together with commit.
+  // on_applied is called after the async raft write is applied or failed.
   static butil::Status DoTxnCommit(RawEnginePtr raw_engine, std::shared_ptr<Engine> raft_engine,
                                    std::shared_ptr<Context> ctx, store::RegionPtr region,
                                    const std::vector<pb::store::LockInfo> &lock_infos, int64_t start_ts,
-                                   int64_t commit_ts);
+                                   int64_t commit_ts, const std::vector<pb::common::KeyValue> &kv_puts_data = {},
+                                   std::function<void()> on_applied = nullptr);
 
   static butil::Status DoRollback(RawEnginePtr raw_engine, std::shared_ptr<Engine> raft_engine,
                                   std::shared_ptr<Context> ctx, std::vector<std::string> &keys_to_rollback_with_data,
@@ -166,6 +215,9 @@ class TxnEngineHelper {
                                            std::shared_ptr<Context> ctx, int64_t start_ts, int64_t for_update_ts,
                                            const std::vector<std::string> &keys);
 
+  // Async commit(the txn is committed once all prewrites succeed) is not supported. The primary LockInfo has no
+  // field for its secondary keys and TxnPrewriteRequest no async commit flag, without them CheckTxnStatus and
+  // ResolveLock can not decide the status of such a txn. A single region txn can use one pc(try_one_pc) instead.
   static butil::Status Prewrite(RawEnginePtr raw_engine, std::shared_ptr<Engine> raft_engine,
                                 std::shared_ptr<Context> ctx, const std::vector<pb::store::Mutation> &mutations,
                                 const std::string &primary_lock, int64_t start_ts, int64_t lock_ttl, int64_t txn_size,
@@ -223,7 +275,13 @@ class TxnEngineHelper {
                                         std::string &last_lock_end_key);                              // NOLINT
 
   static void RegularUpdateSafePointTsHandler(void *arg);
+  // Write the in memory pessimistic lock of region through raft, e.g. before transfer leader.
+  static butil::Status PersistMemoryPessimisticLock(std::shared_ptr<Engine> raft_engine, store::RegionPtr region);
+
   static void RegularDoGcHandler(void *arg);
+
+  // Advance the resolved ts of txn regions on this store, include follower.
+  static void RegularAdvanceResolvedTsHandler(void *arg);
 };
 
 }  // namespace dingodb
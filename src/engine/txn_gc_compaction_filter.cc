@@ -0,0 +1,191 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "engine/txn_gc_compaction_filter.h"
+
+#include <cstdint>
+#include <memory>
+#include <set>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "bthread/mutex.h"
+#include "bvar/reducer.h"
+#include "common/helper.h"
+#include "common/logging.h"
+#include "common/synchronization.h"
+#include "crontab/crontab.h"
+#include "fmt/core.h"
+#include "gflags/gflags.h"
+#include "proto/store.pb.h"
+
+namespace dingodb {
+
+DEFINE_bool(enable_txn_gc_compaction_filter, false,
+            "enable txn gc by rocksdb compaction filter of write cf, instead of raft delete");
+DEFINE_int32(txn_gc_compaction_filter_region_num_per_round, 8,
+             "max region num to compact write cf per gc round in compaction filter mode");
+
+static bvar::Adder<int64_t> g_txn_gc_compaction_filter_drop_count("dingo_txn_gc_compaction_filter_drop_count");
+
+CompactionFilterGc::CompactionFilterGc() { bthread_mutex_init(&mutex_, nullptr); }
+
+CompactionFilterGc::~CompactionFilterGc() { bthread_mutex_destroy(&mutex_); }
+
+CompactionFilterGc& CompactionFilterGc::GetInstance() {
+  static CompactionFilterGc instance;
+  return instance;
+}
+
+bool CompactionFilterGc::IsEnabled() { return FLAGS_enable_txn_gc_compaction_filter; }
+
+void CompactionFilterGc::SetDeleteDataFunc(DeleteDataFunc func) {
+  BAIDU_SCOPED_LOCK(mutex_);
+  delete_data_func_ = func;
+}
+
+void CompactionFilterGc::DeleteData(std::vector<std::string> data_keys) {
+  DeleteDataFunc func;
+  {
+    BAIDU_SCOPED_LOCK(mutex_);
+    func = delete_data_func_;
+  }
+  if (func == nullptr || data_keys.empty()) {
+    return;
+  }
+
+  Bthread bth([func, data_keys = std::move(data_keys)]() { func(data_keys); });
+}
+
+int64_t CompactionFilterGc::GetRegionGcTs(int64_t region_id) {
+  BAIDU_SCOPED_LOCK(mutex_);
+  auto it = region_gc_ts_.find(region_id);
+  return it != region_gc_ts_.end() ? it->second : 0;
+}
+
+void CompactionFilterGc::SetRegionGcTs(int64_t region_id, int64_t gc_ts) {
+  BAIDU_SCOPED_LOCK(mutex_);
+  region_gc_ts_[region_id] = gc_ts;
+}
+
+void CompactionFilterGc::RetainRegions(const std::set<int64_t>& region_ids) {
+  BAIDU_SCOPED_LOCK(mutex_);
+  for (auto it = region_gc_ts_.begin(); it != region_gc_ts_.end();) {
+    if (region_ids.count(it->first) == 0) {
+      it = region_gc_ts_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+bool CompactionFilterGc::CompactInBackground(std::function<void()> compact_func) {
+  bool expected = false;
+  if (!compacting_.compare_exchange_strong(expected, true)) {
+    return false;
+  }
+
+  Bthread bth([this, compact_func]() {
+    {
+      CrontabRunTimeGuard guard;
+      compact_func();
+    }
+    compacting_.store(false);
+  });
+
+  return true;
+}
+
+TxnGcCompactionFilter::TxnGcCompactionFilter(int64_t safe_point_ts,
+                                             CompactionFilterGc::DeleteDataFunc delete_data_func)
+    : safe_point_ts_(safe_point_ts), delete_data_func_(delete_data_func) {}
+
+TxnGcCompactionFilter::~TxnGcCompactionFilter() {
+  g_txn_gc_compaction_filter_drop_count << drop_count_;
+  if (delete_data_func_ != nullptr && !data_keys_.empty()) {
+    delete_data_func_(data_keys_);
+  }
+}
+
+rocksdb::CompactionFilter::Decision TxnGcCompactionFilter::FilterV2(int /*level*/, const rocksdb::Slice& key,
+                                                                    ValueType value_type,
+                                                                    const rocksdb::Slice& existing_value,
+                                                                    std::string* /*new_value*/,
+                                                                    std::string* /*skip_until*/) const {
+  if (value_type != ValueType::kValue) {
+    return Decision::kKeep;
+  }
+
+  std::string user_key;
+  int64_t write_ts = 0;
+  auto status = Helper::DecodeTxnKey(std::string_view(key.data(), key.size()), user_key, write_ts);
+  if (!status.ok()) {
+    return Decision::kKeep;
+  }
+
+  if (user_key != current_key_) {
+    current_key_ = std::move(user_key);
+    is_shadowed_ = false;
+  }
+
+  if (write_ts > safe_point_ts_) {
+    return Decision::kKeep;
+  }
+
+  pb::store::WriteInfo write_info;
+  if (!write_info.ParseFromArray(existing_value.data(), existing_value.size())) {
+    DINGO_LOG(ERROR) << fmt::format("[txn_gc][compaction] parse write info failed, key: {}",
+                                    Helper::StringToHex(std::string_view(key.data(), key.size())));
+    return Decision::kKeep;
+  }
+
+  if (!is_shadowed_) {
+    switch (write_info.op()) {
+      case pb::store::Op::Put:
+        [[fallthrough]];
+      case pb::store::Op::Delete:
+        is_shadowed_ = true;
+        return Decision::kKeep;
+      case pb::store::Op::Rollback:
+        ++drop_count_;
+        return Decision::kRemove;
+      default:
+        return Decision::kKeep;
+    }
+  }
+
+  if (write_info.op() == pb::store::Op::Put && write_info.short_value().empty()) {
+    data_keys_.push_back(Helper::EncodeTxnKey(current_key_, write_info.start_ts()));
+  }
+
+  ++drop_count_;
+  return Decision::kRemove;
+}
+
+std::unique_ptr<rocksdb::CompactionFilter> TxnGcCompactionFilterFactory::CreateCompactionFilter(
+    const rocksdb::CompactionFilter::Context& /*context*/) {
+  auto& compaction_filter_gc = CompactionFilterGc::GetInstance();
+  int64_t safe_point_ts = compaction_filter_gc.GetSafePointTs();
+  if (safe_point_ts <= 0) {
+    return nullptr;
+  }
+
+  return std::make_unique<TxnGcCompactionFilter>(safe_point_ts, [](const std::vector<std::string>& data_keys) {
+    CompactionFilterGc::GetInstance().DeleteData(data_keys);
+  });
+}
+
+}  // namespace dingodb
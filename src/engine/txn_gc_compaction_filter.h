@@ -0,0 +1,116 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_ENGINE_TXN_GC_COMPACTION_FILTER_H_
+#define DINGODB_ENGINE_TXN_GC_COMPACTION_FILTER_H_
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "bthread/types.h"
+#include "rocksdb/compaction_filter.h"
+#include "rocksdb/slice.h"
+
+namespace dingodb {
+
+// Txn gc in compaction filter mode, the mvcc versions of write cf older than gc safe point are dropped by the
+// compaction of rocksdb, without raft proposal. Every replica gc itself.
+// The regular gc task hands the safe point to the filter, and compacts the write cf of a few regions per round
+// whose gc ts is behind in background, so the cold region is reclaimed too.
+class CompactionFilterGc {
+ public:
+  // Delete the data cf keys of dropped write.
+  using DeleteDataFunc = std::function<void(const std::vector<std::string>& data_keys)>;
+
+  CompactionFilterGc();
+  ~CompactionFilterGc();
+
+  CompactionFilterGc(const CompactionFilterGc& rhs) = delete;
+  CompactionFilterGc& operator=(const CompactionFilterGc& rhs) = delete;
+  CompactionFilterGc(CompactionFilterGc&& rhs) = delete;
+  CompactionFilterGc& operator=(CompactionFilterGc&& rhs) = delete;
+
+  static CompactionFilterGc& GetInstance();
+
+  static bool IsEnabled();
+
+  // 0 is gc stop, the filter keeps everything.
+  void SetSafePointTs(int64_t safe_point_ts) { safe_point_ts_.store(safe_point_ts, std::memory_order_release); }
+  int64_t GetSafePointTs() const { return safe_point_ts_.load(std::memory_order_acquire); }
+
+  void SetDeleteDataFunc(DeleteDataFunc func);
+  // It writes db, run in background to not block compaction with write stall.
+  void DeleteData(std::vector<std::string> data_keys);
+
+  // The safe point ts at the last compaction of region, 0 if never.
+  int64_t GetRegionGcTs(int64_t region_id);
+  void SetRegionGcTs(int64_t region_id, int64_t gc_ts);
+  // Drop the region which is not alive.
+  void RetainRegions(const std::set<int64_t>& region_ids);
+
+  // The compaction of a round takes long, run it in background out of the gc task.
+  // Return false if the last round is still running, the round is skipped.
+  bool CompactInBackground(std::function<void()> compact_func);
+
+ private:
+  std::atomic<int64_t> safe_point_ts_{0};
+  std::atomic<bool> compacting_{false};
+
+  bthread_mutex_t mutex_;
+  DeleteDataFunc delete_data_func_;
+  std::map<int64_t, int64_t> region_gc_ts_;
+};
+
+// Filter of write cf, the versions of one key come in descending ts order.
+// The newest Put or Delete not greater than safe point shadows all the older versions, which are dropped.
+// Rollback not greater than safe point is dropped too. The shadowing version itself is kept, an older version
+// in a file out of this compaction may be behind it.
+class TxnGcCompactionFilter : public rocksdb::CompactionFilter {
+ public:
+  TxnGcCompactionFilter(int64_t safe_point_ts, CompactionFilterGc::DeleteDataFunc delete_data_func);
+  ~TxnGcCompactionFilter() override;
+
+  Decision FilterV2(int level, const rocksdb::Slice& key, ValueType value_type, const rocksdb::Slice& existing_value,
+                    std::string* new_value, std::string* skip_until) const override;
+
+  const char* Name() const override { return "TxnGcCompactionFilter"; }
+
+ private:
+  int64_t safe_point_ts_;
+  CompactionFilterGc::DeleteDataFunc delete_data_func_;
+
+  // padding user key of current versions.
+  mutable std::string current_key_;
+  mutable bool is_shadowed_{false};
+  mutable std::vector<std::string> data_keys_;
+  mutable int64_t drop_count_{0};
+};
+
+class TxnGcCompactionFilterFactory : public rocksdb::CompactionFilterFactory {
+ public:
+  std::unique_ptr<rocksdb::CompactionFilter> CreateCompactionFilter(
+      const rocksdb::CompactionFilter::Context& context) override;
+
+  const char* Name() const override { return "TxnGcCompactionFilterFactory"; }
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_ENGINE_TXN_GC_COMPACTION_FILTER_H_
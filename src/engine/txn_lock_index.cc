@@ -0,0 +1,224 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "engine/txn_lock_index.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "bthread/mutex.h"
+#include "bvar/passive_status.h"
+#include "common/constant.h"
+#include "common/helper.h"
+#include "common/logging.h"
+#include "fmt/core.h"
+#include "gflags/gflags.h"
+#include "proto/store.pb.h"
+
+namespace dingodb {
+
+DEFINE_bool(enable_txn_lock_index, false, "enable in memory index of lock cf keys, skip reading unlocked keys");
+DEFINE_uint32(txn_lock_index_shard_num, 64, "txn lock index shard num");
+
+static int64_t GetTxnLockIndexCount(void*) { return TxnLockIndex::GetInstance().Count(); }
+
+static bvar::PassiveStatus<int64_t> g_txn_lock_index_count("dingo_txn_lock_index_count", GetTxnLockIndexCount,
+                                                           nullptr);
+
+TxnLockIndex::TxnLockIndex(uint32_t shard_num) : shards_(std::max(shard_num, 1U)) {
+  for (auto& shard : shards_) {
+    bthread_mutex_init(&shard.mutex, nullptr);
+  }
+}
+
+TxnLockIndex::~TxnLockIndex() {
+  for (auto& shard : shards_) {
+    bthread_mutex_destroy(&shard.mutex);
+  }
+}
+
+TxnLockIndex& TxnLockIndex::GetInstance() {
+  static TxnLockIndex instance(FLAGS_txn_lock_index_shard_num);
+  return instance;
+}
+
+bool TxnLockIndex::IsEnabled() { return FLAGS_enable_txn_lock_index; }
+
+void TxnLockIndex::Add(const std::string& key, int64_t lock_ts) {
+  auto& shard = GetShard(key);
+  BAIDU_SCOPED_LOCK(shard.mutex);
+  auto& lock_tss = shard.keys[key];
+  if (std::find(lock_tss.begin(), lock_tss.end(), lock_ts) == lock_tss.end()) {
+    lock_tss.push_back(lock_ts);
+    shard.ts_keys.emplace(lock_ts, key);
+  }
+}
+
+void TxnLockIndex::EraseKey(Shard& shard, const std::string& key) {
+  auto it = shard.keys.find(key);
+  if (it == shard.keys.end()) {
+    return;
+  }
+  for (auto lock_ts : it->second) {
+    shard.ts_keys.erase(std::make_pair(lock_ts, key));
+  }
+  shard.keys.erase(it);
+}
+
+void TxnLockIndex::Erase(const std::string& key) {
+  int64_t sequence = sequence_.fetch_add(1, std::memory_order_acq_rel) + 1;
+
+  auto& shard = GetShard(key);
+  BAIDU_SCOPED_LOCK(shard.mutex);
+  EraseKey(shard, key);
+  shard.erase_sequence = sequence;
+}
+
+void TxnLockIndex::EraseRange(const std::string& start_key, const std::string& end_key) {
+  int64_t sequence = sequence_.fetch_add(1, std::memory_order_acq_rel) + 1;
+
+  for (auto& shard : shards_) {
+    BAIDU_SCOPED_LOCK(shard.mutex);
+    std::vector<std::string> range_keys;
+    for (const auto& [key, _] : shard.keys) {
+      if (key >= start_key && (end_key.empty() || key < end_key)) {
+        range_keys.push_back(key);
+      }
+    }
+    for (const auto& key : range_keys) {
+      EraseKey(shard, key);
+    }
+    shard.erase_sequence = sequence;
+  }
+}
+
+bool TxnLockIndex::MayLocked(const std::string& key, int64_t sequence) {
+  if (sequence < 0 || building_count_.load(std::memory_order_acquire) > 0) {
+    return true;
+  }
+
+  auto& shard = GetShard(key);
+  BAIDU_SCOPED_LOCK(shard.mutex);
+  return shard.erase_sequence > sequence || shard.keys.count(key) > 0;
+}
+
+bool TxnLockIndex::GetKeysByTs(int64_t min_lock_ts, int64_t max_lock_ts, const std::string& start_key,
+                               const std::string& end_key, int64_t max_count, std::vector<std::string>& keys) {
+  if (building_count_.load(std::memory_order_acquire) > 0) {
+    return false;
+  }
+
+  size_t origin_size = keys.size();
+  for (auto& shard : shards_) {
+    BAIDU_SCOPED_LOCK(shard.mutex);
+    for (auto it = shard.ts_keys.lower_bound(std::make_pair(min_lock_ts, std::string()));
+         it != shard.ts_keys.end() && it->first < max_lock_ts; ++it) {
+      const auto& key = it->second;
+      if (key >= start_key && (end_key.empty() || key < end_key)) {
+        keys.push_back(key);
+        // a key relocked with other ts may be counted twice, it is only a bound
+        if (static_cast<int64_t>(keys.size() - origin_size) > max_count) {
+          keys.resize(origin_size);
+          return false;
+        }
+      }
+    }
+  }
+
+  std::sort(keys.begin(), keys.end());
+  keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+
+  return true;
+}
+
+bool TxnLockIndex::GetMinLockTs(const std::string& start_key, const std::string& end_key, int64_t& min_lock_ts) {
+  if (building_count_.load(std::memory_order_acquire) > 0) {
+    return false;
+  }
+
+  min_lock_ts = INT64_MAX;
+  for (auto& shard : shards_) {
+    BAIDU_SCOPED_LOCK(shard.mutex);
+    // ordered by lock ts, the first key in range has the min lock ts of the shard
+    for (const auto& [lock_ts, key] : shard.ts_keys) {
+      if (key >= start_key && (end_key.empty() || key < end_key)) {
+        if (lock_ts <= 0) {
+          return false;
+        }
+        min_lock_ts = std::min(min_lock_ts, lock_ts);
+        break;
+      }
+    }
+  }
+
+  return true;
+}
+
+void TxnLockIndex::BeginBuild() { building_count_.fetch_add(1, std::memory_order_acq_rel); }
+
+void TxnLockIndex::Build(RawEnginePtr raw_engine, const pb::common::Range& range) {
+  IteratorOptions iter_options;
+  if (!range.start_key().empty()) {
+    iter_options.lower_bound = Helper::EncodeTxnKey(range.start_key(), Constant::kLockVer);
+  }
+  if (!range.end_key().empty()) {
+    iter_options.upper_bound = Helper::EncodeTxnKey(range.end_key(), Constant::kLockVer);
+  }
+
+  auto iter = raw_engine->Reader()->NewIterator(Constant::kTxnLockCF, iter_options);
+  if (iter == nullptr) {
+    DINGO_LOG(FATAL) << "[txn.lock_index] new lock cf iterator failed.";
+    return;
+  }
+
+  int64_t count = 0;
+  for (iter->Seek(iter_options.lower_bound); iter->Valid(); iter->Next()) {
+    std::string key;
+    int64_t ts = 0;
+    auto status = Helper::DecodeTxnKey(iter->Key(), key, ts);
+    if (!status.ok()) {
+      DINGO_LOG(FATAL) << fmt::format("[txn.lock_index] decode lock key({}) failed, error: {}",
+                                      Helper::StringToHex(iter->Key()), status.error_str());
+    }
+
+    pb::store::LockInfo lock_info;
+    auto lock_value = iter->Value();
+    if (!lock_info.ParseFromArray(lock_value.data(), lock_value.size())) {
+      DINGO_LOG(FATAL) << fmt::format("[txn.lock_index] parse lock info failed, key: {}",
+                                      Helper::StringToHex(iter->Key()));
+    }
+
+    Add(key, lock_info.lock_ts());
+    ++count;
+  }
+
+  DINGO_LOG(INFO) << fmt::format("[txn.lock_index] build range[{}, {}) lock count: {}",
+                                 Helper::StringToHex(range.start_key()), Helper::StringToHex(range.end_key()), count);
+}
+
+void TxnLockIndex::EndBuild() { building_count_.fetch_sub(1, std::memory_order_acq_rel); }
+
+int64_t TxnLockIndex::Count() {
+  int64_t count = 0;
+  for (auto& shard : shards_) {
+    BAIDU_SCOPED_LOCK(shard.mutex);
+    count += shard.keys.size();
+  }
+  return count;
+}
+
+}  // namespace dingodb
@@ -0,0 +1,106 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_ENGINE_TXN_LOCK_INDEX_H_
+#define DINGODB_ENGINE_TXN_LOCK_INDEX_H_
+
+#include <atomic>
+#include <cstdint>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "bthread/types.h"
+#include "engine/raw_engine.h"
+#include "proto/common.pb.h"
+
+namespace dingodb {
+
+// Store level in memory index of the user keys which have lock in lock cf, so the lock check of an unlocked key
+// not read rocksdb. It is a superset of the locked keys, the key is added before the lock is written and erased
+// after the lock is deleted, a stale key only cost a rocksdb read.
+// An erase bumps the sequence of its shard. The reader get the sequence before take snapshot, and must read rocksdb
+// when the shard erased after that, because the deleted lock may be still in its snapshot.
+// It is not trusted until the lock cf is loaded at startup, and during snapshot install.
+// The keys are also ordered by lock ts, so the scan of the locks in a ts range, e.g. resolve the locks of a txn, only
+// read the locks of the ts range instead of the whole region.
+class TxnLockIndex {
+ public:
+  explicit TxnLockIndex(uint32_t shard_num);
+  ~TxnLockIndex();
+
+  TxnLockIndex(const TxnLockIndex& rhs) = delete;
+  TxnLockIndex& operator=(const TxnLockIndex& rhs) = delete;
+  TxnLockIndex(TxnLockIndex&& rhs) = delete;
+  TxnLockIndex& operator=(TxnLockIndex&& rhs) = delete;
+
+  // Create by gflags.
+  static TxnLockIndex& GetInstance();
+
+  static bool IsEnabled();
+
+  // Get before take snapshot.
+  int64_t Sequence() const { return sequence_.load(std::memory_order_acquire); }
+
+  // lock_ts is 0 if unknown, such key is only used by MayLocked.
+  void Add(const std::string& key, int64_t lock_ts = 0);
+  void Erase(const std::string& key);
+  // Range is [start_key, end_key) of user key.
+  void EraseRange(const std::string& start_key, const std::string& end_key);
+
+  // Return false only if the key is not locked in the snapshot taken after sequence, negative sequence is unknown.
+  bool MayLocked(const std::string& key, int64_t sequence);
+
+  // Get the sorted keys in [start_key, end_key) which may have a lock with lock_ts in [min_lock_ts, max_lock_ts),
+  // empty end_key is unbounded. Return false if the index is not trusted, or more than max_count keys are in the ts
+  // range, then the lock cf iterator is cheaper. The collection stops once beyond max_count.
+  bool GetKeysByTs(int64_t min_lock_ts, int64_t max_lock_ts, const std::string& start_key, const std::string& end_key,
+                   int64_t max_count, std::vector<std::string>& keys);
+
+  // Get the min lock ts of the keys in [start_key, end_key), INT64_MAX if there is no key.
+  // Return false if the index is not trusted, or a key of unknown lock ts is in the range.
+  bool GetMinLockTs(const std::string& start_key, const std::string& end_key, int64_t& min_lock_ts);
+
+  // Load the lock cf of raw engine between BeginBuild and EndBuild, empty range is the whole cf.
+  void BeginBuild();
+  void Build(RawEnginePtr raw_engine, const pb::common::Range& range);
+  void EndBuild();
+
+  int64_t Count();
+
+ private:
+  struct Shard {
+    bthread_mutex_t mutex;
+    // key -> lock ts
+    std::unordered_map<std::string, std::vector<int64_t>> keys;
+    // (lock ts, key)
+    std::set<std::pair<int64_t, std::string>> ts_keys;
+    int64_t erase_sequence{0};
+  };
+
+  Shard& GetShard(const std::string& key) { return shards_[std::hash<std::string>{}(key) % shards_.size()]; }
+
+  static void EraseKey(Shard& shard, const std::string& key);
+
+  std::atomic<int64_t> sequence_{0};
+  // not trusted when building, the startup build is pending at beginning.
+  std::atomic<int32_t> building_count_{1};
+  std::vector<Shard> shards_;
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_ENGINE_TXN_LOCK_INDEX_H_
@@ -0,0 +1,311 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "engine/txn_lock_wait_manager.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "bthread/unstable.h"
+#include "butil/time.h"
+#include "bvar/passive_status.h"
+#include "bvar/reducer.h"
+#include "common/logging.h"
+#include "fmt/core.h"
+#include "fmt/format.h"
+#include "gflags/gflags.h"
+
+namespace dingodb {
+
+DEFINE_bool(enable_txn_lock_wait, false, "pessimistic lock conflict waits for the lock released in store");
+DEFINE_int64(txn_lock_wait_timeout_ms, 1000, "max time of pessimistic lock waiting for lock, then return the lock");
+
+static bvar::Adder<int64_t> g_txn_lock_wait_timeout_count("dingo_txn_lock_wait_timeout_count");
+static bvar::Adder<int64_t> g_txn_lock_wait_deadlock_count("dingo_txn_lock_wait_deadlock_count");
+
+static int64_t GetWaiterCount(void*) { return TxnLockWaitManager::GetInstance().WaiterCount(); }
+
+static bvar::PassiveStatus<int64_t> g_txn_lock_wait_waiter_count("dingo_txn_lock_wait_waiter_count", GetWaiterCount,
+                                                                  nullptr);
+
+bool TxnLockWaitManager::IsEnabled() { return FLAGS_enable_txn_lock_wait && FLAGS_txn_lock_wait_timeout_ms > 0; }
+
+int64_t TxnLockWaitManager::WaitTimeoutMs() { return FLAGS_txn_lock_wait_timeout_ms; }
+
+// A release of key bumps the version of its slot, the keys of a slot share the version.
+static const size_t kReleaseSlotNum = 1024;
+
+TxnLockWaitManager::TxnLockWaitManager() : release_versions_(kReleaseSlotNum, 0) {}
+
+size_t TxnLockWaitManager::ReleaseSlot(const std::string& key) {
+  return std::hash<std::string>{}(key) % kReleaseSlotNum;
+}
+
+int64_t TxnLockWaitManager::ReleaseVersion() {
+  std::lock_guard<bthread::Mutex> lock(mutex_);
+  return release_version_;
+}
+
+TxnLockWaitManager::WaiterPtr TxnLockWaitManager::Enqueue(int64_t region_id, const std::string& key, int64_t start_ts,
+                                                          int64_t holder_ts, int64_t release_version) {
+  std::vector<WaiterPtr> woken_waiters;
+  WaiterPtr waiter = std::make_shared<Waiter>();
+  waiter->region_id = region_id;
+  waiter->key = key;
+  waiter->start_ts = start_ts;
+  waiter->holder_ts = holder_ts;
+
+  {
+    std::lock_guard<bthread::Mutex> lock(mutex_);
+
+    // the lock may be released after it was read, retry at once
+    if (release_versions_[ReleaseSlot(key)] > release_version) {
+      waiter->woken = true;
+      return waiter;
+    }
+
+    std::vector<int64_t> cycle;
+    while (!deadlock_detector_.AddEdge(start_ts, holder_ts, cycle)) {
+      g_txn_lock_wait_deadlock_count << 1;
+
+      int64_t victim_ts = TxnDeadlockDetector::ChooseVictim(cycle);
+      DINGO_LOG(INFO) << fmt::format(
+          "[txn.lock_wait][region({})] deadlock, waiter: {} holder: {} cycle: [{}] victim: {}", region_id, start_ts,
+          holder_ts, fmt::join(cycle, ","), victim_ts);
+      if (victim_ts == start_ts) {
+        waiter->woken = true;
+        waiter->deadlock = true;
+        break;
+      }
+
+      // the victim's waits are gone, retry
+      AbortWaiters(victim_ts, woken_waiters);
+    }
+
+    if (!waiter->woken) {
+      queues_[key].push_back(waiter);
+    }
+  }
+
+  for (auto& woken_waiter : woken_waiters) {
+    Notify(woken_waiter);
+  }
+
+  return waiter;
+}
+
+void TxnLockWaitManager::AbortWaiters(int64_t start_ts, std::vector<WaiterPtr>& woken_waiters) {
+  std::vector<WaiterPtr> waiters;
+  for (const auto& [key, queue] : queues_) {
+    for (const auto& waiter : queue) {
+      if (waiter->start_ts == start_ts) {
+        waiters.push_back(waiter);
+      }
+    }
+  }
+
+  for (auto& waiter : waiters) {
+    MarkWoken(waiter, true);
+    woken_waiters.push_back(waiter);
+  }
+}
+
+void TxnLockWaitManager::Remove(WaiterPtr waiter) {
+  auto it = queues_.find(waiter->key);
+  if (it != queues_.end()) {
+    auto& queue = it->second;
+    for (auto waiter_it = queue.begin(); waiter_it != queue.end(); ++waiter_it) {
+      if (*waiter_it == waiter) {
+        queue.erase(waiter_it);
+        break;
+      }
+    }
+    if (queue.empty()) {
+      queues_.erase(it);
+    }
+  }
+
+  deadlock_detector_.RemoveEdge(waiter->start_ts, waiter->holder_ts);
+}
+
+void TxnLockWaitManager::MarkWoken(WaiterPtr waiter, bool deadlock) {
+  Remove(waiter);
+  waiter->woken = true;
+  waiter->deadlock = deadlock;
+}
+
+void TxnLockWaitManager::Notify(WaiterPtr waiter) {
+  // the callback and timer are not changed once the waiter is woken
+  if (waiter->timer_arg != nullptr && bthread_timer_del(waiter->timer_id) == 0) {
+    delete waiter->timer_arg;
+  }
+  waiter->timer_arg = nullptr;
+
+  // the callback may hold the waiter
+  WaitCallback callback = std::move(waiter->callback);
+  waiter->callback = nullptr;
+  if (callback) {
+    callback(true);
+  }
+}
+
+void TxnLockWaitManager::OnWaitTimeout(void* arg) {
+  auto* waiter_ptr = static_cast<WaiterPtr*>(arg);
+  WaiterPtr waiter = *waiter_ptr;
+  delete waiter_ptr;
+
+  GetInstance().Timeout(waiter);
+}
+
+void TxnLockWaitManager::Timeout(WaiterPtr waiter) {
+  WaitCallback callback;
+  {
+    std::lock_guard<bthread::Mutex> lock(mutex_);
+    // the waker runs the callback
+    if (waiter->woken) {
+      return;
+    }
+
+    Remove(waiter);
+    waiter->timer_arg = nullptr;
+    callback = std::move(waiter->callback);
+  }
+
+  g_txn_lock_wait_timeout_count << 1;
+  callback(false);
+}
+
+void TxnLockWaitManager::AsyncWait(WaiterPtr waiter, int64_t timeout_ms, WaitCallback callback) {
+  bool woken = false;
+  {
+    std::lock_guard<bthread::Mutex> lock(mutex_);
+    woken = waiter->woken;
+    if (!woken && timeout_ms > 0) {
+      auto* arg = new WaiterPtr(waiter);
+      waiter->callback = std::move(callback);
+      // the timer can't take mutex_ before timer_arg is set
+      if (bthread_timer_add(&waiter->timer_id, butil::milliseconds_from_now(timeout_ms), &OnWaitTimeout, arg) == 0) {
+        waiter->timer_arg = arg;
+        return;
+      }
+
+      delete arg;
+      callback = std::move(waiter->callback);
+    }
+
+    if (!woken) {
+      Remove(waiter);
+    }
+  }
+
+  if (!woken) {
+    g_txn_lock_wait_timeout_count << 1;
+  }
+  callback(woken);
+}
+
+void TxnLockWaitManager::WakeUp(const std::string& key) {
+  WaiterPtr waiter;
+  {
+    std::lock_guard<bthread::Mutex> lock(mutex_);
+
+    release_versions_[ReleaseSlot(key)] = ++release_version_;
+
+    auto it = queues_.find(key);
+    if (it == queues_.end()) {
+      return;
+    }
+
+    waiter = it->second.front();
+    MarkWoken(waiter, false);
+  }
+
+  Notify(waiter);
+}
+
+void TxnLockWaitManager::WakeUpRange(const std::string& start_key, const std::string& end_key) {
+  std::vector<WaiterPtr> waiters;
+  {
+    std::lock_guard<bthread::Mutex> lock(mutex_);
+
+    // the range may cover any slot
+    ++release_version_;
+    std::fill(release_versions_.begin(), release_versions_.end(), release_version_);
+
+    for (auto it = queues_.lower_bound(start_key); it != queues_.end() && it->first < end_key; ++it) {
+      waiters.insert(waiters.end(), it->second.begin(), it->second.end());
+    }
+    for (auto& waiter : waiters) {
+      MarkWoken(waiter, false);
+    }
+  }
+
+  for (auto& waiter : waiters) {
+    Notify(waiter);
+  }
+}
+
+void TxnLockWaitManager::WakeUpRegion(int64_t region_id) {
+  std::vector<WaiterPtr> waiters;
+  {
+    std::lock_guard<bthread::Mutex> lock(mutex_);
+
+    for (const auto& [key, queue] : queues_) {
+      for (const auto& waiter : queue) {
+        if (waiter->region_id == region_id) {
+          waiters.push_back(waiter);
+        }
+      }
+    }
+    for (auto& waiter : waiters) {
+      MarkWoken(waiter, false);
+    }
+  }
+
+  for (auto& waiter : waiters) {
+    Notify(waiter);
+  }
+}
+
+std::vector<TxnLockWaitManager::WaitForEdge> TxnLockWaitManager::GetWaitForGraph() {
+  std::lock_guard<bthread::Mutex> lock(mutex_);
+
+  std::vector<WaitForEdge> edges;
+  for (const auto& [key, queue] : queues_) {
+    for (const auto& waiter : queue) {
+      edges.push_back({waiter->region_id, key, waiter->start_ts, waiter->holder_ts});
+    }
+  }
+
+  return edges;
+}
+
+int64_t TxnLockWaitManager::WaiterCount() {
+  std::lock_guard<bthread::Mutex> lock(mutex_);
+
+  int64_t count = 0;
+  for (const auto& [key, queue] : queues_) {
+    count += queue.size();
+  }
+
+  return count;
+}
+
+}  // namespace dingodb
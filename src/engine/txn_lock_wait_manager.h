@@ -0,0 +1,131 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef DINGODB_ENGINE_TXN_LOCK_WAIT_MANAGER_H_
+#define DINGODB_ENGINE_TXN_LOCK_WAIT_MANAGER_H_
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "bthread/mutex.h"
+#include "bthread/types.h"
+#include "engine/txn_deadlock_detector.h"
+
+namespace dingodb {
+
+// Wait queue of the pessimistic lock requests which meet a lock of other txn.
+// The waiter is enqueued while the request holds the latches of the key. Resolve lock and check txn status delete
+// locks without the latches, so the enqueue also checks the release version read before the lock check, and a waiter
+// whose key was released since then is woken up at once. The request does not block a worker while it waits, it is
+// called back and dispatched again. The apply of lock cf delete wakes up the first waiter of the key, the woken
+// waiter retries the lock, the others keep waiting in FIFO order.
+// The key is user key, it is unique in store, so one store level manager serves all regions.
+// waiter start_ts -> holder lock_ts is an edge of wait-for graph, when a waiter closes a cycle the youngest txn of the
+// cycle is the victim, its waiters are woken up with deadlock at once instead of waiting for the lock ttl.
+class TxnLockWaitManager {
+ public:
+  struct Waiter {
+    int64_t region_id{0};
+    std::string key;
+    int64_t start_ts{0};
+    int64_t holder_ts{0};
+    bool woken{false};
+    // the txn is the victim of a deadlock, it should abort
+    bool deadlock{false};
+    // called once with woken, set by AsyncWait
+    std::function<void(bool)> callback;
+    bthread_timer_t timer_id{0};
+    // the argument of timer, nullptr if no timer
+    std::shared_ptr<Waiter>* timer_arg{nullptr};
+  };
+  using WaiterPtr = std::shared_ptr<Waiter>;
+  using WaitCallback = std::function<void(bool woken)>;
+
+  struct WaitForEdge {
+    int64_t region_id;
+    std::string key;
+    int64_t waiter_ts;
+    int64_t holder_ts;
+  };
+
+  static TxnLockWaitManager& GetInstance() {
+    static TxnLockWaitManager instance;
+    return instance;
+  }
+
+  TxnLockWaitManager(const TxnLockWaitManager& rhs) = delete;
+  TxnLockWaitManager& operator=(const TxnLockWaitManager& rhs) = delete;
+  TxnLockWaitManager(TxnLockWaitManager&& rhs) = delete;
+  TxnLockWaitManager& operator=(TxnLockWaitManager&& rhs) = delete;
+
+  static bool IsEnabled();
+  static int64_t WaitTimeoutMs();
+
+  // Read it before checking the lock, then pass it to Enqueue.
+  int64_t ReleaseVersion();
+
+  // The returned waiter is woken up already with deadlock if the txn is the victim of a deadlock, or without deadlock
+  // if the lock of key may be released since release_version.
+  WaiterPtr Enqueue(int64_t region_id, const std::string& key, int64_t start_ts, int64_t holder_ts,
+                    int64_t release_version);
+  // Call back with true if woken up, false if timeout. The waiter is out of queue before the callback.
+  // The callback runs at once if the waiter is woken up already, otherwise in the thread waking it up or in the timer
+  // thread, so it should only dispatch the work.
+  void AsyncWait(WaiterPtr waiter, int64_t timeout_ms, WaitCallback callback);
+
+  // The lock of key is released.
+  void WakeUp(const std::string& key);
+  // The locks in range [start_key, end_key) of user key are released, e.g. the in memory pessimistic locks are dropped.
+  void WakeUpRange(const std::string& start_key, const std::string& end_key);
+  // Wake up all waiters of region, e.g. the region is not leader any more.
+  void WakeUpRegion(int64_t region_id);
+
+  std::vector<WaitForEdge> GetWaitForGraph();
+  int64_t WaiterCount();
+
+ private:
+  TxnLockWaitManager();
+  ~TxnLockWaitManager() = default;
+
+  static void OnWaitTimeout(void* arg);
+  // Cancel the timer and run the callback of the woken waiter, without mutex_.
+  static void Notify(WaiterPtr waiter);
+
+  void Remove(WaiterPtr waiter);
+  // Remove from queue and mark woken, Notify it after unlock.
+  void MarkWoken(WaiterPtr waiter, bool deadlock);
+  // Mark all waiters of the txn woken with deadlock.
+  void AbortWaiters(int64_t start_ts, std::vector<WaiterPtr>& woken_waiters);
+  void Timeout(WaiterPtr waiter);
+
+  static size_t ReleaseSlot(const std::string& key);
+
+  bthread::Mutex mutex_;
+  // key -> waiters in FIFO order
+  std::map<std::string, std::deque<WaiterPtr>> queues_;
+  int64_t release_version_{0};
+  // the release version of keys hashed to the slot
+  std::vector<int64_t> release_versions_;
+  TxnDeadlockDetector deadlock_detector_;
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_ENGINE_TXN_LOCK_WAIT_MANAGER_H_
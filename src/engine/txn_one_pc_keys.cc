@@ -0,0 +1,148 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "engine/txn_one_pc_keys.h"
+
+#include <cerrno>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "butil/time.h"
+#include "bvar/passive_status.h"
+#include "bvar/reducer.h"
+#include "gflags/gflags.h"
+
+namespace dingodb {
+
+DEFINE_int64(txn_one_pc_read_wait_timeout_ms, 1000,
+             "max time of txn read waiting for the in flight one pc commit applied, then return region unavailable");
+
+static bvar::Adder<int64_t> g_txn_one_pc_read_wait_count("dingo_txn_one_pc_read_wait_count");
+static bvar::Adder<int64_t> g_txn_one_pc_read_wait_timeout_count("dingo_txn_one_pc_read_wait_timeout_count");
+
+static int64_t GetOnePcKeyCount(void*) { return TxnOnePcKeys::GetInstance().Count(); }
+
+static bvar::PassiveStatus<int64_t> g_txn_one_pc_key_count("dingo_txn_one_pc_key_count", GetOnePcKeyCount, nullptr);
+
+TxnOnePcKeys::Holder::Holder(const std::vector<std::string>& keys) : keys_(keys) {}
+
+TxnOnePcKeys::Holder::~Holder() { Release(); }
+
+void TxnOnePcKeys::Holder::SetCommitTs(int64_t commit_ts) {
+  if (!released_.load()) {
+    TxnOnePcKeys::GetInstance().SetCommitTs(keys_, commit_ts);
+  }
+}
+
+void TxnOnePcKeys::Holder::Release() {
+  if (!released_.exchange(true)) {
+    TxnOnePcKeys::GetInstance().Erase(keys_);
+  }
+}
+
+TxnOnePcKeys::HolderPtr TxnOnePcKeys::Add(const std::vector<std::string>& keys) {
+  {
+    std::lock_guard<bthread::Mutex> lock(mutex_);
+    for (const auto& key : keys) {
+      keys_.insert_or_assign(key, 0);
+    }
+    count_.store(keys_.size(), std::memory_order_relaxed);
+  }
+
+  return std::make_shared<Holder>(keys);
+}
+
+void TxnOnePcKeys::SetCommitTs(const std::vector<std::string>& keys, int64_t commit_ts) {
+  std::lock_guard<bthread::Mutex> lock(mutex_);
+  for (const auto& key : keys) {
+    auto it = keys_.find(key);
+    if (it != keys_.end()) {
+      it->second = commit_ts;
+    }
+  }
+  cond_.notify_all();
+}
+
+void TxnOnePcKeys::Erase(const std::vector<std::string>& keys) {
+  std::lock_guard<bthread::Mutex> lock(mutex_);
+  for (const auto& key : keys) {
+    keys_.erase(key);
+  }
+  count_.store(keys_.size(), std::memory_order_relaxed);
+  cond_.notify_all();
+}
+
+bool TxnOnePcKeys::Wait(const std::function<bool()>& is_blocked) {
+  std::unique_lock<bthread::Mutex> lock(mutex_);
+  if (!is_blocked()) {
+    return true;
+  }
+
+  g_txn_one_pc_read_wait_count << 1;
+  int64_t deadline_us = butil::gettimeofday_us() + FLAGS_txn_one_pc_read_wait_timeout_ms * 1000;
+  while (is_blocked()) {
+    int64_t remain_us = deadline_us - butil::gettimeofday_us();
+    if (remain_us <= 0 || cond_.wait_for(lock, remain_us) == ETIMEDOUT) {
+      if (is_blocked()) {
+        g_txn_one_pc_read_wait_timeout_count << 1;
+        return false;
+      }
+      break;
+    }
+  }
+
+  return true;
+}
+
+bool TxnOnePcKeys::WaitKeys(const std::vector<std::string>& keys, int64_t start_ts) {
+  if (Count() == 0) {
+    return true;
+  }
+
+  auto is_blocked = [&]() -> bool {
+    for (const auto& key : keys) {
+      auto it = keys_.find(key);
+      if (it != keys_.end() && IsBlocking(it->second, start_ts)) {
+        return true;
+      }
+    }
+    return false;
+  };
+
+  return Wait(is_blocked);
+}
+
+bool TxnOnePcKeys::WaitRange(const std::string& start_key, const std::string& end_key, int64_t start_ts) {
+  if (Count() == 0) {
+    return true;
+  }
+
+  auto is_blocked = [&]() -> bool {
+    auto it = keys_.lower_bound(start_key);
+    for (; it != keys_.end() && (end_key.empty() || it->first < end_key); ++it) {
+      if (IsBlocking(it->second, start_ts)) {
+        return true;
+      }
+    }
+    return false;
+  };
+
+  return Wait(is_blocked);
+}
+
+}  // namespace dingodb
@@ -0,0 +1,94 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_ENGINE_TXN_ONE_PC_KEYS_H_
+#define DINGODB_ENGINE_TXN_ONE_PC_KEYS_H_
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "bthread/condition_variable.h"
+#include "bthread/mutex.h"
+
+namespace dingodb {
+
+// The keys of one pc prewrite which are written through raft, it plays the lock of the two phase commit.
+// The one pc commit_ts is got from tso after the keys are added, so a reader whose start_ts >= commit_ts gets its
+// start_ts after the keys are added, it waits here until the commit is applied instead of reading the old value.
+// A reader whose start_ts < commit_ts doesn't see the commit at all, it doesn't wait once the commit_ts is known.
+// The key is user key, it is unique in store, so one store level table serves all regions.
+class TxnOnePcKeys {
+ public:
+  // Erase the keys when release or destruct, whichever is first.
+  class Holder {
+   public:
+    Holder(const std::vector<std::string>& keys);
+    ~Holder();
+
+    void SetCommitTs(int64_t commit_ts);
+    void Release();
+
+   private:
+    std::vector<std::string> keys_;
+    std::atomic<bool> released_{false};
+  };
+  using HolderPtr = std::shared_ptr<Holder>;
+
+  static TxnOnePcKeys& GetInstance() {
+    static TxnOnePcKeys instance;
+    return instance;
+  }
+
+  TxnOnePcKeys(const TxnOnePcKeys& rhs) = delete;
+  TxnOnePcKeys& operator=(const TxnOnePcKeys& rhs) = delete;
+  TxnOnePcKeys(TxnOnePcKeys&& rhs) = delete;
+  TxnOnePcKeys& operator=(TxnOnePcKeys&& rhs) = delete;
+
+  // Add the keys with unknown commit_ts.
+  HolderPtr Add(const std::vector<std::string>& keys);
+
+  // Return true if none of the keys is in flight for the reader, false if timeout.
+  bool WaitKeys(const std::vector<std::string>& keys, int64_t start_ts);
+  // Range is [start_key, end_key) of user key.
+  bool WaitRange(const std::string& start_key, const std::string& end_key, int64_t start_ts);
+
+  int64_t Count() { return count_.load(std::memory_order_relaxed); }
+
+ private:
+  TxnOnePcKeys() = default;
+  ~TxnOnePcKeys() = default;
+
+  void SetCommitTs(const std::vector<std::string>& keys, int64_t commit_ts);
+  void Erase(const std::vector<std::string>& keys);
+  // Wait with mutex_ until is_blocked returns false.
+  bool Wait(const std::function<bool()>& is_blocked);
+
+  // The commit of key is not known to be invisible to the reader.
+  static bool IsBlocking(int64_t commit_ts, int64_t start_ts) { return commit_ts == 0 || commit_ts <= start_ts; }
+
+  bthread::Mutex mutex_;
+  bthread::ConditionVariable cond_;
+  // key -> commit_ts, 0 is not got yet
+  std::map<std::string, int64_t> keys_;
+  std::atomic<int64_t> count_{0};
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_ENGINE_TXN_ONE_PC_KEYS_H_
@@ -0,0 +1,128 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "engine/write_coalescer.h"
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <utility>
+
+#include "glog/logging.h"
+
+namespace dingodb {
+
+RegionWriteCoalescer::RegionWriteCoalescer(WriteFunc write_func, int64_t max_batch_count, int64_t max_batch_bytes)
+    : write_func_(std::move(write_func)),
+      max_batch_count_(max_batch_count > 0 ? max_batch_count : 1),
+      max_batch_bytes_(max_batch_bytes) {
+  CHECK(write_func_ != nullptr) << "write_func is nullptr.";
+}
+
+bool RegionWriteCoalescer::CanJoin(BatchPtr batch, std::shared_ptr<Context> ctx, int64_t datum_bytes) const {
+  if (batch->sent || batch->count >= max_batch_count_) {
+    return false;
+  }
+  if (max_batch_bytes_ > 0 && batch->bytes + datum_bytes > max_batch_bytes_) {
+    return false;
+  }
+
+  // the raft entry carries one epoch and cf, the requests validated by other epoch can't share it
+  const auto& batch_ctx = batch->ctx;
+  return batch_ctx->RegionEpoch().version() == ctx->RegionEpoch().version() &&
+         batch_ctx->RegionEpoch().conf_version() == ctx->RegionEpoch().conf_version() &&
+         batch_ctx->CfName() == ctx->CfName();
+}
+
+RegionWriteCoalescer::BatchPtr RegionWriteCoalescer::NewBatch(std::shared_ptr<Context> ctx) {
+  auto batch = std::make_shared<Batch>();
+  batch->ctx = std::make_shared<Context>();
+  batch->ctx->SetRegionId(ctx->RegionId());
+  batch->ctx->SetRegionEpoch(ctx->RegionEpoch());
+  batch->ctx->SetCfName(ctx->CfName());
+  batch->ctx->SetRawEngineType(ctx->RawEngineType());
+  batch->ctx->SetStoreEngineType(ctx->StoreEngineType());
+  batch->write_data = std::make_shared<WriteData>();
+
+  return batch;
+}
+
+butil::Status RegionWriteCoalescer::Write(std::shared_ptr<Context> ctx, std::shared_ptr<DatumAble> datum,
+                                          int64_t datum_bytes) {
+  std::unique_lock<bthread::Mutex> lock(mutex_);
+
+  auto& region_queue = region_queues_[ctx->RegionId()];
+  if (region_queue == nullptr) {
+    region_queue = std::make_shared<RegionQueue>();
+  }
+  auto queue = region_queue;
+
+  // join the last waiting batch, or open a new one
+  if (queue->batches.empty() || !CanJoin(queue->batches.back(), ctx, datum_bytes)) {
+    queue->batches.push_back(NewBatch(ctx));
+  }
+  auto batch = queue->batches.back();
+  batch->ctx->AddSubContext(ctx);
+  batch->write_data->AddDatums(datum);
+  ++batch->count;
+  batch->bytes += datum_bytes;
+  if (ctx->Tracker() != nullptr) {
+    batch->trackers.push_back(ctx->Tracker());
+  }
+
+  while (!batch->done) {
+    if (!queue->in_flight && queue->batches.front() == batch) {
+      // lead the batch, no one can join it after sent
+      batch->sent = true;
+      queue->in_flight = true;
+      ++write_count_;
+
+      TrackerPtr batch_tracker;
+      if (!batch->trackers.empty()) {
+        batch_tracker = Tracker::New(pb::common::RequestInfo());
+        batch->ctx->SetTracker(batch_tracker);
+      }
+
+      lock.unlock();
+      auto status = write_func_(batch->ctx, batch->write_data);
+      if (batch_tracker != nullptr) {
+        // the other callers are waiting for done, no one touches their trackers
+        for (auto& tracker : batch->trackers) {
+          tracker->SetWriteStagesFromBatch(*batch_tracker);
+        }
+      }
+      lock.lock();
+
+      batch->status = status;
+      batch->done = true;
+      queue->batches.pop_front();
+      queue->in_flight = false;
+      if (queue->batches.empty()) {
+        region_queues_.erase(ctx->RegionId());
+      }
+      queue->cond.notify_all();
+      break;
+    }
+
+    queue->cond.wait(lock);
+  }
+
+  if (!batch->status.ok()) {
+    return batch->status;
+  }
+
+  return ctx->Status();
+}
+
+}  // namespace dingodb
@@ -0,0 +1,93 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_ENGINE_WRITE_COALESCER_H_
+#define DINGODB_ENGINE_WRITE_COALESCER_H_
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <vector>
+
+#include "bthread/condition_variable.h"
+#include "bthread/mutex.h"
+#include "butil/status.h"
+#include "common/context.h"
+#include "common/tracker.h"
+#include "engine/write_data.h"
+
+namespace dingodb {
+
+// Coalesce the concurrent sync writes of a region into one raft entry.
+// The writes arrive while a write of the region is in flight join the next batch, which is sent by one of them as
+// soon as the in flight write is done, so there is at most one coalesced write in flight per region.
+// Every caller's context is a sub context of the batch context, the apply handler fills the caller's own response
+// and status, the raft error of the batch is returned to all callers.
+// A batch is bounded by count and bytes, the bytes keep the raft entry under the rpc body size of replication.
+// The batch context has its own tracker, its raft stages are copied to the tracker of every caller.
+class RegionWriteCoalescer {
+ public:
+  using WriteFunc = std::function<butil::Status(std::shared_ptr<Context> ctx, std::shared_ptr<WriteData> write_data)>;
+
+  RegionWriteCoalescer(WriteFunc write_func, int64_t max_batch_count, int64_t max_batch_bytes);
+  ~RegionWriteCoalescer() = default;
+
+  RegionWriteCoalescer(const RegionWriteCoalescer&) = delete;
+  RegionWriteCoalescer& operator=(const RegionWriteCoalescer&) = delete;
+
+  // Write the datum of datum_bytes, return after the raft entry contains it is applied.
+  butil::Status Write(std::shared_ptr<Context> ctx, std::shared_ptr<DatumAble> datum, int64_t datum_bytes);
+
+  int64_t WriteCount() const { return write_count_; }
+
+ private:
+  struct Batch {
+    std::shared_ptr<Context> ctx;
+    std::shared_ptr<WriteData> write_data;
+    int64_t count{0};
+    int64_t bytes{0};
+    std::vector<TrackerPtr> trackers;
+    bool sent{false};
+    bool done{false};
+    butil::Status status;
+  };
+  using BatchPtr = std::shared_ptr<Batch>;
+
+  struct RegionQueue {
+    bthread::ConditionVariable cond;
+    // The front batch is in flight when in_flight is true, the others are waiting.
+    std::deque<BatchPtr> batches;
+    bool in_flight{false};
+  };
+  using RegionQueuePtr = std::shared_ptr<RegionQueue>;
+
+  bool CanJoin(BatchPtr batch, std::shared_ptr<Context> ctx, int64_t datum_bytes) const;
+  static BatchPtr NewBatch(std::shared_ptr<Context> ctx);
+
+  WriteFunc write_func_;
+  int64_t max_batch_count_;
+  int64_t max_batch_bytes_;
+
+  bthread::Mutex mutex_;
+  std::map<int64_t, RegionQueuePtr> region_queues_;
+  int64_t write_count_{0};
+};
+
+using RegionWriteCoalescerPtr = std::shared_ptr<RegionWriteCoalescer>;
+
+}  // namespace dingodb
+
+#endif  // DINGODB_ENGINE_WRITE_COALESCER_H_
@@ -18,6 +18,7 @@
 #include <cstdint>
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "common/helper.h"
@@ -253,6 +254,60 @@ struct DeleteRangeDatum : public DatumAble {
   std::vector<pb::common::Range> ranges;
 };
 
+struct PutIfAbsentDatum : public DatumAble {
+  ~PutIfAbsentDatum() override = default;
+  DatumType GetType() override { return DatumType::kPutIfabsent; }
+
+  pb::raft::Request* TransformToRaft() override {
+    auto* request = new pb::raft::Request();
+
+    request->set_cmd_type(pb::raft::CmdType::PUTIFABSENT);
+    pb::raft::PutIfAbsentRequest* put_if_absent_request = request->mutable_put_if_absent();
+    put_if_absent_request->set_cf_name(cf_name);
+    for (auto& kv : kvs) {
+      put_if_absent_request->add_kvs()->Swap(&kv);
+    }
+    put_if_absent_request->set_is_atomic(is_atomic);
+
+    return request;
+  }
+
+  void TransformFromRaft(pb::raft::Response& resonse) override {}
+
+  std::string cf_name;
+  std::vector<pb::common::KeyValue> kvs;
+  bool is_atomic{false};
+};
+
+struct CompareAndSetDatum : public DatumAble {
+  ~CompareAndSetDatum() override = default;
+  DatumType GetType() override { return DatumType::kCompareAndSet; }
+
+  pb::raft::Request* TransformToRaft() override {
+    auto* request = new pb::raft::Request();
+
+    request->set_cmd_type(pb::raft::CmdType::COMPAREANDSET);
+    pb::raft::CompareAndSetRequest* compare_and_set_request = request->mutable_compare_and_set();
+    compare_and_set_request->set_cf_name(cf_name);
+    for (auto& kv : kvs) {
+      compare_and_set_request->add_kvs()->Swap(&kv);
+    }
+    for (auto& expect_value : expect_values) {
+      compare_and_set_request->add_expect_values()->swap(expect_value);
+    }
+    compare_and_set_request->set_is_atomic(is_atomic);
+
+    return request;
+  }
+
+  void TransformFromRaft(pb::raft::Response& resonse) override {}
+
+  std::string cf_name;
+  std::vector<pb::common::KeyValue> kvs;
+  std::vector<std::string> expect_values;
+  bool is_atomic{false};
+};
+
 struct CreateSchemaDatum : public DatumAble {
   ~CreateSchemaDatum() override = default;
   DatumType GetType() override { return DatumType::kCreateSchema; }
@@ -414,9 +469,14 @@ class WriteDataBuilder {
   // PutDatum
   static std::shared_ptr<WriteData> BuildWrite(const std::string& cf_name,
                                                const std::vector<pb::common::KeyValue>& kvs) {
+    return BuildWrite(cf_name, std::vector<pb::common::KeyValue>(kvs));
+  }
+
+  // PutDatum, take over kvs without copy.
+  static std::shared_ptr<WriteData> BuildWrite(const std::string& cf_name, std::vector<pb::common::KeyValue>&& kvs) {
     auto datum = std::make_shared<PutDatum>();
     datum->cf_name = cf_name;
-    datum->kvs = kvs;
+    datum->kvs = std::move(kvs);
 
     auto write_data = std::make_shared<WriteData>();
     write_data->AddDatums(std::static_pointer_cast<DatumAble>(datum));
@@ -427,9 +487,15 @@ class WriteDataBuilder {
   // VectorAddDatum
   static std::shared_ptr<WriteData> BuildWrite(const std::string& cf_name,
                                                const std::vector<pb::common::VectorWithId>& vectors, bool is_update) {
+    return BuildWrite(cf_name, std::vector<pb::common::VectorWithId>(vectors), is_update);
+  }
+
+  // VectorAddDatum, take over vectors without copy.
+  static std::shared_ptr<WriteData> BuildWrite(const std::string& cf_name,
+                                               std::vector<pb::common::VectorWithId>&& vectors, bool is_update) {
     auto datum = std::make_shared<VectorAddDatum>();
     datum->cf_name = cf_name;
-    datum->vectors = vectors;
+    datum->vectors = std::move(vectors);
     datum->is_update = is_update;
 
     auto write_data = std::make_shared<WriteData>();
@@ -454,9 +520,15 @@ class WriteDataBuilder {
   static std::shared_ptr<WriteData> BuildWrite(const std::string& cf_name,
                                                const std::vector<pb::common::DocumentWithId>& documents,
                                                bool is_update) {
+    return BuildWrite(cf_name, std::vector<pb::common::DocumentWithId>(documents), is_update);
+  }
+
+  // DocumentAddDatum, take over documents without copy.
+  static std::shared_ptr<WriteData> BuildWrite(const std::string& cf_name,
+                                               std::vector<pb::common::DocumentWithId>&& documents, bool is_update) {
     auto datum = std::make_shared<DocumentAddDatum>();
     datum->cf_name = cf_name;
-    datum->documents = documents;
+    datum->documents = std::move(documents);
     datum->is_update = is_update;
 
     auto write_data = std::make_shared<WriteData>();
@@ -502,6 +574,36 @@ class WriteDataBuilder {
     return write_data;
   }
 
+  // PutIfAbsentDatum
+  static std::shared_ptr<WriteData> BuildWrite(const std::string& cf_name,
+                                               const std::vector<pb::common::KeyValue>& kvs, bool is_atomic) {
+    auto datum = std::make_shared<PutIfAbsentDatum>();
+    datum->cf_name = cf_name;
+    datum->kvs = kvs;
+    datum->is_atomic = is_atomic;
+
+    auto write_data = std::make_shared<WriteData>();
+    write_data->AddDatums(std::static_pointer_cast<DatumAble>(datum));
+
+    return write_data;
+  }
+
+  // CompareAndSetDatum
+  static std::shared_ptr<WriteData> BuildWrite(const std::string& cf_name,
+                                               const std::vector<pb::common::KeyValue>& kvs,
+                                               const std::vector<std::string>& expect_values, bool is_atomic) {
+    auto datum = std::make_shared<CompareAndSetDatum>();
+    datum->cf_name = cf_name;
+    datum->kvs = kvs;
+    datum->expect_values = expect_values;
+    datum->is_atomic = is_atomic;
+
+    auto write_data = std::make_shared<WriteData>();
+    write_data->AddDatums(std::static_pointer_cast<DatumAble>(datum));
+
+    return write_data;
+  }
+
   // MetaPutDatum
   static std::shared_ptr<WriteData> BuildWrite(const std::string& cf_name,
                                                pb::coordinator_internal::MetaIncrement& meta_increment) {
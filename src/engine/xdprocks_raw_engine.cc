@@ -24,11 +24,14 @@
 #include <exception>
 #include <filesystem>
 #include <iomanip>
+#include <limits>
 #include <map>
 #include <memory>
+#include <numeric>
 #include <optional>
 #include <stdexcept>
 #include <string>
+#include <string_view>
 #include <tuple>
 #include <type_traits>
 #include <utility>
@@ -43,6 +46,7 @@
 #include "engine/raw_engine.h"
 #include "engine/snapshot.h"
 #include "fmt/core.h"
+#include "gflags/gflags.h"
 #include "proto/common.pb.h"
 #include "proto/error.pb.h"
 #include "xdprocks/advanced_options.h"
@@ -55,6 +59,11 @@
 
 namespace dingodb {
 
+DEFINE_bool(xdprocks_multiget_async_io, true, "xdprocks multi get read sst files with async io");
+DEFINE_bool(xdprocks_long_scan_async_io, true, "xdprocks long scan prefetch sst blocks with async io");
+DEFINE_int64(xdprocks_long_scan_readahead_size, 2 * 1024 * 1024, "xdprocks long scan initial readahead size");
+DEFINE_bool(xdprocks_long_scan_fill_cache, false, "xdprocks long scan fill block cache");
+
 namespace xdp {
 
 ColumnFamily::ColumnFamily(const std::string& cf_name, const ColumnFamilyConfig& config,
@@ -342,6 +351,104 @@ butil::Status Reader::KvGet(ColumnFamilyPtr column_family, dingodb::SnapshotPtr
   return butil::Status();
 }
 
+butil::Status Reader::KvGetPinned(const std::string& cf_name, const std::string& key, const ValueVisitor& visitor) {
+  return KvGetPinned(GetColumnFamily(cf_name), GetSnapshot(), key, visitor);
+}
+
+butil::Status Reader::KvGetPinned(const std::string& cf_name, dingodb::SnapshotPtr snapshot, const std::string& key,
+                                  const ValueVisitor& visitor) {
+  return KvGetPinned(GetColumnFamily(cf_name), snapshot, key, visitor);
+}
+
+butil::Status Reader::KvGetPinned(ColumnFamilyPtr column_family, dingodb::SnapshotPtr snapshot, const std::string& key,
+                                  const ValueVisitor& visitor) {
+  if (BAIDU_UNLIKELY(key.empty())) {
+    DINGO_LOG(ERROR) << fmt::format("[xdprocks] not support empty key.");
+    return butil::Status(pb::error::EKEY_EMPTY, "Key is empty");
+  }
+
+  xdprocks::ReadOptions read_option;
+  read_option.snapshot = static_cast<const xdprocks::Snapshot*>(snapshot->Inner());
+  // pinned value refers the block cache or memtable memory, released when out of scope.
+  xdprocks::PinnableSlice pinnable_value;
+  xdprocks::Status s = GetDB()->Get(read_option, column_family->GetHandle(), xdprocks::Slice(key), &pinnable_value);
+  if (!s.ok()) {
+    if (s.IsNotFound()) {
+      return butil::Status(pb::error::EKEY_NOT_FOUND, "Not found key");
+    }
+    DINGO_LOG(ERROR) << fmt::format("[xdprocks] get key failed, error: {}", s.ToString());
+    return butil::Status(pb::error::EINTERNAL, "Internal get error");
+  }
+
+  visitor(std::string_view(pinnable_value.data(), pinnable_value.size()));
+
+  return butil::Status();
+}
+
+butil::Status Reader::KvMultiGet(const std::string& cf_name, const std::vector<std::string>& keys,
+                                 std::vector<std::string>& values, std::vector<bool>& exists) {
+  return KvMultiGet(GetColumnFamily(cf_name), GetSnapshot(), keys, values, exists);
+}
+
+butil::Status Reader::KvMultiGet(const std::string& cf_name, dingodb::SnapshotPtr snapshot,
+                                 const std::vector<std::string>& keys, std::vector<std::string>& values,
+                                 std::vector<bool>& exists) {
+  return KvMultiGet(GetColumnFamily(cf_name), snapshot, keys, values, exists);
+}
+
+butil::Status Reader::KvMultiGet(ColumnFamilyPtr column_family, dingodb::SnapshotPtr snapshot,
+                                 const std::vector<std::string>& keys, std::vector<std::string>& values,
+                                 std::vector<bool>& exists) {
+  values.clear();
+  values.resize(keys.size());
+  exists.assign(keys.size(), false);
+  if (keys.empty()) {
+    return butil::Status();
+  }
+
+  for (const auto& key : keys) {
+    if (BAIDU_UNLIKELY(key.empty())) {
+      DINGO_LOG(ERROR) << fmt::format("[xdprocks] not support empty key.");
+      return butil::Status(pb::error::EKEY_EMPTY, "Key is empty");
+    }
+  }
+
+  // batched MultiGet does one pass over the files with sorted keys, keep the caller order by index.
+  std::vector<size_t> order(keys.size());
+  std::iota(order.begin(), order.end(), 0);
+  if (!std::is_sorted(keys.begin(), keys.end())) {
+    std::sort(order.begin(), order.end(), [&keys](size_t lhs, size_t rhs) { return keys[lhs] < keys[rhs]; });
+  }
+
+  std::vector<xdprocks::Slice> key_slices;
+  key_slices.reserve(keys.size());
+  for (auto i : order) {
+    key_slices.emplace_back(keys[i]);
+  }
+
+  xdprocks::ReadOptions read_option;
+  read_option.snapshot = static_cast<const xdprocks::Snapshot*>(snapshot->Inner());
+  read_option.async_io = FLAGS_xdprocks_multiget_async_io;
+
+  std::vector<xdprocks::PinnableSlice> pinnable_values(keys.size());
+  std::vector<xdprocks::Status> statuses(keys.size());
+  GetDB()->MultiGet(read_option, column_family->GetHandle(), keys.size(), key_slices.data(), pinnable_values.data(),
+                    statuses.data(), true);
+
+  for (size_t i = 0; i < keys.size(); ++i) {
+    const auto& s = statuses[i];
+    if (s.ok()) {
+      values[order[i]].assign(pinnable_values[i].data(), pinnable_values[i].size());
+      exists[order[i]] = true;
+    } else if (!s.IsNotFound()) {
+      DINGO_LOG(ERROR) << fmt::format("[xdprocks] multi get key failed, error: {}", s.ToString());
+      return butil::Status(pb::error::EINTERNAL, "Internal multi get error");
+    }
+  }
+
+  return butil::Status();
+}
+
 butil::Status Reader::KvScan(ColumnFamilyPtr column_family, std::shared_ptr<dingodb::Snapshot> snapshot,
                              const std::string& start_key, const std::string& end_key,
                              std::vector<pb::common::KeyValue>& kvs) {
@@ -429,6 +536,14 @@ dingodb::IteratorPtr Reader::NewIterator(ColumnFamilyPtr column_family, dingodb:
     read_options.snapshot = static_cast<const xdprocks::Snapshot*>(snapshot->Inner());
   }
   read_options.auto_prefix_mode = true;
+  if (options.long_scan) {
+    // prefetch next blocks while consuming current, readahead grows adaptively.
+    read_options.async_io = FLAGS_xdprocks_long_scan_async_io;
+    read_options.adaptive_readahead = true;
+    read_options.readahead_size = FLAGS_xdprocks_long_scan_readahead_size;
+    // one pass cold scan not evict hot blocks
+    read_options.fill_cache = FLAGS_xdprocks_long_scan_fill_cache;
+  }
 
   return std::make_shared<Iterator>(options, GetDB()->NewIterator(read_options, column_family->GetHandle()), snapshot);
 }
@@ -659,15 +774,24 @@ static xdp::ColumnFamilyMap GenColumnFamilyByDefaultConfig(const std::vector<std
   xdp::ColumnFamily::ColumnFamilyConfig default_config;
   default_config.emplace(Constant::kBlockSize, "4096");
   default_config.emplace(Constant::kBlockCache, Constant::kBlockCacheDefaultValue);
+  default_config.emplace(Constant::kCompressedSecondaryCache, Constant::kCompressedSecondaryCacheDefaultValue);
   default_config.emplace(Constant::kArenaBlockSize, Constant::kArenaBlockSizeDefaultValue);
   default_config.emplace(Constant::kMinWriteBufferNumberToMerge, Constant::kMinWriteBufferNumberToMergeDefaultValue);
   default_config.emplace(Constant::kMaxWriteBufferNumber, Constant::kMaxWriteBufferNumberDefaultValue);
   default_config.emplace(Constant::kMaxCompactionBytes, Constant::kMaxCompactionBytesDefaultValue);
   default_config.emplace(Constant::kWriteBufferSize, Constant::kWriteBufferSizeDefaultValue);
   default_config.emplace(Constant::kPrefixExtractor, Constant::kPrefixExtractorDefaultValue);
+  default_config.emplace(Constant::kPrefixExtractorType, Constant::kPrefixExtractorTypeDefaultValue);
+  default_config.emplace(Constant::kMemtablePrefixBloomSizeRatio, Constant::kMemtablePrefixBloomSizeRatioDefaultValue);
+  default_config.emplace(Constant::kMemtableWholeKeyFiltering, Constant::kMemtableWholeKeyFilteringDefaultValue);
+  default_config.emplace(Constant::kBloomFilterBitsPerKey, Constant::kBloomFilterBitsPerKeyDefaultValue);
+  default_config.emplace(Constant::kWholeKeyFiltering, Constant::kWholeKeyFilteringDefaultValue);
   default_config.emplace(Constant::kMaxBytesForLevelBase, Constant::kMaxBytesForLevelBaseDefaultValue);
   default_config.emplace(Constant::kTargetFileSizeBase, Constant::kTargetFileSizeBaseDefaultValue);
   default_config.emplace(Constant::kMaxBytesForLevelMultiplier, Constant::kMaxBytesForLevelMultiplierDefaultValue);
+  default_config.emplace(Constant::kColdPath, Constant::kColdPathDefaultValue);
+  default_config.emplace(Constant::kColdLevel, Constant::kColdLevelDefaultValue);
+  default_config.emplace(Constant::kColdTtlS, Constant::kColdTtlSDefaultValue);
 
   xdp::ColumnFamilyMap column_families;
   for (const auto& cf_name : column_family_names) {
@@ -751,8 +875,38 @@ bool CastValue(std::string value, std::string& dst_value) {
   return true;
 }
 
+template <>
+bool CastValue(std::string value, bool& dst_value) {
+  if (value == "true") {
+    dst_value = true;
+  } else if (value == "false") {
+    dst_value = false;
+  } else {
+    DINGO_LOG(FATAL) << fmt::format("[xdprocks] cast bool failed, value: {}.", value);
+    return false;
+  }
+  return true;
+}
+
+// The size of level [0, cold_level) when every level is full, L0 is estimated as L1 like rocksdb placing sst by
+// cf_paths target size, so the sst of these levels are placed in the first path.
+static uint64_t CalcHotPathTargetSize(uint64_t max_bytes_for_level_base, double max_bytes_for_level_multiplier,
+                                      int cold_level) {
+  uint64_t target_size = 0;
+  double level_size = max_bytes_for_level_base;
+  for (int level = 0; level < cold_level; ++level) {
+    target_size += static_cast<uint64_t>(level_size);
+    if (level > 0) {
+      level_size *= max_bytes_for_level_multiplier;
+    }
+  }
+
+  return target_size;
+}
+
 // set cf config
-static xdprocks::ColumnFamilyOptions GenRcoksDBColumnFamilyOptions(xdp::ColumnFamilyPtr column_family) {
+static xdprocks::ColumnFamilyOptions GenRcoksDBColumnFamilyOptions(const std::string& db_path,
+                                                                   xdp::ColumnFamilyPtr column_family) {
   xdprocks::ColumnFamilyOptions family_options;
   xdprocks::BlockBasedTableOptions table_options;
 
@@ -764,7 +918,21 @@ static xdprocks::ColumnFamilyOptions GenRcoksDBColumnFamilyOptions(xdp::ColumnFa
     size_t option_value = 0;
     CastValue(column_family->GetConfItem(Constant::kBlockCache), option_value);
 
-    table_options.block_cache = xdprocks::NewLRUCache(option_value);  // LRUcache
+    xdprocks::LRUCacheOptions cache_options;
+    cache_options.capacity = option_value;
+
+    // more cached blocks per gigabyte for point read heavy cf
+    size_t secondary_cache_size = 0;
+    CastValue(column_family->GetConfItem(Constant::kCompressedSecondaryCache), secondary_cache_size);
+    if (secondary_cache_size > 0) {
+      xdprocks::CompressedSecondaryCacheOptions secondary_cache_options;
+      secondary_cache_options.capacity = secondary_cache_size;
+      cache_options.secondary_cache = xdprocks::NewCompressedSecondaryCache(secondary_cache_options);
+      DINGO_LOG(INFO) << fmt::format("[xdprocks] cf({}) compressed secondary cache size({})", column_family->Name(),
+                                     secondary_cache_size);
+    }
+
+    table_options.block_cache = xdprocks::NewLRUCache(cache_options);  // LRUcache
   }
 
   // arena_block_size
@@ -788,19 +956,61 @@ static xdprocks::ColumnFamilyOptions GenRcoksDBColumnFamilyOptions(xdp::ColumnFa
             family_options.max_bytes_for_level_multiplier);
 
   // prefix_extractor
+  // capped keeps the keys shorter than the length in domain, fixed leaves them out of the prefix bloom.
   {
     size_t value = 0;
     CastValue(column_family->GetConfItem(Constant::kPrefixExtractor), value);
 
-    family_options.prefix_extractor.reset(xdprocks::NewCappedPrefixTransform(value));
+    std::string type;
+    CastValue(column_family->GetConfItem(Constant::kPrefixExtractorType), type);
+    if (type == "fixed") {
+      family_options.prefix_extractor.reset(xdprocks::NewFixedPrefixTransform(value));
+    } else if (type == "none") {
+      family_options.prefix_extractor.reset();
+    } else {
+      if (type != "capped") {
+        DINGO_LOG(WARNING) << fmt::format("[xdprocks] unknown prefix_extractor_type({}), use capped.", type);
+      }
+      family_options.prefix_extractor.reset(xdprocks::NewCappedPrefixTransform(value));
+    }
   }
 
+  // memtable bloom, size is ratio of write_buffer_size, 0 disable.
+  CastValue(column_family->GetConfItem(Constant::kMemtablePrefixBloomSizeRatio),
+            family_options.memtable_prefix_bloom_size_ratio);
+  CastValue(column_family->GetConfItem(Constant::kMemtableWholeKeyFiltering),
+            family_options.memtable_whole_key_filtering);
+
   // max_bytes_for_level_base
   CastValue(column_family->GetConfItem(Constant::kMaxBytesForLevelBase), family_options.max_bytes_for_level_base);
 
   // target_file_size_base
   CastValue(column_family->GetConfItem(Constant::kTargetFileSizeBase), family_options.target_file_size_base);
 
+  // tiered storage, the hot levels stay in db path, the cold levels are placed in cold path.
+  {
+    std::string cold_path;
+    CastValue(column_family->GetConfItem(Constant::kColdPath), cold_path);
+    if (!cold_path.empty()) {
+      int cold_level = 0;
+      CastValue(column_family->GetConfItem(Constant::kColdLevel), cold_level);
+      uint64_t hot_target_size = CalcHotPathTargetSize(family_options.max_bytes_for_level_base,
+                                                       family_options.max_bytes_for_level_multiplier, cold_level);
+      family_options.cf_paths.emplace_back(db_path, hot_target_size);
+      family_options.cf_paths.emplace_back(cold_path, std::numeric_limits<uint64_t>::max());
+
+      uint64_t ttl_s = 0;
+      CastValue(column_family->GetConfItem(Constant::kColdTtlS), ttl_s);
+      if (ttl_s > 0) {
+        family_options.ttl = ttl_s;
+      }
+
+      DINGO_LOG(INFO) << fmt::format(
+          "[xdprocks] cf({}) tiered storage, cold_path({}) cold_level({}) hot_target_size({}) cold_ttl_s({})",
+          column_family->Name(), cold_path, cold_level, hot_target_size, ttl_s);
+    }
+  }
+
   family_options.compression_per_level = {
       xdprocks::CompressionType::kNoCompression,  xdprocks::CompressionType::kNoCompression,
       xdprocks::CompressionType::kLZ4Compression, xdprocks::CompressionType::kLZ4Compression,
@@ -808,8 +1018,15 @@ static xdprocks::ColumnFamilyOptions GenRcoksDBColumnFamilyOptions(xdp::ColumnFa
       xdprocks::CompressionType::kZSTD,
   };
 
-  table_options.filter_policy.reset(xdprocks::NewBloomFilterPolicy(10.0, false));
-  table_options.whole_key_filtering = true;
+  // sst bloom, hold whole keys for point lookup and prefixes for region bounded scan(auto_prefix_mode).
+  {
+    double bits_per_key = 0;
+    CastValue(column_family->GetConfItem(Constant::kBloomFilterBitsPerKey), bits_per_key);
+    if (bits_per_key > 0) {
+      table_options.filter_policy.reset(xdprocks::NewBloomFilterPolicy(bits_per_key, false));
+    }
+    CastValue(column_family->GetConfItem(Constant::kWholeKeyFiltering), table_options.whole_key_filtering);
+  }
 
   xdprocks::TableFactory* table_factory = NewBlockBasedTableFactory(table_options);
   family_options.table_factory.reset(table_factory);
@@ -822,7 +1039,7 @@ static xdprocks::DB* InitDB(const std::string& db_path, xdp::ColumnFamilyMap& co
   std::vector<xdprocks::ColumnFamilyDescriptor> column_family_descs;
   for (auto [cf_name, column_family] : column_families) {
     column_family->Dump();
-    xdprocks::ColumnFamilyOptions family_options = GenRcoksDBColumnFamilyOptions(column_family);
+    xdprocks::ColumnFamilyOptions family_options = GenRcoksDBColumnFamilyOptions(db_path, column_family);
     column_family_descs.push_back(xdprocks::ColumnFamilyDescriptor(cf_name, family_options));
   }
 
@@ -1074,11 +1291,18 @@ butil::Status XDPRocksRawEngine::IngestExternalFile(const std::string& cf_name,
   return butil::Status();
 }
 
-void XDPRocksRawEngine::Flush(const std::string& cf_name) {
+butil::Status XDPRocksRawEngine::Flush(const std::string& cf_name) {
   if (db_) {
     xdprocks::FlushOptions flush_options;
-    db_->Flush(flush_options, GetColumnFamily(cf_name)->GetHandle());
+    auto status = db_->Flush(flush_options, GetColumnFamily(cf_name)->GetHandle());
+    if (!status.ok()) {
+      DINGO_LOG(ERROR) << fmt::format("[xdprocks] flush failed, column family {} error: {}", cf_name,
+                                      status.ToString());
+      return butil::Status(pb::error::EINTERNAL, "Flush column family %s failed", cf_name.c_str());
+    }
   }
+
+  return butil::Status();
 }
 
 butil::Status XDPRocksRawEngine::Compact(const std::string& cf_name) {
@@ -1097,6 +1321,36 @@ butil::Status XDPRocksRawEngine::Compact(const std::string& cf_name) {
   return butil::Status();
 }
 
+butil::Status XDPRocksRawEngine::DeleteFilesInRange(const std::string& cf_name, const pb::common::Range& range) {
+  if (db_ == nullptr) {
+    return butil::Status();
+  }
+
+  auto* handle = GetColumnFamily(cf_name)->GetHandle();
+  xdprocks::Slice start_key(range.start_key());
+  xdprocks::Slice end_key(range.end_key());
+  auto status = xdprocks::DeleteFilesInRange(db_.get(), handle, &start_key, &end_key, false);
+  if (!status.ok()) {
+    DINGO_LOG(ERROR) << fmt::format("[xdprocks] delete files in range failed, column family {} range[{}, {}) error: {}",
+                                    cf_name, Helper::StringToHex(range.start_key()),
+                                    Helper::StringToHex(range.end_key()), status.ToString());
+    return butil::Status(pb::error::EINTERNAL, "Delete files in range of column family %s failed", cf_name.c_str());
+  }
+
+  // the files across the range boundary are left, compact them to drop the deleted data and range tombstones.
+  xdprocks::CompactRangeOptions options;
+  options.allow_write_stall = false;
+  status = db_->CompactRange(options, handle, &start_key, &end_key);
+  if (!status.ok()) {
+    DINGO_LOG(ERROR) << fmt::format("[xdprocks] compact range failed, column family {} range[{}, {}) error: {}",
+                                    cf_name, Helper::StringToHex(range.start_key()),
+                                    Helper::StringToHex(range.end_key()), status.ToString());
+    return butil::Status(pb::error::EINTERNAL, "Compact range of column family %s failed", cf_name.c_str());
+  }
+
+  return butil::Status();
+}
+
 void XDPRocksRawEngine::Destroy() { xdprocks::DestroyDB(db_path_, xdprocks::Options()); }
 
 void XDPRocksRawEngine::Close() {
@@ -1125,6 +1379,8 @@ void XDPRocksRawEngine::Close() {
 std::vector<int64_t> XDPRocksRawEngine::GetApproximateSizes(const std::string& cf_name,
                                                             std::vector<pb::common::Range>& ranges) {
   xdprocks::SizeApproximationOptions options;
+  // the recent writes are still in memtable, count them too.
+  options.include_memtables = true;
 
   xdprocks::Range inner_ranges[ranges.size()];
   for (int i = 0; i < ranges.size(); ++i) {
@@ -185,6 +185,16 @@ class Reader : public RawEngine::Reader {
   butil::Status KvGet(const std::string& cf_name, dingodb::SnapshotPtr snapshot, const std::string& key,
                       std::string& value) override;
 
+  butil::Status KvGetPinned(const std::string& cf_name, const std::string& key, const ValueVisitor& visitor) override;
+  butil::Status KvGetPinned(const std::string& cf_name, dingodb::SnapshotPtr snapshot, const std::string& key,
+                            const ValueVisitor& visitor) override;
+
+  butil::Status KvMultiGet(const std::string& cf_name, const std::vector<std::string>& keys,
+                           std::vector<std::string>& values, std::vector<bool>& exists) override;
+  butil::Status KvMultiGet(const std::string& cf_name, dingodb::SnapshotPtr snapshot,
+                           const std::vector<std::string>& keys, std::vector<std::string>& values,
+                           std::vector<bool>& exists) override;
+
   butil::Status KvScan(const std::string& cf_name, const std::string& start_key, const std::string& end_key,
                        std::vector<pb::common::KeyValue>& kvs) override;
   butil::Status KvScan(const std::string& cf_name, std::shared_ptr<dingodb::Snapshot> snapshot,
@@ -209,6 +219,11 @@ class Reader : public RawEngine::Reader {
 
   butil::Status KvGet(ColumnFamilyPtr column_family, dingodb::SnapshotPtr snapshot, const std::string& key,
                       std::string& value);
+  butil::Status KvGetPinned(ColumnFamilyPtr column_family, dingodb::SnapshotPtr snapshot, const std::string& key,
+                            const ValueVisitor& visitor);
+  butil::Status KvMultiGet(ColumnFamilyPtr column_family, dingodb::SnapshotPtr snapshot,
+                           const std::vector<std::string>& keys, std::vector<std::string>& values,
+                           std::vector<bool>& exists);
   butil::Status KvScan(ColumnFamilyPtr column_family, std::shared_ptr<dingodb::Snapshot> snapshot,
                        const std::string& start_key, const std::string& end_key,
                        std::vector<pb::common::KeyValue>& kvs);
@@ -282,8 +297,9 @@ class XDPRocksRawEngine : public RawEngine {
 
   butil::Status IngestExternalFile(const std::string& cf_name, const std::vector<std::string>& files) override;
 
-  void Flush(const std::string& cf_name) override;
+  butil::Status Flush(const std::string& cf_name) override;
   butil::Status Compact(const std::string& cf_name) override;
+  butil::Status DeleteFilesInRange(const std::string& cf_name, const pb::common::Range& range) override;
 
   std::vector<int64_t> GetApproximateSizes(const std::string& cf_name, std::vector<pb::common::Range>& ranges) override;
 
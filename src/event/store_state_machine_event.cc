@@ -24,6 +24,7 @@
 #include "common/logging.h"
 #include "config/config_helper.h"
 #include "fmt/core.h"
+#include "gflags/gflags.h"
 #include "handler/raft_snapshot_handler.h"
 #include "handler/raft_vote_handler.h"
 #include "proto/common.pb.h"
@@ -33,6 +34,8 @@
 
 namespace dingodb {
 
+DECLARE_int32(raft_max_clock_drift_ms);
+
 int SmApplyEventListener::OnEvent(std::shared_ptr<Event> event) {
   auto the_event = std::dynamic_pointer_cast<SmApplyEvent>(event);
 
@@ -44,11 +47,41 @@ int SmApplyEventListener::OnEvent(std::shared_ptr<Event> event) {
     auto* done = dynamic_cast<BaseClosure*>(the_event->done);
     ctx = done ? done->GetCtx() : nullptr;
   }
-  for (const auto& req : the_event->raft_cmd->requests()) {
+  const auto& requests = the_event->raft_cmd->requests();
+  for (int i = 0; i < requests.size(); ++i) {
+    const auto& req = requests.at(i);
+    // coalesced raft cmd, apply request with its caller's context
+    auto req_ctx = (ctx != nullptr && static_cast<size_t>(i) < ctx->SubContexts().size()) ? ctx->SubContexts()[i] : ctx;
     auto handler = handler_collection_->GetHandler(static_cast<HandlerType>(req.cmd_type()));
     if (handler) {
-      handler->Handle(ctx, the_event->region, the_event->engine, req, the_event->region_metrics, the_event->term_id,
-                      the_event->log_id);
+      if (the_event->write_batch != nullptr) {
+        if (handler->AppendWriteBatch(req_ctx, the_event->region, the_event->engine, req, the_event->region_metrics,
+                                      the_event->term_id, the_event->log_id, *the_event->write_batch)) {
+          continue;
+        }
+
+        // keep order with the coalesced writes
+        auto status = the_event->write_batch->Commit();
+        if (!status.ok()) {
+          DINGO_LOG(FATAL) << fmt::format("[raft.apply][region({})] commit write batch failed, error: {}",
+                                          the_event->region->Id(), status.error_str());
+        }
+      }
+
+      switch (the_event->stage) {
+        case ApplyStage::kStore:
+          handler->HandleStore(req_ctx, the_event->region, the_event->engine, req, the_event->region_metrics,
+                               the_event->term_id, the_event->log_id);
+          break;
+        case ApplyStage::kIndex:
+          handler->HandleIndex(req_ctx, the_event->region, the_event->engine, req, the_event->region_metrics,
+                               the_event->term_id, the_event->log_id);
+          break;
+        default:
+          handler->Handle(req_ctx, the_event->region, the_event->engine, req, the_event->region_metrics,
+                          the_event->term_id, the_event->log_id);
+          break;
+      }
     } else {
       DINGO_LOG(ERROR) << "Unknown raft cmd type " << req.cmd_type();
     }
@@ -90,7 +123,7 @@ int SmLeaderStartEventListener::OnEvent(std::shared_ptr<Event> event) {
   if (node != nullptr) {
     uint32_t election_timeout_ms = ConfigHelper::GetElectionTimeout() * 1000;
     if (node->ElectionTimeout() != election_timeout_ms) {
-      node->ResetElectionTimeout(election_timeout_ms, 1000);
+      node->ResetElectionTimeout(election_timeout_ms, FLAGS_raft_max_clock_drift_ms);
     }
   }
 
@@ -188,7 +221,7 @@ int SmStartFollowingEventListener::OnEvent(std::shared_ptr<Event> event) {
   if (node != nullptr) {
     uint32_t election_timeout_ms = ConfigHelper::GetElectionTimeout() * 1000;
     if (node->ElectionTimeout() != election_timeout_ms) {
-      node->ResetElectionTimeout(election_timeout_ms, 1000);
+      node->ResetElectionTimeout(election_timeout_ms, FLAGS_raft_max_clock_drift_ms);
     }
   }
 
@@ -18,6 +18,7 @@
 #include <cstdint>
 
 #include "event/event.h"
+#include "handler/apply_write_batch.h"
 #include "handler/handler.h"
 #include "handler/raft_apply_handler.h"
 #include "metrics/store_metrics_manager.h"
@@ -26,6 +27,13 @@
 
 namespace dingodb {
 
+// Pipeline apply run a log in two stage, kAll run the whole handler.
+enum class ApplyStage {
+  kAll = 0,
+  kStore = 1,
+  kIndex = 2,
+};
+
 // State Machine apply event
 struct SmApplyEvent : public Event {
   SmApplyEvent() : Event(EventSource::kRaftStateMachine, EventType::kSmApply) {}
@@ -39,6 +47,9 @@ struct SmApplyEvent : public Event {
   int64_t term_id;
   int64_t log_id;
   std::shared_ptr<Context> ctx;
+  ApplyStage stage{ApplyStage::kAll};
+  // Coalesce the blind writes of consecutive entries, nullptr is write alone.
+  ApplyWriteBatchPtr write_batch;
 };
 
 class SmApplyEventListener : public EventListener {
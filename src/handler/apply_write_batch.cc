@@ -0,0 +1,123 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "handler/apply_write_batch.h"
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "common/logging.h"
+#include "fmt/core.h"
+
+namespace dingodb {
+
+void ApplyWriteBatch::Put(const std::string &cf_name, const pb::common::KeyValue &kv) {
+  auto &cf_writes = writes_[cf_name];
+  auto it = cf_writes.find(kv.key());
+  if (it == cf_writes.end()) {
+    cf_writes.emplace(kv.key(), kv.value());
+    ++count_;
+    bytes_ += kv.key().size() + kv.value().size();
+  } else {
+    bytes_ -= it->second.has_value() ? static_cast<int64_t>(it->second->size()) : 0;
+    bytes_ += kv.value().size();
+    it->second = kv.value();
+  }
+}
+
+void ApplyWriteBatch::Delete(const std::string &cf_name, const std::string &key) {
+  auto &cf_writes = writes_[cf_name];
+  auto it = cf_writes.find(key);
+  if (it == cf_writes.end()) {
+    cf_writes.emplace(key, std::nullopt);
+    ++count_;
+    bytes_ += key.size();
+  } else {
+    bytes_ -= it->second.has_value() ? static_cast<int64_t>(it->second->size()) : 0;
+    it->second = std::nullopt;
+  }
+}
+
+void ApplyWriteBatch::AddPostCommit(std::function<void()> func) { post_commits_.push_back(std::move(func)); }
+
+bool ApplyWriteBatch::Lookup(const std::string &cf_name, const std::string &key, bool &is_put) const {
+  auto cf_it = writes_.find(cf_name);
+  if (cf_it == writes_.end()) {
+    return false;
+  }
+  auto it = cf_it->second.find(key);
+  if (it == cf_it->second.end()) {
+    return false;
+  }
+
+  is_put = it->second.has_value();
+  return true;
+}
+
+bool ApplyWriteBatch::Lookup(const std::string &cf_name, const std::string &key,
+                             std::optional<std::string> &value) const {
+  auto cf_it = writes_.find(cf_name);
+  if (cf_it == writes_.end()) {
+    return false;
+  }
+  auto it = cf_it->second.find(key);
+  if (it == cf_it->second.end()) {
+    return false;
+  }
+
+  value = it->second;
+  return true;
+}
+
+butil::Status ApplyWriteBatch::Commit() {
+  if (!writes_.empty()) {
+    std::map<std::string, std::vector<pb::common::KeyValue>> kv_puts_with_cf;
+    std::map<std::string, std::vector<std::string>> kv_deletes_with_cf;
+    for (auto &[cf_name, cf_writes] : writes_) {
+      for (auto &[key, value] : cf_writes) {
+        if (value.has_value()) {
+          pb::common::KeyValue kv;
+          kv.set_key(key);
+          kv.set_value(std::move(value.value()));
+          kv_puts_with_cf[cf_name].push_back(std::move(kv));
+        } else {
+          kv_deletes_with_cf[cf_name].push_back(key);
+        }
+      }
+    }
+
+    auto status = engine_->Writer()->KvBatchPutAndDelete(kv_puts_with_cf, kv_deletes_with_cf);
+    if (!status.ok()) {
+      DINGO_LOG(ERROR) << fmt::format("[raft.apply] commit write batch failed, count: {} bytes: {} error: {}", count_,
+                                      bytes_, status.error_str());
+      return status;
+    }
+  }
+
+  for (auto &func : post_commits_) {
+    func();
+  }
+
+  writes_.clear();
+  post_commits_.clear();
+  count_ = 0;
+  bytes_ = 0;
+
+  return butil::Status();
+}
+
+}  // namespace dingodb
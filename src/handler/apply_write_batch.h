@@ -0,0 +1,75 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_HANDLER_APPLY_WRITE_BATCH_H_
+#define DINGODB_HANDLER_APPLY_WRITE_BATCH_H_
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "butil/status.h"
+#include "engine/raw_engine.h"
+#include "proto/common.pb.h"
+
+namespace dingodb {
+
+// Coalesce the blind writes of consecutive raft entries in one on_apply, commit them with one multi cf WriteBatch.
+// The last write of a key wins, so puts and deletes of consecutive entries keep their order.
+class ApplyWriteBatch {
+ public:
+  explicit ApplyWriteBatch(std::shared_ptr<RawEngine> engine) : engine_(engine) {}
+  ~ApplyWriteBatch() = default;
+
+  ApplyWriteBatch(const ApplyWriteBatch &) = delete;
+  ApplyWriteBatch &operator=(const ApplyWriteBatch &) = delete;
+
+  void Put(const std::string &cf_name, const pb::common::KeyValue &kv);
+  void Delete(const std::string &cf_name, const std::string &key);
+
+  // Run after commit, e.g. invalidate cache which must not be refilled with the old value.
+  void AddPostCommit(std::function<void()> func);
+
+  // Return false if the key is not written in batch, otherwise is_put tell put or delete.
+  bool Lookup(const std::string &cf_name, const std::string &key, bool &is_put) const;
+  // Same as above, but also return the value, nullopt is delete.
+  bool Lookup(const std::string &cf_name, const std::string &key, std::optional<std::string> &value) const;
+
+  bool Empty() const { return writes_.empty() && post_commits_.empty(); }
+  int64_t Count() const { return count_; }
+  int64_t ByteSize() const { return bytes_; }
+
+  // Write all coalesced writes to engine, then run post commits and clear.
+  butil::Status Commit();
+
+ private:
+  std::shared_ptr<RawEngine> engine_;
+
+  // cf_name -> key -> value, nullopt is delete.
+  std::map<std::string, std::map<std::string, std::optional<std::string>>> writes_;
+  std::vector<std::function<void()>> post_commits_;
+
+  int64_t count_{0};
+  int64_t bytes_{0};
+};
+
+using ApplyWriteBatchPtr = std::shared_ptr<ApplyWriteBatch>;
+
+}  // namespace dingodb
+
+#endif  // DINGODB_HANDLER_APPLY_WRITE_BATCH_H_
@@ -23,6 +23,7 @@
 #include "butil/status.h"
 #include "common/context.h"
 #include "engine/raw_engine.h"
+#include "handler/apply_write_batch.h"
 #include "meta/store_meta_manager.h"
 #include "metrics/store_metrics_manager.h"
 #include "proto/raft.pb.h"
@@ -70,6 +71,10 @@ enum class HandlerType {
   kDocumentIndexLeaderStop = 2101,
   kDocumentIndexFollowerStart = 2102,
   kDocumentIndexFollowerStop = 2103,
+
+  // Txn pessimistic lock
+  kTxnPessimisticLockLeaderStart = 2200,
+  kTxnPessimisticLockLeaderStop = 2201,
 };
 
 class Handler {
@@ -85,6 +90,28 @@ class Handler {
                      const pb::raft::Request &req, store::RegionMetricsPtr region_metrics, int64_t term_id,
                      int64_t log_id) = 0;
 
+  // Pipeline apply split Handle into store stage and index stage, the index stage of log N run concurrently
+  // with the store stage of log N+1. Handler not split run all in store stage.
+  virtual int HandleStore(std::shared_ptr<Context> ctx, store::RegionPtr region, std::shared_ptr<RawEngine> engine,
+                          const pb::raft::Request &req, store::RegionMetricsPtr region_metrics, int64_t term_id,
+                          int64_t log_id) {
+    return Handle(ctx, region, engine, req, region_metrics, term_id, log_id);
+  }
+  virtual int HandleIndex(std::shared_ptr<Context> /*ctx*/, store::RegionPtr /*region*/,
+                          std::shared_ptr<RawEngine> /*engine*/, const pb::raft::Request & /*req*/,
+                          store::RegionMetricsPtr /*region_metrics*/, int64_t /*term_id*/, int64_t /*log_id*/) {
+    return 0;
+  }
+
+  // Coalesce the blind write of request into write_batch instead of writing engine, the engine write is in
+  // write_batch commit. Return false if not support, then Handle is called after the batch commit.
+  virtual bool AppendWriteBatch(std::shared_ptr<Context> /*ctx*/, store::RegionPtr /*region*/,
+                                std::shared_ptr<RawEngine> /*engine*/, const pb::raft::Request & /*req*/,
+                                store::RegionMetricsPtr /*region_metrics*/, int64_t /*term_id*/, int64_t /*log_id*/,
+                                ApplyWriteBatch & /*write_batch*/) {
+    return false;
+  }
+
   virtual int Handle(store::RegionPtr region, std::shared_ptr<RawEngine> engine, int64_t term, int64_t log_index,
                      braft::SnapshotWriter *writer, braft::Closure *done) = 0;
   virtual int Handle(store::RegionPtr region, std::shared_ptr<RawEngine> engine, braft::SnapshotReader *reader) = 0;
@@ -19,12 +19,15 @@
 #include <cstdint>
 #include <map>
 #include <memory>
+#include <optional>
+#include <set>
 #include <string>
 #include <utility>
 #include <vector>
 
 #include "bthread/bthread.h"
 #include "butil/status.h"
+#include "bvar/reducer.h"
 #include "common/constant.h"
 #include "common/failpoint.h"
 #include "common/helper.h"
@@ -32,9 +35,15 @@
 #include "common/role.h"
 #include "config/config_manager.h"
 #include "document/codec.h"
+#include "engine/change_capture.h"
+#include "engine/flushed_applied_index_tracker.h"
 #include "engine/raw_engine.h"
+#include "engine/rocks_raw_engine.h"
+#include "engine/row_cache.h"
 #include "event/store_state_machine_event.h"
 #include "fmt/core.h"
+#include "gflags/gflags.h"
+#include "handler/apply_write_batch.h"
 #include "meta/store_meta_manager.h"
 #include "proto/common.pb.h"
 #include "proto/error.pb.h"
@@ -42,16 +51,133 @@
 #include "proto/raft.pb.h"
 #include "server/server.h"
 #include "vector/codec.h"
+#include "vector/vector_index.h"
 #include "vector/vector_index_utils.h"
+#include "vector/vector_scalar_bitmap_index.h"
 
 DECLARE_int32(init_election_timeout_ms);
 
 namespace dingodb {
 DECLARE_bool(dingo_log_switch_scalar_speed_up_detail);
+DECLARE_string(raft_snapshot_policy);
+DECLARE_bool(raft_snapshot_range_cut_sst);
+DECLARE_bool(enable_vector_index_split_lazy_rebuild);
+DECLARE_bool(enable_region_incremental_key_count);
+
+DEFINE_bool(enable_raft_apply_ingest, false,
+            "enable apply the big sorted put batch by ingesting sst instead of writing memtable, e.g. bulk load");
+DEFINE_int64(raft_apply_ingest_min_bytes, 4 * 1024 * 1024, "the min bytes of put batch applied by ingesting sst");
+
+bvar::Adder<int64_t> g_raft_apply_ingest_count("dingo_raft_apply_ingest_count");
+bvar::Adder<int64_t> g_raft_apply_ingest_bytes("dingo_raft_apply_ingest_bytes");
+
+// Bulk load, the big batch of sorted keys are written to a sst and ingested, it skips the memtable and wal, and the
+// sst is placed at the bottom level if the range is empty. Every replica does it alone, the result is the same as
+// writing the batch, so it falls back to write when the batch is not suitable or failed.
+static bool IsIngestPut(std::shared_ptr<RawEngine> engine, const pb::raft::PutRequest &request) {
+  if (!FLAGS_enable_raft_apply_ingest || engine->GetRawEngineType() != pb::common::RAW_ENG_ROCKSDB) {
+    return false;
+  }
+
+  int64_t bytes = 0;
+  for (const auto &kv : request.kvs()) {
+    bytes += kv.key().size() + kv.value().size();
+  }
+  if (bytes < FLAGS_raft_apply_ingest_min_bytes) {
+    return false;
+  }
+
+  // sst require strictly increasing keys
+  const auto &kvs = request.kvs();
+  for (int i = 0; i < kvs.size(); ++i) {
+    if (kvs[i].key().empty() || (i > 0 && kvs[i - 1].key() >= kvs[i].key())) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+static butil::Status IngestPut(store::RegionPtr region, std::shared_ptr<RawEngine> engine,
+                               const pb::raft::PutRequest &request, int64_t log_id) {
+  std::string filepath = fmt::format("{}/ingest_{}_{}_{}.sst", Server::GetInstance().GetCheckpointPath(),
+                                     region->Id(), log_id, Helper::TimestampNs());
+
+  auto kvs = Helper::PbRepeatedToVector(request.kvs());
+  auto status = RocksRawEngine::NewSstFileWriter()->SaveFile(kvs, filepath);
+  if (status.ok()) {
+    status = engine->IngestExternalFile(request.cf_name(), {filepath});
+  }
+  Helper::RemoveFileOrDirectory(filepath);
+  if (!status.ok()) {
+    return status;
+  }
+
+  int64_t bytes = 0;
+  for (const auto &kv : kvs) {
+    bytes += kv.key().size() + kv.value().size();
+  }
+  g_raft_apply_ingest_count << 1;
+  g_raft_apply_ingest_bytes << bytes;
+
+  return butil::Status();
+}
+
+void AddCapturePostCommit(int64_t region_id, int64_t log_id, const pb::raft::Request &req,
+                          ApplyWriteBatch &write_batch) {
+  std::vector<ChangeEvent> events;
+  ChangeCapture::Collect(req, log_id, events);
+  if (events.empty()) {
+    return;
+  }
+
+  write_batch.AddPostCommit([region_id, log_id, events = std::move(events)]() {
+    ChangeCapture::GetInstance().Append(region_id, log_id, events);
+  });
+}
+
+static bool IsIncrementalKeyCount(store::RegionMetricsPtr region_metrics, const std::string &cf_name) {
+  return FLAGS_enable_region_incremental_key_count && region_metrics != nullptr && cf_name == Constant::kStoreDataCF;
+}
+
+// The key count delta must be added before the write, see RegionMetrics::VerifyKeyCount.
+// The key of write batch is not committed yet, its state is looked up in write batch first.
+static void AddKeyCountDelta(store::RegionMetricsPtr region_metrics, std::shared_ptr<RawEngine> engine,
+                             const std::string &cf_name, const std::vector<std::string> &keys, bool is_put,
+                             int64_t log_id, const ApplyWriteBatch *write_batch) {
+  auto reader = engine->Reader();
+  std::set<std::string> unique_keys(keys.begin(), keys.end());
+  int64_t delta = 0;
+  for (const auto &key : unique_keys) {
+    bool is_exist = false;
+    if (write_batch == nullptr || !write_batch->Lookup(cf_name, key, is_exist)) {
+      std::string value;
+      is_exist = reader->KvGet(cf_name, key, value).ok();
+    }
+    if (is_put && !is_exist) {
+      ++delta;
+    } else if (!is_put && is_exist) {
+      --delta;
+    }
+  }
+
+  if (delta != 0) {
+    region_metrics->AddKeyCountDelta(delta, log_id);
+  }
+}
+
+static std::vector<std::string> GetKeys(const google::protobuf::RepeatedPtrField<pb::common::KeyValue> &kvs) {
+  std::vector<std::string> keys;
+  keys.reserve(kvs.size());
+  for (const auto &kv : kvs) {
+    keys.push_back(kv.key());
+  }
+  return keys;
+}
 
 int PutHandler::Handle(std::shared_ptr<Context> ctx, store::RegionPtr region, std::shared_ptr<RawEngine> engine,
                        const pb::raft::Request &req, store::RegionMetricsPtr region_metrics, int64_t /*term_id*/,
-                       int64_t /*log_id*/) {
+                       int64_t log_id) {
   butil::Status status;
   const auto &request = req.put();
 
@@ -59,7 +185,25 @@ int PutHandler::Handle(std::shared_ptr<Context> ctx, store::RegionPtr region, st
   if (!writer) {
     DINGO_LOG(FATAL) << "[raft.apply][region(" << region->Id() << ")] NewWriter failed";
   }
-  if (request.kvs().size() == 1) {
+
+  bool is_ingested = false;
+  if (IsIngestPut(engine, request)) {
+    auto ingest_status = IngestPut(region, engine, request, log_id);
+    if (ingest_status.ok()) {
+      is_ingested = true;
+    } else {
+      DINGO_LOG(WARNING) << fmt::format("[raft.apply][region({})] ingest put failed, fallback to write, error: {}",
+                                        region->Id(), ingest_status.error_str());
+    }
+  }
+
+  if (IsIncrementalKeyCount(region_metrics, request.cf_name())) {
+    AddKeyCountDelta(region_metrics, engine, request.cf_name(), GetKeys(request.kvs()), true, log_id, nullptr);
+  }
+
+  if (is_ingested) {
+    // already written
+  } else if (request.kvs().size() == 1) {
     status = writer->KvPut(request.cf_name(), request.kvs().Get(0));
   } else {
     status = writer->KvBatchPutAndDelete(request.cf_name(), Helper::PbRepeatedToVector(request.kvs()), {});
@@ -69,6 +213,16 @@ int PutHandler::Handle(std::shared_ptr<Context> ctx, store::RegionPtr region, st
     DINGO_LOG(FATAL) << fmt::format("[raft.apply][region({})] put failed, error: {}", region->Id(), status.error_str());
   }
 
+  if (RowCache::IsEnabled()) {
+    for (const auto &kv : request.kvs()) {
+      RowCache::GetInstance().Invalidate(region->Id(), kv.key());
+    }
+  }
+
+  if (status.ok() && ChangeCapture::IsEnabled()) {
+    ChangeCapture::GetInstance().Capture(region->Id(), log_id, req);
+  }
+
   if (ctx) {
     ctx->SetStatus(status);
   }
@@ -81,9 +235,63 @@ int PutHandler::Handle(std::shared_ptr<Context> ctx, store::RegionPtr region, st
   return 0;
 }
 
-int DeleteRangeHandler::Handle(std::shared_ptr<Context> ctx, store::RegionPtr /*region*/,
+bool PutHandler::AppendWriteBatch(std::shared_ptr<Context> ctx, store::RegionPtr region,
+                                  std::shared_ptr<RawEngine> engine, const pb::raft::Request &req,
+                                  store::RegionMetricsPtr region_metrics, int64_t /*term_id*/, int64_t log_id,
+                                  ApplyWriteBatch &write_batch) {
+  const auto &request = req.put();
+  // empty key fail alone in Handle
+  if (request.kvs().empty()) {
+    return false;
+  }
+  // bulk load is ingested alone in Handle
+  if (IsIngestPut(engine, request)) {
+    return false;
+  }
+  for (const auto &kv : request.kvs()) {
+    if (kv.key().empty()) {
+      return false;
+    }
+  }
+
+  if (IsIncrementalKeyCount(region_metrics, request.cf_name())) {
+    AddKeyCountDelta(region_metrics, engine, request.cf_name(), GetKeys(request.kvs()), true, log_id, &write_batch);
+  }
+
+  for (const auto &kv : request.kvs()) {
+    write_batch.Put(request.cf_name(), kv);
+  }
+
+  if (RowCache::IsEnabled()) {
+    std::vector<std::string> keys;
+    keys.reserve(request.kvs_size());
+    for (const auto &kv : request.kvs()) {
+      keys.push_back(kv.key());
+    }
+    write_batch.AddPostCommit([region_id = region->Id(), keys = std::move(keys)]() {
+      RowCache::GetInstance().Invalidate(region_id, keys);
+    });
+  }
+
+  if (ChangeCapture::IsEnabled()) {
+    AddCapturePostCommit(region->Id(), log_id, req, write_batch);
+  }
+
+  if (ctx) {
+    ctx->SetStatus(butil::Status());
+  }
+
+  // Update region metrics min/max key
+  if (region_metrics != nullptr) {
+    region_metrics->UpdateMaxAndMinKey(request.kvs());
+  }
+
+  return true;
+}
+
+int DeleteRangeHandler::Handle(std::shared_ptr<Context> ctx, store::RegionPtr region,
                                std::shared_ptr<RawEngine> engine, const pb::raft::Request &req,
-                               store::RegionMetricsPtr region_metrics, int64_t /*term_id*/, int64_t /*log_id*/) {
+                               store::RegionMetricsPtr region_metrics, int64_t /*term_id*/, int64_t log_id) {
   butil::Status status;
   const auto &request = req.delete_range();
 
@@ -95,6 +303,9 @@ int DeleteRangeHandler::Handle(std::shared_ptr<Context> ctx, store::RegionPtr /*
     const auto &range = request.ranges()[0];
     status = reader->KvCount(request.cf_name(), range.start_key(), range.end_key(), internal_delete_count);
     if (status.ok() && 0 != internal_delete_count) {
+      if (IsIncrementalKeyCount(region_metrics, request.cf_name())) {
+        region_metrics->AddKeyCountDelta(-internal_delete_count, log_id);
+      }
       status = writer->KvDeleteRange(request.cf_name(), range);
     }
     delete_count = internal_delete_count;
@@ -111,12 +322,23 @@ int DeleteRangeHandler::Handle(std::shared_ptr<Context> ctx, store::RegionPtr /*
     }
 
     if (status.ok() && 0 != delete_count) {
+      if (IsIncrementalKeyCount(region_metrics, request.cf_name())) {
+        region_metrics->AddKeyCountDelta(-delete_count, log_id);
+      }
       std::map<std::string, std::vector<pb::common::Range>> range_with_cfs;
       range_with_cfs[request.cf_name()] = Helper::PbRepeatedToVector(request.ranges());
       status = writer->KvBatchDeleteRange(range_with_cfs);
     }
   }
 
+  if (RowCache::IsEnabled()) {
+    RowCache::GetInstance().InvalidateRegion(region->Id());
+  }
+
+  if (status.ok() && ChangeCapture::IsEnabled()) {
+    ChangeCapture::GetInstance().Capture(region->Id(), log_id, req);
+  }
+
   if (ctx && ctx->Response()) {
     auto *response = dynamic_cast<pb::store::KvDeleteRangeResponse *>(ctx->Response());
     if (response) {
@@ -135,7 +357,7 @@ int DeleteRangeHandler::Handle(std::shared_ptr<Context> ctx, store::RegionPtr /*
 
 int DeleteBatchHandler::Handle(std::shared_ptr<Context> ctx, store::RegionPtr region, std::shared_ptr<RawEngine> engine,
                                const pb::raft::Request &req, store::RegionMetricsPtr region_metrics,
-                               int64_t /*term_id*/, int64_t /*log_id*/) {
+                               int64_t /*term_id*/, int64_t log_id) {
   butil::Status status;
   const auto &request = req.delete_batch();
 
@@ -152,6 +374,11 @@ int DeleteBatchHandler::Handle(std::shared_ptr<Context> ctx, store::RegionPtr re
     i++;
   }
 
+  if (IsIncrementalKeyCount(region_metrics, request.cf_name())) {
+    AddKeyCountDelta(region_metrics, engine, request.cf_name(), Helper::PbRepeatedToVector(request.keys()), false,
+                     log_id, nullptr);
+  }
+
   auto writer = engine->Writer();
   if (!writer) {
     DINGO_LOG(FATAL) << "[raft.apply][region(" << region->Id() << ")] NewWriter failed";
@@ -167,6 +394,16 @@ int DeleteBatchHandler::Handle(std::shared_ptr<Context> ctx, store::RegionPtr re
                                     status.error_str());
   }
 
+  if (RowCache::IsEnabled()) {
+    for (const auto &key : request.keys()) {
+      RowCache::GetInstance().Invalidate(region->Id(), key);
+    }
+  }
+
+  if (status.ok() && ChangeCapture::IsEnabled()) {
+    ChangeCapture::GetInstance().Capture(region->Id(), log_id, req);
+  }
+
   if (ctx && ctx->Response()) {
     auto *response = dynamic_cast<pb::store::KvBatchDeleteResponse *>(ctx->Response());
     ctx->SetStatus(status);
@@ -183,6 +420,277 @@ int DeleteBatchHandler::Handle(std::shared_ptr<Context> ctx, store::RegionPtr re
   return 0;
 }
 
+bool DeleteBatchHandler::AppendWriteBatch(std::shared_ptr<Context> ctx, store::RegionPtr region,
+                                          std::shared_ptr<RawEngine> engine, const pb::raft::Request &req,
+                                          store::RegionMetricsPtr region_metrics, int64_t /*term_id*/,
+                                          int64_t log_id, ApplyWriteBatch &write_batch) {
+  const auto &request = req.delete_batch();
+  if (request.keys().empty()) {
+    return false;
+  }
+  for (const auto &key : request.keys()) {
+    if (key.empty()) {
+      return false;
+    }
+  }
+
+  // key state see the writes not committed yet
+  auto reader = engine->Reader();
+  std::vector<bool> key_states(request.keys().size(), false);
+  auto snapshot = engine->GetSnapshot();
+  size_t i = 0;
+  for (const auto &key : request.keys()) {
+    bool is_put = false;
+    if (write_batch.Lookup(request.cf_name(), key, is_put)) {
+      key_states[i] = is_put;
+    } else {
+      std::string value;
+      key_states[i] = reader->KvGet(request.cf_name(), snapshot, key, value).ok();
+    }
+    i++;
+  }
+
+  if (IsIncrementalKeyCount(region_metrics, request.cf_name())) {
+    AddKeyCountDelta(region_metrics, engine, request.cf_name(), Helper::PbRepeatedToVector(request.keys()), false,
+                     log_id, &write_batch);
+  }
+
+  for (const auto &key : request.keys()) {
+    write_batch.Delete(request.cf_name(), key);
+  }
+
+  if (RowCache::IsEnabled()) {
+    write_batch.AddPostCommit([region_id = region->Id(), keys = Helper::PbRepeatedToVector(request.keys())]() {
+      RowCache::GetInstance().Invalidate(region_id, keys);
+    });
+  }
+
+  if (ChangeCapture::IsEnabled()) {
+    AddCapturePostCommit(region->Id(), log_id, req, write_batch);
+  }
+
+  if (ctx && ctx->Response()) {
+    auto *response = dynamic_cast<pb::store::KvBatchDeleteResponse *>(ctx->Response());
+    ctx->SetStatus(butil::Status());
+    for (const auto &state : key_states) {
+      response->add_key_states(state);
+    }
+  }
+
+  // Update region metrics min/max key policy
+  if (region_metrics != nullptr) {
+    region_metrics->UpdateMaxAndMinKeyPolicy(request.keys());
+  }
+
+  return true;
+}
+
+// The writes of conditional request which pass the condition, in the form of put and delete batch request, so the
+// change capture and region metrics see them as the plain writes.
+struct ConditionalWrite {
+  ConditionalWrite(const std::string &cf_name, int key_count) : key_states(key_count, false) {
+    put_req.set_cmd_type(pb::raft::CmdType::PUT);
+    put_req.mutable_put()->set_cf_name(cf_name);
+    delete_req.set_cmd_type(pb::raft::CmdType::DELETEBATCH);
+    delete_req.mutable_delete_batch()->set_cf_name(cf_name);
+  }
+
+  pb::raft::Request put_req;
+  pb::raft::Request delete_req;
+  std::vector<bool> key_states;
+  butil::Status status;
+};
+
+// The condition is evaluated at apply time, so the check and the write are atomic against all writes of region.
+// The value of key sees the writes of write batch not committed yet, nullopt means not exist.
+static std::vector<std::optional<std::string>> GetApplyValues(
+    std::shared_ptr<RawEngine> engine, const std::string &cf_name,
+    const google::protobuf::RepeatedPtrField<pb::common::KeyValue> &kvs, const ApplyWriteBatch *write_batch) {
+  auto reader = engine->Reader();
+  auto snapshot = engine->GetSnapshot();
+  std::vector<std::optional<std::string>> values(kvs.size());
+  for (int i = 0; i < kvs.size(); ++i) {
+    const auto &key = kvs.Get(i).key();
+    if (write_batch != nullptr && write_batch->Lookup(cf_name, key, values[i])) {
+      continue;
+    }
+    std::string value;
+    if (reader->KvGet(cf_name, snapshot, key, value).ok()) {
+      values[i] = std::move(value);
+    }
+  }
+
+  return values;
+}
+
+static ConditionalWrite EvalPutIfAbsent(std::shared_ptr<RawEngine> engine, const pb::raft::PutIfAbsentRequest &request,
+                                        const ApplyWriteBatch *write_batch) {
+  ConditionalWrite cond_write(request.cf_name(), request.kvs_size());
+
+  auto values = GetApplyValues(engine, request.cf_name(), request.kvs(), write_batch);
+  for (int i = 0; i < request.kvs_size(); ++i) {
+    if (values[i].has_value()) {
+      if (request.is_atomic()) {
+        return ConditionalWrite(request.cf_name(), request.kvs_size());
+      }
+      continue;
+    }
+
+    *cond_write.put_req.mutable_put()->add_kvs() = request.kvs(i);
+    cond_write.key_states[i] = true;
+  }
+
+  return cond_write;
+}
+
+static ConditionalWrite EvalCompareAndSet(std::shared_ptr<RawEngine> engine,
+                                          const pb::raft::CompareAndSetRequest &request,
+                                          const ApplyWriteBatch *write_batch) {
+  ConditionalWrite cond_write(request.cf_name(), request.kvs_size());
+  if (request.kvs_size() != request.expect_values_size()) {
+    cond_write.status = butil::Status(pb::error::EILLEGAL_PARAMTETERS, "Key is mismatch");
+    return cond_write;
+  }
+
+  auto values = GetApplyValues(engine, request.cf_name(), request.kvs(), write_batch);
+  for (int i = 0; i < request.kvs_size(); ++i) {
+    const auto &kv = request.kvs(i);
+    const auto &expect_value = request.expect_values(i);
+    bool is_match = values[i].has_value() ? values[i].value() == expect_value : expect_value.empty();
+    if (!is_match) {
+      if (request.is_atomic()) {
+        ConditionalWrite failed_write(request.cf_name(), request.kvs_size());
+        if (!values[i].has_value()) {
+          failed_write.status = butil::Status(pb::error::EKEY_NOT_FOUND, "Not found key");
+        }
+        return failed_write;
+      }
+      continue;
+    }
+
+    // value empty means delete
+    if (kv.value().empty()) {
+      cond_write.delete_req.mutable_delete_batch()->add_keys(kv.key());
+    } else {
+      *cond_write.put_req.mutable_put()->add_kvs() = kv;
+    }
+    cond_write.key_states[i] = true;
+  }
+
+  return cond_write;
+}
+
+// Write the puts and deletes of conditional request, into write_batch if not null, otherwise into engine directly.
+static void ApplyConditionalWrite(std::shared_ptr<Context> ctx, store::RegionPtr region,
+                                  std::shared_ptr<RawEngine> engine, ConditionalWrite &cond_write,
+                                  store::RegionMetricsPtr region_metrics, int64_t log_id,
+                                  ApplyWriteBatch *write_batch) {
+  const auto &puts = cond_write.put_req.put();
+  const auto &deletes = cond_write.delete_req.delete_batch();
+  const auto &cf_name = puts.cf_name();
+
+  butil::Status status = cond_write.status;
+  if (status.ok() && (!puts.kvs().empty() || !deletes.keys().empty())) {
+    if (IsIncrementalKeyCount(region_metrics, cf_name)) {
+      AddKeyCountDelta(region_metrics, engine, cf_name, GetKeys(puts.kvs()), true, log_id, write_batch);
+      AddKeyCountDelta(region_metrics, engine, cf_name, Helper::PbRepeatedToVector(deletes.keys()), false, log_id,
+                       write_batch);
+    }
+
+    std::vector<std::string> keys = GetKeys(puts.kvs());
+    keys.insert(keys.end(), deletes.keys().begin(), deletes.keys().end());
+    if (write_batch != nullptr) {
+      for (const auto &kv : puts.kvs()) {
+        write_batch->Put(cf_name, kv);
+      }
+      for (const auto &key : deletes.keys()) {
+        write_batch->Delete(cf_name, key);
+      }
+
+      if (RowCache::IsEnabled()) {
+        write_batch->AddPostCommit([region_id = region->Id(), keys = std::move(keys)]() {
+          RowCache::GetInstance().Invalidate(region_id, keys);
+        });
+      }
+
+      if (ChangeCapture::IsEnabled()) {
+        AddCapturePostCommit(region->Id(), log_id, cond_write.put_req, *write_batch);
+        AddCapturePostCommit(region->Id(), log_id, cond_write.delete_req, *write_batch);
+      }
+    } else {
+      status = engine->Writer()->KvBatchPutAndDelete(cf_name, Helper::PbRepeatedToVector(puts.kvs()),
+                                                     Helper::PbRepeatedToVector(deletes.keys()));
+      if (status.error_code() == pb::error::Errno::EINTERNAL) {
+        DINGO_LOG(FATAL) << fmt::format("[raft.apply][region({})] conditional write failed, error: {}", region->Id(),
+                                        status.error_str());
+      }
+
+      if (RowCache::IsEnabled()) {
+        RowCache::GetInstance().Invalidate(region->Id(), keys);
+      }
+
+      if (status.ok() && ChangeCapture::IsEnabled()) {
+        ChangeCapture::GetInstance().Capture(region->Id(), log_id, cond_write.put_req);
+        ChangeCapture::GetInstance().Capture(region->Id(), log_id, cond_write.delete_req);
+      }
+    }
+
+    // Update region metrics min/max key
+    if (region_metrics != nullptr) {
+      region_metrics->UpdateMaxAndMinKey(puts.kvs());
+      if (!deletes.keys().empty()) {
+        region_metrics->UpdateMaxAndMinKeyPolicy(deletes.keys());
+      }
+    }
+  }
+
+  if (ctx) {
+    ctx->SetStatus(status);
+    if (!status.ok()) {
+      cond_write.key_states.assign(cond_write.key_states.size(), false);
+    }
+    ctx->SetKeyStates(std::move(cond_write.key_states));
+  }
+}
+
+int PutIfAbsentHandler::Handle(std::shared_ptr<Context> ctx, store::RegionPtr region,
+                               std::shared_ptr<RawEngine> engine, const pb::raft::Request &req,
+                               store::RegionMetricsPtr region_metrics, int64_t /*term_id*/, int64_t log_id) {
+  auto cond_write = EvalPutIfAbsent(engine, req.put_if_absent(), nullptr);
+  ApplyConditionalWrite(ctx, region, engine, cond_write, region_metrics, log_id, nullptr);
+
+  return 0;
+}
+
+bool PutIfAbsentHandler::AppendWriteBatch(std::shared_ptr<Context> ctx, store::RegionPtr region,
+                                          std::shared_ptr<RawEngine> engine, const pb::raft::Request &req,
+                                          store::RegionMetricsPtr region_metrics, int64_t /*term_id*/,
+                                          int64_t log_id, ApplyWriteBatch &write_batch) {
+  auto cond_write = EvalPutIfAbsent(engine, req.put_if_absent(), &write_batch);
+  ApplyConditionalWrite(ctx, region, engine, cond_write, region_metrics, log_id, &write_batch);
+
+  return true;
+}
+
+int CompareAndSetHandler::Handle(std::shared_ptr<Context> ctx, store::RegionPtr region,
+                                 std::shared_ptr<RawEngine> engine, const pb::raft::Request &req,
+                                 store::RegionMetricsPtr region_metrics, int64_t /*term_id*/, int64_t log_id) {
+  auto cond_write = EvalCompareAndSet(engine, req.compare_and_set(), nullptr);
+  ApplyConditionalWrite(ctx, region, engine, cond_write, region_metrics, log_id, nullptr);
+
+  return 0;
+}
+
+bool CompareAndSetHandler::AppendWriteBatch(std::shared_ptr<Context> ctx, store::RegionPtr region,
+                                            std::shared_ptr<RawEngine> engine, const pb::raft::Request &req,
+                                            store::RegionMetricsPtr region_metrics, int64_t /*term_id*/,
+                                            int64_t log_id, ApplyWriteBatch &write_batch) {
+  auto cond_write = EvalCompareAndSet(engine, req.compare_and_set(), &write_batch);
+  ApplyConditionalWrite(ctx, region, engine, cond_write, region_metrics, log_id, &write_batch);
+
+  return true;
+}
+
 static void LaunchAyncSaveSnapshot(store::RegionPtr region) {  // NOLINT
   auto store_region_meta = GET_STORE_REGION_META;
   if (region->GetStoreEngineType() == pb::common::STORE_ENG_MONO_STORE) {
@@ -376,7 +884,13 @@ bool HandlePreCreateRegionSplit(const pb::raft::SplitRequest &request, store::Re
                                          fmt::format("Clear follower vector index {}", to_region->Id()));
     }
 
-    if (VectorIndexWrapper::IsPermanentHoldVectorIndex(from_region)) {
+    if (VectorIndexWrapper::IsPermanentHoldVectorIndex(from_region) && FLAGS_enable_vector_index_split_lazy_rebuild) {
+      // Parent keep the wider vector index and search it with range filter, scrub rebuild it later.
+      DINGO_LOG(INFO) << fmt::format(
+          "[split.spliting][job_id({}).region({}->{})] parent lazy rebuild vector index.", request.job_id(),
+          from_region->Id(), to_region->Id());
+      store_region_meta->UpdateTemporaryDisableChange(from_region, false);
+    } else if (VectorIndexWrapper::IsPermanentHoldVectorIndex(from_region)) {
       VectorIndexManager::LaunchRebuildVectorIndex(from_region->VectorIndexWrapper(), request.job_id(), false, false,
                                                    true, "parent split");
     } else {
@@ -568,6 +1082,10 @@ bool HandlePostCreateRegionSplit(const pb::raft::SplitRequest &request, store::R
 
   // Set do snapshot when bootstrap
   store_region_meta->UpdateNeedBootstrapDoSnapshot(child_region, true);
+  // Prebuild child range sst snapshot, so migrate child right after split ship it directly
+  if (FLAGS_raft_snapshot_range_cut_sst && FLAGS_raft_snapshot_policy == Constant::kRaftSnapshotPolicyCheckpoint) {
+    LaunchAyncSaveSnapshot(child_region);
+  }
 
   // update to NORMAL after save snapshot in SplitClosure::Run
   store_region_meta->UpdateState(parent_region, pb::common::StoreRegionState::NORMAL);
@@ -604,7 +1122,13 @@ bool HandlePostCreateRegionSplit(const pb::raft::SplitRequest &request, store::R
                                          fmt::format("Clear follower vector index {}", child_region->Id()));
     }
 
-    if (VectorIndexWrapper::IsPermanentHoldVectorIndex(parent_region)) {
+    if (VectorIndexWrapper::IsPermanentHoldVectorIndex(parent_region) && FLAGS_enable_vector_index_split_lazy_rebuild) {
+      // Parent keep the wider vector index and search it with range filter, scrub rebuild it later.
+      DINGO_LOG(INFO) << fmt::format(
+          "[split.spliting][job_id({}).region({}->{})] parent lazy rebuild vector index.", request.job_id(),
+          parent_region->Id(), child_region->Id());
+      store_region_meta->UpdateTemporaryDisableChange(parent_region, false);
+    } else if (VectorIndexWrapper::IsPermanentHoldVectorIndex(parent_region)) {
       VectorIndexManager::LaunchRebuildVectorIndex(parent_region->VectorIndexWrapper(), request.job_id(), false, false,
                                                    true, "parent split");
     } else {
@@ -654,6 +1178,11 @@ int SplitHandler::Handle(std::shared_ptr<Context>, store::RegionPtr from_region,
                          int64_t log_id) {
   const auto &request = req.split();
 
+  // keys move to the child region, drop the parent cached rows.
+  if (RowCache::IsEnabled()) {
+    RowCache::GetInstance().InvalidateRegion(from_region->Id());
+  }
+
   if (request.split_strategy() == pb::raft::PRE_CREATE_REGION) {
     bool ret = HandlePreCreateRegionSplit(request, from_region, term_id, log_id);
     if (!ret) {
@@ -666,9 +1195,14 @@ int SplitHandler::Handle(std::shared_ptr<Context>, store::RegionPtr from_region,
     }
   }
 
-  auto store_raft_meata = Server::GetInstance().GetStoreMetaManager()->GetStoreRaftMeta();
-  if (store_raft_meata != nullptr) {
-    store_raft_meata->SaveRaftMeta(from_region->Id());
+  if (FlushedAppliedIndexTracker::IsEnabled()) {
+    // data wal disabled, persist after the data flushed.
+    FlushedAppliedIndexTracker::GetInstance().Record(from_region->Id(), term_id, log_id);
+  } else {
+    auto store_raft_meata = Server::GetInstance().GetStoreMetaManager()->GetStoreRaftMeta();
+    if (store_raft_meata != nullptr) {
+      store_raft_meata->SaveRaftMeta(from_region->Id());
+    }
   }
 
   // Update region metrics min/max key policy
@@ -745,6 +1279,10 @@ int PrepareMergeHandler::Handle(std::shared_ptr<Context>, store::RegionPtr sourc
                                 const pb::raft::Request &req, store::RegionMetricsPtr /*region_metrics*/,
                                 int64_t /*term_id*/, int64_t log_id) {
   const auto &request = req.prepare_merge();
+
+  if (RowCache::IsEnabled()) {
+    RowCache::GetInstance().InvalidateRegion(source_region->Id());
+  }
   auto store_region_meta = GET_STORE_REGION_META;
   auto target_region = store_region_meta->GetRegion(request.target_region_id());
 
@@ -841,6 +1379,11 @@ int CommitMergeHandler::Handle(std::shared_ptr<Context>, store::RegionPtr target
                                int64_t /*log_id*/) {
   assert(target_region != nullptr);
   const auto &request = req.commit_merge();
+
+  // keys of source region move in, drop the target cached rows.
+  if (RowCache::IsEnabled()) {
+    RowCache::GetInstance().InvalidateRegion(target_region->Id());
+  }
   auto store_region_meta = GET_STORE_REGION_META;
   assert(store_region_meta != nullptr);
   auto raft_store_engine = Server::GetInstance().GetStorage()->GetRaftStoreEngine();
@@ -1037,8 +1580,19 @@ int SaveRaftSnapshotHandler::Handle(std::shared_ptr<Context>, store::RegionPtr r
 }
 
 int VectorAddHandler::Handle(std::shared_ptr<Context> ctx, store::RegionPtr region, std::shared_ptr<RawEngine> engine,
-                             const pb::raft::Request &req, store::RegionMetricsPtr /*region_metrics*/,
-                             int64_t /*term_id*/, int64_t log_id) {
+                             const pb::raft::Request &req, store::RegionMetricsPtr region_metrics, int64_t term_id,
+                             int64_t log_id) {
+  int ret = HandleStore(ctx, region, engine, req, region_metrics, term_id, log_id);
+  if (ret != 0) {
+    return ret;
+  }
+
+  return HandleIndex(ctx, region, engine, req, region_metrics, term_id, log_id);
+}
+
+int VectorAddHandler::HandleStore(std::shared_ptr<Context> ctx, store::RegionPtr region,
+                                  std::shared_ptr<RawEngine> engine, const pb::raft::Request &req,
+                                  store::RegionMetricsPtr region_metrics, int64_t /*term_id*/, int64_t log_id) {
   auto set_ctx_status = [ctx](butil::Status status) {
     if (ctx) {
       ctx->SetStatus(status);
@@ -1058,6 +1612,10 @@ int VectorAddHandler::Handle(std::shared_ptr<Context> ctx, store::RegionPtr regi
   std::vector<pb::common::KeyValue> kvs_scalar_speed_up;  // for vector scalar data speed up
   std::vector<pb::common::KeyValue> kvs_table;            // for vector table data
 
+  // for scalar bitmap index
+  std::vector<std::pair<int64_t, VectorScalarBitmapIndex::ScalarKeyValuePairs>> scalar_bitmap_items;
+  scalar_bitmap_items.reserve(request.vectors_size());
+
   auto region_start_key = region->Range().start_key();
   auto region_part_id = region->PartitionId();
   for (const auto &vector : request.vectors()) {
@@ -1095,6 +1653,7 @@ int VectorAddHandler::Handle(std::shared_ptr<Context> ctx, store::RegionPtr regi
         kv.set_value(scalar_value.SerializeAsString());
         kvs_scalar_speed_up.push_back(std::move(kv));
       }
+      scalar_bitmap_items.emplace_back(vector.id(), std::move(scalar_key_value_pairs));
     }
 
     // vector table data
@@ -1114,6 +1673,15 @@ int VectorAddHandler::Handle(std::shared_ptr<Context> ctx, store::RegionPtr regi
   }
   kv_puts_with_cf.insert_or_assign(Constant::kVectorTableCF, kvs_table);
 
+  if (IsIncrementalKeyCount(region_metrics, Constant::kStoreDataCF)) {
+    std::vector<std::string> keys;
+    keys.reserve(kvs_default.size());
+    for (const auto &kv : kvs_default) {
+      keys.push_back(kv.key());
+    }
+    AddKeyCountDelta(region_metrics, engine, Constant::kStoreDataCF, keys, true, log_id, nullptr);
+  }
+
   // Put vector data to rocksdb
   if (!kv_puts_with_cf.empty()) {
     auto start_time = Helper::TimestampNs();
@@ -1127,6 +1695,14 @@ int VectorAddHandler::Handle(std::shared_ptr<Context> ctx, store::RegionPtr regi
     }
   }
 
+  // Update scalar bitmap index after speed up cf is written
+  if (status.ok()) {
+    auto scalar_bitmap_index = region->VectorIndexWrapper()->ScalarBitmapIndex();
+    for (const auto &[vector_id, scalar_key_value_pairs] : scalar_bitmap_items) {
+      scalar_bitmap_index->Upsert(vector_id, scalar_key_value_pairs);
+    }
+  }
+
   if (ctx) {
     if (ctx->Response()) {
       bool key_state = status.ok();
@@ -1139,6 +1715,15 @@ int VectorAddHandler::Handle(std::shared_ptr<Context> ctx, store::RegionPtr regi
     ctx->SetStatus(status);
   }
 
+  return 0;
+}
+
+int VectorAddHandler::HandleIndex(std::shared_ptr<Context> ctx, store::RegionPtr region,
+                                  std::shared_ptr<RawEngine> /*engine*/, const pb::raft::Request &req,
+                                  store::RegionMetricsPtr /*region_metrics*/, int64_t /*term_id*/, int64_t log_id) {
+  const auto &request = req.vector_add();
+  TrackerPtr tracker = ctx != nullptr ? ctx->Tracker() : nullptr;
+
   // Handle vector index
   auto vector_index_wrapper = region->VectorIndexWrapper();
   int64_t vector_index_id = vector_index_wrapper->Id();
@@ -1186,7 +1771,7 @@ int VectorAddHandler::Handle(std::shared_ptr<Context> ctx, store::RegionPtr regi
 
 int VectorDeleteHandler::Handle(std::shared_ptr<Context> ctx, store::RegionPtr region,
                                 std::shared_ptr<RawEngine> engine, const pb::raft::Request &req,
-                                store::RegionMetricsPtr /*region_metrics*/, int64_t /*term_id*/, int64_t log_id) {
+                                store::RegionMetricsPtr region_metrics, int64_t /*term_id*/, int64_t log_id) {
   auto set_ctx_status = [ctx](butil::Status status) {
     if (ctx) {
       ctx->SetStatus(status);
@@ -1250,6 +1835,12 @@ int VectorDeleteHandler::Handle(std::shared_ptr<Context> ctx, store::RegionPtr r
     }
   }
 
+  if (!kv_deletes_default.empty() && IsIncrementalKeyCount(region_metrics, Constant::kStoreDataCF)) {
+    // the keys exist, the same id may be deleted twice in one request
+    int64_t delete_count = std::set<std::string>(kv_deletes_default.begin(), kv_deletes_default.end()).size();
+    region_metrics->AddKeyCountDelta(-delete_count, log_id);
+  }
+
   if (!kv_deletes_default.empty()) {
     kv_deletes_with_cf.insert_or_assign(Constant::kStoreDataCF, kv_deletes_default);
     kv_deletes_with_cf.insert_or_assign(Constant::kVectorScalarCF, kv_deletes_default);
@@ -1272,6 +1863,11 @@ int VectorDeleteHandler::Handle(std::shared_ptr<Context> ctx, store::RegionPtr r
     }
   }
 
+  // Update scalar bitmap index after speed up cf is deleted
+  if (status.ok() && !delete_ids.empty()) {
+    region->VectorIndexWrapper()->ScalarBitmapIndex()->Delete(delete_ids);
+  }
+
   if (ctx) {
     if (ctx->Response()) {
       auto *response = dynamic_cast<pb::index::VectorDeleteResponse *>(ctx->Response());
@@ -1333,8 +1929,19 @@ int RebuildVectorIndexHandler::Handle(std::shared_ptr<Context>, store::RegionPtr
 }
 
 int DocumentAddHandler::Handle(std::shared_ptr<Context> ctx, store::RegionPtr region, std::shared_ptr<RawEngine> engine,
-                               const pb::raft::Request &req, store::RegionMetricsPtr /*region_metrics*/,
-                               int64_t /*term_id*/, int64_t log_id) {
+                               const pb::raft::Request &req, store::RegionMetricsPtr region_metrics, int64_t term_id,
+                               int64_t log_id) {
+  int ret = HandleStore(ctx, region, engine, req, region_metrics, term_id, log_id);
+  if (ret != 0) {
+    return ret;
+  }
+
+  return HandleIndex(ctx, region, engine, req, region_metrics, term_id, log_id);
+}
+
+int DocumentAddHandler::HandleStore(std::shared_ptr<Context> ctx, store::RegionPtr region,
+                                    std::shared_ptr<RawEngine> engine, const pb::raft::Request &req,
+                                    store::RegionMetricsPtr region_metrics, int64_t /*term_id*/, int64_t log_id) {
   auto set_ctx_status = [ctx](butil::Status status) {
     if (ctx) {
       ctx->SetStatus(status);
@@ -1371,6 +1978,15 @@ int DocumentAddHandler::Handle(std::shared_ptr<Context> ctx, store::RegionPtr re
   }
   kv_puts_with_cf.insert_or_assign(Constant::kStoreDataCF, kvs_default);
 
+  if (IsIncrementalKeyCount(region_metrics, Constant::kStoreDataCF)) {
+    std::vector<std::string> keys;
+    keys.reserve(kvs_default.size());
+    for (const auto &kv : kvs_default) {
+      keys.push_back(kv.key());
+    }
+    AddKeyCountDelta(region_metrics, engine, Constant::kStoreDataCF, keys, true, log_id, nullptr);
+  }
+
   // Put vector data to rocksdb
   if (!kv_puts_with_cf.empty()) {
     auto start_time = Helper::TimestampNs();
@@ -1396,6 +2012,15 @@ int DocumentAddHandler::Handle(std::shared_ptr<Context> ctx, store::RegionPtr re
     ctx->SetStatus(status);
   }
 
+  return 0;
+}
+
+int DocumentAddHandler::HandleIndex(std::shared_ptr<Context> ctx, store::RegionPtr region,
+                                    std::shared_ptr<RawEngine> /*engine*/, const pb::raft::Request &req,
+                                    store::RegionMetricsPtr /*region_metrics*/, int64_t /*term_id*/, int64_t log_id) {
+  const auto &request = req.document_add();
+  TrackerPtr tracker = ctx != nullptr ? ctx->Tracker() : nullptr;
+
   // Handle document index
   auto document_index_wrapper = region->DocumentIndexWrapper();
   int64_t document_index_id = document_index_wrapper->Id();
@@ -1444,7 +2069,7 @@ int DocumentAddHandler::Handle(std::shared_ptr<Context> ctx, store::RegionPtr re
 
 int DocumentDeleteHandler::Handle(std::shared_ptr<Context> ctx, store::RegionPtr region,
                                   std::shared_ptr<RawEngine> engine, const pb::raft::Request &req,
-                                  store::RegionMetricsPtr /*region_metrics*/, int64_t /*term_id*/, int64_t log_id) {
+                                  store::RegionMetricsPtr region_metrics, int64_t /*term_id*/, int64_t log_id) {
   auto set_ctx_status = [ctx](butil::Status status) {
     if (ctx) {
       ctx->SetStatus(status);
@@ -1508,6 +2133,12 @@ int DocumentDeleteHandler::Handle(std::shared_ptr<Context> ctx, store::RegionPtr
     }
   }
 
+  if (!kv_deletes_default.empty() && IsIncrementalKeyCount(region_metrics, Constant::kStoreDataCF)) {
+    // the keys exist, the same id may be deleted twice in one request
+    int64_t delete_count = std::set<std::string>(kv_deletes_default.begin(), kv_deletes_default.end()).size();
+    region_metrics->AddKeyCountDelta(-delete_count, log_id);
+  }
+
   if (!kv_deletes_default.empty()) {
     kv_deletes_with_cf.insert_or_assign(Constant::kStoreDataCF, kv_deletes_default);
   }
@@ -1572,6 +2203,8 @@ std::shared_ptr<HandlerCollection> RaftApplyHandlerFactory::Build() {
   handler_collection->Register(std::make_shared<PutHandler>());
   handler_collection->Register(std::make_shared<DeleteRangeHandler>());
   handler_collection->Register(std::make_shared<DeleteBatchHandler>());
+  handler_collection->Register(std::make_shared<PutIfAbsentHandler>());
+  handler_collection->Register(std::make_shared<CompareAndSetHandler>());
   handler_collection->Register(std::make_shared<SplitHandler>());
   handler_collection->Register(std::make_shared<PrepareMergeHandler>());
   handler_collection->Register(std::make_shared<CommitMergeHandler>());
@@ -25,6 +25,10 @@
 
 namespace dingodb {
 
+// Capture the change events of the coalesced write after the batch is committed.
+void AddCapturePostCommit(int64_t region_id, int64_t log_id, const pb::raft::Request &req,
+                          ApplyWriteBatch &write_batch);
+
 // PutRequest
 class PutHandler : public BaseHandler {
  public:
@@ -32,6 +36,9 @@ class PutHandler : public BaseHandler {
   int Handle(std::shared_ptr<Context> ctx, store::RegionPtr region, std::shared_ptr<RawEngine> engine,
              const pb::raft::Request &req, store::RegionMetricsPtr region_metrics, int64_t term_id,
              int64_t log_id) override;
+  bool AppendWriteBatch(std::shared_ptr<Context> ctx, store::RegionPtr region, std::shared_ptr<RawEngine> engine,
+                        const pb::raft::Request &req, store::RegionMetricsPtr region_metrics, int64_t term_id,
+                        int64_t log_id, ApplyWriteBatch &write_batch) override;
 };
 
 // DeleteRangeRequest
@@ -50,6 +57,33 @@ class DeleteBatchHandler : public BaseHandler {
   int Handle(std::shared_ptr<Context> ctx, store::RegionPtr region, std::shared_ptr<RawEngine> engine,
              const pb::raft::Request &req, store::RegionMetricsPtr region_metricss, int64_t term_id,
              int64_t log_id) override;
+  bool AppendWriteBatch(std::shared_ptr<Context> ctx, store::RegionPtr region, std::shared_ptr<RawEngine> engine,
+                        const pb::raft::Request &req, store::RegionMetricsPtr region_metrics, int64_t term_id,
+                        int64_t log_id, ApplyWriteBatch &write_batch) override;
+};
+
+// PutIfAbsentRequest
+class PutIfAbsentHandler : public BaseHandler {
+ public:
+  HandlerType GetType() override { return HandlerType::kPutIfabsent; }
+  int Handle(std::shared_ptr<Context> ctx, store::RegionPtr region, std::shared_ptr<RawEngine> engine,
+             const pb::raft::Request &req, store::RegionMetricsPtr region_metrics, int64_t term_id,
+             int64_t log_id) override;
+  bool AppendWriteBatch(std::shared_ptr<Context> ctx, store::RegionPtr region, std::shared_ptr<RawEngine> engine,
+                        const pb::raft::Request &req, store::RegionMetricsPtr region_metrics, int64_t term_id,
+                        int64_t log_id, ApplyWriteBatch &write_batch) override;
+};
+
+// CompareAndSetRequest
+class CompareAndSetHandler : public BaseHandler {
+ public:
+  HandlerType GetType() override { return HandlerType::kCompareAndSet; }
+  int Handle(std::shared_ptr<Context> ctx, store::RegionPtr region, std::shared_ptr<RawEngine> engine,
+             const pb::raft::Request &req, store::RegionMetricsPtr region_metrics, int64_t term_id,
+             int64_t log_id) override;
+  bool AppendWriteBatch(std::shared_ptr<Context> ctx, store::RegionPtr region, std::shared_ptr<RawEngine> engine,
+                        const pb::raft::Request &req, store::RegionMetricsPtr region_metrics, int64_t term_id,
+                        int64_t log_id, ApplyWriteBatch &write_batch) override;
 };
 
 // SplitHandler
@@ -117,6 +151,12 @@ class VectorAddHandler : public BaseHandler {
   int Handle(std::shared_ptr<Context> ctx, store::RegionPtr region, std::shared_ptr<RawEngine> engine,
              const pb::raft::Request &req, store::RegionMetricsPtr region_metrics, int64_t term_id,
              int64_t log_id) override;
+  int HandleStore(std::shared_ptr<Context> ctx, store::RegionPtr region, std::shared_ptr<RawEngine> engine,
+                  const pb::raft::Request &req, store::RegionMetricsPtr region_metrics, int64_t term_id,
+                  int64_t log_id) override;
+  int HandleIndex(std::shared_ptr<Context> ctx, store::RegionPtr region, std::shared_ptr<RawEngine> engine,
+                  const pb::raft::Request &req, store::RegionMetricsPtr region_metrics, int64_t term_id,
+                  int64_t log_id) override;
 };
 
 // VectorDeleteRequest
@@ -144,6 +184,12 @@ class DocumentAddHandler : public BaseHandler {
   int Handle(std::shared_ptr<Context> ctx, store::RegionPtr region, std::shared_ptr<RawEngine> engine,
              const pb::raft::Request &req, store::RegionMetricsPtr region_metrics, int64_t term_id,
              int64_t log_id) override;
+  int HandleStore(std::shared_ptr<Context> ctx, store::RegionPtr region, std::shared_ptr<RawEngine> engine,
+                  const pb::raft::Request &req, store::RegionMetricsPtr region_metrics, int64_t term_id,
+                  int64_t log_id) override;
+  int HandleIndex(std::shared_ptr<Context> ctx, store::RegionPtr region, std::shared_ptr<RawEngine> engine,
+                  const pb::raft::Request &req, store::RegionMetricsPtr region_metrics, int64_t term_id,
+                  int64_t log_id) override;
 };
 
 // DocumentDeleteRequest
@@ -161,6 +207,9 @@ class TxnHandler : public BaseHandler {
   int Handle(std::shared_ptr<Context> ctx, store::RegionPtr region, std::shared_ptr<RawEngine> engine,
              const pb::raft::Request &req, store::RegionMetricsPtr region_metrics, int64_t term_id,
              int64_t log_id) override;
+  bool AppendWriteBatch(std::shared_ptr<Context> ctx, store::RegionPtr region, std::shared_ptr<RawEngine> engine,
+                        const pb::raft::Request &req, store::RegionMetricsPtr region_metrics, int64_t term_id,
+                        int64_t log_id, ApplyWriteBatch &write_batch) override;
 
   static void HandleMultiCfPutAndDeleteRequest(std::shared_ptr<Context> ctx, store::RegionPtr region,
                                                std::shared_ptr<RawEngine> engine,
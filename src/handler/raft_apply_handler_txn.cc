@@ -18,14 +18,20 @@
 #include <map>
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "butil/status.h"
 #include "common/constant.h"
 #include "common/helper.h"
 #include "common/logging.h"
+#include "engine/change_capture.h"
+#include "engine/pessimistic_lock_table.h"
+#include "engine/txn_lock_index.h"
+#include "engine/txn_lock_wait_manager.h"
 #include "fmt/core.h"
 #include "gflags/gflags.h"
+#include "handler/apply_write_batch.h"
 #include "handler/raft_apply_handler.h"
 #include "meta/store_meta_manager.h"
 #include "proto/common.pb.h"
@@ -36,6 +42,89 @@ namespace dingodb {
 
 DECLARE_bool(dingo_log_switch_txn_detail);
 
+// The lock cf write wins, erase the stale in memory pessimistic lock.
+static void EraseMemoryPessimisticLock(const pb::raft::MultiCfPutAndDeleteRequest &request) {
+  if (!PessimisticLockTable::IsEnabled()) {
+    return;
+  }
+
+  auto erase_func = [](const std::string &lock_key) {
+    std::string key;
+    int64_t ts = 0;
+    if (Helper::DecodeTxnKey(lock_key, key, ts).ok()) {
+      PessimisticLockTable::GetInstance().Erase(key);
+    }
+  };
+
+  for (const auto &puts : request.puts_with_cf()) {
+    if (puts.cf_name() != Constant::kTxnLockCF) {
+      continue;
+    }
+    for (const auto &kv : puts.kvs()) {
+      erase_func(kv.key());
+    }
+  }
+
+  for (const auto &dels : request.deletes_with_cf()) {
+    if (dels.cf_name() != Constant::kTxnLockCF) {
+      continue;
+    }
+    for (const auto &key : dels.keys()) {
+      erase_func(key);
+    }
+  }
+}
+
+// The lock index is a superset of the lock cf, add the locked key before write.
+static void AddLockIndex(const pb::raft::MultiCfPutAndDeleteRequest &request) {
+  for (const auto &puts : request.puts_with_cf()) {
+    if (puts.cf_name() != Constant::kTxnLockCF) {
+      continue;
+    }
+    for (const auto &kv : puts.kvs()) {
+      std::string key;
+      int64_t ts = 0;
+      if (!Helper::DecodeTxnKey(kv.key(), key, ts).ok()) {
+        continue;
+      }
+      // a lock can't be parsed is only indexed by key
+      pb::store::LockInfo lock_info;
+      if (!lock_info.ParseFromString(kv.value())) {
+        lock_info.set_lock_ts(0);
+      }
+      TxnLockIndex::GetInstance().Add(key, lock_info.lock_ts());
+    }
+  }
+}
+
+static std::vector<std::string> GetLockDeleteKeys(const pb::raft::MultiCfPutAndDeleteRequest &request) {
+  std::vector<std::string> lock_keys;
+  for (const auto &dels : request.deletes_with_cf()) {
+    if (dels.cf_name() == Constant::kTxnLockCF) {
+      lock_keys.insert(lock_keys.end(), dels.keys().begin(), dels.keys().end());
+    }
+  }
+  return lock_keys;
+}
+
+// The lock of key is released, wake up the pessimistic lock request waiting for it.
+static void WakeUpLockWaiter(const std::string &lock_key) {
+  std::string key;
+  int64_t ts = 0;
+  if (Helper::DecodeTxnKey(lock_key, key, ts).ok()) {
+    TxnLockWaitManager::GetInstance().WakeUp(key);
+  }
+}
+
+// Erase the unlocked key after write.
+static void EraseLockIndex(const std::string &lock_key) {
+  std::string key;
+  int64_t ts = 0;
+  if (Helper::DecodeTxnKey(lock_key, key, ts).ok()) {
+    TxnLockIndex::GetInstance().Erase(key);
+  }
+}
+
 void TxnHandler::HandleMultiCfPutAndDeleteRequest(std::shared_ptr<Context> ctx, store::RegionPtr region,
                                                   std::shared_ptr<RawEngine> engine,
                                                   const pb::raft::MultiCfPutAndDeleteRequest &request,
@@ -90,6 +179,10 @@ void TxnHandler::HandleMultiCfPutAndDeleteRequest(std::shared_ptr<Context> ctx,
     kv_deletes_with_cf.insert_or_assign(dels.cf_name(), kv_deletes);
   }
 
+  if (TxnLockIndex::IsEnabled()) {
+    AddLockIndex(request);
+  }
+
   auto writer = engine->Writer();
   auto status = writer->KvBatchPutAndDelete(kv_puts_with_cf, kv_deletes_with_cf);
   if (!status.ok()) {
@@ -98,6 +191,20 @@ void TxnHandler::HandleMultiCfPutAndDeleteRequest(std::shared_ptr<Context> ctx,
                      << ", write failed, request: " << request.ShortDebugString();
   }
 
+  if (TxnLockIndex::IsEnabled()) {
+    for (const auto &lock_key : GetLockDeleteKeys(request)) {
+      EraseLockIndex(lock_key);
+    }
+  }
+
+  if (TxnLockWaitManager::IsEnabled()) {
+    for (const auto &lock_key : GetLockDeleteKeys(request)) {
+      WakeUpLockWaiter(lock_key);
+    }
+  }
+
+  EraseMemoryPessimisticLock(request);
+
   // check if need to commit to vector index
   {
     const auto &vector_add = request.vector_add();
@@ -279,6 +386,110 @@ void TxnHandler::HandleTxnDeleteRangeRequest(std::shared_ptr<Context> ctx, store
                                     term_id, log_id)
                      << ", write failed, request: " << request.ShortDebugString() << ", status: " << status.error_str();
   }
+
+  if (PessimisticLockTable::IsEnabled()) {
+    PessimisticLockTable::GetInstance().EraseRange(request.start_key(), request.end_key());
+  }
+
+  if (TxnLockIndex::IsEnabled()) {
+    TxnLockIndex::GetInstance().EraseRange(request.start_key(), request.end_key());
+  }
+
+  if (TxnLockWaitManager::IsEnabled()) {
+    TxnLockWaitManager::GetInstance().WakeUpRange(request.start_key(), request.end_key());
+  }
+}
+
+bool TxnHandler::AppendWriteBatch(std::shared_ptr<Context> ctx, store::RegionPtr region,
+                                  std::shared_ptr<RawEngine> /*engine*/, const pb::raft::Request &req,
+                                  store::RegionMetricsPtr /*region_metrics*/, int64_t term_id, int64_t log_id,
+                                  ApplyWriteBatch &write_batch) {
+  const auto &txn_raft_req = req.txn_raft_req();
+  if (!txn_raft_req.has_multi_cf_put_and_delete()) {
+    return false;
+  }
+
+  // commit to vector/document index must follow the write in Handle
+  const auto &request = txn_raft_req.multi_cf_put_and_delete();
+  if (request.vector_add().vectors_size() > 0 || request.vector_del().ids_size() > 0 ||
+      request.document_add().documents_size() > 0 || request.document_del().ids_size() > 0) {
+    return false;
+  }
+
+  // empty keys fail in Handle
+  for (const auto &puts : request.puts_with_cf()) {
+    if (puts.kvs().empty()) {
+      return false;
+    }
+    for (const auto &kv : puts.kvs()) {
+      if (kv.key().empty()) {
+        return false;
+      }
+    }
+  }
+  for (const auto &dels : request.deletes_with_cf()) {
+    if (dels.keys().empty()) {
+      return false;
+    }
+    for (const auto &key : dels.keys()) {
+      if (key.empty()) {
+        return false;
+      }
+    }
+  }
+
+  DINGO_LOG(DEBUG) << fmt::format("[txn][region({})] AppendWriteBatch, term: {} apply_log_id: {}", region->Id(),
+                                  term_id, log_id)
+                   << ", request: " << request.ShortDebugString();
+
+  if (TxnLockIndex::IsEnabled()) {
+    AddLockIndex(request);
+  }
+
+  // same as KvBatchPutAndDelete, deletes after puts
+  for (const auto &puts : request.puts_with_cf()) {
+    for (const auto &kv : puts.kvs()) {
+      write_batch.Put(puts.cf_name(), kv);
+    }
+  }
+  for (const auto &dels : request.deletes_with_cf()) {
+    for (const auto &key : dels.keys()) {
+      write_batch.Delete(dels.cf_name(), key);
+    }
+  }
+
+  EraseMemoryPessimisticLock(request);
+
+  if (ChangeCapture::IsEnabled()) {
+    AddCapturePostCommit(region->Id(), log_id, req, write_batch);
+  }
+
+  if (TxnLockIndex::IsEnabled() || TxnLockWaitManager::IsEnabled()) {
+    auto lock_keys = GetLockDeleteKeys(request);
+    if (!lock_keys.empty()) {
+      // the lock may be put again by a later entry of the batch, erase and wake up by the committed state
+      write_batch.AddPostCommit([&write_batch, lock_keys = std::move(lock_keys)]() {
+        for (const auto &lock_key : lock_keys) {
+          bool is_put = false;
+          if (write_batch.Lookup(Constant::kTxnLockCF, lock_key, is_put) && is_put) {
+            continue;
+          }
+          if (TxnLockIndex::IsEnabled()) {
+            EraseLockIndex(lock_key);
+          }
+          if (TxnLockWaitManager::IsEnabled()) {
+            WakeUpLockWaiter(lock_key);
+          }
+        }
+      });
+    }
+  }
+
+  if (ctx) {
+    ctx->SetStatus(butil::Status());
+  }
+
+  return true;
 }
 
 int TxnHandler::Handle(std::shared_ptr<Context> ctx, store::RegionPtr region, std::shared_ptr<RawEngine> engine,
@@ -299,6 +510,10 @@ int TxnHandler::Handle(std::shared_ptr<Context> ctx, store::RegionPtr region, st
                      << ", txn_raft_req: " << txn_raft_req.DebugString();
   }
 
+  if (ChangeCapture::IsEnabled()) {
+    ChangeCapture::GetInstance().Capture(region->Id(), log_id, req);
+  }
+
   return 0;
 }
 
@@ -26,7 +26,9 @@
 #include "common/constant.h"
 #include "common/failpoint.h"
 #include "common/helper.h"
+#include "common/synchronization.h"
 #include "config/config_manager.h"
+#include "engine/txn_lock_index.h"
 #include "fmt/core.h"
 #include "google/protobuf/message.h"
 #include "proto/common.pb.h"
@@ -38,6 +40,8 @@
 namespace dingodb {
 
 DEFINE_string(raft_snapshot_policy, "dingo", "raft snapshot policy, checkpoint or scan");
+DEFINE_bool(raft_snapshot_range_cut_sst, false,
+            "checkpoint policy cut the region range sst files when save snapshot, follower ingest them directly");
 
 struct SaveRaftSnapshotArg {
   store::RegionPtr region;
@@ -94,6 +98,52 @@ butil::Status RaftSnapshot::GenSnapshotFileByCheckpoint(const std::string& check
   return butil::Status();
 }
 
+// Do Checkpoint and cut region range sst file, one sst file per column family
+butil::Status RaftSnapshot::GenSnapshotFileByRangeSst(const std::string& checkpoint_path, store::RegionPtr region,
+                                                      std::vector<pb::store_internal::SstFileInfo>& sst_files) {
+  auto checkpoint = engine_->NewCheckpoint();
+
+  auto cf_names = Helper::GetColumnFamilyNames(region->Range().start_key());
+  std::vector<pb::store_internal::SstFileInfo> tmp_sst_files;
+  auto status = checkpoint->Create(checkpoint_path, cf_names, tmp_sst_files);
+  if (!status.ok()) {
+    DINGO_LOG(ERROR) << fmt::format("[raft.snapshot][region({})] Create checkpoint failed, path: {} error: {} {}",
+                                    region->Id(), checkpoint_path, status.error_code(), status.error_str());
+    return status;
+  }
+
+  std::vector<std::string> range_sst_paths;
+  range_sst_paths.reserve(cf_names.size());
+  for (const auto& cf_name : cf_names) {
+    range_sst_paths.push_back(fmt::format("{}/merge_{}.sst", checkpoint_path, cf_name));
+  }
+
+  status = engine_->MergeCheckpointFiles(checkpoint_path, region->Range(), cf_names, range_sst_paths);
+  if (!status.ok()) {
+    DINGO_LOG(ERROR) << fmt::format("[raft.snapshot][region({})] cut range sst file failed, path: {} error: {} {}",
+                                    region->Id(), checkpoint_path, status.error_code(), status.error_str());
+    return status;
+  }
+
+  for (int i = 0; i < cf_names.size(); ++i) {
+    // empty path means the column family has no data in range
+    if (range_sst_paths[i].empty()) {
+      continue;
+    }
+
+    pb::store_internal::SstFileInfo sst_file;
+    sst_file.set_name(cf_names[i] + Constant::kRaftSnapshotRangeSstFileNameSuffix);
+    sst_file.set_path(range_sst_paths[i]);
+    sst_file.set_start_key(region->Range().start_key());
+    sst_file.set_end_key(region->Range().end_key());
+    DINGO_LOG(INFO) << fmt::format("[raft.snapshot][region({})] range sst file info: {}", region->Id(),
+                                   sst_file.ShortDebugString());
+    sst_files.push_back(sst_file);
+  }
+
+  return butil::Status();
+}
+
 // Add region meta to snapshot
 bool AddRegionMetaFile(braft::SnapshotWriter* writer, store::RegionPtr region, int64_t term, int64_t log_index) {
   std::string filepath = writer->get_path() + "/" + Constant::kRaftSnapshotRegionMetaFileName;
@@ -257,6 +307,17 @@ butil::Status RaftSnapshot::HandleRaftSnapshotRegionMeta(braft::SnapshotReader*
   return butil::Status();
 }
 
+// Whether the snapshot is made up of range sst files
+static bool IsRangeSstSnapshot(braft::SnapshotReader* reader, const std::vector<std::string>& cf_names) {
+  for (const auto& cf_name : cf_names) {
+    if (reader->get_file_meta(cf_name + Constant::kRaftSnapshotRangeSstFileNameSuffix, nullptr) == 0) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
 // Load snapshot by ingest sst files
 bool RaftSnapshot::LoadSnapshot(braft::SnapshotReader* reader, store::RegionPtr region) {
   DINGO_LOG(INFO) << fmt::format("[raft.snapshot][region({})] load snapshot...", region->Id());
@@ -290,6 +351,7 @@ bool RaftSnapshot::LoadSnapshot(braft::SnapshotReader* reader, store::RegionPtr
   std::string current_path = reader->get_path() + "/" + "CURRENT";
 
   auto cf_names = Helper::GetColumnFamilyNames(region->Range().start_key());
+  bool is_range_sst = false;
 
   // The snapshot is generated by use checkpoint.
   if (Helper::IsExistPath(current_path)) {
@@ -324,19 +386,18 @@ bool RaftSnapshot::LoadSnapshot(braft::SnapshotReader* reader, store::RegionPtr
     for (const auto& merge_file_path : merge_sst_file_paths) {
       sst_files.push_back(merge_file_path);
     }
+  } else if (IsRangeSstSnapshot(reader, cf_names)) {
+    // The snapshot is generated by use checkpoint and cut range sst, ingest directly.
+    for (const auto& cf_name : cf_names) {
+      std::string sst_path = reader->get_path() + "/" + cf_name + Constant::kRaftSnapshotRangeSstFileNameSuffix;
+      sst_files.push_back(Helper::IsExistPath(sst_path) ? sst_path : "");
+    }
+    is_range_sst = true;
   } else {  // The snapshot is generated by use scan.
     DINGO_LOG(ERROR) << fmt::format(
         "[raft.snapshot][region({})] snapshot not include CURRENT file, snapshot by scan is not support now",
         region->Id());
     return false;
-
-    for (auto& file : files) {
-      if (file == Constant::kRaftSnapshotRegionMetaFileName) {
-        continue;
-      }
-      std::string filepath = reader->get_path() + "/" + file;
-      sst_files.push_back(filepath);
-    }
   }
 
   FAIL_POINT("load_snapshot_suspend");
@@ -366,8 +427,8 @@ bool RaftSnapshot::LoadSnapshot(braft::SnapshotReader* reader, store::RegionPtr
   }
 
   for (const auto& sst_file : sst_files) {
-    // Clean merge temp file
-    if (sst_file.empty()) {
+    // Clean merge temp file, the range sst file belong to snapshot, keep it for install snapshot to other peer.
+    if (sst_file.empty() || is_range_sst) {
       continue;
     }
     Helper::RemoveFileOrDirectory(sst_file);
@@ -479,8 +540,12 @@ void SaveSnapshotByCheckpoint(store::RegionPtr region, std::shared_ptr<RawEngine
   brpc::ClosureGuard done_guard(done);
 
   auto raft_snapshot = std::make_shared<RaftSnapshot>(engine, false);
-  auto gen_snapshot_file_func = std::bind(&RaftSnapshot::GenSnapshotFileByCheckpoint, raft_snapshot,  // NOLINT
-                                          std::placeholders::_1, std::placeholders::_2, std::placeholders::_3);
+  auto gen_snapshot_file_func =
+      FLAGS_raft_snapshot_range_cut_sst
+          ? std::bind(&RaftSnapshot::GenSnapshotFileByRangeSst, raft_snapshot,  // NOLINT
+                      std::placeholders::_1, std::placeholders::_2, std::placeholders::_3)
+          : std::bind(&RaftSnapshot::GenSnapshotFileByCheckpoint, raft_snapshot,  // NOLINT
+                      std::placeholders::_1, std::placeholders::_2, std::placeholders::_3);
   if (!raft_snapshot->SaveSnapshot(writer, region, gen_snapshot_file_func, region->Epoch().version(), term,
                                    log_index)) {
     LOG(ERROR) << fmt::format("[raft.snapshot][region({})] save snapshot failed.", region->Id());
@@ -511,6 +576,8 @@ int RaftSaveSnapshotHandler::Handle(store::RegionPtr region, std::shared_ptr<Raw
   std::string policy = FLAGS_raft_snapshot_policy;
   if (BAIDU_LIKELY(policy == Constant::kRaftSnapshotPolicyDingo)) {
     SaveSnapshotByDingo(region, engine, term, log_index, writer, done);
+  } else if (policy == Constant::kRaftSnapshotPolicyCheckpoint) {
+    SaveSnapshotByCheckpoint(region, engine, term, log_index, writer, done);
   } else {
     DINGO_LOG(FATAL) << fmt::format("[raft.snapshot][region({})] unknown snapshot policy: {}", region->Id(), policy);
   }
@@ -520,6 +587,14 @@ int RaftSaveSnapshotHandler::Handle(store::RegionPtr region, std::shared_ptr<Raw
 
 int RaftLoadSnapshotHandler::Handle(store::RegionPtr region, std::shared_ptr<RawEngine> engine,
                                     braft::SnapshotReader* reader) {
+  // lock index is not trusted until the lock cf of region is reloaded
+  bool rebuild_lock_index = TxnLockIndex::IsEnabled() && region->IsTxn();
+  if (rebuild_lock_index) {
+    TxnLockIndex::GetInstance().BeginBuild();
+    TxnLockIndex::GetInstance().EraseRange(region->Range().start_key(), region->Range().end_key());
+  }
+  DEFER(if (rebuild_lock_index) { TxnLockIndex::GetInstance().EndBuild(); });
+
   auto raft_snapshot = std::make_unique<RaftSnapshot>(engine);
   if (FLAGS_raft_snapshot_policy == "dingo") {
     if (!raft_snapshot->LoadSnapshotDingo(reader, region)) {
@@ -535,6 +610,10 @@ int RaftLoadSnapshotHandler::Handle(store::RegionPtr region, std::shared_ptr<Raw
 
   DINGO_LOG(INFO) << fmt::format("[raft.snapshot][region({})] load snapshot to raw_engine success.", region->Id());
 
+  if (rebuild_lock_index) {
+    TxnLockIndex::GetInstance().Build(engine, region->Range());
+  }
+
   if (region->Definition().index_parameter().has_vector_index_parameter()) {
     DINGO_LOG(INFO) << fmt::format("[raft.snapshot][region({})] load snapshot to vector_engine.", region->Id());
 
@@ -48,6 +48,10 @@ class RaftSnapshot {
   butil::Status GenSnapshotFileByCheckpoint(const std::string& checkpoint_path, store::RegionPtr region,
                                             std::vector<pb::store_internal::SstFileInfo>& sst_files);
 
+  // Do Checkpoint and cut region range sst file, follower ingest it without merge
+  butil::Status GenSnapshotFileByRangeSst(const std::string& checkpoint_path, store::RegionPtr region,
+                                          std::vector<pb::store_internal::SstFileInfo>& sst_files);
+
   bool SaveSnapshot(braft::SnapshotWriter* writer, store::RegionPtr region, GenSnapshotFileFunc func,
                     int64_t region_version, int64_t term, int64_t log_index);
 
@@ -15,6 +15,8 @@
 #include "handler/raft_vote_handler.h"
 
 #include "common/role.h"
+#include "engine/pessimistic_lock_table.h"
+#include "engine/txn_lock_wait_manager.h"
 #include "fmt/core.h"
 #include "meta/store_meta_manager.h"
 #include "proto/common.pb.h"
@@ -219,6 +221,37 @@ int DocumentIndexFollowerStopHandler::Handle(store::RegionPtr /*region*/, const
   return 0;
 }
 
+// txn
+// The in memory pessimistic locks only live on the leader of current term, drop them when leader changed.
+static void DropMemoryPessimisticLock(store::RegionPtr region, const std::string &reason) {
+  if (region == nullptr || !PessimisticLockTable::IsEnabled()) {
+    return;
+  }
+
+  auto range = region->Range();
+  PessimisticLockTable::GetInstance().EraseRange(range.start_key(), range.end_key());
+  if (TxnLockWaitManager::IsEnabled()) {
+    TxnLockWaitManager::GetInstance().WakeUpRange(range.start_key(), range.end_key());
+  }
+
+  DINGO_LOG(INFO) << fmt::format("[raft.handle][region({})] drop in memory pessimistic lock, reason: {}", region->Id(),
+                                 reason);
+}
+
+int TxnPessimisticLockLeaderStartHandler::Handle(store::RegionPtr region, int64_t) {
+  DropMemoryPessimisticLock(region, "being leader");
+  return 0;
+}
+
+int TxnPessimisticLockLeaderStopHandler::Handle(store::RegionPtr region, butil::Status) {
+  DropMemoryPessimisticLock(region, "stop leader");
+  // the waiters retry and get not leader
+  if (region != nullptr && TxnLockWaitManager::IsEnabled()) {
+    TxnLockWaitManager::GetInstance().WakeUpRegion(region->Id());
+  }
+  return 0;
+}
+
 std::shared_ptr<HandlerCollection> LeaderStartHandlerFactory::Build() {
   // vector
   auto handler_collection = std::make_shared<HandlerCollection>();
@@ -228,6 +261,9 @@ std::shared_ptr<HandlerCollection> LeaderStartHandlerFactory::Build() {
   if (GetRole() == pb::common::DOCUMENT) {
     handler_collection->Register(std::make_shared<DocumentIndexLeaderStartHandler>());
   }
+  if (GetRole() == pb::common::STORE) {
+    handler_collection->Register(std::make_shared<TxnPessimisticLockLeaderStartHandler>());
+  }
 
   return handler_collection;
 }
@@ -240,6 +276,9 @@ std::shared_ptr<HandlerCollection> LeaderStopHandlerFactory::Build() {
   if (GetRole() == pb::common::DOCUMENT) {
     handler_collection->Register(std::make_shared<DocumentIndexLeaderStopHandler>());
   }
+  if (GetRole() == pb::common::STORE) {
+    handler_collection->Register(std::make_shared<TxnPessimisticLockLeaderStopHandler>());
+  }
 
   return handler_collection;
 }
@@ -77,6 +77,21 @@ class DocumentIndexFollowerStopHandler : public BaseHandler {
   int Handle(store::RegionPtr region, const braft::LeaderChangeContext &ctx) override;
 };
 
+// txn
+// TxnPessimisticLockLeaderStart
+class TxnPessimisticLockLeaderStartHandler : public BaseHandler {
+ public:
+  HandlerType GetType() override { return HandlerType::kTxnPessimisticLockLeaderStart; }
+  int Handle(store::RegionPtr region, int64_t term_id) override;
+};
+
+// TxnPessimisticLockLeaderStop
+class TxnPessimisticLockLeaderStopHandler : public BaseHandler {
+ public:
+  HandlerType GetType() override { return HandlerType::kTxnPessimisticLockLeaderStop; }
+  int Handle(store::RegionPtr region, butil::Status status) override;
+};
+
 // Leader start handler collection
 class LeaderStartHandlerFactory : public HandlerFactory {
  public:
@@ -0,0 +1,610 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "log/index_journal.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "butil/crc32c.h"
+#include "common/helper.h"
+#include "common/logging.h"
+#include "fmt/core.h"
+#include "gflags/gflags.h"
+#include "glog/logging.h"
+#include "proto/error.pb.h"
+#include "raft/raft_cmd_codec.h"
+
+namespace dingodb {
+
+DEFINE_bool(enable_index_journal, false,
+            "record vector/document index requests in journal at apply, raft log is not pinned by lagging index");
+
+static const uint64_t kJournalMagic = 0x324A4E4C58444E49;  // INDXLNJ2
+static const int64_t kHeaderSize = sizeof(uint64_t) + sizeof(int64_t) + sizeof(int64_t);
+static const int64_t kRecordHeaderSize = sizeof(int64_t) + sizeof(uint32_t) + sizeof(uint32_t);
+static const uint32_t kMaxRecordSize = 512 * 1024 * 1024;
+static const std::string kJournalSuffix = ".journal";
+
+static bool WriteAll(int fd, const char* data, size_t size, int64_t offset) {
+  while (size > 0) {
+    ssize_t n = ::pwrite(fd, data, size, offset);
+    if (n < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return false;
+    }
+    data += n;
+    size -= n;
+    offset += n;
+  }
+  return true;
+}
+
+static bool ReadAll(int fd, char* data, size_t size, int64_t offset) {
+  while (size > 0) {
+    ssize_t n = ::pread(fd, data, size, offset);
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n <= 0) {
+      return false;
+    }
+    data += n;
+    size -= n;
+    offset += n;
+  }
+  return true;
+}
+
+static std::string EncodeHeader(int64_t covered_log_id, int64_t hole_start_log_id) {
+  std::string header(kHeaderSize, '\0');
+  memcpy(header.data(), &kJournalMagic, sizeof(kJournalMagic));
+  memcpy(header.data() + sizeof(kJournalMagic), &covered_log_id, sizeof(covered_log_id));
+  memcpy(header.data() + sizeof(kJournalMagic) + sizeof(covered_log_id), &hole_start_log_id,
+         sizeof(hole_start_log_id));
+  return header;
+}
+
+static std::string EncodeRecord(int64_t log_id, const std::string& payload) {
+  uint32_t size = payload.size();
+  uint32_t crc = butil::crc32c::Value(payload.data(), payload.size());
+
+  std::string record(kRecordHeaderSize, '\0');
+  memcpy(record.data(), &log_id, sizeof(log_id));
+  memcpy(record.data() + sizeof(log_id), &size, sizeof(size));
+  memcpy(record.data() + sizeof(log_id) + sizeof(size), &crc, sizeof(crc));
+  record.append(payload);
+  return record;
+}
+
+IndexJournal::~IndexJournal() { Close(); }
+
+void IndexJournal::Close() {
+  if (fd_ >= 0) {
+    ::close(fd_);
+    fd_ = -1;
+  }
+}
+
+bool IndexJournal::Init(int64_t covered_log_id) {
+  BAIDU_SCOPED_LOCK(mutex_);
+
+  if (Helper::IsExistPath(path_)) {
+    return Load();
+  }
+
+  records_.clear();
+  hole_start_log_id_ = 0;
+  hole_end_log_id_ = INT64_MAX;
+  return Rewrite(covered_log_id, {});
+}
+
+bool IndexJournal::Load() {
+  fd_ = ::open(path_.c_str(), O_RDWR);
+  if (fd_ < 0) {
+    DINGO_LOG(ERROR) << fmt::format("[index.journal][region({})] open {} failed, errno: {}", region_id_, path_, errno);
+    return false;
+  }
+
+  std::string header(kHeaderSize, '\0');
+  uint64_t magic = 0;
+  if (ReadAll(fd_, header.data(), kHeaderSize, 0)) {
+    memcpy(&magic, header.data(), sizeof(magic));
+  }
+  if (magic != kJournalMagic) {
+    DINGO_LOG(WARNING) << fmt::format("[index.journal][region({})] invalid header {}", region_id_, path_);
+    Close();
+    return false;
+  }
+  memcpy(&covered_log_id_, header.data() + sizeof(magic), sizeof(covered_log_id_));
+  int64_t hole_start_log_id = 0;
+  memcpy(&hole_start_log_id, header.data() + sizeof(magic) + sizeof(covered_log_id_), sizeof(hole_start_log_id));
+
+  // records are checked one by one, stop at the first broken record
+  records_.clear();
+  int64_t offset = kHeaderSize;
+  std::string record_header(kRecordHeaderSize, '\0');
+  std::string payload;
+  for (;;) {
+    if (!ReadAll(fd_, record_header.data(), kRecordHeaderSize, offset)) {
+      break;
+    }
+
+    int64_t log_id = 0;
+    uint32_t size = 0, crc = 0;
+    memcpy(&log_id, record_header.data(), sizeof(log_id));
+    memcpy(&size, record_header.data() + sizeof(log_id), sizeof(size));
+    memcpy(&crc, record_header.data() + sizeof(log_id) + sizeof(size), sizeof(crc));
+    if (size > kMaxRecordSize || (!records_.empty() && log_id <= records_.back().log_id)) {
+      break;
+    }
+
+    payload.resize(size);
+    if (!ReadAll(fd_, payload.data(), size, offset + kRecordHeaderSize) ||
+        butil::crc32c::Value(payload.data(), size) != crc) {
+      break;
+    }
+
+    records_.push_back({log_id, offset + kRecordHeaderSize, size});
+    offset += kRecordHeaderSize + size;
+  }
+
+  if (::ftruncate(fd_, offset) != 0) {
+    DINGO_LOG(ERROR) << fmt::format("[index.journal][region({})] truncate {} failed, errno: {}", region_id_, path_,
+                                    errno);
+    Close();
+    return false;
+  }
+  write_offset_ = offset;
+
+  // the records appended after the last loaded one may be lost, a hole of the previous run is not filled yet, it is
+  // merged with the new one, the records between them are only kept a bit longer in raft log
+  hole_start_log_id_ = records_.empty() ? covered_log_id_ : records_.back().log_id + 1;
+  if (hole_start_log_id > 0) {
+    hole_start_log_id_ = std::min(hole_start_log_id_, hole_start_log_id);
+  }
+  hole_end_log_id_ = INT64_MAX;
+
+  // persist the hole before any append, so it survives the next crash
+  header = EncodeHeader(covered_log_id_, hole_start_log_id_);
+  if (!WriteAll(fd_, header.data(), header.size(), 0) || ::fdatasync(fd_) != 0) {
+    DINGO_LOG(ERROR) << fmt::format("[index.journal][region({})] write header {} failed, errno: {}", region_id_, path_,
+                                    errno);
+    Close();
+    return false;
+  }
+
+  DINGO_LOG(INFO) << fmt::format(
+      "[index.journal][region({})] load journal, covered_log_id: {} record count: {} hole_start_log_id: {}",
+      region_id_, covered_log_id_, records_.size(), hole_start_log_id_);
+
+  return true;
+}
+
+bool IndexJournal::Rewrite(int64_t covered_log_id, const std::vector<std::pair<int64_t, std::string>>& payloads) {
+  std::string tmp_path = path_ + ".tmp";
+  int fd = ::open(tmp_path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0) {
+    DINGO_LOG(ERROR) << fmt::format("[index.journal][region({})] open {} failed, errno: {}", region_id_, tmp_path,
+                                    errno);
+    return false;
+  }
+
+  std::string data = EncodeHeader(covered_log_id, hole_start_log_id_);
+  std::vector<Record> records;
+  records.reserve(payloads.size());
+  for (const auto& [log_id, payload] : payloads) {
+    records.push_back({log_id, static_cast<int64_t>(data.size()) + kRecordHeaderSize,
+                       static_cast<uint32_t>(payload.size())});
+    data.append(EncodeRecord(log_id, payload));
+  }
+
+  if (!WriteAll(fd, data.data(), data.size(), 0) || ::fsync(fd) != 0) {
+    DINGO_LOG(ERROR) << fmt::format("[index.journal][region({})] write {} failed, errno: {}", region_id_, tmp_path,
+                                    errno);
+    ::close(fd);
+    Helper::RemoveFileOrDirectory(tmp_path);
+    return false;
+  }
+
+  auto status = Helper::Rename(tmp_path, path_);
+  if (!status.ok()) {
+    DINGO_LOG(ERROR) << fmt::format("[index.journal][region({})] rename {} failed, error: {}", region_id_, tmp_path,
+                                    status.error_str());
+    ::close(fd);
+    return false;
+  }
+
+  Close();
+  fd_ = fd;
+  write_offset_ = data.size();
+  dirty_ = false;
+  covered_log_id_ = covered_log_id;
+  records_.swap(records);
+
+  return true;
+}
+
+bool IndexJournal::ReadPayload(const Record& record, std::string& payload) {
+  payload.resize(record.size);
+  return ReadAll(fd_, payload.data(), record.size, record.offset);
+}
+
+int64_t IndexJournal::CoveredLogId() {
+  BAIDU_SCOPED_LOCK(mutex_);
+  return covered_log_id_;
+}
+
+int64_t IndexJournal::LastLogId() {
+  BAIDU_SCOPED_LOCK(mutex_);
+  return records_.empty() ? 0 : records_.back().log_id;
+}
+
+int64_t IndexJournal::RecordCount() {
+  BAIDU_SCOPED_LOCK(mutex_);
+  return records_.size();
+}
+
+bool IndexJournal::Append(int64_t log_id, const pb::raft::RaftCmdRequest& requests) {
+  BAIDU_SCOPED_LOCK(mutex_);
+
+  if (fd_ < 0) {
+    return false;
+  }
+  if (log_id < covered_log_id_ || (!records_.empty() && log_id <= records_.back().log_id)) {
+    return true;
+  }
+
+  std::string payload = requests.SerializeAsString();
+  std::string record = EncodeRecord(log_id, payload);
+  if (!WriteAll(fd_, record.data(), record.size(), write_offset_)) {
+    DINGO_LOG(ERROR) << fmt::format("[index.journal][region({})] append log({}) failed, errno: {}", region_id_, log_id,
+                                    errno);
+    // the written part is overwritten by the next append
+    return false;
+  }
+
+  records_.push_back({log_id, write_offset_ + kRecordHeaderSize, static_cast<uint32_t>(payload.size())});
+  write_offset_ += record.size();
+  dirty_ = true;
+
+  // the first append after load close the hole
+  if (hole_start_log_id_ > 0 && hole_end_log_id_ == INT64_MAX) {
+    hole_end_log_id_ = log_id - 1;
+    if (hole_end_log_id_ < hole_start_log_id_) {
+      hole_start_log_id_ = 0;
+      hole_end_log_id_ = INT64_MAX;
+      // synced with the record, a stale hole start only keeps more raft log
+      std::string header = EncodeHeader(covered_log_id_, hole_start_log_id_);
+      WriteAll(fd_, header.data(), header.size(), 0);
+    }
+  }
+
+  return true;
+}
+
+bool IndexJournal::Sync() {
+  BAIDU_SCOPED_LOCK(mutex_);
+
+  if (fd_ < 0 || !dirty_) {
+    return true;
+  }
+  if (::fdatasync(fd_) != 0) {
+    DINGO_LOG(ERROR) << fmt::format("[index.journal][region({})] sync failed, errno: {}", region_id_, errno);
+    return false;
+  }
+
+  dirty_ = false;
+  return true;
+}
+
+int64_t IndexJournal::RequiredRaftLogId(int64_t index_first_log_id) {
+  BAIDU_SCOPED_LOCK(mutex_);
+
+  if (fd_ < 0 || index_first_log_id < covered_log_id_) {
+    return index_first_log_id;
+  }
+  if (hole_start_log_id_ > 0 && index_first_log_id <= hole_end_log_id_) {
+    return std::max(index_first_log_id, hole_start_log_id_);
+  }
+
+  return INT64_MAX;
+}
+
+butil::Status IndexJournal::Read(int64_t start_log_id, int64_t end_log_id,
+                                 std::vector<std::pair<int64_t, pb::raft::RaftCmdRequest>>& records) {
+  BAIDU_SCOPED_LOCK(mutex_);
+
+  if (start_log_id < covered_log_id_) {
+    return butil::Status(pb::error::EINTERNAL, fmt::format("Journal cover from log({}), read from log({})",
+                                                           covered_log_id_, start_log_id));
+  }
+
+  auto it = std::lower_bound(records_.begin(), records_.end(), start_log_id,
+                             [](const Record& record, int64_t log_id) { return record.log_id < log_id; });
+  std::string payload;
+  for (; it != records_.end() && it->log_id <= end_log_id; ++it) {
+    pb::raft::RaftCmdRequest requests;
+    if (!ReadPayload(*it, payload) || !requests.ParseFromString(payload)) {
+      return butil::Status(pb::error::EINTERNAL, fmt::format("Read journal log({}) failed", it->log_id));
+    }
+    records.emplace_back(it->log_id, std::move(requests));
+  }
+
+  return butil::Status::OK();
+}
+
+bool IndexJournal::TruncatePrefix(int64_t first_log_id_kept) {
+  BAIDU_SCOPED_LOCK(mutex_);
+
+  if (fd_ < 0 || first_log_id_kept <= covered_log_id_) {
+    return true;
+  }
+
+  if (hole_start_log_id_ > 0) {
+    if (first_log_id_kept > hole_end_log_id_) {
+      hole_start_log_id_ = 0;
+      hole_end_log_id_ = INT64_MAX;
+    } else {
+      hole_start_log_id_ = std::max(hole_start_log_id_, first_log_id_kept);
+    }
+  }
+
+  auto it = std::lower_bound(records_.begin(), records_.end(), first_log_id_kept,
+                             [](const Record& record, int64_t log_id) { return record.log_id < log_id; });
+  if (it == records_.begin()) {
+    // no record dropped, just update the header
+    std::string header = EncodeHeader(first_log_id_kept, hole_start_log_id_);
+    if (!WriteAll(fd_, header.data(), header.size(), 0)) {
+      return false;
+    }
+    covered_log_id_ = first_log_id_kept;
+    dirty_ = true;
+    return true;
+  }
+
+  // the kept records are appended after the index snapshot, usually a few
+  std::vector<std::pair<int64_t, std::string>> payloads;
+  for (; it != records_.end(); ++it) {
+    std::string payload;
+    if (!ReadPayload(*it, payload)) {
+      return false;
+    }
+    payloads.emplace_back(it->log_id, std::move(payload));
+  }
+
+  return Rewrite(first_log_id_kept, payloads);
+}
+
+bool IndexJournal::Reset(int64_t covered_log_id) {
+  BAIDU_SCOPED_LOCK(mutex_);
+
+  hole_start_log_id_ = 0;
+  hole_end_log_id_ = INT64_MAX;
+  return Rewrite(covered_log_id, {});
+}
+
+void IndexJournal::Destroy() {
+  BAIDU_SCOPED_LOCK(mutex_);
+
+  Close();
+  records_.clear();
+  Helper::RemoveFileOrDirectory(path_);
+}
+
+// Keep the same requests as replay wal use.
+bool IndexJournal::ExtractIndexRequests(const pb::raft::RaftCmdRequest& raft_cmd, pb::raft::RaftCmdRequest& requests) {
+  for (const auto& request : raft_cmd.requests()) {
+    switch (request.cmd_type()) {
+      case pb::raft::VECTOR_ADD: {
+        auto* mut_request = requests.add_requests();
+        mut_request->set_cmd_type(pb::raft::VECTOR_ADD);
+        auto* mut_vector_add = mut_request->mutable_vector_add();
+        for (const auto& vector : request.vector_add().vectors()) {
+          // scalar and table data is not used by index
+          auto* mut_vector = mut_vector_add->add_vectors();
+          mut_vector->set_id(vector.id());
+          *mut_vector->mutable_vector() = vector.vector();
+        }
+        break;
+      }
+      case pb::raft::VECTOR_DELETE: {
+        auto* mut_request = requests.add_requests();
+        mut_request->set_cmd_type(pb::raft::VECTOR_DELETE);
+        *mut_request->mutable_vector_delete()->mutable_ids() = request.vector_delete().ids();
+        break;
+      }
+      case pb::raft::DOCUMENT_ADD: {
+        auto* mut_request = requests.add_requests();
+        mut_request->set_cmd_type(pb::raft::DOCUMENT_ADD);
+        *mut_request->mutable_document_add()->mutable_documents() = request.document_add().documents();
+        break;
+      }
+      case pb::raft::DOCUMENT_DELETE: {
+        auto* mut_request = requests.add_requests();
+        mut_request->set_cmd_type(pb::raft::DOCUMENT_DELETE);
+        *mut_request->mutable_document_delete()->mutable_ids() = request.document_delete().ids();
+        break;
+      }
+      default:
+        break;
+    }
+  }
+
+  return requests.requests_size() > 0;
+}
+
+IndexJournalManager& IndexJournalManager::GetInstance() {
+  static IndexJournalManager instance;
+  return instance;
+}
+
+bool IndexJournalManager::IsEnabled() { return FLAGS_enable_index_journal; }
+
+std::string IndexJournalManager::JournalPath(int64_t region_id) const {
+  return fmt::format("{}/{}{}", path_, region_id, kJournalSuffix);
+}
+
+bool IndexJournalManager::Init(const std::string& path) {
+  path_ = path;
+
+  if (!IsEnabled()) {
+    if (Helper::IsExistPath(path_)) {
+      DINGO_LOG(INFO) << fmt::format("[index.journal] journal is disabled, remove {}", path_);
+      Helper::RemoveAllFileOrDirectory(path_);
+    }
+    return true;
+  }
+
+  auto status = Helper::CreateDirectories(path_);
+  if (!status.ok()) {
+    DINGO_LOG(ERROR) << fmt::format("[index.journal] create directory {} failed, error: {}", path_,
+                                    status.error_str());
+    return false;
+  }
+
+  BAIDU_SCOPED_LOCK(mutex_);
+  for (const auto& filename : Helper::TraverseDirectory(path_, true)) {
+    if (filename.size() <= kJournalSuffix.size() ||
+        filename.compare(filename.size() - kJournalSuffix.size(), kJournalSuffix.size(), kJournalSuffix) != 0) {
+      continue;
+    }
+
+    int64_t region_id = Helper::StringToInt64(filename.substr(0, filename.size() - kJournalSuffix.size()));
+    if (region_id <= 0) {
+      continue;
+    }
+
+    auto journal = std::make_shared<IndexJournal>(region_id, JournalPath(region_id));
+    if (!journal->Init(0)) {
+      // the raft log is kept for the index without journal
+      DINGO_LOG(WARNING) << fmt::format("[index.journal][region({})] load journal failed, remove it", region_id);
+      Helper::RemoveFileOrDirectory(JournalPath(region_id));
+      continue;
+    }
+    journals_[region_id] = journal;
+  }
+
+  return true;
+}
+
+IndexJournalPtr IndexJournalManager::GetJournal(int64_t region_id) {
+  BAIDU_SCOPED_LOCK(mutex_);
+
+  auto it = journals_.find(region_id);
+  return it != journals_.end() ? it->second : nullptr;
+}
+
+void IndexJournalManager::DeleteJournal(int64_t region_id) {
+  IndexJournalPtr journal;
+  {
+    BAIDU_SCOPED_LOCK(mutex_);
+    auto it = journals_.find(region_id);
+    if (it == journals_.end()) {
+      return;
+    }
+    journal = it->second;
+    journals_.erase(it);
+  }
+
+  journal->Destroy();
+}
+
+void IndexJournalManager::ResetJournal(int64_t region_id, int64_t covered_log_id) {
+  auto journal = GetJournal(region_id);
+  if (journal != nullptr && !journal->Reset(covered_log_id)) {
+    // the journal cover nothing now
+    DeleteJournal(region_id);
+  }
+}
+
+void IndexJournalManager::OnApply(int64_t region_id, int64_t log_id, const pb::raft::RaftCmdRequest& raft_cmd) {
+  pb::raft::RaftCmdRequest requests;
+  if (!IsEnabled() || !IndexJournal::ExtractIndexRequests(raft_cmd, requests)) {
+    return;
+  }
+
+  IndexJournalPtr journal;
+  {
+    BAIDU_SCOPED_LOCK(mutex_);
+    auto& mut_journal = journals_[region_id];
+    if (mut_journal == nullptr) {
+      // the index requests before this log are not recorded, remove the stale file of a broken journal
+      if (Helper::IsExistPath(JournalPath(region_id))) {
+        Helper::RemoveFileOrDirectory(JournalPath(region_id));
+      }
+      mut_journal = std::make_shared<IndexJournal>(region_id, JournalPath(region_id));
+      if (!mut_journal->Init(log_id)) {
+        journals_.erase(region_id);
+        return;
+      }
+    }
+    journal = mut_journal;
+  }
+
+  if (!journal->Append(log_id, requests)) {
+    // a missed record break the journal, start a new one from the next log
+    DeleteJournal(region_id);
+  }
+}
+
+butil::Status IndexJournalManager::ReadIndexLog(std::shared_ptr<SegmentLogStorage> log_storage, int64_t start_log_id,
+                                                int64_t end_log_id, ReadHandler handler) {
+  if (start_log_id > end_log_id) {
+    return butil::Status::OK();
+  }
+
+  int64_t raft_start_log_id = std::max(start_log_id, log_storage->FirstLogIndex());
+  if (raft_start_log_id > start_log_id) {
+    // the log is truncated from raft log, read from journal
+    auto journal = GetInstance().GetJournal(log_storage->RegionId());
+    if (journal == nullptr) {
+      return butil::Status(pb::error::EINTERNAL, fmt::format("Log({}-{}) is truncated and not found journal",
+                                                             start_log_id, raft_start_log_id - 1));
+    }
+
+    std::vector<std::pair<int64_t, pb::raft::RaftCmdRequest>> records;
+    auto status = journal->Read(start_log_id, std::min(end_log_id, raft_start_log_id - 1), records);
+    if (!status.ok()) {
+      return status;
+    }
+    for (auto& [log_id, requests] : records) {
+      handler(log_id, requests);
+    }
+  }
+
+  if (raft_start_log_id <= end_log_id) {
+    auto log_entrys = log_storage->GetEntrys(raft_start_log_id, end_log_id);
+    for (const auto& log_entry : log_entrys) {
+      pb::raft::RaftCmdRequest raft_cmd;
+      CHECK(RaftCmdCodec::Decode(log_entry->data, raft_cmd));
+      handler(log_entry->index, raft_cmd);
+    }
+  }
+
+  return butil::Status::OK();
+}
+
+}  // namespace dingodb
@@ -0,0 +1,151 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef DINGODB_LOG_INDEX_JOURNAL_H_
+#define DINGODB_LOG_INDEX_JOURNAL_H_
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "bthread/mutex.h"
+#include "butil/status.h"
+#include "log/segment_log_storage.h"
+#include "proto/raft.pb.h"
+
+namespace dingodb {
+
+// Journal of the index requests(vector/document add/delete) of a region, appended in log order at raft apply.
+// The requests are trimmed to what the index replay need, so it is much smaller than the raft log.
+// Index recovery read the journal for the log which is truncated from raft log, so a lagging or unsaved
+// vector/document index does not pin the raft log.
+//
+// All index requests of log >= covered log id are recorded. The unsynced tail may be lost at crash, which leaves a
+// hole between the last loaded record and the first record appended after restart, raft log of the hole is kept
+// until the index snapshot pass it. The hole start is persisted in header, so a hole not passed yet is not forgotten
+// by the next crash, the holes of several crashes are merged into one from the first hole start.
+// File layout: header(magic, covered log id, hole start log id), records(log id, size, crc32c, serialized
+// RaftCmdRequest).
+class IndexJournal {
+ public:
+  IndexJournal(int64_t region_id, const std::string& path) : region_id_(region_id), path_(path) {}
+  ~IndexJournal();
+
+  IndexJournal(const IndexJournal&) = delete;
+  IndexJournal& operator=(const IndexJournal&) = delete;
+
+  // Open exist journal file and drop the broken tail, or create a new one cover from covered_log_id.
+  bool Init(int64_t covered_log_id);
+
+  int64_t RegionId() const { return region_id_; }
+  int64_t CoveredLogId();
+  int64_t LastLogId();
+  int64_t RecordCount();
+
+  // Log not greater than last log id is ignored, it is reapplied after restart.
+  bool Append(int64_t log_id, const pb::raft::RaftCmdRequest& requests);
+  bool Sync();
+
+  // The first raft log id which index recovery start from index_first_log_id still need,
+  // INT64_MAX means the journal cover all.
+  int64_t RequiredRaftLogId(int64_t index_first_log_id);
+
+  // Read records of log [start_log_id, end_log_id].
+  butil::Status Read(int64_t start_log_id, int64_t end_log_id,
+                     std::vector<std::pair<int64_t, pb::raft::RaftCmdRequest>>& records);
+
+  // Drop records of log < first_log_id_kept, they are in the index snapshot.
+  bool TruncatePrefix(int64_t first_log_id_kept);
+  // Drop all records and cover from covered_log_id, e.g. raft log is reset by install snapshot.
+  bool Reset(int64_t covered_log_id);
+
+  void Destroy();
+
+  // Trim the index requests of raft cmd for journal, return false if there is no index request.
+  static bool ExtractIndexRequests(const pb::raft::RaftCmdRequest& raft_cmd, pb::raft::RaftCmdRequest& requests);
+
+ private:
+  struct Record {
+    int64_t log_id;
+    int64_t offset;
+    uint32_t size;
+  };
+
+  bool Load();
+  // Write a new file with header and the given records, then replace the old one.
+  bool Rewrite(int64_t covered_log_id, const std::vector<std::pair<int64_t, std::string>>& payloads);
+  bool ReadPayload(const Record& record, std::string& payload);
+  void Close();
+
+  int64_t region_id_;
+  std::string path_;
+
+  bthread::Mutex mutex_;
+  int fd_{-1};
+  int64_t write_offset_{0};
+  bool dirty_{false};
+
+  int64_t covered_log_id_{0};
+  std::vector<Record> records_;
+
+  // [hole_start_log_id_, hole_end_log_id_] may miss records, 0 means no hole. hole_start_log_id_ is in header, the
+  // hole end is known by the first append after load.
+  int64_t hole_start_log_id_{0};
+  int64_t hole_end_log_id_{INT64_MAX};
+};
+
+using IndexJournalPtr = std::shared_ptr<IndexJournal>;
+
+class IndexJournalManager {
+ public:
+  static IndexJournalManager& GetInstance();
+
+  static bool IsEnabled();
+
+  // Load all journals. When disabled remove the journals, they miss the requests applied from now on.
+  bool Init(const std::string& path);
+
+  IndexJournalPtr GetJournal(int64_t region_id);
+  void DeleteJournal(int64_t region_id);
+  // Reset the journal of region if exist.
+  void ResetJournal(int64_t region_id, int64_t covered_log_id);
+
+  // Record the index requests of raft cmd, called in log order.
+  void OnApply(int64_t region_id, int64_t log_id, const pb::raft::RaftCmdRequest& raft_cmd);
+
+  // Read raft cmd of log [start_log_id, end_log_id], the log truncated from raft log is read from journal.
+  using ReadHandler = std::function<void(int64_t log_id, pb::raft::RaftCmdRequest& raft_cmd)>;
+  static butil::Status ReadIndexLog(std::shared_ptr<SegmentLogStorage> log_storage, int64_t start_log_id,
+                                    int64_t end_log_id, ReadHandler handler);
+
+ private:
+  IndexJournalManager() = default;
+  ~IndexJournalManager() = default;
+
+  std::string JournalPath(int64_t region_id) const;
+
+  std::string path_;
+
+  bthread::Mutex mutex_;
+  std::map<int64_t, IndexJournalPtr> journals_;
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_LOG_INDEX_JOURNAL_H_
@@ -0,0 +1,206 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "log/log_entry_cache.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <list>
+#include <vector>
+
+#include "bthread/mutex.h"
+#include "bvar/passive_status.h"
+#include "bvar/reducer.h"
+#include "bvar/window.h"
+#include "gflags/gflags.h"
+
+namespace dingodb {
+
+DEFINE_bool(enable_raft_log_entry_cache, false, "enable cache recently appended raft log entries");
+DEFINE_int64(raft_log_entry_cache_capacity_bytes, 256 * 1024 * 1024, "raft log entry cache capacity bytes");
+DEFINE_uint32(raft_log_entry_cache_shard_num, 32, "raft log entry cache shard num");
+DEFINE_int64(raft_log_entry_cache_max_entry_bytes, 4 * 1024 * 1024, "raft log entry bigger than it not cache");
+
+static bvar::Adder<int64_t> g_log_entry_cache_hit_count("dingo_raft_log_entry_cache_hit_count");
+static bvar::Adder<int64_t> g_log_entry_cache_miss_count("dingo_raft_log_entry_cache_miss_count");
+static bvar::Adder<int64_t> g_log_entry_cache_evict_count("dingo_raft_log_entry_cache_evict_count");
+static bvar::Window<bvar::Adder<int64_t>> g_log_entry_cache_hit_window(&g_log_entry_cache_hit_count, 60);
+static bvar::Window<bvar::Adder<int64_t>> g_log_entry_cache_miss_window(&g_log_entry_cache_miss_count, 60);
+
+static double GetHitRatio(void*) {
+  int64_t hit = g_log_entry_cache_hit_window.get_value();
+  int64_t total = hit + g_log_entry_cache_miss_window.get_value();
+  return total > 0 ? static_cast<double>(hit) / total : 0.0;
+}
+
+// hit ratio in last 60 seconds
+static bvar::PassiveStatus<double> g_log_entry_cache_hit_ratio("dingo_raft_log_entry_cache_hit_ratio", GetHitRatio,
+                                                               nullptr);
+
+LogEntryCache::LogEntryCache(int64_t capacity_bytes, uint32_t shard_num)
+    : shard_capacity_bytes_(capacity_bytes / std::max(shard_num, 1U)), shards_(std::max(shard_num, 1U)) {
+  for (auto& shard : shards_) {
+    bthread_mutex_init(&shard.mutex, nullptr);
+  }
+}
+
+LogEntryCache::~LogEntryCache() {
+  for (auto& shard : shards_) {
+    for (auto& entry : shard.lru) {
+      entry.entry->Release();
+    }
+    bthread_mutex_destroy(&shard.mutex);
+  }
+}
+
+LogEntryCache& LogEntryCache::GetInstance() {
+  static LogEntryCache instance(FLAGS_raft_log_entry_cache_capacity_bytes, FLAGS_raft_log_entry_cache_shard_num);
+  return instance;
+}
+
+bool LogEntryCache::IsEnabled() { return FLAGS_enable_raft_log_entry_cache; }
+
+braft::LogEntry* LogEntryCache::CloneEntry(const braft::LogEntry* entry) {
+  auto* new_entry = new braft::LogEntry();
+  new_entry->AddRef();
+  new_entry->type = entry->type;
+  new_entry->id = entry->id;
+  // share the underlying blocks, not copy
+  new_entry->data = entry->data;
+
+  return new_entry;
+}
+
+void LogEntryCache::EraseEntry(Shard& shard, std::list<Entry>::iterator it) {
+  auto region_it = shard.regions.find(it->region_id);
+  if (region_it != shard.regions.end()) {
+    region_it->second.erase(it->index);
+    if (region_it->second.empty()) {
+      shard.regions.erase(region_it);
+    }
+  }
+
+  shard.bytes -= it->bytes;
+  it->entry->Release();
+  shard.lru.erase(it);
+}
+
+void LogEntryCache::Put(int64_t region_id, const braft::LogEntry* entry) {
+  if (entry->type != braft::ENTRY_TYPE_DATA && entry->type != braft::ENTRY_TYPE_NO_OP) {
+    return;
+  }
+
+  int64_t bytes = sizeof(Entry) + sizeof(braft::LogEntry) + entry->data.size();
+  if (bytes > FLAGS_raft_log_entry_cache_max_entry_bytes || bytes > shard_capacity_bytes_) {
+    return;
+  }
+
+  auto* cache_entry = CloneEntry(entry);
+  auto& shard = GetShard(region_id);
+
+  BAIDU_SCOPED_LOCK(shard.mutex);
+
+  auto& index_map = shard.regions[region_id];
+  auto it = index_map.find(entry->id.index);
+  if (it != index_map.end()) {
+    auto lru_it = it->second;
+    shard.bytes -= lru_it->bytes;
+    lru_it->entry->Release();
+    shard.lru.erase(lru_it);
+    index_map.erase(it);
+  }
+
+  shard.lru.push_front(Entry{region_id, entry->id.index, cache_entry, bytes});
+  index_map[entry->id.index] = shard.lru.begin();
+  shard.bytes += bytes;
+
+  while (shard.bytes > shard_capacity_bytes_ && shard.lru.size() > 1) {
+    EraseEntry(shard, std::prev(shard.lru.end()));
+    g_log_entry_cache_evict_count << 1;
+  }
+}
+
+braft::LogEntry* LogEntryCache::Get(int64_t region_id, int64_t index) {
+  auto& shard = GetShard(region_id);
+
+  BAIDU_SCOPED_LOCK(shard.mutex);
+
+  auto region_it = shard.regions.find(region_id);
+  if (region_it == shard.regions.end()) {
+    g_log_entry_cache_miss_count << 1;
+    return nullptr;
+  }
+  auto it = region_it->second.find(index);
+  if (it == region_it->second.end()) {
+    g_log_entry_cache_miss_count << 1;
+    return nullptr;
+  }
+
+  shard.lru.splice(shard.lru.begin(), shard.lru, it->second);
+  g_log_entry_cache_hit_count << 1;
+
+  return CloneEntry(it->second->entry);
+}
+
+void LogEntryCache::Erase(int64_t region_id, int64_t begin_index, int64_t end_index) {
+  if (begin_index >= end_index) {
+    return;
+  }
+
+  auto& shard = GetShard(region_id);
+
+  BAIDU_SCOPED_LOCK(shard.mutex);
+
+  auto region_it = shard.regions.find(region_id);
+  if (region_it == shard.regions.end()) {
+    return;
+  }
+
+  auto& index_map = region_it->second;
+  auto it = index_map.lower_bound(begin_index);
+  while (it != index_map.end() && it->first < end_index) {
+    auto lru_it = it->second;
+    shard.bytes -= lru_it->bytes;
+    lru_it->entry->Release();
+    shard.lru.erase(lru_it);
+    it = index_map.erase(it);
+  }
+
+  if (index_map.empty()) {
+    shard.regions.erase(region_it);
+  }
+}
+
+void LogEntryCache::EraseRegion(int64_t region_id) { Erase(region_id, INT64_MIN, INT64_MAX); }
+
+int64_t LogEntryCache::Count() {
+  int64_t count = 0;
+  for (auto& shard : shards_) {
+    BAIDU_SCOPED_LOCK(shard.mutex);
+    count += shard.lru.size();
+  }
+  return count;
+}
+
+int64_t LogEntryCache::MemorySize() {
+  int64_t bytes = 0;
+  for (auto& shard : shards_) {
+    BAIDU_SCOPED_LOCK(shard.mutex);
+    bytes += shard.bytes;
+  }
+  return bytes;
+}
+
+}  // namespace dingodb
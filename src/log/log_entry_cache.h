@@ -0,0 +1,91 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_LOG_ENTRY_CACHE_H_
+#define DINGODB_LOG_ENTRY_CACHE_H_
+
+#include <cstdint>
+#include <list>
+#include <map>
+#include <unordered_map>
+#include <vector>
+
+#include "braft/log_entry.h"
+#include "bthread/types.h"
+
+namespace dingodb {
+
+// Store level LRU cache of recently appended raft log entries, in front of the segment file reads.
+// It is sharded by region, every shard has its own lock.
+// The cached entry shares the data IOBuf with the appended one, Get returns a new entry which also shares it,
+// so the caller can consume it freely.
+// Only data and no-op entries are cached, configuration entries are rare and always read from segment.
+// The entries of region are dropped on truncate suffix/prefix and reset, so an overwritten index is never served.
+class LogEntryCache {
+ public:
+  LogEntryCache(int64_t capacity_bytes, uint32_t shard_num);
+  ~LogEntryCache();
+
+  LogEntryCache(const LogEntryCache& rhs) = delete;
+  LogEntryCache& operator=(const LogEntryCache& rhs) = delete;
+  LogEntryCache(LogEntryCache&& rhs) = delete;
+  LogEntryCache& operator=(LogEntryCache&& rhs) = delete;
+
+  // Create by gflags.
+  static LogEntryCache& GetInstance();
+
+  static bool IsEnabled();
+
+  void Put(int64_t region_id, const braft::LogEntry* entry);
+
+  // Return nullptr if not exist, otherwise caller must Release the returned entry.
+  braft::LogEntry* Get(int64_t region_id, int64_t index);
+
+  // Erase [begin_index, end_index)
+  void Erase(int64_t region_id, int64_t begin_index, int64_t end_index);
+  void EraseRegion(int64_t region_id);
+
+  int64_t Count();
+  int64_t MemorySize();
+
+ private:
+  struct Entry {
+    int64_t region_id;
+    int64_t index;
+    braft::LogEntry* entry;
+    int64_t bytes;
+  };
+
+  using IndexMap = std::map<int64_t, std::list<Entry>::iterator>;
+
+  struct Shard {
+    bthread_mutex_t mutex;
+    // front is the most recently used
+    std::list<Entry> lru;
+    std::unordered_map<int64_t, IndexMap> regions;
+    int64_t bytes{0};
+  };
+
+  static braft::LogEntry* CloneEntry(const braft::LogEntry* entry);
+
+  Shard& GetShard(int64_t region_id) { return shards_[static_cast<uint64_t>(region_id) % shards_.size()]; }
+  static void EraseEntry(Shard& shard, std::list<Entry>::iterator it);
+
+  int64_t shard_capacity_bytes_;
+  std::vector<Shard> shards_;
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_LOG_ENTRY_CACHE_H_
@@ -0,0 +1,158 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "log/segment_log_group_syncer.h"
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <vector>
+
+#include "braft/fsync.h"
+#include "bthread/bthread.h"
+#include "bthread/condition_variable.h"
+#include "bthread/mutex.h"
+#include "butil/time.h"
+#include "bvar/latency_recorder.h"
+#include "bvar/recorder.h"
+#include "common/logging.h"
+#include "fmt/core.h"
+#include "gflags/gflags.h"
+
+namespace dingodb {
+
+DEFINE_bool(dingo_raft_group_sync_log, false, "group fsync the segment log of all regions");
+DEFINE_int64(dingo_raft_group_sync_log_window_us, 200, "wait time for more regions join a group sync batch");
+DEFINE_bool(dingo_raft_group_sync_log_use_syncfs, true,
+            "group sync by one syncfs per file system, otherwise one fdatasync per segment file");
+
+static bvar::LatencyRecorder g_segment_log_group_sync_latency("dingo_segment_log_group_sync");
+static bvar::IntRecorder g_segment_log_group_sync_batch_size("dingo_segment_log_group_sync_batch_size");
+
+SegmentLogGroupSyncer::SegmentLogGroupSyncer(int64_t window_us, bool use_syncfs)
+    : window_us_(window_us), use_syncfs_(use_syncfs) {
+  bthread_mutex_init(&mutex_, nullptr);
+  bthread_cond_init(&cond_, nullptr);
+}
+
+SegmentLogGroupSyncer::~SegmentLogGroupSyncer() {
+  bthread_cond_destroy(&cond_);
+  bthread_mutex_destroy(&mutex_);
+}
+
+SegmentLogGroupSyncer& SegmentLogGroupSyncer::GetInstance() {
+  static SegmentLogGroupSyncer instance(FLAGS_dingo_raft_group_sync_log_window_us,
+                                        FLAGS_dingo_raft_group_sync_log_use_syncfs);
+  return instance;
+}
+
+bool SegmentLogGroupSyncer::IsEnabled() { return FLAGS_dingo_raft_group_sync_log; }
+
+int SegmentLogGroupSyncer::Sync(int fd) {
+  std::shared_ptr<Batch> batch;
+  bool is_leader = false;
+  {
+    BAIDU_SCOPED_LOCK(mutex_);
+    if (pending_batch_ == nullptr) {
+      pending_batch_ = std::make_shared<Batch>();
+      is_leader = true;
+    }
+    batch = pending_batch_;
+    batch->fds.push_back(fd);
+  }
+
+  if (!is_leader) {
+    BAIDU_SCOPED_LOCK(mutex_);
+    while (!batch->done) {
+      bthread_cond_wait(&cond_, &mutex_);
+    }
+    return batch->ret;
+  }
+
+  // wait other regions join
+  if (window_us_ > 0) {
+    bthread_usleep(window_us_);
+  }
+
+  {
+    BAIDU_SCOPED_LOCK(mutex_);
+    // members still join while the previous batch is syncing
+    while (is_syncing_) {
+      bthread_cond_wait(&cond_, &mutex_);
+    }
+    is_syncing_ = true;
+    pending_batch_ = nullptr;
+  }
+
+  int64_t start_time_us = butil::gettimeofday_us();
+  int ret = DoSync(batch->fds);
+  g_segment_log_group_sync_latency << butil::gettimeofday_us() - start_time_us;
+  g_segment_log_group_sync_batch_size << static_cast<int64_t>(batch->fds.size());
+
+  {
+    BAIDU_SCOPED_LOCK(mutex_);
+    batch->ret = ret;
+    batch->done = true;
+    is_syncing_ = false;
+    bthread_cond_broadcast(&cond_);
+  }
+
+  return ret;
+}
+
+int SegmentLogGroupSyncer::DoSync(const std::vector<int>& fds) const {
+  if (use_syncfs_) {
+    // one fd per file system
+    std::map<dev_t, int> dev_fds;
+    for (int fd : fds) {
+      struct stat st;
+      if (fstat(fd, &st) != 0) {
+        int err = errno;
+        DINGO_LOG(ERROR) << fmt::format("[raft.log] fstat fd({}) failed, errno: {}", fd, err);
+        return err;
+      }
+      dev_fds.emplace(st.st_dev, fd);
+    }
+
+    for (const auto& [_, fd] : dev_fds) {
+      if (syncfs(fd) != 0) {
+        int err = errno;
+        DINGO_LOG(ERROR) << fmt::format("[raft.log] syncfs fd({}) failed, errno: {}", fd, err);
+        return err;
+      }
+    }
+
+    return 0;
+  }
+
+  std::vector<int> sync_fds = fds;
+  std::sort(sync_fds.begin(), sync_fds.end());
+  sync_fds.erase(std::unique(sync_fds.begin(), sync_fds.end()), sync_fds.end());
+  for (int fd : sync_fds) {
+    int ret = braft::raft_fsync(fd);
+    if (ret != 0) {
+      DINGO_LOG(ERROR) << fmt::format("[raft.log] fsync fd({}) failed, ret: {}", fd, ret);
+      return ret;
+    }
+  }
+
+  return 0;
+}
+
+}  // namespace dingodb
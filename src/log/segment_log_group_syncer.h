@@ -0,0 +1,70 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_SEGMENT_LOG_GROUP_SYNCER_H_
+#define DINGODB_SEGMENT_LOG_GROUP_SYNCER_H_
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "bthread/types.h"
+
+namespace dingodb {
+
+// Group fsync of the segment logs of all regions in the store.
+// Every region keeps its own segment files and index, only the fsync is shared.
+// The first region which needs sync becomes the leader of a batch, it waits a short window for other regions to
+// join, then syncs the whole batch, one syncfs per file system or one fdatasync per distinct file,
+// and wakes up all the members. Only one batch is syncing at a time, the next batch keeps collecting meanwhile.
+class SegmentLogGroupSyncer {
+ public:
+  SegmentLogGroupSyncer(int64_t window_us, bool use_syncfs);
+  ~SegmentLogGroupSyncer();
+
+  SegmentLogGroupSyncer(const SegmentLogGroupSyncer& rhs) = delete;
+  SegmentLogGroupSyncer& operator=(const SegmentLogGroupSyncer& rhs) = delete;
+  SegmentLogGroupSyncer(SegmentLogGroupSyncer&& rhs) = delete;
+  SegmentLogGroupSyncer& operator=(SegmentLogGroupSyncer&& rhs) = delete;
+
+  // Create by gflags.
+  static SegmentLogGroupSyncer& GetInstance();
+
+  static bool IsEnabled();
+
+  // Block until data of fd written before is durable, return 0 on success.
+  int Sync(int fd);
+
+ private:
+  struct Batch {
+    std::vector<int> fds;
+    bool done{false};
+    int ret{0};
+  };
+
+  int DoSync(const std::vector<int>& fds) const;
+
+  int64_t window_us_;
+  bool use_syncfs_;
+
+  bthread_mutex_t mutex_;
+  bthread_cond_t cond_;
+  // batch collecting members
+  std::shared_ptr<Batch> pending_batch_;
+  bool is_syncing_{false};
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_SEGMENT_LOG_GROUP_SYNCER_H_
@@ -14,6 +14,8 @@
 
 #include "log/segment_log_storage.h"
 
+#include <fcntl.h>
+
 #include <algorithm>
 #include <atomic>
 #include <cstdint>
@@ -42,6 +44,9 @@
 #include "common/helper.h"
 #include "common/logging.h"
 #include "fmt/core.h"
+#include "log/index_journal.h"
+#include "log/log_entry_cache.h"
+#include "log/segment_log_group_syncer.h"
 #include "proto/store_internal.pb.h"
 
 #define SEGMENT_OPEN_PATTERN "log_inprogress_%020" PRId64
@@ -52,6 +57,8 @@ namespace dingodb {
 
 DEFINE_bool(dingo_raft_sync_log, true, "Sync log to disk or not");
 DEFINE_bool(dingo_trace_append_entry_latency, false, "Trace append entry latency");
+DEFINE_bool(dingo_raft_segment_preallocate, false,
+            "preallocate disk space of open segment to max segment size, append not allocate block");
 
 using ::butil::RawPacker;
 using ::butil::RawUnpacker;
@@ -157,7 +164,7 @@ inline uint32_t GetChecksum(int checksum_type, const butil::IOBuf& data) {
   }
 }
 
-int Segment::Create() {
+int Segment::Create(int64_t preallocate_bytes) {
   if (!is_open_) {
     CHECK(false) << fmt::format("[raft.log][region({}).index({}_{})] create on a closed segment, path: {}", region_id_,
                                 FirstIndex(), LastIndex(), path_);
@@ -169,6 +176,17 @@ int Segment::Create() {
   fd_ = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
   if (fd_ >= 0) {
     butil::make_close_on_exec(fd_);
+
+    // Keep file size, load and truncate still see the actual written bytes.
+    if (preallocate_bytes > 0) {
+      if (::fallocate(fd_, FALLOC_FL_KEEP_SIZE, 0, preallocate_bytes) == 0) {
+        preallocated_bytes_ = preallocate_bytes;
+      } else {
+        DINGO_LOG(WARNING) << fmt::format(
+            "[raft.log][region({}).index({}_{})] preallocate segment failed, size: {} path: {} error: {}", region_id_,
+            FirstIndex(), LastIndex(), preallocate_bytes, path_, berror());
+      }
+    }
   }
   DINGO_LOG(INFO) << fmt::format("[raft.log][region({}).index({}_{})] created new segment, fd:{} path: {}", region_id_,
                                  FirstIndex(), LastIndex(), fd_, path_);
@@ -370,6 +388,13 @@ int Segment::Load(braft::ConfigurationManager* configuration_manager) {
   // seek to end, for opening segment
   ::lseek(fd_, entry_off, SEEK_SET);
 
+  // The preallocated size is not persisted, the blocks allocated beyond the file size of an open segment are taken
+  // as the preallocated tail, close releases them.
+  int64_t allocated_bytes = static_cast<int64_t>(st_buf.st_blocks) * 512;
+  if (is_open_ && allocated_bytes > file_size) {
+    preallocated_bytes_ = allocated_bytes;
+  }
+
   bytes_ = entry_off;
   return ret;
 }
@@ -450,6 +475,9 @@ int Segment::Sync(bool will_sync) {
       return 0;
     }
     unsynced_bytes_ = 0;
+    if (SegmentLogGroupSyncer::IsEnabled()) {
+      return SegmentLogGroupSyncer::GetInstance().Sync(fd_);
+    }
     return braft::raft_fsync(fd_);
   }
   return 0;
@@ -533,6 +561,16 @@ int Segment::Close(bool will_sync) {
   DINGO_LOG(INFO) << fmt::format(
       "[raft.log][region({}).index({}_{})] close a full segment, raft_sync_segments: {} will_sync: {} path: {}",
       region_id_, FirstIndex(), LastIndex(), Constant::kSegmentLogSync, will_sync, new_path);
+  // release the unused preallocated space after end of file
+  if (preallocated_bytes_ > bytes_) {
+    if (::fallocate(fd_, FALLOC_FL_PUNCH_HOLE | FALLOC_FL_KEEP_SIZE, bytes_, preallocated_bytes_ - bytes_) != 0) {
+      DINGO_LOG(WARNING) << fmt::format(
+          "[raft.log][region({}).index({}_{})] release preallocated space failed, path: {} error: {}", region_id_,
+          FirstIndex(), LastIndex(), path_, berror());
+    }
+    preallocated_bytes_ = 0;
+  }
+
   int ret = 0;
   if (last_index_ > first_index_) {
     if (Constant::kSegmentLogSync && will_sync) {
@@ -805,6 +843,9 @@ int SegmentLogStorage::AppendEntries(const std::vector<braft::LogEntry*>& entrie
     if (0 != ret) {
       return i;
     }
+    if (LogEntryCache::IsEnabled()) {
+      LogEntryCache::GetInstance().Put(region_id_, entry);
+    }
     if (FLAGS_dingo_trace_append_entry_latency && metric) {
       delta_time_us = butil::cpuwide_time_us() - now;
       metric->append_entry_time_us += delta_time_us;
@@ -838,12 +879,22 @@ int SegmentLogStorage::AppendEntry(const braft::LogEntry* entry) {
   if (EEXIST == ret && entry->id.term != GetTerm(entry->id.index)) {
     return EINVAL;
   }
+  if (ret == 0 && LogEntryCache::IsEnabled()) {
+    LogEntryCache::GetInstance().Put(region_id_, entry);
+  }
   last_log_index_.fetch_add(1, butil::memory_order_release);
 
   return segment->Sync(enable_sync_);
 }
 
 braft::LogEntry* SegmentLogStorage::GetEntry(const int64_t index) {
+  if (LogEntryCache::IsEnabled() && index >= FirstLogIndex() && index <= LastLogIndex()) {
+    auto* entry = LogEntryCache::GetInstance().Get(region_id_, index);
+    if (entry != nullptr) {
+      return entry;
+    }
+  }
+
   std::shared_ptr<Segment> segment = GetSegment(index);
   if (segment == nullptr) {
     return nullptr;
@@ -851,6 +902,17 @@ braft::LogEntry* SegmentLogStorage::GetEntry(const int64_t index) {
   return segment->Get(index);
 }
 
+braft::LogEntry* SegmentLogStorage::GetEntryFromSegment(const std::shared_ptr<Segment>& segment, int64_t index) {
+  if (LogEntryCache::IsEnabled()) {
+    auto* entry = LogEntryCache::GetInstance().Get(region_id_, index);
+    if (entry != nullptr) {
+      return entry;
+    }
+  }
+
+  return segment->Get(index);
+}
+
 std::vector<std::shared_ptr<LogEntry>> SegmentLogStorage::GetEntrys(uint64_t begin_index, uint64_t end_index) {
   auto segments = GetSegments(begin_index, end_index);
   if (segments.empty()) {
@@ -863,7 +925,7 @@ std::vector<std::shared_ptr<LogEntry>> SegmentLogStorage::GetEntrys(uint64_t beg
       if (i < begin_index || i > end_index) {
         continue;
       }
-      auto* log_entry = segment->Get(i);
+      auto* log_entry = GetEntryFromSegment(segment, i);
       if (log_entry != nullptr) {
         if (log_entry->type == braft::ENTRY_TYPE_DATA) {
           auto tmp_log_entry = std::make_shared<LogEntry>();
@@ -872,6 +934,7 @@ std::vector<std::shared_ptr<LogEntry>> SegmentLogStorage::GetEntrys(uint64_t beg
           tmp_log_entry->data.swap(log_entry->data);
           log_entrys.push_back(tmp_log_entry);
         }
+        log_entry->Release();
       }
     }
   }
@@ -890,25 +953,26 @@ bool SegmentLogStorage::HasSpecificLog(uint64_t begin_index, uint64_t end_index,
       if (i < begin_index || i > end_index) {
         continue;
       }
-      auto* log_entry = segment->Get(i);
+      auto* log_entry = GetEntryFromSegment(segment, i);
       if (log_entry != nullptr) {
+        bool is_match = false;
         if (log_entry->type == braft::ENTRY_TYPE_DATA) {
           LogEntry tmp_log_entry;
           tmp_log_entry.type = LogEntryType::kEntryTypeData;
           tmp_log_entry.term = log_entry->id.term;
           tmp_log_entry.index = log_entry->id.index;
           tmp_log_entry.data.swap(log_entry->data);
-          if (matcher(tmp_log_entry)) {
-            return true;
-          }
+          is_match = matcher(tmp_log_entry);
         } else if (log_entry->type == braft::ENTRY_TYPE_CONFIGURATION) {
           LogEntry tmp_log_entry;
           tmp_log_entry.type = LogEntryType::kEntryTypeConfiguration;
           tmp_log_entry.term = log_entry->id.term;
           tmp_log_entry.index = log_entry->id.index;
-          if (matcher(tmp_log_entry)) {
-            return true;
-          }
+          is_match = matcher(tmp_log_entry);
+        }
+        log_entry->Release();
+        if (is_match) {
+          return true;
         }
       }
     }
@@ -973,6 +1037,9 @@ int SegmentLogStorage::TruncatePrefix(int64_t first_index_kept) {
     return -1;
   }
   SetFirstAndLastLogIndex(first_index_kept);
+  if (LogEntryCache::IsEnabled()) {
+    LogEntryCache::GetInstance().Erase(region_id_, INT64_MIN, first_index_kept);
+  }
 
   DINGO_LOG(INFO) << fmt::format("[raft.log][region({}).index({}_{})] truncate prefix, first_index_kept: {}",
                                  region_id_, FirstLogIndex(), LastLogIndex(), first_index_kept);
@@ -999,6 +1066,13 @@ int SegmentLogStorage::TruncateVectorIndexPrefix(int64_t first_index_kept) {
 
   vector_index_first_log_index_.store(first_index_kept, std::memory_order_relaxed);
 
+  if (IndexJournalManager::IsEnabled()) {
+    auto journal = IndexJournalManager::GetInstance().GetJournal(region_id_);
+    if (journal != nullptr) {
+      journal->TruncatePrefix(first_index_kept);
+    }
+  }
+
   if (SaveMeta(first_log_index_.load(std::memory_order_relaxed)) != 0) {
     return -1;
   }
@@ -1007,8 +1081,19 @@ int SegmentLogStorage::TruncateVectorIndexPrefix(int64_t first_index_kept) {
 }
 
 int64_t SegmentLogStorage::GetMinFirstLogIndex() {
-  return std::min(first_log_index_.load(butil::memory_order_relaxed),
-                  vector_index_first_log_index_.load(butil::memory_order_relaxed));
+  int64_t vector_index_first_log_index = vector_index_first_log_index_.load(butil::memory_order_relaxed);
+
+  // the log covered by index journal is not needed by index recovery, the journal must be durable before truncate
+  auto journal =
+      IndexJournalManager::IsEnabled() ? IndexJournalManager::GetInstance().GetJournal(region_id_) : nullptr;
+  if (journal != nullptr) {
+    int64_t required_log_index = journal->RequiredRaftLogId(vector_index_first_log_index);
+    if (required_log_index > vector_index_first_log_index && journal->Sync()) {
+      vector_index_first_log_index = required_log_index;
+    }
+  }
+
+  return std::min(first_log_index_.load(butil::memory_order_relaxed), vector_index_first_log_index);
 }
 
 void SegmentLogStorage::TruncateActualPrefixLog() {
@@ -1068,6 +1153,11 @@ std::shared_ptr<Segment> SegmentLogStorage::PopSegmentsFromBack(int64_t last_ind
 int SegmentLogStorage::TruncateSuffix(int64_t last_index_kept) {
   DINGO_LOG(INFO) << fmt::format("[raft.log][region({}).index({}_{})] truncate suffix last_index_kept: {}", region_id_,
                                  FirstLogIndex(), LastLogIndex(), last_index_kept);
+  // the entries after last_index_kept will be overwritten
+  if (LogEntryCache::IsEnabled()) {
+    LogEntryCache::GetInstance().Erase(region_id_, last_index_kept + 1, INT64_MAX);
+  }
+
   // segment files
   std::vector<std::shared_ptr<Segment>> poppeds;
   std::shared_ptr<Segment> last_segment = PopSegmentsFromBack(last_index_kept, poppeds);
@@ -1135,6 +1225,10 @@ int SegmentLogStorage::Reset(int64_t next_log_index) {
   vector_index_first_log_index_.store(next_log_index, butil::memory_order_relaxed);
   last_log_index_.store(next_log_index - 1, butil::memory_order_relaxed);
   lck.unlock();
+  if (LogEntryCache::IsEnabled()) {
+    LogEntryCache::GetInstance().EraseRegion(region_id_);
+  }
+  IndexJournalManager::GetInstance().ResetJournal(region_id_, next_log_index);
   // NOTE: see the comments in truncate_prefix
   if (SaveMeta(next_log_index) != 0) {
     DINGO_LOG(ERROR) << fmt::format("[raft.log][region({}).index({}_{})] save meta failed, path: {}", region_id_,
@@ -1351,13 +1445,17 @@ int SegmentLogStorage::LoadMeta() {
   return 0;
 }
 
+int64_t SegmentLogStorage::PreallocateBytes() const {
+  return FLAGS_dingo_raft_segment_preallocate ? static_cast<int64_t>(max_segment_size_) : 0;
+}
+
 std::shared_ptr<Segment> SegmentLogStorage::OpenSegment() {
   std::shared_ptr<Segment> prev_open_segment;
   {
     BAIDU_SCOPED_LOCK(mutex_);
     if (!open_segment_) {
       open_segment_ = std::make_shared<Segment>(region_id_, path_, LastLogIndex() + 1, checksum_type_);
-      if (open_segment_->Create() != 0) {
+      if (open_segment_->Create(PreallocateBytes()) != 0) {
         open_segment_ = nullptr;
         return nullptr;
       }
@@ -1373,7 +1471,7 @@ std::shared_ptr<Segment> SegmentLogStorage::OpenSegment() {
       if (prev_open_segment->Close(enable_sync_) == 0) {
         BAIDU_SCOPED_LOCK(mutex_);
         open_segment_ = std::make_shared<Segment>(region_id_, path_, LastLogIndex() + 1, checksum_type_);
-        if (open_segment_->Create() == 0) {
+        if (open_segment_->Create(PreallocateBytes()) == 0) {
           // success
           break;
         }
@@ -1472,6 +1570,9 @@ butil::Status SegmentLogStorage::GcInstance(const std::string& uri) {
     status.set_error(EINVAL, "gc log storage failed path %s", uri.c_str());
     return status;
   }
+  if (LogEntryCache::IsEnabled()) {
+    LogEntryCache::GetInstance().EraseRegion(region_id_);
+  }
   DINGO_LOG(INFO) << fmt::format("[raft.log][region({}).index({}_{})] gc log storage success, path: {}", region_id_,
                                  FirstLogIndex(), LastLogIndex(), uri);
   return status;
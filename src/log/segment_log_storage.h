@@ -71,8 +71,8 @@ class BAIDU_CACHELINE_ALIGNMENT Segment {
 
   struct EntryHeader;
 
-  // Create open segment
-  int Create();
+  // Create open segment, preallocate_bytes > 0 allocate disk space in advance and keep file size.
+  int Create(int64_t preallocate_bytes = 0);
 
   // load open or closed segment
   // open fd, load index, truncate uncompleted entry
@@ -125,6 +125,7 @@ class BAIDU_CACHELINE_ALIGNMENT Segment {
   std::string path_;
   int64_t bytes_;
   int64_t unsynced_bytes_;
+  int64_t preallocated_bytes_{0};
   mutable bthread::Mutex mutex_;
 
   int fd_;
@@ -211,11 +212,14 @@ class SegmentLogStorage {
 
  private:
   std::shared_ptr<Segment> OpenSegment();
+  int64_t PreallocateBytes() const;
   int SaveMeta(int64_t log_index);
   int LoadMeta();
   int ListSegments(bool is_empty);
   int LoadSegments(braft::ConfigurationManager* configuration_manager);
   std::shared_ptr<Segment> GetSegment(int64_t log_index);
+  // read from log entry cache first
+  braft::LogEntry* GetEntryFromSegment(const std::shared_ptr<Segment>& segment, int64_t index);
   std::vector<std::shared_ptr<Segment>> GetSegments(uint64_t begin_index, uint64_t end_index);
   void PopSegments(int64_t first_index_kept, std::vector<std::shared_ptr<Segment>>& poppeds);
   std::shared_ptr<Segment> PopSegmentsFromBack(int64_t last_index_kept, std::vector<std::shared_ptr<Segment>>& poppeds);
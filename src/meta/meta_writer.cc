@@ -14,16 +14,32 @@
 
 #include "meta/meta_writer.h"
 
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "bvar/reducer.h"
 #include "common/constant.h"
 #include "common/helper.h"
 #include "common/logging.h"
+#include "gflags/gflags.h"
 #include "proto/common.pb.h"
 
 namespace dingodb {
 
+DEFINE_bool(enable_meta_write_batch, false, "enable coalesce the lazy meta writes and flush them in batch");
+DEFINE_int64(meta_write_batch_interval_ms, 1000, "meta write batch flush interval");
+
+bvar::Adder<int64_t> g_meta_write_lazy_count("dingo_meta_write_lazy_count");
+bvar::Adder<int64_t> g_meta_write_flush_kv_count("dingo_meta_write_flush_kv_count");
+
+bool MetaWriter::IsBatchEnabled() { return FLAGS_enable_meta_write_batch; }
+
 bool MetaWriter::Put(const std::shared_ptr<pb::common::KeyValue> kv) {
   if (kv == nullptr) return true;
   DINGO_LOG(DEBUG) << "Put meta data, key: " << kv->key();
+  EraseDirty(kv->key(), kv->key());
   auto status = engine_->Writer()->KvPut(Constant::kStoreMetaCF, *kv);
   if (status.error_code() == pb::error::Errno::EINTERNAL) {
     DINGO_LOG(FATAL) << "KvPut failed, errcode: " << status.error_code() << " " << status.error_str()
@@ -41,6 +57,9 @@ bool MetaWriter::Put(const std::shared_ptr<pb::common::KeyValue> kv) {
 bool MetaWriter::Put(const std::vector<pb::common::KeyValue> kvs) {
   DINGO_LOG(DEBUG) << "Put meta data, key nums: " << kvs.size();
   if (kvs.empty()) return true;
+  for (const auto& kv : kvs) {
+    EraseDirty(kv.key(), kv.key());
+  }
   auto status = engine_->Writer()->KvBatchPutAndDelete(Constant::kStoreMetaCF, kvs, {});
   if (status.error_code() == pb::error::Errno::EINTERNAL) {
     DINGO_LOG(FATAL) << "KvBatchPut failed, errcode: " << status.error_code() << " " << status.error_str();
@@ -56,6 +75,12 @@ bool MetaWriter::Put(const std::vector<pb::common::KeyValue> kvs) {
 bool MetaWriter::PutAndDelete(std::vector<pb::common::KeyValue> kvs_to_put, std::vector<std::string> keys_to_delete) {
   DINGO_LOG(DEBUG) << "PutAndDelete meta data, key_put nums: " << kvs_to_put.size()
                    << " key_delete nums:" << keys_to_delete.size();
+  for (const auto& kv : kvs_to_put) {
+    EraseDirty(kv.key(), kv.key());
+  }
+  for (const auto& key : keys_to_delete) {
+    EraseDirty(key, key);
+  }
   auto status = engine_->Writer()->KvBatchPutAndDelete(Constant::kStoreMetaCF, kvs_to_put, keys_to_delete);
   if (status.error_code() == pb::error::Errno::EINTERNAL) {
     DINGO_LOG(FATAL) << "KvBatchPutAndDelete failed, errcode: " << status.error_code() << " " << status.error_str()
@@ -73,6 +98,7 @@ bool MetaWriter::PutAndDelete(std::vector<pb::common::KeyValue> kvs_to_put, std:
 
 bool MetaWriter::Delete(const std::string& key) {
   DINGO_LOG(DEBUG) << "Delete meta data, key: " << key;
+  EraseDirty(key, key);
   auto status = engine_->Writer()->KvDelete(Constant::kStoreMetaCF, key);
   if (status.error_code() == pb::error::Errno::EINTERNAL) {
     DINGO_LOG(FATAL) << "KvDelete failed, errcode: " << status.error_code() << " " << status.error_str()
@@ -88,6 +114,7 @@ bool MetaWriter::Delete(const std::string& key) {
 
 bool MetaWriter::DeleteRange(const std::string& start_key, const std::string& end_key) {
   DINGO_LOG(DEBUG) << "DeleteRange meta data, start_key: " << start_key << " end_key: " << end_key;
+  EraseDirty(start_key, end_key);
   pb::common::Range range;
   range.set_start_key(start_key);
   range.set_end_key(end_key);
@@ -113,6 +140,7 @@ bool MetaWriter::DeletePrefix(const std::string& prefix) {
 
   std::string end_key = Helper::PrefixNext(prefix);  // end_key = prefix + 1
   range.set_end_key(end_key);
+  EraseDirty(prefix, end_key);
 
   DINGO_LOG(INFO) << "DeletePrefix meta data, start_key: " << Helper::StringToHex(range.start_key())
                   << " end_key: " << Helper::StringToHex(range.end_key());
@@ -131,4 +159,68 @@ bool MetaWriter::DeletePrefix(const std::string& prefix) {
   return true;
 }
 
+bool MetaWriter::PutLazy(std::shared_ptr<pb::common::KeyValue> kv) {
+  if (kv == nullptr) return true;
+  if (!IsBatchEnabled()) {
+    return Put(kv);
+  }
+
+  BAIDU_SCOPED_LOCK(mutex_);
+  dirty_kvs_.insert_or_assign(kv->key(), kv->value());
+  g_meta_write_lazy_count << 1;
+
+  return true;
+}
+
+bool MetaWriter::Flush() {
+  // hold lock until written, the write through of the same key wait for it.
+  BAIDU_SCOPED_LOCK(mutex_);
+  if (dirty_kvs_.empty()) return true;
+
+  std::vector<pb::common::KeyValue> kvs;
+  kvs.reserve(dirty_kvs_.size());
+  for (auto& [key, value] : dirty_kvs_) {
+    pb::common::KeyValue kv;
+    kv.set_key(key);
+    kv.set_value(std::move(value));
+    kvs.push_back(std::move(kv));
+  }
+  dirty_kvs_.clear();
+
+  DINGO_LOG(DEBUG) << "Flush meta data, key nums: " << kvs.size();
+  auto status = engine_->Writer()->KvBatchPutAndDelete(Constant::kStoreMetaCF, kvs, {});
+  if (status.error_code() == pb::error::Errno::EINTERNAL) {
+    DINGO_LOG(FATAL) << "Flush meta failed, errcode: " << status.error_code() << " " << status.error_str()
+                     << ", put_count: " << kvs.size();
+  }
+  if (!status.ok()) {
+    DINGO_LOG(ERROR) << "Meta flush failed, errcode: " << status.error_code() << " " << status.error_str();
+    return false;
+  }
+  g_meta_write_flush_kv_count << kvs.size();
+
+  return true;
+}
+
+int64_t MetaWriter::DirtyCount() {
+  BAIDU_SCOPED_LOCK(mutex_);
+  return dirty_kvs_.size();
+}
+
+void MetaWriter::EraseDirty(const std::string& start_key, const std::string& end_key) {
+  BAIDU_SCOPED_LOCK(mutex_);
+  if (dirty_kvs_.empty()) return;
+
+  // single key when start_key equal end_key, otherwise [start_key, end_key)
+  if (start_key == end_key) {
+    dirty_kvs_.erase(start_key);
+    return;
+  }
+  auto end_it = end_key.empty() ? dirty_kvs_.end() : dirty_kvs_.lower_bound(end_key);
+  auto start_it = dirty_kvs_.lower_bound(start_key);
+  if (end_key.empty() || start_key < end_key) {
+    dirty_kvs_.erase(start_it, end_it);
+  }
+}
+
 }  // namespace dingodb
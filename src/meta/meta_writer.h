@@ -15,14 +15,22 @@
 #ifndef DINGODB_META_META_WRITER_H_
 #define DINGODB_META_META_WRITER_H_
 
+#include <cstdint>
+#include <map>
 #include <memory>
+#include <string>
 #include <vector>
 
+#include "bthread/mutex.h"
 #include "engine/raw_engine.h"
 #include "proto/common.pb.h"
 
 namespace dingodb {
 
+// Persist meta data to the meta column family.
+// Put/Delete write through at once. PutLazy only marks the key dirty when meta write batch is enabled, the dirty
+// keys are coalesced(the last value wins) and written by Flush in one batch, so it is only for the meta which can
+// be lost in crash, e.g. the periodic applied index or region metrics.
 class MetaWriter {
  public:
   MetaWriter(std::shared_ptr<RawEngine> engine) : engine_(engine) {}
@@ -38,8 +46,22 @@ class MetaWriter {
   bool DeleteRange(const std::string &start_key, const std::string &end_key);
   bool DeletePrefix(const std::string &prefix);
 
+  bool PutLazy(std::shared_ptr<pb::common::KeyValue> kv);
+  // Write all dirty keys in one batch.
+  bool Flush();
+  int64_t DirtyCount();
+
+  static bool IsBatchEnabled();
+
  private:
+  // the write through operation overwrite the dirty value, and must not be overwritten by the flush in progress.
+  void EraseDirty(const std::string &start_key, const std::string &end_key);
+
   std::shared_ptr<RawEngine> engine_;
+
+  // protect dirty_kvs_ and serialize Flush with write through of the dirty keys.
+  bthread::Mutex mutex_;
+  std::map<std::string, std::string> dirty_kvs_;
 };
 
 using MetaWriterPtr = std::shared_ptr<MetaWriter>;
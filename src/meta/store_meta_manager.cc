@@ -30,6 +30,7 @@
 #include "common/role.h"
 #include "common/synchronization.h"
 #include "config/config_helper.h"
+#include "engine/flushed_applied_index_tracker.h"
 #include "fmt/core.h"
 #include "proto/common.pb.h"
 #include "proto/coordinator.pb.h"
@@ -298,6 +299,11 @@ int64_t Region::PartitionId() {
   return inner_region_.definition().part_id();
 }
 
+int64_t Region::TenantId() {
+  BAIDU_SCOPED_LOCK(mutex_);
+  return inner_region_.definition().tenant_id();
+}
+
 int64_t Region::SnapshotEpochVersion() {
   BAIDU_SCOPED_LOCK(mutex_);
   return inner_region_.snapshot_epoch_version();
@@ -629,7 +635,8 @@ void RegionChangeRecorder::Upsert(const pb::store_internal::RegionChangeRecord&
 
 void RegionChangeRecorder::Save(const pb::store_internal::RegionChangeRecord& record) {
   if (record.job_id() > 0) {
-    meta_writer_->Put({TransformToKv(record)});
+    // change record is only for trace, not need write through.
+    meta_writer_->PutLazy(TransformToKv(record));
   }
 }
 
@@ -1080,6 +1087,13 @@ bool StoreRaftMeta::Init() {
   if (!kvs.empty()) {
     TransformFromKv(kvs);
   }
+
+  // data wal disabled, the applied index is persisted only after its data flushed.
+  if (FlushedAppliedIndexTracker::IsEnabled()) {
+    FlushedAppliedIndexTracker::GetInstance().SetPersistFunc(
+        [this](int64_t region_id, int64_t term, int64_t applied_id) { SaveRaftMeta(region_id, term, applied_id); });
+  }
+
   return true;
 }
 
@@ -1098,13 +1112,17 @@ void StoreRaftMeta::AddRaftMeta(store::RaftMetaPtr raft_meta) {
   meta_writer_->Put(TransformToKv(raft_meta));
 }
 
-void StoreRaftMeta::UpdateRaftMeta(store::RaftMetaPtr raft_meta) {
+void StoreRaftMeta::UpdateRaftMeta(store::RaftMetaPtr raft_meta, bool lazy) {
   {
     BAIDU_SCOPED_LOCK(mutex_);
     raft_metas_.insert_or_assign(raft_meta->RegionId(), raft_meta);
   }
 
-  meta_writer_->Put(TransformToKv(raft_meta));
+  if (lazy) {
+    meta_writer_->PutLazy(TransformToKv(raft_meta));
+  } else {
+    meta_writer_->Put(TransformToKv(raft_meta));
+  }
 }
 
 void StoreRaftMeta::SaveRaftMeta(int64_t region_id) {
@@ -1114,12 +1132,29 @@ void StoreRaftMeta::SaveRaftMeta(int64_t region_id) {
   }
 }
 
+void StoreRaftMeta::SaveRaftMeta(int64_t region_id, int64_t term, int64_t applied_id) {
+  auto raft_meta = store::RaftMeta::New(region_id);
+  raft_meta->SetTermAndAppliedId(term, applied_id);
+
+  // Hold lock, avoid write back the raft meta of deleted region.
+  BAIDU_SCOPED_LOCK(mutex_);
+  if (raft_metas_.find(region_id) == raft_metas_.end()) {
+    return;
+  }
+
+  meta_writer_->Put(TransformToKv(raft_meta));
+}
+
 void StoreRaftMeta::DeleteRaftMeta(int64_t region_id) {
   {
     BAIDU_SCOPED_LOCK(mutex_);
     raft_metas_.erase(region_id);
   }
 
+  if (FlushedAppliedIndexTracker::IsEnabled()) {
+    FlushedAppliedIndexTracker::GetInstance().Erase(region_id);
+  }
+
   meta_writer_->Delete(GenKey(region_id));
 }
 
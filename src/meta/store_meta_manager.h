@@ -41,6 +41,7 @@
 #include "proto/node.pb.h"
 #include "proto/raft.pb.h"
 #include "proto/store_internal.pb.h"
+#include "split/region_load_stats.h"
 
 namespace dingodb {
 
@@ -55,6 +56,7 @@ class Region {
   struct Statistics {
     std::atomic<int32_t> serving_request_count{0};
     std::atomic<int64_t> last_serving_time_s{0};
+    std::atomic<int64_t> served_request_count{0};
   };
 
   Region(int64_t region_id);
@@ -128,6 +130,7 @@ class Region {
   void SetParentId(int64_t region_id);
 
   int64_t PartitionId();
+  int64_t TenantId();
 
   int64_t SnapshotEpochVersion();
 
@@ -163,6 +166,11 @@ class Region {
     statistics_.last_serving_time_s.store(Helper::Timestamp(), std::memory_order_relaxed);
   }
 
+  int64_t GetServedRequestCount() const { return statistics_.served_request_count.load(std::memory_order_relaxed); }
+  void IncServedRequestCount() { statistics_.served_request_count.fetch_add(1, std::memory_order_relaxed); }
+
+  RegionLoadStats& LoadStats() { return load_stats_; }
+
  private:
   bthread_mutex_t mutex_;
   pb::store_internal::Region inner_region_;
@@ -177,6 +185,9 @@ class Region {
   Latches latches_;
 
   Statistics statistics_;
+
+  // request load for load based split
+  RegionLoadStats load_stats_;
 };
 
 using RegionPtr = std::shared_ptr<Region>;
@@ -353,8 +364,11 @@ class StoreRaftMeta : public TransformKvAble {
   bool Init();
 
   void AddRaftMeta(store::RaftMetaPtr raft_meta);
-  void UpdateRaftMeta(store::RaftMetaPtr raft_meta);
+  // lazy is for the periodic applied index, which is allowed to lag behind since the apply is idempotent.
+  void UpdateRaftMeta(store::RaftMetaPtr raft_meta, bool lazy = false);
   void SaveRaftMeta(int64_t region_id);
+  // Persist the given applied index, not change the memory raft meta.
+  void SaveRaftMeta(int64_t region_id, int64_t term, int64_t applied_id);
   void DeleteRaftMeta(int64_t region_id);
   store::RaftMetaPtr GetRaftMeta(int64_t region_id);
   std::vector<store::RaftMetaPtr> GetAllRaftMeta();
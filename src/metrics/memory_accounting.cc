@@ -0,0 +1,169 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "metrics/memory_accounting.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "common/logging.h"
+#include "document/document_index_memory_manager.h"
+#include "fmt/core.h"
+#include "gflags/gflags.h"
+#include "log/log_entry_cache.h"
+#include "proto/common.pb.h"
+#include "server/server.h"
+
+#ifdef LINK_TCMALLOC
+#include "gperftools/malloc_extension.h"
+#endif
+
+DEFINE_int64(vector_index_memory_limit_bytes, 0, "memory limit of all vector indexes, 0 is no limit");
+DEFINE_int64(rocksdb_memory_limit_bytes, 0, "memory limit of rocksdb memtable/block cache/table reader, 0 is no limit");
+DEFINE_int64(raft_log_cache_memory_limit_bytes, 0, "memory limit of raft log entry cache, 0 is no limit");
+
+namespace dingodb {
+
+MemoryAccounting::MemoryAccounting()
+    : fragmentation_status_(
+          "dingo_memory_allocator_fragmentation_ratio",
+          [](void* arg) -> double {
+            auto* self = static_cast<MemoryAccounting*>(arg);
+            return FragmentationRatio(self->GetAllocatorStats());
+          },
+          this) {
+  for (auto& usage : usages_) {
+    usage.store(0);
+  }
+
+  for (int i = 0; i < kSubsystemNum; ++i) {
+    usage_statuses_.push_back(std::make_unique<bvar::PassiveStatus<int64_t>>(
+        fmt::format("dingo_memory_{}_bytes", SubsystemName(static_cast<Subsystem>(i))),
+        [](void* arg) -> int64_t { return static_cast<std::atomic<int64_t>*>(arg)->load(); }, &usages_[i]));
+  }
+}
+
+std::string MemoryAccounting::SubsystemName(Subsystem subsystem) {
+  switch (subsystem) {
+    case Subsystem::kVectorIndex:
+      return "vector_index";
+    case Subsystem::kDocumentIndex:
+      return "document_index";
+    case Subsystem::kRocksdb:
+      return "rocksdb";
+    case Subsystem::kRaftLogCache:
+      return "raft_log_cache";
+    default:
+      return "unknown";
+  }
+}
+
+int64_t MemoryAccounting::Limit(Subsystem subsystem) {
+  switch (subsystem) {
+    case Subsystem::kVectorIndex:
+      return FLAGS_vector_index_memory_limit_bytes;
+    case Subsystem::kDocumentIndex:
+      // document index is kept in its budget by eviction
+      return 0;
+    case Subsystem::kRocksdb:
+      return FLAGS_rocksdb_memory_limit_bytes;
+    case Subsystem::kRaftLogCache:
+      return FLAGS_raft_log_cache_memory_limit_bytes;
+    default:
+      return 0;
+  }
+}
+
+bool MemoryAccounting::IsExceedLimit(Subsystem subsystem) const {
+  int64_t limit = Limit(subsystem);
+  return limit > 0 && Usage(subsystem) > limit;
+}
+
+std::string MemoryAccounting::CheckLimit() const {
+  for (int i = 0; i < kSubsystemNum; ++i) {
+    auto subsystem = static_cast<Subsystem>(i);
+    if (IsExceedLimit(subsystem)) {
+      return fmt::format("Memory of {} exceeds limit, usage({}) limit({})", SubsystemName(subsystem),
+                         Usage(subsystem), Limit(subsystem));
+    }
+  }
+
+  return "";
+}
+
+int64_t MemoryAccounting::CollectVectorIndex() {
+  int64_t total_bytes = 0;
+  for (const auto& region : Server::GetInstance().GetAllAliveRegion()) {
+    auto vector_index_wrapper = region->VectorIndexWrapper();
+    if (vector_index_wrapper == nullptr || !vector_index_wrapper->IsReady()) {
+      continue;
+    }
+
+    int64_t memory_bytes = 0;
+    if (vector_index_wrapper->GetMemorySize(memory_bytes).ok()) {
+      total_bytes += memory_bytes;
+    }
+  }
+
+  return total_bytes;
+}
+
+int64_t MemoryAccounting::CollectRocksdb() {
+  auto raw_engine = Server::GetInstance().GetRawEngine(pb::common::RawEngine::RAW_ENG_ROCKSDB);
+  return raw_engine != nullptr ? raw_engine->GetMemoryUsage() : 0;
+}
+
+void MemoryAccounting::Collect() {
+  usages_[static_cast<int>(Subsystem::kVectorIndex)].store(CollectVectorIndex());
+  usages_[static_cast<int>(Subsystem::kDocumentIndex)].store(DocumentIndexMemoryManager::MemoryBytes());
+  usages_[static_cast<int>(Subsystem::kRocksdb)].store(CollectRocksdb());
+  usages_[static_cast<int>(Subsystem::kRaftLogCache)].store(
+      LogEntryCache::IsEnabled() ? LogEntryCache::GetInstance().MemorySize() : 0);
+
+  auto stats = GetAllocatorStats();
+  DINGO_LOG(DEBUG) << fmt::format(
+      "[metrics.memory] vector_index({}) document_index({}) rocksdb({}) raft_log_cache({}) allocated({}) heap({}) "
+      "free({}) unmapped({}) fragmentation({:.3f})",
+      Usage(Subsystem::kVectorIndex), Usage(Subsystem::kDocumentIndex), Usage(Subsystem::kRocksdb),
+      Usage(Subsystem::kRaftLogCache), stats.allocated_bytes, stats.heap_bytes, stats.free_bytes,
+      stats.unmapped_bytes, FragmentationRatio(stats));
+}
+
+MemoryAccounting::AllocatorStats MemoryAccounting::GetAllocatorStats() const {
+  AllocatorStats stats;
+#ifdef LINK_TCMALLOC
+  auto get_property = [](const char* name) -> int64_t {
+    size_t value = 0;
+    return MallocExtension::instance()->GetNumericProperty(name, &value) ? static_cast<int64_t>(value) : 0;
+  };
+  stats.allocated_bytes = get_property("generic.current_allocated_bytes");
+  stats.heap_bytes = get_property("generic.heap_size");
+  stats.free_bytes = get_property("tcmalloc.pageheap_free_bytes");
+  stats.unmapped_bytes = get_property("tcmalloc.pageheap_unmapped_bytes");
+#endif
+
+  return stats;
+}
+
+double MemoryAccounting::FragmentationRatio(const AllocatorStats& stats) {
+  int64_t mapped_bytes = stats.heap_bytes - stats.unmapped_bytes;
+  if (mapped_bytes <= 0 || stats.allocated_bytes > mapped_bytes) {
+    return 0;
+  }
+
+  return static_cast<double>(mapped_bytes - stats.allocated_bytes) / static_cast<double>(mapped_bytes);
+}
+
+}  // namespace dingodb
@@ -0,0 +1,90 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_METRICS_MEMORY_ACCOUNTING_H_
+#define DINGODB_METRICS_MEMORY_ACCOUNTING_H_
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "bvar/passive_status.h"
+
+namespace dingodb {
+
+// Memory usage of the store subsystems, collected with the store metrics.
+// The subsystems are measured by their own accounting(vector index memory size, document index estimation, rocksdb
+// memory properties, raft log cache bytes), which share the process allocator, the allocator stats(tcmalloc only)
+// tell the fragmentation, i.e. the memory held by allocator but not used by any object.
+// Every subsystem has a limit flag, 0 means no limit, the store is read only when any subsystem exceeds its limit,
+// and vector add is rejected when the vector indexes exceed theirs.
+class MemoryAccounting {
+ public:
+  enum class Subsystem {
+    kVectorIndex = 0,
+    kDocumentIndex = 1,
+    kRocksdb = 2,
+    kRaftLogCache = 3,
+  };
+  static constexpr int kSubsystemNum = 4;
+
+  struct AllocatorStats {
+    // bytes used by objects
+    int64_t allocated_bytes{0};
+    // bytes of the heap, include free and unmapped bytes
+    int64_t heap_bytes{0};
+    // free bytes held by allocator
+    int64_t free_bytes{0};
+    // bytes returned to system
+    int64_t unmapped_bytes{0};
+  };
+
+  static MemoryAccounting& GetInstance() {
+    static MemoryAccounting instance;
+    return instance;
+  }
+
+  void Collect();
+
+  int64_t Usage(Subsystem subsystem) const { return usages_[static_cast<int>(subsystem)].load(); }
+  static int64_t Limit(Subsystem subsystem);
+  bool IsExceedLimit(Subsystem subsystem) const;
+
+  // Return the reason of exceeding limit, empty when all subsystems are within their limit.
+  std::string CheckLimit() const;
+
+  AllocatorStats GetAllocatorStats() const;
+  // (heap - unmapped - allocated) / (heap - unmapped), 0 when unknown
+  static double FragmentationRatio(const AllocatorStats& stats);
+
+  static std::string SubsystemName(Subsystem subsystem);
+
+ private:
+  MemoryAccounting();
+  ~MemoryAccounting() = default;
+
+  static int64_t CollectVectorIndex();
+  static int64_t CollectRocksdb();
+
+  std::array<std::atomic<int64_t>, kSubsystemNum> usages_;
+  std::vector<std::unique_ptr<bvar::PassiveStatus<int64_t>>> usage_statuses_;
+  bvar::PassiveStatus<double> fragmentation_status_;
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_METRICS_MEMORY_ACCOUNTING_H_
@@ -0,0 +1,218 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "metrics/region_counter_metrics.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "butil/compiler_specific.h"
+#include "common/helper.h"
+#include "fmt/core.h"
+#include "gflags/gflags.h"
+
+namespace dingodb {
+
+DEFINE_bool(store_region_metrics_compact, false,
+            "use thread local aggregated compact region metrics instead of bvar multi dimension per region");
+DEFINE_int64(store_region_metrics_max_region_num, 100000,
+             "max region num of compact region metrics, the exceeded regions share one overflow slot");
+DEFINE_int64(store_region_metrics_top_n, 20, "busiest region num exposed of compact region metrics");
+DEFINE_int64(store_region_metrics_fold_interval_ms, 1000, "fold interval of compact region metrics");
+
+RegionCounterMetrics::RegionCounterMetrics()
+    : top_regions_status_("dingo_metrics_store_region_top", DumpTopRegions, this) {}
+
+bool RegionCounterMetrics::IsEnabled() { return FLAGS_store_region_metrics_compact; }
+
+RegionCounterMetrics::LocalCounters* RegionCounterMetrics::GetLocalCounters() {
+  // the local counters are owned by local_counters_, live as long as the process
+  thread_local LocalCounters* local_counters = nullptr;
+  if (BAIDU_UNLIKELY(local_counters == nullptr)) {
+    auto counters = std::make_shared<LocalCounters>();
+    std::lock_guard<bthread::Mutex> lock(mutex_);
+    local_counters_.push_back(counters);
+    local_counters = counters.get();
+  }
+
+  return local_counters;
+}
+
+void RegionCounterMetrics::Add(int64_t region_id, CounterType type, int64_t value) {
+  auto* local_counters = GetLocalCounters();
+
+  std::lock_guard<bthread::Mutex> lock(local_counters->mutex);
+  local_counters->counts[region_id][type] += value;
+}
+
+void RegionCounterMetrics::Set(int64_t region_id, GaugeType type, int64_t value) {
+  std::lock_guard<bthread::Mutex> lock(mutex_);
+  GetOrCreateRegionStat(region_id).gauges[type] = value;
+}
+
+void RegionCounterMetrics::Delete(int64_t region_id) {
+  std::lock_guard<bthread::Mutex> lock(mutex_);
+  region_stats_.erase(region_id);
+}
+
+RegionCounterMetrics::RegionStat& RegionCounterMetrics::GetOrCreateRegionStat(int64_t region_id) {
+  auto it = region_stats_.find(region_id);
+  if (it != region_stats_.end()) {
+    return it->second;
+  }
+
+  if (static_cast<int64_t>(region_stats_.size()) >= FLAGS_store_region_metrics_max_region_num) {
+    return region_stats_[kOverflowRegionId];
+  }
+
+  return region_stats_[region_id];
+}
+
+void RegionCounterMetrics::Fold() {
+  std::vector<std::shared_ptr<LocalCounters>> local_counters;
+  {
+    std::lock_guard<bthread::Mutex> lock(mutex_);
+    local_counters = local_counters_;
+  }
+
+  // swap out the thread local counters, hold their lock shortly
+  std::unordered_map<int64_t, std::array<int64_t, kCounterTypeNum>> counts;
+  for (auto& local : local_counters) {
+    std::unordered_map<int64_t, std::array<int64_t, kCounterTypeNum>> local_counts;
+    {
+      std::lock_guard<bthread::Mutex> lock(local->mutex);
+      local_counts.swap(local->counts);
+    }
+
+    for (const auto& [region_id, values] : local_counts) {
+      auto& sum = counts[region_id];
+      for (int i = 0; i < kCounterTypeNum; ++i) {
+        sum[i] += values[i];
+      }
+    }
+  }
+
+  std::lock_guard<bthread::Mutex> lock(mutex_);
+
+  int64_t now_ms = Helper::TimestampMs();
+  int64_t elapsed_ms = last_fold_time_ms_ > 0 ? std::max(now_ms - last_fold_time_ms_, static_cast<int64_t>(1)) : 0;
+  last_fold_time_ms_ = now_ms;
+
+  // the idle regions cost nothing, only reset the rate of last active regions
+  for (auto region_id : active_region_ids_) {
+    auto it = region_stats_.find(region_id);
+    if (it != region_stats_.end()) {
+      it->second.rates.fill(0);
+    }
+  }
+  active_region_ids_.clear();
+
+  for (const auto& [region_id, values] : counts) {
+    auto& stat = GetOrCreateRegionStat(region_id);
+    for (int i = 0; i < kCounterTypeNum; ++i) {
+      stat.totals[i] += values[i];
+      if (elapsed_ms > 0) {
+        stat.rates[i] += values[i] * 1000 / elapsed_ms;
+      }
+    }
+    active_region_ids_.push_back(region_id);
+  }
+  if (!counts.empty() && region_stats_.count(kOverflowRegionId) > 0) {
+    active_region_ids_.push_back(kOverflowRegionId);
+  }
+}
+
+bool RegionCounterMetrics::GetRegionStat(int64_t region_id, RegionStat& stat) {
+  std::lock_guard<bthread::Mutex> lock(mutex_);
+  auto it = region_stats_.find(region_id);
+  if (it == region_stats_.end()) {
+    return false;
+  }
+
+  stat = it->second;
+  return true;
+}
+
+int64_t RegionCounterMetrics::RegionNum() {
+  std::lock_guard<bthread::Mutex> lock(mutex_);
+  return region_stats_.size();
+}
+
+std::vector<std::pair<int64_t, int64_t>> RegionCounterMetrics::TopN(CounterType type, int64_t n) {
+  std::vector<std::pair<int64_t, int64_t>> result;
+  {
+    std::lock_guard<bthread::Mutex> lock(mutex_);
+    for (auto region_id : active_region_ids_) {
+      auto it = region_stats_.find(region_id);
+      if (it != region_stats_.end() && it->second.rates[type] > 0) {
+        result.emplace_back(region_id, it->second.rates[type]);
+      }
+    }
+  }
+
+  auto cmp = [](const auto& a, const auto& b) { return a.second > b.second; };
+  if (n >= 0 && n < static_cast<int64_t>(result.size())) {
+    std::partial_sort(result.begin(), result.begin() + n, result.end(), cmp);
+    result.resize(n);
+  } else {
+    std::sort(result.begin(), result.end(), cmp);
+  }
+
+  return result;
+}
+
+std::string RegionCounterMetrics::CounterTypeName(CounterType type) {
+  switch (type) {
+    case kCommit:
+      return "commit";
+    case kApply:
+      return "apply";
+    case kRowCacheHit:
+      return "row_cache_hit";
+    case kRowCacheMiss:
+      return "row_cache_miss";
+    default:
+      return "unknown";
+  }
+}
+
+// e.g. commit: 1001:5000 1002:3000; apply: 1001:5000 1002:3000; ...
+std::string RegionCounterMetrics::DumpTopRegions(void* arg) {
+  auto* self = static_cast<RegionCounterMetrics*>(arg);
+  if (!IsEnabled()) {
+    return "";
+  }
+
+  std::string result;
+  for (int i = 0; i < kCounterTypeNum; ++i) {
+    auto type = static_cast<CounterType>(i);
+    if (!result.empty()) {
+      result += "; ";
+    }
+    result += CounterTypeName(type) + ":";
+    for (const auto& [region_id, rate] : self->TopN(type, FLAGS_store_region_metrics_top_n)) {
+      result += fmt::format(" {}:{}", region_id, rate);
+    }
+  }
+
+  return result;
+}
+
+}  // namespace dingodb
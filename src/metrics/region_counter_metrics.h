@@ -0,0 +1,113 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef DINGODB_METRICS_REGION_COUNTER_METRICS_H_
+#define DINGODB_METRICS_REGION_COUNTER_METRICS_H_
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "bthread/mutex.h"
+#include "bvar/passive_status.h"
+
+namespace dingodb {
+
+// Compact per region metrics, replace the bvar::MultiDimension of StoreBvarMetrics when
+// store_region_metrics_compact is on, whose dimension per region costs much cpu and memory with many regions.
+// The counters are added to thread local maps, and folded into one per region array periodically, which also
+// computes the per second rate. Only the top N busiest regions are exposed, and the regions exceed
+// store_region_metrics_max_region_num share one overflow slot, so the cardinality is bounded.
+class RegionCounterMetrics {
+ public:
+  enum CounterType {
+    kCommit = 0,
+    kApply = 1,
+    kRowCacheHit = 2,
+    kRowCacheMiss = 3,
+  };
+  static constexpr int kCounterTypeNum = 4;
+
+  enum GaugeType {
+    kLeaderSwitchTime = 0,
+    kLeaderSwitchCount = 1,
+  };
+  static constexpr int kGaugeTypeNum = 2;
+
+  // the regions exceed max region num are counted to it
+  static constexpr int64_t kOverflowRegionId = 0;
+
+  struct RegionStat {
+    std::array<int64_t, kCounterTypeNum> totals{};
+    // per second rate of last fold
+    std::array<int64_t, kCounterTypeNum> rates{};
+    std::array<int64_t, kGaugeTypeNum> gauges{};
+  };
+
+  static RegionCounterMetrics& GetInstance() {
+    static RegionCounterMetrics instance;
+    return instance;
+  }
+
+  static bool IsEnabled();
+
+  void Add(int64_t region_id, CounterType type, int64_t value = 1);
+  void Set(int64_t region_id, GaugeType type, int64_t value);
+  void Delete(int64_t region_id);
+
+  // Fold the thread local counters into region stats, and update the per second rate.
+  void Fold();
+
+  bool GetRegionStat(int64_t region_id, RegionStat& stat);
+  int64_t RegionNum();
+
+  // The busiest regions order by rate of type desc, return (region_id, rate).
+  std::vector<std::pair<int64_t, int64_t>> TopN(CounterType type, int64_t n);
+
+  static std::string CounterTypeName(CounterType type);
+
+ private:
+  RegionCounterMetrics();
+  ~RegionCounterMetrics() = default;
+
+  struct LocalCounters {
+    bthread::Mutex mutex;
+    std::unordered_map<int64_t, std::array<int64_t, kCounterTypeNum>> counts;
+  };
+
+  LocalCounters* GetLocalCounters();
+  // get region stat, the overflow slot when exceed max region num, caller hold mutex_
+  RegionStat& GetOrCreateRegionStat(int64_t region_id);
+
+  static std::string DumpTopRegions(void* arg);
+
+  // Protect local_counters_/region_stats_/active_region_ids_/last_fold_time_ms_.
+  bthread::Mutex mutex_;
+  std::vector<std::shared_ptr<LocalCounters>> local_counters_;
+  std::unordered_map<int64_t, RegionStat> region_stats_;
+  // the regions have rate at last fold, reset their rate at next fold
+  std::vector<int64_t> active_region_ids_;
+  int64_t last_fold_time_ms_{0};
+
+  bvar::PassiveStatus<std::string> top_regions_status_;
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_METRICS_REGION_COUNTER_METRICS_H_
@@ -22,6 +22,7 @@
 #include "bvar/reducer.h"
 #include "bvar/status.h"
 #include "common/helper.h"
+#include "metrics/region_counter_metrics.h"
 
 namespace dingodb {
 
@@ -31,7 +32,9 @@ class StoreBvarMetrics {
       : leader_switch_time_("dingo_metrics_store_raft_leader_switch_time", {"region"}),
         leader_switch_count_("dingo_metrics_store_raft_leader_switch_count", {"region"}),
         commit_count_per_second_("dingo_metrics_store_raft_commit_count_per_second", {"region"}),
-        apply_count_per_second_("dingo_metrics_store_raft_apply_count_per_second", {"region"}) {}
+        apply_count_per_second_("dingo_metrics_store_raft_apply_count_per_second", {"region"}),
+        row_cache_hit_count_("dingo_metrics_store_row_cache_hit_count", {"region"}),
+        row_cache_miss_count_("dingo_metrics_store_row_cache_miss_count", {"region"}) {}
   ~StoreBvarMetrics() = default;
 
   StoreBvarMetrics(const StoreBvarMetrics&) = delete;
@@ -40,6 +43,11 @@ class StoreBvarMetrics {
   static StoreBvarMetrics& GetInstance();
 
   void UpdateLeaderSwitchTime(std::string region_id) {
+    if (RegionCounterMetrics::IsEnabled()) {
+      RegionCounterMetrics::GetInstance().Set(Helper::StringToInt64(region_id), RegionCounterMetrics::kLeaderSwitchTime,
+                                              Helper::TimestampMs());
+      return;
+    }
     auto* region_stat = leader_switch_time_.get_stats({region_id});
     if (region_stat != nullptr) {
       region_stat->set_value(Helper::TimestampMs());
@@ -47,6 +55,11 @@ class StoreBvarMetrics {
   }
 
   void UpdateLeaderSwitchCount(std::string region_id, int64_t value) {
+    if (RegionCounterMetrics::IsEnabled()) {
+      RegionCounterMetrics::GetInstance().Set(Helper::StringToInt64(region_id),
+                                              RegionCounterMetrics::kLeaderSwitchCount, value);
+      return;
+    }
     auto* region_stat = leader_switch_count_.get_stats({region_id});
     if (region_stat != nullptr) {
       region_stat->set_value(value);
@@ -54,6 +67,10 @@ class StoreBvarMetrics {
   }
 
   void IncCommitCountPerSecond(std::string region_id) {
+    if (RegionCounterMetrics::IsEnabled()) {
+      RegionCounterMetrics::GetInstance().Add(Helper::StringToInt64(region_id), RegionCounterMetrics::kCommit);
+      return;
+    }
     auto* region_stat = commit_count_per_second_.get_stats({region_id});
     if (region_stat != nullptr) {
       *region_stat << 1;
@@ -61,13 +78,40 @@ class StoreBvarMetrics {
   }
 
   void IncApplyCountPerSecond(std::string region_id) {
+    if (RegionCounterMetrics::IsEnabled()) {
+      RegionCounterMetrics::GetInstance().Add(Helper::StringToInt64(region_id), RegionCounterMetrics::kApply);
+      return;
+    }
     auto* region_stat = apply_count_per_second_.get_stats({region_id});
     if (region_stat != nullptr) {
       *region_stat << 1;
     }
   }
 
+  void IncRowCacheHitCount(std::string region_id) {
+    if (RegionCounterMetrics::IsEnabled()) {
+      RegionCounterMetrics::GetInstance().Add(Helper::StringToInt64(region_id), RegionCounterMetrics::kRowCacheHit);
+      return;
+    }
+    auto* region_stat = row_cache_hit_count_.get_stats({region_id});
+    if (region_stat != nullptr) {
+      *region_stat << 1;
+    }
+  }
+
+  void IncRowCacheMissCount(std::string region_id) {
+    if (RegionCounterMetrics::IsEnabled()) {
+      RegionCounterMetrics::GetInstance().Add(Helper::StringToInt64(region_id), RegionCounterMetrics::kRowCacheMiss);
+      return;
+    }
+    auto* region_stat = row_cache_miss_count_.get_stats({region_id});
+    if (region_stat != nullptr) {
+      *region_stat << 1;
+    }
+  }
+
   void DeleteMetrics(std::string region_id) {
+    RegionCounterMetrics::GetInstance().Delete(Helper::StringToInt64(region_id));
     if (leader_switch_time_.has_stats({region_id})) {
       leader_switch_time_.delete_stats({region_id});
     }
@@ -80,6 +124,12 @@ class StoreBvarMetrics {
     if (apply_count_per_second_.has_stats({region_id})) {
       apply_count_per_second_.delete_stats({region_id});
     }
+    if (row_cache_hit_count_.has_stats({region_id})) {
+      row_cache_hit_count_.delete_stats({region_id});
+    }
+    if (row_cache_miss_count_.has_stats({region_id})) {
+      row_cache_miss_count_.delete_stats({region_id});
+    }
   }
 
  private:
@@ -87,6 +137,8 @@ class StoreBvarMetrics {
   bvar::MultiDimension<bvar::Status<int64_t>> leader_switch_count_;
   bvar::MultiDimension<bvar::PerSecondEx<bvar::Adder<int64_t>>> commit_count_per_second_;
   bvar::MultiDimension<bvar::PerSecondEx<bvar::Adder<int64_t>>> apply_count_per_second_;
+  bvar::MultiDimension<bvar::Adder<int64_t>> row_cache_hit_count_;
+  bvar::MultiDimension<bvar::Adder<int64_t>> row_cache_miss_count_;
 };
 
 }  // namespace dingodb
@@ -14,6 +14,7 @@
 
 #include "metrics/store_metrics_manager.h"
 
+#include <algorithm>
 #include <cstdint>
 #include <memory>
 #include <string>
@@ -22,14 +23,18 @@
 
 #include "bthread/bthread.h"
 #include "butil/scoped_lock.h"
+#include "bvar/reducer.h"
+#include "bvar/status.h"
 #include "common/constant.h"
 #include "common/helper.h"
 #include "common/logging.h"
 #include "config/config_manager.h"
 #include "fmt/core.h"
 #include "gflags/gflags.h"
+#include "metrics/memory_accounting.h"
 #include "proto/common.pb.h"
 #include "server/server.h"
+#include "split/region_load_stats.h"
 
 namespace dingodb {
 
@@ -38,6 +43,14 @@ DEFINE_double(min_system_memory_capacity_free_ratio, 0.10, "Min system memory ca
 DEFINE_bool(enable_region_metrics_collect_key_count, false, "Enable region metrics collect key count");
 DEFINE_bool(enable_region_metrics_collect_key_max, false, "Enable region metrics collect key max");
 DEFINE_bool(enable_region_metrics_collect_key_min, false, "Enable region metrics collect key min");
+DEFINE_int32(region_hot_key_report_num, 8, "report top hot key number of every region");
+DEFINE_bool(enable_region_incremental_key_count, false,
+            "maintain region key count in raft apply instead of counting, the count is verified periodically");
+DEFINE_int64(region_key_count_verify_interval_s, 3600, "verify the incremental region key count interval seconds");
+
+static bvar::Adder<int64_t> g_region_key_count_drift_count("dingo_region_key_count_drift_count");
+
+static bvar::Status<double> bvar_vector_index_deleted_ratio("dingo_vector_index_deleted_ratio", 0.0);
 
 namespace store {
 
@@ -102,6 +115,51 @@ void RegionMetrics::UpdateMaxAndMinKeyPolicy() {
   need_update_max_key_ = true;
 }
 
+void RegionMetrics::AddKeyCountDelta(int64_t delta, int64_t log_id) {
+  BAIDU_SCOPED_LOCK(mutex_);
+  key_count_log_index_ = std::max(key_count_log_index_, log_id);
+  inner_region_metrics_.set_row_count(inner_region_metrics_.row_count() + delta);
+}
+
+bool RegionMetrics::GetTrustedKeyCount(int64_t& key_count) {
+  BAIDU_SCOPED_LOCK(mutex_);
+  if (!key_count_trusted_) {
+    return false;
+  }
+
+  key_count = inner_region_metrics_.row_count();
+  return true;
+}
+
+bool RegionMetrics::VerifyKeyCount(int64_t key_count, int64_t applied_index) {
+  BAIDU_SCOPED_LOCK(mutex_);
+  if (key_count_log_index_ > applied_index) {
+    return false;
+  }
+
+  if (key_count_trusted_ && inner_region_metrics_.row_count() != key_count) {
+    DINGO_LOG(WARNING) << fmt::format("[metrics.region][region({})] key count drift, incremental({}) actual({})",
+                                      inner_region_metrics_.id(), inner_region_metrics_.row_count(), key_count);
+    g_region_key_count_drift_count << 1;
+  }
+
+  inner_region_metrics_.set_row_count(key_count);
+  key_count_trusted_ = true;
+  key_count_verify_time_ms_ = Helper::TimestampMs();
+  return true;
+}
+
+void RegionMetrics::InvalidateKeyCount(int64_t log_id) {
+  BAIDU_SCOPED_LOCK(mutex_);
+  key_count_log_index_ = std::max(key_count_log_index_, log_id);
+  key_count_trusted_ = false;
+}
+
+int64_t RegionMetrics::KeyCountVerifyTimeMs() {
+  BAIDU_SCOPED_LOCK(mutex_);
+  return key_count_verify_time_ms_;
+}
+
 }  // namespace store
 
 bool StoreMetrics::Init() { return CollectMetrics(); }
@@ -131,6 +189,9 @@ bool StoreMetrics::CollectMetrics() {
     return false;
   }
 
+  // subsystem memory info
+  MemoryAccounting::GetInstance().Collect();
+
   {
     BAIDU_SCOPED_LOCK(mutex_);
     // system disk capacity
@@ -183,6 +244,13 @@ bool StoreMetrics::CollectMetrics() {
       }
     }
 
+    std::string memory_limit_reason = MemoryAccounting::GetInstance().CheckLimit();
+    if (!memory_limit_reason.empty()) {
+      DINGO_LOG(WARNING) << memory_limit_reason;
+      self_store_is_read_only = true;
+      read_only_reason = memory_limit_reason;
+    }
+
     metrics_.mutable_store_own_metrics()->set_is_ready_only(self_store_is_read_only);
     metrics_.mutable_store_own_metrics()->set_read_only_reason(read_only_reason);
   }
@@ -506,7 +574,20 @@ bool StoreRegionMetrics::CollectMetrics() {
     }
 
     // Get region key counts
-    if (FLAGS_enable_region_metrics_collect_key_count) {
+    if (FLAGS_enable_region_incremental_key_count &&
+        region->GetStoreEngineType() == pb::common::STORE_ENG_RAFT_STORE) {
+      int64_t key_count = 0;
+      if (!region_metrics->GetTrustedKeyCount(key_count) ||
+          Helper::TimestampMs() - region_metrics->KeyCountVerifyTimeMs() >=
+              FLAGS_region_key_count_verify_interval_s * 1000) {
+        // the applied index must be read before counting
+        int64_t verify_applied_index = raft_meta->AppliedId();
+        if (!region_metrics->VerifyKeyCount(GetRegionKeyCount(region), verify_applied_index)) {
+          DINGO_LOG(INFO) << fmt::format("[metrics.region][region({})] verify key count conflict with write.",
+                                         region->Id());
+        }
+      }
+    } else if (FLAGS_enable_region_metrics_collect_key_count) {
       if (region_metrics->NeedUpdateKeyCount()) {
         region_metrics->SetKeyCount(GetRegionKeyCount(region));
       } else {
@@ -568,8 +649,18 @@ bool StoreRegionMetrics::CollectMetrics() {
           Helper::TimestampMs() - start_time);
     }
 
-    meta_writer_->Put(TransformToKv(region_metrics));
+    meta_writer_->PutLazy(TransformToKv(region_metrics));
+  }
+
+  // tombstone ratio of all vector index, deleted vectors still occupy slots of index
+  int64_t total_vector_count = 0;
+  int64_t total_deleted_count = 0;
+  for (const auto& region_metrics : region_metricses) {
+    total_vector_count += region_metrics->GetVectorCurrentCount();
+    total_deleted_count += region_metrics->GetVectorDeletedCount();
   }
+  bvar_vector_index_deleted_ratio.set_value(
+      total_vector_count > 0 ? static_cast<double>(total_deleted_count) / total_vector_count : 0.0);
 
   return true;
 }
@@ -686,7 +777,47 @@ void StoreMetricsManager::CollectStoreRegionMetrics() {
 
   region_metrics_->CollectMetrics();
 
+  if (RegionLoadStats::IsHotKeyEnabled()) {
+    CollectRegionHotKeys();
+  }
+
   is_collecting_.store(false);
 }
 
+static std::string FormatHotKeyItems(const std::vector<HotKeySketch::Item>& items) {
+  std::string result;
+  for (const auto& item : items) {
+    result += fmt::format(" {}:{}", Helper::StringToHex(item.key), item.count);
+  }
+  return result;
+}
+
+void StoreMetricsManager::CollectRegionHotKeys() {
+  uint32_t report_num = std::max(FLAGS_region_hot_key_report_num, 1);
+
+  std::string region_hot_keys;
+  auto regions = GET_STORE_REGION_META->GetAllAliveRegion();
+  for (auto& region : regions) {
+    auto hot_keys = region->LoadStats().TakeHotKeys(report_num);
+    if (hot_keys.keys.empty()) {
+      continue;
+    }
+
+    region_hot_keys += fmt::format("region({}) keys:{} prefixes:{}\n", region->Id(), FormatHotKeyItems(hot_keys.keys),
+                                   FormatHotKeyItems(hot_keys.prefixes));
+  }
+
+  BAIDU_SCOPED_LOCK(hot_keys_mutex_);
+  region_hot_keys_.swap(region_hot_keys);
+}
+
+std::string StoreMetricsManager::GetRegionHotKeys() {
+  BAIDU_SCOPED_LOCK(hot_keys_mutex_);
+  return region_hot_keys_;
+}
+
+std::string StoreMetricsManager::DumpRegionHotKeys(void* arg) {
+  return static_cast<StoreMetricsManager*>(arg)->GetRegionHotKeys();
+}
+
 }  // namespace dingodb
\ No newline at end of file
@@ -25,6 +25,7 @@
 
 #include "bthread/types.h"
 #include "butil/scoped_lock.h"
+#include "bvar/passive_status.h"
 #include "common/constant.h"
 #include "engine/engine.h"
 #include "meta/meta_reader.h"
@@ -60,6 +61,8 @@ class RegionMetrics {
     // UpdateMaxAndMinKeyPolicy
     need_update_min_key_ = true;
     need_update_max_key_ = true;
+
+    key_count_trusted_ = false;
   }
 
   int64_t LastLogIndex() {
@@ -274,6 +277,17 @@ class RegionMetrics {
   void UpdateMaxAndMinKeyPolicy(const PbRanges& ranges);
   void UpdateMaxAndMinKeyPolicy();
 
+  // The key count of data cf is maintained by the raft apply handlers, the delta of a log is added before its write.
+  // It's trusted after verified by a full count, a verification is discarded when a delta of the log after the
+  // applied index read before counting is added, because the write may be counted twice.
+  void AddKeyCountDelta(int64_t delta, int64_t log_id);
+  // Return false if the key count is not trusted.
+  bool GetTrustedKeyCount(int64_t& key_count);
+  bool VerifyKeyCount(int64_t key_count, int64_t applied_index);
+  // e.g. the data is replaced by snapshot at log_id, the verification before it is discarded.
+  void InvalidateKeyCount(int64_t log_id);
+  int64_t KeyCountVerifyTimeMs();
+
  private:
   // update metrics until raft log index
   int64_t last_log_index_{0};
@@ -286,6 +300,12 @@ class RegionMetrics {
   // need update region key count
   bool need_update_key_count_{true};
 
+  // incremental key count is verified, it's not trusted after restart because the replayed log is counted again
+  bool key_count_trusted_{false};
+  // the max log index which delta is added
+  int64_t key_count_log_index_{0};
+  int64_t key_count_verify_time_ms_{0};
+
   pb::common::RegionMetrics inner_region_metrics_;
   // protect inner_region_metrics_
   bthread_mutex_t mutex_;
@@ -375,8 +395,11 @@ class StoreMetricsManager {
         is_collecting_store_(false),
         is_collecting_approximate_size_(false),
         store_metrics_(std::make_shared<StoreMetrics>()),
-        region_metrics_(std::make_shared<StoreRegionMetrics>(meta_reader, meta_writer, engine)) {}
-  ~StoreMetricsManager() = default;
+        region_metrics_(std::make_shared<StoreRegionMetrics>(meta_reader, meta_writer, engine)),
+        region_hot_keys_metrics_("dingo_store_region_hot_keys", DumpRegionHotKeys, this) {
+    bthread_mutex_init(&hot_keys_mutex_, nullptr);
+  }
+  ~StoreMetricsManager() { bthread_mutex_destroy(&hot_keys_mutex_); }
 
   StoreMetricsManager(const StoreMetricsManager&) = delete;
   void operator=(const StoreMetricsManager&) = delete;
@@ -390,13 +413,24 @@ class StoreMetricsManager {
   std::shared_ptr<StoreMetrics> GetStoreMetrics() { return store_metrics_; }
   std::shared_ptr<StoreRegionMetrics> GetStoreRegionMetrics() { return region_metrics_; }
 
+  // Hot keys and prefixes of regions in the last collect, one region per line.
+  std::string GetRegionHotKeys();
+
  private:
+  void CollectRegionHotKeys();
+  static std::string DumpRegionHotKeys(void* arg);
+
   // Is collecting metrics, just one collecting at the same time.
   std::atomic<bool> is_collecting_;
   std::atomic<bool> is_collecting_store_;
   std::atomic<bool> is_collecting_approximate_size_;
   std::shared_ptr<StoreMetrics> store_metrics_;
   std::shared_ptr<StoreRegionMetrics> region_metrics_;
+
+  // Protect region_hot_keys_.
+  bthread_mutex_t hot_keys_mutex_;
+  std::string region_hot_keys_;
+  bvar::PassiveStatus<std::string> region_hot_keys_metrics_;
 };
 
 }  // namespace dingodb
@@ -18,18 +18,34 @@
 #include <braft/storage.h>        // braft::SnapshotWriter
 #include <braft/util.h>           // braft::AsyncClosureGuard
 
+#include <algorithm>
 #include <cstdint>
 #include <memory>
+#include <string>
+#include <utility>
+#include <vector>
 
+#include "braft/local_file_meta.pb.h"
+#include "butil/crc32c.h"
+#include "common/helper.h"
 #include "common/logging.h"
 #include "common/meta_control.h"
 #include "engine/snapshot.h"
 #include "fmt/core.h"
+#include "gflags/gflags.h"
 #include "proto/coordinator_internal.pb.h"
 #include "proto/error.pb.h"
+#include "raft/raft_cmd_codec.h"
 
 namespace dingodb {
 
+DEFINE_bool(enable_meta_snapshot_chunk, false,
+            "save meta snapshot as chunk files with checksum, follower only copies the chunks changed");
+DEFINE_int64(meta_snapshot_chunk_kvs, 10000, "max kv count of one meta snapshot chunk file");
+
+static const std::string kSnapshotDataFileName = "data";
+static const std::string kSnapshotChunkFilePrefix = "data_";
+
 MetaStateMachine::MetaStateMachine(std::shared_ptr<MetaControl> meta_control, bool is_volatile)
     : meta_control_(meta_control), is_volatile_state_machine_(is_volatile), last_snapshot_index_(0) {}
 
@@ -75,8 +91,7 @@ void MetaStateMachine::on_apply(braft::Iterator& iter) {
       raft_cmd = *(store_closure->GetRequest());
       is_leader = true;
     } else {
-      butil::IOBufAsZeroCopyInputStream wrapper(iter.data());
-      CHECK(raft_cmd.ParseFromZeroCopyStream(&wrapper));
+      CHECK(RaftCmdCodec::Decode(iter.data(), raft_cmd));
     }
 
     DINGO_LOG(DEBUG) << fmt::format("raft apply log on region[{}-term:{}-index:{}] cmd:[{}]",
@@ -99,12 +114,131 @@ struct SnapshotArg {
   braft::Closure* done;
 };
 
+// chunk file name: data_{field_number}_{chunk_index}, field_number 0 holds the fields which are not chunked.
+static std::string ChunkFileName(int field_number, int64_t chunk_index) {
+  return fmt::format("{}{}_{}", kSnapshotChunkFilePrefix, field_number, chunk_index);
+}
+
+static bool ParseChunkFileName(const std::string& filename, std::pair<int, int64_t>& chunk_id) {
+  if (filename.size() <= kSnapshotChunkFilePrefix.size() ||
+      filename.compare(0, kSnapshotChunkFilePrefix.size(), kSnapshotChunkFilePrefix) != 0) {
+    return false;
+  }
+
+  std::vector<std::string> parts;
+  Helper::SplitString(filename.substr(kSnapshotChunkFilePrefix.size()), '_', parts);
+  if (parts.size() != 2) {
+    return false;
+  }
+
+  try {
+    chunk_id.first = std::stoi(parts[0]);
+    chunk_id.second = std::stoll(parts[1]);
+  } catch (const std::exception&) {
+    return false;
+  }
+
+  return true;
+}
+
+// The checksum is recorded in the file meta, braft skip copying the remote file which has the same name and checksum
+// with the local last snapshot when filter_before_copy_remote is set, so the unchanged chunks are not transferred.
+static bool SaveChunkFile(braft::SnapshotWriter* writer, const std::string& filename,
+                          const pb::coordinator_internal::MetaSnapshotFile& chunk) {
+  braft::ProtoBufFile pb_file(writer->get_path() + "/" + filename);
+  if (pb_file.save(&chunk, true) != 0) {
+    DINGO_LOG(ERROR) << "Fail to save snapshot chunk file " << filename;
+    return false;
+  }
+
+  std::string data;
+  chunk.SerializeToString(&data);
+  braft::LocalFileMeta file_meta;
+  file_meta.set_checksum(std::to_string(butil::crc32c::Value(data.data(), data.size())));
+  if (writer->add_file(filename, &file_meta) != 0) {
+    DINGO_LOG(ERROR) << "Fail to add snapshot chunk file " << filename;
+    return false;
+  }
+
+  return true;
+}
+
+// Every repeated message field(meta map) is split to chunks of meta_snapshot_chunk_kvs elements.
+static bool SaveSnapshotChunks(braft::SnapshotWriter* writer, pb::coordinator_internal::MetaSnapshotFile& s) {
+  const auto* descriptor = s.GetDescriptor();
+  const auto* reflection = s.GetReflection();
+  int64_t chunk_kvs = std::max(FLAGS_meta_snapshot_chunk_kvs, static_cast<int64_t>(1));
+  int64_t chunk_count = 0;
+
+  for (int i = 0; i < descriptor->field_count(); ++i) {
+    const auto* field = descriptor->field(i);
+    if (!field->is_repeated() || field->cpp_type() != google::protobuf::FieldDescriptor::CPPTYPE_MESSAGE) {
+      continue;
+    }
+
+    int size = reflection->FieldSize(s, field);
+    for (int64_t start = 0, chunk_index = 0; start < size; start += chunk_kvs, ++chunk_index) {
+      pb::coordinator_internal::MetaSnapshotFile chunk;
+      int64_t end = std::min(start + chunk_kvs, static_cast<int64_t>(size));
+      for (int64_t j = start; j < end; ++j) {
+        chunk.GetReflection()->AddMessage(&chunk, field)->CopyFrom(reflection->GetRepeatedMessage(s, field, j));
+      }
+      if (!SaveChunkFile(writer, ChunkFileName(field->number(), chunk_index), chunk)) {
+        return false;
+      }
+      ++chunk_count;
+    }
+
+    reflection->ClearField(&s, field);
+  }
+
+  // the rest fields
+  if (!SaveChunkFile(writer, ChunkFileName(0, 0), s)) {
+    return false;
+  }
+
+  DINGO_LOG(INFO) << fmt::format("Saved snapshot chunks, count={}", chunk_count + 1);
+  return true;
+}
+
+// Merge the chunk files in order, the repeated fields keep the order of saving.
+static bool LoadSnapshotChunks(braft::SnapshotReader* reader, pb::coordinator_internal::MetaSnapshotFile& s) {
+  std::vector<std::string> files;
+  reader->list_files(&files);
+
+  std::vector<std::pair<std::pair<int, int64_t>, std::string>> chunk_files;
+  for (const auto& filename : files) {
+    std::pair<int, int64_t> chunk_id;
+    if (ParseChunkFileName(filename, chunk_id)) {
+      chunk_files.emplace_back(chunk_id, filename);
+    }
+  }
+  if (chunk_files.empty()) {
+    DINGO_LOG(ERROR) << "Fail to find snapshot chunk file on " << reader->get_path();
+    return false;
+  }
+  std::sort(chunk_files.begin(), chunk_files.end());
+
+  for (const auto& [chunk_id, filename] : chunk_files) {
+    braft::ProtoBufFile pb_file(reader->get_path() + "/" + filename);
+    pb::coordinator_internal::MetaSnapshotFile chunk;
+    if (pb_file.load(&chunk) != 0) {
+      DINGO_LOG(ERROR) << "Fail to load snapshot chunk file " << filename;
+      return false;
+    }
+    s.MergeFrom(chunk);
+  }
+
+  DINGO_LOG(INFO) << fmt::format("Loaded snapshot chunks, count={}", chunk_files.size());
+  return true;
+}
+
 static void* SaveSnapshot(void* arg) {
   SnapshotArg* sa = (SnapshotArg*)arg;
   std::unique_ptr<SnapshotArg> arg_guard(sa);
   // Serialize StateMachine to the snapshot
   brpc::ClosureGuard done_guard(sa->done);
-  std::string snapshot_path = sa->writer->get_path() + "/data";
+  std::string snapshot_path = sa->writer->get_path() + "/" + kSnapshotDataFileName;
   DINGO_LOG(INFO) << "Saving snapshot to " << snapshot_path;
   // Use protobuf to store the snapshot for backward compatibility.
   pb::coordinator_internal::MetaSnapshotFile s;
@@ -114,6 +248,13 @@ static void* SaveSnapshot(void* arg) {
     return nullptr;
   }
 
+  if (FLAGS_enable_meta_snapshot_chunk) {
+    if (!SaveSnapshotChunks(sa->writer, s)) {
+      sa->done->status().set_error(EIO, "Fail to save snapshot chunks");
+    }
+    return nullptr;
+  }
+
   braft::ProtoBufFile pb_file(snapshot_path);
   if (pb_file.save(&s, true) != 0) {
     sa->done->status().set_error(EIO, "Fail to save pb_file");
@@ -121,7 +262,7 @@ static void* SaveSnapshot(void* arg) {
   }
   // Snapshot is a set of files in raft. Add the only file into the
   // writer here.
-  if (sa->writer->add_file("data") != 0) {
+  if (sa->writer->add_file(kSnapshotDataFileName) != 0) {
     sa->done->status().set_error(EIO, "Fail to add file to writer");
     return nullptr;
   }
@@ -151,10 +292,8 @@ int MetaStateMachine::on_snapshot_load(braft::SnapshotReader* reader) {
   if (!is_volatile_state_machine_) {
     CHECK(!this->meta_control_->IsLeader()) << "Leader is not supposed to load snapshot";
   }
-  if (reader->get_file_meta("data", nullptr) != 0) {
-    DINGO_LOG(ERROR) << "Fail to find `data' on " << reader->get_path();
-    return -1;
-  }
+  // the snapshot saved without chunk has the only data file
+  bool is_chunked = reader->get_file_meta(kSnapshotDataFileName, nullptr) != 0;
 
   // load snapshot meta
   braft::SnapshotMeta snapshot_meta;
@@ -188,12 +327,18 @@ int MetaStateMachine::on_snapshot_load(braft::SnapshotReader* reader) {
     return 0;
   }
 
-  std::string snapshot_path = reader->get_path() + "/data";
-  braft::ProtoBufFile pb_file(snapshot_path);
+  std::string snapshot_path = reader->get_path() + "/" + kSnapshotDataFileName;
   pb::coordinator_internal::MetaSnapshotFile s;
-  if (pb_file.load(&s) != 0) {
-    DINGO_LOG(ERROR) << "Fail to load snapshot from " << snapshot_path;
-    return -1;
+  if (is_chunked) {
+    if (!LoadSnapshotChunks(reader, s)) {
+      return -1;
+    }
+  } else {
+    braft::ProtoBufFile pb_file(snapshot_path);
+    if (pb_file.load(&s) != 0) {
+      DINGO_LOG(ERROR) << "Fail to load snapshot from " << snapshot_path;
+      return -1;
+    }
   }
 
   bool bool_ret = this->meta_control_->LoadMetaFromSnapshotFile(s);
@@ -0,0 +1,172 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "raft/raft_cmd_codec.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "bvar/reducer.h"
+#include "common/logging.h"
+#include "fmt/core.h"
+#include "gflags/gflags.h"
+#include "lz4.h"
+#include "zstd.h"
+
+DEFINE_string(raft_log_compression, "none",
+              "raft log entry compression, none/lz4/zstd, enable it after all nodes are upgraded to support it");
+DEFINE_int32(raft_log_compression_threshold, 8192, "raft log entry is compressed when the size reach it, bytes");
+DEFINE_double(raft_log_compression_min_ratio, 0.85,
+              "raft log entry keep uncompressed when compressed size / raw size is greater than it");
+DEFINE_int32(raft_log_compression_zstd_level, 1, "raft log entry zstd compression level");
+
+namespace dingodb {
+
+static const uint8_t kCompressMagic = 0x00;
+
+bvar::Adder<int64_t> g_raft_log_compress_raw_bytes("dingo_raft_log_compress_raw_bytes");
+bvar::Adder<int64_t> g_raft_log_compress_bytes("dingo_raft_log_compress_bytes");
+bvar::Adder<int64_t> g_raft_log_compress_skip_count("dingo_raft_log_compress_skip_count");
+
+RaftCmdCodec::CompressionType RaftCmdCodec::ParseCompressionType(const std::string& name) {
+  if (name == "lz4") {
+    return CompressionType::kLz4;
+  } else if (name == "zstd") {
+    return CompressionType::kZstd;
+  }
+
+  return CompressionType::kNone;
+}
+
+bool RaftCmdCodec::Compress(CompressionType type, const std::string& input, std::string& output) {
+  switch (type) {
+    case CompressionType::kLz4: {
+      output.resize(LZ4_compressBound(input.size()));
+      int size = LZ4_compress_default(input.data(), output.data(), input.size(), output.size());
+      if (size <= 0) {
+        return false;
+      }
+      output.resize(size);
+      return true;
+    }
+    case CompressionType::kZstd: {
+      output.resize(ZSTD_compressBound(input.size()));
+      size_t size = ZSTD_compress(output.data(), output.size(), input.data(), input.size(),
+                                  FLAGS_raft_log_compression_zstd_level);
+      if (ZSTD_isError(size)) {
+        return false;
+      }
+      output.resize(size);
+      return true;
+    }
+    default:
+      return false;
+  }
+}
+
+bool RaftCmdCodec::Decompress(CompressionType type, const char* input, size_t size, size_t raw_size,
+                              std::string& output) {
+  output.resize(raw_size);
+  switch (type) {
+    case CompressionType::kLz4: {
+      int ret = LZ4_decompress_safe(input, output.data(), size, raw_size);
+      return ret >= 0 && static_cast<size_t>(ret) == raw_size;
+    }
+    case CompressionType::kZstd: {
+      size_t ret = ZSTD_decompress(output.data(), raw_size, input, size);
+      return !ZSTD_isError(ret) && ret == raw_size;
+    }
+    default:
+      return false;
+  }
+}
+
+void RaftCmdCodec::Encode(const pb::raft::RaftCmdRequest& raft_cmd, butil::IOBuf& data) {
+  auto type = ParseCompressionType(FLAGS_raft_log_compression);
+  size_t raw_size = raft_cmd.ByteSizeLong();
+  if (type == CompressionType::kNone || static_cast<int64_t>(raw_size) < FLAGS_raft_log_compression_threshold ||
+      raw_size > UINT32_MAX) {
+    butil::IOBufAsZeroCopyOutputStream wrapper(&data);
+    raft_cmd.SerializeToZeroCopyStream(&wrapper);
+    return;
+  }
+
+  std::string raw_data;
+  raft_cmd.SerializeToString(&raw_data);
+
+  // the incompressible entry(e.g. random float vector) is not worth the decompression cost
+  std::string compressed_data;
+  if (!Compress(type, raw_data, compressed_data) ||
+      compressed_data.size() + kHeaderSize > raw_data.size() * FLAGS_raft_log_compression_min_ratio) {
+    g_raft_log_compress_skip_count << 1;
+    data.append(raw_data);
+    return;
+  }
+
+  char header[kHeaderSize];
+  header[0] = static_cast<char>(kCompressMagic);
+  header[1] = static_cast<char>(type);
+  uint32_t size = raw_data.size();
+  for (int i = 0; i < 4; ++i) {
+    header[2 + i] = static_cast<char>((size >> (i * 8)) & 0xFF);
+  }
+  data.append(header, kHeaderSize);
+  data.append(compressed_data);
+
+  g_raft_log_compress_raw_bytes << raw_data.size();
+  g_raft_log_compress_bytes << compressed_data.size() + kHeaderSize;
+}
+
+bool RaftCmdCodec::DecodeCompressed(const char* data, size_t size, pb::raft::RaftCmdRequest& raft_cmd) {
+  if (size < kHeaderSize) {
+    return false;
+  }
+
+  auto type = static_cast<CompressionType>(data[1]);
+  uint32_t raw_size = 0;
+  for (int i = 0; i < 4; ++i) {
+    raw_size |= static_cast<uint32_t>(static_cast<uint8_t>(data[2 + i])) << (i * 8);
+  }
+
+  std::string raw_data;
+  if (!Decompress(type, data + kHeaderSize, size - kHeaderSize, raw_size, raw_data)) {
+    DINGO_LOG(ERROR) << fmt::format("[raft.codec] decompress raft log failed, type({}) size({}) raw_size({})",
+                                    static_cast<int>(type), size, raw_size);
+    return false;
+  }
+
+  return raft_cmd.ParseFromString(raw_data);
+}
+
+bool RaftCmdCodec::Decode(const butil::IOBuf& data, pb::raft::RaftCmdRequest& raft_cmd) {
+  char magic = 0;
+  if (data.empty() || data.copy_to(&magic, 1) != 1 || static_cast<uint8_t>(magic) != kCompressMagic) {
+    butil::IOBufAsZeroCopyInputStream wrapper(data);
+    return raft_cmd.ParseFromZeroCopyStream(&wrapper);
+  }
+
+  std::string buf = data.to_string();
+  return DecodeCompressed(buf.data(), buf.size(), raft_cmd);
+}
+
+bool RaftCmdCodec::Decode(const std::string& data, pb::raft::RaftCmdRequest& raft_cmd) {
+  if (data.empty() || static_cast<uint8_t>(data[0]) != kCompressMagic) {
+    return raft_cmd.ParseFromString(data);
+  }
+
+  return DecodeCompressed(data.data(), data.size(), raft_cmd);
+}
+
+}  // namespace dingodb
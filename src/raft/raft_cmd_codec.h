@@ -0,0 +1,61 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_RAFT_CMD_CODEC_H_
+#define DINGODB_RAFT_CMD_CODEC_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "butil/iobuf.h"
+#include "proto/raft.pb.h"
+
+namespace dingodb {
+
+// Encode raft cmd into raft log entry data, the large entry is compressed.
+// Compressed data layout: | magic(1B, 0x00) | compression type(1B) | raw size(4B, little endian) | compressed data |
+// A serialized protobuf message never begin with 0x00(field number 0 is invalid), so the uncompressed entry written
+// by the old version is decoded as it is.
+class RaftCmdCodec {
+ public:
+  enum class CompressionType : uint8_t {
+    kNone = 0,
+    kLz4 = 1,
+    kZstd = 2,
+  };
+
+  static constexpr size_t kHeaderSize = 6;
+
+  // Serialize raft_cmd to data, compress by raft_log_compression when the size reach raft_log_compression_threshold
+  // and the compression ratio is good enough.
+  static void Encode(const pb::raft::RaftCmdRequest& raft_cmd, butil::IOBuf& data);
+
+  // Parse raft_cmd from data, the compressed data is decompressed transparently.
+  static bool Decode(const butil::IOBuf& data, pb::raft::RaftCmdRequest& raft_cmd);
+  static bool Decode(const std::string& data, pb::raft::RaftCmdRequest& raft_cmd);
+
+  // none/lz4/zstd, unknown name is none.
+  static CompressionType ParseCompressionType(const std::string& name);
+
+  static bool Compress(CompressionType type, const std::string& input, std::string& output);
+  static bool Decompress(CompressionType type, const char* input, size_t size, size_t raw_size, std::string& output);
+
+ private:
+  static bool DecodeCompressed(const char* data, size_t size, pb::raft::RaftCmdRequest& raft_cmd);
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_RAFT_CMD_CODEC_H_
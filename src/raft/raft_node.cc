@@ -14,10 +14,12 @@
 
 #include "raft/raft_node.h"
 
+#include <algorithm>
 #include <memory>
 #include <string>
 #include <utility>
 
+#include "braft/snapshot_throttle.h"
 #include "bthread/bthread.h"
 #include "butil/memory/ref_counted.h"
 #include "butil/status.h"
@@ -29,12 +31,41 @@
 #include "metrics/store_bvar_metrics.h"
 #include "proto/common.pb.h"
 #include "raft/dingo_filesystem_adaptor.h"
+#include "raft/raft_cmd_codec.h"
 #include "raft/store_state_machine.h"
 
 DEFINE_int32(node_destroy_wait_time_ms, 3000, "wait time on node destroy");
+DEFINE_int64(raft_snapshot_throttle_throughput_bytes, 0,
+             "store level bandwidth cap of raft snapshot install per second, 0 means no limit");
+DEFINE_int64(raft_snapshot_throttle_check_cycle, 10, "raft snapshot throttle check cycle per second");
+DEFINE_int32(raft_quiesce_stretch_factor, 0,
+             "stretch the election timeout and heartbeat interval of idle leader by the factor, 0 or 1 means disable");
+DEFINE_int32(raft_quiesce_idle_s, 60, "leader is idle when no log is appended in the seconds");
+DEFINE_int32(raft_max_clock_drift_ms, 1000,
+             "max clock drift between the raft nodes, the leader lease is shorter than election timeout by it");
+DEFINE_bool(raft_quiesce_follower, false,
+            "followers of idle region also stretch election timeout, a quiescent follower rejects pre-vote within its "
+            "stretched lease, so the failover of idle region takes up to the stretched election timeout");
+
+namespace braft {
+DECLARE_int32(raft_election_heartbeat_factor);
+}  // namespace braft
 
 namespace dingodb {
 
+DECLARE_bool(enable_meta_snapshot_chunk);
+
+// All the raft nodes of store share one throttle, the cap is for the whole store.
+static scoped_refptr<braft::SnapshotThrottle>* GetSnapshotThrottle() {
+  if (FLAGS_raft_snapshot_throttle_throughput_bytes <= 0) {
+    return nullptr;
+  }
+
+  static scoped_refptr<braft::SnapshotThrottle> snapshot_throttle(new braft::ThroughputSnapshotThrottle(
+      FLAGS_raft_snapshot_throttle_throughput_bytes, FLAGS_raft_snapshot_throttle_check_cycle));
+  return &snapshot_throttle;
+}
+
 RaftNode::RaftNode(int64_t node_id, const std::string& raft_group_name, braft::PeerId peer_id,
                    std::shared_ptr<BaseStateMachine> fsm, std::shared_ptr<SegmentLogStorage> log_storage)
     : node_id_(node_id),
@@ -61,6 +92,7 @@ int RaftNode::Init(store::RegionPtr region, const std::string& init_conf, const
     return -1;
   }
   node_options.election_timeout_ms = election_timeout_ms;
+  node_options.max_clock_drift_ms = FLAGS_raft_max_clock_drift_ms;
   node_options.fsm = fsm_.get();
   node_options.node_owns_fsm = false;
   // Disable braft snapshot trigger
@@ -73,6 +105,7 @@ int RaftNode::Init(store::RegionPtr region, const std::string& init_conf, const
 
   node_options.log_storage = new SegmentLogStorageWrapper(log_storage_);
   node_options.node_owns_log_storage = true;
+  node_options.snapshot_throttle = GetSnapshotThrottle();
 
   // coordinator's region does not have store_region_meta, so coordinator will pass nullptr to call AddNode.
   // only store/index's region has store_region_meta, its region != nullptr, we used our own snapshot adaptor.
@@ -80,6 +113,10 @@ int RaftNode::Init(store::RegionPtr region, const std::string& init_conf, const
     region->snapshot_adaptor = new DingoFileSystemAdaptor(region->Id());
     node_options.snapshot_file_system_adaptor = &region->snapshot_adaptor;
   }
+  // the unchanged meta snapshot chunks are reused from the local last snapshot instead of copying.
+  if (region == nullptr && FLAGS_enable_meta_snapshot_chunk) {
+    node_options.filter_before_copy_remote = true;
+  }
 
   if (node_->init(node_options) != 0) {
     DINGO_LOG(ERROR) << fmt::format("[raft.node][node_id({})] init raft node failed.", node_id_);
@@ -121,9 +158,11 @@ butil::Status RaftNode::Commit(std::shared_ptr<Context> ctx, std::shared_ptr<pb:
   if (!IsLeader()) {
     return butil::Status(pb::error::ERAFT_NOTLEADER, GetLeaderId().to_string());
   }
+  // Restore the election timeout before proposing. Only the leader wakes up here, a follower woken up by a misrouted
+  // write would time out against the still stretched heartbeats of the leader.
+  WakeUp();
   butil::IOBuf data;
-  butil::IOBufAsZeroCopyOutputStream wrapper(&data);
-  raft_cmd->SerializeToZeroCopyStream(&wrapper);
+  RaftCmdCodec::Encode(*raft_cmd, data);
 
   FAIL_POINT("before_raft_commit");
 
@@ -146,7 +185,12 @@ butil::Status RaftNode::Commit(std::shared_ptr<Context> ctx, std::shared_ptr<pb:
 
 bool RaftNode::IsLeader() { return node_->is_leader(); }
 
-bool RaftNode::IsLeaderLeaseValid() { return node_->is_leader_lease_valid(); }
+bool RaftNode::IsLeaderLeaseValid() {
+  // The lease of quiescent leader is stretched along with its election timeout, it is longer than the election
+  // timeout of followers, so restore the election timeout before check lease.
+  WakeUp();
+  return node_->is_leader_lease_valid();
+}
 
 bool RaftNode::HasLeader() { return node_->leader_id().to_string() != "0.0.0.0:0:0"; }
 braft::PeerId RaftNode::GetLeaderId() { return node_->leader_id(); }
@@ -163,6 +207,65 @@ void RaftNode::ResetElectionTimeout(int election_timeout_ms, int max_clock_drift
   }
 }
 
+void RaftNode::CheckQuiescent() {
+  braft::NodeStatus status;
+  node_->get_status(&status);
+
+  bool is_leader = status.state == braft::STATE_LEADER;
+  int32_t stretch_factor = FLAGS_raft_quiesce_stretch_factor;
+  int64_t idle_ms = FLAGS_raft_quiesce_idle_s * 1000;
+  if (FLAGS_raft_quiesce_follower) {
+    // Followers quiesce first, then the leader stretches its heartbeat interval beyond their original timeout.
+    idle_ms = is_leader ? idle_ms * 2 : idle_ms;
+  } else {
+    // The heartbeat interval is election_timeout / raft_election_heartbeat_factor, keep it less than half of the
+    // election timeout of followers.
+    stretch_factor = std::min(stretch_factor, braft::FLAGS_raft_election_heartbeat_factor / 2);
+  }
+  bool can_quiesce =
+      stretch_factor > 1 && (is_leader || (FLAGS_raft_quiesce_follower && status.state == braft::STATE_FOLLOWER));
+
+  BAIDU_SCOPED_LOCK(quiesce_mutex_);
+
+  int64_t now_ms = Helper::TimestampMs();
+  if (!can_quiesce || status.term != last_active_term_ || status.last_index != last_active_index_) {
+    last_active_term_ = status.term;
+    last_active_index_ = status.last_index;
+    last_active_time_ms_ = now_ms;
+    if (quiescent_.load(std::memory_order_relaxed)) {
+      ResetElectionTimeout(quiesce_base_timeout_ms_, FLAGS_raft_max_clock_drift_ms);
+      quiescent_.store(false, std::memory_order_release);
+    }
+    return;
+  }
+
+  if (quiescent_.load(std::memory_order_relaxed) || now_ms - last_active_time_ms_ < idle_ms) {
+    return;
+  }
+
+  DINGO_LOG(INFO) << fmt::format("[raft.node][node_id({})] quiesce idle {}, last_index({}) stretch_factor({})",
+                                 node_id_, is_leader ? "leader" : "follower", status.last_index, stretch_factor);
+  quiesce_base_timeout_ms_ = election_timeout_ms_;
+  ResetElectionTimeout(quiesce_base_timeout_ms_ * stretch_factor, FLAGS_raft_max_clock_drift_ms);
+  quiescent_.store(true, std::memory_order_release);
+}
+
+void RaftNode::WakeUp() {
+  if (!quiescent_.load(std::memory_order_acquire)) {
+    return;
+  }
+
+  BAIDU_SCOPED_LOCK(quiesce_mutex_);
+  if (!quiescent_.load(std::memory_order_relaxed)) {
+    return;
+  }
+
+  DINGO_LOG(INFO) << fmt::format("[raft.node][node_id({})] wake up quiescent node", node_id_);
+  ResetElectionTimeout(quiesce_base_timeout_ms_, FLAGS_raft_max_clock_drift_ms);
+  last_active_time_ms_ = Helper::TimestampMs();
+  quiescent_.store(false, std::memory_order_release);
+}
+
 void RaftNode::Shutdown(braft::Closure* done) { node_->shutdown(done); }
 void RaftNode::Join() { node_->join(); }
 
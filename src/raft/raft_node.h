@@ -23,6 +23,7 @@
 #include <memory>
 #include <string>
 
+#include "bthread/mutex.h"
 #include "common/context.h"
 #include "log/segment_log_storage.h"
 #include "meta/store_meta_manager.h"
@@ -60,6 +61,14 @@ class RaftNode {
   uint32_t ElectionTimeout() const;
   void ResetElectionTimeout(int election_timeout_ms, int max_clock_drift_ms);
 
+  // Stretch the election timeout of leader which has no new log for a while, its heartbeat interval is stretched too,
+  // so the idle regions send much less heartbeats. Followers stretch their own election timeout only when
+  // raft_quiesce_follower is enabled, then the leader can stretch its heartbeat interval beyond their original timeout.
+  // A dead leader of such region is replaced after the stretched election timeout, not the original one.
+  void CheckQuiescent();
+  // Restore the election timeout of quiescent node.
+  void WakeUp();
+
   void Shutdown(braft::Closure* done);
   void Join();
 
@@ -89,6 +98,13 @@ class RaftNode {
 
   uint32_t election_timeout_ms_;
 
+  bthread::Mutex quiesce_mutex_;
+  std::atomic<bool> quiescent_{false};
+  uint32_t quiesce_base_timeout_ms_{0};
+  int64_t last_active_term_{0};
+  int64_t last_active_index_{0};
+  int64_t last_active_time_ms_{0};
+
   std::shared_ptr<BaseStateMachine> fsm_;
   std::shared_ptr<SegmentLogStorage> log_storage_;
   std::unique_ptr<braft::Node> node_;
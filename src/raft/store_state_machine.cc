@@ -14,30 +14,50 @@
 
 #include "raft/store_state_machine.h"
 
+#include <algorithm>
+#include <cerrno>
 #include <cstdint>
 #include <memory>
+#include <mutex>
 #include <string>
 
 #include "braft/util.h"
 #include "butil/compiler_specific.h"
 #include "butil/status.h"
+#include "butil/time.h"
+#include "common/constant.h"
 #include "common/helper.h"
 #include "common/logging.h"
 #include "common/synchronization.h"
+#include "crontab/crontab.h"
+#include "engine/change_capture.h"
+#include "engine/flushed_applied_index_tracker.h"
+#include "engine/row_cache.h"
 #include "event/store_state_machine_event.h"
 #include "fmt/core.h"
+#include "gflags/gflags.h"
+#include "log/index_journal.h"
 #include "meta/store_meta_manager.h"
 #include "metrics/store_bvar_metrics.h"
 #include "proto/common.pb.h"
 #include "proto/error.pb.h"
 #include "proto/raft.pb.h"
 #include "raft/dingo_filesystem_adaptor.h"
+#include "raft/raft_cmd_codec.h"
 #include "server/server.h"
 
 const int kSaveAppliedIndexStep = 10;
 
 namespace dingodb {
 
+DEFINE_bool(enable_raft_pipeline_apply, false,
+            "enable pipeline apply, vector/document index update of log N overlap rocksdb write of log N+1");
+DEFINE_int32(raft_pipeline_apply_max_pending, 32, "max pending index stage count of pipeline apply per region");
+DEFINE_bool(enable_raft_apply_write_batch, false,
+            "enable coalesce the writes of consecutive put/delete_batch/txn entries into one write batch");
+DEFINE_int64(raft_apply_write_batch_max_count, 1024, "max key count of apply write batch");
+DEFINE_int64(raft_apply_write_batch_max_bytes, 4 * 1024 * 1024, "max bytes of apply write batch");
+
 StoreStateMachine::StoreStateMachine(std::shared_ptr<RawEngine> engine, store::RegionPtr region,
                                      store::RaftMetaPtr raft_meta, store::RegionMetricsPtr region_metrics,
                                      std::shared_ptr<EventListenerCollection> listeners,
@@ -53,11 +73,29 @@ StoreStateMachine::StoreStateMachine(std::shared_ptr<RawEngine> engine, store::R
       last_snapshot_index_(0),
       raft_apply_worker_set_(raft_apply_worker_set) {
   bthread_mutex_init(&apply_mutex_, nullptr);
+  readable_index_.store(applied_index_);
+  if (FLAGS_enable_raft_pipeline_apply) {
+    auto worker = Worker::New();
+    if (worker->Init()) {
+      pipeline_worker_ = worker;
+      pipeline_cond_ = std::make_shared<BthreadCond>();
+    } else {
+      DINGO_LOG(ERROR) << fmt::format("[raft.sm][region({})] init pipeline apply worker failed, disable pipeline.",
+                                      region->Id());
+    }
+  }
+  if (FLAGS_enable_raft_apply_write_batch) {
+    write_batch_ = std::make_shared<ApplyWriteBatch>(engine);
+  }
   DINGO_LOG(DEBUG) << fmt::format("[new.StoreStateMachine][id({})]", str_node_id_);
 }
 
 StoreStateMachine::~StoreStateMachine() {
   DINGO_LOG(DEBUG) << fmt::format("[delete.StoreStateMachine][id({})]", str_node_id_);
+  if (pipeline_worker_ != nullptr) {
+    WaitPipelineApply();
+    pipeline_worker_->Destroy();
+  }
   bthread_mutex_destroy(&apply_mutex_);
 }
 
@@ -92,6 +130,116 @@ int StoreStateMachine::DispatchEvent(dingodb::EventType event_type, std::shared_
   return 0;
 }
 
+// Only the add of vector/document has heavy index update, others apply serially.
+bool StoreStateMachine::IsSupportPipelineApply(const pb::raft::RaftCmdRequest& raft_cmd) {
+  if (raft_cmd.requests().empty()) {
+    return false;
+  }
+
+  for (const auto& req : raft_cmd.requests()) {
+    if (req.cmd_type() != pb::raft::VECTOR_ADD && req.cmd_type() != pb::raft::DOCUMENT_ADD) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+// Run the index stage in log order, the response is sent and the durable applied index is advanced after it.
+void StoreStateMachine::PipelineApplyIndex(std::shared_ptr<SmApplyEvent> event) {
+  auto index_event = std::make_shared<SmApplyEvent>();
+  index_event->region = event->region;
+  index_event->engine = event->engine;
+  index_event->done = event->done;
+  index_event->raft_cmd = event->raft_cmd;
+  index_event->region_metrics = event->region_metrics;
+  index_event->term_id = event->term_id;
+  index_event->log_id = event->log_id;
+  index_event->stage = ApplyStage::kIndex;
+
+  WaitPipelineApply(FLAGS_raft_pipeline_apply_max_pending - 1);
+  pipeline_cond_->Increase();
+
+  auto task = std::make_shared<DispatchEventTask>([this, index_event]() {
+    braft::AsyncClosureGuard done_guard(index_event->done);
+
+    DispatchEvent(EventType::kSmApply, index_event);
+    SaveAppliedIndex(index_event->term_id, index_event->log_id);
+
+    pipeline_cond_->DecreaseSignal();
+  });
+
+  if (BAIDU_UNLIKELY(!pipeline_worker_->Execute(task))) {
+    DINGO_LOG(ERROR) << fmt::format("[raft.sm][region({})] execute pipeline apply task failed, run in place.",
+                                    region_->Id());
+    task->Run();
+  }
+}
+
+void StoreStateMachine::WaitPipelineApply(int max_pending) {
+  if (pipeline_cond_ != nullptr) {
+    pipeline_cond_->Wait(std::max(max_pending, 0));
+  }
+}
+
+void StoreStateMachine::SaveAppliedIndex(int64_t term, int64_t index, bool force_persist) {
+  raft_meta_->SetTermAndAppliedId(term, index);
+
+  // Persistence applied index
+  // If operation is idempotent, it's ok.
+  // If not, must be stored with the data.
+  if (force_persist || index % kSaveAppliedIndexStep == 0) {
+    if (FlushedAppliedIndexTracker::IsEnabled()) {
+      // data wal disabled, persist after the data flushed.
+      FlushedAppliedIndexTracker::GetInstance().Record(region_->Id(), term, index);
+    } else {
+      Server::GetInstance().GetStoreMetaManager()->GetStoreRaftMeta()->UpdateRaftMeta(raft_meta_, true);
+    }
+  }
+}
+
+bool StoreStateMachine::IsSupportWriteBatch(const pb::raft::RaftCmdRequest& raft_cmd) {
+  if (raft_cmd.requests().empty()) {
+    return false;
+  }
+
+  for (const auto& req : raft_cmd.requests()) {
+    if (req.cmd_type() != pb::raft::PUT && req.cmd_type() != pb::raft::DELETEBATCH &&
+        req.cmd_type() != pb::raft::TXN) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+void StoreStateMachine::CommitWriteBatch() {
+  if (write_batch_ == nullptr) {
+    return;
+  }
+
+  auto status = write_batch_->Commit();
+  if (!status.ok()) {
+    DINGO_LOG(FATAL) << fmt::format("[raft.sm][region({})] commit write batch failed, error: {}", region_->Id(),
+                                    status.error_str());
+  }
+
+  auto& pending = write_batch_pending_;
+  for (auto* done : pending.dones) {
+    braft::run_closure_in_bthread(done);
+  }
+
+  if (pending.last_index > 0) {
+    // persist if skip a step index in batch
+    bool force_persist =
+        pending.last_index / kSaveAppliedIndexStep > (pending.first_index - 1) / kSaveAppliedIndexStep;
+    SaveAppliedIndex(pending.last_term, pending.last_index, force_persist);
+    AdvanceReadableIndex(pending.last_index);
+  }
+
+  pending = WriteBatchPending();
+}
+
 void StoreStateMachine::on_apply(braft::Iterator& iter) {
   BAIDU_SCOPED_LOCK(apply_mutex_);
 
@@ -122,8 +270,7 @@ void StoreStateMachine::on_apply(braft::Iterator& iter) {
       BaseClosure* store_closure = dynamic_cast<BaseClosure*>(iter.done());
       raft_cmd = store_closure->GetRequest();
     } else {
-      butil::IOBufAsZeroCopyInputStream wrapper(iter.data());
-      CHECK(raft_cmd->ParseFromZeroCopyStream(&wrapper));
+      CHECK(RaftCmdCodec::Decode(iter.data(), *raft_cmd));
     }
 
     bool need_apply = true;
@@ -158,7 +305,23 @@ void StoreStateMachine::on_apply(braft::Iterator& iter) {
         iter.index(), applied_index_,
         raft_cmd->requests().empty() ? "" : pb::raft::CmdType_Name(raft_cmd->requests().at(0).cmd_type()));
 
+    // Ordering per region, the serial apply wait all pending index stage finish.
+    bool is_pipeline = need_apply && pipeline_worker_ != nullptr && IsSupportPipelineApply(*raft_cmd);
+    // Other entries commit the coalesced writes first to keep order.
+    bool is_write_batch = need_apply && !is_pipeline && write_batch_ != nullptr && IsSupportWriteBatch(*raft_cmd);
+    if (!is_write_batch) {
+      CommitWriteBatch();
+    }
+    if (!is_pipeline) {
+      WaitPipelineApply();
+    }
+
     if (need_apply) {
+      // Record index requests in log order before apply, replay is idempotent.
+      if (IndexJournalManager::IsEnabled()) {
+        IndexJournalManager::GetInstance().OnApply(region_->Id(), iter.index(), *raft_cmd);
+      }
+
       // Build event
       auto event = std::make_shared<SmApplyEvent>();
       event->region = region_;
@@ -168,6 +331,8 @@ void StoreStateMachine::on_apply(braft::Iterator& iter) {
       event->region_metrics = region_metrics_;
       event->term_id = iter.term();
       event->log_id = iter.index();
+      event->stage = is_pipeline ? ApplyStage::kStore : ApplyStage::kAll;
+      event->write_batch = is_write_batch ? write_batch_ : nullptr;
 
       if (BAIDU_LIKELY(raft_apply_worker_set_ != nullptr)) {
         // Run in queue.
@@ -191,6 +356,12 @@ void StoreStateMachine::on_apply(braft::Iterator& iter) {
       } else {
         DispatchEvent(EventType::kSmApply, event);
       }
+
+      if (is_pipeline) {
+        // done is run by the index stage
+        done_guard.release();
+        PipelineApplyIndex(event);
+      }
     }
 
     if (tracker != nullptr) {
@@ -199,18 +370,41 @@ void StoreStateMachine::on_apply(braft::Iterator& iter) {
 
     applied_term_ = iter.term();
     applied_index_ = iter.index();
-    raft_meta_->SetTermAndAppliedId(applied_term_, applied_index_);
+    if (is_write_batch && !write_batch_->Empty()) {
+      // done and durable applied index wait the write batch commit.
+      auto& pending = write_batch_pending_;
+      auto* pending_done = done_guard.release();
+      if (pending_done != nullptr) {
+        pending.dones.push_back(pending_done);
+      }
+      if (pending.first_index == 0) {
+        pending.first_index = applied_index_;
+      }
+      pending.last_term = applied_term_;
+      pending.last_index = applied_index_;
+
+      if (write_batch_->Count() >= FLAGS_raft_apply_write_batch_max_count ||
+          write_batch_->ByteSize() >= FLAGS_raft_apply_write_batch_max_bytes) {
+        CommitWriteBatch();
+      }
+    } else if (!is_pipeline) {
+      // pipeline advance durable applied index after the index stage.
+      // the deferred entries is committed by the handler
+      if (is_write_batch) {
+        CommitWriteBatch();
+      }
+      SaveAppliedIndex(applied_term_, applied_index_);
+      AdvanceReadableIndex(applied_index_);
+    } else {
+      // the store stage of pipeline is done, the index stage not affect the readable data.
+      AdvanceReadableIndex(applied_index_);
+    }
 
     // bvar metrics
     StoreBvarMetrics::GetInstance().IncApplyCountPerSecond(str_node_id_);
-
-    // Persistence applied index
-    // If operation is idempotent, it's ok.
-    // If not, must be stored with the data.
-    if (applied_index_ % kSaveAppliedIndexStep == 0) {
-      Server::GetInstance().GetStoreMetaManager()->GetStoreRaftMeta()->UpdateRaftMeta(raft_meta_);
-    }
   }
+
+  CommitWriteBatch();
 }
 
 int32_t StoreStateMachine::CatchUpApplyLog(const std::vector<pb::raft::LogEntry>& entries) {
@@ -226,6 +420,7 @@ int32_t StoreStateMachine::CatchUpApplyLog(const std::vector<pb::raft::LogEntry>
   int64_t start_applied_id = 0;
   {
     BAIDU_SCOPED_LOCK(apply_mutex_);
+    WaitPipelineApply();
     start_applied_id = applied_index_;
 
     for (const auto& entry : entries) {
@@ -234,7 +429,7 @@ int32_t StoreStateMachine::CatchUpApplyLog(const std::vector<pb::raft::LogEntry>
       }
 
       auto raft_cmd = std::make_shared<pb::raft::RaftCmdRequest>();
-      CHECK(raft_cmd->ParsePartialFromArray(entry.data().data(), entry.data().size()));
+      CHECK(RaftCmdCodec::Decode(entry.data(), *raft_cmd));
 
       DINGO_LOG(INFO) << fmt::format(
           "[raft.sm][region({}).epoch({})] apply log {}:{} applied_index({}) cmd_type({})",
@@ -255,14 +450,11 @@ int32_t StoreStateMachine::CatchUpApplyLog(const std::vector<pb::raft::LogEntry>
       applied_term_ = entry.term();
       applied_index_ = entry.index();
 
-      raft_meta_->SetTermAndAppliedId(applied_term_, applied_index_);
-
       // bvar metrics
       StoreBvarMetrics::GetInstance().IncApplyCountPerSecond(str_node_id_);
 
-      if (applied_index_ % kSaveAppliedIndexStep == 0) {
-        Server::GetInstance().GetStoreMetaManager()->GetStoreRaftMeta()->UpdateRaftMeta(raft_meta_);
-      }
+      SaveAppliedIndex(applied_term_, applied_index_);
+      AdvanceReadableIndex(applied_index_);
 
       ++actual_apply_log_count;
     }
@@ -278,6 +470,7 @@ int32_t StoreStateMachine::CatchUpApplyLog(const std::vector<pb::raft::LogEntry>
 
 std::shared_ptr<SnapshotContext> StoreStateMachine::MakeSnapshotContext() {
   BAIDU_SCOPED_LOCK(apply_mutex_);
+  WaitPipelineApply();
 
   auto snapshot_ctx = std::make_shared<SnapshotContext>(raw_engine_);
   snapshot_ctx->applied_term = applied_term_;
@@ -290,6 +483,7 @@ std::shared_ptr<SnapshotContext> StoreStateMachine::MakeSnapshotContext() {
 
 void StoreStateMachine::on_shutdown() {
   DINGO_LOG(INFO) << fmt::format("[raft.sm][region({})] on_shutdown", region_->Id());
+  WaitPipelineApply();
   auto event = std::make_shared<SmShutdownEvent>();
   DispatchEvent(EventType::kSmShutdown, event);
   DINGO_LOG(INFO) << fmt::format("[raft.sm][region({})] on_shutdown done", region_->Id());
@@ -297,6 +491,8 @@ void StoreStateMachine::on_shutdown() {
 
 void StoreStateMachine::on_snapshot_save(braft::SnapshotWriter* writer, braft::Closure* done) {
   DINGO_LOG(INFO) << fmt::format("[raft.sm][region({})] on_snapshot_save", region_->Id());
+  CrontabRunTimeGuard guard;
+  WaitPipelineApply();
   auto event = std::make_shared<SmSnapshotSaveEvent>();
   event->engine = raw_engine_;
   event->writer = writer;
@@ -305,6 +501,20 @@ void StoreStateMachine::on_snapshot_save(braft::SnapshotWriter* writer, braft::C
   event->term = applied_term_;
   event->log_index = applied_index_;
 
+  // raft log is truncated after snapshot, the data without wal must be flushed before.
+  if (FlushedAppliedIndexTracker::IsEnabled() &&
+      !FlushedAppliedIndexTracker::GetInstance().IsFlushed(region_->Id(), applied_index_)) {
+    auto status = raw_engine_->Flush(Constant::kStoreDataCF);
+    if (!status.ok()) {
+      // fail the snapshot, otherwise braft truncates the log that the unflushed data can only be recovered from.
+      DINGO_LOG(ERROR) << fmt::format("[raft.sm][region({})] flush before snapshot failed, error: {}", region_->Id(),
+                                      Helper::PrintStatus(status));
+      done->status().set_error(EIO, "Fail to flush data before snapshot");
+      done->Run();
+      return;
+    }
+  }
+
   DispatchEvent(EventType::kSmSnapshotSave, event);
 
   last_snapshot_index_ = applied_index_;
@@ -335,6 +545,8 @@ void StoreStateMachine::on_snapshot_save(braft::SnapshotWriter* writer, braft::C
 //      2>. load snapshot files
 //      3>. applied_index = max_index
 int StoreStateMachine::on_snapshot_load(braft::SnapshotReader* reader) {
+  WaitPipelineApply();
+
   braft::SnapshotMeta meta;
   int ret = reader->load_meta(&meta);
   if (ret != 0) {
@@ -387,10 +599,22 @@ int StoreStateMachine::on_snapshot_load(braft::SnapshotReader* reader) {
       return ret;
     }
 
+    // region data is replaced by snapshot without apply.
+    if (RowCache::IsEnabled()) {
+      RowCache::GetInstance().InvalidateRegion(region_->Id());
+    }
+    if (ChangeCapture::IsEnabled()) {
+      ChangeCapture::GetInstance().EraseRegion(region_->Id());
+    }
+    if (region_metrics_ != nullptr) {
+      region_metrics_->InvalidateKeyCount(meta.last_included_index());
+    }
+
     // Update applied term and index
     applied_term_ = meta.last_included_term();
     applied_index_ = meta.last_included_index();
     last_snapshot_index_ = meta.last_included_index();
+    AdvanceReadableIndex(applied_index_);
 
     if (raft_meta_ != nullptr) {
       raft_meta_->SetTermAndAppliedId(meta.last_included_term(), meta.last_included_index());
@@ -470,7 +694,40 @@ void StoreStateMachine::on_stop_following(const braft::LeaderChangeContext& ctx)
   DispatchEvent(EventType::kSmStopFollowing, event);
 }
 
-void StoreStateMachine::UpdateAppliedIndex(int64_t applied_index) { applied_index_ = applied_index; }
+void StoreStateMachine::UpdateAppliedIndex(int64_t applied_index) {
+  applied_index_ = applied_index;
+  AdvanceReadableIndex(applied_index);
+}
+
+void StoreStateMachine::AdvanceReadableIndex(int64_t index) {
+  int64_t old_index = readable_index_.load();
+  while (old_index < index && !readable_index_.compare_exchange_weak(old_index, index)) {
+  }
+
+  if (readable_waiter_count_.load() > 0) {
+    std::lock_guard<bthread::Mutex> lock(readable_mutex_);
+    readable_cond_.notify_all();
+  }
+}
+
+bool StoreStateMachine::WaitReadableIndex(int64_t index, int64_t timeout_ms) {
+  if (readable_index_.load() >= index) {
+    return true;
+  }
+
+  readable_waiter_count_.fetch_add(1);
+  int64_t deadline_us = butil::gettimeofday_us() + timeout_ms * 1000;
+  std::unique_lock<bthread::Mutex> lock(readable_mutex_);
+  while (readable_index_.load() < index) {
+    int64_t remain_us = deadline_us - butil::gettimeofday_us();
+    if (remain_us <= 0 || readable_cond_.wait_for(lock, remain_us) == ETIMEDOUT) {
+      break;
+    }
+  }
+  readable_waiter_count_.fetch_sub(1);
+
+  return readable_index_.load() >= index;
+}
 
 int64_t StoreStateMachine::GetAppliedIndex() const { return applied_index_; }
 
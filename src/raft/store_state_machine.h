@@ -15,14 +15,19 @@
 #ifndef DINGODB_RAFT_STATE_MACHINE_H_
 #define DINGODB_RAFT_STATE_MACHINE_H_
 
+#include <atomic>
 #include <cstdint>
 #include <string>
 #include <vector>
 
 #include "braft/raft.h"
+#include "bthread/condition_variable.h"
+#include "bthread/mutex.h"
 #include "common/runnable.h"
+#include "common/synchronization.h"
 #include "engine/raw_engine.h"
 #include "event/event.h"
+#include "handler/apply_write_batch.h"
 #include "meta/store_meta_manager.h"
 #include "metrics/store_metrics_manager.h"
 #include "proto/raft.pb.h"
@@ -31,6 +36,7 @@
 namespace dingodb {
 
 struct SnapshotContext;
+struct SmApplyEvent;
 
 class DispatchEventTask : public TaskRunnable {
  public:
@@ -75,6 +81,9 @@ class StoreStateMachine : public BaseStateMachine {
 
   int64_t GetLastSnapshotIndex() const override;
 
+  // Wait until the data of the log index is readable, i.e. applied and committed to engine. Return false if timeout.
+  bool WaitReadableIndex(int64_t index, int64_t timeout_ms);
+
   int32_t CatchUpApplyLog(const std::vector<pb::raft::LogEntry>& entries);
 
   std::shared_ptr<SnapshotContext> MakeSnapshotContext();
@@ -82,6 +91,20 @@ class StoreStateMachine : public BaseStateMachine {
  private:
   int DispatchEvent(dingodb::EventType, std::shared_ptr<dingodb::Event> event);
 
+  // Pipeline apply, the store stage run in on_apply, the index stage run in pipeline_worker_ in log order.
+  static bool IsSupportPipelineApply(const pb::raft::RaftCmdRequest& raft_cmd);
+  void PipelineApplyIndex(std::shared_ptr<SmApplyEvent> event);
+  // Wait until pending index stage count not greater than max_pending.
+  void WaitPipelineApply(int max_pending = 0);
+  void SaveAppliedIndex(int64_t term, int64_t index, bool force_persist = false);
+  // Advance readable_index_ and wake up the waiters.
+  void AdvanceReadableIndex(int64_t index);
+
+  // Coalesce the blind writes of consecutive PUT/DELETEBATCH/TXN entries in one on_apply.
+  static bool IsSupportWriteBatch(const pb::raft::RaftCmdRequest& raft_cmd);
+  // Commit write_batch_, then run the deferred done and advance the durable applied index.
+  void CommitWriteBatch();
+
   store::RegionPtr region_;
   std::string str_node_id_;
   std::shared_ptr<RawEngine> raw_engine_;
@@ -99,6 +122,28 @@ class StoreStateMachine : public BaseStateMachine {
 
   // raft_apply_worker_set
   SimpleWorkerSetPtr raft_apply_worker_set_;
+
+  // Serial worker for the index stage of pipeline apply, nullptr is disable.
+  WorkerPtr pipeline_worker_;
+  // Pending index stage count.
+  BthreadCondPtr pipeline_cond_;
+
+  // Apply write batch, nullptr is disable.
+  ApplyWriteBatchPtr write_batch_;
+  // Deferred done and applied index of the entries in write_batch_.
+  struct WriteBatchPending {
+    std::vector<google::protobuf::Closure*> dones;
+    int64_t first_index{0};
+    int64_t last_term{0};
+    int64_t last_index{0};
+  };
+  WriteBatchPending write_batch_pending_;
+
+  // The applied index whose data is committed to engine, it lags applied_index_ while the write batch is pending.
+  std::atomic<int64_t> readable_index_{0};
+  std::atomic<int32_t> readable_waiter_count_{0};
+  bthread::Mutex readable_mutex_;
+  bthread::ConditionVariable readable_cond_;
 };
 
 }  // namespace dingodb
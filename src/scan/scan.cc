@@ -17,21 +17,28 @@
 #include <fmt/core.h>
 
 #include <algorithm>
+#include <atomic>
 #include <cstdint>
+#include <iterator>
 #include <memory>
 #include <string>
 #include <vector>
 
 #include "bthread/mutex.h"
 #include "butil/compiler_specific.h"
-#include "butil/macros.h"     // IWYU pragma: keep
+#include "butil/macros.h"  // IWYU pragma: keep
+#include "bvar/passive_status.h"
+#include "bvar/reducer.h"
 #include "common/constant.h"  // IWYU pragma: keep
 #include "common/helper.h"    // IWYU pragma: keep
 #include "common/logging.h"
+#include "common/synchronization.h"
 #include "coprocessor/coprocessor.h"
 #include "coprocessor/coprocessor_v2.h"
 #include "coprocessor/utils.h"
+#include "engine/raw_kv_ttl.h"
 #include "engine/write_data.h"  // IWYU pragma: keep
+#include "gflags/gflags.h"
 #include "proto/common.pb.h"
 #include "proto/error.pb.h"
 #include "scan/scan_filter.h"
@@ -41,6 +48,40 @@
 
 namespace dingodb {
 
+DEFINE_int64(scan_long_scan_min_fetch_cnt, 10000,
+             "scan fetch count not less than it or with coprocessor use long scan iterator prefetch");
+DEFINE_bool(scan_enable_prefetch_page, false,
+            "read the next page of scan in background after a page is returned, save the wait of ScanContinue, "
+            "the page is held in memory until the next ScanContinue");
+DEFINE_int64(scan_prefetch_memory_limit_bytes, 1024L * 1024 * 1024,
+             "memory budget of all scan prefetched pages, prefetch is paused when it is used up, 0 is no limit");
+DEFINE_int64(scan_prefetch_quota_bytes, 4 * 1024 * 1024, "max bytes of the prefetched page per scan");
+
+static std::atomic<int64_t> g_scan_prefetch_memory_bytes{0};
+static bvar::PassiveStatus<int64_t> g_scan_prefetch_memory_bytes_status(
+    "dingo_scan_prefetch_memory_bytes", [](void*) -> int64_t { return g_scan_prefetch_memory_bytes.load(); }, nullptr);
+static bvar::Adder<int64_t> g_scan_prefetch_pause_count("dingo_scan_prefetch_pause_count");
+
+static bool ReservePrefetchMemory(int64_t bytes) {
+  int64_t used = g_scan_prefetch_memory_bytes.fetch_add(bytes) + bytes;
+  if (FLAGS_scan_prefetch_memory_limit_bytes > 0 && used > FLAGS_scan_prefetch_memory_limit_bytes) {
+    g_scan_prefetch_memory_bytes.fetch_sub(bytes);
+    return false;
+  }
+  return true;
+}
+
+static void ReleasePrefetchMemory(int64_t bytes) { g_scan_prefetch_memory_bytes.fetch_sub(bytes); }
+
+template <typename Iter>
+static int64_t KvsBytes(Iter begin, Iter end) {
+  int64_t bytes = 0;
+  for (auto it = begin; it != end; ++it) {
+    bytes += it->key().size() + it->value().size();
+  }
+  return bytes;
+}
+
 ScanContext::ScanContext(bvar::LatencyRecorder* scan_latency)
     : region_id_(0),
       max_fetch_cnt_(0),
@@ -59,6 +100,9 @@ ScanContext::ScanContext(bvar::LatencyRecorder* scan_latency)
       timeout_ms_(0),
       max_bytes_rpc_(0),
       max_fetch_cnt_by_server_(0),
+      prefetched_(false),
+      prefetch_has_more_(false),
+      prefetch_memory_bytes_(0),
       scan_latency_(scan_latency),
       bvar_guard_(scan_latency_) {
   bthread_mutex_init(&mutex_, nullptr);
@@ -116,6 +160,10 @@ void ScanContext::Close() {
   iter_ = nullptr;
   last_time_ms_.zero();
   coprocessor_.reset();
+  prefetched_ = false;
+  prefetch_kvs_.clear();
+  ReleasePrefetchMemory(prefetch_memory_bytes_);
+  prefetch_memory_bytes_ = 0;
   bthread_mutex_destroy(&mutex_);
 }
 
@@ -127,10 +175,10 @@ std::chrono::milliseconds ScanContext::GetCurrentTime() {
   return millisec;
 }
 
-butil::Status ScanContext::GetKeyValue(std::vector<pb::common::KeyValue>& kvs, bool& has_more) {
+butil::Status ScanContext::GetKeyValue(int64_t max_bytes, std::vector<pb::common::KeyValue>& kvs, bool& has_more) {
   if (!disable_coprocessor_) {
     butil::Status status;
-    status = coprocessor_->Execute(iter_, key_only_, std::min(max_fetch_cnt_, max_fetch_cnt_by_server_), max_bytes_rpc_,
+    status = coprocessor_->Execute(iter_, key_only_, std::min(max_fetch_cnt_, max_fetch_cnt_by_server_), max_bytes,
                                    &kvs, has_more);
     if (!status.ok()) {
       DINGO_LOG(ERROR) << fmt::format("Coprocessor::Execute failed");
@@ -138,7 +186,7 @@ butil::Status ScanContext::GetKeyValue(std::vector<pb::common::KeyValue>& kvs, b
     return status;
   }
 
-  ScanFilter scan_filter = ScanFilter(key_only_, std::min(max_fetch_cnt_, max_fetch_cnt_by_server_), max_bytes_rpc_);
+  ScanFilter scan_filter = ScanFilter(key_only_, std::min(max_fetch_cnt_, max_fetch_cnt_by_server_), max_bytes);
 
   has_more = false;
   while (iter_->Valid()) {
@@ -162,6 +210,61 @@ butil::Status ScanContext::GetKeyValue(std::vector<pb::common::KeyValue>& kvs, b
   return butil::Status();
 }
 
+void ScanContext::StartPrefetch(std::shared_ptr<ScanContext> context) {
+  int64_t quota = context->max_bytes_rpc_;
+  if (FLAGS_scan_prefetch_quota_bytes > 0) {
+    quota = std::min(quota, FLAGS_scan_prefetch_quota_bytes);
+  }
+  if (!ReservePrefetchMemory(quota)) {
+    g_scan_prefetch_pause_count << 1;
+    return;
+  }
+  context->prefetch_memory_bytes_ += quota;
+
+  context->prefetch_cond_.Increase();
+  Bthread bth([context, quota]() {
+    {
+      BAIDU_SCOPED_LOCK(context->mutex_);
+      context->prefetch_kvs_.clear();
+      context->prefetch_has_more_ = false;
+      context->prefetch_status_ = context->GetKeyValue(quota, context->prefetch_kvs_, context->prefetch_has_more_);
+      context->prefetched_ = true;
+
+      // hold the actual bytes of the page instead of the quota
+      int64_t bytes = KvsBytes(context->prefetch_kvs_.begin(), context->prefetch_kvs_.end());
+      ReleasePrefetchMemory(quota - bytes);
+      context->prefetch_memory_bytes_ += bytes - quota;
+    }
+    context->prefetch_cond_.DecreaseSignal();
+  });
+}
+
+butil::Status ScanContext::TakePrefetched(int64_t max_fetch_cnt, std::vector<pb::common::KeyValue>& kvs,
+                                          bool& has_more) {
+  if (!prefetch_status_.ok()) {
+    prefetched_ = false;
+    prefetch_kvs_.clear();
+    ReleasePrefetchMemory(prefetch_memory_bytes_);
+    prefetch_memory_bytes_ = 0;
+    return prefetch_status_;
+  }
+
+  // the page size may be changed by the client, keep the rest for the next call
+  size_t count = std::min(prefetch_kvs_.size(), static_cast<size_t>(std::max(max_fetch_cnt, int64_t(0))));
+  int64_t bytes = count == prefetch_kvs_.size() ? prefetch_memory_bytes_
+                                                : KvsBytes(prefetch_kvs_.begin(), prefetch_kvs_.begin() + count);
+  ReleasePrefetchMemory(bytes);
+  prefetch_memory_bytes_ -= bytes;
+  kvs.insert(kvs.end(), std::make_move_iterator(prefetch_kvs_.begin()),
+             std::make_move_iterator(prefetch_kvs_.begin() + count));
+  prefetch_kvs_.erase(prefetch_kvs_.begin(), prefetch_kvs_.begin() + count);
+
+  has_more = !prefetch_kvs_.empty() || prefetch_has_more_;
+  prefetched_ = !prefetch_kvs_.empty();
+
+  return butil::Status();
+}
+
 #if defined(ENABLE_SCAN_OPTIMIZATION)
 butil::Status ScanContext::AsyncWork() {
   auto lambda_call = [this]() {
@@ -420,8 +523,13 @@ butil::Status ScanHandler::ScanBegin(std::shared_ptr<ScanContext> context, int64
 
   IteratorOptions options;
   options.upper_bound = context->range_.end_key();
+  options.long_scan = (!context->disable_coprocessor_ && context->coprocessor_ != nullptr) ||
+                      max_fetch_cnt >= FLAGS_scan_long_scan_min_fetch_cnt;
+  // coprocessor may filter by value
+  options.key_only = context->key_only_ && context->disable_coprocessor_;
 
-  context->iter_ = reader->NewIterator(context->cf_name_, options);
+  context->iter_ = RawKvTtl::GetInstance().WrapIterator(context->cf_name_, context->range_,
+                                                       reader->NewIterator(context->cf_name_, options));
   if (!context->iter_) {
     context->state_ = ScanState::kError;
     DINGO_LOG(ERROR) << fmt::format("RawEngine::Reader::NewIterator failed");
@@ -431,13 +539,17 @@ butil::Status ScanHandler::ScanBegin(std::shared_ptr<ScanContext> context, int64
 
   if (context->max_fetch_cnt_ > 0) {
     bool has_more = false;
-    butil::Status s = context->GetKeyValue(*kvs, has_more);
+    butil::Status s = context->GetKeyValue(context->max_bytes_rpc_, *kvs, has_more);
     if (!s.ok()) {
       context->state_ = ScanState::kError;
       DINGO_LOG(ERROR) << fmt::format("ScanContext::GetKeyValue failed");
       return s;
     }
 
+    if (has_more && FLAGS_scan_enable_prefetch_page) {
+      ScanContext::StartPrefetch(context);
+    }
+
 #if defined(ENABLE_SCAN_OPTIMIZATION)
     context->seek_state_ = ScanContext::SeekState::kInitted;
 #endif
@@ -474,6 +586,7 @@ butil::Status ScanHandler::ScanContinue(std::shared_ptr<ScanContext> context, co
 #if defined(ENABLE_SCAN_OPTIMIZATION)
   context->WaitForReady();
 #endif
+  context->prefetch_cond_.Wait();
 
   BAIDU_SCOPED_LOCK(context->mutex_);
   if (ScanState::kBegun != context->state_ && ScanState::kContinued != context->state_) {
@@ -498,13 +611,21 @@ butil::Status ScanHandler::ScanContinue(std::shared_ptr<ScanContext> context, co
 
   context->state_ = ScanState::kContinuing;
 
-  s = context->GetKeyValue(*kvs, has_more);
+  if (context->prefetched_) {
+    s = context->TakePrefetched(max_fetch_cnt, *kvs, has_more);
+  } else {
+    s = context->GetKeyValue(context->max_bytes_rpc_, *kvs, has_more);
+  }
   if (!s.ok()) {
     context->state_ = ScanState::kError;
     DINGO_LOG(ERROR) << fmt::format("ScanContext::GetKeyValue failed");
     return s;
   }
 
+  if (has_more && !context->prefetched_ && FLAGS_scan_enable_prefetch_page) {
+    ScanContext::StartPrefetch(context);
+  }
+
   context->state_ = ScanState::kContinued;
   context->last_time_ms_ = context->GetCurrentTime();
 
@@ -521,6 +642,7 @@ butil::Status ScanHandler::ScanRelease(std::shared_ptr<ScanContext> context,
 #if defined(ENABLE_SCAN_OPTIMIZATION)
   context->WaitForReady();
 #endif
+  context->prefetch_cond_.Wait();
 
   BAIDU_SCOPED_LOCK(context->mutex_);
   if (ScanState::kBegun != context->state_ && ScanState::kContinued != context->state_) {
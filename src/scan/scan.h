@@ -23,6 +23,7 @@
 
 #include "bthread/types.h"
 #include "butil/status.h"
+#include "common/synchronization.h"
 #include "coprocessor/raw_coprocessor.h"
 #include "engine/iterator.h"
 #include "engine/raw_engine.h"
@@ -83,7 +84,15 @@ class ScanContext {
  private:
   void Close();
   static std::chrono::milliseconds GetCurrentTime();
-  butil::Status GetKeyValue(std::vector<pb::common::KeyValue>& kvs, bool& has_more);  // NOLINT
+  // Read a page of at most max_bytes(exceeded by the last kv).
+  butil::Status GetKeyValue(int64_t max_bytes, std::vector<pb::common::KeyValue>& kvs, bool& has_more);  // NOLINT
+  // Read the next page in background while the current page is on the way to the client.
+  // The page is bounded by the per scan quota and reserved from the global prefetch memory budget, the prefetch is
+  // paused when the budget is used up, ScanContinue then reads the page from the iterator itself.
+  static void StartPrefetch(std::shared_ptr<ScanContext> context);
+  // Take at most max_fetch_cnt kvs of the prefetched page, call with mutex_ held.
+  butil::Status TakePrefetched(int64_t max_fetch_cnt, std::vector<pb::common::KeyValue>& kvs,  // NOLINT
+                               bool& has_more);                                                 // NOLINT
 #if defined(ENABLE_SCAN_OPTIMIZATION)
   butil::Status AsyncWork();
   void WaitForReady();
@@ -140,6 +149,16 @@ class ScanContext {
   // kv count per transfer specified by the server
   int64_t max_fetch_cnt_by_server_;
 
+  // next page read ahead, valid if prefetched_ is true
+  bool prefetched_;
+  std::vector<pb::common::KeyValue> prefetch_kvs_;
+  bool prefetch_has_more_;
+  butil::Status prefetch_status_;
+  // bytes held in the prefetch memory budget by this scan
+  int64_t prefetch_memory_bytes_;
+  // count of running prefetch, wait for it before touching the iterator
+  BthreadCond prefetch_cond_;
+
   bvar::LatencyRecorder* scan_latency_;
   BvarLatencyGuard bvar_guard_;
 };
@@ -909,11 +909,10 @@ void DoGetRegionMap(google::protobuf::RpcController * /*controller*/,
     return;
   }
 
-  pb::common::RegionMap regionmap;
-  coordinator_control->GetRegionMap(regionmap);
+  auto regionmap = coordinator_control->GetRegionMapSnapshot();
 
-  *(response->mutable_regionmap()) = regionmap;
-  response->set_epoch(regionmap.epoch());
+  *(response->mutable_regionmap()) = *regionmap;
+  response->set_epoch(regionmap->epoch());
 }
 
 void DoGetDeletedRegionMap(google::protobuf::RpcController * /*controller*/,
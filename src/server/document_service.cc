@@ -168,6 +168,7 @@ void DocumentServiceImpl::DocumentBatchQuery(google::protobuf::RpcController* co
   auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
     DoDocumentBatchQuery(storage_, controller, request, response, svr_done);
   });
+  ServiceHelper::SetTaskQos(task, svr_done->GetRegion(), QosRequestType::kPointRead);
   bool ret = read_worker_set_->ExecuteRR(task);
   if (!ret) {
     brpc::ClosureGuard done_guard(svr_done);
@@ -273,8 +274,9 @@ void DoDocumentSearch(StoragePtr storage, google::protobuf::RpcController* contr
     return;
   }
 
+  response->mutable_document_with_scores()->Reserve(document_results.size());
   for (auto& document_with_score : document_results) {
-    *(response->add_document_with_scores()) = document_with_score;
+    response->add_document_with_scores()->Swap(&document_with_score);
   }
 }
 
@@ -292,6 +294,7 @@ void DocumentServiceImpl::DocumentSearch(google::protobuf::RpcController* contro
   auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
     DoDocumentSearch(storage_, controller, request, response, svr_done);
   });
+  ServiceHelper::SetTaskQos(task, svr_done->GetRegion(), QosRequestType::kVectorSearch);
   bool ret = read_worker_set_->ExecuteLeastQueue(task);
   if (!ret) {
     brpc::ClosureGuard done_guard(svr_done);
@@ -413,12 +416,10 @@ void DoDocumentAdd(StoragePtr storage, google::protobuf::RpcController* controll
   ctx->SetRawEngineType(region->GetRawEngineType());
   ctx->SetStoreEngineType(region->GetStoreEngineType());
 
-  std::vector<pb::common::DocumentWithId> documents;
-  for (const auto& document : request->documents()) {
-    documents.push_back(document);
-  }
-
-  status = storage->DocumentAdd(ctx, is_sync, documents, request->is_update());
+  // the documents are moved out of request, request only is used to log after here
+  auto* mut_request = const_cast<pb::document::DocumentAddRequest*>(request);
+  status = storage->DocumentAdd(ctx, is_sync, Helper::PbRepeatedToVector(mut_request->mutable_documents()),
+                                request->is_update());
   if (!status.ok()) {
     ServiceHelper::SetError(response->mutable_error(), status.error_code(), status.error_str());
 
@@ -449,6 +450,7 @@ void DocumentServiceImpl::DocumentAdd(google::protobuf::RpcController* controlle
   auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
     DoDocumentAdd(storage_, controller, request, response, svr_done, true);
   });
+  ServiceHelper::SetTaskQos(task, svr_done->GetRegion(), QosRequestType::kWrite);
   bool ret = write_worker_set_->ExecuteRR(task);
   if (!ret) {
     brpc::ClosureGuard done_guard(svr_done);
@@ -553,6 +555,7 @@ void DocumentServiceImpl::DocumentDelete(google::protobuf::RpcController* contro
   auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
     DoDocumentDelete(storage_, controller, request, response, svr_done, true);
   });
+  ServiceHelper::SetTaskQos(task, svr_done->GetRegion(), QosRequestType::kWrite);
   bool ret = write_worker_set_->ExecuteRR(task);
   if (!ret) {
     brpc::ClosureGuard done_guard(svr_done);
@@ -628,6 +631,7 @@ void DocumentServiceImpl::DocumentGetBorderId(google::protobuf::RpcController* c
   auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
     DoDocumentGetBorderId(storage_, controller, request, response, svr_done);
   });
+  ServiceHelper::SetTaskQos(task, svr_done->GetRegion(), QosRequestType::kPointRead);
   bool ret = read_worker_set_->ExecuteRR(task);
   if (!ret) {
     brpc::ClosureGuard done_guard(svr_done);
@@ -734,6 +738,7 @@ void DocumentServiceImpl::DocumentScanQuery(google::protobuf::RpcController* con
   auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
     DoDocumentScanQuery(storage_, controller, request, response, svr_done);
   });
+  ServiceHelper::SetTaskQos(task, svr_done->GetRegion(), QosRequestType::kScan);
   bool ret = read_worker_set_->ExecuteRR(task);
   if (!ret) {
     brpc::ClosureGuard done_guard(svr_done);
@@ -819,6 +824,7 @@ void DocumentServiceImpl::DocumentGetRegionMetrics(google::protobuf::RpcControll
   auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
     DoDocumentGetRegionMetrics(storage_, controller, request, response, svr_done);
   });
+  ServiceHelper::SetTaskQos(task, svr_done->GetRegion(), QosRequestType::kPointRead);
   bool ret = read_worker_set_->ExecuteRR(task);
   if (!ret) {
     brpc::ClosureGuard done_guard(svr_done);
@@ -931,6 +937,7 @@ void DocumentServiceImpl::DocumentCount(google::protobuf::RpcController* control
   auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
     DoDocumentCount(storage_, controller, request, response, svr_done);
   });
+  ServiceHelper::SetTaskQos(task, svr_done->GetRegion(), QosRequestType::kScan);
   bool ret = read_worker_set_->ExecuteRR(task);
   if (!ret) {
     brpc::ClosureGuard done_guard(svr_done);
@@ -1039,6 +1046,7 @@ void DocumentServiceImpl::TxnGet(google::protobuf::RpcController* controller, co
   auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
     DoTxnGetDocument(storage_, controller, request, response, svr_done);
   });
+  ServiceHelper::SetTaskQos(task, svr_done->GetRegion(), QosRequestType::kPointRead);
   bool ret = read_worker_set_->ExecuteRR(task);
   if (!ret) {
     brpc::ClosureGuard done_guard(svr_done);
@@ -1170,6 +1178,7 @@ void DocumentServiceImpl::TxnScan(google::protobuf::RpcController* controller, c
   auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
     DoTxnScanDocument(storage_, controller, request, response, svr_done);
   });
+  ServiceHelper::SetTaskQos(task, svr_done->GetRegion(), QosRequestType::kScan);
   bool ret = read_worker_set_->ExecuteRR(task);
   if (!ret) {
     brpc::ClosureGuard done_guard(svr_done);
@@ -1180,7 +1189,8 @@ void DocumentServiceImpl::TxnScan(google::protobuf::RpcController* controller, c
 
 butil::Status ValidateTxnPessimisticLockRequest(const dingodb::pb::store::TxnPessimisticLockRequest* request);
 
-void DoTxnPessimisticLock(StoragePtr storage, google::protobuf::RpcController* controller,
+void DoTxnPessimisticLock(StoragePtr storage, SimpleWorkerSetPtr worker_set,
+                          google::protobuf::RpcController* controller,
                           const dingodb::pb::store::TxnPessimisticLockRequest* request,
                           dingodb::pb::store::TxnPessimisticLockResponse* response, TrackClosure* done, bool is_sync);
 
@@ -1199,8 +1209,9 @@ void DocumentServiceImpl::TxnPessimisticLock(google::protobuf::RpcController* co
 
   // Run in queue.
   auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
-    DoTxnPessimisticLock(storage_, controller, request, response, svr_done, true);
+    DoTxnPessimisticLock(storage_, write_worker_set_, controller, request, response, svr_done, true);
   });
+  ServiceHelper::SetTaskQos(task, svr_done->GetRegion(), QosRequestType::kWrite);
   bool ret = write_worker_set_->ExecuteRR(task);
   if (!ret) {
     brpc::ClosureGuard done_guard(svr_done);
@@ -1233,6 +1244,7 @@ void DocumentServiceImpl::TxnPessimisticRollback(google::protobuf::RpcController
   auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
     DoTxnPessimisticRollback(storage_, controller, request, response, svr_done, true);
   });
+  ServiceHelper::SetTaskQos(task, svr_done->GetRegion(), QosRequestType::kWrite);
   bool ret = write_worker_set_->ExecuteRR(task);
   if (!ret) {
     brpc::ClosureGuard done_guard(svr_done);
@@ -1497,6 +1509,7 @@ void DocumentServiceImpl::TxnPrewrite(google::protobuf::RpcController* controlle
   auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
     DoTxnPrewriteDocument(storage_, controller, request, response, svr_done, true);
   });
+  ServiceHelper::SetTaskQos(task, svr_done->GetRegion(), QosRequestType::kWrite);
   bool ret = write_worker_set_->ExecuteRR(task);
   if (!ret) {
     brpc::ClosureGuard done_guard(svr_done);
@@ -1606,6 +1619,7 @@ void DocumentServiceImpl::TxnCommit(google::protobuf::RpcController* controller,
   auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
     DoTxnCommit(storage_, controller, request, response, svr_done, true);
   });
+  ServiceHelper::SetTaskQos(task, svr_done->GetRegion(), QosRequestType::kWrite);
   bool ret = write_worker_set_->ExecuteRR(task);
   if (!ret) {
     brpc::ClosureGuard done_guard(svr_done);
@@ -1705,6 +1719,7 @@ void DocumentServiceImpl::TxnCheckTxnStatus(google::protobuf::RpcController* con
   auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
     DoTxnCheckTxnStatus(storage_, controller, request, response, svr_done, true);
   });
+  ServiceHelper::SetTaskQos(task, svr_done->GetRegion(), QosRequestType::kWrite);
   bool ret = write_worker_set_->ExecuteRR(task);
   if (!ret) {
     brpc::ClosureGuard done_guard(svr_done);
@@ -1806,6 +1821,7 @@ void DocumentServiceImpl::TxnResolveLock(google::protobuf::RpcController* contro
   auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
     DoTxnResolveLock(storage_, controller, request, response, svr_done, true);
   });
+  ServiceHelper::SetTaskQos(task, svr_done->GetRegion(), QosRequestType::kWrite);
   bool ret = write_worker_set_->ExecuteRR(task);
   if (!ret) {
     brpc::ClosureGuard done_guard(svr_done);
@@ -1925,6 +1941,7 @@ void DocumentServiceImpl::TxnBatchGet(google::protobuf::RpcController* controlle
   auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
     DoTxnBatchGetDocument(storage_, controller, request, response, svr_done);
   });
+  ServiceHelper::SetTaskQos(task, svr_done->GetRegion(), QosRequestType::kPointRead);
   bool ret = read_worker_set_->ExecuteRR(task);
   if (!ret) {
     brpc::ClosureGuard done_guard(svr_done);
@@ -1990,6 +2007,7 @@ void DocumentServiceImpl::TxnBatchRollback(google::protobuf::RpcController* cont
   auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
     DoTxnBatchRollback(storage_, controller, request, response, svr_done, true);
   });
+  ServiceHelper::SetTaskQos(task, svr_done->GetRegion(), QosRequestType::kWrite);
   bool ret = write_worker_set_->ExecuteRR(task);
   if (!ret) {
     brpc::ClosureGuard done_guard(svr_done);
@@ -2054,6 +2072,7 @@ void DocumentServiceImpl::TxnScanLock(google::protobuf::RpcController* controlle
   auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
     DoTxnScanLock(storage_, controller, request, response, svr_done);
   });
+  ServiceHelper::SetTaskQos(task, svr_done->GetRegion(), QosRequestType::kScan);
   bool ret = read_worker_set_->ExecuteRR(task);
   if (!ret) {
     brpc::ClosureGuard done_guard(svr_done);
@@ -2113,6 +2132,7 @@ void DocumentServiceImpl::TxnHeartBeat(google::protobuf::RpcController* controll
   auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
     DoTxnHeartBeat(storage_, controller, request, response, svr_done, true);
   });
+  ServiceHelper::SetTaskQos(task, svr_done->GetRegion(), QosRequestType::kWrite);
   bool ret = write_worker_set_->ExecuteRR(task);
   if (!ret) {
     brpc::ClosureGuard done_guard(svr_done);
@@ -2168,6 +2188,7 @@ void DocumentServiceImpl::TxnGc(google::protobuf::RpcController* controller, con
   auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
     DoTxnGc(storage_, controller, request, response, svr_done, true);
   });
+  ServiceHelper::SetTaskQos(task, svr_done->GetRegion(), QosRequestType::kWrite);
   bool ret = write_worker_set_->ExecuteRR(task);
   if (!ret) {
     brpc::ClosureGuard done_guard(svr_done);
@@ -2223,6 +2244,7 @@ void DocumentServiceImpl::TxnDeleteRange(google::protobuf::RpcController* contro
   auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
     DoTxnDeleteRange(storage_, controller, request, response, svr_done, true);
   });
+  ServiceHelper::SetTaskQos(task, svr_done->GetRegion(), QosRequestType::kWrite);
   bool ret = write_worker_set_->ExecuteRR(task);
   if (!ret) {
     brpc::ClosureGuard done_guard(svr_done);
@@ -2272,6 +2294,7 @@ void DocumentServiceImpl::TxnDump(google::protobuf::RpcController* controller, c
   auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
     DoTxnDump(storage_, controller, request, response, svr_done);
   });
+  ServiceHelper::SetTaskQos(task, svr_done->GetRegion(), QosRequestType::kScan);
   bool ret = read_worker_set_->ExecuteRR(task);
   if (!ret) {
     brpc::ClosureGuard done_guard(svr_done);
@@ -2340,6 +2363,7 @@ void DocumentServiceImpl::Hello(google::protobuf::RpcController* controller, con
 
   auto task = std::make_shared<ServiceTask>([=]() { DoHello(controller, request, response, svr_done); });
 
+  ServiceHelper::SetTaskQos(task, svr_done->GetRegion(), QosRequestType::kPointRead);
   bool ret = read_worker_set_->ExecuteRR(task);
   if (!ret) {
     brpc::ClosureGuard done_guard(svr_done);
@@ -2356,6 +2380,7 @@ void DocumentServiceImpl::GetMemoryInfo(google::protobuf::RpcController* control
 
   auto task = std::make_shared<ServiceTask>([=]() { DoHello(controller, request, response, svr_done, true); });
 
+  ServiceHelper::SetTaskQos(task, svr_done->GetRegion(), QosRequestType::kPointRead);
   bool ret = read_worker_set_->ExecuteRR(task);
   if (!ret) {
     brpc::ClosureGuard done_guard(svr_done);
@@ -14,9 +14,15 @@
 
 #include "server/file_service.h"
 
+#include <fcntl.h>
+#include <sys/stat.h>
+
+#include <algorithm>
+#include <cerrno>
 #include <cstdint>
 #include <vector>
 
+#include "butil/fd_guard.h"
 #include "fmt/core.h"
 #include "server/service_helper.h"
 
@@ -77,6 +83,40 @@ void FileServiceImpl::CleanFileReader(google::protobuf::RpcController* controlle
   }
 }
 
+int FileReaderWrapper::ReadFile(butil::IOBuf* out, const std::string& filename, off_t offset, size_t max_count,
+                                size_t* read_count, bool* is_eof) {
+  // snapshot file name is flat, don't read out of snapshot dir
+  if (filename.empty() || filename.find('/') != std::string::npos) {
+    return EINVAL;
+  }
+
+  std::string file_path = fmt::format("{}/{}", snapshot_->Path(), filename);
+  butil::fd_guard fd(open(file_path.c_str(), O_RDONLY | O_CLOEXEC));
+  if (fd < 0) {
+    return errno;
+  }
+  struct stat file_stat;
+  if (fstat(fd, &file_stat) != 0) {
+    return errno;
+  }
+
+  size_t count = 0;
+  if (offset < file_stat.st_size) {
+    butil::IOPortal portal;
+    ssize_t nread =
+        portal.pappend_from_file_descriptor(fd, offset, std::min<size_t>(max_count, file_stat.st_size - offset));
+    if (nread < 0) {
+      return errno;
+    }
+    count = nread;
+    out->append(portal);
+  }
+
+  *read_count = count;
+  *is_eof = offset + static_cast<off_t>(count) >= file_stat.st_size;
+  return 0;
+}
+
 FileServiceReaderManager::FileServiceReaderManager() {
   bthread_mutex_init(&mutex_, nullptr);
   next_id_ = ((int64_t)getpid() << 45) | (butil::gettimeofday_us() << 17 >> 17);
@@ -20,6 +20,7 @@
 #include <string>
 
 #include "bthread/types.h"
+#include "butil/iobuf.h"
 #include "common/file_reader.h"
 #include "proto/file_service.pb.h"
 #include "vector/vector_index_snapshot.h"
@@ -42,21 +43,17 @@ class FileServiceImpl : public pb::fileservice::FileService {
 
 class FileReaderWrapper {
  public:
-  FileReaderWrapper(vector_index::SnapshotMetaPtr snapshot)
-      : snapshot_(snapshot),
-        file_reader_(std::make_shared<LocalDirReader>(new braft::PosixFileSystemAdaptor(), snapshot->Path())) {}
+  FileReaderWrapper(vector_index::SnapshotMetaPtr snapshot) : snapshot_(snapshot) {}
   ~FileReaderWrapper() = default;
 
+  // Positional read, chunks of a file can be read by concurrent requests in any order.
   int ReadFile(butil::IOBuf* out, const std::string& filename, off_t offset, size_t max_count, size_t* read_count,
-               bool* is_eof) {
-    return file_reader_->ReadFile(out, filename, offset, max_count, read_count, is_eof);
-  }
+               bool* is_eof);
 
   std::string Path() { return snapshot_->Path(); }
 
  private:
   vector_index::SnapshotMetaPtr snapshot_;
-  std::shared_ptr<FileReader> file_reader_;
 };
 
 class FileServiceReaderManager {
@@ -32,6 +32,7 @@
 #include "fmt/core.h"
 #include "gflags/gflags.h"
 #include "meta/store_meta_manager.h"
+#include "metrics/memory_accounting.h"
 #include "proto/common.pb.h"
 #include "proto/coordinator.pb.h"
 #include "proto/error.pb.h"
@@ -40,7 +41,9 @@
 #include "server/server.h"
 #include "server/service_helper.h"
 #include "vector/codec.h"
+#include "vector/multi_vector.h"
 #include "vector/vector_index_utils.h"
+#include "vector/vector_packed_codec.h"
 
 using dingodb::pb::error::Errno;
 
@@ -172,6 +175,7 @@ void IndexServiceImpl::VectorBatchQuery(google::protobuf::RpcController* control
   auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
     DoVectorBatchQuery(storage_, controller, request, response, svr_done);
   });
+  ServiceHelper::SetTaskQos(task, svr_done->GetRegion(), QosRequestType::kPointRead);
   bool ret = read_worker_set_->ExecuteRR(task);
   if (!ret) {
     brpc::ClosureGuard done_guard(svr_done);
@@ -260,6 +264,17 @@ void DoVectorSearch(StoragePtr storage, google::protobuf::RpcController* control
   auto region = done->GetRegion();
   int64_t region_id = request->context().region_id();
 
+  auto* mut_request = const_cast<pb::index::VectorSearchRequest*>(request);
+  // the query vectors are packed in attachment, reply packed too.
+  bool is_packed = !cntl->request_attachment().empty();
+  if (is_packed) {
+    auto status = VectorPackedCodec::Unpack(VectorPackedCodec::VectorWithIds(mut_request), cntl->request_attachment());
+    if (!status.ok()) {
+      ServiceHelper::SetError(response->mutable_error(), status.error_code(), status.error_str());
+      return;
+    }
+  }
+
   butil::Status status = ValidateVectorSearchRequest(storage, request, region);
   if (!status.ok()) {
     ServiceHelper::SetError(response->mutable_error(), status.error_code(), status.error_str());
@@ -270,7 +285,6 @@ void DoVectorSearch(StoragePtr storage, google::protobuf::RpcController* control
     return;
   }
 
-  auto* mut_request = const_cast<pb::index::VectorSearchRequest*>(request);
   auto ctx = std::make_shared<Engine::VectorReader::Context>();
   ctx->partition_id = region->PartitionId();
   ctx->region_id = region->Id();
@@ -279,6 +293,8 @@ void DoVectorSearch(StoragePtr storage, google::protobuf::RpcController* control
   ctx->parameter.Swap(mut_request->mutable_parameter());
   ctx->raw_engine_type = region->GetRawEngineType();
   ctx->store_engine_type = region->GetStoreEngineType();
+  ctx->multi_vector_token_bits = MultiVector::TokenBits(region->Definition().index_id());
+  ctx->document_index = region->DocumentIndexWrapper();
 
   auto scalar_schema = region->ScalarSchema();
   DINGO_LOG_IF(INFO, FLAGS_dingo_log_switch_scalar_speed_up_detail)
@@ -293,8 +309,10 @@ void DoVectorSearch(StoragePtr storage, google::protobuf::RpcController* control
     err->set_errmsg("Param vector_with_ids is empty");
     return;
   } else {
-    for (const auto& vector : request->vector_with_ids()) {
-      ctx->vector_with_ids.push_back(vector);
+    // move query vectors out of request, the request is not used after search.
+    ctx->vector_with_ids.resize(request->vector_with_ids_size());
+    for (int i = 0; i < request->vector_with_ids_size(); ++i) {
+      ctx->vector_with_ids[i].Swap(mut_request->mutable_vector_with_ids(i));
     }
   }
 
@@ -305,8 +323,13 @@ void DoVectorSearch(StoragePtr storage, google::protobuf::RpcController* control
     return;
   }
 
+  response->mutable_batch_results()->Reserve(vector_results.size());
   for (auto& vector_result : vector_results) {
-    *(response->add_batch_results()) = vector_result;
+    response->add_batch_results()->Swap(&vector_result);
+  }
+
+  if (is_packed) {
+    VectorPackedCodec::Pack(VectorPackedCodec::VectorWithIds(response), cntl->response_attachment());
   }
 }
 
@@ -328,6 +351,7 @@ void IndexServiceImpl::VectorSearch(google::protobuf::RpcController* controller,
   auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
     DoVectorSearch(storage_, controller, request, response, svr_done);
   });
+  ServiceHelper::SetTaskQos(task, svr_done->GetRegion(), QosRequestType::kVectorSearch);
   bool ret = read_worker_set_->ExecuteLeastQueue(task);
   if (!ret) {
     brpc::ClosureGuard done_guard(svr_done);
@@ -383,6 +407,12 @@ static butil::Status ValidateVectorAddRequest(StoragePtr storage, const pb::inde
                          fmt::format("Vector index {} exceeds max elements.", region->Id()));
   }
 
+  if (MemoryAccounting::GetInstance().IsExceedLimit(MemoryAccounting::Subsystem::kVectorIndex)) {
+    return butil::Status(pb::error::EVECTOR_INDEX_EXCEED_MAX_ELEMENTS,
+                         fmt::format("Vector index {} add is rejected, vector indexes exceed memory limit.",
+                                     region->Id()));
+  }
+
   for (const auto& vector : request->vectors()) {
     if (BAIDU_UNLIKELY(!VectorCodec::IsLegalVectorId(vector.id()))) {
       return butil::Status(pb::error::EILLEGAL_PARAMTETERS,
@@ -400,7 +430,8 @@ static butil::Status ValidateVectorAddRequest(StoragePtr storage, const pb::inde
         vector_index_wrapper->Type() == pb::common::VectorIndexType::VECTOR_INDEX_TYPE_FLAT ||
         vector_index_wrapper->Type() == pb::common::VectorIndexType::VECTOR_INDEX_TYPE_BRUTEFORCE ||
         vector_index_wrapper->Type() == pb::common::VectorIndexType::VECTOR_INDEX_TYPE_IVF_FLAT ||
-        vector_index_wrapper->Type() == pb::common::VectorIndexType::VECTOR_INDEX_TYPE_IVF_PQ) {
+        vector_index_wrapper->Type() == pb::common::VectorIndexType::VECTOR_INDEX_TYPE_IVF_PQ ||
+        vector_index_wrapper->Type() == pb::common::VectorIndexType::VECTOR_INDEX_TYPE_DISKANN) {
       if (vector.vector().float_values().size() != dimension) {
         return butil::Status(
             pb::error::EILLEGAL_PARAMTETERS,
@@ -466,12 +497,10 @@ void DoVectorAdd(StoragePtr storage, google::protobuf::RpcController* controller
   ctx->SetRawEngineType(region->GetRawEngineType());
   ctx->SetStoreEngineType(region->GetStoreEngineType());
 
-  std::vector<pb::common::VectorWithId> vectors;
-  for (const auto& vector : request->vectors()) {
-    vectors.push_back(vector);
-  }
-
-  status = storage->VectorAdd(ctx, is_sync, vectors, request->is_update());
+  // the vectors are moved out of request, request only is used to log after here
+  auto* mut_request = const_cast<pb::index::VectorAddRequest*>(request);
+  status = storage->VectorAdd(ctx, is_sync, Helper::PbRepeatedToVector(mut_request->mutable_vectors()),
+                              request->is_update());
   if (!status.ok()) {
     ServiceHelper::SetError(response->mutable_error(), status.error_code(), status.error_str());
 
@@ -507,6 +536,7 @@ void IndexServiceImpl::VectorAdd(google::protobuf::RpcController* controller,
   auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
     DoVectorAdd(storage_, controller, request, response, svr_done, true);
   });
+  ServiceHelper::SetTaskQos(task, svr_done->GetRegion(), QosRequestType::kWrite);
   bool ret = write_worker_set_->ExecuteRR(task);
   if (!ret) {
     brpc::ClosureGuard done_guard(svr_done);
@@ -609,6 +639,7 @@ void IndexServiceImpl::VectorDelete(google::protobuf::RpcController* controller,
   auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
     DoVectorDelete(storage_, controller, request, response, svr_done, true);
   });
+  ServiceHelper::SetTaskQos(task, svr_done->GetRegion(), QosRequestType::kWrite);
   bool ret = write_worker_set_->ExecuteRR(task);
   if (!ret) {
     brpc::ClosureGuard done_guard(svr_done);
@@ -684,6 +715,7 @@ void IndexServiceImpl::VectorGetBorderId(google::protobuf::RpcController* contro
   auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
     DoVectorGetBorderId(storage_, controller, request, response, svr_done);
   });
+  ServiceHelper::SetTaskQos(task, svr_done->GetRegion(), QosRequestType::kPointRead);
   bool ret = read_worker_set_->ExecuteRR(task);
   if (!ret) {
     brpc::ClosureGuard done_guard(svr_done);
@@ -793,6 +825,7 @@ void IndexServiceImpl::VectorScanQuery(google::protobuf::RpcController* controll
   auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
     DoVectorScanQuery(storage_, controller, request, response, svr_done);
   });
+  ServiceHelper::SetTaskQos(task, svr_done->GetRegion(), QosRequestType::kScan);
   bool ret = read_worker_set_->ExecuteRR(task);
   if (!ret) {
     brpc::ClosureGuard done_guard(svr_done);
@@ -879,6 +912,7 @@ void IndexServiceImpl::VectorGetRegionMetrics(google::protobuf::RpcController* c
   auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
     DoVectorGetRegionMetrics(storage_, controller, request, response, svr_done);
   });
+  ServiceHelper::SetTaskQos(task, svr_done->GetRegion(), QosRequestType::kPointRead);
   bool ret = read_worker_set_->ExecuteRR(task);
   if (!ret) {
     brpc::ClosureGuard done_guard(svr_done);
@@ -991,6 +1025,7 @@ void IndexServiceImpl::VectorCount(google::protobuf::RpcController* controller,
   auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
     DoVectorCount(storage_, controller, request, response, svr_done);
   });
+  ServiceHelper::SetTaskQos(task, svr_done->GetRegion(), QosRequestType::kScan);
   bool ret = read_worker_set_->ExecuteRR(task);
   if (!ret) {
     brpc::ClosureGuard done_guard(svr_done);
@@ -1120,8 +1155,9 @@ void DoVectorSearchDebug(StoragePtr storage, google::protobuf::RpcController* co
     return;
   }
 
+  response->mutable_batch_results()->Reserve(vector_results.size());
   for (auto& vector_result : vector_results) {
-    *(response->add_batch_results()) = vector_result;
+    response->add_batch_results()->Swap(&vector_result);
   }
   response->set_deserialization_id_time_us(deserialization_id_time_us);
   response->set_scan_scalar_time_us(scan_scalar_time_us);
@@ -1146,6 +1182,7 @@ void IndexServiceImpl::VectorSearchDebug(google::protobuf::RpcController* contro
   auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
     DoVectorSearchDebug(storage_, controller, request, response, svr_done);
   });
+  ServiceHelper::SetTaskQos(task, svr_done->GetRegion(), QosRequestType::kVectorSearch);
   bool ret = read_worker_set_->ExecuteRR(task);
   if (!ret) {
     brpc::ClosureGuard done_guard(svr_done);
@@ -1253,6 +1290,7 @@ void IndexServiceImpl::TxnGet(google::protobuf::RpcController* controller, const
   auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
     DoTxnGetVector(storage_, controller, request, response, svr_done);
   });
+  ServiceHelper::SetTaskQos(task, svr_done->GetRegion(), QosRequestType::kPointRead);
   bool ret = read_worker_set_->ExecuteRR(task);
   if (!ret) {
     brpc::ClosureGuard done_guard(svr_done);
@@ -1384,6 +1422,7 @@ void IndexServiceImpl::TxnScan(google::protobuf::RpcController* controller, cons
   auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
     DoTxnScanVector(storage_, controller, request, response, svr_done);
   });
+  ServiceHelper::SetTaskQos(task, svr_done->GetRegion(), QosRequestType::kScan);
   bool ret = read_worker_set_->ExecuteRR(task);
   if (!ret) {
     brpc::ClosureGuard done_guard(svr_done);
@@ -1394,7 +1433,8 @@ void IndexServiceImpl::TxnScan(google::protobuf::RpcController* controller, cons
 
 butil::Status ValidateTxnPessimisticLockRequest(const dingodb::pb::store::TxnPessimisticLockRequest* request);
 
-void DoTxnPessimisticLock(StoragePtr storage, google::protobuf::RpcController* controller,
+void DoTxnPessimisticLock(StoragePtr storage, SimpleWorkerSetPtr worker_set,
+                          google::protobuf::RpcController* controller,
                           const dingodb::pb::store::TxnPessimisticLockRequest* request,
                           dingodb::pb::store::TxnPessimisticLockResponse* response, TrackClosure* done, bool is_sync);
 
@@ -1418,8 +1458,9 @@ void IndexServiceImpl::TxnPessimisticLock(google::protobuf::RpcController* contr
 
   // Run in queue.
   auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
-    DoTxnPessimisticLock(storage_, controller, request, response, svr_done, true);
+    DoTxnPessimisticLock(storage_, write_worker_set_, controller, request, response, svr_done, true);
   });
+  ServiceHelper::SetTaskQos(task, svr_done->GetRegion(), QosRequestType::kWrite);
   bool ret = write_worker_set_->ExecuteRR(task);
   if (!ret) {
     brpc::ClosureGuard done_guard(svr_done);
@@ -1457,6 +1498,7 @@ void IndexServiceImpl::TxnPessimisticRollback(google::protobuf::RpcController* c
   auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
     DoTxnPessimisticRollback(storage_, controller, request, response, svr_done, true);
   });
+  ServiceHelper::SetTaskQos(task, svr_done->GetRegion(), QosRequestType::kWrite);
   bool ret = write_worker_set_->ExecuteRR(task);
   if (!ret) {
     brpc::ClosureGuard done_guard(svr_done);
@@ -1587,7 +1629,8 @@ static butil::Status ValidateIndexTxnPrewriteRequest(StoragePtr storage, const p
           vector_index_wrapper->Type() == pb::common::VectorIndexType::VECTOR_INDEX_TYPE_FLAT ||
           vector_index_wrapper->Type() == pb::common::VectorIndexType::VECTOR_INDEX_TYPE_BRUTEFORCE ||
           vector_index_wrapper->Type() == pb::common::VectorIndexType::VECTOR_INDEX_TYPE_IVF_FLAT ||
-          vector_index_wrapper->Type() == pb::common::VectorIndexType::VECTOR_INDEX_TYPE_IVF_PQ) {
+          vector_index_wrapper->Type() == pb::common::VectorIndexType::VECTOR_INDEX_TYPE_IVF_PQ ||
+          vector_index_wrapper->Type() == pb::common::VectorIndexType::VECTOR_INDEX_TYPE_DISKANN) {
         if (BAIDU_UNLIKELY(vector.vector().float_values().size() != dimension)) {
           return butil::Status(
               pb::error::EILLEGAL_PARAMTETERS,
@@ -1743,6 +1786,7 @@ void IndexServiceImpl::TxnPrewrite(google::protobuf::RpcController* controller,
   auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
     DoTxnPrewriteVector(storage_, controller, request, response, svr_done, true);
   });
+  ServiceHelper::SetTaskQos(task, svr_done->GetRegion(), QosRequestType::kWrite);
   bool ret = write_worker_set_->ExecuteRR(task);
   if (!ret) {
     brpc::ClosureGuard done_guard(svr_done);
@@ -1862,6 +1906,7 @@ void IndexServiceImpl::TxnCommit(google::protobuf::RpcController* controller,
   auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
     DoTxnCommit(storage_, controller, request, response, svr_done, true);
   });
+  ServiceHelper::SetTaskQos(task, svr_done->GetRegion(), QosRequestType::kWrite);
   bool ret = write_worker_set_->ExecuteRR(task);
   if (!ret) {
     brpc::ClosureGuard done_guard(svr_done);
@@ -1960,6 +2005,7 @@ void IndexServiceImpl::TxnCheckTxnStatus(google::protobuf::RpcController* contro
   auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
     DoTxnCheckTxnStatus(storage_, controller, request, response, svr_done, true);
   });
+  ServiceHelper::SetTaskQos(task, svr_done->GetRegion(), QosRequestType::kWrite);
   bool ret = write_worker_set_->ExecuteRR(task);
   if (!ret) {
     brpc::ClosureGuard done_guard(svr_done);
@@ -2060,6 +2106,7 @@ void IndexServiceImpl::TxnResolveLock(google::protobuf::RpcController* controlle
   auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
     DoTxnResolveLock(storage_, controller, request, response, svr_done, true);
   });
+  ServiceHelper::SetTaskQos(task, svr_done->GetRegion(), QosRequestType::kWrite);
   bool ret = write_worker_set_->ExecuteRR(task);
   if (!ret) {
     brpc::ClosureGuard done_guard(svr_done);
@@ -2179,6 +2226,7 @@ void IndexServiceImpl::TxnBatchGet(google::protobuf::RpcController* controller,
   auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
     DoTxnBatchGetVector(storage_, controller, request, response, svr_done);
   });
+  ServiceHelper::SetTaskQos(task, svr_done->GetRegion(), QosRequestType::kPointRead);
   bool ret = read_worker_set_->ExecuteRR(task);
   if (!ret) {
     brpc::ClosureGuard done_guard(svr_done);
@@ -2249,6 +2297,7 @@ void IndexServiceImpl::TxnBatchRollback(google::protobuf::RpcController* control
   auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
     DoTxnBatchRollback(storage_, controller, request, response, svr_done, true);
   });
+  ServiceHelper::SetTaskQos(task, svr_done->GetRegion(), QosRequestType::kWrite);
   bool ret = write_worker_set_->ExecuteRR(task);
   if (!ret) {
     brpc::ClosureGuard done_guard(svr_done);
@@ -2318,6 +2367,7 @@ void IndexServiceImpl::TxnScanLock(google::protobuf::RpcController* controller,
   auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
     DoTxnScanLock(storage_, controller, request, response, svr_done);
   });
+  ServiceHelper::SetTaskQos(task, svr_done->GetRegion(), QosRequestType::kScan);
   bool ret = read_worker_set_->ExecuteRR(task);
   if (!ret) {
     brpc::ClosureGuard done_guard(svr_done);
@@ -2382,6 +2432,7 @@ void IndexServiceImpl::TxnHeartBeat(google::protobuf::RpcController* controller,
   auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
     DoTxnHeartBeat(storage_, controller, request, response, svr_done, true);
   });
+  ServiceHelper::SetTaskQos(task, svr_done->GetRegion(), QosRequestType::kWrite);
   bool ret = write_worker_set_->ExecuteRR(task);
   if (!ret) {
     brpc::ClosureGuard done_guard(svr_done);
@@ -2445,6 +2496,7 @@ void IndexServiceImpl::TxnGc(google::protobuf::RpcController* controller, const
   auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
     DoTxnGc(storage_, controller, request, response, svr_done, true);
   });
+  ServiceHelper::SetTaskQos(task, svr_done->GetRegion(), QosRequestType::kWrite);
   bool ret = write_worker_set_->ExecuteRR(task);
   if (!ret) {
     brpc::ClosureGuard done_guard(svr_done);
@@ -2505,6 +2557,7 @@ void IndexServiceImpl::TxnDeleteRange(google::protobuf::RpcController* controlle
   auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
     DoTxnDeleteRange(storage_, controller, request, response, svr_done, true);
   });
+  ServiceHelper::SetTaskQos(task, svr_done->GetRegion(), QosRequestType::kWrite);
   bool ret = write_worker_set_->ExecuteRR(task);
   if (!ret) {
     brpc::ClosureGuard done_guard(svr_done);
@@ -2559,6 +2612,7 @@ void IndexServiceImpl::TxnDump(google::protobuf::RpcController* controller, cons
   auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
     DoTxnDump(storage_, controller, request, response, svr_done);
   });
+  ServiceHelper::SetTaskQos(task, svr_done->GetRegion(), QosRequestType::kScan);
   bool ret = read_worker_set_->ExecuteRR(task);
   if (!ret) {
     brpc::ClosureGuard done_guard(svr_done);
@@ -2628,6 +2682,7 @@ void IndexServiceImpl::Hello(google::protobuf::RpcController* controller, const
 
   auto task = std::make_shared<ServiceTask>([=]() { DoHello(controller, request, response, svr_done); });
 
+  ServiceHelper::SetTaskQos(task, svr_done->GetRegion(), QosRequestType::kPointRead);
   bool ret = read_worker_set_->ExecuteRR(task);
   if (!ret) {
     brpc::ClosureGuard done_guard(svr_done);
@@ -2645,6 +2700,7 @@ void IndexServiceImpl::GetMemoryInfo(google::protobuf::RpcController* controller
 
   auto task = std::make_shared<ServiceTask>([=]() { DoHello(controller, request, response, svr_done, true); });
 
+  ServiceHelper::SetTaskQos(task, svr_done->GetRegion(), QosRequestType::kPointRead);
   bool ret = read_worker_set_->ExecuteRR(task);
   if (!ret) {
     brpc::ClosureGuard done_guard(svr_done);
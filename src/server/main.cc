@@ -48,6 +48,7 @@
 #include "common/constant.h"
 #include "common/helper.h"
 #include "common/logging.h"
+#include "common/rdma_transport.h"
 #include "common/role.h"
 #include "common/syscheck.h"
 #include "common/version.h"
@@ -1001,6 +1002,8 @@ int main(int argc, char *argv[]) {
   options.h2_settings.max_frame_size = FLAGS_h2_server_max_frame_size;
   options.h2_settings.max_header_list_size = FLAGS_h2_server_max_header_list_size;
   // options.idle_timeout_sec = 30;
+  // raft replication and index service over rdma if enabled
+  dingodb::RdmaTransport::SetServerOptions(options);
 
   DINGO_LOG(INFO) << "h2_settings.max_concurrent_streams: " << options.h2_settings.max_concurrent_streams;
   DINGO_LOG(INFO) << "h2_settings.stream_window_size: " << options.h2_settings.stream_window_size;
@@ -100,7 +100,7 @@ void DoGetSchema(google::protobuf::RpcController * /*controller*/, const pb::met
                  std::shared_ptr<CoordinatorControl> coordinator_control, std::shared_ptr<Engine> /*raft_engine*/) {
   brpc::ClosureGuard done_guard(done);
 
-  if (!coordinator_control->IsLeader()) {
+  if (!coordinator_control->CanServeRead()) {
     return coordinator_control->RedirectResponse(response);
   }
 
@@ -217,7 +217,7 @@ void DoGetTable(google::protobuf::RpcController * /*controller*/, const pb::meta
                 std::shared_ptr<CoordinatorControl> coordinator_control, std::shared_ptr<Engine> /*raft_engine*/) {
   brpc::ClosureGuard done_guard(done);
 
-  if (!coordinator_control->IsLeader()) {
+  if (!coordinator_control->CanServeRead()) {
     return coordinator_control->RedirectResponse(response);
   }
 
@@ -1008,7 +1008,7 @@ void DoGetIndex(google::protobuf::RpcController * /*controller*/, const pb::meta
                 std::shared_ptr<CoordinatorControl> coordinator_control, std::shared_ptr<Engine> /*raft_engine*/) {
   brpc::ClosureGuard done_guard(done);
 
-  if (!coordinator_control->IsLeader()) {
+  if (!coordinator_control->CanServeRead()) {
     return coordinator_control->RedirectResponse(response);
   }
 
@@ -1072,7 +1072,7 @@ void DoGetIndexRange(google::protobuf::RpcController * /*controller*/, const pb:
                      std::shared_ptr<CoordinatorControl> coordinator_control, std::shared_ptr<Engine> /*raft_engine*/) {
   brpc::ClosureGuard done_guard(done);
 
-  if (!coordinator_control->IsLeader()) {
+  if (!coordinator_control->CanServeRead()) {
     return coordinator_control->RedirectResponse(response);
   }
 
@@ -2158,7 +2158,7 @@ void MetaServiceImpl::GetSchema(google::protobuf::RpcController *controller, con
                                 pb::meta::GetSchemaResponse *response, google::protobuf::Closure *done) {
   brpc::ClosureGuard done_guard(done);
 
-  if (!this->coordinator_control_->IsLeader()) {
+  if (!this->coordinator_control_->CanServeRead()) {
     return RedirectResponse(response);
   }
 
@@ -2265,7 +2265,7 @@ void MetaServiceImpl::GetTable(google::protobuf::RpcController *controller, cons
                                pb::meta::GetTableResponse *response, google::protobuf::Closure *done) {
   brpc::ClosureGuard done_guard(done);
 
-  if (!this->coordinator_control_->IsLeader()) {
+  if (!this->coordinator_control_->CanServeRead()) {
     return RedirectResponse(response);
   }
 
@@ -2751,7 +2751,7 @@ void MetaServiceImpl::GetIndex(google::protobuf::RpcController *controller, cons
                                pb::meta::GetIndexResponse *response, google::protobuf::Closure *done) {
   brpc::ClosureGuard done_guard(done);
 
-  if (!this->coordinator_control_->IsLeader()) {
+  if (!this->coordinator_control_->CanServeRead()) {
     return RedirectResponse(response);
   }
 
@@ -2808,7 +2808,7 @@ void MetaServiceImpl::GetIndexRange(google::protobuf::RpcController *controller,
                                     pb::meta::GetIndexRangeResponse *response, google::protobuf::Closure *done) {
   brpc::ClosureGuard done_guard(done);
 
-  if (!this->coordinator_control_->IsLeader()) {
+  if (!this->coordinator_control_->CanServeRead()) {
     return RedirectResponse(response);
   }
 
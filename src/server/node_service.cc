@@ -26,7 +26,9 @@
 #include "common/helper.h"
 #include "common/logging.h"
 #include "common/role.h"
+#include "common/service_access.h"
 #include "fmt/core.h"
+#include "gflags/gflags.h"
 #include "metrics/dingo_bvar.h"
 #include "proto/common.pb.h"
 #include "proto/error.pb.h"
@@ -40,6 +42,9 @@
 #endif
 
 namespace dingodb {
+
+DECLARE_bool(vector_index_ship_snapshot);
+
 using pb::error::Errno;
 using pb::node::LogDetail;
 
@@ -90,12 +95,16 @@ void NodeServiceImpl::GetRegionInfo(google::protobuf::RpcController*, const pb::
   }
 }
 
-void NodeServiceImpl::GetRaftStatus(google::protobuf::RpcController* /*controller*/,
+void NodeServiceImpl::GetRaftStatus(google::protobuf::RpcController* controller,
                                     const pb::node::GetRaftStatusRequest* request,
                                     pb::node::GetRaftStatusResponse* response, google::protobuf::Closure* done) {
+  brpc::Controller* cntl = (brpc::Controller*)controller;
   auto* svr_done = new NoContextServiceClosure(__func__, done, request, response);
   brpc::ClosureGuard const done_guard(svr_done);
 
+  // The committed index is a read index only when the leader is sure no other leader exists, i.e. its lease is valid.
+  bool is_read_index = ServiceAccess::IsReadIndexRequest(cntl->request_attachment());
+
   auto engine = Server::GetInstance().GetRaftStoreEngine();
   if (engine == nullptr) {
     ServiceHelper::SetError(response->mutable_error(), pb::error::EENGINE_NOT_FOUND, "Not found raft store engine");
@@ -109,6 +118,10 @@ void NodeServiceImpl::GetRaftStatus(google::protobuf::RpcController* /*controlle
                               fmt::format("Not found raft node {}", region_id));
       return;
     }
+    if (is_read_index && (!node->IsLeader() || !node->IsLeaderLeaseValid())) {
+      ServiceHelper::SetError(response->mutable_error(), pb::error::ERAFT_NOTLEADER, node->GetLeaderId().to_string());
+      return;
+    }
 
     auto* entry = response->add_entries();
     entry->set_region_id(region_id);
@@ -430,6 +443,9 @@ void NodeServiceImpl::InstallVectorIndexSnapshot(google::protobuf::RpcController
                                                              vector_index_wrapper->SnapshotSet());
   if (!status.ok()) {
     ServiceHelper::SetError(response->mutable_error(), status.error_code(), status.error_str());
+  } else if (FLAGS_vector_index_ship_snapshot && !vector_index_wrapper->IsOwnReady()) {
+    // Load the shipped snapshot instead of building vector index.
+    VectorIndexManager::LaunchLoadAsyncBuildVectorIndex(vector_index_wrapper, false, false, 0, "install snapshot");
   }
 
   DINGO_LOG(INFO) << fmt::format("InstallVectorIndexSnapshot request: {} response: {}", request->ShortDebugString(),
@@ -15,12 +15,15 @@
 #include "server/push_service.h"
 
 #include <cstdint>
+#include <memory>
+#include <vector>
 
 #include "butil/status.h"
 #include "common/context.h"
 #include "common/helper.h"
 #include "common/logging.h"
 #include "fmt/core.h"
+#include "gflags/gflags.h"
 #include "proto/coordinator.pb.h"
 #include "proto/error.pb.h"
 #include "proto/push.pb.h"
@@ -31,6 +34,9 @@
 
 namespace dingodb {
 
+DEFINE_bool(enable_push_region_cmd_batch_dispatch, false,
+            "save the region commands of one push store operation in one meta write and dispatch them together");
+
 PushServiceImpl::PushServiceImpl() = default;
 
 void PushServiceImpl::PushHeartbeat(google::protobuf::RpcController* controller,
@@ -80,6 +86,7 @@ void PushServiceImpl::PushStoreOperation(google::protobuf::RpcController* contro
   };
 
   auto region_controller = Server::GetInstance().GetRegionController();
+  std::vector<RegionCmdPtr> batch_commands;
   for (const auto& command : request->store_operation().region_cmds()) {
     butil::Status status;
     auto store_meta_manager = Server::GetInstance().GetStoreMetaManager();
@@ -94,6 +101,11 @@ void PushServiceImpl::PushStoreOperation(google::protobuf::RpcController* contro
       continue;
     }
 
+    if (FLAGS_enable_push_region_cmd_batch_dispatch) {
+      batch_commands.push_back(std::make_shared<pb::coordinator::RegionCmd>(command));
+      continue;
+    }
+
     std::shared_ptr<Context> ctx = std::make_shared<Context>();
     status =
         region_controller->DispatchRegionControlCommand(ctx, std::make_shared<pb::coordinator::RegionCmd>(command));
@@ -105,6 +117,19 @@ void PushServiceImpl::PushStoreOperation(google::protobuf::RpcController* contro
     error_func(command.id(), command.region_cmd_type(), status);
   }
 
+  // save the validated commands in one meta write, then dispatch them
+  if (!batch_commands.empty()) {
+    auto statuses = region_controller->DispatchRegionControlCommands(batch_commands);
+    for (size_t i = 0; i < batch_commands.size(); ++i) {
+      const auto& command = batch_commands[i];
+      if (!statuses[i].ok()) {
+        DINGO_LOG(ERROR) << fmt::format("[push.store] dispatch failed, error: {} command: {}", statuses[i].error_str(),
+                                        command->ShortDebugString());
+      }
+      error_func(command->id(), command->region_cmd_type(), statuses[i]);
+    }
+  }
+
   if (!response->region_cmd_results().empty()) {
     for (const auto& cmd_result : response->region_cmd_results()) {
       if (cmd_result.error().errcode() != 0) {
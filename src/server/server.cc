@@ -14,8 +14,10 @@
 
 #include "server/server.h"
 
+#include <algorithm>
 #include <cassert>
 #include <cstdint>
+#include <filesystem>
 #include <memory>
 #include <vector>
 
@@ -25,6 +27,7 @@
 #include "common/constant.h"
 #include "common/helper.h"
 #include "common/logging.h"
+#include "common/profiler.h"
 #include "common/role.h"
 #include "common/version.h"
 #include "config/config.h"
@@ -32,8 +35,11 @@
 #include "config/yaml_config.h"
 #include "coordinator/coordinator_control.h"
 #include "engine/bdb_raw_engine.h"
+#include "engine/checkpoint_backup.h"
 #include "engine/engine.h"
 #include "engine/raft_store_engine.h"
+#include "engine/region_compaction.h"
+#include "engine/resolved_ts.h"
 #include "engine/rocks_raw_engine.h"
 #include "event/store_state_machine_event.h"
 #include "fmt/core.h"
@@ -43,24 +49,38 @@
 #include "coordinator/balance_leader.h"
 #include "engine/mono_store_engine.h"
 #include "engine/txn_engine_helper.h"
+#include "engine/txn_lock_index.h"
 #include "gflags/gflags.h"
 #include "glog/logging.h"
+#include "log/index_journal.h"
 #include "meta/meta_reader.h"
 #include "meta/meta_writer.h"
+#include "metrics/region_counter_metrics.h"
 #include "proto/common.pb.h"
 #include "proto/node.pb.h"
 #include "scan/scan_manager.h"
 #include "store/heartbeat.h"
 #include "store/region_controller.h"
+#include "store/region_heat.h"
 
 DEFINE_string(coor_url, "",
               "coor service name, e.g. file://<path>, list://<addr1>,<addr2>..., bns://<bns-name>, "
               "consul://<service-name>, http://<url>, https://<url>");
 
+DECLARE_int32(raft_quiesce_stretch_factor);
+
 namespace dingodb {
 
 DECLARE_int64(compaction_retention_rev_count);
 DECLARE_bool(auto_compaction);
+DECLARE_int64(document_index_group_commit_interval_ms);
+DECLARE_int32(document_index_memory_budget_interval_s);
+DECLARE_int32(resolved_ts_advance_interval_s);
+DECLARE_int32(continuous_profiler_interval_s);
+DECLARE_int32(checkpoint_backup_interval_s);
+DECLARE_int32(region_heat_save_interval_s);
+DECLARE_int64(meta_write_batch_interval_ms);
+DECLARE_int64(store_region_metrics_fold_interval_ms);
 
 DEFINE_bool(ip2hostname, false, "resolve ip to hostname for get map api");
 DEFINE_bool(enable_ip2hostname_cache, true, "enable ip2hostname cache");
@@ -71,6 +91,8 @@ DEFINE_int32(document_operation_parallel_thread_num, 1, "document operation para
 DEFINE_string(pid_file_name, "pid", "pid file name");
 
 DEFINE_int32(omp_num_threads, 1, "omp num threads");
+DEFINE_bool(enable_vector_index_numa_affinity, false,
+            "bind vector index threads to numa node, and run index operation on the node of region");
 
 DEFINE_int32(server_heartbeat_interval_s, 10, "heartbeat interval seconds");
 DEFINE_int32(server_metrics_collect_interval_s, 300, "metrics collect interval seconds");
@@ -92,14 +114,18 @@ DEFINE_int32(coordinator_lease_interval_s, 1, "coordinator lease interval second
 DEFINE_int32(coordinator_compaction_interval_s, 300, "coordinator compaction interval seconds");
 DEFINE_int32(server_scrub_vector_index_interval_s, 60, "scrub vector index interval seconds");
 DEFINE_int32(raft_snapshot_interval_s, 120, "raft snapshot interval seconds");
+DEFINE_int32(raft_quiesce_check_interval_s, 10, "raft quiesce idle leader check interval seconds");
 DEFINE_int32(gc_update_safe_point_interval_s, 60, "gc update safe point interval seconds");
 DEFINE_int32(gc_do_gc_interval_s, 60, "gc do gc interval seconds");
+DEFINE_int32(region_compaction_interval_s, 600, "region compaction interval seconds");
 DEFINE_int32(balance_leader_interval_s, 60, "balance leader interval seconds");
 DEFINE_int32(recycle_task_list_interval_s, 60, "recycle task list interval seconds");
+DEFINE_int32(region_merge_interval_s, 300, "region merge interval seconds");
 
 DEFINE_int32(server_scrub_document_index_interval_s, 60, "scrub document index interval seconds");
 
 DEFINE_bool(enable_balance_leader, true, "enable balance leader");
+DECLARE_bool(enable_region_merge);
 
 extern "C" {
 extern void omp_set_num_threads(int) noexcept;  // NOLINT
@@ -341,6 +367,13 @@ bool Server::InitEngine() {
     tso_control_->SetKvEngine(raft_engine_);
 
   } else {
+    // load lock cf before region start apply
+    if (TxnLockIndex::IsEnabled()) {
+      TxnLockIndex::GetInstance().Build(raw_rocks_engine, pb::common::Range());
+      TxnLockIndex::GetInstance().Build(raw_bdb_engine, pb::common::Range());
+      TxnLockIndex::GetInstance().EndBuild();
+    }
+
     auto listener_factory = std::make_shared<StoreSmEventListenerFactory>();
     rocks_engine_ = std::make_shared<MonoStoreEngine>(raw_rocks_engine, raw_bdb_engine, listener_factory->Build());
     if (!rocks_engine_->Init(config)) {
@@ -428,6 +461,24 @@ bool Server::InitCoordinatorInteractionForAutoIncrement() {
 
 bool Server::InitLogStorageManager() {
   log_storage_ = std::make_shared<LogStorageManager>();
+
+  // index journal is beside raft log, load before raft log storage init
+  std::string raft_log_path = GetRaftLogPath();
+  while (raft_log_path.size() > 1 && raft_log_path.back() == '/') {
+    raft_log_path.pop_back();
+  }
+  if (!raft_log_path.empty()) {
+    auto parent_path = std::filesystem::path(raft_log_path).parent_path();
+    if (parent_path.empty()) {
+      parent_path = ".";
+    }
+    std::string journal_path = (parent_path / "index_journal").string();
+    if (!IndexJournalManager::GetInstance().Init(journal_path)) {
+      DINGO_LOG(ERROR) << "Init index journal manager failed, path: " << journal_path;
+      return false;
+    }
+  }
+
   return true;
 }
 
@@ -449,6 +500,7 @@ static int32_t GetInterval(std::shared_ptr<Config> config, const std::string& co
 
 bool Server::InitCrontabManager() {
   crontab_manager_ = std::make_shared<CrontabManager>();
+  crontab_manager_->SetLoadProbe([]() -> int64_t { return Server::GetInstance().GetForegroundQueueWaitUs(); });
   auto config = ConfigManager::GetInstance().GetRoleConfig();
 
   // Add heartbeat crontab
@@ -473,6 +525,19 @@ bool Server::InitCrontabManager() {
       [](void*) { Server::GetInstance().GetStoreMetricsManager()->CollectStoreRegionMetrics(); },
   });
 
+  // Add compact region counter metrics fold crontab
+  crontab_configs_.push_back({
+      "REGION_COUNTER_METRICS",
+      {pb::common::STORE, pb::common::INDEX, pb::common::DOCUMENT},
+      FLAGS_store_region_metrics_fold_interval_ms,
+      true,
+      [](void*) {
+        if (RegionCounterMetrics::IsEnabled()) {
+          RegionCounterMetrics::GetInstance().Fold();
+        }
+      },
+  });
+
   // Add store metrics crontab
   FLAGS_server_store_metrics_collect_interval_s =
       GetInterval(config, "server.store_metrics_collect_interval_s", FLAGS_server_store_metrics_collect_interval_s);
@@ -494,6 +559,7 @@ bool Server::InitCrontabManager() {
       FLAGS_server_approximate_size_metrics_collect_interval_s * 1000,
       true,
       [](void*) { Server::GetInstance().GetStoreMetricsManager()->CollectApproximateSizeMetrics(); },
+      CrontabCost::kHeavy,
   });
 
   // Add scan crontab
@@ -537,6 +603,7 @@ bool Server::InitCrontabManager() {
           FLAGS_region_split_check_interval_s * 1000,
           true,
           [](void*) { PreSplitChecker::TriggerPreSplitCheck(nullptr); },
+          CrontabCost::kHeavy,
       });
     }
   }
@@ -651,6 +718,7 @@ bool Server::InitCrontabManager() {
       FLAGS_coordinator_compaction_interval_s * 1000,
       true,
       [](void*) { Heartbeat::TriggerCompactionTask(nullptr); },
+      CrontabCost::kHeavy,
   });
 
   // Add scrub vector index crontab
@@ -662,6 +730,7 @@ bool Server::InitCrontabManager() {
       FLAGS_server_scrub_vector_index_interval_s * 1000,
       true,
       [](void*) { Heartbeat::TriggerScrubVectorIndex(nullptr); },
+      CrontabCost::kHeavy,
   });
 
   // Add scrub document index crontab
@@ -673,6 +742,25 @@ bool Server::InitCrontabManager() {
       FLAGS_server_scrub_document_index_interval_s * 1000,
       true,
       [](void*) { Heartbeat::TriggerScrubVectorIndex(nullptr); },
+      CrontabCost::kHeavy,
+  });
+
+  // Add document index group commit crontab
+  crontab_configs_.push_back({
+      "DOCUMENT_INDEX_GROUP_COMMIT",
+      {pb::common::DOCUMENT},
+      static_cast<int32_t>(std::max(FLAGS_document_index_group_commit_interval_ms, static_cast<int64_t>(100))),
+      true,
+      [](void*) { Heartbeat::TriggerDocumentIndexGroupCommit(nullptr); },
+  });
+
+  // Add document index memory budget crontab
+  crontab_configs_.push_back({
+      "DOCUMENT_INDEX_MEMORY_BUDGET",
+      {pb::common::DOCUMENT},
+      FLAGS_document_index_memory_budget_interval_s * 1000,
+      true,
+      [](void*) { Heartbeat::TriggerDocumentIndexMemoryBudget(nullptr); },
   });
 
   auto raft_store_engine = GetRaftStoreEngine();
@@ -685,7 +773,19 @@ bool Server::InitCrontabManager() {
         FLAGS_raft_snapshot_interval_s * 1000,
         true,
         [](void*) { Server::GetInstance().GetRaftStoreEngine()->DoSnapshotPeriodicity(); },
+        CrontabCost::kHeavy,
     });
+
+    // Add raft quiesce crontab
+    if (FLAGS_raft_quiesce_stretch_factor > 1) {
+      crontab_configs_.push_back({
+          "RAFT_QUIESCE",
+          {pb::common::STORE, pb::common::INDEX, pb::common::DOCUMENT},
+          FLAGS_raft_quiesce_check_interval_s * 1000,
+          true,
+          [](void*) { Server::GetInstance().GetRaftStoreEngine()->QuiesceIdleNodes(); },
+      });
+    }
   }
 
   // Add gc update safe point ts crontab
@@ -707,8 +807,32 @@ bool Server::InitCrontabManager() {
       FLAGS_gc_do_gc_interval_s * 1000,
       true,
       [](void*) { TxnEngineHelper::RegularDoGcHandler(nullptr); },
+      CrontabCost::kHeavy,
   });
 
+  if (RegionCompactionScheduler::IsEnabled()) {
+    // Add region compaction crontab
+    crontab_configs_.push_back({
+        "REGION_COMPACTION",
+        {pb::common::STORE, pb::common::INDEX, pb::common::DOCUMENT},
+        FLAGS_region_compaction_interval_s * 1000,
+        true,
+        [](void*) { RegionCompactionScheduler::GetInstance().Schedule(); },
+        CrontabCost::kHeavy,
+    });
+  }
+
+  if (RegionResolvedTs::IsEnabled()) {
+    // Add advance resolved ts crontab
+    crontab_configs_.push_back({
+        "ADVANCE_RESOLVED_TS",
+        {pb::common::STORE},
+        FLAGS_resolved_ts_advance_interval_s * 1000,
+        true,
+        [](void*) { TxnEngineHelper::RegularAdvanceResolvedTsHandler(nullptr); },
+    });
+  }
+
   if (FLAGS_enable_balance_leader) {
     // Add balance leader crontab
     FLAGS_balance_leader_interval_s =
@@ -722,6 +846,19 @@ bool Server::InitCrontabManager() {
     });
   }
 
+  if (FLAGS_enable_region_merge) {
+    // Add region merge crontab
+    FLAGS_region_merge_interval_s =
+        GetInterval(config, "coordinator.region_merge_interval_s", FLAGS_region_merge_interval_s);
+    crontab_configs_.push_back({
+        "REGION_MERGE",
+        {pb::common::COORDINATOR},
+        FLAGS_region_merge_interval_s * 1000,
+        true,
+        [](void*) { Heartbeat::TriggerRegionMerge(nullptr); },
+    });
+  }
+
   // recycle
   FLAGS_recycle_task_list_interval_s =
       GetInterval(config, "coordinator.recycle_task_list_interval_s", FLAGS_recycle_task_list_interval_s);
@@ -735,6 +872,52 @@ bool Server::InitCrontabManager() {
         coordinator_control->RecycleArchiveTaskList();
       },
   });
+
+  if (RegionHeat::IsEnabled()) {
+    // Add region heat crontab
+    crontab_configs_.push_back({
+        "REGION_HEAT",
+        {pb::common::STORE, pb::common::INDEX, pb::common::DOCUMENT},
+        std::max(FLAGS_region_heat_save_interval_s, 1) * 1000,
+        true,
+        [](void*) { RegionHeat::GetInstance().Save(); },
+    });
+  }
+
+  if (MetaWriter::IsBatchEnabled()) {
+    // Add meta write batch flush crontab
+    crontab_configs_.push_back({
+        "META_WRITE_FLUSH",
+        {pb::common::STORE, pb::common::INDEX, pb::common::DOCUMENT},
+        std::max(FLAGS_meta_write_batch_interval_ms, static_cast<int64_t>(10)),
+        true,
+        [](void*) { Server::GetInstance().GetMetaWriter()->Flush(); },
+    });
+  }
+
+  if (ContinuousProfiler::IsEnabled()) {
+    // Add continuous profiler crontab
+    crontab_configs_.push_back({
+        "CONTINUOUS_PROFILER",
+        {pb::common::COORDINATOR, pb::common::STORE, pb::common::INDEX, pb::common::DOCUMENT},
+        std::max(FLAGS_continuous_profiler_interval_s, 10) * 1000,
+        true,
+        [](void*) { ContinuousProfiler::GetInstance().Run(); },
+    });
+  }
+
+  if (CheckpointBackup::IsEnabled()) {
+    // Add checkpoint backup crontab
+    crontab_configs_.push_back({
+        "CHECKPOINT_BACKUP",
+        {pb::common::STORE, pb::common::INDEX, pb::common::DOCUMENT},
+        std::max(FLAGS_checkpoint_backup_interval_s, 60) * 1000,
+        true,
+        [](void*) { CheckpointBackup::GetInstance().Run(); },
+        CrontabCost::kHeavy,
+    });
+  }
+
   crontab_manager_->AddCrontab(crontab_configs_);
 
   return true;
@@ -766,7 +949,8 @@ bool Server::InitVectorIndexManager() {
         omp_set_num_threads(FLAGS_omp_num_threads);
 
         LOG(INFO) << fmt::format("omp max thread num per ancestor: {}", omp_get_max_threads());
-      });
+      },
+      FLAGS_enable_vector_index_numa_affinity);
 
   vector_index_manager_ = VectorIndexManager::New();
   return vector_index_manager_->Init();
@@ -837,6 +1021,10 @@ void Server::Destroy() {
     document_index_manager_->Destroy();
   }
 
+  if (meta_writer_) {
+    meta_writer_->Flush();
+  }
+
   google::ShutdownGoogleLogging();
 }
 
@@ -1130,6 +1318,18 @@ void Server::SetRaftApplyWorkerSet(SimpleWorkerSetPtr worker_set) { raft_apply_w
 
 SimpleWorkerSetPtr Server::GetRaftApplyWorkerSet() { return raft_apply_worker_set_; }
 
+int64_t Server::GetForegroundQueueWaitUs() {
+  int64_t queue_wait_us = 0;
+  for (const auto& worker_set : {store_service_read_worker_set_, store_service_write_worker_set_,
+                                 index_service_read_worker_set_, index_service_write_worker_set_}) {
+    if (worker_set != nullptr) {
+      queue_wait_us = std::max(queue_wait_us, worker_set->QueueWaitLatencyUs());
+    }
+  }
+
+  return queue_wait_us;
+}
+
 std::vector<std::vector<std::string>> Server::GetStoreServiceReadWorkerSetTrace() {
   if (store_service_read_worker_set_ == nullptr) {
     return {};
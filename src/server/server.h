@@ -218,6 +218,9 @@ class Server {
 
   std::vector<std::vector<std::string>> GetRaftApplyWorkerSetTrace();
 
+  // Max recent queue wait time(us) of service read/write worker sets.
+  int64_t GetForegroundQueueWaitUs();
+
   std::string GetAllWorkSetPendingTaskCount();
 
   ThreadPoolPtr GetVectorIndexThreadPool();
@@ -26,6 +26,7 @@
 #include "gflags/gflags.h"
 #include "proto/error.pb.h"
 #include "server/server.h"
+#include "split/region_load_stats.h"
 #include "vector/codec.h"
 
 namespace dingodb {
@@ -181,6 +182,10 @@ butil::Status ServiceHelper::ValidateRegion(store::RegionPtr region, const std::
     return status;
   }
 
+  if (RegionLoadStats::IsEnabled() || RegionLoadStats::IsHotKeyEnabled()) {
+    region->LoadStats().SampleKeys(keys);
+  }
+
   return butil::Status();
 }
 
@@ -24,11 +24,13 @@
 #include "common/constant.h"
 #include "common/helper.h"
 #include "common/logging.h"
+#include "common/runnable.h"
 #include "common/tracker.h"
 #include "fmt/core.h"
 #include "meta/store_meta_manager.h"
 #include "proto/error.pb.h"
 #include "server/server.h"
+#include "split/region_load_stats.h"
 
 namespace dingodb {
 
@@ -55,6 +57,11 @@ class ServiceHelper {
   static butil::Status ValidateIndexRegion(store::RegionPtr region, const std::vector<int64_t>& vector_ids);
   static butil::Status ValidateDocumentRegion(store::RegionPtr region, const std::vector<int64_t>& document_ids);
   static butil::Status ValidateClusterReadOnly();
+
+  // Set qos of service task for worker set fair queue, tenant is from region.
+  static void SetTaskQos(TaskRunnablePtr task, store::RegionPtr region, QosRequestType request_type) {
+    task->SetQos(region != nullptr ? region->TenantId() : 0, request_type);
+  }
 };
 
 template <typename T>
@@ -230,8 +237,15 @@ void ServiceClosure<T, U, need_region>::Run() {
   }
 
   if (region) {
+    TrackerStats::GetInstance().Record(method_name_, region->Id(), region->Type(), *tracker);
     region->DecServingRequestCount();
     region->UpdateLastServingTime();
+    region->IncServedRequestCount();
+    if (RegionLoadStats::IsEnabled()) {
+      region->LoadStats().AddRequest(elapsed_time);
+    }
+  } else {
+    TrackerStats::GetInstance().Record(method_name_, 0, pb::common::STORE_REGION, *tracker);
   }
 }
 
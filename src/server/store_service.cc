@@ -26,9 +26,11 @@
 #include "common/constant.h"
 #include "common/context.h"
 #include "common/helper.h"
+#include "common/pool_allocator.h"
 #include "common/synchronization.h"
 #include "common/tracker.h"
 #include "common/version.h"
+#include "engine/txn_lock_wait_manager.h"
 #include "fmt/core.h"
 #include "gflags/gflags.h"
 #include "meta/store_meta_manager.h"
@@ -44,6 +46,8 @@ namespace dingodb {
 
 DEFINE_bool(enable_async_store_kvscan, true, "enable async store kvscan");
 DEFINE_bool(enable_async_store_operation, true, "enable async store operation");
+DEFINE_bool(enable_txn_async_write, false,
+            "txn prewrite and commit not wait raft write in worker, the request is finished after apply");
 DECLARE_int64(max_scan_lock_limit);
 DECLARE_int64(max_prewrite_count);
 
@@ -54,6 +58,34 @@ DECLARE_bool(dingo_log_switch_scalar_speed_up_detail);
 
 static void StoreRpcDone(BthreadCond* cond) { cond->DecreaseSignal(); }
 
+// Hold the latches of the keys of txn write request, release them and run done when it runs.
+// For async write it is the done of raft write, the latches are held until the write is applied.
+class TxnLatchesClosure : public google::protobuf::Closure {
+ public:
+  TxnLatchesClosure(store::RegionPtr region, const std::vector<std::string>& keys, google::protobuf::Closure* done)
+      : region_(region), lock_(keys), done_(done) {}
+  ~TxnLatchesClosure() override = default;
+
+  void Acquire() {
+    uint64_t cid = (uint64_t)(&cond_);
+    while (!region_->LatchesAcquire(&lock_, cid)) {
+      cond_.IncreaseWait();
+    }
+  }
+
+  void Run() override {
+    std::unique_ptr<TxnLatchesClosure> self_guard(this);
+    brpc::ClosureGuard done_guard(done_);
+    region_->LatchesRelease(&lock_, (uint64_t)(&cond_));
+  }
+
+ private:
+  store::RegionPtr region_;
+  Lock lock_;
+  BthreadCond cond_;
+  google::protobuf::Closure* done_;
+};
+
 StoreServiceImpl::StoreServiceImpl() = default;
 
 bool StoreServiceImpl::IsRaftApplyPendingExceed() {
@@ -105,7 +137,7 @@ void DoKvGet(StoragePtr storage, google::protobuf::RpcController* controller,
     return;
   }
 
-  std::shared_ptr<Context> ctx = std::make_shared<Context>(cntl, done);
+  std::shared_ptr<Context> ctx = MakePooledShared<Context>(cntl, done);
   ctx->SetRegionId(region_id);
   ctx->SetTracker(tracker);
   ctx->SetCfName(Constant::kStoreDataCF);
@@ -113,20 +145,14 @@ void DoKvGet(StoragePtr storage, google::protobuf::RpcController* controller,
   ctx->SetRawEngineType(region->GetRawEngineType());
   ctx->SetStoreEngineType(region->GetStoreEngineType());
 
-  std::vector<std::string> keys;
-  auto* mut_request = const_cast<dingodb::pb::store::KvGetRequest*>(request);
-  keys.emplace_back(std::move(*mut_request->release_key()));
-
-  std::vector<pb::common::KeyValue> kvs;
-  status = storage->KvGet(ctx, keys, kvs);
+  // copy the value from engine memory into response once.
+  status = storage->KvGetPinned(ctx, request->key(), [response](std::string_view value) {
+    response->set_value(value.data(), value.size());
+  });
   if (!status.ok()) {
     ServiceHelper::SetError(response->mutable_error(), status.error_code(), status.error_str());
     return;
   }
-
-  if (!kvs.empty()) {
-    response->set_value(kvs[0].value());
-  }
 }
 
 void StoreServiceImpl::KvGet(google::protobuf::RpcController* controller,
@@ -147,6 +173,7 @@ void StoreServiceImpl::KvGet(google::protobuf::RpcController* controller,
   auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
     DoKvGet(storage_, controller, request, response, svr_done);
   });
+  ServiceHelper::SetTaskQos(task, svr_done->GetRegion(), QosRequestType::kPointRead);
   bool ret = read_worker_set_->ExecuteRR(task);
   if (!ret) {
     brpc::ClosureGuard done_guard(svr_done);
@@ -198,7 +225,7 @@ void DoKvBatchGet(StoragePtr storage, google::protobuf::RpcController* controlle
     return;
   }
 
-  auto ctx = std::make_shared<Context>(cntl, done);
+  auto ctx = MakePooledShared<Context>(cntl, done);
   ctx->SetRegionId(region_id);
   ctx->SetTracker(tracker);
   ctx->SetCfName(Constant::kStoreDataCF);
@@ -239,6 +266,7 @@ void StoreServiceImpl::KvBatchGet(google::protobuf::RpcController* controller,
   auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
     DoKvBatchGet(storage_, controller, request, response, svr_done);
   });
+  ServiceHelper::SetTaskQos(task, svr_done->GetRegion(), QosRequestType::kPointRead);
   bool ret = read_worker_set_->ExecuteRR(task);
   if (!ret) {
     brpc::ClosureGuard done_guard(svr_done);
@@ -311,7 +339,7 @@ void DoKvPut(StoragePtr storage, google::protobuf::RpcController* controller,
   // release latches after done
   DEFER(region->LatchesRelease(&lock, cid));
 
-  auto ctx = std::make_shared<Context>(cntl, is_sync ? nullptr : done_guard.release(), request, response);
+  auto ctx = MakePooledShared<Context>(cntl, is_sync ? nullptr : done_guard.release(), request, response);
   ctx->SetRegionId(region_id);
   ctx->SetTracker(tracker);
   ctx->SetCfName(Constant::kStoreDataCF);
@@ -322,7 +350,7 @@ void DoKvPut(StoragePtr storage, google::protobuf::RpcController* controller,
   std::vector<pb::common::KeyValue> kvs;
   auto* mut_request = const_cast<dingodb::pb::store::KvPutRequest*>(request);
   kvs.emplace_back(std::move(*mut_request->release_kv()));
-  status = storage->KvPut(ctx, kvs);
+  status = storage->KvPut(ctx, std::move(kvs));
   if (!status.ok()) {
     ServiceHelper::SetError(response->mutable_error(), status.error_code(), status.error_str());
 
@@ -351,6 +379,7 @@ void StoreServiceImpl::KvPut(google::protobuf::RpcController* controller,
   auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
     DoKvPut(storage_, controller, request, response, svr_done, true);
   });
+  ServiceHelper::SetTaskQos(task, svr_done->GetRegion(), QosRequestType::kWrite);
   bool ret = write_worker_set_->ExecuteRR(task);
   if (!ret) {
     brpc::ClosureGuard done_guard(svr_done);
@@ -430,7 +459,7 @@ void DoKvBatchPut(StoragePtr storage, google::protobuf::RpcController* controlle
   // release latches after done
   DEFER(region->LatchesRelease(&lock, cid));
 
-  auto ctx = std::make_shared<Context>(cntl, is_sync ? nullptr : done_guard.release(), request, response);
+  auto ctx = MakePooledShared<Context>(cntl, is_sync ? nullptr : done_guard.release(), request, response);
   ctx->SetRegionId(region_id);
   ctx->SetTracker(tracker);
   ctx->SetCfName(Constant::kStoreDataCF);
@@ -473,6 +502,7 @@ void StoreServiceImpl::KvBatchPut(google::protobuf::RpcController* controller,
   auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
     DoKvBatchPut(storage_, controller, request, response, svr_done, true);
   });
+  ServiceHelper::SetTaskQos(task, svr_done->GetRegion(), QosRequestType::kWrite);
   bool ret = write_worker_set_->ExecuteRR(task);
   if (!ret) {
     brpc::ClosureGuard done_guard(svr_done);
@@ -546,7 +576,7 @@ void DoKvPutIfAbsent(StoragePtr storage, google::protobuf::RpcController* contro
   // release latches after done
   DEFER(region->LatchesRelease(&lock, cid));
 
-  auto ctx = std::make_shared<Context>(cntl, is_sync ? nullptr : done_guard.release(), request, response);
+  auto ctx = MakePooledShared<Context>(cntl, is_sync ? nullptr : done_guard.release(), request, response);
   ctx->SetRegionId(region_id);
   ctx->SetTracker(tracker);
   ctx->SetCfName(Constant::kStoreDataCF);
@@ -591,6 +621,7 @@ void StoreServiceImpl::KvPutIfAbsent(google::protobuf::RpcController* controller
   auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
     DoKvPutIfAbsent(storage_, controller, request, response, svr_done, true);
   });
+  ServiceHelper::SetTaskQos(task, svr_done->GetRegion(), QosRequestType::kWrite);
   bool ret = write_worker_set_->ExecuteRR(task);
   if (!ret) {
     brpc::ClosureGuard done_guard(svr_done);
@@ -670,7 +701,7 @@ void DoKvBatchPutIfAbsent(StoragePtr storage, google::protobuf::RpcController* c
   // release latches after done
   DEFER(region->LatchesRelease(&lock, cid));
 
-  auto ctx = std::make_shared<Context>(cntl, is_sync ? nullptr : done_guard.release(), request, response);
+  auto ctx = MakePooledShared<Context>(cntl, is_sync ? nullptr : done_guard.release(), request, response);
   ctx->SetRegionId(region_id);
   ctx->SetTracker(tracker);
   ctx->SetCfName(Constant::kStoreDataCF);
@@ -720,6 +751,7 @@ void StoreServiceImpl::KvBatchPutIfAbsent(google::protobuf::RpcController* contr
   auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
     DoKvBatchPutIfAbsent(storage_, controller, request, response, svr_done, true);
   });
+  ServiceHelper::SetTaskQos(task, svr_done->GetRegion(), QosRequestType::kWrite);
   bool ret = write_worker_set_->ExecuteRR(task);
   if (!ret) {
     brpc::ClosureGuard done_guard(svr_done);
@@ -794,7 +826,7 @@ void DoKvBatchDelete(StoragePtr storage, google::protobuf::RpcController* contro
   // release latches after done
   DEFER(region->LatchesRelease(&lock, cid));
 
-  auto ctx = std::make_shared<Context>(cntl, is_sync ? nullptr : done_guard.release(), request, response);
+  auto ctx = MakePooledShared<Context>(cntl, is_sync ? nullptr : done_guard.release(), request, response);
   ctx->SetRegionId(region_id);
   ctx->SetTracker(tracker);
   ctx->SetCfName(Constant::kStoreDataCF);
@@ -837,6 +869,7 @@ void StoreServiceImpl::KvBatchDelete(google::protobuf::RpcController* controller
   auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
     DoKvBatchDelete(storage_, controller, request, response, svr_done, true);
   });
+  ServiceHelper::SetTaskQos(task, svr_done->GetRegion(), QosRequestType::kWrite);
   bool ret = write_worker_set_->ExecuteRR(task);
   if (!ret) {
     brpc::ClosureGuard done_guard(svr_done);
@@ -891,7 +924,7 @@ void DoKvDeleteRange(StoragePtr storage, google::protobuf::RpcController* contro
     return;
   }
 
-  auto ctx = std::make_shared<Context>(cntl, is_sync ? nullptr : done_guard.release(), request, response);
+  auto ctx = MakePooledShared<Context>(cntl, is_sync ? nullptr : done_guard.release(), request, response);
   ctx->SetRegionId(region_id);
   ctx->SetTracker(tracker);
   ctx->SetCfName(Constant::kStoreDataCF);
@@ -929,6 +962,7 @@ void StoreServiceImpl::KvDeleteRange(google::protobuf::RpcController* controller
   auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
     DoKvDeleteRange(storage_, controller, request, response, svr_done, true);
   });
+  ServiceHelper::SetTaskQos(task, svr_done->GetRegion(), QosRequestType::kWrite);
   bool ret = write_worker_set_->ExecuteRR(task);
   if (!ret) {
     brpc::ClosureGuard done_guard(svr_done);
@@ -997,7 +1031,7 @@ void DoKvCompareAndSet(StoragePtr storage, google::protobuf::RpcController* cont
   // release latches after done
   DEFER(region->LatchesRelease(&lock, cid));
 
-  auto ctx = std::make_shared<Context>(cntl, is_sync ? nullptr : done_guard.release(), request, response);
+  auto ctx = MakePooledShared<Context>(cntl, is_sync ? nullptr : done_guard.release(), request, response);
   ctx->SetRegionId(region_id);
   ctx->SetTracker(tracker);
   ctx->SetCfName(Constant::kStoreDataCF);
@@ -1039,6 +1073,7 @@ void StoreServiceImpl::KvCompareAndSet(google::protobuf::RpcController* controll
   auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
     DoKvCompareAndSet(storage_, controller, request, response, svr_done, true);
   });
+  ServiceHelper::SetTaskQos(task, svr_done->GetRegion(), QosRequestType::kWrite);
   bool ret = write_worker_set_->ExecuteRR(task);
   if (!ret) {
     brpc::ClosureGuard done_guard(svr_done);
@@ -1119,7 +1154,7 @@ void DoKvBatchCompareAndSet(StoragePtr storage, google::protobuf::RpcController*
   // release latches after done
   DEFER(region->LatchesRelease(&lock, cid));
 
-  auto ctx = std::make_shared<Context>(cntl, is_sync ? nullptr : done_guard.release(), request, response);
+  auto ctx = MakePooledShared<Context>(cntl, is_sync ? nullptr : done_guard.release(), request, response);
   ctx->SetRegionId(region_id);
   ctx->SetTracker(tracker);
   ctx->SetCfName(Constant::kStoreDataCF);
@@ -1171,6 +1206,7 @@ void StoreServiceImpl::KvBatchCompareAndSet(google::protobuf::RpcController* con
   auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
     DoKvBatchCompareAndSet(storage_, controller, request, response, svr_done, true);
   });
+  ServiceHelper::SetTaskQos(task, svr_done->GetRegion(), QosRequestType::kWrite);
   bool ret = write_worker_set_->ExecuteRR(task);
   if (!ret) {
     brpc::ClosureGuard done_guard(svr_done);
@@ -1225,7 +1261,7 @@ void DoKvScanBegin(StoragePtr storage, google::protobuf::RpcController* controll
     return;
   }
 
-  std::shared_ptr<Context> ctx = std::make_shared<Context>(cntl, done);
+  std::shared_ptr<Context> ctx = MakePooledShared<Context>(cntl, done);
   ctx->SetRegionId(region_id);
   ctx->SetTracker(tracker);
   ctx->SetCfName(Constant::kStoreDataCF);
@@ -1272,6 +1308,7 @@ void StoreServiceImpl::KvScanBegin(google::protobuf::RpcController* controller,
   auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
     DoKvScanBegin(storage_, controller, request, response, svr_done);
   });
+  ServiceHelper::SetTaskQos(task, svr_done->GetRegion(), QosRequestType::kScan);
   bool ret = read_worker_set_->ExecuteRR(task);
   if (!ret) {
     brpc::ClosureGuard done_guard(svr_done);
@@ -1317,7 +1354,7 @@ void DoKvScanContinue(StoragePtr storage, google::protobuf::RpcController* contr
     return;
   }
 
-  std::shared_ptr<Context> ctx = std::make_shared<Context>(cntl, done);
+  std::shared_ptr<Context> ctx = MakePooledShared<Context>(cntl, done);
   ctx->SetRegionId(region_id);
   ctx->SetTracker(tracker);
   ctx->SetCfName(Constant::kStoreDataCF);
@@ -1359,6 +1396,7 @@ void StoreServiceImpl::KvScanContinue(google::protobuf::RpcController* controlle
   auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
     DoKvScanContinue(storage_, controller, request, response, svr_done);
   });
+  ServiceHelper::SetTaskQos(task, svr_done->GetRegion(), QosRequestType::kScan);
   bool ret = read_worker_set_->ExecuteRR(task);
   if (!ret) {
     brpc::ClosureGuard done_guard(svr_done);
@@ -1400,7 +1438,7 @@ void DoKvScanRelease(StoragePtr storage, google::protobuf::RpcController* contro
     return;
   }
 
-  std::shared_ptr<Context> ctx = std::make_shared<Context>(cntl, done);
+  std::shared_ptr<Context> ctx = MakePooledShared<Context>(cntl, done);
   ctx->SetRegionId(region_id);
   ctx->SetTracker(tracker);
   ctx->SetCfName(Constant::kStoreDataCF);
@@ -1433,6 +1471,7 @@ void StoreServiceImpl::KvScanRelease(google::protobuf::RpcController* controller
   auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
     DoKvScanRelease(storage_, controller, request, response, svr_done);
   });
+  ServiceHelper::SetTaskQos(task, svr_done->GetRegion(), QosRequestType::kScan);
   bool ret = read_worker_set_->ExecuteRR(task);
   if (!ret) {
     brpc::ClosureGuard done_guard(svr_done);
@@ -1512,7 +1551,7 @@ void DoKvScanBeginV2(StoragePtr storage, google::protobuf::RpcController* contro
     return;
   }
 
-  std::shared_ptr<Context> ctx = std::make_shared<Context>(cntl, done);
+  std::shared_ptr<Context> ctx = MakePooledShared<Context>(cntl, done);
   ctx->SetRegionId(region_id);
   ctx->SetTracker(tracker);
   ctx->SetCfName(Constant::kStoreDataCF);
@@ -1559,6 +1598,7 @@ void StoreServiceImpl::KvScanBeginV2(google::protobuf::RpcController* controller
   auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
     DoKvScanBeginV2(storage_, controller, request, response, svr_done);
   });
+  ServiceHelper::SetTaskQos(task, svr_done->GetRegion(), QosRequestType::kScan);
   bool ret = read_worker_set_->ExecuteRR(task);
   if (!ret) {
     brpc::ClosureGuard done_guard(svr_done);
@@ -1605,7 +1645,7 @@ void DoKvScanContinueV2(StoragePtr storage, google::protobuf::RpcController* con
     return;
   }
 
-  std::shared_ptr<Context> ctx = std::make_shared<Context>(cntl, done);
+  std::shared_ptr<Context> ctx = MakePooledShared<Context>(cntl, done);
   ctx->SetRegionId(region_id);
   ctx->SetTracker(tracker);
   ctx->SetCfName(Constant::kStoreDataCF);
@@ -1649,6 +1689,7 @@ void StoreServiceImpl::KvScanContinueV2(::google::protobuf::RpcController* contr
   auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
     DoKvScanContinueV2(storage_, controller, request, response, svr_done);
   });
+  ServiceHelper::SetTaskQos(task, svr_done->GetRegion(), QosRequestType::kScan);
   bool ret = read_worker_set_->ExecuteRR(task);
   if (!ret) {
     brpc::ClosureGuard done_guard(svr_done);
@@ -1691,7 +1732,7 @@ void DoKvScanReleaseV2(StoragePtr storage, google::protobuf::RpcController* cont
     return;
   }
 
-  std::shared_ptr<Context> ctx = std::make_shared<Context>(cntl, done);
+  std::shared_ptr<Context> ctx = MakePooledShared<Context>(cntl, done);
   ctx->SetRegionId(region_id);
   ctx->SetTracker(tracker);
   ctx->SetCfName(Constant::kStoreDataCF);
@@ -1724,6 +1765,7 @@ void StoreServiceImpl::KvScanReleaseV2(::google::protobuf::RpcController* contro
   auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
     DoKvScanReleaseV2(storage_, controller, request, response, svr_done);
   });
+  ServiceHelper::SetTaskQos(task, svr_done->GetRegion(), QosRequestType::kScan);
   bool ret = read_worker_set_->ExecuteRR(task);
   if (!ret) {
     brpc::ClosureGuard done_guard(svr_done);
@@ -1750,7 +1792,7 @@ void DoTxnGet(StoragePtr storage, google::protobuf::RpcController* controller,
     return;
   }
 
-  std::shared_ptr<Context> ctx = std::make_shared<Context>();
+  std::shared_ptr<Context> ctx = MakePooledShared<Context>();
   ctx->SetRegionId(region_id);
   ctx->SetTracker(tracker);
   ctx->SetCfName(Constant::kStoreDataCF);
@@ -1796,6 +1838,7 @@ void StoreServiceImpl::TxnGet(google::protobuf::RpcController* controller, const
   auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
     DoTxnGet(storage_, controller, request, response, svr_done);
   });
+  ServiceHelper::SetTaskQos(task, svr_done->GetRegion(), QosRequestType::kPointRead);
   bool ret = read_worker_set_->ExecuteRR(task);
   if (!ret) {
     brpc::ClosureGuard done_guard(svr_done);
@@ -1850,7 +1893,7 @@ void DoTxnScan(StoragePtr storage, google::protobuf::RpcController* controller,
     return;
   }
 
-  std::shared_ptr<Context> ctx = std::make_shared<Context>();
+  std::shared_ptr<Context> ctx = MakePooledShared<Context>();
   ctx->SetRegionId(region_id);
   ctx->SetTracker(tracker);
   ctx->SetCfName(Constant::kStoreDataCF);
@@ -1903,6 +1946,7 @@ void StoreServiceImpl::TxnScan(google::protobuf::RpcController* controller, cons
   auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
     DoTxnScan(storage_, controller, request, response, svr_done);
   });
+  ServiceHelper::SetTaskQos(task, svr_done->GetRegion(), QosRequestType::kScan);
   bool ret = read_worker_set_->ExecuteRR(task);
   if (!ret) {
     brpc::ClosureGuard done_guard(svr_done);
@@ -1971,13 +2015,89 @@ static butil::Status ValidateTxnPessimisticLockRequest(const dingodb::pb::store:
   return butil::Status();
 }
 
-void DoTxnPessimisticLock(StoragePtr storage, google::protobuf::RpcController* controller,
-                          const dingodb::pb::store::TxnPessimisticLockRequest* request,
-                          dingodb::pb::store::TxnPessimisticLockResponse* response, TrackClosure* done, bool is_sync) {
+// Enqueue for the first lock of other txn in response, return nullptr if no such lock.
+static TxnLockWaitManager::WaiterPtr EnqueueLockWaiter(int64_t region_id, int64_t start_ts, int64_t release_version,
+                                                       const pb::store::TxnPessimisticLockResponse* response) {
+  for (const auto& txn_result : response->txn_result()) {
+    if (!txn_result.has_locked()) {
+      continue;
+    }
+    const auto& lock_info = txn_result.locked();
+    if (lock_info.lock_ts() == start_ts || lock_info.key().empty()) {
+      continue;
+    }
+
+    return TxnLockWaitManager::GetInstance().Enqueue(region_id, lock_info.key(), start_ts, lock_info.lock_ts(),
+                                                     release_version);
+  }
+
+  return nullptr;
+}
+
+static void DoTxnPessimisticLockWithWait(StoragePtr storage, SimpleWorkerSetPtr worker_set,
+                                         google::protobuf::RpcController* controller,
+                                         const dingodb::pb::store::TxnPessimisticLockRequest* request,
+                                         dingodb::pb::store::TxnPessimisticLockResponse* response, TrackClosure* done,
+                                         bool is_sync, int64_t lock_wait_deadline_ms,
+                                         TxnLockWaitManager::WaiterPtr woken_waiter);
+
+// Dispatch the parked request to worker set again, retry the lock if woken up, otherwise return the lock.
+static void ResumeTxnPessimisticLock(StoragePtr storage, SimpleWorkerSetPtr worker_set,
+                                     google::protobuf::RpcController* controller,
+                                     const dingodb::pb::store::TxnPessimisticLockRequest* request,
+                                     dingodb::pb::store::TxnPessimisticLockResponse* response, TrackClosure* done,
+                                     int64_t lock_wait_deadline_ms, TxnLockWaitManager::WaiterPtr waiter, bool woken) {
+  auto task = std::make_shared<ServiceTask>(
+      [storage, worker_set, controller, request, response, done, lock_wait_deadline_ms, waiter, woken]() {
+        if (!woken) {
+          // timeout, the lock is in response already
+          brpc::ClosureGuard done_guard(done);
+          return;
+        }
+
+        response->clear_txn_result();
+        response->clear_error();
+        DoTxnPessimisticLockWithWait(storage, worker_set, controller, request, response, done, true,
+                                     lock_wait_deadline_ms, waiter);
+      });
+  ServiceHelper::SetTaskQos(task, done->GetRegion(), QosRequestType::kWrite);
+  bool ret = worker_set->ExecuteRR(task);
+  if (!ret) {
+    brpc::ClosureGuard done_guard(done);
+    if (woken) {
+      TxnLockWaitManager::GetInstance().WakeUp(waiter->key);
+    }
+    response->clear_txn_result();
+    ServiceHelper::SetError(response->mutable_error(), pb::error::EREQUEST_FULL,
+                            "WorkerSet queue is full, please wait and retry");
+  }
+}
+
+// The conflict request waits in store for the lock released, instead of client retry with backoff. It is parked on
+// the lock wait queue without holding the worker, and dispatched to worker_set again when woken up or timeout.
+static void DoTxnPessimisticLockWithWait(StoragePtr storage, SimpleWorkerSetPtr worker_set,
+                                         google::protobuf::RpcController* controller,
+                                         const dingodb::pb::store::TxnPessimisticLockRequest* request,
+                                         dingodb::pb::store::TxnPessimisticLockResponse* response, TrackClosure* done,
+                                         bool is_sync, int64_t lock_wait_deadline_ms,
+                                         TxnLockWaitManager::WaiterPtr woken_waiter) {
   brpc::Controller* cntl = (brpc::Controller*)controller;
   brpc::ClosureGuard done_guard(done);
   auto tracker = done->Tracker();
-  tracker->SetServiceQueueWaitTime();
+  if (woken_waiter == nullptr) {
+    tracker->SetServiceQueueWaitTime();
+  }
+
+  // the youngest txn of a deadlock aborts at once, not wait for the lock ttl
+  if (woken_waiter != nullptr && woken_waiter->deadlock) {
+    auto* write_conflict = response->add_txn_result()->mutable_write_conflict();
+    write_conflict->set_reason(pb::store::WriteConflict_Reason::WriteConflict_Reason_SelfRolledBack);
+    write_conflict->set_start_ts(request->start_ts());
+    write_conflict->set_conflict_ts(woken_waiter->holder_ts);
+    write_conflict->set_key(woken_waiter->key);
+    write_conflict->set_primary_key(request->primary_lock());
+    return;
+  }
 
   auto region = done->GetRegion();
   int64_t region_id = request->context().region_id();
@@ -1986,49 +2106,82 @@ void DoTxnPessimisticLock(StoragePtr storage, google::protobuf::RpcController* c
   if (!status.ok()) {
     ServiceHelper::SetError(response->mutable_error(), status.error_code(), status.error_str());
     ServiceHelper::GetStoreRegionInfo(region, response->mutable_error());
+    if (woken_waiter != nullptr) {
+      TxnLockWaitManager::GetInstance().WakeUp(woken_waiter->key);
+    }
     return;
   }
 
-  // check latches
-  auto start_time_us = butil::gettimeofday_us();
+  std::vector<pb::store::Mutation> mutations;
+  for (const auto& mutation : request->mutations()) {
+    mutations.emplace_back(mutation);
+  }
+
   std::vector<std::string> keys_for_lock;
   for (const auto& mutation : request->mutations()) {
     keys_for_lock.push_back(mutation.key());
   }
-  Lock lock(keys_for_lock);
-  BthreadCond sync_cond;
-  uint64_t cid = (uint64_t)(&sync_cond);
 
-  bool latch_got = false;
-  while (!latch_got) {
-    latch_got = region->LatchesAcquire(&lock, cid);
-    if (!latch_got) {
-      sync_cond.IncreaseWait();
+  bool lock_wait = is_sync && worker_set != nullptr && TxnLockWaitManager::IsEnabled();
+  TxnLockWaitManager::WaiterPtr waiter;
+  {
+    // check latches
+    auto start_time_us = butil::gettimeofday_us();
+    Lock lock(keys_for_lock);
+    BthreadCond sync_cond;
+    uint64_t cid = (uint64_t)(&sync_cond);
+
+    bool latch_got = false;
+    while (!latch_got) {
+      latch_got = region->LatchesAcquire(&lock, cid);
+      if (!latch_got) {
+        sync_cond.IncreaseWait();
+      }
     }
-  }
 
-  g_txn_latches_recorder << butil::gettimeofday_us() - start_time_us;
+    g_txn_latches_recorder << butil::gettimeofday_us() - start_time_us;
 
-  // release latches after done
-  DEFER(region->LatchesRelease(&lock, cid));
+    // release latches after done
+    DEFER(region->LatchesRelease(&lock, cid));
 
-  auto ctx = std::make_shared<Context>(cntl, is_sync ? nullptr : done_guard.release(), request, response);
-  ctx->SetRegionId(region_id);
-  ctx->SetTracker(tracker);
-  ctx->SetCfName(Constant::kStoreDataCF);
-  ctx->SetRegionEpoch(request->context().region_epoch());
-  ctx->SetIsolationLevel(request->context().isolation_level());
-  ctx->SetRawEngineType(region->GetRawEngineType());
-  ctx->SetStoreEngineType(region->GetStoreEngineType());
+    // resolve lock and check txn status delete locks without latches, a release after here wakes up the waiter
+    int64_t release_version = lock_wait ? TxnLockWaitManager::GetInstance().ReleaseVersion() : 0;
 
-  std::vector<pb::store::Mutation> mutations;
-  for (const auto& mutation : request->mutations()) {
-    mutations.emplace_back(mutation);
+    auto ctx = MakePooledShared<Context>(cntl, is_sync ? nullptr : done_guard.release(), request, response);
+    ctx->SetRegionId(region_id);
+    ctx->SetTracker(tracker);
+    ctx->SetCfName(Constant::kStoreDataCF);
+    ctx->SetRegionEpoch(request->context().region_epoch());
+    ctx->SetIsolationLevel(request->context().isolation_level());
+    ctx->SetRawEngineType(region->GetRawEngineType());
+    ctx->SetStoreEngineType(region->GetStoreEngineType());
+
+    status = storage->TxnPessimisticLock(ctx, mutations, request->primary_lock(), request->start_ts(),
+                                         request->lock_ttl(), request->for_update_ts());
+
+    // enqueue with latches held, the lock can't be released by other pessimistic lock before it
+    if (status.ok() && lock_wait && Helper::TimestampMs() < lock_wait_deadline_ms) {
+      waiter = EnqueueLockWaiter(region_id, request->start_ts(), release_version, response);
+    }
+  }
+
+  // the woken waiter did not take the lock, pass the turn to the next waiter
+  if (woken_waiter != nullptr && waiter == nullptr && (!status.ok() || response->txn_result_size() > 0)) {
+    TxnLockWaitManager::GetInstance().WakeUp(woken_waiter->key);
+  }
+
+  if (waiter != nullptr) {
+    // park the done until woken up or timeout, the worker serves other requests meanwhile
+    done_guard.release();
+    TxnLockWaitManager::GetInstance().AsyncWait(
+        waiter, lock_wait_deadline_ms - Helper::TimestampMs(),
+        [storage, worker_set, controller, request, response, done, lock_wait_deadline_ms, waiter](bool woken) {
+          ResumeTxnPessimisticLock(storage, worker_set, controller, request, response, done, lock_wait_deadline_ms,
+                                   waiter, woken);
+        });
+    return;
   }
 
-  std::vector<pb::common::KeyValue> kvs;
-  status = storage->TxnPessimisticLock(ctx, mutations, request->primary_lock(), request->start_ts(),
-                                       request->lock_ttl(), request->for_update_ts());
   if (!status.ok()) {
     ServiceHelper::SetError(response->mutable_error(), status.error_code(), status.error_str());
 
@@ -2036,6 +2189,14 @@ void DoTxnPessimisticLock(StoragePtr storage, google::protobuf::RpcController* c
   }
 }
 
+void DoTxnPessimisticLock(StoragePtr storage, SimpleWorkerSetPtr worker_set,
+                          google::protobuf::RpcController* controller,
+                          const dingodb::pb::store::TxnPessimisticLockRequest* request,
+                          dingodb::pb::store::TxnPessimisticLockResponse* response, TrackClosure* done, bool is_sync) {
+  DoTxnPessimisticLockWithWait(storage, worker_set, controller, request, response, done, is_sync,
+                               Helper::TimestampMs() + TxnLockWaitManager::WaitTimeoutMs(), nullptr);
+}
+
 void StoreServiceImpl::TxnPessimisticLock(google::protobuf::RpcController* controller,
                                           const pb::store::TxnPessimisticLockRequest* request,
                                           pb::store::TxnPessimisticLockResponse* response,
@@ -2056,8 +2217,9 @@ void StoreServiceImpl::TxnPessimisticLock(google::protobuf::RpcController* contr
 
   // Run in queue.
   auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
-    DoTxnPessimisticLock(storage_, controller, request, response, svr_done, true);
+    DoTxnPessimisticLock(storage_, write_worker_set_, controller, request, response, svr_done, true);
   });
+  ServiceHelper::SetTaskQos(task, svr_done->GetRegion(), QosRequestType::kWrite);
   bool ret = write_worker_set_->ExecuteRR(task);
   if (!ret) {
     brpc::ClosureGuard done_guard(svr_done);
@@ -2152,7 +2314,7 @@ void DoTxnPessimisticRollback(StoragePtr storage, google::protobuf::RpcControlle
   // release latches after done
   DEFER(region->LatchesRelease(&lock, cid));
 
-  auto ctx = std::make_shared<Context>(cntl, is_sync ? nullptr : done_guard.release(), request, response);
+  auto ctx = MakePooledShared<Context>(cntl, is_sync ? nullptr : done_guard.release(), request, response);
   ctx->SetRegionId(region_id);
   ctx->SetTracker(tracker);
   ctx->SetCfName(Constant::kStoreDataCF);
@@ -2192,6 +2354,7 @@ void StoreServiceImpl::TxnPessimisticRollback(google::protobuf::RpcController* c
   auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
     DoTxnPessimisticRollback(storage_, controller, request, response, svr_done, true);
   });
+  ServiceHelper::SetTaskQos(task, svr_done->GetRegion(), QosRequestType::kWrite);
   bool ret = write_worker_set_->ExecuteRR(task);
   if (!ret) {
     brpc::ClosureGuard done_guard(svr_done);
@@ -2276,24 +2439,15 @@ void DoTxnPrewrite(StoragePtr storage, google::protobuf::RpcController* controll
   for (const auto& mutation : request->mutations()) {
     keys_for_lock.push_back(mutation.key());
   }
-  Lock lock(keys_for_lock);
-  BthreadCond sync_cond;
-  uint64_t cid = (uint64_t)(&sync_cond);
-
-  bool latch_got = false;
-  while (!latch_got) {
-    latch_got = region->LatchesAcquire(&lock, cid);
-    if (!latch_got) {
-      sync_cond.IncreaseWait();
-    }
-  }
+  auto* latches_done = new TxnLatchesClosure(region, keys_for_lock, is_sync ? nullptr : done_guard.release());
+  latches_done->Acquire();
 
   g_txn_latches_recorder << butil::gettimeofday_us() - start_time_us;
 
-  // release latches after done
-  DEFER(region->LatchesRelease(&lock, cid));
+  // release latches after done, the async write releases them after apply
+  brpc::ClosureGuard latches_guard(is_sync ? latches_done : nullptr);
 
-  auto ctx = std::make_shared<Context>(cntl, is_sync ? nullptr : done_guard.release(), request, response);
+  auto ctx = MakePooledShared<Context>(cntl, is_sync ? nullptr : latches_done, request, response);
   ctx->SetRegionId(region_id);
   ctx->SetTracker(tracker);
   ctx->SetCfName(Constant::kStoreDataCF);
@@ -2329,7 +2483,13 @@ void DoTxnPrewrite(StoragePtr storage, google::protobuf::RpcController* controll
   if (!status.ok()) {
     ServiceHelper::SetError(response->mutable_error(), status.error_code(), status.error_str());
 
-    if (!is_sync) done->Run();
+    if (!is_sync) latches_done->Run();
+    return;
+  }
+
+  // no raft write is issued, e.g. the mutations are prewritten already
+  if (!is_sync && ctx->WriteCb() == nullptr) {
+    latches_done->Run();
   }
 }
 
@@ -2352,8 +2512,9 @@ void StoreServiceImpl::TxnPrewrite(google::protobuf::RpcController* controller,
 
   // Run in queue.
   auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
-    DoTxnPrewrite(storage_, controller, request, response, svr_done, true);
+    DoTxnPrewrite(storage_, controller, request, response, svr_done, !FLAGS_enable_txn_async_write);
   });
+  ServiceHelper::SetTaskQos(task, svr_done->GetRegion(), QosRequestType::kWrite);
   bool ret = write_worker_set_->ExecuteRR(task);
   if (!ret) {
     brpc::ClosureGuard done_guard(svr_done);
@@ -2426,24 +2587,15 @@ void DoTxnCommit(StoragePtr storage, google::protobuf::RpcController* controller
   for (const auto& key : request->keys()) {
     keys_for_lock.push_back(key);
   }
-  Lock lock(keys_for_lock);
-  BthreadCond sync_cond;
-  uint64_t cid = (uint64_t)(&sync_cond);
-
-  bool latch_got = false;
-  while (!latch_got) {
-    latch_got = region->LatchesAcquire(&lock, cid);
-    if (!latch_got) {
-      sync_cond.IncreaseWait();
-    }
-  }
+  auto* latches_done = new TxnLatchesClosure(region, keys_for_lock, is_sync ? nullptr : done_guard.release());
+  latches_done->Acquire();
 
   g_txn_latches_recorder << butil::gettimeofday_us() - start_time_us;
 
-  // release latches after done
-  DEFER(region->LatchesRelease(&lock, cid));
+  // release latches after done, the async write releases them after apply
+  brpc::ClosureGuard latches_guard(is_sync ? latches_done : nullptr);
 
-  auto ctx = std::make_shared<Context>(cntl, is_sync ? nullptr : done_guard.release(), request, response);
+  auto ctx = MakePooledShared<Context>(cntl, is_sync ? nullptr : latches_done, request, response);
   ctx->SetRegionId(region_id);
   ctx->SetTracker(tracker);
   ctx->SetCfName(Constant::kStoreDataCF);
@@ -2462,9 +2614,14 @@ void DoTxnCommit(StoragePtr storage, google::protobuf::RpcController* controller
   if (!status.ok()) {
     ServiceHelper::SetError(response->mutable_error(), status.error_code(), status.error_str());
 
-    if (!is_sync) done->Run();
+    if (!is_sync) latches_done->Run();
     return;
   }
+
+  // no raft write is issued, e.g. the keys are committed already
+  if (!is_sync && ctx->WriteCb() == nullptr) {
+    latches_done->Run();
+  }
 }
 
 void StoreServiceImpl::TxnCommit(google::protobuf::RpcController* controller,
@@ -2486,8 +2643,9 @@ void StoreServiceImpl::TxnCommit(google::protobuf::RpcController* controller,
 
   // Run in queue.
   auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
-    DoTxnCommit(storage_, controller, request, response, svr_done, true);
+    DoTxnCommit(storage_, controller, request, response, svr_done, !FLAGS_enable_txn_async_write);
   });
+  ServiceHelper::SetTaskQos(task, svr_done->GetRegion(), QosRequestType::kWrite);
   bool ret = write_worker_set_->ExecuteRR(task);
   if (!ret) {
     brpc::ClosureGuard done_guard(svr_done);
@@ -2574,7 +2732,7 @@ void DoTxnCheckTxnStatus(StoragePtr storage, google::protobuf::RpcController* co
   // release latches after done
   DEFER(region->LatchesRelease(&lock, cid));
 
-  auto ctx = std::make_shared<Context>(cntl, is_sync ? nullptr : done_guard.release(), request, response);
+  auto ctx = MakePooledShared<Context>(cntl, is_sync ? nullptr : done_guard.release(), request, response);
   ctx->SetRegionId(region_id);
   ctx->SetTracker(tracker);
   ctx->SetCfName(Constant::kStoreDataCF);
@@ -2614,6 +2772,7 @@ void StoreServiceImpl::TxnCheckTxnStatus(google::protobuf::RpcController* contro
   auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
     DoTxnCheckTxnStatus(storage_, controller, request, response, svr_done, true);
   });
+  ServiceHelper::SetTaskQos(task, svr_done->GetRegion(), QosRequestType::kWrite);
   bool ret = write_worker_set_->ExecuteRR(task);
   if (!ret) {
     brpc::ClosureGuard done_guard(svr_done);
@@ -2682,7 +2841,7 @@ void DoTxnResolveLock(StoragePtr storage, google::protobuf::RpcController* contr
     return;
   }
 
-  auto ctx = std::make_shared<Context>(cntl, is_sync ? nullptr : done_guard.release(), request, response);
+  auto ctx = MakePooledShared<Context>(cntl, is_sync ? nullptr : done_guard.release(), request, response);
   ctx->SetRegionId(region_id);
   ctx->SetTracker(tracker);
   ctx->SetCfName(Constant::kStoreDataCF);
@@ -2727,6 +2886,7 @@ void StoreServiceImpl::TxnResolveLock(google::protobuf::RpcController* controlle
   auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
     DoTxnResolveLock(storage_, controller, request, response, svr_done, true);
   });
+  ServiceHelper::SetTaskQos(task, svr_done->GetRegion(), QosRequestType::kWrite);
   bool ret = write_worker_set_->ExecuteRR(task);
   if (!ret) {
     brpc::ClosureGuard done_guard(svr_done);
@@ -2784,7 +2944,7 @@ void DoTxnBatchGet(StoragePtr storage, google::protobuf::RpcController* controll
     return;
   }
 
-  std::shared_ptr<Context> ctx = std::make_shared<Context>(cntl, done);
+  std::shared_ptr<Context> ctx = MakePooledShared<Context>(cntl, done);
   ctx->SetRegionId(region_id);
   ctx->SetTracker(tracker);
   ctx->SetCfName(Constant::kStoreDataCF);
@@ -2835,6 +2995,7 @@ void StoreServiceImpl::TxnBatchGet(google::protobuf::RpcController* controller,
   auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
     DoTxnBatchGet(storage_, controller, request, response, svr_done);
   });
+  ServiceHelper::SetTaskQos(task, svr_done->GetRegion(), QosRequestType::kPointRead);
   bool ret = read_worker_set_->ExecuteRR(task);
   if (!ret) {
     brpc::ClosureGuard done_guard(svr_done);
@@ -2920,7 +3081,7 @@ void DoTxnBatchRollback(StoragePtr storage, google::protobuf::RpcController* con
   // release latches after done
   DEFER(region->LatchesRelease(&lock, cid));
 
-  auto ctx = std::make_shared<Context>(cntl, is_sync ? nullptr : done_guard.release(), request, response);
+  auto ctx = MakePooledShared<Context>(cntl, is_sync ? nullptr : done_guard.release(), request, response);
   ctx->SetRegionId(region_id);
   ctx->SetTracker(tracker);
   ctx->SetCfName(Constant::kStoreDataCF);
@@ -2965,6 +3126,7 @@ void StoreServiceImpl::TxnBatchRollback(google::protobuf::RpcController* control
   auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
     DoTxnBatchRollback(storage_, controller, request, response, svr_done, true);
   });
+  ServiceHelper::SetTaskQos(task, svr_done->GetRegion(), QosRequestType::kWrite);
   bool ret = write_worker_set_->ExecuteRR(task);
   if (!ret) {
     brpc::ClosureGuard done_guard(svr_done);
@@ -3035,7 +3197,7 @@ void DoTxnScanLock(StoragePtr storage, google::protobuf::RpcController* controll
     return;
   }
 
-  std::shared_ptr<Context> ctx = std::make_shared<Context>(cntl, done);
+  std::shared_ptr<Context> ctx = MakePooledShared<Context>(cntl, done);
   ctx->SetRegionId(region_id);
   ctx->SetTracker(tracker);
   ctx->SetCfName(Constant::kStoreDataCF);
@@ -3086,6 +3248,7 @@ void StoreServiceImpl::TxnScanLock(google::protobuf::RpcController* controller,
   auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
     DoTxnScanLock(storage_, controller, request, response, svr_done);
   });
+  ServiceHelper::SetTaskQos(task, svr_done->GetRegion(), QosRequestType::kScan);
   bool ret = read_worker_set_->ExecuteRR(task);
   if (!ret) {
     brpc::ClosureGuard done_guard(svr_done);
@@ -3169,7 +3332,7 @@ void DoTxnHeartBeat(StoragePtr storage, google::protobuf::RpcController* control
   // release latches after done
   DEFER(region->LatchesRelease(&lock, cid));
 
-  auto ctx = std::make_shared<Context>(cntl, is_sync ? nullptr : done_guard.release(), request, response);
+  auto ctx = MakePooledShared<Context>(cntl, is_sync ? nullptr : done_guard.release(), request, response);
   ctx->SetRegionId(region_id);
   ctx->SetTracker(tracker);
   ctx->SetCfName(Constant::kStoreDataCF);
@@ -3208,6 +3371,7 @@ void StoreServiceImpl::TxnHeartBeat(google::protobuf::RpcController* controller,
   auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
     DoTxnHeartBeat(storage_, controller, request, response, svr_done, true);
   });
+  ServiceHelper::SetTaskQos(task, svr_done->GetRegion(), QosRequestType::kWrite);
   bool ret = write_worker_set_->ExecuteRR(task);
   if (!ret) {
     brpc::ClosureGuard done_guard(svr_done);
@@ -3253,7 +3417,7 @@ void DoTxnGc(StoragePtr storage, google::protobuf::RpcController* controller,
     return;
   }
 
-  auto ctx = std::make_shared<Context>(cntl, is_sync ? nullptr : done_guard.release(), request, response);
+  auto ctx = MakePooledShared<Context>(cntl, is_sync ? nullptr : done_guard.release(), request, response);
   ctx->SetRegionId(region_id);
   ctx->SetTracker(tracker);
   ctx->SetCfName(Constant::kStoreDataCF);
@@ -3290,6 +3454,7 @@ void StoreServiceImpl::TxnGc(google::protobuf::RpcController* controller, const
   auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
     DoTxnGc(storage_, controller, request, response, svr_done, true);
   });
+  ServiceHelper::SetTaskQos(task, svr_done->GetRegion(), QosRequestType::kWrite);
   bool ret = write_worker_set_->ExecuteRR(task);
   if (!ret) {
     brpc::ClosureGuard done_guard(svr_done);
@@ -3351,7 +3516,7 @@ void DoTxnDeleteRange(StoragePtr storage, google::protobuf::RpcController* contr
     return;
   }
 
-  auto ctx = std::make_shared<Context>(cntl, is_sync ? nullptr : done_guard.release(), request, response);
+  auto ctx = MakePooledShared<Context>(cntl, is_sync ? nullptr : done_guard.release(), request, response);
   ctx->SetRegionId(region_id);
   ctx->SetTracker(tracker);
   ctx->SetCfName(Constant::kStoreDataCF);
@@ -3389,6 +3554,7 @@ void StoreServiceImpl::TxnDeleteRange(google::protobuf::RpcController* controlle
   auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
     DoTxnDeleteRange(storage_, controller, request, response, svr_done, true);
   });
+  ServiceHelper::SetTaskQos(task, svr_done->GetRegion(), QosRequestType::kWrite);
   bool ret = write_worker_set_->ExecuteRR(task);
   if (!ret) {
     brpc::ClosureGuard done_guard(svr_done);
@@ -3446,7 +3612,7 @@ void DoTxnDump(StoragePtr storage, google::protobuf::RpcController* controller,
     return;
   }
 
-  std::shared_ptr<Context> ctx = std::make_shared<Context>(cntl, done);
+  std::shared_ptr<Context> ctx = MakePooledShared<Context>(cntl, done);
   ctx->SetRegionId(region_id);
   ctx->SetTracker(tracker);
   ctx->SetCfName(Constant::kStoreDataCF);
@@ -3504,6 +3670,7 @@ void StoreServiceImpl::TxnDump(google::protobuf::RpcController* controller, cons
   auto task = std::make_shared<ServiceTask>([this, controller, request, response, svr_done]() {
     DoTxnDump(storage_, controller, request, response, svr_done);
   });
+  ServiceHelper::SetTaskQos(task, svr_done->GetRegion(), QosRequestType::kScan);
   bool ret = read_worker_set_->ExecuteRR(task);
   if (!ret) {
     brpc::ClosureGuard done_guard(svr_done);
@@ -3574,6 +3741,7 @@ void StoreServiceImpl::Hello(google::protobuf::RpcController* controller, const
       new ServiceClosure<pb::store::HelloRequest, pb::store::HelloResponse, false>(__func__, done, request, response);
 
   auto task = std::make_shared<ServiceTask>([=]() { DoHello(controller, request, response, svr_done); });
+  ServiceHelper::SetTaskQos(task, svr_done->GetRegion(), QosRequestType::kPointRead);
   bool ret = read_worker_set_->ExecuteRR(task);
   if (!ret) {
     brpc::ClosureGuard done_guard(svr_done);
@@ -3589,6 +3757,7 @@ void StoreServiceImpl::GetMemoryInfo(google::protobuf::RpcController* controller
   auto* svr_done =
       new ServiceClosure<pb::store::HelloRequest, pb::store::HelloResponse, false>(__func__, done, request, response);
   auto task = std::make_shared<ServiceTask>([=]() { DoHello(controller, request, response, svr_done, true); });
+  ServiceHelper::SetTaskQos(task, svr_done->GetRegion(), QosRequestType::kPointRead);
   bool ret = read_worker_set_->ExecuteRR(task);
   if (!ret) {
     brpc::ClosureGuard done_guard(svr_done);
@@ -391,6 +391,12 @@ void TableImpl::PrintSchemaTables(std::ostream& os, bool use_html) {
           line.push_back(
               pb::common::MetricType_Name(vector_index_parameter.hnsw_parameter().metric_type()));  // METRIC_TYPE
           url_line.push_back(std::string());
+        } else if (vector_index_parameter.has_diskann_parameter()) {
+          line.push_back(std::to_string(vector_index_parameter.diskann_parameter().dimension()));  // DIMENSION
+          url_line.push_back(std::string());
+          line.push_back(
+              pb::common::MetricType_Name(vector_index_parameter.diskann_parameter().metric_type()));  // METRIC_TYPE
+          url_line.push_back(std::string());
         } else {
           line.push_back("N/A");  // DIMENSION
           url_line.push_back(std::string());
@@ -14,10 +14,12 @@
 
 #include "server/util_service.h"
 
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <vector>
 
+#include "butil/iobuf.h"
 #include "gflags/gflags.h"
 #include "proto/common.pb.h"
 #include "proto/coordinator.pb.h"
@@ -32,6 +34,27 @@ DECLARE_int64(vector_max_batch_count);
 DECLARE_int64(vector_max_request_size);
 DECLARE_bool(enable_async_vector_operation);
 
+// The topk of VectorCalcDistance is requested in the attachment, the request has no field for it.
+// Request attachment: magic(u32) topk(u32). The reply keeps the topk nearest distances of every left vector, nearest
+// first, and its attachment is their positions in op_right_vectors as u32 row by row.
+static constexpr uint32_t kCalcDistanceTopkMagic = 0x4b544344;  // "DCTK"
+
+static butil::Status ParseVectorCalcDistanceTopk(const butil::IOBuf& attachment, uint32_t& topk) {
+  topk = 0;
+  if (attachment.empty()) {
+    return butil::Status();
+  }
+
+  uint32_t header[2];
+  if (attachment.size() != sizeof(header) || attachment.copy_to(header, sizeof(header)) != sizeof(header) ||
+      header[0] != kCalcDistanceTopkMagic) {
+    return butil::Status(pb::error::EILLEGAL_PARAMTETERS, "invalid vector calc distance attachment");
+  }
+  topk = header[1];
+
+  return butil::Status();
+}
+
 static butil::Status ValidateVectorCalcDistance(const pb::index::VectorCalcDistanceRequest* request) {
   if (request->op_left_vectors_size() * request->op_right_vectors_size() > FLAGS_vector_max_batch_count ||
       request->op_left_vectors_size() == 0 || request->op_right_vectors_size() == 0) {
@@ -56,16 +79,29 @@ void DoVectorCalcDistance(StoragePtr storage, google::protobuf::RpcController* c
     return;
   }
 
+  uint32_t topk = 0;
+  status = ParseVectorCalcDistanceTopk(cntl->request_attachment(), topk);
+  if (!status.ok()) {
+    ServiceHelper::SetError(response->mutable_error(), status.error_code(), status.error_str());
+    return;
+  }
+
   std::vector<std::vector<float>> distances;
   std::vector<pb::common::Vector> result_op_left_vectors;
   std::vector<pb::common::Vector> result_op_right_vectors;
+  std::vector<std::vector<uint32_t>> topk_indexes;
 
-  status = storage->VectorCalcDistance(*request, distances, result_op_left_vectors, result_op_right_vectors);
+  status = storage->VectorCalcDistance(*request, distances, result_op_left_vectors, result_op_right_vectors, topk,
+                                       &topk_indexes);
   if (!status.ok()) {
     ServiceHelper::SetError(response->mutable_error(), status.error_code(), status.error_str());
     return;
   }
 
+  for (const auto& indexes : topk_indexes) {
+    cntl->response_attachment().append(indexes.data(), indexes.size() * sizeof(uint32_t));
+  }
+
   for (const auto& distance : distances) {
     response->add_distances()->mutable_internal_distances()->Add(distance.begin(), distance.end());
   }
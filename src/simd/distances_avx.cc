@@ -20,8 +20,11 @@
 
 #include <immintrin.h>
 
+#include <algorithm>
 #include <cassert>
 
+#include "simd/distances_ref.h"
+
 namespace dingodb {
 
 #define ALIGNED(x) __attribute__((aligned(x)))
@@ -195,5 +198,217 @@ float fvec_Linf_avx(const float* x, const float* y, size_t d) {
   return _mm_cvtss_f32(msum2);
 }
 
+static inline float horizontal_sum_avx(__m256 v) {
+  __m128 msum = _mm_add_ps(_mm256_extractf128_ps(v, 1), _mm256_extractf128_ps(v, 0));
+  msum = _mm_hadd_ps(msum, msum);
+  msum = _mm_hadd_ps(msum, msum);
+  return _mm_cvtss_f32(msum);
+}
+
+// One y vector against four x vectors: each y chunk is loaded once and reused for four accumulators.
+template <bool kIsL2>
+static inline void fvec_op_4x1_avx(const float* x0, const float* x1, const float* x2, const float* x3,
+                                   const float* y, size_t d, float* r0, float* r1, float* r2, float* r3) {
+  __m256 msum0 = _mm256_setzero_ps();
+  __m256 msum1 = _mm256_setzero_ps();
+  __m256 msum2 = _mm256_setzero_ps();
+  __m256 msum3 = _mm256_setzero_ps();
+
+  size_t k = 0;
+  for (; k + 8 <= d; k += 8) {
+    __m256 my = _mm256_loadu_ps(y + k);
+    __m256 mx0 = _mm256_loadu_ps(x0 + k);
+    __m256 mx1 = _mm256_loadu_ps(x1 + k);
+    __m256 mx2 = _mm256_loadu_ps(x2 + k);
+    __m256 mx3 = _mm256_loadu_ps(x3 + k);
+    if constexpr (kIsL2) {
+      mx0 = _mm256_sub_ps(mx0, my);
+      mx1 = _mm256_sub_ps(mx1, my);
+      mx2 = _mm256_sub_ps(mx2, my);
+      mx3 = _mm256_sub_ps(mx3, my);
+      msum0 = _mm256_add_ps(msum0, _mm256_mul_ps(mx0, mx0));
+      msum1 = _mm256_add_ps(msum1, _mm256_mul_ps(mx1, mx1));
+      msum2 = _mm256_add_ps(msum2, _mm256_mul_ps(mx2, mx2));
+      msum3 = _mm256_add_ps(msum3, _mm256_mul_ps(mx3, mx3));
+    } else {
+      msum0 = _mm256_add_ps(msum0, _mm256_mul_ps(mx0, my));
+      msum1 = _mm256_add_ps(msum1, _mm256_mul_ps(mx1, my));
+      msum2 = _mm256_add_ps(msum2, _mm256_mul_ps(mx2, my));
+      msum3 = _mm256_add_ps(msum3, _mm256_mul_ps(mx3, my));
+    }
+  }
+
+  float res0 = horizontal_sum_avx(msum0);
+  float res1 = horizontal_sum_avx(msum1);
+  float res2 = horizontal_sum_avx(msum2);
+  float res3 = horizontal_sum_avx(msum3);
+
+  for (; k < d; k++) {
+    if constexpr (kIsL2) {
+      float t0 = x0[k] - y[k];
+      float t1 = x1[k] - y[k];
+      float t2 = x2[k] - y[k];
+      float t3 = x3[k] - y[k];
+      res0 += t0 * t0;
+      res1 += t1 * t1;
+      res2 += t2 * t2;
+      res3 += t3 * t3;
+    } else {
+      res0 += x0[k] * y[k];
+      res1 += x1[k] * y[k];
+      res2 += x2[k] * y[k];
+      res3 += x3[k] * y[k];
+    }
+  }
+
+  *r0 = res0;
+  *r1 = res1;
+  *r2 = res2;
+  *r3 = res3;
+}
+
+template <bool kIsL2>
+static void fvec_op_nx_ny_avx(float* dis, const float* x, const float* y, size_t d, size_t nx, size_t ny) {
+  size_t block_size = fvec_nx_ny_block_size(d);
+  for (size_t j0 = 0; j0 < ny; j0 += block_size) {
+    size_t j1 = std::min(ny, j0 + block_size);
+
+    size_t i = 0;
+    for (; i + 4 <= nx; i += 4) {
+      const float* x0 = x + i * d;
+      float* dis0 = dis + i * ny;
+      for (size_t j = j0; j < j1; j++) {
+        fvec_op_4x1_avx<kIsL2>(x0, x0 + d, x0 + 2 * d, x0 + 3 * d, y + j * d, d, dis0 + j, dis0 + ny + j,
+                               dis0 + 2 * ny + j, dis0 + 3 * ny + j);
+      }
+    }
+
+    for (; i < nx; i++) {
+      const float* xi = x + i * d;
+      for (size_t j = j0; j < j1; j++) {
+        dis[i * ny + j] = kIsL2 ? fvec_L2sqr_avx(xi, y + j * d, d) : fvec_inner_product_avx(xi, y + j * d, d);
+      }
+    }
+  }
+}
+
+void fvec_L2sqr_nx_ny_avx(float* dis, const float* x, const float* y, size_t d, size_t nx, size_t ny) {
+  fvec_op_nx_ny_avx<true>(dis, x, y, d, nx, ny);
+}
+
+void fvec_inner_products_nx_ny_avx(float* ip, const float* x, const float* y, size_t d, size_t nx, size_t ny) {
+  fvec_op_nx_ny_avx<false>(ip, x, y, d, nx, ny);
+}
+
+static inline __m256 load_fp16_avx(const uint16_t* x) {
+  return _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(x)));
+}
+
+static inline __m256 load_bf16_avx(const uint16_t* x) {
+  __m256i mx = _mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(x)));
+  return _mm256_castsi256_ps(_mm256_slli_epi32(mx, 16));
+}
+
+float fp16vec_L2sqr_avx(const uint16_t* x, const uint16_t* y, size_t d) {
+  __m256 msum = _mm256_setzero_ps();
+  size_t i = 0;
+  for (; i + 8 <= d; i += 8) {
+    const __m256 a_m_b = _mm256_sub_ps(load_fp16_avx(x + i), load_fp16_avx(y + i));
+    msum = _mm256_add_ps(msum, _mm256_mul_ps(a_m_b, a_m_b));
+  }
+  float res = horizontal_sum_avx(msum);
+  if (i < d) {
+    res += fp16vec_L2sqr_ref(x + i, y + i, d - i);
+  }
+  return res;
+}
+
+float fp16vec_inner_product_avx(const uint16_t* x, const uint16_t* y, size_t d) {
+  __m256 msum = _mm256_setzero_ps();
+  size_t i = 0;
+  for (; i + 8 <= d; i += 8) {
+    msum = _mm256_add_ps(msum, _mm256_mul_ps(load_fp16_avx(x + i), load_fp16_avx(y + i)));
+  }
+  float res = horizontal_sum_avx(msum);
+  if (i < d) {
+    res += fp16vec_inner_product_ref(x + i, y + i, d - i);
+  }
+  return res;
+}
+
+float bf16vec_L2sqr_avx(const uint16_t* x, const uint16_t* y, size_t d) {
+  __m256 msum = _mm256_setzero_ps();
+  size_t i = 0;
+  for (; i + 8 <= d; i += 8) {
+    const __m256 a_m_b = _mm256_sub_ps(load_bf16_avx(x + i), load_bf16_avx(y + i));
+    msum = _mm256_add_ps(msum, _mm256_mul_ps(a_m_b, a_m_b));
+  }
+  float res = horizontal_sum_avx(msum);
+  if (i < d) {
+    res += bf16vec_L2sqr_ref(x + i, y + i, d - i);
+  }
+  return res;
+}
+
+float bf16vec_inner_product_avx(const uint16_t* x, const uint16_t* y, size_t d) {
+  __m256 msum = _mm256_setzero_ps();
+  size_t i = 0;
+  for (; i + 8 <= d; i += 8) {
+    msum = _mm256_add_ps(msum, _mm256_mul_ps(load_bf16_avx(x + i), load_bf16_avx(y + i)));
+  }
+  float res = horizontal_sum_avx(msum);
+  if (i < d) {
+    res += bf16vec_inner_product_ref(x + i, y + i, d - i);
+  }
+  return res;
+}
+
+void fvec_to_fp16_avx(uint16_t* dst, const float* src, size_t d) {
+  size_t i = 0;
+  for (; i + 8 <= d; i += 8) {
+    __m128i mh = _mm256_cvtps_ph(_mm256_loadu_ps(src + i), _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), mh);
+  }
+  fvec_to_fp16_ref(dst + i, src + i, d - i);
+}
+
+void fp16vec_to_fvec_avx(float* dst, const uint16_t* src, size_t d) {
+  size_t i = 0;
+  for (; i + 8 <= d; i += 8) {
+    _mm256_storeu_ps(dst + i, load_fp16_avx(src + i));
+  }
+  fp16vec_to_fvec_ref(dst + i, src + i, d - i);
+}
+
+static inline int32_t horizontal_sum_epi32_avx(__m256i v) {
+  __m128i msum = _mm_add_epi32(_mm256_extracti128_si256(v, 1), _mm256_castsi256_si128(v));
+  msum = _mm_hadd_epi32(msum, msum);
+  msum = _mm_hadd_epi32(msum, msum);
+  return _mm_cvtsi128_si32(msum);
+}
+
+int32_t i8vec_inner_product_avx(const int8_t* x, const int8_t* y, size_t d) {
+  __m256i msum = _mm256_setzero_si256();
+  size_t i = 0;
+  for (; i + 16 <= d; i += 16) {
+    __m256i mx = _mm256_cvtepi8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(x + i)));
+    __m256i my = _mm256_cvtepi8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(y + i)));
+    msum = _mm256_add_epi32(msum, _mm256_madd_epi16(mx, my));
+  }
+  return horizontal_sum_epi32_avx(msum) + i8vec_inner_product_ref(x + i, y + i, d - i);
+}
+
+int32_t i8vec_L2sqr_avx(const int8_t* x, const int8_t* y, size_t d) {
+  __m256i msum = _mm256_setzero_si256();
+  size_t i = 0;
+  for (; i + 16 <= d; i += 16) {
+    __m256i mx = _mm256_cvtepi8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(x + i)));
+    __m256i my = _mm256_cvtepi8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(y + i)));
+    __m256i a_m_b = _mm256_sub_epi16(mx, my);
+    msum = _mm256_add_epi32(msum, _mm256_madd_epi16(a_m_b, a_m_b));
+  }
+  return horizontal_sum_epi32_avx(msum) + i8vec_L2sqr_ref(x + i, y + i, d - i);
+}
+
 }  // namespace dingodb
 #endif
@@ -19,10 +19,13 @@
 
 #include <immintrin.h>
 
+#include <algorithm>
 #include <cassert>
 #include <cstdio>
 #include <string>
 
+#include "simd/distances_ref.h"
+
 namespace dingodb {
 
 // reads 0 <= d < 4 floats as __m128
@@ -249,6 +252,215 @@ float fvec_Linf_avx512(const float* x, const float* y, size_t d) {
   return _mm_cvtss_f32(msum2);
 }
 
+// One y vector against four x vectors: each y chunk is loaded once and reused for four accumulators.
+// The d % 16 tail is handled with a masked load, so there is no scalar remainder loop.
+template <bool kIsL2>
+static inline void fvec_op_4x1_avx512(const float* x0, const float* x1, const float* x2, const float* x3,
+                                      const float* y, size_t d, float* r0, float* r1, float* r2, float* r3) {
+  __m512 msum0 = _mm512_setzero_ps();
+  __m512 msum1 = _mm512_setzero_ps();
+  __m512 msum2 = _mm512_setzero_ps();
+  __m512 msum3 = _mm512_setzero_ps();
+
+  size_t k = 0;
+  for (; k + 16 <= d; k += 16) {
+    __m512 my = _mm512_loadu_ps(y + k);
+    __m512 mx0 = _mm512_loadu_ps(x0 + k);
+    __m512 mx1 = _mm512_loadu_ps(x1 + k);
+    __m512 mx2 = _mm512_loadu_ps(x2 + k);
+    __m512 mx3 = _mm512_loadu_ps(x3 + k);
+    if constexpr (kIsL2) {
+      mx0 = _mm512_sub_ps(mx0, my);
+      mx1 = _mm512_sub_ps(mx1, my);
+      mx2 = _mm512_sub_ps(mx2, my);
+      mx3 = _mm512_sub_ps(mx3, my);
+      msum0 = _mm512_fmadd_ps(mx0, mx0, msum0);
+      msum1 = _mm512_fmadd_ps(mx1, mx1, msum1);
+      msum2 = _mm512_fmadd_ps(mx2, mx2, msum2);
+      msum3 = _mm512_fmadd_ps(mx3, mx3, msum3);
+    } else {
+      msum0 = _mm512_fmadd_ps(mx0, my, msum0);
+      msum1 = _mm512_fmadd_ps(mx1, my, msum1);
+      msum2 = _mm512_fmadd_ps(mx2, my, msum2);
+      msum3 = _mm512_fmadd_ps(mx3, my, msum3);
+    }
+  }
+
+  if (k < d) {
+    const __mmask16 mask = (1U << (d - k)) - 1;
+    __m512 my = _mm512_maskz_loadu_ps(mask, y + k);
+    __m512 mx0 = _mm512_maskz_loadu_ps(mask, x0 + k);
+    __m512 mx1 = _mm512_maskz_loadu_ps(mask, x1 + k);
+    __m512 mx2 = _mm512_maskz_loadu_ps(mask, x2 + k);
+    __m512 mx3 = _mm512_maskz_loadu_ps(mask, x3 + k);
+    if constexpr (kIsL2) {
+      mx0 = _mm512_sub_ps(mx0, my);
+      mx1 = _mm512_sub_ps(mx1, my);
+      mx2 = _mm512_sub_ps(mx2, my);
+      mx3 = _mm512_sub_ps(mx3, my);
+      msum0 = _mm512_fmadd_ps(mx0, mx0, msum0);
+      msum1 = _mm512_fmadd_ps(mx1, mx1, msum1);
+      msum2 = _mm512_fmadd_ps(mx2, mx2, msum2);
+      msum3 = _mm512_fmadd_ps(mx3, mx3, msum3);
+    } else {
+      msum0 = _mm512_fmadd_ps(mx0, my, msum0);
+      msum1 = _mm512_fmadd_ps(mx1, my, msum1);
+      msum2 = _mm512_fmadd_ps(mx2, my, msum2);
+      msum3 = _mm512_fmadd_ps(mx3, my, msum3);
+    }
+  }
+
+  *r0 = _mm512_reduce_add_ps(msum0);
+  *r1 = _mm512_reduce_add_ps(msum1);
+  *r2 = _mm512_reduce_add_ps(msum2);
+  *r3 = _mm512_reduce_add_ps(msum3);
+}
+
+template <bool kIsL2>
+static void fvec_op_nx_ny_avx512(float* dis, const float* x, const float* y, size_t d, size_t nx, size_t ny) {
+  size_t block_size = fvec_nx_ny_block_size(d);
+  for (size_t j0 = 0; j0 < ny; j0 += block_size) {
+    size_t j1 = std::min(ny, j0 + block_size);
+
+    size_t i = 0;
+    for (; i + 4 <= nx; i += 4) {
+      const float* x0 = x + i * d;
+      float* dis0 = dis + i * ny;
+      for (size_t j = j0; j < j1; j++) {
+        fvec_op_4x1_avx512<kIsL2>(x0, x0 + d, x0 + 2 * d, x0 + 3 * d, y + j * d, d, dis0 + j, dis0 + ny + j,
+                                  dis0 + 2 * ny + j, dis0 + 3 * ny + j);
+      }
+    }
+
+    for (; i < nx; i++) {
+      const float* xi = x + i * d;
+      for (size_t j = j0; j < j1; j++) {
+        dis[i * ny + j] =
+            kIsL2 ? fvec_L2sqr_avx512(xi, y + j * d, d) : fvec_inner_product_avx512(xi, y + j * d, d);
+      }
+    }
+  }
+}
+
+void fvec_L2sqr_nx_ny_avx512(float* dis, const float* x, const float* y, size_t d, size_t nx, size_t ny) {
+  fvec_op_nx_ny_avx512<true>(dis, x, y, d, nx, ny);
+}
+
+void fvec_inner_products_nx_ny_avx512(float* ip, const float* x, const float* y, size_t d, size_t nx, size_t ny) {
+  fvec_op_nx_ny_avx512<false>(ip, x, y, d, nx, ny);
+}
+
+static inline __m512 load_fp16_avx512(const uint16_t* x) {
+  return _mm512_cvtph_ps(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(x)));
+}
+
+static inline __m512 load_bf16_avx512(const uint16_t* x) {
+  __m512i mx = _mm512_cvtepu16_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(x)));
+  return _mm512_castsi512_ps(_mm512_slli_epi32(mx, 16));
+}
+
+// 512 bit masked load keeps this within AVX512BW, the 256 bit form needs AVX512VL.
+static inline __m256i maskz_load_epi16_avx512(__mmask16 mask, const uint16_t* x) {
+  return _mm512_castsi512_si256(_mm512_maskz_loadu_epi16(static_cast<__mmask32>(mask), x));
+}
+
+static inline __m512 maskz_load_fp16_avx512(__mmask16 mask, const uint16_t* x) {
+  return _mm512_cvtph_ps(maskz_load_epi16_avx512(mask, x));
+}
+
+static inline __m512 maskz_load_bf16_avx512(__mmask16 mask, const uint16_t* x) {
+  __m512i mx = _mm512_cvtepu16_epi32(maskz_load_epi16_avx512(mask, x));
+  return _mm512_castsi512_ps(_mm512_slli_epi32(mx, 16));
+}
+
+// Half precision values are widened to float and accumulated with fma, which keeps float accuracy and only
+// needs AVX512F/BW, so it also runs on cpus without AVX512-FP16 or AVX512-BF16 arithmetic.
+template <bool kIsBf16, bool kIsL2>
+static inline float half_op_avx512(const uint16_t* x, const uint16_t* y, size_t d) {
+  __m512 msum = _mm512_setzero_ps();
+  size_t i = 0;
+  for (; i + 16 <= d; i += 16) {
+    __m512 mx = kIsBf16 ? load_bf16_avx512(x + i) : load_fp16_avx512(x + i);
+    __m512 my = kIsBf16 ? load_bf16_avx512(y + i) : load_fp16_avx512(y + i);
+    if constexpr (kIsL2) {
+      mx = _mm512_sub_ps(mx, my);
+      msum = _mm512_fmadd_ps(mx, mx, msum);
+    } else {
+      msum = _mm512_fmadd_ps(mx, my, msum);
+    }
+  }
+
+  if (i < d) {
+    const __mmask16 mask = (1U << (d - i)) - 1;
+    __m512 mx = kIsBf16 ? maskz_load_bf16_avx512(mask, x + i) : maskz_load_fp16_avx512(mask, x + i);
+    __m512 my = kIsBf16 ? maskz_load_bf16_avx512(mask, y + i) : maskz_load_fp16_avx512(mask, y + i);
+    if constexpr (kIsL2) {
+      mx = _mm512_sub_ps(mx, my);
+      msum = _mm512_fmadd_ps(mx, mx, msum);
+    } else {
+      msum = _mm512_fmadd_ps(mx, my, msum);
+    }
+  }
+
+  return _mm512_reduce_add_ps(msum);
+}
+
+float fp16vec_L2sqr_avx512(const uint16_t* x, const uint16_t* y, size_t d) {
+  return half_op_avx512<false, true>(x, y, d);
+}
+
+float fp16vec_inner_product_avx512(const uint16_t* x, const uint16_t* y, size_t d) {
+  return half_op_avx512<false, false>(x, y, d);
+}
+
+float bf16vec_L2sqr_avx512(const uint16_t* x, const uint16_t* y, size_t d) {
+  return half_op_avx512<true, true>(x, y, d);
+}
+
+float bf16vec_inner_product_avx512(const uint16_t* x, const uint16_t* y, size_t d) {
+  return half_op_avx512<true, false>(x, y, d);
+}
+
+void fvec_to_fp16_avx512(uint16_t* dst, const float* src, size_t d) {
+  size_t i = 0;
+  for (; i + 16 <= d; i += 16) {
+    __m256i mh = _mm512_cvtps_ph(_mm512_loadu_ps(src + i), _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), mh);
+  }
+  fvec_to_fp16_ref(dst + i, src + i, d - i);
+}
+
+void fp16vec_to_fvec_avx512(float* dst, const uint16_t* src, size_t d) {
+  size_t i = 0;
+  for (; i + 16 <= d; i += 16) {
+    _mm512_storeu_ps(dst + i, load_fp16_avx512(src + i));
+  }
+  fp16vec_to_fvec_ref(dst + i, src + i, d - i);
+}
+
+int32_t i8vec_inner_product_avx512(const int8_t* x, const int8_t* y, size_t d) {
+  __m512i msum = _mm512_setzero_si512();
+  size_t i = 0;
+  for (; i + 32 <= d; i += 32) {
+    __m512i mx = _mm512_cvtepi8_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(x + i)));
+    __m512i my = _mm512_cvtepi8_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(y + i)));
+    msum = _mm512_add_epi32(msum, _mm512_madd_epi16(mx, my));
+  }
+  return _mm512_reduce_add_epi32(msum) + i8vec_inner_product_ref(x + i, y + i, d - i);
+}
+
+int32_t i8vec_L2sqr_avx512(const int8_t* x, const int8_t* y, size_t d) {
+  __m512i msum = _mm512_setzero_si512();
+  size_t i = 0;
+  for (; i + 32 <= d; i += 32) {
+    __m512i mx = _mm512_cvtepi8_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(x + i)));
+    __m512i my = _mm512_cvtepi8_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(y + i)));
+    __m512i a_m_b = _mm512_sub_epi16(mx, my);
+    msum = _mm512_add_epi32(msum, _mm512_madd_epi16(a_m_b, a_m_b));
+  }
+  return _mm512_reduce_add_epi32(msum) + i8vec_L2sqr_ref(x + i, y + i, d - i);
+}
+
 }  // namespace dingodb
 
 #endif
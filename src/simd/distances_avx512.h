@@ -33,6 +33,25 @@ float fvec_L1_avx512(const float* x, const float* y, size_t d);
 /// infinity distance
 float fvec_Linf_avx512(const float* x, const float* y, size_t d);
 
+/// nx x ny square L2 distance matrix, four x vectors share every y load
+void fvec_L2sqr_nx_ny_avx512(float* dis, const float* x, const float* y, size_t d, size_t nx, size_t ny);
+
+/// nx x ny inner product matrix, four x vectors share every y load
+void fvec_inner_products_nx_ny_avx512(float* ip, const float* x, const float* y, size_t d, size_t nx, size_t ny);
+
+/// half precision distances, values are widened to float before accumulation
+float fp16vec_L2sqr_avx512(const uint16_t* x, const uint16_t* y, size_t d);
+float fp16vec_inner_product_avx512(const uint16_t* x, const uint16_t* y, size_t d);
+float bf16vec_L2sqr_avx512(const uint16_t* x, const uint16_t* y, size_t d);
+float bf16vec_inner_product_avx512(const uint16_t* x, const uint16_t* y, size_t d);
+
+void fvec_to_fp16_avx512(uint16_t* dst, const float* src, size_t d);
+void fp16vec_to_fvec_avx512(float* dst, const uint16_t* src, size_t d);
+
+/// int8 vectors, widened to int16 and accumulated by madd, needs AVX512BW
+int32_t i8vec_inner_product_avx512(const int8_t* x, const int8_t* y, size_t d);
+int32_t i8vec_L2sqr_avx512(const int8_t* x, const int8_t* y, size_t d);
+
 }  // namespace dingodb
 
 #endif  // DINGODB_SIMD_DISTANCES_AVX512_H_  //NOLINT
@@ -0,0 +1,403 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#if defined(__aarch64__)
+
+#include "simd/distances_neon.h"
+
+#include <arm_neon.h>
+
+#include <algorithm>
+#include <cmath>
+
+#include "simd/distances_ref.h"
+
+namespace dingodb {
+
+float fvec_inner_product_neon(const float* x, const float* y, size_t d) {
+  float32x4_t msum0 = vdupq_n_f32(0.0f);
+  float32x4_t msum1 = vdupq_n_f32(0.0f);
+  size_t i = 0;
+  for (; i + 8 <= d; i += 8) {
+    msum0 = vfmaq_f32(msum0, vld1q_f32(x + i), vld1q_f32(y + i));
+    msum1 = vfmaq_f32(msum1, vld1q_f32(x + i + 4), vld1q_f32(y + i + 4));
+  }
+  if (i + 4 <= d) {
+    msum0 = vfmaq_f32(msum0, vld1q_f32(x + i), vld1q_f32(y + i));
+    i += 4;
+  }
+  float res = vaddvq_f32(vaddq_f32(msum0, msum1));
+  for (; i < d; i++) {
+    res += x[i] * y[i];
+  }
+  return res;
+}
+
+float fvec_L2sqr_neon(const float* x, const float* y, size_t d) {
+  float32x4_t msum0 = vdupq_n_f32(0.0f);
+  float32x4_t msum1 = vdupq_n_f32(0.0f);
+  size_t i = 0;
+  for (; i + 8 <= d; i += 8) {
+    float32x4_t a_m_b0 = vsubq_f32(vld1q_f32(x + i), vld1q_f32(y + i));
+    float32x4_t a_m_b1 = vsubq_f32(vld1q_f32(x + i + 4), vld1q_f32(y + i + 4));
+    msum0 = vfmaq_f32(msum0, a_m_b0, a_m_b0);
+    msum1 = vfmaq_f32(msum1, a_m_b1, a_m_b1);
+  }
+  if (i + 4 <= d) {
+    float32x4_t a_m_b0 = vsubq_f32(vld1q_f32(x + i), vld1q_f32(y + i));
+    msum0 = vfmaq_f32(msum0, a_m_b0, a_m_b0);
+    i += 4;
+  }
+  float res = vaddvq_f32(vaddq_f32(msum0, msum1));
+  for (; i < d; i++) {
+    const float tmp = x[i] - y[i];
+    res += tmp * tmp;
+  }
+  return res;
+}
+
+float fvec_L1_neon(const float* x, const float* y, size_t d) {
+  float32x4_t msum = vdupq_n_f32(0.0f);
+  size_t i = 0;
+  for (; i + 4 <= d; i += 4) {
+    msum = vaddq_f32(msum, vabdq_f32(vld1q_f32(x + i), vld1q_f32(y + i)));
+  }
+  float res = vaddvq_f32(msum);
+  for (; i < d; i++) {
+    res += std::fabs(x[i] - y[i]);
+  }
+  return res;
+}
+
+float fvec_Linf_neon(const float* x, const float* y, size_t d) {
+  float32x4_t mmax = vdupq_n_f32(0.0f);
+  size_t i = 0;
+  for (; i + 4 <= d; i += 4) {
+    mmax = vmaxq_f32(mmax, vabdq_f32(vld1q_f32(x + i), vld1q_f32(y + i)));
+  }
+  float res = vmaxvq_f32(mmax);
+  for (; i < d; i++) {
+    res = std::fmax(res, std::fabs(x[i] - y[i]));
+  }
+  return res;
+}
+
+float fvec_norm_L2sqr_neon(const float* x, size_t d) {
+  float32x4_t msum0 = vdupq_n_f32(0.0f);
+  float32x4_t msum1 = vdupq_n_f32(0.0f);
+  size_t i = 0;
+  for (; i + 8 <= d; i += 8) {
+    float32x4_t mx0 = vld1q_f32(x + i);
+    float32x4_t mx1 = vld1q_f32(x + i + 4);
+    msum0 = vfmaq_f32(msum0, mx0, mx0);
+    msum1 = vfmaq_f32(msum1, mx1, mx1);
+  }
+  if (i + 4 <= d) {
+    float32x4_t mx0 = vld1q_f32(x + i);
+    msum0 = vfmaq_f32(msum0, mx0, mx0);
+    i += 4;
+  }
+  float res = vaddvq_f32(vaddq_f32(msum0, msum1));
+  for (; i < d; i++) {
+    res += x[i] * x[i];
+  }
+  return res;
+}
+
+// One shared vector s against four vectors v0..v3: each chunk of s is loaded once and reused for four
+// accumulators. Both distances are symmetric, so it serves both the ny (s = x) and nx_ny (s = y) kernels.
+template <bool kIsL2>
+static inline void fvec_op_4x1_neon(const float* v0, const float* v1, const float* v2, const float* v3,
+                                    const float* s, size_t d, float* r0, float* r1, float* r2, float* r3) {
+  float32x4_t msum0 = vdupq_n_f32(0.0f);
+  float32x4_t msum1 = vdupq_n_f32(0.0f);
+  float32x4_t msum2 = vdupq_n_f32(0.0f);
+  float32x4_t msum3 = vdupq_n_f32(0.0f);
+
+  size_t k = 0;
+  for (; k + 4 <= d; k += 4) {
+    float32x4_t ms = vld1q_f32(s + k);
+    float32x4_t mv0 = vld1q_f32(v0 + k);
+    float32x4_t mv1 = vld1q_f32(v1 + k);
+    float32x4_t mv2 = vld1q_f32(v2 + k);
+    float32x4_t mv3 = vld1q_f32(v3 + k);
+    if constexpr (kIsL2) {
+      mv0 = vsubq_f32(mv0, ms);
+      mv1 = vsubq_f32(mv1, ms);
+      mv2 = vsubq_f32(mv2, ms);
+      mv3 = vsubq_f32(mv3, ms);
+      msum0 = vfmaq_f32(msum0, mv0, mv0);
+      msum1 = vfmaq_f32(msum1, mv1, mv1);
+      msum2 = vfmaq_f32(msum2, mv2, mv2);
+      msum3 = vfmaq_f32(msum3, mv3, mv3);
+    } else {
+      msum0 = vfmaq_f32(msum0, mv0, ms);
+      msum1 = vfmaq_f32(msum1, mv1, ms);
+      msum2 = vfmaq_f32(msum2, mv2, ms);
+      msum3 = vfmaq_f32(msum3, mv3, ms);
+    }
+  }
+
+  float res0 = vaddvq_f32(msum0);
+  float res1 = vaddvq_f32(msum1);
+  float res2 = vaddvq_f32(msum2);
+  float res3 = vaddvq_f32(msum3);
+
+  for (; k < d; k++) {
+    if constexpr (kIsL2) {
+      float t0 = v0[k] - s[k];
+      float t1 = v1[k] - s[k];
+      float t2 = v2[k] - s[k];
+      float t3 = v3[k] - s[k];
+      res0 += t0 * t0;
+      res1 += t1 * t1;
+      res2 += t2 * t2;
+      res3 += t3 * t3;
+    } else {
+      res0 += v0[k] * s[k];
+      res1 += v1[k] * s[k];
+      res2 += v2[k] * s[k];
+      res3 += v3[k] * s[k];
+    }
+  }
+
+  *r0 = res0;
+  *r1 = res1;
+  *r2 = res2;
+  *r3 = res3;
+}
+
+template <bool kIsL2>
+static void fvec_op_ny_neon(float* dis, const float* x, const float* y, size_t d, size_t ny) {
+  size_t j = 0;
+  for (; j + 4 <= ny; j += 4) {
+    const float* y0 = y + j * d;
+    fvec_op_4x1_neon<kIsL2>(y0, y0 + d, y0 + 2 * d, y0 + 3 * d, x, d, dis + j, dis + j + 1, dis + j + 2,
+                            dis + j + 3);
+  }
+  for (; j < ny; j++) {
+    dis[j] = kIsL2 ? fvec_L2sqr_neon(x, y + j * d, d) : fvec_inner_product_neon(x, y + j * d, d);
+  }
+}
+
+void fvec_L2sqr_ny_neon(float* dis, const float* x, const float* y, size_t d, size_t ny) {
+  fvec_op_ny_neon<true>(dis, x, y, d, ny);
+}
+
+void fvec_inner_products_ny_neon(float* ip, const float* x, const float* y, size_t d, size_t ny) {
+  fvec_op_ny_neon<false>(ip, x, y, d, ny);
+}
+
+template <bool kIsL2>
+static void fvec_op_nx_ny_neon(float* dis, const float* x, const float* y, size_t d, size_t nx, size_t ny) {
+  size_t block_size = fvec_nx_ny_block_size(d);
+  for (size_t j0 = 0; j0 < ny; j0 += block_size) {
+    size_t j1 = std::min(ny, j0 + block_size);
+
+    size_t i = 0;
+    for (; i + 4 <= nx; i += 4) {
+      const float* x0 = x + i * d;
+      float* dis0 = dis + i * ny;
+      for (size_t j = j0; j < j1; j++) {
+        fvec_op_4x1_neon<kIsL2>(x0, x0 + d, x0 + 2 * d, x0 + 3 * d, y + j * d, d, dis0 + j, dis0 + ny + j,
+                                dis0 + 2 * ny + j, dis0 + 3 * ny + j);
+      }
+    }
+
+    for (; i < nx; i++) {
+      const float* xi = x + i * d;
+      for (size_t j = j0; j < j1; j++) {
+        dis[i * ny + j] = kIsL2 ? fvec_L2sqr_neon(xi, y + j * d, d) : fvec_inner_product_neon(xi, y + j * d, d);
+      }
+    }
+  }
+}
+
+void fvec_L2sqr_nx_ny_neon(float* dis, const float* x, const float* y, size_t d, size_t nx, size_t ny) {
+  fvec_op_nx_ny_neon<true>(dis, x, y, d, nx, ny);
+}
+
+void fvec_inner_products_nx_ny_neon(float* ip, const float* x, const float* y, size_t d, size_t nx, size_t ny) {
+  fvec_op_nx_ny_neon<false>(ip, x, y, d, nx, ny);
+}
+
+static inline float32x4_t load_fp16_neon(const uint16_t* x) {
+  return vcvt_f32_f16(vreinterpret_f16_u16(vld1_u16(x)));
+}
+
+static inline float32x4_t load_bf16_neon(const uint16_t* x) {
+  return vreinterpretq_f32_u32(vshlq_n_u32(vmovl_u16(vld1_u16(x)), 16));
+}
+
+float fp16vec_L2sqr_neon(const uint16_t* x, const uint16_t* y, size_t d) {
+  float32x4_t msum = vdupq_n_f32(0.0f);
+  size_t i = 0;
+  for (; i + 4 <= d; i += 4) {
+    float32x4_t a_m_b = vsubq_f32(load_fp16_neon(x + i), load_fp16_neon(y + i));
+    msum = vfmaq_f32(msum, a_m_b, a_m_b);
+  }
+  float res = vaddvq_f32(msum);
+  if (i < d) {
+    res += fp16vec_L2sqr_ref(x + i, y + i, d - i);
+  }
+  return res;
+}
+
+float fp16vec_inner_product_neon(const uint16_t* x, const uint16_t* y, size_t d) {
+  float32x4_t msum = vdupq_n_f32(0.0f);
+  size_t i = 0;
+  for (; i + 4 <= d; i += 4) {
+    msum = vfmaq_f32(msum, load_fp16_neon(x + i), load_fp16_neon(y + i));
+  }
+  float res = vaddvq_f32(msum);
+  if (i < d) {
+    res += fp16vec_inner_product_ref(x + i, y + i, d - i);
+  }
+  return res;
+}
+
+float bf16vec_L2sqr_neon(const uint16_t* x, const uint16_t* y, size_t d) {
+  float32x4_t msum = vdupq_n_f32(0.0f);
+  size_t i = 0;
+  for (; i + 4 <= d; i += 4) {
+    float32x4_t a_m_b = vsubq_f32(load_bf16_neon(x + i), load_bf16_neon(y + i));
+    msum = vfmaq_f32(msum, a_m_b, a_m_b);
+  }
+  float res = vaddvq_f32(msum);
+  if (i < d) {
+    res += bf16vec_L2sqr_ref(x + i, y + i, d - i);
+  }
+  return res;
+}
+
+float bf16vec_inner_product_neon(const uint16_t* x, const uint16_t* y, size_t d) {
+  float32x4_t msum = vdupq_n_f32(0.0f);
+  size_t i = 0;
+  for (; i + 4 <= d; i += 4) {
+    msum = vfmaq_f32(msum, load_bf16_neon(x + i), load_bf16_neon(y + i));
+  }
+  float res = vaddvq_f32(msum);
+  if (i < d) {
+    res += bf16vec_inner_product_ref(x + i, y + i, d - i);
+  }
+  return res;
+}
+
+void fvec_to_fp16_neon(uint16_t* dst, const float* src, size_t d) {
+  size_t i = 0;
+  for (; i + 4 <= d; i += 4) {
+    // fcvtn rounds by FPCR, which is round to nearest even in user space
+    vst1_u16(dst + i, vreinterpret_u16_f16(vcvt_f16_f32(vld1q_f32(src + i))));
+  }
+  fvec_to_fp16_ref(dst + i, src + i, d - i);
+}
+
+void fp16vec_to_fvec_neon(float* dst, const uint16_t* src, size_t d) {
+  size_t i = 0;
+  for (; i + 4 <= d; i += 4) {
+    vst1q_f32(dst + i, load_fp16_neon(src + i));
+  }
+  fp16vec_to_fvec_ref(dst + i, src + i, d - i);
+}
+
+int32_t i8vec_inner_product_neon(const int8_t* x, const int8_t* y, size_t d) {
+  int32x4_t msum = vdupq_n_s32(0);
+  size_t i = 0;
+  for (; i + 16 <= d; i += 16) {
+    int8x16_t mx = vld1q_s8(x + i);
+    int8x16_t my = vld1q_s8(y + i);
+    // |int8 * int8| <= 2^14, the int16 products are pairwise added into int32
+    msum = vpadalq_s16(msum, vmull_s8(vget_low_s8(mx), vget_low_s8(my)));
+    msum = vpadalq_s16(msum, vmull_high_s8(mx, my));
+  }
+  return vaddvq_s32(msum) + i8vec_inner_product_ref(x + i, y + i, d - i);
+}
+
+int32_t i8vec_L2sqr_neon(const int8_t* x, const int8_t* y, size_t d) {
+  int32x4_t msum = vdupq_n_s32(0);
+  size_t i = 0;
+  for (; i + 16 <= d; i += 16) {
+    int8x16_t mx = vld1q_s8(x + i);
+    int8x16_t my = vld1q_s8(y + i);
+    // the difference needs 9 bits, its square is accumulated in int32
+    int16x8_t a_m_b0 = vsubl_s8(vget_low_s8(mx), vget_low_s8(my));
+    int16x8_t a_m_b1 = vsubl_high_s8(mx, my);
+    msum = vmlal_s16(msum, vget_low_s16(a_m_b0), vget_low_s16(a_m_b0));
+    msum = vmlal_high_s16(msum, a_m_b0, a_m_b0);
+    msum = vmlal_s16(msum, vget_low_s16(a_m_b1), vget_low_s16(a_m_b1));
+    msum = vmlal_high_s16(msum, a_m_b1, a_m_b1);
+  }
+  return vaddvq_s32(msum) + i8vec_L2sqr_ref(x + i, y + i, d - i);
+}
+
+void fvec_madd_neon(size_t n, const float* a, float bf, const float* b, float* c) {
+  float32x4_t mbf = vdupq_n_f32(bf);
+  size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    vst1q_f32(c + i, vfmaq_f32(vld1q_f32(a + i), mbf, vld1q_f32(b + i)));
+  }
+  for (; i < n; i++) {
+    c[i] = a[i] + bf * b[i];
+  }
+}
+
+int fvec_madd_and_argmin_neon(size_t n, const float* a, float bf, const float* b, float* c) {
+  float32x4_t mbf = vdupq_n_f32(bf);
+  float32x4_t vmin4 = vdupq_n_f32(1e20);
+  int32x4_t imin4 = vdupq_n_s32(-1);
+  int32x4_t idx4 = {0, 1, 2, 3};
+  const int32x4_t inc4 = vdupq_n_s32(4);
+
+  size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    float32x4_t vc = vfmaq_f32(vld1q_f32(a + i), mbf, vld1q_f32(b + i));
+    vst1q_f32(c + i, vc);
+    // strict less keeps the first index of every lane
+    uint32x4_t mask = vcltq_f32(vc, vmin4);
+    vmin4 = vbslq_f32(mask, vc, vmin4);
+    imin4 = vbslq_s32(mask, idx4, imin4);
+    idx4 = vaddq_s32(idx4, inc4);
+  }
+
+  float vmins[4];
+  int32_t imins[4];
+  vst1q_f32(vmins, vmin4);
+  vst1q_s32(imins, imin4);
+
+  // the smallest value, ties resolved to the smallest index as the scalar version
+  float vmin = 1e20;
+  int imin = -1;
+  for (int lane = 0; lane < 4; lane++) {
+    if (imins[lane] < 0) {
+      continue;
+    }
+    if (vmins[lane] < vmin || (vmins[lane] == vmin && imins[lane] < imin)) {
+      vmin = vmins[lane];
+      imin = imins[lane];
+    }
+  }
+
+  for (; i < n; i++) {
+    c[i] = a[i] + bf * b[i];
+    if (c[i] < vmin) {
+      vmin = c[i];
+      imin = i;
+    }
+  }
+  return imin;
+}
+
+}  // namespace dingodb
+
+#endif  // __aarch64__
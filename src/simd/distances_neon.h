@@ -0,0 +1,64 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_SIMD_DISTANCES_NEON_H_
+#define DINGODB_SIMD_DISTANCES_NEON_H_
+
+#include <cstddef>
+#include <cstdint>
+
+namespace dingodb {
+
+/// Squared L2 distance between two vectors
+float fvec_L2sqr_neon(const float* x, const float* y, size_t d);
+
+/// inner product
+float fvec_inner_product_neon(const float* x, const float* y, size_t d);
+
+/// L1 distance
+float fvec_L1_neon(const float* x, const float* y, size_t d);
+
+/// infinity distance
+float fvec_Linf_neon(const float* x, const float* y, size_t d);
+
+float fvec_norm_L2sqr_neon(const float* x, size_t d);
+
+/// one x against ny contiguous y vectors, four y vectors share every x load
+void fvec_L2sqr_ny_neon(float* dis, const float* x, const float* y, size_t d, size_t ny);
+void fvec_inner_products_ny_neon(float* ip, const float* x, const float* y, size_t d, size_t ny);
+
+/// nx x ny distance matrix, four x vectors share every y load
+void fvec_L2sqr_nx_ny_neon(float* dis, const float* x, const float* y, size_t d, size_t nx, size_t ny);
+void fvec_inner_products_nx_ny_neon(float* ip, const float* x, const float* y, size_t d, size_t nx, size_t ny);
+
+/// half precision distances, fp16 is converted by the armv8 fcvtl instruction
+float fp16vec_L2sqr_neon(const uint16_t* x, const uint16_t* y, size_t d);
+float fp16vec_inner_product_neon(const uint16_t* x, const uint16_t* y, size_t d);
+float bf16vec_L2sqr_neon(const uint16_t* x, const uint16_t* y, size_t d);
+float bf16vec_inner_product_neon(const uint16_t* x, const uint16_t* y, size_t d);
+
+void fvec_to_fp16_neon(uint16_t* dst, const float* src, size_t d);
+void fp16vec_to_fvec_neon(float* dst, const uint16_t* src, size_t d);
+
+/// int8 vectors, widened by the long multiply and accumulated in int32
+int32_t i8vec_inner_product_neon(const int8_t* x, const int8_t* y, size_t d);
+int32_t i8vec_L2sqr_neon(const int8_t* x, const int8_t* y, size_t d);
+
+void fvec_madd_neon(size_t n, const float* a, float bf, const float* b, float* c);
+
+int fvec_madd_and_argmin_neon(size_t n, const float* a, float bf, const float* b, float* c);
+
+}  // namespace dingodb
+
+#endif  // DINGODB_SIMD_DISTANCES_NEON_H_ //NOLINT
@@ -18,9 +18,15 @@
 
 #include "simd/distances_ref.h"
 
+#include <algorithm>
 #include <cmath>
+#include <cstring>
 namespace dingodb {
 
+// The nx x ny kernels walk y in tiles of about this many bytes, so one tile stays in L2 while every x is
+// compared against it.
+static const size_t kNxNyBlockBytes = 256 * 1024;
+
 float fvec_L2sqr_ref(const float* x, const float* y, size_t d) {
   size_t i;
   float res = 0;
@@ -78,6 +84,182 @@ void fvec_inner_products_ny_ref(float* ip, const float* x, const float* y, size_
   }
 }
 
+size_t fvec_nx_ny_block_size(size_t d) {
+  if (d == 0) {
+    return 1;
+  }
+  return std::max(static_cast<size_t>(1), kNxNyBlockBytes / (d * sizeof(float)));
+}
+
+void fvec_L2sqr_nx_ny_ref(float* dis, const float* x, const float* y, size_t d, size_t nx, size_t ny) {
+  size_t block_size = fvec_nx_ny_block_size(d);
+  for (size_t j0 = 0; j0 < ny; j0 += block_size) {
+    size_t j1 = std::min(ny, j0 + block_size);
+    for (size_t i = 0; i < nx; i++) {
+      const float* xi = x + i * d;
+      for (size_t j = j0; j < j1; j++) {
+        dis[i * ny + j] = fvec_L2sqr_ref(xi, y + j * d, d);
+      }
+    }
+  }
+}
+
+void fvec_inner_products_nx_ny_ref(float* ip, const float* x, const float* y, size_t d, size_t nx, size_t ny) {
+  size_t block_size = fvec_nx_ny_block_size(d);
+  for (size_t j0 = 0; j0 < ny; j0 += block_size) {
+    size_t j1 = std::min(ny, j0 + block_size);
+    for (size_t i = 0; i < nx; i++) {
+      const float* xi = x + i * d;
+      for (size_t j = j0; j < j1; j++) {
+        ip[i * ny + j] = fvec_inner_product_ref(xi, y + j * d, d);
+      }
+    }
+  }
+}
+
+uint16_t float_to_fp16_ref(float f) {
+  uint32_t x;
+  memcpy(&x, &f, sizeof(x));
+
+  uint32_t sign = (x >> 16) & 0x8000;
+  uint32_t abs = x & 0x7fffffff;
+
+  // nan and inf
+  if (abs >= 0x7f800000) {
+    return static_cast<uint16_t>(sign | 0x7c00 | (abs > 0x7f800000 ? 0x200 : 0));
+  }
+  // overflow, round to inf
+  if (abs >= 0x477ff000) {
+    return static_cast<uint16_t>(sign | 0x7c00);
+  }
+  // normal half
+  if (abs >= 0x38800000) {
+    uint32_t mant_odd = (abs >> 13) & 1;
+    abs += 0xc8000fff + mant_odd;
+    return static_cast<uint16_t>(sign | (abs >> 13));
+  }
+  // subnormal half or zero
+  if (abs < 0x33000001) {
+    return static_cast<uint16_t>(sign);
+  }
+  uint32_t exp = abs >> 23;
+  uint32_t mant = (abs & 0x7fffff) | 0x800000;
+  uint32_t shift = 126 - exp;
+  uint32_t half_mant = mant >> shift;
+  uint32_t rem = mant & ((1U << shift) - 1);
+  uint32_t halfway = 1U << (shift - 1);
+  if (rem > halfway || (rem == halfway && (half_mant & 1))) {
+    half_mant++;
+  }
+  return static_cast<uint16_t>(sign | half_mant);
+}
+
+float fp16_to_float_ref(uint16_t h) {
+  uint32_t sign = (static_cast<uint32_t>(h) & 0x8000) << 16;
+  uint32_t exp = (h >> 10) & 0x1f;
+  uint32_t mant = h & 0x3ff;
+
+  uint32_t x;
+  if (exp == 0x1f) {
+    x = sign | 0x7f800000 | (mant << 13);
+  } else if (exp != 0) {
+    x = sign | ((exp + 112) << 23) | (mant << 13);
+  } else if (mant != 0) {
+    // subnormal, normalize it
+    exp = 113;
+    while ((mant & 0x400) == 0) {
+      mant <<= 1;
+      exp--;
+    }
+    x = sign | (exp << 23) | ((mant & 0x3ff) << 13);
+  } else {
+    x = sign;
+  }
+
+  float f;
+  memcpy(&f, &x, sizeof(f));
+  return f;
+}
+
+uint16_t float_to_bf16_ref(float f) {
+  uint32_t x;
+  memcpy(&x, &f, sizeof(x));
+  if ((x & 0x7fffffff) > 0x7f800000) {
+    // keep nan quiet
+    return static_cast<uint16_t>((x >> 16) | 0x40);
+  }
+  x += 0x7fff + ((x >> 16) & 1);
+  return static_cast<uint16_t>(x >> 16);
+}
+
+float bf16_to_float_ref(uint16_t h) {
+  uint32_t x = static_cast<uint32_t>(h) << 16;
+  float f;
+  memcpy(&f, &x, sizeof(f));
+  return f;
+}
+
+void fvec_to_fp16_ref(uint16_t* dst, const float* src, size_t d) {
+  for (size_t i = 0; i < d; i++) dst[i] = float_to_fp16_ref(src[i]);
+}
+
+void fp16vec_to_fvec_ref(float* dst, const uint16_t* src, size_t d) {
+  for (size_t i = 0; i < d; i++) dst[i] = fp16_to_float_ref(src[i]);
+}
+
+void fvec_to_bf16_ref(uint16_t* dst, const float* src, size_t d) {
+  for (size_t i = 0; i < d; i++) dst[i] = float_to_bf16_ref(src[i]);
+}
+
+void bf16vec_to_fvec_ref(float* dst, const uint16_t* src, size_t d) {
+  for (size_t i = 0; i < d; i++) dst[i] = bf16_to_float_ref(src[i]);
+}
+
+float fp16vec_L2sqr_ref(const uint16_t* x, const uint16_t* y, size_t d) {
+  float res = 0;
+  for (size_t i = 0; i < d; i++) {
+    const float tmp = fp16_to_float_ref(x[i]) - fp16_to_float_ref(y[i]);
+    res += tmp * tmp;
+  }
+  return res;
+}
+
+float fp16vec_inner_product_ref(const uint16_t* x, const uint16_t* y, size_t d) {
+  float res = 0;
+  for (size_t i = 0; i < d; i++) res += fp16_to_float_ref(x[i]) * fp16_to_float_ref(y[i]);
+  return res;
+}
+
+float bf16vec_L2sqr_ref(const uint16_t* x, const uint16_t* y, size_t d) {
+  float res = 0;
+  for (size_t i = 0; i < d; i++) {
+    const float tmp = bf16_to_float_ref(x[i]) - bf16_to_float_ref(y[i]);
+    res += tmp * tmp;
+  }
+  return res;
+}
+
+float bf16vec_inner_product_ref(const uint16_t* x, const uint16_t* y, size_t d) {
+  float res = 0;
+  for (size_t i = 0; i < d; i++) res += bf16_to_float_ref(x[i]) * bf16_to_float_ref(y[i]);
+  return res;
+}
+
+int32_t i8vec_inner_product_ref(const int8_t* x, const int8_t* y, size_t d) {
+  int32_t res = 0;
+  for (size_t i = 0; i < d; i++) res += static_cast<int32_t>(x[i]) * static_cast<int32_t>(y[i]);
+  return res;
+}
+
+int32_t i8vec_L2sqr_ref(const int8_t* x, const int8_t* y, size_t d) {
+  int32_t res = 0;
+  for (size_t i = 0; i < d; i++) {
+    const int32_t tmp = static_cast<int32_t>(x[i]) - static_cast<int32_t>(y[i]);
+    res += tmp * tmp;
+  }
+  return res;
+}
+
 void fvec_madd_ref(size_t n, const float* a, float bf, const float* b, float* c) {
   for (size_t i = 0; i < n; i++) c[i] = a[i] + bf * b[i];
 }
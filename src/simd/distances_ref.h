@@ -17,6 +17,7 @@
 #ifndef DINGODB_SIMD_DISTANCES_REF_H_
 #define DINGODB_SIMD_DISTANCES_REF_H_
 
+#include <cstdint>
 #include <cstdio>
 
 namespace dingodb {
@@ -42,6 +43,38 @@ void fvec_L2sqr_ny_ref(float* dis, const float* x, const float* y, size_t d, siz
 /// compute the inner product between nx vectors x and one y
 void fvec_inner_products_ny_ref(float* ip, const float* x, const float* y, size_t d, size_t ny);
 
+/// compute the nx x ny square L2 distance matrix between contiguous x and y vectors, dis[i * ny + j]
+void fvec_L2sqr_nx_ny_ref(float* dis, const float* x, const float* y, size_t d, size_t nx, size_t ny);
+
+/// compute the nx x ny inner product matrix between contiguous x and y vectors, ip[i * ny + j]
+void fvec_inner_products_nx_ny_ref(float* ip, const float* x, const float* y, size_t d, size_t nx, size_t ny);
+
+/// number of y vectors of dimension d in one cache resident tile of the nx x ny kernels
+size_t fvec_nx_ny_block_size(size_t d);
+
+/// IEEE 754 half precision <-> float, round to nearest even
+uint16_t float_to_fp16_ref(float f);
+float fp16_to_float_ref(uint16_t h);
+
+/// bfloat16 <-> float, round to nearest even
+uint16_t float_to_bf16_ref(float f);
+float bf16_to_float_ref(uint16_t h);
+
+void fvec_to_fp16_ref(uint16_t* dst, const float* src, size_t d);
+void fp16vec_to_fvec_ref(float* dst, const uint16_t* src, size_t d);
+void fvec_to_bf16_ref(uint16_t* dst, const float* src, size_t d);
+void bf16vec_to_fvec_ref(float* dst, const uint16_t* src, size_t d);
+
+/// distances between two half precision vectors, accumulated in float
+float fp16vec_L2sqr_ref(const uint16_t* x, const uint16_t* y, size_t d);
+float fp16vec_inner_product_ref(const uint16_t* x, const uint16_t* y, size_t d);
+float bf16vec_L2sqr_ref(const uint16_t* x, const uint16_t* y, size_t d);
+float bf16vec_inner_product_ref(const uint16_t* x, const uint16_t* y, size_t d);
+
+/// int8 vectors, exact int32 accumulation
+int32_t i8vec_inner_product_ref(const int8_t* x, const int8_t* y, size_t d);
+int32_t i8vec_L2sqr_ref(const int8_t* x, const int8_t* y, size_t d);
+
 void fvec_madd_ref(size_t n, const float* a, float bf, const float* b, float* c);
 
 int fvec_madd_and_argmin_ref(size_t n, const float* a, float bf, const float* b, float* c);
@@ -0,0 +1,211 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#if defined(__aarch64__)
+
+#include "simd/distances_sve.h"
+
+#include <arm_sve.h>
+
+#include <algorithm>
+#include <cstdint>
+
+#include "simd/distances_ref.h"
+
+namespace dingodb {
+
+float fvec_inner_product_sve(const float* x, const float* y, size_t d) {
+  svfloat32_t msum = svdup_n_f32(0.0f);
+  uint64_t step = svcntw();
+  for (uint64_t i = 0; i < d; i += step) {
+    svbool_t pg = svwhilelt_b32_u64(i, d);
+    msum = svmla_f32_m(pg, msum, svld1_f32(pg, x + i), svld1_f32(pg, y + i));
+  }
+  return svaddv_f32(svptrue_b32(), msum);
+}
+
+float fvec_L2sqr_sve(const float* x, const float* y, size_t d) {
+  svfloat32_t msum = svdup_n_f32(0.0f);
+  uint64_t step = svcntw();
+  for (uint64_t i = 0; i < d; i += step) {
+    svbool_t pg = svwhilelt_b32_u64(i, d);
+    svfloat32_t a_m_b = svsub_f32_x(pg, svld1_f32(pg, x + i), svld1_f32(pg, y + i));
+    msum = svmla_f32_m(pg, msum, a_m_b, a_m_b);
+  }
+  return svaddv_f32(svptrue_b32(), msum);
+}
+
+float fvec_L1_sve(const float* x, const float* y, size_t d) {
+  svfloat32_t msum = svdup_n_f32(0.0f);
+  uint64_t step = svcntw();
+  for (uint64_t i = 0; i < d; i += step) {
+    svbool_t pg = svwhilelt_b32_u64(i, d);
+    msum = svadd_f32_m(pg, msum, svabd_f32_x(pg, svld1_f32(pg, x + i), svld1_f32(pg, y + i)));
+  }
+  return svaddv_f32(svptrue_b32(), msum);
+}
+
+float fvec_Linf_sve(const float* x, const float* y, size_t d) {
+  svfloat32_t mmax = svdup_n_f32(0.0f);
+  uint64_t step = svcntw();
+  for (uint64_t i = 0; i < d; i += step) {
+    svbool_t pg = svwhilelt_b32_u64(i, d);
+    mmax = svmax_f32_m(pg, mmax, svabd_f32_x(pg, svld1_f32(pg, x + i), svld1_f32(pg, y + i)));
+  }
+  return svmaxv_f32(svptrue_b32(), mmax);
+}
+
+float fvec_norm_L2sqr_sve(const float* x, size_t d) {
+  svfloat32_t msum = svdup_n_f32(0.0f);
+  uint64_t step = svcntw();
+  for (uint64_t i = 0; i < d; i += step) {
+    svbool_t pg = svwhilelt_b32_u64(i, d);
+    svfloat32_t mx = svld1_f32(pg, x + i);
+    msum = svmla_f32_m(pg, msum, mx, mx);
+  }
+  return svaddv_f32(svptrue_b32(), msum);
+}
+
+// One shared vector s against four vectors v0..v3, see fvec_op_4x1_neon.
+template <bool kIsL2>
+static inline void fvec_op_4x1_sve(const float* v0, const float* v1, const float* v2, const float* v3,
+                                   const float* s, size_t d, float* r0, float* r1, float* r2, float* r3) {
+  svfloat32_t msum0 = svdup_n_f32(0.0f);
+  svfloat32_t msum1 = svdup_n_f32(0.0f);
+  svfloat32_t msum2 = svdup_n_f32(0.0f);
+  svfloat32_t msum3 = svdup_n_f32(0.0f);
+
+  uint64_t step = svcntw();
+  for (uint64_t k = 0; k < d; k += step) {
+    svbool_t pg = svwhilelt_b32_u64(k, d);
+    svfloat32_t ms = svld1_f32(pg, s + k);
+    svfloat32_t mv0 = svld1_f32(pg, v0 + k);
+    svfloat32_t mv1 = svld1_f32(pg, v1 + k);
+    svfloat32_t mv2 = svld1_f32(pg, v2 + k);
+    svfloat32_t mv3 = svld1_f32(pg, v3 + k);
+    if constexpr (kIsL2) {
+      mv0 = svsub_f32_x(pg, mv0, ms);
+      mv1 = svsub_f32_x(pg, mv1, ms);
+      mv2 = svsub_f32_x(pg, mv2, ms);
+      mv3 = svsub_f32_x(pg, mv3, ms);
+      msum0 = svmla_f32_m(pg, msum0, mv0, mv0);
+      msum1 = svmla_f32_m(pg, msum1, mv1, mv1);
+      msum2 = svmla_f32_m(pg, msum2, mv2, mv2);
+      msum3 = svmla_f32_m(pg, msum3, mv3, mv3);
+    } else {
+      msum0 = svmla_f32_m(pg, msum0, mv0, ms);
+      msum1 = svmla_f32_m(pg, msum1, mv1, ms);
+      msum2 = svmla_f32_m(pg, msum2, mv2, ms);
+      msum3 = svmla_f32_m(pg, msum3, mv3, ms);
+    }
+  }
+
+  svbool_t all = svptrue_b32();
+  *r0 = svaddv_f32(all, msum0);
+  *r1 = svaddv_f32(all, msum1);
+  *r2 = svaddv_f32(all, msum2);
+  *r3 = svaddv_f32(all, msum3);
+}
+
+template <bool kIsL2>
+static void fvec_op_ny_sve(float* dis, const float* x, const float* y, size_t d, size_t ny) {
+  size_t j = 0;
+  for (; j + 4 <= ny; j += 4) {
+    const float* y0 = y + j * d;
+    fvec_op_4x1_sve<kIsL2>(y0, y0 + d, y0 + 2 * d, y0 + 3 * d, x, d, dis + j, dis + j + 1, dis + j + 2,
+                           dis + j + 3);
+  }
+  for (; j < ny; j++) {
+    dis[j] = kIsL2 ? fvec_L2sqr_sve(x, y + j * d, d) : fvec_inner_product_sve(x, y + j * d, d);
+  }
+}
+
+void fvec_L2sqr_ny_sve(float* dis, const float* x, const float* y, size_t d, size_t ny) {
+  fvec_op_ny_sve<true>(dis, x, y, d, ny);
+}
+
+void fvec_inner_products_ny_sve(float* ip, const float* x, const float* y, size_t d, size_t ny) {
+  fvec_op_ny_sve<false>(ip, x, y, d, ny);
+}
+
+template <bool kIsL2>
+static void fvec_op_nx_ny_sve(float* dis, const float* x, const float* y, size_t d, size_t nx, size_t ny) {
+  size_t block_size = fvec_nx_ny_block_size(d);
+  for (size_t j0 = 0; j0 < ny; j0 += block_size) {
+    size_t j1 = std::min(ny, j0 + block_size);
+
+    size_t i = 0;
+    for (; i + 4 <= nx; i += 4) {
+      const float* x0 = x + i * d;
+      float* dis0 = dis + i * ny;
+      for (size_t j = j0; j < j1; j++) {
+        fvec_op_4x1_sve<kIsL2>(x0, x0 + d, x0 + 2 * d, x0 + 3 * d, y + j * d, d, dis0 + j, dis0 + ny + j,
+                               dis0 + 2 * ny + j, dis0 + 3 * ny + j);
+      }
+    }
+
+    for (; i < nx; i++) {
+      const float* xi = x + i * d;
+      for (size_t j = j0; j < j1; j++) {
+        dis[i * ny + j] = kIsL2 ? fvec_L2sqr_sve(xi, y + j * d, d) : fvec_inner_product_sve(xi, y + j * d, d);
+      }
+    }
+  }
+}
+
+void fvec_L2sqr_nx_ny_sve(float* dis, const float* x, const float* y, size_t d, size_t nx, size_t ny) {
+  fvec_op_nx_ny_sve<true>(dis, x, y, d, nx, ny);
+}
+
+void fvec_inner_products_nx_ny_sve(float* ip, const float* x, const float* y, size_t d, size_t nx, size_t ny) {
+  fvec_op_nx_ny_sve<false>(ip, x, y, d, nx, ny);
+}
+
+void fvec_madd_sve(size_t n, const float* a, float bf, const float* b, float* c) {
+  svfloat32_t mbf = svdup_n_f32(bf);
+  uint64_t step = svcntw();
+  for (uint64_t i = 0; i < n; i += step) {
+    svbool_t pg = svwhilelt_b32_u64(i, n);
+    svst1_f32(pg, c + i, svmla_f32_x(pg, svld1_f32(pg, a + i), mbf, svld1_f32(pg, b + i)));
+  }
+}
+
+int fvec_madd_and_argmin_sve(size_t n, const float* a, float bf, const float* b, float* c) {
+  svbool_t all = svptrue_b32();
+  svfloat32_t mbf = svdup_n_f32(bf);
+  svfloat32_t vmins = svdup_n_f32(1e20);
+  svint32_t imins = svdup_n_s32(-1);
+  svint32_t idx = svindex_s32(0, 1);
+
+  uint64_t step = svcntw();
+  for (uint64_t i = 0; i < n; i += step) {
+    svbool_t pg = svwhilelt_b32_u64(i, n);
+    svfloat32_t vc = svmla_f32_x(pg, svld1_f32(pg, a + i), mbf, svld1_f32(pg, b + i));
+    svst1_f32(pg, c + i, vc);
+    // strict less keeps the first index of every lane
+    svbool_t less = svcmplt_f32(pg, vc, vmins);
+    vmins = svsel_f32(less, vc, vmins);
+    imins = svsel_s32(less, idx, imins);
+    idx = svadd_n_s32_x(all, idx, static_cast<int32_t>(step));
+  }
+
+  // the smallest value, ties resolved to the smallest index as the scalar version
+  float vmin = svminv_f32(all, vmins);
+  svbool_t found = svand_b_z(all, svcmpeq_n_f32(all, vmins, vmin), svcmpge_n_s32(all, imins, 0));
+  return svptest_any(all, found) ? svminv_s32(found, imins) : -1;
+}
+
+}  // namespace dingodb
+
+#endif  // __aarch64__
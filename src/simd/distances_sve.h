@@ -0,0 +1,53 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_SIMD_DISTANCES_SVE_H_
+#define DINGODB_SIMD_DISTANCES_SVE_H_
+
+#include <cstddef>
+#include <cstdint>
+
+namespace dingodb {
+
+// Vector length agnostic float kernels, the tail is handled by the while predicate instead of a scalar loop.
+// The half precision and int8 kernels stay on neon, they are bound by the widening instructions.
+
+/// Squared L2 distance between two vectors
+float fvec_L2sqr_sve(const float* x, const float* y, size_t d);
+
+/// inner product
+float fvec_inner_product_sve(const float* x, const float* y, size_t d);
+
+/// L1 distance
+float fvec_L1_sve(const float* x, const float* y, size_t d);
+
+/// infinity distance
+float fvec_Linf_sve(const float* x, const float* y, size_t d);
+
+float fvec_norm_L2sqr_sve(const float* x, size_t d);
+
+void fvec_L2sqr_ny_sve(float* dis, const float* x, const float* y, size_t d, size_t ny);
+void fvec_inner_products_ny_sve(float* ip, const float* x, const float* y, size_t d, size_t ny);
+
+/// nx x ny distance matrix, four x vectors share every y load
+void fvec_L2sqr_nx_ny_sve(float* dis, const float* x, const float* y, size_t d, size_t nx, size_t ny);
+void fvec_inner_products_nx_ny_sve(float* ip, const float* x, const float* y, size_t d, size_t nx, size_t ny);
+
+void fvec_madd_sve(size_t n, const float* a, float bf, const float* b, float* c);
+
+int fvec_madd_and_argmin_sve(size_t n, const float* a, float bf, const float* b, float* c);
+
+}  // namespace dingodb
+
+#endif  // DINGODB_SIMD_DISTANCES_SVE_H_ //NOLINT
@@ -16,6 +16,7 @@
 
 #include "simd/hook.h"
 
+#include <algorithm>
 #include <iostream>
 #include <mutex>
 
@@ -28,6 +29,13 @@
 #include "simd/instruction_set.h"
 #endif
 
+#if defined(__aarch64__)
+#include <sys/auxv.h>
+
+#include "simd/distances_neon.h"
+#include "simd/distances_sve.h"
+#endif
+
 #include "simd/distances_ref.h"
 // #include "knowhere/log.h"
 namespace dingodb {
@@ -38,6 +46,11 @@ bool use_avx2 = true;
 bool use_sse4_2 = true;
 #endif
 
+#if defined(__aarch64__)
+bool use_sve = true;
+bool use_neon = true;
+#endif
+
 decltype(fvec_inner_product) fvec_inner_product = fvec_inner_product_ref;
 decltype(fvec_L2sqr) fvec_L2sqr = fvec_L2sqr_ref;
 decltype(fvec_L1) fvec_L1 = fvec_L1_ref;
@@ -45,6 +58,18 @@ decltype(fvec_Linf) fvec_Linf = fvec_Linf_ref;
 decltype(fvec_norm_L2sqr) fvec_norm_L2sqr = fvec_norm_L2sqr_ref;
 decltype(fvec_L2sqr_ny) fvec_L2sqr_ny = fvec_L2sqr_ny_ref;
 decltype(fvec_inner_products_ny) fvec_inner_products_ny = fvec_inner_products_ny_ref;
+decltype(fvec_L2sqr_nx_ny) fvec_L2sqr_nx_ny = fvec_L2sqr_nx_ny_ref;
+decltype(fvec_inner_products_nx_ny) fvec_inner_products_nx_ny = fvec_inner_products_nx_ny_ref;
+decltype(fp16vec_L2sqr) fp16vec_L2sqr = fp16vec_L2sqr_ref;
+decltype(fp16vec_inner_product) fp16vec_inner_product = fp16vec_inner_product_ref;
+decltype(bf16vec_L2sqr) bf16vec_L2sqr = bf16vec_L2sqr_ref;
+decltype(bf16vec_inner_product) bf16vec_inner_product = bf16vec_inner_product_ref;
+decltype(fvec_to_fp16) fvec_to_fp16 = fvec_to_fp16_ref;
+decltype(fp16vec_to_fvec) fp16vec_to_fvec = fp16vec_to_fvec_ref;
+decltype(fvec_to_bf16) fvec_to_bf16 = fvec_to_bf16_ref;
+decltype(bf16vec_to_fvec) bf16vec_to_fvec = bf16vec_to_fvec_ref;
+decltype(i8vec_inner_product) i8vec_inner_product = i8vec_inner_product_ref;
+decltype(i8vec_L2sqr) i8vec_L2sqr = i8vec_L2sqr_ref;
 decltype(fvec_madd) fvec_madd = fvec_madd_ref;
 decltype(fvec_madd_and_argmin) fvec_madd_and_argmin = fvec_madd_and_argmin_ref;
 
@@ -63,6 +88,30 @@ bool cpu_support_sse4_2() {
   InstructionSet& instruction_set_inst = InstructionSet::GetInstance();
   return (instruction_set_inst.SSE42());
 }
+
+bool cpu_support_f16c() {
+  InstructionSet& instruction_set_inst = InstructionSet::GetInstance();
+  return (instruction_set_inst.F16C());
+}
+#endif
+
+#if defined(__aarch64__)
+bool cpu_support_sve() {
+#if defined(HWCAP_SVE)
+  return (getauxval(AT_HWCAP) & HWCAP_SVE) != 0;
+#else
+  return false;
+#endif
+}
+
+bool cpu_support_neon() {
+#if defined(HWCAP_ASIMD)
+  return (getauxval(AT_HWCAP) & HWCAP_ASIMD) != 0;
+#else
+  // advanced simd is mandatory in armv8-a
+  return true;
+#endif
+}
 #endif
 
 void fvec_hook(std::string& simd_type) {
@@ -78,6 +127,18 @@ void fvec_hook(std::string& simd_type) {
     fvec_norm_L2sqr = fvec_norm_L2sqr_sse;
     fvec_L2sqr_ny = fvec_L2sqr_ny_sse;
     fvec_inner_products_ny = fvec_inner_products_ny_sse;
+    fvec_L2sqr_nx_ny = fvec_L2sqr_nx_ny_avx512;
+    fvec_inner_products_nx_ny = fvec_inner_products_nx_ny_avx512;
+    fp16vec_L2sqr = fp16vec_L2sqr_avx512;
+    fp16vec_inner_product = fp16vec_inner_product_avx512;
+    bf16vec_L2sqr = bf16vec_L2sqr_avx512;
+    bf16vec_inner_product = bf16vec_inner_product_avx512;
+    fvec_to_fp16 = fvec_to_fp16_avx512;
+    fp16vec_to_fvec = fp16vec_to_fvec_avx512;
+    fvec_to_bf16 = fvec_to_bf16_ref;
+    bf16vec_to_fvec = bf16vec_to_fvec_ref;
+    i8vec_inner_product = i8vec_inner_product_avx512;
+    i8vec_L2sqr = i8vec_L2sqr_avx512;
     fvec_madd = fvec_madd_sse;
     fvec_madd_and_argmin = fvec_madd_and_argmin_sse;
 
@@ -91,6 +152,25 @@ void fvec_hook(std::string& simd_type) {
     fvec_norm_L2sqr = fvec_norm_L2sqr_sse;
     fvec_L2sqr_ny = fvec_L2sqr_ny_sse;
     fvec_inner_products_ny = fvec_inner_products_ny_sse;
+    fvec_L2sqr_nx_ny = fvec_L2sqr_nx_ny_avx;
+    fvec_inner_products_nx_ny = fvec_inner_products_nx_ny_avx;
+    if (cpu_support_f16c()) {
+      fp16vec_L2sqr = fp16vec_L2sqr_avx;
+      fp16vec_inner_product = fp16vec_inner_product_avx;
+      fvec_to_fp16 = fvec_to_fp16_avx;
+      fp16vec_to_fvec = fp16vec_to_fvec_avx;
+    } else {
+      fp16vec_L2sqr = fp16vec_L2sqr_ref;
+      fp16vec_inner_product = fp16vec_inner_product_ref;
+      fvec_to_fp16 = fvec_to_fp16_ref;
+      fp16vec_to_fvec = fp16vec_to_fvec_ref;
+    }
+    bf16vec_L2sqr = bf16vec_L2sqr_avx;
+    bf16vec_inner_product = bf16vec_inner_product_avx;
+    fvec_to_bf16 = fvec_to_bf16_ref;
+    bf16vec_to_fvec = bf16vec_to_fvec_ref;
+    i8vec_inner_product = i8vec_inner_product_avx;
+    i8vec_L2sqr = i8vec_L2sqr_avx;
     fvec_madd = fvec_madd_sse;
     fvec_madd_and_argmin = fvec_madd_and_argmin_sse;
 
@@ -104,6 +184,18 @@ void fvec_hook(std::string& simd_type) {
     fvec_norm_L2sqr = fvec_norm_L2sqr_sse;
     fvec_L2sqr_ny = fvec_L2sqr_ny_sse;
     fvec_inner_products_ny = fvec_inner_products_ny_sse;
+    fvec_L2sqr_nx_ny = fvec_L2sqr_nx_ny_ref;
+    fvec_inner_products_nx_ny = fvec_inner_products_nx_ny_ref;
+    fp16vec_L2sqr = fp16vec_L2sqr_ref;
+    fp16vec_inner_product = fp16vec_inner_product_ref;
+    bf16vec_L2sqr = bf16vec_L2sqr_ref;
+    bf16vec_inner_product = bf16vec_inner_product_ref;
+    fvec_to_fp16 = fvec_to_fp16_ref;
+    fp16vec_to_fvec = fp16vec_to_fvec_ref;
+    fvec_to_bf16 = fvec_to_bf16_ref;
+    bf16vec_to_fvec = bf16vec_to_fvec_ref;
+    i8vec_inner_product = i8vec_inner_product_ref;
+    i8vec_L2sqr = i8vec_L2sqr_ref;
     fvec_madd = fvec_madd_sse;
     fvec_madd_and_argmin = fvec_madd_and_argmin_sse;
 
@@ -117,6 +209,88 @@ void fvec_hook(std::string& simd_type) {
     fvec_norm_L2sqr = fvec_norm_L2sqr_ref;
     fvec_L2sqr_ny = fvec_L2sqr_ny_ref;
     fvec_inner_products_ny = fvec_inner_products_ny_ref;
+    fvec_L2sqr_nx_ny = fvec_L2sqr_nx_ny_ref;
+    fvec_inner_products_nx_ny = fvec_inner_products_nx_ny_ref;
+    fp16vec_L2sqr = fp16vec_L2sqr_ref;
+    fp16vec_inner_product = fp16vec_inner_product_ref;
+    bf16vec_L2sqr = bf16vec_L2sqr_ref;
+    bf16vec_inner_product = bf16vec_inner_product_ref;
+    fvec_to_fp16 = fvec_to_fp16_ref;
+    fp16vec_to_fvec = fp16vec_to_fvec_ref;
+    fvec_to_bf16 = fvec_to_bf16_ref;
+    bf16vec_to_fvec = bf16vec_to_fvec_ref;
+    i8vec_inner_product = i8vec_inner_product_ref;
+    i8vec_L2sqr = i8vec_L2sqr_ref;
+    fvec_madd = fvec_madd_ref;
+    fvec_madd_and_argmin = fvec_madd_and_argmin_ref;
+
+    simd_type = "GENERIC";
+  }
+#elif defined(__aarch64__)
+  if (use_neon && cpu_support_neon()) {
+    // sve replaces the float kernels only, the other kernels have no sve version
+    if (use_sve && cpu_support_sve()) {
+      fvec_inner_product = fvec_inner_product_sve;
+      fvec_L2sqr = fvec_L2sqr_sve;
+      fvec_L1 = fvec_L1_sve;
+      fvec_Linf = fvec_Linf_sve;
+
+      fvec_norm_L2sqr = fvec_norm_L2sqr_sve;
+      fvec_L2sqr_ny = fvec_L2sqr_ny_sve;
+      fvec_inner_products_ny = fvec_inner_products_ny_sve;
+      fvec_L2sqr_nx_ny = fvec_L2sqr_nx_ny_sve;
+      fvec_inner_products_nx_ny = fvec_inner_products_nx_ny_sve;
+      fvec_madd = fvec_madd_sve;
+      fvec_madd_and_argmin = fvec_madd_and_argmin_sve;
+
+      simd_type = "SVE";
+    } else {
+      fvec_inner_product = fvec_inner_product_neon;
+      fvec_L2sqr = fvec_L2sqr_neon;
+      fvec_L1 = fvec_L1_neon;
+      fvec_Linf = fvec_Linf_neon;
+
+      fvec_norm_L2sqr = fvec_norm_L2sqr_neon;
+      fvec_L2sqr_ny = fvec_L2sqr_ny_neon;
+      fvec_inner_products_ny = fvec_inner_products_ny_neon;
+      fvec_L2sqr_nx_ny = fvec_L2sqr_nx_ny_neon;
+      fvec_inner_products_nx_ny = fvec_inner_products_nx_ny_neon;
+      fvec_madd = fvec_madd_neon;
+      fvec_madd_and_argmin = fvec_madd_and_argmin_neon;
+
+      simd_type = "NEON";
+    }
+    fp16vec_L2sqr = fp16vec_L2sqr_neon;
+    fp16vec_inner_product = fp16vec_inner_product_neon;
+    bf16vec_L2sqr = bf16vec_L2sqr_neon;
+    bf16vec_inner_product = bf16vec_inner_product_neon;
+    fvec_to_fp16 = fvec_to_fp16_neon;
+    fp16vec_to_fvec = fp16vec_to_fvec_neon;
+    fvec_to_bf16 = fvec_to_bf16_ref;
+    bf16vec_to_fvec = bf16vec_to_fvec_ref;
+    i8vec_inner_product = i8vec_inner_product_neon;
+    i8vec_L2sqr = i8vec_L2sqr_neon;
+  } else {
+    fvec_inner_product = fvec_inner_product_ref;
+    fvec_L2sqr = fvec_L2sqr_ref;
+    fvec_L1 = fvec_L1_ref;
+    fvec_Linf = fvec_Linf_ref;
+
+    fvec_norm_L2sqr = fvec_norm_L2sqr_ref;
+    fvec_L2sqr_ny = fvec_L2sqr_ny_ref;
+    fvec_inner_products_ny = fvec_inner_products_ny_ref;
+    fvec_L2sqr_nx_ny = fvec_L2sqr_nx_ny_ref;
+    fvec_inner_products_nx_ny = fvec_inner_products_nx_ny_ref;
+    fp16vec_L2sqr = fp16vec_L2sqr_ref;
+    fp16vec_inner_product = fp16vec_inner_product_ref;
+    bf16vec_L2sqr = bf16vec_L2sqr_ref;
+    bf16vec_inner_product = bf16vec_inner_product_ref;
+    fvec_to_fp16 = fvec_to_fp16_ref;
+    fp16vec_to_fvec = fp16vec_to_fvec_ref;
+    fvec_to_bf16 = fvec_to_bf16_ref;
+    bf16vec_to_fvec = bf16vec_to_fvec_ref;
+    i8vec_inner_product = i8vec_inner_product_ref;
+    i8vec_L2sqr = i8vec_L2sqr_ref;
     fvec_madd = fvec_madd_ref;
     fvec_madd_and_argmin = fvec_madd_and_argmin_ref;
 
@@ -136,9 +310,29 @@ void fvec_hook_info(std::string& simd_type) {
   } else {
     simd_type = "GENERIC";
   }
+#elif defined(__aarch64__)
+  if (use_neon && cpu_support_neon()) {
+    simd_type = (use_sve && cpu_support_sve()) ? "SVE" : "NEON";
+  } else {
+    simd_type = "GENERIC";
+  }
 #endif
 }
 
+// 64 floats, 4 cache lines, long enough to keep the simd kernel busy between checks
+static constexpr size_t kEarlyAbortChunkSize = 64;
+
+float fvec_L2sqr_early_abort(const float* x, const float* y, size_t d, float threshold) {
+  float sum = 0.0F;
+  for (size_t offset = 0; offset < d; offset += kEarlyAbortChunkSize) {
+    sum += fvec_L2sqr(x + offset, y + offset, std::min(kEarlyAbortChunkSize, d - offset));
+    if (sum > threshold) {
+      return sum;
+    }
+  }
+  return sum;
+}
+
 static int init_hook_ = []() {
   std::string simd_type;
   fvec_hook(simd_type);
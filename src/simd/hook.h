@@ -17,6 +17,7 @@
 #ifndef DINGODB_SIMD_HOOK_H_
 #define DINGODB_SIMD_HOOK_H_
 
+#include <cstdint>
 #include <string>
 namespace dingodb {
 
@@ -27,6 +28,24 @@ extern float (*fvec_Linf)(const float*, const float*, size_t);
 extern float (*fvec_norm_L2sqr)(const float*, size_t);
 extern void (*fvec_L2sqr_ny)(float*, const float*, const float*, size_t, size_t);
 extern void (*fvec_inner_products_ny)(float*, const float*, const float*, size_t, size_t);
+// nx x ny blocked variants, result matrix is row major: dis[i * ny + j] = distance(x[i], y[j])
+extern void (*fvec_L2sqr_nx_ny)(float*, const float*, const float*, size_t, size_t, size_t);
+extern void (*fvec_inner_products_nx_ny)(float*, const float*, const float*, size_t, size_t, size_t);
+// half precision (fp16/bf16) vectors are stored as raw uint16_t and accumulated in float
+extern float (*fp16vec_L2sqr)(const uint16_t*, const uint16_t*, size_t);
+extern float (*fp16vec_inner_product)(const uint16_t*, const uint16_t*, size_t);
+extern float (*bf16vec_L2sqr)(const uint16_t*, const uint16_t*, size_t);
+extern float (*bf16vec_inner_product)(const uint16_t*, const uint16_t*, size_t);
+extern void (*fvec_to_fp16)(uint16_t*, const float*, size_t);
+extern void (*fp16vec_to_fvec)(float*, const uint16_t*, size_t);
+extern void (*fvec_to_bf16)(uint16_t*, const float*, size_t);
+extern void (*bf16vec_to_fvec)(float*, const uint16_t*, size_t);
+// int8 vectors, used by scalar quantized indexes
+extern int32_t (*i8vec_inner_product)(const int8_t*, const int8_t*, size_t);
+extern int32_t (*i8vec_L2sqr)(const int8_t*, const int8_t*, size_t);
+// squared L2 accumulated chunk by chunk with the hooked fvec_L2sqr, return as soon as the partial sum exceeds
+// threshold, a result greater than threshold is only a lower bound of the distance
+float fvec_L2sqr_early_abort(const float* x, const float* y, size_t d, float threshold);
 extern void (*fvec_madd)(size_t, const float*, float, const float*, float*);
 extern int (*fvec_madd_and_argmin)(size_t, const float*, float, const float*, float*);
 
@@ -36,10 +55,21 @@ extern bool use_avx2;
 extern bool use_sse4_2;
 #endif
 
+#if defined(__aarch64__)
+extern bool use_sve;
+extern bool use_neon;
+#endif
+
 #if defined(__x86_64__)
 bool cpu_support_avx512();
 bool cpu_support_avx2();
 bool cpu_support_sse4_2();
+bool cpu_support_f16c();
+#endif
+
+#if defined(__aarch64__)
+bool cpu_support_sve();
+bool cpu_support_neon();
 #endif
 
 void fvec_hook(std::string& simd_type);
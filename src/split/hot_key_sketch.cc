@@ -0,0 +1,93 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "split/hot_key_sketch.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace dingodb {
+
+HotKeySketch::HotKeySketch(uint32_t capacity) : capacity_(std::max(capacity, static_cast<uint32_t>(1))) {
+  items_.reserve(capacity_);
+}
+
+void HotKeySketch::Add(std::string_view key, int64_t weight) {
+  total_count_ += weight;
+
+  std::string key_str(key);
+  auto it = index_.find(key_str);
+  if (it != index_.end()) {
+    items_[it->second].count += weight;
+    return;
+  }
+
+  if (items_.size() < capacity_) {
+    index_.emplace(key_str, items_.size());
+    items_.push_back(Item{std::move(key_str), weight, 0});
+    return;
+  }
+
+  // replace the minimum one, capacity is small so linear search is fine.
+  size_t min_pos = 0;
+  for (size_t i = 1; i < items_.size(); ++i) {
+    if (items_[i].count < items_[min_pos].count) {
+      min_pos = i;
+    }
+  }
+
+  auto& item = items_[min_pos];
+  index_.erase(item.key);
+  index_.emplace(key_str, min_pos);
+  item.error = item.count;
+  item.count += weight;
+  item.key = std::move(key_str);
+}
+
+std::vector<HotKeySketch::Item> HotKeySketch::TopK(uint32_t k) const {
+  std::vector<Item> items = items_;
+  size_t top_num = std::min(static_cast<size_t>(k), items.size());
+  std::partial_sort(items.begin(), items.begin() + top_num, items.end(),
+                    [](const Item& a, const Item& b) { return a.count > b.count; });
+  items.resize(top_num);
+
+  return items;
+}
+
+void HotKeySketch::Decay() {
+  std::vector<Item> items;
+  items.reserve(capacity_);
+  index_.clear();
+  total_count_ = 0;
+  for (auto& item : items_) {
+    item.count /= 2;
+    item.error /= 2;
+    if (item.count == 0) {
+      continue;
+    }
+
+    total_count_ += item.count;
+    index_.emplace(item.key, items.size());
+    items.push_back(std::move(item));
+  }
+
+  items_.swap(items);
+}
+
+}  // namespace dingodb
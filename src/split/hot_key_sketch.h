@@ -0,0 +1,63 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef DINGODB_SPLIT_HOT_KEY_SKETCH_H_
+#define DINGODB_SPLIT_HOT_KEY_SKETCH_H_
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace dingodb {
+
+// Space saving sketch, find the heavy hitter keys of a key stream with bounded memory.
+// When the sketch is full, the key with minimum count is replaced by the new key, which inherits the count as error,
+// so every key whose frequency is above 1/capacity is kept, and its count is overestimated by at most error.
+// Not thread safe.
+class HotKeySketch {
+ public:
+  struct Item {
+    std::string key;
+    int64_t count{0};
+    int64_t error{0};
+  };
+
+  explicit HotKeySketch(uint32_t capacity);
+  ~HotKeySketch() = default;
+
+  void Add(std::string_view key, int64_t weight = 1);
+
+  // The top k items ordered by count desc.
+  std::vector<Item> TopK(uint32_t k) const;
+
+  // Halve all counts and drop the zero ones, so the cold keys fade out.
+  void Decay();
+
+  size_t Size() const { return items_.size(); }
+  int64_t TotalCount() const { return total_count_; }
+
+ private:
+  uint32_t capacity_;
+  int64_t total_count_{0};
+  std::vector<Item> items_;
+  // key -> position of items_
+  std::unordered_map<std::string, size_t> index_;
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_SPLIT_HOT_KEY_SKETCH_H_
@@ -0,0 +1,120 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "split/region_load_stats.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "butil/fast_rand.h"
+#include "butil/scoped_lock.h"
+#include "bthread/mutex.h"
+#include "common/helper.h"
+#include "gflags/gflags.h"
+
+namespace dingodb {
+
+DEFINE_bool(enable_region_load_split, false, "enable split hot region by request load");
+DEFINE_int32(region_load_sample_interval, 16, "region load sample key every interval requests");
+DEFINE_int32(region_load_sample_key_num, 512, "region load max sample key number of one window");
+
+DEFINE_bool(enable_region_hot_key_stats, false, "enable count hot keys of region from sampled keys");
+DEFINE_int32(region_hot_key_sketch_capacity, 64, "region hot key sketch capacity, fixed at region creation");
+DEFINE_int32(region_hot_key_prefix_len, 8, "region hot key prefix length, 0 is disable prefix stats");
+
+RegionLoadStats::RegionLoadStats()
+    : hot_keys_(std::max(FLAGS_region_hot_key_sketch_capacity, 1)),
+      hot_prefixes_(std::max(FLAGS_region_hot_key_sketch_capacity, 1)) {
+  bthread_mutex_init(&mutex_, nullptr);
+  start_time_ms_ = Helper::TimestampMs();
+}
+
+RegionLoadStats::~RegionLoadStats() { bthread_mutex_destroy(&mutex_); }
+
+bool RegionLoadStats::IsEnabled() { return FLAGS_enable_region_load_split; }
+
+bool RegionLoadStats::IsHotKeyEnabled() { return FLAGS_enable_region_hot_key_stats; }
+
+void RegionLoadStats::AddRequest(int64_t elapsed_time_ns) {
+  request_count_.fetch_add(1, std::memory_order_relaxed);
+  elapsed_time_ns_.fetch_add(elapsed_time_ns, std::memory_order_relaxed);
+}
+
+void RegionLoadStats::SampleKeys(const std::vector<std::string_view>& keys) {
+  if (keys.empty()) {
+    return;
+  }
+  int32_t interval = std::max(FLAGS_region_load_sample_interval, 1);
+  if (sample_seq_.fetch_add(1, std::memory_order_relaxed) % interval != 0) {
+    return;
+  }
+
+  const auto& key = keys.size() == 1 ? keys[0] : keys[butil::fast_rand_less_than(keys.size())];
+  uint32_t max_sample_num = std::max(FLAGS_region_load_sample_key_num, 1);
+
+  BAIDU_SCOPED_LOCK(mutex_);
+  if (IsEnabled()) {
+    ++sample_count_;
+    if (sample_keys_.size() < max_sample_num) {
+      sample_keys_.emplace_back(key);
+    } else {
+      // reservoir sampling, every sampled request has the same probability to be kept.
+      uint64_t pos = butil::fast_rand_less_than(sample_count_);
+      if (pos < max_sample_num) {
+        sample_keys_[pos].assign(key.data(), key.size());
+      }
+    }
+  }
+
+  if (IsHotKeyEnabled()) {
+    hot_keys_.Add(key);
+    int32_t prefix_len = FLAGS_region_hot_key_prefix_len;
+    if (prefix_len > 0) {
+      hot_prefixes_.Add(key.substr(0, prefix_len));
+    }
+  }
+}
+
+RegionLoadStats::Window RegionLoadStats::TakeWindow() {
+  Window window;
+  window.request_count = request_count_.exchange(0, std::memory_order_relaxed);
+  window.elapsed_time_ns = elapsed_time_ns_.exchange(0, std::memory_order_relaxed);
+
+  int64_t now_ms = Helper::TimestampMs();
+  BAIDU_SCOPED_LOCK(mutex_);
+  window.duration_ms = now_ms - start_time_ms_;
+  window.sample_keys.swap(sample_keys_);
+  sample_count_ = 0;
+  start_time_ms_ = now_ms;
+
+  return window;
+}
+
+RegionLoadStats::HotKeys RegionLoadStats::TakeHotKeys(uint32_t k) {
+  HotKeys hot_keys;
+
+  BAIDU_SCOPED_LOCK(mutex_);
+  hot_keys.keys = hot_keys_.TopK(k);
+  hot_keys.prefixes = hot_prefixes_.TopK(k);
+  hot_keys_.Decay();
+  hot_prefixes_.Decay();
+
+  return hot_keys;
+}
+
+}  // namespace dingodb
@@ -0,0 +1,90 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_SPLIT_REGION_LOAD_STATS_H_
+#define DINGODB_SPLIT_REGION_LOAD_STATS_H_
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "bthread/types.h"
+#include "split/hot_key_sketch.h"
+
+namespace dingodb {
+
+// Request load of one region within a sampling window, used by load based split.
+// Every request adds its count and elapsed time, keys are sampled every region_load_sample_interval requests
+// into a bounded reservoir, so the sampled keys reflect the access frequency of the key space.
+// The sampled keys and their prefixes are also counted by space saving sketches to find the hot keys of the region.
+class RegionLoadStats {
+ public:
+  struct HotKeys {
+    std::vector<HotKeySketch::Item> keys;
+    std::vector<HotKeySketch::Item> prefixes;
+  };
+
+  struct Window {
+    int64_t request_count{0};
+    int64_t elapsed_time_ns{0};
+    int64_t duration_ms{0};
+    std::vector<std::string> sample_keys;
+
+    int64_t Qps() const { return duration_ms > 0 ? request_count * 1000 / duration_ms : 0; }
+    // Elapsed time of requests per wall time, approximate the cpu cores used by the region.
+    double BusyRatio() const {
+      return duration_ms > 0 ? static_cast<double>(elapsed_time_ns) / (duration_ms * 1000000) : 0;
+    }
+  };
+
+  RegionLoadStats();
+  ~RegionLoadStats();
+
+  RegionLoadStats(const RegionLoadStats&) = delete;
+  void operator=(const RegionLoadStats&) = delete;
+
+  static bool IsEnabled();
+  static bool IsHotKeyEnabled();
+
+  void AddRequest(int64_t elapsed_time_ns);
+  void SampleKeys(const std::vector<std::string_view>& keys);
+
+  // Take the current window and start a new one.
+  Window TakeWindow();
+
+  // Get the top k hot keys and prefixes, then decay the sketches.
+  HotKeys TakeHotKeys(uint32_t k);
+
+ private:
+  std::atomic<int64_t> request_count_{0};
+  std::atomic<int64_t> elapsed_time_ns_{0};
+  std::atomic<int64_t> sample_seq_{0};
+
+  // Protect sample_keys_/sample_count_/start_time_ms_.
+  bthread_mutex_t mutex_;
+  std::vector<std::string> sample_keys_;
+  // Sampled request count of the window, for reservoir sampling.
+  int64_t sample_count_{0};
+  int64_t start_time_ms_{0};
+
+  // Protected by mutex_.
+  HotKeySketch hot_keys_;
+  HotKeySketch hot_prefixes_;
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_SPLIT_REGION_LOAD_STATS_H_
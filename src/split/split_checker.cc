@@ -16,11 +16,14 @@
 
 #include <sys/stat.h>
 
+#include <algorithm>
 #include <cstdint>
 #include <memory>
+#include <numeric>
 #include <queue>
 #include <string>
 #include <string_view>
+#include <utility>
 #include <vector>
 
 #include "common/constant.h"
@@ -38,6 +41,23 @@
 
 namespace dingodb {
 DECLARE_bool(enable_region_split_and_merge_for_lite);
+DECLARE_bool(enable_region_load_split);
+
+DEFINE_bool(split_check_use_approximate_size, true,
+            "split check estimate split key by sst and memtable approximate size, fallback to scan region when can't "
+            "estimate, the key count is left to the metrics collector");
+DEFINE_int32(split_check_approximate_fanout, 16, "split check approximate size pieces of each round");
+DEFINE_int32(split_check_approximate_max_round, 16, "split check approximate size max descend round");
+DEFINE_int64(split_check_approximate_resolution_size, 1 * 1024 * 1024,
+             "split check approximate size stop descending when piece smaller than this size");
+
+DEFINE_int64(region_load_split_qps, 20000, "region load split when region request qps exceed");
+DEFINE_double(region_load_split_busy_ratio, 2.0,
+              "region load split when region request elapsed time per wall time exceed, about cpu cores");
+DEFINE_int32(region_load_split_min_sample_keys, 64, "region load split min sample key number");
+DEFINE_double(region_load_split_max_hot_key_ratio, 0.8,
+              "region load split give up when the larger side still take more than this ratio of samples");
+DEFINE_int64(region_load_split_cooldown_s, 600, "region load split cooldown time after the region or parent split");
 
 MergedIterator::MergedIterator(RawEnginePtr raw_engine, const std::vector<std::string>& cf_names,
                                const std::string& end_key)
@@ -47,6 +67,7 @@ MergedIterator::MergedIterator(RawEnginePtr raw_engine, const std::vector<std::s
   for (const auto& cf_name : cf_names) {
     IteratorOptions options;
     options.upper_bound = end_key;
+    options.long_scan = true;
     auto iter = raw_engine->Reader()->NewIterator(cf_name, snapshot, options);
     iters_.push_back(iter);
   }
@@ -94,9 +115,120 @@ void MergedIterator::Next(IteratorPtr iter, int iter_pos) {
   }
 }
 
+static int64_t SumApproximateSize(RawEnginePtr raw_engine, const std::vector<std::string>& cf_names,
+                                  std::vector<pb::common::Range>& ranges, std::vector<int64_t>& sizes) {
+  sizes.assign(ranges.size(), 0);
+  for (const auto& cf_name : cf_names) {
+    auto cf_sizes = raw_engine->GetApproximateSizes(cf_name, ranges);
+    for (size_t i = 0; i < cf_sizes.size() && i < sizes.size(); ++i) {
+      sizes[i] += cf_sizes[i];
+    }
+  }
+
+  return std::accumulate(sizes.begin(), sizes.end(), static_cast<int64_t>(0));
+}
+
+// Estimate split key by sst approximate size instead of scanning the whole region.
+// Cut the range into even pieces of key space, descend into the piece where the target size offset falls,
+// until the piece is smaller than resolution_size, then seek the first real key of the piece.
+// total_size is the approximate size of the range, return empty when can't estimate.
+static std::string ApproximateSplitKey(RawEnginePtr raw_engine, const pb::common::Range& range,
+                                       const std::vector<std::string>& cf_names, int64_t total_size,
+                                       int64_t target_size, int64_t resolution_size) {
+  if (total_size <= 0 || target_size <= 0 || target_size >= total_size) {
+    return "";
+  }
+
+  std::vector<pb::common::Range> ranges;
+  std::vector<int64_t> sizes;
+
+  std::string start_key = range.start_key();
+  std::string end_key = range.end_key();
+  int64_t piece_size = total_size;
+  int round = 0;
+  for (; round < FLAGS_split_check_approximate_max_round && piece_size > resolution_size; ++round) {
+    auto split_keys = Helper::GenEvenSplitKeys(start_key, end_key, FLAGS_split_check_approximate_fanout);
+    if (split_keys.empty()) {
+      break;
+    }
+    split_keys.insert(split_keys.begin(), start_key);
+    split_keys.push_back(end_key);
+
+    ranges.clear();
+    for (size_t i = 0; i + 1 < split_keys.size(); ++i) {
+      pb::common::Range piece;
+      piece.set_start_key(split_keys[i]);
+      piece.set_end_key(split_keys[i + 1]);
+      ranges.push_back(std::move(piece));
+    }
+    int64_t pieces_size = SumApproximateSize(raw_engine, cf_names, ranges, sizes);
+    if (pieces_size <= 0) {
+      break;
+    }
+
+    // scale to the pieces sum, approximate size of sub ranges not add up exactly.
+    target_size = static_cast<int64_t>(static_cast<double>(target_size) * pieces_size / piece_size);
+    size_t pos = 0;
+    for (; pos + 1 < sizes.size() && target_size >= sizes[pos]; ++pos) {
+      target_size -= sizes[pos];
+    }
+    start_key = split_keys[pos];
+    end_key = split_keys[pos + 1];
+    piece_size = std::max(sizes[pos], static_cast<int64_t>(1));
+  }
+  if (round == 0) {
+    return "";
+  }
+
+  // Seek real key, avoid split in the middle of an encoded key.
+  MergedIterator iter(raw_engine, cf_names, range.end_key());
+  iter.Seek(start_key);
+  if (!iter.Valid() || iter.Key() <= range.start_key()) {
+    return "";
+  }
+
+  return std::string(iter.Key());
+}
+
+static int64_t ApproximateSize(RawEnginePtr raw_engine, const pb::common::Range& range,
+                               const std::vector<std::string>& cf_names) {
+  std::vector<pb::common::Range> ranges = {range};
+  std::vector<int64_t> sizes;
+  return SumApproximateSize(raw_engine, cf_names, ranges, sizes);
+}
+
+static std::string ToUserSplitKey(store::RegionPtr region, const std::string& split_key) {
+  if (!split_key.empty() &&
+      (Helper::IsClientTxn(region->Range().start_key()) || Helper::IsExecutorTxn(region->Range().start_key()))) {
+    return Helper::GetUserKeyFromTxnKey(split_key);
+  }
+  return split_key;
+}
+
 // base physics key, contain key of multi version.
+// The approximate path doesn't read the keys, count is left 0 and the key count is not published by split check.
 std::string HalfSplitChecker::SplitKey(store::RegionPtr region, const pb::common::Range& physical_range,
                                        const std::vector<std::string>& cf_names, uint32_t& count) {
+  if (FLAGS_split_check_use_approximate_size) {
+    int64_t total_size = ApproximateSize(raw_engine_, physical_range, cf_names);
+    if (total_size > 0 && total_size < split_threshold_size_) {
+      DINGO_LOG(INFO) << fmt::format(
+          "[split.check][region({})] policy(HALF) split_threshold_size({}) approximate_size({}) not split",
+          region->Id(), split_threshold_size_, total_size);
+      return "";
+    }
+
+    auto split_key =
+        ApproximateSplitKey(raw_engine_, physical_range, cf_names, total_size, total_size / 2, split_chunk_size_);
+    if (!split_key.empty()) {
+      split_key = ToUserSplitKey(region, split_key);
+      DINGO_LOG(INFO) << fmt::format(
+          "[split.check][region({})] policy(HALF) split_threshold_size({}) approximate_size({}) split_key({})",
+          region->Id(), split_threshold_size_, total_size, Helper::StringToHex(split_key));
+      return split_key;
+    }
+  }
+
   MergedIterator iter(raw_engine_, cf_names, physical_range.end_key());
   iter.Seek(physical_range.start_key());
 
@@ -149,8 +281,30 @@ std::string HalfSplitChecker::SplitKey(store::RegionPtr region, const pb::common
 }
 
 // base physics key, contain key of multi version.
+// The approximate path doesn't read the keys, count is left 0 and the key count is not published by split check.
 std::string SizeSplitChecker::SplitKey(store::RegionPtr region, const pb::common::Range& physical_range,
                                        const std::vector<std::string>& cf_names, uint32_t& count) {
+  if (FLAGS_split_check_use_approximate_size) {
+    int64_t total_size = ApproximateSize(raw_engine_, physical_range, cf_names);
+    if (total_size > 0 && total_size < split_size_) {
+      DINGO_LOG(INFO) << fmt::format(
+          "[split.check][region({})] policy(SIZE) split_size({}) approximate_size({}) not split", region->Id(),
+          split_size_, total_size);
+      return "";
+    }
+
+    auto split_key = ApproximateSplitKey(raw_engine_, physical_range, cf_names, total_size,
+                                         static_cast<int64_t>(split_size_ * split_ratio_),
+                                         FLAGS_split_check_approximate_resolution_size);
+    if (!split_key.empty()) {
+      split_key = ToUserSplitKey(region, split_key);
+      DINGO_LOG(INFO) << fmt::format(
+          "[split.check][region({})] policy(SIZE) split_size({}) split_ratio({}) approximate_size({}) split_key({})",
+          region->Id(), split_size_, split_ratio_, total_size, Helper::StringToHex(split_key));
+      return split_key;
+    }
+  }
+
   MergedIterator iter(raw_engine_, cf_names, physical_range.end_key());
   iter.Seek(physical_range.start_key());
 
@@ -226,6 +380,43 @@ std::string KeysSplitChecker::SplitKey(store::RegionPtr region, const pb::common
   return is_split ? split_key : "";
 }
 
+// base user key, sampled from the request keys.
+std::string LoadSplitChecker::SplitKey(store::RegionPtr region, const pb::common::Range& /*physical_range*/,
+                                       const std::vector<std::string>& /*cf_names*/, uint32_t& /*count*/) {
+  auto range = region->Range();
+  std::vector<std::string_view> keys;
+  keys.reserve(sample_keys_.size());
+  for (const auto& key : sample_keys_) {
+    if (key >= range.start_key() && key < range.end_key()) {
+      keys.push_back(key);
+    }
+  }
+  std::sort(keys.begin(), keys.end());
+
+  std::string split_key;
+  size_t left_count = 0;
+  if (keys.size() >= 2) {
+    // Split before or after the median key, which one is more balanced.
+    const auto& mid_key = keys[keys.size() / 2];
+    size_t lower = std::lower_bound(keys.begin(), keys.end(), mid_key) - keys.begin();
+    size_t upper = std::upper_bound(keys.begin(), keys.end(), mid_key) - keys.begin();
+    auto imbalance = [&](size_t pos) { return std::max(pos, keys.size() - pos); };
+    size_t pos = (lower > 0 && (upper == keys.size() || imbalance(lower) <= imbalance(upper))) ? lower : upper;
+    if (pos > 0 && pos < keys.size() &&
+        static_cast<float>(imbalance(pos)) / keys.size() <= max_hot_key_ratio_ && keys[pos] > range.start_key()) {
+      split_key = keys[pos];
+      left_count = pos;
+    }
+  }
+
+  DINGO_LOG(INFO) << fmt::format(
+      "[split.check][region({})] policy(LOAD) sample_keys({}) in_range_keys({}) left_keys({}) max_hot_key_ratio({}) "
+      "split_key({})",
+      region->Id(), sample_keys_.size(), keys.size(), left_count, max_hot_key_ratio_, Helper::StringToHex(split_key));
+
+  return split_key;
+}
+
 static bool CheckLeaderAndFollowerStatus(int64_t region_id) {
   auto region = Server::GetInstance().GetRegion(region_id);
   if (region == nullptr) {
@@ -307,7 +498,8 @@ void SplitCheckTask::SplitCheck() {
     split_key = split_checker_->SplitKey(region_, region_->Range(), raw_cf_names, key_count);
   }
 
-  // Update region key count metrics.
+  // Update region key count metrics, only when the checker counted the keys by full scan.
+  // A 0 count, e.g. from the approximate size path, leaves the key count to the metrics collector.
   if (region_metrics_ != nullptr && key_count > 0) {
     region_metrics_->SetKeyCount(key_count);
     region_metrics_->SetNeedUpdateKeyCount(false);
@@ -392,6 +584,9 @@ void SplitCheckTask::SplitCheck() {
                                       Helper::PrintStatus(status));
     return;
   }
+
+  // For load split cooldown.
+  region_->UpdateLastSplitTimestamp();
 }
 
 bool SplitCheckWorkers::Init(uint32_t num) {
@@ -461,6 +656,55 @@ static std::shared_ptr<SplitChecker> BuildSplitChecker(std::shared_ptr<RawEngine
   return nullptr;
 }
 
+static bool IsInLoadSplitCooldown(store::RegionPtr region) {
+  int64_t cooldown_ms = FLAGS_region_load_split_cooldown_s * 1000;
+  int64_t now_ms = Helper::TimestampMs();
+  if (now_ms - region->LastSplitTimestamp() < cooldown_ms) {
+    return true;
+  }
+
+  // The child region of a recent split, avoid split again at once.
+  if (region->ParentId() > 0) {
+    auto parent_region = GET_STORE_REGION_META->GetRegion(region->ParentId());
+    if (parent_region != nullptr && now_ms - parent_region->LastSplitTimestamp() < cooldown_ms) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+// Take the region load window, return load split checker when the region is hot.
+static std::shared_ptr<SplitChecker> BuildLoadSplitChecker(store::RegionPtr region) {
+  if (!FLAGS_enable_region_load_split) {
+    return nullptr;
+  }
+
+  auto window = region->LoadStats().TakeWindow();
+  int64_t qps = window.Qps();
+  double busy_ratio = window.BusyRatio();
+  if (qps < FLAGS_region_load_split_qps && busy_ratio < FLAGS_region_load_split_busy_ratio) {
+    return nullptr;
+  }
+
+  std::string reason;
+  if (window.sample_keys.size() < FLAGS_region_load_split_min_sample_keys) {
+    reason = "sample keys too few";
+  } else if (IsInLoadSplitCooldown(region)) {
+    reason = "in split cooldown";
+  }
+
+  DINGO_LOG(INFO) << fmt::format(
+      "[split.check][region({})] hot region qps({}/{}) busy_ratio({:.2f}/{:.2f}) sample_keys({}) skip reason({})",
+      region->Id(), qps, FLAGS_region_load_split_qps, busy_ratio, FLAGS_region_load_split_busy_ratio,
+      window.sample_keys.size(), reason);
+  if (!reason.empty()) {
+    return nullptr;
+  }
+
+  return std::make_shared<LoadSplitChecker>(std::move(window.sample_keys), FLAGS_region_load_split_max_hot_key_ratio);
+}
+
 void PreSplitCheckTask::PreSplitCheck() {
   // if system capacity is very low, suspend all split check to avoid split region.
   auto ret = ServiceHelper::ValidateClusterReadOnly();
@@ -475,6 +719,7 @@ void PreSplitCheckTask::PreSplitCheck() {
   int64_t split_check_approximate_size = ConfigHelper::GetSplitCheckApproximateSize();
   for (auto& region : regions) {
     auto region_metric = metrics->GetMetrics(region->Id());
+    std::shared_ptr<SplitChecker> load_split_checker = BuildLoadSplitChecker(region);
     bool need_scan_check = true;
     std::string reason;
     do {
@@ -513,7 +758,8 @@ void PreSplitCheckTask::PreSplitCheck() {
         reason = "not leader or follower abnormal";
         break;
       }
-      if (region_metric->InnerRegionMetrics().region_size() < split_check_approximate_size) {
+      if (load_split_checker == nullptr &&
+          region_metric->InnerRegionMetrics().region_size() < split_check_approximate_size) {
         need_scan_check = false;
         reason = "region approximate size too small";
         break;
@@ -542,7 +788,7 @@ void PreSplitCheckTask::PreSplitCheck() {
       continue;
     }
 
-    auto split_checker = BuildSplitChecker(raw_engine);
+    auto split_checker = load_split_checker != nullptr ? load_split_checker : BuildSplitChecker(raw_engine);
     if (split_checker == nullptr) {
       continue;
     }
@@ -20,9 +20,11 @@
 #include <cstdint>
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "common/runnable.h"
+#include "crontab/crontab.h"
 #include "engine/raw_engine.h"
 #include "meta/store_meta_manager.h"
 #include "metrics/store_metrics_manager.h"
@@ -65,6 +67,7 @@ class SplitChecker {
     kHalf = 0,
     kSize = 1,
     kKeys = 2,
+    kLoad = 3,
   };
 
   SplitChecker(Policy policy) : policy_(policy) {}
@@ -79,6 +82,8 @@ class SplitChecker {
       return "SIZE";
     } else if (policy_ == Policy::kKeys) {
       return "KEYS";
+    } else if (policy_ == Policy::kLoad) {
+      return "LOAD";
     }
     return "";
   };
@@ -157,6 +162,28 @@ class KeysSplitChecker : public SplitChecker {
   std::shared_ptr<RawEngine> raw_engine_;
 };
 
+// Split hot region based request load.
+// The split key is the median of the keys sampled from requests, so both sides get about half of the load
+// rather than half of the bytes.
+class LoadSplitChecker : public SplitChecker {
+ public:
+  LoadSplitChecker(std::vector<std::string> sample_keys, float max_hot_key_ratio)
+      : SplitChecker(SplitChecker::Policy::kLoad),
+        sample_keys_(std::move(sample_keys)),
+        max_hot_key_ratio_(max_hot_key_ratio) {}
+  ~LoadSplitChecker() override = default;
+
+  // base user key, sampled from the request keys.
+  std::string SplitKey(store::RegionPtr region, const pb::common::Range& physical_range,
+                       const std::vector<std::string>& cf_names, uint32_t& count) override;
+
+ private:
+  // Keys sampled from requests within the load window.
+  std::vector<std::string> sample_keys_;
+  // Not split when the split key alone take more than this ratio of samples, split can't balance one hot key.
+  float max_hot_key_ratio_;
+};
+
 // Multiple worker run split check task.
 class SplitCheckWorkers {
  public:
@@ -197,7 +224,10 @@ class SplitCheckTask : public TaskRunnable {
   std::string Type() override { return "SPLIT_CHECK"; }
 
   void Run() override {
-    SplitCheck();
+    {
+      CrontabRunTimeGuard guard;
+      SplitCheck();
+    }
     if (region_ != nullptr && split_check_workers_ != nullptr) {
       split_check_workers_->DeleteRegionChecking(region_->Id());
     }
@@ -221,7 +251,10 @@ class PreSplitCheckTask : public TaskRunnable {
 
   std::string Type() override { return "PRE_SPLIT_CHECK"; }
 
-  void Run() override { PreSplitCheck(); }
+  void Run() override {
+    CrontabRunTimeGuard guard;
+    PreSplitCheck();
+  }
 
  private:
   void PreSplitCheck();
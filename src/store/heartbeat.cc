@@ -21,9 +21,13 @@
 #include <map>
 #include <memory>
 #include <set>
+#include <string>
+#include <unordered_map>
 #include <vector>
 
+#include "bthread/mutex.h"
 #include "butil/compiler_specific.h"
+#include "butil/scoped_lock.h"
 #include "butil/status.h"
 #include "butil/time.h"
 #include "common/helper.h"
@@ -31,6 +35,7 @@
 #include "common/role.h"
 #include "coordinator/balance_leader.h"
 #include "coordinator/coordinator_control.h"
+#include "coordinator/region_merge.h"
 #include "fmt/core.h"
 #include "gflags/gflags.h"
 #include "proto/common.pb.h"
@@ -38,6 +43,8 @@
 #include "proto/error.pb.h"
 #include "server/server.h"
 
+DECLARE_bool(enable_balance_hot_store);
+
 namespace dingodb {
 
 DEFINE_int32(executor_heartbeat_timeout, 30, "executor heartbeat timeout in seconds");
@@ -51,8 +58,46 @@ DEFINE_int64(store_heartbeat_report_region_multiple, 10,
              "store heartbeat report region multiple, this defines how many times of heartbeat will report "
              "region_metrics once to coordinator");
 
+DEFINE_bool(enable_store_heartbeat_delta_region_metrics, true,
+            "store heartbeat report changed region_metrics between full report, reduce coordinator heartbeat cost");
+
 std::atomic<uint64_t> HeartbeatTask::heartbeat_counter = 0;
 
+// digest of region_metrics last reported to coordinator, used to find changed region for delta heartbeat.
+static bthread::Mutex reported_region_digests_mutex;
+static std::unordered_map<int64_t, uint64_t> reported_region_digests;
+
+// Only the fields coordinator derive region state and status from are digested, raft log index and
+// index apply log id which change at every write are excluded.
+uint64_t HeartbeatTask::RegionMetricsDigest(const pb::common::RegionMetrics& region_metrics) {
+  const auto& definition = region_metrics.region_definition();
+  const auto& braft_status = region_metrics.braft_status();
+
+  std::string digest = fmt::format("{}|{}|{}|{}|{}|{}|{}|{}|{}", region_metrics.leader_store_id(),
+                                   static_cast<int>(region_metrics.store_region_state()),
+                                   definition.epoch().conf_version(), definition.epoch().version(),
+                                   definition.peers_size(), region_metrics.region_size(), region_metrics.row_count(),
+                                   static_cast<int>(braft_status.raft_state()), braft_status.unstable_followers_size());
+  for (const auto& [peer_id, follower] : braft_status.stable_followers()) {
+    digest += fmt::format("|{}:{}:{}:{}", peer_id, follower.next_index() < braft_status.last_index() + 10,
+                          follower.installing_snapshot(), follower.consecutive_error_times() > 10);
+  }
+  if (region_metrics.has_vector_index_status()) {
+    auto index_status = region_metrics.vector_index_status();
+    index_status.clear_apply_log_id();
+    index_status.clear_snapshot_log_id();
+    digest += "|" + index_status.SerializeAsString();
+  }
+  if (region_metrics.has_document_index_status()) {
+    auto index_status = region_metrics.document_index_status();
+    index_status.clear_apply_log_id();
+    index_status.clear_snapshot_log_id();
+    digest += "|" + index_status.SerializeAsString();
+  }
+
+  return std::hash<std::string>{}(digest);
+}
+
 void HeartbeatTask::SendStoreHeartbeat(std::shared_ptr<CoordinatorInteraction> coordinator_interaction,
                                        std::vector<int64_t> region_ids, bool is_update_epoch_version) {
   auto start_time = Helper::TimestampMs();
@@ -82,6 +127,9 @@ void HeartbeatTask::SendStoreHeartbeat(std::shared_ptr<CoordinatorInteraction> c
   // region_metrics, this is for reduce heartbeat size and cpu usage.
   bool need_report_region_metrics =
       !region_ids.empty() || (temp_heartbeat_count % FLAGS_store_heartbeat_report_region_multiple == 0);
+  // between full report, only report the region_metrics changed since last report.
+  bool is_delta_region_metrics = !need_report_region_metrics && FLAGS_enable_store_heartbeat_delta_region_metrics;
+  std::unordered_map<int64_t, uint64_t> region_digests;
 
   // construct store_own_metrics
   *(request.mutable_store_metrics()) = store_metrics_manager->GetStoreMetrics()->Metrics();
@@ -94,9 +142,9 @@ void HeartbeatTask::SendStoreHeartbeat(std::shared_ptr<CoordinatorInteraction> c
                                  Helper::TimestampMs() - start_time)
                   << ", metrics: " << request.mutable_store_metrics()->ShortDebugString();
 
-  if (need_report_region_metrics) {
-    DINGO_LOG(INFO) << fmt::format("[heartbeat.store] start_time({}) heartbeat_counter: {}", first_start_time,
-                                   temp_heartbeat_count);
+  if (need_report_region_metrics || is_delta_region_metrics) {
+    DINGO_LOG(INFO) << fmt::format("[heartbeat.store] start_time({}) heartbeat_counter: {} delta({})",
+                                   first_start_time, temp_heartbeat_count, is_delta_region_metrics);
 
     auto* mut_region_metrics_map = request.mutable_store_metrics()->mutable_region_metrics_map();
     auto region_metrics = store_metrics_manager->GetStoreRegionMetrics();
@@ -183,9 +231,23 @@ void HeartbeatTask::SendStoreHeartbeat(std::shared_ptr<CoordinatorInteraction> c
         }
       }
 
+      uint64_t digest = RegionMetricsDigest(tmp_region_metrics);
+      if (is_delta_region_metrics) {
+        BAIDU_SCOPED_LOCK(reported_region_digests_mutex);
+        auto it = reported_region_digests.find(inner_region.id());
+        if (it != reported_region_digests.end() && it->second == digest) {
+          continue;
+        }
+      }
+      region_digests[inner_region.id()] = digest;
+
       mut_region_metrics_map->insert({inner_region.id(), tmp_region_metrics});
     }
 
+    if (is_delta_region_metrics && !mut_region_metrics_map->empty()) {
+      request.mutable_store_metrics()->set_is_partial_region_metrics(true);
+    }
+
     DINGO_LOG(INFO) << fmt::format(
         "[heartbeat.store] start_time({}) request region count({}) size({}) region_ids_count({}), elapsed time({} ms)",
         first_start_time, mut_region_metrics_map->size(), request.ByteSizeLong(), region_ids.size(),
@@ -215,6 +277,18 @@ void HeartbeatTask::SendStoreHeartbeat(std::shared_ptr<CoordinatorInteraction> c
   DINGO_LOG(INFO) << fmt::format("[heartbeat.store] start_time({}) response size({}) elapsed time({} ms)",
                                  first_start_time, response.ByteSizeLong(), Helper::TimestampMs() - start_time);
 
+  // coordinator has received the region_metrics, record the digest
+  if (!region_digests.empty() || (need_report_region_metrics && region_ids.empty())) {
+    BAIDU_SCOPED_LOCK(reported_region_digests_mutex);
+    if (need_report_region_metrics && region_ids.empty()) {
+      reported_region_digests.swap(region_digests);
+    } else {
+      for (const auto& [region_id, digest] : region_digests) {
+        reported_region_digests[region_id] = digest;
+      }
+    }
+  }
+
   HeartbeatTask::HandleStoreHeartbeatResponse(store_meta_manager, response);
 }
 
@@ -547,6 +621,20 @@ void DocumentIndexScrubTask::ScrubDocumentIndex() {
   }
 }
 
+void DocumentIndexGroupCommitTask::GroupCommitDocumentIndex() {
+  auto status = DocumentIndexManager::GroupCommitDocumentIndex();
+  if (!status.ok()) {
+    DINGO_LOG(ERROR) << fmt::format("Group commit document index failed, error: {}", status.error_str());
+  }
+}
+
+void DocumentIndexMemoryBudgetTask::BalanceDocumentIndexMemory() {
+  auto status = DocumentIndexManager::BalanceDocumentIndexMemory();
+  if (!status.ok()) {
+    DINGO_LOG(ERROR) << fmt::format("Balance document index memory failed, error: {}", status.error_str());
+  }
+}
+
 void BalanceLeaderTask::DoBalanceLeader() {
   auto coordinator_controller = Server::GetInstance().GetCoordinatorControl();
   if (!coordinator_controller->IsLeader()) {
@@ -558,6 +646,15 @@ void BalanceLeaderTask::DoBalanceLeader() {
     return;
   }
 
+  if (FLAGS_enable_balance_hot_store) {
+    // hot store, transfer leader out of hot cpu usage store first
+    auto tracker = balance::Tracker::New();
+    auto status = balance::HotStoreScheduler::LaunchBalanceHotStore(coordinator_controller, raft_engine,
+                                                                    pb::common::NODE_TYPE_STORE, false, tracker);
+    DINGO_LOG_IF(INFO, !status.ok()) << fmt::format("[balance.hot_store] store process error: {}", status.error_str());
+    tracker->Print();
+  }
+
   {
     // store
     auto tracker = balance::Tracker::New();
@@ -586,6 +683,23 @@ void BalanceLeaderTask::DoBalanceLeader() {
   }
 }
 
+void RegionMergeTask::DoRegionMerge() {
+  auto coordinator_controller = Server::GetInstance().GetCoordinatorControl();
+  if (!coordinator_controller->IsLeader()) {
+    return;
+  }
+
+  auto raft_engine = Server::GetInstance().GetRaftStoreEngine();
+  if (raft_engine == nullptr) {
+    return;
+  }
+
+  std::vector<balance::MergeRegionTask> tasks;
+  auto status = balance::RegionMergeScheduler::LaunchRegionMerge(coordinator_controller, raft_engine, false, tasks);
+  DINGO_LOG_IF(INFO, !status.ok()) << fmt::format("[balance.merge] process error: {}", status.error_str());
+  DINGO_LOG_IF(INFO, !tasks.empty()) << fmt::format("[balance.merge] launch merge region task count: {}", tasks.size());
+}
+
 bool Heartbeat::Init() {
   auto worker = Worker::New();
   if (!worker->Init()) {
@@ -683,10 +797,28 @@ void Heartbeat::TriggerScrubDocumentIndex(void*) {
   Server::GetInstance().GetHeartbeat()->Execute(task);
 }
 
+void Heartbeat::TriggerDocumentIndexGroupCommit(void*) {
+  // Free at ExecuteRoutine()
+  auto task = std::make_shared<DocumentIndexGroupCommitTask>();
+  Server::GetInstance().GetHeartbeat()->Execute(task);
+}
+
+void Heartbeat::TriggerDocumentIndexMemoryBudget(void*) {
+  // Free at ExecuteRoutine()
+  auto task = std::make_shared<DocumentIndexMemoryBudgetTask>();
+  Server::GetInstance().GetHeartbeat()->Execute(task);
+}
+
 void Heartbeat::TriggerBalanceLeader(void*) {
   // Free at ExecuteRoutine()
   auto task = std::make_shared<BalanceLeaderTask>();
   Server::GetInstance().GetHeartbeat()->Execute(task);
 }
 
+void Heartbeat::TriggerRegionMerge(void*) {
+  // Free at ExecuteRoutine()
+  auto task = std::make_shared<RegionMergeTask>();
+  Server::GetInstance().GetHeartbeat()->Execute(task);
+}
+
 }  // namespace dingodb
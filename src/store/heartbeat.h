@@ -20,6 +20,7 @@
 
 #include "common/logging.h"
 #include "common/runnable.h"
+#include "crontab/crontab.h"
 #include "coordinator/coordinator_control.h"
 #include "coordinator/coordinator_interaction.h"
 #include "coordinator/kv_control.h"
@@ -48,6 +49,9 @@ class HeartbeatTask : public TaskRunnable {
   static void HandleStoreHeartbeatResponse(std::shared_ptr<StoreMetaManager> store_meta,
                                            const pb::coordinator::StoreHeartbeatResponse& response);
 
+  // digest of the region_metrics fields which coordinator cares, unchanged region is skipped by delta heartbeat
+  static uint64_t RegionMetricsDigest(const pb::common::RegionMetrics& region_metrics);
+
   static std::atomic<uint64_t> heartbeat_counter;
 
  private:
@@ -207,6 +211,7 @@ class CompactionTask : public TaskRunnable {
 
   void Run() override {
     DINGO_LOG(DEBUG) << "start process CompactionTask";
+    CrontabRunTimeGuard guard;
     ExecCompactionTask(kv_control_);
   }
 
@@ -222,7 +227,10 @@ class VectorIndexScrubTask : public TaskRunnable {
 
   std::string Type() override { return "VECTOR_INDEX_SCRUB"; }
 
-  void Run() override { ScrubVectorIndex(); }
+  void Run() override {
+    CrontabRunTimeGuard guard;
+    ScrubVectorIndex();
+  }
 
   static void ScrubVectorIndex();
 };
@@ -234,11 +242,38 @@ class DocumentIndexScrubTask : public TaskRunnable {
 
   std::string Type() override { return "DOCUMENT_INDEX_SCRUB"; }
 
-  void Run() override { ScrubDocumentIndex(); }
+  void Run() override {
+    CrontabRunTimeGuard guard;
+    ScrubDocumentIndex();
+  }
 
   static void ScrubDocumentIndex();
 };
 
+class DocumentIndexGroupCommitTask : public TaskRunnable {
+ public:
+  DocumentIndexGroupCommitTask() = default;
+  ~DocumentIndexGroupCommitTask() override = default;
+
+  std::string Type() override { return "DOCUMENT_INDEX_GROUP_COMMIT"; }
+
+  void Run() override { GroupCommitDocumentIndex(); }
+
+  static void GroupCommitDocumentIndex();
+};
+
+class DocumentIndexMemoryBudgetTask : public TaskRunnable {
+ public:
+  DocumentIndexMemoryBudgetTask() = default;
+  ~DocumentIndexMemoryBudgetTask() override = default;
+
+  std::string Type() override { return "DOCUMENT_INDEX_MEMORY_BUDGET"; }
+
+  void Run() override { BalanceDocumentIndexMemory(); }
+
+  static void BalanceDocumentIndexMemory();
+};
+
 class BalanceLeaderTask : public TaskRunnable {
  public:
   BalanceLeaderTask() = default;
@@ -251,6 +286,18 @@ class BalanceLeaderTask : public TaskRunnable {
   static void DoBalanceLeader();
 };
 
+class RegionMergeTask : public TaskRunnable {
+ public:
+  RegionMergeTask() = default;
+  ~RegionMergeTask() override = default;
+
+  std::string Type() override { return "REGION_MERGE"; }
+
+  void Run() override { DoRegionMerge(); }
+
+  static void DoRegionMerge();
+};
+
 class Heartbeat {
  public:
   Heartbeat() = default;
@@ -272,9 +319,12 @@ class Heartbeat {
   static void TriggerCalculateTableMetrics(void*);
   static void TriggerScrubVectorIndex(void*);
   static void TriggerScrubDocumentIndex(void*);
+  static void TriggerDocumentIndexGroupCommit(void*);
+  static void TriggerDocumentIndexMemoryBudget(void*);
   static void TriggerLeaseTask(void*);
   static void TriggerCompactionTask(void*);
   static void TriggerBalanceLeader(void*);
+  static void TriggerRegionMerge(void*);
 
  private:
   bool Execute(TaskRunnablePtr task);
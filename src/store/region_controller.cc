@@ -18,6 +18,7 @@
 #include <cassert>
 #include <cstdint>
 #include <memory>
+#include <set>
 #include <string>
 #include <vector>
 
@@ -29,25 +30,35 @@
 #include "common/service_access.h"
 #include "config/config_helper.h"
 #include "config/config_manager.h"
+#include "engine/change_capture.h"
+#include "engine/pessimistic_lock_table.h"
 #include "engine/raft_store_engine.h"
+#include "engine/txn_engine_helper.h"
 #include "event/store_state_machine_event.h"
 #include "fmt/core.h"
 #include "gflags/gflags.h"
 #include "glog/logging.h"
+#include "log/index_journal.h"
 #include "meta/store_meta_manager.h"
 #include "metrics/store_bvar_metrics.h"
 #include "proto/common.pb.h"
 #include "proto/coordinator.pb.h"
 #include "proto/error.pb.h"
 #include "proto/raft.pb.h"
+#include "raft/raft_cmd_codec.h"
 #include "server/server.h"
 #include "vector/codec.h"
 #include "vector/vector_index_hnsw.h"
 
 DEFINE_int64(merge_committed_log_gap, 16, "merge commited log gap");
 DEFINE_int32(init_election_timeout_ms, 1000, "init election timeout");
+DEFINE_bool(enable_first_peer_prefer_leader, false,
+            "the first peer of new region elects with shorter timeout to be the leader, coordinator scatters leaders "
+            "of pre split regions by peer order");
 
 DEFINE_int64(transfer_leader_last_serving_gap_time_s, 6, "transfer leader last serving gap time");
+DEFINE_bool(enable_delete_region_drop_files, false,
+            "delete the sst files of deleted region range and compact the boundary, reclaim disk space at once");
 
 namespace dingodb {
 // Notify coordinator region command execute result.
@@ -151,6 +162,11 @@ butil::Status CreateRegionTask::CreateRegion(const pb::common::RegionDefinition&
     auto config = ConfigManager::GetInstance().GetRoleConfig();
     parameter.raft_path = config->GetString("raft.path");
     parameter.election_timeout_ms = FLAGS_init_election_timeout_ms;
+    // the random election timeout is in [timeout, 2*timeout), so the first peer times out before the others
+    if (FLAGS_enable_first_peer_prefer_leader && parent_region_id == 0 && definition.peers_size() > 0 &&
+        definition.peers(0).store_id() == Server::GetInstance().Id()) {
+      parameter.election_timeout_ms = std::max(FLAGS_init_election_timeout_ms / 4, 1);
+    }
     parameter.log_max_segment_size = config->GetInt64("raft.segmentlog_max_segment_size");
     parameter.log_path = config->GetString("raft.log_path");
 
@@ -237,6 +253,25 @@ butil::Status DeleteRegionTask::ValidateDeleteRegion(std::shared_ptr<StoreMetaMa
   return butil::Status();
 }
 
+// The data is already deleted by range tombstone, drop the files to reclaim disk space and avoid iterating over the
+// tombstones. Failure is not fatal, the compaction will reclaim it later.
+static void DropRegionFiles(RawEnginePtr raw_engine, store::RegionPtr region,
+                            const std::vector<std::string>& raw_cf_names, const std::vector<std::string>& txn_cf_names) {
+  pb::common::Range txn_range = Helper::GetMemComparableRange(region->Range());
+  for (const auto& cf_name : raw_cf_names) {
+    auto status = raw_engine->DeleteFilesInRange(cf_name, region->Range());
+    DINGO_LOG_IF(WARNING, !status.ok()) << fmt::format(
+        "[control.region][region({})] drop region files failed, cf: {} error: {}", region->Id(), cf_name,
+        status.error_str());
+  }
+  for (const auto& cf_name : txn_cf_names) {
+    auto status = raw_engine->DeleteFilesInRange(cf_name, txn_range);
+    DINGO_LOG_IF(WARNING, !status.ok()) << fmt::format(
+        "[control.region][region({})] drop region files failed, cf: {} error: {}", region->Id(), cf_name,
+        status.error_str());
+  }
+}
+
 butil::Status DeleteRegionTask::DeleteRegion(std::shared_ptr<Context> ctx, int64_t region_id) {
   auto store_meta_manager = Server::GetInstance().GetStoreMetaManager();
   auto store_region_meta = store_meta_manager->GetStoreRegionMeta();
@@ -266,6 +301,7 @@ butil::Status DeleteRegionTask::DeleteRegion(std::shared_ptr<Context> ctx, int64
     DINGO_LOG(DEBUG) << fmt::format("[control.region][region({})] delete region, delete raft node", region_id);
     raft_store_engine->DestroyNode(ctx, region_id);
     Server::GetInstance().GetLogStorageManager()->DeleteStorage(region_id);
+    IndexJournalManager::GetInstance().DeleteJournal(region_id);
   }
 
   // Update state
@@ -280,6 +316,10 @@ butil::Status DeleteRegionTask::DeleteRegion(std::shared_ptr<Context> ctx, int64
   // Delete raft meta
   store_meta_manager->GetStoreRaftMeta()->DeleteRaftMeta(region_id);
 
+  if (ChangeCapture::IsEnabled()) {
+    ChangeCapture::GetInstance().EraseRegion(region_id);
+  }
+
   // index region
   if (GetRole() == pb::common::ClusterRole::INDEX) {
     auto vector_index_wrapper = region->VectorIndexWrapper();
@@ -318,6 +358,10 @@ butil::Status DeleteRegionTask::DeleteRegion(std::shared_ptr<Context> ctx, int64
         CHECK(status.ok()) << fmt::format("[control.region][region({})] delete region data txn failed, error: {}",
                                           region->Id(), status.error_str());
       }
+
+      if (FLAGS_enable_delete_region_drop_files) {
+        DropRegionFiles(region_raw_engine, region, raw_cf_names, txn_cf_names);
+      }
     } else {
       auto command = std::make_shared<pb::coordinator::RegionCmd>();
       command->set_id(Helper::TimestampNs());
@@ -594,8 +638,7 @@ butil::Status CheckChangeRegionLog(int64_t region_id, int64_t min_applied_log_id
   bool has = log_storage->HasSpecificLog(min_applied_log_id, INT64_MAX, [&](const LogEntry& log_entry) -> bool {
     if (log_entry.type == LogEntryType::kEntryTypeData) {
       auto raft_cmd = std::make_shared<pb::raft::RaftCmdRequest>();
-      butil::IOBufAsZeroCopyInputStream wrapper(log_entry.data);
-      CHECK(raft_cmd->ParseFromZeroCopyStream(&wrapper)) << "parse raft log fail.";
+      CHECK(RaftCmdCodec::Decode(log_entry.data, *raft_cmd)) << "parse raft log fail.";
       for (const auto& request : raft_cmd->requests()) {
         if (request.cmd_type() == pb::raft::CmdType::SPLIT || request.cmd_type() == pb::raft::CmdType::PREPARE_MERGE ||
             request.cmd_type() == pb::raft::CmdType::COMMIT_MERGE ||
@@ -1062,6 +1105,20 @@ butil::Status TransferLeaderTask::TransferLeader(std::shared_ptr<Context>, int64
   }
   auto raft_store_engine = Server::GetInstance().GetRaftStoreEngine();
   if (raft_store_engine != nullptr) {
+    // The new leader not has the in memory pessimistic lock, persist them first.
+    if (PessimisticLockTable::IsEnabled()) {
+      auto region = store_meta_manager->GetStoreRegionMeta()->GetRegion(region_id);
+      if (region != nullptr) {
+        status = TxnEngineHelper::PersistMemoryPessimisticLock(raft_store_engine, region);
+        if (!status.ok()) {
+          DINGO_LOG(ERROR) << fmt::format(
+              "[control.region][region({})] persist memory pessimistic lock failed, error: {}", region_id,
+              status.error_str());
+          return status;
+        }
+      }
+    }
+
     return raft_store_engine->TransferLeader(region_id, peer);
   }
 
@@ -1654,6 +1711,34 @@ void RegionCommandManager::AddCommand(RegionCmdPtr region_cmd) {
   meta_writer_->Put(TransformToKv(region_cmd));
 }
 
+std::vector<RegionCmdPtr> RegionCommandManager::AddCommands(const std::vector<RegionCmdPtr>& region_cmds) {
+  std::vector<RegionCmdPtr> added_region_cmds;
+  {
+    BAIDU_SCOPED_LOCK(mutex_);
+    for (const auto& region_cmd : region_cmds) {
+      if (region_commands_.find(region_cmd->id()) != region_commands_.end()) {
+        DINGO_LOG(WARNING) << fmt::format("[control.region][commond({})] region control command already exist!",
+                                          region_cmd->id());
+        continue;
+      }
+
+      region_commands_.insert(std::make_pair(region_cmd->id(), region_cmd));
+      added_region_cmds.push_back(region_cmd);
+    }
+  }
+
+  if (!added_region_cmds.empty()) {
+    std::vector<pb::common::KeyValue> kvs;
+    kvs.reserve(added_region_cmds.size());
+    for (const auto& region_cmd : added_region_cmds) {
+      kvs.push_back(*TransformToKv(region_cmd));
+    }
+    meta_writer_->Put(kvs);
+  }
+
+  return added_region_cmds;
+}
+
 void RegionCommandManager::UpdateCommandStatus(RegionCmdPtr region_cmd, pb::coordinator::RegionCmdStatus status) {
   region_cmd->set_status(status);
   meta_writer_->Put(TransformToKv(region_cmd));
@@ -1894,6 +1979,30 @@ butil::Status RegionController::DispatchRegionControlCommand(std::shared_ptr<Con
   return DispatchRegionControlCommandImpl(ctx, command);
 }
 
+std::vector<butil::Status> RegionController::DispatchRegionControlCommands(const std::vector<RegionCmdPtr>& commands) {
+  auto region_command_manager = Server::GetInstance().GetRegionCommandManager();
+
+  // Save region commands, repeat commands are not added
+  auto added_commands = region_command_manager->AddCommands(commands);
+  std::set<int64_t> added_command_ids;
+  for (const auto& command : added_commands) {
+    added_command_ids.insert(command->id());
+  }
+
+  std::vector<butil::Status> statuses;
+  statuses.reserve(commands.size());
+  for (const auto& command : commands) {
+    if (added_command_ids.erase(command->id()) == 0) {
+      statuses.push_back(butil::Status(pb::error::EREGION_REPEAT_COMMAND, "Repeat region control command"));
+      continue;
+    }
+
+    statuses.push_back(DispatchRegionControlCommandImpl(std::make_shared<Context>(), command));
+  }
+
+  return statuses;
+}
+
 RegionController::ValidateFunc RegionController::GetValidater(pb::coordinator::RegionCmdType cmd_type) {
   auto it = validaters.find(cmd_type);
   if (it == validaters.end()) {
@@ -380,6 +380,8 @@ class RegionCommandManager : public TransformKvAble {
   bool IsExist(int64_t command_id);
 
   void AddCommand(RegionCmdPtr region_cmd);
+  // add commands and persist them in one meta write, return the added commands(skip existed)
+  std::vector<RegionCmdPtr> AddCommands(const std::vector<RegionCmdPtr>& region_cmds);
   void UpdateCommandStatus(RegionCmdPtr region_cmd, pb::coordinator::RegionCmdStatus status);
   void UpdateCommandStatus(int64_t command_id, pb::coordinator::RegionCmdStatus status);
   RegionCmdPtr GetCommand(int64_t command_id);
@@ -423,6 +425,9 @@ class RegionController {
   void UnRegisterExecutor(int64_t region_id);
 
   butil::Status DispatchRegionControlCommand(std::shared_ptr<Context> ctx, RegionCmdPtr command);
+  // save commands in one meta write, then dispatch to the region control executors which run concurrently.
+  // return the status of each command, same order with commands.
+  std::vector<butil::Status> DispatchRegionControlCommands(const std::vector<RegionCmdPtr>& commands);
 
   // For pre validate
   using ValidateFunc = std::function<butil::Status(const pb::coordinator::RegionCmd&)>;
@@ -0,0 +1,150 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "store/region_heat.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "butil/scoped_lock.h"
+#include "common/helper.h"
+#include "common/logging.h"
+#include "fmt/core.h"
+#include "gflags/gflags.h"
+#include "server/server.h"
+
+namespace dingodb {
+
+DEFINE_bool(enable_region_heat, false,
+            "save region access heat periodically, recover raft node and load index of hot regions first at startup");
+DEFINE_int32(region_heat_save_interval_s, 60, "region heat save interval seconds");
+
+RegionHeat::RegionHeat() { bthread_mutex_init(&mutex_, nullptr); }
+
+RegionHeat::~RegionHeat() { bthread_mutex_destroy(&mutex_); }
+
+bool RegionHeat::IsEnabled() { return FLAGS_enable_region_heat; }
+
+std::map<int64_t, int64_t> RegionHeat::Parse(const std::string& content) {
+  std::map<int64_t, int64_t> heats;
+  std::istringstream input(content);
+  std::string line;
+  while (std::getline(input, line)) {
+    std::istringstream line_input(line);
+    int64_t region_id = 0;
+    int64_t heat = 0;
+    if (line_input >> region_id >> heat && region_id > 0 && heat > 0) {
+      heats[region_id] = heat;
+    }
+  }
+
+  return heats;
+}
+
+std::string RegionHeat::Serialize(const std::map<int64_t, int64_t>& heats) {
+  std::string content;
+  for (const auto& [region_id, heat] : heats) {
+    content += fmt::format("{} {}\n", region_id, heat);
+  }
+
+  return content;
+}
+
+void RegionHeat::Load(const std::string& path) {
+  std::ifstream file(path);
+  std::stringstream buffer;
+  if (file.is_open()) {
+    buffer << file.rdbuf();
+  }
+  auto heats = Parse(buffer.str());
+
+  BAIDU_SCOPED_LOCK(mutex_);
+  path_ = path;
+  heats_ = std::move(heats);
+  DINGO_LOG(INFO) << fmt::format("[region.heat] load region heat from {}, region num({})", path, heats_.size());
+}
+
+void RegionHeat::Save() {
+  auto regions = Server::GetInstance().GetAllAliveRegion();
+
+  std::string path;
+  std::string content;
+  {
+    BAIDU_SCOPED_LOCK(mutex_);
+    if (path_.empty()) {
+      return;
+    }
+
+    std::map<int64_t, int64_t> heats;
+    std::map<int64_t, int64_t> counts;
+    for (const auto& region : regions) {
+      int64_t count = region->GetServedRequestCount();
+      int64_t delta = count - last_counts_[region->Id()];
+      int64_t heat = heats_[region->Id()] / 2 + std::max(delta, static_cast<int64_t>(0));
+      if (heat > 0) {
+        heats[region->Id()] = heat;
+      }
+      counts[region->Id()] = count;
+    }
+    heats_ = std::move(heats);
+    last_counts_ = std::move(counts);
+
+    path = path_;
+    content = Serialize(heats_);
+  }
+
+  // write a temp file then rename, a crash never leave a partial file
+  std::string tmp_path = path + ".tmp";
+  {
+    std::ofstream file(tmp_path, std::ios::trunc);
+    if (!file.is_open()) {
+      DINGO_LOG(WARNING) << fmt::format("[region.heat] open file {} failed", tmp_path);
+      return;
+    }
+    file << content;
+  }
+  auto status = Helper::Rename(tmp_path, path);
+  if (!status.ok()) {
+    DINGO_LOG(WARNING) << fmt::format("[region.heat] rename {} failed, error: {}", tmp_path, status.error_str());
+  }
+}
+
+int64_t RegionHeat::Heat(int64_t region_id) {
+  BAIDU_SCOPED_LOCK(mutex_);
+  auto it = heats_.find(region_id);
+  return it != heats_.end() ? it->second : 0;
+}
+
+void RegionHeat::SortByHeat(std::vector<store::RegionPtr>& regions) {
+  std::map<int64_t, int64_t> heats;
+  {
+    BAIDU_SCOPED_LOCK(mutex_);
+    heats = heats_;
+  }
+
+  auto heat_of = [&heats](const store::RegionPtr& region) -> int64_t {
+    auto it = heats.find(region->Id());
+    return it != heats.end() ? it->second : 0;
+  };
+  std::stable_sort(regions.begin(), regions.end(), [&heat_of](const store::RegionPtr& a, const store::RegionPtr& b) {
+    return heat_of(a) > heat_of(b);
+  });
+}
+
+}  // namespace dingodb
@@ -0,0 +1,67 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_STORE_REGION_HEAT_H_
+#define DINGODB_STORE_REGION_HEAT_H_
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "bthread/types.h"
+#include "meta/store_meta_manager.h"
+
+namespace dingodb {
+
+// Access heat of regions, saved to file periodically and loaded at next startup, so the hot regions recover their
+// raft node and load their vector/document index first.
+// heat = last heat / 2 + served requests since last save, the heat of a region cools down when it is not accessed.
+class RegionHeat {
+ public:
+  static RegionHeat& GetInstance() {
+    static RegionHeat instance;
+    return instance;
+  }
+
+  static bool IsEnabled();
+
+  // Load the heat saved by last run.
+  void Load(const std::string& path);
+  // Update heat by the served requests of regions and save it to file.
+  void Save();
+
+  int64_t Heat(int64_t region_id);
+  // Sort regions by heat, the hottest first, keep the order of same heat.
+  void SortByHeat(std::vector<store::RegionPtr>& regions);
+
+  // Format: one "region_id heat" per line.
+  static std::map<int64_t, int64_t> Parse(const std::string& content);
+  static std::string Serialize(const std::map<int64_t, int64_t>& heats);
+
+ private:
+  RegionHeat();
+  ~RegionHeat();
+
+  bthread_mutex_t mutex_;
+  std::string path_;
+  // region_id -> heat
+  std::map<int64_t, int64_t> heats_;
+  // region_id -> served request count at last save
+  std::map<int64_t, int64_t> last_counts_;
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_STORE_REGION_HEAT_H_
@@ -19,10 +19,9 @@
 #include "butil/compiler_specific.h"
 #include "common/constant.h"
 #include "common/helper.h"
+#include "common/key_codec.h"
 #include "common/logging.h"
 #include "fmt/core.h"
-#include "serial/buf.h"
-#include "serial/schema/long_schema.h"
 
 namespace dingodb {
 
@@ -32,11 +31,10 @@ void VectorCodec::EncodeVectorKey(char prefix, int64_t partition_id, std::string
     DINGO_LOG(FATAL) << "Encode vector key failed, prefix is 0, partition_id:[" << partition_id << "]";
   }
 
-  // Buf buf(17);
-  Buf buf(Constant::kVectorKeyMinLenWithPrefix);
-  buf.Write(prefix);
-  buf.WriteLong(partition_id);
-  buf.GetBytes(result);
+  result.clear();
+  result.reserve(Constant::kVectorKeyMinLenWithPrefix);
+  result.push_back(prefix);
+  KeyCodec::AppendInt64(result, partition_id);
 }
 
 void VectorCodec::EncodeVectorKey(char prefix, int64_t partition_id, int64_t vector_id, std::string& result) {
@@ -52,12 +50,11 @@ void VectorCodec::EncodeVectorKey(char prefix, int64_t partition_id, int64_t vec
                      << vector_id << "]";
   }
 
-  // Buf buf(17);
-  Buf buf(Constant::kVectorKeyMaxLenWithPrefix);
-  buf.Write(prefix);
-  buf.WriteLong(partition_id);
-  DingoSchema<std::optional<int64_t>>::InternalEncodeKey(&buf, vector_id);
-  buf.GetBytes(result);
+  result.clear();
+  result.reserve(Constant::kVectorKeyMaxLenWithPrefix);
+  result.push_back(prefix);
+  KeyCodec::AppendInt64(result, partition_id);
+  KeyCodec::AppendComparableInt64(result, vector_id);
 }
 
 void VectorCodec::EncodeVectorKey(char prefix, int64_t partition_id, int64_t vector_id, const std::string& scalar_key,
@@ -72,19 +69,17 @@ void VectorCodec::EncodeVectorKey(char prefix, int64_t partition_id, int64_t vec
                      << partition_id << "], vector_id:[" << vector_id << "]";
   }
 
-  // Buf buf(17 +  scalar_key.size());
-  Buf buf(Constant::kVectorKeyMaxLenWithPrefix + scalar_key.size());
-  buf.Write(prefix);
-  buf.WriteLong(partition_id);
-  DingoSchema<std::optional<int64_t>>::InternalEncodeKey(&buf, vector_id);
-  buf.Write(scalar_key);
-  buf.GetBytes(result);
+  result.clear();
+  result.reserve(Constant::kVectorKeyMaxLenWithPrefix + scalar_key.size());
+  result.push_back(prefix);
+  KeyCodec::AppendInt64(result, partition_id);
+  KeyCodec::AppendComparableInt64(result, vector_id);
+  result.append(scalar_key);
 }
 
 int64_t VectorCodec::DecodeVectorId(const std::string& value) {
-  Buf buf(value);
   if (value.size() >= Constant::kVectorKeyMaxLenWithPrefix) {
-    buf.Skip(9);
+    return KeyCodec::DecodeComparableInt64(value.data() + Constant::kVectorKeyMinLenWithPrefix);
   } else if (value.size() == Constant::kVectorKeyMinLenWithPrefix) {
     return 0;
   } else {
@@ -92,31 +87,28 @@ int64_t VectorCodec::DecodeVectorId(const std::string& value) {
                      << "]";
     return 0;
   }
-
-  // return buf.ReadLong();
-  return DingoSchema<std::optional<int64_t>>::InternalDecodeKey(&buf);
 }
 
 int64_t VectorCodec::DecodePartitionId(const std::string& value) {
-  Buf buf(value);
-
   if (value.size() >= Constant::kVectorKeyMaxLenWithPrefix || value.size() == Constant::kVectorKeyMinLenWithPrefix) {
-    buf.Skip(1);
+    return KeyCodec::DecodeInt64(value.data() + 1);
+  }
+
+  if (BAIDU_UNLIKELY(value.size() < 8)) {
+    DINGO_LOG(ERROR) << "Decode partition id failed, value size < 8, value:[" << Helper::StringToHex(value) << "]";
+    return 0;
   }
 
-  return buf.ReadLong();
+  return KeyCodec::DecodeInt64(value.data());
 }
 
 std::string VectorCodec::DecodeScalarKey(const std::string& value) {
-  Buf buf(value);
   if (value.size() <= Constant::kVectorKeyMaxLenWithPrefix) {
     DINGO_LOG(FATAL) << "Decode scalar key failed, value size <=17, value:[" << Helper::StringToHex(value) << "]";
     return "";
   }
 
-  buf.Skip(Constant::kVectorKeyMaxLenWithPrefix);
-
-  return buf.ReadString();
+  return value.substr(Constant::kVectorKeyMaxLenWithPrefix);
 }
 
 std::string VectorCodec::DecodeKeyToString(const std::string& key) {
@@ -0,0 +1,75 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "vector/multi_vector.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "common/helper.h"
+#include "gflags/gflags.h"
+#include "simd/hook.h"
+
+namespace dingodb {
+
+DEFINE_string(vector_multi_vector_index_ids, "", "comma separated index ids which are multi vector index");
+DEFINE_int32(vector_multi_vector_token_bits, 8, "low bits of vector id for token index of multi vector document");
+
+int32_t MultiVector::TokenBits(int64_t index_id) {
+  if (FLAGS_vector_multi_vector_index_ids.empty()) {
+    return 0;
+  }
+
+  std::vector<int64_t> index_ids;
+  Helper::SplitString(FLAGS_vector_multi_vector_index_ids, ',', index_ids);
+  if (std::find(index_ids.begin(), index_ids.end(), index_id) == index_ids.end()) {
+    return 0;
+  }
+
+  return std::clamp(FLAGS_vector_multi_vector_token_bits, 0, 32);
+}
+
+float MultiVector::MaxSimDistance(const float* query_values, size_t query_count, const float* token_values,
+                                  size_t token_count, int32_t dimension, pb::common::MetricType metric_type,
+                                  std::vector<float>& distances) {
+  if (query_count == 0 || token_count == 0) {
+    return std::numeric_limits<float>::max();
+  }
+
+  distances.resize(query_count * token_count);
+
+  bool is_ip = metric_type == pb::common::MetricType::METRIC_TYPE_INNER_PRODUCT ||
+               metric_type == pb::common::MetricType::METRIC_TYPE_COSINE;
+  if (is_ip) {
+    fvec_inner_products_nx_ny(distances.data(), query_values, token_values, dimension, query_count, token_count);
+  } else {
+    fvec_L2sqr_nx_ny(distances.data(), query_values, token_values, dimension, query_count, token_count);
+  }
+
+  float sum = 0.0F;
+  for (size_t i = 0; i < query_count; ++i) {
+    const float* row = distances.data() + i * token_count;
+    if (is_ip) {
+      sum += 1.0F - *std::max_element(row, row + token_count);
+    } else {
+      sum += *std::min_element(row, row + token_count);
+    }
+  }
+
+  return sum;
+}
+
+}  // namespace dingodb
@@ -0,0 +1,51 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_VECTOR_MULTI_VECTOR_H_
+#define DINGODB_VECTOR_MULTI_VECTOR_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "proto/common.pb.h"
+
+namespace dingodb {
+
+// Multi vector (late interaction) index mode.
+// A document has several token vectors, its token i is stored as vector id (document_id << token_bits) | i, so all
+// tokens of a document are adjacent in the vector data cf. The query tokens of one search request are scored
+// together against each document by MaxSim and the request gets one aggregated topk of document ids.
+// Indexes in this mode are listed by vector_multi_vector_index_ids.
+class MultiVector {
+ public:
+  // token bits of the index, 0 means single vector index
+  static int32_t TokenBits(int64_t index_id);
+
+  static int64_t DocumentId(int64_t vector_id, int32_t token_bits) { return vector_id >> token_bits; }
+  // [begin, end) vector id of document tokens
+  static int64_t BeginVectorId(int64_t document_id, int32_t token_bits) { return document_id << token_bits; }
+  static int64_t EndVectorId(int64_t document_id, int32_t token_bits) { return (document_id + 1) << token_bits; }
+
+  // Late interaction distance, sum over the query tokens of the distance to the nearest document token.
+  // Distance of a token pair follows VectorIndexUtils::FillSearchResult, so smaller is better, for inner product it
+  // equals query_count - MaxSim score. Values are row major, cosine ones must be normalized.
+  static float MaxSimDistance(const float* query_values, size_t query_count, const float* token_values,
+                              size_t token_count, int32_t dimension, pb::common::MetricType metric_type,
+                              std::vector<float>& distances);
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_VECTOR_MULTI_VECTOR_H_
@@ -0,0 +1,208 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "vector/vector_id_bitmap.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+namespace dingodb {
+
+static inline int64_t HighBits(int64_t vector_id) { return vector_id >> 16; }
+static inline uint16_t LowBits(int64_t vector_id) { return static_cast<uint16_t>(vector_id & 0xFFFF); }
+
+bool VectorIdBitmap::Container::Contains(uint16_t low) const {
+  if (IsBitset()) {
+    return (bitset[low >> 6] >> (low & 63)) & 1;
+  }
+  return std::binary_search(array.begin(), array.end(), low);
+}
+
+void VectorIdBitmap::Container::Add(uint16_t low) {
+  if (IsBitset()) {
+    uint64_t mask = 1ULL << (low & 63);
+    if ((bitset[low >> 6] & mask) == 0) {
+      bitset[low >> 6] |= mask;
+      ++cardinality;
+    }
+    return;
+  }
+
+  auto it = std::lower_bound(array.begin(), array.end(), low);
+  if (it != array.end() && *it == low) {
+    return;
+  }
+  array.insert(it, low);
+  ++cardinality;
+
+  if (cardinality > kArrayMaxSize) {
+    ToBitset();
+  }
+}
+
+void VectorIdBitmap::Container::Remove(uint16_t low) {
+  if (IsBitset()) {
+    uint64_t mask = 1ULL << (low & 63);
+    if ((bitset[low >> 6] & mask) != 0) {
+      bitset[low >> 6] &= ~mask;
+      --cardinality;
+    }
+    if (cardinality < kArrayMaxSize / 2) {
+      ToArray();
+    }
+    return;
+  }
+
+  auto it = std::lower_bound(array.begin(), array.end(), low);
+  if (it != array.end() && *it == low) {
+    array.erase(it);
+    --cardinality;
+  }
+}
+
+void VectorIdBitmap::Container::And(const Container& other) {
+  if (IsBitset() && other.IsBitset()) {
+    cardinality = 0;
+    for (uint32_t i = 0; i < kBitsetWords; ++i) {
+      bitset[i] &= other.bitset[i];
+      cardinality += __builtin_popcountll(bitset[i]);
+    }
+    if (cardinality < kArrayMaxSize / 2) {
+      ToArray();
+    }
+    return;
+  }
+
+  if (IsBitset()) {
+    // other is array, result is at most other's cardinality
+    std::vector<uint16_t> result;
+    result.reserve(other.array.size());
+    for (auto low : other.array) {
+      if (Contains(low)) {
+        result.push_back(low);
+      }
+    }
+    bitset.clear();
+    bitset.shrink_to_fit();
+    array.swap(result);
+    cardinality = array.size();
+    return;
+  }
+
+  auto new_end =
+      std::remove_if(array.begin(), array.end(), [&other](uint16_t low) { return !other.Contains(low); });
+  array.erase(new_end, array.end());
+  cardinality = array.size();
+}
+
+void VectorIdBitmap::Container::ToBitset() {
+  bitset.assign(kBitsetWords, 0);
+  for (auto low : array) {
+    bitset[low >> 6] |= 1ULL << (low & 63);
+  }
+  array.clear();
+  array.shrink_to_fit();
+}
+
+void VectorIdBitmap::Container::ToArray() {
+  array.clear();
+  array.reserve(cardinality);
+  for (uint32_t i = 0; i < kBitsetWords; ++i) {
+    uint64_t word = bitset[i];
+    while (word != 0) {
+      array.push_back(static_cast<uint16_t>(i * 64 + __builtin_ctzll(word)));
+      word &= word - 1;
+    }
+  }
+  bitset.clear();
+  bitset.shrink_to_fit();
+}
+
+void VectorIdBitmap::Add(int64_t vector_id) { containers_[HighBits(vector_id)].Add(LowBits(vector_id)); }
+
+void VectorIdBitmap::Remove(int64_t vector_id) {
+  auto it = containers_.find(HighBits(vector_id));
+  if (it == containers_.end()) {
+    return;
+  }
+
+  it->second.Remove(LowBits(vector_id));
+  if (it->second.cardinality == 0) {
+    containers_.erase(it);
+  }
+}
+
+bool VectorIdBitmap::Contains(int64_t vector_id) const {
+  auto it = containers_.find(HighBits(vector_id));
+  return it != containers_.end() && it->second.Contains(LowBits(vector_id));
+}
+
+void VectorIdBitmap::And(const VectorIdBitmap& other) {
+  for (auto it = containers_.begin(); it != containers_.end();) {
+    auto other_it = other.containers_.find(it->first);
+    if (other_it == other.containers_.end()) {
+      it = containers_.erase(it);
+      continue;
+    }
+
+    it->second.And(other_it->second);
+    if (it->second.cardinality == 0) {
+      it = containers_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+int64_t VectorIdBitmap::Cardinality() const {
+  int64_t count = 0;
+  for (const auto& [_, container] : containers_) {
+    count += container.cardinality;
+  }
+  return count;
+}
+
+int64_t VectorIdBitmap::MemorySize() const {
+  int64_t size = sizeof(VectorIdBitmap);
+  for (const auto& [_, container] : containers_) {
+    size += sizeof(int64_t) + sizeof(Container) + container.array.capacity() * sizeof(uint16_t) +
+            container.bitset.capacity() * sizeof(uint64_t);
+  }
+  return size;
+}
+
+std::vector<int64_t> VectorIdBitmap::ToVector() const {
+  std::vector<int64_t> vector_ids;
+  vector_ids.reserve(Cardinality());
+  for (const auto& [high, container] : containers_) {
+    int64_t base = high << 16;
+    if (container.IsBitset()) {
+      for (uint32_t i = 0; i < kBitsetWords; ++i) {
+        uint64_t word = container.bitset[i];
+        while (word != 0) {
+          vector_ids.push_back(base + i * 64 + __builtin_ctzll(word));
+          word &= word - 1;
+        }
+      }
+    } else {
+      for (auto low : container.array) {
+        vector_ids.push_back(base + low);
+      }
+    }
+  }
+  return vector_ids;
+}
+
+}  // namespace dingodb
@@ -0,0 +1,77 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_VECTOR_ID_BITMAP_H_
+#define DINGODB_VECTOR_ID_BITMAP_H_
+
+#include <cstdint>
+#include <map>
+#include <vector>
+
+namespace dingodb {
+
+// Compressed bitmap of vector ids, roaring style.
+// Ids are partitioned by the high 48 bits, each partition holds the low 16 bits in a container,
+// a sorted array while sparse and a 65536 bits bitset while dense.
+// Not thread safe, the owner must protect it.
+class VectorIdBitmap {
+ public:
+  VectorIdBitmap() = default;
+  ~VectorIdBitmap() = default;
+
+  VectorIdBitmap(const VectorIdBitmap& rhs) = default;
+  VectorIdBitmap& operator=(const VectorIdBitmap& rhs) = default;
+  VectorIdBitmap(VectorIdBitmap&& rhs) = default;
+  VectorIdBitmap& operator=(VectorIdBitmap&& rhs) = default;
+
+  void Add(int64_t vector_id);
+  void Remove(int64_t vector_id);
+  bool Contains(int64_t vector_id) const;
+
+  // Intersect with other in place.
+  void And(const VectorIdBitmap& other);
+
+  bool Empty() const { return containers_.empty(); }
+  int64_t Cardinality() const;
+  int64_t MemorySize() const;
+
+  // Ascending vector ids.
+  std::vector<int64_t> ToVector() const;
+
+  // Containers switch to bitset above this cardinality, and switch back below half of it.
+  static constexpr uint32_t kArrayMaxSize = 4096;
+
+ private:
+  static constexpr uint32_t kBitsetWords = 65536 / 64;
+
+  struct Container {
+    std::vector<uint16_t> array;
+    std::vector<uint64_t> bitset;
+    uint32_t cardinality{0};
+
+    bool IsBitset() const { return !bitset.empty(); }
+    bool Contains(uint16_t low) const;
+    void Add(uint16_t low);
+    void Remove(uint16_t low);
+    void And(const Container& other);
+    void ToBitset();
+    void ToArray();
+  };
+
+  std::map<int64_t, Container> containers_;
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_VECTOR_ID_BITMAP_H_
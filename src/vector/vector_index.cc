@@ -14,6 +14,7 @@
 
 #include "vector/vector_index.h"
 
+#include <algorithm>
 #include <cassert>
 #include <cstdint>
 #include <memory>
@@ -52,6 +53,14 @@ DEFINE_uint32(ivf_vector_write_batch_size_per_task, 256, "ivf vector write batch
 DEFINE_uint32(vector_read_batch_size_per_task, 1, "vector read batch size per task");
 
 DEFINE_uint32(parallel_log_threshold_time_ms, 5000, "parallel log elapsed time");
+DEFINE_bool(enable_vector_index_split_lazy_rebuild, false,
+            "parent region keep its vector index after split and search it with range filter, rebuild it by scrub");
+DEFINE_int32(vector_follower_hold_index_num, -1,
+             "when follower hold index, only the first num peers order by store id hold it as follower, "
+             "the others keep raft log and data only, -1 means all followers");
+DEFINE_bool(enable_vector_index_event_scrub, false,
+            "scrub the vector indexes marked dirty by write instead of sweeping all the vector indexes");
+DEFINE_int64(vector_index_event_scrub_write_key_num, 1000, "write key num to mark vector index dirty for scrub");
 
 // split VectorWithId set to multi batch
 static void SplitVectorWithId(const std::vector<pb::common::VectorWithId>& vector_with_ids, int batch_size,
@@ -75,8 +84,9 @@ butil::Status ParallelRun(ThreadPoolPtr thread_pool, int64_t vector_index_id,
   uint64_t start_time = Helper::TimestampMs();
   std::vector<ThreadPool::TaskPtr> tasks;
   for (uint32_t i = 0; i < vector_with_id_batchs.size(); ++i) {
-    auto task = thread_pool->ExecuteTask([&, i](void*) { statuses[i] = fn(vector_with_id_batchs[i], i); }, nullptr,
-                                         is_priority ? 1 : 0);
+    auto task = thread_pool->ExecuteTaskByNumaNode(
+        vector_index_id, [&, i](void*) { statuses[i] = fn(vector_with_id_batchs[i], i); }, nullptr,
+        is_priority ? 1 : 0);
 
     if (task != nullptr) {
       tasks.push_back(task);
@@ -155,6 +165,9 @@ void VectorIndex::SetSimdHookForFaiss() {
   DINGO_LOG(INFO) << fmt::format("cpu_support_avx512 : {} cpu_support_avx2 : {} cpu_support_sse4_2 : {}",
                                  cpu_support_avx512() ? "true" : "false", cpu_support_avx2() ? "true" : "false",
                                  cpu_support_sse4_2() ? "true" : "false");
+#elif defined(__aarch64__)
+  DINGO_LOG(INFO) << fmt::format("cpu_support_sve : {} cpu_support_neon : {}", cpu_support_sve() ? "true" : "false",
+                                 cpu_support_neon() ? "true" : "false");
 #endif
   DINGO_LOG(INFO) << fmt::format("cpu simd_type : {}", simd_type);
   faiss::set_fvec_L2sqr_hook(fvec_L2sqr);
@@ -172,6 +185,9 @@ void VectorIndex::SetSimdHookForHnswlib() {
   DINGO_LOG(INFO) << fmt::format("cpu_support_avx512 : {} cpu_support_avx2 : {} cpu_support_sse4_2 : {}",
                                  cpu_support_avx512() ? "true" : "false", cpu_support_avx2() ? "true" : "false",
                                  cpu_support_sse4_2() ? "true" : "false");
+#elif defined(__aarch64__)
+  DINGO_LOG(INFO) << fmt::format("cpu_support_sve : {} cpu_support_neon : {}", cpu_support_sve() ? "true" : "false",
+                                 cpu_support_neon() ? "true" : "false");
 #endif
   DINGO_LOG(INFO) << fmt::format("cpu simd_type : {}", simd_type);
   hnswlib::set_fvec_L2sqr_hook(fvec_L2sqr);
@@ -239,10 +255,16 @@ butil::Status VectorIndex::SearchByParallel(const std::vector<pb::common::Vector
                                             const std::vector<std::shared_ptr<FilterFunctor>>& filters,
                                             bool reconstruct, const pb::common::VectorSearchParameter& parameter,
                                             std::vector<pb::index::VectorWithDistanceResult>& results) {
-  if (VectorIndexType() == pb::common::VECTOR_INDEX_TYPE_HNSW) {
+  if (IsSearchParallelInner()) {
     // parallel in inner
     return Search(vector_with_ids, topk, filters, reconstruct, parameter, results);
   } else {
+    // few queries, parallel over index data
+    auto status = SearchByChunk(vector_with_ids, topk, filters, results);
+    if (status.error_code() != pb::error::EVECTOR_NOT_SUPPORT) {
+      return status;
+    }
+
     // parallel in here
     results.resize(vector_with_ids.size());
 
@@ -264,6 +286,13 @@ butil::Status VectorIndex::SearchByParallel(const std::vector<pb::common::Vector
   }
 }
 
+butil::Status VectorIndex::SearchByChunk(const std::vector<pb::common::VectorWithId>& /*vector_with_ids*/,
+                                         uint32_t /*topk*/,
+                                         const std::vector<std::shared_ptr<FilterFunctor>>& /*filters*/,
+                                         std::vector<pb::index::VectorWithDistanceResult>& /*results*/) {
+  return butil::Status(pb::error::Errno::EVECTOR_NOT_SUPPORT, "this vector index do not implement search by chunk");
+}
+
 butil::Status VectorIndex::RangeSearchByParallel(
     const std::vector<pb::common::VectorWithId>& vector_with_ids, float radius,
     const std::vector<std::shared_ptr<VectorIndex::FilterFunctor>>& filters, bool reconstruct,
@@ -300,7 +329,7 @@ butil::Status VectorIndex::TrainByParallel(std::vector<float>& train_datas) {
                                  train_datas.size());
 
   uint64_t start_time = Helper::TimestampMs();
-  auto task = thread_pool->ExecuteTask([&](void*) { status = Train(train_datas); }, nullptr, 0);
+  auto task = thread_pool->ExecuteTaskByNumaNode(Id(), [&](void*) { status = Train(train_datas); }, nullptr, 0);
 
   task->Join();
 
@@ -349,6 +378,7 @@ VectorIndexWrapper::VectorIndexWrapper(int64_t id, pb::common::VectorIndexParame
       saving_num_(0),
       save_snapshot_threshold_write_key_num_(save_snapshot_threshold_write_key_num) {
   snapshot_set_ = vector_index::SnapshotMetaSet::New(id, VectorIndexSnapshotManager::GetSnapshotParentPath(id));
+  scalar_bitmap_index_ = VectorScalarBitmapIndex::New(id);
   bthread_mutex_init(&vector_index_mutex_, nullptr);
   DINGO_LOG(DEBUG) << fmt::format("[new.VectorIndexWrapper][id({})]", id_);
 }
@@ -589,6 +619,11 @@ void VectorIndexWrapper::UpdateVectorIndex(VectorIndexPtr vector_index, const st
     ++version_;
 
     ready_.store(true);
+    is_evicted_.store(false);
+    Touch();
+
+    // region data may be replaced, e.g. install snapshot, rebuild bitmaps on next search
+    scalar_bitmap_index_->Reset();
 
     int64_t apply_log_id = ApplyLogId();
     int64_t snapshot_log_id = SnapshotLogId();
@@ -607,6 +642,21 @@ void VectorIndexWrapper::UpdateVectorIndex(VectorIndexPtr vector_index, const st
   }
 }
 
+void VectorIndexWrapper::Evict() {
+  DINGO_LOG(INFO) << fmt::format("[vector_index.wrapper][index_id({})] evict vector index, last access time({}).",
+                                 Id(), Helper::FormatMsTime(LastAccessTimeMs()));
+  ClearVectorIndex("evict");
+  is_evicted_.store(true);
+}
+
+static butil::Status ReloadEvictedVectorIndex(VectorIndexWrapperPtr vector_index_wrapper) {
+  DINGO_LOG(INFO) << fmt::format("[vector_index.wrapper][index_id({})] reload evicted vector index.",
+                                 vector_index_wrapper->Id());
+  VectorIndexManager::LaunchLoadAsyncBuildVectorIndex(vector_index_wrapper, false, false, 0, "reload evicted");
+  return butil::Status(pb::error::EVECTOR_INDEX_NOT_FOUND, "vector index %ld is evicted and reloading.",
+                       vector_index_wrapper->Id());
+}
+
 void VectorIndexWrapper::ClearVectorIndex(const std::string& trace) {
   DINGO_LOG(INFO) << fmt::format("[vector_index.wrapper][index_id({})][trace({})] Clear all vector index", Id(), trace);
 
@@ -616,6 +666,8 @@ void VectorIndexWrapper::ClearVectorIndex(const std::string& trace) {
   vector_index_ = nullptr;
   share_vector_index_ = nullptr;
   sibling_vector_index_ = nullptr;
+
+  scalar_bitmap_index_->Reset();
 }
 
 VectorIndexPtr VectorIndexWrapper::GetOwnVectorIndex() {
@@ -682,6 +734,41 @@ int32_t VectorIndexWrapper::GetDimension() {
   return vector_index->GetDimension();
 }
 
+void VectorIndexWrapper::UpdatePostFilterPassRate(float pass_rate) {
+  // racy update is fine, it is only an estimate
+  float old_pass_rate = post_filter_pass_rate_.load(std::memory_order_relaxed);
+  post_filter_pass_rate_.store(old_pass_rate * 0.8F + pass_rate * 0.2F, std::memory_order_relaxed);
+}
+
+void VectorIndexWrapper::ApplyTunedSearchParam(pb::common::VectorIndexType type, int32_t value,
+                                               pb::common::VectorSearchParameter& parameter) {
+  if (value <= 0) {
+    return;
+  }
+
+  if (type == pb::common::VECTOR_INDEX_TYPE_HNSW) {
+    if (parameter.hnsw().efsearch() == 0) {
+      parameter.mutable_hnsw()->set_efsearch(value);
+    }
+  } else if (type == pb::common::VECTOR_INDEX_TYPE_IVF_FLAT) {
+    if (parameter.ivf_flat().nprobe() == 0) {
+      parameter.mutable_ivf_flat()->set_nprobe(value);
+    }
+  } else if (type == pb::common::VECTOR_INDEX_TYPE_IVF_PQ) {
+    if (parameter.ivf_pq().nprobe() == 0) {
+      parameter.mutable_ivf_pq()->set_nprobe(value);
+    }
+  }
+}
+
+uint32_t VectorIndexWrapper::RerankMultiple() {
+  auto vector_index = GetVectorIndex();
+  if (vector_index == nullptr) {
+    return 0;
+  }
+  return vector_index->RerankMultiple();
+}
+
 pb::common::MetricType VectorIndexWrapper::GetMetricType() {
   auto vector_index = GetVectorIndex();
   if (vector_index == nullptr) {
@@ -789,6 +876,14 @@ bool VectorIndexWrapper::NeedToRebuild() {
     return false;
   }
 
+  // Parent region keep the wider vector index after split, rebuild it to drop the vectors of child.
+  if (FLAGS_enable_vector_index_split_lazy_rebuild && !Helper::InvalidRange(vector_index->Range())) {
+    auto region = Server::GetInstance().GetRegion(Id());
+    if (region != nullptr && !Helper::IsContainRange(region->Range(), vector_index->Range())) {
+      return true;
+    }
+  }
+
   return vector_index->NeedToRebuild();
 }
 
@@ -842,6 +937,21 @@ bool VectorIndexWrapper::NeedToSave(std::string& reason) {
   return false;
 }
 
+DirtyIndexQueue& VectorIndexWrapper::ScrubQueue() {
+  static DirtyIndexQueue queue;
+  return queue;
+}
+
+void VectorIndexWrapper::MarkScrubDirty() {
+  if (!FLAGS_enable_vector_index_event_scrub ||
+      write_key_count_ - last_scrub_write_key_count_ < FLAGS_vector_index_event_scrub_write_key_num) {
+    return;
+  }
+
+  last_scrub_write_key_count_ = write_key_count_;
+  ScrubQueue().Mark(Id(), write_key_count_ - last_save_write_key_count_);
+}
+
 // Filter vector id by range
 static std::vector<int64_t> FilterVectorId(const std::vector<pb::common::VectorWithId>& vector_with_ids,
                                            const pb::common::Range& range) {
@@ -932,6 +1042,7 @@ butil::Status VectorIndexWrapper::Add(const std::vector<pb::common::VectorWithId
     }
 
     write_key_count_ += vector_with_ids.size();
+    MarkScrubDirty();
 
     return status;
   }
@@ -939,6 +1050,7 @@ butil::Status VectorIndexWrapper::Add(const std::vector<pb::common::VectorWithId
   auto status = vector_index->AddByParallel(vector_with_ids);
   if (status.ok()) {
     write_key_count_ += vector_with_ids.size();
+    MarkScrubDirty();
   }
   return status;
 }
@@ -979,6 +1091,7 @@ butil::Status VectorIndexWrapper::Upsert(const std::vector<pb::common::VectorWit
     }
 
     write_key_count_ += vector_with_ids.size();
+    MarkScrubDirty();
 
     return status;
   }
@@ -986,6 +1099,7 @@ butil::Status VectorIndexWrapper::Upsert(const std::vector<pb::common::VectorWit
   auto status = vector_index->UpsertByParallel(vector_with_ids);
   if (status.ok()) {
     write_key_count_ += vector_with_ids.size();
+    MarkScrubDirty();
   }
   return status;
 }
@@ -1022,6 +1136,7 @@ butil::Status VectorIndexWrapper::Delete(const std::vector<int64_t>& delete_ids)
     status = vector_index->DeleteByParallel(FilterVectorId(delete_ids, vector_index->Range()), true);
     if (status.ok()) {
       write_key_count_ += delete_ids.size();
+      MarkScrubDirty();
     }
     return status;
   }
@@ -1029,6 +1144,7 @@ butil::Status VectorIndexWrapper::Delete(const std::vector<int64_t>& delete_ids)
   auto status = vector_index->DeleteByParallel(delete_ids, true);
   if (status.ok()) {
     write_key_count_ += delete_ids.size();
+    MarkScrubDirty();
   }
   return status;
 }
@@ -1092,7 +1208,11 @@ butil::Status VectorIndexWrapper::Search(std::vector<pb::common::VectorWithId> v
                                          std::vector<std::shared_ptr<VectorIndex::FilterFunctor>>& filters,
                                          bool reconstruct, const pb::common::VectorSearchParameter& parameter,
                                          std::vector<pb::index::VectorWithDistanceResult>& results) {
+  Touch();
   if (!IsReady()) {
+    if (is_evicted_.exchange(false)) {
+      return ReloadEvictedVectorIndex(GetSelf());
+    }
     DINGO_LOG(WARNING) << fmt::format("[vector_index.wrapper][index_id({})] vector index is not ready.", Id());
     return butil::Status(pb::error::EVECTOR_INDEX_NOT_FOUND, "vector index %lu is not ready.", Id());
   }
@@ -1102,18 +1222,26 @@ butil::Status VectorIndexWrapper::Search(std::vector<pb::common::VectorWithId> v
     return butil::Status(pb::error::EVECTOR_INDEX_NOT_FOUND, "vector index %lu is not ready.", Id());
   }
 
+  int32_t tuned_search_param = TunedSearchParam();
+  pb::common::VectorSearchParameter tuned_parameter;
+  if (tuned_search_param > 0) {
+    tuned_parameter = parameter;
+    ApplyTunedSearchParam(Type(), tuned_search_param, tuned_parameter);
+  }
+  const auto& search_parameter = tuned_search_param > 0 ? tuned_parameter : parameter;
+
   // Exist sibling vector index, so need to separate search vector.
   auto sibling_vector_index = SiblingVectorIndex();
   if (sibling_vector_index != nullptr) {
     std::vector<pb::index::VectorWithDistanceResult> results_1;
-    auto status =
-        sibling_vector_index->SearchByParallel(vector_with_ids, topk, filters, reconstruct, parameter, results_1);
+    auto status = sibling_vector_index->SearchByParallel(vector_with_ids, topk, filters, reconstruct,
+                                                         search_parameter, results_1);
     if (!status.ok()) {
       return status;
     }
 
     std::vector<pb::index::VectorWithDistanceResult> results_2;
-    status = vector_index->SearchByParallel(vector_with_ids, topk, filters, reconstruct, parameter, results_2);
+    status = vector_index->SearchByParallel(vector_with_ids, topk, filters, reconstruct, search_parameter, results_2);
     if (!status.ok()) {
       return status;
     }
@@ -1134,7 +1262,7 @@ butil::Status VectorIndexWrapper::Search(std::vector<pb::common::VectorWithId> v
     }
   }
 
-  return vector_index->SearchByParallel(vector_with_ids, topk, filters, reconstruct, parameter, results);
+  return vector_index->SearchByParallel(vector_with_ids, topk, filters, reconstruct, search_parameter, results);
 }
 
 static void MergeRangeSearchResults(std::vector<pb::index::VectorWithDistanceResult>& input_1,
@@ -1153,7 +1281,11 @@ butil::Status VectorIndexWrapper::RangeSearch(std::vector<pb::common::VectorWith
                                               std::vector<std::shared_ptr<VectorIndex::FilterFunctor>> filters,
                                               bool reconstruct, const pb::common::VectorSearchParameter& parameter,
                                               std::vector<pb::index::VectorWithDistanceResult>& results) {
+  Touch();
   if (!IsReady()) {
+    if (is_evicted_.exchange(false)) {
+      return ReloadEvictedVectorIndex(GetSelf());
+    }
     DINGO_LOG(WARNING) << fmt::format("[vector_index.wrapper][index_id({})] vector index is not ready.", Id());
     return butil::Status(pb::error::EVECTOR_INDEX_NOT_FOUND, "vector index %lu is not ready.", Id());
   }
@@ -1213,6 +1345,15 @@ bool VectorIndexWrapper::IsPermanentHoldVectorIndex(store::RegionPtr region) {
     if (!Server::GetInstance().IsLeader(region->Id())) {
       return false;
     }
+  } else if (FLAGS_vector_follower_hold_index_num >= 0 && !Server::GetInstance().IsLeader(region->Id())) {
+    // The rank doesn't depend on leader, so the index replicas keep stable on leader change.
+    std::vector<int64_t> store_ids;
+    for (const auto& peer : region->Peers()) {
+      store_ids.push_back(peer.store_id());
+    }
+    std::sort(store_ids.begin(), store_ids.end());
+    auto it = std::find(store_ids.begin(), store_ids.end(), Server::GetInstance().Id());
+    return it != store_ids.end() && (it - store_ids.begin()) < FLAGS_vector_follower_hold_index_num;
   }
 
   return true;
@@ -15,17 +15,20 @@
 #ifndef DINGODB_VECTOR_INDEX_H_
 #define DINGODB_VECTOR_INDEX_H_
 
+#include <algorithm>
 #include <atomic>
 #include <cstddef>
 #include <cstdint>
 #include <memory>
 #include <string>
 #include <unordered_set>
+#include <utility>
 #include <vector>
 
 #include "bthread/types.h"
 #include "butil/compiler_specific.h"
 #include "butil/status.h"
+#include "common/dirty_index_queue.h"
 #include "common/helper.h"
 #include "common/runnable.h"
 #include "common/threadpool.h"
@@ -34,7 +37,9 @@
 #include "fmt/core.h"
 #include "proto/common.pb.h"
 #include "proto/index.pb.h"
+#include "vector/vector_id_bitmap.h"
 #include "vector/vector_index_snapshot.h"
+#include "vector/vector_scalar_bitmap_index.h"
 
 namespace dingodb {
 
@@ -62,6 +67,11 @@ class VectorIndex {
     virtual ~FilterFunctor() = default;
     virtual void Build(std::vector<faiss::idx_t>& id_map) {}
     virtual bool Check(int64_t vector_id) = 0;
+
+    // Count of vector ids passing the filter, -1 means unknown, e.g. range or negation filter.
+    virtual int64_t CandidateCount() { return -1; }
+    // Vector ids passing the filter, only valid when CandidateCount() >= 0.
+    virtual void GetCandidateIds(std::vector<int64_t>& /*vector_ids*/) {}
   };
 
   // Range filter
@@ -93,10 +103,31 @@ class VectorIndex {
       return !is_negation_ ? exist : !exist;
     }
 
+    int64_t CandidateCount() override { return is_negation_ ? -1 : static_cast<int64_t>(set.size()); }
+    void GetCandidateIds(std::vector<int64_t>& vector_ids) override {
+      vector_ids.assign(set.begin(), set.end());
+      std::sort(vector_ids.begin(), vector_ids.end());
+    }
+
    private:
     bool is_negation_{false};
   };
 
+  // vector id bitmap, e.g. from scalar bitmap index.
+  class BitmapFilterFunctor : public FilterFunctor {
+   public:
+    explicit BitmapFilterFunctor(std::shared_ptr<VectorIdBitmap> bitmap) : bitmap_(std::move(bitmap)) {}
+    ~BitmapFilterFunctor() override = default;
+
+    bool Check(int64_t vector_id) override { return bitmap_->Contains(vector_id); }
+
+    int64_t CandidateCount() override { return bitmap_->Cardinality(); }
+    void GetCandidateIds(std::vector<int64_t>& vector_ids) override { vector_ids = bitmap_->ToVector(); }
+
+   private:
+    std::shared_ptr<VectorIdBitmap> bitmap_;
+  };
+
   // sort vector, binary search, performance is great.
   class SortFilterFunctor : public FilterFunctor {
    public:
@@ -116,6 +147,9 @@ class VectorIndex {
       return !is_negation_ ? exist : !exist;
     }
 
+    int64_t CandidateCount() override { return is_negation_ ? -1 : static_cast<int64_t>(vector_ids_.size()); }
+    void GetCandidateIds(std::vector<int64_t>& vector_ids) override { vector_ids = vector_ids_; }
+
    private:
     bool IsExist(int64_t vector_id) const {
       int64_t begin = 0, end = vector_ids_.size() - 1;
@@ -149,6 +183,13 @@ class VectorIndex {
   virtual butil::Status Add(const std::vector<pb::common::VectorWithId>& vector_with_ids, bool is_priority);
   butil::Status AddByParallel(const std::vector<pb::common::VectorWithId>& vector_with_ids, bool is_priority = false);
 
+  // Bulk build a unpublished index, BuildAdd can be called concurrently with disjoint vector ids if
+  // SupportParallelBuild.
+  virtual bool SupportParallelBuild() { return false; }
+  virtual butil::Status BuildAdd(const std::vector<pb::common::VectorWithId>& vector_with_ids) {
+    return AddByParallel(vector_with_ids, false);
+  }
+
   virtual butil::Status Upsert(const std::vector<pb::common::VectorWithId>& vector_with_ids) = 0;
   virtual butil::Status Upsert(const std::vector<pb::common::VectorWithId>& vector_with_ids, bool is_priority);
   butil::Status UpsertByParallel(const std::vector<pb::common::VectorWithId>& vector_with_ids,
@@ -167,6 +208,13 @@ class VectorIndex {
                                const pb::common::VectorSearchParameter& parameter,
                                std::vector<pb::index::VectorWithDistanceResult>& results) = 0;
 
+  // Search few queries by splitting the index data into chunks searched in parallel and merging the per chunk topk,
+  // for index whose search cost is linear in data size, e.g. flat.
+  // Return EVECTOR_NOT_SUPPORT if not applicable, SearchByParallel then splits query rows instead.
+  virtual butil::Status SearchByChunk(const std::vector<pb::common::VectorWithId>& vector_with_ids, uint32_t topk,
+                                      const std::vector<std::shared_ptr<FilterFunctor>>& filters,
+                                      std::vector<pb::index::VectorWithDistanceResult>& results);
+
   butil::Status SearchByParallel(const std::vector<pb::common::VectorWithId>& vector_with_ids, uint32_t topk,
                                  const std::vector<std::shared_ptr<FilterFunctor>>& filters, bool reconstruct,
                                  const pb::common::VectorSearchParameter& parameter,
@@ -192,9 +240,18 @@ class VectorIndex {
   virtual bool IsTrained() { return true; }
   virtual bool NeedToSave(int64_t last_save_log_behind) = 0;
   virtual bool SupportSave() { return false; }
+  // Search batch is parallel inside the index, SearchByParallel will not split it.
+  virtual bool IsSearchParallelInner() { return VectorIndexType() == pb::common::VECTOR_INDEX_TYPE_HNSW; }
 
   virtual uint32_t WriteOpParallelNum() { return 1; }
 
+  // Search topk * multiple candidates from a lossy index and rerank them with raw vectors, 0 means no rerank.
+  virtual uint32_t RerankMultiple() { return 0; }
+
+  // The index holds the exact copy of raw vectors, the vector data of search result is reconstructed from index
+  // instead of reading data cf. The quantized or normalized index returns empty vector data when reconstruct.
+  virtual bool HoldsExactVectors() { return false; }
+
   int64_t Id() const { return id; }
 
   pb::common::VectorIndexType VectorIndexType() { return vector_index_type; }
@@ -336,9 +393,30 @@ class VectorIndexWrapper : public std::enable_shared_from_this<VectorIndexWrappe
     return snapshot_set_;
   }
 
+  VectorScalarBitmapIndexPtr ScalarBitmapIndex() { return scalar_bitmap_index_; }
+
+  // Observed pass rate of scalar post filter, used to estimate search topk.
+  float PostFilterPassRate() { return post_filter_pass_rate_.load(std::memory_order_relaxed); }
+  void UpdatePostFilterPassRate(float pass_rate);
+
+  // Search parameter(hnsw efsearch or ivf nprobe) chosen by auto tune, used when client doesn't specify, 0 means none.
+  int32_t TunedSearchParam() { return tuned_search_param_.load(std::memory_order_relaxed); }
+  void SetTunedSearchParam(int32_t value) { tuned_search_param_.store(value, std::memory_order_relaxed); }
+  int64_t LastTuneTimeMs() { return last_tune_time_ms_.load(std::memory_order_relaxed); }
+  void SetLastTuneTimeMs(int64_t time_ms) { last_tune_time_ms_.store(time_ms, std::memory_order_relaxed); }
+  // Fill the tuned value into the search parameter of vector index type if it is not specified.
+  static void ApplyTunedSearchParam(pb::common::VectorIndexType type, int32_t value,
+                                    pb::common::VectorSearchParameter& parameter);
+
   void UpdateVectorIndex(VectorIndexPtr vector_index, const std::string& trace);
   void ClearVectorIndex(const std::string& trace);
 
+  // Drop the vector index from memory by VectorIndexMemoryManager, the next search reloads it.
+  void Evict();
+  bool IsEvicted() { return is_evicted_.load(); }
+  int64_t LastAccessTimeMs() { return last_access_time_ms_.load(std::memory_order_relaxed); }
+  void Touch() { last_access_time_ms_.store(Helper::TimestampMs(), std::memory_order_relaxed); }
+
   VectorIndexPtr GetOwnVectorIndex();
   VectorIndexPtr GetVectorIndex();
 
@@ -367,6 +445,7 @@ class VectorIndexWrapper : public std::enable_shared_from_this<VectorIndexWrappe
   void DecSavingNum();
 
   int32_t GetDimension();
+  uint32_t RerankMultiple();
   pb::common::MetricType GetMetricType();
   butil::Status GetCount(int64_t& count);
   butil::Status GetDeletedCount(int64_t& deleted_count);
@@ -377,6 +456,9 @@ class VectorIndexWrapper : public std::enable_shared_from_this<VectorIndexWrappe
   bool NeedToSave(std::string& reason);
   bool SupportSave();
 
+  // The dirty vector indexes wait for event driven scrub, priority is the write key count since last save.
+  static DirtyIndexQueue& ScrubQueue();
+
   butil::Status Add(const std::vector<pb::common::VectorWithId>& vector_with_ids);
   butil::Status Upsert(const std::vector<pb::common::VectorWithId>& vector_with_ids);
   butil::Status Delete(const std::vector<int64_t>& delete_ids);
@@ -398,6 +480,9 @@ class VectorIndexWrapper : public std::enable_shared_from_this<VectorIndexWrappe
       int64_t min_vector_id, int64_t max_vector_id);
 
  private:
+  // mark dirty for scrub when the write key count since last mark crosses threshold
+  void MarkScrubDirty();
+
   // vector index id
   int64_t id_;
   // vector index version
@@ -439,6 +524,19 @@ class VectorIndexWrapper : public std::enable_shared_from_this<VectorIndexWrappe
   // Snapshot set
   vector_index::SnapshotMetaSetPtr snapshot_set_;
 
+  // Scalar bitmap index for scalar pre filter
+  VectorScalarBitmapIndexPtr scalar_bitmap_index_;
+
+  // moving average of scalar post filter pass rate
+  std::atomic<float> post_filter_pass_rate_{0.1F};
+
+  std::atomic<int32_t> tuned_search_param_{0};
+
+  // evicted by memory budget, reload at next search
+  std::atomic<bool> is_evicted_{false};
+  std::atomic<int64_t> last_access_time_ms_{0};
+  std::atomic<int64_t> last_tune_time_ms_{0};
+
   std::atomic<int32_t> pending_task_num_;
   // vector index loadorbuilding num
   std::atomic<int32_t> loadorbuilding_num_;
@@ -450,6 +548,8 @@ class VectorIndexWrapper : public std::enable_shared_from_this<VectorIndexWrappe
   // write(add/update/delete) key count
   int64_t write_key_count_{0};
   int64_t last_save_write_key_count_{0};
+  // write key count when last marked dirty for scrub
+  int64_t last_scrub_write_key_count_{0};
   // save snapshot threshold write key num
   int64_t save_snapshot_threshold_write_key_num_;
 
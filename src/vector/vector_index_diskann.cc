@@ -0,0 +1,1221 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "vector/vector_index_diskann.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <random>
+#include <string>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "butil/status.h"
+#include "bvar/latency_recorder.h"
+#include "common/helper.h"
+#include "common/logging.h"
+#include "common/synchronization.h"
+#include "faiss/utils/distances.h"
+#include "fmt/core.h"
+#include "gflags/gflags.h"
+#include "proto/common.pb.h"
+#include "proto/error.pb.h"
+#include "proto/index.pb.h"
+#include "server/server.h"
+#include "vector/vector_index_utils.h"
+
+namespace dingodb {
+
+DEFINE_uint32(vector_index_diskann_build_list_size, 100, "diskann candidate list size of graph build");
+DEFINE_double(vector_index_diskann_build_alpha, 1.2, "diskann robust prune alpha of graph build");
+DEFINE_uint32(vector_index_diskann_search_list_size, 100, "diskann candidate list size of search");
+DEFINE_uint32(vector_index_diskann_beam_width, 4, "diskann nodes read concurrently per search step");
+DEFINE_uint32(vector_index_diskann_pq_sub_dimension, 4, "diskann dimensions per pq sub quantizer");
+DEFINE_uint32(vector_index_diskann_pq_train_count, 65536, "diskann max vector count to train pq");
+DEFINE_int64(vector_index_diskann_compact_threshold, 100000, "diskann delta count to compact into a new segment");
+DEFINE_double(vector_index_diskann_compact_ratio, 0.2,
+              "diskann delta count to segment count ratio to compact, avoid rebuilding large segment frequently");
+DEFINE_int64(diskann_need_save_count, 10000, "diskann need save count");
+
+bvar::LatencyRecorder g_diskann_upsert_latency("dingo_diskann_upsert_latency");
+bvar::LatencyRecorder g_diskann_search_latency("dingo_diskann_search_latency");
+bvar::LatencyRecorder g_diskann_delete_latency("dingo_diskann_delete_latency");
+bvar::LatencyRecorder g_diskann_load_latency("dingo_diskann_load_latency");
+bvar::LatencyRecorder g_diskann_compact_latency("dingo_diskann_compact_latency");
+
+static const char kSegmentMagic[8] = {'D', 'I', 'N', 'G', 'O', 'D', 'A', 'N'};
+static const char kSnapshotMagic[8] = {'D', 'I', 'N', 'G', 'O', 'D', 'A', 'S'};
+static const uint32_t kVersion = 1;
+static const uint64_t kHeaderSize = 4096;
+// pq need at least ksub vectors to train
+static const uint32_t kPqNbits = 8;
+static const uint32_t kPqMinTrainCount = 1 << kPqNbits;
+static const uint32_t kBuildLockStripes = 1 << 16;
+static const size_t kCopyBufferSize = 4 * 1024 * 1024;
+
+struct SegmentHeader {
+  char magic[8];
+  uint32_t version;
+  int32_t metric_type;
+  uint32_t dimension;
+  uint32_t max_degree;
+  uint64_t count;
+  uint32_t medoid;
+  uint32_t pq_m;
+  uint32_t pq_nbits;
+  uint32_t reserved;
+  uint64_t nodes_offset;
+  uint64_t ids_offset;
+  uint64_t pq_offset;
+  uint64_t codes_offset;
+  uint64_t segment_size;
+};
+
+struct SnapshotHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t dimension;
+  uint64_t segment_offset;
+  uint64_t segment_size;
+  uint64_t delta_offset;
+  uint64_t delta_count;
+  uint64_t shadowed_offset;
+  uint64_t shadowed_count;
+};
+
+static_assert(sizeof(SegmentHeader) <= kHeaderSize && sizeof(SnapshotHeader) <= kHeaderSize);
+
+static bool WriteAll(int fd, const void* data, size_t size, uint64_t offset) {
+  const char* p = static_cast<const char*>(data);
+  while (size > 0) {
+    ssize_t n = pwrite(fd, p, size, offset);
+    if (n < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return false;
+    }
+    p += n;
+    size -= n;
+    offset += n;
+  }
+  return true;
+}
+
+static bool ReadAll(int fd, void* data, size_t size, uint64_t offset) {
+  char* p = static_cast<char*>(data);
+  while (size > 0) {
+    ssize_t n = pread(fd, p, size, offset);
+    if (n < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return false;
+    }
+    if (n == 0) {
+      return false;
+    }
+    p += n;
+    size -= n;
+    offset += n;
+  }
+  return true;
+}
+
+// inner product metrics rank by negative inner product, so that smaller is closer for all metrics.
+static inline float Distance(bool is_l2, const float* x, const float* y, uint32_t dimension) {
+  return is_l2 ? faiss::fvec_L2sqr(x, y, dimension) : -faiss::fvec_inner_product(x, y, dimension);
+}
+
+template <typename Function>
+static void ParallelRange(ThreadPoolPtr thread_pool, size_t count, size_t batch_size, Function fn) {
+  if (thread_pool == nullptr) {
+    for (size_t i = 0; i < count; ++i) {
+      fn(i);
+    }
+    return;
+  }
+
+  std::vector<ThreadPool::TaskPtr> tasks;
+  for (size_t start = 0; start < count; start += batch_size) {
+    size_t end = std::min(start + batch_size, count);
+    auto task = thread_pool->ExecuteTask(
+        [&, start, end](void*) {
+          for (size_t i = start; i < end; ++i) {
+            fn(i);
+          }
+        },
+        nullptr);
+    if (task != nullptr) {
+      tasks.push_back(task);
+    } else {
+      for (size_t i = start; i < end; ++i) {
+        fn(i);
+      }
+    }
+  }
+
+  for (auto& task : tasks) {
+    task->Join();
+  }
+}
+
+// Vamana graph construction in memory, always by L2 which is what alpha pruning assumes.
+class VamanaBuilder {
+ public:
+  VamanaBuilder(const float* vectors, size_t count, uint32_t dimension, uint32_t max_degree, uint32_t list_size)
+      : vectors_(vectors),
+        count_(count),
+        dimension_(dimension),
+        max_degree_(max_degree),
+        list_size_(std::max(list_size, max_degree)),
+        graph_(count),
+        locks_(kBuildLockStripes) {}
+
+  void Build(ThreadPoolPtr thread_pool, float alpha) {
+    medoid_ = FindMedoid();
+
+    std::vector<uint32_t> order(count_);
+    std::iota(order.begin(), order.end(), 0);
+    std::shuffle(order.begin(), order.end(), std::mt19937(count_));
+
+    // first pass connects the graph, second pass with alpha adds long range edges.
+    for (float pass_alpha : {1.0F, alpha}) {
+      ParallelRange(thread_pool, count_, 256, [&](size_t i) { Insert(order[i], pass_alpha); });
+    }
+  }
+
+  uint32_t Medoid() const { return medoid_; }
+  const std::vector<uint32_t>& Neighbors(uint32_t node) const { return graph_[node]; }
+
+ private:
+  struct Candidate {
+    float distance;
+    uint32_t node;
+    bool expanded;
+  };
+
+  const float* Vector(uint32_t node) const { return vectors_ + static_cast<size_t>(node) * dimension_; }
+  std::mutex& Lock(uint32_t node) { return locks_[node % kBuildLockStripes]; }
+
+  uint32_t FindMedoid() const {
+    std::vector<float> centroid(dimension_, 0.0F);
+    for (size_t i = 0; i < count_; ++i) {
+      const float* v = Vector(i);
+      for (uint32_t j = 0; j < dimension_; ++j) {
+        centroid[j] += v[j];
+      }
+    }
+    for (auto& value : centroid) {
+      value /= count_;
+    }
+
+    uint32_t medoid = 0;
+    float min_distance = std::numeric_limits<float>::max();
+    for (size_t i = 0; i < count_; ++i) {
+      float distance = faiss::fvec_L2sqr(centroid.data(), Vector(i), dimension_);
+      if (distance < min_distance) {
+        min_distance = distance;
+        medoid = i;
+      }
+    }
+    return medoid;
+  }
+
+  // Greedy search from medoid, return all expanded nodes.
+  void GreedySearch(const float* target, std::vector<std::pair<float, uint32_t>>& visited) {
+    std::vector<Candidate> list;
+    list.reserve(list_size_ + 1);
+    std::unordered_set<uint32_t> seen;
+
+    list.push_back({faiss::fvec_L2sqr(target, Vector(medoid_), dimension_), medoid_, false});
+    seen.insert(medoid_);
+
+    std::vector<uint32_t> neighbors;
+    for (;;) {
+      auto it = std::find_if(list.begin(), list.end(), [](const Candidate& c) { return !c.expanded; });
+      if (it == list.end()) {
+        break;
+      }
+      it->expanded = true;
+      uint32_t node = it->node;
+      visited.emplace_back(it->distance, node);
+
+      {
+        std::lock_guard<std::mutex> guard(Lock(node));
+        neighbors = graph_[node];
+      }
+
+      for (auto neighbor : neighbors) {
+        if (!seen.insert(neighbor).second) {
+          continue;
+        }
+        float distance = faiss::fvec_L2sqr(target, Vector(neighbor), dimension_);
+        if (list.size() >= list_size_ && distance >= list.back().distance) {
+          continue;
+        }
+        auto pos = std::upper_bound(list.begin(), list.end(), distance,
+                                    [](float d, const Candidate& c) { return d < c.distance; });
+        list.insert(pos, {distance, neighbor, false});
+        if (list.size() > list_size_) {
+          list.pop_back();
+        }
+      }
+    }
+  }
+
+  void RobustPrune(uint32_t node, std::vector<std::pair<float, uint32_t>>& candidates, float alpha,
+                   std::vector<uint32_t>& result) {
+    std::sort(candidates.begin(), candidates.end());
+    candidates.erase(std::unique(candidates.begin(), candidates.end(),
+                                 [](const auto& a, const auto& b) { return a.second == b.second; }),
+                     candidates.end());
+
+    result.clear();
+    std::vector<bool> pruned(candidates.size(), false);
+    for (size_t i = 0; i < candidates.size() && result.size() < max_degree_; ++i) {
+      if (pruned[i] || candidates[i].second == node) {
+        continue;
+      }
+      result.push_back(candidates[i].second);
+
+      const float* selected = Vector(candidates[i].second);
+      for (size_t j = i + 1; j < candidates.size(); ++j) {
+        if (!pruned[j] && alpha * faiss::fvec_L2sqr(selected, Vector(candidates[j].second), dimension_) <=
+                              candidates[j].first) {
+          pruned[j] = true;
+        }
+      }
+    }
+  }
+
+  void Insert(uint32_t node, float alpha) {
+    std::vector<std::pair<float, uint32_t>> candidates;
+    GreedySearch(Vector(node), candidates);
+    {
+      // keep existing edges of the first pass as candidates
+      std::lock_guard<std::mutex> guard(Lock(node));
+      for (auto neighbor : graph_[node]) {
+        candidates.emplace_back(faiss::fvec_L2sqr(Vector(node), Vector(neighbor), dimension_), neighbor);
+      }
+    }
+
+    std::vector<uint32_t> neighbors;
+    RobustPrune(node, candidates, alpha, neighbors);
+    {
+      std::lock_guard<std::mutex> guard(Lock(node));
+      graph_[node] = neighbors;
+    }
+
+    // add back edges
+    std::vector<uint32_t> pruned_neighbors;
+    for (auto neighbor : neighbors) {
+      std::lock_guard<std::mutex> guard(Lock(neighbor));
+      auto& back_neighbors = graph_[neighbor];
+      if (std::find(back_neighbors.begin(), back_neighbors.end(), node) != back_neighbors.end()) {
+        continue;
+      }
+      if (back_neighbors.size() < max_degree_) {
+        back_neighbors.push_back(node);
+        continue;
+      }
+
+      std::vector<std::pair<float, uint32_t>> back_candidates;
+      back_candidates.reserve(back_neighbors.size() + 1);
+      for (auto back_neighbor : back_neighbors) {
+        back_candidates.emplace_back(faiss::fvec_L2sqr(Vector(neighbor), Vector(back_neighbor), dimension_),
+                                     back_neighbor);
+      }
+      back_candidates.emplace_back(faiss::fvec_L2sqr(Vector(neighbor), Vector(node), dimension_), node);
+      RobustPrune(neighbor, back_candidates, alpha, pruned_neighbors);
+      back_neighbors = pruned_neighbors;
+    }
+  }
+
+  const float* vectors_;
+  size_t count_;
+  uint32_t dimension_;
+  uint32_t max_degree_;
+  uint32_t list_size_;
+  uint32_t medoid_{0};
+
+  std::vector<std::vector<uint32_t>> graph_;
+  std::vector<std::mutex> locks_;
+};
+
+static uint32_t CalcPqM(uint32_t dimension) {
+  uint32_t sub_dimension = std::max(FLAGS_vector_index_diskann_pq_sub_dimension, 1U);
+  uint32_t pq_m = std::max(dimension / sub_dimension, 1U);
+  while (dimension % pq_m != 0) {
+    --pq_m;
+  }
+  return pq_m;
+}
+
+DiskAnnSegment::~DiskAnnSegment() {
+  if (fd_ >= 0) {
+    close(fd_);
+  }
+  if (remove_on_close_) {
+    unlink(path_.c_str());
+  }
+}
+
+butil::Status DiskAnnSegment::Build(int fd, uint64_t offset, ThreadPoolPtr thread_pool,
+                                    pb::common::MetricType metric_type, uint32_t dimension, uint32_t max_degree,
+                                    const std::vector<int64_t>& ids, const std::vector<float>& vectors,
+                                    uint64_t& segment_size) {
+  size_t count = ids.size();
+  if (count == 0 || vectors.size() != count * dimension) {
+    return butil::Status(pb::error::EILLEGAL_PARAMTETERS, "vector count mismatch");
+  }
+
+  VamanaBuilder builder(vectors.data(), count, dimension, max_degree, FLAGS_vector_index_diskann_build_list_size);
+  builder.Build(thread_pool, FLAGS_vector_index_diskann_build_alpha);
+
+  SegmentHeader header;
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic, kSegmentMagic, sizeof(header.magic));
+  header.version = kVersion;
+  header.metric_type = metric_type;
+  header.dimension = dimension;
+  header.max_degree = max_degree;
+  header.count = count;
+  header.medoid = builder.Medoid();
+  header.pq_m = count >= kPqMinTrainCount ? CalcPqM(dimension) : 0;
+  header.pq_nbits = kPqNbits;
+
+  size_t node_size = dimension * sizeof(float) + sizeof(uint32_t) + max_degree * sizeof(uint32_t);
+  header.nodes_offset = kHeaderSize;
+  header.ids_offset = header.nodes_offset + count * node_size;
+  header.pq_offset = header.ids_offset + count * sizeof(int64_t);
+
+  // train pq and encode
+  std::vector<float> centroids;
+  std::vector<uint8_t> codes;
+  if (header.pq_m > 0) {
+    try {
+      faiss::ProductQuantizer pq(dimension, header.pq_m, header.pq_nbits);
+      size_t train_count = std::min(count, static_cast<size_t>(FLAGS_vector_index_diskann_pq_train_count));
+      std::vector<float> train_vectors;
+      if (train_count < count) {
+        std::vector<uint32_t> order(count);
+        std::iota(order.begin(), order.end(), 0);
+        std::shuffle(order.begin(), order.end(), std::mt19937(count));
+        train_vectors.resize(train_count * dimension);
+        for (size_t i = 0; i < train_count; ++i) {
+          memcpy(train_vectors.data() + i * dimension, vectors.data() + static_cast<size_t>(order[i]) * dimension,
+                 dimension * sizeof(float));
+        }
+      }
+      pq.train(train_count, train_count < count ? train_vectors.data() : vectors.data());
+
+      codes.resize(count * pq.code_size);
+      pq.compute_codes(vectors.data(), codes.data(), count);
+      centroids = pq.centroids;
+    } catch (std::exception& e) {
+      return butil::Status(pb::error::EINTERNAL, fmt::format("train pq failed, {}", e.what()));
+    }
+  }
+  header.codes_offset = header.pq_offset + centroids.size() * sizeof(float);
+  header.segment_size = header.codes_offset + codes.size();
+
+  // nodes
+  std::vector<char> buffer;
+  buffer.reserve(kCopyBufferSize + node_size);
+  uint64_t write_offset = offset + header.nodes_offset;
+  for (size_t i = 0; i < count; ++i) {
+    size_t pos = buffer.size();
+    buffer.resize(pos + node_size, 0);
+    char* node = buffer.data() + pos;
+    memcpy(node, vectors.data() + i * dimension, dimension * sizeof(float));
+
+    const auto& neighbors = builder.Neighbors(i);
+    uint32_t degree = std::min(static_cast<uint32_t>(neighbors.size()), max_degree);
+    memcpy(node + dimension * sizeof(float), &degree, sizeof(degree));
+    memcpy(node + dimension * sizeof(float) + sizeof(uint32_t), neighbors.data(), degree * sizeof(uint32_t));
+
+    if (buffer.size() >= kCopyBufferSize || i + 1 == count) {
+      if (!WriteAll(fd, buffer.data(), buffer.size(), write_offset)) {
+        return butil::Status(pb::error::EINTERNAL, fmt::format("write nodes failed, {}", strerror(errno)));
+      }
+      write_offset += buffer.size();
+      buffer.clear();
+    }
+  }
+
+  if (!WriteAll(fd, ids.data(), count * sizeof(int64_t), offset + header.ids_offset) ||
+      !WriteAll(fd, centroids.data(), centroids.size() * sizeof(float), offset + header.pq_offset) ||
+      !WriteAll(fd, codes.data(), codes.size(), offset + header.codes_offset) ||
+      !WriteAll(fd, &header, sizeof(header), offset)) {
+    return butil::Status(pb::error::EINTERNAL, fmt::format("write segment failed, {}", strerror(errno)));
+  }
+
+  segment_size = header.segment_size;
+  return butil::Status();
+}
+
+std::shared_ptr<DiskAnnSegment> DiskAnnSegment::Open(const std::string& path, uint64_t offset,
+                                                     butil::Status& status) {
+  std::shared_ptr<DiskAnnSegment> segment(new DiskAnnSegment());
+  segment->path_ = path;
+  segment->offset_ = offset;
+  segment->fd_ = open(path.c_str(), O_RDONLY);
+  if (segment->fd_ < 0) {
+    status = butil::Status(pb::error::EINTERNAL, fmt::format("open {} failed, {}", path, strerror(errno)));
+    return nullptr;
+  }
+
+  SegmentHeader header;
+  if (!ReadAll(segment->fd_, &header, sizeof(header), offset)) {
+    status = butil::Status(pb::error::EINTERNAL, fmt::format("read header of {} failed", path));
+    return nullptr;
+  }
+  if (memcmp(header.magic, kSegmentMagic, sizeof(header.magic)) != 0 || header.version != kVersion) {
+    status = butil::Status(pb::error::EINTERNAL, fmt::format("{} is not a diskann segment", path));
+    return nullptr;
+  }
+
+  segment->metric_type_ = static_cast<pb::common::MetricType>(header.metric_type);
+  segment->dimension_ = header.dimension;
+  segment->max_degree_ = header.max_degree;
+  segment->medoid_ = header.medoid;
+  segment->nodes_offset_ = header.nodes_offset;
+  segment->segment_size_ = header.segment_size;
+
+  segment->ids_.resize(header.count);
+  if (!ReadAll(segment->fd_, segment->ids_.data(), header.count * sizeof(int64_t), offset + header.ids_offset)) {
+    status = butil::Status(pb::error::EINTERNAL, fmt::format("read ids of {} failed", path));
+    return nullptr;
+  }
+
+  if (header.pq_m > 0) {
+    try {
+      segment->pq_ = std::make_unique<faiss::ProductQuantizer>(header.dimension, header.pq_m, header.pq_nbits);
+    } catch (std::exception& e) {
+      status = butil::Status(pb::error::EINTERNAL, fmt::format("create pq failed, {}", e.what()));
+      return nullptr;
+    }
+    auto& pq = *segment->pq_;
+    segment->codes_.resize(header.count * pq.code_size);
+    if (!ReadAll(segment->fd_, pq.centroids.data(), pq.centroids.size() * sizeof(float),
+                 offset + header.pq_offset) ||
+        !ReadAll(segment->fd_, segment->codes_.data(), segment->codes_.size(), offset + header.codes_offset)) {
+      status = butil::Status(pb::error::EINTERNAL, fmt::format("read pq of {} failed", path));
+      return nullptr;
+    }
+  } else {
+    segment->nav_vectors_.resize(header.count * header.dimension);
+    for (uint32_t i = 0; i < header.count; ++i) {
+      if (!segment->ReadVector(i, segment->nav_vectors_.data() + static_cast<size_t>(i) * header.dimension)) {
+        status = butil::Status(pb::error::EINTERNAL, fmt::format("read vectors of {} failed", path));
+        return nullptr;
+      }
+    }
+  }
+
+  status = butil::Status();
+  return segment;
+}
+
+size_t DiskAnnSegment::NodeSize() const {
+  return dimension_ * sizeof(float) + sizeof(uint32_t) + max_degree_ * sizeof(uint32_t);
+}
+
+bool DiskAnnSegment::Contains(int64_t vector_id) const {
+  return std::binary_search(ids_.begin(), ids_.end(), vector_id);
+}
+
+int64_t DiskAnnSegment::MemorySize() const {
+  int64_t size = ids_.capacity() * sizeof(int64_t) + codes_.capacity() + nav_vectors_.capacity() * sizeof(float);
+  if (pq_ != nullptr) {
+    size += pq_->centroids.capacity() * sizeof(float);
+  }
+  return size;
+}
+
+bool DiskAnnSegment::ReadVector(uint32_t node, float* vector) const {
+  return ReadAll(fd_, vector, dimension_ * sizeof(float), offset_ + nodes_offset_ + node * NodeSize());
+}
+
+bool DiskAnnSegment::ReadNodes(const std::vector<uint32_t>& nodes, char* buffer) const {
+  size_t node_size = NodeSize();
+  auto read_node = [&](size_t i) -> bool {
+    return ReadAll(fd_, buffer + i * node_size, node_size, offset_ + nodes_offset_ + nodes[i] * node_size);
+  };
+
+  if (nodes.size() == 1) {
+    return read_node(0);
+  }
+
+  // issue the beam concurrently, ssd serves parallel random reads much better than serial.
+  std::vector<char> oks(nodes.size(), 0);
+  std::vector<Bthread> readers;
+  readers.reserve(nodes.size() - 1);
+  for (size_t i = 1; i < nodes.size(); ++i) {
+    readers.emplace_back([&, i]() { oks[i] = read_node(i) ? 1 : 0; });
+  }
+  oks[0] = read_node(0) ? 1 : 0;
+  for (auto& reader : readers) {
+    reader.Join();
+  }
+
+  return std::all_of(oks.begin(), oks.end(), [](char ok) { return ok == 1; });
+}
+
+void DiskAnnSegment::Search(const float* query, uint32_t topk, bool is_range, float max_distance,
+                            uint32_t search_list_size, uint32_t beam_width, const Filter& filter,
+                            std::vector<Result>& results) const {
+  struct Candidate {
+    float distance;
+    uint32_t node;
+    bool expanded;
+  };
+
+  results.clear();
+  if (ids_.empty()) {
+    return;
+  }
+
+  bool is_l2 = metric_type_ == pb::common::METRIC_TYPE_L2;
+
+  // navigation distance by pq table, or by in memory full vectors for tiny segment.
+  std::vector<float> table;
+  if (pq_ != nullptr) {
+    table.resize(pq_->M * pq_->ksub);
+    if (is_l2) {
+      pq_->compute_distance_table(query, table.data());
+    } else {
+      pq_->compute_inner_prod_table(query, table.data());
+      for (auto& value : table) {
+        value = -value;
+      }
+    }
+  }
+  auto nav_distance = [&](uint32_t node) -> float {
+    if (pq_ == nullptr) {
+      return Distance(is_l2, query, nav_vectors_.data() + static_cast<size_t>(node) * dimension_, dimension_);
+    }
+    const uint8_t* code = codes_.data() + static_cast<size_t>(node) * pq_->code_size;
+    float distance = 0.0F;
+    for (size_t m = 0; m < pq_->M; ++m) {
+      distance += table[m * pq_->ksub + code[m]];
+    }
+    return distance;
+  };
+
+  uint32_t list_size = std::max(search_list_size, topk);
+  std::vector<Candidate> list;
+  list.reserve(list_size + 1);
+  std::unordered_set<uint32_t> seen;
+  list.push_back({nav_distance(medoid_), medoid_, false});
+  seen.insert(medoid_);
+
+  size_t node_size = NodeSize();
+  std::vector<uint32_t> beam;
+  std::vector<char> buffer;
+  for (;;) {
+    beam.clear();
+    for (auto& candidate : list) {
+      if (!candidate.expanded) {
+        candidate.expanded = true;
+        beam.push_back(candidate.node);
+        if (beam.size() >= beam_width) {
+          break;
+        }
+      }
+    }
+    if (beam.empty()) {
+      break;
+    }
+
+    buffer.resize(beam.size() * node_size);
+    if (!ReadNodes(beam, buffer.data())) {
+      DINGO_LOG(ERROR) << fmt::format("[vector_index.diskann] read nodes of {} failed, error: {}", path_,
+                                      strerror(errno));
+      break;
+    }
+
+    for (size_t i = 0; i < beam.size(); ++i) {
+      const char* node = buffer.data() + i * node_size;
+      const float* vector = reinterpret_cast<const float*>(node);
+
+      // rerank by full vector
+      int64_t vector_id = ids_[beam[i]];
+      float distance = Distance(is_l2, query, vector, dimension_);
+      if ((!is_range || distance < max_distance) && (filter == nullptr || filter(vector_id))) {
+        results.emplace_back(distance, vector_id);
+      }
+
+      uint32_t degree = 0;
+      memcpy(&degree, node + dimension_ * sizeof(float), sizeof(degree));
+      const uint32_t* neighbors = reinterpret_cast<const uint32_t*>(node + dimension_ * sizeof(float) + sizeof(degree));
+      for (uint32_t j = 0; j < degree && j < max_degree_; ++j) {
+        uint32_t neighbor = neighbors[j];
+        if (neighbor >= ids_.size() || !seen.insert(neighbor).second) {
+          continue;
+        }
+        float neighbor_distance = nav_distance(neighbor);
+        if (list.size() >= list_size && neighbor_distance >= list.back().distance) {
+          continue;
+        }
+        auto pos = std::upper_bound(list.begin(), list.end(), neighbor_distance,
+                                    [](float d, const Candidate& c) { return d < c.distance; });
+        list.insert(pos, {neighbor_distance, neighbor, false});
+        if (list.size() > list_size) {
+          list.pop_back();
+        }
+      }
+    }
+  }
+
+  std::sort(results.begin(), results.end());
+  if (!is_range && results.size() > topk) {
+    results.resize(topk);
+  }
+}
+
+butil::Status DiskAnnSegment::CopyTo(int fd, uint64_t offset) const {
+  std::vector<char> buffer(kCopyBufferSize);
+  for (uint64_t pos = 0; pos < segment_size_; pos += buffer.size()) {
+    size_t size = std::min(static_cast<uint64_t>(buffer.size()), segment_size_ - pos);
+    if (!ReadAll(fd_, buffer.data(), size, offset_ + pos) || !WriteAll(fd, buffer.data(), size, offset + pos)) {
+      return butil::Status(pb::error::EINTERNAL, fmt::format("copy segment failed, {}", strerror(errno)));
+    }
+  }
+  return butil::Status();
+}
+
+VectorIndexDiskAnn::VectorIndexDiskAnn(int64_t id, const pb::common::VectorIndexParameter& vector_index_parameter,
+                                       const pb::common::RegionEpoch& epoch, const pb::common::Range& range,
+                                       ThreadPoolPtr thread_pool)
+    : VectorIndex(id, vector_index_parameter, epoch, range, thread_pool) {
+  const auto& diskann_parameter = vector_index_parameter.diskann_parameter();
+  dimension_ = diskann_parameter.dimension();
+  metric_type_ = diskann_parameter.metric_type();
+  normalize_ = metric_type_ == pb::common::MetricType::METRIC_TYPE_COSINE;
+  max_degree_ = std::clamp(static_cast<uint32_t>(diskann_parameter.num_neighbors()), 4U, 256U);
+}
+
+VectorIndexDiskAnn::~VectorIndexDiskAnn() {
+  if (compact_thread_ != nullptr) {
+    compact_thread_->Join();
+  }
+}
+
+std::string VectorIndexDiskAnn::SegmentPath(int64_t id) {
+  std::string dir = fmt::format("{}/diskann", Server::GetInstance().GetVectorIndexPath());
+  if (!Helper::IsExistPath(dir)) {
+    Helper::CreateDirectory(dir);
+  }
+  return fmt::format("{}/{}_{}.seg", dir, id, Helper::TimestampNs());
+}
+
+butil::Status VectorIndexDiskAnn::Add(const std::vector<pb::common::VectorWithId>& vector_with_ids) {
+  return UpsertImpl(vector_with_ids);
+}
+
+butil::Status VectorIndexDiskAnn::Upsert(const std::vector<pb::common::VectorWithId>& vector_with_ids) {
+  return UpsertImpl(vector_with_ids);
+}
+
+butil::Status VectorIndexDiskAnn::UpsertImpl(const std::vector<pb::common::VectorWithId>& vector_with_ids) {
+  if (vector_with_ids.empty()) {
+    return butil::Status(pb::error::EILLEGAL_PARAMTETERS, "vector_with_ids is empty");
+  }
+
+  auto status = VectorIndexUtils::CheckVectorDimension(vector_with_ids, dimension_);
+  if (!status.ok()) {
+    return status;
+  }
+
+  // prepare outside lock
+  std::vector<std::vector<float>> values(vector_with_ids.size());
+  for (size_t i = 0; i < vector_with_ids.size(); ++i) {
+    const auto& float_values = vector_with_ids[i].vector().float_values();
+    values[i].assign(float_values.begin(), float_values.end());
+    if (normalize_) {
+      VectorIndexUtils::NormalizeVectorForFaiss(values[i].data(), dimension_);
+    }
+  }
+
+  BvarLatencyGuard bvar_guard(&g_diskann_upsert_latency);
+  RWLockWriteGuard guard(&rw_lock_);
+
+  for (size_t i = 0; i < vector_with_ids.size(); ++i) {
+    int64_t vector_id = vector_with_ids[i].id();
+    int64_t seq = ++write_seq_;
+    if (segment_ != nullptr && segment_->Contains(vector_id)) {
+      shadowed_[vector_id] = seq;
+    }
+    auto& delta_vector = delta_[vector_id];
+    delta_vector.values.swap(values[i]);
+    delta_vector.seq = seq;
+  }
+
+  LaunchCompactIfNeed();
+
+  return butil::Status::OK();
+}
+
+butil::Status VectorIndexDiskAnn::Delete(const std::vector<int64_t>& delete_ids) {
+  if (delete_ids.empty()) {
+    return butil::Status::OK();
+  }
+
+  BvarLatencyGuard bvar_guard(&g_diskann_delete_latency);
+  RWLockWriteGuard guard(&rw_lock_);
+
+  for (auto vector_id : delete_ids) {
+    int64_t seq = ++write_seq_;
+    delta_.erase(vector_id);
+    if (segment_ != nullptr && segment_->Contains(vector_id)) {
+      shadowed_[vector_id] = seq;
+    } else if (is_compacting_.load()) {
+      compacting_deleted_[vector_id] = seq;
+    }
+  }
+
+  LaunchCompactIfNeed();
+
+  return butil::Status::OK();
+}
+
+// Need hold rw_lock_ write.
+void VectorIndexDiskAnn::LaunchCompactIfNeed() {
+  if (is_compacting_.load()) {
+    return;
+  }
+
+  int64_t delta_count = delta_.size() + shadowed_.size();
+  int64_t segment_count = segment_ != nullptr ? segment_->Count() : 0;
+  if (delta_count < FLAGS_vector_index_diskann_compact_threshold ||
+      delta_count < segment_count * FLAGS_vector_index_diskann_compact_ratio) {
+    return;
+  }
+
+  is_compacting_.store(true);
+  if (compact_thread_ != nullptr) {
+    compact_thread_->Join();
+  }
+  compact_thread_ = std::make_unique<Bthread>([this]() {
+    auto status = Compact();
+    if (!status.ok()) {
+      DINGO_LOG(ERROR) << fmt::format("[vector_index.diskann][id({})] compact failed, error: {}", Id(),
+                                      status.error_str());
+    }
+  });
+}
+
+butil::Status VectorIndexDiskAnn::Compact() {
+  int64_t start_time = Helper::TimestampMs();
+  BvarLatencyGuard bvar_guard(&g_diskann_compact_latency);
+
+  DiskAnnSegmentPtr old_segment;
+  int64_t start_seq = 0;
+  std::vector<std::pair<int64_t, std::vector<float>>> delta_vectors;
+  std::unordered_set<int64_t> shadowed_ids;
+  {
+    RWLockWriteGuard guard(&rw_lock_);
+    is_compacting_.store(true);
+    old_segment = segment_;
+    start_seq = write_seq_;
+    delta_vectors.reserve(delta_.size());
+    for (const auto& [vector_id, delta_vector] : delta_) {
+      delta_vectors.emplace_back(vector_id, delta_vector.values);
+    }
+    for (const auto& [vector_id, _] : shadowed_) {
+      shadowed_ids.insert(vector_id);
+    }
+  }
+  ON_SCOPE_EXIT([&]() { is_compacting_.store(false); });
+
+  std::sort(delta_vectors.begin(), delta_vectors.end(),
+            [](const auto& a, const auto& b) { return a.first < b.first; });
+
+  // merge live segment vectors and delta by vector id, delta never overlap live segment vectors.
+  int64_t total_count = delta_vectors.size() + (old_segment != nullptr ? old_segment->Count() : 0);
+  std::vector<int64_t> ids;
+  std::vector<float> vectors;
+  ids.reserve(total_count);
+  vectors.reserve(total_count * dimension_);
+
+  size_t delta_pos = 0;
+  auto append_delta_before = [&](int64_t vector_id) {
+    for (; delta_pos < delta_vectors.size() && delta_vectors[delta_pos].first < vector_id; ++delta_pos) {
+      ids.push_back(delta_vectors[delta_pos].first);
+      vectors.insert(vectors.end(), delta_vectors[delta_pos].second.begin(), delta_vectors[delta_pos].second.end());
+    }
+  };
+
+  if (old_segment != nullptr) {
+    const auto& segment_ids = old_segment->Ids();
+    std::vector<float> vector(dimension_);
+    for (uint32_t i = 0; i < segment_ids.size(); ++i) {
+      if (shadowed_ids.count(segment_ids[i]) > 0) {
+        continue;
+      }
+      if (!old_segment->ReadVector(i, vector.data())) {
+        return butil::Status(pb::error::EINTERNAL, fmt::format("read vector from {} failed", old_segment->Path()));
+      }
+      append_delta_before(segment_ids[i]);
+      ids.push_back(segment_ids[i]);
+      vectors.insert(vectors.end(), vector.begin(), vector.end());
+    }
+  }
+  append_delta_before(INT64_MAX);
+  delta_vectors.clear();
+  delta_vectors.shrink_to_fit();
+
+  DiskAnnSegmentPtr new_segment;
+  if (!ids.empty()) {
+    std::string path = SegmentPath(Id());
+    int fd = open(path.c_str(), O_CREAT | O_TRUNC | O_RDWR, 0644);
+    if (fd < 0) {
+      return butil::Status(pb::error::EINTERNAL, fmt::format("open {} failed, {}", path, strerror(errno)));
+    }
+    uint64_t segment_size = 0;
+    auto status = DiskAnnSegment::Build(fd, 0, thread_pool, metric_type_, dimension_, max_degree_, ids, vectors,
+                                        segment_size);
+    if (status.ok() && fdatasync(fd) != 0) {
+      status = butil::Status(pb::error::EINTERNAL, fmt::format("sync {} failed, {}", path, strerror(errno)));
+    }
+    close(fd);
+    if (status.ok()) {
+      new_segment = DiskAnnSegment::Open(path, 0, status);
+    }
+    if (!status.ok()) {
+      unlink(path.c_str());
+      return status;
+    }
+    new_segment->SetRemoveOnClose(true);
+  }
+  vectors.clear();
+  vectors.shrink_to_fit();
+
+  {
+    RWLockWriteGuard guard(&rw_lock_);
+    if (segment_ != old_segment) {
+      // replaced by Load meanwhile, give up.
+      compacting_deleted_.clear();
+      return butil::Status(pb::error::EINTERNAL, "segment changed while compacting");
+    }
+
+    // writes after start_seq are not in the new segment.
+    std::unordered_map<int64_t, int64_t> new_shadowed;
+    auto shadow_if_contains = [&](int64_t vector_id, int64_t seq) {
+      if (seq > start_seq && new_segment != nullptr && new_segment->Contains(vector_id)) {
+        new_shadowed[vector_id] = std::max(new_shadowed[vector_id], seq);
+      }
+    };
+    for (const auto& [vector_id, seq] : shadowed_) {
+      shadow_if_contains(vector_id, seq);
+    }
+    for (const auto& [vector_id, seq] : compacting_deleted_) {
+      shadow_if_contains(vector_id, seq);
+    }
+    for (auto it = delta_.begin(); it != delta_.end();) {
+      if (it->second.seq <= start_seq) {
+        it = delta_.erase(it);
+      } else {
+        shadow_if_contains(it->first, it->second.seq);
+        ++it;
+      }
+    }
+
+    shadowed_.swap(new_shadowed);
+    compacting_deleted_.clear();
+    segment_ = new_segment;
+  }
+
+  DINGO_LOG(INFO) << fmt::format("[vector_index.diskann][id({})] compact finish, count({}) elapsed({}ms)", Id(),
+                                 ids.size(), Helper::TimestampMs() - start_time);
+
+  return butil::Status();
+}
+
+butil::Status VectorIndexDiskAnn::Search(const std::vector<pb::common::VectorWithId>& vector_with_ids, uint32_t topk,
+                                         const std::vector<std::shared_ptr<FilterFunctor>>& filters, bool,
+                                         const pb::common::VectorSearchParameter&,
+                                         std::vector<pb::index::VectorWithDistanceResult>& results) {
+  if (vector_with_ids.empty()) {
+    return butil::Status(pb::error::EILLEGAL_PARAMTETERS, "vector_with_ids is empty");
+  }
+  if (topk <= 0) return butil::Status::OK();
+
+  return SearchImpl(vector_with_ids, topk, false, 0.0F, filters, results);
+}
+
+butil::Status VectorIndexDiskAnn::RangeSearch(const std::vector<pb::common::VectorWithId>& vector_with_ids,
+                                              float radius,
+                                              const std::vector<std::shared_ptr<VectorIndex::FilterFunctor>>& filters,
+                                              bool, const pb::common::VectorSearchParameter&,
+                                              std::vector<pb::index::VectorWithDistanceResult>& results) {
+  if (vector_with_ids.empty()) {
+    return butil::Status(pb::error::EILLEGAL_PARAMTETERS, "vector_with_ids is empty");
+  }
+
+  // reported distance of inner product is 1 - ip, internal is -ip.
+  float max_distance = metric_type_ == pb::common::MetricType::METRIC_TYPE_L2 ? radius : radius - 1.0F;
+  return SearchImpl(vector_with_ids, FLAGS_vector_index_diskann_search_list_size, true, max_distance, filters,
+                    results);
+}
+
+butil::Status VectorIndexDiskAnn::SearchImpl(const std::vector<pb::common::VectorWithId>& vector_with_ids,
+                                             uint32_t topk, bool is_range, float max_distance,
+                                             const std::vector<std::shared_ptr<FilterFunctor>>& filters,
+                                             std::vector<pb::index::VectorWithDistanceResult>& results) {
+  auto status = VectorIndexUtils::CheckVectorDimension(vector_with_ids, dimension_);
+  if (!status.ok()) {
+    return status;
+  }
+
+  const auto& vector_values = VectorIndexUtils::ExtractVectorValue(vector_with_ids, dimension_, normalize_);
+  bool is_l2 = metric_type_ == pb::common::MetricType::METRIC_TYPE_L2;
+
+  auto check_filters = [&](int64_t vector_id) -> bool {
+    for (const auto& filter : filters) {
+      if (!filter->Check(vector_id)) {
+        return false;
+      }
+    }
+    return true;
+  };
+
+  BvarLatencyGuard bvar_guard(&g_diskann_search_latency);
+  RWLockReadGuard guard(&rw_lock_);
+
+  DiskAnnSegment::Filter segment_filter = [&](int64_t vector_id) -> bool {
+    return shadowed_.count(vector_id) == 0 && check_filters(vector_id);
+  };
+
+  for (size_t row = 0; row < vector_with_ids.size(); ++row) {
+    const float* query = vector_values.get() + row * dimension_;
+
+    std::vector<DiskAnnSegment::Result> row_results;
+    if (segment_ != nullptr) {
+      segment_->Search(query, topk, is_range, max_distance, FLAGS_vector_index_diskann_search_list_size,
+                       FLAGS_vector_index_diskann_beam_width, segment_filter, row_results);
+    }
+
+    for (const auto& [vector_id, delta_vector] : delta_) {
+      float distance = Distance(is_l2, query, delta_vector.values.data(), dimension_);
+      if ((!is_range || distance < max_distance) && check_filters(vector_id)) {
+        row_results.emplace_back(distance, vector_id);
+      }
+    }
+
+    std::sort(row_results.begin(), row_results.end());
+    if (!is_range && row_results.size() > topk) {
+      row_results.resize(topk);
+    }
+
+    auto& result = results.emplace_back();
+    for (const auto& [distance, vector_id] : row_results) {
+      auto* vector_with_distance = result.add_vector_with_distances();
+      auto* vector_with_id = vector_with_distance->mutable_vector_with_id();
+      vector_with_id->set_id(vector_id);
+      vector_with_id->mutable_vector()->set_dimension(dimension_);
+      vector_with_id->mutable_vector()->set_value_type(::dingodb::pb::common::ValueType::FLOAT);
+      vector_with_distance->set_distance(is_l2 ? distance : 1.0F + distance);
+      vector_with_distance->set_metric_type(metric_type_);
+    }
+  }
+
+  DINGO_LOG(DEBUG) << fmt::format("[vector_index.diskann][id({})] result size {}", Id(), results.size());
+
+  return butil::Status::OK();
+}
+
+butil::Status VectorIndexDiskAnn::Save(const std::string& path) {
+  // Warning : read me first !!!!
+  // Currently, the save function is executed in the fork child process.
+  // When calling glog,
+  // the child process will hang.
+  // Remove glog temporarily.
+  if (path.empty()) {
+    return butil::Status(pb::error::EILLEGAL_PARAMTETERS, "path is empty");
+  }
+
+  int fd = open(path.c_str(), O_CREAT | O_TRUNC | O_WRONLY, 0644);
+  if (fd < 0) {
+    return butil::Status(pb::error::EINTERNAL, fmt::format("open {} failed, {}", path, strerror(errno)));
+  }
+  ON_SCOPE_EXIT([&]() { close(fd); });
+
+  SnapshotHeader header;
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic, kSnapshotMagic, sizeof(header.magic));
+  header.version = kVersion;
+  header.dimension = dimension_;
+  header.segment_offset = kHeaderSize;
+  header.segment_size = segment_ != nullptr ? segment_->Size() : 0;
+  header.delta_offset = header.segment_offset + header.segment_size;
+  header.delta_count = delta_.size();
+  header.shadowed_offset = header.delta_offset + header.delta_count * (sizeof(int64_t) + dimension_ * sizeof(float));
+  header.shadowed_count = shadowed_.size();
+
+  if (segment_ != nullptr) {
+    auto status = segment_->CopyTo(fd, header.segment_offset);
+    if (!status.ok()) {
+      return status;
+    }
+  }
+
+  std::vector<char> buffer;
+  uint64_t offset = header.delta_offset;
+  for (const auto& [vector_id, delta_vector] : delta_) {
+    buffer.insert(buffer.end(), reinterpret_cast<const char*>(&vector_id),
+                  reinterpret_cast<const char*>(&vector_id) + sizeof(vector_id));
+    buffer.insert(buffer.end(), reinterpret_cast<const char*>(delta_vector.values.data()),
+                  reinterpret_cast<const char*>(delta_vector.values.data() + dimension_));
+    if (buffer.size() >= kCopyBufferSize) {
+      if (!WriteAll(fd, buffer.data(), buffer.size(), offset)) {
+        return butil::Status(pb::error::EINTERNAL, fmt::format("write delta failed, {}", strerror(errno)));
+      }
+      offset += buffer.size();
+      buffer.clear();
+    }
+  }
+  for (const auto& [vector_id, _] : shadowed_) {
+    buffer.insert(buffer.end(), reinterpret_cast<const char*>(&vector_id),
+                  reinterpret_cast<const char*>(&vector_id) + sizeof(vector_id));
+  }
+
+  if (!WriteAll(fd, buffer.data(), buffer.size(), offset) || !WriteAll(fd, &header, sizeof(header), 0) ||
+      fdatasync(fd) != 0) {
+    return butil::Status(pb::error::EINTERNAL, fmt::format("write snapshot failed, {}", strerror(errno)));
+  }
+
+  return butil::Status();
+}
+
+butil::Status VectorIndexDiskAnn::Load(const std::string& path) {
+  if (path.empty()) {
+    return butil::Status(pb::error::EILLEGAL_PARAMTETERS, "path is empty");
+  }
+
+  BvarLatencyGuard bvar_guard(&g_diskann_load_latency);
+
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return butil::Status(pb::error::EINTERNAL, fmt::format("open {} failed, {}", path, strerror(errno)));
+  }
+  ON_SCOPE_EXIT([&]() { close(fd); });
+
+  SnapshotHeader header;
+  if (!ReadAll(fd, &header, sizeof(header), 0) ||
+      memcmp(header.magic, kSnapshotMagic, sizeof(header.magic)) != 0 || header.version != kVersion) {
+    return butil::Status(pb::error::EINTERNAL, fmt::format("{} is not a diskann snapshot", path));
+  }
+  if (header.dimension != dimension_) {
+    return butil::Status(pb::error::EINTERNAL,
+                         fmt::format("dimension not match, {} vs {}", header.dimension, dimension_));
+  }
+
+  // the segment is served from the snapshot file in place.
+  DiskAnnSegmentPtr segment;
+  if (header.segment_size > 0) {
+    butil::Status status;
+    segment = DiskAnnSegment::Open(path, header.segment_offset, status);
+    if (!status.ok()) {
+      return status;
+    }
+  }
+
+  std::unordered_map<int64_t, DeltaVector> delta;
+  size_t record_size = sizeof(int64_t) + dimension_ * sizeof(float);
+  std::vector<char> record(record_size);
+  for (uint64_t i = 0; i < header.delta_count; ++i) {
+    if (!ReadAll(fd, record.data(), record_size, header.delta_offset + i * record_size)) {
+      return butil::Status(pb::error::EINTERNAL, fmt::format("read delta of {} failed", path));
+    }
+    int64_t vector_id = 0;
+    memcpy(&vector_id, record.data(), sizeof(vector_id));
+    auto& delta_vector = delta[vector_id];
+    delta_vector.values.resize(dimension_);
+    memcpy(delta_vector.values.data(), record.data() + sizeof(vector_id), dimension_ * sizeof(float));
+    delta_vector.seq = 0;
+  }
+
+  std::vector<int64_t> shadowed_ids(header.shadowed_count);
+  if (!ReadAll(fd, shadowed_ids.data(), shadowed_ids.size() * sizeof(int64_t), header.shadowed_offset)) {
+    return butil::Status(pb::error::EINTERNAL, fmt::format("read shadowed of {} failed", path));
+  }
+
+  RWLockWriteGuard guard(&rw_lock_);
+  segment_ = segment;
+  delta_.swap(delta);
+  shadowed_.clear();
+  for (auto vector_id : shadowed_ids) {
+    shadowed_[vector_id] = 0;
+  }
+  compacting_deleted_.clear();
+  write_seq_ = 0;
+
+  DINGO_LOG(INFO) << fmt::format("[vector_index.diskann][id({})] load finish, segment({}) delta({}) shadowed({})",
+                                 Id(), segment_ != nullptr ? segment_->Count() : 0, delta_.size(), shadowed_.size());
+
+  return butil::Status();
+}
+
+void VectorIndexDiskAnn::LockWrite() { rw_lock_.LockWrite(); }
+
+void VectorIndexDiskAnn::UnlockWrite() { rw_lock_.UnlockWrite(); }
+
+int32_t VectorIndexDiskAnn::GetDimension() { return dimension_; }
+
+pb::common::MetricType VectorIndexDiskAnn::GetMetricType() { return metric_type_; }
+
+butil::Status VectorIndexDiskAnn::GetCount(int64_t& count) {
+  RWLockReadGuard guard(&rw_lock_);
+  count = (segment_ != nullptr ? segment_->Count() : 0) - shadowed_.size() + delta_.size();
+  return butil::Status::OK();
+}
+
+butil::Status VectorIndexDiskAnn::GetDeletedCount(int64_t& deleted_count) {
+  RWLockReadGuard guard(&rw_lock_);
+  deleted_count = shadowed_.size();
+  return butil::Status::OK();
+}
+
+butil::Status VectorIndexDiskAnn::GetMemorySize(int64_t& memory_size) {
+  RWLockReadGuard guard(&rw_lock_);
+  memory_size = (segment_ != nullptr ? segment_->MemorySize() : 0) +
+                delta_.size() * (sizeof(DeltaVector) + sizeof(int64_t) + dimension_ * sizeof(float)) +
+                shadowed_.size() * sizeof(int64_t) * 2;
+  return butil::Status::OK();
+}
+
+bool VectorIndexDiskAnn::NeedToSave(int64_t last_save_log_behind) {
+  RWLockReadGuard guard(&rw_lock_);
+  if (segment_ == nullptr && delta_.empty() && shadowed_.empty()) {
+    return false;
+  }
+
+  return last_save_log_behind > FLAGS_diskann_need_save_count;
+}
+
+}  // namespace dingodb
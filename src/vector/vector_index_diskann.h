@@ -0,0 +1,207 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_VECTOR_INDEX_DISKANN_H_  // NOLINT
+#define DINGODB_VECTOR_INDEX_DISKANN_H_
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "butil/status.h"
+#include "common/synchronization.h"
+#include "common/threadpool.h"
+#include "faiss/impl/ProductQuantizer.h"
+#include "proto/common.pb.h"
+#include "vector/vector_index.h"
+
+namespace dingodb {
+
+// Immutable Vamana graph on SSD.
+// Each node stores the full vector and the adjacency list in a fixed size slot of the file, read by pread at search.
+// Only vector ids and PQ codes used to navigate the graph stay in memory.
+// File layout, offsets are relative to the segment start:
+//   header(4KB) | nodes: count * [float vector[dimension], uint32 degree, uint32 neighbors[max_degree]]
+//   | ids: count * int64 ascending | pq centroids | pq codes: count * pq_m
+class DiskAnnSegment {
+ public:
+  // (distance, vector_id), distance is L2 square or negative inner product, smaller is closer.
+  using Result = std::pair<float, int64_t>;
+  using Filter = std::function<bool(int64_t)>;
+
+  ~DiskAnnSegment();
+
+  DiskAnnSegment(const DiskAnnSegment& rhs) = delete;
+  DiskAnnSegment& operator=(const DiskAnnSegment& rhs) = delete;
+  DiskAnnSegment(DiskAnnSegment&& rhs) = delete;
+  DiskAnnSegment& operator=(DiskAnnSegment&& rhs) = delete;
+
+  // Build graph from vectors and write segment to fd at offset, ids must be ascending.
+  // Graph construction runs on thread_pool if not null.
+  static butil::Status Build(int fd, uint64_t offset, ThreadPoolPtr thread_pool, pb::common::MetricType metric_type,
+                             uint32_t dimension, uint32_t max_degree, const std::vector<int64_t>& ids,
+                             const std::vector<float>& vectors, uint64_t& segment_size);
+
+  // Open segment at offset of file, the file is kept open until segment destroy.
+  static std::shared_ptr<DiskAnnSegment> Open(const std::string& path, uint64_t offset, butil::Status& status);
+
+  int64_t Count() const { return ids_.size(); }
+  const std::vector<int64_t>& Ids() const { return ids_; }
+  bool Contains(int64_t vector_id) const;
+  uint64_t Size() const { return segment_size_; }
+  int64_t MemorySize() const;
+  const std::string& Path() const { return path_; }
+
+  // Remove file when destroy, for files generated by compaction.
+  void SetRemoveOnClose(bool remove_on_close) { remove_on_close_ = remove_on_close; }
+
+  // Beam search, return topk ascending results reranked by full vectors.
+  // If is_range, return all expanded nodes whose L2 square or negative inner product < max_distance.
+  void Search(const float* query, uint32_t topk, bool is_range, float max_distance, uint32_t search_list_size,
+              uint32_t beam_width, const Filter& filter, std::vector<Result>& results) const;
+
+  // Read full vector of node by index of Ids().
+  bool ReadVector(uint32_t node, float* vector) const;
+
+  // Copy segment bytes to fd at offset.
+  butil::Status CopyTo(int fd, uint64_t offset) const;
+
+ private:
+  DiskAnnSegment() = default;
+
+  size_t NodeSize() const;
+  // Read nodes concurrently, buffer hold nodes.size() * NodeSize() bytes.
+  bool ReadNodes(const std::vector<uint32_t>& nodes, char* buffer) const;
+
+  std::string path_;
+  int fd_{-1};
+  uint64_t offset_{0};
+  uint64_t segment_size_{0};
+  bool remove_on_close_{false};
+
+  pb::common::MetricType metric_type_;
+  uint32_t dimension_{0};
+  uint32_t max_degree_{0};
+  uint32_t medoid_{0};
+  uint64_t nodes_offset_{0};
+
+  std::vector<int64_t> ids_;
+
+  // navigation, PQ codes, or full vectors when too few vectors to train PQ
+  std::unique_ptr<faiss::ProductQuantizer> pq_;
+  std::vector<uint8_t> codes_;
+  std::vector<float> nav_vectors_;
+};
+
+using DiskAnnSegmentPtr = std::shared_ptr<DiskAnnSegment>;
+
+// DiskANN style index, vectors live in a DiskAnnSegment on SSD.
+// Writes go to an in-memory delta (upserted vectors and shadowed segment ids), searched by brute force and merged
+// with the segment result. When the delta exceeds FLAGS_vector_index_diskann_compact_threshold it is merged
+// into a new segment in background.
+class VectorIndexDiskAnn : public VectorIndex {
+ public:
+  explicit VectorIndexDiskAnn(int64_t id, const pb::common::VectorIndexParameter& vector_index_parameter,
+                              const pb::common::RegionEpoch& epoch, const pb::common::Range& range,
+                              ThreadPoolPtr thread_pool);
+
+  ~VectorIndexDiskAnn() override;
+
+  VectorIndexDiskAnn(const VectorIndexDiskAnn& rhs) = delete;
+  VectorIndexDiskAnn& operator=(const VectorIndexDiskAnn& rhs) = delete;
+  VectorIndexDiskAnn(VectorIndexDiskAnn&& rhs) = delete;
+  VectorIndexDiskAnn& operator=(VectorIndexDiskAnn&& rhs) = delete;
+
+  butil::Status Save(const std::string& path) override;
+  butil::Status Load(const std::string& path) override;
+  bool SupportSave() override { return true; }
+
+  butil::Status Add(const std::vector<pb::common::VectorWithId>& vector_with_ids) override;
+  butil::Status Upsert(const std::vector<pb::common::VectorWithId>& vector_with_ids) override;
+  butil::Status Delete(const std::vector<int64_t>& delete_ids) override;
+
+  butil::Status Search(const std::vector<pb::common::VectorWithId>& vector_with_ids, uint32_t topk,
+                       const std::vector<std::shared_ptr<FilterFunctor>>& filters, bool reconstruct,
+                       const pb::common::VectorSearchParameter& parameter,
+                       std::vector<pb::index::VectorWithDistanceResult>& results) override;
+
+  butil::Status RangeSearch(const std::vector<pb::common::VectorWithId>& vector_with_ids, float radius,
+                            const std::vector<std::shared_ptr<VectorIndex::FilterFunctor>>& filters, bool reconstruct,
+                            const pb::common::VectorSearchParameter& parameter,
+                            std::vector<pb::index::VectorWithDistanceResult>& results) override;
+
+  void LockWrite() override;
+  void UnlockWrite() override;
+
+  int32_t GetDimension() override;
+  pb::common::MetricType GetMetricType() override;
+  butil::Status GetCount(int64_t& count) override;
+  butil::Status GetDeletedCount(int64_t& deleted_count) override;
+  butil::Status GetMemorySize(int64_t& memory_size) override;
+  bool IsExceedsMaxElements() override { return false; }
+
+  butil::Status Train([[maybe_unused]] std::vector<float>& train_datas) override { return butil::Status::OK(); }
+  butil::Status Train([[maybe_unused]] const std::vector<pb::common::VectorWithId>& vectors) override {
+    return butil::Status::OK();
+  }
+  bool NeedToRebuild() override { return false; }
+  bool NeedToSave(int64_t last_save_log_behind) override;
+
+  // Merge delta into a new segment, public for test.
+  butil::Status Compact();
+
+ private:
+  struct DeltaVector {
+    std::vector<float> values;
+    int64_t seq;
+  };
+
+  butil::Status UpsertImpl(const std::vector<pb::common::VectorWithId>& vector_with_ids);
+  void LaunchCompactIfNeed();
+
+  butil::Status SearchImpl(const std::vector<pb::common::VectorWithId>& vector_with_ids, uint32_t topk, bool is_range,
+                           float radius, const std::vector<std::shared_ptr<FilterFunctor>>& filters,
+                           std::vector<pb::index::VectorWithDistanceResult>& results);
+
+  static std::string SegmentPath(int64_t id);
+
+  uint32_t dimension_;
+  pb::common::MetricType metric_type_;
+  // normalize vector, cosine
+  bool normalize_;
+  uint32_t max_degree_;
+
+  RWLock rw_lock_;
+
+  DiskAnnSegmentPtr segment_;
+  // upserted vectors not in segment yet
+  std::unordered_map<int64_t, DeltaVector> delta_;
+  // segment ids which are deleted or replaced by delta, value is write seq
+  std::unordered_map<int64_t, int64_t> shadowed_;
+  // deleted ids not in segment while compacting, they may be in the new segment
+  std::unordered_map<int64_t, int64_t> compacting_deleted_;
+  int64_t write_seq_{0};
+
+  std::atomic<bool> is_compacting_{false};
+  std::unique_ptr<Bthread> compact_thread_;
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_VECTOR_INDEX_DISKANN_H_  // NOLINT
@@ -22,13 +22,20 @@
 #include "server/server.h"
 #include "vector/vector_index.h"
 #include "vector/vector_index_bruteforce.h"
+#include "vector/vector_index_diskann.h"
 #include "vector/vector_index_flat.h"
+#include "vector/vector_index_gpu_ivf_flat.h"
 #include "vector/vector_index_hnsw.h"
 #include "vector/vector_index_ivf_flat.h"
 #include "vector/vector_index_ivf_pq.h"
+#include "vector/vector_index_raw_ivf_pq.h"
 
 namespace dingodb {
 
+#ifdef ENABLE_GPU
+DECLARE_bool(enable_vector_index_gpu);
+#endif
+
 std::shared_ptr<VectorIndex> VectorIndexFactory::New(int64_t id,
                                                      const pb::common::VectorIndexParameter& index_parameter,
                                                      const pb::common::RegionEpoch& epoch,
@@ -59,8 +66,7 @@ std::shared_ptr<VectorIndex> VectorIndexFactory::New(int64_t id,
       break;
     }
     case pb::common::VECTOR_INDEX_TYPE_DISKANN: {
-      DINGO_LOG(ERROR) << "vector_index_parameter = diskann not implement, type=" << index_parameter.vector_index_type()
-                       << ", id=" << id << ", parameter=" << index_parameter.ShortDebugString();
+      vector_index = NewDiskAnn(id, index_parameter, epoch, range, thread_pool);
       break;
     }
     case pb::common::VectorIndexType_INT_MIN_SENTINEL_DO_NOT_USE_:
@@ -216,6 +222,16 @@ std::shared_ptr<VectorIndex> VectorIndexFactory::NewIvfFlat(int64_t id,
 
   // create index may throw exception, so we need to catch it
   try {
+#ifdef ENABLE_GPU
+    if (FLAGS_enable_vector_index_gpu && VectorIndexGpuIvfFlat::IsDeviceAvailable()) {
+      auto new_gpu_ivf_flat_index =
+          std::make_shared<VectorIndexGpuIvfFlat>(id, index_parameter, epoch, range, thread_pool);
+      DINGO_LOG(INFO) << "create gpu ivf flat index success, id=" << id
+                      << ", parameter=" << index_parameter.ShortDebugString();
+      return new_gpu_ivf_flat_index;
+    }
+#endif
+
     auto new_ivf_flat_index = std::make_shared<VectorIndexIvfFlat>(id, index_parameter, epoch, range, thread_pool);
     if (new_ivf_flat_index == nullptr) {
       DINGO_LOG(ERROR) << "create ivf flat index failed of new_ivf_flat_index is nullptr"
@@ -301,6 +317,10 @@ std::shared_ptr<VectorIndex> VectorIndexFactory::NewIvfPq(int64_t id,
         nbits_per_idx, Constant::kCreateIvfPqParamNbitsPerIdxMaxWarning);
   }
 
+  if (VectorIndexRawIvfPq::UseFastScan(nbits_per_idx)) {
+    DINGO_LOG(INFO) << fmt::format("vector_index_parameter nbits_per_idx : {}, ivf pq use fast scan.", nbits_per_idx);
+  }
+
   // create index may throw exception, so we need to catch it
   try {
     auto new_ivf_pq_index = std::make_shared<VectorIndexIvfPq>(id, index_parameter, epoch, range, thread_pool);
@@ -320,4 +340,35 @@ std::shared_ptr<VectorIndex> VectorIndexFactory::NewIvfPq(int64_t id,
   }
 }
 
+std::shared_ptr<VectorIndex> VectorIndexFactory::NewDiskAnn(int64_t id,
+                                                            const pb::common::VectorIndexParameter& index_parameter,
+                                                            const pb::common::RegionEpoch& epoch,
+                                                            const pb::common::Range& range, ThreadPoolPtr thread_pool) {
+  const auto& diskann_parameter = index_parameter.diskann_parameter();
+
+  if (diskann_parameter.dimension() <= 0) {
+    DINGO_LOG(ERROR) << "vector_index_parameter is illegal, dimension <= 0";
+    return nullptr;
+  }
+  if (diskann_parameter.metric_type() == pb::common::MetricType::METRIC_TYPE_NONE) {
+    DINGO_LOG(ERROR) << "vector_index_parameter is illegal, METRIC_TYPE_NONE";
+    return nullptr;
+  }
+  if (diskann_parameter.num_neighbors() <= 0) {
+    DINGO_LOG(ERROR) << "vector_index_parameter is illegal, num_neighbors <= 0";
+    return nullptr;
+  }
+
+  try {
+    auto new_diskann_index = std::make_shared<VectorIndexDiskAnn>(id, index_parameter, epoch, range, thread_pool);
+    DINGO_LOG(INFO) << "create diskann index success, id=" << id
+                    << ", parameter=" << index_parameter.ShortDebugString();
+    return new_diskann_index;
+  } catch (std::exception& e) {
+    DINGO_LOG(ERROR) << "create diskann index failed of exception occured, " << e.what() << ", id=" << id
+                     << ", parameter=" << index_parameter.ShortDebugString();
+    return nullptr;
+  }
+}
+
 }  // namespace dingodb
@@ -14,6 +14,7 @@
 
 #include "vector/vector_index_flat.h"
 
+#include <algorithm>
 #include <cstddef>
 #include <cstdint>
 #include <future>
@@ -34,19 +35,25 @@
 #include "faiss/impl/AuxIndexStructures.h"
 #include "faiss/impl/IDSelector.h"
 #include "faiss/index_io.h"
+#include "faiss/utils/distances.h"
 #include "fmt/core.h"
 #include "glog/logging.h"
 #include "proto/common.pb.h"
 #include "proto/error.pb.h"
 #include "proto/index.pb.h"
+#include "vector/vector_index_mmap_reader.h"
 #include "vector/vector_index_utils.h"
 
 namespace dingodb {
 
 DEFINE_int64(flat_need_save_count, 10000, "flat need save count");
+DEFINE_uint32(flat_chunk_search_max_query_count, 4, "flat search by chunk when query count not more than it");
+DEFINE_int64(flat_chunk_search_min_chunk_size, 65536, "flat search by chunk min vector count of one chunk");
+DEFINE_uint32(flat_chunk_search_max_chunk_num, 8, "flat search by chunk max chunk num");
 
 bvar::LatencyRecorder g_flat_upsert_latency("dingo_flat_upsert_latency");
 bvar::LatencyRecorder g_flat_search_latency("dingo_flat_search_latency");
+bvar::LatencyRecorder g_flat_chunk_search_latency("dingo_flat_chunk_search_latency");
 bvar::LatencyRecorder g_flat_range_search_latency("dingo_flat_range_search_latency");
 bvar::LatencyRecorder g_flat_delete_latency("dingo_flat_delete_latency");
 bvar::LatencyRecorder g_flat_load_latency("dingo_flat_load_latency");
@@ -162,7 +169,7 @@ butil::Status VectorIndexFlat::Delete(const std::vector<int64_t>& delete_ids) {
 }
 
 butil::Status VectorIndexFlat::Search(const std::vector<pb::common::VectorWithId>& vector_with_ids, uint32_t topk,
-                                      const std::vector<std::shared_ptr<FilterFunctor>>& filters, bool,
+                                      const std::vector<std::shared_ptr<FilterFunctor>>& filters, bool reconstruct,
                                       const pb::common::VectorSearchParameter&,
                                       std::vector<pb::index::VectorWithDistanceResult>& results) {
   if (vector_with_ids.empty()) {
@@ -198,15 +205,35 @@ butil::Status VectorIndexFlat::Search(const std::vector<pb::common::VectorWithId
   }
 
   VectorIndexUtils::FillSearchResult(vector_with_ids, topk, distances, labels, metric_type_, dimension_, results);
+  if (reconstruct && HoldsExactVectors()) {
+    ReconstructResults(results);
+  }
 
   DINGO_LOG(DEBUG) << fmt::format("[vector_index.flat][id({})] result size {}", Id(), results.size());
 
   return butil::Status::OK();
 }
 
+void VectorIndexFlat::ReconstructResults(std::vector<pb::index::VectorWithDistanceResult>& results) {
+  RWLockReadGuard guard(&rw_lock_);
+
+  for (auto& result : results) {
+    for (auto& vector_with_distance : *result.mutable_vector_with_distances()) {
+      auto* vector = vector_with_distance.mutable_vector_with_id()->mutable_vector();
+      int64_t vector_id = vector_with_distance.vector_with_id().id();
+      if (index_id_map2_->rev_map.find(vector_id) == index_id_map2_->rev_map.end()) {
+        continue;
+      }
+
+      vector->mutable_float_values()->Resize(dimension_, 0.0f);
+      index_id_map2_->reconstruct(vector_id, vector->mutable_float_values()->mutable_data());
+    }
+  }
+}
+
 butil::Status VectorIndexFlat::RangeSearch(const std::vector<pb::common::VectorWithId>& vector_with_ids, float radius,
                                            const std::vector<std::shared_ptr<VectorIndex::FilterFunctor>>& filters,
-                                           bool /*reconstruct*/, const pb::common::VectorSearchParameter& /*parameter*/,
+                                           bool reconstruct, const pb::common::VectorSearchParameter& /*parameter*/,
                                            std::vector<pb::index::VectorWithDistanceResult>& results) {
   if (vector_with_ids.empty()) {
     return butil::Status(pb::error::EILLEGAL_PARAMTETERS, "vector_with_ids is empty");
@@ -246,12 +273,165 @@ butil::Status VectorIndexFlat::RangeSearch(const std::vector<pb::common::VectorW
   }
 
   VectorIndexUtils::FillRangeSearchResult(range_search_result, metric_type_, dimension_, results);
+  if (reconstruct && HoldsExactVectors()) {
+    ReconstructResults(results);
+  }
 
   DINGO_LOG(DEBUG) << fmt::format("[vector_index.flat][id({})] result size {}", Id(), results.size());
 
   return butil::Status::OK();
 }
 
+// Filter of one chunk, faiss knn functions pass the offset in chunk.
+class FlatChunkIDSelector : public faiss::IDSelector {
+ public:
+  FlatChunkIDSelector(const faiss::idx_t* ids, const faiss::IDSelector* sel) : ids_(ids), sel_(sel) {}
+  ~FlatChunkIDSelector() override = default;
+  bool is_member(faiss::idx_t id) const override { return sel_->is_member(ids_[id]); }  // NOLINT
+
+ private:
+  const faiss::idx_t* ids_;
+  const faiss::IDSelector* sel_;
+};
+
+butil::Status VectorIndexFlat::SearchByChunk(const std::vector<pb::common::VectorWithId>& vector_with_ids,
+                                             uint32_t topk, const std::vector<std::shared_ptr<FilterFunctor>>& filters,
+                                             std::vector<pb::index::VectorWithDistanceResult>& results) {
+  if (thread_pool == nullptr || vector_with_ids.empty() || topk == 0 ||
+      vector_with_ids.size() > FLAGS_flat_chunk_search_max_query_count) {
+    return butil::Status(pb::error::Errno::EVECTOR_NOT_SUPPORT, "not suitable for search by chunk");
+  }
+  auto status = VectorIndexUtils::CheckVectorDimension(vector_with_ids, dimension_);
+  if (!status.ok()) {
+    return status;
+  }
+
+  size_t query_count = vector_with_ids.size();
+  const auto& vector_values = VectorIndexUtils::ExtractVectorValue(vector_with_ids, dimension_, normalize_);
+  auto flat_filter = filters.empty() ? nullptr : std::make_shared<FlatIDSelector>(filters);
+  bool is_l2 = metric_type_ != pb::common::MetricType::METRIC_TYPE_INNER_PRODUCT &&
+               metric_type_ != pb::common::MetricType::METRIC_TYPE_COSINE;
+
+  std::vector<faiss::Index::distance_t> distances(topk * query_count, 0.0f);
+  std::vector<faiss::idx_t> labels(topk * query_count, -1);
+
+  {
+    BvarLatencyGuard bvar_guard(&g_flat_chunk_search_latency);
+    // hold read lock across all chunks, remove_ids compacts the storage
+    RWLockReadGuard guard(&rw_lock_);
+
+    int64_t total = index_id_map2_->ntotal;
+    int64_t min_chunk_size = std::max(static_cast<int64_t>(1), FLAGS_flat_chunk_search_min_chunk_size);
+    int64_t chunk_num = std::min(static_cast<int64_t>(FLAGS_flat_chunk_search_max_chunk_num), total / min_chunk_size);
+    if (chunk_num < 2) {
+      return butil::Status(pb::error::Errno::EVECTOR_NOT_SUPPORT, "too few vectors for search by chunk");
+    }
+
+    auto* flat_index = dynamic_cast<faiss::IndexFlat*>(raw_index_.get());
+    if (flat_index == nullptr) {
+      return butil::Status(pb::error::Errno::EVECTOR_NOT_SUPPORT, "raw index is not flat");
+    }
+    const float* data = flat_index->get_xb();
+    const faiss::idx_t* ids = index_id_map2_->id_map.data();
+
+    // every chunk keeps its own topk heap and writes a faiss style sorted topk, no protobuf until final merge.
+    std::vector<std::vector<faiss::Index::distance_t>> chunk_distances(chunk_num);
+    std::vector<std::vector<faiss::idx_t>> chunk_labels(chunk_num);
+    std::vector<butil::Status> statuses(chunk_num);
+
+    auto search_chunk = [&](int64_t chunk) {
+      int64_t start = total * chunk / chunk_num;
+      int64_t end = total * (chunk + 1) / chunk_num;
+      auto& part_distances = chunk_distances[chunk];
+      auto& part_labels = chunk_labels[chunk];
+      part_distances.resize(topk * query_count);
+      part_labels.resize(topk * query_count, -1);
+
+      std::unique_ptr<FlatChunkIDSelector> chunk_filter;
+      if (flat_filter != nullptr) {
+        chunk_filter = std::make_unique<FlatChunkIDSelector>(ids + start, flat_filter.get());
+      }
+
+      try {
+        if (is_l2) {
+          faiss::knn_L2sqr(vector_values.get(), data + start * dimension_, dimension_, query_count, end - start, topk,
+                           part_distances.data(), part_labels.data(), nullptr, chunk_filter.get());
+        } else {
+          faiss::knn_inner_product(vector_values.get(), data + start * dimension_, dimension_, query_count,
+                                   end - start, topk, part_distances.data(), part_labels.data(), chunk_filter.get());
+        }
+      } catch (std::exception& e) {
+        statuses[chunk] = butil::Status(pb::error::Errno::EINTERNAL, fmt::format("search exception, {}", e.what()));
+        return;
+      }
+
+      for (auto& label : part_labels) {
+        if (label >= 0) {
+          label = ids[start + label];
+        }
+      }
+    };
+
+    std::vector<ThreadPool::TaskPtr> tasks;
+    for (int64_t chunk = 1; chunk < chunk_num; ++chunk) {
+      auto task = thread_pool->ExecuteTaskByNumaNode(Id(), [&, chunk](void*) { search_chunk(chunk); }, nullptr, 1);
+      if (task != nullptr) {
+        tasks.push_back(task);
+      } else {
+        search_chunk(chunk);
+      }
+    }
+    search_chunk(0);
+    for (auto& task : tasks) {
+      task->Join();
+    }
+
+    for (auto& chunk_status : statuses) {
+      if (!chunk_status.ok()) {
+        return chunk_status;
+      }
+    }
+
+    // merge sorted chunk topk, stop when topk taken or all chunks exhausted
+    std::vector<uint32_t> positions(chunk_num);
+    for (size_t row = 0; row < query_count; ++row) {
+      std::fill(positions.begin(), positions.end(), 0);
+      size_t offset = row * topk;
+      for (uint32_t k = 0; k < topk; ++k) {
+        int64_t best = -1;
+        for (int64_t chunk = 0; chunk < chunk_num; ++chunk) {
+          uint32_t pos = positions[chunk];
+          if (pos >= topk || chunk_labels[chunk][offset + pos] < 0) {
+            continue;
+          }
+          if (best < 0) {
+            best = chunk;
+            continue;
+          }
+          float distance = chunk_distances[chunk][offset + pos];
+          float best_distance = chunk_distances[best][offset + positions[best]];
+          if (is_l2 ? distance < best_distance : distance > best_distance) {
+            best = chunk;
+          }
+        }
+        if (best < 0) {
+          break;
+        }
+
+        distances[offset + k] = chunk_distances[best][offset + positions[best]];
+        labels[offset + k] = chunk_labels[best][offset + positions[best]];
+        ++positions[best];
+      }
+    }
+  }
+
+  VectorIndexUtils::FillSearchResult(vector_with_ids, topk, distances, labels, metric_type_, dimension_, results);
+
+  DINGO_LOG(DEBUG) << fmt::format("[vector_index.flat][id({})] chunk search result size {}", Id(), results.size());
+
+  return butil::Status::OK();
+}
+
 void VectorIndexFlat::LockWrite() { rw_lock_.LockWrite(); }
 
 void VectorIndexFlat::UnlockWrite() { rw_lock_.UnlockWrite(); }
@@ -288,7 +468,7 @@ butil::Status VectorIndexFlat::Load(const std::string& path) {
   // The outside has been locked. Remove the locking operation here.
   faiss::Index* internal_raw_index = nullptr;
   try {
-    internal_raw_index = faiss::read_index(path.c_str(), 0);
+    internal_raw_index = VectorIndexMmapReader::ReadIndex(path);
   } catch (std::exception& e) {
     delete internal_raw_index;
     return butil::Status(pb::error::Errno::EINTERNAL, fmt::format("read index exception: {} {}", path, e.what()));
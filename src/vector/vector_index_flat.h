@@ -92,6 +92,10 @@ class VectorIndexFlat : public VectorIndex {
                             const pb::common::VectorSearchParameter& parameter,
                             std::vector<pb::index::VectorWithDistanceResult>& results) override;
 
+  butil::Status SearchByChunk(const std::vector<pb::common::VectorWithId>& vector_with_ids, uint32_t topk,
+                              const std::vector<std::shared_ptr<FilterFunctor>>& filters,
+                              std::vector<pb::index::VectorWithDistanceResult>& results) override;
+
   void LockWrite() override;
   void UnlockWrite() override;
   bool SupportSave() override;
@@ -111,10 +115,15 @@ class VectorIndexFlat : public VectorIndex {
 
   bool NeedToSave(int64_t last_save_log_behind) override;
 
+  bool HoldsExactVectors() override { return !normalize_; }
+
  private:
   template <typename T>
   std::vector<faiss::idx_t> GetExistVectorIds(const T& ids, size_t size);
 
+  // fill the vector data of results from index, the vector deleted after search is left empty.
+  void ReconstructResults(std::vector<pb::index::VectorWithDistanceResult>& results);
+
   // Dimension of the elements
   faiss::idx_t dimension_;
 
@@ -0,0 +1,231 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifdef ENABLE_GPU
+
+#include "vector/vector_index_gpu_ivf_flat.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "bthread/mutex.h"
+#include "butil/compiler_specific.h"
+#include "butil/status.h"
+#include "common/constant.h"
+#include "common/helper.h"
+#include "common/logging.h"
+#include "faiss/IndexIVF.h"
+#include "faiss/gpu/GpuCloner.h"
+#include "faiss/gpu/GpuIndexIVFFlat.h"
+#include "faiss/gpu/utils/DeviceUtils.h"
+#include "fmt/core.h"
+#include "gflags/gflags.h"
+#include "proto/common.pb.h"
+#include "proto/error.pb.h"
+#include "proto/index.pb.h"
+#include "vector/vector_index_utils.h"
+
+namespace dingodb {
+
+DEFINE_bool(enable_vector_index_gpu, true, "enable serve ivf flat search from gpu when cuda device is available");
+DEFINE_int32(vector_index_gpu_device, 0, "cuda device of gpu vector index");
+DEFINE_int64(vector_index_gpu_refresh_interval_ms, 1000,
+             "min interval of rebuilding gpu replica after write, search use cpu index while replica is stale");
+
+bvar::LatencyRecorder g_gpu_ivf_flat_search_latency("dingo_gpu_ivf_flat_search_latency");
+bvar::LatencyRecorder g_gpu_ivf_flat_refresh_latency("dingo_gpu_ivf_flat_refresh_latency");
+
+// faiss gpu k-selection limit, both topk and nprobe
+static const uint32_t kGpuMaxSelection = 2048;
+
+VectorIndexGpuIvfFlat::VectorIndexGpuIvfFlat(int64_t id, const pb::common::VectorIndexParameter& vector_index_parameter,
+                                             const pb::common::RegionEpoch& epoch, const pb::common::Range& range,
+                                             ThreadPoolPtr thread_pool)
+    : VectorIndexIvfFlat(id, vector_index_parameter, epoch, range, thread_pool),
+      device_(FLAGS_vector_index_gpu_device) {
+  bthread_mutex_init(&gpu_mutex_, nullptr);
+  gpu_resources_ = std::make_unique<faiss::gpu::StandardGpuResources>();
+}
+
+VectorIndexGpuIvfFlat::~VectorIndexGpuIvfFlat() {
+  {
+    BAIDU_SCOPED_LOCK(gpu_mutex_);
+    gpu_index_.reset();
+  }
+  gpu_resources_.reset();
+  bthread_mutex_destroy(&gpu_mutex_);
+}
+
+bool VectorIndexGpuIvfFlat::IsDeviceAvailable() {
+  try {
+    return faiss::gpu::getNumDevices() > FLAGS_vector_index_gpu_device;
+  } catch (std::exception& e) {
+    DINGO_LOG(WARNING) << fmt::format("[vector_index.gpu_ivf_flat] get cuda device failed, {}", e.what());
+    return false;
+  }
+}
+
+butil::Status VectorIndexGpuIvfFlat::Load(const std::string& path) {
+  MarkDirty();
+  auto status = VectorIndexIvfFlat::Load(path);
+  MarkDirty();
+  return status;
+}
+
+// Writes mark dirty before and after, a refresh racing with the write can not miss it.
+butil::Status VectorIndexGpuIvfFlat::Add(const std::vector<pb::common::VectorWithId>& vector_with_ids) {
+  MarkDirty();
+  auto status = VectorIndexIvfFlat::Add(vector_with_ids);
+  MarkDirty();
+  return status;
+}
+
+butil::Status VectorIndexGpuIvfFlat::Upsert(const std::vector<pb::common::VectorWithId>& vector_with_ids) {
+  MarkDirty();
+  auto status = VectorIndexIvfFlat::Upsert(vector_with_ids);
+  MarkDirty();
+  return status;
+}
+
+butil::Status VectorIndexGpuIvfFlat::Delete(const std::vector<int64_t>& delete_ids) {
+  MarkDirty();
+  auto status = VectorIndexIvfFlat::Delete(delete_ids);
+  MarkDirty();
+  return status;
+}
+
+butil::Status VectorIndexGpuIvfFlat::Train(std::vector<float>& train_datas) {
+  MarkDirty();
+  auto status = VectorIndexIvfFlat::Train(train_datas);
+  MarkDirty();
+  return status;
+}
+
+butil::Status VectorIndexGpuIvfFlat::Train(const std::vector<pb::common::VectorWithId>& vectors) {
+  MarkDirty();
+  auto status = VectorIndexIvfFlat::Train(vectors);
+  MarkDirty();
+  return status;
+}
+
+bool VectorIndexGpuIvfFlat::RefreshGpuIndexIfNeed() {
+  if (!is_gpu_dirty_.load(std::memory_order_acquire)) {
+    return gpu_index_ != nullptr;
+  }
+
+  int64_t now_ms = Helper::TimestampMs();
+  if (gpu_index_ != nullptr && now_ms - last_refresh_time_ms_ < FLAGS_vector_index_gpu_refresh_interval_ms) {
+    return false;
+  }
+  last_refresh_time_ms_ = now_ms;
+
+  BvarLatencyGuard bvar_guard(&g_gpu_ivf_flat_refresh_latency);
+  // clear before copy, a write after this point marks dirty again.
+  is_gpu_dirty_.store(false, std::memory_order_release);
+  gpu_index_.reset();
+  try {
+    gpu_index_.reset(faiss::gpu::index_cpu_to_gpu(gpu_resources_.get(), device_, index_.get()));
+  } catch (std::exception& e) {
+    DINGO_LOG(ERROR) << fmt::format("[vector_index.gpu_ivf_flat][id({})] copy index to gpu failed, {}", Id(),
+                                    e.what());
+    gpu_index_.reset();
+    MarkDirty();
+    return false;
+  }
+
+  DINGO_LOG(INFO) << fmt::format("[vector_index.gpu_ivf_flat][id({})] refresh gpu index, count({}) elapsed({}ms)", Id(),
+                                 index_->ntotal, Helper::TimestampMs() - now_ms);
+  return true;
+}
+
+butil::Status VectorIndexGpuIvfFlat::SearchGpu(const std::vector<pb::common::VectorWithId>& vector_with_ids,
+                                               uint32_t topk, const pb::common::VectorSearchParameter& parameter,
+                                               std::vector<pb::index::VectorWithDistanceResult>& results,
+                                               bool& is_fallback) {
+  is_fallback = true;
+
+  int32_t nprobe =
+      parameter.ivf_flat().nprobe() > 0 ? parameter.ivf_flat().nprobe() : Constant::kSearchIvfFlatParamNprobe;
+
+  std::vector<faiss::Index::distance_t> distances;
+  std::vector<faiss::idx_t> labels;
+
+  {
+    RWLockReadGuard guard(&rw_lock_);
+
+    if (BAIDU_UNLIKELY(!IsTrainedImpl())) {
+      return butil::Status::OK();
+    }
+
+    nprobe = std::min(nprobe, static_cast<int32_t>(index_->nlist));
+    if (nprobe > kGpuMaxSelection) {
+      return butil::Status::OK();
+    }
+
+    const auto& vector_values = VectorIndexUtils::ExtractVectorValue(vector_with_ids, dimension_, normalize_);
+    distances.resize(topk * vector_with_ids.size(), 0.0f);
+    labels.resize(topk * vector_with_ids.size(), -1);
+
+    BAIDU_SCOPED_LOCK(gpu_mutex_);
+    if (!RefreshGpuIndexIfNeed()) {
+      return butil::Status::OK();
+    }
+
+    BvarLatencyGuard bvar_guard(&g_gpu_ivf_flat_search_latency);
+    faiss::SearchParametersIVF ivf_search_parameters;
+    ivf_search_parameters.nprobe = nprobe;
+    try {
+      gpu_index_->search(vector_with_ids.size(), vector_values.get(), topk, distances.data(), labels.data(),
+                         &ivf_search_parameters);
+    } catch (std::exception& e) {
+      DINGO_LOG(ERROR) << fmt::format("[vector_index.gpu_ivf_flat][id({})] gpu search failed, {}", Id(), e.what());
+      return butil::Status::OK();
+    }
+  }
+
+  is_fallback = false;
+  return VectorIndexUtils::FillSearchResult(vector_with_ids, topk, distances, labels, metric_type_, dimension_,
+                                            results);
+}
+
+butil::Status VectorIndexGpuIvfFlat::Search(const std::vector<pb::common::VectorWithId>& vector_with_ids,
+                                            uint32_t topk, const std::vector<std::shared_ptr<FilterFunctor>>& filters,
+                                            bool reconstruct, const pb::common::VectorSearchParameter& parameter,
+                                            std::vector<pb::index::VectorWithDistanceResult>& results) {
+  // filter need IDSelector, gpu index not support it.
+  if (vector_with_ids.empty() || topk == 0 || topk > kGpuMaxSelection || !filters.empty()) {
+    return VectorIndexIvfFlat::Search(vector_with_ids, topk, filters, reconstruct, parameter, results);
+  }
+
+  auto status = VectorIndexUtils::CheckVectorDimension(vector_with_ids, dimension_);
+  if (!status.ok()) {
+    return status;
+  }
+
+  bool is_fallback = true;
+  status = SearchGpu(vector_with_ids, topk, parameter, results, is_fallback);
+  if (!status.ok() || !is_fallback) {
+    return status;
+  }
+
+  return VectorIndexIvfFlat::Search(vector_with_ids, topk, filters, reconstruct, parameter, results);
+}
+
+}  // namespace dingodb
+
+#endif  // ENABLE_GPU
@@ -0,0 +1,99 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_VECTOR_INDEX_GPU_IVF_FLAT_H_  // NOLINT
+#define DINGODB_VECTOR_INDEX_GPU_IVF_FLAT_H_
+
+#ifdef ENABLE_GPU
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "bthread/types.h"
+#include "butil/status.h"
+#include "faiss/Index.h"
+#include "faiss/gpu/StandardGpuResources.h"
+#include "proto/common.pb.h"
+#include "vector/vector_index_ivf_flat.h"
+
+namespace dingodb {
+
+// IVF-Flat index which serves unfiltered knn search from a GPU replica.
+// The cpu index is still the source of truth for write/save/load/range search,
+// writes mark the replica dirty and it is rebuilt from the cpu index at most every
+// FLAGS_vector_index_gpu_refresh_interval_ms, searches use the cpu index meanwhile.
+class VectorIndexGpuIvfFlat : public VectorIndexIvfFlat {
+ public:
+  explicit VectorIndexGpuIvfFlat(int64_t id, const pb::common::VectorIndexParameter& vector_index_parameter,
+                                 const pb::common::RegionEpoch& epoch, const pb::common::Range& range,
+                                 ThreadPoolPtr thread_pool);
+
+  ~VectorIndexGpuIvfFlat() override;
+
+  VectorIndexGpuIvfFlat(const VectorIndexGpuIvfFlat& rhs) = delete;
+  VectorIndexGpuIvfFlat& operator=(const VectorIndexGpuIvfFlat& rhs) = delete;
+  VectorIndexGpuIvfFlat(VectorIndexGpuIvfFlat&& rhs) = delete;
+  VectorIndexGpuIvfFlat& operator=(VectorIndexGpuIvfFlat&& rhs) = delete;
+
+  // Has usable cuda device.
+  static bool IsDeviceAvailable();
+
+  butil::Status Load(const std::string& path) override;
+
+  butil::Status Add(const std::vector<pb::common::VectorWithId>& vector_with_ids) override;
+  butil::Status Upsert(const std::vector<pb::common::VectorWithId>& vector_with_ids) override;
+  butil::Status Delete(const std::vector<int64_t>& delete_ids) override;
+
+  butil::Status Search(const std::vector<pb::common::VectorWithId>& vector_with_ids, uint32_t topk,
+                       const std::vector<std::shared_ptr<FilterFunctor>>& filters, bool reconstruct,
+                       const pb::common::VectorSearchParameter& parameter,
+                       std::vector<pb::index::VectorWithDistanceResult>& results) override;
+
+  butil::Status Train(std::vector<float>& train_datas) override;
+  butil::Status Train(const std::vector<pb::common::VectorWithId>& vectors) override;
+
+  // one big batch is better than many small batches on gpu
+  bool IsSearchParallelInner() override { return true; }
+
+ private:
+  void MarkDirty() { is_gpu_dirty_.store(true, std::memory_order_release); }
+
+  // Rebuild gpu replica from cpu index if dirty and refresh interval reached, need hold rw_lock_ read.
+  // Return false if gpu replica is not usable.
+  bool RefreshGpuIndexIfNeed();
+
+  butil::Status SearchGpu(const std::vector<pb::common::VectorWithId>& vector_with_ids, uint32_t topk,
+                          const pb::common::VectorSearchParameter& parameter,
+                          std::vector<pb::index::VectorWithDistanceResult>& results, bool& is_fallback);
+
+  int device_;
+
+  std::unique_ptr<faiss::gpu::StandardGpuResources> gpu_resources_;
+
+  // protect gpu_index_ and last_refresh_time_ms_, gpu stream is not thread safe.
+  bthread_mutex_t gpu_mutex_;
+  std::unique_ptr<faiss::Index> gpu_index_;
+  int64_t last_refresh_time_ms_{0};
+
+  std::atomic<bool> is_gpu_dirty_{true};
+};
+
+}  // namespace dingodb
+
+#endif  // ENABLE_GPU
+
+#endif  // DINGODB_VECTOR_INDEX_GPU_IVF_FLAT_H_  // NOLINT
@@ -16,16 +16,24 @@
 
 #include <algorithm>
 #include <cassert>
+#include <cmath>
 #include <cstddef>
 #include <cstdint>
 #include <cstring>
+#include <functional>
 #include <memory>
+#include <mutex>
+#include <queue>
 #include <stdexcept>
 #include <string>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
+#include "butil/scoped_lock.h"
 #include "butil/status.h"
 #include "bvar/latency_recorder.h"
+#include "bvar/reducer.h"
 #include "common/constant.h"
 #include "common/helper.h"
 #include "common/logging.h"
@@ -35,7 +43,9 @@
 #include "gflags/gflags.h"
 #include "proto/common.pb.h"
 #include "proto/error.pb.h"
+#include "simd/hook.h"
 #include "vector/vector_index.h"
+#include "vector/vector_index_snapshot_manager.h"
 #include "vector/vector_index_utils.h"
 
 namespace dingodb {
@@ -51,6 +61,16 @@ DEFINE_uint32(hnsw_max_elements_amplification_multiple, 1, "hnsw max elements am
 DECLARE_int64(vector_max_batch_count);
 
 DEFINE_uint32(hnsw_vector_write_batch_size_per_task, 16, "hnsw vector write batch size per task");
+DEFINE_string(hnsw_vector_storage_type, "float32",
+              "hnsw vector storage type, float32/fp16/bf16/sq8, must be same on coordinator and store");
+DEFINE_uint32(hnsw_sq8_rerank_multiple, 4,
+              "hnsw sq8 search fetch topk * multiple candidates and rerank them with raw vectors, 0 means no rerank");
+DEFINE_bool(hnsw_enable_replace_deleted, false,
+            "new vector reuse the slot of deleted vector and repair its neighbors instead of growing the graph");
+DEFINE_bool(hnsw_enable_expand_without_block_search, false,
+            "expand max elements on a copy of hnsw index while searches go on, instead of resize in place");
+DEFINE_double(hnsw_filtered_search_max_selectivity, 0.0,
+              "use filter-aware traversal when the filter candidates / element count not exceed it, 0 disable");
 DECLARE_uint32(vector_read_batch_size_per_task);
 DECLARE_uint32(parallel_log_threshold_time_ms);
 
@@ -59,6 +79,9 @@ bvar::LatencyRecorder g_hnsw_search_latency("dingo_hnsw_search_latency");
 bvar::LatencyRecorder g_hnsw_range_search_latency("dingo_hnsw_range_search_latency");
 bvar::LatencyRecorder g_hnsw_delete_latency("dingo_hnsw_delete_latency");
 bvar::LatencyRecorder g_hnsw_load_latency("dingo_hnsw_load_latency");
+bvar::Adder<int64_t> g_hnsw_replace_deleted_count("dingo_hnsw_replace_deleted_count");
+bvar::LatencyRecorder g_hnsw_expand_latency("dingo_hnsw_expand_latency");
+bvar::Adder<int64_t> g_hnsw_filtered_search_count("dingo_hnsw_filtered_search_count");
 
 // Filter vecotr id used by region range.
 class HnswRangeFilterFunctor : public hnswlib::BaseFilterFunctor {
@@ -82,6 +105,243 @@ class HnswRangeFilterFunctor : public hnswlib::BaseFilterFunctor {
   std::vector<std::shared_ptr<VectorIndex::FilterFunctor>> filters_;
 };
 
+// Filter-aware knn search (ACORN-1 style), for the restrictive filter whose matched nodes are poorly connected.
+// Upper levels are searched greedily like hnswlib. On level 0 only the matched nodes enter the candidate queue, when
+// a neighbor fails the filter its own neighbors are examined instead, so the traversal goes on through the two hop
+// neighborhood of the predicate subgraph rather than stopping at rejected nodes.
+static std::priority_queue<std::pair<float, hnswlib::labeltype>> FilteredSearchKnn(
+    hnswlib::HierarchicalNSW<float>* index, const void* query, size_t k, hnswlib::BaseFilterFunctor* filter) {
+  std::priority_queue<std::pair<float, hnswlib::labeltype>> result;
+  if (index->cur_element_count == 0) {
+    return result;
+  }
+
+  auto distance = [index, query](hnswlib::tableint id) {
+    return index->fstdistfunc_(query, index->getDataByInternalId(id), index->dist_func_param_);
+  };
+
+  hnswlib::tableint cur_obj = index->enterpoint_node_;
+  float cur_dist = distance(cur_obj);
+  for (int level = index->maxlevel_; level > 0; level--) {
+    bool changed = true;
+    while (changed) {
+      changed = false;
+      auto* linklist = reinterpret_cast<hnswlib::linklistsizeint*>(index->get_linklist(cur_obj, level));
+      int size = index->getListCount(linklist);
+      auto* neighbors = reinterpret_cast<hnswlib::tableint*>(linklist + 1);
+      for (int i = 0; i < size; i++) {
+        float dist = distance(neighbors[i]);
+        if (dist < cur_dist) {
+          cur_dist = dist;
+          cur_obj = neighbors[i];
+          changed = true;
+        }
+      }
+    }
+  }
+
+  size_t ef = std::max(index->ef_, k);
+  auto* visited_list = index->visited_list_pool_->getFreeVisitedList();
+  hnswlib::vl_type* visited = visited_list->mass;
+  hnswlib::vl_type visited_tag = visited_list->curV;
+
+  using Candidate = std::pair<float, hnswlib::tableint>;
+  // nearest first
+  std::priority_queue<Candidate, std::vector<Candidate>, std::greater<>> candidates;
+  // farthest first, the matched and not deleted nodes
+  std::priority_queue<Candidate> top_candidates;
+
+  auto is_match = [index, filter](hnswlib::tableint id) {
+    return filter == nullptr || (*filter)(index->getExternalLabel(id));
+  };
+  auto consider = [&](hnswlib::tableint id) {
+    float dist = distance(id);
+    if (top_candidates.size() < ef || dist < top_candidates.top().first) {
+      candidates.emplace(dist, id);
+      if (!index->isMarkedDeleted(id)) {
+        top_candidates.emplace(dist, id);
+        if (top_candidates.size() > ef) {
+          top_candidates.pop();
+        }
+      }
+    }
+  };
+
+  // the entry point is traversed even if not matched
+  visited[cur_obj] = visited_tag;
+  candidates.emplace(cur_dist, cur_obj);
+  if (is_match(cur_obj) && !index->isMarkedDeleted(cur_obj)) {
+    top_candidates.emplace(cur_dist, cur_obj);
+  }
+
+  while (!candidates.empty()) {
+    auto [dist, id] = candidates.top();
+    if (top_candidates.size() >= ef && dist > top_candidates.top().first) {
+      break;
+    }
+    candidates.pop();
+
+    auto* linklist = index->get_linklist0(id);
+    int size = index->getListCount(linklist);
+    auto* neighbors = reinterpret_cast<hnswlib::tableint*>(linklist + 1);
+    for (int i = 0; i < size; i++) {
+      hnswlib::tableint neighbor = neighbors[i];
+      if (visited[neighbor] == visited_tag) {
+        continue;
+      }
+      visited[neighbor] = visited_tag;
+
+      if (is_match(neighbor)) {
+        consider(neighbor);
+        continue;
+      }
+
+      // expand the neighbors of rejected neighbor
+      auto* hop_linklist = index->get_linklist0(neighbor);
+      int hop_size = index->getListCount(hop_linklist);
+      auto* hop_neighbors = reinterpret_cast<hnswlib::tableint*>(hop_linklist + 1);
+      for (int j = 0; j < hop_size; j++) {
+        hnswlib::tableint hop_neighbor = hop_neighbors[j];
+        if (visited[hop_neighbor] != visited_tag && is_match(hop_neighbor)) {
+          visited[hop_neighbor] = visited_tag;
+          consider(hop_neighbor);
+        }
+      }
+    }
+  }
+
+  index->visited_list_pool_->releaseVisitedList(visited_list);
+
+  while (top_candidates.size() > k) {
+    top_candidates.pop();
+  }
+  for (; !top_candidates.empty(); top_candidates.pop()) {
+    result.emplace(top_candidates.top().first, index->getExternalLabel(top_candidates.top().second));
+  }
+
+  return result;
+}
+
+// hnswlib space over half precision vectors, the graph node data is dimension * 2 bytes.
+// Inner product distance follows hnswlib InnerProductSpace, which is 1 - ip.
+class HnswHalfSpace : public hnswlib::SpaceInterface<float> {
+ public:
+  HnswHalfSpace(size_t dimension, HnswStorageType storage_type, bool is_inner_product)
+      : dimension_(dimension), data_size_(dimension * sizeof(uint16_t)) {
+    if (storage_type == HnswStorageType::kBf16) {
+      dist_func_ = is_inner_product ? Bf16InnerProductDistance : Bf16L2Distance;
+    } else {
+      dist_func_ = is_inner_product ? Fp16InnerProductDistance : Fp16L2Distance;
+    }
+  }
+  ~HnswHalfSpace() override = default;
+
+  size_t get_data_size() override { return data_size_; }
+  hnswlib::DISTFUNC<float> get_dist_func() override { return dist_func_; }
+  void* get_dist_func_param() override { return &dimension_; }
+
+ private:
+  static float Fp16L2Distance(const void* x, const void* y, const void* param) {
+    return fp16vec_L2sqr(static_cast<const uint16_t*>(x), static_cast<const uint16_t*>(y),
+                         *static_cast<const size_t*>(param));
+  }
+  static float Fp16InnerProductDistance(const void* x, const void* y, const void* param) {
+    return 1.0f - fp16vec_inner_product(static_cast<const uint16_t*>(x), static_cast<const uint16_t*>(y),
+                                        *static_cast<const size_t*>(param));
+  }
+  static float Bf16L2Distance(const void* x, const void* y, const void* param) {
+    return bf16vec_L2sqr(static_cast<const uint16_t*>(x), static_cast<const uint16_t*>(y),
+                         *static_cast<const size_t*>(param));
+  }
+  static float Bf16InnerProductDistance(const void* x, const void* y, const void* param) {
+    return 1.0f - bf16vec_inner_product(static_cast<const uint16_t*>(x), static_cast<const uint16_t*>(y),
+                                        *static_cast<const size_t*>(param));
+  }
+
+  size_t dimension_;
+  size_t data_size_;
+  hnswlib::DISTFUNC<float> dist_func_;
+};
+
+// sq8 graph node layout: [float scale][float norm_sqr][int8 code * dimension].
+// Each vector is quantized symmetrically by its own max abs value, so no training is needed.
+struct Sq8Header {
+  float scale;
+  float norm_sqr;
+};
+
+static void Sq8Encode(const float* data, size_t dimension, uint8_t* code) {
+  float max_abs = 0.0f;
+  for (size_t i = 0; i < dimension; ++i) {
+    max_abs = std::max(max_abs, std::fabs(data[i]));
+  }
+
+  Sq8Header header{max_abs / 127.0f, 0.0f};
+  int8_t* values = reinterpret_cast<int8_t*>(code + sizeof(Sq8Header));
+  float inv_scale = header.scale > 0.0f ? 1.0f / header.scale : 0.0f;
+  int64_t norm_sqr = 0;
+  for (size_t i = 0; i < dimension; ++i) {
+    int32_t value = static_cast<int32_t>(std::lround(data[i] * inv_scale));
+    value = std::clamp(value, -127, 127);
+    values[i] = static_cast<int8_t>(value);
+    norm_sqr += value * value;
+  }
+  // norm of the dequantized vector, keep l2 distance of identical codes zero
+  header.norm_sqr = header.scale * header.scale * static_cast<float>(norm_sqr);
+
+  memcpy(code, &header, sizeof(Sq8Header));
+}
+
+static void Sq8Decode(const uint8_t* code, size_t dimension, float* data) {
+  Sq8Header header;
+  memcpy(&header, code, sizeof(Sq8Header));
+  const int8_t* values = reinterpret_cast<const int8_t*>(code + sizeof(Sq8Header));
+  for (size_t i = 0; i < dimension; ++i) {
+    data[i] = header.scale * values[i];
+  }
+}
+
+// hnswlib space over sq8 vectors.
+// The first field of dist func param is read by hnswlib getDataByLabel as element count, so it is the data size.
+class HnswSq8Space : public hnswlib::SpaceInterface<float> {
+ public:
+  HnswSq8Space(size_t dimension, bool is_inner_product)
+      : param_{dimension + sizeof(Sq8Header), dimension},
+        dist_func_(is_inner_product ? InnerProductDistance : L2Distance) {}
+  ~HnswSq8Space() override = default;
+
+  size_t get_data_size() override { return param_.data_size; }
+  hnswlib::DISTFUNC<float> get_dist_func() override { return dist_func_; }
+  void* get_dist_func_param() override { return &param_; }
+
+ private:
+  struct Param {
+    size_t data_size;
+    size_t dimension;
+  };
+
+  static float L2Distance(const void* x, const void* y, const void* param) {
+    const auto* header_x = static_cast<const Sq8Header*>(x);
+    const auto* header_y = static_cast<const Sq8Header*>(y);
+    int32_t ip = i8vec_inner_product(reinterpret_cast<const int8_t*>(header_x + 1),
+                                     reinterpret_cast<const int8_t*>(header_y + 1),
+                                     static_cast<const Param*>(param)->dimension);
+    float distance = header_x->norm_sqr + header_y->norm_sqr - 2.0f * header_x->scale * header_y->scale * ip;
+    return std::max(distance, 0.0f);
+  }
+  static float InnerProductDistance(const void* x, const void* y, const void* param) {
+    const auto* header_x = static_cast<const Sq8Header*>(x);
+    const auto* header_y = static_cast<const Sq8Header*>(y);
+    int32_t ip = i8vec_inner_product(reinterpret_cast<const int8_t*>(header_x + 1),
+                                     reinterpret_cast<const int8_t*>(header_y + 1),
+                                     static_cast<const Param*>(param)->dimension);
+    return 1.0f - header_x->scale * header_y->scale * ip;
+  }
+
+  Param param_;
+  hnswlib::DISTFUNC<float> dist_func_;
+};
+
 template <typename Function>
 inline void ParallelFor(ThreadPoolPtr thread_pool, int64_t vector_index_id, size_t start, size_t end,
                         uint32_t batch_size, bool is_priority, Function fn) {
@@ -99,7 +359,8 @@ inline void ParallelFor(ThreadPoolPtr thread_pool, int64_t vector_index_id, size
       param->start_pos = i;
       param->end_pos = std::min(i + batch_size, end);
 
-      auto task = thread_pool->ExecuteTask(
+      auto task = thread_pool->ExecuteTaskByNumaNode(
+          vector_index_id,
           [&](void* arg) {
             Parameter* param = static_cast<Parameter*>(arg);
             for (int j = param->start_pos; j < param->end_pos; ++j) {
@@ -150,7 +411,18 @@ VectorIndexHnsw::VectorIndexHnsw(int64_t id, const pb::common::VectorIndexParame
 
     normalize_ = false;
 
-    if (hnsw_parameter.metric_type() == pb::common::MetricType::METRIC_TYPE_INNER_PRODUCT) {
+    storage_type_ = GetStorageTypeFromFlag();
+
+    if (storage_type_ != HnswStorageType::kFloat32) {
+      normalize_ = hnsw_parameter.metric_type() == pb::common::MetricType::METRIC_TYPE_COSINE;
+      bool is_inner_product = hnsw_parameter.metric_type() == pb::common::MetricType::METRIC_TYPE_INNER_PRODUCT ||
+                              hnsw_parameter.metric_type() == pb::common::MetricType::METRIC_TYPE_COSINE;
+      if (storage_type_ == HnswStorageType::kSq8) {
+        hnsw_space_ = new HnswSq8Space(hnsw_parameter.dimension(), is_inner_product);
+      } else {
+        hnsw_space_ = new HnswHalfSpace(hnsw_parameter.dimension(), storage_type_, is_inner_product);
+      }
+    } else if (hnsw_parameter.metric_type() == pb::common::MetricType::METRIC_TYPE_INNER_PRODUCT) {
       hnsw_space_ = new hnswlib::InnerProductSpace(hnsw_parameter.dimension());
     } else if (hnsw_parameter.metric_type() == pb::common::MetricType::METRIC_TYPE_COSINE) {
       normalize_ = true;
@@ -166,14 +438,14 @@ VectorIndexHnsw::VectorIndexHnsw(int64_t id, const pb::common::VectorIndexParame
     DINGO_LOG(INFO) << fmt::format(
         "[vector_index.hnsw][id({})] create index, init_max_elements={} max_element_limit={} nlinks={} "
         "efconstruction={} "
-        "metric_type={} dimension={}",
+        "metric_type={} dimension={} storage_type={}",
         Id(), FLAGS_hnsw_max_init_max_elements, max_element_limit_, hnsw_parameter.nlinks(),
         hnsw_parameter.efconstruction(), pb::common::MetricType_Name(hnsw_parameter.metric_type()),
-        hnsw_parameter.dimension());
+        hnsw_parameter.dimension(), static_cast<int>(storage_type_));
 
     hnsw_index_ =
         new hnswlib::HierarchicalNSW<float>(hnsw_space_, FLAGS_hnsw_max_init_max_elements, hnsw_parameter.nlinks(),
-                                            hnsw_parameter.efconstruction(), 100, false);
+                                            hnsw_parameter.efconstruction(), 100, FLAGS_hnsw_enable_replace_deleted);
   }
 }
 
@@ -205,12 +477,18 @@ butil::Status VectorIndexHnsw::Upsert(const std::vector<pb::common::VectorWithId
   }
 
   BvarLatencyGuard bvar_guard(&g_hnsw_upsert_latency);
+  BAIDU_SCOPED_LOCK(write_mutex_);
+
+  auto batch_count = std::max(FLAGS_vector_max_batch_count, static_cast<int64_t>(vector_with_ids.size()));
+  if (FLAGS_hnsw_enable_expand_without_block_search) {
+    ExpandWithoutBlockSearch(batch_count * 2);
+  }
+
   RWLockWriteGuard guard(&rw_lock_);
 
   // Add data to index
   try {
     // check if we need to expand the max_elements
-    auto batch_count = std::max(FLAGS_vector_max_batch_count, static_cast<int64_t>(vector_with_ids.size()));
     if (hnsw_index_->cur_element_count + batch_count * 2 > hnsw_index_->max_elements_) {
       auto new_max_elements = hnsw_index_->max_elements_ * 2;
       DINGO_LOG(INFO) << fmt::format("[vector_index.hnsw][id({})] expand max element, {} -> {}.", Id(),
@@ -219,22 +497,10 @@ butil::Status VectorIndexHnsw::Upsert(const std::vector<pb::common::VectorWithId
       hnsw_index_->resizeIndex(new_max_elements);
     }
 
-    if (!normalize_) {
-      ParallelFor(thread_pool, Id(), 0, vector_with_ids.size(), FLAGS_hnsw_vector_write_batch_size_per_task,
-                  is_priority, [&](size_t row) {
-                    this->hnsw_index_->addPoint((void*)vector_with_ids[row].vector().float_values().data(),
-                                                vector_with_ids[row].id(), false);
-                  });
+    if (hnsw_index_->allow_replace_deleted_ && hnsw_index_->getDeletedCount() > 0) {
+      ReplaceDeletedPoints(vector_with_ids, is_priority);
     } else {
-      ParallelFor(thread_pool, Id(), 0, vector_with_ids.size(), FLAGS_hnsw_vector_write_batch_size_per_task,
-                  is_priority, [&](size_t row) {
-                    // normalize vector
-                    std::vector<float> norm_array(dimension_);
-                    VectorIndexUtils::NormalizeVectorForHnsw(
-                        (float*)vector_with_ids[row].vector().float_values().data(), dimension_, norm_array.data());
-
-                    this->hnsw_index_->addPoint((void*)norm_array.data(), vector_with_ids[row].id(), false);
-                  });
+      AddPoints(vector_with_ids, is_priority);
     }
     return butil::Status();
   } catch (std::runtime_error& e) {
@@ -247,6 +513,173 @@ butil::Status VectorIndexHnsw::Upsert(const std::vector<pb::common::VectorWithId
   }
 }
 
+void VectorIndexHnsw::AddPoints(const std::vector<pb::common::VectorWithId>& vector_with_ids, bool is_priority) {
+  if (!normalize_ && storage_type_ == HnswStorageType::kFloat32) {
+    ParallelFor(thread_pool, Id(), 0, vector_with_ids.size(), FLAGS_hnsw_vector_write_batch_size_per_task,
+                is_priority, [&](size_t row) {
+                  this->hnsw_index_->addPoint((void*)vector_with_ids[row].vector().float_values().data(),
+                                              vector_with_ids[row].id(), false);
+                });
+  } else {
+    ParallelFor(thread_pool, Id(), 0, vector_with_ids.size(), FLAGS_hnsw_vector_write_batch_size_per_task,
+                is_priority, [&](size_t row) {
+                  // normalize and encode vector
+                  std::vector<float> norm_array;
+                  std::vector<uint8_t> code_array;
+                  const void* data =
+                      PrepareVector(vector_with_ids[row].vector().float_values().data(), norm_array, code_array);
+
+                  this->hnsw_index_->addPoint(data, vector_with_ids[row].id(), false);
+                });
+  }
+}
+
+void VectorIndexHnsw::ReplaceDeletedPoints(const std::vector<pb::common::VectorWithId>& vector_with_ids,
+                                           bool is_priority) {
+  // hnswlib don't look up the label when replace deleted, so keep the last one of the same id.
+  std::unordered_map<int64_t, size_t> last_rows;
+  for (size_t row = 0; row < vector_with_ids.size(); ++row) {
+    last_rows[vector_with_ids[row].id()] = row;
+  }
+
+  std::vector<size_t> rows;
+  std::vector<bool> is_replaces;
+  rows.reserve(last_rows.size());
+  is_replaces.reserve(last_rows.size());
+  int64_t replace_count = 0;
+  for (size_t row = 0; row < vector_with_ids.size(); ++row) {
+    int64_t id = vector_with_ids[row].id();
+    if (last_rows[id] != row) {
+      continue;
+    }
+
+    bool is_exist = false;
+    bool is_deleted = false;
+    {
+      std::unique_lock<std::mutex> lock(hnsw_index_->label_lookup_lock);
+      auto it = hnsw_index_->label_lookup_.find(id);
+      if (it != hnsw_index_->label_lookup_.end()) {
+        is_exist = true;
+        is_deleted = hnsw_index_->isMarkedDeleted(it->second);
+      }
+    }
+
+    // re-added id is updated in its own slot, take it out of the deleted slots first
+    if (is_deleted) {
+      hnsw_index_->unmarkDelete(id);
+    }
+
+    rows.push_back(row);
+    is_replaces.push_back(!is_exist);
+    replace_count += is_exist ? 0 : 1;
+  }
+
+  ParallelFor(thread_pool, Id(), 0, rows.size(), FLAGS_hnsw_vector_write_batch_size_per_task, is_priority,
+              [&](size_t i) {
+                const auto& vector_with_id = vector_with_ids[rows[i]];
+                std::vector<float> norm_array;
+                std::vector<uint8_t> code_array;
+                const void* data = PrepareVector(vector_with_id.vector().float_values().data(), norm_array, code_array);
+
+                this->hnsw_index_->addPoint(data, vector_with_id.id(), is_replaces[i]);
+              });
+
+  g_hnsw_replace_deleted_count << replace_count;
+}
+
+bool VectorIndexHnsw::ExpandWithoutBlockSearch(int64_t reserve_count) {
+  // Caller hold write_mutex_, so the index only be read by searches while copying.
+  // The parallel builders change index under read lock, leave them to resize in place.
+  if (build_inflight_count_.load() > 0) {
+    return false;
+  }
+  if (hnsw_index_->cur_element_count + reserve_count <= hnsw_index_->max_elements_) {
+    return true;
+  }
+
+  BvarLatencyGuard bvar_guard(&g_hnsw_expand_latency);
+  auto new_max_elements = hnsw_index_->max_elements_ * 2;
+  DINGO_LOG(INFO) << fmt::format("[vector_index.hnsw][id({})] expand max element by copy, {} -> {}.", Id(),
+                                 hnsw_index_->max_elements_, new_max_elements);
+
+  // Copy index by save and load with larger max elements.
+  std::string parent_path = VectorIndexSnapshotManager::GetSnapshotParentPath(Id());
+  std::string path = fmt::format("{}/expand_{}.idx", parent_path, Helper::TimestampNs());
+  hnswlib::HierarchicalNSW<float>* new_hnsw_index = nullptr;
+  try {
+    auto status = Helper::CreateDirectories(parent_path);
+    if (!status.ok()) {
+      DINGO_LOG(WARNING) << fmt::format("[vector_index.hnsw][id({})] create directory {} failed, error: {}", Id(),
+                                        parent_path, status.error_str());
+      return false;
+    }
+    hnsw_index_->saveIndex(path);
+    new_hnsw_index = new hnswlib::HierarchicalNSW<float>(hnsw_space_, path, false, new_max_elements,
+                                                         hnsw_index_->allow_replace_deleted_);
+  } catch (std::runtime_error& e) {
+    DINGO_LOG(WARNING) << fmt::format("[vector_index.hnsw][id({})] expand by copy failed, error: {}", Id(), e.what());
+    delete new_hnsw_index;
+    Helper::RemoveFileOrDirectory(path);
+    return false;
+  }
+  Helper::RemoveFileOrDirectory(path);
+
+  // Searches only wait for switching pointer.
+  auto* old_hnsw_index = hnsw_index_;
+  {
+    RWLockWriteGuard guard(&rw_lock_);
+    hnsw_index_ = new_hnsw_index;
+  }
+  delete old_hnsw_index;
+
+  return true;
+}
+
+butil::Status VectorIndexHnsw::BuildAdd(const std::vector<pb::common::VectorWithId>& vector_with_ids) {
+  if (vector_with_ids.empty()) {
+    return butil::Status(pb::error::EILLEGAL_PARAMTETERS, "vector_with_ids is empty");
+  }
+
+  auto status = VectorIndexUtils::CheckVectorDimension(vector_with_ids, dimension_);
+  if (!status.ok()) {
+    return status;
+  }
+
+  BvarLatencyGuard bvar_guard(&g_hnsw_upsert_latency);
+
+  // Builders share the read lock while inserting, hnswlib node locks protect the graph.
+  // Count in-flight elements so that concurrent builders never overrun max_elements_.
+  int64_t batch_count = vector_with_ids.size();
+  build_inflight_count_.fetch_add(batch_count);
+  ON_SCOPE_EXIT([&]() { build_inflight_count_.fetch_sub(batch_count); });
+
+  try {
+    for (;;) {
+      {
+        RWLockReadGuard guard(&rw_lock_);
+        if (hnsw_index_->cur_element_count + build_inflight_count_.load() <= hnsw_index_->max_elements_) {
+          AddPoints(vector_with_ids, false);
+          return butil::Status();
+        }
+      }
+
+      RWLockWriteGuard guard(&rw_lock_);
+      int64_t need_element_count = hnsw_index_->cur_element_count + build_inflight_count_.load();
+      if (need_element_count > hnsw_index_->max_elements_) {
+        auto new_max_elements = std::max(hnsw_index_->max_elements_ * 2, static_cast<size_t>(need_element_count) * 2);
+        DINGO_LOG(INFO) << fmt::format("[vector_index.hnsw][id({})] build expand max element, {} -> {}.", Id(),
+                                       hnsw_index_->max_elements_, new_max_elements);
+        hnsw_index_->resizeIndex(new_max_elements);
+      }
+    }
+  } catch (std::runtime_error& e) {
+    std::string s = fmt::format("build add failed, current_element_count({}) max_element_count({}) error: {}",
+                                hnsw_index_->getCurrentElementCount(), hnsw_index_->getMaxElements(), e.what());
+    DINGO_LOG(ERROR) << fmt::format("[vector_index.hnsw][id({})] {}", Id(), s);
+    return butil::Status(pb::error::Errno::EINTERNAL, s);
+  }
+}
+
 butil::Status VectorIndexHnsw::Delete(const std::vector<int64_t>& delete_ids) { return Delete(delete_ids, true); }
 
 butil::Status VectorIndexHnsw::Delete(const std::vector<int64_t>& delete_ids, bool is_priority) {
@@ -257,6 +690,7 @@ butil::Status VectorIndexHnsw::Delete(const std::vector<int64_t>& delete_ids, bo
   butil::Status ret;
 
   BvarLatencyGuard bvar_guard(&g_hnsw_delete_latency);
+  BAIDU_SCOPED_LOCK(write_mutex_);
   RWLockWriteGuard guard(&rw_lock_);
 
   // Add data to index
@@ -301,7 +735,19 @@ butil::Status VectorIndexHnsw::Load(const std::string& path) {
     auto* old_hnsw_index = hnsw_index_;
     uint32_t actual_max_elements =
         vector_index_parameter.hnsw_parameter().max_elements() + Constant::kHnswMaxElementsExpandNum;
-    hnsw_index_ = new hnswlib::HierarchicalNSW<float>(hnsw_space_, path, false, actual_max_elements, true);
+    auto* new_hnsw_index =
+        new hnswlib::HierarchicalNSW<float>(hnsw_space_, path, false, actual_max_elements, true);
+
+    // snapshot saved with another storage type, let caller rebuild index
+    if (BAIDU_UNLIKELY(new_hnsw_index->label_offset_ - new_hnsw_index->offsetData_ != hnsw_space_->get_data_size())) {
+      std::string s = fmt::format("storage type not match, snapshot data size({}) space data size({})",
+                                  new_hnsw_index->label_offset_ - new_hnsw_index->offsetData_,
+                                  hnsw_space_->get_data_size());
+      delete new_hnsw_index;
+      return butil::Status(pb::error::Errno::EINTERNAL, s);
+    }
+
+    hnsw_index_ = new_hnsw_index;
     delete old_hnsw_index;
     return butil::Status::OK();
   } else {
@@ -334,6 +780,9 @@ butil::Status VectorIndexHnsw::Search(const std::vector<pb::common::VectorWithId
     return status;
   }
 
+  // the decoded vector of lossy storage is not the raw vector, it's read from data cf by caller.
+  reconstruct = reconstruct && HoldsExactVectors();
+
   butil::Status ret;
 
   std::unique_ptr<float[]> data = std::make_unique<float[]>(this->dimension_ * vector_with_ids.size());
@@ -376,15 +825,15 @@ butil::Status VectorIndexHnsw::Search(const std::vector<pb::common::VectorWithId
 
       if (reconstruct) {
         try {
-          std::vector<float> data = hnsw_index_->getDataByLabel<float>(data_label[row * topk + i]);
+          std::vector<float> data = GetFloatDataByLabel(data_label[row * topk + i]);
           for (auto& value : data) {
             vector_with_id->mutable_vector()->add_float_values(value);
           }
         } catch (std::exception& e) {
-          std::string s =
-              fmt::format("getDataByLabel failed, label: {}  err: {}", data_label[row * topk + i], e.what());
-          LOG(ERROR) << fmt::format("[vector_index.hnsw][id({})] {}", Id(), s);
-          return butil::Status(pb::error::Errno::EINTERNAL, s);
+          // e.g. deleted after search, the vector data is left empty and read from data cf by caller.
+          vector_with_id->mutable_vector()->clear_float_values();
+          DINGO_LOG(WARNING) << fmt::format("[vector_index.hnsw][id({})] getDataByLabel failed, label: {} err: {}",
+                                            Id(), data_label[row * topk + i], e.what());
         }
       }
     }
@@ -421,13 +870,25 @@ butil::Status VectorIndexHnsw::Search(const std::vector<pb::common::VectorWithId
     hnsw_index_->setEf(search_parameter.hnsw().efsearch());
   }
 
+  bool use_filtered_search = hnsw_filter != nullptr && IsRestrictiveFilter(filters);
+  if (use_filtered_search) {
+    g_hnsw_filtered_search_count << 1;
+  }
+  auto search_knn = [&](const void* query) {
+    return use_filtered_search ? FilteredSearchKnn(hnsw_index_, query, topk, hnsw_filter.get())
+                               : hnsw_index_->searchKnn(query, topk, hnsw_filter.get());
+  };
+
   if (!normalize_) {
     ParallelFor(thread_pool, Id(), 0, vector_with_ids.size(), FLAGS_vector_read_batch_size_per_task, true,
                 [&](size_t row) {
                   std::priority_queue<std::pair<float, hnswlib::labeltype>> result;
 
                   try {
-                    result = hnsw_index_->searchKnn(data.get() + dimension_ * row, topk, hnsw_filter.get());
+                    std::vector<float> norm_array;
+                    std::vector<uint8_t> code_array;
+                    const void* query = PrepareVector(data.get() + dimension_ * row, norm_array, code_array);
+                    result = search_knn(query);
                   } catch (std::runtime_error& e) {
                     std::string s = fmt::format("parallel search vector failed, error: {}", e.what());
                     LOG(ERROR) << fmt::format("[vector_index.hnsw][id({})] {}", Id(), s);
@@ -443,14 +904,14 @@ butil::Status VectorIndexHnsw::Search(const std::vector<pb::common::VectorWithId
   } else {  // normalize_
     ParallelFor(
         thread_pool, Id(), 0, vector_with_ids.size(), FLAGS_vector_read_batch_size_per_task, true, [&](size_t row) {
-          std::vector<float> norm_array(dimension_);
-          VectorIndexUtils::NormalizeVectorForHnsw((float*)(data.get() + dimension_ * row), dimension_,  // NOLINT
-                                                   norm_array.data());
+          std::vector<float> norm_array;
+          std::vector<uint8_t> code_array;
+          const void* query = PrepareVector(data.get() + dimension_ * row, norm_array, code_array);
 
           std::priority_queue<std::pair<float, hnswlib::labeltype>> result;
 
           try {
-            result = hnsw_index_->searchKnn(norm_array.data(), topk, hnsw_filter.get());
+            result = search_knn(query);
           } catch (std::runtime_error& e) {
             std::string s = fmt::format("parallel search vector failed, error: {}", e.what());
             LOG(ERROR) << fmt::format("[vector_index.hnsw][id({})] {}", Id(), s);
@@ -478,6 +939,28 @@ butil::Status VectorIndexHnsw::Search(const std::vector<pb::common::VectorWithId
   return butil::Status::OK();
 }
 
+// The standard traversal visits mostly rejected nodes and returns less than topk when few nodes match the filter.
+// The filter with very few candidates is searched by brute force by VectorReader before reaching here.
+bool VectorIndexHnsw::IsRestrictiveFilter(const std::vector<std::shared_ptr<FilterFunctor>>& filters) {
+  if (FLAGS_hnsw_filtered_search_max_selectivity <= 0) {
+    return false;
+  }
+
+  int64_t candidate_count = -1;
+  for (const auto& filter : filters) {
+    int64_t count = filter->CandidateCount();
+    if (count >= 0 && (candidate_count < 0 || count < candidate_count)) {
+      candidate_count = count;
+    }
+  }
+  if (candidate_count < 0) {
+    return false;
+  }
+
+  int64_t element_count = hnsw_index_->cur_element_count;
+  return candidate_count <= element_count * FLAGS_hnsw_filtered_search_max_selectivity;
+}
+
 butil::Status VectorIndexHnsw::RangeSearch(const std::vector<pb::common::VectorWithId>& /*vector_with_ids*/,
                                            float /*radius*/,
                                            const std::vector<std::shared_ptr<VectorIndex::FilterFunctor>>& /*filters*/,
@@ -491,6 +974,7 @@ void VectorIndexHnsw::LockWrite() { rw_lock_.LockWrite(); }
 void VectorIndexHnsw::UnlockWrite() { rw_lock_.UnlockWrite(); }
 
 butil::Status VectorIndexHnsw::ResizeMaxElements(int64_t new_max_elements) {
+  BAIDU_SCOPED_LOCK(write_mutex_);
   RWLockWriteGuard guard(&rw_lock_);
 
   try {
@@ -591,12 +1075,13 @@ bool VectorIndexHnsw::NeedToSave(int64_t last_save_log_behind) {
 }
 
 // calc hnsw count from memory
-uint32_t VectorIndexHnsw::CalcHnswCountFromMemory(int64_t memory_size_limit, int64_t dimension, int64_t nlinks) {
+uint32_t VectorIndexHnsw::CalcHnswCountFromMemory(int64_t memory_size_limit, int64_t dimension, int64_t nlinks,
+                                                  size_t element_size) {
   // size_links_level0_ = maxM0_ * sizeof(tableint) + sizeof(linklistsizeint);
   int64_t size_links_level0 = nlinks * 2 + sizeof(int64_t) + sizeof(int64_t);
 
   // int64_t size_data_per_element_ = size_links_level0_ + data_size_ + sizeof(labeltype);
-  int64_t size_data_per_element = size_links_level0 + sizeof(float_t) * dimension + sizeof(int64_t);
+  int64_t size_data_per_element = size_links_level0 + element_size * dimension + sizeof(int64_t);
 
   // int64_t size_link_list_per_element =  sizeof(void*);
   int64_t size_link_list_per_element = sizeof(int64_t);
@@ -624,7 +1109,7 @@ butil::Status VectorIndexHnsw::CheckAndSetHnswParameter(pb::common::CreateHnswPa
   }
 
   auto max_element_limit = CalcHnswCountFromMemory(FLAGS_max_hnsw_memory_size_of_region, hnsw_parameter.dimension(),
-                                                   hnsw_parameter.nlinks());
+                                                   hnsw_parameter.nlinks(), StorageElementSize(GetStorageTypeFromFlag()));
   hnsw_parameter.set_max_elements(max_element_limit);
   DINGO_LOG(INFO) << fmt::format(
       "[vector_index.hnsw] calc max element limit is {}, paramiter max_hnsw_memory_size_of_region({}) dimension({}) "
@@ -634,4 +1119,90 @@ butil::Status VectorIndexHnsw::CheckAndSetHnswParameter(pb::common::CreateHnswPa
   return butil::Status::OK();
 }
 
+HnswStorageType VectorIndexHnsw::GetStorageTypeFromFlag() {
+  if (FLAGS_hnsw_vector_storage_type == "fp16") {
+    return HnswStorageType::kFp16;
+  } else if (FLAGS_hnsw_vector_storage_type == "bf16") {
+    return HnswStorageType::kBf16;
+  } else if (FLAGS_hnsw_vector_storage_type == "sq8") {
+    return HnswStorageType::kSq8;
+  } else if (FLAGS_hnsw_vector_storage_type != "float32") {
+    DINGO_LOG(WARNING) << fmt::format("[vector_index.hnsw] unknown storage type({}), use float32.",
+                                      FLAGS_hnsw_vector_storage_type);
+  }
+
+  return HnswStorageType::kFloat32;
+}
+
+size_t VectorIndexHnsw::StorageElementSize(HnswStorageType storage_type) {
+  switch (storage_type) {
+    case HnswStorageType::kFp16:
+    case HnswStorageType::kBf16:
+      return sizeof(uint16_t);
+    case HnswStorageType::kSq8:
+      // the 8 bytes sq8 header is ignored, it is small compared with links of each node
+      return sizeof(int8_t);
+    default:
+      return sizeof(float);
+  }
+}
+
+uint32_t VectorIndexHnsw::RerankMultiple() {
+  return storage_type_ == HnswStorageType::kSq8 ? FLAGS_hnsw_sq8_rerank_multiple : 0;
+}
+
+bool VectorIndexHnsw::HoldsExactVectors() { return !normalize_ && storage_type_ == HnswStorageType::kFloat32; }
+
+const void* VectorIndexHnsw::PrepareVector(const float* data, std::vector<float>& norm_buffer,
+                                           std::vector<uint8_t>& code_buffer) {
+  if (normalize_) {
+    norm_buffer.resize(dimension_);
+    VectorIndexUtils::NormalizeVectorForHnsw(data, dimension_, norm_buffer.data());
+    data = norm_buffer.data();
+  }
+
+  if (storage_type_ == HnswStorageType::kFloat32) {
+    return data;
+  }
+
+  if (storage_type_ == HnswStorageType::kSq8) {
+    code_buffer.resize(dimension_ + sizeof(Sq8Header));
+    Sq8Encode(data, dimension_, code_buffer.data());
+    return code_buffer.data();
+  }
+
+  code_buffer.resize(dimension_ * sizeof(uint16_t));
+  auto* half_data = reinterpret_cast<uint16_t*>(code_buffer.data());
+  if (storage_type_ == HnswStorageType::kFp16) {
+    fvec_to_fp16(half_data, data, dimension_);
+  } else {
+    fvec_to_bf16(half_data, data, dimension_);
+  }
+
+  return code_buffer.data();
+}
+
+std::vector<float> VectorIndexHnsw::GetFloatDataByLabel(hnswlib::labeltype label) {
+  if (storage_type_ == HnswStorageType::kFloat32) {
+    return hnsw_index_->getDataByLabel<float>(label);
+  }
+
+  if (storage_type_ == HnswStorageType::kSq8) {
+    std::vector<uint8_t> code = hnsw_index_->getDataByLabel<uint8_t>(label);
+    std::vector<float> data(dimension_);
+    Sq8Decode(code.data(), dimension_, data.data());
+    return data;
+  }
+
+  std::vector<uint16_t> half_data = hnsw_index_->getDataByLabel<uint16_t>(label);
+  std::vector<float> data(half_data.size());
+  if (storage_type_ == HnswStorageType::kFp16) {
+    fp16vec_to_fvec(data.data(), half_data.data(), half_data.size());
+  } else {
+    bf16vec_to_fvec(data.data(), half_data.data(), half_data.size());
+  }
+
+  return data;
+}
+
 }  // namespace dingodb
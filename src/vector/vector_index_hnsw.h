@@ -15,11 +15,13 @@
 #ifndef DINGODB_VECTOR_INDEX_HNSW_H_  // NOLINT
 #define DINGODB_VECTOR_INDEX_HNSW_H_
 
+#include <atomic>
 #include <cstdint>
 #include <memory>
 #include <string>
 #include <vector>
 
+#include "bthread/mutex.h"
 #include "butil/status.h"
 #include "common/synchronization.h"
 #include "hnswlib/hnswlib.h"
@@ -28,6 +30,16 @@
 
 namespace dingodb {
 
+// Element type of vectors stored in the hnsw graph nodes.
+// fp16/bf16 halve the data size per node, distances are still accumulated in float.
+// sq8 stores per vector scale and int8 codes, search results are reranked with the raw vectors.
+enum class HnswStorageType {
+  kFloat32 = 0,
+  kFp16 = 1,
+  kBf16 = 2,
+  kSq8 = 3,
+};
+
 class VectorIndexHnsw : public VectorIndex {
  public:
   explicit VectorIndexHnsw(int64_t id, const pb::common::VectorIndexParameter& vector_index_parameter,
@@ -36,9 +48,14 @@ class VectorIndexHnsw : public VectorIndex {
 
   ~VectorIndexHnsw() override;
 
-  static uint32_t CalcHnswCountFromMemory(int64_t memory_size_limit, int64_t dimension, int64_t nlinks);
+  static uint32_t CalcHnswCountFromMemory(int64_t memory_size_limit, int64_t dimension, int64_t nlinks,
+                                          size_t element_size = sizeof(float));
   static butil::Status CheckAndSetHnswParameter(pb::common::CreateHnswParam& hnsw_parameter);
 
+  // parse FLAGS_hnsw_vector_storage_type
+  static HnswStorageType GetStorageTypeFromFlag();
+  static size_t StorageElementSize(HnswStorageType storage_type);
+
   VectorIndexHnsw(const VectorIndexHnsw& rhs) = delete;
   VectorIndexHnsw& operator=(const VectorIndexHnsw& rhs) = delete;
   VectorIndexHnsw(VectorIndexHnsw&& rhs) = delete;
@@ -53,6 +70,9 @@ class VectorIndexHnsw : public VectorIndex {
   butil::Status Delete(const std::vector<int64_t>& delete_ids) override;
   butil::Status Delete(const std::vector<int64_t>& delete_ids, bool is_priority) override;
 
+  bool SupportParallelBuild() override { return true; }
+  butil::Status BuildAdd(const std::vector<pb::common::VectorWithId>& vector_with_ids) override;
+
   butil::Status Save(const std::string& path) override;
   butil::Status Load(const std::string& path) override;
 
@@ -87,12 +107,35 @@ class VectorIndexHnsw : public VectorIndex {
   bool NeedToRebuild() override;
   bool NeedToSave(int64_t last_save_log_behind) override;
   bool SupportSave() override;
+  uint32_t RerankMultiple() override;
+  bool HoldsExactVectors() override;
 
   hnswlib::HierarchicalNSW<float>* GetHnswIndex();
 
+  // Whether the filter candidates are few relative to the elements, which uses the filter-aware traversal.
+  bool IsRestrictiveFilter(const std::vector<std::shared_ptr<FilterFunctor>>& filters);
+
+  HnswStorageType StorageType() const { return storage_type_; }
+
   // void NormalizeVector(const float* data, float* norm_array) const;
 
+  // Get the vector of label as float, decode it if stored in half precision or sq8.
+  std::vector<float> GetFloatDataByLabel(hnswlib::labeltype label);
+
  private:
+  // Insert points by thread pool, caller hold rw_lock_ and ensure capacity, throw std::runtime_error.
+  void AddPoints(const std::vector<pb::common::VectorWithId>& vector_with_ids, bool is_priority);
+  // Like AddPoints, but new id reuse the slot of deleted vector and hnswlib repair the neighbors around the slot.
+  // Require index created with allow_replace_deleted.
+  void ReplaceDeletedPoints(const std::vector<pb::common::VectorWithId>& vector_with_ids, bool is_priority);
+
+  // Expand max elements on a copy of index and switch to it, searches go on during copying.
+  // Caller hold write_mutex_ but not rw_lock_, return false if not expanded.
+  bool ExpandWithoutBlockSearch(int64_t reserve_count);
+
+  // Normalize and encode vector to the layout of graph nodes, return the pointer passed to hnswlib.
+  const void* PrepareVector(const float* data, std::vector<float>& norm_buffer, std::vector<uint8_t>& code_buffer);
+
   // hnsw members
   hnswlib::HierarchicalNSW<float>* hnsw_index_;
   hnswlib::SpaceInterface<float>* hnsw_space_;
@@ -102,11 +145,19 @@ class VectorIndexHnsw : public VectorIndex {
 
   // bthread_mutex_t mutex_;
   RWLock rw_lock_;
+  // Serialize writers, so expanding can copy the index without holding rw_lock_.
+  bthread::Mutex write_mutex_;
 
   uint32_t max_element_limit_;
 
   // normalize vector
   bool normalize_;
+
+  // element type of stored vectors
+  HnswStorageType storage_type_{HnswStorageType::kFloat32};
+
+  // elements being inserted by BuildAdd
+  std::atomic<int64_t> build_inflight_count_{0};
 };
 
 }  // namespace dingodb
@@ -39,6 +39,7 @@
 #include "proto/debug.pb.h"
 #include "proto/error.pb.h"
 #include "proto/index.pb.h"
+#include "vector/vector_index_mmap_reader.h"
 #include "vector/vector_index_utils.h"
 
 namespace dingodb {
@@ -326,7 +327,7 @@ butil::Status VectorIndexIvfFlat::Load(const std::string& path) {
 
   faiss::Index* internal_raw_index = nullptr;
   try {
-    internal_raw_index = faiss::read_index(path.c_str(), 0);
+    internal_raw_index = VectorIndexMmapReader::ReadIndex(path);
 
   } catch (std::exception& e) {
     delete internal_raw_index;
@@ -548,10 +549,12 @@ bool VectorIndexIvfFlat::NeedToRebuild() {
 
   if (BAIDU_UNLIKELY(nlist_ == nlist_org_ && 1 != nlist_ &&
                      index_->ntotal >= clustering_parameters.max_points_per_centroid * nlist_org_)) {
-    return train_data_size_ <= (index_->ntotal / 2);
+    if (train_data_size_ <= (index_->ntotal / 2)) {
+      return true;
+    }
   }
 
-  return false;
+  return VectorIndexUtils::IsIvfListImbalanced(index_.get());
 }
 
 bool VectorIndexIvfFlat::IsTrained() {
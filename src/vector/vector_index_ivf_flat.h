@@ -108,7 +108,7 @@ class VectorIndexIvfFlat : public VectorIndex {
   bool IsTrained() override;
   bool NeedToSave(int64_t last_save_log_behind) override;
 
- private:
+ protected:
   void Init();
 
   bool IsTrainedImpl();
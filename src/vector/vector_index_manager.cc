@@ -14,10 +14,13 @@
 
 #include "vector/vector_index_manager.h"
 
+#include <algorithm>
 #include <atomic>
 #include <cassert>
 #include <cstdint>
 #include <memory>
+#include <random>
+#include <set>
 #include <string>
 #include <vector>
 
@@ -28,7 +31,9 @@
 #include "common/helper.h"
 #include "common/logging.h"
 #include "common/synchronization.h"
+#include "engine/raft_store_engine.h"
 #include "fmt/core.h"
+#include "log/index_journal.h"
 #include "meta/store_meta_manager.h"
 #include "proto/common.pb.h"
 #include "proto/error.pb.h"
@@ -39,8 +44,10 @@
 #include "vector/codec.h"
 #include "vector/vector_index.h"
 #include "vector/vector_index_factory.h"
+#include "vector/vector_index_memory_manager.h"
 #include "vector/vector_index_snapshot.h"
 #include "vector/vector_index_snapshot_manager.h"
+#include "vector/vector_reader.h"
 
 namespace dingodb {
 
@@ -48,7 +55,41 @@ DEFINE_int32(vector_background_worker_num, 16, "vector index background worker n
 DEFINE_int32(vector_fast_background_worker_num, 8, "vector index fast background worker num");
 DEFINE_int64(vector_fast_build_log_gap, 50, "vector index fast build log gap");
 DEFINE_int64(vector_pull_snapshot_min_log_gap, 66, "vector index pull snapshot min log gap");
+DEFINE_bool(vector_index_ship_snapshot, false,
+            "leader ship the built vector index snapshot to followers, and followers always pull snapshot before build, "
+            "used by bulk import which build index once instead of on every replica");
 DEFINE_int64(vector_max_background_task_count, 32, "vector index max background task count");
+DEFINE_int64(vector_index_train_sample_count, 0,
+             "max vectors sampled from region to train vector index, 0 means train with all vectors");
+
+DEFINE_int32(vector_index_parallel_build_concurrency, 4,
+             "concurrent readers of building vector index which support parallel build, <=1 means sequential");
+DEFINE_int64(vector_index_parallel_build_min_vector_count, 1000000,
+             "min vector id span of region to enable parallel build");
+DEFINE_int64(vector_index_parallel_build_throttle_latency_us, 50000,
+             "parallel build pause while recent foreground hnsw search latency exceeds it, 0 means no throttle");
+DEFINE_int64(vector_index_parallel_build_throttle_sleep_ms, 100, "parallel build pause time when throttled");
+
+DEFINE_double(vector_index_auto_tune_recall_target, 0,
+              "recall target of auto tune hnsw efsearch or ivf nprobe used when client doesn't specify, 0 means "
+              "disable auto tune");
+DEFINE_int64(vector_index_auto_tune_interval_s, 3600, "interval of vector index auto tune search parameter");
+DEFINE_int32(vector_index_auto_tune_sample_count, 16, "query count sampled from region of vector index auto tune");
+DEFINE_int32(vector_index_auto_tune_topk, 10, "topk of vector index auto tune recall");
+DEFINE_int64(vector_index_event_scrub_max_num, 64, "max dirty vector index num of one event driven scrub");
+DEFINE_int64(vector_index_event_scrub_full_interval, 10,
+             "sweep all vector indexes every interval event driven scrubs, for hold change and memory balance");
+
+DECLARE_int32(vector_follower_hold_index_num);
+DECLARE_bool(enable_vector_index_event_scrub);
+
+extern bvar::LatencyRecorder g_hnsw_search_latency;
+
+// Bulk imported region has few raft logs, so always pull when ship snapshot.
+static bool IsPullSnapshot(store::RegionPtr region, int64_t applied_index) {
+  return FLAGS_vector_index_ship_snapshot || region->Epoch().version() > 1 ||
+         applied_index > FLAGS_vector_pull_snapshot_min_log_gap;
+}
 
 std::string RebuildVectorIndexTask::Trace() {
   return fmt::format("[vector_index.rebuild][id({}).start_time({}).job_id({})] {}", vector_index_wrapper_->Id(),
@@ -304,7 +345,7 @@ void LoadOrBuildVectorIndexTask::Run() {
     applied_index = raft_meta->AppliedId();
   }
 
-  if (region->Epoch().version() > 1 || applied_index > FLAGS_vector_pull_snapshot_min_log_gap) {
+  if (IsPullSnapshot(region, applied_index)) {
     auto snapshot_set = vector_index_wrapper_->SnapshotSet();
     auto status = VectorIndexSnapshotManager::PullLastSnapshotFromPeers(snapshot_set, region->Epoch());
     DINGO_LOG(INFO) << fmt::format(
@@ -425,7 +466,7 @@ void LoadAsyncBuildVectorIndexTask::Run() {
     return;
   }
 
-  if (region->Epoch().version() > 1 || applied_index > FLAGS_vector_pull_snapshot_min_log_gap) {
+  if (IsPullSnapshot(region, applied_index)) {
     auto snapshot_set = vector_index_wrapper_->SnapshotSet();
     auto status = VectorIndexSnapshotManager::PullLastSnapshotFromPeers(snapshot_set, region->Epoch());
     DINGO_LOG(INFO) << fmt::format(
@@ -1047,12 +1088,8 @@ butil::Status VectorIndexManager::ReplayWalToVectorIndex(VectorIndexPtr vector_i
   ids.reserve(Constant::kBuildVectorIndexBatchSize);
 
   int64_t last_log_id = vector_index->ApplyLogId();
-  auto log_entrys = log_stroage->GetEntrys(start_log_id, end_log_id);
-  for (const auto& log_entry : log_entrys) {
-    auto raft_cmd = std::make_shared<pb::raft::RaftCmdRequest>();
-    butil::IOBufAsZeroCopyInputStream wrapper(log_entry->data);
-    CHECK(raft_cmd->ParseFromZeroCopyStream(&wrapper));
-    for (auto& request : *raft_cmd->mutable_requests()) {
+  auto replay_func = [&](int64_t log_id, pb::raft::RaftCmdRequest& raft_cmd) {
+    for (auto& request : *raft_cmd.mutable_requests()) {
       switch (request.cmd_type()) {
         case pb::raft::VECTOR_ADD: {
           if (!ids.empty()) {
@@ -1094,8 +1131,15 @@ butil::Status VectorIndexManager::ReplayWalToVectorIndex(VectorIndexPtr vector_i
       }
     }
 
-    last_log_id = log_entry->index;
+    last_log_id = log_id;
+  };
+
+  // the log truncated from raft log is read from index journal
+  auto status = IndexJournalManager::ReadIndexLog(log_stroage, start_log_id, end_log_id, replay_func);
+  if (!status.ok()) {
+    return status;
   }
+
   if (!vectors.empty()) {
     vector_index->UpsertByParallel(vectors, false);
   } else if (!ids.empty()) {
@@ -1169,6 +1213,7 @@ VectorIndexPtr VectorIndexManager::BuildVectorIndex(VectorIndexWrapperPtr vector
   // load vector data to vector index
   IteratorOptions options;
   options.upper_bound = end_key;
+  options.long_scan = true;
 
   auto raw_engine = Server::GetInstance().GetRawEngine(region->GetRawEngineType());
   auto iter = raw_engine->Reader()->NewIterator(Constant::kVectorDataCF, options);
@@ -1198,6 +1243,24 @@ VectorIndexPtr VectorIndexManager::BuildVectorIndex(VectorIndexWrapperPtr vector
   }
 
   int64_t count = 0;
+  if (FLAGS_vector_index_parallel_build_concurrency > 1 && vector_index->SupportParallelBuild()) {
+    auto status = ParallelBuildVectorIndex(vector_index, raw_engine, range, trace, count);
+    if (status.ok()) {
+      DINGO_LOG(INFO) << fmt::format(
+          "[vector_index.build][index_id({})][trace({})] Parallel build vector index finish, concurrency({}) count({}) "
+          "epoch({}) range({}) elapsed time({}ms)",
+          vector_index_id, trace, FLAGS_vector_index_parallel_build_concurrency, count,
+          Helper::RegionEpochToString(vector_index->Epoch()), VectorCodec::DecodeRangeToString(vector_index->Range()),
+          Helper::TimestampMs() - start_time);
+      return vector_index;
+    }
+    if (status.error_code() != pb::error::EVECTOR_NOT_SUPPORT) {
+      DINGO_LOG(ERROR) << fmt::format("[vector_index.build][index_id({})][trace({})] Parallel build failed, error: {}",
+                                      vector_index_id, trace, status.error_str());
+      return nullptr;
+    }
+  }
+
   int64_t upsert_use_time = 0;
   std::vector<pb::common::VectorWithId> vectors;
   vectors.reserve(Constant::kBuildVectorIndexBatchSize);
@@ -1259,6 +1322,140 @@ VectorIndexPtr VectorIndexManager::BuildVectorIndex(VectorIndexWrapperPtr vector
   return vector_index;
 }
 
+// Read [start_key, end_key) of data cf and add to vector index by BuildAdd.
+static butil::Status BuildVectorIndexSubRange(VectorIndexPtr vector_index, RawEnginePtr raw_engine,
+                                              SnapshotPtr snapshot, const std::string& start_key,
+                                              const std::string& end_key, const std::string& trace, int64_t& count) {
+  IteratorOptions options;
+  options.upper_bound = end_key;
+  auto iter = raw_engine->Reader()->NewIterator(Constant::kVectorDataCF, snapshot, options);
+  if (iter == nullptr) {
+    return butil::Status(pb::error::EINTERNAL, "new iterator failed");
+  }
+
+  std::vector<pb::common::VectorWithId> vectors;
+  vectors.reserve(Constant::kBuildVectorIndexBatchSize);
+  auto flush = [&]() -> butil::Status {
+    auto status = vector_index->BuildAdd(vectors);
+    if (!status.ok()) {
+      return status;
+    }
+    vectors.clear();
+
+    // yield to foreground search, hnsw build and search share vector index thread pool.
+    while (FLAGS_vector_index_parallel_build_throttle_latency_us > 0 &&
+           g_hnsw_search_latency.latency(1) > FLAGS_vector_index_parallel_build_throttle_latency_us) {
+      bthread_usleep(FLAGS_vector_index_parallel_build_throttle_sleep_ms * 1000);
+    }
+    bthread_yield();
+    return butil::Status();
+  };
+
+  for (iter->Seek(start_key); iter->Valid(); iter->Next()) {
+    pb::common::VectorWithId vector;
+    vector.set_id(VectorCodec::DecodeVectorId(std::string(iter->Key())));
+    if (!vector.mutable_vector()->ParseFromArray(iter->Value().data(), iter->Value().size())) {
+      DINGO_LOG(WARNING) << fmt::format(
+          "[vector_index.build][index_id({})][trace({})] vector with id ParseFromString failed.", vector_index->Id(),
+          trace);
+      continue;
+    }
+    if (vector.vector().float_values_size() <= 0) {
+      DINGO_LOG(WARNING) << fmt::format("[vector_index.build][index_id({})][trace({})] vector values_size error.",
+                                        vector_index->Id(), trace);
+      continue;
+    }
+
+    vectors.push_back(std::move(vector));
+    ++count;
+    if (vectors.size() >= Constant::kBuildVectorIndexBatchSize) {
+      auto status = flush();
+      if (!status.ok()) {
+        return status;
+      }
+    }
+  }
+
+  return vectors.empty() ? butil::Status() : flush();
+}
+
+butil::Status VectorIndexManager::ParallelBuildVectorIndex(VectorIndexPtr vector_index, RawEnginePtr raw_engine,
+                                                           const pb::common::Range& range, const std::string& trace,
+                                                           int64_t& count) {
+  const std::string& start_key = range.start_key();
+  const std::string& end_key = range.end_key();
+
+  auto snapshot = raw_engine->GetSnapshot();
+  IteratorOptions options;
+  options.lower_bound = start_key;
+  options.upper_bound = end_key;
+  auto iter = raw_engine->Reader()->NewIterator(Constant::kVectorDataCF, snapshot, options);
+  if (iter == nullptr) {
+    return butil::Status(pb::error::EINTERNAL, "new iterator failed");
+  }
+
+  // Split by the actual id span, assume vector ids are roughly uniform in it.
+  iter->Seek(start_key);
+  if (!iter->Valid()) {
+    return butil::Status(pb::error::EVECTOR_NOT_SUPPORT, "empty range");
+  }
+  int64_t min_vector_id = VectorCodec::DecodeVectorId(std::string(iter->Key()));
+  iter->SeekToLast();
+  if (!iter->Valid()) {
+    return butil::Status(pb::error::EVECTOR_NOT_SUPPORT, "empty range");
+  }
+  int64_t max_vector_id = VectorCodec::DecodeVectorId(std::string(iter->Key()));
+  iter.reset();
+
+  int64_t concurrency = FLAGS_vector_index_parallel_build_concurrency;
+  int64_t span = max_vector_id - min_vector_id + 1;
+  if (span < FLAGS_vector_index_parallel_build_min_vector_count || span < concurrency) {
+    return butil::Status(pb::error::EVECTOR_NOT_SUPPORT, "range too small");
+  }
+
+  char prefix = start_key[0];
+  int64_t partition_id = VectorCodec::DecodePartitionId(start_key);
+  int64_t step = span / concurrency;
+
+  std::vector<std::string> sub_keys = {start_key};
+  for (int64_t i = 1; i < concurrency; ++i) {
+    std::string key;
+    VectorCodec::EncodeVectorKey(prefix, partition_id, min_vector_id + i * step, key);
+    sub_keys.push_back(key);
+  }
+  sub_keys.push_back(end_key);
+
+  DINGO_LOG(INFO) << fmt::format(
+      "[vector_index.build][index_id({})][trace({})] Parallel build vector index, vector_id({}-{}) concurrency({})",
+      vector_index->Id(), trace, min_vector_id, max_vector_id, concurrency);
+
+  std::vector<butil::Status> statuses(concurrency);
+  std::vector<int64_t> counts(concurrency, 0);
+  std::vector<Bthread> workers;
+  workers.reserve(concurrency - 1);
+  for (int64_t i = 1; i < concurrency; ++i) {
+    workers.emplace_back([&, i]() {
+      statuses[i] = BuildVectorIndexSubRange(vector_index, raw_engine, snapshot, sub_keys[i], sub_keys[i + 1], trace,
+                                             counts[i]);
+    });
+  }
+  statuses[0] =
+      BuildVectorIndexSubRange(vector_index, raw_engine, snapshot, sub_keys[0], sub_keys[1], trace, counts[0]);
+  for (auto& worker : workers) {
+    worker.Join();
+  }
+
+  count = 0;
+  for (int64_t i = 0; i < concurrency; ++i) {
+    if (!statuses[i].ok()) {
+      return statuses[i];
+    }
+    count += counts[i];
+  }
+
+  return butil::Status();
+}
+
 void VectorIndexManager::LaunchRebuildVectorIndex(VectorIndexWrapperPtr vector_index_wrapper, int64_t job_id,
                                                   bool is_double_check, bool is_force, bool is_clear,
                                                   const std::string& trace) {
@@ -1474,6 +1671,21 @@ butil::Status VectorIndexManager::SaveVectorIndex(VectorIndexWrapperPtr vector_i
     vector_index_wrapper->SetSnapshotLogId(snapshot_log_id);
   }
 
+  // Ship the snapshot to followers, so they load it instead of building again.
+  if (FLAGS_vector_index_ship_snapshot) {
+    auto raft_store_engine = Server::GetInstance().GetRaftStoreEngine();
+    auto last_snapshot = vector_index_wrapper->SnapshotSet()->GetLastSnapshot();
+    if (raft_store_engine != nullptr && raft_store_engine->IsLeader(vector_index_wrapper->Id()) &&
+        last_snapshot != nullptr) {
+      status = VectorIndexSnapshotManager::InstallSnapshotToFollowers(last_snapshot);
+      if (!status.ok()) {
+        DINGO_LOG(WARNING) << fmt::format(
+            "[vector_index.save][index_id({})][trace({})] ship vector index snapshot to followers failed, error: {}",
+            vector_index_wrapper->Id(), trace, Helper::PrintStatus(status));
+      }
+    }
+  }
+
   // Update vector index status NORMAL
   DINGO_LOG(INFO) << fmt::format(
       "[vector_index.save][index_id({}_v{})][trace({})] Save vector index success, elapsed time({}ms)",
@@ -1517,7 +1729,247 @@ void VectorIndexManager::LaunchSaveVectorIndex(VectorIndexWrapperPtr vector_inde
   }
 }
 
+std::string TuneSearchParamTask::Trace() {
+  return fmt::format("[vector_index.tune][id({}).start_time({})] {}", vector_index_wrapper_->Id(),
+                     Helper::FormatMsTime(start_time_), trace_);
+}
+
+void TuneSearchParamTask::Run() {
+  ON_SCOPE_EXIT([&]() { vector_index_wrapper_->DecPendingTaskNum(); });
+
+  if (vector_index_wrapper_->IsStop() || !vector_index_wrapper_->IsReady()) {
+    DINGO_LOG(INFO) << fmt::format("[vector_index.tune][index_id({})][trace({})] vector index is stop or not ready.",
+                                   vector_index_wrapper_->Id(), trace_);
+    return;
+  }
+
+  auto status = VectorIndexManager::TuneSearchParam(vector_index_wrapper_, trace_);
+  if (!status.ok()) {
+    DINGO_LOG(WARNING) << fmt::format("[vector_index.tune][index_id({})][trace({})] tune failed, error: {}",
+                                      vector_index_wrapper_->Id(), trace_, status.error_str());
+  }
+}
+
+static double CalcRecall(const std::vector<pb::index::VectorWithDistanceResult>& truth_results,
+                         const std::vector<pb::index::VectorWithDistanceResult>& results) {
+  int64_t truth_count = 0;
+  int64_t hit_count = 0;
+  for (size_t i = 0; i < truth_results.size() && i < results.size(); ++i) {
+    std::set<int64_t> truth_ids;
+    for (const auto& vector_with_distance : truth_results[i].vector_with_distances()) {
+      truth_ids.insert(vector_with_distance.vector_with_id().id());
+    }
+    truth_count += truth_ids.size();
+    for (const auto& vector_with_distance : results[i].vector_with_distances()) {
+      hit_count += truth_ids.count(vector_with_distance.vector_with_id().id());
+    }
+  }
+
+  return truth_count == 0 ? 1.0 : static_cast<double>(hit_count) / truth_count;
+}
+
+butil::Status VectorIndexManager::TuneSearchParam(VectorIndexWrapperPtr vector_index_wrapper,
+                                                  const std::string& trace) {
+  static const std::vector<int32_t> kHnswCandidates = {16, 32, 64, 128, 256, 512, 1024};
+  static const std::vector<int32_t> kIvfCandidates = {1, 2, 4, 8, 16, 32, 64, 128, 256, 512, 1024};
+
+  int64_t vector_index_id = vector_index_wrapper->Id();
+  auto type = vector_index_wrapper->Type();
+  const auto& candidates = type == pb::common::VECTOR_INDEX_TYPE_HNSW ? kHnswCandidates : kIvfCandidates;
+  if (type != pb::common::VECTOR_INDEX_TYPE_HNSW && type != pb::common::VECTOR_INDEX_TYPE_IVF_FLAT &&
+      type != pb::common::VECTOR_INDEX_TYPE_IVF_PQ) {
+    return butil::Status(pb::error::EVECTOR_NOT_SUPPORT, "vector index type not support tune");
+  }
+
+  auto region = Server::GetInstance().GetRegion(vector_index_id);
+  if (region == nullptr) {
+    return butil::Status(pb::error::EREGION_NOT_FOUND, "not found region");
+  }
+  auto range = region->Range();
+  auto raw_engine = Server::GetInstance().GetRawEngine(region->GetRawEngineType());
+
+  // sample queries from region data
+  int32_t sample_count = std::max(1, FLAGS_vector_index_auto_tune_sample_count);
+  std::vector<pb::common::VectorWithId> queries;
+  {
+    IteratorOptions options;
+    options.upper_bound = range.end_key();
+    auto iter = raw_engine->Reader()->NewIterator(Constant::kVectorDataCF, options);
+    if (iter == nullptr) {
+      return butil::Status(pb::error::EINTERNAL, "new iterator failed");
+    }
+
+    std::mt19937_64 rng(Helper::TimestampNs());
+    int64_t seen_count = 0;
+    for (iter->Seek(range.start_key()); iter->Valid(); iter->Next()) {
+      pb::common::VectorWithId vector_with_id;
+      std::string value(iter->Value());
+      if (!vector_with_id.mutable_vector()->ParseFromString(value)) {
+        continue;
+      }
+
+      ++seen_count;
+      if (queries.size() < sample_count) {
+        queries.push_back(std::move(vector_with_id));
+      } else {
+        int64_t pos = std::uniform_int_distribution<int64_t>(0, seen_count - 1)(rng);
+        if (pos < sample_count) {
+          queries[pos] = std::move(vector_with_id);
+        }
+      }
+    }
+  }
+  if (queries.empty()) {
+    return butil::Status::OK();
+  }
+
+  uint32_t topk = std::max(1, FLAGS_vector_index_auto_tune_topk);
+  pb::common::VectorSearchParameter parameter;
+  std::vector<std::shared_ptr<VectorIndex::FilterFunctor>> filters;
+
+  std::vector<pb::index::VectorWithDistanceResult> truth_results;
+  auto vector_reader = VectorReader::New(raw_engine->Reader());
+  auto status = vector_reader->BruteForceSearch(vector_index_wrapper, queries, topk, range, filters, false, parameter,
+                                                truth_results);
+  if (!status.ok()) {
+    return status;
+  }
+
+  int32_t tuned_value = candidates.back();
+  double recall = 0;
+  for (auto candidate : candidates) {
+    parameter.Clear();
+    VectorIndexWrapper::ApplyTunedSearchParam(type, candidate, parameter);
+
+    std::vector<pb::index::VectorWithDistanceResult> results;
+    filters.clear();
+    status = vector_index_wrapper->Search(queries, topk, range, filters, false, parameter, results);
+    if (!status.ok()) {
+      return status;
+    }
+
+    recall = CalcRecall(truth_results, results);
+    if (recall >= FLAGS_vector_index_auto_tune_recall_target) {
+      tuned_value = candidate;
+      break;
+    }
+  }
+
+  vector_index_wrapper->SetTunedSearchParam(tuned_value);
+
+  DINGO_LOG(INFO) << fmt::format(
+      "[vector_index.tune][index_id({})][trace({})] tuned search param({}) recall({:.3f}) target({}) queries({}).",
+      vector_index_id, trace, tuned_value, recall, FLAGS_vector_index_auto_tune_recall_target, queries.size());
+
+  return butil::Status::OK();
+}
+
+void VectorIndexManager::LaunchTuneSearchParam(VectorIndexWrapperPtr vector_index_wrapper, const std::string& trace) {
+  assert(vector_index_wrapper != nullptr);
+
+  vector_index_wrapper->SetLastTuneTimeMs(Helper::TimestampMs());
+  auto task = std::make_shared<TuneSearchParamTask>(vector_index_wrapper, trace);
+  if (!Server::GetInstance().GetVectorIndexManager()->ExecuteTask(vector_index_wrapper->Id(), task)) {
+    DINGO_LOG(ERROR) << fmt::format("[vector_index.launch][index_id({})][trace({})] Launch tune search param failed",
+                                    vector_index_wrapper->Id(), trace);
+  } else {
+    vector_index_wrapper->IncPendingTaskNum();
+  }
+}
+
+bool VectorIndexManager::ScrubVectorIndex(store::RegionPtr region) {
+  int64_t vector_index_id = region->Id();
+  if (region->State() != pb::common::NORMAL) {
+    DINGO_LOG(INFO) << fmt::format("[vector_index.scrub][index_id({})] region state is not normal, dont't scrub.",
+                                   vector_index_id);
+    return true;
+  }
+  auto vector_index_wrapper = region->VectorIndexWrapper();
+  if (!vector_index_wrapper->IsReady()) {
+    DINGO_LOG(INFO) << fmt::format("[vector_index.scrub][index_id({})] vector index is not ready, dont't scrub.",
+                                   vector_index_id);
+    return true;
+  }
+  if (vector_index_wrapper->IsStop()) {
+    DINGO_LOG(INFO) << fmt::format("[vector_index.scrub][index_id({})] vector index is stop, dont't scrub.",
+                                   vector_index_id);
+    return true;
+  }
+
+  // the follower index replicas change with region peers
+  if (FLAGS_vector_follower_hold_index_num >= 0 && !VectorIndexWrapper::IsPermanentHoldVectorIndex(vector_index_id) &&
+      !vector_index_wrapper->IsTempHoldVectorIndex()) {
+    DINGO_LOG(INFO) << fmt::format("[vector_index.scrub][index_id({})] not index replica, clear vector index.",
+                                   vector_index_id);
+    vector_index_wrapper->ClearVectorIndex("from scrub");
+    return true;
+  }
+
+  bool need_rebuild = vector_index_wrapper->NeedToRebuild();
+  if (need_rebuild) {
+    if (vector_index_wrapper->RebuildingNum() != 0) {
+      return false;
+    }
+    DINGO_LOG(INFO) << fmt::format("[vector_index.scrub][index_id({})] need rebuild, do rebuild vector index.",
+                                   vector_index_id);
+    LaunchRebuildVectorIndex(vector_index_wrapper, 0, true, false, false, "from scrub");
+    return true;
+  }
+
+  std::string trace;
+  bool need_save = vector_index_wrapper->NeedToSave(trace);
+  if (need_save) {
+    if (vector_index_wrapper->RebuildingNum() != 0 || vector_index_wrapper->SavingNum() != 0) {
+      return false;
+    }
+    DINGO_LOG(INFO) << fmt::format("[vector_index.scrub][index_id({})] need save, trace: {}.", vector_index_id, trace);
+
+    LaunchSaveVectorIndex(vector_index_wrapper, fmt::format("scrub-{}", trace));
+    return true;
+  }
+
+  // tune when the index is idle, after save or rebuild is done
+  if (FLAGS_vector_index_auto_tune_recall_target > 0 && vector_index_wrapper->PendingTaskNum() == 0 &&
+      Helper::TimestampMs() - vector_index_wrapper->LastTuneTimeMs() >=
+          FLAGS_vector_index_auto_tune_interval_s * 1000) {
+    LaunchTuneSearchParam(vector_index_wrapper, "from scrub");
+  }
+
+  return true;
+}
+
+// Event driven scrub only visits the dirty vector indexes of highest priority, idle indexes cost nothing.
+// The dirty index which is busy with save or rebuild is marked again, and is scrubbed at next round.
+static butil::Status ScrubDirtyVectorIndex() {
+  auto& queue = VectorIndexWrapper::ScrubQueue();
+  auto vector_index_ids = queue.Pop(FLAGS_vector_index_event_scrub_max_num);
+  if (vector_index_ids.empty()) {
+    return butil::Status::OK();
+  }
+
+  DINGO_LOG(INFO) << fmt::format("[vector_index.scrub][index_id()] Scrub dirty vector index start, count: {}/{}",
+                                 vector_index_ids.size(), vector_index_ids.size() + queue.Size());
+
+  for (auto vector_index_id : vector_index_ids) {
+    auto region = Server::GetInstance().GetRegion(vector_index_id);
+    if (region == nullptr || region->VectorIndexWrapper() == nullptr) {
+      continue;
+    }
+    if (!VectorIndexManager::ScrubVectorIndex(region)) {
+      queue.Mark(vector_index_id, 0);
+    }
+  }
+
+  return butil::Status::OK();
+}
+
 butil::Status VectorIndexManager::ScrubVectorIndex() {
+  static std::atomic<int64_t> scrub_count{0};
+  if (FLAGS_enable_vector_index_event_scrub && FLAGS_vector_index_event_scrub_full_interval > 0 &&
+      scrub_count.fetch_add(1) % FLAGS_vector_index_event_scrub_full_interval != 0) {
+    return ScrubDirtyVectorIndex();
+  }
+
   auto regions = Server::GetInstance().GetAllAliveRegion();
   if (regions.empty()) {
     DINGO_LOG(INFO) << "[vector_index.scrub][index_id()] No alive region, skip scrub vector index";
@@ -1527,51 +1979,37 @@ butil::Status VectorIndexManager::ScrubVectorIndex() {
   DINGO_LOG(INFO) << "[vector_index.scrub][index_id()] Scrub vector index start, alive region_count is "
                   << regions.size();
 
+  std::vector<VectorIndexWrapperPtr> vector_index_wrappers;
+  vector_index_wrappers.reserve(regions.size());
   for (const auto& region : regions) {
-    int64_t vector_index_id = region->Id();
-    if (region->State() != pb::common::NORMAL) {
-      DINGO_LOG(INFO) << fmt::format("[vector_index.scrub][index_id({})] region state is not normal, dont't scrub.",
-                                     vector_index_id);
-      continue;
-    }
-    auto vector_index_wrapper = region->VectorIndexWrapper();
-    if (!vector_index_wrapper->IsReady()) {
-      DINGO_LOG(INFO) << fmt::format("[vector_index.scrub][index_id({})] vector index is not ready, dont't scrub.",
-                                     vector_index_id);
-      continue;
-    }
-    if (vector_index_wrapper->IsStop()) {
-      DINGO_LOG(INFO) << fmt::format("[vector_index.scrub][index_id({})] vector index is stop, dont't scrub.",
-                                     vector_index_id);
-      continue;
+    if (region->VectorIndexWrapper() != nullptr) {
+      vector_index_wrappers.push_back(region->VectorIndexWrapper());
     }
 
-    bool need_rebuild = vector_index_wrapper->NeedToRebuild();
-    if (need_rebuild && vector_index_wrapper->RebuildingNum() == 0) {
-      DINGO_LOG(INFO) << fmt::format("[vector_index.scrub][index_id({})] need rebuild, do rebuild vector index.",
-                                     vector_index_id);
-      LaunchRebuildVectorIndex(vector_index_wrapper, 0, true, false, false, "from scrub");
-      continue;
-    }
-
-    std::string trace;
-    bool need_save = vector_index_wrapper->NeedToSave(trace);
-    if (need_save && vector_index_wrapper->RebuildingNum() == 0 && vector_index_wrapper->SavingNum() == 0) {
-      DINGO_LOG(INFO) << fmt::format("[vector_index.scrub][index_id({})] need save, trace: {}.", vector_index_id,
-                                     trace);
-
-      LaunchSaveVectorIndex(vector_index_wrapper, fmt::format("scrub-{}", trace));
+    // full sweep covers the dirty vector indexes
+    VectorIndexWrapper::ScrubQueue().Remove(region->Id());
+    if (!ScrubVectorIndex(region) && FLAGS_enable_vector_index_event_scrub) {
+      VectorIndexWrapper::ScrubQueue().Mark(region->Id(), 0);
     }
   }
 
+  VectorIndexMemoryManager::Balance(vector_index_wrappers);
+
   return butil::Status::OK();
 }
 
 butil::Status VectorIndexManager::TrainForBuild(std::shared_ptr<VectorIndex> vector_index,
                                                 std::shared_ptr<Iterator> iter, const std::string& start_key,
                                                 [[maybe_unused]] const std::string& end_key) {
+  int64_t dimension = vector_index->GetDimension();
+  int64_t sample_count = FLAGS_vector_index_train_sample_count;
   std::vector<float> train_vectors;
-  train_vectors.reserve(100000 * vector_index->GetDimension());  // todo opt
+  train_vectors.reserve((sample_count > 0 ? sample_count : 100000) * dimension);  // todo opt
+
+  // Reservoir sampling keeps sample_count vectors at most.
+  // Seed with index id, so that every replica samples the same vectors and trains the same centroids.
+  std::mt19937_64 rng(vector_index->Id());
+  int64_t seen_count = 0;
   for (iter->Seek(start_key); iter->Valid(); iter->Next()) {
     pb::common::VectorWithId vector;
 
@@ -1588,8 +2026,34 @@ butil::Status VectorIndexManager::TrainForBuild(std::shared_ptr<VectorIndex> vec
       continue;
     }
 
-    train_vectors.insert(train_vectors.end(), vector.vector().float_values().begin(),
-                         vector.vector().float_values().end());
+    if (sample_count <= 0) {
+      train_vectors.insert(train_vectors.end(), vector.vector().float_values().begin(),
+                           vector.vector().float_values().end());
+      continue;
+    }
+
+    if (vector.vector().float_values_size() != dimension) {
+      DINGO_LOG(WARNING) << fmt::format("[vector_index.build][index_id({})] vector dimension({}) not match({}).",
+                                        vector_index->Id(), vector.vector().float_values_size(), dimension);
+      continue;
+    }
+
+    ++seen_count;
+    if (seen_count <= sample_count) {
+      train_vectors.insert(train_vectors.end(), vector.vector().float_values().begin(),
+                           vector.vector().float_values().end());
+    } else {
+      int64_t pos = std::uniform_int_distribution<int64_t>(0, seen_count - 1)(rng);
+      if (pos < sample_count) {
+        std::copy(vector.vector().float_values().begin(), vector.vector().float_values().end(),
+                  train_vectors.begin() + pos * dimension);
+      }
+    }
+  }
+
+  if (sample_count > 0) {
+    DINGO_LOG(INFO) << fmt::format("[vector_index.build][index_id({})] sample {}/{} vectors for train.",
+                                   vector_index->Id(), std::min(seen_count, sample_count), seen_count);
   }
 
   if (!train_vectors.empty()) {
@@ -24,6 +24,7 @@
 #include "butil/status.h"
 #include "bvar/latency_recorder.h"
 #include "common/helper.h"
+#include "engine/raw_engine.h"
 #include "meta/store_meta_manager.h"
 #include "proto/common.pb.h"
 #include "vector/vector_index.h"
@@ -167,6 +168,27 @@ class BuildVectorIndexTask : public TaskRunnable {
   int64_t start_time_;
 };
 
+// Tune the default search parameter of vector index by recall against brute force.
+class TuneSearchParamTask : public TaskRunnable {
+ public:
+  TuneSearchParamTask(VectorIndexWrapperPtr vector_index_wrapper, const std::string& trace)
+      : vector_index_wrapper_(vector_index_wrapper), trace_(trace) {
+    start_time_ = Helper::TimestampMs();
+  }
+  ~TuneSearchParamTask() override = default;
+
+  std::string Type() override { return "TUNE_SEARCH_PARAM"; }
+
+  void Run() override;
+
+  std::string Trace() override;
+
+ private:
+  VectorIndexWrapperPtr vector_index_wrapper_;
+  std::string trace_;
+  int64_t start_time_;
+};
+
 // Manage vector index, e.g. build/rebuild/save/load vector index.
 class VectorIndexManager {
  public:
@@ -211,7 +233,14 @@ class VectorIndexManager {
   static void LaunchBuildVectorIndex(VectorIndexWrapperPtr vector_index_wrapper, bool is_temp_hold_vector_index,
                                      bool is_fast_build, int64_t job_id, const std::string& trace);
 
+  // Choose the cheapest hnsw efsearch or ivf nprobe which reaches the recall target on sampled queries.
+  static butil::Status TuneSearchParam(VectorIndexWrapperPtr vector_index_wrapper, const std::string& trace);
+  static void LaunchTuneSearchParam(VectorIndexWrapperPtr vector_index_wrapper, const std::string& trace);
+
+  // Scrub all vector indexes, or only the dirty vector indexes when event driven scrub is enabled.
   static butil::Status ScrubVectorIndex();
+  // Scrub one vector index, return false when it need save or rebuild but is busy.
+  static bool ScrubVectorIndex(store::RegionPtr region);
 
   static bvar::Adder<uint64_t> bvar_vector_index_task_running_num;
   static bvar::Adder<uint64_t> bvar_vector_index_rebuild_task_running_num;
@@ -302,6 +331,12 @@ class VectorIndexManager {
   static butil::Status TrainForBuild(std::shared_ptr<VectorIndex> vector_index, std::shared_ptr<Iterator> iter,
                                      const std::string& start_key, [[maybe_unused]] const std::string& end_key);
 
+  // Split range into disjoint vector id sub ranges, read and add them to vector index concurrently.
+  // Return EVECTOR_NOT_SUPPORT if not worth to parallel, caller should build sequentially.
+  static butil::Status ParallelBuildVectorIndex(std::shared_ptr<VectorIndex> vector_index, RawEnginePtr raw_engine,
+                                                const pb::common::Range& range, const std::string& trace,
+                                                int64_t& count);
+
   // Execute all vector index load/build/rebuild/save task.
   ExecqWorkerSetPtr background_workers_;
   ExecqWorkerSetPtr fast_background_workers_;
@@ -0,0 +1,127 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "vector/vector_index_memory_manager.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+#include <vector>
+
+#include "bvar/status.h"
+#include "common/helper.h"
+#include "common/logging.h"
+#include "fmt/core.h"
+#include "gflags/gflags.h"
+#include "server/server.h"
+
+namespace dingodb {
+
+DEFINE_int64(vector_index_memory_budget_bytes, 0,
+             "vector index store wide memory budget bytes, cold index is evicted to disk when exceed, 0 means no "
+             "limit");
+DEFINE_int64(vector_index_evict_idle_s, 600, "vector index is cold when not searched for it");
+DEFINE_bool(vector_index_evict_leader, false, "evict the cold vector index of leader as well as follower");
+
+static bvar::Status<int64_t> g_vector_index_evicted_num("dingo_vector_index_evicted_num", 0);
+
+std::vector<size_t> VectorIndexMemoryManager::SelectEvictions(const std::vector<Usage>& usages, int64_t budget_bytes,
+                                                              int64_t idle_ms, int64_t now_ms) {
+  std::vector<size_t> evictions;
+  if (budget_bytes <= 0) {
+    return evictions;
+  }
+
+  int64_t total_bytes = 0;
+  for (const auto& usage : usages) {
+    total_bytes += usage.memory_bytes;
+  }
+
+  std::vector<size_t> positions(usages.size());
+  std::iota(positions.begin(), positions.end(), 0);
+  std::sort(positions.begin(), positions.end(), [&usages](size_t lhs, size_t rhs) {
+    return usages[lhs].last_access_time_ms < usages[rhs].last_access_time_ms;
+  });
+
+  for (auto position : positions) {
+    if (total_bytes <= budget_bytes) {
+      break;
+    }
+
+    const auto& usage = usages[position];
+    // sorted by access time, the rest are hotter.
+    if (now_ms - usage.last_access_time_ms < idle_ms) {
+      break;
+    }
+    if (!usage.evictable || usage.memory_bytes <= 0) {
+      continue;
+    }
+
+    evictions.push_back(position);
+    total_bytes -= usage.memory_bytes;
+  }
+
+  return evictions;
+}
+
+static bool IsEvictable(VectorIndexWrapperPtr vector_index_wrapper) {
+  if (!vector_index_wrapper->IsReady() || vector_index_wrapper->IsStop() ||
+      vector_index_wrapper->IsTempHoldVectorIndex() || vector_index_wrapper->PendingTaskNum() > 0) {
+    return false;
+  }
+  if (vector_index_wrapper->ShareVectorIndex() != nullptr || vector_index_wrapper->SiblingVectorIndex() != nullptr) {
+    return false;
+  }
+
+  // reload from snapshot instead of rebuild from all data
+  auto snapshot_set = vector_index_wrapper->SnapshotSet();
+  if (snapshot_set == nullptr || !snapshot_set->IsExistLastSnapshot()) {
+    return false;
+  }
+
+  return FLAGS_vector_index_evict_leader || !Server::GetInstance().IsLeader(vector_index_wrapper->Id());
+}
+
+void VectorIndexMemoryManager::Balance(const std::vector<VectorIndexWrapperPtr>& vector_index_wrappers) {
+  std::vector<Usage> usages;
+  usages.reserve(vector_index_wrappers.size());
+  for (const auto& vector_index_wrapper : vector_index_wrappers) {
+    int64_t memory_bytes = 0;
+    if (vector_index_wrapper->IsReady()) {
+      vector_index_wrapper->GetMemorySize(memory_bytes);
+    }
+    usages.push_back({memory_bytes, vector_index_wrapper->LastAccessTimeMs(), IsEvictable(vector_index_wrapper)});
+  }
+
+  auto evictions = SelectEvictions(usages, FLAGS_vector_index_memory_budget_bytes,
+                                   FLAGS_vector_index_evict_idle_s * 1000, Helper::TimestampMs());
+  for (auto position : evictions) {
+    const auto& vector_index_wrapper = vector_index_wrappers[position];
+    vector_index_wrapper->Evict();
+  }
+
+  int64_t evicted_num = 0;
+  for (const auto& vector_index_wrapper : vector_index_wrappers) {
+    evicted_num += vector_index_wrapper->IsEvicted() ? 1 : 0;
+  }
+  g_vector_index_evicted_num.set_value(evicted_num);
+
+  if (!evictions.empty()) {
+    DINGO_LOG(INFO) << fmt::format("[vector_index.memory] evict({}) evicted({}) budget({})", evictions.size(),
+                                   evicted_num, FLAGS_vector_index_memory_budget_bytes);
+  }
+}
+
+}  // namespace dingodb
@@ -0,0 +1,50 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef DINGODB_VECTOR_INDEX_MEMORY_MANAGER_H_
+#define DINGODB_VECTOR_INDEX_MEMORY_MANAGER_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "vector/vector_index.h"
+
+namespace dingodb {
+
+// Store wide memory budget of vector indexes.
+// When the memory of all vector indexes exceeds vector_index_memory_budget_bytes, the least recently searched
+// indexes idle for vector_index_evict_idle_s are dropped from memory, their snapshot is kept on disk, and the next
+// search launches the reload(load snapshot and replay log). Followers are evicted, leaders only when
+// vector_index_evict_leader is set. Indexes in rebuild/split/merge or without snapshot are never evicted.
+class VectorIndexMemoryManager {
+ public:
+  struct Usage {
+    int64_t memory_bytes{0};
+    int64_t last_access_time_ms{0};
+    bool evictable{true};
+  };
+
+  // Position of the usages to evict, least recently accessed first, until the total fits the budget.
+  // Only the evictable usages idle for idle_ms are candidates, budget <= 0 means no limit.
+  static std::vector<size_t> SelectEvictions(const std::vector<Usage>& usages, int64_t budget_bytes, int64_t idle_ms,
+                                             int64_t now_ms);
+
+  // Evict the cold vector indexes when over the budget.
+  static void Balance(const std::vector<VectorIndexWrapperPtr>& vector_index_wrappers);
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_VECTOR_INDEX_MEMORY_MANAGER_H_
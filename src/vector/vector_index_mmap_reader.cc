@@ -0,0 +1,132 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "vector/vector_index_mmap_reader.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+#include "butil/status.h"
+#include "faiss/impl/FaissException.h"
+#include "faiss/index_io.h"
+#include "fmt/core.h"
+#include "gflags/gflags.h"
+#include "proto/error.pb.h"
+
+namespace dingodb {
+
+DEFINE_bool(vector_index_load_use_mmap, false,
+            "read faiss vector index snapshot file through mmap while loading, the loaded index is still a heap copy");
+DEFINE_uint64(vector_index_mmap_release_bytes, 64 * 1024 * 1024,
+              "release consumed pages of mmap snapshot file every so many bytes");
+
+VectorIndexMmapReader::~VectorIndexMmapReader() {
+  if (data_ != nullptr) {
+    munmap(data_, size_);
+    data_ = nullptr;
+  }
+}
+
+butil::Status VectorIndexMmapReader::Open(const std::string& path) {
+  name = path;
+
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return butil::Status(pb::error::EINTERNAL, fmt::format("open file {} failed, error: {}", path, strerror(errno)));
+  }
+
+  struct stat st;
+  if (fstat(fd, &st) != 0) {
+    int err = errno;
+    close(fd);
+    return butil::Status(pb::error::EINTERNAL, fmt::format("stat file {} failed, error: {}", path, strerror(err)));
+  }
+
+  size_ = st.st_size;
+  offset_ = 0;
+  released_offset_ = 0;
+  if (size_ == 0) {
+    close(fd);
+    return butil::Status::OK();
+  }
+
+  void* addr = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+  int err = errno;
+  // the mapping holds its own reference of the file
+  close(fd);
+  if (addr == MAP_FAILED) {
+    size_ = 0;
+    return butil::Status(pb::error::EINTERNAL, fmt::format("mmap file {} failed, error: {}", path, strerror(err)));
+  }
+
+  data_ = static_cast<uint8_t*>(addr);
+  madvise(data_, size_, MADV_SEQUENTIAL);
+
+  return butil::Status::OK();
+}
+
+size_t VectorIndexMmapReader::operator()(void* ptr, size_t size, size_t nitems) {
+  if (size == 0 || nitems == 0 || offset_ >= size_) {
+    return 0;
+  }
+
+  size_t count = std::min(nitems, (size_ - offset_) / size);
+  size_t bytes = count * size;
+  if (bytes > 0) {
+    memcpy(ptr, data_ + offset_, bytes);
+    offset_ += bytes;
+  }
+
+  ReleaseConsumedPages(offset_ == size_);
+
+  return count;
+}
+
+void VectorIndexMmapReader::ReleaseConsumedPages(bool all) {
+  static const size_t kPageSize = sysconf(_SC_PAGESIZE);
+
+  size_t end = all ? size_ : offset_ / kPageSize * kPageSize;
+  if (end <= released_offset_ || (!all && end - released_offset_ < FLAGS_vector_index_mmap_release_bytes)) {
+    return;
+  }
+
+  // private read only mapping is never dirty, dropped pages are faulted in from the file again if touched
+  madvise(data_ + released_offset_, end - released_offset_, MADV_DONTNEED);
+  released_offset_ = end;
+}
+
+faiss::Index* VectorIndexMmapReader::ReadIndex(const std::string& path) {
+  if (!FLAGS_vector_index_load_use_mmap) {
+    return faiss::read_index(path.c_str(), 0);
+  }
+
+  VectorIndexMmapReader reader;
+  auto status = reader.Open(path);
+  if (!status.ok()) {
+    FAISS_THROW_MSG(status.error_str());
+  }
+
+  return faiss::read_index(&reader, 0);
+}
+
+}  // namespace dingodb
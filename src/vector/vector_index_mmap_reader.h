@@ -0,0 +1,66 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_VECTOR_INDEX_MMAP_READER_H_
+#define DINGODB_VECTOR_INDEX_MMAP_READER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "butil/status.h"
+#include "faiss/Index.h"
+#include "faiss/impl/io.h"
+
+namespace dingodb {
+
+// Read faiss index file through a read only private mapping instead of stdio.
+// Pages are faulted in only when the loader walks over them, and the pages behind the read cursor are
+// released as the load goes on, so loading many indexes at restart does not keep whole files resident.
+// It only replaces the file reads of the loader, faiss still copies the data into its own heap buffers, so the
+// loaded index is not served from the mapping and the hnsw load path is not covered.
+class VectorIndexMmapReader : public faiss::IOReader {
+ public:
+  VectorIndexMmapReader() = default;
+  ~VectorIndexMmapReader() override;
+
+  VectorIndexMmapReader(const VectorIndexMmapReader& rhs) = delete;
+  VectorIndexMmapReader& operator=(const VectorIndexMmapReader& rhs) = delete;
+  VectorIndexMmapReader(VectorIndexMmapReader&& rhs) = delete;
+  VectorIndexMmapReader& operator=(VectorIndexMmapReader&& rhs) = delete;
+
+  butil::Status Open(const std::string& path);
+
+  size_t operator()(void* ptr, size_t size, size_t nitems) override;
+
+  size_t Size() const { return size_; }
+  size_t Offset() const { return offset_; }
+
+  // Load faiss index from path, use mmap reader if FLAGS_vector_index_load_use_mmap is on.
+  // The caller owns the returned index, throw faiss exception like faiss::read_index.
+  static faiss::Index* ReadIndex(const std::string& path);
+
+ private:
+  void ReleaseConsumedPages(bool all);
+
+  uint8_t* data_{nullptr};
+  size_t size_{0};
+  size_t offset_{0};
+  // pages before it have been released
+  size_t released_offset_{0};
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_VECTOR_INDEX_MMAP_READER_H_
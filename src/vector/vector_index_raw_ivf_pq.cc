@@ -20,6 +20,7 @@
 #include <exception>
 #include <future>
 #include <memory>
+#include <numeric>
 #include <string>
 #include <thread>
 #include <utility>
@@ -32,6 +33,8 @@
 #include "common/logging.h"
 #include "faiss/Index.h"
 #include "faiss/IndexFlat.h"
+#include "faiss/IndexIVFPQ.h"
+#include "faiss/IndexIVFPQFastScan.h"
 #include "faiss/MetricType.h"
 #include "faiss/impl/AuxIndexStructures.h"
 #include "faiss/impl/IDSelector.h"
@@ -41,11 +44,15 @@
 #include "proto/debug.pb.h"
 #include "proto/error.pb.h"
 #include "proto/index.pb.h"
+#include "vector/vector_index_mmap_reader.h"
 #include "vector/vector_index_utils.h"
 
 namespace dingodb {
 
 DEFINE_int64(ivf_pq_need_save_count, 10000, "ivf pq need save count");
+DEFINE_bool(enable_ivf_pq_fast_scan, true, "ivf pq with 4 bits per idx use simd fast scan");
+DEFINE_uint32(ivf_pq_fast_scan_filter_topk_multiple, 4,
+              "ivf pq fast scan with filter searches topk * multiple candidates first, double it if not enough");
 
 VectorIndexRawIvfPq::VectorIndexRawIvfPq(int64_t id, const pb::common::VectorIndexParameter& vector_index_parameter,
                                          const pb::common::RegionEpoch& epoch, const pb::common::Range& range,
@@ -68,6 +75,8 @@ VectorIndexRawIvfPq::VectorIndexRawIvfPq(int64_t id, const pb::common::VectorInd
 
   normalize_ = (pb::common::MetricType::METRIC_TYPE_COSINE == metric_type_);
 
+  fast_scan_ = UseFastScan(nbits_per_idx_);
+
   train_data_size_ = 0;
   // Delay object creation.
 }
@@ -93,11 +102,17 @@ butil::Status VectorIndexRawIvfPq::AddOrUpsert(const std::vector<pb::common::Vec
     return butil::Status(pb::error::Errno::EVECTOR_NOT_TRAIN, "ivf pq not train. train first");
   }
 
-  if (is_upsert) {
-    faiss::IDSelectorBatch sel(vector_with_ids.size(), ids.get());
-    index_->remove_ids(sel);
+  try {
+    if (is_upsert) {
+      faiss::IDSelectorBatch sel(vector_with_ids.size(), ids.get());
+      index_->remove_ids(sel);
+    }
+    index_->add_with_ids(vector_with_ids.size(), vector_values.get(), ids.get());
+  } catch (std::exception& e) {
+    std::string s = fmt::format("add or upsert exception: {}", e.what());
+    DINGO_LOG(ERROR) << fmt::format("[vector_index.raw_ivf_pq][id({})] {}", Id(), s);
+    return butil::Status(pb::error::Errno::EINTERNAL, s);
   }
-  index_->add_with_ids(vector_with_ids.size(), vector_values.get(), ids.get());
 
   return butil::Status::OK();
 }
@@ -144,7 +159,14 @@ butil::Status VectorIndexRawIvfPq::Delete(const std::vector<int64_t>& delete_ids
       return butil::Status::OK();
     }
 
-    auto remove_count = index_->remove_ids(sel);
+    size_t remove_count = 0;
+    try {
+      remove_count = index_->remove_ids(sel);
+    } catch (std::exception& e) {
+      std::string s = fmt::format("remove exception: {}", e.what());
+      DINGO_LOG(ERROR) << fmt::format("[vector_index.raw_ivf_pq][id({})] {}", Id(), s);
+      return butil::Status(pb::error::Errno::EINTERNAL, s);
+    }
     if (0 == remove_count) {
       DINGO_LOG(WARNING) << fmt::format("[vector_index.raw_ivf_pq][id({})] remove not found vector id.", Id());
       return butil::Status(pb::error::Errno::EVECTOR_INVALID, "remove not found vector id");
@@ -191,14 +213,25 @@ butil::Status VectorIndexRawIvfPq::Search(const std::vector<pb::common::VectorWi
     ivf_search_parameters.max_codes = 0;
     ivf_search_parameters.quantizer_params = nullptr;  // search for nlist . ignore
 
-    if (!filters.empty()) {
-      auto ivf_pq_filter = filters.empty() ? nullptr : std::make_shared<RawIvfPqIDSelector>(filters);
-      ivf_search_parameters.sel = ivf_pq_filter.get();
-      index_->search(vector_with_ids.size(), vector_values.get(), topk, distances.data(), labels.data(),
-                     &ivf_search_parameters);
-    } else {
-      index_->search(vector_with_ids.size(), vector_values.get(), topk, distances.data(), labels.data(),
-                     &ivf_search_parameters);
+    try {
+      if (!filters.empty()) {
+        auto ivf_pq_filter = filters.empty() ? nullptr : std::make_shared<RawIvfPqIDSelector>(filters);
+        if (fast_scan_) {
+          FastScanSearchWithFilter(vector_with_ids.size(), vector_values.get(), topk, *ivf_pq_filter,
+                                   ivf_search_parameters, distances, labels);
+        } else {
+          ivf_search_parameters.sel = ivf_pq_filter.get();
+          index_->search(vector_with_ids.size(), vector_values.get(), topk, distances.data(), labels.data(),
+                         &ivf_search_parameters);
+        }
+      } else {
+        index_->search(vector_with_ids.size(), vector_values.get(), topk, distances.data(), labels.data(),
+                       &ivf_search_parameters);
+      }
+    } catch (std::exception& e) {
+      std::string s = fmt::format("search exception: {}", e.what());
+      DINGO_LOG(ERROR) << fmt::format("[vector_index.raw_ivf_pq][id({})] {}", Id(), s);
+      return butil::Status(pb::error::Errno::EINTERNAL, s);
     }
   }
 
@@ -255,10 +288,15 @@ butil::Status VectorIndexRawIvfPq::RangeSearch(const std::vector<pb::common::Vec
     try {
       if (!filters.empty()) {
         auto ivf_pq_filter = filters.empty() ? nullptr : std::make_shared<RawIvfPqIDSelector>(filters);
-        ivf_search_parameters.sel = ivf_pq_filter.get();
-
-        index_->range_search(vector_with_ids.size(), vectors_values.get(), radius, range_search_result.get(),
-                             &ivf_search_parameters);
+        if (fast_scan_) {
+          index_->range_search(vector_with_ids.size(), vectors_values.get(), radius, range_search_result.get(),
+                               &ivf_search_parameters);
+          FilterRangeSearchResult(*ivf_pq_filter, range_search_result.get());
+        } else {
+          ivf_search_parameters.sel = ivf_pq_filter.get();
+          index_->range_search(vector_with_ids.size(), vectors_values.get(), radius, range_search_result.get(),
+                               &ivf_search_parameters);
+        }
       } else {
         index_->range_search(vector_with_ids.size(), vectors_values.get(), radius, range_search_result.get(),
                              &ivf_search_parameters);
@@ -311,14 +349,25 @@ butil::Status VectorIndexRawIvfPq::Load(const std::string& path) {
   // The outside has been locked. Remove the locking operation here.
   faiss::Index* internal_raw_index = nullptr;
   try {
-    internal_raw_index = faiss::read_index(path.c_str(), 0);
+    internal_raw_index = VectorIndexMmapReader::ReadIndex(path);
 
   } catch (std::exception& e) {
     delete internal_raw_index;
     return butil::Status(pb::error::Errno::EINTERNAL, fmt::format("read index exception: {} {}", path, e.what()));
   }
 
-  faiss::IndexIVFPQ* internal_index = dynamic_cast<faiss::IndexIVFPQ*>(internal_raw_index);
+  // accept both layouts, the fast scan switch may be changed after save
+  faiss::IndexIVF* internal_index = nullptr;
+  const faiss::ProductQuantizer* internal_pq = nullptr;
+  bool internal_fast_scan = false;
+  if (auto* ivf_pq = dynamic_cast<faiss::IndexIVFPQ*>(internal_raw_index); ivf_pq != nullptr) {
+    internal_index = ivf_pq;
+    internal_pq = &ivf_pq->pq;
+  } else if (auto* ivf_pq_fs = dynamic_cast<faiss::IndexIVFPQFastScan*>(internal_raw_index); ivf_pq_fs != nullptr) {
+    internal_index = ivf_pq_fs;
+    internal_pq = &ivf_pq_fs->pq;
+    internal_fast_scan = true;
+  }
   if (BAIDU_UNLIKELY(!internal_index)) {
     if (internal_raw_index) {
       delete internal_raw_index;
@@ -329,7 +378,7 @@ butil::Status VectorIndexRawIvfPq::Load(const std::string& path) {
   }
 
   // avoid mem leak!!!
-  std::unique_ptr<faiss::IndexIVFPQ> internal_index_ivf_pq(internal_index);
+  std::unique_ptr<faiss::IndexIVF> internal_index_ivf_pq(internal_index);
 
   // double check
   if (BAIDU_UNLIKELY(internal_index->d != dimension_)) {
@@ -378,18 +427,18 @@ butil::Status VectorIndexRawIvfPq::Load(const std::string& path) {
                          fmt::format("nlist not match: {} {}", internal_index->nlist, nlist_));
   }
 
-  if (BAIDU_UNLIKELY(internal_index->pq.M != nsubvector_)) {
-    return butil::Status(pb::error::Errno::EINTERNAL,
-                         fmt::format("M not match: {} {}", internal_index->pq.M, nsubvector_));
+  if (BAIDU_UNLIKELY(internal_pq->M != nsubvector_)) {
+    return butil::Status(pb::error::Errno::EINTERNAL, fmt::format("M not match: {} {}", internal_pq->M, nsubvector_));
   }
 
-  if (BAIDU_UNLIKELY(internal_index->pq.nbits != nbits_per_idx_)) {
+  if (BAIDU_UNLIKELY(internal_pq->nbits != nbits_per_idx_)) {
     return butil::Status(pb::error::Errno::EINTERNAL,
-                         fmt::format("nbits not match: {} {}", internal_index->pq.nbits, nbits_per_idx_));
+                         fmt::format("nbits not match: {} {}", internal_pq->nbits, nbits_per_idx_));
   }
 
   quantizer_.reset();
   index_ = std::move(internal_index_ivf_pq);
+  fast_scan_ = internal_fast_scan;
 
   train_data_size_ = index_->ntotal;
 
@@ -440,12 +489,14 @@ butil::Status VectorIndexRawIvfPq::GetMemorySize(int64_t& memory_size) {
 
   auto capacity = index_->ntotal * index_->code_size + index_->ntotal * sizeof(faiss::idx_t) +
                   index_->nlist * index_->d * sizeof(float);
-  auto centroid_table = index_->pq.M * index_->pq.ksub * index_->pq.dsub * sizeof(float);
+  const auto& pq = Pq();
+  auto centroid_table = pq.M * pq.ksub * pq.dsub * sizeof(float);
 
   memory_size += (capacity + centroid_table);
 
-  if (faiss::METRIC_L2 == index_->metric_type) {
-    auto precomputed_table = index_->nlist * index_->pq.M * index_->pq.ksub * sizeof(float);
+  // fast scan not use precomputed table
+  if (!fast_scan_ && faiss::METRIC_L2 == index_->metric_type) {
+    auto precomputed_table = index_->nlist * pq.M * pq.ksub * sizeof(float);
     memory_size += precomputed_table;
   }
 
@@ -522,7 +573,11 @@ bool VectorIndexRawIvfPq::NeedToRebuild() {
     return false;
   }
 
-  return (index_->ntotal / 2) >= train_data_size_;
+  if ((index_->ntotal / 2) >= train_data_size_) {
+    return true;
+  }
+
+  return VectorIndexUtils::IsIvfListImbalanced(index_.get());
 }
 
 bool VectorIndexRawIvfPq::IsTrained() {
@@ -549,24 +604,27 @@ bool VectorIndexRawIvfPq::NeedToSave(int64_t last_save_log_behind) {
 }
 
 void VectorIndexRawIvfPq::Init() {
+  faiss::MetricType metric_type = faiss::METRIC_L2;
   if (pb::common::MetricType::METRIC_TYPE_L2 == metric_type_) {
     quantizer_ = std::make_unique<faiss::IndexFlatL2>(dimension_);
-    index_ = std::make_unique<faiss::IndexIVFPQ>(quantizer_.get(), dimension_, nlist_, nsubvector_, nbits_per_idx_,
-                                                 faiss::METRIC_L2);
   } else if (pb::common::MetricType::METRIC_TYPE_INNER_PRODUCT == metric_type_) {
     quantizer_ = std::make_unique<faiss::IndexFlatIP>(dimension_);
-    index_ = std::make_unique<faiss::IndexIVFPQ>(quantizer_.get(), dimension_, nlist_, nsubvector_, nbits_per_idx_,
-                                                 faiss::MetricType::METRIC_INNER_PRODUCT);
+    metric_type = faiss::MetricType::METRIC_INNER_PRODUCT;
   } else if (pb::common::MetricType::METRIC_TYPE_COSINE == metric_type_) {
     normalize_ = true;
     quantizer_ = std::make_unique<faiss::IndexFlatIP>(dimension_);
-    index_ = std::make_unique<faiss::IndexIVFPQ>(quantizer_.get(), dimension_, nlist_, nsubvector_, nbits_per_idx_,
-                                                 faiss::MetricType::METRIC_INNER_PRODUCT);
+    metric_type = faiss::MetricType::METRIC_INNER_PRODUCT;
   } else {
     DINGO_LOG(ERROR) << fmt::format("[vector_index.raw_ivf_pq][id({})] unknown index type.", Id());
     quantizer_ = std::make_unique<faiss::IndexFlatL2>(dimension_);
+  }
+
+  if (fast_scan_) {
+    index_ = std::make_unique<faiss::IndexIVFPQFastScan>(quantizer_.get(), dimension_, nlist_, nsubvector_,
+                                                         nbits_per_idx_, metric_type);
+  } else {
     index_ = std::make_unique<faiss::IndexIVFPQ>(quantizer_.get(), dimension_, nlist_, nsubvector_, nbits_per_idx_,
-                                                 faiss::MetricType::METRIC_L2);
+                                                 metric_type);
   }
 }
 
@@ -583,4 +641,89 @@ void VectorIndexRawIvfPq::Reset() {
   index_->reset();
 }
 
+bool VectorIndexRawIvfPq::UseFastScan(int32_t nbits_per_idx) {
+  return FLAGS_enable_ivf_pq_fast_scan && nbits_per_idx == Constant::kIvfPqFastScanNbitsPerIdx;
+}
+
+const faiss::ProductQuantizer& VectorIndexRawIvfPq::Pq() const {
+  if (fast_scan_) {
+    return static_cast<const faiss::IndexIVFPQFastScan*>(index_.get())->pq;
+  }
+  return static_cast<const faiss::IndexIVFPQ*>(index_.get())->pq;
+}
+
+void VectorIndexRawIvfPq::FastScanSearchWithFilter(faiss::idx_t n, const float* vector_values, uint32_t topk,
+                                                   const faiss::IDSelector& selector,
+                                                   const faiss::IVFSearchParameters& parameters,
+                                                   std::vector<faiss::Index::distance_t>& distances,
+                                                   std::vector<faiss::idx_t>& labels) {
+  // rows not get topk results yet
+  std::vector<faiss::idx_t> rows(n);
+  std::iota(rows.begin(), rows.end(), 0);
+
+  faiss::idx_t search_topk = std::min(static_cast<faiss::idx_t>(topk) * FLAGS_ivf_pq_fast_scan_filter_topk_multiple,
+                                      std::max(index_->ntotal, static_cast<faiss::idx_t>(topk)));
+  std::vector<float> batch_values;
+  std::vector<faiss::Index::distance_t> batch_distances;
+  std::vector<faiss::idx_t> batch_labels;
+  while (!rows.empty()) {
+    batch_values.resize(rows.size() * dimension_);
+    for (size_t i = 0; i < rows.size(); ++i) {
+      std::copy_n(vector_values + rows[i] * dimension_, dimension_, batch_values.data() + i * dimension_);
+    }
+    batch_distances.assign(rows.size() * search_topk, 0.0f);
+    batch_labels.assign(rows.size() * search_topk, -1);
+    index_->search(rows.size(), batch_values.data(), search_topk, batch_distances.data(), batch_labels.data(),
+                   &parameters);
+
+    std::vector<faiss::idx_t> next_rows;
+    for (size_t i = 0; i < rows.size(); ++i) {
+      auto row = rows[i];
+      uint32_t count = 0;
+      bool exhausted = false;
+      for (faiss::idx_t j = 0; j < search_topk && count < topk; ++j) {
+        auto label = batch_labels[i * search_topk + j];
+        if (label < 0) {
+          exhausted = true;
+          break;
+        }
+        if (!selector.is_member(label)) {
+          continue;
+        }
+        distances[row * topk + count] = batch_distances[i * search_topk + j];
+        labels[row * topk + count] = label;
+        ++count;
+      }
+      for (uint32_t j = count; j < topk; ++j) {
+        labels[row * topk + j] = -1;
+      }
+
+      if (count < topk && !exhausted && search_topk < index_->ntotal) {
+        next_rows.push_back(row);
+      }
+    }
+
+    rows.swap(next_rows);
+    search_topk = std::min(search_topk * 2, index_->ntotal);
+  }
+}
+
+void VectorIndexRawIvfPq::FilterRangeSearchResult(const faiss::IDSelector& selector,
+                                                  faiss::RangeSearchResult* result) {
+  size_t pos = 0;
+  size_t begin = 0;
+  for (size_t row = 0; row < result->nq; ++row) {
+    size_t end = result->lims[row + 1];
+    for (size_t i = begin; i < end; ++i) {
+      if (selector.is_member(result->labels[i])) {
+        result->labels[pos] = result->labels[i];
+        result->distances[pos] = result->distances[i];
+        ++pos;
+      }
+    }
+    begin = end;
+    result->lims[row + 1] = pos;
+  }
+}
+
 }  // namespace dingodb
@@ -15,7 +15,9 @@
 #ifndef DINGODB_VECTOR_INDEX_RAW_IVF_PQ_H_  // NOLINT
 #define DINGODB_VECTOR_INDEX_RAW_IVF_PQ_H_
 
+#include <faiss/IndexIVF.h>
 #include <faiss/IndexIVFPQ.h>
+#include <faiss/IndexIVFPQFastScan.h>
 
 #include <cstdint>
 #include <memory>
@@ -25,7 +27,9 @@
 #include "butil/status.h"
 #include "faiss/Index.h"
 #include "faiss/MetricType.h"
+#include "faiss/impl/AuxIndexStructures.h"
 #include "faiss/impl/IDSelector.h"
+#include "faiss/impl/ProductQuantizer.h"
 #include "faiss/utils/distances.h"
 #include "proto/common.pb.h"
 #include "vector/vector_index.h"
@@ -108,9 +112,21 @@ class VectorIndexRawIvfPq : public VectorIndex {
   bool IsTrained() override;
   bool NeedToSave(int64_t last_save_log_behind) override;
 
+  // 4 bits pq codes are packed in blocks and scanned by simd shuffle lookup.
+  static bool UseFastScan(int32_t nbits_per_idx);
+  bool IsFastScan() const { return fast_scan_; }
+
  private:
   void Init();
 
+  const faiss::ProductQuantizer& Pq() const;
+
+  // Fast scan index not support id selector, search more candidates and filter them until enough.
+  void FastScanSearchWithFilter(faiss::idx_t n, const float* vector_values, uint32_t topk,
+                                const faiss::IDSelector& selector, const faiss::IVFSearchParameters& parameters,
+                                std::vector<faiss::Index::distance_t>& distances, std::vector<faiss::idx_t>& labels);
+  static void FilterRangeSearchResult(const faiss::IDSelector& selector, faiss::RangeSearchResult* result);
+
   bool IsTrainedImpl();
 
   // train failed. reset
@@ -134,7 +150,10 @@ class VectorIndexRawIvfPq : public VectorIndex {
 
   std::unique_ptr<faiss::Index> quantizer_;
 
-  std::unique_ptr<faiss::IndexIVFPQ> index_;
+  // IndexIVFPQ or IndexIVFPQFastScan
+  std::unique_ptr<faiss::IndexIVF> index_;
+
+  bool fast_scan_;
 
   // normalize vector
   bool normalize_;
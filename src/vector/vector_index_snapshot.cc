@@ -16,8 +16,11 @@
 
 #include <sys/wait.h>  // Add this include
 
+#include <algorithm>
 #include <atomic>
+#include <cinttypes>
 #include <cstdint>
+#include <cstdio>
 #include <cstdlib>
 #include <filesystem>
 #include <memory>
@@ -35,7 +38,11 @@ namespace dingodb {
 namespace vector_index {
 
 SnapshotMeta::SnapshotMeta(int64_t vector_index_id, const std::string& path)
-    : vector_index_id_(vector_index_id), path_(path) {}
+    : vector_index_id_(vector_index_id), path_(path) {
+  bthread_mutex_init(&mutex_, nullptr);
+}
+
+SnapshotMeta::~SnapshotMeta() { bthread_mutex_destroy(&mutex_); }
 
 bool SnapshotMeta::Init() {
   std::filesystem::path path(path_);
@@ -61,8 +68,6 @@ bool SnapshotMeta::Init() {
     return false;
   }
 
-  snapshot_log_id_ = snapshot_index_id;
-
   pb::store_internal::VectorIndexSnapshotMeta meta;
   braft::ProtoBufFile pb_file_meta(MetaPath());
   if (pb_file_meta.load(&meta) != 0) {
@@ -76,9 +81,22 @@ bool SnapshotMeta::Init() {
   epoch_ = meta.epoch();
   range_ = meta.range();
 
+  // snapshot pulled from peer is named by the log id include deltas, the meta keeps the base log id
+  base_log_id_ = meta.snapshot_log_id() > 0 ? meta.snapshot_log_id() : snapshot_index_id;
+  snapshot_log_id_ = base_log_id_;
+
+  std::error_code ec;
+  auto index_data_size = std::filesystem::file_size(IndexDataPath(), ec);
+  index_data_size_ = ec ? 0 : static_cast<int64_t>(index_data_size);
+
+  if (!LoadDeltas()) {
+    Destroy();
+    return false;
+  }
+
   DINGO_LOG(INFO) << fmt::format(
       "[vector_index.snapshot][index_id({})] Load snapshot meta, epoch: {} snapshot_index_id: {}, path: {}",
-      vector_index_id_, Helper::RegionEpochToString(epoch_), snapshot_index_id, path_);
+      vector_index_id_, Helper::RegionEpochToString(epoch_), SnapshotLogId(), path_);
 
   return true;
 }
@@ -86,11 +104,107 @@ bool SnapshotMeta::Init() {
 std::string SnapshotMeta::MetaPath() { return fmt::format("{}/meta", path_); }
 
 std::string SnapshotMeta::IndexDataPath() {
-  return fmt::format("{}/index_{}_{}.idx", path_, vector_index_id_, snapshot_log_id_);
+  return fmt::format("{}/index_{}_{}.idx", path_, vector_index_id_, base_log_id_);
 }
 
 std::vector<std::string> SnapshotMeta::ListFileNames() { return Helper::TraverseDirectory(path_); }
 
+std::string SnapshotMeta::DeltaPath(int64_t start_log_id, int64_t end_log_id) {
+  return fmt::format("{}/delta_{:020}_{:020}", path_, start_log_id, end_log_id);
+}
+
+bool SnapshotMeta::LoadDeltas() {
+  std::vector<Delta> deltas;
+  for (const auto& filename : Helper::TraverseDirectory(path_, "delta_", true, false)) {
+    int64_t start_log_id = 0, end_log_id = 0;
+    if (sscanf(filename.c_str(), "delta_%" SCNd64 "_%" SCNd64, &start_log_id, &end_log_id) != 2 ||  // NOLINT
+        fmt::format("delta_{:020}_{:020}", start_log_id, end_log_id) != filename) {
+      // e.g. tmp file of a crashed save
+      continue;
+    }
+
+    std::error_code ec;
+    auto size = std::filesystem::file_size(fmt::format("{}/{}", path_, filename), ec);
+    deltas.push_back({start_log_id, end_log_id, ec ? 0 : static_cast<int64_t>(size)});
+  }
+
+  std::sort(deltas.begin(), deltas.end(),
+            [](const Delta& lhs, const Delta& rhs) { return lhs.start_log_id < rhs.start_log_id; });
+
+  // keep the chain from base, the rest is stale
+  int64_t log_id = base_log_id_;
+  std::vector<Delta> chain;
+  for (const auto& delta : deltas) {
+    if (delta.start_log_id == log_id && delta.end_log_id > log_id) {
+      chain.push_back(delta);
+      log_id = delta.end_log_id;
+    } else {
+      DINGO_LOG(WARNING) << fmt::format(
+          "[vector_index.snapshot][index_id({})] Delete stale snapshot delta({}-{}), chain log id: {}, path: {}",
+          vector_index_id_, delta.start_log_id, delta.end_log_id, log_id, path_);
+      Helper::RemoveFileOrDirectory(DeltaPath(delta.start_log_id, delta.end_log_id));
+    }
+  }
+
+  BAIDU_SCOPED_LOCK(mutex_);
+  deltas_.swap(chain);
+  snapshot_log_id_ = log_id;
+
+  return true;
+}
+
+bool SnapshotMeta::AddDelta(int64_t start_log_id, int64_t end_log_id) {
+  std::error_code ec;
+  auto size = std::filesystem::file_size(DeltaPath(start_log_id, end_log_id), ec);
+  if (ec) {
+    DINGO_LOG(ERROR) << fmt::format("[vector_index.snapshot][index_id({})] Not found snapshot delta({}-{}), path: {}",
+                                    vector_index_id_, start_log_id, end_log_id, path_);
+    return false;
+  }
+
+  BAIDU_SCOPED_LOCK(mutex_);
+  if (start_log_id != snapshot_log_id_.load() || end_log_id <= start_log_id) {
+    DINGO_LOG(ERROR) << fmt::format(
+        "[vector_index.snapshot][index_id({})] Snapshot delta({}-{}) not follow snapshot log id({}), path: {}",
+        vector_index_id_, start_log_id, end_log_id, snapshot_log_id_.load(), path_);
+    return false;
+  }
+
+  deltas_.push_back({start_log_id, end_log_id, static_cast<int64_t>(size)});
+  snapshot_log_id_ = end_log_id;
+
+  return true;
+}
+
+std::vector<std::string> SnapshotMeta::DeltaPaths() {
+  BAIDU_SCOPED_LOCK(mutex_);
+
+  std::vector<std::string> paths;
+  paths.reserve(deltas_.size());
+  for (const auto& delta : deltas_) {
+    paths.push_back(DeltaPath(delta.start_log_id, delta.end_log_id));
+  }
+
+  return paths;
+}
+
+int64_t SnapshotMeta::DeltaCount() {
+  BAIDU_SCOPED_LOCK(mutex_);
+
+  return deltas_.size();
+}
+
+int64_t SnapshotMeta::DeltaSize() {
+  BAIDU_SCOPED_LOCK(mutex_);
+
+  int64_t size = 0;
+  for (const auto& delta : deltas_) {
+    size += delta.size;
+  }
+
+  return size;
+}
+
 void SnapshotMeta::Destroy() {
   bool is_destroied = false;
   if (!is_destroied_.compare_exchange_strong(is_destroied, true)) {
@@ -100,7 +214,7 @@ void SnapshotMeta::Destroy() {
   // Delete directory
   DINGO_LOG(INFO) << fmt::format(
       "[vector_index.snapshot][index_id({})] Delete snapshot, epoch: {} snapshot_index_id: {} path: {}.",
-      vector_index_id_, Helper::RegionEpochToString(epoch_), snapshot_log_id_, path_);
+      vector_index_id_, Helper::RegionEpochToString(epoch_), SnapshotLogId(), path_);
   Helper::RemoveAllFileOrDirectory(path_);
 }
 
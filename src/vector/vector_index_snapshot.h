@@ -15,7 +15,9 @@
 #ifndef DINGODB_VECTOR_INDEX_SNAPSHOT_H_
 #define DINGODB_VECTOR_INDEX_SNAPSHOT_H_
 
+#include <atomic>
 #include <cstdint>
+#include <map>
 #include <memory>
 #include <string>
 #include <vector>
@@ -28,10 +30,12 @@ namespace dingodb {
 namespace vector_index {
 
 // Indicate a vector index snapshot
+// A snapshot is a base index image plus a chain of delta files, each delta holds the vector add/delete
+// of log (start_log_id, end_log_id] and the next delta starts at the end of the previous one.
 class SnapshotMeta {
  public:
   SnapshotMeta(int64_t vector_index_id, const std::string& path);
-  ~SnapshotMeta() = default;
+  ~SnapshotMeta();
 
   static std::shared_ptr<SnapshotMeta> New(int64_t vector_index_id, const std::string& path) {
     return std::make_shared<SnapshotMeta>(vector_index_id, path);
@@ -40,25 +44,51 @@ class SnapshotMeta {
   bool Init();
 
   int64_t VectorIndexId() const { return vector_index_id_; }
-  int64_t SnapshotLogId() const { return snapshot_log_id_; }
+  // log id the snapshot covers, include deltas
+  int64_t SnapshotLogId() const { return snapshot_log_id_.load(); }
+  // log id of the base index image
+  int64_t BaseLogId() const { return base_log_id_; }
   std::string Path() const { return path_; }
   std::string MetaPath();
   std::string IndexDataPath();
   std::vector<std::string> ListFileNames();
 
+  std::string DeltaPath(int64_t start_log_id, int64_t end_log_id);
+  // Append a saved delta file to the chain, start log id must be SnapshotLogId().
+  bool AddDelta(int64_t start_log_id, int64_t end_log_id);
+  // delta file paths in apply order
+  std::vector<std::string> DeltaPaths();
+  int64_t DeltaCount();
+  int64_t DeltaSize();
+  int64_t IndexDataSize() const { return index_data_size_; }
+
   pb::common::RegionEpoch Epoch() const { return epoch_; }
   pb::common::Range Range() const { return range_; }
 
   void Destroy();
 
  private:
+  struct Delta {
+    int64_t start_log_id;
+    int64_t end_log_id;
+    int64_t size;
+  };
+
+  bool LoadDeltas();
+
   int64_t vector_index_id_;
-  int64_t snapshot_log_id_;
+  std::atomic<int64_t> snapshot_log_id_{0};
+  int64_t base_log_id_{0};
+  int64_t index_data_size_{0};
   std::string path_;
 
   pb::common::RegionEpoch epoch_;
   pb::common::Range range_;
 
+  // protect deltas_
+  bthread_mutex_t mutex_;
+  std::vector<Delta> deltas_;
+
   std::atomic<bool> is_destroied_{false};
 };
 
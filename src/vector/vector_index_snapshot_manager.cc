@@ -14,9 +14,11 @@
 
 #include "vector/vector_index_snapshot_manager.h"
 
+#include <fcntl.h>
 #include <sys/wait.h>  // Add this include
 
 #include <algorithm>
+#include <atomic>
 #include <cstdint>
 #include <cstdlib>
 #include <cstring>
@@ -27,27 +29,50 @@
 #include <vector>
 
 #include "braft/protobuf_file.h"
+#include "bthread/bthread.h"
+#include "bthread/mutex.h"
 #include "butil/endpoint.h"
+#include "butil/fd_guard.h"
 #include "butil/iobuf.h"
+#include "butil/scoped_lock.h"
 #include "butil/status.h"
 #include "butil/strings/string_split.h"
+#include "butil/time.h"
 #include "common/helper.h"
 #include "common/logging.h"
 #include "common/service_access.h"
+#include "common/synchronization.h"
 #include "config/config_manager.h"
 #include "fmt/core.h"
 #include "proto/common.pb.h"
 #include "proto/error.pb.h"
 #include "proto/file_service.pb.h"
 #include "proto/node.pb.h"
+#include "proto/raft.pb.h"
 #include "proto/store_internal.pb.h"
+#include "raft/raft_cmd_codec.h"
 #include "server/file_service.h"
 #include "server/server.h"
+#include "vector/codec.h"
 #include "vector/vector_index_factory.h"
 
 namespace dingodb {
 
 DEFINE_bool(vector_index_snapshot_use_fork, true, "Use fork to save vector index snapshot.");
+DEFINE_bool(enable_vector_index_delta_snapshot, true, "save vector index changes as delta of last snapshot");
+DEFINE_int64(vector_index_delta_snapshot_max_count, 16, "max delta file count of one vector index snapshot");
+DEFINE_double(vector_index_delta_snapshot_max_size_ratio, 0.3,
+              "save a full snapshot when delta size exceed this ratio of the base index file size");
+DEFINE_int64(vector_index_delta_snapshot_file_size, 64 * 1024 * 1024, "split delta file by wal size");
+DEFINE_int32(vector_index_snapshot_download_concurrency, 1,
+             "concurrent chunk requests of downloading one vector index snapshot file");
+DEFINE_int32(vector_index_snapshot_download_retry_times, 3,
+             "retry times of one chunk of vector index snapshot file, a broken download resume at the chunk");
+DEFINE_int64(vector_index_snapshot_download_rate_limit_bytes, 0,
+             "max bytes per second of all vector index snapshot downloads, 0 means no limit");
+DEFINE_bool(vector_index_pull_snapshot_from_all_peers, false,
+            "follower pull vector index snapshot from all peers instead of leader only, the fastest peer is preferred "
+            "among the peers own the newest snapshot");
 
 // Get all snapshot path, except tmp dir.
 static std::vector<std::string> GetSnapshotPaths(std::string path) {
@@ -152,6 +177,130 @@ std::string VectorIndexSnapshotManager::GetSnapshotNewPath(int64_t vector_index_
   return fmt::format("{}/snapshot_{:020}", GetSnapshotParentPath(vector_index_id), snapshot_log_id);
 }
 
+// Wait until the bytes can be downloaded, the rate limit is shared by all downloads.
+static void ThrottleDownload(int64_t bytes) {
+  int64_t rate = FLAGS_vector_index_snapshot_download_rate_limit_bytes;
+  if (rate <= 0) {
+    return;
+  }
+
+  static bthread::Mutex mutex;
+  static int64_t next_time_us = 0;
+  int64_t wait_us = 0;
+  {
+    BAIDU_SCOPED_LOCK(mutex);
+    int64_t now_us = butil::monotonic_time_us();
+    int64_t start_us = std::max(next_time_us, now_us);
+    next_time_us = start_us + bytes * 1000000 / rate;
+    wait_us = start_us - now_us;
+  }
+
+  if (wait_us > 0) {
+    bthread_usleep(wait_us);
+  }
+}
+
+// Download the chunk at offset and write it at the same offset of fd, retry the chunk on failure.
+static butil::Status DownloadChunk(int64_t reader_id, const butil::EndPoint& endpoint, const std::string& filename,
+                                   int64_t offset, int fd, bool& is_eof) {
+  pb::fileservice::GetFileRequest request;
+  request.set_reader_id(reader_id);
+  request.set_filename(filename);
+  request.set_offset(offset);
+  request.set_size(Constant::kFileTransportChunkSize);
+
+  ThrottleDownload(Constant::kFileTransportChunkSize);
+
+  for (int retry = 0;; ++retry) {
+    butil::IOBuf buf;
+    auto response = ServiceAccess::GetFile(request, endpoint, &buf);
+    // the data must be as long as the peer read, otherwise it is broken
+    if (response != nullptr && buf.size() == response->read_size()) {
+      int64_t write_offset = offset;
+      while (!buf.empty()) {
+        ssize_t nw = buf.pcut_into_file_descriptor(fd, write_offset);
+        if (nw < 0) {
+          return butil::Status(pb::error::EINTERNAL, "Write file %s failed, error: %s", filename.c_str(),
+                               strerror(errno));
+        }
+        write_offset += nw;
+      }
+
+      is_eof = response->eof();
+      return butil::Status();
+    }
+
+    if (retry >= FLAGS_vector_index_snapshot_download_retry_times) {
+      return butil::Status(pb::error::EINTERNAL, fmt::format("Get file {} offset {} failed", filename, offset));
+    }
+
+    DINGO_LOG(WARNING) << fmt::format("[vector_index.snapshot] get file {} offset {} failed, retry {}.", filename,
+                                      offset, retry + 1);
+    bthread_usleep((retry + 1) * 100 * 1000);
+  }
+}
+
+// Download file by concurrent workers, worker i gets the chunks i, i + n, i + 2n ... until eof.
+static butil::Status DownloadFile(int64_t reader_id, const butil::EndPoint& endpoint, const std::string& filename,
+                                  const std::string& filepath) {
+  butil::fd_guard fd(open(filepath.c_str(), O_CREAT | O_WRONLY | O_TRUNC | O_CLOEXEC, 0644));
+  if (fd < 0) {
+    return butil::Status(pb::error::EINTERNAL, "Open file %s failed, error: %s", filepath.c_str(), strerror(errno));
+  }
+
+  int concurrency = std::max(1, FLAGS_vector_index_snapshot_download_concurrency);
+  // the chunks after stop_chunk are not needed, because of eof or error
+  std::atomic<int64_t> stop_chunk{INT64_MAX};
+  auto stop_at = [&stop_chunk](int64_t chunk) {
+    int64_t old_chunk = stop_chunk.load();
+    while (chunk < old_chunk && !stop_chunk.compare_exchange_weak(old_chunk, chunk)) {
+    }
+  };
+
+  std::vector<butil::Status> statuses(concurrency);
+  std::vector<Bthread> workers;
+  workers.reserve(concurrency);
+  for (int i = 0; i < concurrency; ++i) {
+    workers.emplace_back([&, i]() {
+      for (int64_t chunk = i; chunk < stop_chunk.load(); chunk += concurrency) {
+        bool is_eof = false;
+        statuses[i] =
+            DownloadChunk(reader_id, endpoint, filename, chunk * Constant::kFileTransportChunkSize, fd, is_eof);
+        if (!statuses[i].ok()) {
+          stop_at(-1);
+          return;
+        }
+        if (is_eof) {
+          stop_at(chunk);
+          return;
+        }
+      }
+    });
+  }
+  for (auto& worker : workers) {
+    worker.Join();
+  }
+
+  for (const auto& status : statuses) {
+    if (!status.ok()) {
+      return status;
+    }
+  }
+
+  return butil::Status();
+}
+
+// Clean the reader created by getting snapshot meta.
+static void CleanFileReader(const std::string& uri) {
+  int64_t reader_id = ParseReaderId(uri);
+  butil::EndPoint endpoint = ParseHost(uri);
+  if (reader_id > 0 && endpoint.port != 0) {
+    pb::fileservice::CleanFileReaderRequest request;
+    request.set_reader_id(reader_id);
+    ServiceAccess::CleanFileReader(request, endpoint);
+  }
+}
+
 butil::Status VectorIndexSnapshotManager::LaunchInstallSnapshot(const butil::EndPoint& endpoint,
                                                                 vector_index::SnapshotMetaPtr snapshot) {
   assert(snapshot != nullptr);
@@ -329,18 +478,25 @@ butil::Status VectorIndexSnapshotManager::PullLastSnapshotFromPeers(vector_index
 
   auto self_peer = raft_node->GetPeerId();
   std::vector<braft::PeerId> peers;
-  if (raft_node->IsLeader()) {
+  if (raft_node->IsLeader() || FLAGS_vector_index_pull_snapshot_from_all_peers) {
     raft_node->ListPeers(&peers);
   } else {
     peers.push_back(raft_node->GetLeaderId());
   }
+  int64_t peer_min_latency_us = INT64_MAX;
   for (const auto& peer : peers) {
     if (peer == self_peer) {
       continue;
     }
 
     pb::node::GetVectorIndexSnapshotResponse response;
+    int64_t start_time_us = butil::monotonic_time_us();
     auto status = ServiceAccess::GetVectorIndexSnapshot(request, peer.addr, response);
+    int64_t latency_us = butil::monotonic_time_us() - start_time_us;
+    // only probe the meta, LaunchPullSnapshot gets a new reader
+    if (status.ok() && !response.uri().empty()) {
+      CleanFileReader(response.uri());
+    }
     if (!status.ok()) {
       DINGO_LOG(WARNING) << fmt::format(
           "[vector_index.snapshot][index({})] get peer vector index snapshot meta failed, peer({}) error: {}.",
@@ -355,9 +511,12 @@ butil::Status VectorIndexSnapshotManager::PullLastSnapshotFromPeers(vector_index
       continue;
     }
 
-    if (peer_max_snapshot_log_index < response.meta().snapshot_log_index()) {
+    // prefer the newest snapshot, then the fastest peer
+    if (peer_max_snapshot_log_index < response.meta().snapshot_log_index() ||
+        (peer_max_snapshot_log_index == response.meta().snapshot_log_index() && latency_us < peer_min_latency_us)) {
       peer_max_snapshot_log_index = response.meta().snapshot_log_index();
       peer_snapshot_version = response.meta().epoch().version();
+      peer_min_latency_us = latency_us;
       endpoint = peer.addr;
     }
   }
@@ -424,44 +583,16 @@ butil::Status VectorIndexSnapshotManager::DownloadSnapshotFile(const std::string
   }
 
   for (const auto& filename : meta.filenames()) {
-    int64_t offset = 0;
-    std::ofstream ofile;
-
     std::string filepath = fmt::format("{}/{}", tmp_snapshot_path, filename);
-    ofile.open(filepath, std::ofstream::out | std::ofstream::binary);
     DINGO_LOG(INFO) << fmt::format("[vector_index.snapshot][index({})] get vector index snapshot file: {}",
                                    meta.vector_index_id(), filepath);
 
-    for (;;) {
-      pb::fileservice::GetFileRequest request;
-      request.set_reader_id(reader_id);
-      request.set_filename(filename);
-      request.set_offset(offset);
-      request.set_size(Constant::kFileTransportChunkSize);
-
-      DINGO_LOG(DEBUG) << fmt::format("[vector_index.snapshot][index({})] GetFileRequest: {}", meta.vector_index_id(),
-                                      request.ShortDebugString());
-
-      butil::IOBuf buf;
-      auto response = ServiceAccess::GetFile(request, endpoint, &buf);
-      if (response == nullptr) {
-        return butil::Status(pb::error::EINTERNAL, "Get file failed");
-      }
-
-      DINGO_LOG(DEBUG) << fmt::format("[vector_index.snapshot][index({})] GetFileResponse: {}", meta.vector_index_id(),
-                                      response->ShortDebugString());
-
-      // Write local file.
-      ofile << buf;
-
-      if (response->eof()) {
-        break;
-      }
-
-      offset += response->read_size();
+    auto status = DownloadFile(reader_id, endpoint, filename, filepath);
+    if (!status.ok()) {
+      DINGO_LOG(ERROR) << fmt::format("[vector_index.snapshot][index({})] get vector index snapshot file failed, {}",
+                                      meta.vector_index_id(), Helper::PrintStatus(status));
+      return status;
     }
-
-    ofile.close();
   }
 
   if (snapshot_set->IsExistSnapshot(meta.snapshot_log_index())) {
@@ -496,6 +627,184 @@ butil::Status VectorIndexSnapshotManager::DownloadSnapshotFile(const std::string
   return butil::Status();
 }
 
+static bool IsSameRange(const pb::common::Range& lhs, const pb::common::Range& rhs) {
+  return lhs.start_key() == rhs.start_key() && lhs.end_key() == rhs.end_key();
+}
+
+// Delta is saved only when the changes of the snapshot is small compared to the base image,
+// otherwise save a full image, which folds all deltas.
+static bool CanSaveDeltaSnapshot(VectorIndexPtr vector_index, vector_index::SnapshotMetaPtr snapshot) {
+  if (!FLAGS_enable_vector_index_delta_snapshot || snapshot == nullptr) {
+    return false;
+  }
+
+  if (snapshot->Epoch().version() != vector_index->Epoch().version() ||
+      !IsSameRange(snapshot->Range(), vector_index->Range())) {
+    return false;
+  }
+
+  if (snapshot->DeltaCount() >= FLAGS_vector_index_delta_snapshot_max_count) {
+    return false;
+  }
+
+  return snapshot->IndexDataSize() > 0 &&
+         snapshot->DeltaSize() < snapshot->IndexDataSize() * FLAGS_vector_index_delta_snapshot_max_size_ratio;
+}
+
+// Save the vector add/delete of log (snapshot log id, end_log_id] from wal as delta files of the snapshot.
+butil::Status VectorIndexSnapshotManager::SaveVectorIndexDeltaSnapshot(VectorIndexPtr vector_index,
+                                                                       vector_index::SnapshotMetaPtr snapshot,
+                                                                       int64_t end_log_id) {
+  int64_t vector_index_id = vector_index->Id();
+  int64_t start_log_id = snapshot->SnapshotLogId();
+  if (end_log_id <= start_log_id) {
+    return butil::Status::OK();
+  }
+
+  auto log_storage = Server::GetInstance().GetLogStorageManager()->GetLogStorage(vector_index_id);
+  if (log_storage == nullptr) {
+    return butil::Status(pb::error::EINTERNAL, "Not found log storage");
+  }
+  if (log_storage->FirstLogIndex() > start_log_id + 1 || log_storage->LastLogIndex() < end_log_id) {
+    return butil::Status(pb::error::EINTERNAL,
+                         fmt::format("Log({}-{}) is not complete in wal({}-{})", start_log_id + 1, end_log_id,
+                                     log_storage->FirstLogIndex(), log_storage->LastLogIndex()));
+  }
+
+  int64_t start_time = Helper::TimestampMs();
+
+  int64_t min_vector_id = 0, max_vector_id = 0;
+  VectorCodec::DecodeRangeToVectorId(vector_index->Range(), min_vector_id, max_vector_id);
+
+  // split into files by size, a delta file is parsed as one message at load
+  auto save_delta = [&](pb::raft::RaftCmdRequest& delta, int64_t delta_end_log_id) -> butil::Status {
+    int64_t delta_start_log_id = snapshot->SnapshotLogId();
+    std::string delta_path = snapshot->DeltaPath(delta_start_log_id, delta_end_log_id);
+    braft::ProtoBufFile pb_file(delta_path);
+    if (pb_file.save(&delta, true) != 0) {
+      return butil::Status(pb::error::EINTERNAL, fmt::format("Save snapshot delta file {} failed", delta_path));
+    }
+    if (!snapshot->AddDelta(delta_start_log_id, delta_end_log_id)) {
+      Helper::RemoveFileOrDirectory(delta_path);
+      return butil::Status(pb::error::EINTERNAL, fmt::format("Add snapshot delta file {} failed", delta_path));
+    }
+
+    delta.Clear();
+    return butil::Status::OK();
+  };
+
+  // Saved deltas are a valid prefix of the chain, so a unsupported log in the middle just stop the delta save.
+  pb::raft::RaftCmdRequest delta;
+  int64_t delta_bytes = 0;
+  auto log_entrys = log_storage->GetEntrys(start_log_id + 1, end_log_id);
+  for (const auto& log_entry : log_entrys) {
+    pb::raft::RaftCmdRequest raft_cmd;
+    if (!RaftCmdCodec::Decode(log_entry->data, raft_cmd)) {
+      return butil::Status(pb::error::EINTERNAL, fmt::format("Parse log entry {} failed", log_entry->index));
+    }
+
+    for (auto& request : *raft_cmd.mutable_requests()) {
+      switch (request.cmd_type()) {
+        case pb::raft::VECTOR_ADD: {
+          pb::raft::Request delta_request;
+          delta_request.set_cmd_type(pb::raft::VECTOR_ADD);
+          for (auto& vector : *request.mutable_vector_add()->mutable_vectors()) {
+            if (vector.id() >= min_vector_id && vector.id() < max_vector_id) {
+              delta_request.mutable_vector_add()->add_vectors()->Swap(&vector);
+            }
+          }
+          if (delta_request.vector_add().vectors_size() > 0) {
+            delta.add_requests()->Swap(&delta_request);
+          }
+          break;
+        }
+        case pb::raft::VECTOR_DELETE: {
+          pb::raft::Request delta_request;
+          delta_request.set_cmd_type(pb::raft::VECTOR_DELETE);
+          for (auto vector_id : request.vector_delete().ids()) {
+            if (vector_id >= min_vector_id && vector_id < max_vector_id) {
+              delta_request.mutable_vector_delete()->add_ids(vector_id);
+            }
+          }
+          if (delta_request.vector_delete().ids_size() > 0) {
+            delta.add_requests()->Swap(&delta_request);
+          }
+          break;
+        }
+        case pb::raft::META_WRITE:
+        case pb::raft::SAVE_RAFT_SNAPSHOT:
+        case pb::raft::PRE_CREATE_REGION:
+        case pb::raft::POST_CREATE_REGION:
+          break;
+        default:
+          // e.g. txn commit or split, which change vector index but can not be decoded here
+          return butil::Status(pb::error::EVECTOR_NOT_SUPPORT,
+                               fmt::format("Log entry {} cmd type {} not support delta", log_entry->index,
+                                           static_cast<int>(request.cmd_type())));
+      }
+    }
+
+    delta_bytes += log_entry->data.size();
+    if (delta_bytes >= FLAGS_vector_index_delta_snapshot_file_size && log_entry->index < end_log_id) {
+      auto status = save_delta(delta, log_entry->index);
+      if (!status.ok()) {
+        return status;
+      }
+      delta_bytes = 0;
+    }
+  }
+
+  auto status = save_delta(delta, end_log_id);
+  if (!status.ok()) {
+    return status;
+  }
+
+  // Set truncate wal log index.
+  log_storage->TruncateVectorIndexPrefix(end_log_id);
+
+  DINGO_LOG(INFO) << fmt::format(
+      "[vector_index.save_snapshot][index_id({})] Save vector index snapshot delta({}-{}) base({}) delta count({}) "
+      "delta size({}) elapsed time {}ms",
+      vector_index_id, start_log_id, end_log_id, snapshot->BaseLogId(), snapshot->DeltaCount(), snapshot->DeltaSize(),
+      Helper::TimestampMs() - start_time);
+
+  return butil::Status::OK();
+}
+
+butil::Status VectorIndexSnapshotManager::ApplyDeltaSnapshot(VectorIndexPtr vector_index,
+                                                             const std::string& delta_path) {
+  pb::raft::RaftCmdRequest delta;
+  braft::ProtoBufFile pb_file(delta_path);
+  if (pb_file.load(&delta) != 0) {
+    return butil::Status(pb::error::EINTERNAL, fmt::format("Load snapshot delta file {} failed", delta_path));
+  }
+
+  for (auto& request : *delta.mutable_requests()) {
+    butil::Status status;
+    if (request.cmd_type() == pb::raft::VECTOR_ADD) {
+      std::vector<pb::common::VectorWithId> vectors;
+      vectors.reserve(request.vector_add().vectors_size());
+      for (auto& vector : *request.mutable_vector_add()->mutable_vectors()) {
+        vectors.emplace_back();
+        vectors.back().Swap(&vector);
+      }
+      status = vector_index->UpsertByParallel(vectors, false);
+    } else if (request.cmd_type() == pb::raft::VECTOR_DELETE) {
+      std::vector<int64_t> ids(request.vector_delete().ids().begin(), request.vector_delete().ids().end());
+      status = vector_index->DeleteByParallel(ids, false);
+    }
+
+    // the snapshot is only valid with every delta op applied, fail it and let the index be rebuilt
+    if (!status.ok()) {
+      DINGO_LOG(WARNING) << fmt::format("[vector_index.load_snapshot][index_id({})] apply snapshot delta {} failed, {}",
+                                        vector_index->Id(), delta_path, Helper::PrintStatus(status));
+      return status;
+    }
+  }
+
+  return butil::Status::OK();
+}
+
 // Save vector index snapshot, just one concurrence.
 butil::Status VectorIndexSnapshotManager::SaveVectorIndexSnapshot(VectorIndexWrapperPtr vector_index_wrapper,
                                                                   int64_t& snapshot_log_index) {
@@ -529,6 +838,22 @@ butil::Status VectorIndexSnapshotManager::SaveVectorIndexSnapshot(VectorIndexWra
 
   int64_t vector_index_id = vector_index_wrapper->Id();
 
+  auto last_snapshot = vector_index_wrapper->SnapshotSet()->GetLastSnapshot();
+  if (CanSaveDeltaSnapshot(vector_index, last_snapshot)) {
+    // vector index apply log id only grows, all log before it are applied
+    int64_t apply_log_index = vector_index_wrapper->ApplyLogId();
+    auto status = SaveVectorIndexDeltaSnapshot(vector_index, last_snapshot, apply_log_index);
+    if (status.ok()) {
+      snapshot_log_index = last_snapshot->SnapshotLogId();
+      return butil::Status::OK();
+    }
+
+    DINGO_LOG(WARNING) << fmt::format(
+        "[vector_index.save_snapshot][index_id({})] Save vector index snapshot delta failed, save full snapshot, "
+        "error: {}",
+        vector_index_id, Helper::PrintStatus(status));
+  }
+
   int64_t start_time = Helper::TimestampMs();
 
   // lock write for atomic ops
@@ -901,6 +1226,17 @@ std::shared_ptr<VectorIndex> VectorIndexSnapshotManager::LoadVectorIndexSnapshot
     return nullptr;
   }
 
+  // apply delta files after base image
+  for (const auto& delta_path : last_snapshot->DeltaPaths()) {
+    status = ApplyDeltaSnapshot(vector_index, delta_path);
+    if (!status.ok()) {
+      DINGO_LOG(WARNING) << fmt::format(
+          "[vector_index.load_snapshot][index_id({}).snapshot_log_id({})] load snapshot delta {} failed, error: {}.",
+          vector_index_id, last_snapshot->SnapshotLogId(), delta_path, Helper::PrintStatus(status));
+      return nullptr;
+    }
+  }
+
   // set vector_index apply log id
   vector_index->SetSnapshotLogId(last_snapshot->SnapshotLogId());
   vector_index->SetApplyLogId(last_snapshot->SnapshotLogId());
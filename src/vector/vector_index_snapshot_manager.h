@@ -66,6 +66,9 @@ class VectorIndexSnapshotManager {
  private:
   static std::string GetSnapshotTmpPath(int64_t vector_index_id);
   static std::string GetSnapshotNewPath(int64_t vector_index_id, int64_t snapshot_log_id);
+  static butil::Status SaveVectorIndexDeltaSnapshot(VectorIndexPtr vector_index,
+                                                    vector_index::SnapshotMetaPtr snapshot, int64_t end_log_id);
+  static butil::Status ApplyDeltaSnapshot(VectorIndexPtr vector_index, const std::string& delta_path);
   static butil::Status DownloadSnapshotFile(const std::string& uri, const pb::node::VectorIndexSnapshotMeta& meta,
                                             vector_index::SnapshotMetaSetPtr snapshot_set);
 };
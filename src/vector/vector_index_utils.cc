@@ -26,25 +26,36 @@
 #include "common/constant.h"
 #include "common/logging.h"
 #include "coprocessor/utils.h"
+#include "faiss/Clustering.h"
 #include "faiss/MetricType.h"
 #include "faiss/utils/extra_distances-inl.h"
 #include "fmt/core.h"
+#include "gflags/gflags.h"
 #include "hnswlib/hnswlib.h"
 #include "hnswlib/space_ip.h"
 #include "hnswlib/space_l2.h"
 #include "proto/common.pb.h"
 #include "proto/error.pb.h"
+#include "simd/hook.h"
 
 namespace dingodb {
 
 DECLARE_bool(dingo_log_switch_scalar_speed_up_detail);
 
+DEFINE_double(ivf_rebuild_imbalance_factor, 0,
+              "rebuild ivf index when imbalance factor of inverted lists exceed it, 0 means disable");
+DEFINE_int64(vector_calc_distance_parallel_ops, 4 * 1024 * 1024,
+             "split vector calc distance into parallel tasks of about this many multiply-adds, 0 means disable");
+
+// upper bound of parallel tasks of one vector calc distance request
+static const int64_t kCalcDistanceMaxChunkNum = 32;
+
 butil::Status VectorIndexUtils::CalcDistanceEntry(
     const ::dingodb::pb::index::VectorCalcDistanceRequest& request,
-    std::vector<std::vector<float>>& distances,                             // NOLINT
-    std::vector<::dingodb::pb::common::Vector>& result_op_left_vectors,     // NOLINT
-    std::vector<::dingodb::pb::common::Vector>& result_op_right_vectors) {  // NOLINT
-
+    std::vector<std::vector<float>>& distances,                            // NOLINT
+    std::vector<::dingodb::pb::common::Vector>& result_op_left_vectors,    // NOLINT
+    std::vector<::dingodb::pb::common::Vector>& result_op_right_vectors,   // NOLINT
+    uint32_t topk, ThreadPoolPtr thread_pool, std::vector<std::vector<uint32_t>>* topk_indexes) {
   pb::index::AlgorithmType algorithm_type = request.algorithm_type();
   pb::common::MetricType metric_type = request.metric_type();
   const google::protobuf::RepeatedPtrField<::dingodb::pb::common::Vector>& op_left_vectors = request.op_left_vectors();
@@ -53,6 +64,21 @@ butil::Status VectorIndexUtils::CalcDistanceEntry(
 
   bool is_return_normlize = request.is_return_normlize();
 
+  // the normalized vectors are returned pair by pair, only the distances can be computed as a matrix
+  bool is_matrix_algorithm =
+      algorithm_type == pb::index::ALGORITHM_FAISS || algorithm_type == pb::index::ALGORITHM_HNSWLIB;
+  bool is_matrix_metric = metric_type == pb::common::METRIC_TYPE_L2 ||
+                          metric_type == pb::common::METRIC_TYPE_INNER_PRODUCT ||
+                          metric_type == pb::common::METRIC_TYPE_COSINE;
+  if (!is_return_normlize && is_matrix_algorithm && is_matrix_metric) {
+    std::vector<std::vector<uint32_t>> indexes;
+    return CalcDistanceMatrix(algorithm_type, metric_type, op_left_vectors, op_right_vectors, topk, thread_pool,
+                              distances, topk_indexes != nullptr ? *topk_indexes : indexes);
+  }
+  if (topk > 0) {
+    return butil::Status(pb::error::EILLEGAL_PARAMTETERS, "topk is not supported with normalized vectors returned");
+  }
+
   switch (algorithm_type) {
     case pb::index::ALGORITHM_FAISS: {
       return CalcDistanceByFaiss(metric_type, op_left_vectors, op_right_vectors, is_return_normlize, distances,
@@ -74,6 +100,145 @@ butil::Status VectorIndexUtils::CalcDistanceEntry(
   return butil::Status();
 }
 
+butil::Status VectorIndexUtils::CalcDistanceMatrix(
+    pb::index::AlgorithmType algorithm_type, pb::common::MetricType metric_type,
+    const google::protobuf::RepeatedPtrField<::dingodb::pb::common::Vector>& op_left_vectors,
+    const google::protobuf::RepeatedPtrField<::dingodb::pb::common::Vector>& op_right_vectors, uint32_t topk,
+    ThreadPoolPtr thread_pool, std::vector<std::vector<float>>& distances,
+    std::vector<std::vector<uint32_t>>& topk_indexes) {
+  distances.clear();
+  topk_indexes.clear();
+  if (op_left_vectors.empty() || op_right_vectors.empty()) {
+    return butil::Status();
+  }
+
+  bool is_hnsw = algorithm_type == pb::index::ALGORITHM_HNSWLIB;
+  if (!is_hnsw && algorithm_type != pb::index::ALGORITHM_FAISS) {
+    return butil::Status(pb::error::EILLEGAL_PARAMTETERS, "invalid algorithm type");
+  }
+  bool is_l2 = metric_type == pb::common::METRIC_TYPE_L2;
+  bool is_cosine = metric_type == pb::common::METRIC_TYPE_COSINE;
+  if (!is_l2 && !is_cosine && metric_type != pb::common::METRIC_TYPE_INNER_PRODUCT) {
+    return butil::Status(pb::error::EILLEGAL_PARAMTETERS, "invalid metric type");
+  }
+
+  // pack to contiguous rows, normalized as the pairwise functions do for cosine
+  size_t dimension = op_left_vectors[0].float_values_size();
+  auto pack_vectors = [&](const google::protobuf::RepeatedPtrField<::dingodb::pb::common::Vector>& vectors,
+                          std::vector<float>& values) -> bool {
+    values.resize(vectors.size() * dimension);
+    for (int i = 0; i < vectors.size(); ++i) {
+      const auto& float_values = vectors[i].float_values();
+      if (static_cast<size_t>(float_values.size()) != dimension) {
+        return false;
+      }
+      float* row = values.data() + i * dimension;
+      if (is_cosine && is_hnsw) {
+        NormalizeVectorForHnsw(float_values.data(), dimension, row);
+      } else {
+        std::copy(float_values.begin(), float_values.end(), row);
+        if (is_cosine) {
+          NormalizeVectorForFaiss(row, dimension);
+        }
+      }
+    }
+    return true;
+  };
+
+  std::vector<float> left_values;
+  std::vector<float> right_values;
+  if (!pack_vectors(op_left_vectors, left_values) || !pack_vectors(op_right_vectors, right_values)) {
+    return butil::Status(pb::error::EILLEGAL_PARAMTETERS, "op_left_vectors and op_right_vectors dimension not match");
+  }
+
+  size_t nx = op_left_vectors.size();
+  size_t ny = op_right_vectors.size();
+  int64_t chunk_num = 1;
+  if (thread_pool != nullptr && FLAGS_vector_calc_distance_parallel_ops > 0) {
+    int64_t ops = static_cast<int64_t>(nx * ny * dimension);
+    chunk_num = std::clamp(ops / FLAGS_vector_calc_distance_parallel_ops, static_cast<int64_t>(1),
+                           std::min(kCalcDistanceMaxChunkNum, static_cast<int64_t>(ny)));
+  }
+
+  // chunk c holds the nx x (end - start) matrix of right vectors [start, end) at offset nx * start
+  std::vector<float> matrix(nx * ny);
+  auto calc_chunk = [&](int64_t chunk) {
+    size_t start = ny * chunk / chunk_num;
+    size_t end = ny * (chunk + 1) / chunk_num;
+    float* chunk_matrix = matrix.data() + nx * start;
+    const float* chunk_right = right_values.data() + start * dimension;
+    if (is_l2) {
+      fvec_L2sqr_nx_ny(chunk_matrix, left_values.data(), chunk_right, dimension, nx, end - start);
+    } else {
+      fvec_inner_products_nx_ny(chunk_matrix, left_values.data(), chunk_right, dimension, nx, end - start);
+    }
+  };
+
+  std::vector<ThreadPool::TaskPtr> tasks;
+  for (int64_t chunk = 1; chunk < chunk_num; ++chunk) {
+    auto task = thread_pool->ExecuteTask([&, chunk](void*) { calc_chunk(chunk); }, nullptr);
+    if (task != nullptr) {
+      tasks.push_back(task);
+    } else {
+      calc_chunk(chunk);
+    }
+  }
+  calc_chunk(0);
+  for (auto& task : tasks) {
+    task->Join();
+  }
+
+  // hnswlib reports inner product as 1 - ip
+  bool is_one_minus = is_hnsw && !is_l2;
+  distances.resize(nx);
+  for (auto& distance : distances) {
+    distance.resize(ny);
+  }
+  for (int64_t chunk = 0; chunk < chunk_num; ++chunk) {
+    size_t start = ny * chunk / chunk_num;
+    size_t end = ny * (chunk + 1) / chunk_num;
+    const float* chunk_matrix = matrix.data() + nx * start;
+    for (size_t i = 0; i < nx; ++i) {
+      const float* row = chunk_matrix + i * (end - start);
+      for (size_t j = start; j < end; ++j) {
+        distances[i][j] = is_one_minus ? 1.0f - row[j - start] : row[j - start];
+      }
+    }
+  }
+
+  if (topk == 0) {
+    return butil::Status();
+  }
+
+  // raw inner product of faiss is a similarity, the bigger the nearer
+  bool is_similarity = !is_hnsw && !is_l2;
+  size_t k = std::min(static_cast<size_t>(topk), ny);
+  topk_indexes.resize(nx);
+  for (size_t i = 0; i < nx; ++i) {
+    auto& row = distances[i];
+    auto& indexes = topk_indexes[i];
+    indexes.resize(ny);
+    for (size_t j = 0; j < ny; ++j) {
+      indexes[j] = j;
+    }
+    std::partial_sort(indexes.begin(), indexes.begin() + k, indexes.end(), [&](uint32_t lhs, uint32_t rhs) {
+      if (row[lhs] != row[rhs]) {
+        return is_similarity ? row[lhs] > row[rhs] : row[lhs] < row[rhs];
+      }
+      return lhs < rhs;
+    });
+    indexes.resize(k);
+
+    std::vector<float> topk_row(k);
+    for (size_t j = 0; j < k; ++j) {
+      topk_row[j] = row[indexes[j]];
+    }
+    row.swap(topk_row);
+  }
+
+  return butil::Status();
+}
+
 butil::Status VectorIndexUtils::CalcDistanceCore(
     const google::protobuf::RepeatedPtrField<::dingodb::pb::common::Vector>& op_left_vectors,
     const google::protobuf::RepeatedPtrField<::dingodb::pb::common::Vector>& op_right_vectors, bool is_return_normlize,
@@ -401,12 +566,12 @@ void VectorIndexUtils::ResultOpVectorAssignmentWrapper(const ::dingodb::pb::comm
   }
 }
 
-void VectorIndexUtils::NormalizeVectorForFaiss(float* x, int32_t d) {
-  static const float kFloatAccuracy = 0.00001;
+static const float kNormalizeFloatAccuracy = 0.00001;
 
+void VectorIndexUtils::NormalizeVectorForFaiss(float* x, int32_t d) {
   float norm_l2_sqr = faiss::fvec_norm_L2sqr(x, d);
 
-  if (norm_l2_sqr > 0 && std::abs(1.0f - norm_l2_sqr) > kFloatAccuracy) {
+  if (norm_l2_sqr > 0 && std::abs(1.0f - norm_l2_sqr) > kNormalizeFloatAccuracy) {
     float norm_l2 = std::sqrt(norm_l2_sqr);
     for (int32_t i = 0; i < d; i++) {
       x[i] = x[i] / norm_l2;
@@ -414,6 +579,16 @@ void VectorIndexUtils::NormalizeVectorForFaiss(float* x, int32_t d) {
   }
 }
 
+float VectorIndexUtils::InverseNormForFaiss(const float* x, int32_t d) {
+  float norm_l2_sqr = faiss::fvec_norm_L2sqr(x, d);
+
+  if (norm_l2_sqr > 0 && std::abs(1.0f - norm_l2_sqr) > kNormalizeFloatAccuracy) {
+    return 1.0f / std::sqrt(norm_l2_sqr);
+  }
+
+  return 1.0f;
+}
+
 void VectorIndexUtils::NormalizeVectorForHnsw(const float* data, uint32_t dimension, float* norm_array) {
   float norm = 0.0f;
   for (int i = 0; i < dimension; i++) norm += data[i] * data[i];
@@ -423,6 +598,28 @@ void VectorIndexUtils::NormalizeVectorForHnsw(const float* data, uint32_t dimens
   for (int i = 0; i < dimension; i++) norm_array[i] = data[i] * norm;
 }
 
+bool VectorIndexUtils::IsIvfListImbalanced(const faiss::IndexIVF* index) {
+  if (FLAGS_ivf_rebuild_imbalance_factor <= 0 || index == nullptr || index->invlists == nullptr ||
+      index->nlist <= 1) {
+    return false;
+  }
+
+  // too few vectors per list, the imbalance is just noise
+  faiss::ClusteringParameters clustering_parameters;
+  if (index->ntotal < static_cast<faiss::idx_t>(clustering_parameters.min_points_per_centroid * index->nlist)) {
+    return false;
+  }
+
+  double imbalance_factor = index->invlists->imbalance_factor();
+  if (imbalance_factor > FLAGS_ivf_rebuild_imbalance_factor) {
+    DINGO_LOG(INFO) << fmt::format("[vector_index.utils] ivf list imbalanced, nlist: {} ntotal: {} factor: {:.3f}",
+                                   index->nlist, index->ntotal, imbalance_factor);
+    return true;
+  }
+
+  return false;
+}
+
 butil::Status VectorIndexUtils::CheckVectorDimension(const std::vector<pb::common::VectorWithId>& vector_with_ids,
                                                      int dimension) {
   for (const auto& vector_with_id : vector_with_ids) {
@@ -21,7 +21,9 @@
 #include <vector>
 
 #include "butil/status.h"
+#include "common/threadpool.h"
 #include "faiss/Index.h"
+#include "faiss/IndexIVF.h"
 #include "faiss/impl/AuxIndexStructures.h"
 #include "proto/common.pb.h"
 #include "proto/index.pb.h"
@@ -38,10 +40,25 @@ class VectorIndexUtils {
   VectorIndexUtils(VectorIndexUtils&& rhs) = delete;
   VectorIndexUtils& operator=(VectorIndexUtils&& rhs) = delete;
 
+  // topk > 0 keeps the topk nearest right vectors of every left vector, see CalcDistanceMatrix.
   static butil::Status CalcDistanceEntry(const ::dingodb::pb::index::VectorCalcDistanceRequest& request,
                                          std::vector<std::vector<float>>& distances,
                                          std::vector<::dingodb::pb::common::Vector>& result_op_left_vectors,
-                                         std::vector<::dingodb::pb::common::Vector>& result_op_right_vectors);
+                                         std::vector<::dingodb::pb::common::Vector>& result_op_right_vectors,
+                                         uint32_t topk = 0, ThreadPoolPtr thread_pool = nullptr,
+                                         std::vector<std::vector<uint32_t>>* topk_indexes = nullptr);
+
+  // Distance matrix of all left vectors against all right vectors by the blocked nx x ny simd kernels, same values
+  // as the pairwise CalcDistanceByFaiss/CalcDistanceByHnswlib. The right vectors are split into column chunks which
+  // are computed in parallel on thread_pool, thread_pool may be nullptr.
+  // topk > 0 keeps only the topk nearest right vectors of every left vector, nearest first, and their positions in
+  // op_right_vectors are returned in topk_indexes.
+  static butil::Status CalcDistanceMatrix(
+      pb::index::AlgorithmType algorithm_type, pb::common::MetricType metric_type,
+      const google::protobuf::RepeatedPtrField<::dingodb::pb::common::Vector>& op_left_vectors,
+      const google::protobuf::RepeatedPtrField<::dingodb::pb::common::Vector>& op_right_vectors, uint32_t topk,
+      ThreadPoolPtr thread_pool, std::vector<std::vector<float>>& distances,
+      std::vector<std::vector<uint32_t>>& topk_indexes);
 
   using DoCalcDistanceFunc =
       std::function<butil::Status(const ::dingodb::pb::common::Vector&, const ::dingodb::pb::common::Vector&, bool,
@@ -158,8 +175,15 @@ class VectorIndexUtils {
                                               dingodb::pb::common::Vector& result_op_right_vectors);
 
   static void NormalizeVectorForFaiss(float* x, int32_t d);
+  // The factor NormalizeVectorForFaiss scales x by, ip(q, x) * factor is the cosine similarity of the normalized q
+  // and x, so cosine can be computed on raw vectors at inner product cost.
+  static float InverseNormForFaiss(const float* x, int32_t d);
   static void NormalizeVectorForHnsw(const float* data, uint32_t dimension, float* norm_array);
 
+  // The inverted lists of ivf index are imbalanced, the nprobe scans of the big lists dominate the search latency,
+  // re-clustering by rebuild is needed.
+  static bool IsIvfListImbalanced(const faiss::IndexIVF* index);
+
   static butil::Status CheckVectorDimension(const std::vector<pb::common::VectorWithId>& vector_with_ids,
                                             int dimension);
 
@@ -0,0 +1,120 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "vector/vector_packed_codec.h"
+
+#include <cstdint>
+#include <vector>
+
+#include "butil/iobuf.h"
+#include "butil/status.h"
+#include "fmt/core.h"
+#include "proto/common.pb.h"
+#include "proto/error.pb.h"
+#include "proto/index.pb.h"
+
+namespace dingodb {
+
+static_assert(__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__, "packed vector encoding require little endian host");
+
+void VectorPackedCodec::Pack(const std::vector<pb::common::VectorWithId*>& vector_with_ids, butil::IOBuf& buf) {
+  uint32_t count = 0;
+  for (const auto* vector_with_id : vector_with_ids) {
+    if (!vector_with_id->vector().float_values().empty()) {
+      ++count;
+    }
+  }
+
+  uint32_t magic = kMagic;
+  buf.append(&magic, sizeof(magic));
+  buf.append(&count, sizeof(count));
+
+  for (uint32_t position = 0; position < vector_with_ids.size(); ++position) {
+    auto* vector = vector_with_ids[position]->mutable_vector();
+    if (vector->float_values().empty()) {
+      continue;
+    }
+
+    uint32_t dimension = vector->float_values_size();
+    buf.append(&position, sizeof(position));
+    buf.append(&dimension, sizeof(dimension));
+    buf.append(vector->float_values().data(), dimension * sizeof(float));
+
+    vector->set_dimension(dimension);
+    vector->clear_float_values();
+  }
+}
+
+butil::Status VectorPackedCodec::Unpack(const std::vector<pb::common::VectorWithId*>& vector_with_ids,
+                                        butil::IOBuf& buf) {
+  uint32_t magic = 0;
+  uint32_t count = 0;
+  if (buf.cutn(&magic, sizeof(magic)) != sizeof(magic) || magic != kMagic ||
+      buf.cutn(&count, sizeof(count)) != sizeof(count)) {
+    return butil::Status(pb::error::EILLEGAL_PARAMTETERS, "Packed vector header is invalid");
+  }
+
+  for (uint32_t i = 0; i < count; ++i) {
+    uint32_t position = 0;
+    uint32_t dimension = 0;
+    if (buf.cutn(&position, sizeof(position)) != sizeof(position) ||
+        buf.cutn(&dimension, sizeof(dimension)) != sizeof(dimension)) {
+      return butil::Status(pb::error::EILLEGAL_PARAMTETERS, "Packed vector is truncated");
+    }
+    if (position >= vector_with_ids.size()) {
+      return butil::Status(pb::error::EILLEGAL_PARAMTETERS,
+                           fmt::format("Packed vector position {} exceed vector count {}", position,
+                                       vector_with_ids.size()));
+    }
+    if (buf.size() < dimension * sizeof(float)) {
+      return butil::Status(pb::error::EILLEGAL_PARAMTETERS, "Packed vector is truncated");
+    }
+
+    auto* vector = vector_with_ids[position]->mutable_vector();
+    auto* float_values = vector->mutable_float_values();
+    float_values->Resize(dimension, 0.0f);
+    buf.cutn(float_values->mutable_data(), dimension * sizeof(float));
+    vector->set_dimension(dimension);
+  }
+
+  if (!buf.empty()) {
+    return butil::Status(pb::error::EILLEGAL_PARAMTETERS, "Packed vector has redundant data");
+  }
+
+  return butil::Status::OK();
+}
+
+std::vector<pb::common::VectorWithId*> VectorPackedCodec::VectorWithIds(pb::index::VectorSearchRequest* request) {
+  std::vector<pb::common::VectorWithId*> vector_with_ids;
+  vector_with_ids.reserve(request->vector_with_ids_size());
+  for (auto& vector_with_id : *request->mutable_vector_with_ids()) {
+    vector_with_ids.push_back(&vector_with_id);
+  }
+
+  return vector_with_ids;
+}
+
+std::vector<pb::common::VectorWithId*> VectorPackedCodec::VectorWithIds(pb::index::VectorSearchResponse* response) {
+  std::vector<pb::common::VectorWithId*> vector_with_ids;
+  for (auto& batch_result : *response->mutable_batch_results()) {
+    for (auto& vector_with_distance : *batch_result.mutable_vector_with_distances()) {
+      vector_with_ids.push_back(vector_with_distance.mutable_vector_with_id());
+    }
+  }
+
+  return vector_with_ids;
+}
+
+}  // namespace dingodb
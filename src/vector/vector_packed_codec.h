@@ -0,0 +1,50 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef DINGODB_VECTOR_PACKED_CODEC_H_
+#define DINGODB_VECTOR_PACKED_CODEC_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "butil/iobuf.h"
+#include "butil/status.h"
+#include "proto/common.pb.h"
+#include "proto/index.pb.h"
+
+namespace dingodb {
+
+// Packed wire encoding of float vectors.
+// The float values are moved out of protobuf into the brpc attachment as raw little endian float32, so they are
+// copied by one memcpy instead of being parsed and serialized element by element.
+// Layout: magic(u32) count(u32) then count items of position(u32) dimension(u32) float32 * dimension, position is the
+// index of the vector in the list enumerated by VectorWithIds, the vector keeps its dimension with empty float_values.
+// The server replies packed only when the request is packed, so old client and server are not affected.
+class VectorPackedCodec {
+ public:
+  static constexpr uint32_t kMagic = 0x4b505644;  // "DVPK"
+
+  // Move the float values of vectors to buf.
+  static void Pack(const std::vector<pb::common::VectorWithId*>& vector_with_ids, butil::IOBuf& buf);
+  // Move the float values from buf back to vectors, buf is consumed.
+  static butil::Status Unpack(const std::vector<pb::common::VectorWithId*>& vector_with_ids, butil::IOBuf& buf);
+
+  static std::vector<pb::common::VectorWithId*> VectorWithIds(pb::index::VectorSearchRequest* request);
+  static std::vector<pb::common::VectorWithId*> VectorWithIds(pb::index::VectorSearchResponse* response);
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_VECTOR_PACKED_CODEC_H_
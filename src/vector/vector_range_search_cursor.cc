@@ -0,0 +1,149 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "vector/vector_range_search_cursor.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "butil/status.h"
+#include "common/constant.h"
+#include "fmt/core.h"
+#include "proto/error.pb.h"
+#include "simd/hook.h"
+#include "vector/codec.h"
+#include "vector/vector_index_utils.h"
+
+namespace dingodb {
+
+VectorRangeSearchCursor::VectorRangeSearchCursor(RawEngine::ReaderPtr reader, const pb::common::Range& region_range,
+                                                 int32_t dimension, pb::common::MetricType metric_type, float radius)
+    : reader_(reader),
+      region_range_(region_range),
+      dimension_(dimension),
+      metric_type_(metric_type),
+      radius_(radius),
+      is_ip_(metric_type == pb::common::MetricType::METRIC_TYPE_INNER_PRODUCT ||
+             metric_type == pb::common::MetricType::METRIC_TYPE_COSINE),
+      normalize_(metric_type == pb::common::MetricType::METRIC_TYPE_COSINE) {}
+
+butil::Status VectorRangeSearchCursor::Open(const std::vector<pb::common::VectorWithId>& vector_with_ids,
+                                            const std::vector<std::shared_ptr<VectorIndex::FilterFunctor>>& filters) {
+  if (vector_with_ids.empty()) {
+    return butil::Status(pb::error::EILLEGAL_PARAMTETERS, "vector_with_ids is empty");
+  }
+  auto status = VectorIndexUtils::CheckVectorDimension(vector_with_ids, dimension_);
+  if (!status.ok()) {
+    return status;
+  }
+
+  query_count_ = vector_with_ids.size();
+  query_values_ = VectorIndexUtils::ExtractVectorValue(vector_with_ids, dimension_, normalize_);
+  filters_ = filters;
+
+  IteratorOptions options;
+  options.lower_bound = region_range_.start_key();
+  options.upper_bound = region_range_.end_key();
+  iter_ = reader_->NewIterator(Constant::kVectorDataCF, options);
+  if (iter_ == nullptr) {
+    return butil::Status(pb::error::EINTERNAL, "new iterator failed");
+  }
+  iter_->Seek(region_range_.start_key());
+
+  return butil::Status::OK();
+}
+
+bool VectorRangeSearchCursor::IsFiltered(int64_t vector_id) {
+  for (const auto& filter : filters_) {
+    if (!filter->Check(vector_id)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+butil::Status VectorRangeSearchCursor::Next(int64_t max_count,
+                                            std::vector<pb::index::VectorWithDistanceResult>& results,
+                                            bool& has_more) {
+  if (iter_ == nullptr) {
+    return butil::Status(pb::error::EINTERNAL, "range search cursor is not open");
+  }
+  if (max_count <= 0) {
+    max_count = std::numeric_limits<int64_t>::max();
+  }
+
+  results.clear();
+  results.resize(query_count_);
+
+  std::vector<float> values(dimension_);
+  std::vector<float> ip_distances(is_ip_ ? query_count_ : 0);
+  int64_t count = 0;
+  for (; iter_->Valid() && count < max_count; iter_->Next()) {
+    std::string key(iter_->Key());
+    auto vector_id = VectorCodec::DecodeVectorId(key);
+    if (vector_id <= 0 || vector_id == INT64_MAX) {
+      continue;
+    }
+    if (IsFiltered(vector_id)) {
+      continue;
+    }
+
+    auto value = iter_->Value();
+    pb::common::Vector vector;
+    if (!vector.ParseFromArray(value.data(), value.size())) {
+      return butil::Status(pb::error::EINTERNAL, "Parse proto from string error");
+    }
+    if (vector.float_values_size() != dimension_) {
+      return butil::Status(pb::error::Errno::EVECTOR_INVALID,
+                           fmt::format("vector dimension not match, {} {}", vector.float_values_size(), dimension_));
+    }
+    std::copy(vector.float_values().begin(), vector.float_values().end(), values.begin());
+    // cosine scales the inner product of the raw vector, no normalized copy
+    float inverse_norm = normalize_ ? VectorIndexUtils::InverseNormForFaiss(values.data(), dimension_) : 1.0F;
+    ++scanned_count_;
+
+    // one vector against all queries, no early abort for inner product, partial sums are not monotonic
+    if (is_ip_) {
+      fvec_inner_products_ny(ip_distances.data(), values.data(), query_values_.get(), dimension_, query_count_);
+    }
+
+    for (size_t i = 0; i < query_count_; ++i) {
+      float distance = is_ip_ ? 1.0F - ip_distances[i] * inverse_norm
+                              : fvec_L2sqr_early_abort(query_values_.get() + i * dimension_, values.data(),
+                                                       dimension_, radius_);
+      if (distance >= radius_) {
+        continue;
+      }
+
+      auto* vector_with_distance = results[i].add_vector_with_distances();
+      auto* vector_with_id = vector_with_distance->mutable_vector_with_id();
+      vector_with_id->set_id(vector_id);
+      vector_with_id->mutable_vector()->set_dimension(dimension_);
+      vector_with_id->mutable_vector()->set_value_type(::dingodb::pb::common::ValueType::FLOAT);
+      vector_with_distance->set_distance(distance);
+      vector_with_distance->set_metric_type(metric_type_);
+      ++count;
+    }
+  }
+
+  has_more = iter_->Valid();
+
+  return butil::Status::OK();
+}
+
+}  // namespace dingodb
@@ -0,0 +1,87 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_VECTOR_RANGE_SEARCH_CURSOR_H_
+#define DINGODB_VECTOR_RANGE_SEARCH_CURSOR_H_
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "butil/status.h"
+#include "engine/iterator.h"
+#include "engine/raw_engine.h"
+#include "proto/common.pb.h"
+#include "proto/index.pb.h"
+#include "vector/vector_index.h"
+
+namespace dingodb {
+
+class VectorRangeSearchCursor;
+using VectorRangeSearchCursorPtr = std::shared_ptr<VectorRangeSearchCursor>;
+
+// Brute force range search cursor over the vector data of a region.
+// Scan the vector data cf in vector id order and return the vectors within radius page by page, only one page of
+// results is held at a time, so a dense neighborhood query does not materialize all matches of the region.
+// Distance follows VectorIndexUtils::FillRangeSearchResult, a vector is in range when distance < radius, for L2 the
+// kernel aborts once the partial sum is out of radius.
+class VectorRangeSearchCursor {
+ public:
+  VectorRangeSearchCursor(RawEngine::ReaderPtr reader, const pb::common::Range& region_range, int32_t dimension,
+                          pb::common::MetricType metric_type, float radius);
+  ~VectorRangeSearchCursor() = default;
+
+  VectorRangeSearchCursor(const VectorRangeSearchCursor& rhs) = delete;
+  VectorRangeSearchCursor& operator=(const VectorRangeSearchCursor& rhs) = delete;
+  VectorRangeSearchCursor(VectorRangeSearchCursor&& rhs) = delete;
+  VectorRangeSearchCursor& operator=(VectorRangeSearchCursor&& rhs) = delete;
+
+  static VectorRangeSearchCursorPtr New(RawEngine::ReaderPtr reader, const pb::common::Range& region_range,
+                                        int32_t dimension, pb::common::MetricType metric_type, float radius) {
+    return std::make_shared<VectorRangeSearchCursor>(reader, region_range, dimension, metric_type, radius);
+  }
+
+  butil::Status Open(const std::vector<pb::common::VectorWithId>& vector_with_ids,
+                     const std::vector<std::shared_ptr<VectorIndex::FilterFunctor>>& filters);
+
+  // Scan until max_count results of all queries are collected or the region is over, results has one entry per
+  // query. A vector is never split across pages, so a page may exceed max_count by less than the query count.
+  butil::Status Next(int64_t max_count, std::vector<pb::index::VectorWithDistanceResult>& results, bool& has_more);
+
+  bool HasMore() const { return iter_ != nullptr && iter_->Valid(); }
+
+  int64_t ScannedCount() const { return scanned_count_; }
+
+ private:
+  bool IsFiltered(int64_t vector_id);
+
+  RawEngine::ReaderPtr reader_;
+  pb::common::Range region_range_;
+  int32_t dimension_;
+  pb::common::MetricType metric_type_;
+  float radius_;
+  bool is_ip_;
+  bool normalize_;
+
+  size_t query_count_{0};
+  std::unique_ptr<float[]> query_values_;
+  std::vector<std::shared_ptr<VectorIndex::FilterFunctor>> filters_;
+
+  IteratorPtr iter_;
+  int64_t scanned_count_{0};
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_VECTOR_RANGE_SEARCH_CURSOR_H_
@@ -15,12 +15,14 @@
 #include "vector/vector_reader.h"
 
 #include <algorithm>
+#include <cmath>
 #include <cstdint>
 #include <deque>
 #include <limits>
 #include <memory>
 #include <set>
 #include <string>
+#include <string_view>
 #include <utility>
 #include <vector>
 
@@ -33,13 +35,19 @@
 #include "coprocessor/utils.h"
 #include "fmt/core.h"
 #include "gflags/gflags.h"
+#include "google/protobuf/io/coded_stream.h"
+#include "google/protobuf/wire_format_lite.h"
 #include "proto/common.pb.h"
 #include "proto/error.pb.h"
 #include "server/server.h"
+#include "simd/hook.h"
 #include "vector/codec.h"
+#include "vector/multi_vector.h"
 #include "vector/vector_index.h"
+#include "vector/vector_id_bitmap.h"
 #include "vector/vector_index_factory.h"
 #include "vector/vector_index_utils.h"
+#include "vector/vector_range_search_cursor.h"
 
 namespace dingodb {
 
@@ -50,12 +58,28 @@ namespace dingodb {
 
 DEFINE_int64(vector_index_max_range_search_result_count, 1024, "max range search result count");
 DEFINE_int64(vector_index_bruteforce_batch_count, 2048, "bruteforce batch count");
+DEFINE_int32(vector_index_bruteforce_parallel_num, 0,
+             "split region by vector id and brute force search the parts in vector index thread pool, <=1 is serial");
+DEFINE_int64(vector_range_search_page_size, 1024, "brute force range search results fetched per cursor page");
 DEFINE_bool(dingo_log_switch_scalar_speed_up_detail, false, "scalar speed up log");
 
+DEFINE_uint32(vector_post_filter_min_topk_multiple, 2, "scalar post filter min search topk multiple of top_n");
+DEFINE_uint32(vector_post_filter_max_topk, 16384, "scalar post filter max search topk after expand");
+DEFINE_uint32(vector_multi_vector_candidate_multiple, 4,
+             "multi vector search candidate tokens of every query token, multiple of top_n");
+DEFINE_int64(vector_filter_bruteforce_max_candidate_count, 8192,
+             "pre filter with candidates not more than it may search by brute force over the candidates");
+DEFINE_double(vector_filter_bruteforce_max_selectivity, 0.1,
+              "pre filter with candidates/region count not more than it may search by brute force over the candidates");
+DEFINE_uint32(vector_document_filter_max_match_count, 1000000,
+             "max matched documents of full-text pre filter when the document search top_n is not set");
+
 bvar::LatencyRecorder g_bruteforce_search_latency("dingo_bruteforce_search_latency");
 bvar::LatencyRecorder g_bruteforce_range_search_latency("dingo_bruteforce_range_search_latency");
+bvar::LatencyRecorder g_multi_vector_search_latency("dingo_multi_vector_search_latency");
 
 DECLARE_bool(dingo_log_switch_coprocessor_scalar_detail);
+DECLARE_bool(enable_vector_scalar_bitmap_index);
 
 butil::Status VectorReader::QueryVectorWithId(const pb::common::Range& region_range, int64_t partition_id,
                                               int64_t vector_id, bool with_vector_data,
@@ -63,18 +87,22 @@ butil::Status VectorReader::QueryVectorWithId(const pb::common::Range& region_ra
   std::string key;
   VectorCodec::EncodeVectorKey(region_range.start_key()[0], partition_id, vector_id, key);
 
-  std::string value;
-  auto status = reader_->KvGet(Constant::kStoreDataCF, key, value);
+  // parse from the pinned value, save a copy of the big vector value.
+  bool parse_ok = true;
+  auto status = reader_->KvGetPinned(Constant::kStoreDataCF, key, [&](std::string_view value) {
+    if (with_vector_data) {
+      pb::common::Vector vector;
+      parse_ok = vector.ParseFromArray(value.data(), value.size());
+      if (parse_ok) {
+        vector_with_id.mutable_vector()->Swap(&vector);
+      }
+    }
+  });
   if (!status.ok()) {
     return status;
   }
-
-  if (with_vector_data) {
-    pb::common::Vector vector;
-    if (!vector.ParseFromString(value)) {
-      return butil::Status(pb::error::EINTERNAL, "Parse proto from string error");
-    }
-    vector_with_id.mutable_vector()->Swap(&vector);
+  if (!parse_ok) {
+    return butil::Status(pb::error::EINTERNAL, "Parse proto from string error");
   }
 
   vector_with_id.set_id(vector_id);
@@ -86,7 +114,8 @@ butil::Status VectorReader::SearchVector(
     int64_t partition_id, VectorIndexWrapperPtr vector_index, pb::common::Range region_range,
     const std::vector<pb::common::VectorWithId>& vector_with_ids, const pb::common::VectorSearchParameter& parameter,
     const pb::common::ScalarSchema& scalar_schema,
-    std::vector<pb::index::VectorWithDistanceResult>& vector_with_distance_results) {
+    std::vector<pb::index::VectorWithDistanceResult>& vector_with_distance_results,
+    std::shared_ptr<VectorIndex::FilterFunctor> document_filter) {
   if (vector_with_ids.empty()) {
     DINGO_LOG(WARNING) << "Empty vector with ids";
     return butil::Status();
@@ -96,10 +125,15 @@ butil::Status VectorReader::SearchVector(
   auto vector_filter_type = parameter.vector_filter_type();
 
   bool with_vector_data = !(parameter.without_vector_data());
-  std::vector<pb::index::VectorWithDistanceResult> tmp_results;
 
-  // scalar post filter
-  if (dingodb::pb::common::VectorFilter::SCALAR_FILTER == vector_filter &&
+  if (document_filter != nullptr) {  // full-text pre filter search
+    butil::Status status = DoVectorSearchForDocumentPreFilter(vector_index, vector_with_ids, parameter, region_range,
+                                                              document_filter, vector_with_distance_results);
+    if (!status.ok()) {
+      DINGO_LOG(ERROR) << fmt::format("DoVectorSearchForDocumentPreFilter failed : {}", status.error_cstr());
+      return status;
+    }
+  } else if (dingodb::pb::common::VectorFilter::SCALAR_FILTER == vector_filter &&
       dingodb::pb::common::VectorFilterType::QUERY_POST == vector_filter_type) {
     uint32_t top_n = parameter.top_n();
     bool enable_range_search = parameter.enable_range_search();
@@ -112,88 +146,36 @@ butil::Status VectorReader::SearchVector(
         DINGO_LOG(ERROR) << status.error_cstr();
         return status;
       }
-    } else if (parameter.has_vector_coprocessor()) {
-      if (BAIDU_UNLIKELY(vector_with_ids[0].scalar_data().scalar_data_size() != 0)) {
-        DINGO_LOG(WARNING) << "vector_with_ids[0].scalar_data() deprecated. use coprocessor.";
-      }
-      top_n *= 10;
-      butil::Status status = VectorReader::SearchAndRangeSearchWrapper(vector_index, region_range, vector_with_ids,
-                                                                       parameter, tmp_results, top_n, {});
-      if (!status.ok()) {
-        DINGO_LOG(ERROR) << status.error_cstr();
-        return status;
-      }
-
-      std::shared_ptr<RawCoprocessor> scalar_coprocessor =
-          std::make_shared<CoprocessorScalar>(Helper::GetKeyPrefix(region_range.start_key()));
+    } else {
+      std::shared_ptr<RawCoprocessor> scalar_coprocessor;
+      if (parameter.has_vector_coprocessor()) {
+        if (BAIDU_UNLIKELY(vector_with_ids[0].scalar_data().scalar_data_size() != 0)) {
+          DINGO_LOG(WARNING) << "vector_with_ids[0].scalar_data() deprecated. use coprocessor.";
+        }
 
-      status = scalar_coprocessor->Open(CoprocessorPbWrapper{parameter.vector_coprocessor()});
-      if (!status.ok()) {
-        DINGO_LOG(ERROR) << "scalar coprocessor::Open failed " << status.error_cstr();
-        return status;
+        scalar_coprocessor = std::make_shared<CoprocessorScalar>(Helper::GetKeyPrefix(region_range.start_key()));
+        auto status = scalar_coprocessor->Open(CoprocessorPbWrapper{parameter.vector_coprocessor()});
+        if (!status.ok()) {
+          DINGO_LOG(ERROR) << "scalar coprocessor::Open failed " << status.error_cstr();
+          return status;
+        }
       }
 
-      for (auto& vector_with_distance_result : tmp_results) {
-        pb::index::VectorWithDistanceResult new_vector_with_distance_result;
-
-        for (auto& temp_vector_with_distance : *vector_with_distance_result.mutable_vector_with_distances()) {
-          int64_t temp_id = temp_vector_with_distance.vector_with_id().id();
-          bool compare_result = false;
-          butil::Status status = CompareVectorScalarDataWithCoprocessor(region_range, partition_id, temp_id,
-                                                                        scalar_coprocessor, compare_result);
-          if (!status.ok()) {
-            return status;
-          }
-
-          if (!compare_result) {
-            continue;
-          }
-
-          new_vector_with_distance_result.add_vector_with_distances()->Swap(&temp_vector_with_distance);
-          // topk
-          if (!enable_range_search) {
-            if (new_vector_with_distance_result.vector_with_distances_size() >= parameter.top_n()) {
-              break;
-            }
-          }
+      auto compare_func = [&](int64_t vector_id, bool& compare_result) -> butil::Status {
+        if (scalar_coprocessor != nullptr) {
+          return CompareVectorScalarDataWithCoprocessor(region_range, partition_id, vector_id, scalar_coprocessor,
+                                                        compare_result);
         }
-        vector_with_distance_results.emplace_back(std::move(new_vector_with_distance_result));
-      }
+        return CompareVectorScalarData(region_range, partition_id, vector_id, vector_with_ids[0].scalar_data(),
+                                       compare_result);
+      };
 
-    } else {  //! parameter.has_vector_coprocessor() && vector_with_ids[0].scalar_data().scalar_data_size() != 0
-      top_n *= 10;
-      butil::Status status = VectorReader::SearchAndRangeSearchWrapper(vector_index, region_range, vector_with_ids,
-                                                                       parameter, tmp_results, top_n, {});
+      butil::Status status = SearchWithScalarPostFilter(vector_index, region_range, vector_with_ids, parameter,
+                                                        compare_func, vector_with_distance_results);
       if (!status.ok()) {
         DINGO_LOG(ERROR) << status.error_cstr();
         return status;
       }
-
-      for (auto& vector_with_distance_result : tmp_results) {
-        pb::index::VectorWithDistanceResult new_vector_with_distance_result;
-
-        for (auto& temp_vector_with_distance : *vector_with_distance_result.mutable_vector_with_distances()) {
-          int64_t temp_id = temp_vector_with_distance.vector_with_id().id();
-          bool compare_result = false;
-          butil::Status status = CompareVectorScalarData(region_range, partition_id, temp_id,
-                                                         vector_with_ids[0].scalar_data(), compare_result);
-          if (!status.ok()) {
-            return status;
-          }
-          if (!compare_result) {
-            continue;
-          }
-
-          new_vector_with_distance_result.add_vector_with_distances()->Swap(&temp_vector_with_distance);
-          // topk
-          if (!enable_range_search) {
-            if (new_vector_with_distance_result.vector_with_distances_size() >= parameter.top_n()) {
-              break;
-            }
-          }
-        }
-        vector_with_distance_results.emplace_back(std::move(new_vector_with_distance_result));
-      }
     }
   } else if (dingodb::pb::common::VectorFilter::VECTOR_ID_FILTER == vector_filter) {  // vector id array search
     butil::Status status = DoVectorSearchForVectorIdPreFilter(vector_index, vector_with_ids, parameter, region_range,
@@ -223,21 +205,143 @@ butil::Status VectorReader::SearchVector(
 
   // if vector index does not support restruct vector ,we restruct it using RocksDB
   if (with_vector_data) {
+    std::vector<pb::common::VectorWithId*> vector_with_ids_without_data;
     for (auto& result : vector_with_distance_results) {
       for (auto& vector_with_distance : *result.mutable_vector_with_distances()) {
         if (vector_with_distance.vector_with_id().vector().float_values_size() > 0 ||
             vector_with_distance.vector_with_id().vector().binary_values_size() > 0) {
           continue;
         }
+        vector_with_ids_without_data.push_back(vector_with_distance.mutable_vector_with_id());
+      }
+    }
 
-        pb::common::VectorWithId vector_with_id;
-        auto status = QueryVectorWithId(region_range, partition_id, vector_with_distance.vector_with_id().id(), true,
-                                        vector_with_id);
+    auto status = QueryVectorData(region_range, partition_id, vector_with_ids_without_data);
+    if (!status.ok()) {
+      return status;
+    }
+  }
+
+  return butil::Status();
+}
+
+// Search topk * multiple candidates and filter them by scalar.
+// The multiple comes from the pass rate observed by previous queries on this region, if it is still not enough, the
+// search topk is expanded and the search is retried until FLAGS_vector_post_filter_max_topk.
+butil::Status VectorReader::SearchWithScalarPostFilter(
+    VectorIndexWrapperPtr vector_index, const pb::common::Range& region_range,
+    const std::vector<pb::common::VectorWithId>& vector_with_ids, const pb::common::VectorSearchParameter& parameter,
+    const std::function<butil::Status(int64_t, bool&)>& compare_func,
+    std::vector<pb::index::VectorWithDistanceResult>& vector_with_distance_results) {
+  uint32_t top_n = parameter.top_n();
+  bool enable_range_search = parameter.enable_range_search();
+
+  uint32_t max_topk = std::max(top_n, FLAGS_vector_post_filter_max_topk);
+  float pass_rate = std::max(vector_index->PostFilterPassRate(), 1.0F / max_topk);
+  // 20% margin over the expected count
+  uint64_t expect_topk = static_cast<uint64_t>(std::ceil(top_n * 1.2F / pass_rate));
+  uint64_t min_topk = std::min(static_cast<uint64_t>(top_n) * FLAGS_vector_post_filter_min_topk_multiple,
+                               static_cast<uint64_t>(max_topk));
+  uint32_t search_topk = static_cast<uint32_t>(std::clamp(expect_topk, min_topk, static_cast<uint64_t>(max_topk)));
+
+  std::vector<pb::index::VectorWithDistanceResult> tmp_results;
+  for (;;) {
+    tmp_results.clear();
+    auto status = VectorReader::SearchAndRangeSearchWrapper(vector_index, region_range, vector_with_ids, parameter,
+                                                            tmp_results, search_topk, {});
+    if (!status.ok()) {
+      return status;
+    }
+
+    int64_t scan_count = 0;
+    int64_t pass_count = 0;
+    bool need_more = false;
+    std::vector<pb::index::VectorWithDistanceResult> filter_results;
+    filter_results.reserve(tmp_results.size());
+    for (auto& vector_with_distance_result : tmp_results) {
+      pb::index::VectorWithDistanceResult new_vector_with_distance_result;
+
+      for (auto& temp_vector_with_distance : *vector_with_distance_result.mutable_vector_with_distances()) {
+        bool compare_result = false;
+        status = compare_func(temp_vector_with_distance.vector_with_id().id(), compare_result);
         if (!status.ok()) {
           return status;
         }
-        vector_with_distance.mutable_vector_with_id()->Swap(&vector_with_id);
+
+        ++scan_count;
+        if (!compare_result) {
+          continue;
+        }
+        ++pass_count;
+
+        new_vector_with_distance_result.add_vector_with_distances()->Swap(&temp_vector_with_distance);
+        // topk
+        if (!enable_range_search) {
+          if (new_vector_with_distance_result.vector_with_distances_size() >= top_n) {
+            break;
+          }
+        }
       }
+
+      // index returned full candidates but not enough passed, there may be more
+      if (!enable_range_search && new_vector_with_distance_result.vector_with_distances_size() < top_n &&
+          vector_with_distance_result.vector_with_distances_size() >= search_topk) {
+        need_more = true;
+      }
+      filter_results.emplace_back(std::move(new_vector_with_distance_result));
+    }
+
+    if (scan_count > 0) {
+      vector_index->UpdatePostFilterPassRate(static_cast<float>(pass_count) / scan_count);
+    }
+
+    if (!need_more || search_topk >= max_topk) {
+      vector_with_distance_results.swap(filter_results);
+      break;
+    }
+
+    DINGO_LOG_IF(INFO, FLAGS_dingo_log_switch_scalar_speed_up_detail) << fmt::format(
+        "post filter not enough, expand search topk {} -> {}, pass {}/{}", search_topk,
+        std::min(static_cast<uint64_t>(search_topk) * 4, static_cast<uint64_t>(max_topk)), pass_count, scan_count);
+    search_topk = static_cast<uint32_t>(
+        std::min(static_cast<uint64_t>(search_topk) * 4, static_cast<uint64_t>(max_topk)));
+  }
+
+  return butil::Status::OK();
+}
+
+butil::Status VectorReader::MultiGetVectorValues(const std::string& cf_name, const pb::common::Range& region_range,
+                                                 int64_t partition_id,
+                                                 const std::vector<pb::common::VectorWithId*>& vector_with_ids,
+                                                 std::vector<std::string>& values, std::vector<bool>& exists) {
+  std::vector<std::string> keys(vector_with_ids.size());
+  for (size_t i = 0; i < vector_with_ids.size(); ++i) {
+    VectorCodec::EncodeVectorKey(region_range.start_key()[0], partition_id, vector_with_ids[i]->id(), keys[i]);
+  }
+
+  return reader_->KvMultiGet(cf_name, keys, values, exists);
+}
+
+butil::Status VectorReader::QueryVectorData(const pb::common::Range& region_range, int64_t partition_id,
+                                            const std::vector<pb::common::VectorWithId*>& vector_with_ids) {
+  if (vector_with_ids.empty()) {
+    return butil::Status();
+  }
+
+  std::vector<std::string> values;
+  std::vector<bool> exists;
+  auto status =
+      MultiGetVectorValues(Constant::kStoreDataCF, region_range, partition_id, vector_with_ids, values, exists);
+  if (!status.ok()) {
+    return status;
+  }
+
+  for (size_t i = 0; i < vector_with_ids.size(); ++i) {
+    if (!exists[i]) {
+      return butil::Status(pb::error::EKEY_NOT_FOUND, "Not found key");
+    }
+    if (!vector_with_ids[i]->mutable_vector()->ParseFromString(values[i])) {
+      return butil::Status(pb::error::EINTERNAL, "Parse proto from string error");
     }
   }
 
@@ -246,50 +350,105 @@ butil::Status VectorReader::SearchVector(
 
 butil::Status VectorReader::QueryVectorTableData(const pb::common::Range& region_range, int64_t partition_id,
                                                  pb::common::VectorWithId& vector_with_id) {
-  std::string key, value;
+  std::string key;
   VectorCodec::EncodeVectorKey(region_range.start_key()[0], partition_id, vector_with_id.id(), key);
 
-  auto status = reader_->KvGet(Constant::kVectorTableCF, key, value);
+  pb::common::VectorTableData vector_table;
+  bool parse_ok = false;
+  auto status = reader_->KvGetPinned(Constant::kVectorTableCF, key, [&](std::string_view value) {
+    parse_ok = vector_table.ParseFromArray(value.data(), value.size());
+  });
   if (!status.ok()) {
     return status;
   }
 
-  pb::common::VectorTableData vector_table;
-  if (!vector_table.ParseFromString(value)) {
+  if (!parse_ok) {
     return butil::Status(pb::error::EINTERNAL, "Decode vector table data failed");
   }
 
-  *(vector_with_id.mutable_table_data()) = vector_table;
+  vector_with_id.mutable_table_data()->Swap(&vector_table);
+
+  return butil::Status();
+}
+
+butil::Status VectorReader::QueryVectorTableData(const pb::common::Range& region_range, int64_t partition_id,
+                                                 const std::vector<pb::common::VectorWithId*>& vector_with_ids) {
+  if (vector_with_ids.empty()) {
+    return butil::Status();
+  }
+
+  std::vector<std::string> values;
+  std::vector<bool> exists;
+  auto status =
+      MultiGetVectorValues(Constant::kVectorTableCF, region_range, partition_id, vector_with_ids, values, exists);
+  if (!status.ok()) {
+    return status;
+  }
+
+  for (size_t i = 0; i < vector_with_ids.size(); ++i) {
+    if (!exists[i]) {
+      continue;
+    }
+    if (!vector_with_ids[i]->mutable_table_data()->ParseFromString(values[i])) {
+      return butil::Status(pb::error::EINTERNAL, "Decode vector table data failed");
+    }
+  }
 
   return butil::Status();
 }
 
 butil::Status VectorReader::QueryVectorTableData(const pb::common::Range& region_range, int64_t partition_id,
                                                  std::vector<pb::index::VectorWithDistanceResult>& results) {
-  // get metadata by parameter
+  // get metadata of all results by one multi get
+  std::vector<pb::common::VectorWithId*> vector_with_ids;
   for (auto& result : results) {
     for (auto& vector_with_distance : *result.mutable_vector_with_distances()) {
-      pb::common::VectorWithId& vector_with_id = *(vector_with_distance.mutable_vector_with_id());
-      QueryVectorTableData(region_range, partition_id, vector_with_id);
+      vector_with_ids.push_back(vector_with_distance.mutable_vector_with_id());
     }
   }
 
-  return butil::Status();
+  return QueryVectorTableData(region_range, partition_id, vector_with_ids);
 }
 
 butil::Status VectorReader::QueryVectorTableData(const pb::common::Range& region_range, int64_t partition_id,
                                                  std::vector<pb::common::VectorWithDistance>& vector_with_distances) {
-  // get metadata by parameter
+  std::vector<pb::common::VectorWithId*> vector_with_ids;
+  vector_with_ids.reserve(vector_with_distances.size());
   for (auto& vector_with_distance : vector_with_distances) {
-    pb::common::VectorWithId& vector_with_id = *(vector_with_distance.mutable_vector_with_id());
-    QueryVectorTableData(region_range, partition_id, vector_with_id);
+    vector_with_ids.push_back(vector_with_distance.mutable_vector_with_id());
+  }
+
+  return QueryVectorTableData(region_range, partition_id, vector_with_ids);
+}
+
+butil::Status VectorReader::ParseVectorScalarData(const std::vector<std::string>& selected_scalar_keys,
+                                                  const std::string& value, pb::common::VectorWithId& vector_with_id) {
+  pb::common::VectorScalardata vector_scalar;
+  if (!vector_scalar.ParseFromString(value)) {
+    return butil::Status(pb::error::EINTERNAL, "Decode vector scalar data failed");
+  }
+
+  // take the whole parsed scalar data without copying fields when all keys are selected
+  if (selected_scalar_keys.empty() && vector_with_id.scalar_data().scalar_data().empty()) {
+    vector_with_id.mutable_scalar_data()->Swap(&vector_scalar);
+    return butil::Status();
+  }
+
+  auto* scalar = vector_with_id.mutable_scalar_data()->mutable_scalar_data();
+  for (auto& [key, value] : *vector_scalar.mutable_scalar_data()) {
+    if (!selected_scalar_keys.empty() &&
+        std::find(selected_scalar_keys.begin(), selected_scalar_keys.end(), key) == selected_scalar_keys.end()) {
+      continue;
+    }
+
+    (*scalar)[key].Swap(&value);
   }
 
   return butil::Status();
 }
 
 butil::Status VectorReader::QueryVectorScalarData(const pb::common::Range& region_range, int64_t partition_id,
-                                                  std::vector<std::string> selected_scalar_keys,
+                                                  const std::vector<std::string>& selected_scalar_keys,
                                                   pb::common::VectorWithId& vector_with_id) {
   std::string key, value;
   VectorCodec::EncodeVectorKey(region_range.start_key()[0], partition_id, vector_with_id.id(), key);
@@ -299,48 +458,61 @@ butil::Status VectorReader::QueryVectorScalarData(const pb::common::Range& regio
     return status;
   }
 
-  pb::common::VectorScalardata vector_scalar;
-  if (!vector_scalar.ParseFromString(value)) {
-    return butil::Status(pb::error::EINTERNAL, "Decode vector scalar data failed");
+  return ParseVectorScalarData(selected_scalar_keys, value, vector_with_id);
+}
+
+butil::Status VectorReader::QueryVectorScalarData(const pb::common::Range& region_range, int64_t partition_id,
+                                                  const std::vector<std::string>& selected_scalar_keys,
+                                                  const std::vector<pb::common::VectorWithId*>& vector_with_ids) {
+  if (vector_with_ids.empty()) {
+    return butil::Status();
   }
 
-  auto* scalar = vector_with_id.mutable_scalar_data()->mutable_scalar_data();
-  for (const auto& [key, value] : vector_scalar.scalar_data()) {
-    if (!selected_scalar_keys.empty() &&
-        std::find(selected_scalar_keys.begin(), selected_scalar_keys.end(), key) == selected_scalar_keys.end()) {
+  std::vector<std::string> values;
+  std::vector<bool> exists;
+  auto status =
+      MultiGetVectorValues(Constant::kVectorScalarCF, region_range, partition_id, vector_with_ids, values, exists);
+  if (!status.ok()) {
+    return status;
+  }
+
+  for (size_t i = 0; i < vector_with_ids.size(); ++i) {
+    if (!exists[i]) {
       continue;
     }
-
-    scalar->insert({key, value});
+    status = ParseVectorScalarData(selected_scalar_keys, values[i], *vector_with_ids[i]);
+    if (!status.ok()) {
+      return status;
+    }
   }
 
   return butil::Status();
 }
 
 butil::Status VectorReader::QueryVectorScalarData(const pb::common::Range& region_range, int64_t partition_id,
-                                                  std::vector<std::string> selected_scalar_keys,
+                                                  const std::vector<std::string>& selected_scalar_keys,
                                                   std::vector<pb::index::VectorWithDistanceResult>& results) {
-  // get metadata by parameter
+  // get metadata of all results by one multi get
+  std::vector<pb::common::VectorWithId*> vector_with_ids;
   for (auto& result : results) {
     for (auto& vector_with_distance : *result.mutable_vector_with_distances()) {
-      pb::common::VectorWithId& vector_with_id = *(vector_with_distance.mutable_vector_with_id());
-      QueryVectorScalarData(region_range, partition_id, selected_scalar_keys, vector_with_id);
+      vector_with_ids.push_back(vector_with_distance.mutable_vector_with_id());
     }
   }
 
-  return butil::Status();
+  return QueryVectorScalarData(region_range, partition_id, selected_scalar_keys, vector_with_ids);
 }
 
 butil::Status VectorReader::QueryVectorScalarData(const pb::common::Range& region_range, int64_t partition_id,
-                                                  std::vector<std::string> selected_scalar_keys,
+                                                  const std::vector<std::string>& selected_scalar_keys,
                                                   std::vector<pb::common::VectorWithDistance>& vector_with_distances) {
-  // get metadata by parameter
+  std::vector<pb::common::VectorWithId*> vector_with_ids;
+  vector_with_ids.reserve(vector_with_distances.size());
   for (auto& vector_with_distance : vector_with_distances) {
-    pb::common::VectorWithId& vector_with_id = *(vector_with_distance.mutable_vector_with_id());
-    QueryVectorScalarData(region_range, partition_id, selected_scalar_keys, vector_with_id);
+    vector_with_ids.push_back(vector_with_distance.mutable_vector_with_id());
   }
 
-  return butil::Status();
+  return QueryVectorScalarData(region_range, partition_id, selected_scalar_keys, vector_with_ids);
 }
 
 butil::Status VectorReader::CompareVectorScalarData(const pb::common::Range& region_range, int64_t partition_id,
@@ -348,19 +520,22 @@ butil::Status VectorReader::CompareVectorScalarData(const pb::common::Range& reg
                                                     const pb::common::VectorScalardata& source_scalar_data,
                                                     bool& compare_result) {
   compare_result = false;
-  std::string key, value;
+  std::string key;
 
   VectorCodec::EncodeVectorKey(region_range.start_key()[0], partition_id, vector_id, key);
 
-  auto status = reader_->KvGet(Constant::kVectorScalarCF, key, value);
+  pb::common::VectorScalardata vector_scalar;
+  bool parse_ok = false;
+  auto status = reader_->KvGetPinned(Constant::kVectorScalarCF, key, [&](std::string_view value) {
+    parse_ok = vector_scalar.ParseFromArray(value.data(), value.size());
+  });
   if (!status.ok()) {
     DINGO_LOG(WARNING) << fmt::format("Get vector scalar data failed, vector_id: {} error: {} ", vector_id,
                                       status.error_str());
     return status;
   }
 
-  pb::common::VectorScalardata vector_scalar;
-  if (!vector_scalar.ParseFromString(value)) {
+  if (!parse_ok) {
     return butil::Status(pb::error::EINTERNAL, "Decode vector scalar data failed");
   }
 
@@ -385,19 +560,22 @@ butil::Status VectorReader::CompareVectorScalarDataWithCoprocessor(
     const pb::common::Range& region_range, int64_t partition_id, int64_t vector_id,
     const std::shared_ptr<RawCoprocessor>& scalar_coprocessor, bool& compare_result) {
   compare_result = false;
-  std::string key, value;
+  std::string key;
 
   VectorCodec::EncodeVectorKey(region_range.start_key()[0], partition_id, vector_id, key);
 
-  auto status = reader_->KvGet(Constant::kVectorScalarCF, key, value);
+  pb::common::VectorScalardata vector_scalar;
+  bool parse_ok = false;
+  auto status = reader_->KvGetPinned(Constant::kVectorScalarCF, key, [&](std::string_view value) {
+    parse_ok = vector_scalar.ParseFromArray(value.data(), value.size());
+  });
   if (!status.ok()) {
     DINGO_LOG(WARNING) << fmt::format("Get vector scalar data failed, vector_id: {} error: {} ", vector_id,
                                       status.error_str());
     return status;
   }
 
-  pb::common::VectorScalardata vector_scalar;
-  if (!vector_scalar.ParseFromString(value)) {
+  if (!parse_ok) {
     return butil::Status(pb::error::EINTERNAL, "Decode vector scalar data failed");
   }
 
@@ -420,9 +598,22 @@ butil::Status VectorReader::CompareVectorScalarDataWithCoprocessor(
 
 butil::Status VectorReader::VectorBatchSearch(std::shared_ptr<Engine::VectorReader::Context> ctx,
                                               std::vector<pb::index::VectorWithDistanceResult>& results) {  // NOLINT
+  // document ids of multi vector index have no scalar and table data
+  if (ctx->multi_vector_token_bits > 0) {
+    return MultiVectorSearch(ctx, results);
+  }
+
+  std::shared_ptr<VectorIndex::FilterFunctor> document_filter;
+  if (ctx->document_index != nullptr && !ctx->document_parameter.query_string().empty()) {
+    auto status = BuildDocumentFilter(ctx->document_index, ctx->region_range, ctx->document_parameter, document_filter);
+    if (!status.ok()) {
+      return status;
+    }
+  }
+
   // Search vectors by vectors
   auto status = SearchVector(ctx->partition_id, ctx->vector_index, ctx->region_range, ctx->vector_with_ids,
-                             ctx->parameter, ctx->scalar_schema, results);
+                             ctx->parameter, ctx->scalar_schema, results, document_filter);
   if (!status.ok()) {
     return status;
   }
@@ -825,23 +1016,86 @@ butil::Status VectorReader::DoVectorSearchForVectorIdPreFilter(  // NOLINT
   return butil::Status::OK();
 }
 
-butil::Status VectorReader::DoVectorSearchForScalarPreFilter(
-    VectorIndexWrapperPtr vector_index, pb::common::Range region_range,
-    const std::vector<pb::common::VectorWithId>& vector_with_ids, const pb::common::VectorSearchParameter& parameter,
-    const pb::common::ScalarSchema& scalar_schema,
-    std::vector<pb::index::VectorWithDistanceResult>& vector_with_distance_results) {  // NOLINT
-  // scalar pre filter search
-  butil::Status status;
-  bool use_coprocessor = parameter.has_vector_coprocessor();
+butil::Status VectorReader::BuildDocumentFilter(DocumentIndexWrapperPtr document_index,
+                                                const pb::common::Range& region_range,
+                                                const pb::common::DocumentSearchParameter& parameter,
+                                                std::shared_ptr<VectorIndex::FilterFunctor>& filter) {
+  pb::common::DocumentSearchParameter match_parameter = parameter;
+  if (match_parameter.top_n() == 0) {
+    match_parameter.set_top_n(FLAGS_vector_document_filter_max_match_count);
+  }
+  match_parameter.set_without_scalar_data(true);
 
-  if (!use_coprocessor && vector_with_ids[0].scalar_data().scalar_data_size() == 0) {
-    std::string s = fmt::format("vector_with_ids[0].scalar_data() empty not support");
-    DINGO_LOG(ERROR) << s;
-    return butil::Status(pb::error::Errno::EILLEGAL_PARAMTETERS, s);
+  std::vector<pb::common::DocumentWithScore> documents;
+  auto status = document_index->Search(region_range, match_parameter, documents);
+  if (!status.ok()) {
+    DINGO_LOG(ERROR) << fmt::format("[vector.reader] full-text pre filter search failed, query({}) error: {}",
+                                    match_parameter.query_string(), status.error_str());
+    return status;
+  }
+  if (documents.size() >= match_parameter.top_n()) {
+    DINGO_LOG(WARNING) << fmt::format("[vector.reader] full-text pre filter matches are truncated to {}, query({})",
+                                      match_parameter.top_n(), match_parameter.query_string());
   }
 
-  bool enable_speed_up = false;
-  if (use_coprocessor) {
+  auto bitmap = std::make_shared<VectorIdBitmap>();
+  for (const auto& document : documents) {
+    bitmap->Add(document.document_with_id().id());
+  }
+  filter = std::make_shared<VectorIndex::BitmapFilterFunctor>(bitmap);
+
+  return butil::Status::OK();
+}
+
+butil::Status VectorReader::DoVectorSearchForDocumentPreFilter(
+    VectorIndexWrapperPtr vector_index, const std::vector<pb::common::VectorWithId>& vector_with_ids,
+    const pb::common::VectorSearchParameter& parameter, const pb::common::Range& region_range,
+    std::shared_ptr<VectorIndex::FilterFunctor> document_filter,
+    std::vector<pb::index::VectorWithDistanceResult>& vector_with_distance_results) {
+  std::vector<std::shared_ptr<VectorIndex::FilterFunctor>> filters = {document_filter};
+
+  // the vector id filter is intersected with the match set, the scalar filters are not combined.
+  if (dingodb::pb::common::VectorFilter::VECTOR_ID_FILTER == parameter.vector_filter()) {
+    auto vector_ids = Helper::PbRepeatedToVector(parameter.vector_ids());
+    auto status =
+        VectorReader::SetVectorIndexIdsFilter(parameter.is_negation(), parameter.is_sorted(), vector_ids, filters);
+    if (!status.ok()) {
+      DINGO_LOG(ERROR) << status.error_str();
+      return status;
+    }
+  } else if (dingodb::pb::common::VectorFilter::SCALAR_FILTER != parameter.vector_filter() ||
+             dingodb::pb::common::VectorFilterType::QUERY_POST != parameter.vector_filter_type() ||
+             parameter.has_vector_coprocessor() || vector_with_ids[0].scalar_data().scalar_data_size() != 0) {
+    return butil::Status(pb::error::EILLEGAL_PARAMTETERS, "full-text pre filter not support scalar filter");
+  }
+
+  auto status = VectorReader::SearchAndRangeSearchWrapper(vector_index, region_range, vector_with_ids, parameter,
+                                                          vector_with_distance_results, parameter.top_n(), filters);
+  if (!status.ok()) {
+    DINGO_LOG(ERROR) << status.error_cstr();
+    return status;
+  }
+
+  return butil::Status::OK();
+}
+
+butil::Status VectorReader::DoVectorSearchForScalarPreFilter(
+    VectorIndexWrapperPtr vector_index, pb::common::Range region_range,
+    const std::vector<pb::common::VectorWithId>& vector_with_ids, const pb::common::VectorSearchParameter& parameter,
+    const pb::common::ScalarSchema& scalar_schema,
+    std::vector<pb::index::VectorWithDistanceResult>& vector_with_distance_results) {  // NOLINT
+  // scalar pre filter search
+  butil::Status status;
+  bool use_coprocessor = parameter.has_vector_coprocessor();
+
+  if (!use_coprocessor && vector_with_ids[0].scalar_data().scalar_data_size() == 0) {
+    std::string s = fmt::format("vector_with_ids[0].scalar_data() empty not support");
+    DINGO_LOG(ERROR) << s;
+    return butil::Status(pb::error::Errno::EILLEGAL_PARAMTETERS, s);
+  }
+
+  bool enable_speed_up = false;
+  if (use_coprocessor) {
     status = VectorIndexUtils::IsNeedToScanKeySpeedUpCF(scalar_schema, parameter.vector_coprocessor(), enable_speed_up);
     if (!status.ok()) {
       DINGO_LOG(ERROR) << status.error_cstr();
@@ -893,6 +1147,30 @@ butil::Status VectorReader::DoVectorSearchForScalarPreFilter(
                      (enable_speed_up ? "true" : "false"), (use_coprocessor ? "true" : "false"),
                      scalar_schema.ShortDebugString(), Helper::SetToString(compare_keys));
 
+  // equal compare on speed up keys, try scalar bitmap index first
+  if (enable_speed_up && !use_coprocessor && FLAGS_enable_vector_scalar_bitmap_index) {
+    auto bitmap = std::make_shared<VectorIdBitmap>();
+    status =
+        vector_index->ScalarBitmapIndex()->Search(reader_, region_range, vector_with_ids[0].scalar_data(), *bitmap);
+    if (status.ok()) {
+      DINGO_LOG_IF(INFO, FLAGS_dingo_log_switch_scalar_speed_up_detail)
+          << fmt::format("scalar bitmap index hit, vector count: {}", bitmap->Cardinality());
+
+      std::vector<std::shared_ptr<VectorIndex::FilterFunctor>> filters;
+      filters.push_back(std::make_shared<VectorIndex::BitmapFilterFunctor>(bitmap));
+      status = VectorReader::SearchAndRangeSearchWrapper(vector_index, region_range, vector_with_ids, parameter,
+                                                         vector_with_distance_results, parameter.top_n(), filters);
+      if (!status.ok()) {
+        DINGO_LOG(ERROR) << status.error_cstr();
+        return status;
+      }
+      return butil::Status::OK();
+    }
+
+    DINGO_LOG_IF(INFO, FLAGS_dingo_log_switch_scalar_speed_up_detail)
+        << fmt::format("scalar bitmap index miss, fallback to scan, reason: {}", status.error_cstr());
+  }
+
   std::vector<int64_t> vector_ids;
   vector_ids.reserve(1024);
   if (enable_speed_up) {
@@ -1594,8 +1872,18 @@ butil::Status VectorReader::SearchAndRangeSearchWrapper(
         return status;
       }
     } else {
-      status = vector_index->Search(vector_with_ids, topk, region_range, filters, with_vector_data, parameter,
-                                    vector_with_distance_results);
+      // selective pre filter, brute force over candidates is cheaper and exact
+      std::vector<int64_t> candidate_ids;
+      if (IsSelectivePreFilter(vector_index, filters, candidate_ids)) {
+        return BruteForceSearchByIds(vector_index, vector_with_ids, topk, region_range, candidate_ids, filters,
+                                     vector_with_distance_results);
+      }
+
+      // lossy index, e.g. sq8 hnsw, fetch more candidates and rerank them with raw vectors
+      uint32_t rerank_multiple = vector_index->RerankMultiple();
+      uint32_t search_topk = rerank_multiple > 1 ? topk * rerank_multiple : topk;
+      status = vector_index->Search(vector_with_ids, search_topk, region_range, filters,
+                                    with_vector_data && rerank_multiple == 0, parameter, vector_with_distance_results);
       if (status.error_code() == pb::error::Errno::EVECTOR_NOT_SUPPORT) {
         DINGO_LOG(DEBUG) << "Search vector index not support, try brute force, id: " << vector_index->Id();
         return BruteForceSearch(vector_index, vector_with_ids, topk, region_range, filters, with_vector_data, parameter,
@@ -1605,6 +1893,96 @@ butil::Status VectorReader::SearchAndRangeSearchWrapper(
                                         status.error_str());
         return status;
       }
+
+      if (rerank_multiple > 0) {
+        status = RerankSearchResults(vector_index, region_range, vector_with_ids, topk, with_vector_data,
+                                     vector_with_distance_results);
+        if (!status.ok()) {
+          DINGO_LOG(ERROR) << fmt::format("Rerank search result failed, error: {} {}", status.error_code(),
+                                          status.error_str());
+          return status;
+        }
+      }
+    }
+  }
+
+  return butil::Status::OK();
+}
+
+butil::Status VectorReader::RerankSearchResults(
+    VectorIndexWrapperPtr vector_index, const pb::common::Range& region_range,
+    const std::vector<pb::common::VectorWithId>& vector_with_ids, uint32_t topk, bool with_vector_data,
+    std::vector<pb::index::VectorWithDistanceResult>& vector_with_distance_results) {
+  auto metric_type = vector_index->GetMetricType();
+  bool is_ip = metric_type == pb::common::MetricType::METRIC_TYPE_INNER_PRODUCT ||
+               metric_type == pb::common::MetricType::METRIC_TYPE_COSINE;
+  bool is_cosine = metric_type == pb::common::MetricType::METRIC_TYPE_COSINE;
+  int64_t partition_id = VectorCodec::DecodePartitionId(region_range.start_key());
+
+  for (size_t row = 0; row < vector_with_distance_results.size() && row < vector_with_ids.size(); ++row) {
+    auto& vector_with_distances = *vector_with_distance_results[row].mutable_vector_with_distances();
+    if (vector_with_distances.empty()) {
+      continue;
+    }
+
+    std::vector<float> query(vector_with_ids[row].vector().float_values().begin(),
+                             vector_with_ids[row].vector().float_values().end());
+    if (is_cosine) {
+      VectorIndexUtils::NormalizeVectorForFaiss(query.data(), query.size());
+    }
+
+    int valid_count = 0;
+    for (int i = 0; i < vector_with_distances.size(); ++i) {
+      auto& vector_with_distance = vector_with_distances[i];
+      pb::common::VectorWithId vector_with_id;
+      auto status = QueryVectorWithId(region_range, partition_id, vector_with_distance.vector_with_id().id(), true,
+                                      vector_with_id);
+      if (status.error_code() == pb::error::EKEY_NOT_FOUND) {
+        // deleted concurrently after the index search, skip it
+        continue;
+      }
+      if (!status.ok()) {
+        return status;
+      }
+
+      auto* values = vector_with_id.mutable_vector()->mutable_float_values();
+      if (values->size() != query.size()) {
+        return butil::Status(pb::error::EVECTOR_INVALID, "vector dimension not match, %d vs %lu", values->size(),
+                             query.size());
+      }
+
+      float distance = 0.0F;
+      if (is_cosine) {
+        float inverse_norm = VectorIndexUtils::InverseNormForFaiss(values->data(), values->size());
+        distance = 1.0F - fvec_inner_product(query.data(), values->data(), query.size()) * inverse_norm;
+      } else if (is_ip) {
+        distance = 1.0F - fvec_inner_product(query.data(), values->data(), query.size());
+      } else {
+        distance = fvec_L2sqr(query.data(), values->data(), query.size());
+      }
+      vector_with_distance.set_distance(distance);
+
+      if (with_vector_data) {
+        vector_with_distance.mutable_vector_with_id()->Swap(&vector_with_id);
+      }
+      if (valid_count != i) {
+        vector_with_distances.SwapElements(valid_count, i);
+      }
+      ++valid_count;
+    }
+    if (valid_count < vector_with_distances.size()) {
+      vector_with_distances.DeleteSubrange(valid_count, vector_with_distances.size() - valid_count);
+    }
+
+    std::sort(vector_with_distances.begin(), vector_with_distances.end(),
+              [](const pb::common::VectorWithDistance& lhs, const pb::common::VectorWithDistance& rhs) {
+                if (lhs.distance() != rhs.distance()) {
+                  return lhs.distance() < rhs.distance();
+                }
+                return lhs.vector_with_id().id() < rhs.vector_with_id().id();
+              });
+    if (vector_with_distances.size() > topk) {
+      vector_with_distances.DeleteSubrange(topk, vector_with_distances.size() - topk);
     }
   }
 
@@ -1640,174 +2018,443 @@ bool operator>(const DistanceResult& result1, const DistanceResult& result2) {
   }
 }
 
-// ScanData from raw engine, build vector index and search
-butil::Status VectorReader::BruteForceSearch(VectorIndexWrapperPtr vector_index,
-                                             const std::vector<pb::common::VectorWithId>& vector_with_ids,
-                                             uint32_t topk, const pb::common::Range& region_range,
-                                             std::vector<std::shared_ptr<VectorIndex::FilterFunctor>>& filters,
-                                             bool reconstruct, const pb::common::VectorSearchParameter& parameter,
-                                             std::vector<pb::index::VectorWithDistanceResult>& results) {
-  auto metric_type = vector_index->GetMetricType();
-  auto dimension = vector_index->GetDimension();
+// Max heap of (distance, vector_id) of one query, the top is the worst kept candidate.
+// Keep ids only while scanning, protobuf is built for the final topk.
+using BruteForceTopResult = std::priority_queue<std::pair<float, int64_t>>;
+
+// Merge one batch of scanned vectors into the per query topk heaps.
+// The distance matrix of all queries against the batch is computed by the blocked nx x ny kernel, so the batch
+// stays cache resident while every query is compared against it.
+// For cosine the batch keeps the raw vectors with their inverse norms, the inner product is scaled by the cached
+// norm instead of normalizing every candidate.
+static void BruteForceSearchBatch(const float* query_values, size_t query_count, const std::vector<int64_t>& batch_ids,
+                                  const std::vector<float>& batch_values,
+                                  const std::vector<float>& batch_inverse_norms, int32_t dimension,
+                                  pb::common::MetricType metric_type, uint32_t topk, std::vector<float>& distances,
+                                  std::vector<BruteForceTopResult>& top_results) {
+  size_t batch_count = batch_ids.size();
+  if (batch_count == 0) {
+    return;
+  }
+
+  distances.resize(query_count * batch_count);
+
+  bool is_ip = metric_type == pb::common::MetricType::METRIC_TYPE_INNER_PRODUCT ||
+               metric_type == pb::common::MetricType::METRIC_TYPE_COSINE;
+  if (is_ip) {
+    fvec_inner_products_nx_ny(distances.data(), query_values, batch_values.data(), dimension, query_count,
+                              batch_count);
+  } else {
+    fvec_L2sqr_nx_ny(distances.data(), query_values, batch_values.data(), dimension, query_count, batch_count);
+  }
 
-  pb::common::RegionEpoch epoch;
-  pb::common::VectorIndexParameter index_parameter;
-  index_parameter.mutable_flat_parameter()->set_dimension(dimension);
-  index_parameter.mutable_flat_parameter()->set_metric_type(metric_type);
+  bool is_cosine = metric_type == pb::common::MetricType::METRIC_TYPE_COSINE;
+  for (size_t i = 0; i < query_count; i++) {
+    auto& top_result = top_results[i];
+    const float* row = distances.data() + i * batch_count;
+
+    for (size_t j = 0; j < batch_count; j++) {
+      // same distance convention as VectorIndexUtils::FillSearchResult
+      float similarity = is_cosine ? row[j] * batch_inverse_norms[j] : row[j];
+      float distance = is_ip ? 1.0F - similarity : similarity;
+      std::pair<float, int64_t> candidate(distance, batch_ids[j]);
+      if (top_result.size() >= topk) {
+        if (!(candidate < top_result.top())) {
+          continue;
+        }
+        top_result.pop();
+      }
+      top_result.push(candidate);
+    }
+  }
+}
 
-  IteratorOptions options;
-  options.lower_bound = region_range.start_key();
-  options.upper_bound = region_range.end_key();
-  auto iterator = reader_->NewIterator(Constant::kVectorDataCF, options);
+// Convert topk heaps to results in ascending distance.
+static void BruteForceFillResults(std::vector<BruteForceTopResult>& top_results, int32_t dimension,
+                                  pb::common::MetricType metric_type,
+                                  std::vector<pb::index::VectorWithDistanceResult>& results) {
+  results.resize(top_results.size());
+  std::vector<std::pair<float, int64_t>> sorted_results;
+  for (size_t i = 0; i < top_results.size(); i++) {
+    auto& top_result = top_results[i];
+    sorted_results.resize(top_result.size());
+    for (auto it = sorted_results.rbegin(); it != sorted_results.rend(); ++it) {
+      *it = top_result.top();
+      top_result.pop();
+    }
 
-  iterator->Seek(region_range.start_key());
-  if (!iterator->Valid()) {
-    return butil::Status();
+    auto& result = results[i];
+    result.mutable_vector_with_distances()->Reserve(sorted_results.size());
+    for (const auto& [distance, vector_id] : sorted_results) {
+      auto* vector_with_distance = result.add_vector_with_distances();
+      auto* vector_with_id = vector_with_distance->mutable_vector_with_id();
+      vector_with_id->set_id(vector_id);
+      vector_with_id->mutable_vector()->set_dimension(dimension);
+      vector_with_id->mutable_vector()->set_value_type(::dingodb::pb::common::ValueType::FLOAT);
+      vector_with_distance->set_distance(distance);
+      vector_with_distance->set_metric_type(metric_type);
+    }
   }
+}
+
+// Query planner of pre filter.
+// When the filter candidates are few in absolute count and relative to the region, filtered graph search visits
+// mostly rejected nodes and recall drops, brute force over the candidates is both faster and exact.
+bool VectorReader::IsSelectivePreFilter(VectorIndexWrapperPtr vector_index,
+                                        std::vector<std::shared_ptr<VectorIndex::FilterFunctor>>& filters,
+                                        std::vector<int64_t>& candidate_ids) {
+  std::shared_ptr<VectorIndex::FilterFunctor> candidate_filter;
+  int64_t candidate_count = -1;
+  for (const auto& filter : filters) {
+    int64_t count = filter->CandidateCount();
+    if (count >= 0 && (candidate_count < 0 || count < candidate_count)) {
+      candidate_count = count;
+      candidate_filter = filter;
+    }
+  }
+  if (candidate_filter == nullptr || candidate_count > FLAGS_vector_filter_bruteforce_max_candidate_count) {
+    return false;
+  }
+
+  int64_t region_count = 0;
+  auto status = vector_index->GetCount(region_count);
+  if (!status.ok() || region_count <= 0) {
+    return false;
+  }
+  if (candidate_count > region_count * FLAGS_vector_filter_bruteforce_max_selectivity) {
+    return false;
+  }
+
+  candidate_filter->GetCandidateIds(candidate_ids);
+  DINGO_LOG_IF(INFO, FLAGS_dingo_log_switch_scalar_speed_up_detail) << fmt::format(
+      "[vector_index.planner][id({})] pre filter candidate({}) region count({}), use brute force",
+      vector_index->Id(), candidate_count, region_count);
+
+  return true;
+}
+
+// Read vectors of candidates by point get and search by brute force.
+butil::Status VectorReader::BruteForceSearchByIds(VectorIndexWrapperPtr vector_index,
+                                                  const std::vector<pb::common::VectorWithId>& vector_with_ids,
+                                                  uint32_t topk, const pb::common::Range& region_range,
+                                                  const std::vector<int64_t>& candidate_ids,
+                                                  std::vector<std::shared_ptr<VectorIndex::FilterFunctor>>& filters,
+                                                  std::vector<pb::index::VectorWithDistanceResult>& results) {
+  auto metric_type = vector_index->GetMetricType();
+  auto dimension = vector_index->GetDimension();
+
+  if (vector_with_ids.empty()) {
+    return butil::Status(pb::error::EILLEGAL_PARAMTETERS, "vector_with_ids is empty");
+  }
+  if (topk == 0) {
+    return butil::Status::OK();
+  }
+  auto status = VectorIndexUtils::CheckVectorDimension(vector_with_ids, dimension);
+  if (!status.ok()) {
+    return status;
+  }
+
+  bool normalize = metric_type == pb::common::MetricType::METRIC_TYPE_COSINE;
+  const auto& query_values = VectorIndexUtils::ExtractVectorValue(vector_with_ids, dimension, normalize);
 
   BvarLatencyGuard bvar_guard(&g_bruteforce_search_latency);
 
-  // topk results
-  std::vector<std::priority_queue<DistanceResult>> top_results;
+  std::vector<BruteForceTopResult> top_results;
   top_results.resize(vector_with_ids.size());
 
-  int64_t count = 0;
-  std::vector<pb::common::VectorWithId> vector_with_id_batch;
-  std::vector<pb::index::VectorWithDistanceResult> results_batch;
+  int64_t partition_id = VectorCodec::DecodePartitionId(region_range.start_key());
+  int64_t batch_size = std::max(static_cast<int64_t>(1), FLAGS_vector_index_bruteforce_batch_count);
+  std::vector<int64_t> batch_ids;
+  batch_ids.reserve(batch_size);
+  std::vector<float> batch_values;
+  batch_values.reserve(batch_size * dimension);
+  std::vector<float> batch_inverse_norms;
+  std::vector<float> distances;
+
+  int64_t min_vector_id = 0, max_vector_id = 0;
+  VectorCodec::DecodeRangeToVectorId(region_range, min_vector_id, max_vector_id);
+
+  for (auto vector_id : candidate_ids) {
+    // candidates from client may be out of region
+    if (vector_id < min_vector_id || vector_id >= max_vector_id) {
+      continue;
+    }
 
-  // scan data from raw engine
-  while (iterator->Valid()) {
-    std::string key(iterator->Key());
-    auto vector_id = VectorCodec::DecodeVectorId(key);
-    if (vector_id == 0 || vector_id == INT64_MAX || vector_id < 0) {
-      iterator->Next();
+    bool is_member = true;
+    for (const auto& filter : filters) {
+      if (!filter->Check(vector_id)) {
+        is_member = false;
+        break;
+      }
+    }
+    if (!is_member) {
       continue;
     }
 
-    auto value = iterator->Value();
+    pb::common::VectorWithId vector_with_id;
+    status = QueryVectorWithId(region_range, partition_id, vector_id, true, vector_with_id);
+    if (status.error_code() == pb::error::EKEY_NOT_FOUND) {
+      continue;
+    } else if (!status.ok()) {
+      return status;
+    }
 
-    pb::common::Vector vector;
-    if (!vector.ParseFromArray(value.data(), value.size())) {
-      return butil::Status(pb::error::EINTERNAL, "Parse proto from string error");
+    const auto& vector = vector_with_id.vector();
+    if (vector.float_values_size() != dimension) {
+      return butil::Status(pb::error::Errno::EVECTOR_INVALID,
+                           fmt::format("vector dimension not match, {} {}", vector.float_values_size(), dimension));
     }
-    pb::common::VectorWithId vector_with_id;
-    vector_with_id.mutable_vector()->Swap(&vector);
-    vector_with_id.set_id(vector_id);
 
-    vector_with_id_batch.push_back(vector_with_id);
+    batch_ids.push_back(vector_id);
+    size_t offset = batch_values.size();
+    batch_values.insert(batch_values.end(), vector.float_values().begin(), vector.float_values().end());
+    if (normalize) {
+      batch_inverse_norms.push_back(VectorIndexUtils::InverseNormForFaiss(batch_values.data() + offset, dimension));
+    }
 
-    if (vector_with_id_batch.size() == FLAGS_vector_index_bruteforce_batch_count) {
-      auto thread_pool = Server::GetInstance().GetVectorIndexThreadPool();
-      auto flat_index = VectorIndexFactory::NewFlat(INT64_MAX, index_parameter, epoch, region_range, thread_pool);
-      if (flat_index == nullptr) {
-        DINGO_LOG(FATAL) << "flat_index is nullptr";
-      }
+    if (batch_ids.size() == batch_size) {
+      BruteForceSearchBatch(query_values.get(), vector_with_ids.size(), batch_ids, batch_values, batch_inverse_norms,
+                            dimension, metric_type, topk, distances, top_results);
+      batch_ids.clear();
+      batch_values.clear();
+      batch_inverse_norms.clear();
+    }
+  }
 
-      auto ret = flat_index->AddByParallel(vector_with_id_batch);
-      if (!ret.ok()) {
-        DINGO_LOG(ERROR) << fmt::format("Add vector to flat index failed, error: {} {}", ret.error_code(),
-                                        ret.error_str());
-        return ret;
-      }
+  BruteForceSearchBatch(query_values.get(), vector_with_ids.size(), batch_ids, batch_values, batch_inverse_norms,
+                        dimension, metric_type, topk, distances, top_results);
 
-      ret = flat_index->SearchByParallel(vector_with_ids, topk, filters, reconstruct, parameter, results_batch);
-      if (!ret.ok()) {
-        DINGO_LOG(ERROR) << fmt::format("Search vector index failed, error: {} {}", ret.error_code(), ret.error_str());
-        return ret;
-      }
+  BruteForceFillResults(top_results, dimension, metric_type, results);
 
-      CHECK(results_batch.size() == vector_with_ids.size());
+  return butil::Status::OK();
+}
 
-      for (int i = 0; i < results_batch.size(); i++) {
-        auto& result = results_batch[i];
-        auto& top_result = top_results[i];
+// Append float_values of the serialized pb::common::Vector to values without building the message.
+// Both packed and unpacked encoding are accepted, the other fields are skipped. Return the float count, -1 if broken.
+static int64_t DecodeVectorFloatValues(std::string_view value, std::vector<float>& values) {
+  using google::protobuf::internal::WireFormatLite;
 
-        for (const auto& vector_with_distance : result.vector_with_distances()) {
-          auto& top_result = top_results[i];
-          if (top_result.size() < topk) {
-            top_result.emplace(vector_with_distance.distance(), vector_with_distance);
-          } else {
-            if (top_result.top().distance > vector_with_distance.distance()) {
-              top_result.pop();
-              top_result.emplace(vector_with_distance.distance(), vector_with_distance);
-            }
-          }
-        }
+  google::protobuf::io::CodedInputStream input(reinterpret_cast<const uint8_t*>(value.data()), value.size());
+  int64_t count = 0;
+  for (uint32_t tag = input.ReadTag(); tag != 0; tag = input.ReadTag()) {
+    if (WireFormatLite::GetTagFieldNumber(tag) != pb::common::Vector::kFloatValuesFieldNumber) {
+      if (!WireFormatLite::SkipField(&input, tag)) {
+        return -1;
       }
-
-      results_batch.clear();
-      vector_with_id_batch.clear();
+      continue;
     }
 
-    iterator->Next();
+    // little endian as the wire format, read into the buffer directly
+    auto wire_type = WireFormatLite::GetTagWireType(tag);
+    if (wire_type == WireFormatLite::WIRETYPE_LENGTH_DELIMITED) {
+      uint32_t size = 0;
+      if (!input.ReadVarint32(&size) || size % sizeof(float) != 0) {
+        return -1;
+      }
+      size_t offset = values.size();
+      values.resize(offset + size / sizeof(float));
+      if (!input.ReadRaw(values.data() + offset, size)) {
+        return -1;
+      }
+      count += size / sizeof(float);
+    } else if (wire_type == WireFormatLite::WIRETYPE_FIXED32) {
+      uint32_t bits = 0;
+      if (!input.ReadLittleEndian32(&bits)) {
+        return -1;
+      }
+      values.push_back(WireFormatLite::DecodeFloat(bits));
+      ++count;
+    } else {
+      return -1;
+    }
   }
 
-  if (!vector_with_id_batch.empty()) {
-    auto thread_pool = Server::GetInstance().GetVectorIndexThreadPool();
-    auto flat_index = VectorIndexFactory::NewFlat(INT64_MAX, index_parameter, epoch, region_range, thread_pool);
-    if (flat_index == nullptr) {
-      DINGO_LOG(FATAL) << "flat_index is nullptr";
+  return input.ConsumedEntireMessage() ? count : -1;
+}
+
+// Scan [start_key, end_key) of vector data, the filters are checked before decoding, the vector bytes are decoded
+// into the contiguous batch buffer and compared by batch.
+static butil::Status BruteForceScanRange(RawEngine::ReaderPtr reader, const std::string& start_key,
+                                         const std::string& end_key,
+                                         const std::vector<std::shared_ptr<VectorIndex::FilterFunctor>>& filters,
+                                         const float* query_values, size_t query_count, int32_t dimension,
+                                         pb::common::MetricType metric_type, uint32_t topk,
+                                         std::vector<BruteForceTopResult>& top_results) {
+  IteratorOptions options;
+  options.lower_bound = start_key;
+  options.upper_bound = end_key;
+  auto iterator = reader->NewIterator(Constant::kVectorDataCF, options);
+
+  bool normalize = metric_type == pb::common::MetricType::METRIC_TYPE_COSINE;
+  int64_t batch_size = std::max(static_cast<int64_t>(1), FLAGS_vector_index_bruteforce_batch_count);
+  std::vector<int64_t> batch_ids;
+  batch_ids.reserve(batch_size);
+  std::vector<float> batch_values;
+  batch_values.reserve(batch_size * dimension);
+  std::vector<float> batch_inverse_norms;
+  std::vector<float> distances;
+
+  for (iterator->Seek(start_key); iterator->Valid(); iterator->Next()) {
+    std::string key(iterator->Key());
+    auto vector_id = VectorCodec::DecodeVectorId(key);
+    if (vector_id == 0 || vector_id == INT64_MAX || vector_id < 0) {
+      continue;
     }
 
-    auto ret = flat_index->AddByParallel(vector_with_id_batch);
-    if (!ret.ok()) {
-      DINGO_LOG(ERROR) << fmt::format("Add vector to flat index failed, error: {} {}", ret.error_code(),
-                                      ret.error_str());
-      return ret;
+    bool is_member = true;
+    for (const auto& filter : filters) {
+      if (!filter->Check(vector_id)) {
+        is_member = false;
+        break;
+      }
+    }
+    if (!is_member) {
+      continue;
     }
 
-    ret = flat_index->SearchByParallel(vector_with_ids, topk, filters, reconstruct, parameter, results_batch);
-    if (!ret.ok()) {
-      DINGO_LOG(ERROR) << fmt::format("Search vector index failed, error: {} {}", ret.error_code(), ret.error_str());
-      return ret;
+    size_t offset = batch_values.size();
+    int64_t count = DecodeVectorFloatValues(iterator->Value(), batch_values);
+    if (count < 0) {
+      return butil::Status(pb::error::EINTERNAL, "Parse proto from string error");
+    }
+    if (count != dimension) {
+      return butil::Status(pb::error::Errno::EVECTOR_INVALID,
+                           fmt::format("vector dimension not match, {} {}", count, dimension));
     }
 
-    CHECK(results_batch.size() == vector_with_ids.size());
+    batch_ids.push_back(vector_id);
+    if (normalize) {
+      batch_inverse_norms.push_back(VectorIndexUtils::InverseNormForFaiss(batch_values.data() + offset, dimension));
+    }
 
-    for (int i = 0; i < results_batch.size(); i++) {
-      auto& result = results_batch[i];
-      auto& top_result = top_results[i];
+    if (batch_ids.size() == batch_size) {
+      BruteForceSearchBatch(query_values, query_count, batch_ids, batch_values, batch_inverse_norms, dimension,
+                            metric_type, topk, distances, top_results);
+      batch_ids.clear();
+      batch_values.clear();
+      batch_inverse_norms.clear();
+    }
+  }
 
-      for (const auto& vector_with_distance : result.vector_with_distances()) {
-        auto& top_result = top_results[i];
-        if (top_result.size() < topk) {
-          top_result.emplace(vector_with_distance.distance(), vector_with_distance);
-        } else {
-          if (top_result.top().distance > vector_with_distance.distance()) {
-            top_result.pop();
-            top_result.emplace(vector_with_distance.distance(), vector_with_distance);
-          }
-        }
-      }
+  BruteForceSearchBatch(query_values, query_count, batch_ids, batch_values, batch_inverse_norms, dimension,
+                        metric_type, topk, distances, top_results);
+
+  return butil::Status::OK();
+}
+
+// Split the region by vector id into parallel_num parts, the region start/end key are kept at both ends.
+static std::vector<std::string> SplitRegionByVectorId(const pb::common::Range& region_range, int parallel_num) {
+  std::vector<std::string> keys;
+  keys.push_back(region_range.start_key());
+
+  int64_t min_vector_id = 0, max_vector_id = 0;
+  VectorCodec::DecodeRangeToVectorId(region_range, min_vector_id, max_vector_id);
+  if (max_vector_id > min_vector_id) {
+    char prefix = region_range.start_key()[0];
+    int64_t partition_id = VectorCodec::DecodePartitionId(region_range.start_key());
+    uint64_t step = (static_cast<uint64_t>(max_vector_id) - min_vector_id) / parallel_num;
+    for (int i = 1; i < parallel_num && step > 0; ++i) {
+      std::string key;
+      VectorCodec::EncodeVectorKey(prefix, partition_id, min_vector_id + static_cast<int64_t>(step * i), key);
+      keys.push_back(key);
     }
+  }
+
+  keys.push_back(region_range.end_key());
+  return keys;
+}
+
+// ScanData from raw engine, compute distance by batch and search
+butil::Status VectorReader::BruteForceSearch(VectorIndexWrapperPtr vector_index,
+                                             const std::vector<pb::common::VectorWithId>& vector_with_ids,
+                                             uint32_t topk, const pb::common::Range& region_range,
+                                             std::vector<std::shared_ptr<VectorIndex::FilterFunctor>>& filters,
+                                             bool /*reconstruct*/, const pb::common::VectorSearchParameter& /*parameter*/,
+                                             std::vector<pb::index::VectorWithDistanceResult>& results) {
+  auto metric_type = vector_index->GetMetricType();
+  auto dimension = vector_index->GetDimension();
 
-    results_batch.clear();
-    vector_with_id_batch.clear();
+  if (vector_with_ids.empty()) {
+    return butil::Status(pb::error::EILLEGAL_PARAMTETERS, "vector_with_ids is empty");
+  }
+  if (topk == 0) {
+    return butil::Status::OK();
+  }
+  auto status = VectorIndexUtils::CheckVectorDimension(vector_with_ids, dimension);
+  if (!status.ok()) {
+    return status;
   }
 
-  // copy top_results to results
-  // we don't do sorting by distance here
-  // the client will do sorting by distance
-  results.resize(top_results.size());
+  bool normalize = metric_type == pb::common::MetricType::METRIC_TYPE_COSINE;
+  const auto& query_values = VectorIndexUtils::ExtractVectorValue(vector_with_ids, dimension, normalize);
 
-  for (int i = 0; i < top_results.size(); i++) {
-    auto& top_result = top_results[i];
-    auto& result = results[i];
+  BvarLatencyGuard bvar_guard(&g_bruteforce_search_latency);
 
-    std::deque<pb::common::VectorWithDistance> vector_with_distances_deque;
+  // topk results
+  std::vector<BruteForceTopResult> top_results;
+  top_results.resize(vector_with_ids.size());
 
-    while (!top_result.empty()) {
-      auto top = top_result.top();
-      vector_with_distances_deque.emplace_front(top.vector_with_distance);
-      top_result.pop();
+  auto thread_pool = Server::GetInstance().GetVectorIndexThreadPool();
+  if (FLAGS_vector_index_bruteforce_parallel_num <= 1 || thread_pool == nullptr) {
+    status = BruteForceScanRange(reader_, region_range.start_key(), region_range.end_key(), filters,
+                                 query_values.get(), vector_with_ids.size(), dimension, metric_type, topk, top_results);
+    if (!status.ok()) {
+      return status;
     }
 
-    while (!vector_with_distances_deque.empty()) {
-      auto& vector_with_distance = *result.add_vector_with_distances();
-      vector_with_distance.Swap(&vector_with_distances_deque.front());
-      vector_with_distances_deque.pop_front();
+    BruteForceFillResults(top_results, dimension, metric_type, results);
+    return butil::Status::OK();
+  }
+
+  // every part has its own topk heaps, merged after all parts done.
+  auto keys = SplitRegionByVectorId(region_range, FLAGS_vector_index_bruteforce_parallel_num);
+  size_t part_num = keys.size() - 1;
+  std::vector<std::vector<BruteForceTopResult>> part_top_results(part_num);
+  std::vector<butil::Status> part_statuses(part_num);
+  auto scan_part = [&](size_t part) {
+    part_top_results[part].resize(vector_with_ids.size());
+    part_statuses[part] = BruteForceScanRange(reader_, keys[part], keys[part + 1], filters, query_values.get(),
+                                              vector_with_ids.size(), dimension, metric_type, topk,
+                                              part_top_results[part]);
+  };
+
+  std::vector<ThreadPool::TaskPtr> tasks;
+  for (size_t part = 1; part < part_num; ++part) {
+    auto task = thread_pool->ExecuteTask([&, part](void*) { scan_part(part); }, nullptr);
+    if (task != nullptr) {
+      tasks.push_back(task);
+    } else {
+      scan_part(part);
     }
   }
+  // the caller scan the first part
+  scan_part(0);
+  for (auto& task : tasks) {
+    task->Join();
+  }
+
+  for (size_t part = 0; part < part_num; ++part) {
+    if (!part_statuses[part].ok()) {
+      return part_statuses[part];
+    }
+
+    for (size_t i = 0; i < top_results.size(); ++i) {
+      auto& part_top_result = part_top_results[part][i];
+      auto& top_result = top_results[i];
+      for (; !part_top_result.empty(); part_top_result.pop()) {
+        const auto& candidate = part_top_result.top();
+        if (top_result.size() >= topk) {
+          if (!(candidate < top_result.top())) {
+            continue;
+          }
+          top_result.pop();
+        }
+        top_result.push(candidate);
+      }
+    }
+  }
+
+  BruteForceFillResults(top_results, dimension, metric_type, results);
 
   return butil::Status::OK();
 }
@@ -1816,159 +2463,175 @@ butil::Status VectorReader::BruteForceRangeSearch(VectorIndexWrapperPtr vector_i
                                                   const std::vector<pb::common::VectorWithId>& vector_with_ids,
                                                   float radius, const pb::common::Range& region_range,
                                                   std::vector<std::shared_ptr<VectorIndex::FilterFunctor>> filters,
-                                                  bool reconstruct, const pb::common::VectorSearchParameter& parameter,
+                                                  bool /*reconstruct*/,
+                                                  const pb::common::VectorSearchParameter& /*parameter*/,
                                                   std::vector<pb::index::VectorWithDistanceResult>& results) {
-  auto metric_type = vector_index->GetMetricType();
-  auto dimension = vector_index->GetDimension();
+  BvarLatencyGuard bvar_guard(&g_bruteforce_range_search_latency);
+
+  auto cursor = VectorRangeSearchCursor::New(reader_, region_range, vector_index->GetDimension(),
+                                             vector_index->GetMetricType(), radius);
+  auto status = cursor->Open(vector_with_ids, filters);
+  if (!status.ok()) {
+    return status;
+  }
 
-  pb::common::RegionEpoch epoch;
-  pb::common::VectorIndexParameter index_parameter;
-  index_parameter.mutable_flat_parameter()->set_dimension(dimension);
-  index_parameter.mutable_flat_parameter()->set_metric_type(metric_type);
+  // pull page by page, a query stops taking results at the limit, stop scan when all queries are full.
+  // we don't do sorting by distance here, the client will do sorting by distance.
+  results.clear();
+  results.resize(vector_with_ids.size());
+  size_t full_count = 0;
+  bool has_more = true;
+  std::vector<pb::index::VectorWithDistanceResult> page_results;
+  while (has_more && full_count < results.size()) {
+    status = cursor->Next(FLAGS_vector_range_search_page_size, page_results, has_more);
+    if (!status.ok()) {
+      return status;
+    }
 
-  IteratorOptions options;
-  options.lower_bound = region_range.start_key();
-  options.upper_bound = region_range.end_key();
-  auto iterator = reader_->NewIterator(Constant::kVectorDataCF, options);
+    for (size_t i = 0; i < page_results.size(); ++i) {
+      auto* vector_with_distances = results[i].mutable_vector_with_distances();
+      auto& page_vector_with_distances = *page_results[i].mutable_vector_with_distances();
+      if (vector_with_distances->size() >= FLAGS_vector_index_max_range_search_result_count ||
+          page_vector_with_distances.empty()) {
+        continue;
+      }
 
-  iterator->Seek(region_range.start_key());
-  if (!iterator->Valid()) {
-    return butil::Status();
+      for (auto& vector_with_distance : page_vector_with_distances) {
+        if (vector_with_distances->size() >= FLAGS_vector_index_max_range_search_result_count) {
+          DINGO_LOG(WARNING) << fmt::format("RangeSearch result count exceed limit, limit: {}, query: {}",
+                                            FLAGS_vector_index_max_range_search_result_count, i);
+          break;
+        }
+        vector_with_distances->Add()->Swap(&vector_with_distance);
+      }
+      if (vector_with_distances->size() >= FLAGS_vector_index_max_range_search_result_count) {
+        ++full_count;
+      }
+    }
   }
 
-  BvarLatencyGuard bvar_guard(&g_bruteforce_range_search_latency);
+  DINGO_LOG(DEBUG) << fmt::format("[vector_index.range_search][id({})] brute force scanned({}) has_more({})",
+                                  vector_index->Id(), cursor->ScannedCount(), has_more);
 
-  // range search results
-  std::vector<std::vector<std::pair<float, pb::common::VectorWithDistance>>> range_rsults;
-  range_rsults.resize(vector_with_ids.size());
+  return butil::Status::OK();
+}
 
-  int64_t count = 0;
-  std::vector<pb::common::VectorWithId> vector_with_id_batch;
-  std::vector<pb::index::VectorWithDistanceResult> results_batch;
+// Read all token vectors of a document, the tokens out of region are skipped.
+butil::Status VectorReader::ScanMultiVectorTokens(const pb::common::Range& region_range, int64_t partition_id,
+                                                  int64_t document_id, int32_t token_bits, int32_t dimension,
+                                                  bool normalize, std::vector<float>& token_values) {
+  token_values.clear();
 
-  // scan data from raw engine
-  while (iterator->Valid()) {
-    std::string key(iterator->Key());
-    auto vector_id = VectorCodec::DecodeVectorId(key);
-    if (vector_id == 0 || vector_id == INT64_MAX || vector_id < 0) {
-      iterator->Next();
-      continue;
-    }
+  std::string begin_key, end_key;
+  VectorCodec::EncodeVectorKey(region_range.start_key()[0], partition_id,
+                               MultiVector::BeginVectorId(document_id, token_bits), begin_key);
+  VectorCodec::EncodeVectorKey(region_range.start_key()[0], partition_id,
+                               MultiVector::EndVectorId(document_id, token_bits), end_key);
 
-    auto value = iterator->Value();
+  IteratorOptions options;
+  options.lower_bound = std::max(begin_key, region_range.start_key());
+  options.upper_bound = std::min(end_key, region_range.end_key());
+  if (options.lower_bound >= options.upper_bound) {
+    return butil::Status::OK();
+  }
 
+  auto iterator = reader_->NewIterator(Constant::kVectorDataCF, options);
+  for (iterator->Seek(options.lower_bound); iterator->Valid(); iterator->Next()) {
+    auto value = iterator->Value();
     pb::common::Vector vector;
     if (!vector.ParseFromArray(value.data(), value.size())) {
       return butil::Status(pb::error::EINTERNAL, "Parse proto from string error");
     }
-    pb::common::VectorWithId vector_with_id;
-    vector_with_id.mutable_vector()->Swap(&vector);
-    vector_with_id.set_id(vector_id);
-
-    vector_with_id_batch.push_back(vector_with_id);
-
-    if (vector_with_id_batch.size() == FLAGS_vector_index_bruteforce_batch_count) {
-      auto thread_pool = Server::GetInstance().GetVectorIndexThreadPool();
-      auto flat_index = VectorIndexFactory::NewFlat(INT64_MAX, index_parameter, epoch, region_range, thread_pool);
-      if (flat_index == nullptr) {
-        DINGO_LOG(FATAL) << "flat_index is nullptr";
-      }
+    if (vector.float_values_size() != dimension) {
+      return butil::Status(pb::error::Errno::EVECTOR_INVALID,
+                           fmt::format("vector dimension not match, {} {}", vector.float_values_size(), dimension));
+    }
 
-      auto ret = flat_index->AddByParallel(vector_with_id_batch);
-      if (!ret.ok()) {
-        DINGO_LOG(ERROR) << fmt::format("Add vector to flat index failed, error: {} {}", ret.error_code(),
-                                        ret.error_str());
-        return ret;
-      }
+    size_t offset = token_values.size();
+    token_values.insert(token_values.end(), vector.float_values().begin(), vector.float_values().end());
+    if (normalize) {
+      VectorIndexUtils::NormalizeVectorForFaiss(token_values.data() + offset, dimension);
+    }
+  }
 
-      ret = flat_index->RangeSearchByParallel(vector_with_ids, radius, filters, reconstruct, parameter, results_batch);
-      if (!ret.ok()) {
-        DINGO_LOG(ERROR) << fmt::format("RangeSearch vector index failed, error: {} {}", ret.error_code(),
-                                        ret.error_str());
-        return ret;
-      }
+  return butil::Status::OK();
+}
 
-      CHECK(results_batch.size() == vector_with_ids.size());
+// Late interaction search of multi vector index.
+// Every query token searches candidate tokens from the vector index, the candidates are grouped by document, then
+// every candidate document is scored by MaxSim over all its tokens, the request gets one topk of document ids.
+butil::Status VectorReader::MultiVectorSearch(std::shared_ptr<Engine::VectorReader::Context> ctx,
+                                              std::vector<pb::index::VectorWithDistanceResult>& results) {
+  auto vector_index = ctx->vector_index;
+  int32_t token_bits = ctx->multi_vector_token_bits;
+  uint32_t topk = ctx->parameter.top_n();
+  auto metric_type = vector_index->GetMetricType();
+  auto dimension = vector_index->GetDimension();
 
-      for (int i = 0; i < results_batch.size(); i++) {
-        auto& result = results_batch[i];
-        auto& top_result = range_rsults[i];
+  if (ctx->vector_with_ids.empty()) {
+    return butil::Status(pb::error::EILLEGAL_PARAMTETERS, "vector_with_ids is empty");
+  }
+  auto status = VectorIndexUtils::CheckVectorDimension(ctx->vector_with_ids, dimension);
+  if (!status.ok()) {
+    return status;
+  }
 
-        for (const auto& vector_with_distance : result.vector_with_distances()) {
-          auto& top_result = range_rsults[i];
-          if (top_result.size() < FLAGS_vector_index_max_range_search_result_count) {
-            top_result.emplace_back(vector_with_distance.distance(), vector_with_distance);
-          } else {
-            DINGO_LOG(WARNING) << fmt::format("RangeSearch result count exceed limit, limit: {}, actual: {}",
-                                              FLAGS_vector_index_max_range_search_result_count, top_result.size() + 1);
-            break;
-          }
-        }
-      }
+  // candidate documents
+  pb::common::VectorSearchParameter candidate_parameter = ctx->parameter;
+  candidate_parameter.set_top_n(std::min(topk * std::max(FLAGS_vector_multi_vector_candidate_multiple, 1U),
+                                         std::max(FLAGS_vector_post_filter_max_topk, topk)));
+  candidate_parameter.set_without_vector_data(true);
+  std::vector<pb::index::VectorWithDistanceResult> candidate_results;
+  status = SearchVector(ctx->partition_id, vector_index, ctx->region_range, ctx->vector_with_ids, candidate_parameter,
+                        ctx->scalar_schema, candidate_results);
+  if (!status.ok()) {
+    return status;
+  }
 
-      results_batch.clear();
-      vector_with_id_batch.clear();
+  std::set<int64_t> document_ids;
+  for (const auto& candidate_result : candidate_results) {
+    for (const auto& vector_with_distance : candidate_result.vector_with_distances()) {
+      document_ids.insert(MultiVector::DocumentId(vector_with_distance.vector_with_id().id(), token_bits));
     }
-
-    iterator->Next();
   }
 
-  if (!vector_with_id_batch.empty()) {
-    auto thread_pool = Server::GetInstance().GetVectorIndexThreadPool();
-    auto flat_index = VectorIndexFactory::NewFlat(INT64_MAX, index_parameter, epoch, region_range, thread_pool);
-    if (flat_index == nullptr) {
-      DINGO_LOG(FATAL) << "flat_index is nullptr";
-    }
+  BvarLatencyGuard bvar_guard(&g_multi_vector_search_latency);
 
-    auto ret = flat_index->AddByParallel(vector_with_id_batch);
-    if (!ret.ok()) {
-      DINGO_LOG(ERROR) << fmt::format("Add vector to flat index failed, error: {} {}", ret.error_code(),
-                                      ret.error_str());
-      return ret;
-    }
+  bool normalize = metric_type == pb::common::MetricType::METRIC_TYPE_COSINE;
+  const auto& query_values = VectorIndexUtils::ExtractVectorValue(ctx->vector_with_ids, dimension, normalize);
 
-    ret = flat_index->RangeSearchByParallel(vector_with_ids, radius, filters, reconstruct, parameter, results_batch);
-    if (!ret.ok()) {
-      DINGO_LOG(ERROR) << fmt::format("RangeSearch vector index failed, error: {} {}", ret.error_code(),
-                                      ret.error_str());
-      return ret;
+  // rerank by MaxSim
+  std::vector<BruteForceTopResult> top_results(1);
+  auto& top_result = top_results[0];
+  std::vector<float> token_values;
+  std::vector<float> distances;
+  for (auto document_id : document_ids) {
+    status = ScanMultiVectorTokens(ctx->region_range, ctx->partition_id, document_id, token_bits, dimension, normalize,
+                                   token_values);
+    if (!status.ok()) {
+      return status;
+    }
+    size_t token_count = token_values.size() / dimension;
+    if (token_count == 0) {
+      continue;
     }
 
-    CHECK(results_batch.size() == vector_with_ids.size());
-
-    for (int i = 0; i < results_batch.size(); i++) {
-      auto& result = results_batch[i];
-      auto& top_result = range_rsults[i];
-
-      for (const auto& vector_with_distance : result.vector_with_distances()) {
-        auto& top_result = range_rsults[i];
-        if (top_result.size() < FLAGS_vector_index_max_range_search_result_count) {
-          top_result.emplace_back(vector_with_distance.distance(), vector_with_distance);
-        } else {
-          DINGO_LOG(WARNING) << fmt::format("RangeSearch result count exceed limit, limit: {}, actual: {}",
-                                            FLAGS_vector_index_max_range_search_result_count, top_result.size() + 1);
-          break;
-        }
+    float distance = MultiVector::MaxSimDistance(query_values.get(), ctx->vector_with_ids.size(), token_values.data(),
+                                                 token_count, dimension, metric_type, distances);
+    std::pair<float, int64_t> candidate(distance, document_id);
+    if (top_result.size() >= topk) {
+      if (!(candidate < top_result.top())) {
+        continue;
       }
+      top_result.pop();
     }
-
-    results_batch.clear();
-    vector_with_id_batch.clear();
+    top_result.push(candidate);
   }
 
-  // copy top_results to results
-  // we don't do sorting by distance here
-  // the client will do sorting by distance
-  results.resize(range_rsults.size());
-  for (int i = 0; i < range_rsults.size(); i++) {
-    auto& top_result = range_rsults[i];
-    auto& result = results[i];
+  BruteForceFillResults(top_results, dimension, metric_type, results);
 
-    for (auto& top : top_result) {
-      auto& vector_with_distance = *result.add_vector_with_distances();
-      vector_with_distance.Swap(&top.second);
-    }
-  }
+  DINGO_LOG(DEBUG) << fmt::format("[vector_index.multi_vector][id({})] query tokens({}) candidate documents({})",
+                                  vector_index->Id(), ctx->vector_with_ids.size(), document_ids.size());
 
   return butil::Status::OK();
 }
@@ -72,16 +72,36 @@ class VectorReader {
                              const std::vector<pb::common::VectorWithId>& vector_with_ids,
                              const pb::common::VectorSearchParameter& parameter,
                              const pb::common::ScalarSchema& scalar_schema,
-                             std::vector<pb::index::VectorWithDistanceResult>& vector_with_distance_results);
-
+                             std::vector<pb::index::VectorWithDistanceResult>& vector_with_distance_results,
+                             std::shared_ptr<VectorIndex::FilterFunctor> document_filter = nullptr);
+
+  // Build the filter of the documents matching the full-text query, the match set stays in the server as bitmap.
+  static butil::Status BuildDocumentFilter(DocumentIndexWrapperPtr document_index,
+                                           const pb::common::Range& region_range,
+                                           const pb::common::DocumentSearchParameter& parameter,
+                                           std::shared_ptr<VectorIndex::FilterFunctor>& filter);
+
+  // Get the values of vector ids from cf by one multi get, values[i] and exists[i] are for vector_with_ids[i].
+  butil::Status MultiGetVectorValues(const std::string& cf_name, const pb::common::Range& region_range,
+                                     int64_t partition_id, const std::vector<pb::common::VectorWithId*>& vector_with_ids,
+                                     std::vector<std::string>& values, std::vector<bool>& exists);
+  // Fill vector data of vector_with_ids which have no vector data.
+  butil::Status QueryVectorData(const pb::common::Range& region_range, int64_t partition_id,
+                                const std::vector<pb::common::VectorWithId*>& vector_with_ids);
+
+  static butil::Status ParseVectorScalarData(const std::vector<std::string>& selected_scalar_keys,
+                                             const std::string& value, pb::common::VectorWithId& vector_with_id);
   butil::Status QueryVectorScalarData(const pb::common::Range& region_range, int64_t partition_id,
-                                      std::vector<std::string> selected_scalar_keys,
+                                      const std::vector<std::string>& selected_scalar_keys,
                                       pb::common::VectorWithId& vector_with_id);
   butil::Status QueryVectorScalarData(const pb::common::Range& region_range, int64_t partition_id,
-                                      std::vector<std::string> selected_scalar_keys,
+                                      const std::vector<std::string>& selected_scalar_keys,
+                                      const std::vector<pb::common::VectorWithId*>& vector_with_ids);
+  butil::Status QueryVectorScalarData(const pb::common::Range& region_range, int64_t partition_id,
+                                      const std::vector<std::string>& selected_scalar_keys,
                                       std::vector<pb::common::VectorWithDistance>& vector_with_distances);
   butil::Status QueryVectorScalarData(const pb::common::Range& region_range, int64_t partition_id,
-                                      std::vector<std::string> selected_scalar_keys,
+                                      const std::vector<std::string>& selected_scalar_keys,
                                       std::vector<pb::index::VectorWithDistanceResult>& results);
 
   butil::Status CompareVectorScalarData(const pb::common::Range& region_range, int64_t partition_id, int64_t vector_id,
@@ -94,6 +114,8 @@ class VectorReader {
 
   butil::Status QueryVectorTableData(const pb::common::Range& region_range, int64_t partition_id,
                                      pb::common::VectorWithId& vector_with_id);
+  butil::Status QueryVectorTableData(const pb::common::Range& region_range, int64_t partition_id,
+                                     const std::vector<pb::common::VectorWithId*>& vector_with_ids);
   butil::Status QueryVectorTableData(const pb::common::Range& region_range, int64_t partition_id,
                                      std::vector<pb::common::VectorWithDistance>& vector_with_distances);
   butil::Status QueryVectorTableData(const pb::common::Range& region_range, int64_t partition_id,
@@ -107,6 +129,12 @@ class VectorReader {
       const pb::common::VectorSearchParameter& parameter, const pb::common::Range& region_range,
       std::vector<pb::index::VectorWithDistanceResult>& vector_with_distance_results);
 
+  butil::Status DoVectorSearchForDocumentPreFilter(
+      VectorIndexWrapperPtr vector_index, const std::vector<pb::common::VectorWithId>& vector_with_ids,
+      const pb::common::VectorSearchParameter& parameter, const pb::common::Range& region_range,
+      std::shared_ptr<VectorIndex::FilterFunctor> document_filter,
+      std::vector<pb::index::VectorWithDistanceResult>& vector_with_distance_results);
+
  public:
   butil::Status DoVectorSearchForScalarPreFilter(
       VectorIndexWrapperPtr vector_index, pb::common::Range region_range,
@@ -174,6 +202,22 @@ class VectorReader {
                                  const pb::common::VectorSearchParameter& parameter,
                                  std::vector<pb::index::VectorWithDistanceResult>& results);
 
+  static bool IsSelectivePreFilter(VectorIndexWrapperPtr vector_index,
+                                   std::vector<std::shared_ptr<VectorIndex::FilterFunctor>>& filters,
+                                   std::vector<int64_t>& candidate_ids);
+
+  butil::Status BruteForceSearchByIds(VectorIndexWrapperPtr vector_index,
+                                      const std::vector<pb::common::VectorWithId>& vector_with_ids, uint32_t topk,
+                                      const pb::common::Range& region_range, const std::vector<int64_t>& candidate_ids,
+                                      std::vector<std::shared_ptr<VectorIndex::FilterFunctor>>& filters,
+                                      std::vector<pb::index::VectorWithDistanceResult>& results);
+
+  butil::Status SearchWithScalarPostFilter(
+      VectorIndexWrapperPtr vector_index, const pb::common::Range& region_range,
+      const std::vector<pb::common::VectorWithId>& vector_with_ids, const pb::common::VectorSearchParameter& parameter,
+      const std::function<butil::Status(int64_t, bool&)>& compare_func,
+      std::vector<pb::index::VectorWithDistanceResult>& vector_with_distance_results);
+
   butil::Status BruteForceRangeSearch(VectorIndexWrapperPtr vector_index,
                                       const std::vector<pb::common::VectorWithId>& vector_with_ids, float radius,
                                       const pb::common::Range& region_range,
@@ -181,6 +225,18 @@ class VectorReader {
                                       bool reconstruct, const pb::common::VectorSearchParameter& parameter,
                                       std::vector<pb::index::VectorWithDistanceResult>& results);
 
+  butil::Status ScanMultiVectorTokens(const pb::common::Range& region_range, int64_t partition_id,
+                                      int64_t document_id, int32_t token_bits, int32_t dimension, bool normalize,
+                                      std::vector<float>& token_values);
+  butil::Status MultiVectorSearch(std::shared_ptr<Engine::VectorReader::Context> ctx,
+                                  std::vector<pb::index::VectorWithDistanceResult>& results);
+
+  // Recompute distances of candidates from a lossy index with raw vectors, keep the nearest topk.
+  butil::Status RerankSearchResults(VectorIndexWrapperPtr vector_index, const pb::common::Range& region_range,
+                                    const std::vector<pb::common::VectorWithId>& vector_with_ids, uint32_t topk,
+                                    bool with_vector_data,
+                                    std::vector<pb::index::VectorWithDistanceResult>& vector_with_distance_results);
+
   RawEngine::ReaderPtr reader_;
 };
 
@@ -0,0 +1,354 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "vector/vector_scalar_bitmap_index.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "bthread/mutex.h"
+#include "butil/status.h"
+#include "bvar/latency_recorder.h"
+#include "common/constant.h"
+#include "common/helper.h"
+#include "common/logging.h"
+#include "fmt/core.h"
+#include "gflags/gflags.h"
+#include "proto/common.pb.h"
+#include "proto/error.pb.h"
+#include "vector/codec.h"
+
+namespace dingodb {
+
+DEFINE_bool(enable_vector_scalar_bitmap_index, true, "enable scalar bitmap index for vector scalar pre filter");
+DEFINE_uint32(vector_scalar_bitmap_index_max_values_per_key, 1024,
+              "max distinct values of one scalar key in bitmap index, exceed it the key is not indexed");
+
+bvar::LatencyRecorder g_vector_scalar_bitmap_index_build_latency("dingo_vector_scalar_bitmap_index_build_latency");
+bvar::LatencyRecorder g_vector_scalar_bitmap_index_search_latency("dingo_vector_scalar_bitmap_index_search_latency");
+
+// Encode scalar value to bytes, equal bytes iff Helper::IsEqualVectorScalarValue.
+// Float values are not indexed, their equality is not the equality of bytes.
+static bool EncodeScalarValue(const pb::common::ScalarValue& scalar_value, std::string& output) {
+  output.clear();
+  output.append(std::to_string(static_cast<int>(scalar_value.field_type())));
+  output.push_back(':');
+
+  auto append_fixed = [&output](auto value) {
+    output.append(reinterpret_cast<const char*>(&value), sizeof(value));
+  };
+  for (const auto& field : scalar_value.fields()) {
+    switch (scalar_value.field_type()) {
+      case pb::common::ScalarFieldType::BOOL:
+        output.push_back(field.bool_data() ? '1' : '0');
+        break;
+      case pb::common::ScalarFieldType::INT8:
+      case pb::common::ScalarFieldType::INT16:
+      case pb::common::ScalarFieldType::INT32:
+        append_fixed(static_cast<int32_t>(field.int_data()));
+        break;
+      case pb::common::ScalarFieldType::INT64:
+        append_fixed(static_cast<int64_t>(field.long_data()));
+        break;
+      case pb::common::ScalarFieldType::STRING:
+        append_fixed(static_cast<uint32_t>(field.string_data().size()));
+        output.append(field.string_data());
+        break;
+      case pb::common::ScalarFieldType::BYTES:
+        append_fixed(static_cast<uint32_t>(field.bytes_data().size()));
+        output.append(field.bytes_data());
+        break;
+      default:
+        return false;
+    }
+  }
+
+  return true;
+}
+
+static bool IsSameRange(const pb::common::Range& range1, const pb::common::Range& range2) {
+  return range1.start_key() == range2.start_key() && range1.end_key() == range2.end_key();
+}
+
+VectorScalarBitmapIndex::VectorScalarBitmapIndex(int64_t id) : id_(id) { bthread_mutex_init(&build_mutex_, nullptr); }
+
+VectorScalarBitmapIndex::~VectorScalarBitmapIndex() { bthread_mutex_destroy(&build_mutex_); }
+
+void VectorScalarBitmapIndex::UpsertToIndexes(KeyIndexes& key_indexes, int64_t vector_id,
+                                              const ScalarKeyValuePairs& scalar_key_value_pairs) {
+  // upsert overwrite all scalar of the vector
+  DeleteFromIndexes(key_indexes, vector_id);
+  AddToIndexes(key_indexes, vector_id, scalar_key_value_pairs);
+}
+
+void VectorScalarBitmapIndex::AddToIndexes(KeyIndexes& key_indexes, int64_t vector_id,
+                                           const ScalarKeyValuePairs& scalar_key_value_pairs) {
+  std::string encode_value;
+  for (const auto& [key, scalar_value] : scalar_key_value_pairs) {
+    auto& key_index = key_indexes[key];
+    if (key_index.disabled) {
+      continue;
+    }
+
+    if (!EncodeScalarValue(scalar_value, encode_value)) {
+      key_index.disabled = true;
+      key_index.value_bitmaps.clear();
+      continue;
+    }
+
+    auto it = key_index.value_bitmaps.find(encode_value);
+    if (it == key_index.value_bitmaps.end()) {
+      if (key_index.value_bitmaps.size() >= FLAGS_vector_scalar_bitmap_index_max_values_per_key) {
+        key_index.disabled = true;
+        key_index.value_bitmaps.clear();
+        continue;
+      }
+      it = key_index.value_bitmaps.emplace(encode_value, VectorIdBitmap()).first;
+    }
+    it->second.Add(vector_id);
+  }
+}
+
+void VectorScalarBitmapIndex::DeleteFromIndexes(KeyIndexes& key_indexes, int64_t vector_id) {
+  for (auto& [_, key_index] : key_indexes) {
+    for (auto it = key_index.value_bitmaps.begin(); it != key_index.value_bitmaps.end();) {
+      it->second.Remove(vector_id);
+      if (it->second.Empty()) {
+        it = key_index.value_bitmaps.erase(it);
+      } else {
+        ++it;
+      }
+    }
+  }
+}
+
+void VectorScalarBitmapIndex::Upsert(int64_t vector_id, const ScalarKeyValuePairs& scalar_key_value_pairs) {
+  RWLockWriteGuard guard(&rw_lock_);
+
+  if (is_building_) {
+    pending_ops_.push_back({vector_id, false, scalar_key_value_pairs});
+  }
+  if (is_built_) {
+    UpsertToIndexes(key_indexes_, vector_id, scalar_key_value_pairs);
+  }
+}
+
+void VectorScalarBitmapIndex::Delete(const std::vector<int64_t>& vector_ids) {
+  RWLockWriteGuard guard(&rw_lock_);
+
+  for (auto vector_id : vector_ids) {
+    if (is_building_) {
+      pending_ops_.push_back({vector_id, true, {}});
+    }
+    if (is_built_) {
+      DeleteFromIndexes(key_indexes_, vector_id);
+    }
+  }
+}
+
+void VectorScalarBitmapIndex::Reset() {
+  RWLockWriteGuard guard(&rw_lock_);
+
+  is_built_ = false;
+  ++reset_version_;
+  key_indexes_.clear();
+  range_.Clear();
+}
+
+butil::Status VectorScalarBitmapIndex::Build(RawEngine::ReaderPtr reader, const pb::common::Range& region_range) {
+  BAIDU_SCOPED_LOCK(build_mutex_);
+
+  {
+    RWLockReadGuard guard(&rw_lock_);
+    if (is_built_ && IsSameRange(range_, region_range)) {
+      return butil::Status::OK();
+    }
+  }
+
+  BvarLatencyGuard bvar_guard(&g_vector_scalar_bitmap_index_build_latency);
+
+  // Record ops applied from now on, the iterator created after sees all writes before.
+  int64_t reset_version = 0;
+  {
+    RWLockWriteGuard guard(&rw_lock_);
+    is_building_ = true;
+    pending_ops_.clear();
+    reset_version = reset_version_;
+  }
+
+  auto finish_building = [this]() {
+    RWLockWriteGuard guard(&rw_lock_);
+    is_building_ = false;
+    pending_ops_.clear();
+  };
+
+  IteratorOptions options;
+  options.upper_bound = region_range.end_key();
+  auto iter = reader->NewIterator(Constant::kVectorScalarKeySpeedUpCF, options);
+  if (iter == nullptr) {
+    finish_building();
+    DINGO_LOG(ERROR) << fmt::format("[vector_index.bitmap][id({})] new iterator failed, region range {}", id_,
+                                    VectorCodec::DecodeRangeToString(region_range));
+    return butil::Status(pb::error::Errno::EINTERNAL, "New iterator failed");
+  }
+
+  KeyIndexes key_indexes;
+  int64_t last_vector_id = 0;
+  ScalarKeyValuePairs scalar_key_value_pairs;
+  int64_t vector_count = 0;
+  for (iter->Seek(region_range.start_key()); iter->Valid(); iter->Next()) {
+    std::string key(iter->Key());
+    int64_t vector_id = VectorCodec::DecodeVectorId(key);
+    if (vector_id != last_vector_id && !scalar_key_value_pairs.empty()) {
+      // scan is ordered by vector id, every vector is new
+      AddToIndexes(key_indexes, last_vector_id, scalar_key_value_pairs);
+      scalar_key_value_pairs.clear();
+      ++vector_count;
+    }
+    last_vector_id = vector_id;
+
+    std::string scalar_key = VectorCodec::DecodeScalarKey(key);
+    if (scalar_key.empty()) {
+      finish_building();
+      return butil::Status(pb::error::Errno::EINTERNAL,
+                           fmt::format("decode scalar key({}) failed", Helper::StringToHex(key)));
+    }
+
+    pb::common::ScalarValue scalar_value;
+    if (!scalar_value.ParseFromArray(iter->Value().data(), iter->Value().size())) {
+      finish_building();
+      return butil::Status(pb::error::EINTERNAL, "pb decode scalar value failed");
+    }
+    scalar_key_value_pairs.emplace_back(std::move(scalar_key), std::move(scalar_value));
+  }
+  if (!scalar_key_value_pairs.empty()) {
+    AddToIndexes(key_indexes, last_vector_id, scalar_key_value_pairs);
+    ++vector_count;
+  }
+
+  RWLockWriteGuard guard(&rw_lock_);
+  if (reset_version != reset_version_) {
+    // data replaced during scan, drop this build
+    is_building_ = false;
+    pending_ops_.clear();
+    return butil::Status(pb::error::Errno::EVECTOR_NOT_SUPPORT, "scalar bitmap index is reset while building");
+  }
+
+  for (const auto& op : pending_ops_) {
+    if (op.is_delete) {
+      DeleteFromIndexes(key_indexes, op.vector_id);
+    } else {
+      UpsertToIndexes(key_indexes, op.vector_id, op.scalar_key_value_pairs);
+    }
+  }
+
+  DINGO_LOG(INFO) << fmt::format(
+      "[vector_index.bitmap][id({})] build scalar bitmap index, range {} vector_count({}) key_count({}) "
+      "pending_op_count({})",
+      id_, VectorCodec::DecodeRangeToString(region_range), vector_count, key_indexes.size(), pending_ops_.size());
+
+  key_indexes_.swap(key_indexes);
+  range_ = region_range;
+  is_built_ = true;
+  is_building_ = false;
+  pending_ops_.clear();
+
+  return butil::Status::OK();
+}
+
+butil::Status VectorScalarBitmapIndex::Search(RawEngine::ReaderPtr reader, const pb::common::Range& region_range,
+                                              const pb::common::VectorScalardata& scalar_data,
+                                              VectorIdBitmap& result) {
+  if (scalar_data.scalar_data().empty()) {
+    return butil::Status(pb::error::Errno::EVECTOR_NOT_SUPPORT, "scalar data is empty");
+  }
+
+  bool need_build = false;
+  {
+    RWLockReadGuard guard(&rw_lock_);
+    need_build = !is_built_ || !IsSameRange(range_, region_range);
+  }
+  if (need_build) {
+    auto status = Build(reader, region_range);
+    if (!status.ok()) {
+      return status;
+    }
+  }
+
+  BvarLatencyGuard bvar_guard(&g_vector_scalar_bitmap_index_search_latency);
+  RWLockReadGuard guard(&rw_lock_);
+  if (!is_built_ || !IsSameRange(range_, region_range)) {
+    return butil::Status(pb::error::Errno::EVECTOR_NOT_SUPPORT, "scalar bitmap index is not built");
+  }
+
+  // check all keys are indexed before intersect
+  std::vector<const VectorIdBitmap*> bitmaps;
+  std::string encode_value;
+  bool is_empty = false;
+  for (const auto& [key, scalar_value] : scalar_data.scalar_data()) {
+    auto it = key_indexes_.find(key);
+    if (it != key_indexes_.end() && it->second.disabled) {
+      return butil::Status(pb::error::Errno::EVECTOR_NOT_SUPPORT, fmt::format("scalar key({}) is not indexed", key));
+    }
+    if (!EncodeScalarValue(scalar_value, encode_value)) {
+      return butil::Status(pb::error::Errno::EVECTOR_NOT_SUPPORT,
+                           fmt::format("scalar key({}) value type not support", key));
+    }
+
+    if (it == key_indexes_.end()) {
+      is_empty = true;
+      continue;
+    }
+    auto bitmap_it = it->second.value_bitmaps.find(encode_value);
+    if (bitmap_it == it->second.value_bitmaps.end()) {
+      is_empty = true;
+      continue;
+    }
+    bitmaps.push_back(&bitmap_it->second);
+  }
+
+  result = VectorIdBitmap();
+  if (is_empty || bitmaps.empty()) {
+    return butil::Status::OK();
+  }
+
+  // start from the smallest bitmap
+  std::sort(bitmaps.begin(), bitmaps.end(), [](const VectorIdBitmap* lhs, const VectorIdBitmap* rhs) {
+    return lhs->Cardinality() < rhs->Cardinality();
+  });
+  result = *bitmaps[0];
+  for (size_t i = 1; i < bitmaps.size() && !result.Empty(); ++i) {
+    result.And(*bitmaps[i]);
+  }
+
+  return butil::Status::OK();
+}
+
+int64_t VectorScalarBitmapIndex::MemorySize() {
+  RWLockReadGuard guard(&rw_lock_);
+
+  int64_t memory_size = 0;
+  for (const auto& [key, key_index] : key_indexes_) {
+    memory_size += key.size();
+    for (const auto& [value, bitmap] : key_index.value_bitmaps) {
+      memory_size += value.size() + bitmap.MemorySize();
+    }
+  }
+  return memory_size;
+}
+
+}  // namespace dingodb
@@ -0,0 +1,115 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_VECTOR_SCALAR_BITMAP_INDEX_H_
+#define DINGODB_VECTOR_SCALAR_BITMAP_INDEX_H_
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "bthread/types.h"
+#include "butil/status.h"
+#include "common/synchronization.h"
+#include "engine/raw_engine.h"
+#include "proto/common.pb.h"
+#include "vector/vector_id_bitmap.h"
+
+namespace dingodb {
+
+// Inverted index from speed up scalar key/value to vector id bitmap of one region.
+// The source of truth is the scalar key speed up column family, the bitmaps are built from it on first use and
+// then maintained incrementally by the vector add/delete apply handlers.
+// Keys whose distinct value count exceeds FLAGS_vector_scalar_bitmap_index_max_values_per_key and float typed
+// values are not indexed, queries on them fall back to scanning the column family.
+class VectorScalarBitmapIndex {
+ public:
+  using ScalarKeyValuePairs = std::vector<std::pair<std::string, pb::common::ScalarValue>>;
+
+  explicit VectorScalarBitmapIndex(int64_t id);
+  ~VectorScalarBitmapIndex();
+
+  VectorScalarBitmapIndex(const VectorScalarBitmapIndex& rhs) = delete;
+  VectorScalarBitmapIndex& operator=(const VectorScalarBitmapIndex& rhs) = delete;
+  VectorScalarBitmapIndex(VectorScalarBitmapIndex&& rhs) = delete;
+  VectorScalarBitmapIndex& operator=(VectorScalarBitmapIndex&& rhs) = delete;
+
+  static std::shared_ptr<VectorScalarBitmapIndex> New(int64_t id) {
+    return std::make_shared<VectorScalarBitmapIndex>(id);
+  }
+
+  // Called after the speed up column family is written, replace all scalar of the vector.
+  void Upsert(int64_t vector_id, const ScalarKeyValuePairs& scalar_key_value_pairs);
+  // Called after the speed up column family is deleted.
+  void Delete(const std::vector<int64_t>& vector_ids);
+
+  // Drop all bitmaps, rebuild on next search, e.g. region data is replaced by snapshot.
+  void Reset();
+
+  // Get vector ids whose scalar equal all scalar_data, build bitmaps first if need.
+  // Return EVECTOR_NOT_SUPPORT if some key is not indexed, caller should scan instead.
+  butil::Status Search(RawEngine::ReaderPtr reader, const pb::common::Range& region_range,
+                       const pb::common::VectorScalardata& scalar_data, VectorIdBitmap& result);
+
+  int64_t MemorySize();
+
+ private:
+  struct KeyIndex {
+    // too many distinct values or not indexable value type
+    bool disabled{false};
+    std::map<std::string, VectorIdBitmap> value_bitmaps;
+  };
+
+  using KeyIndexes = std::map<std::string, KeyIndex>;
+
+  struct PendingOp {
+    int64_t vector_id;
+    bool is_delete;
+    ScalarKeyValuePairs scalar_key_value_pairs;
+  };
+
+  static void UpsertToIndexes(KeyIndexes& key_indexes, int64_t vector_id,
+                              const ScalarKeyValuePairs& scalar_key_value_pairs);
+  static void AddToIndexes(KeyIndexes& key_indexes, int64_t vector_id,
+                           const ScalarKeyValuePairs& scalar_key_value_pairs);
+  static void DeleteFromIndexes(KeyIndexes& key_indexes, int64_t vector_id);
+
+  butil::Status Build(RawEngine::ReaderPtr reader, const pb::common::Range& region_range);
+
+  int64_t id_;
+
+  // serialize build
+  bthread_mutex_t build_mutex_;
+
+  // protect members below
+  RWLock rw_lock_;
+  bool is_built_{false};
+  // bump by Reset, a build started before is discarded
+  int64_t reset_version_{0};
+  // ops applied while building, replay to the new bitmaps in apply order
+  bool is_building_{false};
+  std::vector<PendingOp> pending_ops_;
+  // range of region when build
+  pb::common::Range range_;
+  KeyIndexes key_indexes_;
+};
+
+using VectorScalarBitmapIndexPtr = std::shared_ptr<VectorScalarBitmapIndex>;
+
+}  // namespace dingodb
+
+#endif  // DINGODB_VECTOR_SCALAR_BITMAP_INDEX_H_
@@ -0,0 +1,208 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "vector/vector_search_cache.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "bthread/mutex.h"
+#include "bvar/passive_status.h"
+#include "bvar/reducer.h"
+#include "bvar/window.h"
+#include "common/helper.h"
+#include "common/logging.h"
+#include "fmt/core.h"
+#include "gflags/gflags.h"
+#include "google/protobuf/io/coded_stream.h"
+#include "google/protobuf/io/zero_copy_stream_impl_lite.h"
+
+namespace dingodb {
+
+DEFINE_bool(enable_vector_search_cache, true, "enable vector search result cache");
+DEFINE_int64(vector_search_cache_capacity_bytes, 256 * 1024 * 1024, "vector search result cache capacity bytes");
+DEFINE_uint32(vector_search_cache_shard_num, 32, "vector search result cache shard num");
+DEFINE_int64(vector_search_cache_max_entry_bytes, 1 * 1024 * 1024, "vector search result bigger than it not cache");
+DEFINE_string(vector_search_cache_disabled_index_ids, "",
+              "comma separated index ids which not use vector search result cache");
+
+static bvar::Adder<int64_t> g_vector_search_cache_hit_count("dingo_vector_search_cache_hit_count");
+static bvar::Adder<int64_t> g_vector_search_cache_miss_count("dingo_vector_search_cache_miss_count");
+static bvar::Adder<int64_t> g_vector_search_cache_evict_count("dingo_vector_search_cache_evict_count");
+static bvar::Window<bvar::Adder<int64_t>> g_vector_search_cache_hit_window(&g_vector_search_cache_hit_count, 60);
+static bvar::Window<bvar::Adder<int64_t>> g_vector_search_cache_miss_window(&g_vector_search_cache_miss_count, 60);
+
+static double GetHitRatio(void*) {
+  int64_t hit = g_vector_search_cache_hit_window.get_value();
+  int64_t total = hit + g_vector_search_cache_miss_window.get_value();
+  return total > 0 ? static_cast<double>(hit) / total : 0.0;
+}
+
+// hit ratio in last 60 seconds
+static bvar::PassiveStatus<double> g_vector_search_cache_hit_ratio("dingo_vector_search_cache_hit_ratio", GetHitRatio,
+                                                                   nullptr);
+
+VectorSearchCache::VectorSearchCache(int64_t capacity_bytes, uint32_t shard_num,
+                                     const std::set<int64_t>& disabled_index_ids)
+    : shard_capacity_bytes_(capacity_bytes / std::max(shard_num, 1U)),
+      shards_(std::max(shard_num, 1U)),
+      disabled_index_ids_(disabled_index_ids) {
+  for (auto& shard : shards_) {
+    bthread_mutex_init(&shard.mutex, nullptr);
+  }
+}
+
+VectorSearchCache::~VectorSearchCache() {
+  for (auto& shard : shards_) {
+    bthread_mutex_destroy(&shard.mutex);
+  }
+}
+
+std::shared_ptr<VectorSearchCache> VectorSearchCache::New() {
+  std::vector<int64_t> ids;
+  if (!FLAGS_vector_search_cache_disabled_index_ids.empty()) {
+    Helper::SplitString(FLAGS_vector_search_cache_disabled_index_ids, ',', ids);
+  }
+
+  DINGO_LOG(INFO) << fmt::format("[vector_search_cache] capacity({}) shard_num({}) disabled_index_ids({})",
+                                 FLAGS_vector_search_cache_capacity_bytes, FLAGS_vector_search_cache_shard_num,
+                                 FLAGS_vector_search_cache_disabled_index_ids);
+
+  return std::make_shared<VectorSearchCache>(FLAGS_vector_search_cache_capacity_bytes,
+                                             FLAGS_vector_search_cache_shard_num,
+                                             std::set<int64_t>(ids.begin(), ids.end()));
+}
+
+std::string VectorSearchCache::Fingerprint(int64_t region_id, const pb::common::Range& region_range,
+                                           const std::vector<pb::common::VectorWithId>& vector_with_ids,
+                                           const pb::common::VectorSearchParameter& parameter) {
+  std::string fingerprint;
+  fingerprint.append(reinterpret_cast<const char*>(&region_id), sizeof(region_id));
+
+  // length prefix every part, keep parts boundary unambiguous.
+  // deterministic, scalar data map must serialize in the same order.
+  auto append = [&fingerprint](const google::protobuf::Message& message) {
+    std::string data;
+    {
+      google::protobuf::io::StringOutputStream stream(&data);
+      google::protobuf::io::CodedOutputStream output(&stream);
+      output.SetSerializationDeterministic(true);
+      message.SerializeToCodedStream(&output);
+    }
+    uint64_t size = data.size();
+    fingerprint.append(reinterpret_cast<const char*>(&size), sizeof(size));
+    fingerprint.append(data);
+  };
+
+  append(region_range);
+  append(parameter);
+  for (const auto& vector_with_id : vector_with_ids) {
+    append(vector_with_id);
+  }
+
+  return fingerprint;
+}
+
+bool VectorSearchCache::IsEnabled(int64_t index_id) const {
+  return FLAGS_enable_vector_search_cache && disabled_index_ids_.count(index_id) == 0;
+}
+
+void VectorSearchCache::EraseEntry(Shard& shard, std::list<Entry>::iterator it) {
+  shard.bytes -= it->bytes;
+  shard.entries.erase(it->hash);
+  shard.lru.erase(it);
+}
+
+bool VectorSearchCache::Get(const std::string& fingerprint, const Version& version,
+                            std::vector<pb::index::VectorWithDistanceResult>& results) {
+  uint64_t hash = std::hash<std::string>{}(fingerprint);
+  auto& shard = GetShard(hash);
+
+  BAIDU_SCOPED_LOCK(shard.mutex);
+
+  auto it = shard.entries.find(hash);
+  if (it == shard.entries.end() || it->second->fingerprint != fingerprint) {
+    g_vector_search_cache_miss_count << 1;
+    return false;
+  }
+
+  // region has applied new log, the entry is stale.
+  if (!(it->second->version == version)) {
+    EraseEntry(shard, it->second);
+    g_vector_search_cache_miss_count << 1;
+    return false;
+  }
+
+  shard.lru.splice(shard.lru.begin(), shard.lru, it->second);
+  results = it->second->results;
+  g_vector_search_cache_hit_count << 1;
+
+  return true;
+}
+
+void VectorSearchCache::Put(const std::string& fingerprint, const Version& version,
+                            const std::vector<pb::index::VectorWithDistanceResult>& results) {
+  int64_t bytes = sizeof(Entry) + fingerprint.size();
+  for (const auto& result : results) {
+    bytes += result.ByteSizeLong();
+  }
+  if (bytes > FLAGS_vector_search_cache_max_entry_bytes || bytes > shard_capacity_bytes_) {
+    return;
+  }
+
+  uint64_t hash = std::hash<std::string>{}(fingerprint);
+  auto& shard = GetShard(hash);
+
+  BAIDU_SCOPED_LOCK(shard.mutex);
+
+  auto it = shard.entries.find(hash);
+  if (it != shard.entries.end()) {
+    EraseEntry(shard, it->second);
+  }
+
+  while (!shard.lru.empty() && shard.bytes + bytes > shard_capacity_bytes_) {
+    EraseEntry(shard, std::prev(shard.lru.end()));
+    g_vector_search_cache_evict_count << 1;
+  }
+
+  shard.lru.push_front(Entry{hash, fingerprint, version, results, bytes});
+  shard.entries[hash] = shard.lru.begin();
+  shard.bytes += bytes;
+}
+
+int64_t VectorSearchCache::Count() {
+  int64_t count = 0;
+  for (auto& shard : shards_) {
+    BAIDU_SCOPED_LOCK(shard.mutex);
+    count += shard.lru.size();
+  }
+  return count;
+}
+
+int64_t VectorSearchCache::MemorySize() {
+  int64_t bytes = 0;
+  for (auto& shard : shards_) {
+    BAIDU_SCOPED_LOCK(shard.mutex);
+    bytes += shard.bytes;
+  }
+  return bytes;
+}
+
+}  // namespace dingodb
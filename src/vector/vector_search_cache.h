@@ -0,0 +1,105 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_VECTOR_SEARCH_CACHE_H_
+#define DINGODB_VECTOR_SEARCH_CACHE_H_
+
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "bthread/types.h"
+#include "proto/common.pb.h"
+#include "proto/index.pb.h"
+
+namespace dingodb {
+
+// Store level LRU cache of vector batch search results.
+// An entry is keyed by the hash of the region, the query vectors and the search parameter (which carries the
+// filter), and is tagged with the apply log id of the region and of its vector index when it is computed.
+// Get only returns an entry whose tags equal the current ids, so any applied write invalidates the entries of
+// the region, they are dropped on access or by LRU eviction.
+class VectorSearchCache {
+ public:
+  // apply_log_id of region raft and of vector index
+  struct Version {
+    int64_t region_apply_log_id{0};
+    int64_t vector_index_apply_log_id{0};
+
+    bool operator==(const Version& rhs) const {
+      return region_apply_log_id == rhs.region_apply_log_id &&
+             vector_index_apply_log_id == rhs.vector_index_apply_log_id;
+    }
+  };
+
+  VectorSearchCache(int64_t capacity_bytes, uint32_t shard_num, const std::set<int64_t>& disabled_index_ids);
+  ~VectorSearchCache();
+
+  VectorSearchCache(const VectorSearchCache& rhs) = delete;
+  VectorSearchCache& operator=(const VectorSearchCache& rhs) = delete;
+  VectorSearchCache(VectorSearchCache&& rhs) = delete;
+  VectorSearchCache& operator=(VectorSearchCache&& rhs) = delete;
+
+  // Create by gflags.
+  static std::shared_ptr<VectorSearchCache> New();
+
+  // Serialize everything the result depends on.
+  static std::string Fingerprint(int64_t region_id, const pb::common::Range& region_range,
+                                 const std::vector<pb::common::VectorWithId>& vector_with_ids,
+                                 const pb::common::VectorSearchParameter& parameter);
+
+  bool IsEnabled(int64_t index_id) const;
+
+  bool Get(const std::string& fingerprint, const Version& version,
+           std::vector<pb::index::VectorWithDistanceResult>& results);
+  void Put(const std::string& fingerprint, const Version& version,
+           const std::vector<pb::index::VectorWithDistanceResult>& results);
+
+  int64_t Count();
+  int64_t MemorySize();
+
+ private:
+  struct Entry {
+    uint64_t hash;
+    std::string fingerprint;
+    Version version;
+    std::vector<pb::index::VectorWithDistanceResult> results;
+    int64_t bytes;
+  };
+
+  struct Shard {
+    bthread_mutex_t mutex;
+    // front is the most recently used
+    std::list<Entry> lru;
+    std::unordered_map<uint64_t, std::list<Entry>::iterator> entries;
+    int64_t bytes{0};
+  };
+
+  Shard& GetShard(uint64_t hash) { return shards_[hash % shards_.size()]; }
+  static void EraseEntry(Shard& shard, std::list<Entry>::iterator it);
+
+  int64_t shard_capacity_bytes_;
+  std::vector<Shard> shards_;
+  std::set<int64_t> disabled_index_ids_;
+};
+
+using VectorSearchCachePtr = std::shared_ptr<VectorSearchCache>;
+
+}  // namespace dingodb
+
+#endif  // DINGODB_VECTOR_SEARCH_CACHE_H_
@@ -0,0 +1,106 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <cstdint>
+#include <optional>
+#include <string>
+
+#include "benchmark/benchmark.h"
+#include "common/constant.h"
+#include "common/helper.h"
+#include "common/key_codec.h"
+#include "document/codec.h"
+#include "serial/buf.h"
+#include "serial/schema/long_schema.h"
+#include "vector/codec.h"
+
+namespace dingodb {
+
+// vector key encoded by serial Buf, the way before KeyCodec
+static void BM_VectorKeyEncodeBuf(benchmark::State& state) {
+  int64_t vector_id = 0;
+  std::string result;
+  for (auto _ : state) {
+    Buf buf(Constant::kVectorKeyMaxLenWithPrefix);
+    buf.Write('r');
+    buf.WriteLong(1001);
+    DingoSchema<std::optional<int64_t>>::InternalEncodeKey(&buf, ++vector_id);
+    buf.GetBytes(result);
+    benchmark::DoNotOptimize(result);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_VectorKeyEncodeBuf);
+
+static void BM_VectorKeyEncode(benchmark::State& state) {
+  int64_t vector_id = 0;
+  std::string result;
+  for (auto _ : state) {
+    VectorCodec::EncodeVectorKey('r', 1001, ++vector_id, result);
+    benchmark::DoNotOptimize(result);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_VectorKeyEncode);
+
+static void BM_VectorKeyDecodeBuf(benchmark::State& state) {
+  std::string key;
+  VectorCodec::EncodeVectorKey('r', 1001, 123456789, key);
+  for (auto _ : state) {
+    Buf buf(key);
+    buf.Skip(9);
+    benchmark::DoNotOptimize(DingoSchema<std::optional<int64_t>>::InternalDecodeKey(&buf));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_VectorKeyDecodeBuf);
+
+static void BM_VectorKeyDecode(benchmark::State& state) {
+  std::string key;
+  VectorCodec::EncodeVectorKey('r', 1001, 123456789, key);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(VectorCodec::DecodeVectorId(key));
+    benchmark::DoNotOptimize(VectorCodec::DecodePartitionId(key));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_VectorKeyDecode);
+
+static void BM_DocumentKeyEncodeDecode(benchmark::State& state) {
+  int64_t document_id = 0;
+  std::string result;
+  for (auto _ : state) {
+    DocumentCodec::EncodeDocumentKey('r', 1001, ++document_id, result);
+    benchmark::DoNotOptimize(DocumentCodec::DecodeDocumentId(result));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_DocumentKeyEncodeDecode);
+
+// txn key encode and decode, range(0) is the user key size
+static void BM_TxnKeyEncodeDecode(benchmark::State& state) {
+  std::string user_key(state.range(0), 'k');
+  std::string key;
+  int64_t ts = 0;
+  for (auto _ : state) {
+    std::string txn_key = Helper::EncodeTxnKey(user_key, ++ts);
+    benchmark::DoNotOptimize(Helper::DecodeTxnKey(txn_key, key, ts));
+  }
+  state.SetItemsProcessed(state.iterations());
+  state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_TxnKeyEncodeDecode)->Arg(16)->Arg(64)->Arg(256);
+
+}  // namespace dingodb
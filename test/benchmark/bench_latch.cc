@@ -0,0 +1,48 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "common/latch.h"
+#include "fmt/core.h"
+
+namespace dingodb {
+
+// acquire and release keys without conflict, range(0) is the key number of one command
+static void BM_LatchAcquireRelease(benchmark::State& state) {
+  Latches latches(1 << 16);
+
+  int64_t key_num = state.range(0);
+  std::vector<std::string> keys;
+  keys.reserve(key_num);
+  for (int64_t i = 0; i < key_num; ++i) {
+    keys.push_back(fmt::format("key_{}", i));
+  }
+
+  uint64_t cid = 0;
+  for (auto _ : state) {
+    Lock lock(keys);
+    ++cid;
+    benchmark::DoNotOptimize(latches.Acquire(&lock, cid));
+    latches.Release(&lock, cid, std::nullopt);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_LatchAcquireRelease)->Arg(1)->Arg(8)->Arg(64);
+
+}  // namespace dingodb
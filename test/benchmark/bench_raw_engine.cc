@@ -0,0 +1,152 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "common/helper.h"
+#include "config/yaml_config.h"
+#include "engine/bdb_raw_engine.h"
+#include "engine/raw_engine.h"
+#include "engine/rocks_raw_engine.h"
+#include "fmt/core.h"
+#include "proto/common.pb.h"
+
+namespace dingodb {
+
+static const std::string kBenchRawEnginePath = "./bench/raw_engine";
+static const std::string kBenchCf = "default";
+
+enum BenchEngineType {
+  kBenchRocks = 0,
+  kBenchBdb = 1,
+};
+
+static std::shared_ptr<RawEngine> NewRawEngine(int64_t type) {
+  std::string path = fmt::format("{}/{}", kBenchRawEnginePath, type == kBenchRocks ? "rocks" : "bdb");
+  Helper::RemoveAllFileOrDirectory(path);
+  Helper::CreateDirectories(path);
+
+  auto config = std::make_shared<YamlConfig>();
+  if (config->Load(fmt::format("store:\n  path: {}\n", path)) != 0) {
+    return nullptr;
+  }
+
+  std::shared_ptr<RawEngine> engine;
+  if (type == kBenchRocks) {
+    engine = std::make_shared<RocksRawEngine>();
+  } else {
+    engine = std::make_shared<BdbRawEngine>();
+  }
+  if (!engine->Init(config, {kBenchCf})) {
+    return nullptr;
+  }
+
+  return engine;
+}
+
+// the engines are shared by the benchmark threads, and live as long as the process
+static std::shared_ptr<RawEngine> GetRawEngine(int64_t type) {
+  static std::mutex mutex;
+  static std::array<std::shared_ptr<RawEngine>, 2> engines;
+
+  std::lock_guard<std::mutex> lock(mutex);
+  if (engines[type] == nullptr) {
+    engines[type] = NewRawEngine(type);
+  }
+  return engines[type];
+}
+
+static std::string BenchKey(int64_t thread_index, int64_t i) {
+  return fmt::format("key_{:04}_{:012}", thread_index, i);
+}
+
+// Compare the raw engines on the same workload, e.g.
+// dingodb_bench --benchmark_filter=BM_RawEngine.* --bdb_group_commit=true --bdb_point_get_without_snapshot=true
+
+// put keys, range(0) is engine type, range(1) is value size
+static void BM_RawEnginePut(benchmark::State& state) {
+  auto engine = GetRawEngine(state.range(0));
+  if (engine == nullptr) {
+    state.SkipWithError("init raw engine failed");
+    return;
+  }
+
+  auto writer = engine->Writer();
+  std::string value(state.range(1), 'x');
+  int64_t i = 0;
+  for (auto _ : state) {
+    pb::common::KeyValue kv;
+    kv.set_key(BenchKey(state.thread_index(), i++));
+    kv.set_value(value);
+    auto status = writer->KvPut(kBenchCf, kv);
+    if (!status.ok()) {
+      state.SkipWithError(status.error_cstr());
+      break;
+    }
+  }
+  state.SetItemsProcessed(state.iterations());
+  state.SetBytesProcessed(state.iterations() * state.range(1));
+}
+BENCHMARK(BM_RawEnginePut)
+    ->ArgsProduct({{kBenchRocks, kBenchBdb}, {256}})
+    ->Threads(1)
+    ->Threads(8)
+    ->UseRealTime();
+
+// get random keys of prepared data, range(0) is engine type
+static void BM_RawEngineGet(benchmark::State& state) {
+  const int64_t key_num = 10000;
+  auto engine = GetRawEngine(state.range(0));
+  if (engine == nullptr) {
+    state.SkipWithError("init raw engine failed");
+    return;
+  }
+
+  // thread 0 prepare data before the threads start
+  if (state.thread_index() == 0) {
+    std::vector<pb::common::KeyValue> kvs(key_num);
+    for (int64_t i = 0; i < key_num; ++i) {
+      kvs[i].set_key(BenchKey(9999, i));
+      kvs[i].set_value(std::string(256, 'x'));
+    }
+    auto status = engine->Writer()->KvBatchPutAndDelete(kBenchCf, kvs, {});
+    if (!status.ok()) {
+      state.SkipWithError(status.error_cstr());
+      return;
+    }
+  }
+
+  auto reader = engine->Reader();
+  int64_t offset = state.thread_index();
+  for (auto _ : state) {
+    std::string value;
+    auto status = reader->KvGet(kBenchCf, BenchKey(9999, offset), value);
+    if (!status.ok()) {
+      state.SkipWithError(status.error_cstr());
+      break;
+    }
+    offset = (offset + 7919) % key_num;
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_RawEngineGet)->Arg(kBenchRocks)->Arg(kBenchBdb)->Threads(1)->Threads(8)->UseRealTime();
+
+}  // namespace dingodb
@@ -0,0 +1,128 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <sys/resource.h>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "benchmark/benchmark.h"
+#include "brpc/channel.h"
+#include "brpc/controller.h"
+#include "brpc/server.h"
+#include "butil/iobuf.h"
+#include "proto/node.pb.h"
+
+namespace dingodb {
+
+// echo the request attachment, the payload of raft entry and search result is mostly in attachment
+class EchoNodeService : public pb::node::NodeService {
+ public:
+  void GetNodeInfo(google::protobuf::RpcController* controller, const pb::node::GetNodeInfoRequest*,
+                   pb::node::GetNodeInfoResponse*, google::protobuf::Closure* done) override {
+    brpc::ClosureGuard done_guard(done);
+    auto* cntl = static_cast<brpc::Controller*>(controller);
+    cntl->response_attachment().swap(cntl->request_attachment());
+  }
+};
+
+struct EchoServer {
+  EchoNodeService service;
+  brpc::Server server;
+  brpc::Channel channel;
+  bool ok{false};
+};
+
+static std::unique_ptr<EchoServer> StartEchoServer(bool use_rdma) {
+  auto echo = std::make_unique<EchoServer>();
+  if (echo->server.AddService(&echo->service, brpc::SERVER_DOESNT_OWN_SERVICE) != 0) {
+    return echo;
+  }
+
+  brpc::ServerOptions server_options;
+  brpc::ChannelOptions channel_options;
+  channel_options.timeout_ms = 10000;
+#ifdef BRPC_WITH_RDMA
+  server_options.use_rdma = use_rdma;
+  channel_options.use_rdma = use_rdma;
+#else
+  if (use_rdma) {
+    return echo;
+  }
+#endif
+
+  if (echo->server.Start("127.0.0.1", brpc::PortRange(30000, 40000), &server_options) != 0) {
+    return echo;
+  }
+  if (echo->channel.Init(echo->server.listen_address(), &channel_options) != 0) {
+    return echo;
+  }
+
+  echo->ok = true;
+  return echo;
+}
+
+static int64_t ProcessCpuTimeNs() {
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  return (usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * 1000000000L +
+         (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) * 1000L;
+}
+
+// round trip of payload, range(0) is payload bytes, range(1) is 1 for rdma and 0 for tcp.
+// cpu_ns_per_gb counts the cpu of the whole process, include the server side.
+static void BM_RpcRoundTrip(benchmark::State& state) {
+  int64_t payload_size = state.range(0);
+  bool use_rdma = state.range(1) != 0;
+
+  // leaked, not stop the server in static destruction
+  static EchoServer* echo_servers[2] = {nullptr, nullptr};
+  auto*& echo = echo_servers[use_rdma ? 1 : 0];
+  if (echo == nullptr) {
+    echo = StartEchoServer(use_rdma).release();
+  }
+  if (!echo->ok) {
+    state.SkipWithError(use_rdma ? "rdma is not available" : "start echo server failed");
+    return;
+  }
+
+  std::string payload(payload_size, 'x');
+  pb::node::NodeService_Stub stub(&echo->channel);
+  pb::node::GetNodeInfoRequest request;
+
+  int64_t start_cpu_ns = ProcessCpuTimeNs();
+  for (auto _ : state) {
+    brpc::Controller cntl;
+    cntl.request_attachment().append(payload);
+    pb::node::GetNodeInfoResponse response;
+    stub.GetNodeInfo(&cntl, &request, &response, nullptr);
+    if (cntl.Failed()) {
+      state.SkipWithError(cntl.ErrorText().c_str());
+      break;
+    }
+  }
+  int64_t cpu_ns = ProcessCpuTimeNs() - start_cpu_ns;
+
+  int64_t bytes = 2 * payload_size * state.iterations();
+  state.SetBytesProcessed(bytes);
+  state.counters["cpu_ns_per_gb"] = bytes > 0 ? static_cast<double>(cpu_ns) * (1 << 30) / bytes : 0;
+}
+BENCHMARK(BM_RpcRoundTrip)
+    ->ArgsProduct({{4 << 10, 256 << 10, 4 << 20}, {0, 1}})
+    ->UseRealTime()
+    ->Unit(benchmark::kMicrosecond);
+
+}  // namespace dingodb
@@ -0,0 +1,64 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cstdint>
+
+#include "benchmark/benchmark.h"
+#include "common/safe_map.h"
+
+namespace dingodb {
+
+static constexpr int64_t kSafeMapKeyNum = 100000;
+
+// readers of the doubly buffered map, range(0) is the key number
+static void BM_SafeMapGet(benchmark::State& state) {
+  static DingoSafeMap<int64_t, int64_t>* safe_map = nullptr;
+  if (state.thread_index() == 0) {
+    safe_map = new DingoSafeMap<int64_t, int64_t>();
+    safe_map->Init(state.range(0));
+    for (int64_t i = 0; i < state.range(0); ++i) {
+      safe_map->Put(i, i);
+    }
+  }
+
+  int64_t key = state.thread_index();
+  int64_t value = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(safe_map->Get(key, value));
+    key = (key + 7) % state.range(0);
+  }
+  state.SetItemsProcessed(state.iterations());
+
+  if (state.thread_index() == 0) {
+    delete safe_map;
+    safe_map = nullptr;
+  }
+}
+BENCHMARK(BM_SafeMapGet)->Arg(kSafeMapKeyNum)->ThreadRange(1, 8)->UseRealTime();
+
+// every put modifies both buffers and waits for readers
+static void BM_SafeMapPut(benchmark::State& state) {
+  DingoSafeMap<int64_t, int64_t> safe_map;
+  safe_map.Init(state.range(0));
+
+  int64_t key = 0;
+  for (auto _ : state) {
+    safe_map.Put(key, key);
+    key = (key + 1) % state.range(0);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_SafeMapPut)->Arg(kSafeMapKeyNum);
+
+}  // namespace dingodb
@@ -0,0 +1,126 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "braft/configuration_manager.h"
+#include "braft/log_entry.h"
+#include "butil/iobuf.h"
+#include "common/helper.h"
+#include "log/segment_log_storage.h"
+
+namespace dingodb {
+
+static const std::string kBenchLogPath = "./bench/segment_log";
+
+static std::shared_ptr<SegmentLogStorage> NewLogStorage() {
+  Helper::RemoveAllFileOrDirectory(kBenchLogPath);
+  Helper::CreateDirectories(kBenchLogPath);
+
+  auto log_storage = std::make_shared<SegmentLogStorage>(kBenchLogPath, 1, 64 * 1024 * 1024, INT64_MAX);
+  static braft::ConfigurationManager configuration_manager;
+  if (log_storage->Init(&configuration_manager) != 0) {
+    return nullptr;
+  }
+  return log_storage;
+}
+
+static braft::LogEntry* NewLogEntry(int64_t index, const std::string& payload) {
+  auto* log_entry = new braft::LogEntry();
+  log_entry->AddRef();
+  log_entry->type = braft::ENTRY_TYPE_DATA;
+  log_entry->id.term = 1;
+  log_entry->id.index = index;
+  log_entry->data.append(payload);
+
+  return log_entry;
+}
+
+// append batches of 32 entries, range(0) is entry size
+static void BM_SegmentLogStorageAppend(benchmark::State& state) {
+  auto log_storage = NewLogStorage();
+  if (log_storage == nullptr) {
+    state.SkipWithError("init log storage failed");
+    return;
+  }
+
+  const int batch_size = 32;
+  std::string payload(state.range(0), 'x');
+  int64_t index = log_storage->LastLogIndex();
+  for (auto _ : state) {
+    state.PauseTiming();
+    std::vector<braft::LogEntry*> entries;
+    entries.reserve(batch_size);
+    for (int i = 0; i < batch_size; ++i) {
+      entries.push_back(NewLogEntry(++index, payload));
+    }
+    state.ResumeTiming();
+
+    int ret = log_storage->AppendEntries(entries, nullptr);
+
+    state.PauseTiming();
+    for (auto* entry : entries) {
+      entry->Release();
+    }
+    state.ResumeTiming();
+    if (ret != batch_size) {
+      state.SkipWithError("append entries failed");
+      break;
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * batch_size);
+  state.SetBytesProcessed(state.iterations() * batch_size * state.range(0));
+
+  log_storage->GcInstance(kBenchLogPath);
+}
+BENCHMARK(BM_SegmentLogStorageAppend)->Arg(256)->Arg(4096)->Arg(64 * 1024);
+
+// read random entries, range(0) is entry size
+static void BM_SegmentLogStorageGetEntry(benchmark::State& state) {
+  auto log_storage = NewLogStorage();
+  if (log_storage == nullptr) {
+    state.SkipWithError("init log storage failed");
+    return;
+  }
+
+  const int64_t entry_num = 10000;
+  std::string payload(state.range(0), 'x');
+  int64_t first_index = log_storage->LastLogIndex() + 1;
+  for (int64_t i = 0; i < entry_num; ++i) {
+    auto* entry = NewLogEntry(first_index + i, payload);
+    log_storage->AppendEntry(entry);
+    entry->Release();
+  }
+
+  int64_t offset = 0;
+  for (auto _ : state) {
+    auto* entry = log_storage->GetEntry(first_index + offset);
+    if (entry == nullptr) {
+      state.SkipWithError("get entry failed");
+      break;
+    }
+    entry->Release();
+    offset = (offset + 7919) % entry_num;
+  }
+  state.SetItemsProcessed(state.iterations());
+
+  log_storage->GcInstance(kBenchLogPath);
+}
+BENCHMARK(BM_SegmentLogStorageGetEntry)->Arg(256)->Arg(4096);
+
+}  // namespace dingodb
@@ -0,0 +1,114 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "simd/distances_ref.h"
+#include "simd/hook.h"
+
+namespace dingodb {
+
+static std::vector<float> GenFloatVector(size_t size, uint32_t seed) {
+  std::mt19937 rng(seed);
+  std::uniform_real_distribution<float> distrib(-1.0, 1.0);
+
+  std::vector<float> values(size);
+  for (auto& value : values) {
+    value = distrib(rng);
+  }
+  return values;
+}
+
+static std::vector<int8_t> GenInt8Vector(size_t size, uint32_t seed) {
+  std::mt19937 rng(seed);
+  std::uniform_int_distribution<int> distrib(-128, 127);
+
+  std::vector<int8_t> values(size);
+  for (auto& value : values) {
+    value = static_cast<int8_t>(distrib(rng));
+  }
+  return values;
+}
+
+// the hooked kernel is the one selected by cpu features at startup
+static void BM_FvecL2sqr(benchmark::State& state) {
+  size_t dimension = state.range(0);
+  auto x = GenFloatVector(dimension, 1);
+  auto y = GenFloatVector(dimension, 2);
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(fvec_L2sqr(x.data(), y.data(), dimension));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_FvecL2sqr)->Arg(64)->Arg(128)->Arg(512)->Arg(1024);
+
+static void BM_FvecL2sqrRef(benchmark::State& state) {
+  size_t dimension = state.range(0);
+  auto x = GenFloatVector(dimension, 1);
+  auto y = GenFloatVector(dimension, 2);
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(fvec_L2sqr_ref(x.data(), y.data(), dimension));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_FvecL2sqrRef)->Arg(64)->Arg(128)->Arg(512)->Arg(1024);
+
+static void BM_FvecInnerProduct(benchmark::State& state) {
+  size_t dimension = state.range(0);
+  auto x = GenFloatVector(dimension, 1);
+  auto y = GenFloatVector(dimension, 2);
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(fvec_inner_product(x.data(), y.data(), dimension));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_FvecInnerProduct)->Arg(64)->Arg(128)->Arg(512)->Arg(1024);
+
+// one query against a block of ny vectors
+static void BM_FvecL2sqrNxNy(benchmark::State& state) {
+  size_t dimension = state.range(0);
+  size_t nx = 4;
+  size_t ny = 256;
+  auto x = GenFloatVector(dimension * nx, 1);
+  auto y = GenFloatVector(dimension * ny, 2);
+  std::vector<float> distances(nx * ny);
+
+  for (auto _ : state) {
+    fvec_L2sqr_nx_ny(distances.data(), x.data(), y.data(), dimension, nx, ny);
+    benchmark::DoNotOptimize(distances.data());
+  }
+  state.SetItemsProcessed(state.iterations() * nx * ny);
+}
+BENCHMARK(BM_FvecL2sqrNxNy)->Arg(128)->Arg(512);
+
+static void BM_I8vecL2sqr(benchmark::State& state) {
+  size_t dimension = state.range(0);
+  auto x = GenInt8Vector(dimension, 1);
+  auto y = GenInt8Vector(dimension, 2);
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(i8vec_L2sqr(x.data(), y.data(), dimension));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_I8vecL2sqr)->Arg(128)->Arg(512);
+
+}  // namespace dingodb
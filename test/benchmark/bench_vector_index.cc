@@ -0,0 +1,152 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "common/threadpool.h"
+#include "proto/common.pb.h"
+#include "proto/index.pb.h"
+#include "vector/vector_index.h"
+#include "vector/vector_index_factory.h"
+
+namespace dingodb {
+
+static std::vector<pb::common::VectorWithId> GenVectors(int64_t start_id, int64_t count, int32_t dimension) {
+  std::mt19937 rng(start_id);
+  std::uniform_real_distribution<float> distrib(0.0, 1.0);
+
+  std::vector<pb::common::VectorWithId> vector_with_ids;
+  vector_with_ids.reserve(count);
+  for (int64_t i = 0; i < count; ++i) {
+    pb::common::VectorWithId vector_with_id;
+    vector_with_id.set_id(start_id + i);
+    auto* vector = vector_with_id.mutable_vector();
+    vector->set_dimension(dimension);
+    vector->set_value_type(pb::common::ValueType::FLOAT);
+    for (int32_t j = 0; j < dimension; ++j) {
+      vector->add_float_values(distrib(rng));
+    }
+    vector_with_ids.push_back(std::move(vector_with_id));
+  }
+
+  return vector_with_ids;
+}
+
+static VectorIndexPtr NewVectorIndex(pb::common::VectorIndexType type, int32_t dimension, int64_t max_elements) {
+  static ThreadPoolPtr thread_pool = std::make_shared<ThreadPool>("bench_vector_index", 4);
+
+  pb::common::RegionEpoch epoch;
+  epoch.set_conf_version(1);
+  epoch.set_version(1);
+  pb::common::Range range;
+
+  pb::common::VectorIndexParameter index_parameter;
+  index_parameter.set_vector_index_type(type);
+  if (type == pb::common::VectorIndexType::VECTOR_INDEX_TYPE_HNSW) {
+    auto* hnsw_parameter = index_parameter.mutable_hnsw_parameter();
+    hnsw_parameter->set_dimension(dimension);
+    hnsw_parameter->set_metric_type(pb::common::MetricType::METRIC_TYPE_L2);
+    hnsw_parameter->set_efconstruction(200);
+    hnsw_parameter->set_max_elements(max_elements);
+    hnsw_parameter->set_nlinks(32);
+    return VectorIndexFactory::NewHnsw(1, index_parameter, epoch, range, thread_pool);
+  }
+
+  auto* flat_parameter = index_parameter.mutable_flat_parameter();
+  flat_parameter->set_dimension(dimension);
+  flat_parameter->set_metric_type(pb::common::MetricType::METRIC_TYPE_L2);
+  return VectorIndexFactory::NewFlat(1, index_parameter, epoch, range, thread_pool);
+}
+
+// add batches of 256 vectors, range(0) is type, range(1) is dimension
+static void BM_VectorIndexAdd(benchmark::State& state) {
+  auto type = static_cast<pb::common::VectorIndexType>(state.range(0));
+  int32_t dimension = state.range(1);
+  const int64_t batch_size = 256;
+  const int64_t max_elements = 1000000;
+
+  auto vector_index = NewVectorIndex(type, dimension, max_elements);
+  if (vector_index == nullptr) {
+    state.SkipWithError("new vector index failed");
+    return;
+  }
+
+  int64_t next_id = 1;
+  for (auto _ : state) {
+    state.PauseTiming();
+    if (next_id + batch_size > max_elements) {
+      vector_index = NewVectorIndex(type, dimension, max_elements);
+      next_id = 1;
+    }
+    auto vector_with_ids = GenVectors(next_id, batch_size, dimension);
+    next_id += batch_size;
+    state.ResumeTiming();
+
+    auto status = vector_index->Add(vector_with_ids);
+    if (!status.ok()) {
+      state.SkipWithError(status.error_cstr());
+      break;
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * batch_size);
+}
+BENCHMARK(BM_VectorIndexAdd)
+    ->ArgsProduct({{pb::common::VectorIndexType::VECTOR_INDEX_TYPE_FLAT,
+                    pb::common::VectorIndexType::VECTOR_INDEX_TYPE_HNSW},
+                   {128, 512}})
+    ->Unit(benchmark::kMillisecond);
+
+// search top 10 of one query, range(0) is type, range(1) is dimension, range(2) is data size
+static void BM_VectorIndexSearch(benchmark::State& state) {
+  auto type = static_cast<pb::common::VectorIndexType>(state.range(0));
+  int32_t dimension = state.range(1);
+  int64_t data_size = state.range(2);
+
+  auto vector_index = NewVectorIndex(type, dimension, data_size);
+  if (vector_index == nullptr) {
+    state.SkipWithError("new vector index failed");
+    return;
+  }
+  auto status = vector_index->Add(GenVectors(1, data_size, dimension));
+  if (!status.ok()) {
+    state.SkipWithError(status.error_cstr());
+    return;
+  }
+
+  auto queries = GenVectors(data_size + 1, 64, dimension);
+  size_t query_pos = 0;
+  for (auto _ : state) {
+    std::vector<pb::index::VectorWithDistanceResult> results;
+    status = vector_index->Search({queries[query_pos]}, 10, {}, false, {}, results);
+    if (!status.ok()) {
+      state.SkipWithError(status.error_cstr());
+      break;
+    }
+    benchmark::DoNotOptimize(results);
+    query_pos = (query_pos + 1) % queries.size();
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_VectorIndexSearch)
+    ->ArgsProduct({{pb::common::VectorIndexType::VECTOR_INDEX_TYPE_FLAT,
+                    pb::common::VectorIndexType::VECTOR_INDEX_TYPE_HNSW},
+                   {128, 512},
+                   {10000, 100000}})
+    ->Unit(benchmark::kMicrosecond);
+
+}  // namespace dingodb
@@ -0,0 +1,53 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <string>
+
+#include "benchmark/benchmark.h"
+#include "common/helper.h"
+#include "fmt/core.h"
+#include "gflags/gflags.h"
+#include "glog/logging.h"
+
+static void InitLog(const std::string& log_dir) {
+  if (!dingodb::Helper::IsExistPath(log_dir)) {
+    dingodb::Helper::CreateDirectories(log_dir);
+  }
+
+  FLAGS_logbufsecs = 0;
+  FLAGS_minloglevel = google::GLOG_WARNING;
+  FLAGS_logtostderr = false;
+  FLAGS_alsologtostderr = false;
+
+  std::string program_name = "dingodb_bench";
+
+  google::InitGoogleLogging(program_name.c_str());
+  google::SetLogDestination(google::GLOG_INFO, fmt::format("{}/{}.info.log.", log_dir, program_name).c_str());
+  google::SetLogDestination(google::GLOG_WARNING, fmt::format("{}/{}.warn.log.", log_dir, program_name).c_str());
+  google::SetLogDestination(google::GLOG_ERROR, fmt::format("{}/{}.error.log.", log_dir, program_name).c_str());
+  google::SetStderrLogging(google::GLOG_FATAL);
+}
+
+// e.g. dingodb_bench --benchmark_filter=BM_Latch.* --benchmark_format=json --benchmark_out=latch.json
+int main(int argc, char* argv[]) {
+  InitLog("./log");
+
+  benchmark::Initialize(&argc, argv);
+  google::ParseCommandLineFlags(&argc, &argv, true);
+
+  benchmark::RunSpecifiedBenchmarks();
+  benchmark::Shutdown();
+
+  return 0;
+}
@@ -0,0 +1,95 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "document/codec.h"
+#include "proto/common.pb.h"
+
+namespace dingodb {
+
+class DocumentCodecScalarFilterTest : public testing::Test {
+ protected:
+  static pb::common::ScalarSchema Schema() {
+    pb::common::ScalarSchema scalar_schema;
+    auto add_field = [&](const std::string& key, pb::common::ScalarFieldType type) {
+      auto* field = scalar_schema.add_fields();
+      field->set_key(key);
+      field->set_field_type(type);
+    };
+    add_field("text", pb::common::ScalarFieldType::STRING);
+    add_field("i64", pb::common::ScalarFieldType::INT64);
+    add_field("f64", pb::common::ScalarFieldType::DOUBLE);
+    add_field("bytes", pb::common::ScalarFieldType::BYTES);
+    return scalar_schema;
+  }
+
+  static std::vector<DocumentScalarFilter> Parse(const std::string& expression) {
+    std::vector<DocumentScalarFilter> filters;
+    std::string error_message;
+    EXPECT_TRUE(DocumentCodec::ParseScalarFilter(expression, filters, error_message)) << error_message;
+    return filters;
+  }
+};
+
+TEST_F(DocumentCodecScalarFilterTest, Parse) {
+  auto filters = Parse("i64>=10;f64<2.5;text=hello world;");
+  ASSERT_EQ(3, filters.size());
+  EXPECT_EQ("i64", filters[0].column);
+  EXPECT_EQ(">=", filters[0].op);
+  EXPECT_EQ("10", filters[0].value);
+  EXPECT_EQ("<", filters[1].op);
+  EXPECT_EQ("2.5", filters[1].value);
+  EXPECT_EQ("=", filters[2].op);
+  EXPECT_EQ("hello world", filters[2].value);
+
+  std::vector<DocumentScalarFilter> illegal;
+  std::string error_message;
+  EXPECT_FALSE(DocumentCodec::ParseScalarFilter("i64", illegal, error_message));
+  EXPECT_FALSE(DocumentCodec::ParseScalarFilter(">=1", illegal, error_message));
+  EXPECT_FALSE(DocumentCodec::ParseScalarFilter("i64>=", illegal, error_message));
+}
+
+TEST_F(DocumentCodecScalarFilterTest, GenQueryString) {
+  std::string result;
+  std::string error_message;
+  ASSERT_TRUE(DocumentCodec::GenScalarFilterQueryString(Schema(), "text:discover",
+                                                         Parse("i64>=10;i64<20;f64>0.5;f64<=1.5;text=a \"b\""),
+                                                         result, error_message))
+      << error_message;
+  EXPECT_EQ(R"((text:discover) AND i64:[10 TO *} AND i64:{* TO 20} AND f64:{0.5 TO *} AND f64:{* TO 1.5] AND )"
+            R"(text:"a \"b\"")",
+            result);
+
+  ASSERT_TRUE(DocumentCodec::GenScalarFilterQueryString(Schema(), "", Parse("i64=7"), result, error_message));
+  EXPECT_EQ("i64:7", result);
+}
+
+TEST_F(DocumentCodecScalarFilterTest, GenQueryStringIllegal) {
+  std::string result;
+  std::string error_message;
+  // not declared
+  EXPECT_FALSE(DocumentCodec::GenScalarFilterQueryString(Schema(), "q", Parse("other=1"), result, error_message));
+  // type mismatch
+  EXPECT_FALSE(DocumentCodec::GenScalarFilterQueryString(Schema(), "q", Parse("i64=abc"), result, error_message));
+  EXPECT_FALSE(DocumentCodec::GenScalarFilterQueryString(Schema(), "q", Parse("f64>1.5x"), result, error_message));
+  // range on text, filter on bytes
+  EXPECT_FALSE(DocumentCodec::GenScalarFilterQueryString(Schema(), "q", Parse("text>a"), result, error_message));
+  EXPECT_FALSE(DocumentCodec::GenScalarFilterQueryString(Schema(), "q", Parse("bytes=a"), result, error_message));
+}
+
+}  // namespace dingodb
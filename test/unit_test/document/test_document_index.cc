@@ -22,6 +22,12 @@
 #include "butil/status.h"
 #include "document/codec.h"
 #include "document/document_index_factory.h"
+#include "gflags/gflags.h"
+
+namespace dingodb {
+DECLARE_int64(document_index_group_commit_max_count);
+DECLARE_int64(document_index_group_commit_interval_ms);
+}  // namespace dingodb
 
 static size_t log_level = 1;
 
@@ -526,4 +532,149 @@ TEST(DingoDocumentIndexTest, test_upsert) {
     EXPECT_EQ(ret.ok(), true);
     EXPECT_EQ(results.size(), 0);
   }
-}
\ No newline at end of file
+}
+
+TEST(DingoDocumentIndexTest, test_group_commit) {
+  std::filesystem::remove_all(kDocumentIndexTestIndexPath);
+  std::string index_path{kDocumentIndexTestIndexPath};
+
+  std::string error_message;
+  std::string json_parameter;
+  std::map<std::string, dingodb::TokenizerType> column_tokenizer_parameter;
+
+  dingodb::pb::common::DocumentIndexParameter document_index_parameter;
+  auto* text_field = document_index_parameter.mutable_scalar_schema()->add_fields();
+  text_field->set_key("text");
+  text_field->set_field_type(dingodb::pb::common::ScalarFieldType::STRING);
+  column_tokenizer_parameter["text"] = dingodb::TokenizerType::kTokenizerTypeText;
+
+  ASSERT_TRUE(dingodb::DocumentCodec::GenDefaultTokenizerJsonParameter(column_tokenizer_parameter, json_parameter,
+                                                                       error_message));
+  document_index_parameter.set_json_parameter(json_parameter);
+
+  butil::Status status;
+  auto document_index = dingodb::DocumentIndexFactory::LoadOrCreateIndex(
+      1, index_path, document_index_parameter, dingodb::pb::common::RegionEpoch(), dingodb::pb::common::Range(),
+      status);
+  ASSERT_TRUE(document_index != nullptr) << status.error_str();
+
+  auto gen_document = [](int64_t id, const std::string& text) {
+    dingodb::pb::common::DocumentWithId document_with_id;
+    document_with_id.set_id(id);
+    dingodb::pb::common::DocumentValue document_value;
+    document_value.set_field_type(dingodb::pb::common::ScalarFieldType::STRING);
+    document_value.mutable_field_value()->set_string_data(text);
+    document_with_id.mutable_document()->mutable_document_data()->insert({"text", document_value});
+    return document_with_id;
+  };
+
+  auto search_count = [&](const std::string& query) {
+    std::vector<dingodb::pb::common::DocumentWithScore> results;
+    auto ret = document_index->Search(10, query, false, 0, INT64_MAX, false, {}, {}, results);
+    EXPECT_TRUE(ret.ok()) << ret.error_str();
+    return results.size();
+  };
+
+  dingodb::FLAGS_document_index_group_commit_max_count = 3;
+  dingodb::FLAGS_document_index_group_commit_interval_ms = 3600 * 1000;
+
+  // below the bound, pending and not searchable
+  ASSERT_TRUE(document_index->GroupAdd({gen_document(1, "apple banana")}).ok());
+  ASSERT_TRUE(document_index->GroupAdd({gen_document(2, "apple cherry")}).ok());
+  EXPECT_EQ(2, document_index->PendingCommitCount());
+  EXPECT_EQ(0, search_count("apple"));
+
+  // reach the bound, commit together
+  ASSERT_TRUE(document_index->GroupAdd({gen_document(3, "apple durian")}).ok());
+  EXPECT_EQ(0, document_index->PendingCommitCount());
+  EXPECT_EQ(3, search_count("apple"));
+
+  ASSERT_TRUE(document_index->GroupDelete({1}).ok());
+  EXPECT_EQ(1, document_index->PendingCommitCount());
+  ASSERT_TRUE(document_index->GroupCommit(false).ok());
+  EXPECT_EQ(1, document_index->PendingCommitCount());
+  ASSERT_TRUE(document_index->GroupCommit(true).ok());
+  EXPECT_EQ(0, document_index->PendingCommitCount());
+  EXPECT_EQ(2, search_count("apple"));
+
+  // save commits pending writes
+  ASSERT_TRUE(document_index->GroupUpsert({gen_document(2, "grape")}).ok());
+  EXPECT_GT(document_index->PendingCommitCount(), 0);
+  document_index->LockWrite();
+  ASSERT_TRUE(document_index->Save(index_path).ok());
+  document_index->UnlockWrite();
+  EXPECT_EQ(0, document_index->PendingCommitCount());
+  EXPECT_EQ(1, search_count("apple"));
+  EXPECT_EQ(1, search_count("grape"));
+
+  dingodb::FLAGS_document_index_group_commit_max_count = 10000;
+  dingodb::FLAGS_document_index_group_commit_interval_ms = 1000;
+}
+
+TEST(DingoDocumentIndexTest, test_evict) {
+  std::filesystem::remove_all(kDocumentIndexTestIndexPath);
+  std::string index_path{kDocumentIndexTestIndexPath};
+
+  std::string error_message;
+  std::string json_parameter;
+  std::map<std::string, dingodb::TokenizerType> column_tokenizer_parameter;
+
+  dingodb::pb::common::DocumentIndexParameter document_index_parameter;
+  auto* text_field = document_index_parameter.mutable_scalar_schema()->add_fields();
+  text_field->set_key("text");
+  text_field->set_field_type(dingodb::pb::common::ScalarFieldType::STRING);
+  column_tokenizer_parameter["text"] = dingodb::TokenizerType::kTokenizerTypeText;
+
+  ASSERT_TRUE(dingodb::DocumentCodec::GenDefaultTokenizerJsonParameter(column_tokenizer_parameter, json_parameter,
+                                                                       error_message));
+  document_index_parameter.set_json_parameter(json_parameter);
+
+  butil::Status status;
+  auto document_index = dingodb::DocumentIndexFactory::LoadOrCreateIndex(
+      1, index_path, document_index_parameter, dingodb::pb::common::RegionEpoch(), dingodb::pb::common::Range(),
+      status);
+  ASSERT_TRUE(document_index != nullptr) << status.error_str();
+
+  auto gen_document = [](int64_t id, const std::string& text) {
+    dingodb::pb::common::DocumentWithId document_with_id;
+    document_with_id.set_id(id);
+    dingodb::pb::common::DocumentValue document_value;
+    document_value.set_field_type(dingodb::pb::common::ScalarFieldType::STRING);
+    document_value.mutable_field_value()->set_string_data(text);
+    document_with_id.mutable_document()->mutable_document_data()->insert({"text", document_value});
+    return document_with_id;
+  };
+
+  auto search_count = [&](const std::string& query) {
+    std::vector<dingodb::pb::common::DocumentWithScore> results;
+    auto ret = document_index->Search(10, query, false, 0, INT64_MAX, false, {}, {}, results);
+    EXPECT_TRUE(ret.ok()) << ret.error_str();
+    return results.size();
+  };
+
+  dingodb::FLAGS_document_index_group_commit_max_count = 10;
+  dingodb::FLAGS_document_index_group_commit_interval_ms = 3600 * 1000;
+
+  ASSERT_TRUE(document_index->Add({gen_document(1, "apple banana")}, true).ok());
+  ASSERT_TRUE(document_index->GroupAdd({gen_document(2, "apple cherry")}).ok());
+  EXPECT_EQ(1, document_index->PendingCommitCount());
+
+  // evict commits pending writes
+  ASSERT_TRUE(document_index->Evict().ok());
+  EXPECT_TRUE(document_index->IsEvicted());
+  EXPECT_EQ(0, document_index->PendingCommitCount());
+
+  // search loads the reader only
+  EXPECT_EQ(2, search_count("apple"));
+  EXPECT_TRUE(document_index->IsReaderLoaded());
+  EXPECT_FALSE(document_index->IsWriterLoaded());
+
+  // write loads the writer
+  ASSERT_TRUE(document_index->Evict().ok());
+  ASSERT_TRUE(document_index->Add({gen_document(3, "apple durian")}, true).ok());
+  EXPECT_TRUE(document_index->IsWriterLoaded());
+  EXPECT_EQ(3, search_count("apple"));
+
+  dingodb::FLAGS_document_index_group_commit_max_count = 10000;
+  dingodb::FLAGS_document_index_group_commit_interval_ms = 1000;
+}
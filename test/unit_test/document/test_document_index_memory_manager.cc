@@ -0,0 +1,52 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "document/document_index_memory_manager.h"
+#include "gflags/gflags.h"
+
+namespace dingodb {
+
+DECLARE_int64(document_index_writer_memory_bytes);
+DECLARE_int64(document_index_reader_memory_bytes);
+
+TEST(DocumentIndexMemoryManagerTest, EstimateMemoryBytes) {
+  EXPECT_EQ(0, DocumentIndexMemoryManager::EstimateMemoryBytes(false, false, 0));
+  EXPECT_EQ(FLAGS_document_index_reader_memory_bytes, DocumentIndexMemoryManager::EstimateMemoryBytes(false, true, 0));
+  EXPECT_EQ(FLAGS_document_index_writer_memory_bytes + 100,
+            DocumentIndexMemoryManager::EstimateMemoryBytes(true, false, 100));
+}
+
+TEST(DocumentIndexMemoryManagerTest, SelectEvictions) {
+  int64_t now_ms = 100000;
+  std::vector<DocumentIndexMemoryManager::Usage> usages = {
+      {100, now_ms - 50000}, {100, now_ms - 90000}, {100, now_ms}, {0, now_ms - 99000}, {100, now_ms - 70000}};
+
+  // no limit
+  EXPECT_TRUE(DocumentIndexMemoryManager::SelectEvictions(usages, 0, 10000, now_ms).empty());
+  // within budget
+  EXPECT_TRUE(DocumentIndexMemoryManager::SelectEvictions(usages, 400, 10000, now_ms).empty());
+
+  // coldest first, skip the evicted
+  EXPECT_EQ(std::vector<size_t>({1, 4}), DocumentIndexMemoryManager::SelectEvictions(usages, 250, 10000, now_ms));
+
+  // the hot one is kept even over budget
+  EXPECT_EQ(std::vector<size_t>({1, 4, 0}), DocumentIndexMemoryManager::SelectEvictions(usages, 1, 10000, now_ms));
+}
+
+}  // namespace dingodb
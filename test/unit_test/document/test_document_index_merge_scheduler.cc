@@ -0,0 +1,55 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+
+#include "document/document_index_merge_scheduler.h"
+#include "gflags/gflags.h"
+
+namespace dingodb {
+
+DECLARE_int64(document_merge_bytes_per_second);
+
+TEST(DocumentIndexMergeSchedulerTest, ParseSegmentCount) {
+  EXPECT_EQ(2, DocumentIndexMergeScheduler::ParseSegmentCount(
+                   R"({"index_settings":{},"segments":[{"max_doc":10},{"max_doc":5}],"opstamp":3})"));
+  EXPECT_EQ(0, DocumentIndexMergeScheduler::ParseSegmentCount(R"({"segments":[]})"));
+  EXPECT_EQ(-1, DocumentIndexMergeScheduler::ParseSegmentCount(R"({"opstamp":3})"));
+  EXPECT_EQ(-1, DocumentIndexMergeScheduler::ParseSegmentCount("not json"));
+}
+
+TEST(DocumentIndexMergeSchedulerTest, Priority) {
+  // searched first
+  EXPECT_GT(DocumentIndexMergeScheduler::Priority(100.0, 4), DocumentIndexMergeScheduler::Priority(0.0, 4));
+  // fewer segments first
+  EXPECT_GT(DocumentIndexMergeScheduler::Priority(10.0, 2), DocumentIndexMergeScheduler::Priority(10.0, 20));
+}
+
+TEST(DocumentIndexMergeSchedulerTest, Budget) {
+  auto& scheduler = DocumentIndexMergeScheduler::GetInstance();
+
+  FLAGS_document_merge_bytes_per_second = 0;
+  EXPECT_TRUE(scheduler.Acquire(INT64_MAX / 2));
+
+  // raft apply commits use up the budget, queued commits wait
+  FLAGS_document_merge_bytes_per_second = 1000;
+  scheduler.Charge(1000 * 1000);
+  EXPECT_FALSE(scheduler.Acquire(10));
+
+  FLAGS_document_merge_bytes_per_second = 64 * 1024 * 1024;
+}
+
+}  // namespace dingodb
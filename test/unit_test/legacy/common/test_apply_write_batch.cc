@@ -0,0 +1,139 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "common/helper.h"
+#include "config/yaml_config.h"
+#include "engine/rocks_raw_engine.h"
+#include "handler/apply_write_batch.h"
+#include "proto/common.pb.h"
+#include "proto/error.pb.h"
+
+namespace dingodb {
+
+static const std::string kApplyWriteBatchRootPath = "./unit_test_apply_write_batch";
+static const std::string kDataCf = "default";
+static const std::string kLockCf = "meta";
+
+class ApplyWriteBatchTest : public testing::Test {
+ protected:
+  static void SetUpTestSuite() {
+    Helper::CreateDirectories(kApplyWriteBatchRootPath + "/db");
+
+    const std::string config_content = "store:\n  path: " + kApplyWriteBatchRootPath + "/db\n";
+    auto config = std::make_shared<YamlConfig>();
+    ASSERT_EQ(0, config->Load(config_content));
+
+    engine = std::make_shared<RocksRawEngine>();
+    ASSERT_TRUE(engine->Init(config, {kDataCf, kLockCf}));
+  }
+
+  static void TearDownTestSuite() {
+    engine->Close();
+    engine->Destroy();
+    Helper::RemoveAllFileOrDirectory(kApplyWriteBatchRootPath);
+  }
+
+  static pb::common::KeyValue Kv(const std::string& key, const std::string& value) {
+    pb::common::KeyValue kv;
+    kv.set_key(key);
+    kv.set_value(value);
+    return kv;
+  }
+
+  static std::shared_ptr<RocksRawEngine> engine;
+};
+
+std::shared_ptr<RocksRawEngine> ApplyWriteBatchTest::engine = nullptr;
+
+TEST_F(ApplyWriteBatchTest, LastWriteWin) {
+  ApplyWriteBatch write_batch(engine);
+  EXPECT_TRUE(write_batch.Empty());
+
+  // entry 1 put, entry 2 delete, entry 3 put again
+  write_batch.Put(kDataCf, Kv("key1", "v1"));
+  write_batch.Put(kDataCf, Kv("key2", "v2"));
+  write_batch.Delete(kDataCf, "key1");
+  write_batch.Put(kLockCf, Kv("key1", "lock"));
+  write_batch.Put(kDataCf, Kv("key2", "v22"));
+  EXPECT_EQ(3, write_batch.Count());
+
+  bool is_put = false;
+  ASSERT_TRUE(write_batch.Lookup(kDataCf, "key1", is_put));
+  EXPECT_FALSE(is_put);
+  ASSERT_TRUE(write_batch.Lookup(kDataCf, "key2", is_put));
+  EXPECT_TRUE(is_put);
+  EXPECT_FALSE(write_batch.Lookup(kDataCf, "key3", is_put));
+
+  // nothing written before commit
+  std::string value;
+  EXPECT_EQ(pb::error::EKEY_NOT_FOUND, engine->Reader()->KvGet(kDataCf, "key2", value).error_code());
+
+  int post_commit_count = 0;
+  write_batch.AddPostCommit([&post_commit_count]() { ++post_commit_count; });
+  ASSERT_TRUE(write_batch.Commit().ok());
+  EXPECT_EQ(1, post_commit_count);
+  EXPECT_TRUE(write_batch.Empty());
+  EXPECT_EQ(0, write_batch.Count());
+  EXPECT_EQ(0, write_batch.ByteSize());
+
+  auto reader = engine->Reader();
+  EXPECT_EQ(pb::error::EKEY_NOT_FOUND, reader->KvGet(kDataCf, "key1", value).error_code());
+  ASSERT_TRUE(reader->KvGet(kDataCf, "key2", value).ok());
+  EXPECT_EQ("v22", value);
+  ASSERT_TRUE(reader->KvGet(kLockCf, "key1", value).ok());
+  EXPECT_EQ("lock", value);
+}
+
+TEST_F(ApplyWriteBatchTest, DeleteCommitted) {
+  ApplyWriteBatch write_batch(engine);
+  write_batch.Put(kDataCf, Kv("key5", "v5"));
+  ASSERT_TRUE(write_batch.Commit().ok());
+
+  write_batch.Delete(kDataCf, "key5");
+  EXPECT_EQ(4, write_batch.ByteSize());
+  ASSERT_TRUE(write_batch.Commit().ok());
+
+  std::string value;
+  EXPECT_EQ(pb::error::EKEY_NOT_FOUND, engine->Reader()->KvGet(kDataCf, "key5", value).error_code());
+
+  // empty commit is ok
+  ASSERT_TRUE(write_batch.Commit().ok());
+}
+
+TEST_F(ApplyWriteBatchTest, LookupValue) {
+  ApplyWriteBatch write_batch(engine);
+  write_batch.Put(kDataCf, Kv("key6", "v6"));
+  write_batch.Delete(kDataCf, "key7");
+
+  // the conditional write sees the value not committed yet
+  std::optional<std::string> value;
+  ASSERT_TRUE(write_batch.Lookup(kDataCf, "key6", value));
+  ASSERT_TRUE(value.has_value());
+  EXPECT_EQ("v6", value.value());
+  ASSERT_TRUE(write_batch.Lookup(kDataCf, "key7", value));
+  EXPECT_FALSE(value.has_value());
+  EXPECT_FALSE(write_batch.Lookup(kLockCf, "key6", value));
+
+  ASSERT_TRUE(write_batch.Commit().ok());
+  EXPECT_FALSE(write_batch.Lookup(kDataCf, "key6", value));
+}
+
+}  // namespace dingodb
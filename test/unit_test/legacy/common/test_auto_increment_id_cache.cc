@@ -0,0 +1,155 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include "butil/status.h"
+#include "coordinator/auto_increment_id_cache.h"
+#include "proto/error.pb.h"
+
+namespace dingodb {
+
+// generate like AutoIncrementControl, [start_id, end_id) is generated and end_id is the next start_id
+class FakeCoordinator {
+ public:
+  FakeCoordinator(uint32_t increment, uint32_t offset) : increment_(increment), offset_(offset) {}
+
+  butil::Status Generate(uint32_t count, int64_t& start_id, int64_t& end_id) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (fail_) {
+      return butil::Status(pb::error::Errno::EINTERNAL, "generate failed");
+    }
+
+    ++generate_count_;
+    start_id = next_id_;
+    end_id = AutoIncrementIdCache::FirstId(next_id_, increment_, offset_) + count * increment_;
+    next_id_ = end_id;
+    return butil::Status::OK();
+  }
+
+  AutoIncrementIdCache::FetchFunc FetchFunc() {
+    return [this](uint32_t count, int64_t& start_id, int64_t& end_id) { return Generate(count, start_id, end_id); };
+  }
+
+  int64_t GenerateCount() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return generate_count_;
+  }
+
+  void SetFail(bool fail) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    fail_ = fail;
+  }
+
+ private:
+  uint32_t increment_;
+  uint32_t offset_;
+
+  std::mutex mutex_;
+  int64_t next_id_{1};
+  int64_t generate_count_{0};
+  bool fail_{false};
+};
+
+TEST(AutoIncrementIdCacheTest, FirstId) {
+  EXPECT_EQ(1, AutoIncrementIdCache::FirstId(1, 1, 1));
+  EXPECT_EQ(100, AutoIncrementIdCache::FirstId(100, 1, 1));
+  EXPECT_EQ(3, AutoIncrementIdCache::FirstId(1, 5, 3));
+  EXPECT_EQ(8, AutoIncrementIdCache::FirstId(4, 5, 3));
+  EXPECT_EQ(8, AutoIncrementIdCache::FirstId(8, 5, 3));
+}
+
+TEST(AutoIncrementIdCacheTest, Sequential) {
+  FakeCoordinator coordinator(1, 1);
+  AutoIncrementIdCache id_cache(coordinator.FetchFunc(), 100, 1, 1);
+
+  for (int64_t i = 1; i <= 1000; ++i) {
+    int64_t id = 0;
+    ASSERT_TRUE(id_cache.GenerateId(id).ok());
+    EXPECT_EQ(i, id);
+  }
+
+  EXPECT_GE(coordinator.GenerateCount(), 10);
+  EXPECT_LE(coordinator.GenerateCount(), 11);
+}
+
+TEST(AutoIncrementIdCacheTest, IncrementOffset) {
+  FakeCoordinator coordinator(5, 3);
+  AutoIncrementIdCache id_cache(coordinator.FetchFunc(), 10, 5, 3);
+
+  std::vector<int64_t> ids;
+  ASSERT_TRUE(id_cache.GenerateIds(100, ids).ok());
+  ASSERT_EQ(100, ids.size());
+  for (size_t i = 0; i < ids.size(); ++i) {
+    EXPECT_EQ(3, ids[i] % 5);
+    if (i > 0) {
+      EXPECT_GT(ids[i], ids[i - 1]);
+    }
+  }
+}
+
+TEST(AutoIncrementIdCacheTest, Error) {
+  FakeCoordinator coordinator(1, 1);
+  coordinator.SetFail(true);
+  AutoIncrementIdCache id_cache(coordinator.FetchFunc(), 10, 1, 1);
+
+  int64_t id = 0;
+  EXPECT_EQ(pb::error::Errno::EINTERNAL, id_cache.GenerateId(id).error_code());
+
+  coordinator.SetFail(false);
+  ASSERT_TRUE(id_cache.GenerateId(id).ok());
+  EXPECT_EQ(1, id);
+}
+
+TEST(AutoIncrementIdCacheTest, Concurrent) {
+  const int thread_num = 8;
+  const int req_num = 1000;
+
+  FakeCoordinator coordinator(1, 1);
+  AutoIncrementIdCache id_cache(coordinator.FetchFunc(), 64, 1, 1);
+
+  std::vector<std::vector<int64_t>> thread_ids(thread_num);
+  std::vector<std::thread> threads;
+  for (int i = 0; i < thread_num; ++i) {
+    threads.emplace_back([&, i]() {
+      for (int j = 0; j < req_num; ++j) {
+        int64_t id = 0;
+        EXPECT_TRUE(id_cache.GenerateId(id).ok());
+        thread_ids[i].push_back(id);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  std::set<int64_t> ids;
+  for (const auto& one_thread_ids : thread_ids) {
+    for (size_t i = 1; i < one_thread_ids.size(); ++i) {
+      EXPECT_GT(one_thread_ids[i], one_thread_ids[i - 1]);
+    }
+    ids.insert(one_thread_ids.begin(), one_thread_ids.end());
+  }
+  EXPECT_EQ(thread_num * req_num, ids.size());
+  EXPECT_LE(coordinator.GenerateCount(), thread_num * req_num / 64 + 2);
+}
+
+}  // namespace dingodb
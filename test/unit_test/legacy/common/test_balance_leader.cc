@@ -23,8 +23,12 @@
 #include "common/helper.h"
 #include "common/logging.h"
 #include "coordinator/balance_leader.h"
+#include "gflags/gflags.h"
 #include "proto/common.pb.h"
 
+DECLARE_uint32(balacne_leader_task_batch_size);
+DECLARE_uint32(balance_leader_max_task_batch_size);
+
 class CandidateStoresTest : public testing::Test {
  protected:
   void SetUp() override {}
@@ -412,4 +416,66 @@ TEST_F(BalanceLeaderSchedulerTest, ParseTimePeriod) {
     ASSERT_EQ(2, time_periods[0].first);
     ASSERT_EQ(4, time_periods[0].second);
   }
-}
\ No newline at end of file
+}
+
+TEST_F(BalanceLeaderSchedulerTest, HotStoreSchedule) {
+  // region | store-1 | store-2 | store-3
+  // 60001  | L       | F       | F
+  // ...
+  // 60006  | L       | F       | F
+  std::vector<RegionDistribution> region_distributions = {
+      {60001, {1001, 1002, 1003}}, {60002, {1001, 1002, 1003}}, {60003, {1001, 1002, 1003}},
+      {60004, {1001, 1002, 1003}}, {60005, {1001, 1002, 1003}}, {60006, {1001, 1002, 1003}},
+  };
+
+  dingodb::pb::common::StoreMap store_map = GenerateStoreMap(region_distributions);
+  dingodb::pb::common::RegionMap region_map = GenerateRegionMap(region_distributions);
+  std::shared_ptr<dingodb::CoordinatorControl> coordinator_control =
+      std::make_shared<MockCoordinatorControl>(GenerateRegionInternalMap(region_distributions));
+
+  std::vector<dingodb::balance::FilterPtr> store_filters;
+  std::vector<dingodb::balance::FilterPtr> region_filters;
+  std::vector<dingodb::balance::FilterPtr> task_filters;
+  std::vector<dingodb::balance::FilterPtr> resource_filters;
+  auto hot_store_scheduler = std::make_shared<dingodb::balance::HotStoreScheduler>(
+      coordinator_control, nullptr, store_filters, region_filters, task_filters, resource_filters, nullptr);
+
+  {
+    // no hot store
+    auto tasks = hot_store_scheduler->Schedule(region_map, store_map, {{1001, 5000}, {1002, 4000}, {1003, 4500}});
+    ASSERT_TRUE(tasks.empty());
+  }
+
+  {
+    // store-1 is hot, one leader(9000 / 6) moved to the coolest store-2 make it not hot
+    auto tasks = hot_store_scheduler->Schedule(region_map, store_map, {{1001, 9000}, {1002, 2000}, {1003, 3000}});
+    ASSERT_EQ(1, tasks.size());
+    ASSERT_EQ(1001, tasks[0]->source_store_id);
+    ASSERT_EQ(1002, tasks[0]->target_store_id);
+  }
+}
+
+TEST_F(BalanceLeaderSchedulerTest, CalcTaskBatchSize) {
+  FLAGS_balacne_leader_task_batch_size = 4;
+  FLAGS_balance_leader_max_task_batch_size = 32;
+
+  auto stores = GenerateStoreEntries(3);
+
+  // balanced, keep the min batch size
+  for (int i = 0; i < 30; ++i) {
+    stores[i % 3]->TestAddLeader(60000 + i);
+  }
+  ASSERT_EQ(4, dingodb::balance::BalanceLeaderScheduler::CalcTaskBatchSize(stores));
+
+  // store-0 has 10 + 30 leaders, average is 20, 20 leaders should be transferred out
+  for (int i = 0; i < 30; ++i) {
+    stores[0]->TestAddLeader(70000 + i);
+  }
+  ASSERT_EQ(20, dingodb::balance::BalanceLeaderScheduler::CalcTaskBatchSize(stores));
+
+  // limited by max batch size
+  for (int i = 0; i < 100; ++i) {
+    stores[0]->TestAddLeader(80000 + i);
+  }
+  ASSERT_EQ(32, dingodb::balance::BalanceLeaderScheduler::CalcTaskBatchSize(stores));
+}
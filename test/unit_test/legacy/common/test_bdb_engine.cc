@@ -31,13 +31,18 @@
 #include "config/yaml_config.h"
 #include "engine/bdb_raw_engine.h"
 #include "engine/snapshot.h"
+#include "fmt/core.h"
 #include "gflags/gflags.h"
 #include "proto/common.pb.h"
+#include "proto/error.pb.h"
 
 namespace dingodb {
 
 DEFINE_uint32(bdb_test_max_count, 30000, "bdb_test_max_count");
 
+DECLARE_bool(bdb_group_commit);
+DECLARE_bool(bdb_point_get_without_snapshot);
+
 static const std::string kDefaultCf = "default";
 
 static const std::string kTempDataDirectory = "./unit_test/bdb_unit_test";
@@ -1965,4 +1970,42 @@ TEST_F(RawBdbEngineTest, MaxTxnNums) {
   DINGO_LOG(ERROR) << "MaxTxnNums end";
 }
 
+TEST_F(RawBdbEngineTest, GroupCommit) {
+  FLAGS_bdb_group_commit = true;
+  FLAGS_bdb_point_get_without_snapshot = true;
+
+  const int thread_num = 8;
+  const int key_num = 100;
+  std::vector<std::thread> threads;
+  for (int i = 0; i < thread_num; ++i) {
+    threads.emplace_back([i]() {
+      auto writer = RawBdbEngineTest::engine->Writer();
+      for (int j = 0; j < key_num; ++j) {
+        pb::common::KeyValue kv;
+        kv.set_key(fmt::format("group_commit_{}_{}", i, j));
+        kv.set_value(fmt::format("value_{}_{}", i, j));
+        EXPECT_TRUE(writer->KvPut(kDefaultCf, kv).ok());
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  auto reader = RawBdbEngineTest::engine->Reader();
+  for (int i = 0; i < thread_num; ++i) {
+    for (int j = 0; j < key_num; ++j) {
+      std::string value;
+      ASSERT_TRUE(reader->KvGet(kDefaultCf, fmt::format("group_commit_{}_{}", i, j), value).ok());
+      EXPECT_EQ(fmt::format("value_{}_{}", i, j), value);
+    }
+  }
+
+  std::string value;
+  EXPECT_EQ(pb::error::EKEY_NOT_FOUND, reader->KvGet(kDefaultCf, "group_commit_not_exist", value).error_code());
+
+  FLAGS_bdb_group_commit = false;
+  FLAGS_bdb_point_get_without_snapshot = false;
+}
+
 }  // namespace dingodb
@@ -0,0 +1,187 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "butil/iobuf.h"
+#include "common/constant.h"
+#include "common/helper.h"
+#include "engine/change_capture.h"
+#include "proto/raft.pb.h"
+#include "proto/store.pb.h"
+
+namespace dingodb {
+
+static void AddTxnWrite(pb::raft::MultiCfPutAndDeleteRequest* request, const std::string& key, int64_t start_ts,
+                        int64_t commit_ts, pb::store::Op op, const std::string& short_value) {
+  pb::store::WriteInfo write_info;
+  write_info.set_start_ts(start_ts);
+  write_info.set_op(op);
+  write_info.set_short_value(short_value);
+
+  auto* puts = request->add_puts_with_cf();
+  puts->set_cf_name(Constant::kTxnWriteCF);
+  auto* kv = puts->add_kvs();
+  kv->set_key(Helper::EncodeTxnKey(key, commit_ts));
+  kv->set_value(write_info.SerializeAsString());
+}
+
+static void AddTxnData(pb::raft::MultiCfPutAndDeleteRequest* request, const std::string& key, int64_t start_ts,
+                       const std::string& value) {
+  auto* puts = request->add_puts_with_cf();
+  puts->set_cf_name(Constant::kTxnDataCF);
+  auto* kv = puts->add_kvs();
+  kv->set_key(Helper::EncodeTxnKey(key, start_ts));
+  kv->set_value(value);
+}
+
+TEST(ChangeCaptureTest, CollectRaw) {
+  pb::raft::Request req;
+  req.set_cmd_type(pb::raft::PUT);
+  req.mutable_put()->set_cf_name(Constant::kStoreDataCF);
+  auto* kv = req.mutable_put()->add_kvs();
+  kv->set_key("key1");
+  kv->set_value("value1");
+
+  std::vector<ChangeEvent> events;
+  ChangeCapture::Collect(req, 10, events);
+  ASSERT_EQ(1, events.size());
+  EXPECT_EQ(ChangeEvent::Type::kPut, events[0].type);
+  EXPECT_EQ(10, events[0].log_index);
+  EXPECT_EQ("key1", events[0].key);
+  EXPECT_EQ("value1", events[0].value);
+
+  req.Clear();
+  req.set_cmd_type(pb::raft::DELETEBATCH);
+  req.mutable_delete_batch()->set_cf_name(Constant::kStoreDataCF);
+  req.mutable_delete_batch()->add_keys("key1");
+  req.mutable_delete_batch()->add_keys("key2");
+  events.clear();
+  ChangeCapture::Collect(req, 11, events);
+  ASSERT_EQ(2, events.size());
+  EXPECT_EQ(ChangeEvent::Type::kDelete, events[1].type);
+  EXPECT_EQ("key2", events[1].key);
+
+  // other cf is not captured
+  req.mutable_delete_batch()->set_cf_name(Constant::kStoreMetaCF);
+  events.clear();
+  ChangeCapture::Collect(req, 12, events);
+  EXPECT_TRUE(events.empty());
+}
+
+TEST(ChangeCaptureTest, CollectTxn) {
+  pb::raft::Request prewrite_req;
+  prewrite_req.set_cmd_type(pb::raft::TXN);
+  auto* prewrite = prewrite_req.mutable_txn_raft_req()->mutable_multi_cf_put_and_delete();
+  AddTxnData(prewrite, "key1", 100, "long_value1");
+  AddTxnData(prewrite, "key2", 100, "long_value2");
+
+  pb::raft::Request commit_req;
+  commit_req.set_cmd_type(pb::raft::TXN);
+  auto* commit = commit_req.mutable_txn_raft_req()->mutable_multi_cf_put_and_delete();
+  AddTxnWrite(commit, "key1", 100, 101, pb::store::Op::Put, "");
+  AddTxnWrite(commit, "key2", 100, 101, pb::store::Op::Rollback, "");
+  AddTxnWrite(commit, "key3", 100, 101, pb::store::Op::Put, "short");
+  AddTxnWrite(commit, "key4", 100, 101, pb::store::Op::Delete, "");
+  AddTxnWrite(commit, "key5", 99, 101, pb::store::Op::Put, "");
+
+  std::map<std::string, std::string> prewrites;
+  int64_t prewrite_bytes = 0;
+
+  std::vector<ChangeEvent> events;
+  ChangeCapture::Collect(prewrite_req, 1, events);
+  ASSERT_EQ(2, events.size());
+  EXPECT_EQ(ChangeEvent::Type::kTxnPrewrite, events[0].type);
+  ChangeCapture::ResolveTxnValue(prewrites, prewrite_bytes, events);
+  EXPECT_TRUE(events.empty());
+  EXPECT_EQ(2, prewrites.size());
+  EXPECT_GT(prewrite_bytes, 0);
+
+  ChangeCapture::Collect(commit_req, 2, events);
+  ASSERT_EQ(5, events.size());
+  ChangeCapture::ResolveTxnValue(prewrites, prewrite_bytes, events);
+  ASSERT_EQ(4, events.size());
+
+  EXPECT_EQ(ChangeEvent::Type::kTxnPut, events[0].type);
+  EXPECT_EQ("key1", events[0].key);
+  EXPECT_EQ("long_value1", events[0].value);
+  EXPECT_EQ(100, events[0].start_ts);
+  EXPECT_EQ(101, events[0].commit_ts);
+  EXPECT_FALSE(events[0].value_missing);
+
+  EXPECT_EQ("short", events[1].value);
+  EXPECT_FALSE(events[1].value_missing);
+
+  EXPECT_EQ(ChangeEvent::Type::kTxnDelete, events[2].type);
+  EXPECT_EQ("key4", events[2].key);
+
+  // prewrite is not captured
+  EXPECT_EQ("key5", events[3].key);
+  EXPECT_TRUE(events[3].value_missing);
+
+  // committed and rollbacked prewrite are released
+  EXPECT_TRUE(prewrites.empty());
+  EXPECT_EQ(0, prewrite_bytes);
+}
+
+TEST(ChangeCaptureTest, CollectOnePc) {
+  pb::raft::Request req;
+  req.set_cmd_type(pb::raft::TXN);
+  auto* request = req.mutable_txn_raft_req()->mutable_multi_cf_put_and_delete();
+  // write cf goes before data cf in request
+  AddTxnWrite(request, "key1", 200, 201, pb::store::Op::Put, "");
+  AddTxnData(request, "key1", 200, "long_value1");
+
+  std::map<std::string, std::string> prewrites;
+  int64_t prewrite_bytes = 0;
+  std::vector<ChangeEvent> events;
+  ChangeCapture::Collect(req, 1, events);
+  ChangeCapture::ResolveTxnValue(prewrites, prewrite_bytes, events);
+  ASSERT_EQ(1, events.size());
+  EXPECT_EQ("long_value1", events[0].value);
+  EXPECT_TRUE(prewrites.empty());
+}
+
+TEST(ChangeCaptureTest, Encode) {
+  ChangeEvent event;
+  event.type = ChangeEvent::Type::kTxnPut;
+  event.log_index = 0x0102;
+  event.start_ts = 100;
+  event.commit_ts = 101;
+  event.key = "key";
+  event.value = "value";
+
+  butil::IOBuf buf;
+  event.EncodeTo(buf);
+  std::string data = buf.to_string();
+  ASSERT_EQ(1 + 8 * 3 + 1 + 4 + 3 + 4 + 5, data.size());
+  EXPECT_EQ(static_cast<char>(ChangeEvent::Type::kTxnPut), data[0]);
+  EXPECT_EQ(0x01, data[7]);
+  EXPECT_EQ(0x02, data[8]);
+  EXPECT_EQ(100, data[16]);
+  EXPECT_EQ(101, data[24]);
+  EXPECT_EQ(0, data[25]);
+  EXPECT_EQ(3, data[29]);
+  EXPECT_EQ("key", data.substr(30, 3));
+  EXPECT_EQ(5, data[36]);
+  EXPECT_EQ("value", data.substr(37));
+}
+
+}  // namespace dingodb
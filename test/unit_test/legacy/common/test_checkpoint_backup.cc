@@ -0,0 +1,115 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <gtest/gtest.h>
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "common/helper.h"
+#include "config/yaml_config.h"
+#include "engine/checkpoint_backup.h"
+#include "engine/rocks_raw_engine.h"
+#include "fmt/core.h"
+#include "gflags/gflags.h"
+#include "proto/common.pb.h"
+
+namespace dingodb {
+
+DECLARE_string(checkpoint_backup_tmp_dir);
+
+static const std::string kCheckpointBackupRootPath = "./unit_test_checkpoint_backup";
+static const std::string kDefaultCf = "default";
+
+static std::shared_ptr<RocksRawEngine> OpenEngine(const std::string& db_path) {
+  const std::string config_content = "store:\n  path: " + db_path + "\n";
+  auto config = std::make_shared<YamlConfig>();
+  EXPECT_EQ(0, config->Load(config_content));
+
+  auto engine = std::make_shared<RocksRawEngine>();
+  EXPECT_TRUE(engine->Init(config, {kDefaultCf}));
+  return engine;
+}
+
+static void Put(std::shared_ptr<RocksRawEngine> engine, int start, int end) {
+  std::vector<pb::common::KeyValue> kvs;
+  for (int i = start; i < end; ++i) {
+    pb::common::KeyValue kv;
+    kv.set_key(fmt::format("key{:06}", i));
+    kv.set_value(fmt::format("value{}", i));
+    kvs.push_back(kv);
+  }
+  ASSERT_TRUE(engine->Writer()->KvBatchPutAndDelete(kDefaultCf, kvs, {}).ok());
+  engine->Flush(kDefaultCf);
+}
+
+TEST(CheckpointBackupTest, FileList) {
+  EXPECT_TRUE(CheckpointBackup::IsSharedFile("000012.sst"));
+  EXPECT_TRUE(CheckpointBackup::IsSharedFile("000013.blob"));
+  EXPECT_FALSE(CheckpointBackup::IsSharedFile("MANIFEST-000005"));
+  EXPECT_FALSE(CheckpointBackup::IsSharedFile("000014.log"));
+
+  std::map<std::string, std::string> files = {{"000012.sst.100", "000012.sst"}, {"000013.blob.200", "000013.blob"}};
+  EXPECT_EQ(files, CheckpointBackup::DecodeFileList(CheckpointBackup::EncodeFileList(files)));
+  EXPECT_TRUE(CheckpointBackup::DecodeFileList("").empty());
+}
+
+TEST(CheckpointBackupTest, BackupAndRestore) {
+  Helper::RemoveAllFileOrDirectory(kCheckpointBackupRootPath);
+  FLAGS_checkpoint_backup_tmp_dir = kCheckpointBackupRootPath + "/tmp";
+  std::string backup_dir = kCheckpointBackupRootPath + "/backup";
+
+  auto engine = OpenEngine(kCheckpointBackupRootPath + "/db");
+  Put(engine, 0, 100);
+
+  std::string backup_name_1;
+  ASSERT_TRUE(CheckpointBackup::GetInstance().Backup(engine, backup_dir, backup_name_1).ok());
+  auto shared_files_1 = Helper::TraverseDirectory(backup_dir + "/sst", true, false);
+  EXPECT_FALSE(shared_files_1.empty());
+
+  // the second backup uploads the new sst only
+  Put(engine, 100, 200);
+  std::string backup_name_2;
+  ASSERT_TRUE(CheckpointBackup::GetInstance().Backup(engine, backup_dir, backup_name_2).ok());
+  auto shared_files_2 = Helper::TraverseDirectory(backup_dir + "/sst", true, false);
+  EXPECT_GT(shared_files_2.size(), shared_files_1.size());
+  EXPECT_EQ(2, CheckpointBackup::ListBackups(backup_dir).size());
+
+  engine->Close();
+
+  std::string restore_path = kCheckpointBackupRootPath + "/restore";
+  ASSERT_TRUE(CheckpointBackup::Restore(backup_dir, backup_name_2, restore_path, 4).ok());
+  // restore into non-empty directory is refused
+  EXPECT_FALSE(CheckpointBackup::Restore(backup_dir, backup_name_2, restore_path, 4).ok());
+
+  auto restored_engine = OpenEngine(restore_path);
+  std::string value;
+  ASSERT_TRUE(restored_engine->Reader()->KvGet(kDefaultCf, "key000000", value).ok());
+  EXPECT_EQ("value0", value);
+  ASSERT_TRUE(restored_engine->Reader()->KvGet(kDefaultCf, "key000199", value).ok());
+  EXPECT_EQ("value199", value);
+  restored_engine->Close();
+
+  // the shared files still referenced by the kept backup stay
+  CheckpointBackup::CleanExpiredBackups(backup_dir, 1);
+  EXPECT_EQ(1, CheckpointBackup::ListBackups(backup_dir).size());
+  EXPECT_FALSE(Helper::TraverseDirectory(backup_dir + "/sst", true, false).empty());
+
+  Helper::RemoveAllFileOrDirectory(kCheckpointBackupRootPath);
+}
+
+}  // namespace dingodb
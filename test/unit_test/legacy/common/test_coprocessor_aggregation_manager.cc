@@ -17,11 +17,14 @@
 #include <cstdint>
 #include <memory>
 #include <optional>
+#include <string>
+#include <utility>
 #include <vector>
 
 #include "butil/status.h"
 #include "coprocessor/aggregation_manager.h"
 #include "coprocessor/utils.h"
+#include "fmt/core.h"
 #include "proto/common.pb.h"
 #include "proto/store.pb.h"
 
@@ -2784,6 +2787,163 @@ TEST_F(CoprocessorAggregationManagerTest, Execute) {
   }
 }
 
+TEST_F(CoprocessorAggregationManagerTest, ManyGroups) {
+  google::protobuf::RepeatedPtrField<pb::common::Schema> pb_schemas;
+  for (auto type : {::dingodb::pb::common::Schema_Type::Schema_Type_LONG,
+                    ::dingodb::pb::common::Schema_Type::Schema_Type_LONG,
+                    ::dingodb::pb::common::Schema_Type::Schema_Type_STRING}) {
+    pb::common::Schema schema;
+    schema.set_type(type);
+    schema.set_is_key(false);
+    schema.set_is_nullable(true);
+    schema.set_index(pb_schemas.size());
+    pb_schemas.Add(std::move(schema));
+  }
+
+  std::shared_ptr<std::vector<std::shared_ptr<BaseSchema>>> result_serial_schemas =
+      std::make_shared<std::vector<std::shared_ptr<BaseSchema>>>();
+  butil::Status ok = Utils::TransToSerialSchema(pb_schemas, &result_serial_schemas);
+  EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
+
+  std::shared_ptr<std::vector<std::shared_ptr<BaseSchema>>> group_by_operator_serial_schemas =
+      std::make_shared<std::vector<std::shared_ptr<BaseSchema>>>();
+  ok = Utils::TransToSerialSchema(pb_schemas, &group_by_operator_serial_schemas);
+  EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
+
+  // SUM long, COUNT long, MAX string
+  ::google::protobuf::RepeatedPtrField<pb::store::AggregationOperator> aggregation_operators;
+  for (auto oper : {::dingodb::pb::store::AggregationType::SUM, ::dingodb::pb::store::AggregationType::COUNT,
+                    ::dingodb::pb::store::AggregationType::MAX}) {
+    pb::store::AggregationOperator aggregation_operator;
+    aggregation_operator.set_index_of_column(aggregation_operators.size());
+    aggregation_operator.set_oper(oper);
+    aggregation_operators.Add(std::move(aggregation_operator));
+  }
+
+  auto manager = std::make_shared<AggregationManager>();
+  ok = manager->Open(group_by_operator_serial_schemas, aggregation_operators, result_serial_schemas);
+  EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
+
+  // enough groups to grow the hash table several times
+  const int64_t group_num = 1000;
+  const int64_t round_num = 3;
+  for (int64_t round = 0; round < round_num; ++round) {
+    for (int64_t i = 0; i < group_num; ++i) {
+      std::vector<std::any> record;
+      record.emplace_back(std::optional<int64_t>(i));
+      record.emplace_back(round == 0 ? std::optional<int64_t>(std::nullopt) : std::optional<int64_t>(round));
+      record.emplace_back(
+          std::optional<std::shared_ptr<std::string>>(std::make_shared<std::string>(std::to_string(round))));
+
+      ok = manager->Execute(fmt::format("key{:06}", group_num - i), record);
+      EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
+    }
+  }
+
+  // wrong type
+  {
+    std::vector<std::any> record;
+    record.emplace_back(std::optional<int32_t>(1));
+    ok = manager->Execute("key", record);
+    EXPECT_EQ(ok.error_code(), pb::error::Errno::EILLEGAL_PARAMTETERS);
+  }
+
+  int64_t count = 0;
+  std::string last_key;
+  auto iter = manager->CreateIterator();
+  while (iter->HasNext()) {
+    const auto &key = iter->GetKey();
+    const auto &value = iter->GetValue();
+    EXPECT_LT(last_key, key);
+    last_key = key;
+
+    if (key != "key") {
+      int64_t i = group_num - std::stol(key.substr(3));
+      EXPECT_EQ(i * round_num, std::any_cast<std::optional<int64_t>>((*value)[0]).value());
+      EXPECT_EQ(round_num - 1, std::any_cast<std::optional<int64_t>>((*value)[1]).value());
+      EXPECT_EQ(std::to_string(round_num - 1),
+                *std::any_cast<std::optional<std::shared_ptr<std::string>>>((*value)[2]).value());
+      ++count;
+    }
+    iter->Next();
+  }
+  EXPECT_EQ(group_num, count);
+
+  manager->Close();
+}
+
+TEST_F(CoprocessorAggregationManagerTest, Flush) {
+  google::protobuf::RepeatedPtrField<pb::common::Schema> pb_schemas;
+  {
+    pb::common::Schema schema;
+    schema.set_type(::dingodb::pb::common::Schema_Type::Schema_Type_LONG);
+    schema.set_is_key(false);
+    schema.set_is_nullable(true);
+    schema.set_index(0);
+    pb_schemas.Add(std::move(schema));
+  }
+
+  std::shared_ptr<std::vector<std::shared_ptr<BaseSchema>>> result_serial_schemas =
+      std::make_shared<std::vector<std::shared_ptr<BaseSchema>>>();
+  butil::Status ok = Utils::TransToSerialSchema(pb_schemas, &result_serial_schemas);
+  EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
+
+  std::shared_ptr<std::vector<std::shared_ptr<BaseSchema>>> group_by_operator_serial_schemas =
+      std::make_shared<std::vector<std::shared_ptr<BaseSchema>>>();
+  ok = Utils::TransToSerialSchema(pb_schemas, &group_by_operator_serial_schemas);
+  EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
+
+  ::google::protobuf::RepeatedPtrField<pb::store::AggregationOperator> aggregation_operators;
+  {
+    pb::store::AggregationOperator aggregation_operator;
+    aggregation_operator.set_index_of_column(0);
+    aggregation_operator.set_oper(::dingodb::pb::store::AggregationType::SUM);
+    aggregation_operators.Add(std::move(aggregation_operator));
+  }
+
+  auto manager = std::make_shared<AggregationManager>();
+  ok = manager->Open(group_by_operator_serial_schemas, aggregation_operators, result_serial_schemas);
+  EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
+
+  auto execute = [&](const std::string &key, int64_t value) {
+    std::vector<std::any> record;
+    record.emplace_back(std::optional<int64_t>(value));
+    EXPECT_EQ(manager->Execute(key, record).error_code(), pb::error::Errno::OK);
+  };
+
+  execute("a", 1);
+  execute("b", 2);
+  execute("a", 3);
+  EXPECT_EQ(2, manager->GroupCount());
+
+  auto partial = manager->Flush();
+  EXPECT_EQ(0, manager->GroupCount());
+
+  // the flushed groups are not changed by rows executed after flush
+  execute("a", 10);
+  EXPECT_EQ(1, manager->GroupCount());
+
+  std::vector<std::pair<std::string, int64_t>> results;
+  for (; partial->HasNext(); partial->Next()) {
+    results.emplace_back(partial->GetKey(),
+                         std::any_cast<std::optional<int64_t>>((*partial->GetValue())[0]).value());
+  }
+  ASSERT_EQ(2, results.size());
+  EXPECT_EQ("a", results[0].first);
+  EXPECT_EQ(4, results[0].second);
+  EXPECT_EQ("b", results[1].first);
+  EXPECT_EQ(2, results[1].second);
+
+  auto rest = manager->CreateIterator();
+  ASSERT_TRUE(rest->HasNext());
+  EXPECT_EQ("a", rest->GetKey());
+  EXPECT_EQ(10, std::any_cast<std::optional<int64_t>>((*rest->GetValue())[0]).value());
+  rest->Next();
+  EXPECT_FALSE(rest->HasNext());
+
+  manager->Close();
+}
+
 TEST_F(CoprocessorAggregationManagerTest, CreateIterator) {
   std::shared_ptr<AggregationIterator> iter = aggregation_manager->CreateIterator();
   while (iter->HasNext()) {
@@ -0,0 +1,102 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "coprocessor/coprocessor_plan_cache.h"
+#include "gflags/gflags.h"
+#include "proto/common.pb.h"
+
+namespace dingodb {
+
+DECLARE_int64(coprocessor_v2_plan_cache_capacity);
+
+static pb::common::CoprocessorV2 NewCoprocessor(int32_t schema_version) {
+  pb::common::CoprocessorV2 coprocessor;
+  coprocessor.set_schema_version(schema_version);
+  coprocessor.mutable_original_schema()->set_common_id(1);
+  auto* schema = coprocessor.mutable_original_schema()->add_schema();
+  schema->set_type(pb::common::Schema_Type::Schema_Type_LONG);
+  schema->set_index(0);
+  coprocessor.add_selection_columns(0);
+  coprocessor.mutable_result_schema()->set_common_id(1);
+  *coprocessor.mutable_result_schema()->add_schema() = *schema;
+  coprocessor.set_rel_expr("rel_expr");
+  return coprocessor;
+}
+
+TEST(CoprocessorV2PlanCacheTest, Fingerprint) {
+  auto coprocessor = NewCoprocessor(1);
+  auto fingerprint = CoprocessorV2PlanCache::Fingerprint(coprocessor);
+
+  // rel expr is not a part of plan
+  coprocessor.set_rel_expr("other_rel_expr");
+  EXPECT_EQ(fingerprint, CoprocessorV2PlanCache::Fingerprint(coprocessor));
+
+  EXPECT_NE(fingerprint, CoprocessorV2PlanCache::Fingerprint(NewCoprocessor(2)));
+
+  coprocessor = NewCoprocessor(1);
+  coprocessor.add_selection_columns(0);
+  EXPECT_NE(fingerprint, CoprocessorV2PlanCache::Fingerprint(coprocessor));
+
+  coprocessor = NewCoprocessor(1);
+  coprocessor.mutable_original_schema()->set_common_id(2);
+  EXPECT_NE(fingerprint, CoprocessorV2PlanCache::Fingerprint(coprocessor));
+
+  coprocessor = NewCoprocessor(1);
+  coprocessor.mutable_result_schema()->mutable_schema(0)->set_type(pb::common::Schema_Type::Schema_Type_DOUBLE);
+  EXPECT_NE(fingerprint, CoprocessorV2PlanCache::Fingerprint(coprocessor));
+}
+
+TEST(CoprocessorV2PlanCacheTest, GetPut) {
+  int64_t old_capacity = FLAGS_coprocessor_v2_plan_cache_capacity;
+  FLAGS_coprocessor_v2_plan_cache_capacity = 2;
+
+  auto& cache = CoprocessorV2PlanCache::GetInstance();
+  cache.Clear();
+
+  auto plan1 = std::make_shared<CoprocessorV2Plan>();
+  plan1->original_column_indexes = {0};
+  auto plan2 = std::make_shared<CoprocessorV2Plan>();
+  auto plan3 = std::make_shared<CoprocessorV2Plan>();
+
+  EXPECT_EQ(nullptr, cache.Get("plan1"));
+  cache.Put("plan1", plan1);
+  cache.Put("plan2", plan2);
+  EXPECT_EQ(2, cache.Count());
+  EXPECT_EQ(plan1, cache.Get("plan1"));
+
+  // plan2 is the least recently used
+  cache.Put("plan3", plan3);
+  EXPECT_EQ(2, cache.Count());
+  EXPECT_EQ(nullptr, cache.Get("plan2"));
+  EXPECT_EQ(plan1, cache.Get("plan1"));
+  EXPECT_EQ(plan3, cache.Get("plan3"));
+
+  // replace
+  cache.Put("plan1", plan2);
+  EXPECT_EQ(2, cache.Count());
+  EXPECT_EQ(plan2, cache.Get("plan1"));
+
+  cache.Clear();
+  EXPECT_EQ(0, cache.Count());
+  FLAGS_coprocessor_v2_plan_cache_capacity = old_capacity;
+}
+
+}  // namespace dingodb
@@ -20,6 +20,14 @@
 #include <thread>
 
 #include "crontab/crontab.h"
+#include "gflags/gflags.h"
+
+namespace dingodb {
+DECLARE_bool(enable_crontab_load_aware_schedule);
+DECLARE_double(crontab_heavy_jitter_ratio);
+DECLARE_int64(crontab_heavy_defer_queue_wait_us);
+DECLARE_uint32(crontab_heavy_max_defer_count);
+}  // namespace dingodb
 
 class CrontabManagerTest : public testing::Test {
  protected:
@@ -92,3 +100,40 @@ TEST(CrontabManagerTest, pause) {
   EXPECT_EQ("", str);
   crontab_manager.Destroy();
 }
+
+TEST(CrontabManagerTest, load_aware_schedule) {
+  dingodb::Crontab crontab;
+  crontab.interval = 10000;
+  crontab.cost = dingodb::CrontabCost::kHeavy;
+  int64_t queue_wait_us = 0;
+  crontab.load_probe = [&queue_wait_us]() -> int64_t { return queue_wait_us; };
+
+  // disabled
+  EXPECT_EQ(10000, dingodb::CrontabManager::NextDelay(crontab));
+  queue_wait_us = INT64_MAX;
+  EXPECT_FALSE(dingodb::CrontabManager::ShouldDefer(crontab));
+
+  dingodb::FLAGS_enable_crontab_load_aware_schedule = true;
+  dingodb::FLAGS_crontab_heavy_jitter_ratio = 0.1;
+  for (int i = 0; i < 100; ++i) {
+    int64_t delay = dingodb::CrontabManager::NextDelay(crontab);
+    EXPECT_GE(delay, 9000);
+    EXPECT_LE(delay, 11000);
+  }
+
+  // busy foreground
+  EXPECT_TRUE(dingodb::CrontabManager::ShouldDefer(crontab));
+  crontab.defer_count = dingodb::FLAGS_crontab_heavy_max_defer_count;
+  EXPECT_FALSE(dingodb::CrontabManager::ShouldDefer(crontab));
+  crontab.defer_count = 0;
+  queue_wait_us = 0;
+  EXPECT_FALSE(dingodb::CrontabManager::ShouldDefer(crontab));
+
+  // light crontab is not affected
+  crontab.cost = dingodb::CrontabCost::kLight;
+  queue_wait_us = INT64_MAX;
+  EXPECT_EQ(10000, dingodb::CrontabManager::NextDelay(crontab));
+  EXPECT_FALSE(dingodb::CrontabManager::ShouldDefer(crontab));
+
+  dingodb::FLAGS_enable_crontab_load_aware_schedule = false;
+}
@@ -0,0 +1,48 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "common/dirty_index_queue.h"
+
+namespace dingodb {
+
+TEST(DirtyIndexQueueTest, MarkAndPop) {
+  DirtyIndexQueue queue;
+  EXPECT_TRUE(queue.Pop(10).empty());
+
+  queue.Mark(1, 100);
+  queue.Mark(2, 300);
+  queue.Mark(3, 200);
+  // keep the larger priority
+  queue.Mark(1, 50);
+  queue.Mark(3, 400);
+  EXPECT_EQ(3, queue.Size());
+
+  auto ids = queue.Pop(2);
+  EXPECT_EQ((std::vector<int64_t>{3, 2}), ids);
+  EXPECT_EQ(1, queue.Size());
+
+  queue.Mark(4, 10);
+  queue.Remove(1);
+  ids = queue.Pop(0);
+  EXPECT_EQ((std::vector<int64_t>{4}), ids);
+  EXPECT_EQ(0, queue.Size());
+}
+
+}  // namespace dingodb
@@ -0,0 +1,120 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "document/document_search_cache.h"
+#include "proto/common.pb.h"
+
+namespace dingodb {
+
+class DocumentSearchCacheTest : public testing::Test {
+ protected:
+  static std::string Fingerprint(int64_t index_id, const std::string& query_string, uint32_t topk) {
+    pb::common::Range range;
+    range.set_start_key("a");
+    range.set_end_key("z");
+
+    pb::common::DocumentSearchParameter parameter;
+    parameter.set_top_n(topk);
+    parameter.set_query_string(query_string);
+
+    return DocumentSearchCache::Fingerprint(index_id, range, parameter);
+  }
+
+  static std::vector<pb::common::DocumentWithScore> Results(int64_t document_id) {
+    std::vector<pb::common::DocumentWithScore> results(1);
+    results[0].mutable_document_with_id()->set_id(document_id);
+    results[0].set_score(0.5F);
+    return results;
+  }
+};
+
+TEST_F(DocumentSearchCacheTest, NormalizeQuery) {
+  EXPECT_EQ("", DocumentSearchCache::NormalizeQuery(""));
+  EXPECT_EQ("", DocumentSearchCache::NormalizeQuery("  \t "));
+  EXPECT_EQ("text:hello", DocumentSearchCache::NormalizeQuery(" text:hello\n"));
+  EXPECT_EQ("text:hello AND col:world", DocumentSearchCache::NormalizeQuery("text:hello   AND\tcol:world"));
+}
+
+TEST_F(DocumentSearchCacheTest, Fingerprint) {
+  EXPECT_EQ(Fingerprint(1, "text:hello", 10), Fingerprint(1, "  text:hello ", 10));
+  EXPECT_NE(Fingerprint(1, "text:hello", 10), Fingerprint(2, "text:hello", 10));
+  EXPECT_NE(Fingerprint(1, "text:hello", 10), Fingerprint(1, "text:world", 10));
+  EXPECT_NE(Fingerprint(1, "text:hello", 10), Fingerprint(1, "text:hello", 20));
+
+  // scalar data selection not change the tantivy result
+  pb::common::Range range;
+  pb::common::DocumentSearchParameter parameter;
+  parameter.set_query_string("text:hello");
+  auto fingerprint = DocumentSearchCache::Fingerprint(1, range, parameter);
+  parameter.set_without_scalar_data(true);
+  EXPECT_EQ(fingerprint, DocumentSearchCache::Fingerprint(1, range, parameter));
+}
+
+TEST_F(DocumentSearchCacheTest, GetPut) {
+  DocumentSearchCache cache(1024 * 1024, 4);
+  auto fingerprint = Fingerprint(1, "text:hello", 10);
+  DocumentSearchCache::Version version{100, 0};
+
+  std::vector<pb::common::DocumentWithScore> results;
+  EXPECT_FALSE(cache.Get(fingerprint, version, results));
+
+  cache.Put(fingerprint, version, Results(7));
+  ASSERT_TRUE(cache.Get(fingerprint, version, results));
+  ASSERT_EQ(1, results.size());
+  EXPECT_EQ(7, results[0].document_with_id().id());
+  EXPECT_EQ(1, cache.Count());
+
+  // index committed, stale entry is dropped
+  results.clear();
+  EXPECT_FALSE(cache.Get(fingerprint, DocumentSearchCache::Version{101, 0}, results));
+  EXPECT_EQ(0, cache.Count());
+  EXPECT_EQ(0, cache.MemorySize());
+
+  cache.Put(fingerprint, version, Results(7));
+  EXPECT_FALSE(cache.Get(fingerprint, DocumentSearchCache::Version{100, 5}, results));
+}
+
+TEST_F(DocumentSearchCacheTest, Evict) {
+  DocumentSearchCache::Version version{1, 0};
+
+  DocumentSearchCache probe(1024 * 1024, 1);
+  probe.Put(Fingerprint(1, "q0", 10), version, Results(0));
+  int64_t entry_bytes = probe.MemorySize();
+  ASSERT_GT(entry_bytes, 0);
+
+  DocumentSearchCache cache(entry_bytes * 3 + entry_bytes / 2, 1);
+  for (int i = 0; i < 10; ++i) {
+    cache.Put(Fingerprint(1, "q" + std::to_string(i), 10), version, Results(i));
+  }
+  EXPECT_EQ(3, cache.Count());
+
+  std::vector<pb::common::DocumentWithScore> results;
+  EXPECT_FALSE(cache.Get(Fingerprint(1, "q0", 10), version, results));
+  EXPECT_TRUE(cache.Get(Fingerprint(1, "q9", 10), version, results));
+
+  // recently used survives
+  EXPECT_TRUE(cache.Get(Fingerprint(1, "q7", 10), version, results));
+  cache.Put(Fingerprint(1, "q10", 10), version, Results(10));
+  EXPECT_TRUE(cache.Get(Fingerprint(1, "q7", 10), version, results));
+  EXPECT_FALSE(cache.Get(Fingerprint(1, "q8", 10), version, results));
+}
+
+}  // namespace dingodb
@@ -0,0 +1,104 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <mutex>
+
+#include "engine/flushed_applied_index_tracker.h"
+
+namespace dingodb {
+
+class FlushedAppliedIndexTrackerTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    tracker.SetSequenceFunc([this]() -> uint64_t { return seqno.load(); });
+    tracker.SetPersistFunc([this](int64_t region_id, int64_t, int64_t applied_index) {
+      std::lock_guard<std::mutex> lock(mutex);
+      auto& persisted_index = persisteds[region_id];
+      persisted_index = std::max(persisted_index, applied_index);
+    });
+  }
+
+  int64_t Persisted(int64_t region_id) {
+    std::lock_guard<std::mutex> lock(mutex);
+    return persisteds[region_id];
+  }
+
+  FlushedAppliedIndexTracker tracker;
+  std::atomic<uint64_t> seqno{0};
+  std::mutex mutex;
+  std::map<int64_t, int64_t> persisteds;
+};
+
+TEST_F(FlushedAppliedIndexTrackerTest, PersistAfterFlush) {
+  seqno = 100;
+  tracker.Record(1, 1, 10);
+  seqno = 200;
+  tracker.Record(1, 1, 20);
+  tracker.Record(2, 1, 30);
+  EXPECT_EQ(3, tracker.PendingCount());
+  EXPECT_FALSE(tracker.IsFlushed(1, 10));
+  EXPECT_EQ(0, Persisted(1));
+
+  // only the data of index 10 is flushed
+  EXPECT_TRUE(tracker.OnFlushCompleted(150));
+  tracker.PersistFlushed();
+  EXPECT_TRUE(tracker.IsFlushed(1, 10));
+  EXPECT_FALSE(tracker.IsFlushed(1, 20));
+  EXPECT_FALSE(tracker.IsFlushed(2, 30));
+  EXPECT_EQ(2, tracker.PendingCount());
+
+  tracker.OnFlushCompleted(200);
+  tracker.PersistFlushed();
+  EXPECT_TRUE(tracker.IsFlushed(1, 20));
+  EXPECT_TRUE(tracker.IsFlushed(2, 30));
+  EXPECT_EQ(0, tracker.PendingCount());
+
+  // smaller flushed seqno not go back
+  EXPECT_FALSE(tracker.OnFlushCompleted(120));
+  seqno = 201;
+  tracker.Record(1, 2, 40);
+  tracker.PersistFlushed();
+  EXPECT_FALSE(tracker.IsFlushed(1, 40));
+}
+
+TEST_F(FlushedAppliedIndexTrackerTest, NoWriteSinceFlush) {
+  seqno = 100;
+  tracker.OnFlushCompleted(100);
+  tracker.PersistFlushed();
+
+  // data already in sst, persist in place
+  tracker.Record(1, 1, 10);
+  EXPECT_TRUE(tracker.IsFlushed(1, 10));
+  EXPECT_EQ(10, Persisted(1));
+  EXPECT_EQ(0, tracker.PendingCount());
+}
+
+TEST_F(FlushedAppliedIndexTrackerTest, SameSeqno) {
+  seqno = 100;
+  tracker.Record(1, 1, 10);
+  tracker.Record(1, 1, 20);
+  EXPECT_EQ(1, tracker.PendingCount());
+
+  tracker.Erase(1);
+  EXPECT_EQ(0, tracker.PendingCount());
+  EXPECT_FALSE(tracker.IsFlushed(1, 10));
+}
+
+}  // namespace dingodb
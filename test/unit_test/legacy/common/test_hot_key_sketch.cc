@@ -0,0 +1,72 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "fmt/core.h"
+#include "split/hot_key_sketch.h"
+
+namespace dingodb {
+
+TEST(HotKeySketchTest, TopK) {
+  HotKeySketch sketch(8);
+
+  // two heavy keys among many cold keys
+  for (int i = 0; i < 1000; ++i) {
+    sketch.Add("hot_a");
+    if (i % 2 == 0) {
+      sketch.Add("hot_b");
+    }
+    sketch.Add(fmt::format("cold_{}", i));
+  }
+
+  EXPECT_EQ(8, sketch.Size());
+  EXPECT_EQ(2500, sketch.TotalCount());
+
+  auto top = sketch.TopK(2);
+  ASSERT_EQ(2, top.size());
+  EXPECT_EQ("hot_a", top[0].key);
+  EXPECT_EQ("hot_b", top[1].key);
+  // count is overestimated by at most error
+  EXPECT_LE(top[0].count - top[0].error, 1000);
+  EXPECT_GE(top[0].count, 1000);
+
+  EXPECT_EQ(8, sketch.TopK(100).size());
+}
+
+TEST(HotKeySketchTest, Decay) {
+  HotKeySketch sketch(4);
+  for (int i = 0; i < 10; ++i) {
+    sketch.Add("a");
+  }
+  sketch.Add("b");
+
+  sketch.Decay();
+  auto top = sketch.TopK(4);
+  ASSERT_EQ(1, top.size());
+  EXPECT_EQ("a", top[0].key);
+  EXPECT_EQ(5, top[0].count);
+  EXPECT_EQ(5, sketch.TotalCount());
+
+  // index is rebuilt after decay
+  sketch.Add("a", 3);
+  EXPECT_EQ(8, sketch.TopK(1)[0].count);
+}
+
+}  // namespace dingodb
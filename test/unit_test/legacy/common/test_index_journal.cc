@@ -0,0 +1,204 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "common/helper.h"
+#include "log/index_journal.h"
+#include "proto/raft.pb.h"
+
+namespace dingodb {
+
+static const std::string kIndexJournalPath = "./unit_test/index_journal";
+
+class IndexJournalTest : public testing::Test {
+ protected:
+  void SetUp() override { Helper::CreateDirectories(kIndexJournalPath); }
+  void TearDown() override { Helper::RemoveAllFileOrDirectory(kIndexJournalPath); }
+};
+
+static pb::raft::RaftCmdRequest GenVectorAdd(int64_t id) {
+  pb::raft::RaftCmdRequest raft_cmd;
+  auto* request = raft_cmd.add_requests();
+  request->set_cmd_type(pb::raft::VECTOR_ADD);
+  auto* vector = request->mutable_vector_add()->add_vectors();
+  vector->set_id(id);
+  vector->mutable_vector()->add_float_values(1.0f);
+  vector->mutable_scalar_data()->mutable_scalar_data()->insert({"key", pb::common::ScalarValue()});
+  return raft_cmd;
+}
+
+static pb::raft::RaftCmdRequest ExtractIndexRequests(const pb::raft::RaftCmdRequest& raft_cmd) {
+  pb::raft::RaftCmdRequest requests;
+  IndexJournal::ExtractIndexRequests(raft_cmd, requests);
+  return requests;
+}
+
+TEST_F(IndexJournalTest, ExtractIndexRequests) {
+  auto raft_cmd = GenVectorAdd(1);
+  raft_cmd.add_requests()->set_cmd_type(pb::raft::PUT);
+  auto* request = raft_cmd.add_requests();
+  request->set_cmd_type(pb::raft::VECTOR_DELETE);
+  request->mutable_vector_delete()->add_ids(2);
+
+  pb::raft::RaftCmdRequest requests;
+  ASSERT_TRUE(IndexJournal::ExtractIndexRequests(raft_cmd, requests));
+  ASSERT_EQ(2, requests.requests_size());
+  ASSERT_EQ(1, requests.requests(0).vector_add().vectors(0).id());
+  ASSERT_EQ(1, requests.requests(0).vector_add().vectors(0).vector().float_values_size());
+  // scalar data is not used by index
+  ASSERT_FALSE(requests.requests(0).vector_add().vectors(0).has_scalar_data());
+  ASSERT_EQ(2, requests.requests(1).vector_delete().ids(0));
+
+  pb::raft::RaftCmdRequest put_cmd;
+  put_cmd.add_requests()->set_cmd_type(pb::raft::PUT);
+  pb::raft::RaftCmdRequest put_requests;
+  ASSERT_FALSE(IndexJournal::ExtractIndexRequests(put_cmd, put_requests));
+}
+
+TEST_F(IndexJournalTest, AppendRead) {
+  std::string path = kIndexJournalPath + "/1.journal";
+  IndexJournal journal(1, path);
+  ASSERT_TRUE(journal.Init(10));
+  ASSERT_EQ(10, journal.CoveredLogId());
+
+  // before covered and reapplied log are ignored
+  ASSERT_TRUE(journal.Append(9, ExtractIndexRequests(GenVectorAdd(9))));
+  for (int64_t log_id = 10; log_id < 20; ++log_id) {
+    ASSERT_TRUE(journal.Append(log_id, ExtractIndexRequests(GenVectorAdd(log_id))));
+  }
+  ASSERT_TRUE(journal.Append(15, ExtractIndexRequests(GenVectorAdd(15))));
+  ASSERT_TRUE(journal.Sync());
+  ASSERT_EQ(10, journal.RecordCount());
+  ASSERT_EQ(19, journal.LastLogId());
+
+  std::vector<std::pair<int64_t, pb::raft::RaftCmdRequest>> records;
+  ASSERT_TRUE(journal.Read(12, 14, records).ok());
+  ASSERT_EQ(3, records.size());
+  ASSERT_EQ(12, records[0].first);
+  ASSERT_EQ(12, records[0].second.requests(0).vector_add().vectors(0).id());
+  ASSERT_EQ(14, records[2].first);
+
+  // not covered
+  records.clear();
+  ASSERT_FALSE(journal.Read(5, 14, records).ok());
+
+  // index from log 12 need no raft log, index from log 5 need all
+  ASSERT_EQ(INT64_MAX, journal.RequiredRaftLogId(12));
+  ASSERT_EQ(5, journal.RequiredRaftLogId(5));
+}
+
+TEST_F(IndexJournalTest, TruncatePrefix) {
+  std::string path = kIndexJournalPath + "/2.journal";
+  IndexJournal journal(2, path);
+  ASSERT_TRUE(journal.Init(1));
+  for (int64_t log_id = 1; log_id <= 10; ++log_id) {
+    ASSERT_TRUE(journal.Append(log_id, ExtractIndexRequests(GenVectorAdd(log_id))));
+  }
+
+  ASSERT_TRUE(journal.TruncatePrefix(8));
+  ASSERT_EQ(8, journal.CoveredLogId());
+  ASSERT_EQ(3, journal.RecordCount());
+
+  // append after rewrite
+  ASSERT_TRUE(journal.Append(11, ExtractIndexRequests(GenVectorAdd(11))));
+  std::vector<std::pair<int64_t, pb::raft::RaftCmdRequest>> records;
+  ASSERT_TRUE(journal.Read(8, 11, records).ok());
+  ASSERT_EQ(4, records.size());
+  ASSERT_EQ(11, records[3].second.requests(0).vector_add().vectors(0).id());
+
+  ASSERT_TRUE(journal.Reset(100));
+  ASSERT_EQ(100, journal.CoveredLogId());
+  ASSERT_EQ(0, journal.RecordCount());
+}
+
+TEST_F(IndexJournalTest, Reload) {
+  std::string path = kIndexJournalPath + "/3.journal";
+  {
+    IndexJournal journal(3, path);
+    ASSERT_TRUE(journal.Init(1));
+    for (int64_t log_id = 1; log_id <= 10; ++log_id) {
+      ASSERT_TRUE(journal.Append(log_id, ExtractIndexRequests(GenVectorAdd(log_id))));
+    }
+    ASSERT_TRUE(journal.Sync());
+  }
+
+  // broken tail
+  {
+    FILE* file = fopen(path.c_str(), "ab");
+    ASSERT_TRUE(file != nullptr);
+    fwrite("broken", 1, 6, file);
+    fclose(file);
+  }
+
+  IndexJournal journal(3, path);
+  ASSERT_TRUE(journal.Init(0));
+  ASSERT_EQ(1, journal.CoveredLogId());
+  ASSERT_EQ(10, journal.RecordCount());
+
+  // the log after last record may be lost at crash, raft log keep them
+  ASSERT_EQ(11, journal.RequiredRaftLogId(5));
+  ASSERT_TRUE(journal.Append(15, ExtractIndexRequests(GenVectorAdd(15))));
+  ASSERT_EQ(11, journal.RequiredRaftLogId(5));
+  ASSERT_EQ(INT64_MAX, journal.RequiredRaftLogId(16));
+
+  // index snapshot pass the hole
+  ASSERT_TRUE(journal.TruncatePrefix(15));
+  ASSERT_EQ(INT64_MAX, journal.RequiredRaftLogId(15));
+
+  std::vector<std::pair<int64_t, pb::raft::RaftCmdRequest>> records;
+  ASSERT_TRUE(journal.Read(15, 15, records).ok());
+  ASSERT_EQ(1, records.size());
+}
+
+TEST_F(IndexJournalTest, ReloadTwice) {
+  std::string path = kIndexJournalPath + "/4.journal";
+  {
+    IndexJournal journal(4, path);
+    ASSERT_TRUE(journal.Init(1));
+    for (int64_t log_id = 1; log_id <= 10; ++log_id) {
+      ASSERT_TRUE(journal.Append(log_id, ExtractIndexRequests(GenVectorAdd(log_id))));
+    }
+    ASSERT_TRUE(journal.Sync());
+  }
+
+  // crash again after the hole [11, 14]
+  {
+    IndexJournal journal(4, path);
+    ASSERT_TRUE(journal.Init(0));
+    ASSERT_TRUE(journal.Append(15, ExtractIndexRequests(GenVectorAdd(15))));
+    ASSERT_TRUE(journal.Sync());
+  }
+
+  // the first hole is not forgotten
+  IndexJournal journal(4, path);
+  ASSERT_TRUE(journal.Init(0));
+  ASSERT_EQ(11, journal.RecordCount());
+  ASSERT_EQ(11, journal.RequiredRaftLogId(5));
+  ASSERT_TRUE(journal.Append(20, ExtractIndexRequests(GenVectorAdd(20))));
+  ASSERT_EQ(11, journal.RequiredRaftLogId(5));
+  ASSERT_EQ(INT64_MAX, journal.RequiredRaftLogId(20));
+
+  // index snapshot pass both holes
+  ASSERT_TRUE(journal.TruncatePrefix(20));
+  ASSERT_EQ(INT64_MAX, journal.RequiredRaftLogId(20));
+}
+
+}  // namespace dingodb
@@ -0,0 +1,108 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "common/helper.h"
+#include "common/key_codec.h"
+#include "serial/buf.h"
+#include "serial/schema/long_schema.h"
+
+namespace dingodb {
+
+static const std::vector<int64_t> kInt64Values = {0, 1, -1, 0x1122334455667788, INT64_MAX, INT64_MIN, -1234567890};
+
+TEST(KeyCodecTest, Int64) {
+  for (int64_t value : kInt64Values) {
+    std::string result;
+    KeyCodec::AppendInt64(result, value);
+    KeyCodec::AppendComparableInt64(result, value);
+    KeyCodec::AppendNegationInt64(result, value);
+
+    // same as serial encoding
+    Buf buf(24);
+    buf.WriteLong(value);
+    DingoSchema<std::optional<int64_t>>::InternalEncodeKey(&buf, value);
+    buf.WriteLongWithNegation(value);
+    ASSERT_EQ(buf.GetString(), result);
+
+    ASSERT_EQ(value, KeyCodec::DecodeInt64(result.data()));
+    ASSERT_EQ(value, KeyCodec::DecodeComparableInt64(result.data() + 8));
+    ASSERT_EQ(value, KeyCodec::DecodeNegationInt64(result.data() + 16));
+  }
+
+  std::string result;
+  KeyCodec::AppendInt64(result, 0x1122334455667788);
+  ASSERT_EQ("1122334455667788", Helper::StringToHex(result));
+}
+
+TEST(KeyCodecTest, ComparableInt64Order) {
+  std::string prev;
+  for (int64_t value : {INT64_MIN, -100L, -1L, 0L, 1L, 100L, INT64_MAX}) {
+    std::string result;
+    KeyCodec::AppendComparableInt64(result, value);
+    ASSERT_LT(prev, result);
+    prev = result;
+  }
+}
+
+TEST(KeyCodecTest, PaddingKey) {
+  std::string padding_key;
+  KeyCodec::AppendPaddingKey(padding_key, "abc");
+  ASSERT_EQ("616263000000000000fa", Helper::StringToHex(padding_key));
+
+  padding_key.clear();
+  KeyCodec::AppendPaddingKey(padding_key, "12345678");
+  ASSERT_EQ("3132333435363738ff0000000000000000f7", Helper::StringToHex(padding_key));
+
+  for (size_t size = 0; size < 40; ++size) {
+    std::string key;
+    for (size_t i = 0; i < size; ++i) {
+      key.push_back(static_cast<char>(i * 37));
+    }
+    padding_key.clear();
+    KeyCodec::AppendPaddingKey(padding_key, key);
+    ASSERT_EQ(KeyCodec::PaddingKeySize(size), padding_key.size());
+
+    std::string decoded_key;
+    ASSERT_TRUE(KeyCodec::DecodePaddingKey(padding_key, decoded_key));
+    ASSERT_EQ(key, decoded_key);
+  }
+
+  std::string key;
+  ASSERT_FALSE(KeyCodec::DecodePaddingKey("", key));
+  ASSERT_FALSE(KeyCodec::DecodePaddingKey("12345678", key));
+  ASSERT_FALSE(KeyCodec::DecodePaddingKey(std::string("12345678\xff", 9), key));
+}
+
+TEST(KeyCodecTest, TxnKey) {
+  std::string txn_key = Helper::EncodeTxnKey(std::string("user_key_0001"), 123456);
+  std::string key;
+  int64_t ts = 0;
+  ASSERT_TRUE(Helper::DecodeTxnKey(txn_key, key, ts).ok());
+  ASSERT_EQ("user_key_0001", key);
+  ASSERT_EQ(123456, ts);
+
+  // the bigger ts is in front
+  ASSERT_LT(Helper::EncodeTxnKey(std::string("key"), 200), Helper::EncodeTxnKey(std::string("key"), 100));
+  ASSERT_FALSE(Helper::DecodeTxnKey(std::string("short"), key, ts).ok());
+}
+
+}  // namespace dingodb
@@ -397,4 +397,31 @@ TEST(DingoLatchTest, partially_releasing) {
   TestPartiallyReleasingImpl(64);
   TestPartiallyReleasingImpl(4);
   TestPartiallyReleasingImpl(2);
-}
\ No newline at end of file
+}
+
+TEST(DingoLatchTest, wakeup_in_order_after_burst) {
+  dingodb::Latches latches(4);
+
+  std::vector<std::string> key{"k1"};
+  dingodb::Lock lock(key);
+  EXPECT_EQ(latches.Acquire(&lock, 1), true);
+
+  // more waiting than the shrink capacity
+  std::vector<dingodb::Lock> queueing_locks;
+  queueing_locks.reserve(32);
+  for (uint64_t cid = 2; cid < 34; ++cid) {
+    queueing_locks.push_back(dingodb::Lock(key));
+    EXPECT_EQ(latches.Acquire(&queueing_locks.back(), cid), false);
+  }
+
+  auto wakeup = latches.Release(&lock, 1, std::nullopt);
+  for (uint64_t cid = 2; cid < 34; ++cid) {
+    ASSERT_EQ(wakeup.size(), 1);
+    EXPECT_EQ(wakeup[0], cid);
+    EXPECT_EQ(latches.Acquire(&queueing_locks[cid - 2], cid), true);
+    wakeup = latches.Release(&queueing_locks[cid - 2], cid, std::nullopt);
+  }
+
+  EXPECT_EQ(wakeup.empty(), true);
+  EXPECT_EQ(IsLatchesEmpty(&latches), true);
+}
@@ -0,0 +1,122 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <string>
+
+#include "braft/log_entry.h"
+#include "log/log_entry_cache.h"
+
+namespace dingodb {
+
+class LogEntryCacheTest : public testing::Test {
+ protected:
+  static braft::LogEntry* NewEntry(int64_t index, const std::string& data,
+                                   braft::EntryType type = braft::ENTRY_TYPE_DATA) {
+    auto* entry = new braft::LogEntry();
+    entry->AddRef();
+    entry->type = type;
+    entry->id.term = 1;
+    entry->id.index = index;
+    entry->data.append(data);
+    return entry;
+  }
+
+  static void Put(LogEntryCache& cache, int64_t region_id, int64_t index, const std::string& data) {
+    auto* entry = NewEntry(index, data);
+    cache.Put(region_id, entry);
+    entry->Release();
+  }
+};
+
+TEST_F(LogEntryCacheTest, GetPut) {
+  LogEntryCache cache(1024 * 1024, 4);
+  EXPECT_EQ(nullptr, cache.Get(1, 1));
+
+  Put(cache, 1, 1, "hello");
+  Put(cache, 2, 1, "world");
+  EXPECT_EQ(2, cache.Count());
+
+  auto* entry = cache.Get(1, 1);
+  ASSERT_NE(nullptr, entry);
+  EXPECT_EQ(1, entry->id.index);
+  EXPECT_EQ(braft::ENTRY_TYPE_DATA, entry->type);
+  EXPECT_EQ("hello", entry->data.to_string());
+
+  // consume the returned entry not affect the cached one
+  butil::IOBuf data;
+  data.swap(entry->data);
+  entry->Release();
+  entry = cache.Get(1, 1);
+  ASSERT_NE(nullptr, entry);
+  EXPECT_EQ("hello", entry->data.to_string());
+  entry->Release();
+
+  // configuration entry not cache
+  auto* conf_entry = NewEntry(2, "", braft::ENTRY_TYPE_CONFIGURATION);
+  cache.Put(1, conf_entry);
+  conf_entry->Release();
+  EXPECT_EQ(nullptr, cache.Get(1, 2));
+}
+
+TEST_F(LogEntryCacheTest, Erase) {
+  LogEntryCache cache(1024 * 1024, 4);
+  for (int64_t index = 1; index <= 10; ++index) {
+    Put(cache, 1, index, "data" + std::to_string(index));
+  }
+  Put(cache, 2, 5, "other");
+
+  // truncate suffix, overwrite index 8
+  cache.Erase(1, 8, INT64_MAX);
+  EXPECT_EQ(nullptr, cache.Get(1, 8));
+  Put(cache, 1, 8, "new8");
+  auto* entry = cache.Get(1, 8);
+  ASSERT_NE(nullptr, entry);
+  EXPECT_EQ("new8", entry->data.to_string());
+  entry->Release();
+
+  // truncate prefix
+  cache.Erase(1, INT64_MIN, 3);
+  EXPECT_EQ(nullptr, cache.Get(1, 2));
+  EXPECT_EQ(6, cache.Count());
+
+  cache.EraseRegion(1);
+  EXPECT_EQ(1, cache.Count());
+  entry = cache.Get(2, 5);
+  ASSERT_NE(nullptr, entry);
+  entry->Release();
+}
+
+TEST_F(LogEntryCacheTest, Evict) {
+  LogEntryCache probe(1024 * 1024, 1);
+  Put(probe, 1, 1, std::string(100, 'a'));
+  int64_t entry_bytes = probe.MemorySize();
+  ASSERT_GT(entry_bytes, 0);
+
+  LogEntryCache cache(entry_bytes * 3 + entry_bytes / 2, 1);
+  for (int64_t index = 1; index <= 10; ++index) {
+    Put(cache, 1, index, std::string(100, 'a'));
+  }
+  EXPECT_EQ(3, cache.Count());
+  EXPECT_LE(cache.MemorySize(), entry_bytes * 3 + entry_bytes / 2);
+  EXPECT_EQ(nullptr, cache.Get(1, 1));
+
+  auto* entry = cache.Get(1, 10);
+  ASSERT_NE(nullptr, entry);
+  entry->Release();
+}
+
+}  // namespace dingodb
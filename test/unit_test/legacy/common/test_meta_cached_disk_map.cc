@@ -0,0 +1,160 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "common/helper.h"
+#include "config/yaml_config.h"
+#include "coordinator/coordinator_meta_storage.h"
+#include "engine/rocks_raw_engine.h"
+#include "proto/coordinator_internal.pb.h"
+
+namespace dingodb {  // NOLINT
+
+const std::string kRootPath = "./unit_test_meta_cached_disk_map";
+const std::string kLogPath = kRootPath + "/log";
+const std::string kStorePath = kRootPath + "/db";
+const std::string kYamlConfigContent =
+    "cluster:\n"
+    "  name: dingodb\n"
+    "  instance_id: 666\n"
+    "server:\n"
+    "  host: 127.0.0.1\n"
+    "  port: 23000\n"
+    "log:\n"
+    "  path: " +
+    kLogPath +
+    "\n"
+    "store:\n"
+    "  path: " +
+    kStorePath + "\n";
+
+static const std::vector<std::string> kAllCFs = {"default", Constant::kStoreMetaCF};
+
+static pb::coordinator_internal::KvIndexInternal BuildKvIndex(const std::string& key, int64_t mod_revision) {
+  pb::coordinator_internal::KvIndexInternal kv_index;
+  kv_index.set_id(key);
+  kv_index.mutable_mod_revision()->set_main(mod_revision);
+  return kv_index;
+}
+
+class MetaCachedDiskMapTest : public testing::Test {
+ protected:
+  static void SetUpTestSuite() {
+    Helper::CreateDirectories(kLogPath);
+    Helper::CreateDirectories(kStorePath);
+
+    std::shared_ptr<Config> config = std::make_shared<YamlConfig>();
+    ASSERT_EQ(0, config->Load(kYamlConfigContent));
+
+    engine = std::make_shared<RocksRawEngine>();
+    ASSERT_TRUE(engine != nullptr);
+    ASSERT_TRUE(engine->Init(config, kAllCFs));
+  }
+
+  static void TearDownTestSuite() {
+    engine->Close();
+    engine->Destroy();
+    Helper::RemoveAllFileOrDirectory(kRootPath);
+  }
+
+  static std::shared_ptr<RocksRawEngine> engine;
+};
+
+std::shared_ptr<RocksRawEngine> MetaCachedDiskMapTest::engine = nullptr;
+
+TEST_F(MetaCachedDiskMapTest, PutGetErase) {
+  MetaCachedDiskMap<pb::coordinator_internal::KvIndexInternal> meta("TEST_PUT", engine, 2);
+  ASSERT_TRUE(meta.Recover());
+  EXPECT_EQ(0, meta.Count());
+
+  for (int i = 0; i < 5; ++i) {
+    std::string key = "key" + std::to_string(i);
+    ASSERT_TRUE(meta.Put(key, BuildKvIndex(key, i + 1)).ok());
+  }
+  EXPECT_EQ(5, meta.Count());
+  EXPECT_EQ(2, meta.CacheSize());
+
+  // evicted key is read back from disk
+  pb::coordinator_internal::KvIndexInternal kv_index;
+  ASSERT_TRUE(meta.Get("key0", kv_index).ok());
+  EXPECT_EQ(1, kv_index.mod_revision().main());
+  EXPECT_EQ(2, meta.CacheSize());
+
+  // update existing key does not change count
+  ASSERT_TRUE(meta.Put("key0", BuildKvIndex("key0", 10)).ok());
+  EXPECT_EQ(5, meta.Count());
+  ASSERT_TRUE(meta.Get("key0", kv_index).ok());
+  EXPECT_EQ(10, kv_index.mod_revision().main());
+
+  ASSERT_TRUE(meta.Erase("key0").ok());
+  EXPECT_EQ(4, meta.Count());
+  EXPECT_EQ(pb::error::EKEY_NOT_FOUND, meta.Get("key0", kv_index).error_code());
+
+  // erase not exist key does not change count
+  ASSERT_TRUE(meta.Erase("key0").ok());
+  EXPECT_EQ(4, meta.Count());
+
+  // count is rebuilt from disk
+  MetaCachedDiskMap<pb::coordinator_internal::KvIndexInternal> meta_recover("TEST_PUT", engine, 2);
+  ASSERT_TRUE(meta_recover.Recover());
+  EXPECT_EQ(4, meta_recover.Count());
+  EXPECT_EQ(0, meta_recover.CacheSize());
+}
+
+TEST_F(MetaCachedDiskMapTest, GetRangeValues) {
+  MetaCachedDiskMap<pb::coordinator_internal::KvIndexInternal> meta("TEST_RANGE", engine, 0);
+  ASSERT_TRUE(meta.Recover());
+
+  for (const auto& key : {"a", "ab", "abc", "b", "bc"}) {
+    ASSERT_TRUE(meta.Put(key, BuildKvIndex(key, 1)).ok());
+  }
+  EXPECT_EQ(0, meta.CacheSize());
+
+  std::vector<pb::coordinator_internal::KvIndexInternal> values;
+  ASSERT_TRUE(meta.GetRangeValues(values, "a", Helper::PrefixNext("a")).ok());
+  ASSERT_EQ(3, values.size());
+  EXPECT_EQ("a", values[0].id());
+  EXPECT_EQ("abc", values[2].id());
+
+  values.clear();
+  ASSERT_TRUE(meta.GetRangeValues(values, "ab", "bc").ok());
+  ASSERT_EQ(3, values.size());
+  EXPECT_EQ("b", values[2].id());
+
+  values.clear();
+  ASSERT_TRUE(meta.GetRangeValues(values, "a", "c", nullptr, 2).ok());
+  EXPECT_EQ(2, values.size());
+
+  values.clear();
+  ASSERT_TRUE(meta
+                  .GetRangeValues(values, "a", "c",
+                                  [](const pb::coordinator_internal::KvIndexInternal& kv_index) -> bool {
+                                    return kv_index.id().size() == 2;
+                                  })
+                  .ok());
+  ASSERT_EQ(2, values.size());
+  EXPECT_EQ("ab", values[0].id());
+  EXPECT_EQ("bc", values[1].id());
+
+  std::vector<std::string> ids;
+  ASSERT_TRUE(meta.GetAllIds(ids).ok());
+  EXPECT_EQ(5, ids.size());
+}
+
+}  // namespace dingodb
@@ -0,0 +1,119 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "common/constant.h"
+#include "config/config.h"
+#include "config/yaml_config.h"
+#include "engine/rocks_raw_engine.h"
+#include "gflags/gflags.h"
+#include "meta/meta_reader.h"
+#include "meta/meta_writer.h"
+
+namespace dingodb {
+
+DECLARE_bool(enable_meta_write_batch);
+
+static const std::string kMetaWriterYamlConfig =
+    "cluster:\n"
+    "  name: dingodb\n"
+    "  instance_id: 12345\n"
+    "store:\n"
+    "  path: /tmp/dingo-store-unit-test/meta_writer\n";
+
+class MetaWriterTest : public testing::Test {
+ protected:
+  static void SetUpTestSuite() {
+    std::shared_ptr<Config> config = std::make_shared<YamlConfig>();
+    ASSERT_EQ(0, config->Load(kMetaWriterYamlConfig));
+
+    engine = std::make_shared<RocksRawEngine>();
+    ASSERT_TRUE(engine->Init(config, {Constant::kStoreDataCF, Constant::kStoreMetaCF}));
+  }
+
+  static void TearDownTestSuite() {
+    engine->Close();
+    engine->Destroy();
+    FLAGS_enable_meta_write_batch = false;
+  }
+
+  static std::shared_ptr<pb::common::KeyValue> NewKv(const std::string& key, const std::string& value) {
+    auto kv = std::make_shared<pb::common::KeyValue>();
+    kv->set_key(key);
+    kv->set_value(value);
+    return kv;
+  }
+
+  static std::string GetValue(const std::string& key) {
+    MetaReader reader(engine);
+    auto kv = reader.Get(key);
+    return kv == nullptr ? "" : kv->value();
+  }
+
+  static std::shared_ptr<RocksRawEngine> engine;
+};
+
+std::shared_ptr<RocksRawEngine> MetaWriterTest::engine = nullptr;
+
+TEST_F(MetaWriterTest, LazyDisabled) {
+  FLAGS_enable_meta_write_batch = false;
+  MetaWriter writer(engine);
+
+  EXPECT_TRUE(writer.PutLazy(NewKv("lazy_disabled", "v1")));
+  EXPECT_EQ(0, writer.DirtyCount());
+  EXPECT_EQ("v1", GetValue("lazy_disabled"));
+}
+
+TEST_F(MetaWriterTest, Coalesce) {
+  FLAGS_enable_meta_write_batch = true;
+  MetaWriter writer(engine);
+
+  EXPECT_TRUE(writer.PutLazy(NewKv("coalesce_1", "v1")));
+  EXPECT_TRUE(writer.PutLazy(NewKv("coalesce_1", "v2")));
+  EXPECT_TRUE(writer.PutLazy(NewKv("coalesce_2", "v1")));
+  EXPECT_EQ(2, writer.DirtyCount());
+  EXPECT_EQ("", GetValue("coalesce_1"));
+
+  EXPECT_TRUE(writer.Flush());
+  EXPECT_EQ(0, writer.DirtyCount());
+  EXPECT_EQ("v2", GetValue("coalesce_1"));
+  EXPECT_EQ("v1", GetValue("coalesce_2"));
+}
+
+TEST_F(MetaWriterTest, WriteThroughOverwriteDirty) {
+  FLAGS_enable_meta_write_batch = true;
+  MetaWriter writer(engine);
+
+  // the later write through must not be overwritten by the earlier lazy write
+  EXPECT_TRUE(writer.PutLazy(NewKv("through_1", "lazy")));
+  EXPECT_TRUE(writer.Put(NewKv("through_1", "sync")));
+  EXPECT_TRUE(writer.PutLazy(NewKv("through_2", "lazy")));
+  EXPECT_TRUE(writer.Delete("through_2"));
+  EXPECT_TRUE(writer.PutLazy(NewKv("through_prefix_1", "lazy")));
+  EXPECT_TRUE(writer.PutLazy(NewKv("through_prefix_2", "lazy")));
+  EXPECT_TRUE(writer.DeletePrefix("through_prefix_"));
+  EXPECT_EQ(0, writer.DirtyCount());
+
+  EXPECT_TRUE(writer.Flush());
+  EXPECT_EQ("sync", GetValue("through_1"));
+  EXPECT_EQ("", GetValue("through_2"));
+  EXPECT_EQ("", GetValue("through_prefix_1"));
+}
+
+}  // namespace dingodb
@@ -0,0 +1,59 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "common/numa.h"
+
+class NumaTest : public testing::Test {
+ protected:
+  void SetUp() override {}
+  void TearDown() override {}
+};
+
+TEST_F(NumaTest, ParseCpuList) {
+  std::vector<uint32_t> cpus;
+  ASSERT_TRUE(dingodb::NumaTopology::ParseCpuList("0-3,8,10-11\n", cpus));
+  ASSERT_EQ(std::vector<uint32_t>({0, 1, 2, 3, 8, 10, 11}), cpus);
+
+  cpus.clear();
+  ASSERT_TRUE(dingodb::NumaTopology::ParseCpuList("", cpus));
+  ASSERT_TRUE(cpus.empty());
+
+  EXPECT_FALSE(dingodb::NumaTopology::ParseCpuList("3-1", cpus));
+  EXPECT_FALSE(dingodb::NumaTopology::ParseCpuList("1-", cpus));
+  EXPECT_FALSE(dingodb::NumaTopology::ParseCpuList("1-2-3", cpus));
+  EXPECT_FALSE(dingodb::NumaTopology::ParseCpuList("a", cpus));
+}
+
+TEST_F(NumaTest, Topology) {
+  auto& topology = dingodb::NumaTopology::GetInstance();
+  ASSERT_GE(topology.NodeNum(), 1);
+
+  for (int32_t node = 0; node < topology.NodeNum(); ++node) {
+    EXPECT_FALSE(topology.NodeCpus(node).empty());
+  }
+
+  for (int64_t id = 0; id < 100; ++id) {
+    int32_t node = topology.NodeOfId(id);
+    EXPECT_GE(node, 0);
+    EXPECT_LT(node, topology.NodeNum());
+  }
+
+  EXPECT_TRUE(topology.BindCurrentThread(0));
+  EXPECT_FALSE(topology.BindCurrentThread(topology.NodeNum()));
+}
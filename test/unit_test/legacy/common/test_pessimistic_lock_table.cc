@@ -0,0 +1,87 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "engine/pessimistic_lock_table.h"
+#include "proto/store.pb.h"
+
+namespace dingodb {
+
+static pb::store::LockInfo GenLockInfo(const std::string& key, int64_t start_ts, int64_t for_update_ts) {
+  pb::store::LockInfo lock_info;
+  lock_info.set_primary_lock("pk");
+  lock_info.set_key(key);
+  lock_info.set_lock_ts(start_ts);
+  lock_info.set_for_update_ts(for_update_ts);
+  lock_info.set_lock_type(pb::store::Op::Lock);
+  return lock_info;
+}
+
+TEST(PessimisticLockTableTest, PutGet) {
+  PessimisticLockTable table(100);
+
+  pb::store::LockInfo lock_info;
+  EXPECT_FALSE(table.Get("key1", lock_info));
+
+  EXPECT_TRUE(table.Put({GenLockInfo("key1", 10, 11), GenLockInfo("key2", 10, 11)}));
+  EXPECT_EQ(2, table.Count());
+  ASSERT_TRUE(table.Get("key1", lock_info));
+  EXPECT_EQ(10, lock_info.lock_ts());
+  EXPECT_EQ(11, lock_info.for_update_ts());
+
+  // update for_update_ts
+  EXPECT_TRUE(table.Put({GenLockInfo("key1", 10, 12)}));
+  EXPECT_EQ(2, table.Count());
+  ASSERT_TRUE(table.Get("key1", lock_info));
+  EXPECT_EQ(12, lock_info.for_update_ts());
+
+  table.Erase("key1");
+  EXPECT_FALSE(table.Get("key1", lock_info));
+  EXPECT_EQ(1, table.Count());
+}
+
+TEST(PessimisticLockTableTest, MaxCount) {
+  PessimisticLockTable table(2);
+
+  EXPECT_TRUE(table.Put({GenLockInfo("key1", 10, 11)}));
+  // all or nothing
+  EXPECT_FALSE(table.Put({GenLockInfo("key2", 10, 11), GenLockInfo("key3", 10, 11)}));
+  EXPECT_EQ(1, table.Count());
+  EXPECT_TRUE(table.Put({GenLockInfo("key2", 10, 11)}));
+  EXPECT_EQ(2, table.Count());
+}
+
+TEST(PessimisticLockTableTest, Range) {
+  PessimisticLockTable table(100);
+  EXPECT_TRUE(table.Put({GenLockInfo("a1", 10, 11), GenLockInfo("b1", 10, 11), GenLockInfo("b2", 10, 11),
+                         GenLockInfo("c1", 10, 11)}));
+
+  auto lock_infos = table.GetRange("b", "c");
+  ASSERT_EQ(2, lock_infos.size());
+  EXPECT_EQ("b1", lock_infos[0].key());
+  EXPECT_EQ("b2", lock_infos[1].key());
+
+  table.EraseRange("b", "c");
+  EXPECT_EQ(2, table.Count());
+  pb::store::LockInfo lock_info;
+  EXPECT_TRUE(table.Get("a1", lock_info));
+  EXPECT_TRUE(table.Get("c1", lock_info));
+  EXPECT_FALSE(table.Get("b1", lock_info));
+}
+
+}  // namespace dingodb
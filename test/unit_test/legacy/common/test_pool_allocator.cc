@@ -0,0 +1,96 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "common/pool_allocator.h"
+
+namespace dingodb {
+
+struct PoolObject {
+  explicit PoolObject(int64_t id, std::string name) : id(id), name(std::move(name)) {}
+  int64_t id;
+  std::string name;
+  char padding[200];
+};
+
+TEST(PoolAllocatorTest, Reuse) {
+  using Cache = ThreadLocalBlockCache<64>;
+  void* ptr = Cache::Allocate();
+  Cache::Deallocate(ptr);
+  int64_t cached_num = Cache::CachedBlockNum();
+  EXPECT_GE(cached_num, 1);
+
+  // the last freed block is reused first
+  EXPECT_EQ(ptr, Cache::Allocate());
+  EXPECT_EQ(cached_num - 1, Cache::CachedBlockNum());
+  Cache::Deallocate(ptr);
+}
+
+TEST(PoolAllocatorTest, MakePooledShared) {
+  std::vector<std::shared_ptr<PoolObject>> objects;
+  for (int i = 0; i < 100; ++i) {
+    objects.push_back(MakePooledShared<PoolObject>(i, "object_" + std::to_string(i)));
+  }
+  for (int i = 0; i < 100; ++i) {
+    EXPECT_EQ(i, objects[i]->id);
+    EXPECT_EQ("object_" + std::to_string(i), objects[i]->name);
+  }
+
+  objects.clear();
+  auto object = MakePooledShared<PoolObject>(1000, "reused");
+  EXPECT_EQ(1000, object->id);
+}
+
+TEST(PoolAllocatorTest, CrossThread) {
+  const int num = 1000;
+  std::vector<std::shared_ptr<PoolObject>> objects;
+  for (int i = 0; i < num; ++i) {
+    objects.push_back(MakePooledShared<PoolObject>(i, "object"));
+  }
+
+  // release by other thread, which cache the blocks
+  std::thread thread([&objects]() {
+    objects.clear();
+    std::vector<std::shared_ptr<PoolObject>> reused;
+    for (int i = 0; i < num; ++i) {
+      reused.push_back(MakePooledShared<PoolObject>(i, "reused"));
+    }
+    for (int i = 0; i < num; ++i) {
+      EXPECT_EQ(i, reused[i]->id);
+    }
+  });
+  thread.join();
+  EXPECT_TRUE(objects.empty());
+}
+
+TEST(PoolAllocatorTest, Cap) {
+  using Cache = ThreadLocalBlockCache<128>;
+  std::vector<void*> blocks;
+  for (int64_t i = 0; i < Cache::kMaxCachedBlockNum + 100; ++i) {
+    blocks.push_back(Cache::Allocate());
+  }
+  for (auto* block : blocks) {
+    Cache::Deallocate(block);
+  }
+  EXPECT_EQ(Cache::kMaxCachedBlockNum, Cache::CachedBlockNum());
+}
+
+}  // namespace dingodb
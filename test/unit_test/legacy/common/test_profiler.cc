@@ -0,0 +1,44 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "common/profiler.h"
+
+namespace dingodb {
+
+TEST(ContinuousProfilerTest, ExpiredProfiles) {
+  std::vector<std::string> filenames = {
+      "cpu.0000001700000003000.prof",
+      "cpu.0000001700000001000.prof",
+      "cpu.0000001700000004000.prof",
+      "cpu.0000001700000002000.prof",
+  };
+
+  auto expired = ContinuousProfiler::ExpiredProfiles(filenames, 2);
+  ASSERT_EQ(2, expired.size());
+  EXPECT_EQ("cpu.0000001700000001000.prof", expired[0]);
+  EXPECT_EQ("cpu.0000001700000002000.prof", expired[1]);
+
+  EXPECT_TRUE(ContinuousProfiler::ExpiredProfiles(filenames, 4).empty());
+  EXPECT_TRUE(ContinuousProfiler::ExpiredProfiles({}, 2).empty());
+
+  // keep one at least
+  EXPECT_EQ(3, ContinuousProfiler::ExpiredProfiles(filenames, 0).size());
+}
+
+}  // namespace dingodb
@@ -0,0 +1,123 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <string>
+
+#include "butil/iobuf.h"
+#include "gflags/gflags.h"
+#include "proto/raft.pb.h"
+#include "raft/raft_cmd_codec.h"
+
+DECLARE_string(raft_log_compression);
+DECLARE_int32(raft_log_compression_threshold);
+
+namespace dingodb {
+
+static pb::raft::RaftCmdRequest GenRaftCmd(int kv_num, const std::string& value) {
+  pb::raft::RaftCmdRequest raft_cmd;
+  raft_cmd.mutable_header()->set_region_id(1000);
+  auto* request = raft_cmd.add_requests();
+  request->set_cmd_type(pb::raft::CmdType::PUT);
+  auto* put_request = request->mutable_put();
+  put_request->set_cf_name("default");
+  for (int i = 0; i < kv_num; ++i) {
+    auto* kv = put_request->add_kvs();
+    kv->set_key("key_" + std::to_string(i));
+    kv->set_value(value);
+  }
+
+  return raft_cmd;
+}
+
+class RaftCmdCodecTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    old_compression_ = FLAGS_raft_log_compression;
+    old_threshold_ = FLAGS_raft_log_compression_threshold;
+    FLAGS_raft_log_compression_threshold = 1024;
+  }
+
+  void TearDown() override {
+    FLAGS_raft_log_compression = old_compression_;
+    FLAGS_raft_log_compression_threshold = old_threshold_;
+  }
+
+  // encode and decode raft_cmd, return encoded size
+  static size_t RoundTrip(const pb::raft::RaftCmdRequest& raft_cmd) {
+    butil::IOBuf data;
+    RaftCmdCodec::Encode(raft_cmd, data);
+
+    pb::raft::RaftCmdRequest iobuf_result;
+    EXPECT_TRUE(RaftCmdCodec::Decode(data, iobuf_result));
+    EXPECT_EQ(raft_cmd.SerializeAsString(), iobuf_result.SerializeAsString());
+
+    pb::raft::RaftCmdRequest string_result;
+    EXPECT_TRUE(RaftCmdCodec::Decode(data.to_string(), string_result));
+    EXPECT_EQ(raft_cmd.SerializeAsString(), string_result.SerializeAsString());
+
+    return data.size();
+  }
+
+ private:
+  std::string old_compression_;
+  int32_t old_threshold_;
+};
+
+TEST_F(RaftCmdCodecTest, None) {
+  FLAGS_raft_log_compression = "none";
+  auto raft_cmd = GenRaftCmd(100, std::string(100, 'a'));
+  EXPECT_EQ(raft_cmd.ByteSizeLong(), RoundTrip(raft_cmd));
+}
+
+TEST_F(RaftCmdCodecTest, Compress) {
+  auto raft_cmd = GenRaftCmd(100, std::string(100, 'a'));
+  for (const auto* type : {"lz4", "zstd"}) {
+    FLAGS_raft_log_compression = type;
+    EXPECT_LT(RoundTrip(raft_cmd), raft_cmd.ByteSizeLong() / 2) << type;
+  }
+}
+
+TEST_F(RaftCmdCodecTest, BelowThreshold) {
+  FLAGS_raft_log_compression = "zstd";
+  auto raft_cmd = GenRaftCmd(1, "small");
+  EXPECT_EQ(raft_cmd.ByteSizeLong(), RoundTrip(raft_cmd));
+}
+
+TEST_F(RaftCmdCodecTest, Incompressible) {
+  FLAGS_raft_log_compression = "lz4";
+  std::string value;
+  uint32_t seed = 12345;
+  for (int i = 0; i < 4096; ++i) {
+    seed = seed * 1103515245 + 12345;
+    value.push_back(static_cast<char>(seed >> 16));
+  }
+  auto raft_cmd = GenRaftCmd(1, value);
+  EXPECT_EQ(raft_cmd.ByteSizeLong(), RoundTrip(raft_cmd));
+}
+
+TEST_F(RaftCmdCodecTest, Corrupted) {
+  FLAGS_raft_log_compression = "zstd";
+  butil::IOBuf data;
+  RaftCmdCodec::Encode(GenRaftCmd(100, std::string(100, 'a')), data);
+  std::string buf = data.to_string();
+  buf.resize(buf.size() / 2);
+
+  pb::raft::RaftCmdRequest raft_cmd;
+  EXPECT_FALSE(RaftCmdCodec::Decode(buf, raft_cmd));
+}
+
+}  // namespace dingodb
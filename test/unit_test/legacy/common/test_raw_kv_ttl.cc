@@ -0,0 +1,168 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <ctime>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "common/constant.h"
+#include "common/helper.h"
+#include "engine/iterator.h"
+#include "engine/raw_kv_ttl.h"
+
+namespace dingodb {
+
+// iterate the sorted kvs
+class VectorIterator : public Iterator {
+ public:
+  explicit VectorIterator(std::vector<std::pair<std::string, std::string>> kvs) : kvs_(std::move(kvs)) {}
+
+  std::string GetName() override { return "Vector"; }
+  IteratorType GetID() override { return IteratorType::kMemEngine; }
+
+  bool Valid() const override { return pos_ >= 0 && pos_ < static_cast<int64_t>(kvs_.size()); }
+
+  void SeekToFirst() override { pos_ = 0; }
+  void SeekToLast() override { pos_ = static_cast<int64_t>(kvs_.size()) - 1; }
+
+  void Seek(const std::string& target) override {
+    for (pos_ = 0; Valid() && kvs_[pos_].first < target; ++pos_) {
+    }
+  }
+
+  void Next() override { ++pos_; }
+  void Prev() override { --pos_; }
+
+  std::string_view Key() const override { return kvs_[pos_].first; }
+  std::string_view Value() const override { return kvs_[pos_].second; }
+
+  butil::Status Status() const override { return butil::Status::OK(); }
+
+ private:
+  std::vector<std::pair<std::string, std::string>> kvs_;
+  int64_t pos_{-1};
+};
+
+class RawKvTtlTest : public testing::Test {
+ protected:
+  void SetUp() override { ASSERT_TRUE(RawKvTtl::GetInstance().Init("1001:60,1002:3600")); }
+  void TearDown() override { ASSERT_TRUE(RawKvTtl::GetInstance().Init("")); }
+};
+
+TEST_F(RawKvTtlTest, Init) {
+  auto& ttl = RawKvTtl::GetInstance();
+  EXPECT_TRUE(ttl.IsEnabled());
+
+  EXPECT_FALSE(ttl.Init("1001"));
+  EXPECT_FALSE(ttl.Init("1001:"));
+  EXPECT_FALSE(ttl.Init("abc:60"));
+  EXPECT_FALSE(ttl.Init("1001:-1"));
+  EXPECT_FALSE(ttl.Init("1001:60:1"));
+
+  EXPECT_TRUE(ttl.Init(""));
+  EXPECT_FALSE(ttl.IsEnabled());
+  EXPECT_TRUE(ttl.Init("1001:60,"));
+  EXPECT_TRUE(ttl.IsEnabled());
+}
+
+TEST_F(RawKvTtlTest, GetTtl) {
+  auto& ttl = RawKvTtl::GetInstance();
+
+  EXPECT_EQ(60, ttl.GetTtl(Constant::kStoreDataCF, Helper::EncodeTableRegionHeader(Constant::kClientRaw, 1001, "a")));
+  EXPECT_EQ(3600, ttl.GetTtl(Constant::kStoreDataCF, Helper::EncodeTableRegionHeader(Constant::kExecutorRaw, 1002)));
+  EXPECT_EQ(0, ttl.GetTtl(Constant::kStoreDataCF, Helper::EncodeTableRegionHeader(Constant::kClientRaw, 1003, "a")));
+  // txn key and other cf have no ttl
+  EXPECT_EQ(0, ttl.GetTtl(Constant::kStoreDataCF, Helper::EncodeTableRegionHeader(Constant::kClientTxn, 1001, "a")));
+  EXPECT_EQ(0, ttl.GetTtl(Constant::kStoreMetaCF, Helper::EncodeTableRegionHeader(Constant::kClientRaw, 1001, "a")));
+  EXPECT_EQ(0, ttl.GetTtl(Constant::kStoreDataCF, "w"));
+}
+
+TEST_F(RawKvTtlTest, EncodeValues) {
+  auto& ttl = RawKvTtl::GetInstance();
+
+  std::vector<pb::common::KeyValue> kvs(2);
+  kvs[0].set_key(Helper::EncodeTableRegionHeader(Constant::kClientRaw, 1001, "a"));
+  kvs[0].set_value("value1");
+  kvs[1].set_key(Helper::EncodeTableRegionHeader(Constant::kClientRaw, 1003, "a"));
+  kvs[1].set_value("value2");
+  EXPECT_TRUE(ttl.HasTtl(Constant::kStoreDataCF, kvs));
+
+  int64_t now_s = std::time(nullptr);
+  ttl.EncodeValues(Constant::kStoreDataCF, kvs);
+  EXPECT_EQ("value2", kvs[1].value());
+
+  std::string_view user_value;
+  int64_t expire_ts_s = 0;
+  ASSERT_TRUE(RawKvTtl::DecodeValue(kvs[0].value(), user_value, expire_ts_s));
+  EXPECT_EQ("value1", user_value);
+  EXPECT_GE(expire_ts_s, now_s + 60);
+  EXPECT_LE(expire_ts_s, now_s + 61);
+
+  ASSERT_TRUE(RawKvTtl::DecodeValue(RawKvTtl::EncodeValue("", 0x1234567890), user_value, expire_ts_s));
+  EXPECT_TRUE(user_value.empty());
+  EXPECT_EQ(0x1234567890, expire_ts_s);
+  EXPECT_FALSE(RawKvTtl::DecodeValue("short", user_value, expire_ts_s));
+}
+
+TEST_F(RawKvTtlTest, Iterator) {
+  int64_t now_s = std::time(nullptr);
+  auto iter = std::make_shared<VectorIterator>(std::vector<std::pair<std::string, std::string>>{
+      {"a", RawKvTtl::EncodeValue("1", now_s - 1)},
+      {"b", RawKvTtl::EncodeValue("2", now_s + 100)},
+      {"c", RawKvTtl::EncodeValue("3", now_s)},
+      {"d", RawKvTtl::EncodeValue("4", now_s + 100)},
+      {"e", RawKvTtl::EncodeValue("5", now_s - 100)},
+  });
+  TtlIterator ttl_iter(iter, now_s);
+
+  std::vector<std::string> values;
+  for (ttl_iter.SeekToFirst(); ttl_iter.Valid(); ttl_iter.Next()) {
+    values.emplace_back(ttl_iter.Value());
+  }
+  EXPECT_EQ(std::vector<std::string>({"2", "4"}), values);
+
+  values.clear();
+  for (ttl_iter.SeekToLast(); ttl_iter.Valid(); ttl_iter.Prev()) {
+    values.emplace_back(ttl_iter.Value());
+  }
+  EXPECT_EQ(std::vector<std::string>({"4", "2"}), values);
+
+  ttl_iter.Seek("c");
+  ASSERT_TRUE(ttl_iter.Valid());
+  EXPECT_EQ("d", ttl_iter.Key());
+}
+
+TEST_F(RawKvTtlTest, CompactionFilter) {
+  int64_t now_s = std::time(nullptr);
+  TtlCompactionFilter filter(now_s);
+
+  std::string key = Helper::EncodeTableRegionHeader(Constant::kClientRaw, 1001, "a");
+  std::string new_value;
+  bool value_changed = false;
+  EXPECT_TRUE(filter.Filter(0, key, RawKvTtl::EncodeValue("v", now_s - 1), &new_value, &value_changed));
+  EXPECT_FALSE(filter.Filter(0, key, RawKvTtl::EncodeValue("v", now_s + 1), &new_value, &value_changed));
+
+  // no ttl
+  std::string other_key = Helper::EncodeTableRegionHeader(Constant::kClientRaw, 1003, "a");
+  EXPECT_FALSE(filter.Filter(0, other_key, RawKvTtl::EncodeValue("v", now_s - 1), &new_value, &value_changed));
+}
+
+}  // namespace dingodb
@@ -0,0 +1,70 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "engine/region_compaction.h"
+
+namespace dingodb {
+
+using Candidate = RegionCompactionScheduler::Candidate;
+
+TEST(RegionCompactionTest, Pick) {
+  std::vector<Candidate> candidates = {
+      {1, 1000000, 100000, 0},  // ratio 0.1
+      {2, 1000000, 500000, 0},  // ratio 0.5
+      {3, 100, 90, 0},          // ratio 0.9, too few deletions
+      {4, 1000000, 800000, 0},  // ratio 0.8
+      {5, 1000, 0, 1},          // range tombstone
+      {6, 0, 0, 0},
+  };
+
+  auto region_ids = RegionCompactionScheduler::Pick(candidates, 0.3, 10000, 10);
+  EXPECT_EQ(std::vector<int64_t>({5, 4, 2}), region_ids);
+
+  region_ids = RegionCompactionScheduler::Pick(candidates, 0.3, 10000, 2);
+  EXPECT_EQ(std::vector<int64_t>({5, 4}), region_ids);
+
+  region_ids = RegionCompactionScheduler::Pick(candidates, 0.05, 0, 10);
+  EXPECT_EQ(std::vector<int64_t>({5, 3, 4, 2, 1}), region_ids);
+
+  EXPECT_TRUE(RegionCompactionScheduler::Pick(candidates, 0.3, 10000, 0).empty());
+  EXPECT_TRUE(RegionCompactionScheduler::Pick({}, 0.3, 10000, 10).empty());
+}
+
+TEST(RegionCompactionTest, InWindow) {
+  for (int32_t hour = 0; hour < 24; ++hour) {
+    EXPECT_TRUE(RegionCompactionScheduler::InWindow(hour, 0, 24));
+  }
+
+  EXPECT_TRUE(RegionCompactionScheduler::InWindow(2, 2, 6));
+  EXPECT_TRUE(RegionCompactionScheduler::InWindow(5, 2, 6));
+  EXPECT_FALSE(RegionCompactionScheduler::InWindow(6, 2, 6));
+  EXPECT_FALSE(RegionCompactionScheduler::InWindow(1, 2, 6));
+
+  // cross midnight
+  EXPECT_TRUE(RegionCompactionScheduler::InWindow(23, 22, 4));
+  EXPECT_TRUE(RegionCompactionScheduler::InWindow(0, 22, 4));
+  EXPECT_TRUE(RegionCompactionScheduler::InWindow(3, 22, 4));
+  EXPECT_FALSE(RegionCompactionScheduler::InWindow(4, 22, 4));
+  EXPECT_FALSE(RegionCompactionScheduler::InWindow(12, 22, 4));
+
+  EXPECT_FALSE(RegionCompactionScheduler::InWindow(12, 0, 0));
+}
+
+}  // namespace dingodb
@@ -0,0 +1,104 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "gflags/gflags.h"
+#include "metrics/region_counter_metrics.h"
+
+namespace dingodb {
+
+DECLARE_int64(store_region_metrics_max_region_num);
+
+TEST(RegionCounterMetricsTest, FoldAndTopN) {
+  auto& metrics = RegionCounterMetrics::GetInstance();
+  metrics.Fold();
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 4; ++i) {
+    threads.emplace_back([&]() {
+      for (int j = 0; j < 100; ++j) {
+        metrics.Add(900001, RegionCounterMetrics::kApply);
+        metrics.Add(900002, RegionCounterMetrics::kApply, 2);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  metrics.Fold();
+
+  RegionCounterMetrics::RegionStat stat;
+  ASSERT_TRUE(metrics.GetRegionStat(900001, stat));
+  EXPECT_EQ(400, stat.totals[RegionCounterMetrics::kApply]);
+  EXPECT_GT(stat.rates[RegionCounterMetrics::kApply], 0);
+  ASSERT_TRUE(metrics.GetRegionStat(900002, stat));
+  EXPECT_EQ(800, stat.totals[RegionCounterMetrics::kApply]);
+
+  auto top = metrics.TopN(RegionCounterMetrics::kApply, 1);
+  ASSERT_EQ(1, top.size());
+  EXPECT_EQ(900002, top[0].first);
+
+  // idle regions have no rate after next fold
+  metrics.Fold();
+  EXPECT_TRUE(metrics.TopN(RegionCounterMetrics::kApply, 10).empty());
+  ASSERT_TRUE(metrics.GetRegionStat(900002, stat));
+  EXPECT_EQ(800, stat.totals[RegionCounterMetrics::kApply]);
+
+  metrics.Set(900001, RegionCounterMetrics::kLeaderSwitchCount, 5);
+  ASSERT_TRUE(metrics.GetRegionStat(900001, stat));
+  EXPECT_EQ(5, stat.gauges[RegionCounterMetrics::kLeaderSwitchCount]);
+
+  metrics.Delete(900001);
+  metrics.Delete(900002);
+  EXPECT_FALSE(metrics.GetRegionStat(900001, stat));
+}
+
+TEST(RegionCounterMetricsTest, Overflow) {
+  auto& metrics = RegionCounterMetrics::GetInstance();
+  int64_t old_max_region_num = FLAGS_store_region_metrics_max_region_num;
+  FLAGS_store_region_metrics_max_region_num = metrics.RegionNum() + 1;
+
+  metrics.Add(900011, RegionCounterMetrics::kCommit);
+  metrics.Add(900012, RegionCounterMetrics::kCommit);
+  metrics.Add(900013, RegionCounterMetrics::kCommit);
+  metrics.Fold();
+
+  RegionCounterMetrics::RegionStat stat;
+  int64_t region_count = 0;
+  int64_t commit_count = 0;
+  for (int64_t region_id : {900011, 900012, 900013}) {
+    if (metrics.GetRegionStat(region_id, stat)) {
+      ++region_count;
+      commit_count += stat.totals[RegionCounterMetrics::kCommit];
+    }
+  }
+  EXPECT_EQ(1, region_count);
+  ASSERT_TRUE(metrics.GetRegionStat(RegionCounterMetrics::kOverflowRegionId, stat));
+  EXPECT_EQ(3, commit_count + stat.totals[RegionCounterMetrics::kCommit]);
+
+  FLAGS_store_region_metrics_max_region_num = old_max_region_num;
+  for (int64_t region_id : std::vector<int64_t>{900011, 900012, 900013, RegionCounterMetrics::kOverflowRegionId}) {
+    metrics.Delete(region_id);
+  }
+}
+
+}  // namespace dingodb
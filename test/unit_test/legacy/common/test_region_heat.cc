@@ -0,0 +1,43 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <map>
+#include <string>
+
+#include "store/region_heat.h"
+
+namespace dingodb {
+
+TEST(RegionHeatTest, SerializeAndParse) {
+  std::map<int64_t, int64_t> heats = {{1001, 100}, {1002, 5}, {80001, 123456789}};
+
+  auto content = RegionHeat::Serialize(heats);
+  EXPECT_EQ("1001 100\n1002 5\n80001 123456789\n", content);
+  EXPECT_EQ(heats, RegionHeat::Parse(content));
+}
+
+TEST(RegionHeatTest, ParseInvalid) {
+  // broken, non positive and partial lines are skipped
+  auto heats = RegionHeat::Parse("1001 100\nabc\n1002\n-1 10\n1003 0\n1004 7");
+  EXPECT_EQ(2, heats.size());
+  EXPECT_EQ(100, heats[1001]);
+  EXPECT_EQ(7, heats[1004]);
+
+  EXPECT_TRUE(RegionHeat::Parse("").empty());
+}
+
+}  // namespace dingodb
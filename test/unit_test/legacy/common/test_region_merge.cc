@@ -0,0 +1,79 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "coordinator/region_merge.h"
+#include "proto/common.pb.h"
+
+class RegionMergeSchedulerTest : public testing::Test {
+ protected:
+  void SetUp() override {}
+  void TearDown() override {}
+};
+
+static void AddRegion(dingodb::pb::common::RegionMap& region_map, int64_t region_id, const std::string& start_key,
+                      const std::string& end_key, int64_t part_id = 1) {
+  auto* region = region_map.add_regions();
+  region->set_id(region_id);
+  region->set_region_type(dingodb::pb::common::RegionType::STORE_REGION);
+  region->set_state(dingodb::pb::common::RegionState::REGION_NORMAL);
+
+  auto* definition = region->mutable_definition();
+  definition->set_id(region_id);
+  definition->set_part_id(part_id);
+  definition->mutable_range()->set_start_key(start_key);
+  definition->mutable_range()->set_end_key(end_key);
+  for (int64_t store_id = 1001; store_id <= 1003; ++store_id) {
+    auto* peer = definition->add_peers();
+    peer->set_store_id(store_id);
+    peer->set_role(dingodb::pb::common::PeerRole::VOTER);
+  }
+}
+
+TEST_F(RegionMergeSchedulerTest, Schedule) {
+  const int64_t mb = 1024 * 1024;
+
+  {
+    // 60001[a,b) 60002[b,c) 60003[c,d) 60004[d,e), 60004 is too large
+    dingodb::pb::common::RegionMap region_map;
+    AddRegion(region_map, 60003, "c", "d");
+    AddRegion(region_map, 60001, "a", "b");
+    AddRegion(region_map, 60004, "d", "e");
+    AddRegion(region_map, 60002, "b", "c");
+    std::map<int64_t, int64_t> region_sizes = {{60001, mb}, {60002, mb}, {60003, mb}, {60004, 100 * mb}};
+
+    auto tasks = dingodb::balance::RegionMergeScheduler::Schedule(region_map, region_sizes);
+    ASSERT_EQ(1, tasks.size());
+    ASSERT_EQ(60002, tasks[0].source_region_id);
+    ASSERT_EQ(60001, tasks[0].target_region_id);
+  }
+
+  {
+    // different partition and region without metrics are not merged
+    dingodb::pb::common::RegionMap region_map;
+    AddRegion(region_map, 60001, "a", "b", 1);
+    AddRegion(region_map, 60002, "b", "c", 2);
+    AddRegion(region_map, 60003, "c", "d", 2);
+    std::map<int64_t, int64_t> region_sizes = {{60001, 0}, {60002, 0}};
+
+    auto tasks = dingodb::balance::RegionMergeScheduler::Schedule(region_map, region_sizes);
+    ASSERT_TRUE(tasks.empty());
+  }
+}
@@ -0,0 +1,56 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include "engine/resolved_ts.h"
+
+namespace dingodb {
+
+TEST(RegionResolvedTsTest, Advance) {
+  RegionResolvedTs resolved_ts;
+  EXPECT_EQ(0, resolved_ts.Get(1));
+  EXPECT_FALSE(resolved_ts.IsResolved(1, 100));
+
+  resolved_ts.Advance(1, 100);
+  EXPECT_EQ(100, resolved_ts.Get(1));
+  EXPECT_TRUE(resolved_ts.IsResolved(1, 100));
+  EXPECT_FALSE(resolved_ts.IsResolved(1, 101));
+  EXPECT_FALSE(resolved_ts.IsResolved(1, 0));
+  EXPECT_FALSE(resolved_ts.IsResolved(2, 100));
+
+  // never move backward
+  resolved_ts.Advance(1, 50);
+  EXPECT_EQ(100, resolved_ts.Get(1));
+  resolved_ts.Advance(1, 200);
+  EXPECT_EQ(200, resolved_ts.Get(1));
+
+  resolved_ts.Erase(1);
+  EXPECT_EQ(0, resolved_ts.Get(1));
+}
+
+TEST(RegionResolvedTsTest, EraseNotIn) {
+  RegionResolvedTs resolved_ts;
+  resolved_ts.Advance(1, 100);
+  resolved_ts.Advance(2, 100);
+  resolved_ts.Advance(3, 100);
+
+  resolved_ts.EraseNotIn({1, 3, 4});
+  EXPECT_EQ(100, resolved_ts.Get(1));
+  EXPECT_EQ(0, resolved_ts.Get(2));
+  EXPECT_EQ(100, resolved_ts.Get(3));
+  EXPECT_EQ(0, resolved_ts.Get(4));
+}
+
+}  // namespace dingodb
@@ -961,6 +961,73 @@ TEST_F(RelExprHelperTest, TransToOperandWrapper) {
   }
 }
 
+TEST_F(RelExprHelperTest, TransToOperandBatch) {
+  butil::Status ok;
+
+  std::vector<BaseSchema::Type> column_types{BaseSchema::Type::kLong, BaseSchema::Type::kString,
+                                             BaseSchema::Type::kBool};
+
+  // empty ok
+  {
+    std::vector<std::vector<std::any>> original_records;
+    std::vector<std::unique_ptr<std::vector<expr::Operand>>> operand_ptrs;
+    ok = RelExprHelper::TransToOperandBatch(column_types, original_records, operand_ptrs);
+    EXPECT_EQ(ok.error_code(), pb::error::OK);
+    EXPECT_TRUE(operand_ptrs.empty());
+  }
+
+  // column size not match
+  {
+    std::vector<std::vector<std::any>> original_records(1);
+    original_records[0].emplace_back(std::optional<int64_t>(1));
+    std::vector<std::unique_ptr<std::vector<expr::Operand>>> operand_ptrs;
+    ok = RelExprHelper::TransToOperandBatch(column_types, original_records, operand_ptrs);
+    EXPECT_EQ(ok.error_code(), pb::error::EILLEGAL_PARAMTETERS);
+  }
+
+  // type not match
+  {
+    std::vector<std::vector<std::any>> original_records(1);
+    original_records[0].emplace_back(std::optional<int32_t>(1));
+    original_records[0].emplace_back(std::optional<std::shared_ptr<std::string>>(std::make_shared<std::string>("a")));
+    original_records[0].emplace_back(std::optional<bool>(true));
+    std::vector<std::unique_ptr<std::vector<expr::Operand>>> operand_ptrs;
+    ok = RelExprHelper::TransToOperandBatch(column_types, original_records, operand_ptrs);
+    EXPECT_EQ(ok.error_code(), pb::error::EILLEGAL_PARAMTETERS);
+  }
+
+  // ok
+  {
+    std::vector<std::vector<std::any>> original_records;
+    for (int64_t i = 0; i < 3; ++i) {
+      std::vector<std::any> record;
+      record.emplace_back(std::optional<int64_t>(i * 100));
+      record.emplace_back(
+          std::optional<std::shared_ptr<std::string>>(std::make_shared<std::string>(std::to_string(i))));
+      if (i == 1) {
+        record.emplace_back(std::optional<bool>(std::nullopt));
+      } else {
+        record.emplace_back(std::optional<bool>(i == 0));
+      }
+      original_records.push_back(std::move(record));
+    }
+
+    std::vector<std::unique_ptr<std::vector<expr::Operand>>> operand_ptrs;
+    ok = RelExprHelper::TransToOperandBatch(column_types, original_records, operand_ptrs);
+    EXPECT_EQ(ok.error_code(), pb::error::OK);
+    ASSERT_EQ(3, operand_ptrs.size());
+
+    for (size_t i = 0; i < operand_ptrs.size(); ++i) {
+      ASSERT_EQ(column_types.size(), operand_ptrs[i]->size());
+      EXPECT_EQ(i * 100, (*operand_ptrs[i])[0].GetValue<int64_t>());
+      EXPECT_EQ(std::to_string(i), *(*operand_ptrs[i])[1].GetValue<dingodb::expr::String>());
+      if (i != 1) {
+        EXPECT_EQ(i == 0, (*operand_ptrs[i])[2].GetValue<bool>());
+      }
+    }
+  }
+}
+
 TEST_F(RelExprHelperTest, TransFromOperandWrapper) {
   butil::Status ok;
 
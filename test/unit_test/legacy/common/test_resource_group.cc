@@ -0,0 +1,67 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <map>
+
+#include "common/resource_group.h"
+#include "common/runnable.h"
+
+namespace dingodb {
+
+TEST(ResourceGroupManagerTest, ParseBudgets) {
+  std::map<int64_t, int64_t> budgets;
+  EXPECT_TRUE(ResourceGroupManager::ParseBudgets("", budgets));
+  EXPECT_TRUE(budgets.empty());
+
+  EXPECT_TRUE(ResourceGroupManager::ParseBudgets("1:1000,2:500", budgets));
+  EXPECT_EQ(2, budgets.size());
+  EXPECT_EQ(1000, budgets[1]);
+  EXPECT_EQ(500, budgets[2]);
+
+  EXPECT_FALSE(ResourceGroupManager::ParseBudgets("1:0", budgets));
+  EXPECT_FALSE(ResourceGroupManager::ParseBudgets("1", budgets));
+}
+
+TEST(ResourceGroupManagerTest, Throttle) {
+  ResourceGroupManager manager;
+  int64_t now_us = 1000000;
+  manager.SetBudgets({{1, 10}}, now_us);
+
+  // tenant without budget is unlimited
+  EXPECT_TRUE(manager.Admit(2, now_us));
+
+  // 10ms run time of scan is 10.5 ru, more than the budget
+  EXPECT_TRUE(manager.Admit(1, now_us));
+  manager.Charge(1, QosRequestType::kScan, 10000, now_us);
+  EXPECT_LT(manager.Tokens(1, now_us), 0);
+  EXPECT_FALSE(manager.Admit(1, now_us));
+
+  // pay back the debt after refill
+  EXPECT_FALSE(manager.Admit(1, now_us + 10000));
+  EXPECT_TRUE(manager.Admit(1, now_us + 100000));
+
+  // tokens are capped by burst
+  EXPECT_DOUBLE_EQ(10, manager.Tokens(1, now_us + 100000000));
+
+  // remove budget
+  manager.SetBudgets({}, now_us);
+  manager.Charge(1, QosRequestType::kScan, 100000, now_us);
+  EXPECT_TRUE(manager.Admit(1, now_us));
+}
+
+}  // namespace dingodb
@@ -27,6 +27,7 @@
 #include <memory>
 #include <random>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include "butil/status.h"
@@ -583,6 +584,83 @@ TEST_F(RawRocksEngineTest, KvGet) {
   }
 }
 
+TEST_F(RawRocksEngineTest, KvMultiGet) {
+  const std::string &cf_name = kDefaultCf;
+  auto writer = RawRocksEngineTest::engine->Writer();
+  auto reader = RawRocksEngineTest::engine->Reader();
+
+  for (const auto &key : {"multi_get_key1", "multi_get_key2", "multi_get_key3"}) {
+    pb::common::KeyValue kv;
+    kv.set_key(key);
+    kv.set_value(std::string("value_") + key);
+    butil::Status ok = writer->KvPut(cf_name, kv);
+    EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
+  }
+
+  // key some empty
+  {
+    std::vector<std::string> keys{"multi_get_key1", ""};
+    std::vector<std::string> values;
+    std::vector<bool> exists;
+
+    butil::Status ok = reader->KvMultiGet(cf_name, keys, values, exists);
+    EXPECT_EQ(ok.error_code(), pb::error::Errno::EKEY_EMPTY);
+  }
+
+  // unsorted keys and some key not exist, result keeps the order of keys
+  {
+    std::vector<std::string> keys{"multi_get_key3", "multi_get_not_exist", "multi_get_key1", "multi_get_key2"};
+    std::vector<std::string> values;
+    std::vector<bool> exists;
+
+    butil::Status ok = reader->KvMultiGet(cf_name, keys, values, exists);
+    EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
+    ASSERT_EQ(keys.size(), values.size());
+    ASSERT_EQ(keys.size(), exists.size());
+    EXPECT_EQ(std::vector<bool>({true, false, true, true}), exists);
+    EXPECT_EQ("value_multi_get_key3", values[0]);
+    EXPECT_EQ("", values[1]);
+    EXPECT_EQ("value_multi_get_key1", values[2]);
+    EXPECT_EQ("value_multi_get_key2", values[3]);
+  }
+
+  // empty keys
+  {
+    std::vector<std::string> values;
+    std::vector<bool> exists;
+
+    butil::Status ok = reader->KvMultiGet(cf_name, {}, values, exists);
+    EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
+    EXPECT_TRUE(values.empty());
+  }
+}
+
+TEST_F(RawRocksEngineTest, KvGetPinned) {
+  const std::string &cf_name = kDefaultCf;
+  auto writer = RawRocksEngineTest::engine->Writer();
+  auto reader = RawRocksEngineTest::engine->Reader();
+
+  pb::common::KeyValue kv;
+  kv.set_key("pinned_get_key");
+  kv.set_value(std::string(4096, 'v'));
+  butil::Status ok = writer->KvPut(cf_name, kv);
+  EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
+
+  std::string value;
+  ok = reader->KvGetPinned(cf_name, kv.key(), [&value](std::string_view pinned_value) { value = pinned_value; });
+  EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
+  EXPECT_EQ(kv.value(), value);
+
+  bool visited = false;
+  ok = reader->KvGetPinned(cf_name, "pinned_get_not_exist", [&visited](std::string_view) { visited = true; });
+  EXPECT_EQ(ok.error_code(), pb::error::Errno::EKEY_NOT_FOUND);
+  EXPECT_FALSE(visited);
+
+  ok = reader->KvGetPinned(cf_name, "", [&visited](std::string_view) { visited = true; });
+  EXPECT_EQ(ok.error_code(), pb::error::Errno::EKEY_EMPTY);
+  EXPECT_FALSE(visited);
+}
+
 #ifdef TEST_KV_BATCH_GET_SWITCH
 TEST_F(RawRocksEngineTest, KvBatchGet) {
   const std::string &cf_name = kDefaultCf;
@@ -0,0 +1,102 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <string>
+
+#include "engine/row_cache.h"
+
+namespace dingodb {
+
+TEST(RowCacheTest, GetPut) {
+  RowCache cache(1024 * 1024, 4);
+
+  std::string value;
+  EXPECT_FALSE(cache.Get(1, "key", value));
+
+  cache.Put(1, "key", "value", cache.Generation(1, "key"));
+  ASSERT_TRUE(cache.Get(1, "key", value));
+  EXPECT_EQ("value", value);
+  EXPECT_EQ(1, cache.Count());
+
+  // same key of other region is another entry
+  EXPECT_FALSE(cache.Get(2, "key", value));
+
+  cache.Invalidate(1, "key");
+  EXPECT_FALSE(cache.Get(1, "key", value));
+  EXPECT_EQ(0, cache.Count());
+  EXPECT_EQ(0, cache.MemorySize());
+}
+
+TEST(RowCacheTest, StalePut) {
+  RowCache cache(1024 * 1024, 4);
+
+  // read before write, put after write
+  uint64_t generation = cache.Generation(1, "key");
+  cache.Invalidate(1, "key");
+  cache.Put(1, "key", "old_value", generation);
+
+  std::string value;
+  EXPECT_FALSE(cache.Get(1, "key", value));
+
+  generation = cache.Generation(1, "key");
+  cache.InvalidateRegion(1);
+  cache.Put(1, "key", "old_value", generation);
+  EXPECT_FALSE(cache.Get(1, "key", value));
+}
+
+TEST(RowCacheTest, InvalidateRegion) {
+  RowCache cache(1024 * 1024, 4);
+  for (int i = 0; i < 10; ++i) {
+    auto key = "key" + std::to_string(i);
+    cache.Put(1, key, "value", cache.Generation(1, key));
+    cache.Put(2, key, "value", cache.Generation(2, key));
+  }
+  EXPECT_EQ(20, cache.Count());
+
+  cache.InvalidateRegion(1);
+  EXPECT_EQ(10, cache.Count());
+
+  std::string value;
+  EXPECT_FALSE(cache.Get(1, "key0", value));
+  EXPECT_TRUE(cache.Get(2, "key0", value));
+}
+
+TEST(RowCacheTest, Evict) {
+  RowCache probe(1024 * 1024, 1);
+  probe.Put(1, "key0", "value", probe.Generation(1, "key0"));
+  int64_t entry_bytes = probe.MemorySize();
+  ASSERT_GT(entry_bytes, 0);
+
+  RowCache cache(entry_bytes * 3 + entry_bytes / 2, 1);
+  for (int i = 0; i < 10; ++i) {
+    auto key = "key" + std::to_string(i);
+    cache.Put(1, key, "value", cache.Generation(1, key));
+  }
+  EXPECT_EQ(3, cache.Count());
+
+  std::string value;
+  EXPECT_FALSE(cache.Get(1, "key0", value));
+  EXPECT_TRUE(cache.Get(1, "key9", value));
+
+  // recently used survives
+  EXPECT_TRUE(cache.Get(1, "key7", value));
+  cache.Put(1, "key10", "value", cache.Generation(1, "key10"));
+  EXPECT_TRUE(cache.Get(1, "key7", value));
+  EXPECT_FALSE(cache.Get(1, "key8", value));
+}
+
+}  // namespace dingodb
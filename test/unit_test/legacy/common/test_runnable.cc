@@ -16,10 +16,12 @@
 #include <pthread.h>
 #include <sched.h>
 
+#include <array>
 #include <atomic>
 #include <chrono>
 #include <cstdint>
 #include <iostream>
+#include <memory>
 #include <string>
 #include <thread>
 #include <vector>
@@ -67,4 +69,101 @@ TEST_F(SimpleWorkerSetTest, Performance01) {
   std::cout << "finish..." << std::endl;
   worker_set->Destroy();
   std::cout << "exit..." << std::endl;
-}
\ No newline at end of file
+}
+
+TEST_F(SimpleWorkerSetTest, FairQueueParseShares) {
+  std::array<uint32_t, dingodb::kQosRequestTypeNum> shares;
+  shares.fill(1);
+  ASSERT_TRUE(dingodb::WeightedFairQueue::ParseShares("point_read:8,scan:2", shares));
+  EXPECT_EQ(8, shares[static_cast<int>(dingodb::QosRequestType::kPointRead)]);
+  EXPECT_EQ(2, shares[static_cast<int>(dingodb::QosRequestType::kScan)]);
+  EXPECT_EQ(1, shares[static_cast<int>(dingodb::QosRequestType::kWrite)]);
+
+  EXPECT_FALSE(dingodb::WeightedFairQueue::ParseShares("unknown:1", shares));
+  EXPECT_FALSE(dingodb::WeightedFairQueue::ParseShares("scan:0", shares));
+  EXPECT_FALSE(dingodb::WeightedFairQueue::ParseShares("scan", shares));
+}
+
+TEST_F(SimpleWorkerSetTest, FairQueue) {
+  dingodb::WeightedFairQueue fair_queue;
+
+  // tenant 1 floods scan, then tenant 2 issues point read
+  for (int i = 0; i < 100; ++i) {
+    auto task = std::make_shared<TempTestTask>();
+    task->SetQos(1, dingodb::QosRequestType::kScan);
+    fair_queue.Push(task);
+  }
+  for (int i = 0; i < 10; ++i) {
+    auto task = std::make_shared<TempTestTask>();
+    task->SetQos(2, dingodb::QosRequestType::kPointRead);
+    fair_queue.Push(task);
+  }
+  ASSERT_EQ(110, fair_queue.Size());
+
+  // point read is not queued behind all of the scan
+  int scan_count_before_last_point_read = 0;
+  int point_read_count = 0;
+  while (point_read_count < 10) {
+    auto task = fair_queue.Pop();
+    ASSERT_NE(nullptr, task);
+    if (task->TenantId() == 2) {
+      ++point_read_count;
+    } else {
+      ++scan_count_before_last_point_read;
+    }
+  }
+  EXPECT_LT(scan_count_before_last_point_read, 10);
+
+  // the same flow keeps fifo order
+  uint64_t last_id = 0;
+  while (!fair_queue.Empty()) {
+    auto task = fair_queue.Pop();
+    ASSERT_NE(nullptr, task);
+    EXPECT_GT(task->Id(), last_id);
+    last_id = task->Id();
+  }
+  EXPECT_EQ(nullptr, fair_queue.Pop());
+}
+
+TEST_F(SimpleWorkerSetTest, FairQueueUpdateCost) {
+  dingodb::WeightedFairQueue fair_queue;
+
+  int64_t init_cost = fair_queue.Cost(dingodb::QosRequestType::kScan);
+  for (int i = 0; i < 100; ++i) {
+    fair_queue.UpdateCost(dingodb::QosRequestType::kScan, init_cost * 10);
+  }
+  EXPECT_GT(fair_queue.Cost(dingodb::QosRequestType::kScan), init_cost * 9);
+}
+
+TEST_F(SimpleWorkerSetTest, CodelAdmission) {
+  // target 5ms, interval 100ms
+  dingodb::CodelAdmission admission(5000, 100000);
+  int64_t now_us = 1000000;
+
+  // sojourn time above target shortly is not overload
+  EXPECT_FALSE(admission.OnDequeue(10000, now_us));
+  EXPECT_FALSE(admission.OnDequeue(10000, now_us + 50000));
+  EXPECT_FALSE(admission.IsOverload());
+
+  // a good task reset the interval
+  EXPECT_FALSE(admission.OnDequeue(1000, now_us + 60000));
+  EXPECT_FALSE(admission.OnDequeue(10000, now_us + 70000));
+  EXPECT_FALSE(admission.OnDequeue(10000, now_us + 160000));
+  EXPECT_FALSE(admission.IsOverload());
+
+  // above target for a whole interval
+  EXPECT_TRUE(admission.OnDequeue(10000, now_us + 170000));
+  EXPECT_TRUE(admission.IsOverload());
+  EXPECT_FALSE(admission.OnDequeue(10000, now_us + 180000));
+  EXPECT_TRUE(admission.IsOverload());
+
+  // leave overload when sojourn time drop below target
+  EXPECT_FALSE(admission.OnDequeue(1000, now_us + 190000));
+  EXPECT_FALSE(admission.IsOverload());
+
+  // leave overload when queue drained
+  EXPECT_FALSE(admission.OnDequeue(10000, now_us + 200000));
+  EXPECT_TRUE(admission.OnDequeue(10000, now_us + 300000));
+  admission.Reset();
+  EXPECT_FALSE(admission.IsOverload());
+}
@@ -18,6 +18,7 @@
 #include <chrono>
 #include <cstdint>
 #include <iostream>
+#include <map>
 #include <memory>
 #include <thread>
 #include <vector>
@@ -105,6 +106,108 @@ TEST(DingoSafeMapTest, DingoSafeMapCopy) {
   EXPECT_EQ(map3.size(), 3);
 }
 
+TEST(DingoSafeMapTest, DingoSafeMapBatchModify) {
+  dingodb::DingoSafeMap<int64_t, int64_t> safe_map;
+  safe_map.Init(1000);
+  safe_map.Put(1, 1);
+  safe_map.Put(2, 2);
+
+  auto ret = safe_map.BatchModify([](butil::FlatMap<int64_t, int64_t>& map) -> size_t {
+    for (int64_t i = 3; i <= 10; ++i) {
+      map.insert(i, i);
+    }
+    map.erase(1);
+    return 1;
+  });
+  EXPECT_EQ(ret, 1);
+  EXPECT_EQ(safe_map.Size(), 9);
+  EXPECT_FALSE(safe_map.Exists(1));
+  EXPECT_EQ(safe_map.Get(10), 10);
+
+  // both buffers are modified
+  ret = safe_map.BatchModify([](butil::FlatMap<int64_t, int64_t>&) -> size_t { return 0; });
+  EXPECT_EQ(ret, -1);
+  EXPECT_EQ(safe_map.Size(), 9);
+  EXPECT_EQ(safe_map.Get(10), 10);
+}
+
+TEST(DingoShardedSafeMapTest, DingoShardedSafeMap) {
+  dingodb::DingoShardedSafeMap<int64_t, int64_t> safe_map(4);
+  safe_map.Init(1000);
+  safe_map.Put(1, 1);
+  EXPECT_EQ(safe_map.Get(1), 1);
+
+  EXPECT_EQ(safe_map.PutIfAbsent(1, 2), -1);
+  EXPECT_EQ(safe_map.Get(1), 1);
+
+  EXPECT_EQ(safe_map.PutIfNotEqual(1, 2), 1);
+  EXPECT_EQ(safe_map.Get(1), 2);
+
+  EXPECT_EQ(safe_map.PutIfExists(2, 2), -1);
+  int64_t value = 0;
+  EXPECT_EQ(safe_map.Get(2, value), -1);
+  EXPECT_EQ(value, 0);
+
+  std::vector<int64_t> key_list = {1, 2, 3, 4, 5, 6, 7, 8};
+  std::vector<int64_t> value_list = {1, 2, 3, 4, 5, 6, 7, 8};
+  EXPECT_EQ(safe_map.MultiPut(key_list, value_list), 1);
+  EXPECT_EQ(safe_map.Size(), 8);
+  for (auto key : key_list) {
+    EXPECT_EQ(safe_map.Get(key), key);
+  }
+
+  EXPECT_EQ(safe_map.PutIfEqual(3, 4), -1);
+  EXPECT_EQ(safe_map.PutIfEqual(3, 3), 1);
+
+  EXPECT_EQ(safe_map.MultiErase({1, 2}), 1);
+  EXPECT_FALSE(safe_map.Exists(1));
+  EXPECT_FALSE(safe_map.Exists(2));
+
+  std::vector<int64_t> values;
+  EXPECT_EQ(safe_map.GetAllValues(values, [](int64_t value) { return value > 6; }), 2);
+
+  std::map<int64_t, int64_t> key_values;
+  EXPECT_EQ(safe_map.GetAllKeyValues(key_values), 6);
+  EXPECT_EQ(key_values.begin()->first, 3);
+
+  butil::FlatMap<int64_t, int64_t> raw_map;
+  raw_map.init(100);
+  safe_map.GetRawMapCopy(raw_map);
+  EXPECT_EQ(raw_map.size(), 6);
+
+  raw_map.erase(3);
+  safe_map.CopyFromRawMap(raw_map);
+  EXPECT_EQ(safe_map.Size(), 5);
+  EXPECT_FALSE(safe_map.Exists(3));
+
+  safe_map.Clear();
+  EXPECT_EQ(safe_map.Size(), 0);
+}
+
+TEST(DingoShardedSafeMapTest, DingoShardedSafeMapConcurrent) {
+  dingodb::DingoShardedSafeMap<int64_t, int64_t> safe_map;
+  safe_map.Init(10000);
+
+  const int thread_num = 8;
+  const int key_num = 1000;
+  std::vector<std::thread> threads;
+  for (int i = 0; i < thread_num; ++i) {
+    threads.emplace_back([&safe_map, i]() {
+      for (int j = 0; j < key_num; ++j) {
+        safe_map.Put(i * key_num + j, j);
+        safe_map.Get(j);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  EXPECT_EQ(safe_map.Size(), thread_num * key_num);
+  std::vector<int64_t> keys;
+  EXPECT_EQ(safe_map.GetAllKeys(keys), thread_num * key_num);
+}
+
 TEST(DingoSafeStdMapTest, DingoSafeStdMapGetRangeValues) {
   dingodb::DingoSafeStdMap<std::string, std::string> safe_map;
 
@@ -325,6 +428,13 @@ TEST(DingoSafeStdMapTest, DingoSafeStdMapFindIntervalValues) {
   }
 
   EXPECT_EQ(ret, 1);
+
+  values.clear();
+  start_key = "wa";
+  end_key = "wz";
+  ret = safe_map.FindIntervalValues(values, start_key, end_key, nullptr, nullptr, 2);
+
+  EXPECT_EQ(ret, 2);
 }
 
 TEST(DingoSafeStdMapTest, DingoSafeStdMapMultiGet) {
@@ -18,6 +18,7 @@
 #include <sys/types.h>
 #include <unistd.h>
 
+#include <algorithm>
 #include <cstddef>
 #include <cstdint>
 #include <cstdio>
@@ -35,12 +36,16 @@
 #include "config/yaml_config.h"
 #include "crontab/crontab.h"
 #include "engine/rocks_raw_engine.h"
+#include "gflags/gflags.h"
 #include "proto/common.pb.h"
 #include "scan/scan.h"
 #include "scan/scan_manager.h"
 
 namespace dingodb {
 
+DECLARE_bool(scan_enable_prefetch_page);
+DECLARE_int64(scan_prefetch_memory_limit_bytes);
+
 static const std::string &kDefaultCf = "default";  // NOLINT
 
 static const std::vector<std::string> kAllCFs = {kDefaultCf};
@@ -784,6 +789,102 @@ TEST_F(ScanTest, scan) {
   this->DeleteScan();
 }
 
+TEST_F(ScanTest, ScanContinuePrefetch) {
+  auto raw_rocks_engine = this->GetRawRocksEngine();
+  std::string scan_id;
+
+  butil::Status ok;
+  FLAGS_scan_enable_prefetch_page = true;
+
+  // [keyAA, keyAA0, keyAAA, keyAAA0, keyAB, keyAB0, keyABB, keyABB0, keyABC, keyABC0, keyABD, keyABD0 ]
+  auto scan = this->GetScan(&scan_id);
+  EXPECT_NE(scan.get(), nullptr);
+  ok = scan->Open(scan_id, raw_rocks_engine, kDefaultCf);
+  EXPECT_EQ(ok.error_code(), dingodb::pb::error::Errno::OK);
+
+  pb::common::Range range;
+  range.set_start_key("keyAA");
+  range.set_end_key("keyZZ");
+
+  std::vector<pb::common::KeyValue> kvs;
+  ok = ScanHandler::ScanBegin(scan, 1, range, 3, false, true, true, {}, &kvs);
+  EXPECT_EQ(ok.error_code(), dingodb::pb::error::Errno::OK);
+  EXPECT_EQ(kvs.size(), 3);
+
+  // page size changed by client, the prefetched page is split or topped up by the next ones
+  std::vector<std::string> keys;
+  for (const auto &kv : kvs) {
+    keys.push_back(kv.key());
+  }
+  for (int64_t max_fetch_cnt : {2, 5, 1, 100, 100}) {
+    kvs.clear();
+    bool has_more = false;
+    ok = ScanHandler::ScanContinue(scan, scan_id, max_fetch_cnt, &kvs, has_more);
+    EXPECT_EQ(ok.error_code(), dingodb::pb::error::Errno::OK);
+    EXPECT_LE(kvs.size(), max_fetch_cnt);
+    for (const auto &kv : kvs) {
+      keys.push_back(kv.key());
+    }
+  }
+
+  EXPECT_EQ(keys.size(), 12);
+  EXPECT_TRUE(std::is_sorted(keys.begin(), keys.end()));
+  EXPECT_EQ(std::adjacent_find(keys.begin(), keys.end()), keys.end());
+
+  ok = ScanHandler::ScanRelease(scan, scan_id);
+  EXPECT_EQ(ok.error_code(), dingodb::pb::error::Errno::OK);
+
+  FLAGS_scan_enable_prefetch_page = false;
+  this->DeleteScan();
+}
+
+TEST_F(ScanTest, ScanContinuePrefetchPaused) {
+  auto raw_rocks_engine = this->GetRawRocksEngine();
+  std::string scan_id;
+
+  butil::Status ok;
+
+  // prefetch memory budget is used up, the pages are read by ScanContinue
+  int64_t old_limit = FLAGS_scan_prefetch_memory_limit_bytes;
+  FLAGS_scan_prefetch_memory_limit_bytes = 1;
+  FLAGS_scan_enable_prefetch_page = true;
+
+  auto scan = this->GetScan(&scan_id);
+  EXPECT_NE(scan.get(), nullptr);
+  ok = scan->Open(scan_id, raw_rocks_engine, kDefaultCf);
+  EXPECT_EQ(ok.error_code(), dingodb::pb::error::Errno::OK);
+
+  pb::common::Range range;
+  range.set_start_key("keyAA");
+  range.set_end_key("keyZZ");
+
+  std::vector<pb::common::KeyValue> kvs;
+  ok = ScanHandler::ScanBegin(scan, 1, range, 5, true, true, true, {}, &kvs);
+  EXPECT_EQ(ok.error_code(), dingodb::pb::error::Errno::OK);
+  EXPECT_EQ(kvs.size(), 5);
+
+  bool has_more = true;
+  int64_t count = kvs.size();
+  while (has_more) {
+    kvs.clear();
+    ok = ScanHandler::ScanContinue(scan, scan_id, 5, &kvs, has_more);
+    EXPECT_EQ(ok.error_code(), dingodb::pb::error::Errno::OK);
+    for (const auto &kv : kvs) {
+      // key only
+      EXPECT_TRUE(kv.value().empty());
+    }
+    count += kvs.size();
+  }
+  EXPECT_EQ(count, 12);
+
+  ok = ScanHandler::ScanRelease(scan, scan_id);
+  EXPECT_EQ(ok.error_code(), dingodb::pb::error::Errno::OK);
+
+  FLAGS_scan_prefetch_memory_limit_bytes = old_limit;
+  FLAGS_scan_enable_prefetch_page = false;
+  this->DeleteScan();
+}
+
 TEST_F(ScanTest, Init2) {
   auto raw_rocks_engine = this->GetRawRocksEngine();
   std::string scan_id;
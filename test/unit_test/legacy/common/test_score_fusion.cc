@@ -0,0 +1,88 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "common/score_fusion.h"
+#include "proto/common.pb.h"
+#include "proto/index.pb.h"
+
+namespace dingodb {
+
+class ScoreFusionTest : public testing::Test {};
+
+TEST_F(ScoreFusionTest, ReciprocalRank) {
+  ScoreFusion::RankedList vector_list = {{1, 0.9F}, {2, 0.8F}, {3, 0.7F}};
+  ScoreFusion::RankedList document_list = {{3, 10.0F}, {4, 9.0F}, {1, 1.0F}};
+
+  auto fused = ScoreFusion::ReciprocalRank({vector_list, document_list}, {}, 60, 10);
+  ASSERT_EQ(4, fused.size());
+  // 1: 1/61 + 1/63, 3: 1/63 + 1/61, tie broken by id
+  EXPECT_EQ(1, fused[0].id);
+  EXPECT_EQ(3, fused[1].id);
+  EXPECT_FLOAT_EQ(1.0F / 61 + 1.0F / 63, fused[0].score);
+  EXPECT_EQ(2, fused[2].id);
+  EXPECT_EQ(4, fused[3].id);
+
+  // weight document only
+  fused = ScoreFusion::ReciprocalRank({vector_list, document_list}, {0.0F, 1.0F}, 60, 2);
+  ASSERT_EQ(2, fused.size());
+  EXPECT_EQ(3, fused[0].id);
+  EXPECT_EQ(4, fused[1].id);
+}
+
+TEST_F(ScoreFusionTest, WeightedScore) {
+  ScoreFusion::RankedList vector_list = {{1, -0.1F}, {2, -0.5F}, {3, -0.9F}};
+  ScoreFusion::RankedList document_list = {{3, 30.0F}, {2, 20.0F}};
+
+  auto fused = ScoreFusion::WeightedScore({vector_list, document_list}, {0.5F, 0.5F}, 10);
+  ASSERT_EQ(3, fused.size());
+  // 1: 0.5 * 1, 2: 0.5 * 0.5 + 0, 3: 0 + 0.5 * 1
+  EXPECT_EQ(1, fused[0].id);
+  EXPECT_FLOAT_EQ(0.5F, fused[0].score);
+  EXPECT_EQ(3, fused[1].id);
+  EXPECT_FLOAT_EQ(0.5F, fused[1].score);
+  EXPECT_EQ(2, fused[2].id);
+  EXPECT_FLOAT_EQ(0.25F, fused[2].score);
+
+  // equal scores normalize to 1
+  fused = ScoreFusion::WeightedScore({{{7, 3.0F}, {8, 3.0F}}}, {}, 10);
+  ASSERT_EQ(2, fused.size());
+  EXPECT_FLOAT_EQ(1.0F, fused[0].score);
+  EXPECT_FLOAT_EQ(1.0F, fused[1].score);
+}
+
+TEST_F(ScoreFusionTest, FromResult) {
+  pb::index::VectorWithDistanceResult vector_result;
+  auto* vector_with_distance = vector_result.add_vector_with_distances();
+  vector_with_distance->mutable_vector_with_id()->set_id(5);
+  vector_with_distance->set_distance(0.25F);
+  auto vector_list = ScoreFusion::FromVectorResult(vector_result);
+  ASSERT_EQ(1, vector_list.size());
+  EXPECT_EQ(5, vector_list[0].id);
+  EXPECT_FLOAT_EQ(-0.25F, vector_list[0].score);
+
+  google::protobuf::RepeatedPtrField<pb::common::DocumentWithScore> document_result;
+  auto* document_with_score = document_result.Add();
+  document_with_score->mutable_document_with_id()->set_id(6);
+  document_with_score->set_score(2.5F);
+  auto document_list = ScoreFusion::FromDocumentResult(document_result);
+  ASSERT_EQ(1, document_list.size());
+  EXPECT_EQ(6, document_list[0].id);
+  EXPECT_FLOAT_EQ(2.5F, document_list[0].score);
+}
+
+}  // namespace dingodb
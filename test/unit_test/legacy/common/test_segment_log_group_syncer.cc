@@ -0,0 +1,98 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <fcntl.h>
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <string>
+#include <vector>
+
+#include "bthread/bthread.h"
+#include "common/helper.h"
+#include "log/segment_log_group_syncer.h"
+
+namespace dingodb {
+
+static const std::string kGroupSyncerPath = "./unit_test_segment_log_group_syncer";
+
+class SegmentLogGroupSyncerTest : public testing::Test {
+ protected:
+  static void SetUpTestSuite() { Helper::CreateDirectories(kGroupSyncerPath); }
+  static void TearDownTestSuite() { Helper::RemoveAllFileOrDirectory(kGroupSyncerPath); }
+
+  struct Arg {
+    SegmentLogGroupSyncer* syncer;
+    int fd;
+    std::atomic<int>* failed_count;
+  };
+
+  static void* SyncFunc(void* arg) {
+    auto* sync_arg = static_cast<Arg*>(arg);
+    for (int i = 0; i < 10; ++i) {
+      std::string data = "raft log " + std::to_string(i);
+      if (write(sync_arg->fd, data.data(), data.size()) != static_cast<ssize_t>(data.size()) ||
+          sync_arg->syncer->Sync(sync_arg->fd) != 0) {
+        sync_arg->failed_count->fetch_add(1);
+      }
+    }
+    return nullptr;
+  }
+
+  static void ConcurrentSync(SegmentLogGroupSyncer& syncer) {
+    const int region_num = 8;
+    std::vector<int> fds;
+    for (int i = 0; i < region_num; ++i) {
+      std::string path = kGroupSyncerPath + "/log_" + std::to_string(i);
+      int fd = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+      ASSERT_GE(fd, 0);
+      fds.push_back(fd);
+    }
+
+    std::atomic<int> failed_count{0};
+    std::vector<Arg> args;
+    args.reserve(region_num);
+    std::vector<bthread_t> tids(region_num);
+    for (int i = 0; i < region_num; ++i) {
+      args.push_back(Arg{&syncer, fds[i], &failed_count});
+      ASSERT_EQ(0, bthread_start_background(&tids[i], nullptr, SyncFunc, &args[i]));
+    }
+    for (auto tid : tids) {
+      bthread_join(tid, nullptr);
+    }
+
+    EXPECT_EQ(0, failed_count.load());
+    for (int fd : fds) {
+      close(fd);
+    }
+  }
+};
+
+TEST_F(SegmentLogGroupSyncerTest, Syncfs) {
+  SegmentLogGroupSyncer syncer(100, true);
+  ConcurrentSync(syncer);
+}
+
+TEST_F(SegmentLogGroupSyncerTest, Fdatasync) {
+  SegmentLogGroupSyncer syncer(0, false);
+  ConcurrentSync(syncer);
+}
+
+TEST_F(SegmentLogGroupSyncerTest, BadFd) {
+  SegmentLogGroupSyncer syncer(0, true);
+  EXPECT_NE(0, syncer.Sync(-1));
+}
+
+}  // namespace dingodb
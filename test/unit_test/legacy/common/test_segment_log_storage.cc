@@ -13,6 +13,7 @@
 // limitations under the License.
 
 #include <gtest/gtest.h>
+#include <sys/stat.h>
 
 #include <cstdint>
 #include <memory>
@@ -20,6 +21,7 @@
 #include <string>
 
 #include "braft/log_entry.h"
+#include "butil/strings/stringprintf.h"
 #include "common/helper.h"
 #include "log/segment_log_storage.h"
 #include "proto/raft.pb.h"
@@ -122,4 +124,33 @@ TEST_F(SegmentLogStorageTest, GetEntrys) {
   auto log_entrys = log_stroage->GetEntrys(begin_index, end_index);
 
   EXPECT_EQ(end_index - begin_index + 1, log_entrys.size());
-}
\ No newline at end of file
+}
+TEST_F(SegmentLogStorageTest, ReleasePreallocatedAfterReload) {
+  const std::string path = kLogPath + "/preallocate";
+  dingodb::Helper::CreateDirectories(path);
+
+  const int64_t preallocate_bytes = 4 * 1024 * 1024;
+  const std::string open_path = path + butil::StringPrintf("/log_inprogress_%020d", 1);
+  {
+    dingodb::Segment segment(1, path, 1, 0);
+    ASSERT_EQ(0, segment.Create(preallocate_bytes));
+  }
+
+  struct stat st_buf;
+  ASSERT_EQ(0, ::stat(open_path.c_str(), &st_buf));
+  if (st_buf.st_blocks * 512 < preallocate_bytes) {
+    GTEST_SKIP() << "fallocate is not supported";
+  }
+
+  // restart, the reloaded open segment still releases the preallocated tail on close
+  dingodb::Segment segment(1, path, 1, 0);
+  braft::ConfigurationManager configuration_manager;
+  ASSERT_EQ(0, segment.Load(&configuration_manager));
+  ASSERT_EQ(0, segment.Close(false));
+
+  const std::string closed_path = path + butil::StringPrintf("/log_%020d_%020d", 1, 0);
+  ASSERT_EQ(0, ::stat(closed_path.c_str(), &st_buf));
+  EXPECT_LT(st_buf.st_blocks * 512, preallocate_bytes);
+
+  dingodb::Helper::RemoveAllFileOrDirectory(path);
+}
@@ -24,6 +24,7 @@
 #include "common/helper.h"
 #include "config/yaml_config.h"
 #include "engine/rocks_raw_engine.h"
+#include "fmt/core.h"
 #include "proto/common.pb.h"
 #include "split/split_checker.h"
 
@@ -290,4 +291,81 @@ TEST_F(SplitCheckerTest, KeysSplitKeys) {  // NOLINT
   writer->KvDeleteRange(kAllCFs, range);
 }
 
+TEST_F(SplitCheckerTest, HalfSplitKeysByApproximateSize) {  // NOLINT
+  // Ready data, flush to sst for approximate size.
+  auto writer = SplitCheckerTest::engine->Writer();
+  dingodb::pb::common::KeyValue kv;
+  for (int i = 0; i < 10000; ++i) {
+    kv.set_key(fmt::format("pp{:06}", i));
+    kv.set_value(GenRandomString(512));
+    for (const auto& cf_name : kAllCFs) {
+      writer->KvPut(cf_name, kv);
+    }
+  }
+  for (const auto& cf_name : kAllCFs) {
+    SplitCheckerTest::engine->Flush(cf_name);
+  }
+
+  uint32_t split_threshold_size = 64 * 1024;
+  uint32_t split_chunk_size = 64 * 1024;
+  auto split_checker =
+      std::make_shared<HalfSplitChecker>(SplitCheckerTest::engine, split_threshold_size, split_chunk_size);
+
+  uint32_t count = 0;
+  std::vector<std::string> raft_addrs;
+  dingodb::pb::common::Range range;
+  range.set_start_key("pp");
+  range.set_end_key("pq");
+  auto region = BuildRegion(1000, "unit_test", raft_addrs, range.start_key(), range.end_key());
+  auto split_key = split_checker->SplitKey(region, region->Range(), kAllCFs, count);
+  EXPECT_FALSE(split_key.empty());
+
+  auto reader = SplitCheckerTest::engine->Reader();
+  int64_t left_count = 0;
+  reader->KvCount(kDefaultCf, range.start_key(), split_key, left_count);
+  int64_t right_count = 0;
+  reader->KvCount(kDefaultCf, split_key, range.end_key(), right_count);
+  EXPECT_EQ(10000, left_count + right_count);
+  EXPECT_TRUE(abs(static_cast<int>(left_count - right_count)) < 2000);
+
+  // Clean
+  writer->KvDeleteRange(kAllCFs, range);
+}
+
+TEST_F(SplitCheckerTest, LoadSplitKeys) {  // NOLINT
+  std::vector<std::string> raft_addrs;
+  auto region = BuildRegion(1000, "unit_test", raft_addrs, "aa", "zz");
+  uint32_t count = 0;
+
+  // Most load on the head keys, the split key balance the samples rather than the key space.
+  std::vector<std::string> sample_keys;
+  for (int i = 0; i < 900; ++i) {
+    sample_keys.push_back(fmt::format("bb{:04}", i));
+  }
+  for (int i = 0; i < 100; ++i) {
+    sample_keys.push_back(fmt::format("xx{:04}", i));
+  }
+  // out of region range
+  sample_keys.push_back("zzz");
+
+  LoadSplitChecker split_checker(sample_keys, 0.8);
+  EXPECT_EQ("LOAD", split_checker.GetPolicyName());
+  auto split_key = split_checker.SplitKey(region, region->Range(), kAllCFs, count);
+  EXPECT_EQ("bb0500", split_key);
+
+  // One hot key can't be balanced by split.
+  std::vector<std::string> hot_keys(1000, "hh");
+  hot_keys.push_back("aa01");
+  LoadSplitChecker hot_split_checker(hot_keys, 0.8);
+  EXPECT_TRUE(hot_split_checker.SplitKey(region, region->Range(), kAllCFs, count).empty());
+
+  // Hot key at the tail, split before it.
+  std::vector<std::string> tail_keys(600, "yy");
+  for (int i = 0; i < 400; ++i) {
+    tail_keys.push_back(fmt::format("cc{:04}", i));
+  }
+  LoadSplitChecker tail_split_checker(tail_keys, 0.8);
+  EXPECT_EQ("yy", tail_split_checker.SplitKey(region, region->Range(), kAllCFs, count));
+}
+
 }  // namespace dingodb
\ No newline at end of file
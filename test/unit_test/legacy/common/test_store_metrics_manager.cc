@@ -144,4 +144,42 @@ TEST_F(StoreRegionMetricsTest, GetRegionMinKey) {
   std::vector<std::string> raft_addrs;
   dingodb::store::RegionPtr region = BuildRegion(11111, "unit-test-01", raft_addrs);
   EXPECT_EQ("", store_region_metrics->GetRegionMinKey(region));
-}
\ No newline at end of file
+}
+
+TEST(RegionMetricsTest, IncrementalKeyCount) {
+  auto region_metrics = dingodb::StoreRegionMetrics::NewMetrics(22222);
+
+  int64_t key_count = 0;
+  region_metrics->AddKeyCountDelta(3, 10);
+  EXPECT_FALSE(region_metrics->GetTrustedKeyCount(key_count));
+
+  // the count is started before log 10 is applied
+  EXPECT_FALSE(region_metrics->VerifyKeyCount(0, 9));
+  EXPECT_FALSE(region_metrics->GetTrustedKeyCount(key_count));
+
+  EXPECT_TRUE(region_metrics->VerifyKeyCount(5, 10));
+  EXPECT_TRUE(region_metrics->GetTrustedKeyCount(key_count));
+  EXPECT_EQ(5, key_count);
+  EXPECT_LT(0, region_metrics->KeyCountVerifyTimeMs());
+
+  region_metrics->AddKeyCountDelta(-2, 11);
+  region_metrics->AddKeyCountDelta(4, 12);
+  EXPECT_TRUE(region_metrics->GetTrustedKeyCount(key_count));
+  EXPECT_EQ(7, key_count);
+
+  // the count is corrected by verification
+  EXPECT_TRUE(region_metrics->VerifyKeyCount(6, 12));
+  EXPECT_TRUE(region_metrics->GetTrustedKeyCount(key_count));
+  EXPECT_EQ(6, key_count);
+
+  // snapshot load at 20
+  region_metrics->InvalidateKeyCount(20);
+  EXPECT_FALSE(region_metrics->GetTrustedKeyCount(key_count));
+  EXPECT_FALSE(region_metrics->VerifyKeyCount(6, 12));
+  EXPECT_TRUE(region_metrics->VerifyKeyCount(100, 20));
+  EXPECT_TRUE(region_metrics->GetTrustedKeyCount(key_count));
+  EXPECT_EQ(100, key_count);
+
+  region_metrics->ResetMetricsForRegionVersionUpdate();
+  EXPECT_FALSE(region_metrics->GetTrustedKeyCount(key_count));
+}
@@ -0,0 +1,101 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "common/helper.h"
+#include "coordinator/coordinator_control.h"
+#include "gflags/gflags.h"
+#include "proto/common.pb.h"
+#include "proto/meta.pb.h"
+
+namespace dingodb {
+
+DECLARE_bool(enable_table_pre_split);
+
+static pb::common::Range NewRange(const std::string& start_key, const std::string& end_key) {
+  pb::common::Range range;
+  range.set_start_key(start_key);
+  range.set_end_key(end_key);
+  return range;
+}
+
+TEST(TablePreSplitTest, ParsePreSplitKeys) {
+  std::vector<std::pair<std::string, int64_t>> keys;
+  auto status = CoordinatorControl::ParsePreSplitKeys(
+      Helper::StringToHex(std::string("b")) + "," + Helper::StringToHex(std::string("c")) + ":10", keys);
+  ASSERT_TRUE(status.ok());
+  ASSERT_EQ(2, keys.size());
+  EXPECT_EQ("b", keys[0].first);
+  EXPECT_EQ(1, keys[0].second);
+  EXPECT_EQ("c", keys[1].first);
+  EXPECT_EQ(10, keys[1].second);
+
+  keys.clear();
+  EXPECT_FALSE(CoordinatorControl::ParsePreSplitKeys("abc", keys).ok());
+  EXPECT_FALSE(CoordinatorControl::ParsePreSplitKeys("61:0", keys).ok());
+}
+
+TEST(TablePreSplitTest, CalcPreSplitKeys) {
+  auto range = NewRange("a", "z");
+
+  std::vector<std::pair<std::string, int64_t>> keys;
+  for (char c = 'b'; c <= 'i'; ++c) {
+    keys.emplace_back(std::string(1, c), 1);
+  }
+  // out of range keys are ignored
+  keys.emplace_back("a", 100);
+  keys.emplace_back("zz", 100);
+
+  auto split_keys = CoordinatorControl::CalcPreSplitKeys(keys, range, 4);
+  EXPECT_EQ((std::vector<std::string>{"d", "f", "h"}), split_keys);
+
+  EXPECT_TRUE(CoordinatorControl::CalcPreSplitKeys(keys, range, 1).empty());
+
+  // histogram, the heavy bucket gets its own region
+  std::vector<std::pair<std::string, int64_t>> histogram = {{"c", 1}, {"m", 100}, {"x", 1}};
+  split_keys = CoordinatorControl::CalcPreSplitKeys(histogram, range, 2);
+  EXPECT_EQ((std::vector<std::string>{"x"}), split_keys);
+}
+
+TEST(TablePreSplitTest, PreSplitPartRanges) {
+  auto part_range = NewRange("a", "z");
+  pb::meta::TableDefinition table_definition;
+  (*table_definition.mutable_properties())["pre_split_keys"] =
+      Helper::StringToHex(std::string("h")) + "," + Helper::StringToHex(std::string("p"));
+
+  std::vector<pb::common::Range> ranges;
+  FLAGS_enable_table_pre_split = false;
+  ASSERT_TRUE(CoordinatorControl::PreSplitPartRanges(table_definition, part_range, ranges).ok());
+  EXPECT_EQ(1, ranges.size());
+
+  FLAGS_enable_table_pre_split = true;
+  ASSERT_TRUE(CoordinatorControl::PreSplitPartRanges(table_definition, part_range, ranges).ok());
+  ASSERT_EQ(3, ranges.size());
+  EXPECT_EQ("a", ranges[0].start_key());
+  EXPECT_EQ("h", ranges[0].end_key());
+  EXPECT_EQ("h", ranges[1].start_key());
+  EXPECT_EQ("p", ranges[1].end_key());
+  EXPECT_EQ("p", ranges[2].start_key());
+  EXPECT_EQ("z", ranges[2].end_key());
+  FLAGS_enable_table_pre_split = false;
+}
+
+}  // namespace dingodb
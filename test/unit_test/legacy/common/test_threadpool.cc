@@ -102,6 +102,84 @@ TEST_F(ThreadPoolTest, ExecuteTaskPriority) {
   ASSERT_EQ(1, run_orders[2]);
 }
 
+TEST_F(ThreadPoolTest, ExecuteTaskMultiSubmitter) {
+  dingodb::ThreadPool thread_pool("unit_test", 4);
+
+  int submitter_num = 4;
+  int task_num = 10000;
+  std::atomic<int> count = 0;
+
+  std::vector<std::thread> submitters;
+  for (int i = 0; i < submitter_num; ++i) {
+    submitters.emplace_back([&thread_pool, &count, task_num]() {
+      std::vector<dingodb::ThreadPool::TaskPtr> tasks;
+      for (int j = 0; j < task_num; ++j) {
+        auto task = thread_pool.ExecuteTask([&count](void *) { count.fetch_add(1); }, nullptr, j % 2);
+        ASSERT_NE(nullptr, task);
+        tasks.push_back(task);
+      }
+
+      for (auto &task : tasks) {
+        task->Join();
+      }
+    });
+  }
+
+  for (auto &submitter : submitters) {
+    submitter.join();
+  }
+
+  ASSERT_EQ(submitter_num * task_num, count.load());
+  ASSERT_EQ(0, thread_pool.PendingTaskCount());
+}
+
+TEST_F(ThreadPoolTest, DestroyDrainTask) {
+  dingodb::ThreadPool thread_pool("unit_test", 3);
+
+  std::atomic<int> count = 0;
+  for (int i = 0; i < 1000; ++i) {
+    ASSERT_NE(nullptr, thread_pool.ExecuteTask([&count](void *) { count.fetch_add(1); }, nullptr));
+  }
+
+  thread_pool.Destroy();
+
+  ASSERT_EQ(1000, count.load());
+}
+
+TEST_F(ThreadPoolTest, ExecuteTaskByNumaNode) {
+  dingodb::ThreadPool thread_pool("unit_test", 4, nullptr, true);
+
+  std::atomic<int> count = 0;
+  std::vector<dingodb::ThreadPool::TaskPtr> tasks;
+  for (int64_t region_id = 0; region_id < 1000; ++region_id) {
+    auto task = thread_pool.ExecuteTaskByNumaNode(region_id, [&count](void *) { count.fetch_add(1); }, nullptr,
+                                                  region_id % 2);
+    ASSERT_NE(nullptr, task);
+    tasks.push_back(task);
+  }
+
+  for (auto &task : tasks) {
+    task->Join();
+  }
+
+  ASSERT_EQ(1000, count.load());
+
+  // tasks of node without thread are stolen by other node
+  thread_pool.AdjustPoolSize(1);
+  tasks.clear();
+  for (int64_t region_id = 0; region_id < 100; ++region_id) {
+    auto task = thread_pool.ExecuteTaskByNumaNode(region_id, [&count](void *) { count.fetch_add(1); }, nullptr);
+    ASSERT_NE(nullptr, task);
+    tasks.push_back(task);
+  }
+
+  for (auto &task : tasks) {
+    task->Join();
+  }
+
+  ASSERT_EQ(1100, count.load());
+}
+
 static int GetThreadPolicy(pthread_attr_t &attr) {
   int policy;
   int rs = pthread_attr_getschedpolicy(&attr, &policy);
@@ -0,0 +1,121 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <random>
+#include <vector>
+
+#include "common/timer_wheel.h"
+
+namespace dingodb {
+
+TEST(TimerWheelTest, Basic) {
+  TimerWheel timer_wheel(100);
+  timer_wheel.Add(1, 100);
+  timer_wheel.Add(2, 105);
+  timer_wheel.Add(3, 100 + 64 * 3 + 7);
+  timer_wheel.Add(4, 90);
+  EXPECT_EQ(4, timer_wheel.Size());
+
+  std::vector<int64_t> expired_ids;
+  timer_wheel.Advance(104, expired_ids);
+  std::sort(expired_ids.begin(), expired_ids.end());
+  EXPECT_EQ(std::vector<int64_t>({1, 4}), expired_ids);
+
+  expired_ids.clear();
+  timer_wheel.Advance(105, expired_ids);
+  EXPECT_EQ(std::vector<int64_t>({2}), expired_ids);
+
+  expired_ids.clear();
+  timer_wheel.Advance(100 + 64 * 3 + 6, expired_ids);
+  EXPECT_TRUE(expired_ids.empty());
+  timer_wheel.Advance(100 + 64 * 3 + 7, expired_ids);
+  EXPECT_EQ(std::vector<int64_t>({3}), expired_ids);
+  EXPECT_EQ(0, timer_wheel.Size());
+}
+
+TEST(TimerWheelTest, RescheduleAndRemove) {
+  TimerWheel timer_wheel(0);
+  timer_wheel.Add(1, 10);
+  timer_wheel.Add(2, 10);
+  // renew
+  timer_wheel.Add(1, 5000);
+  timer_wheel.Remove(2);
+  EXPECT_FALSE(timer_wheel.Exists(2));
+
+  std::vector<int64_t> expired_ids;
+  timer_wheel.Advance(4999, expired_ids);
+  EXPECT_TRUE(expired_ids.empty());
+  timer_wheel.Advance(5000, expired_ids);
+  EXPECT_EQ(std::vector<int64_t>({1}), expired_ids);
+}
+
+TEST(TimerWheelTest, Clear) {
+  TimerWheel timer_wheel(0);
+  timer_wheel.Add(1, 10);
+  timer_wheel.Clear(1000000);
+  EXPECT_EQ(0, timer_wheel.Size());
+  EXPECT_EQ(1000000, timer_wheel.CurrentTick());
+
+  timer_wheel.Add(2, 1000010);
+  std::vector<int64_t> expired_ids;
+  timer_wheel.Advance(1000010, expired_ids);
+  EXPECT_EQ(std::vector<int64_t>({2}), expired_ids);
+}
+
+TEST(TimerWheelTest, Random) {
+  std::mt19937 rng(12345);
+  const int64_t start_tick = 1700000000;
+  TimerWheel timer_wheel(start_tick);
+  std::map<int64_t, int64_t> expected;  // id -> expire tick
+
+  int64_t now = start_tick;
+  for (int round = 0; round < 2000; ++round) {
+    for (int i = 0; i < 20; ++i) {
+      int64_t id = rng() % 5000;
+      int r = rng() % 10;
+      if (r == 0) {
+        timer_wheel.Remove(id);
+        expected.erase(id);
+      } else {
+        int64_t expire_tick = now + (r < 8 ? rng() % 300 : rng() % 300000);
+        timer_wheel.Add(id, expire_tick);
+        expected[id] = expire_tick;
+      }
+    }
+
+    now += rng() % 7;
+    std::vector<int64_t> expired_ids;
+    timer_wheel.Advance(now, expired_ids);
+    std::sort(expired_ids.begin(), expired_ids.end());
+
+    std::vector<int64_t> expected_ids;
+    for (auto it = expected.begin(); it != expected.end();) {
+      if (it->second <= now) {
+        expected_ids.push_back(it->first);
+        it = expected.erase(it);
+      } else {
+        ++it;
+      }
+    }
+    ASSERT_EQ(expected_ids, expired_ids) << "round " << round << " now " << now;
+    ASSERT_EQ(expected.size(), timer_wheel.Size());
+  }
+}
+
+}  // namespace dingodb
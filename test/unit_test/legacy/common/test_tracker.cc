@@ -22,6 +22,15 @@
 #include "common/tracker.h"
 #include "common/uuid.h"
 #include "fmt/core.h"
+#include "gflags/gflags.h"
+
+namespace dingodb {
+
+DECLARE_bool(enable_tracker_stats);
+DECLARE_int32(tracker_sample_interval);
+DECLARE_int32(tracker_sample_ring_size);
+
+}  // namespace dingodb
 
 class TrackerTest : public testing::Test {
  protected:
@@ -61,4 +70,29 @@ TEST_F(TrackerTest, SetTime) {
   ASSERT_LE(1 * ms * 1000 * 1000, tracker->RaftQueueWaitTime());
   ASSERT_LE(1 * ms * 1000 * 1000, tracker->RaftApplyTime());
   ASSERT_LE(6 * ms * 1000 * 1000, tracker->TotalRpcTime());
-}
\ No newline at end of file
+}
+
+TEST_F(TrackerTest, StatsSampleRing) {
+  dingodb::FLAGS_enable_tracker_stats = true;
+  dingodb::FLAGS_tracker_sample_interval = 1;
+  dingodb::FLAGS_tracker_sample_ring_size = 4;
+
+  for (int i = 0; i < 10; ++i) {
+    dingodb::pb::common::RequestInfo request_info;
+    request_info.set_request_id(i);
+    auto tracker = dingodb::Tracker::New(request_info);
+    tracker->SetTotalRpcTime();
+    dingodb::TrackerStats::GetInstance().Record("TrackerTest", 1000 + i, dingodb::pb::common::INDEX_REGION,
+                                                *tracker);
+  }
+
+  // keep the latest sampled traces, oldest first
+  auto traces = dingodb::TrackerStats::GetInstance().GetSampledTraces();
+  ASSERT_EQ(4, traces.size());
+  for (int i = 0; i < 4; ++i) {
+    ASSERT_NE(std::string::npos, traces[i].find(fmt::format("request_id({})", 6 + i))) << traces[i];
+    ASSERT_NE(std::string::npos, traces[i].find("region_class(index)")) << traces[i];
+  }
+
+  dingodb::FLAGS_enable_tracker_stats = false;
+}
@@ -0,0 +1,108 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include "butil/status.h"
+#include "coordinator/tso_batcher.h"
+#include "proto/error.pb.h"
+
+namespace dingodb {
+
+TEST(TsoBatcherTest, Single) {
+  int64_t next_ts = 100;
+  TsoBatcher tso_batcher(
+      [&next_ts](int64_t count, int64_t& start_ts) -> butil::Status {
+        EXPECT_EQ(1, count);
+        start_ts = next_ts;
+        next_ts += count;
+        return butil::Status::OK();
+      },
+      16);
+
+  int64_t tso = 0;
+  EXPECT_TRUE(tso_batcher.GetTso(tso).ok());
+  EXPECT_EQ(100, tso);
+  EXPECT_TRUE(tso_batcher.GetTso(tso).ok());
+  EXPECT_EQ(101, tso);
+  EXPECT_EQ(2, tso_batcher.FetchCount());
+}
+
+TEST(TsoBatcherTest, Error) {
+  TsoBatcher tso_batcher(
+      [](int64_t, int64_t&) -> butil::Status { return butil::Status(pb::error::Errno::EINTERNAL, "fetch fail"); }, 16);
+
+  int64_t tso = 0;
+  auto status = tso_batcher.GetTso(tso);
+  EXPECT_FALSE(status.ok());
+  EXPECT_EQ(pb::error::Errno::EINTERNAL, status.error_code());
+}
+
+TEST(TsoBatcherTest, Concurrent) {
+  const int thread_num = 16;
+  const int req_num = 200;
+  const int64_t max_batch_count = 8;
+
+  std::atomic<int64_t> next_ts{1};
+  std::atomic<int64_t> max_count{0};
+  TsoBatcher tso_batcher(
+      [&](int64_t count, int64_t& start_ts) -> butil::Status {
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+        int64_t old_max = max_count.load();
+        while (count > old_max && !max_count.compare_exchange_weak(old_max, count)) {
+        }
+        start_ts = next_ts.fetch_add(count);
+        return butil::Status::OK();
+      },
+      max_batch_count);
+
+  std::vector<std::vector<int64_t>> results(thread_num);
+  std::vector<std::thread> threads;
+  threads.reserve(thread_num);
+  for (int i = 0; i < thread_num; ++i) {
+    threads.emplace_back([&, i]() {
+      for (int j = 0; j < req_num; ++j) {
+        int64_t tso = 0;
+        ASSERT_TRUE(tso_batcher.GetTso(tso).ok());
+        results[i].push_back(tso);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  std::set<int64_t> all_tsos;
+  for (const auto& tsos : results) {
+    for (size_t i = 1; i < tsos.size(); ++i) {
+      EXPECT_LT(tsos[i - 1], tsos[i]);
+    }
+    all_tsos.insert(tsos.begin(), tsos.end());
+  }
+
+  // every timestamp is unique and allocated
+  EXPECT_EQ(thread_num * req_num, all_tsos.size());
+  EXPECT_EQ(next_ts.load() - 1, all_tsos.size());
+  EXPECT_LE(max_count.load(), max_batch_count);
+  EXPECT_LE(tso_batcher.FetchCount(), thread_num * req_num);
+}
+
+}  // namespace dingodb
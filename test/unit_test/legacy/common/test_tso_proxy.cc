@@ -0,0 +1,90 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdint>
+#include <thread>
+
+#include "butil/status.h"
+#include "coordinator/tso_proxy.h"
+#include "proto/error.pb.h"
+
+namespace dingodb {
+
+TEST(TsoProxyTest, Window) {
+  int64_t next_ts = 100;
+  TsoProxy tso_proxy(
+      [&next_ts](int64_t count, int64_t& start_ts) -> butil::Status {
+        EXPECT_EQ(4, count);
+        start_ts = next_ts;
+        next_ts += count + 10;
+        return butil::Status::OK();
+      },
+      4, 60 * 1000);
+
+  int64_t tso = 0;
+  for (int64_t i = 0; i < 4; ++i) {
+    EXPECT_TRUE(tso_proxy.GetTso(tso).ok());
+    EXPECT_EQ(100 + i, tso);
+  }
+  EXPECT_EQ(1, tso_proxy.FetchCount());
+
+  // window exhausted
+  EXPECT_TRUE(tso_proxy.GetTso(tso).ok());
+  EXPECT_EQ(114, tso);
+  EXPECT_EQ(2, tso_proxy.FetchCount());
+}
+
+TEST(TsoProxyTest, LeaseExpire) {
+  int64_t next_ts = 100;
+  TsoProxy tso_proxy(
+      [&next_ts](int64_t count, int64_t& start_ts) -> butil::Status {
+        start_ts = next_ts;
+        next_ts += count;
+        return butil::Status::OK();
+      },
+      1024, 10);
+
+  int64_t tso = 0;
+  EXPECT_TRUE(tso_proxy.GetTso(tso).ok());
+  EXPECT_EQ(100, tso);
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  EXPECT_TRUE(tso_proxy.GetTso(tso).ok());
+  EXPECT_EQ(1124, tso);
+  EXPECT_EQ(2, tso_proxy.FetchCount());
+}
+
+TEST(TsoProxyTest, Fallback) {
+  int64_t next_ts = 100;
+  TsoProxy tso_proxy(
+      [&next_ts](int64_t count, int64_t& start_ts) -> butil::Status {
+        start_ts = next_ts;
+        next_ts -= count;
+        return butil::Status::OK();
+      },
+      1, 60 * 1000);
+
+  int64_t tso = 0;
+  EXPECT_TRUE(tso_proxy.GetTso(tso).ok());
+  EXPECT_EQ(100, tso);
+
+  auto status = tso_proxy.GetTso(tso);
+  EXPECT_FALSE(status.ok());
+  EXPECT_EQ(pb::error::Errno::EINTERNAL, status.error_code());
+}
+
+}  // namespace dingodb
@@ -0,0 +1,75 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "engine/txn_deadlock_detector.h"
+
+namespace dingodb {
+
+TEST(TxnDeadlockDetectorTest, Cycle) {
+  TxnDeadlockDetector detector;
+  std::vector<int64_t> cycle;
+
+  // 1 -> 2 -> 3 -> 4
+  EXPECT_TRUE(detector.AddEdge(1, 2, cycle));
+  EXPECT_TRUE(detector.AddEdge(2, 3, cycle));
+  EXPECT_TRUE(detector.AddEdge(3, 4, cycle));
+  // 1 -> 3 is not a cycle
+  EXPECT_TRUE(detector.AddEdge(1, 3, cycle));
+  EXPECT_TRUE(cycle.empty());
+  EXPECT_EQ(4, detector.EdgeCount());
+
+  EXPECT_FALSE(detector.AddEdge(4, 1, cycle));
+  EXPECT_EQ(4, detector.EdgeCount());
+  ASSERT_GE(cycle.size(), 3);
+  EXPECT_EQ(4, cycle.front());
+  EXPECT_EQ(1, cycle[1]);
+  EXPECT_EQ(3, cycle.back());
+  EXPECT_EQ(4, TxnDeadlockDetector::ChooseVictim(cycle));
+
+  EXPECT_FALSE(detector.AddEdge(3, 2, cycle));
+  EXPECT_EQ((std::vector<int64_t>{3, 2}), cycle);
+
+  // break the cycle
+  detector.RemoveEdge(3, 4);
+  EXPECT_TRUE(detector.AddEdge(4, 1, cycle));
+  EXPECT_EQ(4, detector.EdgeCount());
+}
+
+TEST(TxnDeadlockDetectorTest, EdgeCount) {
+  TxnDeadlockDetector detector;
+  std::vector<int64_t> cycle;
+
+  // two requests of txn 1 wait for txn 2
+  EXPECT_TRUE(detector.AddEdge(1, 2, cycle));
+  EXPECT_TRUE(detector.AddEdge(1, 2, cycle));
+  EXPECT_EQ(1, detector.EdgeCount());
+
+  detector.RemoveEdge(1, 2);
+  EXPECT_FALSE(detector.AddEdge(2, 1, cycle));
+  detector.RemoveEdge(1, 2);
+  EXPECT_EQ(0, detector.EdgeCount());
+  EXPECT_TRUE(detector.AddEdge(2, 1, cycle));
+
+  // remove not exist edge
+  detector.RemoveEdge(5, 6);
+  EXPECT_EQ(1, detector.EdgeCount());
+}
+
+}  // namespace dingodb
@@ -0,0 +1,86 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "common/helper.h"
+#include "engine/txn_gc_compaction_filter.h"
+#include "proto/store.pb.h"
+#include "rocksdb/compaction_filter.h"
+
+namespace dingodb {
+
+using Decision = rocksdb::CompactionFilter::Decision;
+using ValueType = rocksdb::CompactionFilter::ValueType;
+
+static std::string GenWriteValue(pb::store::Op op, int64_t start_ts, const std::string& short_value) {
+  pb::store::WriteInfo write_info;
+  write_info.set_op(op);
+  write_info.set_start_ts(start_ts);
+  write_info.set_short_value(short_value);
+  return write_info.SerializeAsString();
+}
+
+static Decision Filter(const TxnGcCompactionFilter& filter, const std::string& key, int64_t write_ts,
+                       pb::store::Op op, int64_t start_ts, const std::string& short_value = "") {
+  std::string write_key = Helper::EncodeTxnKey(key, write_ts);
+  std::string write_value = GenWriteValue(op, start_ts, short_value);
+  std::string new_value;
+  std::string skip_until;
+  return filter.FilterV2(1, write_key, ValueType::kValue, write_value, &new_value, &skip_until);
+}
+
+TEST(TxnGcCompactionFilterTest, DropShadowedVersion) {
+  std::vector<std::string> data_keys;
+  {
+    TxnGcCompactionFilter filter(100, [&data_keys](const std::vector<std::string>& keys) { data_keys = keys; });
+
+    // newer than safe point
+    EXPECT_EQ(Decision::kKeep, Filter(filter, "key1", 120, pb::store::Op::Put, 110));
+    // newest put not greater than safe point
+    EXPECT_EQ(Decision::kKeep, Filter(filter, "key1", 90, pb::store::Op::Put, 80));
+    // shadowed
+    EXPECT_EQ(Decision::kRemove, Filter(filter, "key1", 70, pb::store::Op::Put, 60));
+    EXPECT_EQ(Decision::kRemove, Filter(filter, "key1", 50, pb::store::Op::Put, 40, "value"));
+    EXPECT_EQ(Decision::kRemove, Filter(filter, "key1", 30, pb::store::Op::Delete, 20));
+
+    // next key, rollback is dropped, delete is kept
+    EXPECT_EQ(Decision::kRemove, Filter(filter, "key2", 95, pb::store::Op::Rollback, 95));
+    EXPECT_EQ(Decision::kKeep, Filter(filter, "key2", 90, pb::store::Op::Delete, 80));
+    EXPECT_EQ(Decision::kRemove, Filter(filter, "key2", 70, pb::store::Op::Put, 60));
+  }
+
+  // only the long value in data cf
+  ASSERT_EQ(2, data_keys.size());
+  EXPECT_EQ(Helper::EncodeTxnKey(std::string("key1"), 60), data_keys[0]);
+  EXPECT_EQ(Helper::EncodeTxnKey(std::string("key2"), 60), data_keys[1]);
+}
+
+TEST(TxnGcCompactionFilterTest, RegionGcTs) {
+  auto& compaction_filter_gc = CompactionFilterGc::GetInstance();
+
+  EXPECT_EQ(0, compaction_filter_gc.GetRegionGcTs(1001));
+  compaction_filter_gc.SetRegionGcTs(1001, 100);
+  compaction_filter_gc.SetRegionGcTs(1002, 100);
+  EXPECT_EQ(100, compaction_filter_gc.GetRegionGcTs(1001));
+
+  compaction_filter_gc.RetainRegions({1002});
+  EXPECT_EQ(0, compaction_filter_gc.GetRegionGcTs(1001));
+  EXPECT_EQ(100, compaction_filter_gc.GetRegionGcTs(1002));
+}
+
+}  // namespace dingodb
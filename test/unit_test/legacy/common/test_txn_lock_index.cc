@@ -0,0 +1,144 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "engine/txn_lock_index.h"
+
+namespace dingodb {
+
+TEST(TxnLockIndexTest, AddErase) {
+  TxnLockIndex index(4);
+
+  // not trusted before build end
+  EXPECT_TRUE(index.MayLocked("key1", index.Sequence()));
+  index.EndBuild();
+
+  int64_t sequence = index.Sequence();
+  EXPECT_FALSE(index.MayLocked("key1", sequence));
+
+  index.Add("key1");
+  index.Add("key2");
+  EXPECT_EQ(2, index.Count());
+  EXPECT_TRUE(index.MayLocked("key1", sequence));
+
+  // the snapshot taken before erase may still have the lock
+  index.Erase("key1");
+  EXPECT_EQ(1, index.Count());
+  EXPECT_TRUE(index.MayLocked("key1", sequence));
+  EXPECT_FALSE(index.MayLocked("key1", index.Sequence()));
+
+  // unknown sequence
+  EXPECT_TRUE(index.MayLocked("key3", -1));
+}
+
+TEST(TxnLockIndexTest, EraseRange) {
+  TxnLockIndex index(4);
+  index.EndBuild();
+
+  index.Add("a1");
+  index.Add("b1");
+  index.Add("b2");
+  index.Add("c1");
+
+  index.EraseRange("b", "c");
+  EXPECT_EQ(2, index.Count());
+
+  int64_t sequence = index.Sequence();
+  EXPECT_TRUE(index.MayLocked("a1", sequence));
+  EXPECT_TRUE(index.MayLocked("c1", sequence));
+  EXPECT_FALSE(index.MayLocked("b1", sequence));
+  EXPECT_FALSE(index.MayLocked("b2", sequence));
+
+  // rebuilding
+  index.BeginBuild();
+  EXPECT_TRUE(index.MayLocked("b1", index.Sequence()));
+  index.EndBuild();
+  EXPECT_FALSE(index.MayLocked("b1", index.Sequence()));
+}
+
+TEST(TxnLockIndexTest, GetKeysByTs) {
+  TxnLockIndex index(4);
+
+  std::vector<std::string> keys;
+  EXPECT_FALSE(index.GetKeysByTs(0, INT64_MAX, "", "", INT64_MAX, keys));
+  index.EndBuild();
+
+  index.Add("a1", 100);
+  index.Add("b1", 100);
+  index.Add("b2", 200);
+  index.Add("c1", 300);
+  // relock with other ts
+  index.Add("b1", 150);
+
+  keys.clear();
+  EXPECT_TRUE(index.GetKeysByTs(100, 101, "", "", INT64_MAX, keys));
+  EXPECT_EQ(std::vector<std::string>({"a1", "b1"}), keys);
+
+  keys.clear();
+  EXPECT_TRUE(index.GetKeysByTs(100, 300, "b", "c", INT64_MAX, keys));
+  EXPECT_EQ(std::vector<std::string>({"b1", "b2"}), keys);
+
+  index.Erase("b1");
+  keys.clear();
+  EXPECT_TRUE(index.GetKeysByTs(0, INT64_MAX, "", "", INT64_MAX, keys));
+  EXPECT_EQ(std::vector<std::string>({"a1", "b2", "c1"}), keys);
+
+  // too many keys in the ts range
+  keys.clear();
+  EXPECT_TRUE(index.GetKeysByTs(0, INT64_MAX, "", "", 3, keys));
+  EXPECT_EQ(3, keys.size());
+  keys.clear();
+  EXPECT_FALSE(index.GetKeysByTs(0, INT64_MAX, "", "", 2, keys));
+  EXPECT_TRUE(keys.empty());
+
+  index.EraseRange("a", "c");
+  keys.clear();
+  EXPECT_TRUE(index.GetKeysByTs(0, INT64_MAX, "", "", INT64_MAX, keys));
+  EXPECT_EQ(std::vector<std::string>({"c1"}), keys);
+}
+
+TEST(TxnLockIndexTest, GetMinLockTs) {
+  TxnLockIndex index(4);
+
+  int64_t min_lock_ts = 0;
+  EXPECT_FALSE(index.GetMinLockTs("", "", min_lock_ts));
+  index.EndBuild();
+
+  EXPECT_TRUE(index.GetMinLockTs("", "", min_lock_ts));
+  EXPECT_EQ(INT64_MAX, min_lock_ts);
+
+  index.Add("a1", 300);
+  index.Add("b1", 200);
+  index.Add("b2", 150);
+  index.Add("c1", 100);
+
+  EXPECT_TRUE(index.GetMinLockTs("", "", min_lock_ts));
+  EXPECT_EQ(100, min_lock_ts);
+  EXPECT_TRUE(index.GetMinLockTs("a", "c", min_lock_ts));
+  EXPECT_EQ(150, min_lock_ts);
+  EXPECT_TRUE(index.GetMinLockTs("d", "e", min_lock_ts));
+  EXPECT_EQ(INT64_MAX, min_lock_ts);
+
+  // unknown lock ts in range
+  index.Add("b3");
+  EXPECT_FALSE(index.GetMinLockTs("b", "c", min_lock_ts));
+  EXPECT_TRUE(index.GetMinLockTs("c", "", min_lock_ts));
+  EXPECT_EQ(100, min_lock_ts);
+}
+
+}  // namespace dingodb
@@ -0,0 +1,156 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <future>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "engine/txn_lock_wait_manager.h"
+
+namespace dingodb {
+
+// Return true if woken up, false if timeout.
+static bool Wait(TxnLockWaitManager& manager, TxnLockWaitManager::WaiterPtr waiter, int64_t timeout_ms) {
+  std::promise<bool> promise;
+  auto future = promise.get_future();
+  manager.AsyncWait(waiter, timeout_ms, [&promise](bool woken) { promise.set_value(woken); });
+  return future.get();
+}
+
+TEST(TxnLockWaitManagerTest, Timeout) {
+  auto& manager = TxnLockWaitManager::GetInstance();
+
+  auto waiter = manager.Enqueue(1, "key_timeout", 100, 10, manager.ReleaseVersion());
+  ASSERT_NE(nullptr, waiter);
+  EXPECT_EQ(1, manager.WaiterCount());
+
+  EXPECT_FALSE(Wait(manager, waiter, 10));
+  EXPECT_EQ(0, manager.WaiterCount());
+  EXPECT_TRUE(manager.GetWaitForGraph().empty());
+}
+
+TEST(TxnLockWaitManagerTest, WakeUpInOrder) {
+  auto& manager = TxnLockWaitManager::GetInstance();
+
+  auto waiter1 = manager.Enqueue(1, "key_order", 101, 10, manager.ReleaseVersion());
+  auto waiter2 = manager.Enqueue(1, "key_order", 102, 10, manager.ReleaseVersion());
+  ASSERT_NE(nullptr, waiter1);
+  ASSERT_NE(nullptr, waiter2);
+
+  auto edges = manager.GetWaitForGraph();
+  ASSERT_EQ(2, edges.size());
+  EXPECT_EQ(101, edges[0].waiter_ts);
+  EXPECT_EQ(102, edges[1].waiter_ts);
+  EXPECT_EQ(10, edges[0].holder_ts);
+  EXPECT_EQ("key_order", edges[0].key);
+
+  // wake up before wait is not lost
+  manager.WakeUp("key_order");
+  EXPECT_TRUE(Wait(manager, waiter1, 1000));
+  EXPECT_TRUE(waiter1->woken);
+  EXPECT_FALSE(waiter2->woken);
+  EXPECT_EQ(1, manager.WaiterCount());
+
+  std::thread thread([&]() { manager.WakeUp("key_order"); });
+  EXPECT_TRUE(Wait(manager, waiter2, 10000));
+  thread.join();
+  EXPECT_EQ(0, manager.WaiterCount());
+
+  // no waiter
+  manager.WakeUp("key_order");
+}
+
+TEST(TxnLockWaitManagerTest, Deadlock) {
+  auto& manager = TxnLockWaitManager::GetInstance();
+
+  // 201 -> 202 -> 203
+  auto waiter1 = manager.Enqueue(1, "key_a", 201, 202, manager.ReleaseVersion());
+  auto waiter2 = manager.Enqueue(1, "key_b", 202, 203, manager.ReleaseVersion());
+  EXPECT_FALSE(waiter1->woken);
+  EXPECT_FALSE(waiter2->woken);
+
+  // 203 -> 201 makes a cycle, 203 is the youngest
+  auto waiter3 = manager.Enqueue(1, "key_c", 203, 201, manager.ReleaseVersion());
+  EXPECT_TRUE(waiter3->woken);
+  EXPECT_TRUE(waiter3->deadlock);
+  EXPECT_TRUE(Wait(manager, waiter3, 1000));
+  EXPECT_EQ(2, manager.WaiterCount());
+
+  // 200 -> 201 -> 202 -> 203 -> 200, 203 is the youngest, 202 waiting for it is woken up
+  auto waiter4 = manager.Enqueue(1, "key_d", 203, 200, manager.ReleaseVersion());
+  EXPECT_FALSE(waiter4->woken);
+  auto waiter5 = manager.Enqueue(2, "key_e", 200, 201, manager.ReleaseVersion());
+  EXPECT_FALSE(waiter5->woken);
+  EXPECT_TRUE(waiter4->deadlock);
+  EXPECT_TRUE(Wait(manager, waiter4, 1000));
+  EXPECT_FALSE(waiter2->deadlock);
+
+  // the waiters of other txn are not woken up
+  manager.WakeUpRegion(2);
+  EXPECT_TRUE(Wait(manager, waiter5, 1000));
+  EXPECT_FALSE(waiter5->deadlock);
+  EXPECT_FALSE(waiter1->woken);
+  EXPECT_FALSE(waiter2->woken);
+
+  manager.WakeUpRegion(1);
+  EXPECT_TRUE(Wait(manager, waiter1, 1000));
+  EXPECT_TRUE(Wait(manager, waiter2, 1000));
+  EXPECT_EQ(0, manager.WaiterCount());
+}
+
+TEST(TxnLockWaitManagerTest, ReleaseBeforeEnqueue) {
+  auto& manager = TxnLockWaitManager::GetInstance();
+
+  // the lock is released between the lock check and enqueue
+  int64_t release_version = manager.ReleaseVersion();
+  manager.WakeUp("key_release");
+  auto waiter = manager.Enqueue(1, "key_release", 301, 30, release_version);
+  EXPECT_TRUE(waiter->woken);
+  EXPECT_FALSE(waiter->deadlock);
+  EXPECT_EQ(0, manager.WaiterCount());
+  EXPECT_TRUE(Wait(manager, waiter, 1000));
+
+  // release of other key
+  release_version = manager.ReleaseVersion();
+  manager.WakeUp("key_other");
+  waiter = manager.Enqueue(1, "key_release", 301, 30, release_version);
+  EXPECT_FALSE(waiter->woken);
+  EXPECT_FALSE(Wait(manager, waiter, 10));
+  EXPECT_EQ(0, manager.WaiterCount());
+}
+
+TEST(TxnLockWaitManagerTest, WakeUpRange) {
+  auto& manager = TxnLockWaitManager::GetInstance();
+
+  auto waiter1 = manager.Enqueue(1, "key_range_a", 401, 40, manager.ReleaseVersion());
+  auto waiter2 = manager.Enqueue(1, "key_range_a", 402, 40, manager.ReleaseVersion());
+  auto waiter3 = manager.Enqueue(1, "key_range_c", 403, 40, manager.ReleaseVersion());
+
+  std::thread thread([&]() { manager.WakeUpRange("key_range_a", "key_range_b"); });
+  EXPECT_TRUE(Wait(manager, waiter1, 10000));
+  EXPECT_TRUE(Wait(manager, waiter2, 10000));
+  thread.join();
+  EXPECT_FALSE(waiter3->woken);
+
+  manager.WakeUp("key_range_c");
+  EXPECT_TRUE(Wait(manager, waiter3, 1000));
+  EXPECT_EQ(0, manager.WaiterCount());
+}
+
+}  // namespace dingodb
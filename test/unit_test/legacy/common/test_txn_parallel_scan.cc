@@ -0,0 +1,226 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "common/constant.h"
+#include "common/helper.h"
+#include "config/config.h"
+#include "config/yaml_config.h"
+#include "engine/rocks_raw_engine.h"
+#include "engine/txn_engine_helper.h"
+#include "fmt/core.h"
+#include "proto/common.pb.h"
+#include "proto/store.pb.h"
+
+namespace dingodb {
+
+static const std::vector<std::string> kParallelScanCFs = {Constant::kTxnWriteCF, Constant::kTxnDataCF,
+                                                          Constant::kTxnLockCF, Constant::kStoreDataCF};
+
+static const std::string kParallelScanRootPath = "./unit_test_txn_parallel_scan";
+static const std::string kParallelScanStorePath = kParallelScanRootPath + "/db";
+
+static const std::string kParallelScanYamlConfigContent =
+    "cluster:\n"
+    "  name: dingodb\n"
+    "  instance_id: 12345\n"
+    "  coordinators: 127.0.0.1:19190,127.0.0.1:19191,127.0.0.1:19192\n"
+    "  keyring: TO_BE_CONTINUED\n"
+    "server:\n"
+    "  host: 127.0.0.1\n"
+    "  port: 23000\n"
+    "log:\n"
+    "  path: " +
+    kParallelScanRootPath +
+    "/log\n"
+    "store:\n"
+    "  path: " +
+    kParallelScanStorePath + "\n";
+
+static std::string GenKey(int i) { return fmt::format("t{:04}", i); }
+
+class TxnParallelScanTest : public testing::Test {
+ protected:
+  static void SetUpTestSuite() {
+    Helper::CreateDirectories(kParallelScanStorePath);
+
+    std::shared_ptr<Config> config = std::make_shared<YamlConfig>();
+    ASSERT_EQ(0, config->Load(kParallelScanYamlConfigContent));
+
+    engine = std::make_shared<RocksRawEngine>();
+    ASSERT_TRUE(engine->Init(config, kParallelScanCFs));
+
+    // committed at ts 10, odd keys deleted at ts 20
+    auto writer = engine->Writer();
+    for (int i = 0; i < 100; ++i) {
+      pb::store::WriteInfo write_info;
+      write_info.set_op(pb::store::Op::Put);
+      write_info.set_start_ts(9);
+      write_info.set_short_value(fmt::format("value{}", i));
+
+      pb::common::KeyValue kv;
+      kv.set_key(Helper::EncodeTxnKey(GenKey(i), 10));
+      kv.set_value(write_info.SerializeAsString());
+      ASSERT_TRUE(writer->KvPut(Constant::kTxnWriteCF, kv).ok());
+
+      if (i % 2 == 1) {
+        write_info.set_op(pb::store::Op::Delete);
+        write_info.set_start_ts(19);
+        write_info.clear_short_value();
+        kv.set_key(Helper::EncodeTxnKey(GenKey(i), 20));
+        kv.set_value(write_info.SerializeAsString());
+        ASSERT_TRUE(writer->KvPut(Constant::kTxnWriteCF, kv).ok());
+      }
+    }
+  }
+
+  static void TearDownTestSuite() {
+    engine->Close();
+    engine->Destroy();
+    Helper::RemoveAllFileOrDirectory(kParallelScanRootPath);
+  }
+
+  static std::vector<pb::common::Range> GenSubRanges(const std::vector<int>& split_points) {
+    std::vector<pb::common::Range> sub_ranges;
+    std::string start_key = GenKey(0);
+    for (int point : split_points) {
+      pb::common::Range sub_range;
+      sub_range.set_start_key(start_key);
+      sub_range.set_end_key(GenKey(point));
+      sub_ranges.push_back(sub_range);
+      start_key = GenKey(point);
+    }
+    return sub_ranges;
+  }
+
+  static std::shared_ptr<RocksRawEngine> engine;
+};
+
+std::shared_ptr<RocksRawEngine> TxnParallelScanTest::engine = nullptr;
+
+TEST_F(TxnParallelScanTest, SameAsSequential) {
+  pb::common::Range range;
+  range.set_start_key(GenKey(0));
+  range.set_end_key(GenKey(100));
+
+  for (int64_t start_ts : {15, 25}) {
+    for (int64_t limit : {7, 40, 1000}) {
+      pb::store::TxnResultInfo txn_result_info;
+      std::vector<pb::common::KeyValue> kvs;
+      bool has_more = false;
+      std::string end_scan_key;
+      auto status = TxnEngineHelper::Scan(engine, pb::store::IsolationLevel::SnapshotIsolation, start_ts, range, limit,
+                                          false, false, {}, true, pb::common::CoprocessorV2(), txn_result_info, kvs,
+                                          has_more, end_scan_key);
+      ASSERT_TRUE(status.ok());
+
+      pb::store::TxnResultInfo parallel_txn_result_info;
+      std::vector<pb::common::KeyValue> parallel_kvs;
+      bool parallel_has_more = false;
+      std::string parallel_end_scan_key;
+      status = TxnEngineHelper::ParallelScan(engine, pb::store::IsolationLevel::SnapshotIsolation, start_ts,
+                                             GenSubRanges({13, 50, 51, 100}), limit, false, {},
+                                             parallel_txn_result_info, parallel_kvs, parallel_has_more,
+                                             parallel_end_scan_key);
+      ASSERT_TRUE(status.ok());
+
+      ASSERT_EQ(kvs.size(), parallel_kvs.size());
+      for (size_t i = 0; i < kvs.size(); ++i) {
+        EXPECT_EQ(kvs[i].key(), parallel_kvs[i].key());
+        EXPECT_EQ(kvs[i].value(), parallel_kvs[i].value());
+      }
+      EXPECT_EQ(has_more, parallel_has_more);
+      EXPECT_EQ(end_scan_key, parallel_end_scan_key);
+    }
+  }
+}
+
+TEST_F(TxnParallelScanTest, SplitSmallRange) {
+  pb::common::Range range;
+  range.set_start_key(GenKey(0));
+  range.set_end_key(GenKey(100));
+
+  // far below the min size, keep sequential
+  auto sub_ranges = TxnEngineHelper::SplitScanRange(engine, range, 4);
+  ASSERT_EQ(1, sub_ranges.size());
+  EXPECT_EQ(range.start_key(), sub_ranges[0].start_key());
+  EXPECT_EQ(range.end_key(), sub_ranges[0].end_key());
+}
+
+TEST_F(TxnParallelScanTest, LazyValue) {
+  // values in data cf, committed at ts 10
+  auto writer = engine->Writer();
+  for (int i = 0; i < 10; ++i) {
+    std::string key = fmt::format("u{:04}", i);
+    pb::store::WriteInfo write_info;
+    write_info.set_op(pb::store::Op::Put);
+    write_info.set_start_ts(9);
+
+    pb::common::KeyValue kv;
+    kv.set_key(Helper::EncodeTxnKey(key, 10));
+    kv.set_value(write_info.SerializeAsString());
+    ASSERT_TRUE(writer->KvPut(Constant::kTxnWriteCF, kv).ok());
+
+    kv.set_key(Helper::EncodeTxnKey(key, 9));
+    kv.set_value(fmt::format("data{}", i));
+    ASSERT_TRUE(writer->KvPut(Constant::kTxnDataCF, kv).ok());
+  }
+
+  pb::common::Range range;
+  range.set_start_key("u0000");
+  range.set_end_key("u0010");
+
+  pb::store::TxnResultInfo txn_result_info;
+  std::vector<std::string> data_keys;
+  {
+    auto txn_iter = std::make_shared<TxnIterator>(engine, range, 15, pb::store::IsolationLevel::SnapshotIsolation,
+                                                  std::set<int64_t>{});
+    txn_iter->SetLazyValue(true);
+    ASSERT_TRUE(txn_iter->Init().ok());
+    ASSERT_TRUE(txn_iter->Seek(range.start_key()).ok());
+    while (txn_iter->Valid(txn_result_info)) {
+      EXPECT_FALSE(txn_iter->ValueDataKey().empty());
+      data_keys.push_back(txn_iter->ValueDataKey());
+      txn_iter->Next();
+    }
+    ASSERT_EQ(10, data_keys.size());
+
+    std::vector<std::string> values;
+    ASSERT_TRUE(txn_iter->BatchGetValue(data_keys, values).ok());
+    ASSERT_EQ(10, values.size());
+    for (int i = 0; i < 10; ++i) {
+      EXPECT_EQ(fmt::format("data{}", i), values[i]);
+    }
+  }
+
+  // read on demand
+  {
+    auto txn_iter = std::make_shared<TxnIterator>(engine, range, 15, pb::store::IsolationLevel::SnapshotIsolation,
+                                                  std::set<int64_t>{});
+    txn_iter->SetLazyValue(true);
+    ASSERT_TRUE(txn_iter->Init().ok());
+    ASSERT_TRUE(txn_iter->Seek(range.start_key()).ok());
+    ASSERT_TRUE(txn_iter->Valid(txn_result_info));
+    EXPECT_EQ("data0", txn_iter->Value());
+    EXPECT_TRUE(txn_iter->ValueDataKey().empty());
+  }
+}
+
+}  // namespace dingodb
@@ -0,0 +1,160 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "butil/status.h"
+#include "common/context.h"
+#include "engine/write_coalescer.h"
+#include "engine/write_data.h"
+#include "proto/error.pb.h"
+
+namespace dingodb {
+
+static std::shared_ptr<Context> NewContext(int64_t region_id, int64_t version) {
+  auto ctx = std::make_shared<Context>();
+  ctx->SetRegionId(region_id);
+  pb::common::RegionEpoch epoch;
+  epoch.set_version(version);
+  epoch.set_conf_version(1);
+  ctx->SetRegionEpoch(epoch);
+  return ctx;
+}
+
+static std::shared_ptr<DatumAble> NewDatum(int64_t id) {
+  return WriteDataBuilder::BuildWrite("default", std::vector<int64_t>{id})->Datums().front();
+}
+
+// apply every request with its caller's context like the state machine
+static butil::Status FakeApply(std::shared_ptr<Context> ctx, std::shared_ptr<WriteData> write_data) {
+  EXPECT_EQ(ctx->SubContexts().size(), write_data->Datums().size());
+  for (const auto& sub_ctx : ctx->SubContexts()) {
+    sub_ctx->SetStatus(butil::Status::OK());
+  }
+  return butil::Status::OK();
+}
+
+TEST(RegionWriteCoalescerTest, Single) {
+  RegionWriteCoalescer coalescer(FakeApply, 16, 0);
+
+  auto ctx = NewContext(1, 1);
+  ctx->SetStatus(butil::Status(pb::error::Errno::EINTERNAL, "not applied"));
+  EXPECT_TRUE(coalescer.Write(ctx, NewDatum(1), 8).ok());
+  EXPECT_TRUE(coalescer.Write(NewContext(1, 1), NewDatum(2), 8).ok());
+  EXPECT_EQ(2, coalescer.WriteCount());
+}
+
+TEST(RegionWriteCoalescerTest, Error) {
+  RegionWriteCoalescer coalescer(
+      [](std::shared_ptr<Context>, std::shared_ptr<WriteData>) -> butil::Status {
+        return butil::Status(pb::error::Errno::ERAFT_NOTLEADER, "not leader");
+      },
+      16, 0);
+
+  auto status = coalescer.Write(NewContext(1, 1), NewDatum(1), 8);
+  EXPECT_EQ(pb::error::Errno::ERAFT_NOTLEADER, status.error_code());
+}
+
+TEST(RegionWriteCoalescerTest, Concurrent) {
+  const int thread_num = 16;
+  const int req_num = 100;
+  const int64_t max_batch_count = 8;
+
+  std::atomic<int64_t> datum_count{0};
+  std::atomic<int64_t> max_count{0};
+  RegionWriteCoalescer coalescer(
+      [&](std::shared_ptr<Context> ctx, std::shared_ptr<WriteData> write_data) -> butil::Status {
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+        int64_t count = write_data->Datums().size();
+        int64_t old_max = max_count.load();
+        while (count > old_max && !max_count.compare_exchange_weak(old_max, count)) {
+        }
+        // all requests of one batch belong to the same region and epoch
+        for (const auto& sub_ctx : ctx->SubContexts()) {
+          EXPECT_EQ(ctx->RegionId(), sub_ctx->RegionId());
+          EXPECT_EQ(ctx->RegionEpoch().version(), sub_ctx->RegionEpoch().version());
+        }
+        datum_count.fetch_add(count);
+        return FakeApply(ctx, write_data);
+      },
+      max_batch_count, 0);
+
+  std::vector<std::thread> threads;
+  threads.reserve(thread_num);
+  for (int i = 0; i < thread_num; ++i) {
+    threads.emplace_back([&, i]() {
+      for (int j = 0; j < req_num; ++j) {
+        // two regions, epoch changes in the middle
+        auto ctx = NewContext(i % 2 + 1, j < req_num / 2 ? 1 : 2);
+        EXPECT_TRUE(coalescer.Write(ctx, NewDatum(j), 8).ok());
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  EXPECT_EQ(thread_num * req_num, datum_count.load());
+  EXPECT_LE(max_count.load(), max_batch_count);
+  EXPECT_LE(coalescer.WriteCount(), thread_num * req_num);
+}
+
+TEST(RegionWriteCoalescerTest, MaxBytes) {
+  const int thread_num = 8;
+  const int req_num = 50;
+  const int64_t datum_bytes = 8;
+  const int64_t max_batch_bytes = 3 * datum_bytes;
+
+  std::atomic<int64_t> datum_count{0};
+  std::atomic<int64_t> max_count{0};
+  RegionWriteCoalescer coalescer(
+      [&](std::shared_ptr<Context> ctx, std::shared_ptr<WriteData> write_data) -> butil::Status {
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+        int64_t count = write_data->Datums().size();
+        int64_t old_max = max_count.load();
+        while (count > old_max && !max_count.compare_exchange_weak(old_max, count)) {
+        }
+        datum_count.fetch_add(count);
+        return FakeApply(ctx, write_data);
+      },
+      16, max_batch_bytes);
+
+  std::vector<std::thread> threads;
+  threads.reserve(thread_num);
+  for (int i = 0; i < thread_num; ++i) {
+    threads.emplace_back([&]() {
+      for (int j = 0; j < req_num; ++j) {
+        EXPECT_TRUE(coalescer.Write(NewContext(1, 1), NewDatum(j), datum_bytes).ok());
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  EXPECT_EQ(thread_num * req_num, datum_count.load());
+  EXPECT_LE(max_count.load(), max_batch_bytes / datum_bytes);
+
+  // a datum larger than the limit is written alone
+  EXPECT_TRUE(coalescer.Write(NewContext(1, 1), NewDatum(1), 2 * max_batch_bytes).ok());
+}
+
+}  // namespace dingodb
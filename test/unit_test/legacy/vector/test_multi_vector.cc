@@ -0,0 +1,78 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "gflags/gflags.h"
+#include "proto/common.pb.h"
+#include "vector/multi_vector.h"
+
+namespace dingodb {
+
+DECLARE_string(vector_multi_vector_index_ids);
+DECLARE_int32(vector_multi_vector_token_bits);
+
+class MultiVectorTest : public testing::Test {
+ protected:
+  void TearDown() override { FLAGS_vector_multi_vector_index_ids = ""; }
+};
+
+TEST_F(MultiVectorTest, TokenBits) {
+  EXPECT_EQ(0, MultiVector::TokenBits(100));
+
+  FLAGS_vector_multi_vector_index_ids = "100,200";
+  FLAGS_vector_multi_vector_token_bits = 8;
+  EXPECT_EQ(8, MultiVector::TokenBits(100));
+  EXPECT_EQ(8, MultiVector::TokenBits(200));
+  EXPECT_EQ(0, MultiVector::TokenBits(300));
+}
+
+TEST_F(MultiVectorTest, VectorId) {
+  int32_t token_bits = 8;
+  EXPECT_EQ(5 * 256, MultiVector::BeginVectorId(5, token_bits));
+  EXPECT_EQ(6 * 256, MultiVector::EndVectorId(5, token_bits));
+  EXPECT_EQ(5, MultiVector::DocumentId(MultiVector::BeginVectorId(5, token_bits), token_bits));
+  EXPECT_EQ(5, MultiVector::DocumentId(MultiVector::EndVectorId(5, token_bits) - 1, token_bits));
+}
+
+TEST_F(MultiVectorTest, MaxSimDistance) {
+  // 2 query tokens, 3 document tokens, dimension 2
+  std::vector<float> queries = {1.0F, 0.0F, 0.0F, 1.0F};
+  std::vector<float> tokens = {1.0F, 0.0F, 0.6F, 0.8F, 0.0F, 0.5F};
+  std::vector<float> distances;
+
+  // inner product, max ip per query is 1.0 and 0.8, distance = 2 - 1.8
+  float distance = MultiVector::MaxSimDistance(queries.data(), 2, tokens.data(), 3, 2,
+                                               pb::common::MetricType::METRIC_TYPE_INNER_PRODUCT, distances);
+  EXPECT_NEAR(0.2F, distance, 1e-5);
+
+  // l2, nearest per query is 0.0 and min(2, 0.4, 0.25)
+  distance =
+      MultiVector::MaxSimDistance(queries.data(), 2, tokens.data(), 3, 2, pb::common::MetricType::METRIC_TYPE_L2,
+                                  distances);
+  EXPECT_NEAR(0.25F, distance, 1e-5);
+
+  // more matched tokens is nearer
+  std::vector<float> one_token = {1.0F, 0.0F};
+  EXPECT_GT(MultiVector::MaxSimDistance(queries.data(), 2, one_token.data(), 1, 2,
+                                        pb::common::MetricType::METRIC_TYPE_INNER_PRODUCT, distances),
+            MultiVector::MaxSimDistance(queries.data(), 2, tokens.data(), 3, 2,
+                                        pb::common::MetricType::METRIC_TYPE_INNER_PRODUCT, distances));
+}
+
+}  // namespace dingodb
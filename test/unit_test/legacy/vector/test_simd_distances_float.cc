@@ -0,0 +1,159 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "simd/distances_ref.h"
+#include "simd/hook.h"
+
+#if defined(__aarch64__)
+#include "simd/distances_neon.h"
+#include "simd/distances_sve.h"
+#endif
+
+namespace dingodb {
+
+// Every hooked float kernel against the reference, plus the arm kernels directly so the neon ones are covered on
+// sve machines too.
+class SimdDistancesFloatTest : public testing::Test {
+ protected:
+  struct Kernels {
+    float (*inner_product)(const float*, const float*, size_t);
+    float (*l2sqr)(const float*, const float*, size_t);
+    float (*l1)(const float*, const float*, size_t);
+    float (*linf)(const float*, const float*, size_t);
+    float (*norm_l2sqr)(const float*, size_t);
+    void (*l2sqr_ny)(float*, const float*, const float*, size_t, size_t);
+    void (*inner_products_ny)(float*, const float*, const float*, size_t, size_t);
+    void (*l2sqr_nx_ny)(float*, const float*, const float*, size_t, size_t, size_t);
+    void (*inner_products_nx_ny)(float*, const float*, const float*, size_t, size_t, size_t);
+    void (*madd)(size_t, const float*, float, const float*, float*);
+    int (*madd_and_argmin)(size_t, const float*, float, const float*, float*);
+  };
+
+  static void SetUpTestSuite() {
+    std::string simd_type;
+    fvec_hook(simd_type);
+  }
+
+  static std::vector<float> RandomVectors(size_t n, size_t d) {
+    std::mt19937 rng(n * 131 + d);
+    std::uniform_real_distribution<float> distrib(-1.0f, 1.0f);
+    std::vector<float> values(n * d);
+    for (auto& value : values) {
+      value = distrib(rng);
+    }
+    return values;
+  }
+
+  static void ExpectNear(float expect, float actual) {
+    EXPECT_NEAR(expect, actual, 1e-3 * std::max(1.0f, std::fabs(expect)));
+  }
+
+  static void CheckKernels(const Kernels& kernels) {
+    for (size_t d : {1, 3, 4, 7, 8, 17, 64, 768}) {
+      auto x = RandomVectors(1, d);
+      auto y = RandomVectors(1, d + 1);
+
+      ExpectNear(fvec_inner_product_ref(x.data(), y.data(), d), kernels.inner_product(x.data(), y.data(), d));
+      ExpectNear(fvec_L2sqr_ref(x.data(), y.data(), d), kernels.l2sqr(x.data(), y.data(), d));
+      ExpectNear(fvec_L1_ref(x.data(), y.data(), d), kernels.l1(x.data(), y.data(), d));
+      ExpectNear(fvec_Linf_ref(x.data(), y.data(), d), kernels.linf(x.data(), y.data(), d));
+      ExpectNear(fvec_norm_L2sqr_ref(x.data(), d), kernels.norm_l2sqr(x.data(), d));
+
+      for (size_t ny : {1, 4, 9}) {
+        auto ys = RandomVectors(ny, d);
+        std::vector<float> expect(ny);
+        std::vector<float> actual(ny);
+        fvec_L2sqr_ny_ref(expect.data(), x.data(), ys.data(), d, ny);
+        kernels.l2sqr_ny(actual.data(), x.data(), ys.data(), d, ny);
+        for (size_t j = 0; j < ny; ++j) {
+          ExpectNear(expect[j], actual[j]);
+        }
+        fvec_inner_products_ny_ref(expect.data(), x.data(), ys.data(), d, ny);
+        kernels.inner_products_ny(actual.data(), x.data(), ys.data(), d, ny);
+        for (size_t j = 0; j < ny; ++j) {
+          ExpectNear(expect[j], actual[j]);
+        }
+      }
+
+      for (size_t nx : {1, 5}) {
+        size_t ny = 7;
+        auto xs = RandomVectors(nx, d);
+        auto ys = RandomVectors(ny, d);
+        std::vector<float> expect(nx * ny);
+        std::vector<float> actual(nx * ny);
+        fvec_L2sqr_nx_ny_ref(expect.data(), xs.data(), ys.data(), d, nx, ny);
+        kernels.l2sqr_nx_ny(actual.data(), xs.data(), ys.data(), d, nx, ny);
+        for (size_t k = 0; k < nx * ny; ++k) {
+          ExpectNear(expect[k], actual[k]);
+        }
+        fvec_inner_products_nx_ny_ref(expect.data(), xs.data(), ys.data(), d, nx, ny);
+        kernels.inner_products_nx_ny(actual.data(), xs.data(), ys.data(), d, nx, ny);
+        for (size_t k = 0; k < nx * ny; ++k) {
+          ExpectNear(expect[k], actual[k]);
+        }
+      }
+
+      std::vector<float> expect(d);
+      std::vector<float> actual(d);
+      fvec_madd_ref(d, x.data(), 0.5f, y.data(), expect.data());
+      kernels.madd(d, x.data(), 0.5f, y.data(), actual.data());
+      for (size_t k = 0; k < d; ++k) {
+        ExpectNear(expect[k], actual[k]);
+      }
+      EXPECT_EQ(fvec_madd_and_argmin_ref(d, x.data(), 0.5f, y.data(), expect.data()),
+                kernels.madd_and_argmin(d, x.data(), 0.5f, y.data(), actual.data()));
+    }
+
+    // ties resolve to the first index, nothing below the initial bound is -1
+    std::vector<float> a = {3.0f, 1.0f, 2.0f, 1.0f, 1.0f, 5.0f, 1.0f, 9.0f, 1.0f};
+    std::vector<float> b(a.size(), 0.0f);
+    std::vector<float> c(a.size());
+    EXPECT_EQ(1, kernels.madd_and_argmin(a.size(), a.data(), 1.0f, b.data(), c.data()));
+    std::vector<float> big(a.size(), 1e21f);
+    EXPECT_EQ(-1, kernels.madd_and_argmin(big.size(), big.data(), 1.0f, b.data(), c.data()));
+  }
+};
+
+TEST_F(SimdDistancesFloatTest, Hooked) {
+  CheckKernels({fvec_inner_product, fvec_L2sqr, fvec_L1, fvec_Linf, fvec_norm_L2sqr, fvec_L2sqr_ny,
+                fvec_inner_products_ny, fvec_L2sqr_nx_ny, fvec_inner_products_nx_ny, fvec_madd, fvec_madd_and_argmin});
+}
+
+#if defined(__aarch64__)
+TEST_F(SimdDistancesFloatTest, Neon) {
+  CheckKernels({fvec_inner_product_neon, fvec_L2sqr_neon, fvec_L1_neon, fvec_Linf_neon, fvec_norm_L2sqr_neon,
+                fvec_L2sqr_ny_neon, fvec_inner_products_ny_neon, fvec_L2sqr_nx_ny_neon, fvec_inner_products_nx_ny_neon,
+                fvec_madd_neon, fvec_madd_and_argmin_neon});
+}
+
+TEST_F(SimdDistancesFloatTest, Sve) {
+  if (!cpu_support_sve()) {
+    GTEST_SKIP() << "cpu not support sve";
+  }
+  CheckKernels({fvec_inner_product_sve, fvec_L2sqr_sve, fvec_L1_sve, fvec_Linf_sve, fvec_norm_L2sqr_sve,
+                fvec_L2sqr_ny_sve, fvec_inner_products_ny_sve, fvec_L2sqr_nx_ny_sve, fvec_inner_products_nx_ny_sve,
+                fvec_madd_sve, fvec_madd_and_argmin_sve});
+}
+#endif
+
+}  // namespace dingodb
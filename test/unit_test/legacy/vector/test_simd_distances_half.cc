@@ -0,0 +1,119 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "simd/distances_ref.h"
+#include "simd/hook.h"
+
+namespace dingodb {
+
+class SimdDistancesHalfTest : public testing::Test {
+ protected:
+  static void SetUpTestSuite() {
+    std::string simd_type;
+    fvec_hook(simd_type);
+  }
+
+  static std::vector<float> RandomVector(size_t d, uint32_t seed) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> distrib(-1.0f, 1.0f);
+    std::vector<float> values(d);
+    for (auto& value : values) {
+      value = distrib(rng);
+    }
+    return values;
+  }
+};
+
+TEST_F(SimdDistancesHalfTest, Fp16Convert) {
+  EXPECT_EQ(0x0000, float_to_fp16_ref(0.0f));
+  EXPECT_EQ(0x8000, float_to_fp16_ref(-0.0f));
+  EXPECT_EQ(0x3c00, float_to_fp16_ref(1.0f));
+  EXPECT_EQ(0xc000, float_to_fp16_ref(-2.0f));
+  EXPECT_EQ(0x7bff, float_to_fp16_ref(65504.0f));
+  EXPECT_EQ(0x7c00, float_to_fp16_ref(1e6f));
+  EXPECT_EQ(0x7c00, float_to_fp16_ref(std::numeric_limits<float>::infinity()));
+  EXPECT_EQ(0x0001, float_to_fp16_ref(std::ldexp(1.0f, -24)));
+  EXPECT_TRUE(std::isnan(fp16_to_float_ref(float_to_fp16_ref(std::numeric_limits<float>::quiet_NaN()))));
+
+  for (uint32_t h = 0; h < 0x7c00; ++h) {
+    float f = fp16_to_float_ref(static_cast<uint16_t>(h));
+    EXPECT_EQ(h, float_to_fp16_ref(f));
+  }
+
+  auto values = RandomVector(37, 1);
+  std::vector<uint16_t> expect(values.size());
+  std::vector<uint16_t> actual(values.size());
+  fvec_to_fp16_ref(expect.data(), values.data(), values.size());
+  fvec_to_fp16(actual.data(), values.data(), values.size());
+  EXPECT_EQ(expect, actual);
+
+  std::vector<float> back(values.size());
+  fp16vec_to_fvec(back.data(), actual.data(), actual.size());
+  for (size_t i = 0; i < values.size(); ++i) {
+    EXPECT_NEAR(values[i], back[i], 1e-3);
+  }
+}
+
+TEST_F(SimdDistancesHalfTest, Bf16Convert) {
+  EXPECT_EQ(0x3f80, float_to_bf16_ref(1.0f));
+  EXPECT_EQ(0xc000, float_to_bf16_ref(-2.0f));
+  EXPECT_FLOAT_EQ(1.0f, bf16_to_float_ref(0x3f80));
+
+  auto values = RandomVector(37, 2);
+  std::vector<uint16_t> codes(values.size());
+  fvec_to_bf16(codes.data(), values.data(), values.size());
+  std::vector<float> back(values.size());
+  bf16vec_to_fvec(back.data(), codes.data(), codes.size());
+  for (size_t i = 0; i < values.size(); ++i) {
+    EXPECT_NEAR(values[i], back[i], 1e-2);
+  }
+}
+
+TEST_F(SimdDistancesHalfTest, Distance) {
+  for (size_t d : {1, 7, 16, 33, 768}) {
+    auto x = RandomVector(d, d);
+    auto y = RandomVector(d, d + 1);
+
+    std::vector<uint16_t> hx(d), hy(d), bx(d), by(d);
+    fvec_to_fp16_ref(hx.data(), x.data(), d);
+    fvec_to_fp16_ref(hy.data(), y.data(), d);
+    fvec_to_bf16_ref(bx.data(), x.data(), d);
+    fvec_to_bf16_ref(by.data(), y.data(), d);
+
+    float tolerance = 1e-3 * d;
+    EXPECT_NEAR(fp16vec_L2sqr_ref(hx.data(), hy.data(), d), fp16vec_L2sqr(hx.data(), hy.data(), d), tolerance);
+    EXPECT_NEAR(fp16vec_inner_product_ref(hx.data(), hy.data(), d), fp16vec_inner_product(hx.data(), hy.data(), d),
+                tolerance);
+    EXPECT_NEAR(bf16vec_L2sqr_ref(bx.data(), by.data(), d), bf16vec_L2sqr(bx.data(), by.data(), d), tolerance);
+    EXPECT_NEAR(bf16vec_inner_product_ref(bx.data(), by.data(), d), bf16vec_inner_product(bx.data(), by.data(), d),
+                tolerance);
+
+    // half precision distance should stay close to the float one
+    EXPECT_NEAR(fvec_L2sqr_ref(x.data(), y.data(), d), fp16vec_L2sqr(hx.data(), hy.data(), d), 1e-2 * d);
+    EXPECT_NEAR(fvec_inner_product_ref(x.data(), y.data(), d), bf16vec_inner_product(bx.data(), by.data(), d),
+                1e-2 * d);
+  }
+}
+
+}  // namespace dingodb
@@ -0,0 +1,70 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "simd/distances_ref.h"
+#include "simd/hook.h"
+
+namespace dingodb {
+
+class SimdDistancesInt8Test : public testing::Test {
+ protected:
+  static void SetUpTestSuite() {
+    std::string simd_type;
+    fvec_hook(simd_type);
+  }
+
+  static std::vector<int8_t> RandomCodes(size_t d, uint32_t seed) {
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int> distrib(-127, 127);
+    std::vector<int8_t> codes(d);
+    for (auto& code : codes) {
+      code = static_cast<int8_t>(distrib(rng));
+    }
+    return codes;
+  }
+};
+
+TEST_F(SimdDistancesInt8Test, InnerProduct) {
+  for (size_t d : {1, 15, 16, 31, 33, 128, 769}) {
+    auto x = RandomCodes(d, d);
+    auto y = RandomCodes(d, d + 1);
+    EXPECT_EQ(i8vec_inner_product_ref(x.data(), y.data(), d), i8vec_inner_product(x.data(), y.data(), d)) << d;
+  }
+}
+
+TEST_F(SimdDistancesInt8Test, L2sqr) {
+  for (size_t d : {1, 15, 16, 31, 33, 128, 769}) {
+    auto x = RandomCodes(d, d);
+    auto y = RandomCodes(d, d + 1);
+    EXPECT_EQ(i8vec_L2sqr_ref(x.data(), y.data(), d), i8vec_L2sqr(x.data(), y.data(), d)) << d;
+  }
+}
+
+TEST_F(SimdDistancesInt8Test, Extremes) {
+  size_t d = 1024;
+  std::vector<int8_t> x(d, 127);
+  std::vector<int8_t> y(d, -127);
+  EXPECT_EQ(-127 * 127 * static_cast<int32_t>(d), i8vec_inner_product(x.data(), y.data(), d));
+  EXPECT_EQ(254 * 254 * static_cast<int32_t>(d), i8vec_L2sqr(x.data(), y.data(), d));
+}
+
+}  // namespace dingodb
@@ -0,0 +1,98 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "simd/distances_ref.h"
+#include "simd/hook.h"
+
+namespace dingodb {
+
+class SimdDistancesNxNyTest : public testing::Test {
+ protected:
+  static void SetUpTestSuite() {
+    std::string simd_type;
+    fvec_hook(simd_type);
+  }
+
+  static std::vector<float> RandomVectors(size_t n, size_t d) {
+    std::mt19937 rng(n * 131 + d);
+    std::uniform_real_distribution<float> distrib(-1.0f, 1.0f);
+    std::vector<float> values(n * d);
+    for (auto& value : values) {
+      value = distrib(rng);
+    }
+    return values;
+  }
+
+  static void ExpectNear(const std::vector<float>& expect, const std::vector<float>& actual) {
+    ASSERT_EQ(expect.size(), actual.size());
+    for (size_t i = 0; i < expect.size(); ++i) {
+      EXPECT_NEAR(expect[i], actual[i], 1e-3 * std::max(1.0f, std::fabs(expect[i]))) << "pos: " << i;
+    }
+  }
+};
+
+TEST_F(SimdDistancesNxNyTest, L2sqr) {
+  for (size_t d : {1, 3, 8, 17, 64, 768}) {
+    for (size_t nx : {1, 3, 4, 9}) {
+      size_t ny = 257;
+      auto x = RandomVectors(nx, d);
+      auto y = RandomVectors(ny, d);
+
+      std::vector<float> expect(nx * ny);
+      for (size_t i = 0; i < nx; ++i) {
+        fvec_L2sqr_ny_ref(expect.data() + i * ny, x.data() + i * d, y.data(), d, ny);
+      }
+
+      std::vector<float> actual(nx * ny);
+      fvec_L2sqr_nx_ny(actual.data(), x.data(), y.data(), d, nx, ny);
+      ExpectNear(expect, actual);
+    }
+  }
+}
+
+TEST_F(SimdDistancesNxNyTest, InnerProduct) {
+  for (size_t d : {1, 3, 8, 17, 64, 768}) {
+    for (size_t nx : {1, 3, 4, 9}) {
+      size_t ny = 257;
+      auto x = RandomVectors(nx, d);
+      auto y = RandomVectors(ny, d);
+
+      std::vector<float> expect(nx * ny);
+      for (size_t i = 0; i < nx; ++i) {
+        fvec_inner_products_ny_ref(expect.data() + i * ny, x.data() + i * d, y.data(), d, ny);
+      }
+
+      std::vector<float> actual(nx * ny);
+      fvec_inner_products_nx_ny(actual.data(), x.data(), y.data(), d, nx, ny);
+      ExpectNear(expect, actual);
+    }
+  }
+}
+
+TEST_F(SimdDistancesNxNyTest, BlockSize) {
+  EXPECT_EQ(1, fvec_nx_ny_block_size(0));
+  EXPECT_GE(fvec_nx_ny_block_size(768), 1);
+  EXPECT_GE(fvec_nx_ny_block_size(1), fvec_nx_ny_block_size(768));
+}
+
+}  // namespace dingodb
@@ -0,0 +1,111 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <random>
+#include <set>
+#include <vector>
+
+#include "vector/vector_id_bitmap.h"
+
+namespace dingodb {
+
+class VectorIdBitmapTest : public testing::Test {};
+
+TEST_F(VectorIdBitmapTest, AddRemoveContains) {
+  VectorIdBitmap bitmap;
+  EXPECT_TRUE(bitmap.Empty());
+
+  bitmap.Add(1);
+  bitmap.Add(1);
+  bitmap.Add(65536);
+  bitmap.Add(1LL << 40);
+  EXPECT_EQ(3, bitmap.Cardinality());
+  EXPECT_TRUE(bitmap.Contains(1));
+  EXPECT_TRUE(bitmap.Contains(65536));
+  EXPECT_TRUE(bitmap.Contains(1LL << 40));
+  EXPECT_FALSE(bitmap.Contains(2));
+
+  bitmap.Remove(65536);
+  bitmap.Remove(3);
+  EXPECT_EQ(2, bitmap.Cardinality());
+  EXPECT_FALSE(bitmap.Contains(65536));
+  EXPECT_EQ(std::vector<int64_t>({1, 1LL << 40}), bitmap.ToVector());
+}
+
+TEST_F(VectorIdBitmapTest, DenseContainer) {
+  VectorIdBitmap bitmap;
+  std::set<int64_t> expect;
+  std::mt19937 rng(7);
+  std::uniform_int_distribution<int64_t> distrib(1, 3 * 65536);
+  for (int i = 0; i < 50000; ++i) {
+    int64_t id = distrib(rng);
+    bitmap.Add(id);
+    expect.insert(id);
+  }
+  EXPECT_EQ(static_cast<int64_t>(expect.size()), bitmap.Cardinality());
+  EXPECT_EQ(std::vector<int64_t>(expect.begin(), expect.end()), bitmap.ToVector());
+
+  // shrink back to array containers
+  for (auto it = expect.begin(); it != expect.end();) {
+    if (*it % 16 != 0) {
+      bitmap.Remove(*it);
+      it = expect.erase(it);
+    } else {
+      ++it;
+    }
+  }
+  EXPECT_EQ(static_cast<int64_t>(expect.size()), bitmap.Cardinality());
+  EXPECT_EQ(std::vector<int64_t>(expect.begin(), expect.end()), bitmap.ToVector());
+}
+
+TEST_F(VectorIdBitmapTest, And) {
+  VectorIdBitmap even;
+  VectorIdBitmap triple;
+  VectorIdBitmap sparse;
+  for (int64_t id = 1; id <= 200000; ++id) {
+    if (id % 2 == 0) even.Add(id);
+    if (id % 3 == 0) triple.Add(id);
+    if (id % 1000 == 0) sparse.Add(id);
+  }
+
+  // bitset and bitset
+  VectorIdBitmap result = even;
+  result.And(triple);
+  std::vector<int64_t> expect;
+  for (int64_t id = 6; id <= 200000; id += 6) {
+    expect.push_back(id);
+  }
+  EXPECT_EQ(expect, result.ToVector());
+
+  // bitset and array, array and bitset
+  VectorIdBitmap result2 = triple;
+  result2.And(sparse);
+  VectorIdBitmap result3 = sparse;
+  result3.And(triple);
+  expect.clear();
+  for (int64_t id = 3000; id <= 200000; id += 3000) {
+    expect.push_back(id);
+  }
+  EXPECT_EQ(expect, result2.ToVector());
+  EXPECT_EQ(expect, result3.ToVector());
+
+  VectorIdBitmap empty;
+  result3.And(empty);
+  EXPECT_TRUE(result3.Empty());
+}
+
+}  // namespace dingodb
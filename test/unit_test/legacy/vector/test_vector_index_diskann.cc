@@ -0,0 +1,167 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <fcntl.h>
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "proto/common.pb.h"
+#include "vector/vector_index_diskann.h"
+
+namespace dingodb {
+
+class VectorIndexDiskAnnTest : public testing::Test {
+ protected:
+  void TearDown() override {
+    std::remove(kSegmentPath.c_str());
+    std::remove(kSnapshotPath.c_str());
+  }
+
+  static std::vector<float> RandomVectors(size_t count, uint32_t dimension) {
+    std::mt19937 rng(count);
+    std::uniform_real_distribution<float> distrib(0.0F, 1.0F);
+    std::vector<float> vectors(count * dimension);
+    for (auto& value : vectors) {
+      value = distrib(rng);
+    }
+    return vectors;
+  }
+
+  static pb::common::VectorIndexParameter Parameter(uint32_t dimension, pb::common::MetricType metric_type) {
+    pb::common::VectorIndexParameter parameter;
+    parameter.set_vector_index_type(pb::common::VECTOR_INDEX_TYPE_DISKANN);
+    parameter.mutable_diskann_parameter()->set_dimension(dimension);
+    parameter.mutable_diskann_parameter()->set_metric_type(metric_type);
+    parameter.mutable_diskann_parameter()->set_num_neighbors(32);
+    return parameter;
+  }
+
+  inline static const std::string kSegmentPath = "./vector_index_diskann_test.seg";
+  inline static const std::string kSnapshotPath = "./vector_index_diskann_test.snapshot";
+};
+
+TEST_F(VectorIndexDiskAnnTest, SegmentSearch) {
+  const uint32_t dimension = 16;
+  // enough vectors to navigate by pq
+  const size_t count = 2000;
+  auto vectors = RandomVectors(count, dimension);
+  std::vector<int64_t> ids(count);
+  for (size_t i = 0; i < count; ++i) {
+    ids[i] = 100 + i * 2;
+  }
+
+  int fd = open(kSegmentPath.c_str(), O_CREAT | O_TRUNC | O_RDWR, 0644);
+  ASSERT_GE(fd, 0);
+  uint64_t segment_size = 0;
+  auto status = DiskAnnSegment::Build(fd, 0, nullptr, pb::common::METRIC_TYPE_L2, dimension, 32, ids, vectors,
+                                      segment_size);
+  close(fd);
+  ASSERT_TRUE(status.ok()) << status.error_str();
+
+  auto segment = DiskAnnSegment::Open(kSegmentPath, 0, status);
+  ASSERT_TRUE(status.ok()) << status.error_str();
+  EXPECT_EQ(count, segment->Count());
+  EXPECT_EQ(segment_size, segment->Size());
+  EXPECT_TRUE(segment->Contains(100));
+  EXPECT_FALSE(segment->Contains(101));
+
+  std::vector<float> vector(dimension);
+  ASSERT_TRUE(segment->ReadVector(5, vector.data()));
+  EXPECT_EQ(std::vector<float>(vectors.begin() + 5 * dimension, vectors.begin() + 6 * dimension), vector);
+
+  // query by indexed vectors, the nearest must be itself
+  int found = 0;
+  for (size_t i = 0; i < count; i += 20) {
+    std::vector<DiskAnnSegment::Result> results;
+    segment->Search(vectors.data() + i * dimension, 10, false, 0.0F, 64, 4, nullptr, results);
+    ASSERT_LE(results.size(), 10);
+    ASSERT_TRUE(std::is_sorted(results.begin(), results.end()));
+    if (!results.empty() && results[0].second == ids[i]) {
+      ++found;
+    }
+  }
+  EXPECT_GE(found, 95);
+
+  // filter out itself
+  std::vector<DiskAnnSegment::Result> results;
+  segment->Search(vectors.data(), 10, false, 0.0F, 64, 4, [&](int64_t id) { return id != ids[0]; }, results);
+  for (const auto& result : results) {
+    EXPECT_NE(ids[0], result.second);
+  }
+}
+
+TEST_F(VectorIndexDiskAnnTest, UpsertDeleteSaveLoad) {
+  const uint32_t dimension = 8;
+  const size_t count = 100;
+  auto vectors = RandomVectors(count, dimension);
+
+  auto parameter = Parameter(dimension, pb::common::METRIC_TYPE_L2);
+  auto index = std::make_shared<VectorIndexDiskAnn>(1, parameter, pb::common::RegionEpoch(), pb::common::Range(),
+                                                    nullptr);
+
+  std::vector<pb::common::VectorWithId> vector_with_ids(count);
+  for (size_t i = 0; i < count; ++i) {
+    vector_with_ids[i].set_id(i + 1);
+    for (uint32_t j = 0; j < dimension; ++j) {
+      vector_with_ids[i].mutable_vector()->add_float_values(vectors[i * dimension + j]);
+    }
+  }
+  ASSERT_TRUE(index->Upsert(vector_with_ids).ok());
+  ASSERT_TRUE(index->Delete({1, 2, 3}).ok());
+
+  int64_t total = 0;
+  ASSERT_TRUE(index->GetCount(total).ok());
+  EXPECT_EQ(count - 3, total);
+
+  std::vector<pb::index::VectorWithDistanceResult> results;
+  ASSERT_TRUE(index->Search({vector_with_ids[9]}, 5, {}, false, {}, results).ok());
+  ASSERT_EQ(1, results.size());
+  ASSERT_EQ(5, results[0].vector_with_distances_size());
+  EXPECT_EQ(10, results[0].vector_with_distances(0).vector_with_id().id());
+  EXPECT_FLOAT_EQ(0.0F, results[0].vector_with_distances(0).distance());
+
+  results.clear();
+  ASSERT_TRUE(index->Search({vector_with_ids[0]}, 5, {}, false, {}, results).ok());
+  for (const auto& vector_with_distance : results[0].vector_with_distances()) {
+    EXPECT_GT(vector_with_distance.vector_with_id().id(), 3);
+  }
+
+  ASSERT_TRUE(index->Save(kSnapshotPath).ok());
+
+  auto new_index = std::make_shared<VectorIndexDiskAnn>(1, parameter, pb::common::RegionEpoch(),
+                                                        pb::common::Range(), nullptr);
+  ASSERT_TRUE(new_index->Load(kSnapshotPath).ok());
+  ASSERT_TRUE(new_index->GetCount(total).ok());
+  EXPECT_EQ(count - 3, total);
+
+  std::vector<pb::index::VectorWithDistanceResult> new_results;
+  ASSERT_TRUE(new_index->Search({vector_with_ids[9]}, 5, {}, false, {}, new_results).ok());
+  ASSERT_EQ(1, new_results.size());
+  EXPECT_EQ(10, new_results[0].vector_with_distances(0).vector_with_id().id());
+
+  // wrong dimension
+  auto other_index = std::make_shared<VectorIndexDiskAnn>(1, Parameter(dimension + 1, pb::common::METRIC_TYPE_L2),
+                                                          pb::common::RegionEpoch(), pb::common::Range(), nullptr);
+  EXPECT_FALSE(other_index->Load(kSnapshotPath).ok());
+}
+
+}  // namespace dingodb
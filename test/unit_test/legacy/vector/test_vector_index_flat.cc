@@ -929,6 +929,44 @@ TEST_F(VectorIndexFlatTest, Search) {
   // }
 }
 
+TEST_F(VectorIndexFlatTest, SearchReconstruct) {
+  butil::Status ok;
+
+  pb::common::VectorWithId vector_with_id;
+  vector_with_id.set_id(0 + data_base_size);
+  vector_with_id.mutable_vector()->set_dimension(dimension);
+  vector_with_id.mutable_vector()->set_value_type(::dingodb::pb::common::ValueType::FLOAT);
+  for (size_t i = 0; i < dimension; i++) {
+    vector_with_id.mutable_vector()->add_float_values(data_base[i]);
+  }
+  uint32_t topk = 3;
+  std::vector<pb::common::VectorWithId> vector_with_ids;
+  vector_with_ids.push_back(vector_with_id);
+
+  // exact vectors, reconstruct from index
+  {
+    std::vector<pb::index::VectorWithDistanceResult> results;
+    ok = vector_index_flat_l2->Search(vector_with_ids, topk, {}, true, {}, results);
+    EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
+    ASSERT_EQ(results.size(), 1);
+    EXPECT_GT(results[0].vector_with_distances_size(), 0);
+    for (const auto& vector_with_distance : results[0].vector_with_distances()) {
+      EXPECT_EQ(vector_with_distance.vector_with_id().vector().float_values_size(), dimension);
+    }
+  }
+
+  // normalized vectors, leave to caller read from kv
+  {
+    std::vector<pb::index::VectorWithDistanceResult> results;
+    ok = vector_index_flat_cosine->Search(vector_with_ids, topk, {}, true, {}, results);
+    EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
+    ASSERT_EQ(results.size(), 1);
+    for (const auto& vector_with_distance : results[0].vector_with_distances()) {
+      EXPECT_EQ(vector_with_distance.vector_with_id().vector().float_values_size(), 0);
+    }
+  }
+}
+
 TEST_F(VectorIndexFlatTest, RangeSearch) {
   butil::Status ok;
 
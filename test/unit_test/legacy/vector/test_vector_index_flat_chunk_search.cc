@@ -0,0 +1,154 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "butil/status.h"
+#include "gflags/gflags.h"
+#include "proto/common.pb.h"
+#include "proto/error.pb.h"
+#include "proto/index.pb.h"
+#include "vector/vector_index_factory.h"
+
+namespace dingodb {
+
+DECLARE_int64(flat_chunk_search_min_chunk_size);
+
+class VectorIndexFlatChunkSearchTest : public testing::Test {
+ protected:
+  static void SetUpTestSuite() {
+    vector_index_thread_pool = std::make_shared<ThreadPool>("vector_index", 4);
+    FLAGS_flat_chunk_search_min_chunk_size = 1000;
+  }
+
+  static void TearDownTestSuite() { vector_index_thread_pool.reset(); }
+
+  static std::shared_ptr<VectorIndex> NewFlat(pb::common::MetricType metric_type) {
+    pb::common::VectorIndexParameter index_parameter;
+    index_parameter.set_vector_index_type(pb::common::VectorIndexType::VECTOR_INDEX_TYPE_FLAT);
+    index_parameter.mutable_flat_parameter()->set_dimension(kDimension);
+    index_parameter.mutable_flat_parameter()->set_metric_type(metric_type);
+    auto vector_index =
+        VectorIndexFactory::NewFlat(1, index_parameter, pb::common::RegionEpoch(), pb::common::Range(),
+                                    vector_index_thread_pool);
+
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<float> distrib(0.0F, 1.0F);
+    std::vector<pb::common::VectorWithId> vector_with_ids(kDataSize);
+    for (size_t i = 0; i < kDataSize; ++i) {
+      vector_with_ids[i].set_id(kVectorIdStart + i);
+      vector_with_ids[i].mutable_vector()->set_dimension(kDimension);
+      for (int j = 0; j < kDimension; ++j) {
+        vector_with_ids[i].mutable_vector()->add_float_values(distrib(rng));
+      }
+    }
+    auto status = vector_index->Add(vector_with_ids);
+    EXPECT_TRUE(status.ok()) << status.error_str();
+
+    return vector_index;
+  }
+
+  static std::vector<pb::common::VectorWithId> Queries(size_t count) {
+    std::mt19937 rng(2);
+    std::uniform_real_distribution<float> distrib(0.0F, 1.0F);
+    std::vector<pb::common::VectorWithId> vector_with_ids(count);
+    for (auto& vector_with_id : vector_with_ids) {
+      vector_with_id.mutable_vector()->set_dimension(kDimension);
+      for (int j = 0; j < kDimension; ++j) {
+        vector_with_id.mutable_vector()->add_float_values(distrib(rng));
+      }
+    }
+    return vector_with_ids;
+  }
+
+  static void ExpectSameResults(const std::vector<pb::index::VectorWithDistanceResult>& expected,
+                                const std::vector<pb::index::VectorWithDistanceResult>& actual) {
+    ASSERT_EQ(expected.size(), actual.size());
+    for (size_t i = 0; i < expected.size(); ++i) {
+      ASSERT_EQ(expected[i].vector_with_distances_size(), actual[i].vector_with_distances_size());
+      for (int j = 0; j < expected[i].vector_with_distances_size(); ++j) {
+        EXPECT_EQ(expected[i].vector_with_distances(j).vector_with_id().id(),
+                  actual[i].vector_with_distances(j).vector_with_id().id());
+        EXPECT_FLOAT_EQ(expected[i].vector_with_distances(j).distance(), actual[i].vector_with_distances(j).distance());
+      }
+    }
+  }
+
+  inline static constexpr int kDimension = 16;
+  inline static constexpr size_t kDataSize = 10000;
+  inline static constexpr int64_t kVectorIdStart = 1000;
+  inline static ThreadPoolPtr vector_index_thread_pool;
+};
+
+TEST_F(VectorIndexFlatChunkSearchTest, SameAsSearch) {
+  for (auto metric_type : {pb::common::MetricType::METRIC_TYPE_L2, pb::common::MetricType::METRIC_TYPE_INNER_PRODUCT,
+                           pb::common::MetricType::METRIC_TYPE_COSINE}) {
+    auto vector_index = NewFlat(metric_type);
+    ASSERT_NE(nullptr, vector_index);
+    auto queries = Queries(2);
+
+    std::vector<pb::index::VectorWithDistanceResult> expected;
+    ASSERT_TRUE(vector_index->Search(queries, 20, {}, false, {}, expected).ok());
+
+    std::vector<pb::index::VectorWithDistanceResult> actual;
+    auto status = vector_index->SearchByChunk(queries, 20, {}, actual);
+    ASSERT_TRUE(status.ok()) << status.error_str();
+    ExpectSameResults(expected, actual);
+
+    // SearchByParallel takes the chunk path as well
+    actual.clear();
+    ASSERT_TRUE(vector_index->SearchByParallel(queries, 20, {}, false, {}, actual).ok());
+    ExpectSameResults(expected, actual);
+  }
+}
+
+TEST_F(VectorIndexFlatChunkSearchTest, Filter) {
+  auto vector_index = NewFlat(pb::common::MetricType::METRIC_TYPE_L2);
+  ASSERT_NE(nullptr, vector_index);
+  auto queries = Queries(1);
+
+  // sparse ids spread over all chunks, fewer than topk
+  std::vector<int64_t> filter_ids;
+  for (size_t i = 0; i < kDataSize; i += 1111) {
+    filter_ids.push_back(kVectorIdStart + i);
+  }
+  std::vector<std::shared_ptr<VectorIndex::FilterFunctor>> filters;
+  filters.emplace_back(std::make_shared<VectorIndex::ConcreteFilterFunctor>(filter_ids));
+
+  std::vector<pb::index::VectorWithDistanceResult> expected;
+  ASSERT_TRUE(vector_index->Search(queries, 20, filters, false, {}, expected).ok());
+  ASSERT_EQ(filter_ids.size(), expected[0].vector_with_distances_size());
+
+  std::vector<pb::index::VectorWithDistanceResult> actual;
+  ASSERT_TRUE(vector_index->SearchByChunk(queries, 20, filters, actual).ok());
+  ExpectSameResults(expected, actual);
+}
+
+TEST_F(VectorIndexFlatChunkSearchTest, NotSuitable) {
+  auto vector_index = NewFlat(pb::common::MetricType::METRIC_TYPE_L2);
+  ASSERT_NE(nullptr, vector_index);
+
+  // too many queries, parallel over rows
+  std::vector<pb::index::VectorWithDistanceResult> results;
+  auto status = vector_index->SearchByChunk(Queries(100), 10, {}, results);
+  EXPECT_EQ(pb::error::EVECTOR_NOT_SUPPORT, status.error_code());
+  EXPECT_TRUE(results.empty());
+}
+
+}  // namespace dingodb
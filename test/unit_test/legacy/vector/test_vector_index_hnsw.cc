@@ -14,6 +14,7 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
 #include <array>
 #include <cstddef>
 #include <cstdint>
@@ -26,6 +27,7 @@
 
 #include "butil/status.h"
 #include "faiss/MetricType.h"
+#include "gflags/gflags.h"
 #include "fmt/core.h"
 #include "proto/common.pb.h"
 #include "proto/error.pb.h"
@@ -37,6 +39,8 @@
 
 namespace dingodb {
 
+DECLARE_double(hnsw_filtered_search_max_selectivity);
+
 class VectorIndexHnswTest : public testing::Test {
  protected:
   static void SetUpTestSuite() {}
@@ -345,6 +349,37 @@ TEST_F(VectorIndexHnswTest, EfSearch) {
   }
 }
 
+TEST_F(VectorIndexHnswTest, FilteredSearch) {
+  // always use the filter-aware traversal
+  FLAGS_hnsw_filtered_search_max_selectivity = 1.0;
+
+  pb::common::VectorWithId vector_with_id;
+  vector_with_id.set_id(0);
+  vector_with_id.mutable_vector()->set_dimension(dimension);
+  vector_with_id.mutable_vector()->set_value_type(::dingodb::pb::common::ValueType::FLOAT);
+  for (size_t i = 0; i < dimension; i++) {
+    vector_with_id.mutable_vector()->add_float_values(data_base[i + dimension]);
+  }
+  std::vector<pb::common::VectorWithId> vector_with_ids = {vector_with_id};
+
+  std::vector<int64_t> vector_ids = {1, 3, 5, 7};
+  auto filter = std::make_shared<VectorIndex::ConcreteFilterFunctor>(vector_ids);
+  std::vector<pb::index::VectorWithDistanceResult> results;
+  auto ok = vector_index_hnsw->Search(vector_with_ids, 10, {filter}, false, {}, results);
+  EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
+
+  ASSERT_EQ(results.size(), 1);
+  EXPECT_EQ(results[0].vector_with_distances_size(), vector_ids.size());
+  for (const auto &vector_with_distance : results[0].vector_with_distances()) {
+    int64_t id = vector_with_distance.vector_with_id().id();
+    EXPECT_NE(std::find(vector_ids.begin(), vector_ids.end(), id), vector_ids.end());
+  }
+  // the query is the vector 1
+  EXPECT_EQ(results[0].vector_with_distances(0).vector_with_id().id(), 1);
+
+  FLAGS_hnsw_filtered_search_max_selectivity = 0.0;
+}
+
 TEST_F(VectorIndexHnswTest, CreateCosine) {
   static const pb::common::Range kRange;
   // valid param L2
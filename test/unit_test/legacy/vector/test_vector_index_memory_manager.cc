@@ -0,0 +1,55 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "vector/vector_index_memory_manager.h"
+
+namespace dingodb {
+
+TEST(VectorIndexMemoryManagerTest, SelectEvictions) {
+  int64_t now_ms = 100000;
+  std::vector<VectorIndexMemoryManager::Usage> usages = {{100, now_ms - 50000, true},
+                                                         {100, now_ms - 90000, true},
+                                                         {100, now_ms, true},
+                                                         {0, now_ms - 99000, true},
+                                                         {100, now_ms - 70000, true}};
+
+  // no limit
+  EXPECT_TRUE(VectorIndexMemoryManager::SelectEvictions(usages, 0, 10000, now_ms).empty());
+  // within budget
+  EXPECT_TRUE(VectorIndexMemoryManager::SelectEvictions(usages, 400, 10000, now_ms).empty());
+
+  // coldest first, skip the evicted
+  EXPECT_EQ(std::vector<size_t>({1, 4}), VectorIndexMemoryManager::SelectEvictions(usages, 250, 10000, now_ms));
+
+  // the hot one is kept even over budget
+  EXPECT_EQ(std::vector<size_t>({1, 4, 0}), VectorIndexMemoryManager::SelectEvictions(usages, 1, 10000, now_ms));
+}
+
+TEST(VectorIndexMemoryManagerTest, SkipNotEvictable) {
+  int64_t now_ms = 100000;
+  // the coldest is a leader or in rebuild
+  std::vector<VectorIndexMemoryManager::Usage> usages = {
+      {100, now_ms - 90000, false}, {100, now_ms - 50000, true}, {100, now_ms - 70000, true}};
+
+  EXPECT_EQ(std::vector<size_t>({2}), VectorIndexMemoryManager::SelectEvictions(usages, 250, 10000, now_ms));
+  EXPECT_EQ(std::vector<size_t>({2, 1}), VectorIndexMemoryManager::SelectEvictions(usages, 100, 10000, now_ms));
+}
+
+}  // namespace dingodb
@@ -0,0 +1,121 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "faiss/IndexFlat.h"
+#include "faiss/index_io.h"
+#include "gflags/gflags.h"
+#include "vector/vector_index_mmap_reader.h"
+
+namespace dingodb {
+
+DECLARE_bool(vector_index_load_use_mmap);
+DECLARE_uint64(vector_index_mmap_release_bytes);
+
+class VectorIndexMmapReaderTest : public testing::Test {
+ protected:
+  void TearDown() override { std::remove(kFilePath.c_str()); }
+
+  inline static const std::string kFilePath = "./vector_index_mmap_reader_test.data";
+};
+
+TEST_F(VectorIndexMmapReaderTest, Read) {
+  std::vector<uint8_t> data(3 * 4096 + 123);
+  for (size_t i = 0; i < data.size(); ++i) {
+    data[i] = static_cast<uint8_t>(i * 31);
+  }
+  {
+    std::ofstream out(kFilePath, std::ios::binary);
+    out.write(reinterpret_cast<const char*>(data.data()), data.size());
+  }
+
+  // release pages while reading
+  FLAGS_vector_index_mmap_release_bytes = 4096;
+
+  VectorIndexMmapReader reader;
+  ASSERT_TRUE(reader.Open(kFilePath).ok());
+  EXPECT_EQ(data.size(), reader.Size());
+
+  std::vector<uint8_t> result(data.size());
+  size_t offset = 0;
+  size_t chunk = 1;
+  while (offset < data.size()) {
+    size_t count = reader(result.data() + offset, 1, std::min(chunk, data.size() - offset));
+    ASSERT_GT(count, 0);
+    offset += count;
+    chunk = chunk * 3 + 1;
+  }
+  EXPECT_EQ(data, result);
+  EXPECT_EQ(data.size(), reader.Offset());
+
+  // read past end
+  uint8_t byte = 0;
+  EXPECT_EQ(0, reader(&byte, 1, 1));
+}
+
+TEST_F(VectorIndexMmapReaderTest, ReadPartialItem) {
+  std::vector<uint8_t> data(10, 7);
+  {
+    std::ofstream out(kFilePath, std::ios::binary);
+    out.write(reinterpret_cast<const char*>(data.data()), data.size());
+  }
+
+  VectorIndexMmapReader reader;
+  ASSERT_TRUE(reader.Open(kFilePath).ok());
+
+  // only whole items are returned
+  std::vector<uint32_t> result(3, 0);
+  EXPECT_EQ(2, reader(result.data(), sizeof(uint32_t), result.size()));
+  EXPECT_EQ(8, reader.Offset());
+}
+
+TEST_F(VectorIndexMmapReaderTest, OpenNotExist) {
+  VectorIndexMmapReader reader;
+  EXPECT_FALSE(reader.Open("./vector_index_mmap_reader_not_exist.data").ok());
+}
+
+TEST_F(VectorIndexMmapReaderTest, ReadIndex) {
+  const int dimension = 16;
+  const int count = 1000;
+  faiss::IndexFlatL2 index(dimension);
+  std::vector<float> vectors(dimension * count);
+  for (size_t i = 0; i < vectors.size(); ++i) {
+    vectors[i] = static_cast<float>(i % 97) / 97.0F;
+  }
+  index.add(count, vectors.data());
+  faiss::write_index(&index, kFilePath.c_str());
+
+  FLAGS_vector_index_load_use_mmap = true;
+  std::unique_ptr<faiss::Index> load_index(VectorIndexMmapReader::ReadIndex(kFilePath));
+  FLAGS_vector_index_load_use_mmap = false;
+  ASSERT_NE(nullptr, load_index);
+  EXPECT_EQ(dimension, load_index->d);
+  EXPECT_EQ(count, load_index->ntotal);
+
+  auto* flat_index = dynamic_cast<faiss::IndexFlatL2*>(load_index.get());
+  ASSERT_NE(nullptr, flat_index);
+  EXPECT_EQ(0, memcmp(vectors.data(), flat_index->get_xb(), vectors.size() * sizeof(float)));
+}
+
+}  // namespace dingodb
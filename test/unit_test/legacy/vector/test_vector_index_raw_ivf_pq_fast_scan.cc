@@ -0,0 +1,132 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "proto/common.pb.h"
+#include "proto/index.pb.h"
+#include "vector/vector_index_raw_ivf_pq.h"
+
+namespace dingodb {
+
+class VectorIndexRawIvfPqFastScanTest : public testing::Test {
+ protected:
+  void TearDown() override { std::remove(kPath.c_str()); }
+
+  static std::shared_ptr<VectorIndexRawIvfPq> NewIndex(int32_t nbits_per_idx) {
+    pb::common::VectorIndexParameter index_parameter;
+    index_parameter.set_vector_index_type(pb::common::VectorIndexType::VECTOR_INDEX_TYPE_IVF_PQ);
+    auto* ivf_pq_parameter = index_parameter.mutable_ivf_pq_parameter();
+    ivf_pq_parameter->set_dimension(kDimension);
+    ivf_pq_parameter->set_metric_type(pb::common::MetricType::METRIC_TYPE_L2);
+    ivf_pq_parameter->set_ncentroids(kNcentroids);
+    ivf_pq_parameter->set_nsubvector(kNsubvector);
+    ivf_pq_parameter->set_nbits_per_idx(nbits_per_idx);
+    return std::make_shared<VectorIndexRawIvfPq>(1, index_parameter, pb::common::RegionEpoch(), pb::common::Range(),
+                                                 nullptr);
+  }
+
+  static std::vector<pb::common::VectorWithId> Vectors() {
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<float> distrib(0.0F, 1.0F);
+    std::vector<pb::common::VectorWithId> vector_with_ids(kDataSize);
+    for (int i = 0; i < kDataSize; ++i) {
+      vector_with_ids[i].set_id(kStartId + i);
+      for (int j = 0; j < kDimension; ++j) {
+        vector_with_ids[i].mutable_vector()->add_float_values(distrib(rng));
+      }
+    }
+    return vector_with_ids;
+  }
+
+  inline static constexpr int kDimension = 32;
+  inline static constexpr int kDataSize = 2000;
+  inline static constexpr int32_t kNcentroids = 8;
+  inline static constexpr int32_t kNsubvector = 16;
+  inline static constexpr int64_t kStartId = 1000;
+  inline static const std::string kPath = "./vector_index_raw_ivf_pq_fast_scan_test";
+};
+
+TEST_F(VectorIndexRawIvfPqFastScanTest, FastScan) {
+  EXPECT_TRUE(NewIndex(4)->IsFastScan());
+  EXPECT_FALSE(NewIndex(8)->IsFastScan());
+
+  auto index = NewIndex(4);
+  auto vector_with_ids = Vectors();
+  ASSERT_TRUE(index->Train(vector_with_ids).ok());
+  ASSERT_TRUE(index->Add(vector_with_ids).ok());
+
+  int64_t count = 0;
+  ASSERT_TRUE(index->GetCount(count).ok());
+  EXPECT_EQ(kDataSize, count);
+
+  pb::common::VectorSearchParameter parameter;
+  parameter.mutable_ivf_pq()->set_nprobe(kNcentroids);
+
+  // query by indexed vectors, the nearest should be mostly itself
+  std::vector<pb::common::VectorWithId> queries(vector_with_ids.begin(), vector_with_ids.begin() + 100);
+  std::vector<pb::index::VectorWithDistanceResult> results;
+  ASSERT_TRUE(index->Search(queries, 10, {}, false, parameter, results).ok());
+  ASSERT_EQ(queries.size(), results.size());
+  int found = 0;
+  for (size_t i = 0; i < results.size(); ++i) {
+    ASSERT_EQ(10, results[i].vector_with_distances_size());
+    for (const auto& vector_with_distance : results[i].vector_with_distances()) {
+      if (vector_with_distance.vector_with_id().id() == queries[i].id()) {
+        ++found;
+        break;
+      }
+    }
+  }
+  EXPECT_GE(found, 80);
+
+  // filter with few ids, fast scan filters the candidates
+  std::vector<int64_t> filter_ids = {kStartId + 1, kStartId + 500, kStartId + 1500};
+  std::vector<std::shared_ptr<VectorIndex::FilterFunctor>> filters = {
+      std::make_shared<VectorIndex::ConcreteFilterFunctor>(filter_ids)};
+  results.clear();
+  ASSERT_TRUE(index->Search({queries[0]}, 10, filters, false, parameter, results).ok());
+  ASSERT_EQ(1, results.size());
+  EXPECT_EQ(filter_ids.size(), results[0].vector_with_distances_size());
+  for (const auto& vector_with_distance : results[0].vector_with_distances()) {
+    EXPECT_NE(std::find(filter_ids.begin(), filter_ids.end(), vector_with_distance.vector_with_id().id()),
+              filter_ids.end());
+  }
+
+  results.clear();
+  ASSERT_TRUE(index->RangeSearch({queries[0]}, 100.0F, filters, false, parameter, results).ok());
+  ASSERT_EQ(1, results.size());
+  EXPECT_EQ(filter_ids.size(), results[0].vector_with_distances_size());
+
+  ASSERT_TRUE(index->Delete({kStartId, kStartId + 1}).ok());
+  ASSERT_TRUE(index->GetCount(count).ok());
+  EXPECT_EQ(kDataSize - 2, count);
+
+  ASSERT_TRUE(index->Save(kPath).ok());
+  auto new_index = NewIndex(4);
+  ASSERT_TRUE(new_index->Load(kPath).ok());
+  EXPECT_TRUE(new_index->IsFastScan());
+  ASSERT_TRUE(new_index->GetCount(count).ok());
+  EXPECT_EQ(kDataSize - 2, count);
+}
+
+}  // namespace dingodb
@@ -20,9 +20,13 @@
 #include <string>
 #include <vector>
 
+#include "braft/protobuf_file.h"
 #include "butil/endpoint.h"
 #include "butil/strings/string_split.h"
+#include "common/helper.h"
 #include "fmt/core.h"
+#include "proto/raft.pb.h"
+#include "proto/store_internal.pb.h"
 #include "vector/vector_index_snapshot.h"
 
 class VectorIndexSnapshotTest : public testing::Test {
@@ -102,6 +106,23 @@ TEST_F(VectorIndexSnapshotTest, ParseReaderId) {  // NOLINT
   }
 }
 
+// Create snapshot dir with meta file, base_log_id is the log id of index image.
+static dingodb::vector_index::SnapshotMetaPtr NewSnapshot(int64_t vector_index_id, const std::string& path,
+                                                          int64_t base_log_id) {
+  dingodb::Helper::CreateDirectories(path);
+
+  dingodb::pb::store_internal::VectorIndexSnapshotMeta meta;
+  meta.set_vector_index_id(vector_index_id);
+  meta.set_snapshot_log_id(base_log_id);
+  braft::ProtoBufFile pb_file_meta(fmt::format("{}/meta", path));
+  if (pb_file_meta.save(&meta, true) != 0) {
+    return nullptr;
+  }
+
+  auto snapshot = dingodb::vector_index::SnapshotMeta::New(vector_index_id, path);
+  return snapshot->Init() ? snapshot : nullptr;
+}
+
 TEST_F(VectorIndexSnapshotTest, AddSnapshot) {  // NOLINT
   int64_t vector_index_id = 100;
   std::string root_path = fmt::format("/tmp/{}", vector_index_id);
@@ -112,7 +133,8 @@ TEST_F(VectorIndexSnapshotTest, AddSnapshot) {  // NOLINT
   {
     int64_t snapshot_log_id = 5;
     std::string path = fmt::format("/tmp/{}/snapshot_{:020}", vector_index_id, snapshot_log_id);
-    auto snapshot = dingodb::vector_index::SnapshotMeta::New(vector_index_id, path);
+    auto snapshot = NewSnapshot(vector_index_id, path, snapshot_log_id);
+    ASSERT_NE(nullptr, snapshot);
 
     snapshot_set->AddSnapshot(snapshot);
     EXPECT_EQ(snapshot, snapshot_set->GetLastSnapshot());
@@ -121,7 +143,8 @@ TEST_F(VectorIndexSnapshotTest, AddSnapshot) {  // NOLINT
   {
     int64_t snapshot_log_id = 11;
     std::string path = fmt::format("/tmp/{}/snapshot_{:020}", vector_index_id, snapshot_log_id);
-    auto snapshot = dingodb::vector_index::SnapshotMeta::New(vector_index_id, path);
+    auto snapshot = NewSnapshot(vector_index_id, path, snapshot_log_id);
+    ASSERT_NE(nullptr, snapshot);
 
     snapshot_set->AddSnapshot(snapshot);
     EXPECT_EQ(snapshot, snapshot_set->GetLastSnapshot());
@@ -131,7 +154,8 @@ TEST_F(VectorIndexSnapshotTest, AddSnapshot) {  // NOLINT
   {
     int64_t snapshot_log_id = 15;
     std::string path = fmt::format("/tmp/{}/snapshot_{:020}", vector_index_id, snapshot_log_id);
-    auto snapshot = dingodb::vector_index::SnapshotMeta::New(vector_index_id, path);
+    auto snapshot = NewSnapshot(vector_index_id, path, snapshot_log_id);
+    ASSERT_NE(nullptr, snapshot);
 
     snapshot_set->AddSnapshot(snapshot);
     EXPECT_EQ(snapshot, snapshot_set->GetLastSnapshot());
@@ -140,10 +164,67 @@ TEST_F(VectorIndexSnapshotTest, AddSnapshot) {  // NOLINT
   {
     int64_t snapshot_log_id = 16;
     std::string path = fmt::format("/tmp/{}/snapshot_{:020}", vector_index_id, snapshot_log_id);
-    auto snapshot = dingodb::vector_index::SnapshotMeta::New(vector_index_id, path);
+    auto snapshot = NewSnapshot(vector_index_id, path, snapshot_log_id);
+    ASSERT_NE(nullptr, snapshot);
 
     snapshot_set->AddSnapshot(snapshot);
     EXPECT_EQ(snapshot, snapshot_set->GetLastSnapshot());
     EXPECT_EQ(1, snapshot_set->GetSnapshots().size());
   }
+
+  snapshot_set->Destroy();
+}
+
+TEST_F(VectorIndexSnapshotTest, DeltaChain) {  // NOLINT
+  int64_t vector_index_id = 101;
+  int64_t base_log_id = 10;
+  std::string path = fmt::format("/tmp/{}/snapshot_{:020}", vector_index_id, base_log_id);
+  dingodb::Helper::RemoveAllFileOrDirectory(path);
+
+  auto snapshot = NewSnapshot(vector_index_id, path, base_log_id);
+  ASSERT_NE(nullptr, snapshot);
+  EXPECT_EQ(base_log_id, snapshot->BaseLogId());
+  EXPECT_EQ(base_log_id, snapshot->SnapshotLogId());
+  EXPECT_EQ(0, snapshot->DeltaCount());
+
+  auto save_delta = [&](int64_t start_log_id, int64_t end_log_id) {
+    dingodb::pb::raft::RaftCmdRequest delta;
+    auto* request = delta.add_requests();
+    request->set_cmd_type(dingodb::pb::raft::VECTOR_DELETE);
+    request->mutable_vector_delete()->add_ids(end_log_id);
+    braft::ProtoBufFile pb_file(snapshot->DeltaPath(start_log_id, end_log_id));
+    return pb_file.save(&delta, true) == 0;
+  };
+
+  // delta must follow the chain
+  ASSERT_TRUE(save_delta(10, 20));
+  EXPECT_TRUE(snapshot->AddDelta(10, 20));
+  ASSERT_TRUE(save_delta(15, 30));
+  EXPECT_FALSE(snapshot->AddDelta(15, 30));
+  ASSERT_TRUE(save_delta(20, 30));
+  EXPECT_TRUE(snapshot->AddDelta(20, 30));
+  EXPECT_EQ(30, snapshot->SnapshotLogId());
+  EXPECT_EQ(2, snapshot->DeltaCount());
+  EXPECT_GT(snapshot->DeltaSize(), 0);
+
+  // reload from dir, the stale delta is dropped
+  auto reload_snapshot = dingodb::vector_index::SnapshotMeta::New(vector_index_id, path);
+  ASSERT_TRUE(reload_snapshot->Init());
+  EXPECT_EQ(base_log_id, reload_snapshot->BaseLogId());
+  EXPECT_EQ(30, reload_snapshot->SnapshotLogId());
+  std::vector<std::string> expect_paths = {snapshot->DeltaPath(10, 20), snapshot->DeltaPath(20, 30)};
+  EXPECT_EQ(expect_paths, reload_snapshot->DeltaPaths());
+  EXPECT_FALSE(dingodb::Helper::IsExistPath(snapshot->DeltaPath(15, 30)));
+
+  // snapshot pulled from peer is named by the log id include deltas
+  std::string peer_path = fmt::format("/tmp/{}/snapshot_{:020}", vector_index_id, 30);
+  dingodb::Helper::RemoveAllFileOrDirectory(peer_path);
+  ASSERT_TRUE(dingodb::Helper::Rename(path, peer_path).ok());
+  auto peer_snapshot = dingodb::vector_index::SnapshotMeta::New(vector_index_id, peer_path);
+  ASSERT_TRUE(peer_snapshot->Init());
+  EXPECT_EQ(base_log_id, peer_snapshot->BaseLogId());
+  EXPECT_EQ(30, peer_snapshot->SnapshotLogId());
+  EXPECT_EQ(fmt::format("{}/index_{}_{}.idx", peer_path, vector_index_id, base_log_id), peer_snapshot->IndexDataPath());
+
+  peer_snapshot->Destroy();
 }
@@ -14,17 +14,22 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
 #include <array>
 #include <cstddef>
 #include <cstdint>
 #include <cstdio>
 #include <cstdlib>
+#include <functional>
 #include <iomanip>
 #include <iostream>
+#include <memory>
 #include <random>
 #include <vector>
 
 #include "butil/status.h"
+#include "common/threadpool.h"
+#include "gflags/gflags.h"
 #include "glog/logging.h"
 #include "proto/common.pb.h"
 #include "proto/error.pb.h"
@@ -33,6 +38,8 @@
 
 namespace dingodb {
 
+DECLARE_int64(vector_calc_distance_parallel_ops);
+
 class VectorIndexUtilsTest : public testing::Test {
  protected:
   static void SetUpTestSuite() {}
@@ -4743,6 +4750,134 @@ TEST_F(VectorIndexUtilsTest, NormalizeVectorForFaiss) {
   }
 }
 
+TEST_F(VectorIndexUtilsTest, CalcDistanceMatrix) {
+  constexpr uint32_t kDimension = 17;
+  std::mt19937 rng;
+  std::uniform_real_distribution<> distrib(-1.0, 1.0);
+  auto random_vectors = [&](size_t count) {
+    google::protobuf::RepeatedPtrField<::dingodb::pb::common::Vector> vectors;
+    for (size_t i = 0; i < count; i++) {
+      auto* vector = vectors.Add();
+      for (uint32_t j = 0; j < kDimension; j++) {
+        vector->add_float_values(distrib(rng));
+      }
+    }
+    return vectors;
+  };
+  auto op_left_vectors = random_vectors(5);
+  auto op_right_vectors = random_vectors(37);
+
+  // split to chunks as many as possible
+  int64_t old_parallel_ops = FLAGS_vector_calc_distance_parallel_ops;
+  FLAGS_vector_calc_distance_parallel_ops = 1;
+  auto thread_pool = std::make_shared<ThreadPool>("calc_distance", 4);
+
+  for (auto algorithm_type : {pb::index::ALGORITHM_FAISS, pb::index::ALGORITHM_HNSWLIB}) {
+    for (auto metric_type : {pb::common::METRIC_TYPE_L2, pb::common::METRIC_TYPE_INNER_PRODUCT,
+                             pb::common::METRIC_TYPE_COSINE}) {
+      std::vector<std::vector<float>> expect_distances;
+      std::vector<::dingodb::pb::common::Vector> result_op_left_vectors;
+      std::vector<::dingodb::pb::common::Vector> result_op_right_vectors;
+      butil::Status ok;
+      if (algorithm_type == pb::index::ALGORITHM_FAISS) {
+        ok = VectorIndexUtils::CalcDistanceByFaiss(metric_type, op_left_vectors, op_right_vectors, false,
+                                                   expect_distances, result_op_left_vectors, result_op_right_vectors);
+      } else {
+        ok = VectorIndexUtils::CalcDistanceByHnswlib(metric_type, op_left_vectors, op_right_vectors, false,
+                                                     expect_distances, result_op_left_vectors,
+                                                     result_op_right_vectors);
+      }
+      EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
+
+      // full matrix
+      std::vector<std::vector<float>> distances;
+      std::vector<std::vector<uint32_t>> topk_indexes;
+      ok = VectorIndexUtils::CalcDistanceMatrix(algorithm_type, metric_type, op_left_vectors, op_right_vectors, 0,
+                                                thread_pool, distances, topk_indexes);
+      EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
+      ASSERT_EQ(expect_distances.size(), distances.size());
+      EXPECT_TRUE(topk_indexes.empty());
+      for (size_t i = 0; i < distances.size(); i++) {
+        ASSERT_EQ(expect_distances[i].size(), distances[i].size());
+        for (size_t j = 0; j < distances[i].size(); j++) {
+          EXPECT_NEAR(expect_distances[i][j], distances[i][j], 1e-4);
+        }
+      }
+
+      // topk, nearest first
+      bool is_similarity =
+          algorithm_type == pb::index::ALGORITHM_FAISS && metric_type != pb::common::METRIC_TYPE_L2;
+      ok = VectorIndexUtils::CalcDistanceMatrix(algorithm_type, metric_type, op_left_vectors, op_right_vectors, 3,
+                                                nullptr, distances, topk_indexes);
+      EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
+      ASSERT_EQ(expect_distances.size(), topk_indexes.size());
+      for (size_t i = 0; i < topk_indexes.size(); i++) {
+        ASSERT_EQ(3, topk_indexes[i].size());
+        ASSERT_EQ(3, distances[i].size());
+        auto sorted = expect_distances[i];
+        if (is_similarity) {
+          std::sort(sorted.begin(), sorted.end(), std::greater<>());
+        } else {
+          std::sort(sorted.begin(), sorted.end());
+        }
+        for (size_t k = 0; k < 3; k++) {
+          EXPECT_NEAR(expect_distances[i][topk_indexes[i][k]], distances[i][k], 1e-4);
+          EXPECT_NEAR(sorted[k], distances[i][k], 1e-4);
+        }
+      }
+    }
+  }
+
+  // dimension not match
+  {
+    auto op_short_vectors = random_vectors(2);
+    op_short_vectors[0].mutable_float_values()->RemoveLast();
+    std::vector<std::vector<float>> distances;
+    std::vector<std::vector<uint32_t>> topk_indexes;
+    auto ok = VectorIndexUtils::CalcDistanceMatrix(pb::index::ALGORITHM_FAISS, pb::common::METRIC_TYPE_L2,
+                                                   op_left_vectors, op_short_vectors, 0, nullptr, distances,
+                                                   topk_indexes);
+    EXPECT_EQ(ok.error_code(), pb::error::Errno::EILLEGAL_PARAMTETERS);
+  }
+
+  FLAGS_vector_calc_distance_parallel_ops = old_parallel_ops;
+}
+
+TEST_F(VectorIndexUtilsTest, InverseNormForFaiss) {
+  constexpr uint32_t kDimension = 16;
+  std::array<float, kDimension> query{};
+  std::array<float, kDimension> data{};
+
+  std::mt19937 rng;
+  std::uniform_real_distribution<> distrib;
+  for (uint32_t i = 0; i < kDimension; i++) {
+    query[i] = distrib(rng);
+    data[i] = distrib(rng) * 10;
+  }
+  VectorIndexUtils::NormalizeVectorForFaiss(query.data(), kDimension);
+
+  // scaled inner product of raw vector equals inner product of normalized vector
+  float inverse_norm = VectorIndexUtils::InverseNormForFaiss(data.data(), kDimension);
+  float scaled_ip = 0.0f;
+  for (uint32_t i = 0; i < kDimension; i++) {
+    scaled_ip += query[i] * data[i];
+  }
+  scaled_ip *= inverse_norm;
+
+  auto norm_data = data;
+  VectorIndexUtils::NormalizeVectorForFaiss(norm_data.data(), kDimension);
+  float ip = 0.0f;
+  for (uint32_t i = 0; i < kDimension; i++) {
+    ip += query[i] * norm_data[i];
+  }
+  EXPECT_NEAR(ip, scaled_ip, 1e-5);
+
+  // zero and unit vector are not scaled
+  std::array<float, kDimension> zero{};
+  EXPECT_EQ(1.0f, VectorIndexUtils::InverseNormForFaiss(zero.data(), kDimension));
+  EXPECT_EQ(1.0f, VectorIndexUtils::InverseNormForFaiss(norm_data.data(), kDimension));
+}
+
 TEST_F(VectorIndexUtilsTest, NormalizeVectorForHnsw) {
   // ok
   {
@@ -0,0 +1,115 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "butil/iobuf.h"
+#include "proto/common.pb.h"
+#include "proto/index.pb.h"
+#include "vector/vector_packed_codec.h"
+
+namespace dingodb {
+
+class VectorPackedCodecTest : public testing::Test {};
+
+TEST_F(VectorPackedCodecTest, SearchRequest) {
+  pb::index::VectorSearchRequest request;
+  for (int i = 0; i < 3; ++i) {
+    auto* vector_with_id = request.add_vector_with_ids();
+    // search by id, no vector
+    if (i == 1) {
+      vector_with_id->set_id(100);
+      continue;
+    }
+    for (int j = 0; j < 8; ++j) {
+      vector_with_id->mutable_vector()->add_float_values(i * 10 + j + 0.5f);
+    }
+  }
+  pb::index::VectorSearchRequest expect = request;
+
+  butil::IOBuf buf;
+  VectorPackedCodec::Pack(VectorPackedCodec::VectorWithIds(&request), buf);
+  for (const auto& vector_with_id : request.vector_with_ids()) {
+    EXPECT_TRUE(vector_with_id.vector().float_values().empty());
+  }
+  EXPECT_EQ(8 + 2 * (8 + 8 * sizeof(float)), buf.size());
+
+  EXPECT_TRUE(VectorPackedCodec::Unpack(VectorPackedCodec::VectorWithIds(&request), buf).ok());
+  EXPECT_TRUE(buf.empty());
+  ASSERT_EQ(expect.vector_with_ids_size(), request.vector_with_ids_size());
+  for (int i = 0; i < request.vector_with_ids_size(); ++i) {
+    const auto& float_values = request.vector_with_ids(i).vector().float_values();
+    const auto& expect_float_values = expect.vector_with_ids(i).vector().float_values();
+    ASSERT_EQ(expect_float_values.size(), float_values.size());
+    for (int j = 0; j < float_values.size(); ++j) {
+      EXPECT_EQ(expect_float_values[j], float_values[j]);
+    }
+  }
+  EXPECT_EQ(8, request.vector_with_ids(0).vector().dimension());
+  EXPECT_EQ(100, request.vector_with_ids(1).id());
+}
+
+TEST_F(VectorPackedCodecTest, SearchResponse) {
+  pb::index::VectorSearchResponse response;
+  for (int i = 0; i < 2; ++i) {
+    auto* batch_result = response.add_batch_results();
+    for (int j = 0; j < 3; ++j) {
+      auto* vector = batch_result->add_vector_with_distances()->mutable_vector_with_id()->mutable_vector();
+      vector->add_float_values(i);
+      vector->add_float_values(j);
+    }
+  }
+
+  butil::IOBuf buf;
+  VectorPackedCodec::Pack(VectorPackedCodec::VectorWithIds(&response), buf);
+  EXPECT_TRUE(VectorPackedCodec::Unpack(VectorPackedCodec::VectorWithIds(&response), buf).ok());
+  for (int i = 0; i < 2; ++i) {
+    for (int j = 0; j < 3; ++j) {
+      const auto& vector = response.batch_results(i).vector_with_distances(j).vector_with_id().vector();
+      ASSERT_EQ(2, vector.float_values_size());
+      EXPECT_EQ(i, vector.float_values(0));
+      EXPECT_EQ(j, vector.float_values(1));
+    }
+  }
+}
+
+TEST_F(VectorPackedCodecTest, Invalid) {
+  pb::index::VectorSearchRequest request;
+  request.add_vector_with_ids()->mutable_vector()->add_float_values(1.0f);
+
+  butil::IOBuf buf;
+  buf.append("invalid");
+  EXPECT_FALSE(VectorPackedCodec::Unpack(VectorPackedCodec::VectorWithIds(&request), buf).ok());
+
+  // truncated
+  buf.clear();
+  VectorPackedCodec::Pack(VectorPackedCodec::VectorWithIds(&request), buf);
+  butil::IOBuf truncated;
+  buf.cutn(&truncated, buf.size() - 1);
+  EXPECT_FALSE(VectorPackedCodec::Unpack(VectorPackedCodec::VectorWithIds(&request), truncated).ok());
+
+  // position exceed
+  pb::index::VectorSearchRequest two_request;
+  two_request.add_vector_with_ids();
+  two_request.add_vector_with_ids()->mutable_vector()->add_float_values(1.0f);
+  buf.clear();
+  VectorPackedCodec::Pack(VectorPackedCodec::VectorWithIds(&two_request), buf);
+  EXPECT_FALSE(VectorPackedCodec::Unpack(VectorPackedCodec::VectorWithIds(&request), buf).ok());
+}
+
+}  // namespace dingodb
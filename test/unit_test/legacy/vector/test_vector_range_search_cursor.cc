@@ -0,0 +1,211 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "common/constant.h"
+#include "common/helper.h"
+#include "config/yaml_config.h"
+#include "engine/rocks_raw_engine.h"
+#include "proto/common.pb.h"
+#include "simd/hook.h"
+#include "vector/codec.h"
+#include "vector/vector_range_search_cursor.h"
+
+namespace dingodb {
+
+static const std::string kRangeSearchRootPath = "./unit_test_range_search_cursor";
+
+static const std::string kRangeSearchYamlConfigContent =
+    "cluster:\n"
+    "  name: dingodb\n"
+    "  instance_id: 12345\n"
+    "  coordinators: 127.0.0.1:19190,127.0.0.1:19191,127.0.0.1:19192\n"
+    "  keyring: TO_BE_CONTINUED\n"
+    "server:\n"
+    "  host: 127.0.0.1\n"
+    "  port: 23000\n"
+    "log:\n"
+    "  path: " +
+    kRangeSearchRootPath +
+    "/log\n"
+    "store:\n"
+    "  path: " +
+    kRangeSearchRootPath + "/db\n";
+
+class VectorRangeSearchCursorTest : public testing::Test {
+ protected:
+  static void SetUpTestSuite() {
+    Helper::CreateDirectories(kRangeSearchRootPath + "/db");
+
+    auto config = std::make_shared<YamlConfig>();
+    ASSERT_EQ(0, config->Load(kRangeSearchYamlConfigContent));
+
+    engine = std::make_shared<RocksRawEngine>();
+    ASSERT_TRUE(engine->Init(config, {Constant::kVectorDataCF}));
+
+    std::string start_key;
+    VectorCodec::EncodeVectorKey(kPrefix, kPartitionId, start_key);
+    range.set_start_key(start_key);
+    range.set_end_key(Helper::PrefixNext(start_key));
+
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<float> distrib(0.0F, 1.0F);
+    vectors.resize(kDataSize);
+    auto writer = engine->Writer();
+    for (int64_t i = 0; i < kDataSize; ++i) {
+      auto& vector = vectors[i];
+      vector.set_dimension(kDimension);
+      for (int j = 0; j < kDimension; ++j) {
+        vector.add_float_values(distrib(rng));
+      }
+
+      pb::common::KeyValue kv;
+      VectorCodec::EncodeVectorKey(kPrefix, kPartitionId, i + 1, *kv.mutable_key());
+      kv.set_value(vector.SerializeAsString());
+      ASSERT_TRUE(writer->KvPut(Constant::kVectorDataCF, kv).ok());
+    }
+  }
+
+  static void TearDownTestSuite() {
+    engine->Close();
+    engine->Destroy();
+    Helper::RemoveAllFileOrDirectory(kRangeSearchRootPath);
+  }
+
+  // vector ids within radius of L2 by full distance
+  static std::set<int64_t> ExpectL2(const pb::common::Vector& query, float radius) {
+    std::set<int64_t> vector_ids;
+    for (int64_t i = 0; i < kDataSize; ++i) {
+      float distance = 0.0F;
+      for (int j = 0; j < kDimension; ++j) {
+        float diff = query.float_values(j) - vectors[i].float_values(j);
+        distance += diff * diff;
+      }
+      if (distance < radius) {
+        vector_ids.insert(i + 1);
+      }
+    }
+    return vector_ids;
+  }
+
+  inline static constexpr char kPrefix = 'r';
+  inline static constexpr int64_t kPartitionId = 1001;
+  inline static constexpr int kDimension = 100;
+  inline static constexpr int64_t kDataSize = 2000;
+  inline static std::shared_ptr<RocksRawEngine> engine;
+  inline static pb::common::Range range;
+  inline static std::vector<pb::common::Vector> vectors;
+};
+
+TEST_F(VectorRangeSearchCursorTest, L2sqrEarlyAbort) {
+  const auto& x = vectors[0];
+  const auto& y = vectors[1];
+  float distance = fvec_L2sqr(x.float_values().data(), y.float_values().data(), kDimension);
+
+  // in range, the full distance
+  EXPECT_FLOAT_EQ(distance,
+                  fvec_L2sqr_early_abort(x.float_values().data(), y.float_values().data(), kDimension, distance));
+  // out of range, a lower bound out of radius
+  float partial = fvec_L2sqr_early_abort(x.float_values().data(), y.float_values().data(), kDimension, 0.0F);
+  EXPECT_GT(partial, 0.0F);
+  EXPECT_LE(partial, distance * (1.0F + 1e-5F));
+}
+
+TEST_F(VectorRangeSearchCursorTest, Paging) {
+  float radius = 12.0F;
+  std::vector<pb::common::VectorWithId> queries(2);
+  *queries[0].mutable_vector() = vectors[10];
+  *queries[1].mutable_vector() = vectors[20];
+
+  auto cursor =
+      VectorRangeSearchCursor::New(engine->Reader(), range, kDimension, pb::common::MetricType::METRIC_TYPE_L2, radius);
+  ASSERT_TRUE(cursor->Open(queries, {}).ok());
+
+  std::vector<std::set<int64_t>> actual(queries.size());
+  std::vector<pb::index::VectorWithDistanceResult> results;
+  bool has_more = true;
+  int page_count = 0;
+  while (has_more) {
+    ASSERT_TRUE(cursor->Next(16, results, has_more).ok());
+    ASSERT_EQ(queries.size(), results.size());
+    int64_t count = 0;
+    for (size_t i = 0; i < results.size(); ++i) {
+      for (const auto& vector_with_distance : results[i].vector_with_distances()) {
+        EXPECT_LT(vector_with_distance.distance(), radius);
+        EXPECT_TRUE(actual[i].insert(vector_with_distance.vector_with_id().id()).second);
+      }
+      count += results[i].vector_with_distances_size();
+    }
+    EXPECT_LT(count, 16 + queries.size());
+    ++page_count;
+  }
+  EXPECT_GT(page_count, 1);
+  EXPECT_EQ(kDataSize, cursor->ScannedCount());
+
+  for (size_t i = 0; i < queries.size(); ++i) {
+    EXPECT_EQ(ExpectL2(queries[i].vector(), radius), actual[i]);
+  }
+}
+
+TEST_F(VectorRangeSearchCursorTest, Filter) {
+  std::vector<pb::common::VectorWithId> queries(1);
+  *queries[0].mutable_vector() = vectors[0];
+
+  // a big radius, every vector within range
+  auto cursor =
+      VectorRangeSearchCursor::New(engine->Reader(), range, kDimension, pb::common::MetricType::METRIC_TYPE_L2, 1e9F);
+  std::vector<std::shared_ptr<VectorIndex::FilterFunctor>> filters = {
+      std::make_shared<VectorIndex::RangeFilterFunctor>(100, 200)};
+  ASSERT_TRUE(cursor->Open(queries, filters).ok());
+
+  std::vector<pb::index::VectorWithDistanceResult> results;
+  bool has_more = false;
+  ASSERT_TRUE(cursor->Next(0, results, has_more).ok());
+  EXPECT_FALSE(has_more);
+  ASSERT_EQ(100, results[0].vector_with_distances_size());
+  EXPECT_EQ(100, results[0].vector_with_distances(0).vector_with_id().id());
+  EXPECT_EQ(199, results[0].vector_with_distances(99).vector_with_id().id());
+}
+
+TEST_F(VectorRangeSearchCursorTest, InnerProduct) {
+  std::vector<pb::common::VectorWithId> queries(1);
+  *queries[0].mutable_vector() = vectors[0];
+
+  // distance is 1 - ip, query itself has the largest ip
+  float self_ip = fvec_inner_product(vectors[0].float_values().data(), vectors[0].float_values().data(), kDimension);
+  float radius = 1.0F - self_ip * 0.9F;
+  auto cursor = VectorRangeSearchCursor::New(engine->Reader(), range, kDimension,
+                                             pb::common::MetricType::METRIC_TYPE_INNER_PRODUCT, radius);
+  ASSERT_TRUE(cursor->Open(queries, {}).ok());
+
+  std::vector<pb::index::VectorWithDistanceResult> results;
+  bool has_more = false;
+  ASSERT_TRUE(cursor->Next(0, results, has_more).ok());
+  bool found_self = false;
+  for (const auto& vector_with_distance : results[0].vector_with_distances()) {
+    EXPECT_LT(vector_with_distance.distance(), radius);
+    found_self = found_self || vector_with_distance.vector_with_id().id() == 1;
+  }
+  EXPECT_TRUE(found_self);
+}
+
+}  // namespace dingodb
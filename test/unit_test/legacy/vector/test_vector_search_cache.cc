@@ -0,0 +1,119 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "proto/common.pb.h"
+#include "proto/index.pb.h"
+#include "vector/vector_search_cache.h"
+
+namespace dingodb {
+
+class VectorSearchCacheTest : public testing::Test {
+ protected:
+  static std::string Fingerprint(int64_t region_id, float value, uint32_t topk) {
+    pb::common::Range range;
+    range.set_start_key("a");
+    range.set_end_key("z");
+
+    pb::common::VectorWithId vector_with_id;
+    vector_with_id.mutable_vector()->set_dimension(2);
+    vector_with_id.mutable_vector()->add_float_values(value);
+    vector_with_id.mutable_vector()->add_float_values(value);
+
+    pb::common::VectorSearchParameter parameter;
+    parameter.set_top_n(topk);
+
+    return VectorSearchCache::Fingerprint(region_id, range, {vector_with_id}, parameter);
+  }
+
+  static std::vector<pb::index::VectorWithDistanceResult> Results(int64_t vector_id) {
+    std::vector<pb::index::VectorWithDistanceResult> results(1);
+    auto* vector_with_distance = results[0].add_vector_with_distances();
+    vector_with_distance->mutable_vector_with_id()->set_id(vector_id);
+    vector_with_distance->set_distance(0.5F);
+    return results;
+  }
+};
+
+TEST_F(VectorSearchCacheTest, Fingerprint) {
+  EXPECT_EQ(Fingerprint(1, 1.0F, 10), Fingerprint(1, 1.0F, 10));
+  EXPECT_NE(Fingerprint(1, 1.0F, 10), Fingerprint(2, 1.0F, 10));
+  EXPECT_NE(Fingerprint(1, 1.0F, 10), Fingerprint(1, 2.0F, 10));
+  EXPECT_NE(Fingerprint(1, 1.0F, 10), Fingerprint(1, 1.0F, 20));
+}
+
+TEST_F(VectorSearchCacheTest, GetPut) {
+  VectorSearchCache cache(1024 * 1024, 4, {});
+  auto fingerprint = Fingerprint(1, 1.0F, 10);
+  VectorSearchCache::Version version{100, 90};
+
+  std::vector<pb::index::VectorWithDistanceResult> results;
+  EXPECT_FALSE(cache.Get(fingerprint, version, results));
+
+  cache.Put(fingerprint, version, Results(7));
+  ASSERT_TRUE(cache.Get(fingerprint, version, results));
+  ASSERT_EQ(1, results.size());
+  EXPECT_EQ(7, results[0].vector_with_distances(0).vector_with_id().id());
+  EXPECT_EQ(1, cache.Count());
+
+  // a write applied, stale entry is dropped
+  results.clear();
+  EXPECT_FALSE(cache.Get(fingerprint, VectorSearchCache::Version{101, 90}, results));
+  EXPECT_EQ(0, cache.Count());
+  EXPECT_EQ(0, cache.MemorySize());
+
+  cache.Put(fingerprint, version, Results(7));
+  EXPECT_FALSE(cache.Get(fingerprint, VectorSearchCache::Version{100, 91}, results));
+}
+
+TEST_F(VectorSearchCacheTest, Evict) {
+  auto fingerprint = Fingerprint(1, 0.0F, 10);
+  VectorSearchCache::Version version{1, 1};
+
+  // room for a few entries in one shard
+  VectorSearchCache probe(1024 * 1024, 1, {});
+  probe.Put(fingerprint, version, Results(0));
+  int64_t entry_bytes = probe.MemorySize();
+  ASSERT_GT(entry_bytes, 0);
+
+  VectorSearchCache cache(entry_bytes * 3 + entry_bytes / 2, 1, {});
+  for (int i = 0; i < 10; ++i) {
+    cache.Put(Fingerprint(1, i, 10), version, Results(i));
+  }
+  EXPECT_EQ(3, cache.Count());
+  EXPECT_LE(cache.MemorySize(), entry_bytes * 3 + entry_bytes / 2);
+
+  std::vector<pb::index::VectorWithDistanceResult> results;
+  EXPECT_FALSE(cache.Get(Fingerprint(1, 0, 10), version, results));
+  EXPECT_TRUE(cache.Get(Fingerprint(1, 9, 10), version, results));
+
+  // recently used survives
+  EXPECT_TRUE(cache.Get(Fingerprint(1, 7, 10), version, results));
+  cache.Put(Fingerprint(1, 10, 10), version, Results(10));
+  EXPECT_TRUE(cache.Get(Fingerprint(1, 7, 10), version, results));
+  EXPECT_FALSE(cache.Get(Fingerprint(1, 8, 10), version, results));
+}
+
+TEST_F(VectorSearchCacheTest, DisabledIndex) {
+  VectorSearchCache cache(1024 * 1024, 4, {5});
+  EXPECT_TRUE(cache.IsEnabled(4));
+  EXPECT_FALSE(cache.IsEnabled(5));
+}
+
+}  // namespace dingodb